@@ -0,0 +1,717 @@
+/**
+ * @file main.cpp
+ * @brief Benchmark suite: every model in `include/epiworld/models` and
+ *        `include/measles`, and the network generators in `randgraph.hpp`,
+ *        at several population sizes.
+ *
+ * Usage:
+ *
+ *     benchmarks [--sizes 1e4,1e5,1e6,1e7] [--days 50] [--filter <text>]
+ *                [--out bench.json] [--baseline <file>] [--threshold 0.1]
+ *
+ * For each benchmark and size, the report has the time per simulated day
+ * (models) or per graph (generators), the peak resident set size, and the
+ * number of events per second. Events are the state transitions recorded
+ * by the model, or the edges for the generators.
+ *
+ * The report is written as JSON with one benchmark per line. With
+ * `--baseline`, the results are compared against a previous report, and
+ * the program exits with status 1 if any benchmark is slower (or uses more
+ * memory) than the baseline by more than `--threshold`.
+ */
+
+#include "../include/epiworld/epiworld.hpp"
+#include "../include/measles/measles.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using namespace epiworld;
+
+using bench_clock = std::chrono::steady_clock;
+
+/// One row of the report.
+struct BenchResult {
+    std::string name;
+    size_t n = 0u;
+    std::string unit;           ///< "day" (models) or "graph" (generators).
+    double ms = 0.0;            ///< Milliseconds per unit.
+    double peak_rss_mb = 0.0;
+    double events = 0.0;
+    double events_per_sec = 0.0;
+};
+
+/**
+ * @brief Builds a model with `n` agents and passes it to the runner.
+ * @details The model lives in the benchmark's stack, so data the model
+ * points to (e.g., the covariates of `ModelSIRLogit`) can live there too.
+ */
+using ModelBench = std::function<
+    void(size_t, const std::function< void(Model<> &) > &)
+    >;
+
+/// Generates a network with `n` nodes using the model's RNG.
+using GraphBench = std::function< AdjList(size_t, Model<> &) >;
+
+// -----------------------------------------------------------------------------
+//  Peak resident set size
+// -----------------------------------------------------------------------------
+
+/**
+ * On Linux, the high-water mark is reset before each benchmark, so the peak
+ * belongs to the benchmark. Elsewhere (or if the reset is not allowed), the
+ * peak of the whole process is reported.
+ */
+static void peak_rss_reset()
+{
+#ifdef __linux__
+    std::ofstream f("/proc/self/clear_refs");
+    if (f)
+        f << "5";
+#endif
+}
+
+static double peak_rss_mb()
+{
+#ifdef __linux__
+    std::ifstream f("/proc/self/status");
+    std::string line;
+    while (std::getline(f, line))
+        if (line.compare(0u, 6u, "VmHWM:") == 0)
+            return std::strtod(line.c_str() + 6, nullptr) / 1024.0;
+#endif
+
+#if defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast< double >(usage.ru_maxrss) / 1048576.0;
+#elif defined(__unix__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast< double >(usage.ru_maxrss) / 1024.0;
+#else
+    return 0.0;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//  Benchmarks
+// -----------------------------------------------------------------------------
+
+/// Agents that changed state over the whole run.
+static double count_transitions(Model<> & model)
+{
+
+    std::vector< std::string > state_from, state_to;
+    std::vector< int > date, counts;
+    model.get_db().get_hist_transition_matrix(
+        state_from, state_to, date, counts, true
+    );
+
+    double n = 0.0;
+    for (size_t i = 0u; i < counts.size(); ++i)
+        if (state_from[i] != state_to[i])
+            n += static_cast< double >(counts[i]);
+
+    return n;
+
+}
+
+static BenchResult bench_model(
+    const std::string & name,
+    size_t n,
+    int ndays,
+    const ModelBench & bench
+)
+{
+
+    BenchResult res;
+    res.name = name;
+    res.n    = n;
+    res.unit = "day";
+
+    peak_rss_reset();
+    bench(n, [&](Model<> & model) -> void {
+
+        model.verbose_off();
+
+        auto t0 = bench_clock::now();
+        model.run(ndays, 123);
+        auto t1 = bench_clock::now();
+
+        double ms = std::chrono::duration< double, std::milli >(t1 - t0).count();
+
+        res.ms     = ms / static_cast< double >(ndays);
+        res.events = count_transitions(model);
+        res.events_per_sec = res.events / (ms / 1000.0);
+
+    });
+    res.peak_rss_mb = peak_rss_mb();
+
+    return res;
+
+}
+
+static BenchResult bench_graph(
+    const std::string & name,
+    size_t n,
+    const GraphBench & bench
+)
+{
+
+    BenchResult res;
+    res.name = name;
+    res.n    = n;
+    res.unit = "graph";
+
+    peak_rss_reset();
+    {
+
+        epimodels::ModelSIR<> model("bench-virus", 0.01, 0.3, 0.5);
+        model.seed(123);
+
+        auto t0 = bench_clock::now();
+        AdjList al = bench(n, model);
+        auto t1 = bench_clock::now();
+
+        res.ms     = std::chrono::duration< double, std::milli >(t1 - t0).count();
+        res.events = static_cast< double >(al.ecount());
+        res.events_per_sec = res.events / (res.ms / 1000.0);
+
+    }
+    res.peak_rss_mb = peak_rss_mb();
+
+    return res;
+
+}
+
+/// Three groups of the same size (for the mixing models).
+static const std::vector< double > contact_matrix = {
+    4.0, 1.0, 1.0,
+    1.0, 4.0, 1.0,
+    1.0, 1.0, 4.0
+};
+
+static void add_groups(Model<> & model, size_t n)
+{
+    size_t third = n / 3u;
+    model.add_entity(Entity<>("Group 1", distribute_entity_to_range<>(0, third)));
+    model.add_entity(Entity<>("Group 2", distribute_entity_to_range<>(third, 2u * third)));
+    model.add_entity(Entity<>("Group 3", distribute_entity_to_range<>(2u * third, n)));
+}
+
+static std::vector< std::pair< std::string, ModelBench > > model_benchmarks()
+{
+
+    using namespace epimodels;
+    using namespace measles;
+    using Run = std::function< void(Model<> &) >;
+
+    const epiworld_double prevalence = 0.001;
+
+    std::vector< std::pair< std::string, ModelBench > > res;
+
+    // Models on a small-world network
+    res.emplace_back("SIR", [=](size_t n, const Run & run) {
+        ModelSIR<> model("virus", prevalence, 0.3, 0.3);
+        model.agents_smallworld(n, 4, false, 0.01);
+        run(model);
+    });
+
+    res.emplace_back("SEIR", [=](size_t n, const Run & run) {
+        ModelSEIR<> model("virus", prevalence, 0.3, 4.0, 0.3);
+        model.agents_smallworld(n, 4, false, 0.01);
+        run(model);
+    });
+
+    res.emplace_back("SIS", [=](size_t n, const Run & run) {
+        ModelSIS<> model("virus", prevalence, 0.3, 0.3);
+        model.agents_smallworld(n, 4, false, 0.01);
+        run(model);
+    });
+
+    res.emplace_back("SISD", [=](size_t n, const Run & run) {
+        ModelSISD<> model("virus", prevalence, 0.3, 0.3, 0.01);
+        model.agents_smallworld(n, 4, false, 0.01);
+        run(model);
+    });
+
+    res.emplace_back("SIRD", [=](size_t n, const Run & run) {
+        ModelSIRD<> model("virus", prevalence, 0.3, 0.3, 0.01);
+        model.agents_smallworld(n, 4, false, 0.01);
+        run(model);
+    });
+
+    res.emplace_back("SEIRD", [=](size_t n, const Run & run) {
+        ModelSEIRD<> model("virus", prevalence, 0.3, 4.0, 0.3, 0.01);
+        model.agents_smallworld(n, 4, false, 0.01);
+        run(model);
+    });
+
+    res.emplace_back("SIRLogit", [=](size_t n, const Run & run) {
+
+        std::vector< double > covariate(n);
+        for (size_t i = 0u; i < n; ++i)
+            covariate[i] = static_cast< double >(i % 10u) / 10.0;
+
+        ModelSIRLogit<> model(
+            "virus", covariate.data(), 1u,
+            {0.5, -1.0}, {0.5}, {0u}, {0u},
+            0.3, 0.3, prevalence
+        );
+        model.agents_smallworld(n, 4, false, 0.01);
+        run(model);
+
+    });
+
+    res.emplace_back("DiffNet", [=](size_t n, const Run & run) {
+        ModelDiffNet<> model("innovation", prevalence, 0.3);
+        model.agents_smallworld(n, 4, false, 0.01);
+        run(model);
+    });
+
+    res.emplace_back("SURV", [=](size_t n, const Run & run) {
+        ModelSURV<> model(
+            "virus", static_cast< epiworld_fast_uint >(n * prevalence) + 1u
+        );
+        model.agents_smallworld(n, 4, false, 0.01);
+        run(model);
+    });
+
+    res.emplace_back("SEIRNetworkQuarantine", [=](size_t n, const Run & run) {
+        ModelSEIRNetworkQuarantine<> model(
+            "virus", prevalence, 0.3, 4.0, 0.3,
+            0.1, 5.0,           // Hospitalization
+            2.0, 4, 0.9, 1.0, 10 // Policy
+        );
+        model.agents_smallworld(n, 4, false, 0.01);
+        run(model);
+    });
+
+    // Connected (fully mixing) models
+    res.emplace_back("SIRCONN", [=](size_t n, const Run & run) {
+        ModelSIRCONN<> model("virus", n, prevalence, 4.0, 0.1, 0.3);
+        run(model);
+    });
+
+    res.emplace_back("SEIRCONN", [=](size_t n, const Run & run) {
+        ModelSEIRCONN<> model("virus", n, prevalence, 4.0, 0.1, 4.0, 0.3);
+        run(model);
+    });
+
+    res.emplace_back("SIRDCONN", [=](size_t n, const Run & run) {
+        ModelSIRDCONN<> model("virus", n, prevalence, 4.0, 0.1, 0.3, 0.01);
+        run(model);
+    });
+
+    res.emplace_back("SEIRDCONN", [=](size_t n, const Run & run) {
+        ModelSEIRDCONN<> model(
+            "virus", n, prevalence, 4.0, 0.1, 4.0, 0.3, 0.01
+        );
+        run(model);
+    });
+
+    // Mixing models (three groups)
+    res.emplace_back("SIRMixing", [=](size_t n, const Run & run) {
+        ModelSIRMixing<> model(
+            "virus", n, prevalence, 0.1, 0.3, contact_matrix
+        );
+        add_groups(model, n);
+        run(model);
+    });
+
+    res.emplace_back("SEIRMixing", [=](size_t n, const Run & run) {
+        ModelSEIRMixing<> model(
+            "virus", n, prevalence, 0.1, 4.0, 0.3, contact_matrix
+        );
+        add_groups(model, n);
+        run(model);
+    });
+
+    res.emplace_back("SEIRMixingQuarantine", [=](size_t n, const Run & run) {
+        ModelSEIRMixingQuarantine<> model(
+            "virus", n, prevalence, 0.1, 4.0, 0.3, contact_matrix,
+            0.1, 5.0,           // Hospitalization
+            2.0, 4, 0.9, 1.0, 10 // Policy
+        );
+        add_groups(model, n);
+        run(model);
+    });
+
+    // Measles
+    res.emplace_back("MeaslesMixing", [=](size_t n, const Run & run) {
+        ModelMeaslesMixing<> model(
+            n, prevalence, 0.1, 0.9, 0.3,
+            7.0, 4.0, 5.0,      // Incubation, prodromal and rash
+            contact_matrix,
+            0.2, 7.0,           // Hospitalization
+            3.0, 21, 0.8, 0.8, 4, // Policy
+            0.5                 // Proportion vaccinated
+        );
+        add_groups(model, n);
+        run(model);
+    });
+
+    res.emplace_back("MeaslesMixingRiskQuarantine", [=](size_t n, const Run & run) {
+        ModelMeaslesMixingRiskQuarantine<> model(
+            n, prevalence, 0.1, 0.9,
+            7.0, 4.0, 5.0,      // Incubation, prodromal and rash
+            contact_matrix,
+            0.2, 7.0,           // Hospitalization
+            3.0, 21, 14, 7, 0.8, 0.8, 4, // Policy
+            0.5,                // Proportion vaccinated
+            0.5                 // Detection rate in quarantine
+        );
+        add_groups(model, n);
+        run(model);
+    });
+
+    res.emplace_back("MeaslesSchool", [=](size_t n, const Run & run) {
+        ModelMeaslesSchool<> model(
+            n, static_cast< epiworld_fast_uint >(n * prevalence) + 1u,
+            2.0, 0.2, 0.9, 0.3,
+            7.0, 4.0, 5.0,      // Incubation, prodromal and rash
+            3.0, 0.2, 7.0,      // Detection and hospitalization
+            0.5, 21, 0.8, 4     // Policy
+        );
+        run(model);
+    });
+
+    return res;
+
+}
+
+static std::vector< std::pair< std::string, GraphBench > > graph_benchmarks()
+{
+
+    std::vector< std::pair< std::string, GraphBench > > res;
+
+    // All with an expected degree of about 10
+    res.emplace_back("rgraph_bernoulli", [](size_t n, Model<> & m) {
+        return rgraph_bernoulli(n, 10.0 / static_cast< double >(n - 1u), false, m);
+    });
+
+    res.emplace_back("rgraph_ring_lattice", [](size_t n, Model<> &) {
+        return rgraph_ring_lattice(n, 10, false);
+    });
+
+    res.emplace_back("rgraph_smallworld", [](size_t n, Model<> & m) {
+        return rgraph_smallworld(n, 10, 0.1, false, m);
+    });
+
+    res.emplace_back("rgraph_blocked", [](size_t n, Model<> & m) {
+        return rgraph_blocked(n, 10, 2, m);
+    });
+
+    res.emplace_back("rgraph_sbm", [](size_t n, Model<> & m) {
+
+        // Two blocks, so they have the same size for all the default sizes
+        std::vector< size_t > block_sizes = {n / 2u, n - n / 2u};
+
+        std::vector< double > mixing = {
+            8.0, 2.0,
+            2.0, 8.0
+        };
+
+        return rgraph_sbm(block_sizes, mixing, true, m);
+
+    });
+
+    return res;
+
+}
+
+// -----------------------------------------------------------------------------
+//  Report and baseline
+// -----------------------------------------------------------------------------
+
+static void write_report(
+    const std::string & fn,
+    const std::vector< BenchResult > & results,
+    int ndays
+)
+{
+
+    std::ofstream f(fn);
+    if (!f)
+        throw std::runtime_error("Cannot write the report to " + fn);
+
+    #ifdef DEBUG
+    const char * debug = "true";
+    #else
+    const char * debug = "false";
+    #endif
+
+    f << "{\n";
+    f << "  \"epiworld\": \"" << epiworld_version() << "\",\n";
+    f << "  \"debug\": " << debug << ",\n";
+    f << "  \"ndays\": " << ndays << ",\n";
+    f << "  \"benchmarks\": [\n";
+
+    char buff[512];
+    for (size_t i = 0u; i < results.size(); ++i)
+    {
+        const auto & r = results[i];
+        std::snprintf(
+            buff, sizeof(buff),
+            "    {\"name\": \"%s\", \"n\": %zu, \"unit\": \"%s\", "
+            "\"ms\": %.6g, \"peak_rss_mb\": %.6g, \"events\": %.0f, "
+            "\"events_per_sec\": %.6g}%s\n",
+            r.name.c_str(), r.n, r.unit.c_str(), r.ms, r.peak_rss_mb,
+            r.events, r.events_per_sec,
+            (i + 1u < results.size()) ? "," : ""
+        );
+        f << buff;
+    }
+
+    f << "  ]\n}\n";
+
+}
+
+/**
+ * @brief Value of `"key": value` in a line of the report.
+ * @details The report has one benchmark per line (see `write_report()`), so
+ * there is no need for a full JSON parser.
+ */
+static bool report_field(
+    const std::string & line,
+    const std::string & key,
+    std::string & value
+)
+{
+
+    auto pos = line.find("\"" + key + "\": ");
+    if (pos == std::string::npos)
+        return false;
+
+    pos += key.size() + 4u;
+    if (line[pos] == '"')
+    {
+        auto end = line.find('"', pos + 1u);
+        value = line.substr(pos + 1u, end - pos - 1u);
+    }
+    else
+    {
+        auto end = line.find_first_of(",}", pos);
+        value = line.substr(pos, end - pos);
+    }
+
+    return true;
+
+}
+
+/// Baseline results by "name/n".
+static std::map< std::string, BenchResult > read_report(const std::string & fn)
+{
+
+    std::ifstream f(fn);
+    if (!f)
+        throw std::runtime_error("Cannot read the baseline " + fn);
+
+    std::map< std::string, BenchResult > res;
+    std::string line, value;
+    while (std::getline(f, line))
+    {
+
+        BenchResult r;
+        if (!report_field(line, "name", r.name))
+            continue;
+
+        if (report_field(line, "n", value))
+            r.n = std::strtoull(value.c_str(), nullptr, 10);
+
+        if (report_field(line, "ms", value))
+            r.ms = std::strtod(value.c_str(), nullptr);
+
+        if (report_field(line, "peak_rss_mb", value))
+            r.peak_rss_mb = std::strtod(value.c_str(), nullptr);
+
+        res[r.name + "/" + std::to_string(r.n)] = r;
+
+    }
+
+    return res;
+
+}
+
+/// Prints the comparison and returns the number of regressions.
+static int compare_report(
+    const std::vector< BenchResult > & results,
+    const std::map< std::string, BenchResult > & baseline,
+    double threshold
+)
+{
+
+    std::printf(
+        "\n%-28s  %9s  %11s  %11s  %7s  %7s\n",
+        "benchmark", "n", "ms (base)", "ms (now)", "time", "rss"
+    );
+
+    int nregressions = 0;
+    for (const auto & r : results)
+    {
+
+        auto b = baseline.find(r.name + "/" + std::to_string(r.n));
+        if (b == baseline.end())
+        {
+            std::printf(
+                "%-28s  %9zu  %11s  %11.4g  %7s  %7s  new\n",
+                r.name.c_str(), r.n, "-", r.ms, "-", "-"
+            );
+            continue;
+        }
+
+        double time_ratio = r.ms / b->second.ms;
+        double rss_ratio  = (b->second.peak_rss_mb > 0.0) ?
+            r.peak_rss_mb / b->second.peak_rss_mb : 1.0;
+
+        std::string flag;
+        if (time_ratio > 1.0 + threshold)
+            flag += " slower";
+        if (rss_ratio > 1.0 + threshold)
+            flag += " bigger";
+
+        if (!flag.empty())
+            ++nregressions;
+
+        std::printf(
+            "%-28s  %9zu  %11.4g  %11.4g  %6.2fx  %6.2fx %s\n",
+            r.name.c_str(), r.n, b->second.ms, r.ms,
+            time_ratio, rss_ratio, flag.c_str()
+        );
+
+    }
+
+    std::printf(
+        "\n%d regression(s) (threshold: %.0f%%)\n",
+        nregressions, threshold * 100.0
+    );
+
+    return nregressions;
+
+}
+
+// -----------------------------------------------------------------------------
+//  Main
+// -----------------------------------------------------------------------------
+
+static std::vector< size_t > parse_sizes(const std::string & s)
+{
+
+    std::vector< size_t > res;
+    size_t start = 0u;
+    while (start < s.size())
+    {
+        auto end = s.find(',', start);
+        if (end == std::string::npos)
+            end = s.size();
+
+        // strtod so "1e6" works
+        res.push_back(static_cast< size_t >(
+            std::strtod(s.substr(start, end - start).c_str(), nullptr)
+        ));
+
+        start = end + 1u;
+    }
+
+    return res;
+
+}
+
+int main(int argc, char * argv[]) {
+
+    std::vector< size_t > sizes = {10000, 100000, 1000000, 10000000};
+    int ndays = 50;
+    std::string filter;
+    std::string out = "bench.json";
+    std::string baseline;
+    double threshold = 0.1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+
+        std::string arg = argv[i];
+        if ((i + 1) == argc)
+        {
+            std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return 2;
+        }
+
+        std::string value = argv[++i];
+        if (arg == "--sizes")
+            sizes = parse_sizes(value);
+        else if (arg == "--days")
+            ndays = std::atoi(value.c_str());
+        else if (arg == "--filter")
+            filter = value;
+        else if (arg == "--out")
+            out = value;
+        else if (arg == "--baseline")
+            baseline = value;
+        else if (arg == "--threshold")
+            threshold = std::strtod(value.c_str(), nullptr);
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return 2;
+        }
+
+    }
+
+    #ifdef DEBUG
+    std::printf("Warning: debug build; use BUILD_PROFILE=release for timings.\n\n");
+    #endif
+
+    std::printf(
+        "%-28s  %9s  %11s  %11s  %14s  %11s\n",
+        "benchmark", "n", "ms/unit", "peak MB", "events/sec", "unit"
+    );
+
+    std::vector< BenchResult > results;
+    auto report = [&results](BenchResult r) -> void {
+        std::printf(
+            "%-28s  %9zu  %11.4g  %11.1f  %14.4g  %11s\n",
+            r.name.c_str(), r.n, r.ms, r.peak_rss_mb, r.events_per_sec,
+            r.unit.c_str()
+        );
+        std::fflush(stdout);
+        results.push_back(std::move(r));
+    };
+
+    for (const auto & b : model_benchmarks())
+    {
+        if (b.first.find(filter) == std::string::npos)
+            continue;
+
+        for (auto n : sizes)
+            report(bench_model(b.first, n, ndays, b.second));
+    }
+
+    for (const auto & b : graph_benchmarks())
+    {
+        if (b.first.find(filter) == std::string::npos)
+            continue;
+
+        for (auto n : sizes)
+            report(bench_graph(b.first, n, b.second));
+    }
+
+    write_report(out, results, ndays);
+    std::printf("\nReport written to %s\n", out.c_str());
+
+    if (baseline != "")
+        return compare_report(results, read_report(baseline), threshold) > 0 ?
+            1 : 0;
+
+    return 0;
+
+}
@@ -0,0 +1,31093 @@
+#include <vector>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <random>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <map>
+#include <unordered_map>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <algorithm>
+#include <regex>
+#include <sstream>
+#include <iomanip>
+#include <set>
+#include <type_traits>
+#include <mutex>
+#include <iterator>
+#include <cassert>
+#ifdef EPI_DEBUG_VIRUS
+#include <atomic>
+#endif
+
+#ifndef EPIWORLD_HPP
+#define EPIWORLD_HPP
+
+/* Versioning */
+#define EPIWORLD_VERSION_MAJOR 0
+#define EPIWORLD_VERSION_MINOR 15
+#define EPIWORLD_VERSION_PATCH 1
+
+#define EPIWORLD_VERSION_PRERELEASE ""
+
+static constexpr int epiworld_version_major = EPIWORLD_VERSION_MAJOR;
+static constexpr int epiworld_version_minor = EPIWORLD_VERSION_MINOR;
+static constexpr int epiworld_version_patch = EPIWORLD_VERSION_PATCH;
+static constexpr std::string_view epiworld_version_prerelease =
+    EPIWORLD_VERSION_PRERELEASE;
+
+inline std::string epiworld_version() {
+    std::string v =
+        std::to_string(epiworld_version_major) + "." +
+        std::to_string(epiworld_version_minor) + "." +
+        std::to_string(epiworld_version_patch);
+
+    if (!epiworld_version_prerelease.empty()) {
+        v += "-";
+        v += epiworld_version_prerelease;
+    }
+
+    return v;
+}
+
+namespace epiworld {
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/config.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_CONFIG_HPP
+#define EPIWORLD_CONFIG_HPP
+
+#ifndef printf_epiworld
+    #define printf_epiworld fflush(stdout);printf
+#endif
+
+// In case the user has a way to stop the program
+// This is called during `run_multiple()` and it is
+// passed the simulation number.
+#ifndef EPI_CHECK_USER_INTERRUPT
+    #define EPI_CHECK_USER_INTERRUPT(a)
+#endif
+
+#ifndef EPIWORLD_MAXNEIGHBORS
+    #define EPIWORLD_MAXNEIGHBORS 1048576
+#endif
+
+#if defined(_OPENMP) || defined(__OPENMP)
+    #include <omp.h>
+// #else
+//     #define omp_get_thread_num() 0
+//     #define omp_set_num_threads() 1
+#endif
+
+#ifndef epiworld_double
+    #define epiworld_double float
+#endif
+
+#ifndef epiworld_fast_int
+    #define epiworld_fast_int int
+#endif
+
+#ifndef epiworld_fast_uint
+    #define epiworld_fast_uint unsigned long long int
+#endif
+
+// Type used to store agent and entity ids in the network, the entities,
+// the agents, and contact tracing. Models with fewer than 2^32 agents can
+// define it as `uint32_t` to halve the memory of these arrays.
+#ifndef epiworld_agent_index
+    #define epiworld_agent_index size_t
+#endif
+
+// By default, `Model::rbinom` will use a Poisson approximation in the
+// rare-event regime where p <= 0.01 and n * p^2 <= 0.1. Advanced users can
+// disable this by defining EPI_NO_FAST_BINOM before including epiworld.
+#if !defined(EPI_NO_FAST_BINOM) && !defined(EPI_FAST_BINOM)
+    #define EPI_FAST_BINOM
+#endif
+
+#define EPI_DEFAULT_TSEQ int
+
+#ifndef EPI_MAX_TRACKING
+    #define EPI_MAX_TRACKING 200
+#endif
+
+// Lanes of the generator used by `Model::runif_batch_on()`. The sequence of
+// batched uniforms is reproducible for a given number of lanes.
+#ifndef EPI_RUNIF_LANES
+    #define EPI_RUNIF_LANES 4
+#endif
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class Model;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class Agent;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class PersonTools;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class Virus;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class Viruses;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class Viruses_const;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class Tool;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class Entity;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class GlobalEvent;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using VirusPtr = std::shared_ptr< Virus< TSeq > >;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using ToolPtr = std::shared_ptr< Tool< TSeq > >;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using EntityPtr = std::shared_ptr< Entity< TSeq > >;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using GlobalEventPtr = std::shared_ptr< GlobalEvent< TSeq > >;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using ToolFun = std::function<epiworld_double(Tool<TSeq>&,Agent<TSeq>*,VirusPtr<TSeq>&,Model<TSeq>*)>;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using MixerFun = std::function<epiworld_double(Agent<TSeq>*,VirusPtr<TSeq>&,Model<TSeq>*)>;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using MutFun = std::function<bool(Agent<TSeq>*,Virus<TSeq>&,Model<TSeq>*)>;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using PostRecoveryFun = std::function<void(Agent<TSeq>*,Virus<TSeq>&,Model<TSeq>*)>;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using VirusFun = std::function<epiworld_double(Agent<TSeq>*,Virus<TSeq>&,Model<TSeq>*)>;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using UpdateFun = std::function<void(Agent<TSeq>*,Model<TSeq>*)>;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using UpdateFunPtr = void (*)(Agent<TSeq>*,Model<TSeq>*); ///< Plain `UpdateFun`.
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using GlobalFun = std::function<void(Model<TSeq>*)>;
+
+template<typename TSeq>
+struct Event;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using EventFun = std::function<void(Event<TSeq>&,Model<TSeq>*)>;
+
+enum class EventAction : uint8_t {
+    AddVirus,
+    AddTool,
+    AddEntity,
+    RemoveVirus,
+    RemoveTool,
+    RemoveEntity,
+    ChangeState
+};
+
+/**
+ * @brief Decides how to distribute viruses at initialization
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using VirusToAgentFun = std::function<void(Virus<TSeq>&,Model<TSeq>*)>;
+
+/**
+ * @brief Decides how to distribute tools at initialization
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using ToolToAgentFun = std::function<void(Tool<TSeq>&,Model<TSeq>*)>;
+
+/**
+ * @brief Decides how to distribute entities at initialization
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using EntityToAgentFun = std::function<void(Entity<TSeq>&,Model<TSeq>*)>;
+
+/**
+ * @brief Event data for update an agent
+ *
+ * @tparam TSeq
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+struct Event {
+    Agent<TSeq> * agent;
+    VirusPtr<TSeq> virus;
+    ToolPtr<TSeq> tool;
+    Entity<TSeq> * entity;
+    epiworld_fast_int new_state;
+    epiworld_fast_int queue;
+    EventAction action;
+public:
+/**
+     * @brief Construct a new Event object
+     *
+     * All the parameters are rather optional.
+     *
+     * @param agent_ Agent over who the action will happen
+     * @param virus_ Virus to add
+     * @param tool_ Tool to add
+     * @param virus_idx Index of virus to be removed (if needed)
+     * @param tool_idx Index of tool to be removed (if needed)
+     * @param new_state_ Next state
+     * @param queue_ Efect on the queue
+     * @param action_ The action to execute
+     */
+    Event(
+        Agent<TSeq> * agent_,
+        VirusPtr<TSeq> & virus_,
+        ToolPtr<TSeq> & tool_,
+        Entity<TSeq> * entity_,
+        epiworld_fast_int new_state_,
+        epiworld_fast_int queue_,
+        EventAction action_
+    ) : agent(agent_), virus(virus_), tool(tool_), entity(entity_),
+        new_state(new_state_),
+        queue(queue_), action(action_) {
+            return;
+        };
+};
+
+/**
+ * @name Constants in epiworld
+ *
+ * @details The following are the default values some probabilities and
+ * rates take when no value has been specified in the model.
+ */
+///@{
+#ifndef DEFAULT_TOOL_CONTAGION_REDUCTION
+    #define DEFAULT_TOOL_CONTAGION_REDUCTION    0.0
+#endif
+
+#ifndef DEFAULT_TOOL_TRANSMISSION_REDUCTION
+    #define DEFAULT_TOOL_TRANSMISSION_REDUCTION 0.0
+#endif
+
+#ifndef DEFAULT_TOOL_RECOVERY_ENHANCER
+    #define DEFAULT_TOOL_RECOVERY_ENHANCER      0.0
+#endif
+
+#ifndef DEFAULT_TOOL_DEATH_REDUCTION
+    #define DEFAULT_TOOL_DEATH_REDUCTION        0.0
+#endif
+
+#ifndef EPI_DEFAULT_VIRUS_PROB_INFECTION
+    #define EPI_DEFAULT_VIRUS_PROB_INFECTION    1.0
+#endif
+
+#ifndef EPI_DEFAULT_VIRUS_PROB_RECOVERY
+    #define EPI_DEFAULT_VIRUS_PROB_RECOVERY     0.1428
+#endif
+
+#ifndef EPI_DEFAULT_VIRUS_PROB_DEATH
+    #define EPI_DEFAULT_VIRUS_PROB_DEATH        0.0
+#endif
+
+#ifndef EPI_DEFAULT_INCUBATION_DAYS
+    #define EPI_DEFAULT_INCUBATION_DAYS         7.0
+#endif
+///@}
+
+#ifdef EPI_DEBUG
+    #define EPI_DEBUG_PRINTF printf_epiworld
+
+    #define EPI_DEBUG_ERROR(etype, msg) \
+        (etype)("[[epi-debug]] (error) " + std::string(msg));
+
+    #define EPI_DEBUG_NOTIFY_ACTIVE() \
+        EPI_DEBUG_PRINTF("DEBUGGING ON (compiled with EPI_DEBUG defined)%s\n", "");
+
+    #define EPI_DEBUG_ALL_NON_NEGATIVE(vect) \
+        for (auto & v : vect) \
+            if (static_cast<double>(v) < 0.0) \
+                throw EPI_DEBUG_ERROR(std::logic_error, "A negative value not allowed.");
+
+    #define EPI_DEBUG_SUM_DBL(vect, num) \
+        double _epi_debug_sum = 0.0; \
+        for (auto & v : vect) \
+        {   \
+            _epi_debug_sum += static_cast<double>(v);\
+            if (_epi_debug_sum > static_cast<double>(num)) \
+                throw EPI_DEBUG_ERROR(std::logic_error, "The sum of elements not reached."); \
+        }
+
+    #define EPI_DEBUG_SUM_INT(vect, num) \
+        int _epi_debug_sum = 0; \
+        for (auto & v : vect) \
+        {   \
+            _epi_debug_sum += static_cast<int>(v);\
+            if (_epi_debug_sum > static_cast<int>(num)) \
+                throw EPI_DEBUG_ERROR(std::logic_error, "The sum of elements not reached."); \
+        }
+
+    #define EPI_DEBUG_VECTOR_MATCH_INT(a, b, c) \
+        if (a.size() != b.size())  {\
+            EPI_DEBUG_PRINTF("In '%s'", std::string(c).c_str()); \
+            EPI_DEBUG_PRINTF("Size of vector a: %lu\n", (a).size());\
+            EPI_DEBUG_PRINTF("Size of vector b: %lu\n", (b).size());\
+            throw EPI_DEBUG_ERROR(std::length_error, "The vectors do not match size."); \
+        }\
+        for (int _i = 0; _i < static_cast<int>(a.size()); ++_i) \
+            if (a[_i] != b[_i]) {\
+                EPI_DEBUG_PRINTF("In '%s'", std::string(c).c_str()); \
+                EPI_DEBUG_PRINTF("Iterating the last 5 values%s:\n", ""); \
+                for (int _j = std::max(0, static_cast<int>(_i) - 4); _j <= _i; ++_j) \
+                { \
+                    EPI_DEBUG_PRINTF( \
+                        "a[%i]: %i; b[%i]: %i\n", \
+                        _j, \
+                        static_cast<int>(a[_j]), \
+                        _j, static_cast<int>(b[_j])); \
+                } \
+                throw EPI_DEBUG_ERROR(std::logic_error, "The vectors do not match."); \
+            }
+
+    #define EPI_DEBUG_FAIL_AT_TRUE(a,b) \
+        if (a) \
+        {\
+            throw EPI_DEBUG_ERROR(std::logic_error, b); \
+        }
+
+    #define epiexception(a) std::logic_error
+#else
+    #define EPI_DEBUG_PRINTF(fmt, ...)
+    #define EPI_DEBUG_ERROR(fmt, ...)
+    #define EPI_DEBUG_NOTIFY_ACTIVE()
+    #define EPI_DEBUG_ALL_NON_NEGATIVE(vect)
+    #define EPI_DEBUG_SUM_DBL(vect, num)
+    #define EPI_DEBUG_SUM_INT(vect, num)
+    #define EPI_DEBUG_VECTOR_MATCH_INT(a, b, c)
+    #define EPI_DEBUG_FAIL_AT_TRUE(a, b) \
+        if (a) \
+            return false;
+    #define epiexception(a) a
+#endif
+
+#if defined(EPI_DEBUG_NO_THREAD_ID) || (!defined(__OPENMP) && !defined(_OPENMP))
+    #define EPI_GET_THREAD_ID() 0
+#else
+    #define EPI_GET_THREAD_ID() omp_get_thread_num()
+#endif
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/config.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/epiworld-macros.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MACROS_HPP
+#define EPIWORLD_MACROS_HPP
+
+/**
+ * @brief Helper macro to define a new tool
+ * 
+ */
+#define EPI_NEW_TOOL(fname,tseq) inline epiworld_double \
+(fname)(\
+    epiworld::Tool< tseq > & t, \
+    epiworld::Agent< tseq > * p, \
+    std::shared_ptr<epiworld::Virus< tseq >> v, \
+    epiworld::Model< tseq > * m\
+    )
+
+/**
+ * @brief Create a Tool within a function
+ * 
+ */
+#define EPI_NEW_TOOL_LAMBDA(funname,tseq) \
+    epiworld::ToolFun<tseq> funname = \
+    [](epiworld::Tool<tseq> & t, \
+    epiworld::Agent<tseq> * p, \
+    std::shared_ptr<epiworld::Virus<tseq>> v, \
+    epiworld::Model<tseq> * m) -> epiworld_double
+
+/**
+ * @brief Helper macro for accessing model parameters
+ * 
+ */
+#define EPI_PARAMS(i) m->operator()(i)
+
+/**
+ * @brief Helper macro for defining Mutation Functions
+ * 
+ */
+#define EPI_NEW_MUTFUN(funname,tseq) inline bool \
+    (funname)(\
+    epiworld::Agent<tseq> * p, \
+    epiworld::Virus<tseq> & v, \
+    epiworld::Model<tseq> * m )
+
+#define EPI_NEW_MUTFUN_LAMBDA(funname,tseq) \
+    epiworld::MutFun<tseq> funname = \
+    [](epiworld::Agent<tseq> * p, \
+    epiworld::Virus<tseq> & v, \
+    epiworld::Model<tseq> * m) -> void
+
+#define EPI_NEW_POSTRECOVERYFUN(funname,tseq) inline void \
+    (funname)( \
+    epiworld::Agent<tseq> * p, \
+    epiworld::Virus<tseq> & v, \
+    epiworld::Model<tseq> * m\
+    )
+
+#define EPI_NEW_POSTRECOVERYFUN_LAMBDA(funname,tseq) \
+    epiworld::PostRecoveryFun<tseq> funname = \
+    [](epiworld::Agent<tseq> * p, \
+    epiworld::Virus<tseq> & v , \
+    epiworld::Model<tseq> * m) -> void
+
+#define EPI_NEW_VIRUSFUN(funname,tseq) inline epiworld_double \
+    (funname)( \
+    epiworld::Agent<tseq> * p, \
+    epiworld::Virus<tseq> & v, \
+    epiworld::Model<tseq> * m\
+    )
+
+#define EPI_NEW_VIRUSFUN_LAMBDA(funname,TSeq) \
+    epiworld::VirusFun<TSeq> funname = \
+    [](epiworld::Agent<TSeq> * p, \
+    epiworld::Virus<TSeq> & v, \
+    epiworld::Model<TSeq> * m) -> epiworld_double
+
+#define EPI_RUNIF() m->runif()
+
+#define EPI_TOKENPASTE(a,b) a ## b
+#define MPAR(num) *(m->EPI_TOKENPASTE(p,num))
+
+#define EPI_NEW_UPDATEFUN(funname,tseq) inline void \
+    (funname)(epiworld::Agent<tseq> * p, epiworld::Model<tseq> * m)
+
+#define EPI_NEW_UPDATEFUN_LAMBDA(funname,tseq) \
+    epiworld::UpdateFun<tseq> funname = \
+    [](epiworld::Agent<tseq> * p, epiworld::Model<tseq> * m) -> void
+
+#define EPI_NEW_GLOBALFUN(funname,tseq) inline void \
+    (funname)(epiworld::Model<tseq>* m)
+
+#define EPI_NEW_GLOBALFUN_LAMBDA(funname,tseq) \
+    epiworld::GlobalFun<tseq> funname = \
+    [](epiworld::Model<tseq>* m) -> void
+
+
+#define EPI_NEW_ENTITYTOAGENTFUN(funname,tseq) inline void \
+    (funname)(epiworld::Entity<tseq> & e, epiworld::Model<tseq> * m)
+
+#define EPI_NEW_ENTITYTOAGENTFUN_LAMBDA(funname,tseq) \
+    epiworld::EntityToAgentFun<tseq> funname = \
+    [](epiworld::Entity<tseq> & e, epiworld::Model<tseq> * m) -> void
+
+// Use this to make it more efficient for storage if the type is small
+// and the pointer is not needed
+#define EPI_TYPENAME_TRAITS(tseq, bound) typename std::conditional< \
+    sizeof( tseq ) <= sizeof( bound ), \
+    tseq, \
+    std::shared_ptr< tseq > \
+    >::type
+
+#define EPI_IF_TSEQ_LESS_EQ_INT(tseq) \
+    if constexpr (sizeof( tseq ) <= sizeof( int ))
+
+#define EPI_CHECK_COALESCE(proposed_, virus_tool_, alt_) \
+    if (static_cast<int>(proposed_) == -99) {\
+        if (static_cast<int>(virus_tool_) == -99) \
+            (proposed_) = (alt_);\
+        else (proposed_) = (virus_tool_);}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/epiworld-macros.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/epiassert-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_EPIASSERT_HPP
+#define EPIWORLD_EPIASSERT_HPP
+
+/**
+ * @defgroup epiassert Argument Assertion Utilities
+ * @brief Runtime validation of function arguments.
+ *
+ * The `EpiAssert` class provides static template methods for validating
+ * function arguments. Each method works with both scalar and iterable
+ * (container) types via `if constexpr` dispatch. On failure the methods
+ * throw `std::range_error` or `std::invalid_argument` with a descriptive
+ * message that includes the variable name, the offending value, and an
+ * optional caller location string.
+ *
+ * @par Example
+ * @code
+ * EpiAssert::check_bounds(pop_size, 0, 10000, "pop_size", "Model::init");
+ * EpiAssert::check_probability(rate, "rate", "ModelSIR::ModelSIR");
+ * EpiAssert::check_sum(probs, 1.0, "probabilities", "create_init_function");
+ * @endcode
+ *
+ * @note Requires C++17 or later (`if constexpr`, `std::void_t`).
+ * @{
+ */
+
+namespace epiassert_detail {
+
+    /**
+     * @brief Type trait that detects iterable types (types with `begin()`
+     *        and `end()`).
+     *
+     * `std::string` is explicitly excluded so that it is treated as a
+     * scalar value rather than a character container.
+     */
+    template<typename T, typename = void>
+    struct is_iterable : std::false_type {};
+
+    template<typename T>
+    struct is_iterable<T, std::void_t<
+        decltype(std::begin(std::declval<const T &>())),
+        decltype(std::end(std::declval<const T &>()))
+    >> : std::true_type {};
+
+    template<>
+    struct is_iterable<std::string> : std::false_type {};
+
+    /**
+     * @brief Convert a numeric value to its string representation.
+     *
+     * Uses `std::ostringstream` so that floating-point values are printed
+     * with enough precision to be useful in error messages.
+     */
+    template<typename T>
+    inline std::string to_str(const T & v)
+    {
+        std::ostringstream oss;
+        oss << v;
+        return oss.str();
+    }
+
+} // namespace epiassert_detail
+
+/**
+ * @brief Argument-assertion utilities for epiworld.
+ *
+ * All methods are `static` and accept an optional @p varname (for the
+ * variable being checked) and @p caller (for the function or method that
+ * called the check). Both are used only in the error message.
+ */
+class EpiAssert {
+private:
+    /** @brief Format the caller location for error messages. */
+    static std::string fmt_location(const std::string & caller)
+    {
+        if (caller.empty())
+            return "";
+        return " (in '" + caller + "')";
+    }
+
+public:
+    // -----------------------------------------------------------------
+    //  check_bounds – value(s) in [lower, upper]
+    // -----------------------------------------------------------------
+
+    /**
+     * @brief Assert that @p value is in `[lower, upper]`.
+     *
+     * For container types every element is checked individually.
+     *
+     * @throws std::range_error if any value violates the bounds.
+     */
+    template<typename T, typename BoundT>
+    static void check_bounds(
+        const T      value,
+        const BoundT lower,
+        const BoundT upper,
+        const std::string varname = "value",
+        const std::string caller  = ""
+    )
+    {
+        if (lower > upper)
+        {
+            throw std::invalid_argument(
+                "check_bounds: 'lower' (" +
+                epiassert_detail::to_str(lower) +
+                ") must be <= 'upper' (" +
+                epiassert_detail::to_str(upper) + ")" +
+                fmt_location(caller)
+            );
+        }
+
+        if constexpr (epiassert_detail::is_iterable<T>::value)
+        {
+            size_t idx = 0;
+            for (const auto & v : value)
+            {
+                if ((v < lower) || (v > upper))
+                {
+                    throw std::range_error(
+                        "'" + varname + "[" +
+                        std::to_string(idx) + "]' must be in [" +
+                        epiassert_detail::to_str(lower) + ", " +
+                        epiassert_detail::to_str(upper) + "], but got " +
+                        epiassert_detail::to_str(v) +
+                        fmt_location(caller)
+                    );
+                }
+                ++idx;
+            }
+        }
+        else
+        {
+            if ((value < lower) || (value > upper))
+            {
+                throw std::range_error(
+                    "'" + varname + "' must be in [" +
+                    epiassert_detail::to_str(lower) + ", " +
+                    epiassert_detail::to_str(upper) + "], but got " +
+                    epiassert_detail::to_str(value) +
+                    fmt_location(caller)
+                );
+            }
+        }
+    }
+
+    // -----------------------------------------------------------------
+    //  check_non_negative – value(s) >= 0
+    // -----------------------------------------------------------------
+
+    /**
+     * @brief Assert that @p value is non-negative.
+     *
+     * For container types every element is checked individually.
+     *
+     * @throws std::range_error if any value is negative.
+     */
+    template<typename T>
+    static void check_non_negative(
+        const T value,
+        const std::string varname = "value",
+        const std::string caller  = ""
+    )
+    {
+        if constexpr (epiassert_detail::is_iterable<T>::value)
+        {
+            size_t idx = 0;
+            for (const auto & v : value)
+            {
+                if (v < 0)
+                {
+                    throw std::range_error(
+                        "'" + varname + "[" +
+                        std::to_string(idx) + "]' must be non-negative"
+                        ", but got " + epiassert_detail::to_str(v) +
+                        fmt_location(caller)
+                    );
+                }
+                ++idx;
+            }
+        }
+        else
+        {
+            if (value < 0)
+            {
+                throw std::range_error(
+                    "'" + varname + "' must be non-negative"
+                    ", but got " + epiassert_detail::to_str(value) +
+                    fmt_location(caller)
+                );
+            }
+        }
+    }
+
+    // -----------------------------------------------------------------
+    //  check_probability – value(s) in [0, 1]
+    // -----------------------------------------------------------------
+
+    /**
+     * @brief Assert that @p value is a valid probability in `[0, 1]`.
+     *
+     * For container types every element is checked individually.
+     *
+     * @throws std::range_error if any value is outside `[0, 1]`.
+     */
+    template<typename T>
+    static void check_probability(
+        const T value,
+        const std::string varname = "value",
+        const std::string caller  = ""
+    )
+    {
+        if constexpr (epiassert_detail::is_iterable<T>::value)
+        {
+            size_t idx = 0;
+            for (const auto & v : value)
+            {
+                if (v < 0.0 || v > 1.0)
+                {
+                    throw std::range_error(
+                        "'" + varname + "[" +
+                        std::to_string(idx) +
+                        "]' must be a probability in [0, 1]"
+                        ", but got " + epiassert_detail::to_str(v) +
+                        fmt_location(caller)
+                    );
+                }
+                ++idx;
+            }
+        }
+        else
+        {
+            if (value < 0.0 || value > 1.0)
+            {
+                throw std::range_error(
+                    "'" + varname +
+                    "' must be a probability in [0, 1]"
+                    ", but got " + epiassert_detail::to_str(value) +
+                    fmt_location(caller)
+                );
+            }
+        }
+    }
+
+    // -----------------------------------------------------------------
+    //  check_sum – container elements sum to target ± tolerance
+    // -----------------------------------------------------------------
+
+    /**
+     * @brief Assert that the elements of @p values sum to @p target
+     *        within ± @p tolerance.
+     *
+     * @throws std::invalid_argument if the sum is outside
+     *         `[target − tolerance, target + tolerance]`.
+     */
+    template<typename T>
+    static void check_sum(
+        const T      values,
+        double         target,
+        const std::string varname   = "values",
+        const std::string caller    = "",
+        double         tolerance = 1e-8
+    )
+    {
+        static_assert(
+            epiassert_detail::is_iterable<T>::value,
+            "check_sum requires an iterable type."
+        );
+
+        if (tolerance < 0.0)
+        {
+            throw std::invalid_argument(
+                "check_sum: 'tolerance' must be non-negative, but got " +
+                epiassert_detail::to_str(tolerance) +
+                fmt_location(caller)
+            );
+        }
+
+        double s = 0.0;
+        for (const auto & v : values)
+            s += static_cast<double>(v);
+
+        if (std::abs(s - target) > tolerance)
+        {
+            throw std::invalid_argument(
+                "'" + varname + "' elements must sum to " +
+                epiassert_detail::to_str(target) +
+                " (tolerance " + epiassert_detail::to_str(tolerance) +
+                "), but got " + epiassert_detail::to_str(s) +
+                fmt_location(caller)
+            );
+        }
+    }
+
+    // -----------------------------------------------------------------
+    //  check_size – container has expected number of elements
+    // -----------------------------------------------------------------
+
+    /**
+     * @brief Assert that @p values has exactly @p expected elements.
+     *
+     * @throws std::invalid_argument if the size differs.
+     */
+    template<typename T>
+    static void check_size(
+        const T values,
+        size_t    expected,
+        const std::string varname = "values",
+        const std::string caller  = ""
+    )
+    {
+        static_assert(
+            epiassert_detail::is_iterable<T>::value,
+            "check_size requires an iterable type."
+        );
+
+        const auto actual_size = static_cast<size_t>(
+            std::distance(std::begin(values), std::end(values))
+        );
+
+        if (actual_size != expected)
+        {
+            throw std::invalid_argument(
+                "'" + varname + "' must have " +
+                std::to_string(expected) + " elements, but got " +
+                std::to_string(actual_size) +
+                fmt_location(caller)
+            );
+        }
+    }
+
+    // -----------------------------------------------------------------
+    //  check – custom predicate validation
+    // -----------------------------------------------------------------
+
+    /**
+     * @brief Assert that @p pred returns `true` for @p value.
+     *
+     * The predicate receives the value by `const` reference and should
+     * return `true` when the value is valid.
+     *
+     * @throws std::invalid_argument with the caller-provided @p message
+     *         when the predicate returns `false`.
+     */
+    template<typename T, typename Predicate>
+    static void check(
+        const T     value,
+        Predicate     pred,
+        const std::string message,
+        const std::string caller = ""
+    )
+    {
+        if (!pred(value))
+        {
+            throw std::invalid_argument(
+                message + fmt_location(caller)
+            );
+        }
+    }
+};
+
+/** @} */  // end of epiassert group
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/epiassert-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/misc.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MISC_HPP
+#define EPIWORLD_MISC_HPP
+
+template<typename TSeq>
+class Model;
+
+template<typename TSeq>
+class Agent;
+
+// Relevant for anything using vecHasher function ------------------------------
+/**
+ * @brief Vector hasher
+ * @tparam T
+ */
+template <typename T>
+struct vecHasher {
+    std::size_t operator()(std::vector< T > const&  dat) const noexcept {
+
+        std::hash< T > hasher;
+        std::size_t hash = hasher(dat[0u]);
+
+        // ^ makes bitwise XOR
+        // 0x9e3779b9 is a 32 bit constant (comes from the golden ratio)
+        // << is a shift operator, something like lhs * 2^(rhs)
+        if (dat.size() > 1u)
+            for (epiworld_fast_uint i = 1u; i < dat.size(); ++i)
+                hash ^= hasher(dat[i]) + 0x9e3779b9 + (hash<<6) + (hash>>2);
+
+        return hash;
+
+    }
+};
+
+template<typename Ta = epiworld_double, typename Tb = epiworld_fast_uint>
+using MapVec_type = std::unordered_map< std::vector< Ta >, Tb, vecHasher<Ta>>;
+
+/**
+ * @name Default sequence initializers
+ *
+ * @details
+ * If the user does not provide a default sequence, this function is used when
+ * a sequence needs to be initialized. Some examples: `Agent`, `Virus`, and
+ * `Tool` need a default sequence.
+ *
+ * @tparam TSeq
+ * @return TSeq
+ */
+///@{
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline TSeq default_sequence(int seq_count);
+
+// Making it 'static' so that we don't have problems when including the
+// header. This is important during the linkage, e.g., in R.
+// See https://en.cppreference.com/w/cpp/language/storage_duration#Linkage
+// static int _n_sequences_created = 0;
+
+template<>
+inline bool default_sequence(int seq_count) {
+
+    if (seq_count == 2)
+        throw std::logic_error("Maximum number of sequence created.");
+
+    return seq_count++ ? false : true;
+}
+
+template<>
+inline int default_sequence(int seq_count) {
+    return seq_count++;
+}
+
+template<>
+inline epiworld_double default_sequence(int seq_count) {
+    return static_cast<epiworld_double>(seq_count++);
+}
+
+template<>
+inline std::vector<bool> default_sequence(int seq_count) {
+
+    if (seq_count == 2)
+        throw std::logic_error("Maximum number of sequence created.");
+
+    return {seq_count++ ? false : true};
+}
+
+template<>
+inline std::vector<int> default_sequence(int seq_count) {
+    return {seq_count++};
+}
+
+template<>
+inline std::vector<epiworld_double> default_sequence(int seq_count) {
+    return {static_cast<epiworld_double>(seq_count++)};
+}
+///@}
+
+/**
+ * @brief Check whether `a` is included in `b`
+ *
+ * @tparam Ta Type of `a`. Could be int, epiworld_double, etc.
+ * @param a Scalar of class `Ta`.
+ * @param b Vector `std::vector` of class `Ta`.
+ * @return `true` if `a in b`, and `false` otherwise.
+ */
+template<typename Ta>
+inline bool IN(const Ta & a, const std::vector< Ta > & b) noexcept
+{
+    for (const auto & i : b)
+        if (a == i)
+            return true;
+
+    return false;
+}
+
+/**
+ * @brief Conditional Weighted Sampling
+ *
+ * @details
+ * The sampling function will draw one of `{-1, 0,...,probs.size() - 1}` in a
+ * weighted fashion. The probabilities are drawn given that either one or none
+ * of the cases is drawn; in the latter returns -1.
+ *
+ * @param probs Vector of probabilities.
+ * @param m A `Model`. This is used to draw random uniform numbers.
+ * @return int If -1 then it means that none got sampled, otherwise the index
+ * of the entry that got drawn.
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ, typename TDbl = epiworld_double >
+inline int roulette(
+    const std::vector< TDbl > & probs,
+    Model<TSeq> * m
+    )
+{
+
+    // Step 1: Computing the prob on none
+    TDbl p_none = 1.0;
+    std::vector< int > certain_infection;
+    certain_infection.reserve(probs.size());
+
+    for (epiworld_fast_uint p = 0u; p < probs.size(); ++p)
+    {
+        p_none *= (1.0 - probs[p]);
+
+        if (probs[p] > (1 - 1e-100))
+            certain_infection.push_back(p);
+
+    }
+
+    TDbl r = static_cast<TDbl>(m->runif());
+    // If there are one or more probs that go close to 1, sample
+    // uniformly
+    if (certain_infection.size() > 0)
+        return certain_infection[std::floor(r * certain_infection.size())];
+
+    // Step 2: Calculating the prob of none or single
+    std::vector< TDbl > probs_only_p(probs.size());
+    TDbl p_none_or_single = p_none;
+    for (epiworld_fast_uint p = 0u; p < probs.size(); ++p)
+    {
+        probs_only_p[p] = probs[p] * (p_none / (1.0 - probs[p]));
+        p_none_or_single += probs_only_p[p];
+    }
+
+    // Step 3: Roulette
+    TDbl cumsum = p_none/p_none_or_single;
+    if (r < cumsum)
+    {
+        return -1;
+    }
+
+    for (epiworld_fast_uint p = 0u; p < probs.size(); ++p)
+    {
+        // If it yield here, then bingo, the individual will acquire the disease
+        cumsum += probs_only_p[p]/(p_none_or_single);
+        if (r < cumsum)
+            return static_cast<int>(p);
+
+    }
+
+
+    #ifdef EPI_DEBUG
+    printf_epiworld("[epi-debug] roulette::cumsum = %.4f\n", cumsum);
+    #endif
+
+    return static_cast<int>(probs.size() - 1u);
+
+}
+
+template<typename TSeq>
+inline int roulette(std::vector< double > & probs, Model<TSeq> * m)
+{
+    return roulette<TSeq, double>(probs, m);
+}
+
+template<typename TSeq>
+inline int roulette(std::vector< float > & probs, Model<TSeq> * m)
+{
+    return roulette<TSeq, float>(probs, m);
+}
+
+
+template<typename TSeq>
+inline int roulette(
+    epiworld_fast_uint nelements,
+    Model<TSeq> * m
+    )
+{
+
+    if ((nelements * 2) > m->array_double_tmp.size())
+    {
+        throw std::logic_error(
+            "Trying to sample from more data than there is in roulette!" +
+            std::to_string(nelements) + " vs " +
+            std::to_string(m->array_double_tmp.size())
+            );
+    }
+
+    // Step 1: Computing the prob on none
+    epiworld_double p_none = 1.0;
+    epiworld_fast_uint ncertain = 0u;
+    // std::vector< int > certain_infection;
+    for (epiworld_fast_uint p = 0u; p < nelements; ++p)
+    {
+        p_none *= (1.0 - m->array_double_tmp[p]);
+
+        if (m->array_double_tmp[p] > (1 - 1e-100))
+            m->array_double_tmp[nelements + ncertain++] = p;
+            // certain_infection.push_back(p);
+
+    }
+
+    epiworld_double r = m->runif();
+    // If there are one or more probs that go close to 1, sample
+    // uniformly
+    if (ncertain > 0u)
+        return m->array_double_tmp[nelements + std::floor(ncertain * r)]; //    certain_infection[std::floor(r * certain_infection.size())];
+
+    // Step 2: Calculating the prob of none or single
+    // std::vector< epiworld_double > probs_only_p;
+    epiworld_double p_none_or_single = p_none;
+    for (epiworld_fast_uint p = 0u; p < nelements; ++p)
+    {
+        m->array_double_tmp[nelements + p] =
+            m->array_double_tmp[p] * (p_none / (1.0 - m->array_double_tmp[p]));
+        p_none_or_single += m->array_double_tmp[nelements + p];
+    }
+
+    // Step 3: Roulette
+    epiworld_double cumsum = p_none/p_none_or_single;
+    if (r < cumsum)
+        return -1;
+
+    for (epiworld_fast_uint p = 0u; p < nelements; ++p)
+    {
+        // If it yield here, then bingo, the individual will acquire the disease
+        cumsum += m->array_double_tmp[nelements + p]/(p_none_or_single);
+        if (r < cumsum)
+            return static_cast<int>(p);
+
+    }
+
+    return static_cast<int>(nelements - 1u);
+
+}
+
+/**
+ * @brief Read parameters from a yaml file
+ *
+ * @details
+ * The file should have the following structure:
+ * ```yaml
+ * # Comment
+ * [name of parameter 1]: [value in T]
+ * [name of parameter 2]: [value in T]
+ * ...
+ * ```
+ *
+ * @tparam T Type of the parameter
+ * @param fn Path to the file containing the parameters
+ * @return std::map<std::string, T>
+ */
+template <typename T>
+inline std::map< std::string, T > read_yaml(std::string fn)
+{
+
+    std::ifstream paramsfile(fn);
+
+    if (!paramsfile)
+        throw std::logic_error("The file " + fn + " was not found.");
+
+    std::regex pattern("^([^:]+)\\s*[:]\\s*([-]?[0-9]+|[-]?[0-9]*\\.[0-9]+)?\\s*$");
+
+    std::string line;
+    std::smatch match;
+    auto empty = std::sregex_iterator();
+
+    // Making room
+    std::map<std::string, T> parameters;
+
+    while (std::getline(paramsfile, line))
+    {
+
+        // Is it a comment or an empty line?
+        if (std::regex_match(line, std::regex("^([*].+|//.+|#.+|\\s*)$")))
+            continue;
+
+        // Finding the pattern, if it doesn't match, then error
+        std::regex_match(line, match, pattern);
+
+        if (match.empty())
+            throw std::logic_error("Line has invalid format:\n" + line);
+
+        // Capturing the number
+        std::string anumber = match[2u].str() + match[3u].str();
+        T tmp_num = static_cast<T>(
+            std::strtod(anumber.c_str(), nullptr)
+            );
+
+        std::string pname = std::regex_replace(
+            match[1u].str(),
+            std::regex("^\\s+|\\s+$"),
+            "");
+
+        // Adding the parameter to the map
+        parameters[pname] = tmp_num;
+
+    }
+
+    return parameters;
+
+}
+
+
+
+/**
+ * @brief Cast a `Model` pointer to a specific model type
+ */
+#ifndef EPI_ASSUME
+    #if defined(EPI_DEBUG)
+        #include <cassert>
+        #define EPI_ASSUME(cond) assert(cond)
+    #elif defined(__clang__)
+        #define EPI_ASSUME(cond) __builtin_assume(cond)
+    #elif defined(_MSC_VER)
+        #define EPI_ASSUME(cond) __assume(cond)
+    #elif defined(__GNUC__)
+        #define EPI_ASSUME(cond) do { if (!(cond)) __builtin_unreachable(); } while (0)
+    #else
+        #define EPI_ASSUME(cond) ((void)0)
+    #endif
+#endif
+
+template<class To, class TSeq>
+inline To* model_cast(Model<TSeq>* m) {
+#ifdef EPI_DEBUG
+    auto* out = dynamic_cast<To*>(m);
+    assert(out != nullptr);
+    return out;
+#else
+    auto* out = static_cast<To*>(m);
+    EPI_ASSUME(out != nullptr);
+    return out;
+#endif
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/misc.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/progress.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_PROGRESS_HPP
+#define EPIWORLD_PROGRESS_HPP
+
+#ifndef EPIWORLD_PROGRESS_BAR_WIDTH
+#define EPIWORLD_PROGRESS_BAR_WIDTH 80
+#endif
+
+/**
+ * @brief A simple progress bar
+  */
+class Progress {
+private:
+    int    width;     ///< Total width size (number of bars)
+    int    n;         ///< Total number of iterations
+    epiworld_double step_size; ///< Size of the step
+    int last_loc;     ///< Last location of the bar
+    int cur_loc;      ///< Last location of the bar
+    int i;            ///< Current iteration step
+
+public:
+    Progress() {};
+    Progress(int n_, int width_);
+    ~Progress() {};
+
+    void start();
+    void next();
+    
+
+};
+
+inline Progress::Progress(int n_, int width_) {
+
+
+    if (n_ < 0)
+        throw std::invalid_argument("n must be greater or equal than 0.");
+
+    if (width_ <= 0)
+        throw std::invalid_argument("width must be greater than 0");
+
+    width     = std::max(7, width_ - 7);
+    n         = n_;
+    step_size = n == 0? width : static_cast<epiworld_double>(width)/
+        static_cast<epiworld_double>(n);
+    last_loc  = 0;
+    i         = 0;
+
+}
+
+inline void Progress::start()
+{
+
+    #ifndef EPI_DEBUG
+    for (int j = 0; j < (width); ++j)
+    {
+        printf_epiworld("_");
+    }
+    printf_epiworld("\n");
+    #endif
+}
+
+inline void Progress::next() {
+
+    if (i == 0)
+        start();
+
+    cur_loc = std::floor((++i) * step_size);
+
+    #ifndef EPI_DEBUG
+    for (int j = 0; j < (cur_loc - last_loc); ++j)
+    { 
+        printf_epiworld("|");
+    }
+
+    if (i == n)
+    {
+        printf_epiworld(" done.\n");
+    }
+    #endif
+
+    last_loc = cur_loc;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/progress.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/threadarray.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_THREADARRAY_HPP
+#define EPIWORLD_THREADARRAY_HPP
+
+/**
+ * @brief Fixed-size scratch array with one copy per thread
+ *
+ * @details Behaves like `std::array<T,N>` (only `operator[]` and `size()`
+ * are provided). By default there is a single copy. Once `split()` is on,
+ * every OpenMP thread indexes its own copy, so update functions running
+ * in parallel (see `Model<TSeq>::parallel_update_on()`) can use the
+ * model's temporary arrays without stepping on each other.
+ *
+ * @tparam T Type of the elements.
+ * @tparam N Number of elements.
+ */
+template<typename T, size_t N>
+class ThreadArray {
+private:
+    std::vector< std::array< T, N > > data = std::vector< std::array< T, N > >(1u);
+    bool splitted = false;
+
+public:
+
+    T & operator[](size_t i)
+    {
+        #ifdef _OPENMP
+        if (splitted)
+            return data[omp_get_thread_num()][i];
+        #endif
+        return data[0u][i];
+    }
+
+    const T & operator[](size_t i) const
+    {
+        #ifdef _OPENMP
+        if (splitted)
+            return data[omp_get_thread_num()][i];
+        #endif
+        return data[0u][i];
+    }
+
+    constexpr size_t size() const noexcept { return N; }
+
+    /**
+     * @brief Turns the per-thread copies on or off
+     * @param nthreads Number of copies to keep (ignored when `value` is
+     * false).
+     */
+    void split(bool value, size_t nthreads = 1u)
+    {
+        if (value && (data.size() < nthreads))
+            data.resize(nthreads);
+
+        splitted = value;
+    }
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/threadarray.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/rng-utils.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_RNG_UTILS_HPP
+#define EPIWORLD_RNG_UTILS_HPP
+
+#include <cstdint>
+#include <limits>
+#include <random>
+// (already included include/epiworld/config.hpp)
+
+/**
+ * @brief Fast 64-bit PRNG based on the xoshiro256** algorithm.
+ *
+ * xoshiro256** has 256-bit state, 64-bit output, and passes all known
+ * statistical tests. It is significantly faster than std::mt19937.
+ * State is seeded via SplitMix64 from a single 64-bit value.
+ *
+ * Reference: Blackman & Vigna, "Scrambled Linear Pseudorandom Number
+ * Generators", ACM TOMS, 2021. https://prng.di.unimi.it/
+ */
+class epi_xoshiro256ss {
+    uint64_t s[4];
+
+    static uint64_t rotl(const uint64_t x, int k) noexcept {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    static uint64_t splitmix64(uint64_t& x) noexcept {
+        x += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = x;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+public:
+    using result_type = uint64_t;
+
+    explicit epi_xoshiro256ss(uint64_t seed_val = 0) noexcept {
+        seed(seed_val);
+    }
+
+    static constexpr result_type min() noexcept { return 0; }
+    static constexpr result_type max() noexcept {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    void seed(uint64_t seed_val) noexcept {
+        s[0] = splitmix64(seed_val);
+        s[1] = splitmix64(seed_val);
+        s[2] = splitmix64(seed_val);
+        s[3] = splitmix64(seed_val);
+    }
+
+    /**
+     * @brief Copies the 256-bit state from/to `x` (e.g., for checkpoints)
+     */
+    ///@{
+    void get_state(uint64_t x[4]) const noexcept {
+        for (int i = 0; i < 4; ++i)
+            x[i] = s[i];
+    }
+
+    void set_state(const uint64_t x[4]) noexcept {
+        for (int i = 0; i < 4; ++i)
+            s[i] = x[i];
+    }
+    ///@}
+
+    result_type operator()() noexcept {
+        const uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    /**
+     * @brief Advances the state by 2^128 draws
+     * @details Used to split the sequence into non-overlapping streams
+     * (see `epi_xoshiro256ss_lanes`).
+     */
+    void jump() noexcept {
+
+        static constexpr uint64_t JUMP[4] = {
+            0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+            0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+        };
+
+        uint64_t j[4] = {0u, 0u, 0u, 0u};
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int b = 0; b < 64; ++b)
+            {
+                if (JUMP[i] & (uint64_t(1) << b))
+                    for (int k = 0; k < 4; ++k)
+                        j[k] ^= s[k];
+
+                (*this)();
+            }
+        }
+
+        set_state(j);
+
+    }
+};
+
+/**
+ * @brief Draw a uniform [0, 1) number from 64 random bits.
+ *
+ * Uses the top N bits (where N = std::numeric_limits<epiworld_double>::digits)
+ * to produce a value in [0, 1) without any long-double arithmetic.
+ */
+inline epiworld_double runif_from_bits(uint64_t x) noexcept {
+    static_assert(
+        std::numeric_limits<epiworld_double>::digits < 64,
+        "epiworld_double must have fewer than 64 mantissa bits; "
+        "the bit-extraction in runif_from_bits requires digits < 64 to avoid "
+        "undefined behaviour in the shift and scale computation"
+    );
+
+    constexpr int bits  = std::numeric_limits<epiworld_double>::digits;
+    constexpr int shift = 64 - bits;
+    // scale = 2^{-bits}: the result is in [0, 1) by construction (no clamp needed)
+    constexpr epiworld_double scale =
+        epiworld_double(1) / epiworld_double(uint64_t(1) << bits);
+    // Going through a 32-bit integer when possible, which converts to
+    // floating point with a single (vector) instruction
+    if constexpr (bits < 32)
+        return static_cast<epiworld_double>(
+            static_cast<int32_t>(x >> shift)
+        ) * scale;
+    else
+        return static_cast<epiworld_double>(
+            static_cast<int64_t>(x >> shift)
+        ) * scale;
+}
+
+/**
+ * @brief `L` interleaved xoshiro256** generators that fill blocks of numbers.
+ *
+ * Lane `l` starts `l` jumps (2^128 draws) ahead of an `epi_xoshiro256ss`
+ * seeded with the same value, so lanes never overlap. The state is stored
+ * by word (`s[word][lane]`), so each step updates the `L` lanes with the
+ * same operations and compilers vectorize the loop (e.g., AVX2 with
+ * `L = 4`, AVX-512 with `L = 8`).
+ *
+ * Block `k` holds the `k`-th output of every lane, so the sequence is
+ * reproducible for a fixed `L` but differs across values of `L`.
+ *
+ * @tparam L Number of lanes.
+ */
+template<size_t L = 4u>
+class epi_xoshiro256ss_lanes {
+    alignas(64) uint64_t s[4][L];
+
+public:
+    static constexpr size_t lanes = L;
+
+    explicit epi_xoshiro256ss_lanes(uint64_t seed_val = 0) noexcept {
+        seed(seed_val);
+    }
+
+    void seed(uint64_t seed_val) noexcept {
+
+        epi_xoshiro256ss eng(seed_val);
+        uint64_t x[4];
+        for (size_t l = 0u; l < L; ++l)
+        {
+            eng.get_state(x);
+            for (int w = 0; w < 4; ++w)
+                s[w][l] = x[w];
+
+            eng.jump();
+        }
+
+    }
+
+    /**
+     * @brief Copies the `4 * L` words of state from/to `x` (lane-major within
+     * each word, as stored).
+     */
+    ///@{
+    void get_state(uint64_t * x) const noexcept {
+        for (int w = 0; w < 4; ++w)
+            for (size_t l = 0u; l < L; ++l)
+                x[w * L + l] = s[w][l];
+    }
+
+    void set_state(const uint64_t * x) noexcept {
+        for (int w = 0; w < 4; ++w)
+            for (size_t l = 0u; l < L; ++l)
+                s[w][l] = x[w * L + l];
+    }
+    ///@}
+
+    /**
+     * @brief Writes `nblocks` blocks of `L` numbers to `out`
+     * @param out Array of at least `nblocks * L` elements.
+     * @param nblocks Number of blocks.
+     * @param conv Conversion applied to each 64-bit output.
+     */
+    template<typename T, typename TConv>
+    void fill(T * out, size_t nblocks, TConv conv) noexcept {
+
+        // Working on local copies lets the compiler keep the state in
+        // (vector) registers across blocks
+        alignas(64) uint64_t s0[L], s1[L], s2[L], s3[L], res[L];
+        for (size_t l = 0u; l < L; ++l)
+        {
+            s0[l] = s[0][l];
+            s1[l] = s[1][l];
+            s2[l] = s[2][l];
+            s3[l] = s[3][l];
+        }
+
+        for (size_t k = 0u; k < nblocks; ++k, out += L)
+        {
+
+            // Same as epi_xoshiro256ss::operator(); the multiplications by
+            // 5 and 9 are written as shifts so they vectorize without a
+            // 64-bit vector multiply.
+            for (size_t l = 0u; l < L; ++l)
+            {
+                const uint64_t r = (s1[l] << 2) + s1[l];
+                const uint64_t x = (r << 7) | (r >> 57);
+                res[l] = (x << 3) + x;
+
+                const uint64_t t = s1[l] << 17;
+                s2[l] ^= s0[l];
+                s3[l] ^= s1[l];
+                s1[l] ^= s2[l];
+                s0[l] ^= s3[l];
+                s2[l] ^= t;
+                s3[l] = (s3[l] << 45) | (s3[l] >> 19);
+            }
+
+            for (size_t l = 0u; l < L; ++l)
+                out[l] = conv(res[l]);
+
+        }
+
+        for (size_t l = 0u; l < L; ++l)
+        {
+            s[0][l] = s0[l];
+            s[1][l] = s1[l];
+            s[2][l] = s2[l];
+            s[3][l] = s3[l];
+        }
+
+    }
+
+    void fill(uint64_t * out, size_t nblocks) noexcept {
+        fill(out, nblocks, [](uint64_t x) noexcept { return x; });
+    }
+
+    /**
+     * @brief Writes `nblocks` blocks of `L` uniform [0, 1) numbers to `out`
+     * (see `runif_from_bits()`).
+     */
+    void fill_unif(epiworld_double * out, size_t nblocks) noexcept {
+        fill(out, nblocks, [](uint64_t x) noexcept { return runif_from_bits(x); });
+    }
+
+};
+
+/**
+ * @brief Counter-based 64-bit PRNG based on the Philox4x32-10 algorithm.
+ *
+ * The output is a pure function of a 64-bit key and a 128-bit counter, so
+ * any stream can be generated independently of every other (e.g., in a
+ * different thread) without carrying state around. The counter is split in
+ * three parts: a 64-bit stream id (e.g., the agent), a 32-bit sub-stream id
+ * (e.g., the day), and a 32-bit block index that advances as numbers are
+ * drawn. Each block yields two 64-bit numbers.
+ *
+ * Reference: Salmon, Moraes, Dror & Shaw, "Parallel Random Numbers: As
+ * Easy as 1, 2, 3", SC'11. https://www.deshawresearch.com/resources_random123.html
+ */
+class epi_philox4x32 {
+    uint32_t key[2]   = {0u, 0u};
+    uint32_t ctr[4]   = {0u, 0u, 0u, 0u};
+    uint32_t block[4] = {0u, 0u, 0u, 0u};
+    int used = 2; ///< Number of 64-bit words of `block` already returned.
+
+    static constexpr uint32_t M0 = 0xD2511F53u;
+    static constexpr uint32_t M1 = 0xCD9E8D57u;
+    static constexpr uint32_t W0 = 0x9E3779B9u;
+    static constexpr uint32_t W1 = 0xBB67AE85u;
+
+    void generate() noexcept {
+
+        uint32_t c[4] = {ctr[0], ctr[1], ctr[2], ctr[3]};
+        uint32_t k0 = key[0];
+        uint32_t k1 = key[1];
+
+        for (int r = 0; r < 10; ++r)
+        {
+            const uint64_t p0 = static_cast<uint64_t>(M0) * c[0];
+            const uint64_t p1 = static_cast<uint64_t>(M1) * c[2];
+
+            c[0] = static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k0;
+            c[1] = static_cast<uint32_t>(p1);
+            c[2] = static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k1;
+            c[3] = static_cast<uint32_t>(p0);
+
+            k0 += W0;
+            k1 += W1;
+        }
+
+        for (int i = 0; i < 4; ++i)
+            block[i] = c[i];
+
+        ++ctr[0];
+        used = 0;
+
+    }
+
+public:
+    using result_type = uint64_t;
+
+    explicit epi_philox4x32(uint64_t key_val = 0) noexcept {
+        seed(key_val);
+    }
+
+    static constexpr result_type min() noexcept { return 0; }
+    static constexpr result_type max() noexcept {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    /**
+     * @brief Sets the key and moves to the beginning of stream 0.
+     */
+    void seed(uint64_t key_val) noexcept {
+        key[0] = static_cast<uint32_t>(key_val);
+        key[1] = static_cast<uint32_t>(key_val >> 32);
+        set_stream(0u);
+    }
+
+    /**
+     * @brief Moves to the beginning of a stream (the key is kept).
+     * @param stream Stream id (e.g., agent id).
+     * @param substream Sub-stream id (e.g., day).
+     */
+    void set_stream(uint64_t stream, uint32_t substream = 0u) noexcept {
+        ctr[0] = 0u;
+        ctr[1] = substream;
+        ctr[2] = static_cast<uint32_t>(stream);
+        ctr[3] = static_cast<uint32_t>(stream >> 32);
+        used = 2;
+    }
+
+    /**
+     * @brief Raw 128-bit block for the current counter (used for testing).
+     */
+    const uint32_t * next_block() noexcept {
+        generate();
+        used = 2;
+        return block;
+    }
+
+    result_type operator()() noexcept {
+
+        if (used == 2)
+            generate();
+
+        const int i = 2 * (used++);
+        return (static_cast<uint64_t>(block[i]) << 32) | block[i + 1];
+
+    }
+};
+
+/**
+ * @brief Draw a uniform [0, 1) random number from a 64-bit engine
+ * (`epi_xoshiro256ss` or `epi_philox4x32`). See `runif_from_bits()`.
+ *
+ * @param engine An epi_xoshiro256ss or epi_philox4x32 engine.
+ * @return epiworld_double in [0, 1).
+ */
+template<typename TEngine>
+inline epiworld_double runif_epi(TEngine & engine) {
+    static_assert(
+        TEngine::max() == std::numeric_limits<uint64_t>::max(),
+        "runif_epi requires an engine with 64-bit output"
+    );
+
+    return runif_from_bits(engine());
+}
+
+/**
+ * @brief Draw a uniform [0, 1) random number from a std::mt19937 engine.
+ *
+ * Kept for backward compatibility with code that still holds a raw mt19937.
+ */
+inline epiworld_double runif_mt19937(std::mt19937 & engine) {
+    static constexpr epiworld_double factor =
+        epiworld_double(1) / (epiworld_double(std::mt19937::max()) + epiworld_double(1));
+    epiworld_double res = epiworld_double(engine()) * factor;
+    if (res >= epiworld_double(1))
+        res = std::nextafter(epiworld_double(1), epiworld_double(0));
+    return res;
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/rng-utils.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/modeldiagram-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELDIAGRAM_MEAT_HPP
+#define EPIWORLD_MODELDIAGRAM_MEAT_HPP
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/modeldiagram-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELDIAGRAM_HPP
+#define EPIWORLD_MODELDIAGRAM_HPP
+
+enum class DiagramType {
+    Mermaid, DOT
+};
+
+/**
+ * @brief Class to create model diagrams from transition data
+ * 
+ * This class reads transition data from epidemiological model simulations
+ * and generates visual diagrams representing the state transitions.
+ * It supports multiple diagram formats, including Mermaid and DOT.
+ * 
+ * @ingroup model_utilities
+ */
+class ModelDiagram {
+private:
+
+    std::map< std::pair< std::string, std::string >, int > data;
+    std::vector< std::string > states;
+    std::vector< epiworld_double > tprob;
+
+    void draw_mermaid(std::string fn_output, bool self);
+    void draw_dot(std::string fn_output, bool self);
+
+    void draw(
+        DiagramType diagram_type,
+        std::string fn_output = "",
+        bool self = false
+    );
+
+
+    int n_runs = 0; ///< The number of runs included in the diagram.
+
+    /**
+     * @brief Reads the transitions from a file.
+     * @details
+     * The file is assumed to come from the output of [Model::write_data()],
+     * and should be in the following format:
+     * ```
+     * 0 "S" "I" 10
+     * 1 "I" "R" 5
+     * 2 "R" "S" 3
+     * ...
+     * ```
+     * The first column is the step, the second column is the state from which
+     * the transition is made, the third column is the state to which the
+     * transition is made, and the fourth column is the number of transitions.
+     * 
+     * @param fn_transition The name of the file to read.
+     * @return void
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    void read_transitions(
+        const std::string & fn_transition
+    );
+
+    /**
+     * @brief In the case of multiple files (like from run_multiple)
+     * @param fns_transition The names of the files to read.
+     * @details
+     * It will read the transitions from multiple files and concatenate them.
+     * into the same object.
+     */
+    void read_transitions(
+        const std::vector< std::string > & fns_transition
+    );
+    
+    /**
+     * @brief Computes the transition probability matrix.
+     * @param normalize Whether to compute only the counts,
+     * otherwise the probabilities will be computed (row-stochastic).
+     * @return void
+     */
+    void transition_probability(bool normalize = true);
+
+    void clear();
+
+public:
+
+    ModelDiagram() {};
+
+    void draw_from_data(
+        DiagramType diagram_type,
+        const std::vector< std::string > & states,
+        const std::vector< epiworld_double > & tprob,
+        const std::string & fn_output = "",
+        bool self = false
+    );
+
+    void draw_from_file(
+        DiagramType diagram_type,
+        const std::string & fn_transition,
+        const std::string & fn_output = "",
+        bool self = false
+    );
+
+    void draw_from_files(
+        DiagramType diagram_type,
+        const std::vector< std::string > & fns_transition,
+        const std::string & fn_output = "",
+        bool self = false
+    );
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/modeldiagram-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+inline void ModelDiagram::read_transitions(
+    const std::string & fn_transition
+) {
+
+    // Checking if the file exists
+    std::ifstream file(fn_transition);
+
+    if (!file.is_open())
+        throw std::runtime_error(
+            "Could not open the file '" +
+            fn_transition + "' for reading."
+        );
+
+    // Reading the data
+    std::string line;
+    int i = 0;
+    while (std::getline(file, line))
+    {
+
+        // Skipping the first line
+        if (i++ == 0)
+            continue;
+
+        std::istringstream iss(line);
+        #ifdef EPI_DEBUG
+        int t;
+        iss >> t;
+        #endif
+
+        int i_;
+        std::string from_, to_;
+        int counts_;
+
+        iss >> i_;
+
+        // Read the quoted strings
+        iss >> std::quoted(from_) >> std::quoted(to_);
+
+        // Read the integer
+        iss >> counts_;
+
+        if (counts_ > 0)
+        {
+            auto idx = std::make_pair(from_, to_);
+            if (data.find(idx) == data.end())
+                data[idx] = counts_;
+            else
+                data[idx] += counts_;
+        }
+
+    }
+
+    // Incrementing the number of runs
+    this->n_runs++;
+
+}
+
+inline void ModelDiagram::read_transitions(
+    const std::vector< std::string > & fns_transition
+)
+{
+
+    for (const auto & fn: fns_transition)
+        this->read_transitions(fn);
+
+    return;
+
+}
+
+inline void ModelDiagram::transition_probability(
+    bool normalize
+)
+{
+
+    // Generating the map of states
+    std::set< std::string > states_set;
+
+    for (const auto & d: data)
+    {
+        states_set.insert(d.first.first);
+        states_set.insert(d.first.second);
+    }
+
+    // Generating the transition matrix
+    states = std::vector< std::string >(states_set.begin(), states_set.end());
+    size_t n_states = states.size();
+    tprob.assign(n_states * n_states, 0.0);
+
+    std::vector< epiworld_double > rowsum(n_states, 0.0);
+    for (size_t i = 0; i < n_states; ++i)
+    {
+
+        for (size_t j = 0; j < n_states; ++j)
+        {
+
+            auto key = std::make_pair(states[i], states[j]);
+            if (data.find(key) != data.end())
+                tprob[i + j * n_states] = static_cast<epiworld_double>(
+                    data[key]
+                );
+
+            if (normalize)
+                rowsum[i] += tprob[i + j * n_states];
+
+        }
+
+        if (normalize)
+        {
+            for (size_t j = 0; j < n_states; ++j)
+                tprob[i + j * n_states] /= rowsum[i];
+        }
+
+    }
+
+    return;
+
+
+}
+
+inline void ModelDiagram::clear()
+{
+    data.clear();
+    states.clear();
+    tprob.clear();
+    n_runs = 0;
+    return;
+}
+
+inline void ModelDiagram::draw_mermaid(
+    std::string fn_output,
+    bool self
+) {
+     // Getting a sorting vector of indices from the states
+    // string vector
+    std::vector< size_t > idx(states.size());
+    std::iota(idx.begin(), idx.end(), 0u);
+
+    std::sort(
+        idx.begin(),
+        idx.end(),
+        [&states = this->states](size_t i, size_t j) {
+            return states[i] < states[j];
+        }
+    );
+
+    std::vector< std::string > states_ids;
+    for (size_t i = 0u; i < states.size(); ++i)
+        states_ids.push_back("s" + std::to_string(i));
+
+    std::string graph = "flowchart TB\n";
+
+    // Declaring the states
+    for (size_t i = 0u; i < states.size(); ++i)
+    {
+        graph += "\t" + states_ids[i] + "[" + states[idx[i]] + "]\n";
+    }
+
+    // Adding the transitions
+    size_t n_states = states.size();
+    for (size_t i = 0u; i < states.size(); ++i)
+    {
+        for (size_t j = 0u; j < states.size(); ++j)
+        {
+            if (!self && i == j)
+                continue;
+
+            if (tprob[idx[i] + idx[j] * n_states] > 0.0)
+            {
+                graph += "\t" + states_ids[i] + " -->|" +
+                    std::to_string(tprob[idx[i] + idx[j] * n_states]) +
+                    "| " + states_ids[j] + "\n";
+            }
+        }
+    }
+
+    if (fn_output != "")
+    {
+        std::ofstream file(fn_output);
+
+        if (!file.is_open())
+            throw std::runtime_error(
+                "Could not open the file " +
+                fn_output +
+                " for writing."
+            );
+
+        file << graph;
+        file.close();
+
+    } else {
+        printf_epiworld("%s\n", graph.c_str());
+    }
+
+    return;
+}
+
+inline void ModelDiagram::draw_dot(std::string fn_output, bool self) {
+    std::vector<size_t> idx(states.size());
+    std::iota(idx.begin(), idx.end(), 0u);
+
+    std::sort(
+        idx.begin(),
+        idx.end(),
+        [&states = this->states](size_t i, size_t j) {
+            return states[i] < states[j];
+        }
+    );
+
+    std::vector<std::string> states_ids;
+    for (size_t i = 0u; i < states.size(); ++i)
+        states_ids.push_back("s" + std::to_string(i));
+
+    std::string graph = "digraph G {\n\trankdir=LR;\n";
+
+    // Declaring the states
+    for (size_t i = 0u; i < states.size(); ++i)
+    {
+        graph += "\t" + states_ids[i] + " [label=\"" + states[idx[i]] + "\"];\n";
+    }
+
+    // Adding the transitions
+    size_t n_states = states.size();
+    for (size_t i = 0u; i < states.size(); ++i)
+    {
+        for (size_t j = 0u; j < states.size(); ++j)
+        {
+            if (!self && i == j)
+                continue;
+
+            if (tprob[idx[i] + idx[j] * n_states] > 0.0)
+            {
+                graph += "\t" + states_ids[i] + " -> " + states_ids[j] +
+                         " [label=\"" +
+                         std::to_string(tprob[idx[i] + idx[j] * n_states]) +
+                         "\"];\n";
+            }
+        }
+    }
+
+    graph += "}\n";
+
+    if (fn_output != "")
+    {
+        std::ofstream file(fn_output);
+
+        if (!file.is_open())
+            throw std::runtime_error(
+                "Could not open the file " +
+                fn_output +
+                " for writing."
+            );
+
+        file << graph;
+        file.close();
+
+    } else {
+        printf_epiworld("%s\n", graph.c_str());
+    }
+
+    return;
+}
+
+inline void ModelDiagram::draw(
+    DiagramType diagram_type,
+    std::string fn_output,
+    bool self
+)
+{
+    switch (diagram_type) {
+    case DiagramType::Mermaid:
+        return draw_mermaid(fn_output, self);
+    case DiagramType::DOT:
+        return draw_dot(fn_output, self);
+    default:
+  		throw std::logic_error("Unknown how to dispatch DiagramType.");
+    }
+}
+
+inline void ModelDiagram::draw_from_file(
+    DiagramType diagram_type,
+    const std::string & fn_transition,
+    const std::string & fn_output,
+    bool self
+) {
+
+    this->clear();
+
+    // Loading the transition file
+    this->read_transitions(fn_transition);
+
+    // Computing the transition probability
+    this->transition_probability();
+
+    // Actually drawing the diagram
+    this->draw(diagram_type, fn_output, self);
+
+    return;
+
+}
+
+inline void ModelDiagram::draw_from_files(
+    DiagramType diagram_type,
+    const std::vector< std::string > & fns_transition,
+    const std::string & fn_output,
+    bool self
+) {
+
+    this->clear();
+
+    // Loading the transition files
+    this->read_transitions(fns_transition);
+
+    // Computing the transition probability
+    this->transition_probability();
+
+    // Actually drawing the diagram
+    this->draw(diagram_type, fn_output, self);
+
+    return;
+}
+
+inline void ModelDiagram::draw_from_data(
+    DiagramType diagram_type,
+    const std::vector< std::string > & states,
+    const std::vector< epiworld_double > & tprob,
+    const std::string & fn_output,
+    bool self
+) {
+
+    this->clear();
+
+    this->states = states;
+    this->tprob = tprob;
+
+    this->draw(diagram_type, fn_output, self);
+
+    return;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/modeldiagram-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/math/distributions.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MATH_DISTRIBUTIONS_HPP
+#define EPIWORLD_MATH_DISTRIBUTIONS_HPP
+
+// Implementing the factorial function
+/**
+ * @brief Compute the log of the factorial
+ * 
+ * @param n Number
+ * 
+ * @return The log of the factorial
+ */
+inline double log_factorial(int n)
+{
+    if (n == 0)
+        return 0.0;
+    return std::log(static_cast<double>(n)) + log_factorial(n-1);
+}
+
+/**
+ * @brief Compute the Poisson probability
+ * 
+ * @param k Number of events
+ * @param lambda Rate
+ * @param max_n Maximum number of events
+ * @param as_log Return the log of the probability
+ * 
+ * @return The Poisson probability
+ */
+inline double dpois(
+    int k,
+    double lambda,
+    int max_n = 100,
+    bool as_log = false
+    )
+{
+
+    if (max_n < k)
+        throw std::runtime_error("max_n must be greater than k");
+
+    double res = k * std::log(lambda) - lambda - log_factorial(
+        std::min(k, max_n)
+        );
+    
+    return as_log ? res : std::exp(res);
+}
+
+/**
+ * @brief Compute the probability of the generation interval
+ * 
+ * @details
+ * If `p_0_approx` is negative, it will be computed using the Poisson
+ * distribution. If `normalizing` is negative, it will be computed on the fly
+ * 
+ * @param g Generation interval
+ * @param S Population size
+ * @param p_c Probability of contact
+ * @param p_i Probability of infection
+ * @param p_r Probability of recovery
+ * @param p_0_approx Approximation of the probability of not being infected
+ * @param normalizing Normalizing constant
+ * @param max_contacts Maximum number of contacts
+ * @param max_days Maximum number of days
+ * 
+ * @return The probability of the generation interval
+ * 
+ */
+inline double dgenint(
+    int g,
+    double S,
+    double p_c,
+    double p_i,
+    double p_r,
+    double & p_0_approx,
+    double & normalizing,
+    int max_contacts = 200,
+    int max_days = 200
+    ) {
+
+    if ((g < 1) || (g > max_days))
+        return 0.0;
+
+    if (p_0_approx < 0.0)
+    {
+
+        p_0_approx = 0.0;
+        for (int i = 0; i < max_contacts; ++i)
+        {
+
+            p_0_approx += std::exp(
+                dpois(i, S * p_c, max_contacts, true) +
+                std::log(1.0 - p_i) * static_cast<double>(i)
+                );
+
+        }
+    }
+
+    double g_dbl = static_cast<double>(g);
+
+    if (normalizing < 0.0)
+    {
+
+        normalizing = 1.0;
+        double log1_p_r = std::log(1.0 - p_r);
+        double log_p_r = std::log(p_r);
+        double log_p_0_approx = std::log(p_0_approx);
+        for (int i = 1; i <= max_days; ++i)
+        {
+
+            double i_dbl = static_cast<double>(i);
+
+            normalizing -= std::exp(
+                log1_p_r * (i_dbl - 1.0) +
+                log_p_r +
+                log_p_0_approx * (i_dbl - 1.0)
+                );
+        }
+
+    }
+
+
+    return std::exp(
+        std::log(1 - p_r) * (g_dbl)+
+        std::log(p_0_approx) * (g_dbl - 1.0) +
+        std::log(1.0 - p_0_approx) -
+        std::log(normalizing)
+        );
+
+}
+
+// Mean of the generation interval
+/**
+ * @brief Compute the mean of the generation interval
+ * @param S Population size.
+ * @param p_c Probability of contact.
+ * @param p_i Probability of infection.
+ * @param p_r Probability of recovery.
+ * @param max_days Maximum number of days.
+ * @param max_n Maximum number of contacts.
+ * 
+ * @return The mean of the generation interval
+ */
+inline double gen_int_mean(
+    double S,
+    double p_c,
+    double p_i,
+    double p_r,
+    int max_days = 200,
+    int max_n = 200
+    ) {
+
+    double mean = 0.0;
+    double p_0_approx = -1.0;
+    double normalizing = -1.0;
+    for (int i = 1; i < max_days; ++i)
+    {
+        mean += 
+            static_cast<double>(i) *
+            dgenint(
+                i, S, p_c, p_i, p_r, p_0_approx, normalizing, max_n, max_days
+                );
+
+    }
+
+    return mean;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/math/distributions.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/math/lfmcmc.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_LFMCMC_HPP
+#define EPIWORLD_LFMCMC_HPP
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/math/lfmcmc/lfmcmc-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_LFMCMC_BONES_HPP
+#define EPIWORLD_LFMCMC_BONES_HPP
+
+#ifndef epiworld_double
+    #define epiworld_double float
+#endif
+
+
+template<typename TData>
+class LFMCMC;
+
+template<typename TData>
+using LFMCMCSimFun = std::function<TData(const std::vector< epiworld_double >&,LFMCMC<TData>*)>;
+
+template<typename TData>
+using LFMCMCSummaryFun = std::function<void(std::vector< epiworld_double >&,const TData&,LFMCMC<TData>*)>;
+
+template<typename TData>
+using LFMCMCProposalFun = std::function<void(std::vector< epiworld_double >&,const std::vector< epiworld_double >&,LFMCMC<TData>*)>;
+
+template<typename TData>
+using LFMCMCKernelFun = std::function<epiworld_double(const std::vector< epiworld_double >&,const std::vector< epiworld_double >&,epiworld_double,LFMCMC<TData>*)>;
+
+/**
+ * @brief Proposal function
+ * @param new_params Vector where to save the new parameters.
+ * @param old_params Vector of reference parameters.
+ * @param m LFMCMC model.
+ * @tparam TData 
+ */
+template<typename TData>
+inline void proposal_fun_normal(
+    std::vector< epiworld_double >& new_params,
+    const std::vector< epiworld_double >& old_params,
+    LFMCMC<TData>* m
+);
+
+/**
+ * @brief Factory for a reflective normal kernel
+ * 
+ * @details Reflective kernel corrects proposals by forcing them to be
+ * within prespecified boundaries. 
+ * 
+ * @tparam TData 
+ * @param scale Scale of the normal kernel
+ * @param lb Lower bound (applies the same to all parameters)
+ * @param ub Upper bound (applies the same to all parameters)
+ * @return LFMCMCProposalFun<TData> 
+ */
+template<typename TData>
+inline LFMCMCProposalFun<TData> make_proposal_norm_reflective(
+    epiworld_double scale,
+    epiworld_double lb = std::numeric_limits<epiworld_double>::min(),
+    epiworld_double ub = std::numeric_limits<epiworld_double>::max()
+);
+
+/**
+ * @brief Uniform proposal kernel
+ * 
+ * Proposals are made within a radious 1 of the current
+ * state of the parameters.
+ * 
+ * @param new_params Where to write the new parameters
+ * @param old_params Reference parameters
+ * @tparam TData 
+ * @param m LFMCMC model.
+ */
+template<typename TData>
+inline void proposal_fun_unif(
+    std::vector< epiworld_double >& new_params,
+    const std::vector< epiworld_double >& old_params,
+    LFMCMC<TData>* m
+);
+
+/**
+ * @brief Uses the uniform kernel with euclidean distance
+ * 
+ * @param simulated_stats Vector of statistics based on 
+ * simulated data
+ * @param observed_stats Vector of observed statistics
+ * @param epsilon Epsilon parameter
+ * @param m LFMCMC model
+ * @return epiworld_double 
+ */
+template<typename TData>
+inline epiworld_double kernel_fun_uniform(
+    const std::vector< epiworld_double >& simulated_stats,
+    const std::vector< epiworld_double >& observed_stats,
+    epiworld_double epsilon,
+    LFMCMC<TData>* m
+);
+
+/**
+ * @brief Gaussian kernel
+ * 
+ * @tparam TData 
+ * @param simulated_stats Vector of statistics based on 
+ * simulated data
+ * @param observed_stats Vector of observed statistics
+ * @param epsilon Epsilon parameter
+ * @param m LFMCMC model
+ * @return epiworld_double 
+ */
+template<typename TData>
+inline epiworld_double kernel_fun_gaussian(
+    const std::vector< epiworld_double >& simulated_stats,
+    const std::vector< epiworld_double >& observed_stats,
+    epiworld_double epsilon,
+    LFMCMC<TData>* m
+);
+
+/**
+ * @brief Likelihood-Free Markov Chain Monte Carlo
+ * 
+ * @tparam TData Type of data that is generated
+ */
+template<typename TData>
+class LFMCMC {
+private:
+
+    // Random number sampling
+    std::shared_ptr< epi_xoshiro256ss > m_engine = nullptr;
+    
+    std::shared_ptr< std::normal_distribution<> > rnormd =
+        std::make_shared< std::normal_distribution<> >(0.0);
+
+    std::shared_ptr< std::gamma_distribution<> > rgammad = 
+        std::make_shared< std::gamma_distribution<> >();
+
+    // Process data
+    TData m_observed_data;
+    std::vector< TData > * m_simulated_data = nullptr;
+
+    // Information about the size of the process
+    size_t m_n_samples;
+    size_t m_n_stats;
+    size_t m_n_params;
+
+    epiworld_double m_epsilon;
+
+    std::vector< epiworld_double > m_initial_params;             ///< Initial parameters
+    std::vector< epiworld_double > m_current_proposed_params;    ///< Proposed parameters for the next sample
+    std::vector< epiworld_double > m_current_accepted_params;    ///< Most recently accepted parameters (current state of MCMC)
+    std::vector< epiworld_double > m_current_proposed_stats;     ///< Statistics from simulation run with proposed parameters
+    std::vector< epiworld_double > m_current_accepted_stats;     ///< Statistics from simulation run with most recently accepted params
+
+    std::vector< epiworld_double > m_observed_stats;             ///< Observed statistics
+
+    std::vector< epiworld_double > m_all_sample_params;          ///< Parameter samples
+    std::vector< epiworld_double > m_all_sample_stats;           ///< Statistic samples
+    std::vector< bool >            m_all_sample_acceptance;      ///< Indicator if sample was accepted
+    std::vector< epiworld_double > m_all_sample_drawn_prob;      ///< Drawn probabilities (runif()) for each sample
+    std::vector< epiworld_double > m_all_sample_kernel_scores;   ///< Kernel scores for each sample
+
+    std::vector< epiworld_double > m_all_accepted_params;        ///< Posterior distribution of parameters from accepted samples
+    std::vector< epiworld_double > m_all_accepted_stats;         ///< Posterior distribution of statistics from accepted samples
+    std::vector< epiworld_double > m_all_accepted_kernel_scores; ///< Kernel scores for each accepted sample
+
+    // Functions
+    LFMCMCSimFun<TData> m_simulation_fun;
+    LFMCMCSummaryFun<TData> m_summary_fun;
+    LFMCMCProposalFun<TData> m_proposal_fun = proposal_fun_normal<TData>;
+    LFMCMCKernelFun<TData> m_kernel_fun     = kernel_fun_uniform<TData>;
+
+    // Misc
+    std::vector< std::string > m_param_names;
+    std::vector< std::string > m_stat_names;
+
+    std::chrono::time_point<std::chrono::steady_clock> m_start_time;
+    std::chrono::time_point<std::chrono::steady_clock> m_end_time;
+
+    // Timing
+    // std::chrono::milliseconds
+    std::chrono::duration<epiworld_double,std::micro> m_elapsed_time = 
+        std::chrono::duration<epiworld_double,std::micro>::zero();
+
+    inline void get_elapsed_time(
+        std::string unit,
+        epiworld_double * last_elapsed,
+        std::string * unit_abbr,
+        bool print
+    ) const;
+
+    void chrono_start();
+    void chrono_end();
+
+    // Progress
+    bool verbose = true;
+    Progress progress_bar;
+    
+public:
+
+    void run(
+        std::vector< epiworld_double > params_init_,
+        size_t n_samples_,
+        epiworld_double epsilon_,
+        int seed = -1
+        );
+
+    LFMCMC() {};
+    LFMCMC(const TData & observed_data_) : m_observed_data(observed_data_) {};
+    ~LFMCMC() {};
+
+    // Setting LFMCMC variables
+    void set_observed_data(const TData & observed_data_) {m_observed_data = observed_data_;};
+    
+    void set_proposal_fun(LFMCMCProposalFun<TData> fun);
+    void set_simulation_fun(LFMCMCSimFun<TData> fun);
+    void set_summary_fun(LFMCMCSummaryFun<TData> fun);
+    void set_kernel_fun(LFMCMCKernelFun<TData> fun);
+
+    void set_params_names(std::vector< std::string > names);
+    void set_stats_names(std::vector< std::string > names);
+    
+    /**
+     * @name Random number generation
+     * 
+     * @param eng 
+     */
+    ///@{
+    void set_rand_engine(std::shared_ptr< epi_xoshiro256ss > & eng);
+    std::shared_ptr< epi_xoshiro256ss > & get_rand_endgine();
+    void seed(epiworld_fast_uint s);
+    void set_rand_gamma(epiworld_double alpha, epiworld_double beta);
+    epiworld_double runif();
+    epiworld_double rnorm();
+    epiworld_double rgamma();
+    epiworld_double runif(epiworld_double lb, epiworld_double ub);
+    epiworld_double rnorm(epiworld_double mean, epiworld_double sd);
+    epiworld_double rgamma(epiworld_double alpha, epiworld_double beta);
+    ///@}
+
+    // Accessing parameters of the function
+    size_t get_n_samples() const {return m_n_samples;};
+    size_t get_n_stats() const {return m_n_stats;};
+    size_t get_n_params() const {return m_n_params;};
+    epiworld_double get_epsilon() const {return m_epsilon;};
+
+    const std::vector< epiworld_double > & get_initial_params() const {return m_initial_params;};
+    const std::vector< epiworld_double > & get_current_proposed_params() const {return m_current_proposed_params;};
+    const std::vector< epiworld_double > & get_current_accepted_params() const {return m_current_accepted_params;};
+    const std::vector< epiworld_double > & get_current_proposed_stats() const {return m_current_proposed_stats;};
+    const std::vector< epiworld_double > & get_current_accepted_stats() const {return m_current_accepted_stats;};
+
+    const std::vector< epiworld_double > & get_observed_stats() const {return m_observed_stats;};
+
+    const std::vector< epiworld_double > & get_all_sample_params() const {return m_all_sample_params;};
+    const std::vector< epiworld_double > & get_all_sample_stats() const {return m_all_sample_stats;};
+    const std::vector< bool >            & get_all_sample_acceptance() const {return m_all_sample_acceptance;};
+    const std::vector< epiworld_double > & get_all_sample_drawn_prob() const {return m_all_sample_drawn_prob;};
+    const std::vector< epiworld_double > & get_all_sample_kernel_scores() const {return m_all_sample_kernel_scores;};
+
+    const std::vector< epiworld_double > & get_all_accepted_params() const {return m_all_accepted_params;};
+    const std::vector< epiworld_double > & get_all_accepted_stats() const {return m_all_accepted_stats;};
+    const std::vector< epiworld_double > & get_all_accepted_kernel_scores() const {return m_all_accepted_kernel_scores;};
+    
+    std::vector< TData > * get_simulated_data() const {return m_simulated_data;};
+
+    std::vector< epiworld_double > get_mean_params();
+    std::vector< epiworld_double > get_mean_stats();
+
+    // Printing
+    LFMCMC<TData> & verbose_off();
+    LFMCMC<TData> & verbose_on();
+    void print(size_t burnin = 0u) const;
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/math/lfmcmc/lfmcmc-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/math/lfmcmc/lfmcmc-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_LFMCMC_MEAT_HPP
+#define EPIWORLD_LFMCMC_MEAT_HPP
+
+// (already included include/epiworld/math/lfmcmc/lfmcmc-bones.hpp)
+
+/**
+ * @brief Proposal function
+ * @param new_params Vector where to save the new parameters.
+ * @param old_params Vector of reference parameters.
+ * @param m LFMCMC model.
+ * @tparam TData 
+ */
+template<typename TData>
+inline void proposal_fun_normal(
+    std::vector< epiworld_double >& new_params,
+    const std::vector< epiworld_double >& old_params,
+    LFMCMC<TData>* m
+) {
+
+    for (size_t p = 0u; p < m->get_n_params(); ++p)
+        new_params[p] = old_params[p] + m->rnorm();
+
+    return;
+}
+
+/**
+ * @brief Factory for a reflective normal kernel
+ * 
+ * @details Reflective kernel corrects proposals by forcing them to be
+ * within prespecified boundaries. 
+ * 
+ * @tparam TData 
+ * @param scale Scale of the normal kernel
+ * @param lb Lower bound (applies the same to all parameters)
+ * @param ub Upper bound (applies the same to all parameters)
+ * @return LFMCMCProposalFun<TData> 
+ */
+template<typename TData>
+inline LFMCMCProposalFun<TData> make_proposal_norm_reflective(
+    epiworld_double scale,
+    epiworld_double lb,
+    epiworld_double ub
+) {
+
+    LFMCMCProposalFun<TData> fun =
+        [scale,lb,ub](
+            std::vector< epiworld_double >& new_params,
+            const std::vector< epiworld_double >& old_params,
+            LFMCMC<TData>* m
+        ) {
+
+        // Making the proposal
+        for (size_t p = 0u; p < m->get_n_params(); ++p)
+            new_params[p] = old_params[p] + m->rnorm() * scale;
+
+        // Checking boundaries
+        epiworld_double d = ub - lb;
+        int odd;
+        epiworld_double d_above, d_below;
+        for (auto & p : new_params)
+        {
+
+            // Correcting if parameter goes above the upper bound
+            if (p > ub)
+            {
+                d_above = p - ub;
+                odd     = static_cast<int>(std::floor(d_above / d)) % 2;
+                d_above = d_above - std::floor(d_above / d) * d;
+
+                p = (lb + d_above) * odd +
+                    (ub - d_above) * (1 - odd);
+
+            // Correcting if parameter goes below upper bound
+            } else if (p < lb)
+            {
+                d_below = lb - p;
+                int odd = static_cast<int>(std::floor(d_below / d)) % 2;
+                d_below = d_below - std::floor(d_below / d) * d;
+
+                p = (ub - d_below) * odd +
+                    (lb + d_below) * (1 - odd);
+            }
+
+        }
+
+        #ifdef EPI_DEBUG
+        for (auto & p : new_params)
+            if (p < lb || p > ub)
+                throw std::range_error("The parameter is out of bounds.");
+        #endif
+
+
+        return;
+
+    };
+
+    return fun;
+}
+
+/**
+ * @brief Uniform proposal kernel
+ * 
+ * Proposals are made within a radious 1 of the current
+ * state of the parameters.
+ * 
+ * @param new_params Where to write the new parameters
+ * @param old_params Reference parameters
+ * @tparam TData 
+ * @param m LFMCMC model.
+ */
+template<typename TData>
+inline void proposal_fun_unif(
+    std::vector< epiworld_double >& new_params,
+    const std::vector< epiworld_double >& old_params,
+    LFMCMC<TData>* m
+) {
+
+    for (size_t p = 0u; p < m->get_n_params(); ++p)
+        new_params[p] = (old_params[p] + m->runif(-1.0, 1.0));
+
+    return;
+}
+
+/**
+ * @brief Uses the uniform kernel with euclidean distance
+ * 
+ * @param simulated_stats Vector of statistics based on 
+ * simulated data
+ * @param observed_stats Vector of observed statistics
+ * @param epsilon Epsilon parameter
+ * @param m LFMCMC model
+ * @return epiworld_double 
+ */
+template<typename TData>
+inline epiworld_double kernel_fun_uniform(
+    const std::vector< epiworld_double >& simulated_stats,
+    const std::vector< epiworld_double >& observed_stats,
+    epiworld_double epsilon,
+    LFMCMC<TData>* m
+) {
+
+    epiworld_double ans = 0.0;
+    for (size_t p = 0u; p < m->get_n_params(); ++p)
+        ans += std::pow(observed_stats[p] - simulated_stats[p], 2.0);
+
+    return std::sqrt(ans) < epsilon ? 1.0 : 0.0;
+
+}
+
+#define sqrt2pi() 2.5066282746310002416
+
+/**
+ * @brief Gaussian kernel
+ * 
+ * @tparam TData 
+ * @param simulated_stats Vector of statistics based on 
+ * simulated data
+ * @param observed_stats Vector of observed statistics
+ * @param epsilon Epsilon parameter
+ * @param m LFMCMC model
+ * @return epiworld_double 
+ */
+template<typename TData>
+inline epiworld_double kernel_fun_gaussian(
+    const std::vector< epiworld_double >& simulated_stats,
+    const std::vector< epiworld_double >& observed_stats,
+    epiworld_double epsilon,
+    LFMCMC<TData>* m
+) {
+
+    epiworld_double ans = 0.0;
+    for (size_t p = 0u; p < m->get_n_params(); ++p)
+        ans += std::pow(observed_stats[p] - simulated_stats[p], 2.0);
+
+    return std::exp(
+        -.5 * (ans/std::pow(1 + std::pow(epsilon, 2.0)/3.0, 2.0))
+        ) / sqrt2pi() ;
+
+}
+
+
+template<typename TData>
+inline void LFMCMC<TData>::set_proposal_fun(LFMCMCProposalFun<TData> fun)
+{
+    m_proposal_fun = fun;
+}
+
+template<typename TData>
+inline void LFMCMC<TData>::set_simulation_fun(LFMCMCSimFun<TData> fun)
+{
+    m_simulation_fun = fun;
+}
+
+template<typename TData>
+inline void LFMCMC<TData>::set_summary_fun(LFMCMCSummaryFun<TData> fun)
+{
+    m_summary_fun = fun;
+}
+
+template<typename TData>
+inline void LFMCMC<TData>::set_kernel_fun(LFMCMCKernelFun<TData> fun)
+{
+    m_kernel_fun = fun;
+}
+
+
+template<typename TData>
+inline void LFMCMC<TData>::run(
+    std::vector< epiworld_double > params_init_,
+    size_t n_samples_,
+    epiworld_double epsilon_,
+    int seed
+    )
+{
+
+    // Starting timing
+    chrono_start();
+
+    // Setting the baseline parameters of the model
+    m_n_samples    = n_samples_;
+    m_epsilon      = epsilon_;
+    m_initial_params  = params_init_;
+    m_n_params = params_init_.size();
+
+    if (seed >= 0)
+        this->seed(seed);
+
+    m_current_proposed_params.resize(m_n_params);
+    m_current_accepted_params.resize(m_n_params);
+
+    if (m_simulated_data != nullptr)
+        m_simulated_data->resize(m_n_samples);
+
+    m_current_accepted_params = m_initial_params;
+    m_current_proposed_params  = m_initial_params;
+
+    // Computing the baseline sufficient statistics
+    m_summary_fun(m_observed_stats, m_observed_data, this);
+    m_n_stats = m_observed_stats.size();
+
+    // Reserving size
+    m_current_proposed_stats.resize(m_n_stats);
+    m_current_accepted_stats.resize(m_n_stats);
+    m_all_sample_drawn_prob.resize(m_n_samples);
+    m_all_sample_acceptance.resize(m_n_samples, false);
+    m_all_sample_params.resize(m_n_samples * m_n_params);
+    m_all_sample_stats.resize(m_n_samples * m_n_stats);
+    m_all_sample_kernel_scores.resize(m_n_samples);
+
+    m_all_accepted_params.resize(m_n_samples * m_n_params);
+    m_all_accepted_stats.resize(m_n_samples * m_n_stats);
+    m_all_accepted_kernel_scores.resize(m_n_samples);
+
+    TData data_i = m_simulation_fun(m_initial_params, this);
+
+    m_summary_fun(m_current_proposed_stats, data_i, this);
+    m_all_accepted_kernel_scores[0u] = m_kernel_fun(
+        m_current_proposed_stats, m_observed_stats, m_epsilon, this
+        );
+
+    // Recording statistics
+    for (size_t i = 0u; i < m_n_stats; ++i)
+        m_all_sample_stats[i] = m_current_proposed_stats[i];
+    
+    m_current_accepted_stats = m_current_proposed_stats;
+
+    for (size_t k = 0u; k < m_n_params; ++k)
+        m_all_accepted_params[k] = m_initial_params[k];
+    
+    for (size_t k = 0u; k < m_n_params; ++k)
+        m_all_sample_params[k] = m_initial_params[k];
+   
+    // Init progress bar
+    progress_bar = Progress(m_n_samples, 80);
+
+    // Run LFMCMC
+    for (size_t i = 1u; i < m_n_samples; ++i)
+    {
+        // Step 1: Generate a proposal and store it in m_current_proposed_params
+        m_proposal_fun(m_current_proposed_params, m_current_accepted_params, this);
+
+        // Step 2: Using m_current_proposed_params, simulate data
+        TData data_i = m_simulation_fun(m_current_proposed_params, this);
+
+        // Are we storing the data?
+        if (m_simulated_data != nullptr)
+            m_simulated_data->operator[](i) = data_i;
+
+        // Step 3: Generate the summary statistics of the data
+        m_summary_fun(m_current_proposed_stats, data_i, this);
+
+        // Step 4: Compute the hastings ratio using the kernel function
+        epiworld_double hr = m_kernel_fun(
+            m_current_proposed_stats, m_observed_stats, m_epsilon, this
+            );
+
+        m_all_sample_kernel_scores[i] = hr;
+
+        // Storing data
+        for (size_t k = 0u; k < m_n_params; ++k)
+            m_all_sample_params[i * m_n_params + k] = m_current_proposed_params[k];
+
+        for (size_t k = 0u; k < m_n_stats; ++k)
+            m_all_sample_stats[i * m_n_stats + k] = m_current_proposed_stats[k];
+        
+        // Running Hastings ratio
+        epiworld_double r = runif();
+        m_all_sample_drawn_prob[i] = r;
+
+        // Step 5: Update if likely
+        if (r < std::min(static_cast<epiworld_double>(1.0), hr / m_all_accepted_kernel_scores[i - 1u]))
+        {
+            m_all_accepted_kernel_scores[i] = hr;
+            m_all_sample_acceptance[i]     = true;
+            
+            for (size_t k = 0u; k < m_n_stats; ++k)
+                m_all_accepted_stats[i * m_n_stats + k] =
+                    m_current_proposed_stats[k];
+
+            m_current_accepted_params = m_current_proposed_params;
+            m_current_accepted_stats = m_current_proposed_stats;
+        } else
+        {
+
+            for (size_t k = 0u; k < m_n_stats; ++k)
+                m_all_accepted_stats[i * m_n_stats + k] =
+                    m_all_accepted_stats[(i - 1) * m_n_stats + k];
+
+            m_all_accepted_kernel_scores[i] = m_all_accepted_kernel_scores[i - 1u];
+        }
+            
+
+        for (size_t k = 0u; k < m_n_params; ++k)
+            m_all_accepted_params[i * m_n_params + k] = m_current_accepted_params[k];
+
+        if (verbose)
+           progress_bar.next();
+
+    }
+
+    // End timing
+    chrono_end();
+
+}
+
+
+template<typename TData>
+inline epiworld_double LFMCMC<TData>::runif()
+{
+    return runif_epi(*m_engine);
+}
+
+template<typename TData>
+inline epiworld_double LFMCMC<TData>::runif(
+    epiworld_double lb,
+    epiworld_double ub
+)
+{
+    return runif_epi(*m_engine) * (ub - lb) + lb;
+}
+
+template<typename TData>
+inline epiworld_double LFMCMC<TData>::rnorm()
+{
+    return rnormd->operator()(*m_engine);
+}
+
+template<typename TData>
+inline epiworld_double LFMCMC<TData>::rnorm(
+    epiworld_double mean,
+    epiworld_double sd
+    )
+{
+    return (rnormd->operator()(*m_engine)) * sd + mean;
+}
+
+template<typename TData>
+inline epiworld_double LFMCMC<TData>::rgamma()
+{
+    return rgammad->operator()(*m_engine);
+}
+
+template<typename TData>
+inline epiworld_double LFMCMC<TData>::rgamma(
+    epiworld_double alpha,
+    epiworld_double beta
+    )
+{
+
+    auto old_param = rgammad->param();
+
+    rgammad->param(std::gamma_distribution<>::param_type(alpha, beta));
+
+    epiworld_double ans = rgammad->operator()(*m_engine);
+
+    rgammad->param(old_param);
+
+    return ans;
+
+}
+
+template<typename TData>
+inline void LFMCMC<TData>::seed(epiworld_fast_uint s) {
+
+    this->m_engine->seed(s);
+
+}
+
+template<typename TData>
+inline void LFMCMC<TData>::set_rand_engine(std::shared_ptr< epi_xoshiro256ss > & eng)
+{
+    m_engine = eng;
+}
+
+template<typename TData>
+inline void LFMCMC<TData>::set_rand_gamma(epiworld_double alpha, epiworld_double beta)
+{
+    rgammad = std::make_shared<std::gamma_distribution<>>(alpha,beta);
+}
+
+template<typename TData>
+inline std::shared_ptr< epi_xoshiro256ss > & LFMCMC<TData>::get_rand_endgine()
+{
+    return m_engine;
+}
+
+// Step 1: Simulate data
+
+// Step 2: Compute the sufficient statistics
+
+// Step 3: Compute the hastings-ratio
+
+// Step 4: Accept/reject, and go back to step 1
+
+#define DURCAST(tunit,txtunit) {\
+        elapsed       = std::chrono::duration_cast<std::chrono:: tunit>(\
+            m_end_time - m_start_time).count(); \
+        abbr_unit     = txtunit;}
+
+template<typename TData>
+inline void LFMCMC<TData>::get_elapsed_time(
+    std::string unit,
+    epiworld_double * last_elapsed,
+    std::string * unit_abbr,
+    bool print
+) const {
+
+    // Preparing the result
+    epiworld_double elapsed;
+    std::string abbr_unit;
+
+    // Figuring out the length
+    if (unit == "auto")
+    {
+
+        size_t tlength = std::to_string(
+            static_cast<int>(floor(m_elapsed_time.count()))
+            ).length();
+        
+        if (tlength <= 1)
+            unit = "nanoseconds";
+        else if (tlength <= 3)
+            unit = "microseconds";
+        else if (tlength <= 6)
+            unit = "milliseconds";
+        else if (tlength <= 8)
+            unit = "seconds";
+        else if (tlength <= 9)
+            unit = "minutes";
+        else 
+            unit = "hours";
+
+    }
+
+    if (unit == "nanoseconds")       DURCAST(nanoseconds,"ns")
+    else if (unit == "microseconds") DURCAST(microseconds,"\xC2\xB5s")
+    else if (unit == "milliseconds") DURCAST(milliseconds,"ms")
+    else if (unit == "seconds")      DURCAST(seconds,"s")
+    else if (unit == "minutes")      DURCAST(minutes,"m")
+    else if (unit == "hours")        DURCAST(hours,"h")
+    else
+        throw std::range_error("The time unit " + unit + " is not supported.");
+
+
+    if (last_elapsed != nullptr)
+        *last_elapsed = elapsed;
+    if (unit_abbr != nullptr)
+        *unit_abbr = abbr_unit;
+
+    if (!print)
+        return;
+
+    printf_epiworld("Elapsed time : %.2f%s.\n", elapsed, abbr_unit.c_str());
+}
+
+#undef DURCAST
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/math/lfmcmc/lfmcmc-meat-print.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef LFMCMC_MEAT_PRINT_HPP
+#define LFMCMC_MEAT_PRINT_HPP
+
+template<typename TData>
+inline void LFMCMC<TData>::print(size_t burnin) const
+{
+
+    // For each statistic or parameter in the model, we print three values: 
+    // - mean, the 2.5% quantile, and the 97.5% quantile
+    std::vector< epiworld_double > summ_params(m_n_params * 3, 0.0);
+    std::vector< epiworld_double > summ_stats(m_n_stats * 3, 0.0);
+
+    // Compute the number of samples to use based on burnin rate
+    size_t n_samples_print = m_n_samples;
+    if (burnin > 0)
+    {
+        if (burnin >= m_n_samples)
+            throw std::length_error(
+                "The burnin is greater than or equal to the number of samples."
+                );
+
+        n_samples_print = m_n_samples - burnin;
+
+    }
+
+    epiworld_double n_samples_dbl = static_cast< epiworld_double >(
+        n_samples_print
+        );
+
+    // Compute parameter summary values
+    for (size_t k = 0u; k < m_n_params; ++k)
+    {
+
+        // Retrieving the relevant parameter
+        std::vector< epiworld_double > par_i(n_samples_print);
+        for (size_t i = burnin; i < m_n_samples; ++i)
+        {
+            par_i[i-burnin] = m_all_accepted_params[i * m_n_params + k];
+            summ_params[k * 3] += par_i[i-burnin]/n_samples_dbl;
+        }
+
+        // Computing the 95% Credible interval
+        std::sort(par_i.begin(), par_i.end());
+
+        summ_params[k * 3 + 1u] = 
+            par_i[std::floor(.025 * n_samples_dbl)];
+        summ_params[k * 3 + 2u] = 
+            par_i[std::floor(.975 * n_samples_dbl)];
+
+    }
+
+    // Compute statistics summary values
+    for (size_t k = 0u; k < m_n_stats; ++k)
+    {
+
+        // Retrieving the relevant parameter
+        std::vector< epiworld_double > stat_k(n_samples_print);
+        for (size_t i = burnin; i < m_n_samples; ++i)
+        {
+            stat_k[i-burnin] = m_all_accepted_stats[i * m_n_stats + k];
+            summ_stats[k * 3] += stat_k[i-burnin]/n_samples_dbl;
+        }
+
+        // Computing the 95% Credible interval
+        std::sort(stat_k.begin(), stat_k.end());
+        summ_stats[k * 3 + 1u] = 
+            stat_k[std::floor(.025 * n_samples_dbl)];
+        summ_stats[k * 3 + 2u] = 
+            stat_k[std::floor(.975 * n_samples_dbl)];
+
+    }
+
+    printf_epiworld("___________________________________________\n\n");
+    printf_epiworld("LIKELIHOOD-FREE MARKOV CHAIN MONTE CARLO\n\n");
+
+    printf_epiworld("N Samples (total) : %zu\n", m_n_samples);
+    printf_epiworld("N Samples (after burn-in period) : %zu\n", m_n_samples - burnin);
+
+    std::string abbr;
+    epiworld_double elapsed;
+    get_elapsed_time("auto", &elapsed, &abbr, false);
+    printf_epiworld("Elapsed t : %.2f%s\n\n", elapsed, abbr.c_str());
+    
+    ////////////////////////////////////////////////////////////////////////////
+    // PARAMETERS
+    ////////////////////////////////////////////////////////////////////////////
+    printf_epiworld("Parameters:\n");
+
+    // Figuring out format
+    std::string fmt_params;
+    
+    int nchar_par_num = 0;
+    for (auto & n : summ_params)
+    {
+        
+        int tmp_nchar;
+        
+        if (std::abs(n) < 1) {
+            // std::log10(<1) will return negative number
+            // std::log10(0) will return -inf and throw a runtime error
+            tmp_nchar = 0;
+        } else {
+            tmp_nchar = std::floor(std::log10(std::abs(n)));
+        }
+
+        if (nchar_par_num < tmp_nchar)
+            nchar_par_num = tmp_nchar;
+    }
+    nchar_par_num += 5; // 1 for neg padd, 2 for decimals, 1 the decimal point, and one b/c log(<10) < 1.
+    std::string charlen = std::to_string(nchar_par_num);
+
+    if (m_param_names.size() != 0u)
+    {
+        int nchar_par = 0;
+        for (auto & n : m_param_names)
+        {
+            int tmp_nchar = n.length();
+            if (nchar_par < tmp_nchar)
+                nchar_par = tmp_nchar;
+        }
+
+        fmt_params = std::string("  -%-") +
+            std::to_string(nchar_par) +
+            std::string("s : % ") + charlen  + 
+            std::string(".2f [% ") + charlen + 
+            std::string(".2f, % ") + charlen +
+            std::string(".2f] (initial : % ") +
+            charlen + std::string(".2f)\n");
+
+        for (size_t k = 0u; k < m_n_params; ++k)
+        {
+            printf_epiworld(
+                fmt_params.c_str(),
+                m_param_names[k].c_str(),
+                summ_params[k * 3],
+                summ_params[k * 3 + 1u],
+                summ_params[k * 3 + 2u],
+                m_initial_params[k]
+                );
+        }
+
+        
+    } else {
+
+        fmt_params = std::string("  [%-2ld]: % ") + charlen + 
+            std::string(".2f [% ") + charlen +
+            std::string(".2f, % ") + charlen + 
+            std::string(".2f] (initial : % ") + charlen +
+            std::string(".2f)\n");
+
+        for (size_t k = 0u; k < m_n_params; ++k)
+        {
+            
+            printf_epiworld(
+                fmt_params.c_str(),
+                k,
+                summ_params[k * 3],
+                summ_params[k * 3 + 1u],
+                summ_params[k * 3 + 2u],
+                m_initial_params[k]
+                );
+        }
+
+    }    
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Statistics
+    ////////////////////////////////////////////////////////////////////////////
+    printf_epiworld("\nStatistics:\n");
+    int nchar = 0;
+    for (auto & s : summ_stats)
+    {
+        int tmp_nchar;
+        if (std::abs(s) < 1) {
+            // std::log10(<1) will return negative number
+            // std::log10(0) will return -inf and throw a runtime error
+            tmp_nchar = 0;
+        } else {
+            tmp_nchar = std::floor(std::log10(std::abs(s)));
+        }
+    
+        if (nchar < tmp_nchar)
+            nchar = tmp_nchar;
+    }
+
+    nchar += 5; // See above
+
+    std::string nchar_char = std::to_string(nchar);
+
+    // Figuring out format
+    std::string fmt_stats;
+    if (m_stat_names.size() != 0u)
+    {
+        int nchar_stats = 0;
+        for (auto & n : m_stat_names)
+        {
+            int tmp_nchar = n.length();
+            if (nchar_stats < tmp_nchar)
+                nchar_stats = tmp_nchar;
+        }
+
+        fmt_stats = std::string("  -%-") +
+            std::to_string(nchar_stats) +
+            std::string("s : % ") + nchar_char +
+            std::string(".2f [% ") + nchar_char +
+            std::string(".2f, % ") + nchar_char +
+            std::string(".2f] (Observed: % ") + nchar_char +
+            std::string(".2f)\n");
+
+        for (size_t k = 0u; k < m_n_stats; ++k)
+        {
+            printf_epiworld(
+                fmt_stats.c_str(),
+                m_stat_names[k].c_str(),
+                summ_stats[k * 3],
+                summ_stats[k * 3 + 1u],
+                summ_stats[k * 3 + 2u],
+                m_observed_stats[k]
+                );
+        }
+
+        
+    } else {
+
+        fmt_stats = std::string("  [%-2ld] : % ") + 
+            nchar_char +
+            std::string(".2f [% ") + nchar_char +
+            std::string(".2f, % ") + nchar_char +
+            std::string(".2f] (Observed: % ") + nchar_char +
+            std::string(".2f)\n");
+
+        for (size_t k = 0u; k < m_n_stats; ++k)
+        {
+            printf_epiworld(
+                fmt_stats.c_str(),
+                k,
+                summ_stats[k * 3],
+                summ_stats[k * 3 + 1u],
+                summ_stats[k * 3 + 2u],
+                m_observed_stats[k]
+                );
+        }
+
+    }
+
+    printf_epiworld("___________________________________________\n\n");
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/math/lfmcmc/lfmcmc-meat-print.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+template<typename TData>
+inline void LFMCMC<TData>::chrono_start() {
+    m_start_time = std::chrono::steady_clock::now();
+}
+
+template<typename TData>
+inline void LFMCMC<TData>::chrono_end() {
+    m_end_time = std::chrono::steady_clock::now();
+    m_elapsed_time += (m_end_time - m_start_time);
+}
+
+template<typename TData>
+inline void LFMCMC<TData>::set_params_names(std::vector< std::string > names)
+{
+
+    if (names.size() != m_n_params)
+        throw std::length_error("The number of names to add differs from the number of parameters in the model.");
+
+    m_param_names = names;
+
+}
+template<typename TData>
+inline void LFMCMC<TData>::set_stats_names(std::vector< std::string > names)
+{
+
+    if (names.size() != m_n_stats)
+        throw std::length_error("The number of names to add differs from the number of statistics in the model.");
+
+    m_stat_names = names;
+
+}
+
+template<typename TData>
+inline std::vector< epiworld_double > LFMCMC<TData>::get_mean_params()
+{
+    std::vector< epiworld_double > res(this->m_n_params, 0.0);
+    
+    for (size_t k = 0u; k < m_n_params; ++k)
+    {
+        for (size_t i = 0u; i < m_n_samples; ++i)
+            res[k] += (this->m_all_accepted_params[k + m_n_params * i])/
+                static_cast< epiworld_double >(m_n_samples);
+    }
+
+    return res;
+
+}
+
+template<typename TData>
+inline std::vector< epiworld_double > LFMCMC<TData>::get_mean_stats()
+{
+    std::vector< epiworld_double > res(this->m_n_stats, 0.0);
+    
+    for (size_t k = 0u; k < m_n_stats; ++k)
+    {
+        for (size_t i = 0u; i < m_n_samples; ++i)
+            res[k] += (this->m_all_accepted_stats[k + m_n_stats * i])/
+                static_cast< epiworld_double >(m_n_samples);
+    }
+
+    return res;
+
+}
+
+template<typename TData>
+inline LFMCMC<TData> & LFMCMC<TData>::verbose_off()
+{
+    verbose = false;
+    return *this;
+}
+
+template<typename TData>
+inline LFMCMC<TData> & LFMCMC<TData>::verbose_on()
+{
+    verbose = true;
+    return *this;
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/math/lfmcmc/lfmcmc-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/math/lfmcmc.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/userdata-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_USERDATA_BONES_HPP
+#define EPIWORLD_USERDATA_BONES_HPP
+
+template<typename TSeq>
+class Model;
+
+template<typename TSeq>
+class DataBase;
+
+/**
+ * @brief Personalized data by the user
+ *
+ * @tparam TSeq
+ */
+template<typename TSeq>
+class UserData
+{
+    friend class Model<TSeq>;
+    friend class DataBase<TSeq>;
+
+private:
+    Model<TSeq> * model = nullptr;
+
+    std::vector< std::string > data_names;
+    std::vector< int > data_dates;
+    std::vector< epiworld_double > data_data;
+
+    epiworld_fast_uint k = 0u;
+    epiworld_fast_uint n = 0u;
+
+    int last_day = -1;
+
+public:
+
+    UserData() = delete;
+    UserData(Model<TSeq> & m) : model(&m) {};
+    UserData(Model<TSeq> * m) : model(m) {};
+
+    /**
+     * @brief Construct a new User Data object
+     *
+     * @param names A vector of names. The length of the vector sets
+     * the number of columns to record.
+     */
+    UserData(std::vector< std::string > names);
+
+    /**
+     * @name Append data
+     *
+     * @param x A vector of length `ncol()` (if vector), otherwise a `epiworld_double`.
+     * @param j Index of the data point, from 0 to `ncol() - 1`.
+     */
+    ///@{
+    void add(std::vector<epiworld_double> x);
+    void add(
+        epiworld_fast_uint j,
+        epiworld_double x
+        );
+    ///@}
+
+    /**
+     * @name Access data
+     *
+     * @param i Row (0 through ndays - 1.)
+     * @param j Column (0 through `ncols()`).
+     * @return epiworld_double&
+     */
+    ///@{
+    epiworld_double & operator()(
+        epiworld_fast_uint i,
+        epiworld_fast_uint j
+        );
+
+    epiworld_double & operator()(
+        epiworld_fast_uint i,
+        std::string name
+        );
+    ///@}
+
+    std::vector< std::string > & get_names();
+
+    std::vector< int > & get_dates();
+
+    std::vector< epiworld_double > & get_data();
+
+    void get_all(
+        std::vector< std::string > * names    = nullptr,
+        std::vector< int > * date             = nullptr,
+        std::vector< epiworld_double > * data = nullptr
+    );
+
+    epiworld_fast_uint nrow() const;
+    epiworld_fast_uint ncol() const;
+
+    void write(std::string fn);
+    void print() const;
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/userdata-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/userdata-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_USERDATA_MEAT_HPP
+#define EPIWORLD_USERDATA_MEAT_HPP
+
+template<typename TSeq>
+class UserData;
+
+template<typename TSeq>
+inline UserData<TSeq>::UserData(std::vector< std::string > names)
+{
+
+    k = names.size();
+    data_names = names;
+
+}
+
+template<typename TSeq>
+inline void UserData<TSeq>::add(std::vector<epiworld_double> x)
+{
+
+    if (x.size() != k)
+        throw std::out_of_range(
+            "The size of -x-, " + std::to_string(x.size()) + ", does not match " +
+            "the number of elements registered (" + std::to_string(k));
+
+    for (auto & i : x)
+        data_data.push_back(i);
+
+    data_dates.push_back(model->today());
+
+    n++;
+    last_day = model->today();
+
+}
+
+template<typename TSeq>
+inline void UserData<TSeq>::add(epiworld_fast_uint j, epiworld_double x)
+{
+
+    // Starting with a new day?
+    if (static_cast<int>(model->today()) != last_day)
+    {
+
+        std::vector< epiworld_double > tmp(k, 0.0);
+
+        tmp[j] = x;
+
+        add(tmp);
+
+    }
+    else
+    {
+
+        this->operator()(n - 1, j) = x;
+
+    }
+
+}
+
+template<typename TSeq>
+inline std::vector< std::string > & UserData<TSeq>::get_names() 
+{
+    return data_names;
+}
+
+template<typename TSeq>
+inline std::vector< int > & UserData<TSeq>::get_dates() 
+{
+    return data_dates;
+}
+
+template<typename TSeq>
+inline std::vector< epiworld_double > & UserData<TSeq>::get_data() 
+{
+    return data_data;
+}
+
+template<typename TSeq>
+inline void UserData<TSeq>::get_all(
+    std::vector< std::string > * names,
+    std::vector< int > * date,
+    std::vector< epiworld_double > * data
+) 
+{
+    
+    if (names != nullptr)
+        names = &this->data_names;
+
+    if (date != nullptr)
+        date = &this->data_dates;
+
+    if (data != nullptr)
+        data = &this->data_data;
+
+}
+
+template<typename TSeq>
+inline epiworld_double & UserData<TSeq>::operator()(
+    epiworld_fast_uint i,
+    epiworld_fast_uint j
+)
+{
+
+    if (j >= k)
+        throw std::out_of_range("j cannot be greater than k - 1.");
+
+    if (i >= n)
+        throw std::out_of_range("j cannot be greater than n - 1.");
+
+    return data_data[k * i + j];
+
+}
+
+template<typename TSeq>
+inline epiworld_double & UserData<TSeq>::operator()(
+    epiworld_fast_uint i,
+    std::string name
+)
+{
+    int loc = -1;
+    for (epiworld_fast_uint l = 0u; l < k; ++l)
+    {
+
+        if (name == data_names[l])
+        {
+
+            loc = l;
+            break;
+
+        }
+
+    }
+
+    if (loc < 0)
+        throw std::range_error(
+            "The variable \"" + name + "\" is not present " +
+            "in the user UserData database."
+        );
+
+    return operator()(i, static_cast<epiworld_fast_uint>(loc));
+
+}
+
+template<typename TSeq>
+inline epiworld_fast_uint UserData<TSeq>::nrow() const
+{
+    return n;
+}
+
+template<typename TSeq>
+inline epiworld_fast_uint UserData<TSeq>::ncol() const
+{
+    return k;
+}
+
+template<typename TSeq>
+inline void UserData<TSeq>::write(std::string fn)
+{
+    std::ofstream file_ud(fn, std::ios_base::out);
+
+    // File header
+    file_ud << "\"date\"";
+    for (auto & cn : data_names)
+        file_ud << " \"" + cn + "\"";
+    file_ud << "\n";
+    
+    epiworld_fast_uint ndata = 0u;
+    for (epiworld_fast_uint i = 0u; i < n; ++i)
+    {
+        file_ud << data_dates[i];
+
+        for (epiworld_fast_uint j = 0u; j < k; ++j)
+            file_ud << " " << data_data[ndata++];
+
+        file_ud << "\n";
+    }
+
+    return;
+}
+
+template<typename TSeq>
+inline void UserData<TSeq>::print() const
+{
+    // File header
+    printf_epiworld("Total records: %llu\n", n);
+    printf_epiworld("date");
+
+    for (auto & cn : data_names)
+    {
+
+        printf_epiworld(" %s", cn.c_str());
+
+    }
+
+    printf_epiworld("\n");
+    
+    epiworld_fast_uint ndata = 0u;
+    
+    for (epiworld_fast_uint i = 0u; i < n; ++i)
+    {
+
+        printf_epiworld("%i", data_dates[i]);
+
+        for (epiworld_fast_uint j = 0u; j < k; ++j)
+        {
+
+            printf_epiworld(" %.2f", data_data[ndata++]);
+
+        }
+
+        printf_epiworld("\n");
+
+    }
+
+    return;
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/userdata-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/seq_processing.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_SEQ_PROCESSING_HPP 
+#define EPIWORLD_SEQ_PROCESSING_HPP
+
+/**
+ * @brief Hasher function to turn the sequence into an integer vector
+ * 
+ * @tparam TSeq 
+ * @param x 
+ * @return std::vector<int> 
+ */
+template<typename TSeq>
+inline std::vector<int> default_seq_hasher(const TSeq & x);
+
+template<>
+inline std::vector<int> default_seq_hasher<std::vector<int>>(const std::vector<int> & x) {
+    return x;
+}
+
+template<>
+inline std::vector<int> default_seq_hasher<std::vector<bool>>(const std::vector<bool> & x) {
+    std::vector<int> ans(x.size());
+    size_t j = 0;
+    for (const auto & i : x)
+        ans[j++] = i? 1 : 0;
+    return ans;
+}
+
+template<>
+inline std::vector<int> default_seq_hasher<int>(const int & x) {
+    return {x};
+}
+
+template<>
+inline std::vector<int> default_seq_hasher<bool>(const bool & x) {
+    return {x ? 1 : 0};
+}
+
+/**
+ * @brief Default way to write sequences
+ * 
+ * @tparam TSeq 
+ * @param seq 
+ * @return std::string 
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline std::string default_seq_writer(const TSeq & seq);
+
+template<>
+inline std::string default_seq_writer<std::vector<int>>(
+    const std::vector<int> & seq
+) {
+
+    std::string out = "";
+    for (const auto & s : seq)
+        out = out + std::to_string(s);
+
+    return out;
+
+}
+
+template<>
+inline std::string default_seq_writer<std::vector<bool>>(
+    const std::vector<bool> & seq
+) {
+
+    std::string out = "";
+    for (const auto & s : seq)
+        out = out + (s ? "1" : "0");
+
+    return out;
+
+}
+
+template<>
+inline std::string default_seq_writer<bool>(
+    const bool & seq
+) {
+
+    return seq ? "1" : "0";
+
+}
+
+template<>
+inline std::string default_seq_writer<int>(
+    const int & seq
+) {
+
+    return std::to_string(seq);
+
+}
+
+
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/seq_processing.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/hospitalizationstracker-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_HOSPITALIZATIONSTRACKER_BONES_HPP
+#define EPIWORLD_HOSPITALIZATIONSTRACKER_BONES_HPP
+
+template<typename TSeq>
+class Agent;
+
+template<typename TSeq>
+class Model;
+
+/**
+ * @brief Class to track hospitalizations in an epidemiological model.
+ * 
+ * @details
+ * This class keeps track of hospitalizations in a model. For each hospitalized
+ * agent, it records the date, virus ID, and tool IDs with appropriate weights.
+ * 
+ * Since agents always have at most one virus but may have multiple tools,
+ * if an agent has N tools, then N records are created, each with weight
+ * equal to 1/N. If the agent has no tools, a single record is created with
+ * tool_id = -1 and weight = 1.0.
+ * 
+ * The `get()` method returns a summary of the hospitalizations grouped by
+ * date, virus_id, and tool_id, with weight summed across all matching
+ * records.
+ * 
+ * @tparam TSeq Type of sequence (should match `TSeq` across the model)
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class HospitalizationsTracker {
+    friend class Model<TSeq>;
+
+private:
+
+    std::vector<int> _date;           ///< Date of hospitalization
+    std::vector<int> _virus_id;       ///< ID of the virus causing hospitalization
+    std::vector<int> _tool_id;        ///< ID of the tool (-1 if no tools)
+    std::vector<double> _weight;      ///< Weight for the tool (1/N where N is tool count)
+
+public:
+
+    HospitalizationsTracker() = default;
+
+    /**
+     * @brief Reset the tracker by clearing all data.
+     */
+    void reset();
+
+    /**
+     * @brief Record a hospitalization event for an agent.
+     * 
+     * @param agent Reference to the agent being hospitalized.
+     * @param model Reference to the model.
+     * 
+     * @details
+     * For each hospitalization, the method records:
+     * - The current date from the model
+     * - The virus ID from the agent's virus
+     * - For each tool the agent has, a separate record with weight = 1/N
+     *   where N is the number of tools
+     * - If the agent has no tools, a single record with tool_id = -1 and
+     *   weight = 1.0
+     */
+    void record(Agent<TSeq> & agent, Model<TSeq> & model);
+
+    /**
+     * @brief Get the full time series of hospitalizations.
+     * 
+     * @param ndays Number of days in the simulation (0 to ndays-1).
+     * @param date Output vector for dates.
+     * @param virus_id Output vector for virus IDs.
+     * @param tool_id Output vector for tool IDs.
+     * @param count Output vector for counts (number of hospitalized individuals).
+     * @param weight Output vector for summed weights (fractional contribution 
+     *   based on tool distribution).
+     * 
+     * @details
+     * Returns the full time series of hospitalization data. For each unique 
+     * (virus_id, tool_id) combination observed, returns an entry for every 
+     * day from 0 to ndays-1.
+     * 
+     * The `count` vector contains the actual number of individuals hospitalized 
+     * for that (date, virus_id, tool_id) combination. This is useful for 
+     * answering questions like "how many total people were hospitalized?" 
+     * regardless of their tools.
+     * 
+     * The `weight` vector contains fractional contributions: if an agent has N 
+     * tools, each tool gets weight = 1/N. Summing weights across all tool_ids 
+     * for a given date and virus_id gives the total number of hospitalizations.
+     */
+    void get(
+        int ndays,
+        std::vector<int> & date,
+        std::vector<int> & virus_id,
+        std::vector<int> & tool_id,
+        std::vector<int> & count,
+        std::vector<double> & weight
+    ) const;
+
+    /**
+     * @brief Get the number of raw records in the tracker.
+     * @return Number of records.
+     */
+    size_t size() const;
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/hospitalizationstracker-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/hospitalizationstracker-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_HOSPITALIZATIONSTRACKER_MEAT_HPP
+#define EPIWORLD_HOSPITALIZATIONSTRACKER_MEAT_HPP
+
+
+template<typename TSeq>
+inline void HospitalizationsTracker<TSeq>::reset()
+{
+    _date.clear();
+    _virus_id.clear();
+    _tool_id.clear();
+    _weight.clear();
+}
+
+template<typename TSeq>
+inline void HospitalizationsTracker<TSeq>::record(
+    Agent<TSeq> & agent,
+    Model<TSeq> & model
+)
+{
+    int current_date = model.today();
+    
+    // Get the virus ID (-1 if no virus)
+    int v_id = -1;
+    auto & virus = agent.get_virus();
+    if (virus != nullptr)
+        v_id = virus->get_id();
+    
+    // Get the number of tools
+    size_t n_tools = agent.get_n_tools();
+    
+    if (n_tools == 0u)
+    {
+        // No tools: single record with tool_id = -1 and weight = 1.0
+        _date.push_back(current_date);
+        _virus_id.push_back(v_id);
+        _tool_id.push_back(-1);
+        _weight.push_back(1.0);
+    }
+    else
+    {
+        // Multiple tools: one record per tool with weight = 1/N
+        double w = 1.0 / static_cast<double>(n_tools);
+        for (size_t i = 0u; i < n_tools; ++i)
+        {
+            _date.push_back(current_date);
+            _virus_id.push_back(v_id);
+            _tool_id.push_back(agent.get_tool(static_cast<int>(i))->get_id());
+            _weight.push_back(w);
+        }
+    }
+}
+
+template<typename TSeq>
+inline void HospitalizationsTracker<TSeq>::get(
+    int ndays,
+    std::vector<int> & date,
+    std::vector<int> & virus_id,
+    std::vector<int> & tool_id,
+    std::vector<int> & count,
+    std::vector<double> & weight
+) const
+{
+    // Clear output vectors
+    date.clear();
+    virus_id.clear();
+    tool_id.clear();
+    count.clear();
+    weight.clear();
+    
+    if (ndays <= 0)
+        return;
+    
+    // First, aggregate by (date, virus_id, tool_id) to get count and sum of weights
+    // Key: (date, virus_id, tool_id), Value: (count, sum of weight)
+    std::map<std::tuple<int, int, int>, std::pair<int, double>> aggregated;
+    
+    // Collect unique (virus_id, tool_id) combinations
+    std::set<std::pair<int, int>> unique_combinations;
+    
+    for (size_t i = 0u; i < _date.size(); ++i)
+    {
+        auto key = std::make_tuple(_date[i], _virus_id[i], _tool_id[i]);
+        aggregated[key].first += 1;  // Count
+        aggregated[key].second += _weight[i];  // Weight
+        unique_combinations.insert(std::make_pair(_virus_id[i], _tool_id[i]));
+    }
+    
+    // If no hospitalizations occurred, still output the full time series 
+    // with a single combination (virus_id=-1, tool_id=-1) and zeros
+    if (unique_combinations.empty())
+    {
+        unique_combinations.insert(std::make_pair(-1, -1));
+    }
+    
+    // For each unique (virus_id, tool_id) combination, output all days
+    for (const auto & combo : unique_combinations)
+    {
+        int v_id = combo.first;
+        int t_id = combo.second;
+        
+        for (int d = 0; d < ndays; ++d)
+        {
+            date.push_back(d);
+            virus_id.push_back(v_id);
+            tool_id.push_back(t_id);
+            
+            // Look up the count and weight for this (date, virus_id, tool_id) combination
+            auto key = std::make_tuple(d, v_id, t_id);
+            auto it = aggregated.find(key);
+            if (it != aggregated.end())
+            {
+                count.push_back(it->second.first);
+                weight.push_back(it->second.second);
+            }
+            else
+            {
+                count.push_back(0);
+                weight.push_back(0.0);
+            }
+        }
+    }
+}
+
+template<typename TSeq>
+inline size_t HospitalizationsTracker<TSeq>::size() const
+{
+    return _date.size();
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/hospitalizationstracker-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/database-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_DATABASE_BONES_HPP
+#define EPIWORLD_DATABASE_BONES_HPP
+
+template<typename TSeq>
+class Model;
+
+template<typename TSeq>
+class Virus;
+
+template<typename TSeq>
+class UserData;
+
+/**
+ * @brief Statistical data about the process
+ *
+ * **Implementation details:**
+ * <a href="../impl/data-collection-and-analysis.md">Data Collection and Analysis</a>,
+ * <a href="../impl/generation-interval-and-reproductive-number.md">Generation Interval and Reproductive Number Calculation</a>
+ *
+ * @tparam TSeq
+ */
+template<typename TSeq>
+class DataBase {
+    friend class Model<TSeq>;
+private:
+    Model<TSeq> * model;
+
+    HospitalizationsTracker<TSeq> m_hospitalizations; ///< Tracker for hospitalization events
+
+    // Variants information
+    MapVec_type<int,int> virus_id; ///< The squence is the key
+    std::vector< std::string > virus_name;
+    std::vector< TSeq> virus_sequence;
+    std::vector< int > virus_origin_date;
+    std::vector< int > virus_parent_id;
+
+    MapVec_type<int,int> tool_id; ///< The squence is the key
+    std::vector< std::string > tool_name;
+    std::vector< TSeq> tool_sequence;
+    std::vector< int > tool_origin_date;
+
+    std::function<std::vector<int>(const TSeq&)> seq_hasher = default_seq_hasher<TSeq>;
+    std::function<std::string(const TSeq &)> seq_writer = default_seq_writer<TSeq>;
+
+    // {Variant 1: {state 1, state 2, etc.}, Variant 2: {...}, ...}
+    std::vector< std::vector<int> > today_virus;
+
+    // {Variant 1: {state 1, state 2, etc.}, Variant 2: {...}, ...}
+    std::vector< std::vector<int> > today_tool;
+
+    // {Susceptible, Infected, etc.}
+    std::vector< int > today_total;
+
+    // Totals
+    int today_total_nviruses_active = 0;
+
+    int sampling_freq = 1;
+
+    // Variants history
+    std::vector< int > hist_virus_date;
+    std::vector< int > hist_virus_id;
+    std::vector< epiworld_fast_uint > hist_virus_state;
+    std::vector< int > hist_virus_counts;
+
+    // Tools history
+    std::vector< int > hist_tool_date;
+    std::vector< int > hist_tool_id;
+    std::vector< epiworld_fast_uint > hist_tool_state;
+    std::vector< int > hist_tool_counts;
+
+    // Overall hist
+    std::vector< int > hist_total_date;
+    std::vector< int > hist_total_nviruses_active;
+    std::vector< epiworld_fast_uint > hist_total_state;
+    std::vector< int > hist_total_counts;
+    std::vector< int > hist_transition_matrix;
+
+    // Transmission network
+    std::vector< int > transmission_date;                 ///< Date of the transmission event
+    std::vector< int > transmission_source;               ///< Id of the source
+    std::vector< int > transmission_target;               ///< Id of the target
+    std::vector< int > transmission_virus;              ///< Id of the variant
+    std::vector< int > transmission_source_exposure_date; ///< Date when the source acquired the variant
+
+    std::vector< int > transition_matrix;
+
+    UserData<TSeq> user_data;
+
+    void update_state(
+        epiworld_fast_uint prev_state,
+        epiworld_fast_uint new_state,
+        bool undo = false
+    );
+
+    void update_virus(
+        epiworld_fast_uint virus_id,
+        epiworld_fast_uint prev_state,
+        epiworld_fast_uint new_state,
+        bool undo = false
+    );
+
+    void update_tool(
+        epiworld_fast_uint tool_id,
+        epiworld_fast_uint prev_state,
+        epiworld_fast_uint new_state,
+        bool undo = false
+    );
+
+    void record_transition(epiworld_fast_uint from, epiworld_fast_uint to, bool undo);
+
+    /**
+     * @name Batched state counters
+     * @details While batching is on, `update_state()` only accumulates the
+     * net number of transitions between each pair of states; they are
+     * applied to `today_total` and `transition_matrix` by `batch_off()`.
+     * `Model<TSeq>::events_run()` batches the updates of each day.
+     */
+    ///@{
+    bool batch_transitions = false;
+    bool batch_dirty = false;
+    std::vector< int > batch_counts; ///< Net transitions [to * nstates + from]
+    void batch_on();
+    void batch_off();
+    ///@}
+
+
+public:
+
+    #ifdef EPI_DEBUG
+    int n_transmissions_potential = 0;
+    int n_transmissions_today     = 0;
+    #endif
+
+    DataBase() = delete;
+    DataBase(Model<TSeq> & m) : model(&m), m_hospitalizations(), user_data(m) {};
+    DataBase(const DataBase<TSeq> & db);
+    DataBase<TSeq> & operator=(const DataBase<TSeq> & m) = default;
+
+    /**
+     * @brief Registering a new variant
+     *
+     * @param v Pointer to the new virus.
+     * Since viruses are originated in the agent, the numbers simply move around.
+     * From the parent virus to the new virus. And the total number of infected
+     * does not change.
+     */
+    void record_virus(Virus<TSeq> & v);
+    void record_tool(Tool<TSeq> & t);
+    void set_seq_hasher(std::function<std::vector<int>(TSeq)> fun);
+    void reset();
+    Model<TSeq> * get_model();
+    void record();
+
+    const std::vector< TSeq > & get_sequence() const;
+    const std::vector< int > & get_nexposed() const;
+    size_t size() const;
+
+    /**
+     * @name Get recorded information from the model
+     *
+     * @param what std::string, The state, e.g., 0, 1, 2, ...
+     * @return In `get_today_total`, the current counts of `what`.
+     * @return In `get_today_virus`, the current counts of `what` for
+     * each virus.
+     * @return In `get_hist_total`, the time series of `what`
+     * @return In `get_hist_virus`, the time series of what for each virus.
+     * @return In `get_hist_total_date` and `get_hist_virus_date` the
+     * corresponding date
+     * @return In `get_active_cases`, the number of active cases (currently infected individuals)
+     * for each virus at each point in time.
+     */
+    ///@{
+    int get_today_total(const std::string & what) const;
+    int get_today_total(const epiworld_fast_uint & what) const;
+    void get_today_total(
+        std::vector< std::string > * state = nullptr,
+        std::vector< int > * counts = nullptr
+    ) const;
+
+    void get_today_virus(
+        std::vector< std::string > & state,
+        std::vector< int > & id,
+        std::vector< int > & counts
+    ) const;
+
+    void get_today_transition_matrix(
+        std::vector< int > & counts
+    ) const;
+
+    void get_hist_total(
+        std::vector< int > * date,
+        std::vector< std::string > * state,
+        std::vector< int > * counts
+    ) const;
+
+    void get_hist_virus(
+        std::vector< int > & date,
+        std::vector< int > & id,
+        std::vector< std::string > & state,
+        std::vector< int > & counts
+    ) const;
+
+    void get_hist_tool(
+        std::vector< int > & date,
+        std::vector< int > & id,
+        std::vector< std::string > & state,
+        std::vector< int > & counts
+    ) const;
+
+    void get_hist_transition_matrix(
+        std::vector< std::string > & state_from,
+        std::vector< std::string > & state_to,
+        std::vector< int > & date,
+        std::vector< int > & counts,
+        bool skip_zeros
+    ) const;
+
+    void get_active_cases(
+        std::vector< int > & date,
+        std::vector< int > & virus_id,
+        std::vector< int > & count
+    ) const;
+
+    void get_outbreak_size(
+        std::vector< int > & date,
+        std::vector< int > & virus_id,
+        std::vector< int > & size
+    ) const;
+    ///@}
+
+    /**
+     * @brief Get the transmissions object
+     *
+     * @param date
+     * @param source
+     * @param target
+     * @param virus
+     * @param source_exposure_date
+     */
+    ///@{
+    void get_transmissions(
+        std::vector<int> & date,
+        std::vector<int> & source,
+        std::vector<int> & target,
+        std::vector<int> & virus,
+        std::vector<int> & source_exposure_date
+    ) const;
+
+    void get_transmissions(
+        int * date,
+        int * source,
+        int * target,
+        int * virus,
+        int * source_exposure_date
+    ) const;
+    ///@}
+
+    void write_data(
+        std::string fn_virus_info,
+        std::string fn_virus_hist,
+        std::string fn_tool_info,
+        std::string fn_tool_hist,
+        std::string fn_total_hist,
+        std::string fn_transmission,
+        std::string fn_transition,
+        std::string fn_reproductive_number,
+        std::string fn_generation_time,
+        std::string fn_active_cases,
+        std::string fn_outbreak_size,
+        std::string fn_hospitalizations
+        ) const;
+
+    /***
+     * @brief Record a transmission event
+     * @param i,j Integers. Id of the source and target agents.
+     * @param virus Integer. Id of the virus.
+     * @param i_expo_date Integer. Date when the source agent was infected.
+     * @details
+     * If i is -1, then it means that the agent was assigned a virus at the
+     * beginning of the simulation.
+     */
+    void record_transmission(int i, int j, int virus, int i_expo_date);
+
+    size_t get_n_viruses() const; ///< Get the number of viruses
+    size_t get_n_tools() const; ///< Get the number of tools
+
+    void set_user_data(std::vector< std::string > names);
+    void add_user_data(std::vector< epiworld_double > x);
+    void add_user_data(epiworld_fast_uint j, epiworld_double x);
+    UserData<TSeq> & get_user_data();
+
+
+    /**
+     * @brief Computes the reproductive number of each case
+     *
+     * @details By definition, whereas it computes R0 (basic reproductive number)
+     * or Rt/R (the effective reproductive number) will depend on whether the
+     * virus is allowed to circulate naïvely or not, respectively.
+     *
+     * @param fn File where to write out the reproductive number.
+     * @details
+     * In the case of `MapVec_type<int,int>`, the key is a vector of 3 integers:
+     * - Virus id
+     * - Source id
+     * - Date when the source was infected
+     * 
+     * The seed cases are those with source id != -1 and date when the source
+     * was infected == 0. Cases with source id == -1 is equivalent to the 
+     * Model's reproductive number, this is, the initial number of cases
+     * at the beginning of the simulation.
+     */
+    ///@{
+    MapVec_type<int,int> get_reproductive_number() const;
+
+    void get_reproductive_number(
+        std::string fn
+        ) const;
+    ///@}
+
+    /**
+     * @brief Calculates the transition probabilities
+     * @param print Print the transition matrix.
+     * @param normalize Normalize the transition matrix. Otherwise,
+     * it returns raw counts.
+     * @details
+     * The transition matrix is the matrix of the counts of transitions
+     * from one state to another. So the ij-th element of the matrix is
+     * the number of transitions from state i to state j (when not normalized),
+     * or the probability of transitioning from state i to state j
+     * (when normalized).
+     * @return std::vector< epiworld_double >
+     */
+    std::vector< epiworld_double > get_transition_probability(
+        bool print = true,
+        bool normalize = true
+    ) const;
+
+    bool operator==(const DataBase<TSeq> & other) const;
+    bool operator!=(const DataBase<TSeq> & other) const {return !operator==(other);};
+
+    /**
+     * Calculates the generating time
+     * @param agent_id,virus_id,time,gentime vectors where to save the values
+     *
+     * @details
+     * The generation time is the time between the infection of the source and
+     * the infection of the target.
+    */
+   ///@{
+    void get_generation_time(
+        std::vector< int > & agent_id,
+        std::vector< int > & virus_id,
+        std::vector< int > & time,
+        std::vector< int > & gentime
+    ) const; ///< Get the generation time
+
+    void get_generation_time(
+        std::string fn
+    ) const; ///< Write the generation time to a file
+    ///@}
+
+    /**
+     * @brief Record a hospitalization event for an agent.
+     * 
+     * @param agent Reference to the agent being hospitalized.
+     * 
+     * @details
+     * For each hospitalization, the method records:
+     * - The current date from the model
+     * - The virus ID from the agent's virus
+     * - For each tool the agent has, a separate record with weight = 1/N
+     *   where N is the number of tools
+     * - If the agent has no tools, a single record with tool_id = -1 and
+     *   weight = 1.0
+     */
+    void record_hospitalization(Agent<TSeq> & agent);
+
+    /**
+     * @brief Get the full time series of hospitalization data.
+     * 
+     * @param date Output vector for dates.
+     * @param virus_id Output vector for virus IDs.
+     * @param tool_id Output vector for tool IDs.
+     * @param count Output vector for counts (number of hospitalized individuals).
+     * @param weight Output vector for summed weights (fractional contribution
+     *   based on tool distribution).
+     * 
+     * @details
+     * Returns the full time series of hospitalization data. For each unique 
+     * (virus_id, tool_id) combination observed, returns an entry for every 
+     * day from 0 to ndays-1.
+     * 
+     * The `count` vector contains the actual number of individuals hospitalized 
+     * for that (date, virus_id, tool_id) combination. This is useful for 
+     * answering questions like "how many total people were hospitalized?" 
+     * regardless of their tools.
+     * 
+     * The `weight` vector contains fractional contributions: if an agent has N 
+     * tools, each tool gets weight = 1/N. Summing weights across all tool_ids 
+     * for a given date and virus_id gives the total number of hospitalizations.
+     */
+    void get_hospitalizations(
+        std::vector<int> & date,
+        std::vector<int> & virus_id,
+        std::vector<int> & tool_id,
+        std::vector<int> & count,
+        std::vector<double> & weight
+    ) const;
+
+};
+
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/database-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/database-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_DATABASE_MEAT_HPP
+#define EPIWORLD_DATABASE_MEAT_HPP
+
+#include <vector>
+#include <string>
+// (already included include/epiworld/config.hpp)
+// (already included include/epiworld/epiworld-macros.hpp)
+// (already included include/epiworld/misc.hpp)
+// (already included include/epiworld/database-bones.hpp)
+
+template<typename TSeq>
+inline void DataBase<TSeq>::reset()
+{
+
+    // Initializing the counts
+    today_total.assign(model->nstates, 0);
+    for (auto & p : model->get_agents())
+        ++today_total[p.get_state()];
+
+    #ifdef EPI_DEBUG
+    // Only the first should be different from zero
+    {
+        int n = static_cast<int>(model->size());
+        if (today_total[0] != n)
+            throw std::runtime_error("The number of susceptible agents is not equal to the total number of agents.");
+
+        if (std::accumulate(today_total.begin(), today_total.end(), 0) != n)
+            throw std::runtime_error("The total number of agents is not equal to the sum of the number of agents in each state.");
+            
+    }
+    #endif
+
+    
+    transition_matrix.assign(model->nstates * model->nstates, 0);
+    for (size_t s = 0u; s < model->nstates; ++s)
+        transition_matrix[s + s * model->nstates] = today_total[s];
+
+    hist_virus_date.clear();
+    hist_virus_id.clear();
+    hist_virus_state.clear();
+    hist_virus_counts.clear();
+
+    hist_tool_date.clear();
+    hist_tool_id.clear();
+    hist_tool_state.clear();
+    hist_tool_counts.clear();    
+
+    today_virus.resize(get_n_viruses());
+    for (auto& virus_states : today_virus)
+        virus_states.assign(model->nstates, 0);
+
+    today_tool.resize(get_n_tools());
+    for (auto& tool_states : today_tool)
+        tool_states.assign(model->nstates, 0);
+
+    hist_total_date.clear();
+    hist_total_state.clear();
+    hist_total_nviruses_active.clear();
+    hist_total_counts.clear();
+    hist_transition_matrix.clear();
+
+    transmission_date.clear();
+    transmission_virus.clear();
+    transmission_source.clear();
+    transmission_target.clear();
+    transmission_source_exposure_date.clear();
+
+    m_hospitalizations.reset();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline DataBase<TSeq>::DataBase(const DataBase<TSeq> & db) :
+    m_hospitalizations(db.m_hospitalizations),
+    virus_id(db.virus_id),
+    virus_name(db.virus_name),
+    virus_sequence(db.virus_sequence),
+    virus_origin_date(db.virus_origin_date),
+    virus_parent_id(db.virus_parent_id),
+    tool_id(db.tool_id),
+    tool_name(db.tool_name),
+    tool_sequence(db.tool_sequence),
+    tool_origin_date(db.tool_origin_date),
+    seq_hasher(db.seq_hasher),
+    seq_writer(db.seq_writer),
+    // {Variant 1: {state 1, state 2, etc.}, Variant 2: {...}, ...}
+    today_virus(db.today_virus),
+    // {Variant 1: {state 1, state 2, etc.}, Variant 2: {...}, ...}
+    today_tool(db.today_tool),
+    // {Susceptible, Infected, etc.}
+    today_total(db.today_total),
+    // Totals
+    today_total_nviruses_active(db.today_total_nviruses_active),
+    sampling_freq(db.sampling_freq),
+    // Variants history
+    hist_virus_date(db.hist_virus_date),
+    hist_virus_id(db.hist_virus_id),
+    hist_virus_state(db.hist_virus_state),
+    hist_virus_counts(db.hist_virus_counts),
+    // Tools history
+    hist_tool_date(db.hist_tool_date),
+    hist_tool_id(db.hist_tool_id),
+    hist_tool_state(db.hist_tool_state),
+    hist_tool_counts(db.hist_tool_counts),
+    // Overall hist
+    hist_total_date(db.hist_total_date),
+    hist_total_nviruses_active(db.hist_total_nviruses_active),
+    hist_total_state(db.hist_total_state),
+    hist_total_counts(db.hist_total_counts),
+    hist_transition_matrix(db.hist_transition_matrix),
+    // Transmission network
+    transmission_date(db.transmission_date),
+    transmission_source(db.transmission_source),
+    transmission_target(db.transmission_target),
+    transmission_virus(db.transmission_virus),
+    transmission_source_exposure_date(db.transmission_source_exposure_date),
+    transition_matrix(db.transition_matrix),
+    user_data(nullptr)
+{}
+
+// DataBase<TSeq> & DataBase<TSeq>::operator=(const DataBase<TSeq> & m)
+// {
+
+// }
+
+template<typename TSeq>
+inline Model<TSeq> * DataBase<TSeq>::get_model() {
+    return model;
+}
+
+template<typename TSeq>
+inline const std::vector< TSeq > & DataBase<TSeq>::get_sequence() const {
+    return virus_sequence;
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::record() 
+{
+
+    ////////////////////////////////////////////////////////////////////////////
+    // DEBUGGING BLOCK
+    ////////////////////////////////////////////////////////////////////////////
+    EPI_DEBUG_ALL_NON_NEGATIVE(today_total)
+
+    #ifdef EPI_DEBUG
+    // Checking whether the sums correspond (aggregated runs have no agents)
+    if (model->size() > 0u)
+    {
+        EPI_DEBUG_SUM_INT(today_total, model->size())
+
+        std::vector< int > _today_total_cp(today_total.size(), 0);
+        for (auto s : model->agents_state)
+            _today_total_cp[s]++;
+
+        for (auto & p : model->population)
+            if (model->agents_state[p.get_id()] != p.get_state())
+                throw std::logic_error(
+                    "Model::agents_state doesn't match the state of agent " +
+                    std::to_string(p.get_id()) + "."
+                );
+
+        EPI_DEBUG_VECTOR_MATCH_INT(
+            _today_total_cp, today_total,
+            "Sums of __today_total_cp in database-meat.hpp"
+            )
+    }
+
+    if (model->today() == 0)
+    {
+        if (hist_total_date.size() != 0)
+            EPI_DEBUG_ERROR(std::logic_error, "DataBase::record hist_total_date should be of length 0.")
+        if (hist_total_nviruses_active.size() != 0)
+            EPI_DEBUG_ERROR(std::logic_error, "DataBase::record hist_total_nviruses_active should be of length 0.")
+        if (hist_total_state.size() != 0)
+            EPI_DEBUG_ERROR(std::logic_error, "DataBase::record hist_total_state should be of length 0.")
+        if (hist_total_counts.size() != 0)
+            EPI_DEBUG_ERROR(std::logic_error, "DataBase::record hist_total_counts should be of length 0.")
+        if (hist_virus_date.size() != 0)
+            EPI_DEBUG_ERROR(std::logic_error, "DataBase::record hist_virus_date should be of length 0.")
+        if (hist_virus_id.size() != 0)
+            EPI_DEBUG_ERROR(std::logic_error, "DataBase::record hist_virus_id should be of length 0.")
+        if (hist_virus_state.size() != 0)
+            EPI_DEBUG_ERROR(std::logic_error, "DataBase::record hist_virus_state should be of length 0.")
+        if (hist_virus_counts.size() != 0)
+            EPI_DEBUG_ERROR(std::logic_error, "DataBase::record hist_virus_counts should be of length 0.")
+        if (hist_tool_date.size() != 0)
+            EPI_DEBUG_ERROR(std::logic_error, "DataBase::record hist_tool_date should be of length 0.")
+        if (hist_tool_id.size() != 0)
+            EPI_DEBUG_ERROR(std::logic_error, "DataBase::record hist_tool_id should be of length 0.")
+        if (hist_tool_state.size() != 0)
+            EPI_DEBUG_ERROR(std::logic_error, "DataBase::record hist_tool_state should be of length 0.")
+        if (hist_tool_counts.size() != 0)
+            EPI_DEBUG_ERROR(std::logic_error, "DataBase::record hist_tool_counts should be of length 0.")
+    }
+    #endif
+    ////////////////////////////////////////////////////////////////////////////
+
+    // Only store every now and then
+    if ((model->today() % sampling_freq) == 0)
+    {
+
+        // Recording virus's history
+        for (auto & p : virus_id)
+        {
+
+            for (epiworld_fast_uint s = 0u; s < model->nstates; ++s)
+            {
+
+                hist_virus_date.push_back(model->today());
+                hist_virus_id.push_back(p.second);
+                hist_virus_state.push_back(s);
+
+                #ifdef EPI_DEBUG
+                if (today_virus[p.second][s] < 0)
+                    throw std::logic_error(
+                        "The count of viruses in DataBase::record cannot be negative."
+                    );
+                #endif
+
+                hist_virus_counts.push_back(today_virus[p.second][s]);
+
+            }
+
+        }
+
+        // Recording tool's history
+        for (auto & p : tool_id)
+        {
+
+            for (epiworld_fast_uint s = 0u; s < model->nstates; ++s)
+            {
+
+                hist_tool_date.push_back(model->today());
+                hist_tool_id.push_back(p.second);
+                hist_tool_state.push_back(s);
+                hist_tool_counts.push_back(today_tool[p.second][s]);
+
+            }
+
+        }
+
+        // Recording the overall history
+        for (epiworld_fast_uint s = 0u; s < model->nstates; ++s)
+        {
+            hist_total_date.push_back(model->today());
+            hist_total_nviruses_active.push_back(today_total_nviruses_active);
+            hist_total_state.push_back(s);
+            hist_total_counts.push_back(today_total[s]);
+        }
+
+        for (const auto& cell : transition_matrix)
+            hist_transition_matrix.push_back(cell);
+
+        // Now the diagonal must reflect the state
+        for (size_t s_i = 0u; s_i < model->nstates; ++s_i)
+        {
+
+            for (size_t s_j = 0u; s_j < model->nstates; ++s_j)
+            {
+                
+                if ((s_i != s_j) && (transition_matrix[s_i + s_j * model->nstates] > 0))
+                {
+                    transition_matrix[s_j + s_j * model->nstates] +=
+                        transition_matrix[s_i + s_j * model->nstates];
+
+                    transition_matrix[s_i + s_j * model->nstates] = 0;
+                }
+         
+            }
+
+        }
+
+        #ifdef EPI_DEBUG
+        for (size_t s_i = 0u; s_i < model->nstates; ++s_i)
+        {
+            if (transition_matrix[s_i + s_i * model->nstates] != 
+                today_total[s_i])
+                throw std::logic_error(
+                    "The diagonal of the updated transition Matrix should match the daily totals"
+                    );
+        }
+        #endif
+
+    }
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::record_virus(Virus<TSeq> & v)
+{
+
+    // If no sequence, then need to add one. This is regardless of the case
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        if (v.get_sequence() == -1)
+            v.set_sequence(default_sequence<TSeq>(
+                static_cast<int>(virus_name.size())
+                ));
+    }
+    else
+    {
+        if (v.get_sequence() == nullptr)
+            v.set_sequence(default_sequence<TSeq>(
+                static_cast<int>(virus_name.size())
+                ));        
+    }
+
+    // Negative id -> virus hasn't been recorded
+    if (v.get_id() < 0)
+    {
+
+        epiworld_fast_uint new_id = virus_id.size();
+        virus_name.push_back(v.get_name());
+
+        // Generating the hash
+        std::vector< int > hash;
+        EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+        {
+            hash = seq_hasher(v.get_sequence());
+            virus_id[hash] = new_id;
+            virus_sequence.push_back(v.get_sequence());
+        }
+        else
+        {
+            hash = seq_hasher(*v.get_sequence());
+            virus_id[hash] = new_id;
+            virus_sequence.push_back(*v.get_sequence());
+        }
+
+
+        virus_origin_date.push_back(model->today());
+        
+        virus_parent_id.push_back(v.get_id()); // Must be -99
+        
+        today_virus.push_back({});
+        today_virus[new_id].resize(model->nstates, 0);
+       
+        // Updating the variant
+        v.set_id(new_id);
+        v.set_date(model->today());
+
+        today_total_nviruses_active++;
+
+    }
+    else
+    { // In this case, the virus is already on record, need to make sure
+             // The new sequence is new.
+
+        // Updating registry
+        std::vector< int > hash;
+        EPI_IF_TSEQ_LESS_EQ_INT(TSeq)
+        {
+            hash = seq_hasher(v.get_sequence());
+        }
+        else
+        {
+            hash = seq_hasher(*v.get_sequence());
+        }
+        epiworld_fast_uint old_id = v.get_id();
+        epiworld_fast_uint new_id;
+
+        // If the sequence is new, then it means that the
+        if (virus_id.find(hash) == virus_id.end())
+        {
+
+            new_id = virus_id.size();
+            virus_id[hash] = new_id;
+            virus_name.push_back(v.get_name());
+
+            EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+            {
+                virus_sequence.push_back(v.get_sequence());
+            }
+            else
+            {
+                virus_sequence.push_back(*v.get_sequence());
+            }
+
+            virus_origin_date.push_back(model->today());
+            
+            virus_parent_id.push_back(old_id);
+            
+            today_virus.push_back({});
+            today_virus[new_id].resize(model->nstates, 0);
+        
+            // Updating the variant
+            v.set_id(new_id);
+            v.set_date(model->today());
+
+            today_total_nviruses_active++;
+
+        } else {
+
+            // Finding the id
+            new_id = virus_id[hash];
+
+            // Reflecting the change
+            v.set_id(new_id);
+            v.set_date(virus_origin_date[new_id]);
+
+        }
+
+        // Moving statistics (only if we are affecting an individual)
+        if (v.get_agent() != nullptr)
+        {
+            // Correcting math
+            epiworld_fast_uint tmp_state = v.get_agent()->get_state();
+            today_virus[old_id][tmp_state]--;
+            today_virus[new_id][tmp_state]++;
+
+            #ifdef EPI_DEBUG
+            if (today_virus[old_id][tmp_state] < 0)
+                throw std::logic_error("An entry in today_virus is negative.");
+            #endif
+
+        }
+
+    }
+    
+    return;
+
+} 
+
+template<typename TSeq>
+inline void DataBase<TSeq>::record_tool(Tool<TSeq> & t)
+{
+
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        if (t.get_sequence() == -1)
+            t.set_sequence(default_sequence<TSeq>(
+                static_cast<int>(tool_name.size())
+            ));
+    }
+    else
+    {
+        if (t.get_sequence() == nullptr)
+            t.set_sequence(default_sequence<TSeq>(
+                static_cast<int>(tool_name.size())
+            ));
+    }
+
+    if (t.get_id() < 0) 
+    {
+
+        epiworld_fast_uint new_id = tool_id.size();
+        tool_name.push_back(t.get_name());
+
+        std::vector< int > hash;
+        EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+        {
+            hash = seq_hasher(t.get_sequence());
+            tool_id[hash] = new_id;
+            tool_sequence.push_back(t.get_sequence());
+        }
+        else
+        {
+            hash = seq_hasher(*t.get_sequence());
+            tool_id[hash] = new_id;
+            tool_sequence.push_back(*t.get_sequence());
+
+        }
+        tool_origin_date.push_back(model->today());
+                
+        today_tool.push_back({});
+        today_tool[new_id].resize(model->nstates, 0);
+
+        // Updating the tool
+        t.set_id(new_id);
+        t.set_date(model->today());
+
+    } else {
+
+        // Updating registry
+        std::vector< int > hash;
+        EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+        {
+            hash = seq_hasher(t.get_sequence());
+        }
+        else
+        {
+            hash = seq_hasher(*t.get_sequence());
+        }
+        epiworld_fast_uint old_id = t.get_id();
+        epiworld_fast_uint new_id;
+        
+        if (tool_id.find(hash) == tool_id.end())
+        {
+
+            new_id = tool_id.size();
+            tool_id[hash] = new_id;
+            tool_name.push_back(t.get_name());
+
+            EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+            {
+                tool_sequence.push_back(t.get_sequence());
+            }
+            else
+            {
+                tool_sequence.push_back(*t.get_sequence());
+            }
+            
+            tool_origin_date.push_back(model->today());
+                    
+            today_tool.push_back({});
+            today_tool[new_id].resize(model->nstates, 0);
+
+            // Updating the tool
+            t.set_id(new_id);
+            t.set_date(model->today());
+
+        } else {
+
+            // Finding the id
+            new_id = tool_id[hash];
+
+            // Reflecting the change
+            t.set_id(new_id);
+            t.set_date(tool_origin_date[new_id]);
+
+        }
+
+        // Moving statistics (only if we are affecting an individual)
+        if (t.get_agent() != nullptr)
+        {
+            // Correcting math
+            epiworld_fast_uint tmp_state = t.get_agent()->get_state();
+            today_tool[old_id][tmp_state]--;
+            today_tool[new_id][tmp_state]++;
+
+        }
+
+    }
+
+    
+    
+    return;
+} 
+
+template<typename TSeq>
+inline size_t DataBase<TSeq>::size() const
+{
+    return virus_id.size();
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::update_state(
+        epiworld_fast_uint prev_state,
+        epiworld_fast_uint new_state,
+        bool undo
+) {
+
+    if (prev_state == new_state)
+        return; // No need to update if the state is the same
+
+    #ifdef EPI_DEBUG
+    // Checking ranges (should be within expected)
+    if ((prev_state >= model->nstates))
+        throw std::out_of_range(
+            "prev_state is out of range in DataBase::update_state"
+        );
+    if ((new_state >= model->nstates))
+        throw std::out_of_range(
+            "new_state is out of range in DataBase::update_state"
+        );
+    if (prev_state == new_state)
+        throw std::logic_error(
+            "prev_state and new_state are the same in DataBase::update_state"
+        );
+    #endif
+
+    if (batch_transitions)
+    {
+        batch_counts[new_state * model->nstates + prev_state] += undo ? -1 : 1;
+        batch_dirty = true;
+        return;
+    }
+
+    if (undo)
+    {
+
+        today_total[prev_state]++;
+        today_total[new_state]--;
+        
+    } else {
+
+        today_total[prev_state]--;
+        today_total[new_state]++;
+
+    }
+
+    record_transition(prev_state, new_state, undo);
+    
+    return;
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::batch_on()
+{
+
+    batch_counts.assign(model->nstates * model->nstates, 0);
+    batch_transitions = true;
+    batch_dirty = false;
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::batch_off()
+{
+
+    batch_transitions = false;
+
+    if (!batch_dirty)
+        return;
+
+    const size_t n = model->nstates;
+    for (size_t to = 0u; to < n; ++to)
+        for (size_t from = 0u; from < n; ++from)
+        {
+
+            int & c = batch_counts[to * n + from];
+            if (c == 0)
+                continue;
+
+            today_total[from] -= c;
+            today_total[to]   += c;
+
+            transition_matrix[to * n + from]   += c;
+            transition_matrix[from * n + from] -= c;
+
+            #ifdef EPI_DEBUG
+            if (transition_matrix[from * n + from] < 0)
+                throw std::logic_error("An entry in transition matrix is negative.");
+            #endif
+
+            c = 0;
+
+        }
+
+    batch_dirty = false;
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::update_virus(
+        epiworld_fast_uint virus_id,
+        epiworld_fast_uint prev_state,
+        epiworld_fast_uint new_state,
+        bool undo
+) {
+
+    if (undo)
+    {
+        today_virus[virus_id][prev_state]++;
+        today_virus[virus_id][new_state]--;
+    }
+    else
+    {
+        today_virus[virus_id][prev_state]--;
+        today_virus[virus_id][new_state]++;
+    }
+
+    #ifdef EPI_DEBUG
+    if (today_virus[virus_id][prev_state] < 0)
+        throw std::logic_error("An entry in today_virus is negative.");
+    if (today_virus[virus_id][new_state] < 0)
+        throw std::logic_error("An entry in today_virus is negative (new_state).");
+    #endif
+
+    return;
+    
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::update_tool(
+        epiworld_fast_uint tool_id,
+        epiworld_fast_uint prev_state,
+        epiworld_fast_uint new_state,
+        bool undo
+) {
+
+    if (undo)
+    {
+        today_tool[tool_id][prev_state]++;
+        today_tool[tool_id][new_state]--;
+    }
+    else
+    {
+        today_tool[tool_id][prev_state]--;
+        today_tool[tool_id][new_state]++;
+    }
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::record_transition(
+    epiworld_fast_uint from,
+    epiworld_fast_uint to,
+    bool undo
+) {
+
+    if (undo)
+    {   
+
+        transition_matrix[to * model->nstates + from]--;
+        transition_matrix[from * model->nstates + from]++;
+
+    } else {
+
+        transition_matrix[to * model->nstates + from]++;
+        transition_matrix[from * model->nstates + from]--;
+
+    }
+
+    #ifdef EPI_DEBUG
+    if (transition_matrix[from * model->nstates + from] < 0)
+        throw std::logic_error("An entry in transition matrix is negative.");
+    #endif
+
+}
+
+template<typename TSeq>
+inline int DataBase<TSeq>::get_today_total(
+    const std::string & what
+) const
+{
+
+    for (auto i = 0u; i < model->states_labels.size(); ++i)
+    {
+        if (model->states_labels[i] == what)
+            return today_total[i];
+    }
+
+    throw std::range_error("The value '" + what + "' is not in the model.");
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::get_today_total(
+    std::vector< std::string > * state,
+    std::vector< int > * counts
+) const
+{
+    if (state != nullptr)
+        (*state) = model->states_labels;
+
+    if (counts != nullptr)
+        *counts = today_total;
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::get_today_virus(
+    std::vector< std::string > & state,
+    std::vector< int > & id,
+    std::vector< int > & counts
+    ) const
+{
+    
+    // Total entries = number of viruses × number of states
+    size_t n_viruses = today_virus.size();
+    size_t n_states = model->states_labels.size();
+    size_t total_entries = n_viruses * n_states;
+
+    state.resize(total_entries, "");
+    id.resize(total_entries, 0);
+    counts.resize(total_entries, 0);
+
+    size_t n = 0u;
+    for (epiworld_fast_uint v = 0u; v < n_viruses; ++v)
+        for (epiworld_fast_uint s = 0u; s < n_states; ++s)
+        {
+            state[n]   = model->states_labels[s];
+            id[n]      = static_cast<int>(v);
+            counts[n]  = today_virus[v][s];
+            ++n;
+        }
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::get_hist_total(
+    std::vector< int > * date,
+    std::vector< std::string > * state,
+    std::vector< int > * counts
+) const
+{
+
+    if (date != nullptr)
+        *date = hist_total_date;
+
+    if (state != nullptr)
+    {
+        state->resize(hist_total_state.size(), "");
+        for (epiworld_fast_uint i = 0u; i < hist_total_state.size(); ++i)
+            state->operator[](i) = model->states_labels[hist_total_state[i]];
+    }
+
+    if (counts != nullptr)
+        *counts = hist_total_counts;
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::get_hist_virus(
+    std::vector< int > & date,
+    std::vector< int > & id,
+    std::vector< std::string > & state,
+    std::vector< int > & counts
+) const {
+
+    date = hist_virus_date;
+    const auto& labels = model->states_labels;
+    
+    id = hist_virus_id;
+    state.resize(hist_virus_state.size(), "");
+    for (epiworld_fast_uint i = 0u; i < hist_virus_state.size(); ++i)
+        state[i] = labels[hist_virus_state[i]];
+
+    counts = hist_virus_counts;
+
+    return;
+
+}
+
+
+template<typename TSeq>
+inline void DataBase<TSeq>::get_hist_tool(
+    std::vector< int > & date,
+    std::vector< int > & id,
+    std::vector< std::string > & state,
+    std::vector< int > & counts
+) const {
+
+    date = hist_tool_date;
+    const auto& labels = model->states_labels;
+    
+    id = hist_tool_id;
+    state.resize(hist_tool_state.size(), "");
+    for (size_t i = 0u; i < hist_tool_state.size(); ++i)
+        state[i] = labels[hist_tool_state[i]];
+
+    counts = hist_tool_counts;
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::get_today_transition_matrix(
+    std::vector< int > & counts
+) const
+{
+
+    counts = transition_matrix;
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::get_hist_transition_matrix(
+    std::vector< std::string > & state_from,
+    std::vector< std::string > & state_to,
+    std::vector< int > & date,
+    std::vector< int > & counts,
+    bool skip_zeros
+) const
+{
+
+    size_t n = this->hist_transition_matrix.size();
+    
+    // Clearing the previous vectors
+    state_from.clear();
+    state_to.clear();
+    date.clear();
+    counts.clear();
+
+    // Reserving space
+    state_from.reserve(n);
+    state_to.reserve(n);
+    date.reserve(n);
+    counts.reserve(n);
+
+    size_t n_states = model->nstates;
+    size_t n_steps  = model->get_ndays();
+
+    // If n is zero, then we are done
+    if (n == 0u)
+        return;
+
+    for (size_t step = 0u; step <= n_steps; ++step) // The final step counts
+    {
+        for (size_t j = 0u; j < n_states; ++j) // Column major storage
+        {
+            for (size_t i = 0u; i < n_states; ++i)
+            {
+                // Retrieving the value of the day
+                int v = hist_transition_matrix[
+                    step * n_states * n_states + // Day of the data
+                    j * n_states +               // Column (to)
+                    i                            // Row (from)
+                    ];
+
+                // If we are skipping the zeros and it is zero, then don't save
+                if (skip_zeros && v == 0)
+                    continue;
+                                
+                state_from.push_back(model->states_labels[i]);
+                state_to.push_back(model->states_labels[j]);
+                date.push_back(hist_total_date[step * n_states]);
+                counts.push_back(v);
+
+            }
+
+        }
+    }
+
+    return;
+
+
+}
+
+
+template<typename TSeq>
+inline void DataBase<TSeq>::get_active_cases(
+    std::vector<int> & date,
+    std::vector<int> & virus_id,
+    std::vector<int> & count
+) const 
+{
+
+    // Extracting useful sizes
+    size_t n_days    = model->get_ndays() + 1u; // Including day 0
+    size_t n_viruses = model->get_n_viruses();
+    
+    // Making room
+    date.assign(n_days * n_viruses, 0);
+    virus_id.assign(n_days * n_viruses, 0);
+    count.assign(n_days * n_viruses, 0);
+
+    for (size_t i = 0u; i < hist_virus_id.size(); ++i)
+    {
+
+        // With more viruses, there are more days
+        auto location = hist_virus_date[i] + hist_virus_id[i] * n_days;
+
+        date[location] = hist_virus_date[i];
+        virus_id[location] = hist_virus_id[i];
+        count[location] += hist_virus_counts[i];
+
+    }
+
+    return;
+    
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::get_outbreak_size(
+    std::vector<int> & date,
+    std::vector<int> & virus_id,
+    std::vector<int> & outbreak_size
+) const 
+{
+
+    // Extracting useful sizes
+    size_t n_days    = model->get_ndays() + 1u; // Including day 0
+    size_t n_viruses = model->get_n_viruses();
+    
+    // Making room
+    date.assign(n_days * n_viruses, 0);
+    std::iota(date.begin(), date.end(), 0);
+
+    virus_id.assign(n_days * n_viruses, 0);
+    for (size_t v = 0u; v < n_viruses; ++v)
+        for (size_t d = 0u; d < n_days; ++d)
+            virus_id[d + v * n_days] = static_cast<int>(v);
+
+    outbreak_size.assign(n_days * n_viruses, 0);
+
+    // With more viruses, there are more days;
+    for (size_t i = 0u; i < transmission_date.size(); ++i)
+    {
+        outbreak_size[
+            transmission_date[i] + transmission_virus[i] * n_days
+        ] += 1;
+    }
+
+    // Now, we generate the cumulative sum
+    for (size_t v = 0u; v < n_viruses; ++v)
+    {
+        for (size_t d = 1u; d < n_days; ++d)
+        {
+            auto location = d + v * n_days;
+            outbreak_size[location] += outbreak_size[location - 1u];
+        }
+    }
+
+    return;
+    
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::get_transmissions(
+    std::vector<int> & date,
+    std::vector<int> & source,
+    std::vector<int> & target,
+    std::vector<int> & virus,
+    std::vector<int> & source_exposure_date
+) const 
+{
+
+    size_t nevents = transmission_date.size();
+
+    date.resize(nevents);
+    source.resize(nevents);
+    target.resize(nevents);
+    virus.resize(nevents);
+    source_exposure_date.resize(nevents);
+
+    get_transmissions(
+        &date[0u],
+        &source[0u],
+        &target[0u],
+        &virus[0u],
+        &source_exposure_date[0u]
+    );
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::get_transmissions(
+    int * date,
+    int * source,
+    int * target,
+    int * virus,
+    int * source_exposure_date
+) const 
+{
+
+    size_t nevents = transmission_date.size();
+
+    for (size_t i = 0u; i < nevents; ++i)
+    {
+
+        *(date + i) = transmission_date.at(i);
+        *(source + i) = transmission_source.at(i);
+        *(target + i) = transmission_target.at(i);
+        *(virus + i) = transmission_virus.at(i);
+        *(source_exposure_date + i) = transmission_source_exposure_date.at(i);
+
+    }
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::write_data(
+    std::string fn_virus_info,
+    std::string fn_virus_hist,
+    std::string fn_tool_info,
+    std::string fn_tool_hist,
+    std::string fn_total_hist,
+    std::string fn_transmission,
+    std::string fn_transition,
+    std::string fn_reproductive_number,
+    std::string fn_generation_time,
+    std::string fn_active_cases,
+    std::string fn_outbreak_size,
+    std::string fn_hospitalizations
+) const
+{
+
+    if (fn_virus_info != "")
+    {
+        std::ofstream file_virus_info(fn_virus_info, std::ios_base::out);
+
+        // Check if the file exists and throw an error if it doesn't
+        if (!file_virus_info)
+        {
+            throw std::runtime_error(
+                "Could not open file \"" + fn_virus_info +
+                "\" for writing.")
+                ;
+        }
+
+
+        file_virus_info <<
+        #ifdef EPI_DEBUG
+            "thread " << "virus_id " << "virus " << "virus_sequence " << "date_recorded " << "parent\n";
+        #else
+            "virus_id " << "virus " << "virus_sequence " << "date_recorded " << "parent\n";
+        #endif
+
+        for (const auto & v : virus_id)
+        {
+            int id = v.second;
+            file_virus_info <<
+                #ifdef EPI_DEBUG
+                EPI_GET_THREAD_ID() << " " <<
+                #endif
+                id << " \"" <<
+                virus_name[id] << "\" " <<
+                seq_writer(virus_sequence[id]) << " " <<
+                virus_origin_date[id] << " " <<
+                virus_parent_id[id] << "\n";
+        }
+
+    }
+
+    if (fn_virus_hist != "")
+    {
+        std::ofstream file_virus(fn_virus_hist, std::ios_base::out);
+        
+        // Repeat the same error if the file doesn't exists
+        if (!file_virus)
+        {
+            throw std::runtime_error(
+                "Could not open file \"" + fn_virus_hist +
+                "\" for writing.")
+                ;
+        }
+
+        file_virus <<
+            #ifdef EPI_DEBUG
+            "thread "<< "date " << "virus_id " << "virus " << "state " << "n\n";
+            #else
+            "date " << "virus_id " << "virus " << "state " << "n\n";
+            #endif
+
+        for (epiworld_fast_uint i = 0; i < hist_virus_id.size(); ++i)
+            file_virus <<
+                #ifdef EPI_DEBUG
+                EPI_GET_THREAD_ID() << " " <<
+                #endif
+                hist_virus_date[i] << " " <<
+                hist_virus_id[i] << " \"" <<
+                virus_name[hist_virus_id[i]] << "\" \"" <<
+                model->states_labels[hist_virus_state[i]] << "\" " <<
+                hist_virus_counts[i] << "\n";
+    }
+
+    if (fn_tool_info != "")
+    {
+        std::ofstream file_tool_info(fn_tool_info, std::ios_base::out);
+
+        // Repeat the same error if the file doesn't exists
+        if (!file_tool_info)
+        {
+            throw std::runtime_error(
+                "Could not open file \"" + fn_tool_info +
+                "\" for writing.")
+                ;
+        }
+
+        file_tool_info <<
+            #ifdef EPI_DEBUG
+            "thread " << 
+            #endif
+            "id " << "tool_name " << "tool_sequence " << "date_recorded\n";
+
+        for (const auto & t : tool_id)
+        {
+            int id = t.second;
+            file_tool_info <<
+                #ifdef EPI_DEBUG
+                EPI_GET_THREAD_ID() << " " <<
+                #endif
+                id << " \"" <<
+                tool_name[id] << "\" " <<
+                seq_writer(tool_sequence[id]) << " " <<
+                tool_origin_date[id] << "\n";
+        }
+
+    }
+
+    if (fn_tool_hist != "")
+    {
+        std::ofstream file_tool_hist(fn_tool_hist, std::ios_base::out);
+
+        // Repeat the same error if the file doesn't exists
+        if (!file_tool_hist)
+        {
+            throw std::runtime_error(
+                "Could not open file \"" + fn_tool_hist +
+                "\" for writing.")
+                ;
+        }
+        
+        file_tool_hist <<
+            #ifdef EPI_DEBUG
+            "thread " << 
+            #endif
+            "date " << "id " << "state " << "n\n";
+
+        for (epiworld_fast_uint i = 0; i < hist_tool_id.size(); ++i)
+            file_tool_hist <<
+                #ifdef EPI_DEBUG
+                EPI_GET_THREAD_ID() << " " <<
+                #endif
+                hist_tool_date[i] << " " <<
+                hist_tool_id[i] << " \"" <<
+                model->states_labels[hist_tool_state[i]] << "\" " <<
+                hist_tool_counts[i] << "\n";
+    }
+
+    if (fn_total_hist != "")
+    {
+        std::ofstream file_total(fn_total_hist, std::ios_base::out);
+
+        // Repeat the same error if the file doesn't exists
+        if (!file_total)
+        {
+            throw std::runtime_error(
+                "Could not open file \"" + fn_total_hist +
+                "\" for writing.")
+                ;
+        }
+
+        file_total <<
+            #ifdef EPI_DEBUG
+            "thread " << 
+            #endif
+            "date " << "nviruses " << "state " << "counts\n";
+
+        for (epiworld_fast_uint i = 0; i < hist_total_date.size(); ++i)
+            file_total <<
+                #ifdef EPI_DEBUG
+                EPI_GET_THREAD_ID() << " " <<
+                #endif
+                hist_total_date[i] << " " <<
+                hist_total_nviruses_active[i] << " \"" <<
+                model->states_labels[hist_total_state[i]] << "\" " << 
+                hist_total_counts[i] << "\n";
+    }
+
+    if (fn_transmission != "")
+    {
+        std::ofstream file_transmission(fn_transmission, std::ios_base::out);
+
+        // Repeat the same error if the file doesn't exists
+        if (!file_transmission)
+        {
+            throw std::runtime_error(
+                "Could not open file \"" + fn_transmission +
+                "\" for writing.")
+                ;
+        }
+
+        file_transmission <<
+            #ifdef EPI_DEBUG
+            "thread " << 
+            #endif
+            "date " << "virus_id virus " << "source_exposure_date " << "source " << "target\n";
+
+        for (epiworld_fast_uint i = 0; i < transmission_target.size(); ++i)
+            file_transmission <<
+                #ifdef EPI_DEBUG
+                EPI_GET_THREAD_ID() << " " <<
+                #endif
+                transmission_date[i] << " " <<
+                transmission_virus[i] << " \"" <<
+                virus_name[transmission_virus[i]] << "\" " <<
+                transmission_source_exposure_date[i] << " " <<
+                transmission_source[i] << " " <<
+                transmission_target[i] << "\n";
+                
+    }
+
+    if (fn_transition != "")
+    {
+        std::ofstream file_transition(fn_transition, std::ios_base::out);
+
+        // Repeat the same error if the file doesn't exists
+        if (!file_transition)
+        {
+            throw std::runtime_error(
+                "Could not open file \"" + fn_transition +
+                "\" for writing.")
+                ;
+        }
+
+        file_transition <<
+            #ifdef EPI_DEBUG
+            "thread " << 
+            #endif
+            "date " << "from " << "to " << "counts\n";
+
+        int ns = model->nstates;
+
+        for (int i = 0; i <= model->today(); ++i)
+        {
+
+            for (int from = 0u; from < ns; ++from)
+            {
+                for (int to = 0u; to < ns; ++to)
+                {
+                    // Skipping the zeros
+                    auto counts = hist_transition_matrix[
+                        i * (ns * ns) + to * ns + from
+                    ];
+
+                    if (counts == 0)
+                        continue;
+
+                    file_transition <<
+                        #ifdef EPI_DEBUG
+                        EPI_GET_THREAD_ID() << " " <<
+                        #endif
+                        i << " \"" <<
+                        model->states_labels[from] << "\" \"" <<
+                        model->states_labels[to] << "\" " <<
+                        counts << "\n";
+                }
+            }
+                
+        }
+                
+    }
+
+    if (fn_reproductive_number != "")
+        get_reproductive_number(fn_reproductive_number);
+
+    if (fn_generation_time != "")
+        get_generation_time(fn_generation_time);
+
+    if (fn_active_cases != "")
+    {
+        std::vector< int > date;
+        std::vector< int > virus_id;
+        std::vector< int > count;
+        get_active_cases(date, virus_id, count);
+
+        std::ofstream file_active_cases(fn_active_cases, std::ios_base::out);
+        // Repeat the same error if the file doesn't exists
+        if (!file_active_cases)
+        {
+            throw std::runtime_error(
+                "Could not open file \"" + fn_active_cases +
+                "\" for writing.")
+                ;
+        }
+
+        file_active_cases <<
+            #ifdef EPI_DEBUG
+            "thread " << 
+            #endif
+            "date " << "virus_id virus " << "active_cases\n";
+
+        for (size_t i = 0u; i < date.size(); ++i)
+        {
+            if (count[i] > 0)
+                file_active_cases <<
+                    #ifdef EPI_DEBUG
+                    EPI_GET_THREAD_ID() << " " <<
+                    #endif
+                    date[i] << " " <<
+                    virus_id[i] << " \"" <<
+                    virus_name[virus_id[i]] << "\" " <<
+                    count[i] << "\n";
+        }
+
+    }
+
+    if (fn_outbreak_size != "")
+    {
+        std::vector< int > date;
+        std::vector< int > virus_id;
+        std::vector< int > outbreak_size;
+        get_outbreak_size(date, virus_id, outbreak_size);
+
+        std::ofstream file_outbreak_size(fn_outbreak_size, std::ios_base::out);
+        // Repeat the same error if the file doesn't exists
+        if (!file_outbreak_size)
+        {
+            throw std::runtime_error(
+                "Could not open file \"" + fn_outbreak_size +
+                "\" for writing.")
+                ;
+        }
+
+        file_outbreak_size <<
+            #ifdef EPI_DEBUG
+            "thread " << 
+            #endif
+            "date " << "virus_id virus " << "outbreak_size\n";
+
+        for (size_t i = 0u; i < date.size(); ++i)
+        {
+            if (outbreak_size[i] > 0)
+                file_outbreak_size <<
+                    #ifdef EPI_DEBUG
+                    EPI_GET_THREAD_ID() << " " <<
+                    #endif
+                    date[i] << " " <<
+                    virus_id[i] << " \"" <<
+                    virus_name[virus_id[i]] << "\" " <<
+                    outbreak_size[i] << "\n";
+        }
+
+    }
+
+    if (fn_hospitalizations != "")
+    {
+        std::vector< int > date;
+        std::vector< int > virus_id;
+        std::vector< int > tool_id;
+        std::vector< int > count;
+        std::vector< double > weight;
+        get_hospitalizations(date, virus_id, tool_id, count, weight);
+
+        std::ofstream file_hospitalizations(fn_hospitalizations, std::ios_base::out);
+        // Repeat the same error if the file doesn't exists
+        if (!file_hospitalizations)
+        {
+            throw std::runtime_error(
+                "Could not open file \"" + fn_hospitalizations +
+                "\" for writing.")
+                ;
+        }
+
+        file_hospitalizations <<
+            #ifdef EPI_DEBUG
+            "thread " << 
+            #endif
+            "date " << "virus_id " << "tool_id " << "count " << "weight\n";
+
+        for (size_t i = 0u; i < date.size(); ++i)
+        {
+            // Only write non-zero counts or weights
+            if (count[i] > 0 || weight[i] > 0.0)
+                file_hospitalizations <<
+                    #ifdef EPI_DEBUG
+                    EPI_GET_THREAD_ID() << " " <<
+                    #endif
+                    date[i] << " " <<
+                    virus_id[i] << " " <<
+                    tool_id[i] << " " <<
+                    count[i] << " " <<
+                    weight[i] << "\n";
+        }
+
+    }
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::record_transmission(
+    int i,
+    int j,
+    int virus,
+    int i_expo_date
+) {
+
+    transmission_date.push_back(model->today());
+    transmission_source.push_back(i);
+    transmission_target.push_back(j);
+    transmission_virus.push_back(virus);
+    transmission_source_exposure_date.push_back(i_expo_date);
+
+}
+
+template<typename TSeq>
+inline size_t DataBase<TSeq>::get_n_viruses() const
+{
+    return virus_id.size();
+}
+
+template<typename TSeq>
+inline size_t DataBase<TSeq>::get_n_tools() const
+{
+    return tool_id.size();
+}
+
+
+template<typename TSeq>
+inline void DataBase<TSeq>::set_user_data(
+    std::vector< std::string > names
+)
+{
+    user_data = UserData<TSeq>(names);
+    user_data.model = model;
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::add_user_data(
+    std::vector< epiworld_double > x
+)
+{
+
+    user_data.add(x);
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::add_user_data(
+    epiworld_fast_uint k,
+    epiworld_double x
+)
+{
+
+    user_data.add(k, x);
+
+}
+
+template<typename TSeq>
+inline UserData<TSeq> & DataBase<TSeq>::get_user_data()
+{
+    return user_data;
+}
+
+template<typename TSeq>
+inline MapVec_type<int,int> DataBase<TSeq>::get_reproductive_number()
+const {
+
+    // Checking size
+    MapVec_type<int,int> map;
+
+    // Number of digits of maxid
+    for (size_t i = 0u; i < transmission_date.size(); ++i)
+    {
+        // Fabricating id
+        std::vector< int > h = {
+            transmission_virus[i],
+            transmission_source[i],
+            transmission_source_exposure_date[i]
+        };
+
+        // Adding to counter
+        if (map.find(h) == map.end())
+            map[h] = 1;
+        else
+            map[h]++;
+
+        // The target is added
+        std::vector< int > h_target = {
+            transmission_virus[i],
+            transmission_target[i],
+            transmission_date[i]
+        };
+
+        map[h_target] = 0;
+        
+    }
+
+    return map;
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::get_reproductive_number(
+    std::string fn
+) const {
+
+
+    auto map = get_reproductive_number();
+
+    std::ofstream fn_file(fn, std::ios_base::out);
+
+    // Repeat the same error if the file doesn't exists
+    if (!fn_file)
+    {
+        throw std::runtime_error(
+            "Could not open file \"" + fn +
+            "\" for writing.")
+            ;
+    }
+
+    fn_file << 
+        #ifdef EPI_DEBUG
+        "thread " <<
+        #endif
+        "virus_id virus source source_exposure_date rt\n";
+
+
+    for (auto & m : map)
+        fn_file <<
+            #ifdef EPI_DEBUG
+            EPI_GET_THREAD_ID() << " " <<
+            #endif
+            m.first[0u] << " \"" <<
+            virus_name[m.first[0u]] << "\" " <<
+            m.first[1u] << " " <<
+            m.first[2u] << " " <<
+            m.second << "\n";
+
+    return;
+
+}
+
+template<typename TSeq>
+inline std::vector< epiworld_double > DataBase<TSeq>::get_transition_probability(
+    bool print,
+    bool normalize
+) const {
+
+    const auto& states_labels = model->get_states();
+    size_t n_state = states_labels.size();
+    size_t n_days   = model->get_ndays();
+    std::vector< epiworld_double > res(n_state * n_state, 0.0);
+    std::vector< epiworld_double > rowsums(n_state, 0.0);
+
+    for (size_t t = 0; t < n_days; ++t)
+    {
+
+        for (size_t s_i = 0; s_i < n_state; ++s_i)
+        {
+
+            for (size_t s_j = 0u; s_j < n_state; ++s_j)
+            {
+                res[s_i + s_j * n_state] += (
+                    hist_transition_matrix[
+                        s_i + s_j * n_state +
+                        t * (n_state * n_state)
+                    ]
+                );
+                
+                rowsums[s_i] += hist_transition_matrix[
+                    s_i + s_j * n_state +
+                    t * (n_state * n_state)
+                ];
+            
+            }
+
+        }
+
+    }
+
+    if (normalize)
+    {
+        for (size_t s_i = 0; s_i < n_state; ++s_i)
+        {
+            // Nothing to normalize if the row is zero
+            if (rowsums[s_i] == 0)
+                continue;
+
+            for (size_t s_j = 0; s_j < n_state; ++s_j)
+                res[s_i + s_j * n_state] /= rowsums[s_i];
+        }
+    }
+
+    if (print)
+    {   
+
+        size_t nchar = 0u;
+        for (auto & l : states_labels)
+            if (l.length() > nchar)
+                nchar = l.length();
+
+        std::string fmt = " - %-" + std::to_string(nchar) + "s";
+
+        std::string fmt_entry = " % 4.2f";
+        if (!normalize)
+        {
+            nchar = 0u;
+            for (auto & l: res)
+            {
+                std::string tmp = std::to_string(l);
+                if (tmp.length() > nchar)
+                    nchar = tmp.length();
+            }
+
+            fmt_entry = " % " + std::to_string(nchar) + ".0f";
+        } 
+
+        
+        printf_epiworld("\nTransition Probabilities:\n");
+        for (size_t s_i = 0u; s_i < n_state; ++s_i)
+        {
+            printf_epiworld(fmt.c_str(), states_labels[s_i].c_str());
+            for (size_t s_j = 0u; s_j < n_state; ++s_j)
+            {
+                if (
+                    std::isnan(res[s_i + s_j * n_state]) ||
+                    (res[s_i + s_j * n_state] < 1e-10)
+                )
+                {
+                    printf_epiworld("     -");
+                } else {
+                    printf_epiworld(
+                        fmt_entry.c_str(), res[s_i + s_j * n_state]
+                    );
+                }
+            }
+            printf_epiworld("\n");
+        }
+
+        printf_epiworld("\n");
+
+    }
+
+    return res;
+
+
+} 
+
+#define VECT_MATCH(a, b, c) \
+    EPI_DEBUG_FAIL_AT_TRUE(a.size() != b.size(), c) \
+    for (size_t __i = 0u; __i < a.size(); ++__i) \
+    {\
+        EPI_DEBUG_FAIL_AT_TRUE(a[__i] != b[__i], c) \
+    }
+
+template<>
+inline bool DataBase<std::vector<int>>::operator==(const DataBase<std::vector<int>> & other) const
+{
+    VECT_MATCH(
+        virus_name, other.virus_name,
+        "DataBase:: virus_name don't match"
+        )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        virus_sequence.size() != other.virus_sequence.size(),
+        "DataBase:: virus_sequence don't match."
+        )
+
+    for (size_t i = 0u; i < virus_sequence.size(); ++i)
+    {
+        VECT_MATCH(
+            virus_sequence[i], other.virus_sequence[i],
+            "DataBase:: virus_sequence[i] don't match"
+            )
+    }
+
+    VECT_MATCH(
+        virus_origin_date,
+        other.virus_origin_date,
+        "DataBase:: virus_origin_date[i] don't match"
+    )
+
+    VECT_MATCH(
+        virus_parent_id,
+        other.virus_parent_id,
+        "DataBase:: virus_parent_id[i] don't match"
+    )
+
+    VECT_MATCH(
+        tool_name,
+        other.tool_name,
+        "DataBase:: tool_name[i] don't match"
+    )
+
+    VECT_MATCH(
+        tool_sequence,
+        other.tool_sequence,
+        "DataBase:: tool_sequence[i] don't match"
+    )
+
+    VECT_MATCH(
+        tool_origin_date,
+        other.tool_origin_date,
+        "DataBase:: tool_origin_date[i] don't match"
+    )
+
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        sampling_freq != other.sampling_freq,
+        "DataBase:: sampling_freq don't match."
+        )
+
+    // Variants history
+    VECT_MATCH(
+        hist_virus_date,
+        other.hist_virus_date,
+        "DataBase:: hist_virus_date[i] don't match"
+        )
+
+    VECT_MATCH(
+        hist_virus_id,
+        other.hist_virus_id,
+        "DataBase:: hist_virus_id[i] don't match"
+        )
+
+    VECT_MATCH(
+        hist_virus_state,
+        other.hist_virus_state,
+        "DataBase:: hist_virus_state[i] don't match"
+        )
+
+    VECT_MATCH(
+        hist_virus_counts,
+        other.hist_virus_counts,
+        "DataBase:: hist_virus_counts[i] don't match"
+        )
+
+    // Tools history
+    VECT_MATCH(
+        hist_tool_date,
+        other.hist_tool_date,
+        "DataBase:: hist_tool_date[i] don't match"
+        )
+
+    VECT_MATCH(
+        hist_tool_id,
+        other.hist_tool_id,
+        "DataBase:: hist_tool_id[i] don't match"
+        )
+
+    VECT_MATCH(
+        hist_tool_state,
+        other.hist_tool_state,
+        "DataBase:: hist_tool_state[i] don't match"
+        )
+
+    VECT_MATCH(
+        hist_tool_counts,
+        other.hist_tool_counts,
+        "DataBase:: hist_tool_counts[i] don't match"
+        )
+
+    // Overall hist
+    VECT_MATCH(
+        hist_total_date,
+        other.hist_total_date,
+        "DataBase:: hist_total_date[i] don't match"
+        )
+
+    VECT_MATCH(
+        hist_total_nviruses_active,
+        other.hist_total_nviruses_active,
+        "DataBase:: hist_total_nviruses_active[i] don't match"
+        )
+
+    VECT_MATCH(
+        hist_total_state,
+        other.hist_total_state,
+        "DataBase:: hist_total_state[i] don't match"
+        )
+
+    VECT_MATCH(
+        hist_total_counts,
+        other.hist_total_counts,
+        "DataBase:: hist_total_counts[i] don't match"
+        )
+
+    VECT_MATCH(
+        hist_transition_matrix,
+        other.hist_transition_matrix,
+        "DataBase:: hist_transition_matrix[i] don't match"
+        )
+
+    // {Variant 1: {state 1, state 2, etc.}, Variant 2: {...}, ...}
+    EPI_DEBUG_FAIL_AT_TRUE(
+        today_virus.size() != other.today_virus.size(),
+        "DataBase:: today_virus don't match."
+        )
+    
+    for (size_t i = 0u; i < today_virus.size(); ++i)
+    {
+        VECT_MATCH(
+            today_virus[i], other.today_virus[i],
+            "DataBase:: today_virus[i] don't match"
+            )
+    }
+
+    // {Variant 1: {state 1, state 2, etc.}, Variant 2: {...}, ...}
+    if (today_tool.size() != other.today_tool.size())
+        return false;
+    
+    for (size_t i = 0u; i < today_tool.size(); ++i)
+    {
+        VECT_MATCH(
+            today_tool[i], other.today_tool[i],
+            "DataBase:: today_tool[i] don't match"
+            )
+    }
+
+    // {Susceptible, Infected, etc.}
+    VECT_MATCH(
+        today_total, other.today_total,
+        "DataBase:: today_total don't match"
+        )
+
+    // Totals
+    EPI_DEBUG_FAIL_AT_TRUE(
+        today_total_nviruses_active != other.today_total_nviruses_active,
+        "DataBase:: today_total_nviruses_active don't match."
+        )
+
+    // Transmission network
+    VECT_MATCH(
+        transmission_date,
+        other.transmission_date,                 ///< Date of the transmission eve,
+        "DataBase:: transmission_date[i] don't match"
+        )
+
+    VECT_MATCH(
+        transmission_source,
+        other.transmission_source,               ///< Id of the sour,
+        "DataBase:: transmission_source[i] don't match"
+        )
+
+    VECT_MATCH(
+        transmission_target,
+        other.transmission_target,               ///< Id of the targ,
+        "DataBase:: transmission_target[i] don't match"
+        )
+
+    VECT_MATCH(
+        transmission_virus,
+        other.transmission_virus,              ///< Id of the varia,
+        "DataBase:: transmission_virus[i] don't match"
+        )
+
+    VECT_MATCH(
+        transmission_source_exposure_date,
+        other.transmission_source_exposure_date, ///< Date when the source acquired the varia,
+        "DataBase:: transmission_source_exposure_date[i] don't match"
+        )
+
+
+    VECT_MATCH(
+        transition_matrix,
+        other.transition_matrix,
+        "DataBase:: transition_matrix[i] don't match"
+        )
+
+
+    return true;
+
+}
+
+template<typename TSeq>
+inline bool DataBase<TSeq>::operator==(const DataBase<TSeq> & other) const
+{
+    VECT_MATCH(
+        virus_name,
+        other.virus_name,
+        "DataBase:: virus_name[i] don't match"
+    )
+
+    VECT_MATCH(
+        virus_sequence,
+        other.virus_sequence,
+        "DataBase:: virus_sequence[i] don't match"
+    )
+
+    VECT_MATCH(
+        virus_origin_date,
+        other.virus_origin_date,
+        "DataBase:: virus_origin_date[i] don't match"
+    )
+
+    VECT_MATCH(
+        virus_parent_id,
+        other.virus_parent_id,
+        "DataBase:: virus_parent_id[i] don't match"
+    )
+
+    VECT_MATCH(
+        tool_name,
+        other.tool_name,
+        "DataBase:: tool_name[i] don't match"
+    )
+
+    VECT_MATCH(
+        tool_sequence,
+        other.tool_sequence,
+        "DataBase:: tool_sequence[i] don't match"
+    )
+
+    VECT_MATCH(
+        tool_origin_date,
+        other.tool_origin_date,
+        "DataBase:: tool_origin_date[i] don't match"
+    )
+
+    
+    EPI_DEBUG_FAIL_AT_TRUE(
+        sampling_freq != other.sampling_freq,
+        "DataBase:: sampling_freq don't match."
+    )
+
+    // Variants history
+    VECT_MATCH(
+        hist_virus_date,
+        other.hist_virus_date,
+        "DataBase:: hist_virus_date[i] don't match"
+    )
+
+    VECT_MATCH(
+        hist_virus_id,
+        other.hist_virus_id,
+        "DataBase:: hist_virus_id[i] don't match"
+    )
+
+    VECT_MATCH(
+        hist_virus_state,
+        other.hist_virus_state,
+        "DataBase:: hist_virus_state[i] don't match"
+    )
+
+    VECT_MATCH(
+        hist_virus_counts,
+        other.hist_virus_counts,
+        "DataBase:: hist_virus_counts[i] don't match"
+    )
+
+    // Tools history
+    VECT_MATCH(
+        hist_tool_date,
+        other.hist_tool_date,
+        "DataBase:: hist_tool_date[i] don't match"
+    )
+
+    VECT_MATCH(
+        hist_tool_id,
+        other.hist_tool_id,
+        "DataBase:: hist_tool_id[i] don't match"
+    )
+
+    VECT_MATCH(
+        hist_tool_state,
+        other.hist_tool_state,
+        "DataBase:: hist_tool_state[i] don't match"
+    )
+
+    VECT_MATCH(
+        hist_tool_counts,
+        other.hist_tool_counts,
+        "DataBase:: hist_tool_counts[i] don't match"
+    )
+
+    // Overall hist
+    VECT_MATCH(
+        hist_total_date,
+        other.hist_total_date,
+        "DataBase:: hist_total_date[i] don't match"
+    )
+
+    VECT_MATCH(
+        hist_total_nviruses_active,
+        other.hist_total_nviruses_active,
+        "DataBase:: hist_total_nviruses_active[i] don't match"
+    )
+
+    VECT_MATCH(
+        hist_total_state,
+        other.hist_total_state,
+        "DataBase:: hist_total_state[i] don't match"
+    )
+
+    VECT_MATCH(
+        hist_total_counts,
+        other.hist_total_counts,
+        "DataBase:: hist_total_counts[i] don't match"
+    )
+
+    VECT_MATCH(
+        hist_transition_matrix,
+        other.hist_transition_matrix,
+        "DataBase:: hist_transition_matrix[i] don't match"
+    )
+
+    // {Variant 1: {state 1, state 2, etc.}, Variant 2: {...}, ...}
+    EPI_DEBUG_FAIL_AT_TRUE(
+        today_virus.size() != other.today_virus.size(),
+        "DataBase:: today_virus.size() don't match."
+    )
+    
+    for (size_t i = 0u; i < today_virus.size(); ++i)
+    {
+        VECT_MATCH(
+            today_virus[i], other.today_virus[i],
+            "DataBase:: today_virus[i] don't match"
+            )
+    }
+
+    // {Variant 1: {state 1, state 2, etc.}, Variant 2: {...}, ...}
+    EPI_DEBUG_FAIL_AT_TRUE(
+        today_tool.size() != other.today_tool.size(),
+        "DataBase:: today_tool.size() don't match."
+    )
+    
+    for (size_t i = 0u; i < today_tool.size(); ++i)
+    {
+        VECT_MATCH(
+            today_tool[i], other.today_tool[i],
+            "DataBase:: today_tool[i] don't match"
+            )
+    }
+
+    // {Susceptible, Infected, etc.}
+    VECT_MATCH(
+        today_total, other.today_total,
+        "DataBase:: today_total[i] don't match"
+        )
+
+    // Totals
+    EPI_DEBUG_FAIL_AT_TRUE(
+        today_total_nviruses_active != other.today_total_nviruses_active,
+        "DataBase:: today_total_nviruses_active don't match."
+    )
+
+    // Transmission network
+    VECT_MATCH( ///< Date of the transmission eve
+        transmission_date,
+        other.transmission_date,
+        "DataBase:: transmission_date[i] don't match"
+    )
+
+    VECT_MATCH( ///< Id of the sour
+        transmission_source,
+        other.transmission_source,
+        "DataBase:: transmission_source[i] don't match"
+    )
+
+    VECT_MATCH( ///< Id of the targ
+        transmission_target,
+        other.transmission_target,
+        "DataBase:: transmission_target[i] don't match"
+    )
+
+    VECT_MATCH( ///< Id of the varia
+        transmission_virus,
+        other.transmission_virus,
+        "DataBase:: transmission_virus[i] don't match"
+    )
+
+    VECT_MATCH( ///< Date when the source acquired the varia
+        transmission_source_exposure_date,
+        other.transmission_source_exposure_date,
+        "DataBase:: transmission_source_exposure_date[i] don't match"
+    )
+
+    VECT_MATCH(
+        transition_matrix,
+        other.transition_matrix,
+        "DataBase:: transition_matrix[i] don't match"
+    )
+
+    return true;
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::get_generation_time(
+    std::vector< int > & agent_id,
+    std::vector< int > & virus_id,
+    std::vector< int > & time,
+    std::vector< int > & gentime
+) const {
+    
+    size_t nevents = transmission_date.size();
+
+    agent_id.reserve(nevents);
+    virus_id.reserve(nevents);
+    time.reserve(nevents);
+    gentime.reserve(nevents);
+
+    // Iterating through the individuals
+    for (size_t i = 0u; i < nevents; ++i)
+    {
+        int agent_id_i = transmission_target[i];
+        agent_id.push_back(agent_id_i);
+        virus_id.push_back(transmission_virus[i]);
+        time.push_back(transmission_date[i]);
+
+        bool found = false;
+        for (size_t j = i; j < nevents; ++j)
+        {
+
+            if (transmission_source[j] == agent_id_i)
+            {
+                gentime.push_back(transmission_date[j] - time[i]);
+                found = true;
+                break;
+            }
+
+        }
+
+        // If there's no transmission, we set the generation time to
+        // minus 1;
+        if (!found)
+            gentime.push_back(-1);
+
+    }
+
+    agent_id.shrink_to_fit();
+    virus_id.shrink_to_fit();
+    time.shrink_to_fit();
+    gentime.shrink_to_fit();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::get_generation_time(
+    std::string fn
+) const
+{
+
+    std::vector< int > agent_id;
+    std::vector< int > virus_id;
+    std::vector< int > time;
+    std::vector< int > gentime;
+
+    get_generation_time(agent_id, virus_id, time, gentime);
+
+    std::ofstream fn_file(fn, std::ios_base::out);
+
+    // Throw an error if the file doesn't exists using throw
+    if (!fn_file)
+    {
+        throw std::runtime_error(
+            "DataBase::get_generation_time: "
+            "Cannot open file " + fn + "."
+        );
+    }
+
+
+
+    fn_file << 
+        #ifdef EPI_DEBUG
+        "thread " <<
+        #endif
+        "virus source source_exposure_date gentime\n";
+
+    size_t n = agent_id.size();
+    for (size_t i = 0u; i < n; ++i)
+        fn_file <<
+            #ifdef EPI_DEBUG
+            EPI_GET_THREAD_ID() << " " <<
+            #endif
+            virus_id[i] << " " <<
+            agent_id[i] << " " <<
+            time[i] << " " <<
+            gentime[i] << "\n";
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::record_hospitalization(Agent<TSeq> & agent)
+{
+    m_hospitalizations.record(agent, *model);
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::get_hospitalizations(
+    std::vector<int> & date,
+    std::vector<int> & virus_id,
+    std::vector<int> & tool_id,
+    std::vector<int> & count,
+    std::vector<double> & weight
+) const
+{
+    // Get the number of days from the model and add 1 since days are 0-indexed
+    // today() returns the last day, so we need today() + 1 for the full count
+    int ndays = model->today() + 1;
+    m_hospitalizations.get(ndays, date, virus_id, tool_id, count, weight);
+}
+
+#undef VECT_MATCH
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/database-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/adjlist-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_ADJLIST_BONES_HPP
+#define EPIWORLD_ADJLIST_BONES_HPP
+
+
+/**
+ * @brief Adjacency list representation of a network
+ */
+class AdjList {
+private:
+
+    std::vector<std::map<int, int>> dat;
+    bool directed;
+    epiworld_fast_uint N = 0;
+    epiworld_fast_uint E = 0;
+
+public:
+
+    AdjList() {};
+
+    /**
+     * @brief Construct a new Adj List object
+     * 
+     * @details 
+     * Ids in the network are assume to range from `0` to `size - 1`.
+     * 
+     * @param source Unsigned int vector with the source
+     * @param target Unsigned int vector with the target
+     * @param size Number of vertices in the network.
+     * @param directed Bool true if the network is directed
+     */
+    AdjList(
+        const std::vector< int > & source,
+        const std::vector< int > & target,
+        int size,
+        bool directed
+        );
+
+    AdjList(AdjList && a); // Move constructor
+    AdjList(const AdjList & a); // Copy constructor
+    AdjList& operator=(const AdjList& a);
+
+
+    /**
+     * @brief Read an edgelist
+     * 
+     * Ids in the network are assume to range from `0` to `size - 1`.
+     * 
+     * @param fn Path to the file
+     * @param skip Number of lines to skip (e.g., 1 if there's a header)
+     * @param directed `true` if the network is directed
+     * @param size Number of vertices in the network.
+     */
+    void read_edgelist(
+        std::string fn,
+        int size,
+        int skip = 0,
+        bool directed = true
+        );
+
+    std::map<int, int> operator()(
+        epiworld_fast_uint i
+        ) const;
+        
+    void print(epiworld_fast_uint limit = 20u) const;
+    size_t vcount() const; ///< Number of vertices/nodes in the network.
+    size_t ecount() const; ///< Number of edges/arcs/ties in the network.
+    
+    std::vector<std::map<int,int>> & get_dat() {
+        return dat;
+    };
+
+    bool is_directed() const; ///< `true` if the network is directed.
+
+};
+
+
+#endif
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/adjlist-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/adjlist-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_ADJLIST_MEAT_HPP
+#define EPIWORLD_ADJLIST_MEAT_HPP
+
+#include <vector>
+#include <map>
+#include <string>
+#include <stdexcept>
+#include <fstream>
+// (already included include/epiworld/config.hpp)
+// (already included include/epiworld/adjlist-bones.hpp)
+
+inline AdjList::AdjList(
+    const std::vector< int > & source,
+    const std::vector< int > & target,
+    int size,
+    bool directed
+) : directed(directed) {
+
+
+    dat.resize(size, std::map<int,int>({}));
+    int max_id = size - 1;
+
+    int i,j;
+    for (int m = 0; m < static_cast<int>(source.size()); ++m)
+    {
+
+        i = source[m];
+        j = target[m];
+
+        if (i > max_id)
+            throw std::range_error(
+                "The source["+std::to_string(m)+"] = " + std::to_string(i) +
+                " is above the max_id " + std::to_string(max_id)
+                );
+
+        if (j > max_id)
+            throw std::range_error(
+                "The target["+std::to_string(m)+"] = " + std::to_string(j) +
+                " is above the max_id " + std::to_string(max_id)
+                );
+
+        // Adding nodes
+        if (dat[i].find(j) == dat[i].end())
+            dat[i].insert(std::pair<int, int>(j, 1u));
+        else
+            dat[i][j]++; 
+        
+        if (!directed)
+        {
+
+            if (dat[j].find(i) == dat[j].end())
+                dat[j].insert(std::pair<int, int>(i, 1u));
+            else
+                dat[j][i]++;
+
+        }
+
+        E++;
+
+    }
+
+    N = size;
+
+    return;
+
+}
+
+
+inline AdjList::AdjList(AdjList && a) :
+    dat(std::move(a.dat)),
+    directed(a.directed),
+    N(a.N),
+    E(a.E)
+{
+
+}
+
+inline AdjList::AdjList(const AdjList & a) :
+    dat(a.dat),
+    directed(a.directed),
+    N(a.N),
+    E(a.E)
+{
+
+}
+
+inline AdjList& AdjList::operator=(const AdjList& a)
+{
+    if (this == &a)
+        return *this;
+
+    this->dat = a.dat;
+    this->directed = a.directed;
+    this->N = a.N;
+    this->E = a.E;
+
+    return *this;
+}
+
+inline void AdjList::read_edgelist(
+    std::string fn,
+    int size,
+    int skip,
+    bool directed
+) {
+
+    int i,j;
+    std::ifstream filei(fn);
+
+    if (!filei)
+        throw std::logic_error("The file " + fn + " was not found.");
+
+    int linenum = 0;
+    std::vector< int > source_;
+    std::vector< int > target_;
+
+    source_.reserve(1e5);
+    target_.reserve(1e5);
+
+    int max_id = size - 1;
+
+    while (!filei.eof())
+    {
+
+        if (linenum++ < skip)
+            continue;
+
+        filei >> i >> j;
+
+        // Looking for exceptions
+        if (filei.bad())
+            throw std::logic_error(
+                "I/O error while reading the file " +
+                fn
+            );
+
+        if (filei.fail())
+            break;
+
+        if (i > max_id)
+            throw std::range_error(
+                "The source["+std::to_string(linenum)+"] = " + std::to_string(i) +
+                " is above the max_id " + std::to_string(max_id)
+                );
+
+        if (j > max_id)
+            throw std::range_error(
+                "The target["+std::to_string(linenum)+"] = " + std::to_string(j) +
+                " is above the max_id " + std::to_string(max_id)
+                );
+
+        source_.push_back(i);
+        target_.push_back(j);
+
+    }
+
+    // Now using the right constructor
+    *this = AdjList(source_, target_, size, directed);
+
+    return;
+
+}
+
+inline std::map<int,int> AdjList::operator()(
+    epiworld_fast_uint i
+    ) const {
+
+    if (i >= N)
+        throw std::range_error(
+            "The vertex id " + std::to_string(i) + " is not in the network."
+            );
+
+    return dat[i];
+
+}
+
+inline void AdjList::print(epiworld_fast_uint limit) const {
+
+
+    epiworld_fast_uint counter = 0;
+    printf_epiworld("Nodeset:\n");
+    int i = -1;
+    for (auto & n : dat)
+    {
+
+        if (counter++ > limit)
+            break;
+
+        printf_epiworld("  % 3i: {", ++i);
+        int niter = 0;
+        for (auto n_n : n)
+            if (++niter < static_cast<int>(n.size()))
+            {    
+                printf_epiworld("%i, ", static_cast<int>(n_n.first));
+            }
+            else {
+                printf_epiworld("%i}\n", static_cast<int>(n_n.first));
+            }
+    }
+
+    if (limit < dat.size())
+    {
+        printf_epiworld(
+            "  (... skipping %i records ...)\n",
+            static_cast<int>(dat.size() - limit)
+            );
+    }
+
+}
+
+inline size_t AdjList::vcount() const 
+{
+    return N;
+}
+
+inline size_t AdjList::ecount() const 
+{
+    return E;
+}
+
+inline bool AdjList::is_directed() const {
+
+    if (dat.size() == 0u)
+        throw std::logic_error("The edgelist is empty.");
+    
+    return directed;
+    
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/adjlist-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/network-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_NETWORK_BONES_HPP
+#define EPIWORLD_NETWORK_BONES_HPP
+
+#include <vector>
+#include <map>
+#include <limits>
+#include <stdexcept>
+// (already included include/epiworld/config.hpp)
+
+class AdjList;
+
+/**
+ * @brief Contact network stored in compressed sparse row (CSR) format
+ * @details
+ * The ties of agent `i` are stored in the half-open range
+ * `[offsets[i], offsets[i + 1])` of two flat arrays: `ids`, with the
+ * ids of the neighbors, and `locations`, with the position of the reverse
+ * tie within the neighbor's row. Storing the network this way avoids one
+ * heap allocation per agent, keeps neighbors contiguous in memory, and
+ * makes copying the population (e.g., in `Model<TSeq>::reset()` or when
+ * cloning the model in `Model<TSeq>::run_multiple()`) a handful of
+ * `memcpy`s.
+ *
+ * The network is owned by `Model<TSeq>`; agents only keep their degree.
+ * Ids and locations are stored as `epiworld_agent_index` (see
+ * `config.hpp`), so the number of vertices is bounded by that type.
+ */
+class Network
+{
+    template<typename TSeq> friend class Model;
+
+private:
+
+    std::vector< size_t > offsets = {0u};              ///< Row offsets (size `n + 1`).
+    std::vector< epiworld_agent_index > ids;           ///< Neighbor ids.
+    std::vector< epiworld_agent_index > locations;     ///< Location of the reverse tie in the neighbor's row.
+
+public:
+
+    Network() = default;
+
+    /**
+     * @brief Construct an empty network
+     * @param n Number of vertices (agents).
+     */
+    Network(size_t n);
+
+    /**
+     * @brief Removes all ties and resizes the network to `n` vertices
+     * @param n Number of vertices (agents).
+     * @throws std::range_error if `n` does not fit in `epiworld_agent_index`.
+     */
+    void reset(size_t n);
+
+    /**
+     * @brief Builds the network from an adjacency list
+     * @details
+     * The ties are added in the same order in which `Agent<TSeq>::add_neighbor()`
+     * adds them (both directions, skipping duplicates), so the resulting
+     * neighbor ordering is the same as adding the ties one at a time.
+     * @param al Adjacency list.
+     */
+    void build(AdjList & al);
+
+    /**
+     * @brief Adds the tie `i -> j` (and its reverse `j -> i`)
+     * @details
+     * Since the storage is contiguous, this is an `O(E)` operation. To
+     * build large networks, use `build()` instead.
+     * @param i, j Vertex ids.
+     * @param check_source If `true`, skips adding `j` to `i` if already present.
+     * @param check_target If `true`, skips adding `i` to `j` if already present.
+     */
+    void add_edge(
+        size_t i,
+        size_t j,
+        bool check_source = true,
+        bool check_target = true
+        );
+
+    size_t vcount() const noexcept; ///< Number of vertices.
+    size_t ecount() const noexcept; ///< Number of stored ties (both directions).
+    size_t degree(size_t i) const;  ///< Number of neighbors of vertex `i`.
+
+    /**
+     * @name Row access
+     * @details Pointers to the first element of the row of vertex `i`. The
+     * row has `degree(i)` elements.
+     */
+    ///@{
+    epiworld_agent_index * neighbors(size_t i);
+    const epiworld_agent_index * neighbors(size_t i) const;
+    epiworld_agent_index * neighbors_locations(size_t i);
+    const epiworld_agent_index * neighbors_locations(size_t i) const;
+    ///@}
+
+    bool operator==(const Network & other) const;
+    bool operator!=(const Network & other) const {return !operator==(other);};
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/network-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/network-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_NETWORK_MEAT_HPP
+#define EPIWORLD_NETWORK_MEAT_HPP
+
+// (already included include/epiworld/network-bones.hpp)
+// (already included include/epiworld/adjlist-bones.hpp)
+
+inline Network::Network(size_t n)
+{
+    reset(n);
+}
+
+inline void Network::reset(size_t n)
+{
+
+    if (n > static_cast< size_t >(
+        std::numeric_limits< epiworld_agent_index >::max()
+    ))
+        throw std::range_error(
+            "The network cannot have " + std::to_string(n) +
+            " vertices, as ids are stored as `epiworld_agent_index` (" +
+            std::to_string(sizeof(epiworld_agent_index) * 8u) + " bits)."
+        );
+
+    offsets.assign(n + 1, 0u);
+    ids.clear();
+    locations.clear();
+
+}
+
+inline void Network::build(AdjList & al)
+{
+
+    const auto & dat = al.get_dat();
+    size_t n = al.vcount();
+
+    // Ties are staged by row first, since adding a tie can append to
+    // any row (the reverse tie).
+    std::vector< std::vector< epiworld_agent_index > > rows_ids(n);
+    std::vector< std::vector< epiworld_agent_index > > rows_locs(n);
+
+    auto find = [&rows_ids](size_t row, size_t what) -> bool {
+        for (auto k : rows_ids[row])
+            if (k == what)
+                return true;
+        return false;
+    };
+
+    for (size_t i = 0u; i < dat.size(); ++i)
+    {
+
+        for (const auto & link : dat[i])
+        {
+
+            size_t j = static_cast< size_t >(link.first);
+
+            if (!find(i, j))
+            {
+                rows_locs[i].push_back(
+                    static_cast< epiworld_agent_index >(rows_ids[j].size())
+                );
+                rows_ids[i].push_back(static_cast< epiworld_agent_index >(j));
+            }
+
+            if (!find(j, i))
+            {
+                rows_locs[j].push_back(
+                    static_cast< epiworld_agent_index >(rows_ids[i].size() - 1)
+                );
+                rows_ids[j].push_back(static_cast< epiworld_agent_index >(i));
+            }
+
+        }
+
+    }
+
+    // Flattening
+    offsets.assign(n + 1, 0u);
+    for (size_t i = 0u; i < n; ++i)
+        offsets[i + 1] = offsets[i] + rows_ids[i].size();
+
+    ids.resize(offsets[n]);
+    locations.resize(offsets[n]);
+    for (size_t i = 0u; i < n; ++i)
+    {
+        std::copy(rows_ids[i].begin(), rows_ids[i].end(), ids.begin() + offsets[i]);
+        std::copy(rows_locs[i].begin(), rows_locs[i].end(), locations.begin() + offsets[i]);
+    }
+
+}
+
+inline void Network::add_edge(
+    size_t i,
+    size_t j,
+    bool check_source,
+    bool check_target
+)
+{
+
+    if (std::max(i, j) >= vcount())
+        throw std::range_error(
+            "The vertex is out of range. The network only has " +
+            std::to_string(vcount()) + " vertices."
+        );
+
+    auto insert = [this](size_t row, size_t id, size_t loc) -> void {
+
+        size_t pos = offsets[row + 1];
+        ids.insert(
+            ids.begin() + pos, static_cast< epiworld_agent_index >(id)
+        );
+        locations.insert(
+            locations.begin() + pos, static_cast< epiworld_agent_index >(loc)
+        );
+
+        for (size_t k = row + 1; k < offsets.size(); ++k)
+            ++offsets[k];
+
+    };
+
+    auto find = [this](size_t row, size_t what) -> bool {
+        for (size_t k = offsets[row]; k < offsets[row + 1]; ++k)
+            if (ids[k] == what)
+                return true;
+        return false;
+    };
+
+    // Three things going on here:
+    // - Where in the neighbor will this be
+    // - What is the neighbor's id
+    // - Increasing the number of neighbors
+    if (!check_source || !find(i, j))
+        insert(i, j, degree(j));
+
+    if (!check_target || !find(j, i))
+        insert(j, i, degree(i) - 1);
+
+}
+
+inline size_t Network::vcount() const noexcept
+{
+    return offsets.size() - 1u;
+}
+
+inline size_t Network::ecount() const noexcept
+{
+    return ids.size();
+}
+
+inline size_t Network::degree(size_t i) const
+{
+    return offsets[i + 1] - offsets[i];
+}
+
+inline epiworld_agent_index * Network::neighbors(size_t i)
+{
+    return ids.data() + offsets[i];
+}
+
+inline const epiworld_agent_index * Network::neighbors(size_t i) const
+{
+    return ids.data() + offsets[i];
+}
+
+inline epiworld_agent_index * Network::neighbors_locations(size_t i)
+{
+    return locations.data() + offsets[i];
+}
+
+inline const epiworld_agent_index * Network::neighbors_locations(size_t i) const
+{
+    return locations.data() + offsets[i];
+}
+
+inline bool Network::operator==(const Network & other) const
+{
+
+    if (offsets != other.offsets)
+        return false;
+
+    return ids == other.ids;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/network-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/indexedheap-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_INDEXEDHEAP_BONES_HPP
+#define EPIWORLD_INDEXEDHEAP_BONES_HPP
+
+#include <vector>
+#include <limits>
+// (already included include/epiworld/config.hpp)
+
+/**
+ * @brief Binary min-heap over a fixed set of items with updatable keys
+ * @details
+ * Items are identified by their index in `[0, n)`. The heap keeps the
+ * position of each item (`pos`), so changing the key of an item is
+ * `O(log n)` and the minimum is available in `O(1)`. Used by the
+ * next-reaction engine (`Model<TSeq>::run_continuous()`) to keep the time
+ * of the next event of each agent. Items without a scheduled event carry
+ * an infinite key.
+ */
+class IndexedMinHeap
+{
+private:
+
+    std::vector< epiworld_double > keys; ///< Key of each item.
+    std::vector< size_t > heap;          ///< Items in heap order.
+    std::vector< size_t > pos;           ///< Position of each item in `heap`.
+
+    void swap_at(size_t a, size_t b);
+    void sift_up(size_t i);
+    void sift_down(size_t i);
+
+public:
+
+    IndexedMinHeap() = default;
+
+    /**
+     * @brief Resets the heap to `n` items, all with infinite keys
+     * @param n Number of items.
+     */
+    void reset(size_t n);
+
+    /**
+     * @brief Sets the key of item `i` and restores the heap order
+     * @param i Item index.
+     * @param key New key.
+     */
+    void update(size_t i, epiworld_double key);
+
+    size_t top() const;                    ///< Item with the smallest key.
+    epiworld_double top_key() const;       ///< Smallest key.
+    epiworld_double key(size_t i) const;   ///< Key of item `i`.
+    size_t size() const noexcept;          ///< Number of items.
+
+};
+
+inline void IndexedMinHeap::swap_at(size_t a, size_t b)
+{
+    std::swap(heap[a], heap[b]);
+    pos[heap[a]] = a;
+    pos[heap[b]] = b;
+}
+
+inline void IndexedMinHeap::sift_up(size_t i)
+{
+
+    while (i > 0u)
+    {
+        size_t parent = (i - 1u) / 2u;
+        if (keys[heap[parent]] <= keys[heap[i]])
+            break;
+
+        swap_at(i, parent);
+        i = parent;
+    }
+
+}
+
+inline void IndexedMinHeap::sift_down(size_t i)
+{
+
+    size_t n = heap.size();
+    while (true)
+    {
+        size_t smallest = i;
+        size_t left     = 2u * i + 1u;
+        size_t right    = left + 1u;
+
+        if ((left < n) && (keys[heap[left]] < keys[heap[smallest]]))
+            smallest = left;
+
+        if ((right < n) && (keys[heap[right]] < keys[heap[smallest]]))
+            smallest = right;
+
+        if (smallest == i)
+            break;
+
+        swap_at(i, smallest);
+        i = smallest;
+    }
+
+}
+
+inline void IndexedMinHeap::reset(size_t n)
+{
+
+    keys.assign(n, std::numeric_limits< epiworld_double >::infinity());
+    heap.resize(n);
+    pos.resize(n);
+
+    for (size_t i = 0u; i < n; ++i)
+    {
+        heap[i] = i;
+        pos[i]  = i;
+    }
+
+}
+
+inline void IndexedMinHeap::update(size_t i, epiworld_double key)
+{
+
+    epiworld_double old = keys[i];
+    keys[i] = key;
+
+    if (key < old)
+        sift_up(pos[i]);
+    else if (key > old)
+        sift_down(pos[i]);
+
+}
+
+inline size_t IndexedMinHeap::top() const
+{
+    if (heap.empty())
+        throw std::logic_error("The heap is empty.");
+
+    return heap[0u];
+}
+
+inline epiworld_double IndexedMinHeap::top_key() const
+{
+    if (heap.empty())
+        return std::numeric_limits< epiworld_double >::infinity();
+
+    return keys[heap[0u]];
+}
+
+inline epiworld_double IndexedMinHeap::key(size_t i) const
+{
+    return keys[i];
+}
+
+inline size_t IndexedMinHeap::size() const noexcept
+{
+    return heap.size();
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/indexedheap-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/profiler-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_PROFILER_BONES_HPP
+#define EPIWORLD_PROFILER_BONES_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+// (already included include/epiworld/config.hpp)
+
+/**
+ * @brief Time per phase and counters of a simulation
+ * @details
+ * `Model<TSeq>` keeps one for the last run and one for all its runs (see
+ * `Model<TSeq>::get_profile()`). Phases are timed exclusively: the time
+ * spent in a nested phase (e.g., `events_run()` called from the global
+ * events) is only counted in the nested phase.
+ *
+ * The instrumentation is only compiled when `EPI_PROFILE` is defined;
+ * otherwise the `EPI_PROFILE_*` macros expand to nothing and all the
+ * times and counters stay at zero.
+ */
+class Profiler
+{
+public:
+
+    enum Phase : size_t {
+        UpdateState,  ///< Update functions of the agents.
+        EventsRun,    ///< Applying the events (`Model::events_run()`).
+        GlobalEvents, ///< Global events (without the events they add).
+        Rewire,       ///< Rewiring the network.
+        Record,       ///< Recording the day (`DataBase::record()`).
+        MutateVirus,  ///< Mutating the viruses.
+        NPhases
+    };
+
+    enum Counter : size_t {
+        AgentsVisited, ///< Agents whose state was checked for an update.
+        StateFunCalls, ///< Calls to update functions.
+        RngDraws,      ///< Random variates drawn from the model.
+        NCounters
+    };
+
+    static constexpr size_t NEventActions =
+        static_cast< size_t >(EventAction::ChangeState) + 1u;
+
+private:
+
+    std::array< epiworld_double, NPhases > times = {};   ///< Microseconds.
+    std::array< uint64_t, NCounters > counters = {};
+    std::array< uint64_t, NEventActions > events = {};   ///< By `EventAction`.
+
+    // Stack of open phases (for exclusive timing)
+    std::array< size_t, 8u > stack = {};
+    size_t depth = 0u;
+    std::chrono::time_point< std::chrono::steady_clock > tic;
+
+    void stop_current(std::chrono::time_point< std::chrono::steady_clock > now);
+
+public:
+
+    Profiler() = default;
+
+    void reset(); ///< Sets all times and counters to zero.
+
+    /**
+     * @name Timing
+     * @details `enter()` pauses the current phase (if any) and starts
+     * `phase`; `leave()` stops it and resumes the previous one. `Scope`
+     * does both (RAII).
+     */
+    ///@{
+    void enter(Phase phase);
+    void leave();
+
+    class Scope {
+    private:
+        Profiler & profiler;
+    public:
+        Scope(Profiler & p, Phase phase) : profiler(p) { profiler.enter(phase); };
+        ~Scope() { profiler.leave(); };
+    };
+    ///@}
+
+    /**
+     * @brief Adds to a counter
+     * @details Thread-safe (atomic), since variates can be drawn within
+     * the parallel update.
+     */
+    void add(Counter counter, uint64_t n = 1u);
+    void add_event(EventAction action);
+
+    Profiler & operator+=(const Profiler & other); ///< Aggregates (e.g., replicates).
+
+    epiworld_double get_time(Phase phase) const; ///< Microseconds.
+    uint64_t get_count(Counter counter) const;
+    uint64_t get_events(EventAction action) const;
+
+    static const char * phase_name(Phase phase);
+    static const char * counter_name(Counter counter);
+    static const char * event_name(EventAction action);
+
+    void print() const;
+
+};
+
+#ifdef EPI_PROFILE
+    #define EPI_PROFILE_SCOPE(profiler, phase) \
+        Profiler::Scope epi_profile_scope_((profiler), Profiler::phase);
+    #define EPI_PROFILE_ADD(profiler, counter, n) \
+        (profiler).add(Profiler::counter, (n));
+    #define EPI_PROFILE_EVENT(profiler, action) \
+        (profiler).add_event(action);
+#else
+    #define EPI_PROFILE_SCOPE(profiler, phase)
+    #define EPI_PROFILE_ADD(profiler, counter, n)
+    #define EPI_PROFILE_EVENT(profiler, action)
+#endif
+
+inline void Profiler::reset()
+{
+    times.fill(0.0);
+    counters.fill(0u);
+    events.fill(0u);
+    depth = 0u;
+}
+
+inline void Profiler::stop_current(
+    std::chrono::time_point< std::chrono::steady_clock > now
+)
+{
+
+    // Phases nested deeper than the stack are not timed
+    if ((depth == 0u) || (depth > stack.size()))
+        return;
+
+    times[stack[depth - 1u]] +=
+        std::chrono::duration< epiworld_double, std::micro >(now - tic).count();
+
+}
+
+inline void Profiler::enter(Phase phase)
+{
+
+    auto now = std::chrono::steady_clock::now();
+    stop_current(now);
+
+    if (depth < stack.size())
+        stack[depth] = phase;
+
+    ++depth;
+    tic = now;
+
+}
+
+inline void Profiler::leave()
+{
+
+    auto now = std::chrono::steady_clock::now();
+
+    stop_current(now);
+
+    if (depth > 0u)
+        --depth;
+
+    tic = now;
+
+}
+
+inline void Profiler::add(Counter counter, uint64_t n)
+{
+    #pragma omp atomic
+    counters[counter] += n;
+}
+
+inline void Profiler::add_event(EventAction action)
+{
+    events[static_cast< size_t >(action)]++;
+}
+
+inline Profiler & Profiler::operator+=(const Profiler & other)
+{
+
+    for (size_t i = 0u; i < NPhases; ++i)
+        times[i] += other.times[i];
+
+    for (size_t i = 0u; i < NCounters; ++i)
+        counters[i] += other.counters[i];
+
+    for (size_t i = 0u; i < NEventActions; ++i)
+        events[i] += other.events[i];
+
+    return *this;
+
+}
+
+inline epiworld_double Profiler::get_time(Phase phase) const
+{
+    return times.at(phase);
+}
+
+inline uint64_t Profiler::get_count(Counter counter) const
+{
+    return counters.at(counter);
+}
+
+inline uint64_t Profiler::get_events(EventAction action) const
+{
+    return events.at(static_cast< size_t >(action));
+}
+
+inline const char * Profiler::phase_name(Phase phase)
+{
+
+    static const char * names[NPhases] = {
+        "update_state", "events_run", "run_globalevents", "rewire",
+        "record", "mutate_virus"
+    };
+
+    return names[phase];
+
+}
+
+inline const char * Profiler::counter_name(Counter counter)
+{
+
+    static const char * names[NCounters] = {
+        "agents visited", "state_fun calls", "random draws"
+    };
+
+    return names[counter];
+
+}
+
+inline const char * Profiler::event_name(EventAction action)
+{
+
+    static const char * names[NEventActions] = {
+        "add virus", "add tool", "add entity", "remove virus",
+        "remove tool", "remove entity", "change state"
+    };
+
+    return names[static_cast< size_t >(action)];
+
+}
+
+inline void Profiler::print() const
+{
+
+    printf_epiworld("Time per phase (ms):\n");
+    for (size_t i = 0u; i < NPhases; ++i)
+    {
+        printf_epiworld(
+            "  %-20s: %.3f\n",
+            phase_name(static_cast< Phase >(i)), times[i] / 1000.0
+        );
+    }
+
+    printf_epiworld("Counters:\n");
+    for (size_t i = 0u; i < NCounters; ++i)
+    {
+        printf_epiworld(
+            "  %-20s: %llu\n",
+            counter_name(static_cast< Counter >(i)),
+            static_cast< unsigned long long >(counters[i])
+        );
+    }
+
+    printf_epiworld("Events:\n");
+    for (size_t i = 0u; i < NEventActions; ++i)
+    {
+        printf_epiworld(
+            "  %-20s: %llu\n",
+            event_name(static_cast< EventAction >(i)),
+            static_cast< unsigned long long >(events[i])
+        );
+    }
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/profiler-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/memoryusage-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MEMORYUSAGE_BONES_HPP
+#define EPIWORLD_MEMORYUSAGE_BONES_HPP
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unordered_map>
+// (already included include/epiworld/config.hpp)
+
+/**
+ * @brief Memory used by a model, in bytes, by component
+ * @details
+ * Returned by `Model<TSeq>::memory_usage()` (measured) and
+ * `Model<TSeq>::estimate_memory_usage()` (predicted). Containers are
+ * counted by their capacity. Objects are counted by their own size, so
+ * heap memory owned by their members (strings, `std::function`s, user
+ * data) is not included; the figures are a lower bound of what the
+ * allocator sees.
+ */
+class MemoryUsage
+{
+public:
+
+    /**
+     * @name Agents
+     */
+    ///@{
+    size_t agents          = 0u; ///< `Agent` objects and their states.
+    size_t agents_entities = 0u; ///< Entity ids of each agent.
+    size_t agents_viruses  = 0u; ///< Viruses held by agents (one copy each).
+    size_t agents_tools    = 0u; ///< Tools held by agents (one copy each).
+    ///@}
+
+    size_t network         = 0u; ///< Neighbors (CSR arrays of `Network`).
+    size_t network_backup  = 0u; ///< Only when not shared with `network`.
+    size_t entities        = 0u; ///< `Entity` objects and their agent ids.
+    size_t queue           = 0u; ///< `Queue::active` and the active list.
+    size_t contact_tracing = 0u;
+    size_t events          = 0u; ///< Event buffers (including per thread).
+    size_t sampling        = 0u; ///< Scratch space of `AgentsSample`.
+
+    /**
+     * @name Database
+     */
+    ///@{
+    size_t db_registry         = 0u; ///< Virus/tool ids, names, sequences.
+    size_t db_today            = 0u; ///< Today's counts.
+    size_t db_hist_virus       = 0u; ///< `hist_virus_*`.
+    size_t db_hist_tool        = 0u; ///< `hist_tool_*`.
+    size_t db_hist_total       = 0u; ///< `hist_total_*`.
+    size_t db_hist_transition  = 0u; ///< `hist_transition_matrix`.
+    size_t db_transition       = 0u; ///< Today's transition matrix.
+    size_t db_transmission     = 0u; ///< `transmission_*`.
+    size_t db_user_data        = 0u;
+    size_t db_hospitalizations = 0u;
+    ///@}
+
+    /**
+     * @brief Additional memory of the thread clones of `run_multiple()`
+     * @details Each clone copies the model except for the network, which
+     * is shared until modified.
+     */
+    size_t thread_clones = 0u;
+
+    size_t database() const; ///< Sum of the `db_*` components.
+    size_t total() const;    ///< Sum of all the components.
+
+    void print() const;
+
+    /**
+     * @name Bytes used by a container
+     */
+    ///@{
+    template<typename T>
+    static size_t bytes(const std::vector< T > & x);
+    static size_t bytes(const std::vector< bool > & x);
+    template<typename Tk, typename Tv, typename Th>
+    static size_t bytes(const std::unordered_map< Tk, Tv, Th > & x);
+    ///@}
+
+};
+
+template<typename T>
+inline size_t MemoryUsage::bytes(const std::vector< T > & x)
+{
+    return x.capacity() * sizeof(T);
+}
+
+inline size_t MemoryUsage::bytes(const std::vector< bool > & x)
+{
+    return (x.capacity() + 7u) / 8u;
+}
+
+template<typename Tk, typename Tv, typename Th>
+inline size_t MemoryUsage::bytes(const std::unordered_map< Tk, Tv, Th > & x)
+{
+
+    // Each entry is a node (value and pointer to the next one)
+    size_t res = x.bucket_count() * sizeof(void *) +
+        x.size() * (sizeof(std::pair< const Tk, Tv >) + sizeof(void *));
+
+    if constexpr (std::is_same_v< Tk, std::vector< int > >)
+        for (const auto & p : x)
+            res += bytes(p.first);
+
+    return res;
+
+}
+
+inline size_t MemoryUsage::database() const
+{
+    return db_registry + db_today + db_hist_virus + db_hist_tool +
+        db_hist_total + db_hist_transition + db_transition +
+        db_transmission + db_user_data + db_hospitalizations;
+}
+
+inline size_t MemoryUsage::total() const
+{
+    return agents + agents_entities + agents_viruses + agents_tools +
+        network + network_backup + entities + queue + contact_tracing +
+        events + sampling + database() + thread_clones;
+}
+
+inline void MemoryUsage::print() const
+{
+
+    auto print_line = [](const char * name, size_t x) -> void {
+
+        double value = static_cast< double >(x);
+        const char * unit = "B ";
+        if (value >= 1073741824.0)
+        {
+            value /= 1073741824.0;
+            unit = "GB";
+        }
+        else if (value >= 1048576.0)
+        {
+            value /= 1048576.0;
+            unit = "MB";
+        }
+        else if (value >= 1024.0)
+        {
+            value /= 1024.0;
+            unit = "KB";
+        }
+
+        printf_epiworld(" - %-24s: %10.2f %s\n", name, value, unit);
+
+    };
+
+    printf_epiworld("Memory usage\n");
+    print_line("Agents", agents);
+    print_line("Agents' entities", agents_entities);
+    print_line("Agents' viruses", agents_viruses);
+    print_line("Agents' tools", agents_tools);
+    print_line("Network", network);
+    print_line("Network (backup)", network_backup);
+    print_line("Entities", entities);
+    print_line("Queue", queue);
+    print_line("Contact tracing", contact_tracing);
+    print_line("Events", events);
+    print_line("Sampling", sampling);
+    print_line("Database", database());
+    print_line("  registry", db_registry);
+    print_line("  today", db_today);
+    print_line("  hist virus", db_hist_virus);
+    print_line("  hist tool", db_hist_tool);
+    print_line("  hist total", db_hist_total);
+    print_line("  hist transition", db_hist_transition);
+    print_line("  transition", db_transition);
+    print_line("  transmission", db_transmission);
+    print_line("  user data", db_user_data);
+    print_line("  hospitalizations", db_hospitalizations);
+    print_line("Thread clones", thread_clones);
+    print_line("Total", total());
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/memoryusage-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/agentneighbors-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_AGENTNEIGHBORS_BONES_HPP
+#define EPIWORLD_AGENTNEIGHBORS_BONES_HPP
+
+template<typename TSeq>
+class Agent;
+
+/**
+ * @brief Non-owning view over the neighbors of an agent
+ *
+ * @details Iterates over the agent's row of the `Network` and yields
+ * references to the agents in the model's population, without allocating.
+ * The view is invalidated by any change to the network (e.g., adding ties or
+ * rewiring) or to the population. Returned by `Agent::neighbors()`.
+ *
+ * @tparam TSeq
+ */
+template<typename TSeq>
+class AgentNeighbors {
+private:
+    Agent<TSeq> * population;
+    const epiworld_agent_index * ids;
+    size_t n;
+
+public:
+
+    class iterator {
+    private:
+        Agent<TSeq> * population;
+        const epiworld_agent_index * ptr;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Agent<TSeq>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = Agent<TSeq> *;
+        using reference         = Agent<TSeq> &;
+
+        iterator(Agent<TSeq> * population_, const epiworld_agent_index * ptr_) :
+            population(population_), ptr(ptr_) {};
+
+        reference operator*() const { return population[*ptr]; };
+        pointer operator->() const { return &population[*ptr]; };
+
+        iterator & operator++() { ++ptr; return *this; };
+        iterator operator++(int) { iterator tmp = *this; ++ptr; return tmp; };
+
+        bool operator==(const iterator & other) const { return ptr == other.ptr; };
+        bool operator!=(const iterator & other) const { return ptr != other.ptr; };
+    };
+
+    AgentNeighbors(
+        Agent<TSeq> * population_,
+        const epiworld_agent_index * ids_,
+        size_t n_
+    ) : population(population_), ids(ids_), n(n_) {};
+
+    iterator begin() const { return iterator(population, ids); };
+    iterator end() const { return iterator(population, ids + n); };
+
+    size_t size() const noexcept { return n; };
+    bool empty() const noexcept { return n == 0u; };
+
+    Agent<TSeq> & operator[](size_t i) const { return population[ids[i]]; };
+    size_t id(size_t i) const { return ids[i]; }; ///< Id of the i-th neighbor.
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/agentneighbors-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/randgraph.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_RANDGRA
+#define EPIWORLD_RANDGRA
+
+template<typename TSeq>
+class Model;
+
+template<typename TSeq>
+class Agent;
+
+class AdjList;
+
+
+template<typename TSeq, typename TDat>
+inline void rewire_degseq(
+    TDat * agents,
+    Model<TSeq> * model,
+    epiworld_double proportion
+    );
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline void rewire_degseq(
+    std::vector< Agent<TSeq> > * agents,
+    Model<TSeq> * model,
+    epiworld_double proportion
+    )
+{
+
+    #ifdef EPI_DEBUG
+    std::vector< int > _degree0(agents->size(), 0);
+    for (size_t i = 0u; i < _degree0.size(); ++i)
+        _degree0[i] = model->get_agents()[i].get_n_neighbors();
+    #endif
+
+    // Identifying individuals with degree > 0
+    std::vector< epiworld_fast_uint > non_isolates;
+    std::vector< epiworld_double > weights;
+    epiworld_double nedges = 0.0;
+
+    for (epiworld_fast_uint i = 0u; i < agents->size(); ++i)
+    {
+        if (agents->operator[](i).get_n_neighbors() > 0u)
+        {
+            non_isolates.push_back(i);
+            epiworld_double wtemp = static_cast<epiworld_double>(
+                agents->operator[](i).get_n_neighbors()
+                );
+            weights.push_back(wtemp);
+            nedges += wtemp;
+        }
+    }
+
+    if (non_isolates.size() == 0u)
+        throw std::logic_error("The graph is completely disconnected.");
+
+    // Cumulative probs
+    weights[0u] /= nedges;
+    for (epiworld_fast_uint i = 1u; i < non_isolates.size(); ++i)
+    {
+         weights[i] /= nedges;
+         weights[i] += weights[i - 1u];
+    }
+
+    // Only swap if needed
+    epiworld_fast_uint N = non_isolates.size();
+    epiworld_double prob;
+    int nrewires = floor(proportion * nedges);
+    while (nrewires-- > 0)
+    {
+
+        // Picking egos
+        prob = model->runif();
+        int id0 = N - 1;
+        for (epiworld_fast_uint i = 0u; i < N; ++i)
+            if (prob <= weights[i])
+            {
+                id0 = i;
+                break;
+            }
+
+        prob = model->runif();
+        int id1 = N - 1;
+        for (epiworld_fast_uint i = 0u; i < N; ++i)
+            if (prob <= weights[i])
+            {
+                id1 = i;
+                break;
+            }
+
+        // Correcting for under or overflow.
+        if (id1 == id0)
+            id1++;
+
+        if (id1 >= static_cast<int>(N))
+            id1 = 0;
+
+        Agent<TSeq> & p0 = agents->operator[](non_isolates[id0]);
+        Agent<TSeq> & p1 = agents->operator[](non_isolates[id1]);
+
+        // Picking alters (relative location in their lists)
+        // In this case, these are uniformly distributed within the list
+        int id01 = model->runif_index(p0.get_n_neighbors());
+        int id11 = model->runif_index(p1.get_n_neighbors());
+
+        // Get the actual neighbor IDs that will be swapped
+        auto neighbors_p0 = p0.neighbors(*model);
+        auto neighbors_p1 = p1.neighbors(*model);
+        size_t neighbor_id_01 = neighbors_p0.id(id01);
+        size_t neighbor_id_11 = neighbors_p1.id(id11);
+
+        // Check if the swap would create self-loops or invalid configurations
+        // After swap: p0 will be connected to neighbor_id_11, p1 to neighbor_id_01
+        // Skip if:
+        // 1. neighbor_id_01 == neighbor_id_11 (swapping the same neighbor)
+        // 2. neighbor_id_01 == non_isolates[id1] (p1's new neighbor would be p1 itself)
+        // 3. neighbor_id_11 == non_isolates[id0] (p0's new neighbor would be p0 itself)
+        if (neighbor_id_01 == neighbor_id_11 ||
+            neighbor_id_01 == non_isolates[id1] ||
+            neighbor_id_11 == non_isolates[id0]) {
+            continue;
+        }
+
+        // Check if the swap would create duplicate edges
+        // After swap: p0 will be connected to neighbor_id_11, p1 to neighbor_id_01
+        bool would_create_duplicate = false;
+        for (size_t k = 0u; k < neighbors_p0.size(); ++k) {
+            if (neighbors_p0.id(k) == neighbor_id_11 && neighbors_p0.id(k) != neighbor_id_01) {
+                would_create_duplicate = true;
+                break;
+            }
+        }
+        if (!would_create_duplicate) {
+            for (size_t k = 0u; k < neighbors_p1.size(); ++k) {
+                if (neighbors_p1.id(k) == neighbor_id_01 && neighbors_p1.id(k) != neighbor_id_11) {
+                    would_create_duplicate = true;
+                    break;
+                }
+            }
+        }
+
+        if (would_create_duplicate) {
+            continue; // Skip this rewire attempt
+        }
+
+        // When rewiring, we need to flip the individuals from the other
+        // end as well, since we are dealing withi an undirected graph
+        
+        // Swap neighbors between the two agents
+        // Note: id0 and id1 are indices in non_isolates, not agent IDs
+        model->get_agents()[non_isolates[id0]].swap_neighbors(
+            model->get_agents()[non_isolates[id1]],
+            id01,
+            id11,
+            *model
+            );
+
+
+    }
+
+    #ifdef EPI_DEBUG
+    for (size_t _i = 0u; _i < _degree0.size(); ++_i)
+    {
+        if (_degree0[_i] != static_cast<int>(model->get_agents()[_i].get_n_neighbors()))
+            throw std::logic_error("[epi-debug] Degree does not match afted rewire_degseq.");
+    }
+    #endif
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void rewire_degseq(
+    AdjList * agents,
+    Model<TSeq> * model,
+    epiworld_double proportion
+    )
+{
+
+    // Identifying individuals with degree > 0
+    std::vector< epiworld_fast_int > nties(agents->vcount(), 0);
+
+    #ifdef EPI_DEBUG
+    std::vector< int > _degree0(agents->vcount(), 0);
+    for (size_t i = 0u; i < _degree0.size(); ++i)
+        _degree0[i] = agents->get_dat()[i].size();
+    #endif
+    
+    std::vector< int > non_isolates;
+    non_isolates.reserve(nties.size());
+
+    std::vector< epiworld_double > weights;
+    weights.reserve(nties.size());
+
+    epiworld_double nedges = 0.0;
+    auto & dat = agents->get_dat();
+
+    if (dat.size() > nties.size())
+        throw std::logic_error("Inconsistent adjacency list data.");
+
+    for (size_t i = 0u; i < dat.size(); ++i)
+        nties[i] += dat[i].size();
+
+    bool directed = agents->is_directed();
+    for (size_t i = 0u; i < dat.size(); ++i)
+    {
+        if (nties[i] > 0)
+        {
+            non_isolates.push_back(i);
+            if (directed)
+            {
+                weights.push_back(
+                    static_cast<epiworld_double>(nties[i])
+                );
+                nedges += static_cast<epiworld_double>(nties[i]);
+            }
+            else {
+                weights.push_back(
+                    static_cast<epiworld_double>(nties[i])/2.0
+                );
+                nedges += static_cast<epiworld_double>(nties[i]) / 2.0;
+            }
+        }
+    }
+
+    if (non_isolates.size() == 0u)
+        throw std::logic_error("The graph is completely disconnected.");
+
+    // Cumulative probs
+    weights[0u] /= nedges;
+    for (epiworld_fast_uint i = 1u; i < non_isolates.size(); ++i)
+    {
+         weights[i] /= nedges;
+         weights[i] += weights[i - 1u];
+    }
+
+    // Only swap if needed
+    epiworld_fast_uint N = non_isolates.size();
+    epiworld_double prob;
+    int nrewires = floor(proportion * nedges / (
+        agents->is_directed() ? 1.0 : 2.0
+    ));
+
+    while (nrewires-- > 0)
+    {
+
+        // Picking egos
+        prob = model->runif();
+        int id0 = N - 1;
+        for (epiworld_fast_uint i = 0u; i < N; ++i)
+            if (prob <= weights[i])
+            {
+                id0 = i;
+                break;
+            }
+
+        prob = model->runif();
+        int id1 = N - 1;
+        for (epiworld_fast_uint i = 0u; i < N; ++i)
+            if (prob <= weights[i])
+            {
+                id1 = i;
+                break;
+            }
+
+        // Correcting for under or overflow.
+        if (id1 == id0)
+            id1++;
+
+        if (id1 >= static_cast<int>(N))
+            id1 = 0;
+
+        std::map<int,int> & p0 = agents->get_dat()[non_isolates[id0]];
+        std::map<int,int> & p1 = agents->get_dat()[non_isolates[id1]];
+
+        // Picking alters (relative location in their lists)
+        // In this case, these are uniformly distributed within the list
+        int id01 = model->runif_index(p0.size());
+        int id11 = model->runif_index(p1.size());
+
+        // Since it is a map, we need to find the actual ids (positions)
+        // are not good enough.
+        int count = 0;
+        for (auto & n : p0)
+            if (count++ == id01)
+                id01 = n.first;
+
+        count = 0;
+        for (auto & n : p1)
+            if (count++ == id11)
+                id11 = n.first;
+
+        // When rewiring, we need to actually swap the edges, not just the weights
+        // We'll swap edges: (id0, id01) <-> (id1, id11)
+        // After swap: (id0, id11) and (id1, id01)
+        // But first, check if the swap would create duplicate or self-loop edges
+        
+        // Check for self-loops (new edge would connect node to itself)
+        if (id01 == non_isolates[id1] || id11 == non_isolates[id0]) {
+            continue;
+        }
+        
+        // Check for duplicate edges (new edge already exists)
+        if (p0.find(id11) != p0.end() || p1.find(id01) != p1.end()) {
+            continue; // Skip this rewire attempt to avoid duplicate edges
+        }
+        
+        // Check if we're trying to swap the same neighbor
+        if (id01 == id11) {
+            continue;
+        }
+        
+        // Save the weights before removing edges
+        int weight_0_01 = p0[id01];
+        int weight_1_11 = p1[id11];
+        
+        // Remove old edges from ego perspectives
+        p0.erase(id01);
+        p1.erase(id11);
+        
+        // Add new edges from ego perspectives with swapped alters
+        p0[id11] = weight_0_01;
+        p1[id01] = weight_1_11;
+        
+        // For undirected graphs, also update from alter perspectives
+        if (!agents->is_directed())
+        {
+            std::map<int,int> & p01 = agents->get_dat()[id01];
+            std::map<int,int> & p11 = agents->get_dat()[id11];
+            
+            // Save weights from alter perspectives
+            int weight_01_0 = p01[non_isolates[id0]];
+            int weight_11_1 = p11[non_isolates[id1]];
+            
+            // Remove old edges from alter perspectives
+            p01.erase(non_isolates[id0]);
+            p11.erase(non_isolates[id1]);
+            
+            // Add new edges from alter perspectives
+            p01[non_isolates[id1]] = weight_11_1;
+            p11[non_isolates[id0]] = weight_01_0;
+        }
+
+    }
+
+    #ifdef EPI_DEBUG
+    for (size_t _i = 0u; _i < _degree0.size(); ++_i)
+    {
+        if (_degree0[_i] != static_cast<int>(agents->get_dat()[_i].size()))
+            throw std::logic_error(
+                "[epi-debug] Degree does not match afted rewire_degseq. " +
+                std::string("Expected: ") +
+                std::to_string(_degree0[_i]) +
+                std::string(", observed: ") +
+                std::to_string(agents->get_dat()[_i].size())
+                );
+    }
+    #endif
+
+
+    return;
+
+}
+
+/**
+ * Threshold for the hybrid row-advance in Batagelj-Brandes.
+ *
+ * When a geometric skip lands past the current row of the lower-triangle
+ * enumeration, the flat index must be mapped back to (i, j). For small
+ * excess (j - i <= threshold) the integer while-loop is fastest; for
+ * large excess the O(1) inverse-triangular-number formula avoids
+ * O(sqrt(excess)) iterations. 200 keeps the loop body to at most ~20
+ * iterations (sqrt(2 * 200) ~ 20) before switching to FPU math.
+ */
+static constexpr long long BB_FPU_THRESHOLD = 200;
+
+/**
+ * @brief Generates an Erdős–Rényi random graph G(n, p) using the
+ * Batagelj-Brandes algorithm.
+ *
+ * Uses geometric skipping to advance through the space of possible edges,
+ * generating each edge independently with probability p. This produces
+ * **unbiased** edge counts in O(n + m) expected time, where m is the
+ * number of edges generated.
+ *
+ * Reference: V. Batagelj and U. Brandes, "Efficient generation of large
+ * random networks," Physical Review E, vol. 71, no. 3, 2005.
+ *
+ * @tparam TSeq Type of the sequence (template parameter of the model).
+ * @param n Number of nodes.
+ * @param p Edge probability.
+ * @param directed Whether the graph is directed.
+ * @param model A reference to the Model, used for random number generation.
+ * @return An AdjList representing the generated network.
+ */
+template<typename TSeq>
+inline AdjList rgraph_bernoulli(
+    epiworld_fast_uint n,
+    epiworld_double p,
+    bool directed,
+    Model<TSeq> & model
+) {
+
+    std::vector< int > source;
+    std::vector< int > target;
+
+    // Pre-allocate based on expected edge count
+    double n_possible = directed
+        ? static_cast<double>(n) * (n - 1.0)
+        : static_cast<double>(n) * (n - 1.0) / 2.0;
+    source.reserve(static_cast<size_t>(n_possible * p * 1.1));
+    target.reserve(static_cast<size_t>(n_possible * p * 1.1));
+
+    // Batagelj-Brandes: use geometric skipping to enumerate edges.
+    // log(1 - p) is precomputed; each skip is 1 + floor(log(U) / lp).
+    double lp = std::log(1.0 - p);
+
+    if (!directed)
+    {
+        // Undirected: iterate over (i, j) with i > j
+        long long i = 1;
+        long long j = -1;
+
+        while (i < static_cast<long long>(n))
+        {
+            // Geometric skip
+            double r = model.runif();
+
+            // Avoid log(0)
+            if (r == 0.0)
+                r = std::numeric_limits<double>::min();
+
+            j += 1 + static_cast<long long>(
+                std::floor(std::log(r) / lp)
+            );
+
+            // Advance to the next row if j >= i.
+            // Hybrid approach: for large skips, use O(1) FPU
+            // inverse-triangular-number formula instead of the
+            // integer loop, avoiding O(sqrt(skip)) iterations.
+            if (j >= i && i < static_cast<long long>(n))
+            {
+                if (j - i > BB_FPU_THRESHOLD)
+                {
+                    // O(1) FPU mapping: flat index → (i, j) via
+                    // inverse triangular number. `flat` fits in
+                    // long long since n ≤ INT_MAX (AdjList limit),
+                    // so i*(i-1)/2 + j < n*(n-1)/2 ≪ 2^62.
+                    long long flat = i * (i - 1) / 2 + j;
+                    double df = static_cast<double>(flat);
+                    i = static_cast<long long>(std::floor(
+                        (1.0 + std::sqrt(1.0 + 8.0 * df)) / 2.0
+                    ));
+                    j = flat - i * (i - 1) / 2;
+                    // Floating-point correction: sqrt may round i
+                    // up or down by 1 for large flat values, so j
+                    // may land outside [0, i). Each correction loop
+                    // runs at most 1–2 iterations; only one of the
+                    // two can execute for a given (i, j).
+                    while (j >= i) { j -= i; i++; }
+                    while (j < 0)  { i--; j += i; }
+                }
+                else
+                {
+                    while (j >= i && i < static_cast<long long>(n))
+                    {
+                        j -= i;
+                        i++;
+                    }
+                }
+            }
+
+            if (i < static_cast<long long>(n))
+            {
+                source.push_back(static_cast<int>(i));
+                target.push_back(static_cast<int>(j));
+            }
+        }
+    }
+    else
+    {
+        // Directed: iterate over (i, j) with i != j
+        // We linearize pairs: for row i, columns [0..n-1] excluding i.
+        // Position k in [0, n*(n-1)) maps to row = k/(n-1),
+        // col = k%(n-1), if col >= row then col++.
+        long long total = static_cast<long long>(n) * (n - 1);
+        long long k = -1;
+
+        while (true)
+        {
+            double r = model.runif();
+            if (r == 0.0)
+                r = std::numeric_limits<double>::min();
+
+            k += 1 + static_cast<long long>(
+                std::floor(std::log(r) / lp)
+            );
+
+            if (k >= total)
+                break;
+
+            long long row = k / static_cast<long long>(n - 1);
+            long long col = k % static_cast<long long>(n - 1);
+            if (col >= row)
+                col++;
+
+            source.push_back(static_cast<int>(row));
+            target.push_back(static_cast<int>(col));
+        }
+    }
+
+    AdjList al(source, target, static_cast<int>(n), directed);
+
+    return al;
+
+}
+
+template<typename TSeq>
+inline AdjList rgraph_bernoulli2(
+    epiworld_fast_uint n,
+    epiworld_double p,
+    bool directed,
+    Model<TSeq> & model
+) {
+
+    std::vector< int > source;
+    std::vector< int > target;
+
+    // Checking the density (how many)
+    std::binomial_distribution<> d(
+        n * (n - 1.0) / (directed ? 1.0 : 2.0),
+        p
+    );
+
+    // Need to compensate for the possible number of diagonal
+    // elements sampled. If n * n, then each diag element has
+    // 1/(n^2) chance of sampling
+
+    epiworld_fast_uint m = d(model.get_rand_endgine());
+
+    source.resize(m);
+    target.resize(m);
+
+    double n2 = static_cast<double>(n * n);
+
+    int loc,row,col;
+    for (epiworld_fast_uint i = 0u; i < m; ++i)
+    {
+        loc = floor(model.runif() * n2);
+        col = floor(static_cast<double>(loc)/static_cast<double>(n));
+        row = loc - row * n;
+
+        // Undirected needs to swap
+        if (!directed && (col > row))
+            std::swap(col, row);
+
+        source[i] = row;
+        target[i] = col;
+
+    }
+
+    AdjList al(source, target, static_cast<int>(n), directed);
+
+    return al;
+
+}
+
+inline AdjList rgraph_ring_lattice(
+    epiworld_fast_uint n,
+    epiworld_fast_uint k,
+    bool directed = false
+) {
+
+    if ((n - 1u) < k)
+        throw std::logic_error("k can be at most n - 1.");
+
+    std::vector< int > source;
+    std::vector< int > target;
+
+    if (!directed)
+        if (k > 1u) k = static_cast< size_t >(floor(k / 2.0));
+
+    for (size_t i = 0; i < n; ++i)
+    {
+
+        for (size_t j = 1u; j <= k; ++j)
+        {
+
+            // Next neighbor
+            size_t l = i + j;
+            if (l >= n) l = l - n;
+
+            source.push_back(i);
+            target.push_back(l);
+
+        }
+
+    }
+
+    return AdjList(source, target, n, directed);
+
+}
+
+/**
+ * @brief Smallworld network (Watts-Strogatz)
+ *
+ * @tparam TSeq
+ * @param n
+ * @param k
+ * @param p
+ * @param directed
+ * @param model
+ * @return AdjList
+ */
+template<typename TSeq>
+inline AdjList rgraph_smallworld(
+    epiworld_fast_uint n,
+    epiworld_fast_uint k,
+    epiworld_double p,
+    bool directed,
+    Model<TSeq> & model
+) {
+
+    // Creating the ring lattice
+    AdjList ring = rgraph_ring_lattice(n,k,directed);
+
+    // Rewiring and returning
+    if (k > 0u)
+        rewire_degseq(&ring, &model, p);
+
+    return ring;
+
+}
+
+/**
+ * @brief Generates a blocked network
+ *
+ * Since block sizes and number of connections between blocks are fixed,
+ * this routine is fully deterministic.
+ *
+ * @tparam TSeq
+ * @param n Size of the network
+ * @param blocksize Size of the block.
+ * @param ncons Number of connections between blocks
+ * @param model A model
+ * @return AdjList
+ */
+template<typename TSeq>
+inline AdjList rgraph_blocked(
+    epiworld_fast_uint n,
+    epiworld_fast_uint blocksize,
+    epiworld_fast_uint ncons,
+    Model<TSeq>&
+) {
+
+    std::vector< int > source_;
+    std::vector< int > target_;
+
+    size_t i = 0u;
+    size_t cum_node_count = 0u;
+    while (i < n)
+    {
+
+        for (size_t j = 0; j < blocksize; ++j)
+        {
+
+            for (size_t k = 0; k < j; ++k)
+            {
+                // No loops
+                if (k == j)
+                    continue;
+
+                // Exists the loop in case there are no more
+                // nodes available
+                if ((i + k) >= n)
+                    break;
+
+                source_.push_back(static_cast<int>(j + i));
+                target_.push_back(static_cast<int>(k + i));
+            }
+
+            // No more nodes left to build connections
+            if (++cum_node_count >= n)
+                break;
+
+        }
+
+        // Connections between this and the previou sone
+        if (i != 0)
+        {
+
+            size_t max_cons = std::min(ncons, n - cum_node_count);
+
+            // Generating the connections
+            for (size_t j = 0u; j < max_cons; ++j)
+            {
+
+                source_.push_back(static_cast<int>(i + j - blocksize));
+                target_.push_back(static_cast<int>(i + j));
+
+            }
+        }
+
+        i += blocksize;
+
+    }
+
+    return AdjList(source_, target_, n, false);
+
+}
+
+/**
+ * @brief Generates a network using a Stochastic Block Model (SBM).
+ *
+ * This function creates a random undirected network where connections between
+ * agents are determined by a mixing matrix and block (group) membership.
+ * Each potential edge between agents in blocks \f$g\f$ and \f$h\f$ is included
+ * independently with probability \f$M(g, h) / n_h\f$, where \f$M(g, h)\f$ is
+ * the entry of the mixing matrix and \f$n_h\f$ is the number of agents in
+ * block \f$h\f$.
+ *
+ * The mixing matrix is **not** row-stochastic. For undirected networks, its
+ * row sums should be interpreted as the average expected degree for agents in
+ * that group only when the balance condition
+ * \f$M(g, h) \times n_g = M(h, g) \times n_h\f$ holds for all pairs
+ * \f$(g, h)\f$. In that balanced case,
+ * \f[
+ *   \mathbb{E}[\text{degree of agent in group } g] = \sum_{h} M(g, h)
+ * \f]
+ *
+ * For undirected networks, the implementation samples between-block edges only
+ * once for each unordered pair of blocks (with \f$g \le h\f$) using
+ * \f$M(g, h) / n_h\f$. Therefore, if the balance condition is violated, the
+ * row sums generally do not match the expected degree from every group's
+ * perspective.
+ *
+ * **Unbiased generation.** Edge generation uses the Batagelj-Brandes
+ * algorithm (geometric skipping) independently for each block pair.
+ * Each possible edge is included with exactly the correct probability,
+ * with no duplicate edge collisions. The expected number of edges for a
+ * block pair is exactly:
+ * - Within-block: \f$\binom{n_g}{2} \times p_{gg}\f$
+ * - Between-block: \f$n_g \times n_h \times p_{gh}\f$
+ *
+ * **Balance condition warning.** If the balance condition is violated for
+ * any pair of blocks and the model's verbose mode is on, a warning is
+ * printed indicating which entries are being silently ignored.
+ *
+ * Reference: V. Batagelj and U. Brandes, "Efficient generation of large
+ * random networks," Physical Review E, vol. 71, no. 3, 2005.
+ *
+ * @tparam TSeq Type of the sequence (template parameter of the model).
+ * @param block_sizes A vector of size \f$K\f$ indicating the number of agents
+ *   per block. The total number of agents is \f$\sum_k \text{block\_sizes}[k]\f$.
+ * @param mixing_matrix A vector of size \f$K \times K\f$ representing the
+ *   mixing matrix. The entry \f$M(g, h)\f$ controls the expected number of
+ *   connections agents in group \f$g\f$ make with agents in group \f$h\f$.
+ * @param row_major If `true`, the mixing matrix is stored in row-major order
+ *   (C-style), i.e., \f$M(g, h) = \text{mixing\_matrix}[g \times K + h]\f$.
+ *   If `false`, column-major order (Fortran-style) is assumed, i.e.,
+ *   \f$M(g, h) = \text{mixing\_matrix}[h \times K + g]\f$.
+ * @param model A reference to the Model, used for random number generation.
+ * @return An AdjList representing the generated undirected network.
+ *
+ * @throws std::length_error If `block_sizes` is empty, `mixing_matrix` size
+ *   does not equal \f$K^2\f$, or any block size is zero.
+ * @throws std::range_error If any mixing matrix entry is negative or if
+ *   \f$M(g, h) / n_h > 1\f$ for any pair of blocks.
+ */
+template<typename TSeq>
+inline AdjList rgraph_sbm(
+    const std::vector< size_t > & block_sizes,
+    const std::vector< double > & mixing_matrix,
+    bool row_major,
+    Model<TSeq> & model
+) {
+
+    size_t n_blocks = block_sizes.size();
+
+    if (n_blocks == 0u)
+        throw std::length_error(
+            "block_sizes must have at least one element."
+        );
+
+    if (mixing_matrix.size() != n_blocks * n_blocks)
+        throw std::length_error(
+            "mixing_matrix must have size K * K, where K = block_sizes.size(). "
+            "Expected " + std::to_string(n_blocks * n_blocks) +
+            " but got " + std::to_string(mixing_matrix.size()) + "."
+        );
+
+    // Total number of agents
+    size_t n = 0u;
+    const size_t max_adjlist_n = static_cast<size_t>(
+        std::numeric_limits<int>::max()
+    );
+    for (auto bs : block_sizes)
+    {
+        if (bs == 0u)
+            throw std::length_error(
+                "All block sizes must be positive."
+            );
+
+        if (bs > max_adjlist_n - n)
+            throw std::length_error(
+                "The total number of agents implied by block_sizes exceeds "
+                "the maximum supported graph size (" +
+                std::to_string(std::numeric_limits<int>::max()) + ")."
+            );
+
+        n += bs;
+    }
+
+    // Compute the starting index for each block
+    std::vector< size_t > block_start(n_blocks, 0u);
+    for (size_t g = 1u; g < n_blocks; ++g)
+        block_start[g] = block_start[g - 1u] + block_sizes[g - 1u];
+
+    // Validate mixing matrix entries and compute probabilities.
+    // p(g, h) = M(g, h) / n_h for the undirected case.
+    // We validate that all entries are non-negative and p(g,h) <= 1.
+    // Also estimate the total expected edge count for vector reservation.
+    double estimated_edges = 0.0;
+    for (size_t g = 0u; g < n_blocks; ++g)
+    {
+        for (size_t h = 0u; h < n_blocks; ++h)
+        {
+            double m_gh = row_major
+                ? mixing_matrix[g * n_blocks + h]
+                : mixing_matrix[h * n_blocks + g];
+
+            if (m_gh < 0.0)
+                throw std::range_error(
+                    "Mixing matrix entries must be non-negative. "
+                    "Entry (" + std::to_string(g) + ", " +
+                    std::to_string(h) + ") = " + std::to_string(m_gh) + "."
+                );
+
+            double p_gh = m_gh / static_cast<double>(block_sizes[h]);
+            if (p_gh > 1.0)
+                throw std::range_error(
+                    "Mixing matrix entry (" + std::to_string(g) + ", " +
+                    std::to_string(h) + ") = " + std::to_string(m_gh) +
+                    " implies probability " + std::to_string(p_gh) +
+                    " > 1 (block size = " +
+                    std::to_string(block_sizes[h]) + ")."
+                );
+        }
+
+        // Accumulate expected edges for upper triangle (g <= h)
+        for (size_t h = g; h < n_blocks; ++h)
+        {
+            double m_gh = row_major
+                ? mixing_matrix[g * n_blocks + h]
+                : mixing_matrix[h * n_blocks + g];
+
+            double p_gh = m_gh / static_cast<double>(block_sizes[h]);
+            if (p_gh <= 0.0)
+                continue;
+
+            double n_possible;
+            if (g == h)
+                n_possible = static_cast<double>(block_sizes[g]) *
+                    static_cast<double>(block_sizes[g] - 1u) / 2.0;
+            else
+                n_possible = static_cast<double>(block_sizes[g]) *
+                    static_cast<double>(block_sizes[h]);
+
+            estimated_edges += n_possible * std::min(p_gh, 1.0);
+        }
+    }
+
+    // Warn when the balance condition M(g,h)*n_g = M(h,g)*n_h is
+    // violated for any pair. The upper triangle is used for sampling,
+    // so the lower-triangle entries are silently ignored.
+    if (model.get_verbose())
+    {
+        for (size_t g = 0u; g < n_blocks; ++g)
+        {
+            for (size_t h = g + 1u; h < n_blocks; ++h)
+            {
+                double m_gh = row_major
+                    ? mixing_matrix[g * n_blocks + h]
+                    : mixing_matrix[h * n_blocks + g];
+                double m_hg = row_major
+                    ? mixing_matrix[h * n_blocks + g]
+                    : mixing_matrix[g * n_blocks + h];
+
+                double lhs = m_gh * static_cast<double>(block_sizes[g]);
+                double rhs = m_hg * static_cast<double>(block_sizes[h]);
+
+                if (std::abs(lhs - rhs) > 1e-10 *
+                    std::max(std::abs(lhs), std::abs(rhs)))
+                {
+                    printf_epiworld(
+                        "Warning [rgraph_sbm]: balance condition violated "
+                        "for blocks (%zu, %zu): M(%zu,%zu)*n_%zu = %.4f "
+                        "!= M(%zu,%zu)*n_%zu = %.4f. Only M(%zu,%zu)/n_%zu "
+                        "is used for edge sampling.\n",
+                        g, h,
+                        g, h, g, lhs,
+                        h, g, h, rhs,
+                        g, h, h
+                    );
+                }
+            }
+        }
+    }
+
+    std::vector< int > source;
+    std::vector< int > target;
+
+    // Pre-allocate based on estimated edge count to avoid
+    // repeated reallocations during push_back.
+    source.reserve(static_cast<size_t>(estimated_edges * 1.1));
+    target.reserve(static_cast<size_t>(estimated_edges * 1.1));
+
+    // Batagelj-Brandes geometric skipping for each block pair.
+    // For each pair (g, h) with g <= h, we enumerate possible edges
+    // and skip ahead using geometric random variables, producing each
+    // edge independently with exactly probability p_gh. No duplicates,
+    // no bias.
+    for (size_t g = 0u; g < n_blocks; ++g)
+    {
+        for (size_t h = g; h < n_blocks; ++h)
+        {
+
+            double m_gh = row_major
+                ? mixing_matrix[g * n_blocks + h]
+                : mixing_matrix[h * n_blocks + g];
+
+            // Probability of an edge between agents in blocks g and h
+            double p_gh = m_gh / static_cast<double>(block_sizes[h]);
+
+            if (p_gh <= 0.0)
+                continue;
+
+            // Fast path: p_gh >= 1.0 means all edges are present
+            if (p_gh >= 1.0)
+            {
+                if (g == h)
+                {
+                    // All unique pairs within the block
+                    for (size_t i = block_start[g];
+                         i < block_start[g] + block_sizes[g]; ++i)
+                    {
+                        for (size_t j = i + 1u;
+                             j < block_start[g] + block_sizes[g]; ++j)
+                        {
+                            source.push_back(static_cast<int>(i));
+                            target.push_back(static_cast<int>(j));
+                        }
+                    }
+                }
+                else
+                {
+                    // All pairs between blocks g and h
+                    for (size_t i = block_start[g];
+                         i < block_start[g] + block_sizes[g]; ++i)
+                    {
+                        for (size_t j = block_start[h];
+                             j < block_start[h] + block_sizes[h]; ++j)
+                        {
+                            source.push_back(static_cast<int>(i));
+                            target.push_back(static_cast<int>(j));
+                        }
+                    }
+                }
+                continue;
+            }
+
+            double lp = std::log(1.0 - p_gh);
+
+            if (g == h)
+            {
+                // Within-block: iterate (i, j) with i > j, both in
+                // [0, n_g). Use BB geometric skipping.
+                long long n_g = static_cast<long long>(block_sizes[g]);
+                long long i = 1;
+                long long j = -1;
+
+                while (i < n_g)
+                {
+                    double r = model.runif();
+                    if (r == 0.0)
+                        r = std::numeric_limits<double>::min();
+
+                    j += 1 + static_cast<long long>(
+                        std::floor(std::log(r) / lp)
+                    );
+
+                    // Hybrid row-advance (see BB_FPU_THRESHOLD
+                    // comment in rgraph_bernoulli above).
+                    if (j >= i && i < n_g)
+                    {
+                        if (j - i > BB_FPU_THRESHOLD)
+                        {
+                            long long flat = i * (i - 1) / 2 + j;
+                            double df = static_cast<double>(flat);
+                            i = static_cast<long long>(std::floor(
+                                (1.0 + std::sqrt(1.0 + 8.0 * df)) / 2.0
+                            ));
+                            j = flat - i * (i - 1) / 2;
+                            while (j >= i) { j -= i; i++; }
+                            while (j < 0)  { i--; j += i; }
+                        }
+                        else
+                        {
+                            while (j >= i && i < n_g)
+                            {
+                                j -= i;
+                                i++;
+                            }
+                        }
+                    }
+
+                    if (i < n_g)
+                    {
+                        source.push_back(
+                            static_cast<int>(block_start[g] +
+                                static_cast<size_t>(i))
+                        );
+                        target.push_back(
+                            static_cast<int>(block_start[g] +
+                                static_cast<size_t>(j))
+                        );
+                    }
+                }
+            }
+            else
+            {
+                // Between-block: iterate (i, j) with i in [0, n_g),
+                // j in [0, n_h). Linearize as k = i * n_h + j.
+                long long n_g = static_cast<long long>(block_sizes[g]);
+                long long n_h = static_cast<long long>(block_sizes[h]);
+                long long total = n_g * n_h;
+                long long k = -1;
+
+                while (true)
+                {
+                    double r = model.runif();
+                    if (r == 0.0)
+                        r = std::numeric_limits<double>::min();
+
+                    k += 1 + static_cast<long long>(
+                        std::floor(std::log(r) / lp)
+                    );
+
+                    if (k >= total)
+                        break;
+
+                    long long row = k / n_h;
+                    long long col = k % n_h;
+
+                    source.push_back(
+                        static_cast<int>(block_start[g] +
+                            static_cast<size_t>(row))
+                    );
+                    target.push_back(
+                        static_cast<int>(block_start[h] +
+                            static_cast<size_t>(col))
+                    );
+                }
+            }
+
+        }
+    }
+
+    return AdjList(source, target, static_cast<int>(n), false);
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/randgraph.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/queue-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_QUEUE_BONES_HPP
+#define EPIWORLD_QUEUE_BONES_HPP
+
+/**
+ * @brief Controls which agents are verified at each step
+ * 
+ * @details The idea is that only agents who are either in
+ * an infected state or have an infected neighbor should be
+ * checked. Otherwise it makes no sense (no chance to recover
+ * or capture the disease).
+ * 
+ * **Implementation details:**
+ * <a href="../impl/queueing-system.md">Queueing System</a>
+ * 
+ * @tparam TSeq 
+ */
+template<typename TSeq>
+class Queue
+{
+    friend class Model<TSeq>;
+
+private:
+
+    /**
+     * @brief Count of ego's neighbors in queue (including ego)
+     */
+    std::vector< epiworld_fast_int > active;
+    Model<TSeq> * model = nullptr;
+    int n_in_queue = 0;
+
+    /**
+     * @brief Worklist of agents that may be in the queue
+     * @details Agents are added (once, as tracked by `in_list`) when their
+     * counter is increased or accessed through `operator[]`, and are
+     * removed lazily by `get_active_agents()` once their counter is back
+     * to zero. This way, iterating over the queue costs as much as the
+     * number of active agents, not the size of the population.
+     */
+    ///@{
+    std::vector< size_t > active_list;
+    std::vector< bool > in_list;
+    void touch(size_t i);
+    ///@}
+
+    // Auxiliary variable that checks how many steps
+    // left are there
+    // int n_steps_left;
+    // bool queuing_started   = false;
+
+public:
+
+    void operator+=(Agent<TSeq> * p);
+    void operator-=(Agent<TSeq> * p);
+    epiworld_fast_int & operator[](epiworld_fast_uint i);
+
+    /**
+     * @brief Reads the counter of agent `i` without adding it to the
+     * worklist.
+     */
+    epiworld_fast_int operator[](epiworld_fast_uint i) const;
+
+    /**
+     * @brief Number of agents in the worklist, including those that left
+     * the queue since the last call to `get_active_agents()`.
+     */
+    size_t get_worklist_size() const {return active_list.size();};
+
+    /**
+     * @brief Ids of the agents in the queue, in ascending order
+     * @details Compacts the worklist before returning it. Iterating in
+     * ascending order keeps the draws from the random number generator
+     * in the same order as looping over the entire population.
+     */
+    const std::vector< size_t > & get_active_agents();
+
+    // void initialize(Model<TSeq> * m, Agent<TSeq> * p);
+    void reset();
+
+    bool operator==(const Queue<TSeq> & other) const;
+    bool operator!=(const Queue<TSeq> & other) const {return !operator==(other);};
+
+    static const int NoOne    = 0;
+    static const int OnlySelf = 1;
+    static const int Everyone = 2;
+
+};
+
+template<typename TSeq>
+inline void Queue<TSeq>::touch(size_t i)
+{
+
+    if (!in_list[i])
+    {
+        in_list[i] = true;
+        active_list.push_back(i);
+    }
+
+}
+
+template<typename TSeq>
+inline void Queue<TSeq>::operator+=(Agent<TSeq> * p)
+{
+
+    if (++active[p->id] == 1)
+        n_in_queue++;
+
+    touch(p->id);
+
+    if (p->get_n_neighbors() == 0u)
+        return; // No neighbors, no need to add them
+
+    const epiworld_agent_index * neighbors = model->network->neighbors(p->id);
+    for (size_t i = 0u; i < p->n_neighbors; ++i)
+    {
+
+        size_t n = neighbors[i];
+
+        if (++active[n] == 1)
+            n_in_queue++;
+
+        touch(n);
+
+    }
+
+}
+
+template<typename TSeq>
+inline void Queue<TSeq>::operator-=(Agent<TSeq> * p)
+{
+
+    if (--active[p->id] == 0)
+        n_in_queue--;
+
+    if (p->get_n_neighbors() == 0u)
+        return; // No neighbors, no need to add them
+
+    const epiworld_agent_index * neighbors = model->network->neighbors(p->id);
+    for (size_t i = 0u; i < p->n_neighbors; ++i)
+    {
+
+        size_t n = neighbors[i];
+
+        if (--active[n] == 0)
+            n_in_queue--;
+    }
+
+}
+
+template<typename TSeq>
+inline epiworld_fast_int & Queue<TSeq>::operator[](epiworld_fast_uint i)
+{
+    // The counter may be modified through the reference
+    touch(i);
+    return active[i];
+}
+
+template<typename TSeq>
+inline epiworld_fast_int Queue<TSeq>::operator[](epiworld_fast_uint i) const
+{
+    return active[i];
+}
+
+template<typename TSeq>
+inline const std::vector< size_t > & Queue<TSeq>::get_active_agents()
+{
+
+    if ((active_list.size() * 4u) > active.size())
+    {
+
+        // Dense queue: a single pass over the counters returns
+        // the agents already sorted
+        active_list.clear();
+        for (size_t i = 0u; i < active.size(); ++i)
+        {
+            in_list[i] = active[i] > 0;
+            if (in_list[i])
+                active_list.push_back(i);
+        }
+
+    }
+    else
+    {
+
+        // Sparse queue: dropping the agents that left the queue
+        size_t n = 0u;
+        for (auto i : active_list)
+        {
+            if (active[i] > 0)
+                active_list[n++] = i;
+            else
+                in_list[i] = false;
+        }
+
+        active_list.resize(n);
+        std::sort(active_list.begin(), active_list.end());
+
+    }
+
+    return active_list;
+
+}
+
+template<typename TSeq>
+inline void Queue<TSeq>::reset()
+{
+
+    if (n_in_queue)
+    {
+
+        for (auto & q : this->active)
+            q = 0;
+
+        n_in_queue = 0;
+        
+    }
+
+    active.resize(model->size(), 0);
+
+    // Rebuilding the worklist from the counters that were kept
+    active_list.clear();
+    in_list.assign(active.size(), false);
+    for (size_t i = 0u; i < active.size(); ++i)
+        if (active[i] > 0)
+            touch(i);
+
+}
+
+template<typename TSeq>
+inline bool Queue<TSeq>::operator==(const Queue<TSeq> & other) const 
+{
+    if (active.size() != other.active.size())
+        return false;
+
+    for (size_t i = 0u; i < active.size(); ++i)
+    {
+        if (active[i] != other.active[i])
+            return false;
+    }
+
+    return true;
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/queue-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/eventbuffer.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_EVENTBUFFER_HPP
+#define EPIWORLD_EVENTBUFFER_HPP
+
+template<typename TSeq>
+class Agent;
+
+template<typename TSeq>
+class Entity;
+
+/**
+ * @brief Pending events of a model, stored as parallel arrays
+ *
+ * @details Each event is a row across the arrays `agent`, `action`,
+ * `new_state`, `queue`, and `payload`. Viruses, tools, and entities travel
+ * in their own arrays and events refer to them by index (`payload`, `-1`
+ * if none), so most events (e.g., changes of state) carry no shared
+ * pointers. The arrays keep their capacity across days. Filled by
+ * `Model<TSeq>::_add_event()` and consumed by `Model<TSeq>::events_run()`.
+ *
+ * @tparam TSeq
+ */
+template<typename TSeq>
+class EventBuffer {
+    friend class Model<TSeq>;
+private:
+
+    std::vector< Agent<TSeq> * > agent;
+    std::vector< EventAction > action;
+    std::vector< epiworld_fast_int > new_state;
+    std::vector< epiworld_fast_int > queue;
+    std::vector< int > payload; ///< Index in `viruses`, `tools`, or `entities`.
+
+    std::vector< VirusPtr<TSeq> > viruses;
+    std::vector< ToolPtr<TSeq> > tools;
+    std::vector< Entity<TSeq> * > entities;
+
+    std::vector< size_t > order; ///< Scratch space for `sort_by_agent()`.
+
+public:
+
+    size_t size() const noexcept { return action.size(); };
+    bool empty() const noexcept { return action.empty(); };
+
+    void push(
+        Agent<TSeq> * agent_,
+        VirusPtr<TSeq> && virus_,
+        ToolPtr<TSeq> && tool_,
+        Entity<TSeq> * entity_,
+        epiworld_fast_int new_state_,
+        epiworld_fast_int queue_,
+        EventAction action_
+    )
+    {
+
+        int idx = -1;
+        switch (action_)
+        {
+        case EventAction::AddVirus:
+        case EventAction::RemoveVirus:
+            idx = static_cast< int >(viruses.size());
+            viruses.push_back(std::move(virus_));
+            break;
+        case EventAction::AddTool:
+        case EventAction::RemoveTool:
+            idx = static_cast< int >(tools.size());
+            tools.push_back(std::move(tool_));
+            break;
+        case EventAction::AddEntity:
+        case EventAction::RemoveEntity:
+            idx = static_cast< int >(entities.size());
+            entities.push_back(entity_);
+            break;
+        default:
+            break;
+        }
+
+        agent.push_back(agent_);
+        action.push_back(action_);
+        new_state.push_back(new_state_);
+        queue.push_back(queue_);
+        payload.push_back(idx);
+
+    };
+
+    /**
+     * @brief Moves the i-th event into `a`
+     * @details The virus or tool of the event (if any) is moved out of the
+     * buffer, so each event can only be retrieved once.
+     */
+    void get(size_t i, Event<TSeq> & a)
+    {
+
+        a.agent     = agent[i];
+        a.action    = action[i];
+        a.new_state = new_state[i];
+        a.queue     = queue[i];
+        a.virus     = nullptr;
+        a.tool      = nullptr;
+        a.entity    = nullptr;
+
+        const int idx = payload[i];
+        if (idx < 0)
+            return;
+
+        switch (a.action)
+        {
+        case EventAction::AddVirus:
+        case EventAction::RemoveVirus:
+            a.virus = std::move(viruses[idx]);
+            break;
+        case EventAction::AddTool:
+        case EventAction::RemoveTool:
+            a.tool = std::move(tools[idx]);
+            break;
+        default:
+            a.entity = entities[idx];
+            break;
+        }
+
+    };
+
+    /**
+     * @brief Order in which to apply the events in `[from, to)`
+     * @details Sorted by agent id. The sort is stable, so the events of
+     * each agent keep the order in which they were added.
+     * @return Reference to a vector of `to - from` event indices.
+     */
+    const std::vector< size_t > & sort_by_agent(size_t from, size_t to)
+    {
+
+        order.resize(to - from);
+        for (size_t i = from; i < to; ++i)
+            order[i - from] = i;
+
+        std::stable_sort(
+            order.begin(), order.end(),
+            [this](size_t i, size_t j) {
+                return agent[i]->get_id() < agent[j]->get_id();
+            }
+        );
+
+        return order;
+
+    };
+
+    /**
+     * @brief Removes all the events (keeps the capacity)
+     */
+    void clear()
+    {
+        agent.clear();
+        action.clear();
+        new_state.clear();
+        queue.clear();
+        payload.clear();
+        viruses.clear();
+        tools.clear();
+        entities.clear();
+    };
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/eventbuffer.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/contacttracing-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_CONTACTTRACING_BONES_H
+#define EPIWORLD_CONTACTTRACING_BONES_H
+
+#include <vector>
+#include <stdexcept>
+// (already included include/epiworld/config.hpp)
+
+/** 
+ * @brief Class for tracing contacts between agents
+ * @details
+ * The class assumes that contacts are stored in a matrix-like
+ * structure, where rows are agents and columns are contacts in a 
+ * column-major format. Each entry stores the id of the contact
+ * and the day of the contact is stored in a parallel array.
+ * 
+ * The maximum number of contacts per agent is fixed at initialization
+ * time. If more contacts are added, they will overwrite previous
+ * contacts in a circular buffer fashion.
+ * */
+class ContactTracing
+{
+    template<typename TSeq> friend class Model;
+
+private:
+
+    std::vector< epiworld_agent_index > contact_matrix;
+    std::vector< size_t > contacts_per_agent;
+    std::vector< size_t > contact_date;
+
+    size_t n_agents;
+    size_t max_contacts;
+
+    size_t get_location(size_t row, size_t col) const;
+
+public:
+
+    ContactTracing();
+
+    /**
+     * @brief Construct a new Contact Tracing object
+     * 
+     * @param n_agents Agents in the system, usually `Model<TSeq>::size()`.
+     * @param max_contacts Maximum number of contacts to track per agent.
+     */
+    ContactTracing(size_t n_agents, size_t max_contacts);
+
+    /**
+     * @brief Add a contact between two agents at a given day.
+     * 
+     * @param agent_a Agent id (usually infectious agent)
+     * @param agent_b Agent id (usually susceptible agent)
+     * @param day Day of the contact (usually Model<TSeq>::today()).
+     */
+    void add_contact(size_t agent_a, size_t agent_b, size_t day);
+
+    /**
+     * @brief Get the number of contacts for an agent
+     * 
+     * @param agent Agent id
+     * @return size_t Number of contacts recorded for that agent (can be more than max_contacts)
+     */
+    size_t get_n_contacts(size_t agent); 
+
+    size_t get_max_contacts() const;
+    
+    /**
+     * @brief Get the contact object
+     * 
+     * @param agent Source agent (id)
+     * @param idx Index of the contact (0 to get_n_contacts(agent)-1)
+     * @return std::pair<size_t, int> with (contact_id, contact_day)
+     * @throws std::out_of_range if idx is out of range.
+     */
+    std::pair<size_t, int> get_contact(size_t agent, size_t idx);
+
+    /**
+     * @brief Reset the contact tracing data
+     * 
+     * Usually called by `Model<TSeq>::reset()`.
+     * 
+     * @param n_agents Number of agents
+     * @param max_contacts Maximum number of contacts to track per agent
+     */
+    void reset(
+        size_t n_agents,
+        size_t max_contacts
+    );
+
+    /**
+     * @brief Print the contacts of an agent 
+     * 
+     * @param agent Agent id
+     */
+    void print(size_t agent);
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/contacttracing-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/contacttracing-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_CONTACTTRACING_MEAT_H
+#define EPIWORLD_CONTACTTRACING_MEAT_H
+
+// (already included include/epiworld/contacttracing-bones.hpp)
+
+inline size_t ContactTracing::get_location(size_t row, size_t col) const
+{
+    return col * n_agents + row;
+}
+
+inline ContactTracing::ContactTracing()
+{
+    n_agents = 0u;
+    max_contacts = 0u;
+}
+
+inline ContactTracing::ContactTracing(size_t n_agents, size_t max_contacts)
+{
+    this->n_agents = n_agents;
+    this->max_contacts = max_contacts;
+
+    contact_matrix.resize(n_agents * max_contacts, 0u);
+    contacts_per_agent.resize(n_agents, 0);
+    contact_date.resize(n_agents * max_contacts, 0);
+}
+
+inline void ContactTracing::add_contact(size_t agent_a, size_t agent_b, size_t day)
+{
+    
+    // Checking overflow
+    size_t col_location = contacts_per_agent[agent_a] % max_contacts;
+    size_t array_location = get_location(agent_a, col_location);
+
+    contact_matrix[array_location] = static_cast< epiworld_agent_index >(agent_b);
+    contact_date[array_location] = day;
+
+    contacts_per_agent[agent_a] += 1;
+
+}
+
+inline size_t ContactTracing::get_n_contacts(size_t agent)
+{
+    return contacts_per_agent[agent];
+}
+
+inline size_t ContactTracing::get_max_contacts() const
+{
+    return max_contacts;
+}
+
+inline std::pair< size_t, int> ContactTracing::get_contact(size_t agent, size_t idx)
+{
+    if (
+        (idx >= contacts_per_agent[agent]) ||
+        (idx >= max_contacts)
+    )
+        throw std::out_of_range("Index out of range in get_contact");
+
+    size_t col_location = idx % max_contacts;
+    size_t array_location = get_location(agent, col_location);
+
+    return { contact_matrix[array_location], contact_date[array_location] };
+}
+
+inline void ContactTracing::reset(size_t n_agents, size_t max_contacts)
+{
+
+    this->n_agents = n_agents;
+    this->max_contacts = max_contacts;
+
+    contact_matrix.assign(n_agents * max_contacts, 0u);
+    contacts_per_agent.assign(n_agents, 0u);
+    contact_date.assign(n_agents * max_contacts, 0u);
+}
+
+inline void ContactTracing::print(size_t agent)
+{
+
+    size_t n_contacts = contacts_per_agent[agent];
+    if (n_contacts > max_contacts)
+        n_contacts = max_contacts;
+
+    printf_epiworld("Agent %zu has %zu contacts: ", agent, n_contacts);
+    for (size_t i = 0u; i < n_contacts; ++i)
+    {
+        auto [contact_id, contact_day] = get_contact(agent, i);
+        printf_epiworld("(%zu, day %i) ", contact_id, contact_day);
+    }
+    printf_epiworld("\n");
+
+    return;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/contacttracing-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/contactmatrix-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_CONTACTMATRIX_BONES_HPP
+#define EPIWORLD_CONTACTMATRIX_BONES_HPP
+
+#include <vector>
+
+/**
+ * @file contactmatrix-bones.hpp
+ * @brief Base class for handling contact matrices in epidemiological
+ * models
+ * 
+ * This class provides functionality for setting and validating contact
+ * matrices, which are essential for modeling population mixing in
+ * epidemiological simulations. Models that require contact matrices can
+ * inherit from this class.
+ */
+class ContactMatrix 
+{
+private: 
+
+    std::vector< double > contact_matrix;
+    std::vector< double > contact_matrix_backup; ///< Used for resetting the model
+    int n_groups = -1;
+
+public:
+
+    ContactMatrix() = default;
+
+    /**
+     * @brief Validates the contact matrix size and values
+     * @param expected_size The expected size of the contact matrix
+     */
+    void validate_contact_matrix(size_t expected_size);
+    /**
+     * @brief Set the contact matrix for population mixing
+     * @param cmat Contact matrix specifying interaction rates between groups
+     * @param as_backup Whether to use the matrix as a backup (default: true)
+     * If set to true, the new contact matrix will be saved as a backup for
+     * resetting the model.
+     */
+    void set_contact_matrix(std::vector< double > cmat, bool as_backup = true);
+
+    /**
+     * @brief Get the current contact matrix
+     * @return Vector representing the contact matrix
+     */
+    const std::vector< double > & get_contact_matrix() const;
+
+    /**
+     * @brief Get the current contact matrix
+     * @return Vector representing the contact matrix
+     */
+    std::vector< double > & get_contact_matrix_ref();
+
+    /**
+     * @brief Get the contact rate between two groups
+     * @param i Index of the first group
+     * @param j Index of the second group
+     * @return Contact rate between group i and group j
+     */
+    double get_contact_rate(size_t i, size_t j, bool check = true) const;
+
+    /**
+     * @brief Get the size of the contact matrix
+     * @return Size of the contact matrix
+     */
+    size_t get_contact_matrix_size() const;
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/contactmatrix-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/contactmatrix-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_CONTACTMATRIX_MEAT_HPP
+#define EPIWORLD_CONTACTMATRIX_MEAT_HPP
+
+// (already included include/epiworld/contactmatrix-bones.hpp)
+#include <stdexcept>
+
+inline void ContactMatrix::validate_contact_matrix(size_t expected_size)
+{
+
+    if (!contact_matrix_backup.empty())
+        contact_matrix = contact_matrix_backup;
+
+    if (contact_matrix.size() != expected_size * expected_size)
+        throw std::length_error(
+            std::string("Contact matrix size is ") +
+            std::to_string(contact_matrix.size()) +
+            std::string(", but expected size is ") +
+            std::to_string(expected_size * expected_size) + "."
+        );
+
+    for (int i = 0; i < n_groups; ++i)
+    {
+        for (int j = 0; j < n_groups; ++j)
+        {
+            if (get_contact_rate(i, j, false) < 0.0)
+                throw std::range_error(
+                    std::string("The contact matrix must be non-negative. ") +
+                    std::to_string(this->get_contact_rate(i, j, false)) +
+                    std::string(" < 0.")
+                    );
+        }
+    }
+
+}
+
+inline void ContactMatrix::set_contact_matrix(
+    std::vector< double > cmat,
+    bool as_backup
+)
+{
+    n_groups = static_cast<int>(std::sqrt(cmat.size()));
+    if (n_groups * n_groups != static_cast<int>(cmat.size()))
+        throw std::invalid_argument(
+            "Contact matrix size is not a perfect square, cannot determine number of groups."
+        );
+
+    if (as_backup)
+        contact_matrix_backup = cmat;
+
+    contact_matrix = cmat;
+    return;
+};
+
+inline const std::vector< double > & ContactMatrix::get_contact_matrix() const
+{
+    return contact_matrix;
+}
+
+inline std::vector< double > & ContactMatrix::get_contact_matrix_ref()
+{
+    return contact_matrix;
+}
+
+inline double ContactMatrix::get_contact_rate(
+    size_t i, size_t j, bool check
+) const
+{
+    if (check && (
+        (static_cast<int>(i) >= n_groups) ||
+        (static_cast<int>(j) >= n_groups)
+    ))
+        throw std::out_of_range(
+            std::string("Group indices out of range. ") +
+            std::to_string(i) + ", " + std::to_string(j) +
+            std::string(" >= ") + std::to_string(n_groups)
+        );
+    return contact_matrix[j * n_groups + i];
+}
+
+inline size_t ContactMatrix::get_contact_matrix_size() const
+{
+    return contact_matrix.size();
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/contactmatrix-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/globalevent-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_GLOBALEVENT_BONES_HPP
+#define EPIWORLD_GLOBALEVENT_BONES_HPP
+
+#include <string>
+// (already included include/epiworld/config.hpp)
+
+/**
+ * @brief Template for a Global Event
+ * @details Global events are functions that Model<TSeq> executes
+ * at the end of a day.
+ * 
+ */
+template<typename TSeq>
+class GlobalEvent
+{
+private:
+    GlobalFun<TSeq> fun = nullptr;
+    std::string name = "A global action";
+    int day = -99;
+public:
+
+    GlobalEvent() {};
+
+    /**
+     * @brief Construct a new Global Event object
+     * 
+     * @param fun A function that takes a Model<TSeq> * as argument and returns void.
+     * @param name A descriptive name for the action.
+     * @param day The day when the action will be executed. If negative, it will be executed every day.
+     */
+    GlobalEvent(GlobalFun<TSeq> fun, std::string name, int day = -99);
+    
+    virtual ~GlobalEvent() = default;
+
+    virtual void operator()(Model<TSeq> * m, int day);
+
+    void set_name(std::string name);
+    std::string get_name() const;
+
+    void set_day(int day);
+    int get_day() const;
+    
+    void print() const;
+
+    // Comparison operators
+    bool operator==(const GlobalEvent<TSeq> & other) const;
+    bool operator!=(const GlobalEvent<TSeq> & other) const;
+
+    virtual std::unique_ptr<GlobalEvent<TSeq>> clone_ptr() const;
+
+};
+
+
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/globalevent-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/globalevent-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_GLOBALEVENT_MEAT_HPP
+#define EPIWORLD_GLOBALEVENT_MEAT_HPP
+
+#include <memory>
+// (already included include/epiworld/globalevent-bones.hpp)
+
+template<typename TSeq>
+inline GlobalEvent<TSeq>::GlobalEvent(
+    GlobalFun<TSeq> fun,
+    std::string name,
+    int day
+    )
+{
+    this->fun = fun;
+    this->name = name;
+    this->day = day;
+}
+
+template<typename TSeq>
+inline void GlobalEvent<TSeq>::operator()(Model<TSeq> * m, int day)
+{   
+    
+    if (this->fun == nullptr)
+        return;
+
+    // events apply if day is negative or if day is equal to the day of the action
+    if (this->day < 0 || this->day == day)
+        this->fun(m);
+    
+    return;
+
+}
+
+template<typename TSeq>
+inline void GlobalEvent<TSeq>::set_name(std::string name)
+{
+    this->name = name;
+}
+
+template<typename TSeq>
+inline std::string GlobalEvent<TSeq>::get_name() const
+{
+    return this->name;
+}
+
+template<typename TSeq>
+inline void GlobalEvent<TSeq>::set_day(int day)
+{
+    this->day = day;
+}
+
+template<typename TSeq>
+inline int GlobalEvent<TSeq>::get_day() const
+{
+    return this->day;
+}
+
+template<typename TSeq>
+inline void GlobalEvent<TSeq>::print() const
+{
+    printf_epiworld(
+        "Global action: %s\n"
+        "  - Day: %i\n",
+        this->name.c_str(),
+        this->day
+        );
+}
+
+template<typename TSeq>
+inline bool GlobalEvent<TSeq>::operator==(const GlobalEvent<TSeq> & other) const
+{
+    return (this->name == other.name) && (this->day == other.day);
+}
+
+template<typename TSeq>
+inline bool GlobalEvent<TSeq>::operator!=(const GlobalEvent<TSeq> & other) const
+{
+    return !(*this == other);
+}
+
+template<typename TSeq>
+inline std::unique_ptr<GlobalEvent<TSeq>> GlobalEvent<TSeq>::clone_ptr() const
+{
+    return std::make_unique<GlobalEvent<TSeq>>(*this);
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/globalevent-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/model-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODEL_BONES_HPP
+#define EPIWORLD_MODEL_BONES_HPP
+
+#include <memory>
+#include <vector>
+#include <functional>
+#include <string>
+#include <map>
+// (already included include/epiworld/config.hpp)
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/agent-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_PERSON_BONES_HPP
+#define EPIWORLD_PERSON_BONES_HPP
+
+template<typename TSeq>
+class Model;
+
+template<typename TSeq>
+class Virus;
+
+template<typename TSeq>
+class Viruses;
+
+template<typename TSeq>
+class Viruses_const;
+
+template<typename TSeq>
+class Tool;
+
+
+template<typename TSeq>
+class Queue;
+
+template<typename TSeq>
+struct Event;
+
+template<typename TSeq>
+class Entity;
+
+template<typename TSeq>
+class Entities;
+
+template<typename TSeq>
+class AgentsSample;
+
+/**
+ * @brief Agent (agents)
+ * 
+ * @tparam TSeq Sequence type (should match `TSeq` across the model)
+ */
+template<typename TSeq>
+class Agent {
+    friend class Model<TSeq>;
+    friend class Virus<TSeq>;
+    friend class Tool<TSeq>;
+    friend class Queue<TSeq>;
+    friend class AgentsSample<TSeq>;
+protected:
+
+    size_t n_neighbors = 0u; ///< Degree (ties are stored in `Model<TSeq>::network`).
+
+    std::vector< epiworld_agent_index > entities; ///< Entity IDs (indices into Model::entities)
+
+    unsigned int state = 0u;
+    unsigned int state_prev = 0u; ///< For accounting, if need to undo a change.
+    
+    int state_last_changed = -1; ///< Last time the agent was updated.
+    int id = -1;
+    
+    VirusPtr<TSeq> virus = nullptr;
+
+    std::vector< ToolPtr<TSeq> > tools;
+
+    /**
+     * @name Cached tool effects
+     * @details `tools_effects[k]` is the product of `(1 - effect k)` across
+     * the agent's tools, valid when bit `k` of `tools_effects_fixed` is on
+     * (i.e., all the tools have a constant k-th effect; see
+     * `Tool<TSeq>::fixed_mask`). Refreshed every time the tools change, so
+     * the mixers in `Model<TSeq>` can skip calling the tools' functions.
+     */
+    ///@{
+    epiworld_double tools_effects[4u] = {1.0, 1.0, 1.0, 1.0};
+    unsigned char tools_effects_fixed = 0x0Fu;
+    void tools_effects_update();
+    ///@}
+
+    void reset(); ///< Resets the agent to the initial state (no virus, no tools, no entities, state 0.)
+
+public:
+
+    Agent() = default;
+    Agent(Agent<TSeq> && p);
+    Agent(const Agent<TSeq> & p);
+    Agent<TSeq> & operator=(const Agent<TSeq> & other_agent);
+    ~Agent();
+
+    /**
+     * @name Add/Remove Virus/Tool
+     * 
+     * Any of these is ultimately reflected at the end of the iteration.
+     * 
+     * @param tool Tool to add
+     * @param virus Virus to add
+     * @param state_new state after the change
+     * @param queue 
+     */
+    ///@{
+    void add_tool(
+        Model<TSeq> & model,
+        const Tool<TSeq> & tool,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+        );
+
+    void set_virus(
+        Model<TSeq> & model,
+        const Virus<TSeq> & virus,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+        );
+
+    void add_entity(
+        Model<TSeq> & model,
+        Entity<TSeq> & entity,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+        );
+
+    void rm_tool(
+        Model<TSeq> & model,
+        epiworld_fast_uint tool_idx,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+    );
+
+    void rm_tool(
+        Model<TSeq> & model,
+        ToolPtr<TSeq> & tool,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+    );
+
+    void rm_virus(
+        Model<TSeq> & model,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+    );
+
+    void rm_entity(
+        Model<TSeq> & model,
+        epiworld_fast_uint entity_idx,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+    );
+
+    void rm_entity(
+        Model<TSeq> & model,
+        Entity<TSeq> & entity,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+    );
+
+    void rm_agent_by_virus(Model<TSeq> & model) = delete; ///< Agent removed by virus
+    ///@}
+    
+    /**
+     * @name Get the rates (multipliers) for the agent
+     * 
+     * @param v A pointer to a virus.
+     * @return epiworld_double 
+     */
+    ///@{
+    epiworld_double get_susceptibility_reduction(VirusPtr<TSeq> & v, Model<TSeq> & model);
+    epiworld_double get_transmission_reduction(VirusPtr<TSeq> & v, Model<TSeq> & model);
+    epiworld_double get_recovery_enhancer(VirusPtr<TSeq> & v, Model<TSeq> & model);
+    epiworld_double get_death_reduction(VirusPtr<TSeq> & v, Model<TSeq> & model);
+    ///@}
+
+    int get_id() const; ///< Id of the individual
+
+    VirusPtr<TSeq> & get_virus();
+    const VirusPtr<TSeq> & get_virus() const;
+
+    ToolPtr<TSeq> & get_tool(int i);
+    ToolPtr<TSeq> & get_tool(std::string name);
+
+    std::vector<ToolPtr<TSeq>> get_tools();
+    const std::vector<ToolPtr<TSeq>> get_tools() const;
+    size_t get_n_tools() const noexcept;
+
+    void mutate_virus();
+    void add_neighbor(
+        Agent<TSeq> & p,
+        Model<TSeq> & model,
+        bool check_source = true,
+        bool check_target = true
+        );
+
+    /**
+     * @brief Swaps neighbors between the current agent and agent `other`
+     * 
+     * @param other 
+     * @param n_this 
+     * @param n_other 
+     */
+    void swap_neighbors(
+        Agent<TSeq> & other,
+        size_t n_this,
+        size_t n_other,
+        Model<TSeq> & model
+    );
+
+    std::vector< Agent<TSeq> * > get_neighbors(Model<TSeq> & model);
+    AgentNeighbors<TSeq> neighbors(Model<TSeq> & model); ///< Non-allocating view of the neighbors.
+    size_t get_n_neighbors() const;
+
+    void change_state(
+        Model<TSeq> & model,
+        epiworld_fast_uint new_state,
+        epiworld_fast_int queue = 0
+        );
+
+    unsigned int get_state() const;
+    unsigned int get_state_prev() const;
+    int get_state_last_changed() const;
+
+
+    bool has_tool(epiworld_fast_uint t) const;
+    bool has_tool(std::string_view name) const;
+    bool has_tool(const Tool<TSeq> & t) const;
+    bool has_virus(epiworld_fast_uint t) const;
+    bool has_virus(std::string_view name) const;
+    bool has_virus(const Virus<TSeq> & v) const;
+    bool has_entity(epiworld_fast_uint t) const;
+    bool has_entity(std::string_view name, const Model<TSeq> & model) const;
+
+    void print(Model<TSeq> & model, bool compressed = false) const;
+
+    /**
+     * @brief Access the j-th column of the agent
+     * 
+     * If an external array has been specified, then these two
+     * functions can be used to access additional agent's features 
+     * not included in the model.
+     * 
+     * @param j 
+     * @param model Reference to the Model
+     * @return double& 
+     */
+    ///@{
+    double & operator()(size_t j, Model<TSeq> & model);
+    double operator()(size_t j, const Model<TSeq> & model) const;
+    ///@}
+
+    const std::vector< epiworld_agent_index > & get_entities() const;
+
+    const Entity<TSeq> & get_entity(size_t i, const Model<TSeq> & model) const;
+    Entity<TSeq> & get_entity(size_t i, Model<TSeq> & model);
+
+    size_t get_n_entities() const;
+
+    bool operator==(const Agent<TSeq> & other) const;
+    bool operator!=(const Agent<TSeq> & other) const {return !operator==(other);};
+
+};
+
+
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/agent-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/virus-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_VIRUS_HPP
+#define EPIWORLD_VIRUS_HPP
+
+template<typename TSeq>
+class Agent;
+
+template<typename TSeq>
+class Virus;
+
+template<typename TSeq>
+class Model;
+
+/**
+ * @brief Virus
+ * 
+ * @tparam TSeq 
+ * @details
+ * Raw transmisibility of a virus should be a function of its genetic
+ * sequence. Nonetheless, transmisibility can be reduced as a result of
+ * having one or more tools to fight the virus. Because of this, transmisibility
+ * should be a function of the agent.
+ */
+template<typename TSeq>
+class Virus {
+    friend class Agent<TSeq>;
+    friend class Model<TSeq>;
+    friend class DataBase<TSeq>;
+private:
+    
+    /**
+     * @brief Fields shared by the copies of a virus
+     * @details Agents carry their own copy of the virus, but the name,
+     * states, queues, and functions are the same for every carrier, so
+     * copies share a single `Strain`. Setters detach it first
+     * (copy-on-write), so copying a virus is cheap and only viruses that are
+     * modified after the copy (e.g., by a mutation) own a new strain.
+     */
+    struct Strain {
+
+        std::string virus_name = "unknown virus";
+        epiworld_fast_int state_init    = -99; ///< Change of state when added to agent.
+        epiworld_fast_int state_post    = -99; ///< Change of state when removed from agent.
+        epiworld_fast_int state_removed = -99; ///< Change of state when agent is removed
+
+        epiworld_fast_int queue_init    = Queue<TSeq>::Everyone; ///< Change of state when added to agent.
+        epiworld_fast_int queue_post    = -Queue<TSeq>::Everyone; ///< Change of state when removed from agent.
+        epiworld_fast_int queue_removed = -Queue<TSeq>::Everyone; ///< Change of state when agent is removed
+
+        MutFun<TSeq>          mutation                 = nullptr;
+        PostRecoveryFun<TSeq> post_recovery_fun        = nullptr;
+        VirusFun<TSeq>        probability_of_infecting = nullptr;
+        VirusFun<TSeq>        probability_of_recovery  = nullptr;
+        VirusFun<TSeq>        probability_of_death     = nullptr;
+        VirusFun<TSeq>        incubation               = nullptr;
+
+        // Information about how distribution works
+        VirusToAgentFun<TSeq> dist = nullptr;
+
+    };
+
+    // Per-carrier data
+    Agent<TSeq> * agent = nullptr;
+
+    EPI_TYPENAME_TRAITS(TSeq, int) baseline_sequence = 
+        EPI_TYPENAME_TRAITS(TSeq, int)(); 
+
+    int date = -99;
+    int id   = -99;
+
+    std::shared_ptr< Strain > strain = std::make_shared< Strain >();
+    Strain & strain_mut(); ///< Strain to modify (detached if shared).
+        
+public:
+
+    #ifdef EPI_DEBUG_VIRUS
+    static std::atomic<int> counter_construct;          // Default and parameterized constructors
+    static std::atomic<int> counter_copy_construct;     // Copy constructor
+    static std::atomic<int> counter_move_construct;     // Move constructor
+    static std::atomic<int> counter_copy_assign;        // Copy assignment
+    static std::atomic<int> counter_move_assign;        // Move assignment
+    static std::atomic<int> counter_destruct;           // Destructor
+    #endif
+
+    Virus();
+
+    Virus(std::string name = "unknown virus");
+    
+    Virus(
+        std::string name,
+        epiworld_double prevalence,
+        bool as_proportion
+    );
+    
+    #ifdef EPI_DEBUG_VIRUS
+    
+    // Copy and move operations for debugging
+    Virus(const Virus<TSeq>& other);                    // Copy constructor
+    Virus(Virus<TSeq>&& other) noexcept;                // Move constructor
+    Virus<TSeq>& operator=(const Virus<TSeq>& other);   // Copy assignment
+    Virus<TSeq>& operator=(Virus<TSeq>&& other) noexcept; // Move assignment
+
+    ~Virus();
+    #endif
+    
+    void mutate(Model<TSeq> * model);
+    void set_mutation(MutFun<TSeq> fun);
+    
+    EPI_TYPENAME_TRAITS(TSeq, int) get_sequence();
+    void set_sequence(TSeq sequence);
+    
+    Agent<TSeq> * get_agent();
+    void set_agent(Agent<TSeq> * p);
+    
+    void set_date(int d);
+    int get_date() const;
+
+    void set_id(int idx);
+    int get_id() const;
+
+    /**
+     * @name Get and set the tool functions
+     * 
+     * @param v The virus over which to operate
+     * @param fun the function to be used
+     * 
+     * @return epiworld_double 
+     */
+    ///@{
+    epiworld_double get_prob_infecting(Model<TSeq> * model);
+    epiworld_double get_prob_recovery(Model<TSeq> * model);
+    epiworld_double get_prob_death(Model<TSeq> * model);
+    epiworld_double get_incubation(Model<TSeq> * model);
+    
+    void post_recovery(Model<TSeq> * model);
+    void set_post_recovery(PostRecoveryFun<TSeq> fun);
+    void set_post_immunity(epiworld_double prob);
+    void set_post_immunity(std::string param);
+
+    void set_prob_infecting_fun(VirusFun<TSeq> fun);
+    void set_prob_recovery_fun(VirusFun<TSeq> fun);
+    void set_prob_death_fun(VirusFun<TSeq> fun);
+    void set_incubation_fun(VirusFun<TSeq> fun);
+    
+    void set_prob_infecting(std::string param);
+    void set_prob_recovery(std::string param);
+    void set_prob_death(std::string param);
+    void set_incubation(std::string param);
+
+    // Deleting pointer versions to avoid mistakes
+    void set_prob_infecting(epiworld_double * prob) = delete;
+    void set_prob_recovery(epiworld_double * prob) = delete;
+    void set_prob_death(epiworld_double * prob) = delete;
+    void set_incubation(epiworld_double * prob) = delete;
+    void set_post_immunity(epiworld_double * prob) = delete;
+    
+    void set_prob_infecting(epiworld_double prob);
+    void set_prob_recovery(epiworld_double prob);
+    void set_prob_death(epiworld_double prob);
+    void set_incubation(epiworld_double prob);
+    ///@}
+
+
+    void set_name(std::string name);
+    std::string get_name() const;
+
+    /**
+     * @name Get and set the state and queue
+     * 
+     * After applied, viruses can change the state and affect
+     * the queue of agents. These function sets the default values,
+     * which are retrieved when adding or removing a virus does not
+     * specify a change in state or in queue.
+     * 
+     * @param init After the virus/tool is added to the agent.
+     * @param end After the virus/tool is removed.
+     * @param removed After the agent (Agent) is removed.
+     */
+    ///@{
+    void set_state(
+        epiworld_fast_int init,
+        epiworld_fast_int end,
+        epiworld_fast_int removed = -99
+        );
+        
+    void set_queue(
+        epiworld_fast_int init,
+        epiworld_fast_int end,
+        epiworld_fast_int removed = -99
+        );
+
+    void get_state(
+        epiworld_fast_int * init,
+        epiworld_fast_int * end,
+        epiworld_fast_int * removed = nullptr
+        ) const;
+
+    void get_queue(
+        epiworld_fast_int * init,
+        epiworld_fast_int * end,
+        epiworld_fast_int * removed = nullptr
+        ) const;
+    ///@}
+
+    bool operator==(const Virus<TSeq> & other) const;
+    bool operator!=(const Virus<TSeq> & other) const {return !operator==(other);};
+
+    void print() const;
+
+    /**
+     * @brief Get information about the prevalence of the virus
+     */
+    ///@{
+    void distribute(Model<TSeq> * model);
+    void set_distribution(VirusToAgentFun<TSeq> fun);
+    ///@}
+
+    virtual ~Virus() = default;
+    virtual std::unique_ptr<Virus<TSeq>> clone_ptr() const;
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/virus-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/viruses-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_VIRUSES_BONES_HPP
+#define EPIWORLD_VIRUSES_BONES_HPP
+
+template<typename TSeq>
+class Virus;
+
+template<typename TSeq>
+class Agent;
+
+/**
+ * @brief Set of viruses (useful for building iterators)
+ * 
+ * @tparam TSeq 
+ */
+template<typename TSeq>
+class Viruses {
+    friend class Virus<TSeq>;
+    friend class Agent<TSeq>;
+private:
+    std::vector< VirusPtr<TSeq> > * dat;
+    const epiworld_fast_uint * n_viruses;
+
+public:
+
+    Viruses() = delete;
+    Viruses(Agent<TSeq> & p) : dat(&p.viruses), n_viruses(&p.n_viruses) {};
+
+    typename std::vector< VirusPtr<TSeq> >::iterator begin();
+    typename std::vector< VirusPtr<TSeq> >::iterator end();
+
+    VirusPtr<TSeq> & operator()(size_t i);
+    VirusPtr<TSeq> & operator[](size_t i);
+
+    size_t size() const noexcept;
+
+    void print() const noexcept;
+
+};
+
+template<typename TSeq>
+inline typename std::vector< VirusPtr<TSeq> >::iterator Viruses<TSeq>::begin()
+{
+
+    if (*n_viruses == 0u)
+        return dat->end();
+    
+    return dat->begin();
+}
+
+template<typename TSeq>
+inline typename std::vector< VirusPtr<TSeq> >::iterator Viruses<TSeq>::end()
+{
+    
+    #ifdef EPI_DEBUG
+    if (dat->size() < *n_viruses)
+        throw EPI_DEBUG_ERROR(std::logic_error, "Viruses:: The end of the virus is out of range");
+    #endif 
+
+    return begin() + *n_viruses;
+}
+
+template<typename TSeq>
+inline VirusPtr<TSeq> & Viruses<TSeq>::operator()(size_t i)
+{
+
+    if (i >= *n_viruses)
+        throw std::range_error("Virus index out of range.");
+
+    return dat->operator[](i);
+
+}
+
+template<typename TSeq>
+inline VirusPtr<TSeq> & Viruses<TSeq>::operator[](size_t i)
+{
+
+    return dat->operator[](i);
+
+}
+
+template<typename TSeq>
+inline size_t Viruses<TSeq>::size() const noexcept 
+{
+    return *n_viruses;
+}
+
+template<typename TSeq>
+inline void Viruses<TSeq>::print() const noexcept
+{
+
+    if (*n_viruses == 0u)
+    {
+        printf_epiworld("List of viruses (none)\n");
+        return;
+    }
+
+    printf_epiworld("List of viruses (%i): ", *n_viruses);
+
+    // Printing the name of each virus separated by a comma
+    for (size_t i = 0u; i < *n_viruses; ++i)
+    {
+        if (i == *n_viruses - 1u)
+        {
+            printf_epiworld("%s", dat->operator[](i)->get_name().c_str());
+        } else 
+        {
+            printf_epiworld("%s, ", dat->operator[](i)->get_name().c_str());
+        }
+    }
+    
+    printf_epiworld("\n");
+
+}
+
+/**
+ * @brief Set of Viruses (const) (useful for iterators)
+ * 
+ * @tparam TSeq 
+ */
+template<typename TSeq>
+class Viruses_const {
+    friend class Virus<TSeq>;
+    friend class Agent<TSeq>;
+private:
+    const std::vector< VirusPtr<TSeq> > * dat;
+    const epiworld_fast_uint * n_viruses;
+
+public:
+
+    Viruses_const() = delete;
+    Viruses_const(const Agent<TSeq> & p) : dat(&p.viruses), n_viruses(&p.n_viruses) {};
+
+    typename std::vector< VirusPtr<TSeq> >::const_iterator begin() const;
+    typename std::vector< VirusPtr<TSeq> >::const_iterator end() const;
+
+    const VirusPtr<TSeq> & operator()(size_t i);
+    const VirusPtr<TSeq> & operator[](size_t i);
+
+    size_t size() const noexcept;
+
+    void print() const noexcept;
+
+};
+
+template<typename TSeq>
+inline typename std::vector< VirusPtr<TSeq> >::const_iterator Viruses_const<TSeq>::begin() const {
+
+    if (*n_viruses == 0u)
+        return dat->end();
+    
+    return dat->begin();
+}
+
+template<typename TSeq>
+inline typename std::vector< VirusPtr<TSeq> >::const_iterator Viruses_const<TSeq>::end() const {
+
+    #ifdef EPI_DEBUG
+    if (dat->size() < *n_viruses)
+        throw EPI_DEBUG_ERROR(std::logic_error, "Viruses_const:: The end of the virus is out of range");
+    #endif 
+    return begin() + *n_viruses;
+}
+
+template<typename TSeq>
+inline const VirusPtr<TSeq> & Viruses_const<TSeq>::operator()(size_t i)
+{
+
+    if (i >= *n_viruses)
+        throw std::range_error("Virus index out of range.");
+
+    return dat->operator[](i);
+
+}
+
+template<typename TSeq>
+inline const VirusPtr<TSeq> & Viruses_const<TSeq>::operator[](size_t i)
+{
+
+    return dat->operator[](i);
+
+}
+
+template<typename TSeq>
+inline size_t Viruses_const<TSeq>::size() const noexcept 
+{
+    return *n_viruses;
+}
+
+template<typename TSeq>
+inline void Viruses_const<TSeq>::print() const noexcept
+{
+
+    if (*n_viruses == 0u)
+    {
+        printf_epiworld("List of viruses (none)\n");
+        return;
+    }
+
+    printf_epiworld("List of viruses (%i): ", *n_viruses);
+
+    // Printing the name of each virus separated by a comma
+    for (size_t i = 0u; i < *n_viruses; ++i)
+    {
+        if (i == *n_viruses - 1u)
+        {
+            printf_epiworld("%s", dat->operator[](i)->get_name().c_str());
+        } else
+        {
+            printf_epiworld("%s, ", dat->operator[](i)->get_name().c_str());
+        }
+    }
+    
+    printf_epiworld("\n");
+
+}
+
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/viruses-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/tool-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_TOOL_BONES_HPP
+#define EPIWORLD_TOOL_BONES_HPP
+
+template<typename TSeq>
+class Virus;
+
+template<typename TSeq>
+class Agent;
+
+template<typename TSeq>
+class Model;
+
+template<typename TSeq>
+class Tool;
+
+/**
+ * @brief Tools for defending the agent against the virus
+ * 
+ * @tparam TSeq Type of sequence
+ */
+template<typename TSeq> 
+class Tool {
+    friend class Agent<TSeq>;
+    friend class Model<TSeq>;
+protected:
+
+    /**
+     * @brief Fields shared by the copies of a tool
+     * @details Every agent holding the tool gets its own copy, but the name,
+     * functions, states, and queues are the same across them, so copies
+     * share a single `Definition`. Setters detach it first (copy-on-write).
+     */
+    struct Definition {
+
+        std::string tool_name;
+
+        ToolFun<TSeq> susceptibility_reduction = nullptr;
+        ToolFun<TSeq> transmission_reduction   = nullptr;
+        ToolFun<TSeq> recovery_enhancer        = nullptr;
+        ToolFun<TSeq> death_reduction          = nullptr;
+
+        ToolToAgentFun<TSeq> dist = nullptr;
+
+        epiworld_fast_int state_init = -99;
+        epiworld_fast_int state_post = -99;
+
+        epiworld_fast_int queue_init = Queue<TSeq>::NoOne; ///< Change of state when added to agent.
+        epiworld_fast_int queue_post = Queue<TSeq>::NoOne; ///< Change of state when removed from agent.
+
+        /**
+         * @brief Effects known to be constant
+         * @details Bit `k` of `fixed_mask` is on when the k-th effect
+         * (susceptibility, transmission, recovery, death) does not depend on
+         * the virus or the day, in which case its value is `fixed_value[k]`.
+         * Agents use these to cache the product of their tools' effects (see
+         * `Agent<TSeq>::tools_effects_update()`).
+         */
+        ///@{
+        unsigned char fixed_mask = 0x0Fu;
+        epiworld_double fixed_value[4u] = {
+            DEFAULT_TOOL_CONTAGION_REDUCTION,
+            DEFAULT_TOOL_TRANSMISSION_REDUCTION,
+            DEFAULT_TOOL_RECOVERY_ENHANCER,
+            DEFAULT_TOOL_DEATH_REDUCTION
+        };
+        ///@}
+
+    };
+
+    // Per-agent data
+    Agent<TSeq> * agent = nullptr;
+    int pos_in_agent        = -99; ///< Location in the agent
+
+    int date = -99;
+    int id   = -99;
+    
+    EPI_TYPENAME_TRAITS(TSeq, int) sequence = 
+        EPI_TYPENAME_TRAITS(TSeq, int)(); ///< Sequence of the tool
+
+    std::shared_ptr< Definition > def = std::make_shared< Definition >();
+    Definition & def_mut(); ///< Definition to modify (detached if shared).
+    void set_fixed_effect(size_t k, bool fixed, epiworld_double value);
+
+    void set_agent(Agent<TSeq> * p, size_t idx);
+
+public:
+    Tool();
+    Tool(std::string name = "unknown tool");
+    Tool(
+        std::string name,
+        epiworld_double prevalence,
+        bool as_proportion
+    );
+
+    virtual ~Tool() = default;
+
+    void set_sequence(TSeq d);
+    void set_sequence(std::shared_ptr<TSeq> d);
+    EPI_TYPENAME_TRAITS(TSeq, int) get_sequence();
+
+    /**
+     * @name Get and set the tool functions
+     * 
+     * @param v The virus over which to operate
+     * @param fun the function to be used
+     * 
+     * @return epiworld_double 
+     */
+    ///@{
+    virtual epiworld_double get_susceptibility_reduction(VirusPtr<TSeq> & v, Model<TSeq> * model);
+    virtual epiworld_double get_transmission_reduction(VirusPtr<TSeq> & v, Model<TSeq> * model);
+    virtual epiworld_double get_recovery_enhancer(VirusPtr<TSeq> & v, Model<TSeq> * model);
+    virtual epiworld_double get_death_reduction(VirusPtr<TSeq> & v, Model<TSeq> * model);
+    
+    virtual void set_susceptibility_reduction_fun(ToolFun<TSeq> fun);
+    virtual void set_transmission_reduction_fun(ToolFun<TSeq> fun);
+    virtual void set_recovery_enhancer_fun(ToolFun<TSeq> fun);
+    virtual void set_death_reduction_fun(ToolFun<TSeq> fun);
+
+    virtual void set_susceptibility_reduction(std::string param);
+    virtual void set_transmission_reduction(std::string param);
+    virtual void set_recovery_enhancer(std::string param);
+    virtual void set_death_reduction(std::string param);
+
+    // Deleting pointer versions to avoid mistakes
+    virtual void set_susceptibility_reduction(epiworld_double * prob) = delete;
+    virtual void set_transmission_reduction(epiworld_double * prob) = delete;
+    virtual void set_recovery_enhancer(epiworld_double * prob) = delete;
+    virtual void set_death_reduction(epiworld_double * prob) = delete;
+
+    virtual void set_susceptibility_reduction(epiworld_double prob);
+    virtual void set_transmission_reduction(epiworld_double prob);
+    virtual void set_recovery_enhancer(epiworld_double prob);
+    virtual void set_death_reduction(epiworld_double prob);
+    ///@}
+
+    void set_name(std::string name);
+    virtual std::string get_name() const;
+
+    Agent<TSeq> * get_agent();
+    int get_id() const;
+    void set_id(int id);
+    void set_date(int d);
+    int get_date() const;
+
+    void set_state(epiworld_fast_int init, epiworld_fast_int post);
+    void set_queue(epiworld_fast_int init, epiworld_fast_int post);
+    void get_state(epiworld_fast_int * init, epiworld_fast_int * post);
+    void get_queue(epiworld_fast_int * init, epiworld_fast_int * post);
+
+    bool operator==(const Tool<TSeq> & other) const;
+    bool operator!=(const Tool<TSeq> & other) const {return !operator==(other);};
+
+    void print() const;
+
+    void distribute(Model<TSeq> * model);
+    void set_distribution(ToolToAgentFun<TSeq> fun);
+
+    virtual std::unique_ptr<Tool<TSeq>> clone_ptr() const; 
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/tool-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+// (already included include/epiworld/database-bones.hpp)
+// (already included include/epiworld/queue-bones.hpp)
+// (already included include/epiworld/globalevent-bones.hpp)
+// (already included include/epiworld/contacttracing-bones.hpp)
+// (already included include/epiworld/profiler-bones.hpp)
+// (already included include/epiworld/memoryusage-bones.hpp)
+
+template<typename TSeq>
+class AgentsSample;
+
+class AdjList;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline std::function<void(size_t,Model<TSeq>*)> make_save_run(
+    std::string fmt = "%03lu-episimulation.csv",
+    bool total_hist = true,
+    bool virus_info = false,
+    bool virus_hist = false,
+    bool tool_info = false,
+    bool tool_hist = false,
+    bool transmission = false,
+    bool transition = false,
+    bool reproductive = false,
+    bool generation = false,
+    bool active_cases = false,
+    bool outbreak_size = false,
+    bool hospitalizations = false
+    );
+
+// template<typename TSeq>
+// class VirusPtr;
+
+// template<typename TSeq>
+// class ToolPtr;
+
+template<typename TSeq>
+inline void default_update_susceptible(Agent<TSeq> * p, Model<TSeq> * m);
+
+/**
+ * @brief Core class of epiworld.
+ *
+ * The model class provides the wrapper that puts together `Agent`, `Virus`, and
+ * `Tools`.
+ *
+ * @tparam TSeq Type of sequence. In principle, users can build models in which
+ * virus and human sequence is represented as numeric vectors (if needed.)
+ */
+template<typename TSeq>
+class Model {
+    friend class Agent<TSeq>;
+    friend class AgentsSample<TSeq>;
+    friend class DataBase<TSeq>;
+    friend class Queue<TSeq>;
+
+protected:
+
+    std::string name = ""; ///< Name of the model
+
+    DataBase<TSeq> db = DataBase<TSeq>(*this);
+
+    std::vector< Agent<TSeq> > population = {};
+
+    /**
+     * @brief State of each agent, stored contiguously (by agent id)
+     * @details A structure-of-arrays copy of `Agent<TSeq>::state`, so
+     * whole-population scans (the update sweeps, the state filters of
+     * `AgentsSample`, and `get_agents_states()`) read one array instead
+     * of loading every `Agent`. It is written together with the agents'
+     * states in `events_run()`, `reset()`, and `agents_empty_graph()`.
+     */
+    std::vector< unsigned int > agents_state = {};
+
+    bool using_backup = true;
+
+    /**
+     * @name Contact network
+     *
+     * @details The network (see `Network`) is shared between copies of
+     * the model (e.g., the thread clones in `run_multiple()`) and the
+     * backup. It is only copied when modified through
+     * `get_network_mutable()` while being shared (copy-on-write), so
+     * read-only topologies are stored once regardless of the number of
+     * threads.
+     */
+    ///@{
+    std::shared_ptr< Network > network = std::make_shared< Network >();
+    std::shared_ptr< Network > network_backup = nullptr; ///< Set by `set_backup()`.
+    Network & get_network_mutable();
+    ///@}
+
+    /**
+     * @name Auxiliary variables for AgentsSample<TSeq> iterators
+     *
+     * @details These variables+objects are used by the AgentsSample<TSeq>
+     * class for building efficient iterators over agents. The idea is to
+     * reduce the memory allocation, so only during the first call of
+     * AgentsSample<TSeq>::AgentsSample(Model<TSeq>) these vectors are allocated.
+     */
+    ///@{
+    std::vector< Agent<TSeq> * > sampled_population;
+    size_t sampled_population_n = 0u;
+    std::vector< size_t > population_left;
+    size_t population_left_n = 0u;
+    ///@}
+
+    /**
+     * @name Agents features
+     *
+     * @details Optionally, a model can include an external data source
+     * pointing to agents information. The data can then be access through
+     * the `Agent::operator()` method.
+     *
+     */
+    ///@{
+    double * agents_data = nullptr;
+    size_t agents_data_ncols = 0u;
+    ///@}
+
+    bool directed = false;
+
+    std::vector< VirusPtr<TSeq> > viruses = {};
+    std::vector< ToolPtr<TSeq> > tools = {};
+
+    std::vector< Entity<TSeq> > entities = {};
+
+    std::shared_ptr< epi_xoshiro256ss > engine = std::make_shared< epi_xoshiro256ss >();
+    uint64_t rng_seed = 0u; ///< Last value passed to `seed()` (keys the per-agent streams).
+
+    /**
+     * @name Batched uniforms
+     * @details See `runif_batch_on()`.
+     */
+    ///@{
+    bool use_runif_batch = false;
+    epi_xoshiro256ss_lanes< EPI_RUNIF_LANES > engine_batch;
+    std::vector< epiworld_double > runif_buffer = {};
+    size_t runif_buffer_pos = 0u;
+    static constexpr size_t runif_batch_blocks = 64u; ///< Blocks per refill.
+    epiworld_double runif_next(); ///< Next uniform (from the buffer, if on).
+    ///@}
+
+    epiworld_double runifd_a = 0.0;
+    epiworld_double runifd_b = 1.0;
+    std::normal_distribution<>       rnormd      =
+        std::normal_distribution<>(0.0);
+    std::gamma_distribution<>        rgammad     =
+        std::gamma_distribution<>();
+    std::lognormal_distribution<>    rlognormald =
+        std::lognormal_distribution<>();
+    std::exponential_distribution<>  rexpd       =
+        std::exponential_distribution<>();
+    std::binomial_distribution<> rbinomd         =
+        std::binomial_distribution<>();
+    int rbinomd_n = 1;
+    epiworld_double rbinomd_fast_lambda = 0.0;
+    bool rbinomd_use_poisson = false;
+    std::negative_binomial_distribution<> rnbinomd =
+        std::negative_binomial_distribution<>();
+    std::geometric_distribution<> rgeomd          =
+        std::geometric_distribution<>();
+    std::poisson_distribution<> rpoissd           =
+        std::poisson_distribution<>();
+
+    std::function<void(std::vector<Agent<TSeq>>*,Model<TSeq>*,epiworld_double)> rewire_fun;
+    epiworld_double rewire_prop = 0.0;
+
+    std::map<std::string, epiworld_double > parameters;
+    std::vector< const epiworld_double * > parameters_ptrs = {}; ///< Indexed by `param_id()`.
+    void parameters_ptrs_update();
+    epiworld_fast_uint ndays = 0;
+    Progress pb;
+
+    std::vector< UpdateFun<TSeq> >    state_fun = {};                  ///< Functions to update states
+    std::vector< std::string >        states_labels = {};              ///< Labels of the states
+
+    /** Function to distribute states. Goes along with the function  */
+    std::function<void(Model<TSeq>*)> initial_states_fun = [](Model<TSeq> * /**/)
+    -> void {};
+
+    epiworld_fast_uint nstates = 0u;
+
+    bool verbose     = true;
+    int current_date = 0;
+
+    void dist_tools();
+    void dist_virus();
+    void dist_entities();
+
+    std::chrono::time_point<std::chrono::steady_clock> time_start;
+    std::chrono::time_point<std::chrono::steady_clock> time_end;
+
+    // std::chrono::milliseconds
+    std::chrono::duration<epiworld_double,std::micro> time_elapsed =
+        std::chrono::duration<epiworld_double,std::micro>::zero();
+    epiworld_fast_uint n_replicates = 0u;
+    int last_seed = 0;
+    void chrono_start();
+    void chrono_end();
+
+    Profiler profile;       ///< Last run (reset by `chrono_start()`).
+    Profiler profile_total; ///< All the runs (added by `chrono_end()`).
+
+    std::vector<GlobalEventPtr<TSeq>> globalevents;
+
+    Queue<TSeq> queue;
+    bool use_queuing   = true;
+    size_t sim_id = 0u;
+    void set_sim_id(size_t id);
+
+    /**
+     * @brief Checks the model and prepares day 0 (shared by `run()` and
+     * `run_continuous()`).
+     */
+    void run_setup(epiworld_fast_uint ndays, int seed);
+
+    /**
+     * @brief Runs `ndays` days from the current date (the loop of `run()`,
+     * also used by `resume()`).
+     */
+    void run_days(epiworld_fast_uint ndays);
+
+    /**
+     * @name Aggregated runs
+     * @details Helpers for models that can run on counts instead of
+     * agents (e.g., `ModelSIRMixing::aggregated_on()`). Since there are no
+     * agents to count, `aggregated_setup()` sets the database to the given
+     * totals (and records day 0), `aggregated_move()` records `n`
+     * transitions at once, and `aggregated_end()` closes the run as
+     * `run()` does. States flagged in `with_virus` count towards the first
+     * virus.
+     *
+     * Models turn the mode on with `aggregated_enable()`, which keeps the
+     * group sizes and releases the agents, and implement
+     * `run_aggregated()`, which `run()` calls after seeding the model.
+     * `aggregated_split()` spreads `n` cases across groups in proportion
+     * to their size, and `aggregated_escape()` is the probability that a
+     * susceptible in group `i` escapes infection from the infected `I`
+     * (by group) in a day.
+     */
+    ///@{
+    bool aggregated = false;
+    std::vector< size_t > aggregated_sizes = {};
+    std::vector< bool > aggregated_with_virus = {};
+    void aggregated_enable(std::vector< size_t > group_sizes);
+    void aggregated_disable();
+    virtual Model<TSeq> & run_aggregated(epiworld_fast_uint ndays);
+    std::vector< int > aggregated_split(epiworld_double prevalence);
+    epiworld_double aggregated_escape(
+        const ContactMatrix & contact_matrix,
+        size_t i,
+        const std::vector< int > & I,
+        epiworld_double p_transmit
+    ) const;
+    void aggregated_setup(
+        epiworld_fast_uint ndays,
+        const std::vector< int > & totals,
+        const std::vector< bool > & with_virus
+    );
+    void aggregated_move(epiworld_fast_uint from, epiworld_fast_uint to, int n);
+    void aggregated_end();
+    ///@}
+
+    std::unique_ptr<ContactTracing> contact_tracing;
+    bool use_contact_tracing = false;
+    size_t contact_tracing_max_contacts = EPI_MAX_TRACKING;
+
+    /**
+     * @brief Variables used to keep track of the events
+     * to be made regarding viruses.
+     */
+    EventBuffer<TSeq> events;
+    bool events_by_agent = false; ///< Apply the events in agent order.
+
+    /**
+     * @name Fast-forward
+     * @details See `fast_forward_on()`.
+     */
+    ///@{
+    bool fast_forward = false;
+    std::function<bool(Model<TSeq>*)> absorbing_fun = nullptr;
+    ///@}
+
+    /**
+     * @name Parallel update
+     * @details When on, `update_state()` splits the agents across threads.
+     * Events are collected in per-thread buffers (`events_threads`) and
+     * merged in agent order before calling `events_run()`. Each agent
+     * draws from its own counter-based stream (`engines_threads` are keyed
+     * by seed and simulation id, and positioned at the agent and day), so
+     * results do not depend on the number of threads.
+     */
+    ///@{
+    bool use_parallel_update = false;
+    int parallel_update_nthreads = 1;
+    bool in_parallel_update = false; ///< True while inside the parallel region.
+    std::vector< std::vector< Event<TSeq> > > events_threads = {};
+    std::vector< epi_philox4x32 > engines_threads = {};
+    void update_state_parallel();
+    epi_philox4x32 & rng_engine_thread(); ///< Engine of the current thread.
+    uint64_t rng_next(); ///< Next 64 random bits (from the thread's engine, if any).
+
+    /**
+     * @brief Draws from a (possibly stateful) distribution.
+     * @details Within a parallel update, a fresh distribution with the same
+     * parameters is used so cached values are not shared across threads.
+     */
+    template<typename TDist, typename... TArgs>
+    typename TDist::result_type rand_draw(TDist & dist, TArgs... args);
+    ///@}
+
+    /**
+     * @name Statically dispatched update
+     * @details Built-in models override `update_state_static()` to run
+     * their states through `update_state_table()`, which calls the update
+     * functions directly (not through `std::function`), so the compiler can
+     * inline them. The table is only used while `state_fun` still holds
+     * the model's own functions (see `state_fun_is()`); user-defined
+     * functions, extra states, and the parallel update go through
+     * `state_fun`.
+     */
+    ///@{
+    virtual bool update_state_static(); ///< Returns false if not available.
+
+    template<UpdateFunPtr<TSeq>... Funs>
+    bool update_state_table();
+
+    template<size_t I, UpdateFunPtr<TSeq> Fun, UpdateFunPtr<TSeq>... Funs>
+    void update_state_dispatch(Agent<TSeq> & p);
+
+    bool state_fun_is(epiworld_fast_uint state, UpdateFunPtr<TSeq> fun) const;
+    ///@}
+
+    /**
+     * @name Members of derived models in checkpoints
+     * @details `write_checkpoint()` ends by calling
+     * `write_checkpoint_derived()`, and `read_checkpoint()` calls
+     * `read_checkpoint_derived()` once the agents, viruses, and tools are
+     * restored. Built-in models write the per-agent data kept by their
+     * update functions (e.g., quarantine days) and rebuild the lists they
+     * derive from the agents' states (e.g., infected agents by group).
+     * The default writes and reads nothing.
+     */
+    ///@{
+    virtual void write_checkpoint_derived(std::ostream & out) const;
+    virtual void read_checkpoint_derived(std::istream & in);
+    void read_checkpoint_derived_keep_rng(std::istream & in); ///< Keeps the binomial distribution.
+    ///@}
+
+    /**
+     * @brief Runs jobs `0, ..., njobs - 1` (see `run_multiple()`)
+     * @details With OpenMP, each thread works on its own copy of the
+     * model (the calling thread on this one) and takes the next free job,
+     * so threads stay busy when runtimes vary. `job(i, model)` runs job
+     * `i`, and `fun(i, model)` (if any) is then called one thread at a
+     * time. If a copy ran the last job, its state is copied into this
+     * model at the end (with the members of derived models, see
+     * `write_checkpoint_derived()`), so the model always ends as the last
+     * job left it. Without OpenMP, the jobs run in order on this model.
+     * @return The number of jobs run by this model.
+     */
+    size_t run_jobs(
+        size_t njobs,
+        int nthreads,
+        std::function<void(size_t,Model<TSeq>*)> job,
+        std::function<void(size_t,Model<TSeq>*)> fun,
+        Progress & pb,
+        bool verbose
+    );
+
+    /**
+     * @brief Construct a new Event object
+     *
+     * @param agent_ Agent over which the action will be called
+     * @param virus_ Virus pointer included in the action
+     * @param tool_ Tool pointer included in the action
+     * @param entity_ Entity pointer included in the action
+     * @param new_state_ New state of the agent
+     * @param queue_ Change in the queue
+      * @param action_ Action to execute when processing the event
+     */
+    void _add_event(
+        Agent<TSeq> * agent_,
+        VirusPtr<TSeq> virus_,
+        ToolPtr<TSeq> tool_,
+        Entity<TSeq> * entity_,
+        epiworld_fast_int new_state_,
+        epiworld_fast_int queue_,
+          EventAction action_
+        );
+
+    /**
+     * @name Default event handlers
+     *
+     * These member functions implement the default behavior for each
+     * event action (add/remove virus, tool, entity, or change state).
+     */
+    ///@{
+    void _event_add_virus(Event<TSeq> & a);
+    void _event_add_tool(Event<TSeq> & a);
+    void _event_add_entity(Event<TSeq> & a);
+    void _event_rm_virus(Event<TSeq> & a);
+    void _event_rm_tool(Event<TSeq> & a);
+    void _event_rm_entity(Event<TSeq> & a);
+    void _event_change_state(Event<TSeq> & a);
+    ///@}
+
+    /**
+     * @name Tool Mixers
+     *
+     * These functions combine the effects tools have to deliver
+     * a single effect. For example, wearing a mask, been vaccinated,
+     * and the immune system combine together to jointly reduce
+     * the susceptibility for a given virus.
+     *
+     */
+    virtual epiworld_double susceptibility_reduction_mixer(
+        Agent<TSeq> * agent, VirusPtr<TSeq> & virus
+    );
+    virtual epiworld_double transmission_reduction_mixer(
+        Agent<TSeq> * agent, VirusPtr<TSeq> & virus
+    );
+    virtual epiworld_double recovery_enhancer_mixer(
+        Agent<TSeq> * agent, VirusPtr<TSeq> & virus
+    );
+    virtual epiworld_double death_reduction_mixer(
+        Agent<TSeq> * agent, VirusPtr<TSeq> & virus
+    );
+
+    /**
+     * @brief Advanced usage: Makes a copy of data and returns it as undeleted pointer
+     *
+     * @param copy
+     */
+    virtual std::unique_ptr<Model<TSeq>> clone_ptr();
+
+public:
+
+    ThreadArray<epiworld_double, 1024u * 2u> array_double_tmp;
+    ThreadArray<Virus<TSeq> *, 1024u * 2u> array_virus_tmp;
+
+    Model();
+    Model(const Model<TSeq> & m);
+    Model(Model<TSeq> && m);
+    Model<TSeq> & operator=(const Model<TSeq> & m);
+
+    virtual ~Model() {};
+
+    /**
+     * @name Set the backup object
+     * @details `backup` can be used to restore the network
+     * after a run. This can be useful if the user wishes to have
+     * individuals start with the same network from the beginning
+     * (e.g., when the network is rewired during the simulation). The
+     * rest of the agents' state is always restored by `reset()`.
+     *
+     */
+    ///@{
+    void set_backup();
+    // void restore_backup();
+    ///@}
+
+    DataBase<TSeq> & get_db();
+    const DataBase<TSeq> & get_db() const;
+    epiworld_double operator()(std::string pname);
+
+    size_t size() const;
+
+    /**
+     * @name Random number generation
+     *
+     * @param eng Random number generator
+     * @param s Seed
+     */
+    ///@{
+    void set_rand_engine(std::shared_ptr< epi_xoshiro256ss > & eng);
+    std::shared_ptr< epi_xoshiro256ss > & get_rand_endgine();
+    void seed(size_t s);
+    void set_rand_norm(epiworld_double mean, epiworld_double sd);
+    void set_rand_unif(epiworld_double a, epiworld_double b);
+    void set_rand_exp(epiworld_double lambda);
+    void set_rand_gamma(epiworld_double alpha, epiworld_double beta);
+    void set_rand_lognormal(epiworld_double mean, epiworld_double shape);
+    void set_rand_binom(int n, epiworld_double p);
+    void set_rand_nbinom(int n, epiworld_double p);
+    void set_rand_geom(epiworld_double p);
+    void set_rand_poiss(epiworld_double lambda);
+    epiworld_double rnorm();
+    epiworld_double rnorm(epiworld_double mean, epiworld_double sd);
+    epiworld_double rgamma();
+    epiworld_double rgamma(epiworld_double alpha, epiworld_double beta);
+    epiworld_double rexp();
+    epiworld_double rexp(epiworld_double lambda);
+    epiworld_double rlognormal();
+    epiworld_double rlognormal(epiworld_double mean, epiworld_double shape);
+
+    /**
+     * @brief Draw from the currently configured uniform distribution.
+     * @return A random draw from the configured uniform distribution.
+     * @details
+     * These uniform draws make use of Lemire's algorithm for fast
+     * uniform integer generation, which is both faster and more accurate than
+     * the common `std::uniform_int_distribution` approach.
+     * 
+     * 
+     * Lemire, D. (2019). Fast Random Integer Generation in an Interval.
+     * ACM Trans. Model. Comput. Simul., 29(1), 3:1-3:12.
+     * <https://doi.org/10.1145/3230636>
+     */
+    epiworld_double runif();
+    epiworld_double runif(epiworld_double a, epiworld_double b);
+    int runif_int(int a, int b);
+    uint32_t runif_index(uint32_t n);
+    /**
+     * @brief Draw from the currently configured binomial distribution.
+     * @details When `EPI_FAST_BINOM` is enabled (default), this uses
+     * `rpoiss(lambda)` with `lambda = n * p` after `set_rand_binom(n, p)` in the
+     * rare-event regime `p <= 0.01` and `n * p * p <= 0.1`. Define
+     * `EPI_NO_FAST_BINOM` before including epiworld to disable this behavior.
+     * @return A random draw from the configured binomial distribution, or from
+     * its Poisson approximation when the fast path is active.
+     */
+    int rbinom();
+    /**
+     * @brief Draw from a binomial distribution with parameters `n` and `p`.
+     * @details When `EPI_FAST_BINOM` is enabled (default), this uses
+     * `rpoiss(lambda)` with `lambda = n * p` in the rare-event regime
+     * `p <= 0.01` and `n * p * p <= 0.1`. This preserves the mean and is often
+     * substantially faster in practice while remaining very accurate in that
+     * region. Define `EPI_NO_FAST_BINOM` before including epiworld to disable
+     * this behavior and force the exact binomial draw.
+     * @param n Number of trials.
+     * @param p Success probability.
+     * @return A random draw from the binomial distribution, or from its
+     * Poisson approximation when the fast path is active.
+     */
+    int rbinom(int n, epiworld_double p);
+    int rnbinom();
+    int rnbinom(int n, epiworld_double p);
+    int rgeom();
+    int rgeom(epiworld_double p);
+    int rpoiss();
+    int rpoiss(epiworld_double lambda);
+    ///@}
+
+    /**
+     * @brief Sample from a set of probabilities stored in array_double_tmp.
+     * @details Uses a cumulative probability approach: draws a uniform random
+     * number and walks through array_double_tmp[0..n-1], accumulating
+     * probabilities until the draw is exceeded. If no event fires, returns n
+     * (meaning "none of the above").
+     * @param n Number of probability entries in array_double_tmp to consider.
+     * @return Index in [0, n] of the sampled event (n = no event).
+     */
+    size_t sample_from_probs(size_t n);
+
+    /**
+     * @name Add Virus/Tool to the model
+     *
+     * This is done before the model has been initialized.
+     *
+     * @param v Virus to be added
+     * @param t Tool to be added
+     * @param preval Initial prevalence (initial state.) It can be
+     * specified as a proportion (between zero and one,) or an integer
+     * indicating number of individuals.
+     */
+    ///@{
+    void add_virus(Virus<TSeq> & v);
+    void add_tool(Tool<TSeq> & t);
+    void add_entity(Entity<TSeq> e);
+    void rm_virus(size_t virus_pos);
+    void rm_tool(size_t tool_pos);
+    void rm_entity(size_t entity_id);
+    ///@}
+
+    /**
+     * @brief Associate agents-entities from a file
+     *
+     * The structure of the file should be two columns separated by
+     * space. The first column indexing between 0 and nagents-1, and the
+     * second column between 0 and nentities - 1.
+     *
+     * @param fn Path to the file.
+     * @param skip How many rows to skip.
+     */
+    void load_agents_entities_ties(std::string fn, int skip);
+
+    /**
+     * @brief Associate agents-entities from data
+    */
+    void load_agents_entities_ties(
+        const std::vector<int> & agents_ids,
+        const std::vector<int> & entities_ids
+        );
+
+    void load_agents_entities_ties(
+        const int * agents_id,
+        const int * entities_id,
+        size_t n
+        );
+
+    /**
+     * @name Accessing population of the model
+     *
+     * @param fn std::string Filename of the edgelist file.
+     * @param skip int Number of lines to skip in `fn`.
+     * @param directed bool Whether the graph is directed or not.
+     * @param size Size of the network.
+     * @param al AdjList to read into the model.
+     */
+    ///@{
+    void agents_from_adjlist(
+        std::string fn,
+        int size,
+        int skip = 0,
+        bool directed = false
+        );
+
+    void agents_from_edgelist(
+        const std::vector< int > & source,
+        const std::vector< int > & target,
+        int size,
+        bool directed
+    );
+
+    void agents_from_adjlist(AdjList al);
+
+    bool is_directed() const;
+
+    std::vector< Agent<TSeq> > & get_agents(); ///< Returns a reference to the vector of agents.
+
+    const Network & get_network() const; ///< Returns the contact network.
+
+    Agent<TSeq> & get_agent(size_t i);
+
+    std::vector< epiworld_fast_uint > get_agents_states() const; ///< Returns a vector with the states of the agents.
+
+    std::vector< Viruses_const<TSeq> > get_agents_viruses() const; ///< Returns a const vector with the viruses of the agents.
+
+    std::vector< Viruses<TSeq> > get_agents_viruses(); ///< Returns a vector with the viruses of the agents.
+
+    std::vector< Entity<TSeq> > & get_entities();
+
+    Entity<TSeq> & get_entity(size_t entity_id, int * entity_pos = nullptr);
+    const Entity<TSeq> & get_entity(size_t entity_id, int * entity_pos = nullptr) const;
+
+    Model<TSeq> & agents_smallworld(
+        epiworld_fast_uint n = 1000,
+        epiworld_fast_uint k = 5,
+        bool d = false,
+        epiworld_double p = .01
+        );
+    void agents_empty_graph(epiworld_fast_uint n = 1000);
+
+    /**
+     * @brief Initialize agents using a Stochastic Block Model (SBM).
+     *
+     * Creates agents and connects them according to an SBM defined by
+     * `block_sizes` and `mixing_matrix`.
+     *
+     * @param block_sizes Number of agents per block.
+     * @param mixing_matrix Mixing matrix of size K*K; row sums give average
+     *   expected degree per group.
+     * @param row_major If `true`, matrix is row-major; otherwise column-major.
+     * @return Reference to this Model.
+     *
+     * @see rgraph_sbm
+     */
+    Model<TSeq> & agents_sbm(
+        const std::vector< size_t > & block_sizes,
+        const std::vector< double > & mixing_matrix,
+        bool row_major = true
+        );
+    ///@}
+
+    /**
+     * @name Initialize agents using a Bernoulli random graph
+     * @param n Number of agents.
+     * @param p Probability of tie formation.
+     * @param d Whether the graph is directed or not.
+     * @return Reference to this Model.
+     */
+    Model<TSeq> & agents_bernoulli(
+        epiworld_fast_uint n,
+        epiworld_double p,
+        bool d = false
+    );
+
+    /**
+     * @name Functions to run the model
+     *
+     * @param seed Seed to be used for Pseudo-RNG.
+     * @param ndays Number of days (steps) of the simulation.
+     * @param fun In the case of `run_multiple`, a function that is called
+     * after each experiment.
+     *
+     */
+    ///@{
+    void update_state();
+    void mutate_virus();
+    virtual void next();
+    virtual Model<TSeq> & run(
+        epiworld_fast_uint ndays,
+        int seed = -1
+    ); ///< Runs the simulation (after initialization)
+    bool is_aggregated() const; ///< Runs on counts (see `run_aggregated()`)
+    Model<TSeq> & run_multiple( ///< Multiple runs of the simulation
+        epiworld_fast_uint ndays,
+        epiworld_fast_uint nexperiments,
+        int seed_ = -1,
+        std::function<void(size_t,Model<TSeq>*)> fun = make_save_run<TSeq>(),
+        bool reset = true,
+        bool verbose = true,
+        int nthreads = 1
+        );
+    ///@}
+
+    /**
+     * @brief Runs the simulation in continuous time (next-reaction method)
+     *
+     * @details Instead of visiting every active agent each day, each agent
+     * has a single pending event (infection if susceptible, recovery or
+     * death if infected) scheduled in an indexed priority queue. The daily
+     * probabilities of the virus and tools are turned into rates,
+     * \f$\lambda = -\log(1 - p)\f$, so an agent that does not interact
+     * with anyone keeps the same daily probabilities as in `run()`. After
+     * each event, only the agent and its neighbors are rescheduled, so the
+     * cost is proportional to the number of events rather than to the
+     * number of days times active agents.
+     *
+     * The database is recorded at day boundaries, where the global events,
+     * rewiring, and mutations also run (as in `run()`). Rates are assumed
+     * to be constant between events; they are all recomputed after a day
+     * boundary only if the model has global events, rewiring, or mutating
+     * viruses.
+     *
+     * Only models whose states use `default_update_susceptible()`,
+     * `default_update_exposed()`, or no update function are supported
+     * (e.g., SIR, SIS, SIRD, and SISD over a network).
+     *
+     * @param ndays Number of days of the simulation.
+     * @param seed Seed to be used for Pseudo-RNG.
+     * @throws std::logic_error If a state uses a different update function.
+     */
+    Model<TSeq> & run_continuous(
+        epiworld_fast_uint ndays,
+        int seed = -1
+    );
+
+    /**
+     * @name Checkpoints
+     *
+     * @details `write_checkpoint()` saves the state of the model (e.g.,
+     * after `run()`) to a versioned binary file: the date, parameters, and
+     * RNG state (including the distributions' cached draws), the agents'
+     * states, viruses, tools, and entities, the network, the queue, the
+     * global events' days, and the database (history, transmissions, and
+     * user data). `read_checkpoint()` restores it, and `resume()` continues
+     * the simulation, so the following days are the same as if the
+     * original model had kept running.
+     *
+     * Functions cannot be stored, so the checkpoint must be read by a
+     * model built by the same code (same states, viruses, tools, entities,
+     * global events, and number of agents). Viruses and tools are rebuilt
+     * from the ones in the model (mutated viruses from their ancestor
+     * in the model), keeping each carrier's id, date, and sequence, so
+     * tools created during the simulation (e.g., by
+     * `Virus::set_post_immunity()`) cannot be restored.
+     * Members added by derived models are only included if the model
+     * overrides `write_checkpoint_derived()` and `read_checkpoint_derived()`
+     * (as the built-in models do).
+     *
+     * @param fn Filename.
+     * @param ndays Number of days to add to the simulation.
+     * @throws std::runtime_error If the file cannot be opened or read.
+     * @throws std::logic_error If the checkpoint doesn't match the model.
+     */
+    ///@{
+    void write_checkpoint(std::string fn) const;
+    void write_checkpoint(std::ostream & out) const;
+    void read_checkpoint(std::string fn);
+    void read_checkpoint(std::istream & in);
+    Model<TSeq> & resume(epiworld_fast_uint ndays);
+    ///@}
+
+    /**
+     * @brief Runs scenarios that share a burn-in period
+     *
+     * @details The model runs the first `burnin` days once, and the result
+     * is kept as an in-memory checkpoint (see `write_checkpoint()`). Then,
+     * each of the `scenarios.size()` scenarios is run `nreplicates` times
+     * from that checkpoint until day `ndays`: the parameters listed in the
+     * scenario are set (see `set_param()`), the model is seeded with the
+     * fork's own seed, and the simulation continues with `resume()`. The
+     * database of each fork has the full history (burn-in included).
+     *
+     * Forks are numbered `scenario * nreplicates + replicate`; the number
+     * is passed to `fun` and used as the simulation id. As in
+     * `run_multiple()`, seeds are bound to the fork number, so the results
+     * don't depend on the number of threads, and the model ends with the
+     * state of the last fork.
+     *
+     * @param ndays Number of days of the simulation (burn-in included).
+     * @param burnin Number of days shared by all the forks.
+     * @param scenarios Parameters to set in each scenario (an empty map
+     * runs the model as is).
+     * @param nreplicates Number of replicates of each scenario.
+     * @param seed Seed to be used for Pseudo-RNG.
+     * @param fun Function called after each fork.
+     * @param verbose When `true`, shows a progress bar.
+     * @param nthreads Number of threads (with OpenMP).
+     */
+    Model<TSeq> & run_scenarios(
+        epiworld_fast_uint ndays,
+        epiworld_fast_uint burnin,
+        const std::vector< std::map< std::string, epiworld_double > > & scenarios,
+        epiworld_fast_uint nreplicates,
+        int seed = -1,
+        std::function<void(size_t,Model<TSeq>*)> fun = make_save_run<TSeq>(),
+        bool verbose = true,
+        int nthreads = 1
+    );
+
+    size_t get_n_viruses() const; ///< Number of viruses in the model
+    size_t get_n_tools() const; ///< Number of tools in the model
+    epiworld_fast_uint get_ndays() const;
+    epiworld_fast_uint get_n_replicates() const;
+    size_t get_sim_id() const;
+    size_t get_n_entities() const;
+    void set_ndays(epiworld_fast_uint ndays);
+    bool get_verbose() const;
+    Model<TSeq> & verbose_off();
+    Model<TSeq> & verbose_on();
+    int today() const; ///< The current time of the model
+
+    /**
+     * @name Rewire the network preserving the degree sequence.
+     *
+     * @details This implementation assumes an undirected network,
+     * thus if {(i,j), (k,l)} -> {(i,l), (k,j)}, the reciprocal
+     * is also true, i.e., {(j,i), (l,k)} -> {(j,k), (l,i)}.
+     *
+     * @param proportion Proportion of ties to be rewired.
+     *
+     * @result A rewired version of the network.
+     */
+    ///@{
+    void set_rewire_fun(std::function<void(std::vector<Agent<TSeq>>*,Model<TSeq>*,epiworld_double)> fun);
+    void set_rewire_prop(epiworld_double prop);
+    epiworld_double get_rewire_prop() const;
+    void rewire();
+    ///@}
+
+    /**
+     * @brief Wrapper of `DataBase::write_data`
+     *
+     * @param fn_virus_info Filename. Information about the virus.
+     * @param fn_virus_hist Filename. History of the virus.
+     * @param fn_tool_info Filename. Information about the tool.
+     * @param fn_tool_hist Filename. History of the tool.
+     * @param fn_total_hist   Filename. Aggregated history (state)
+     * @param fn_transmission Filename. Transmission history.
+     * @param fn_transition   Filename. Markov transition history.
+     * @param fn_reproductive_number Filename. Case by case reproductive number
+     * @param fn_generation_time Filename. Generation time data.
+     * @param fn_active_cases Filename. Active cases data.
+     * @param fn_outbreak_size Filename. Outbreak size data.
+     * @param fn_hospitalizations Filename. Hospitalization data.
+     */
+    void write_data(
+        std::string fn_virus_info,
+        std::string fn_virus_hist,
+        std::string fn_tool_info,
+        std::string fn_tool_hist,
+        std::string fn_total_hist,
+        std::string fn_transmission,
+        std::string fn_transition,
+        std::string fn_reproductive_number,
+        std::string fn_generation_time,
+        std::string fn_active_cases,
+        std::string fn_outbreak_size,
+        std::string fn_hospitalizations
+        ) const;
+
+    /**
+     * @name Export the network data in edgelist form
+     *
+     * @param fn std::string. File name.
+     * @param source Integer vector
+     * @param target Integer vector
+     *
+     * @details When passing the source and target, the function will
+     * write the edgelist on those.
+     */
+    ///@{
+    void write_edgelist(
+        std::string fn
+        ) const;
+
+    void write_edgelist(
+        std::vector< int > & source,
+        std::vector< int > & target
+        ) const;
+    ///@}
+
+    std::map<std::string, epiworld_double> & params();
+
+    /**
+     * @brief Reset the model
+     *
+     * @details Resetting the model will:
+     * - clear the database
+     * - reset the agents' state, viruses, and tools (in place)
+     * - restore the network (if `set_backup()` was called before and
+     *   the network was rewired)
+     * - re-distribute tools
+     * - re-distribute viruses
+     * - set the date to 0
+     *
+     */
+    virtual void reset();
+    const Model<TSeq> & print(bool lite = false) const;
+
+    /**
+     * @name Manage state (states) in the model
+     *
+     * @details
+     *
+     * The functions `get_state` return the current values for the
+     * states included in the model. The function `set_state_function`
+     * replaces the update function associated with an existing state.
+     *
+     * @param lab `std::string` Name of the state.
+     *
+     * @return `add_state*` returns the ID (index) of the registered state.
+     * @return `set_state_function` returns a reference to the model.
+     * @return `get_state_*` returns a vector of pairs with the
+     * states and their labels.
+     */
+    ///@{
+    epiworld_fast_int state_of(std::string_view name);
+    epiworld_fast_int add_state(std::string lab, UpdateFun<TSeq> fun = nullptr);
+    Model<TSeq> & set_state_function(epiworld_fast_uint state, UpdateFun<TSeq> fun = nullptr);
+    Model<TSeq> & set_state_function(std::string_view name, UpdateFun<TSeq> fun = nullptr);
+    const std::vector< std::string > & get_states() const;
+    size_t get_n_states() const;
+    const std::vector< UpdateFun<TSeq> > & get_state_fun() const;
+    void print_state_codes() const;
+    ///@}
+
+    /**
+     * @name Initial states
+     *
+     * @details These functions are called before the simulation starts.
+     *
+     * @param proportions_ Vector of proportions for each state.
+     * @param queue_ Vector of queue for each state.
+     */
+    virtual Model<TSeq> & initial_states(
+        std::vector< double > /*proportions_*/,
+        std::vector< int > /*queue_*/
+    ) {return *this;};
+
+    /**
+     * @name Setting and accessing parameters from the model
+     *
+     * @details Tools can incorporate parameters included in the model.
+     * Internally, parameters in the tool are stored as pointers to
+     * an std::map<> of parameters in the model. Using the `epiworld_fast_uint`
+     * method directly fetches the parameters in the order these were
+     * added to the tool. Accessing parameters via the `std::string` method
+     * involves searching the parameter directly in the std::map<> member
+     * of the model (so it is not recommended.)
+     *
+     * The `par()` function members are aliases for `get_param()`.
+     *
+     * Update functions called for every agent should use parameter ids
+     * instead of names. `param_id()` maps a name to an id that is the same
+     * across models (so it can be resolved once, e.g., in a `static`
+     * variable), and `par(id)` is then a single load. The `std::map<>`
+     * returned by `params()` is still the storage, so values modified
+     * through it are seen by `par(id)`. Parameters added through it are
+     * bound to their ids the next time `params()` is called or the model
+     * runs (until then, `par(id)` searches them by name). Parameters
+     * should not be erased from it.
+     *
+     * In the case of the function `read_params`, users can pass a file
+     * listing parameters to be included in the model. Each line in the
+     * file should have the following structure:
+     *
+     * ```
+     * [name of parameter 1]: [value in double]
+     * [name of parameter 2]: [value in double]
+     * ...
+     * ```
+     *
+     * The only condition for parameter names is that these do not include
+     * a colon.
+     *
+     *
+     * @param initial_val
+     * @param pname Name of the parameter to add or to fetch
+     * @param fn Path to the file containing parameters
+     * @return The current value of the parameter
+     * in the model.
+     *
+     */
+    ///@{
+    epiworld_double add_param(
+        epiworld_double initial_val, std::string pname, bool overwrite = false
+    );
+    Model<TSeq> & read_params(std::string fn, bool overwrite = false);
+    epiworld_double get_param(const std::string & pname);
+    void set_param(const std::string & pname, epiworld_double val);
+    epiworld_double par(const std::string & pname) const;
+    epiworld_double par(size_t id) const;
+    static size_t param_id(const std::string & pname);
+    static const std::string & param_name(size_t id);
+    ///@}
+
+    void get_elapsed(
+        std::string unit = "auto",
+        epiworld_double * last_elapsed = nullptr,
+        epiworld_double * total_elapsed = nullptr,
+        std::string * unit_abbr = nullptr,
+        bool print = true
+    ) const;
+
+    /**
+     * @name Profiling
+     * @details Time per phase and counters (agents visited, update
+     * functions called, events by type, and random draws) of the last run
+     * and of all the runs of the model, including the ones made by the
+     * threads of `run_multiple()` and `run_scenarios()`. Only collected
+     * when compiled with `EPI_PROFILE` (see `Profiler`).
+     */
+    ///@{
+    const Profiler & get_profile() const; ///< Profile of the last run.
+    const Profiler & get_profile_total() const; ///< Profile of all the runs.
+    ///@}
+
+    /**
+     * @name Memory usage
+     * @details `memory_usage()` measures the memory held by the model now
+     * (see `MemoryUsage` for what is counted). With `nthreads > 1`, it
+     * adds the clones that `run_multiple()` would make with that many
+     * threads.
+     *
+     * `estimate_memory_usage()` predicts the usage of a model before
+     * building it, after a run of `ndays`. The estimate is an upper bound
+     * for the outbreak: it assumes every agent carries a virus at some
+     * point and is infected once (the transmission records). Entities,
+     * events and contact tracing are not included. Since history vectors
+     * grow geometrically, their capacity (and what `memory_usage()`
+     * reports) can be up to twice the estimate.
+     *
+     * @param n Number of agents.
+     * @param mean_degree Average number of neighbors per agent.
+     * @param nstates Number of states.
+     * @param ndays Number of days.
+     * @param nviruses, ntools Number of viruses and tools (variants
+     * included).
+     * @param nthreads Threads passed to `run_multiple()`.
+     */
+    ///@{
+    MemoryUsage memory_usage(int nthreads = 1) const;
+    static MemoryUsage estimate_memory_usage(
+        size_t n,
+        epiworld_double mean_degree,
+        size_t nstates,
+        size_t ndays,
+        size_t nviruses = 1u,
+        size_t ntools = 0u,
+        int nthreads = 1
+    );
+    ///@}
+
+    /**
+     * @name Set the user data object
+     *
+     * @param names string vector with the names of the variables.
+     */
+    ///[@
+    void set_user_data(std::vector< std::string > names);
+    void add_user_data(epiworld_fast_uint j, epiworld_double x);
+    void add_user_data(std::vector< epiworld_double > x);
+    UserData<TSeq> & get_user_data();
+    ///@}
+
+    /**
+     * @brief Set a global action
+     *
+     * @param fun A function to be called on the prescribed date
+     * @param name Name of the action.
+     * @param date Integer indicating when the function is called (see details)
+     *
+     * @details When date is less than zero, then the function is called
+     * at the end of every day. Otherwise, the function will be called only
+     * at the end of the indicated date.
+     */
+    void add_globalevent(
+        std::function<void(Model<TSeq>*)> fun,
+        std::string name = "A global action",
+        int date = -99
+        );
+
+    void add_globalevent(
+        GlobalEvent<TSeq> & action
+    );
+
+    GlobalEvent<TSeq> & get_globalevent(std::string name); ///< Retrieve a global action by name
+    GlobalEvent<TSeq> & get_globalevent(size_t i); ///< Retrieve a global action by index
+
+    void rm_globalevent(std::string name); ///< Remove a global action by name
+    void rm_globalevent(size_t i); ///< Remove a global action by index
+
+    void run_globalevents();
+
+    void clear_state_set();
+
+    /**
+     * @name Queuing system
+     * @details When queueing is on, the model will keep track of which agents
+     * are either in risk of exposure or exposed. This then is used at each
+     * step to act only on the aforementioned agents.
+     *
+     */
+    ////@{
+    void queuing_on(); ///< Activates the queuing system (default.)
+    Model<TSeq> & queuing_off(); ///< Deactivates the queuing system.
+    bool is_queuing_on() const; ///< Query if the queuing system is on.
+    Queue<TSeq> & get_queue(); ///< Retrieve the `Queue` object.
+    ///@}
+
+    /**
+     * @name Contact tracing
+     * @details When contact tracing is on, the model will track contacts
+     * between agents. Users must actively record contacts in their update
+     * functions by calling `get_contact_tracing().add_contact(...)`.
+     * Contact tracing is off by default.
+     *
+     * @param max_contacts Maximum number of contacts to track per agent
+     * (default: EPI_MAX_TRACKING). Only used when turning tracing on.
+     */
+    ///@{
+    Model<TSeq> & contact_tracing_on(size_t max_contacts = EPI_MAX_TRACKING); ///< Activates contact tracing.
+    Model<TSeq> & contact_tracing_off(); ///< Deactivates contact tracing.
+    bool is_contact_tracing_on() const; ///< Query if contact tracing is on.
+    ContactTracing & get_contact_tracing(); ///< Retrieve the `ContactTracing` object.
+    ///@}
+
+    /**
+     * @name Order of the events
+     * @details By default, `events_run()` applies the events of the day in
+     * the order in which they were added. When on, events are applied
+     * sorted by agent id (each agent's events keep their relative order),
+     * which walks the population sequentially. Counts and states are the
+     * same either way, but records kept in order of occurrence (e.g., the
+     * transmissions) may be listed in a different order.
+     */
+    ///@{
+    Model<TSeq> & events_by_agent_on(); ///< Applies the events in agent order.
+    Model<TSeq> & events_by_agent_off(); ///< Applies the events in insertion order (default.)
+    bool is_events_by_agent_on() const; ///< Query if the events are applied in agent order.
+    ///@}
+
+    /**
+     * @name Fast-forward after extinction
+     * @details When on, `run()` (and `resume()`) check after each day
+     * whether the model reached an absorbing state, i.e., nothing can change
+     * anymore. If so, the remaining days only call `next()`, which records
+     * the (unchanged) counts in the database, skipping the update of the
+     * agents, global events, rewiring, and mutation. The history is the
+     * same as in a full run; only the random numbers left undrawn differ.
+     *
+     * By default (`fun = nullptr`), `is_absorbing()` is `true` when no agent
+     * has a virus, no global event is left to run (events without a day
+     * run every day), and agents are only in states without an update
+     * function or with `default_update_susceptible()`. Models with other
+     * update functions can pass their own detector.
+     *
+     * @param fun Function returning `true` if the model can no longer change.
+     */
+    ///@{
+    Model<TSeq> & fast_forward_on(std::function<bool(Model<TSeq>*)> fun = nullptr); ///< Activates the fast-forward.
+    Model<TSeq> & fast_forward_off(); ///< Deactivates the fast-forward (default.)
+    bool is_fast_forward_on() const; ///< Query if the fast-forward is on.
+    bool is_absorbing(); ///< Query if the model reached an absorbing state.
+    ///@}
+
+    /**
+     * @name Batched uniforms
+     * @details When on, `runif()` takes its numbers from a buffer filled
+     * in blocks by `EPI_RUNIF_LANES` interleaved xoshiro256** generators
+     * (`epi_xoshiro256ss_lanes`), instead of drawing them one at a time from
+     * the model's engine. This speeds up models drawing many uniforms (e.g.,
+     * the contact sampling of the mixing models).
+     *
+     * The batched stream is seeded by `seed()` and is separate from the
+     * engine used by the other distributions. Results are reproducible
+     * for a given seed and number of lanes, but differ from those obtained
+     * with the option off. Within a parallel update, `runif()` still draws
+     * from the per-agent streams.
+     */
+    ///@{
+    Model<TSeq> & runif_batch_on(); ///< Activates the batched uniforms.
+    Model<TSeq> & runif_batch_off(); ///< Deactivates the batched uniforms (default.)
+    bool is_runif_batch_on() const; ///< Query if the batched uniforms are on.
+    ///@}
+
+    /**
+     * @name Parallel update of the agents' states
+     * @details When on, `update_state()` runs the update functions of the
+     * agents in parallel (OpenMP) and the resulting events are applied in
+     * the same order as in a serial run. Each agent draws random numbers
+     * from its own Philox stream, keyed by the seed and the simulation id
+     * (`rng_seed ^ sim_id * 0x9e3779b97f4a7c15`) and positioned at the
+     * agent and day, so the results are identical for any number of
+     * threads (but differ from those obtained with the option off).
+     *
+     * Update functions must only read the model and register changes
+     * through events (e.g., `Agent::change_state()`, `Agent::set_virus()`).
+     * Functions writing to model members (including contact tracing) are
+     * not safe to run in parallel.
+     *
+     * @param nthreads Number of threads to use.
+     */
+    ///@{
+    Model<TSeq> & parallel_update_on(int nthreads = 2); ///< Activates the parallel update.
+    Model<TSeq> & parallel_update_off(); ///< Deactivates the parallel update (default.)
+    bool is_parallel_update_on() const; ///< Query if the parallel update is on.
+    ///@}
+
+    const std::vector< VirusPtr<TSeq> > & get_viruses() const;
+    const std::vector< ToolPtr<TSeq> > & get_tools() const;
+    Virus<TSeq> & get_virus(size_t id);
+    Virus<TSeq> & get_virus(std::string_view name);
+    Tool<TSeq> & get_tool(size_t id);
+    Tool<TSeq> & get_tool(std::string_view name);
+
+    bool has_virus(std::string_view name) const;
+    bool has_tool(std::string_view name) const;
+
+    /**
+     * @brief Set the agents data object
+     *
+     * @details The data should be an array with the data stored in a
+     * column major order, i.e., by column.
+     *
+     * @param data_ Pointer to the first element of an array of size
+     * `size() * ncols_`.
+     * @param ncols_ Number of features included in the data.
+     *
+     */
+    void set_agents_data(double * data_, size_t ncols_);
+    double * get_agents_data();
+    size_t get_agents_data_ncols() const;
+
+    /**
+     * @brief Set the name object
+     *
+     * @param name
+     */
+    void set_name(std::string name);
+    std::string get_name() const;
+
+    bool operator==(const Model<TSeq> & other) const;
+    bool operator!=(const Model<TSeq> & other) const {return !operator==(other);};
+
+    /**
+     * @brief Executes the stored action
+     *
+     * @param model_ Model over which it will be executed.
+     */
+    void events_run();
+
+    /**
+     * @brief Draws a mermaid diagram of the model.
+     * @param model The model to draw.
+     * @param fn_output The name of the file to write the diagram.
+     * If empty, the diagram will be printed to the standard output.
+     * @param self Whether to allow self-transitions.
+     */
+    void draw(
+        DiagramType diagram_type = DiagramType::Mermaid,
+        const std::string & fn_output = "",
+        bool self = false
+    );
+
+    /**
+     * @brief Record a hospitalization event for an agent.
+     * 
+     * @param agent Reference to the agent being hospitalized.
+     * 
+     * @details
+     * This is a wrapper for `DataBase::record_hospitalization()`.
+     * For each hospitalization, the method records:
+     * - The current date from the model
+     * - The virus ID from the agent's virus
+     * - For each tool the agent has, a separate record with weight = 1/N
+     *   where N is the number of tools
+     * - If the agent has no tools, a single record with tool_id = -1 and
+     *   weight = 1.0
+     */
+    void record_hospitalization(Agent<TSeq> & agent);
+
+    /**
+     * @brief Get the full time series of hospitalization data.
+     * 
+     * @param date Output vector for dates.
+     * @param virus_id Output vector for virus IDs.
+     * @param tool_id Output vector for tool IDs.
+     * @param count Output vector for counts (number of hospitalized individuals).
+     * @param weight Output vector for summed weights (fractional contribution
+     *   based on tool distribution).
+     * 
+     * @details
+     * This is a wrapper for `DataBase::get_hospitalizations()`.
+     * Returns the full time series of hospitalization data. For each unique 
+     * (virus_id, tool_id) combination observed, returns an entry for every 
+     * day from 0 to ndays-1.
+     * 
+     * The `count` vector contains the actual number of individuals hospitalized 
+     * for that (date, virus_id, tool_id) combination. This is useful for 
+     * answering questions like "how many total people were hospitalized?" 
+     * regardless of their tools.
+     * 
+     * The `weight` vector contains fractional contributions: if an agent has N 
+     * tools, each tool gets weight = 1/N. Summing weights across all tool_ids 
+     * for a given date and virus_id gives the total number of hospitalizations.
+     */
+    void get_hospitalizations(
+        std::vector<int> & date,
+        std::vector<int> & virus_id,
+        std::vector<int> & tool_id,
+        std::vector<int> & count,
+        std::vector<double> & weight
+    ) const;
+
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/model-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/model-rand-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODEL_RAND_MEAT_HPP
+#define EPIWORLD_MODEL_RAND_MEAT_HPP
+
+// (already included include/epiworld/rng-utils.hpp)
+// (already included include/epiworld/model-bones.hpp)
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_gamma(epiworld_double alpha, epiworld_double beta)
+{
+    rgammad = std::gamma_distribution<>(alpha,beta);
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_norm(epiworld_double mean, epiworld_double sd)
+{
+    rnormd  = std::normal_distribution<>(mean, sd);
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_unif(epiworld_double a, epiworld_double b)
+{
+    runifd_a = a;
+    runifd_b = b;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_lognormal(epiworld_double mean, epiworld_double shape)
+{
+    rlognormald  = std::lognormal_distribution<>(mean, shape);
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_exp(epiworld_double lambda)
+{
+    rexpd  = std::exponential_distribution<>(lambda);
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_binom(int n, epiworld_double p)
+{
+    rbinomd  = std::binomial_distribution<>(n, p);
+    rbinomd_n = n;
+#ifdef EPI_FAST_BINOM
+    rbinomd_fast_lambda = static_cast<epiworld_double>(n) * p;
+    rbinomd_use_poisson =
+        (p <= static_cast<epiworld_double>(0.01)) &&
+        (static_cast<epiworld_double>(n) * p * p <= static_cast<epiworld_double>(0.1));
+#else
+    rbinomd_fast_lambda = 0.0;
+    rbinomd_use_poisson = false;
+#endif
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_nbinom(int n, epiworld_double p)
+{
+    rnbinomd  = std::negative_binomial_distribution<>(n, p);
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_geom(epiworld_double p)
+{
+    rgeomd  = std::geometric_distribution<>(p);
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_poiss(epiworld_double lambda)
+{
+    rpoissd  = std::poisson_distribution<>(lambda);
+}
+
+template<typename TSeq>
+inline std::shared_ptr< epi_xoshiro256ss > & Model<TSeq>::get_rand_endgine()
+{
+    return engine;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_engine(std::shared_ptr< epi_xoshiro256ss > & eng)
+{
+    engine = eng;
+}
+
+template<typename TSeq>
+inline epi_philox4x32 & Model<TSeq>::rng_engine_thread()
+{
+    #ifdef _OPENMP
+    return engines_threads[omp_get_thread_num()];
+    #else
+    return engines_threads[0u];
+    #endif
+}
+
+template<typename TSeq>
+inline uint64_t Model<TSeq>::rng_next()
+{
+
+    EPI_PROFILE_ADD(profile, RngDraws, 1u)
+
+    if (in_parallel_update)
+        return rng_engine_thread()();
+
+    return (*engine)();
+
+}
+
+template<typename TSeq>
+template<typename TDist, typename... TArgs>
+inline typename TDist::result_type Model<TSeq>::rand_draw(
+    TDist & dist,
+    TArgs... args
+)
+{
+
+    EPI_PROFILE_ADD(profile, RngDraws, 1u)
+
+    if (in_parallel_update)
+    {
+        TDist dist_thread(dist.param());
+        return dist_thread(rng_engine_thread(), args...);
+    }
+
+    return dist(*engine, args...);
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::runif_next()
+{
+
+    if (in_parallel_update)
+        return runif_epi(rng_engine_thread());
+
+    if (!use_runif_batch)
+        return runif_epi(*engine);
+
+    if (runif_buffer_pos == runif_buffer.size())
+    {
+        runif_buffer.resize(runif_batch_blocks * EPI_RUNIF_LANES);
+        engine_batch.fill_unif(runif_buffer.data(), runif_batch_blocks);
+        runif_buffer_pos = 0u;
+    }
+
+    return runif_buffer[runif_buffer_pos++];
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::runif() {
+    // CHECK_INIT()
+    EPI_PROFILE_ADD(profile, RngDraws, 1u)
+    return runif_next() * (runifd_b - runifd_a) + runifd_a;
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::runif_int(int a, int b) {
+    // CHECK_INIT()
+    return a + runif_index(static_cast<uint32_t>(b - a + 1));
+}
+
+template<typename TSeq>
+inline uint32_t Model<TSeq>::runif_index(uint32_t n) {
+
+    // If asking for a 0-range, return 0 to prevent division by zero in the bias check
+    if (n == 0) return 0;
+
+    // Grab 32 perfectly uniform random bits directly from xoshiro256ss
+    uint32_t x = static_cast<uint32_t>(rng_next());
+    
+    // Multiply by the bound N to get a 64-bit result
+    uint64_t m = static_cast<uint64_t>(x) * static_cast<uint64_t>(n);
+    
+    // The fractional part (lower 32 bits)
+    uint32_t l = static_cast<uint32_t>(m);
+    
+    // Unbiased rejection sampling for the rare edge case
+    if (l < n) {
+        uint32_t t = -n % n; // Two's complement trick to get (2^32 - n) % n
+        while (l < t) {
+            x = static_cast<uint32_t>(rng_next());
+            m = static_cast<uint64_t>(x) * static_cast<uint64_t>(n);
+            l = static_cast<uint32_t>(m);
+        }
+    }
+    
+    // The integer part (upper 32 bits) is our unbiased scaled random index
+    return static_cast<uint32_t>(m >> 32);
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::runif(epiworld_double a, epiworld_double b) {
+    // CHECK_INIT()
+    EPI_PROFILE_ADD(profile, RngDraws, 1u)
+    return runif_next() * (b - a) + a;
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rnorm() {
+    // CHECK_INIT()
+    return rand_draw(rnormd);
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rnorm(epiworld_double mean, epiworld_double sd) {
+    // CHECK_INIT()
+    return rand_draw(rnormd) * sd + mean;
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rgamma() {
+    return rand_draw(rgammad);
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rgamma(epiworld_double alpha, epiworld_double beta) {
+
+    return rand_draw(
+        rgammad,
+        std::gamma_distribution<>::param_type(alpha, beta)
+    );
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rexp() {
+    return rand_draw(rexpd);
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rexp(epiworld_double lambda) {
+
+    return rand_draw(
+        rexpd,
+        std::exponential_distribution<>::param_type(lambda)
+    );
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rlognormal() {
+    return rand_draw(rlognormald);
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rlognormal(epiworld_double mean, epiworld_double shape) {
+
+    return rand_draw(
+        rlognormald,
+        std::lognormal_distribution<>::param_type(mean, shape)
+    );
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rbinom() {
+#ifdef EPI_FAST_BINOM
+    if (rbinomd_use_poisson)
+    {
+        int res = rpoiss(rbinomd_fast_lambda);
+        return std::min(res, rbinomd_n);
+    }
+#endif
+    return rand_draw(rbinomd);
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rbinom(int n, epiworld_double p) {
+
+    if (n == 0 || p == 0.0)
+        return 0;
+
+#ifdef EPI_FAST_BINOM
+    if (
+        (p <= static_cast<epiworld_double>(0.01)) &&
+        (static_cast<epiworld_double>(n) * p * p <= static_cast<epiworld_double>(0.1))
+    )
+    {
+        int res = rpoiss(static_cast<epiworld_double>(n) * p);
+        return std::min(res, n);
+    }
+#endif
+
+    return rand_draw(
+        rbinomd,
+        std::binomial_distribution<>::param_type(n, p)
+    );
+
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rnbinom() {
+    return rand_draw(rnbinomd);
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rnbinom(int n, epiworld_double p) {
+
+    return rand_draw(
+        rnbinomd,
+        std::negative_binomial_distribution<>::param_type(n, p)
+    );
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rgeom() {
+    return rand_draw(rgeomd);
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rgeom(epiworld_double p) {
+
+    return rand_draw(
+        rgeomd,
+        std::geometric_distribution<>::param_type(p)
+    );
+
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rpoiss() {
+    return rand_draw(rpoissd);
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rpoiss(epiworld_double lambda) {
+
+    return rand_draw(
+        rpoissd,
+        std::poisson_distribution<>::param_type(lambda)
+    );
+
+}
+
+template<typename TSeq>
+inline size_t Model<TSeq>::sample_from_probs(size_t n) {
+
+    epiworld_double p_total = runif();
+    size_t ans;
+    for (ans = 0u; ans < n; ++ans)
+    {
+        if (p_total < array_double_tmp[ans])
+            break;
+        array_double_tmp[ans + 1] += array_double_tmp[ans];
+    }
+    return ans;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::seed(size_t s) {
+    this->rng_seed = static_cast< uint64_t >(s);
+    this->engine->seed(s);
+
+    // The batched stream is keyed apart from the engine, so their
+    // sequences do not coincide
+    this->engine_batch.seed(
+        static_cast< uint64_t >(s) ^ 0x9e3779b97f4a7c15ULL
+    );
+    this->runif_buffer.clear();
+    this->runif_buffer_pos = 0u;
+
+    // Some distributions keep draws for the next call (e.g., the normal
+    // makes two at a time), which would make the sequence depend on what
+    // was drawn before seeding
+    this->rnormd.reset();
+    this->rgammad.reset();
+    this->rlognormald.reset();
+    this->rexpd.reset();
+    this->rbinomd.reset();
+    this->rnbinomd.reset();
+    this->rgeomd.reset();
+    this->rpoissd.reset();
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/model-rand-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/model-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODEL_MEAT_HPP
+#define EPIWORLD_MODEL_MEAT_HPP
+
+#include <vector>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <map>
+#include <unordered_map>
+// (already included include/epiworld/config.hpp)
+// (already included include/epiworld/userdata-bones.hpp)
+// (already included include/epiworld/adjlist-bones.hpp)
+// (already included include/epiworld/model-bones.hpp)
+// (already included include/epiworld/virus-bones.hpp)
+// (already included include/epiworld/agent-bones.hpp)
+// (already included include/epiworld/tool-bones.hpp)
+// (already included include/epiworld/rng-utils.hpp)
+// (already included include/epiworld/modeldiagram-bones.hpp)
+
+/**
+ * @brief Function factory for saving model runs
+ *
+ * @details This function is the default behavior of the `run_multiple`
+ * member of `Model<TSeq>`. By default only the total history (
+ * case counts by unit of time.)
+ *
+ * @tparam TSeq
+ * @param fmt
+ * @param total_hist
+ * @param virus_info
+ * @param virus_hist
+ * @param tool_info
+ * @param tool_hist
+ * @param transmission
+ * @param transition
+ * @return std::function<void(size_t,Model<TSeq>*)>
+ */
+template<typename TSeq>
+inline std::function<void(size_t,Model<TSeq>*)> make_save_run(
+    std::string fmt,
+    bool total_hist,
+    bool virus_info,
+    bool virus_hist,
+    bool tool_info,
+    bool tool_hist,
+    bool transmission,
+    bool transition,
+    bool reproductive,
+    bool generation,
+    bool active_cases,
+    bool outbreak_size,
+    bool hospitalizations
+    )
+{
+
+    // Counting number of %
+    int n_fmt = 0;
+    for (auto & f : fmt)
+        if (f == '%')
+            n_fmt++;
+
+    if (n_fmt != 1)
+        throw std::logic_error("The -fmt- argument must have only one \"%\" symbol.");
+
+    // Listting things to save
+    std::vector< bool > what_to_save = {
+        virus_info,
+        virus_hist,
+        tool_info,
+        tool_hist,
+        total_hist,
+        transmission,
+        transition,
+        reproductive,
+        generation,
+        active_cases,
+        outbreak_size,
+        hospitalizations
+    };
+
+    std::function<void(size_t,Model<TSeq>*)> saver = [fmt,what_to_save](
+        size_t niter, Model<TSeq> * m
+    ) -> void {
+
+        auto set_saver = [fmt,niter](
+            bool condition,
+            std::string suffix
+        ) -> std::string
+        {
+            if (condition)
+            {
+                std::string var = fmt + suffix;
+                char buff[1024u];
+                snprintf(buff, sizeof(buff), var.c_str(), niter);
+                return std::string(buff);
+            }
+            return std::string("");
+        };
+
+        auto virus_info = set_saver(what_to_save[0u], "_virus_info.csv");
+        auto virus_hist = set_saver(what_to_save[1u], "_virus_hist.csv");
+        auto tool_info = set_saver(what_to_save[2u], "_tool_info.csv");
+        auto tool_hist = set_saver(what_to_save[3u], "_tool_hist.csv");
+        auto total_hist = set_saver(what_to_save[4u], "_total_hist.csv");
+        auto transmission = set_saver(what_to_save[5u], "_transmission.csv");
+        auto transition = set_saver(what_to_save[6u], "_transition.csv");
+        auto reproductive = set_saver(what_to_save[7u], "_reproductive.csv");
+        auto generation = set_saver(what_to_save[8u], "_generation.csv");
+        auto active_cases = set_saver(what_to_save[9u], "_active_cases.csv");
+        auto outbreak_size = set_saver(what_to_save[10u], "_outbreak_size.csv");
+        auto hospitalizations = set_saver(what_to_save[11u], "_hospitalizations.csv");
+
+        m->write_data(
+            virus_info,
+            virus_hist,
+            tool_info,
+            tool_hist,
+            total_hist,
+            transmission,
+            transition,
+            reproductive,
+            generation,
+            active_cases,
+            outbreak_size,
+            hospitalizations
+        );
+
+    };
+
+    return saver;
+}
+
+
+template<typename TSeq>
+inline void Model<TSeq>::_add_event(
+    Agent<TSeq> * agent_,
+    VirusPtr<TSeq> virus_,
+    ToolPtr<TSeq> tool_,
+    Entity<TSeq> * entity_,
+    epiworld_fast_int new_state_,
+    epiworld_fast_int queue_,
+    EventAction action_
+) {
+
+    // Within a parallel update, events go to the thread's buffer and
+    // are merged (in agent order) afterwards.
+    if (in_parallel_update)
+    {
+        #ifdef _OPENMP
+        auto & buffer = events_threads[omp_get_thread_num()];
+        #else
+        auto & buffer = events_threads[0u];
+        #endif
+
+        buffer.emplace_back(
+            agent_, virus_, tool_, entity_, new_state_, queue_, action_
+        );
+
+        return;
+    }
+
+    events.push(
+        agent_, std::move(virus_), std::move(tool_), entity_,
+        new_state_, queue_, action_
+    );
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::events_run()
+{
+
+    EPI_PROFILE_SCOPE(profile, EventsRun)
+
+    // State counters are accumulated and applied once
+    db.batch_on();
+
+    VirusPtr<TSeq> virus_null = nullptr;
+    ToolPtr<TSeq> tool_null = nullptr;
+    Event<TSeq> a(
+        nullptr, virus_null, tool_null, nullptr, -99, -99,
+        EventAction::ChangeState
+    );
+
+    try
+    {
+
+        // Events added while running (e.g., by post-recovery functions) are
+        // applied after the current ones
+        size_t nevents_tmp = 0u;
+        while (nevents_tmp < events.size())
+        {
+
+            const size_t nevents_end = events.size();
+            const std::vector< size_t > * order = events_by_agent ?
+                &events.sort_by_agent(nevents_tmp, nevents_end) : nullptr;
+
+            for (size_t k = nevents_tmp; k < nevents_end; ++k)
+            {
+
+                events.get(
+                    order ? (*order)[k - nevents_tmp] : k,
+                    a
+                );
+                Agent<TSeq> * p  = a.agent;
+
+                EPI_PROFILE_EVENT(profile, a.action)
+
+                #ifdef EPI_DEBUG
+                if (a.new_state >= static_cast<epiworld_fast_int>(nstates))
+                {
+                    throw std::range_error(
+                        "The proposed state " + std::to_string(a.new_state) + " is out of range. " +
+                        "The model currently has " + std::to_string(nstates - 1) + " states.");
+
+                }
+                else if ((a.new_state != -99) && (a.new_state < 0))
+                {
+                    throw std::range_error(
+                        "The proposed state " + std::to_string(a.new_state) + " is out of range. " +
+                        "The state cannot be negative.");
+                }
+                #endif
+
+                // Undoing the change in the transition matrix
+                if (
+                    (a.new_state != -99) &&
+                    (p->state_last_changed == today()) &&
+                    (static_cast<int>(p->state) != a.new_state)
+                )
+                {
+                    // Undoing state change in the transition matrix
+                    // The previous state is already recorded
+                    db.update_state(p->state_prev, p->state, true);
+
+                } else if (p->state_last_changed != today())
+                    p->state_prev = p->state; // Recording the previous state
+
+                switch (a.action)
+                {
+                case EventAction::AddVirus:
+                    _event_add_virus(a);
+                    break;
+                case EventAction::AddTool:
+                    _event_add_tool(a);
+                    break;
+                case EventAction::AddEntity:
+                    _event_add_entity(a);
+                    break;
+                case EventAction::RemoveVirus:
+                    _event_rm_virus(a);
+                    break;
+                case EventAction::RemoveTool:
+                    _event_rm_tool(a);
+                    break;
+                case EventAction::RemoveEntity:
+                    _event_rm_entity(a);
+                    break;
+                case EventAction::ChangeState:
+                    _event_change_state(a);
+                    break;
+                default:
+                    throw std::logic_error("The requested event action is not supported.");
+                }
+
+                if (a.new_state != -99)
+                {
+                    p->state = a.new_state;
+                    agents_state[static_cast< size_t >(p->id)] = p->state;
+                }
+
+                // Registering that the last change was today
+                p->state_last_changed = today();
+
+
+                #ifdef EPI_DEBUG
+                if (static_cast<int>(p->state) >= static_cast<int>(nstates))
+                        throw std::range_error(
+                            "The new state " + std::to_string(p->state) + " is out of range. " +
+                            "The model currently has " + std::to_string(nstates - 1) + " states.");
+                #endif
+
+                // Updating queue
+                if (use_queuing && a.queue != -99)
+                {
+
+                    if (a.queue == Queue<TSeq>::Everyone)
+                        queue += p;
+                    else if (a.queue == -Queue<TSeq>::Everyone)
+                        queue -= p;
+                    else if (a.queue == Queue<TSeq>::OnlySelf)
+                        queue[p->get_id()]++;
+                    else if (a.queue == -Queue<TSeq>::OnlySelf)
+                        queue[p->get_id()]--;
+                    else if (a.queue != Queue<TSeq>::NoOne)
+                        throw std::logic_error(
+                            "The proposed queue change is not valid. Queue values can be {-2, -1, 0, 1, 2}."
+                            );
+
+                }
+
+            }
+
+            nevents_tmp = nevents_end;
+
+        }
+
+    } catch (...) {
+
+        // Dropping the rest of the day's events (their payloads may have
+        // been moved out already)
+        db.batch_off();
+        events.clear();
+        throw;
+
+    }
+
+    db.batch_off();
+
+    // Go back to square 1
+    events.clear();
+
+    return;
+
+}
+
+/**
+ * @name Default function for combining susceptibility_reduction levels
+ *
+ * @tparam TSeq
+ * @param pt
+ * @return epiworld_double
+ */
+///@{
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::susceptibility_reduction_mixer(
+    Agent<TSeq>* p,
+    VirusPtr<TSeq> & v
+)
+{
+    if (p->tools_effects_fixed & (1u << 0u))
+        return 1.0 - p->tools_effects[0u];
+
+    epiworld_double total = 1.0;
+    for (auto & tool : p->tools)
+        total *= (1.0 - tool->get_susceptibility_reduction(v, this));
+
+    return 1.0 - total;
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::transmission_reduction_mixer(
+    Agent<TSeq>* p,
+    VirusPtr<TSeq> & v
+)
+{
+    if (p->tools_effects_fixed & (1u << 1u))
+        return 1.0 - p->tools_effects[1u];
+
+    epiworld_double total = 1.0;
+    for (auto & tool : p->tools)
+        total *= (1.0 - tool->get_transmission_reduction(v, this));
+
+    return (1.0 - total);
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::recovery_enhancer_mixer(
+    Agent<TSeq>* p,
+    VirusPtr<TSeq> & v
+)
+{
+    if (p->tools_effects_fixed & (1u << 2u))
+        return 1.0 - p->tools_effects[2u];
+
+    epiworld_double total = 1.0;
+    for (auto & tool : p->tools)
+        total *= (1.0 - tool->get_recovery_enhancer(v, this));
+
+    return 1.0 - total;
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::death_reduction_mixer(
+    Agent<TSeq>* p,
+    VirusPtr<TSeq> & v
+) {
+
+    if (p->tools_effects_fixed & (1u << 3u))
+        return 1.0 - p->tools_effects[3u];
+
+    epiworld_double total = 1.0;
+    for (auto & tool : p->tools)
+    {
+        total *= (1.0 - tool->get_death_reduction(v, this));
+    }
+
+    return 1.0 - total;
+
+}
+///@}
+
+template<typename TSeq>
+inline std::unique_ptr<Model<TSeq>> Model<TSeq>::clone_ptr()
+{
+    // Everything is copied
+    auto ptr = std::make_unique<Model<TSeq>>(*this);
+
+    #ifdef EPI_DEBUG
+    if (*this != *ptr)
+        throw std::logic_error("Model::clone_ptr The copies of the model don't match.");
+    #endif
+
+    return ptr;
+}
+
+template<typename TSeq>
+inline Model<TSeq>::Model()
+{
+    db.model = this;
+    db.user_data = this;
+    if (use_queuing)
+        queue.model = this;
+}
+
+template<typename TSeq>
+inline Model<TSeq>::Model(const Model<TSeq> & model) :
+    name(model.name),
+    db(model.db),
+    population(model.population),
+    agents_state(model.agents_state),
+    network(model.network),
+    network_backup(model.network_backup),
+    directed(model.directed),
+    viruses(),
+    tools(),
+    entities(model.entities),
+    use_runif_batch(model.use_runif_batch),
+    rewire_fun(model.rewire_fun),
+    rewire_prop(model.rewire_prop),
+    parameters(model.parameters),
+    ndays(model.ndays),
+    pb(model.pb),
+    state_fun(model.state_fun),
+    states_labels(model.states_labels),
+    initial_states_fun(model.initial_states_fun),
+    nstates(model.nstates),
+    verbose(model.verbose),
+    current_date(model.current_date),
+    globalevents(),
+    queue(model.queue),
+    use_queuing(model.use_queuing),
+    sim_id(model.sim_id),
+    aggregated(model.aggregated),
+    aggregated_sizes(model.aggregated_sizes),
+    contact_tracing(
+        model.contact_tracing
+            ? std::make_unique<ContactTracing>(*model.contact_tracing)
+            : nullptr
+    ),
+    use_contact_tracing(model.use_contact_tracing),
+    contact_tracing_max_contacts(model.contact_tracing_max_contacts),
+    events_by_agent(model.events_by_agent),
+    fast_forward(model.fast_forward),
+    absorbing_fun(model.absorbing_fun),
+    use_parallel_update(model.use_parallel_update),
+    parallel_update_nthreads(model.parallel_update_nthreads)
+{
+
+    // Pointing to the right place. This needs
+    // to be done afterwards since the state zero is set as a function
+    // of the population.
+    db.model = this;
+    db.user_data.model = this;
+
+    if (use_queuing)
+        queue.model = this;
+
+    parameters_ptrs_update();
+
+    agents_data = model.agents_data;
+    agents_data_ncols = model.agents_data_ncols;
+
+    rbinomd = model.rbinomd;
+    rbinomd_n = model.rbinomd_n;
+    rbinomd_fast_lambda = model.rbinomd_fast_lambda;
+    rbinomd_use_poisson = model.rbinomd_use_poisson;
+
+    // Deep-copy model-level objects so clones can run independently in parallel.
+    viruses.reserve(model.viruses.size());
+    for (const auto & v : model.viruses)
+        viruses.emplace_back(std::shared_ptr<Virus<TSeq>>(v->clone_ptr()));
+
+    tools.reserve(model.tools.size());
+    for (const auto & t : model.tools)
+        tools.emplace_back(std::shared_ptr<Tool<TSeq>>(t->clone_ptr()));
+
+    globalevents.reserve(model.globalevents.size());
+    for (const auto & ge : model.globalevents)
+        globalevents.emplace_back(std::shared_ptr<GlobalEvent<TSeq>>(ge->clone_ptr()));
+
+    // Entity-agent relationships now use size_t IDs, so they copy
+    // correctly without any rebinding needed.
+
+}
+
+template<typename TSeq>
+inline Model<TSeq>::Model(Model<TSeq> && model) :
+    name(std::move(model.name)),
+    db(std::move(model.db)),
+    population(std::move(model.population)),
+    agents_state(std::move(model.agents_state)),
+    network(std::move(model.network)),
+    network_backup(std::move(model.network_backup)),
+    agents_data(std::move(model.agents_data)),
+    agents_data_ncols(std::move(model.agents_data_ncols)),
+    directed(std::move(model.directed)),
+    // Virus
+    viruses(std::move(model.viruses)),
+    // Tools
+    tools(std::move(model.tools)),
+    // Entities
+    entities(std::move(model.entities)),
+    // Pseudo-RNG
+    engine(std::move(model.engine)),
+    rng_seed(model.rng_seed),
+    use_runif_batch(model.use_runif_batch),
+    engine_batch(model.engine_batch),
+    runif_buffer(std::move(model.runif_buffer)),
+    runif_buffer_pos(model.runif_buffer_pos),
+    runifd_a(model.runifd_a),
+    runifd_b(model.runifd_b),
+    rnormd(std::move(model.rnormd)),
+    rgammad(std::move(model.rgammad)),
+    rlognormald(std::move(model.rlognormald)),
+    rexpd(std::move(model.rexpd)),
+    rbinomd(std::move(model.rbinomd)),
+    rbinomd_n(model.rbinomd_n),
+    rbinomd_fast_lambda(model.rbinomd_fast_lambda),
+    rbinomd_use_poisson(model.rbinomd_use_poisson),
+    // Rewiring
+    rewire_fun(std::move(model.rewire_fun)),
+    rewire_prop(std::move(model.rewire_prop)),
+    parameters(std::move(model.parameters)),
+    // Others
+    ndays(model.ndays),
+    pb(std::move(model.pb)),
+    state_fun(std::move(model.state_fun)),
+    states_labels(std::move(model.states_labels)),
+    initial_states_fun(std::move(model.initial_states_fun)),
+    nstates(model.nstates),
+    verbose(model.verbose),
+    current_date(std::move(model.current_date)),
+    globalevents(std::move(model.globalevents)),
+    queue(std::move(model.queue)),
+    use_queuing(model.use_queuing),
+    sim_id(model.sim_id),
+    aggregated(model.aggregated),
+    aggregated_sizes(model.aggregated_sizes),
+    contact_tracing(std::move(model.contact_tracing)),
+    use_contact_tracing(model.use_contact_tracing),
+    contact_tracing_max_contacts(model.contact_tracing_max_contacts),
+    events_by_agent(model.events_by_agent),
+    fast_forward(model.fast_forward),
+    absorbing_fun(model.absorbing_fun),
+    use_parallel_update(model.use_parallel_update),
+    parallel_update_nthreads(model.parallel_update_nthreads)
+{
+
+    db.model = this;
+    db.user_data.model = this;
+
+    if (use_queuing)
+        queue.model = this;
+
+    parameters_ptrs_update();
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::operator=(const Model<TSeq> & m)
+{
+    if (this == &m)
+        return *this;
+
+    name = m.name;
+
+    population        = m.population;
+    agents_state      = m.agents_state;
+    network           = m.network;
+    network_backup    = m.network_backup;
+
+    db = m.db;
+    db.model = this;
+    db.user_data.model = this;
+
+    directed = m.directed;
+
+    viruses.clear();
+    viruses.reserve(m.viruses.size());
+    for (const auto & v : m.viruses)
+        viruses.emplace_back(std::shared_ptr<Virus<TSeq>>(v->clone_ptr()));
+
+    tools.clear();
+    tools.reserve(m.tools.size());
+    for (const auto & t : m.tools)
+        tools.emplace_back(std::shared_ptr<Tool<TSeq>>(t->clone_ptr()));
+
+    entities        = m.entities;
+
+    rewire_fun  = m.rewire_fun;
+    rewire_prop = m.rewire_prop;
+
+    parameters = m.parameters;
+    parameters_ptrs_update();
+    ndays      = m.ndays;
+    pb         = m.pb;
+
+    state_fun    = m.state_fun;
+    states_labels = m.states_labels;
+    initial_states_fun = m.initial_states_fun;
+    nstates       = m.nstates;
+
+    verbose     = m.verbose;
+
+    current_date = m.current_date;
+
+    globalevents.clear();
+    globalevents.reserve(m.globalevents.size());
+    for (const auto & ge : m.globalevents)
+        globalevents.emplace_back(std::shared_ptr<GlobalEvent<TSeq>>(ge->clone_ptr()));
+
+    queue = m.queue;
+    use_queuing = m.use_queuing;
+
+    aggregated = m.aggregated;
+    aggregated_sizes = m.aggregated_sizes;
+
+    contact_tracing = m.contact_tracing
+        ? std::make_unique<ContactTracing>(*m.contact_tracing)
+        : nullptr;
+    use_contact_tracing = m.use_contact_tracing;
+    contact_tracing_max_contacts = m.contact_tracing_max_contacts;
+
+    events_by_agent = m.events_by_agent;
+    fast_forward = m.fast_forward;
+    absorbing_fun = m.absorbing_fun;
+    use_parallel_update = m.use_parallel_update;
+    parallel_update_nthreads = m.parallel_update_nthreads;
+    use_runif_batch = m.use_runif_batch;
+
+    agents_data = m.agents_data;
+    agents_data_ncols = m.agents_data_ncols;
+
+    // The random numbers continue where those of m are
+    *engine = *m.engine;
+    rng_seed = m.rng_seed;
+    last_seed = m.last_seed;
+    engine_batch = m.engine_batch;
+    runif_buffer = m.runif_buffer;
+    runif_buffer_pos = m.runif_buffer_pos;
+    runifd_a = m.runifd_a;
+    runifd_b = m.runifd_b;
+    rnormd = m.rnormd;
+    rgammad = m.rgammad;
+    rlognormald = m.rlognormald;
+    rexpd = m.rexpd;
+    rbinomd = m.rbinomd;
+    rbinomd_n = m.rbinomd_n;
+    rbinomd_fast_lambda = m.rbinomd_fast_lambda;
+    rbinomd_use_poisson = m.rbinomd_use_poisson;
+    rnbinomd = m.rnbinomd;
+    rgeomd = m.rgeomd;
+    rpoissd = m.rpoissd;
+
+    // Figure out the queuing
+    if (use_queuing)
+        queue.model = this;
+
+    sim_id = m.sim_id;
+    // Entity-agent relationships now use size_t IDs, so they copy
+    // correctly without any rebinding needed.
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline DataBase<TSeq> & Model<TSeq>::get_db()
+{
+    return db;
+}
+
+template<typename TSeq>
+inline const DataBase<TSeq> & Model<TSeq>::get_db() const
+{
+    return db;
+}
+
+
+template<typename TSeq>
+inline std::vector<Agent<TSeq>> & Model<TSeq>::get_agents()
+{
+    return population;
+}
+
+template<typename TSeq>
+inline const Network & Model<TSeq>::get_network() const
+{
+    return *network;
+}
+
+template<typename TSeq>
+inline Network & Model<TSeq>::get_network_mutable()
+{
+
+    // Shared with a clone or the backup, so we need our own copy
+    if (network.use_count() > 1)
+        network = std::make_shared< Network >(*network);
+
+    return *network;
+
+}
+
+template<typename TSeq>
+inline Agent<TSeq> & Model<TSeq>::get_agent(size_t i)
+{
+    return population[i];
+}
+
+template<typename TSeq>
+inline std::vector< epiworld_fast_uint > Model<TSeq>::get_agents_states() const
+{
+    return std::vector< epiworld_fast_uint >(
+        agents_state.begin(), agents_state.end()
+    );
+}
+
+template<typename TSeq>
+inline std::vector< Viruses_const<TSeq> > Model<TSeq>::get_agents_viruses() const
+{
+
+    std::vector< Viruses_const<TSeq> > viruses(population.size());
+    for (size_t i = 0u; i < population.size(); ++i)
+        viruses[i] = population[i].get_virus();
+
+    return viruses;
+
+}
+
+// Same as before, but the non const version
+template<typename TSeq>
+inline std::vector< Viruses<TSeq> > Model<TSeq>::get_agents_viruses()
+{
+
+    std::vector< Viruses<TSeq> > viruses(population.size());
+    for (size_t i = 0u; i < population.size(); ++i)
+        viruses[i] = population[i].get_virus();
+
+    return viruses;
+
+}
+
+template<typename TSeq>
+inline std::vector<Entity<TSeq>> & Model<TSeq>::get_entities()
+{
+    return entities;
+}
+
+template<typename TSeq>
+inline Entity<TSeq> & Model<TSeq>::get_entity(size_t i, int * entity_pos)
+{
+
+    for (size_t j = 0u; j < entities.size(); ++j)
+        if (entities[j].get_id() == static_cast<int>(i))
+        {
+
+            if (entity_pos)
+                *entity_pos = j;
+
+            return entities[j];
+
+        }
+
+    throw std::range_error("The entity with id " + std::to_string(i) + " was not found.");
+
+}
+
+template<typename TSeq>
+inline const Entity<TSeq> & Model<TSeq>::get_entity(size_t i, int * entity_pos) const
+{
+    for (size_t j = 0u; j < entities.size(); ++j)
+        if (entities[j].get_id() == static_cast<int>(i))
+        {
+
+            if (entity_pos)
+                *entity_pos = j;
+
+            return entities[j];
+
+        }
+
+    throw std::range_error("The entity with id " + std::to_string(i) + " was not found.");
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::agents_smallworld(
+    epiworld_fast_uint n,
+    epiworld_fast_uint k,
+    bool d,
+    epiworld_double p
+)
+{
+
+    agents_from_adjlist(
+        rgraph_smallworld(n, k, p, d, *this)
+    );
+
+    return *this;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::agents_empty_graph(
+    epiworld_fast_uint n
+)
+{
+
+
+    // Resizing the people
+    population.clear();
+    population.resize(n);
+    agents_state.assign(n, 0u);
+    network = std::make_shared< Network >(n);
+
+    // A new network invalidates the backup
+    network_backup = nullptr;
+
+    // Filling the model and ids
+    size_t i = 0u;
+    for (auto & p : population)
+    {
+        p.id = i++;
+    }
+
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::agents_sbm(
+    const std::vector< size_t > & block_sizes,
+    const std::vector< double > & mixing_matrix,
+    bool row_major
+)
+{
+
+    agents_from_adjlist(
+        rgraph_sbm(block_sizes, mixing_matrix, row_major, *this)
+    );
+
+    return *this;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::agents_bernoulli(
+    epiworld_fast_uint n,
+    epiworld_double p,
+    bool d
+)
+{
+
+    agents_from_adjlist(
+        rgraph_bernoulli(n, p, d, *this)
+    );
+
+    return *this;
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::operator()(std::string pname) {
+
+    const auto iter = parameters.find(pname);
+    if (iter == parameters.end())
+        throw std::range_error("The parameter '"+ pname + "' is not in the model.");
+
+    return iter->second;
+
+}
+
+template<typename TSeq>
+inline size_t Model<TSeq>::size() const {
+    return population.size();
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::dist_virus()
+{
+
+    for (auto & v: viruses)
+    {
+
+        v->distribute(this);
+
+        // Apply the events
+        events_run();
+    }
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::dist_tools()
+{
+
+    for (auto & tool: tools)
+    {
+
+        tool->distribute(this);
+
+        // Apply the events
+        events_run();
+
+    }
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::dist_entities()
+{
+
+    for (auto & entity: entities)
+    {
+
+        entity.distribute(this);
+
+        // Apply the events
+        events_run();
+
+    }
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::chrono_start() {
+    profile.reset();
+    time_start = std::chrono::steady_clock::now();
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::chrono_end() {
+    time_end = std::chrono::steady_clock::now();
+    time_elapsed += (time_end - time_start);
+    n_replicates++;
+    profile_total += profile;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_backup()
+{
+
+    // No copy is made here; the backup shares the network until
+    // the network is modified (e.g., by rewiring).
+    if (!network_backup)
+        network_backup = network;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::add_virus(
+    Virus<TSeq> & v
+    )
+{
+
+    // Checking the state
+    epiworld_fast_int init_, post_, rm_;
+    v.get_state(&init_, &post_, &rm_);
+
+    if (init_ == -99)
+        throw std::logic_error(
+            "The virus \"" + v.get_name() + "\" has no -init- state."
+            );
+    else if (post_ == -99)
+        throw std::logic_error(
+            "The virus \"" + v.get_name() + "\" has no -post- state."
+            );
+
+    // Recording the variant
+    db.record_virus(v);
+
+    // Adding new virus
+    auto cloned = v.clone_ptr();
+    viruses.push_back(std::shared_ptr<Virus<TSeq>>(std::move(cloned)));
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::add_tool(Tool<TSeq> & t)
+{
+
+
+    db.record_tool(t);
+
+    // Adding the tool to the model (and database.)
+    auto cloned = t.clone_ptr();
+    tools.push_back(std::shared_ptr<Tool<TSeq>>(std::move(cloned)));
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::add_entity(Entity<TSeq> e)
+{
+
+    e.id = entities.size();
+    entities.push_back(e);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::rm_entity(size_t entity_id)
+{
+
+    int entity_pos = 0;
+    auto & entity = this->get_entity(entity_id, &entity_pos);
+
+    // First, resetting the entity
+    entity.reset();
+
+    // How should
+    if (entity_pos != (static_cast<int>(entities.size()) - 1))
+        std::swap(entities[entity_pos], entities[entities.size() - 1]);
+
+    entities.pop_back();
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::rm_virus(size_t virus_pos)
+{
+
+    if (viruses.size() <= virus_pos)
+        throw std::range_error(
+            std::string("The specified virus (") +
+            std::to_string(virus_pos) +
+            std::string(") is out of range. ") +
+            std::string("There are only ") +
+            std::to_string(viruses.size()) +
+            std::string(" viruses.")
+            );
+
+    // Flipping with the last one
+    std::swap(viruses[virus_pos], viruses[viruses.size() - 1]);
+    viruses.pop_back();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::rm_tool(size_t tool_pos)
+{
+
+    if (tools.size() <= tool_pos)
+        throw std::range_error(
+            std::string("The specified tool (") +
+            std::to_string(tool_pos) +
+            std::string(") is out of range. ") +
+            std::string("There are only ") +
+            std::to_string(tools.size()) +
+            std::string(" tools.")
+            );
+
+    // Flipping with the last one
+    std::swap(tools[tool_pos], tools[tools.size() - 1]);
+
+    /* There's an error on windows:
+    https://github.com/UofUEpiBio/epiworldR/actions/runs/4801482395/jobs/8543744180#step:6:84
+
+    More clear here:
+    https://stackoverflow.com/questions/58660207/why-doesnt-stdswap-work-on-vectorbool-elements-under-clang-win
+    */
+
+    tools.pop_back();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::load_agents_entities_ties(
+    std::string fn,
+    int skip
+    )
+{
+
+
+    int i,j;
+    std::ifstream filei(fn);
+
+    if (!filei)
+        throw std::logic_error("The file " + fn + " was not found.");
+
+    int linenum = 0;
+    std::vector< std::vector< epiworld_fast_uint > > target_(entities.size());
+
+    target_.reserve(1e5);
+
+    while (!filei.eof())
+    {
+
+        if (linenum++ < skip)
+            continue;
+
+        filei >> i >> j;
+
+        // Looking for exceptions
+        if (filei.bad())
+            throw std::logic_error(
+                "I/O error while reading the file " +
+                fn
+            );
+
+        if (filei.fail())
+            break;
+
+        if (i >= static_cast<int>(this->size()))
+            throw std::range_error(
+                "The agent["+std::to_string(linenum)+"] = " + std::to_string(i) +
+                " is above the max id " + std::to_string(this->size() - 1)
+                );
+
+        if (j >= static_cast<int>(this->entities.size()))
+            throw std::range_error(
+                "The entity["+std::to_string(linenum)+"] = " + std::to_string(j) +
+                " is above the max id " + std::to_string(this->entities.size() - 1)
+                );
+
+        target_[j].push_back(i);
+
+        population[i].add_entity(*this, entities[j]);
+
+    }
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::load_agents_entities_ties(
+    const std::vector< int > & agents_ids,
+    const std::vector< int > & entities_ids
+) {
+
+
+    // Checking the size
+    if (agents_ids.size() != entities_ids.size())
+        throw std::length_error(
+            std::string("The size of agents_ids (") +
+            std::to_string(agents_ids.size()) +
+            std::string(") and entities_ids (") +
+            std::to_string(entities_ids.size()) +
+            std::string(") must be the same.")
+            );
+
+    return this->load_agents_entities_ties(
+        agents_ids.data(),
+        entities_ids.data(),
+        agents_ids.size()
+    );
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::load_agents_entities_ties(
+    const int * agents_ids,
+    const int * entities_ids,
+    size_t n
+) {
+
+
+    auto get_agent = [agents_ids](int i) -> int {
+        return *(agents_ids + i);
+        };
+
+    auto get_entity = [entities_ids](int i) -> int {
+        return *(entities_ids + i);
+        };
+
+    for (size_t i = 0u; i < n; ++i)
+    {
+
+        if (get_agent(i) < 0)
+            throw std::length_error(
+                std::string("agents_ids[") +
+                std::to_string(i) +
+                std::string("] = ") +
+                std::to_string(get_agent(i)) +
+                std::string(" is negative.")
+                );
+
+        if (get_entity(i) < 0)
+            throw std::length_error(
+                std::string("entities_ids[") +
+                std::to_string(i) +
+                std::string("] = ") +
+                std::to_string(get_entity(i)) +
+                std::string(" is negative.")
+                );
+
+        int pop_size = static_cast<int>(this->population.size());
+        if (get_agent(i) >= pop_size)
+            throw std::length_error(
+                std::string("agents_ids[") +
+                std::to_string(i) +
+                std::string("] = ") +
+                std::to_string(get_agent(i)) +
+                std::string(" is out of range (population size: ") +
+                std::to_string(pop_size) +
+                std::string(").")
+                );
+
+        int ent_size = static_cast<int>(this->entities.size());
+        if (get_entity(i) >= ent_size)
+            throw std::length_error(
+                std::string("entities_ids[") +
+                std::to_string(i) +
+                std::string("] = ") +
+                std::to_string(get_entity(i)) +
+                std::string(" is out of range (entities size: ") +
+                std::to_string(ent_size) +
+                std::string(").")
+                );
+
+        // Adding the entity to the agent
+        this->population[get_agent(i)].add_entity(
+            *this,
+            this->entities[get_entity(i)]
+        );
+
+    }
+
+    return;
+
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::agents_from_adjlist(
+    std::string fn,
+    int size,
+    int skip,
+    bool directed
+    ) {
+
+
+    AdjList al;
+    al.read_edgelist(fn, size, skip, directed);
+    this->agents_from_adjlist(al);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::agents_from_edgelist(
+    const std::vector< int > & source,
+    const std::vector< int > & target,
+    int size,
+    bool directed
+) {
+
+
+    AdjList al(source, target, size, directed);
+    agents_from_adjlist(al);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::agents_from_adjlist(AdjList al) {
+
+
+    // Resizing the people
+    agents_empty_graph(al.vcount());
+
+    // Building the network and updating the degrees
+    auto & net = get_network_mutable();
+    net.build(al);
+    for (auto & p: population)
+        p.n_neighbors = net.degree(p.id);
+
+    #ifdef EPI_DEBUG
+    for (auto & p: population)
+    {
+        if (p.id >= static_cast<int>(al.vcount()))
+            throw std::logic_error(
+                "Agent's id cannot be negative above or equal to the number of agents!");
+    }
+    #endif
+
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::is_directed() const
+{
+    if (population.size() == 0u)
+        throw std::logic_error("The population hasn't been initialized.");
+
+    return directed;
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::today() const {
+
+    if (ndays == 0)
+      return 0;
+
+    return this->current_date;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::next() {
+
+    #ifdef EPI_DEBUG
+    // Checking all the agents have proper states
+    for (auto & p : population)
+    {
+        if ((p.state >= nstates) || (p.state < 0))
+        {
+            throw std::range_error(
+                "The agent " + std::to_string(p.id) +
+                " has state " + std::to_string(p.state) +
+                " which is above the maximum state of " +
+                std::to_string(nstates - 1) + "."
+            );
+        }
+
+        if ((p.state_prev >= nstates) || (p.state_prev < 0))
+        {
+            throw std::range_error(
+                "The agent " + std::to_string(p.id) +
+                " has previous state " + std::to_string(p.state_prev) +
+                " which is above the maximum state of " +
+                std::to_string(nstates - 1) + "."
+            );
+        }
+
+    }
+
+    #endif
+
+    {
+        EPI_PROFILE_SCOPE(profile, Record)
+        db.record();
+    }
+
+    ++this->current_date;
+
+    // Advancing the progress bar
+    if ((this->current_date >= 1) && verbose)
+        pb.next();
+
+    return ;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::run_setup(
+    epiworld_fast_uint ndays,
+    int seed
+)
+{
+
+    // Set this model as the current model in scope for this thread.
+    // This enables Model::the() calls from agents, entities, etc.
+
+    if (size() == 0u)
+        throw std::logic_error("There are no agents in this model!");
+
+    if (nstates == 0u)
+        throw std::logic_error(
+            std::string("No states registered in this model. ") +
+            std::string("At least one state should be included. See the ") +
+            std::string("function -Model::add_state()-")
+            );
+
+    // Setting up the number of steps
+    this->ndays = ndays;
+
+    if (seed >= 0)
+        this->seed(static_cast< size_t >(seed));
+
+    last_seed = seed;
+
+    // Binding the parameters added through `params()` (par(id) only reads)
+    parameters_ptrs_update();
+
+    // Checking whether the proposed state in/out/removed
+    // are valid
+    epiworld_fast_int _init, _end, _removed;
+    int nstate_int = static_cast<int>(nstates);
+
+    // Function to validate the states of viruses
+    // and tools.
+    auto check_init_states = [nstate_int](int x) -> void {
+
+        if (((x != -99) && (x < 0)) || (x >= nstate_int))
+            throw std::range_error("States must be between 0 and " +
+                std::to_string(nstate_int - 1));
+    };
+
+    for (auto & v : viruses)
+    {
+        v->get_state(&_init, &_end, &_removed);
+
+        check_init_states(_init);
+        check_init_states(_end);
+        check_init_states(_removed);
+
+    }
+
+    for (auto & t : tools)
+    {
+        t->get_state(&_init, &_end);
+
+        check_init_states(_init);
+        check_init_states(_end);
+
+    }
+
+    // Starting first infection and tools
+    reset();
+
+    // Record the baseline (day 0) and advance to day 1
+    next();
+
+    // Initializing the simulation
+    chrono_start();
+
+    // Verifying if the user wants to see the progress bar
+    if (get_verbose())
+    {
+        printf_epiworld("Running the model...\n");
+    }
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::run(
+    epiworld_fast_uint ndays,
+    int seed
+)
+{
+
+    if (aggregated)
+    {
+
+        if (seed >= 0)
+            this->seed(static_cast< size_t >(seed));
+
+        last_seed = seed;
+
+        // The binomial keeps cached draws (large n), which would make the
+        // run depend on the previous one
+        rbinomd.reset();
+
+        return run_aggregated(ndays);
+
+    }
+
+    run_setup(ndays, seed);
+
+    run_days(get_ndays());
+
+    // The last reaches the end...
+    this->current_date--;
+
+    chrono_end();
+
+    sim_id++;
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::run_days(epiworld_fast_uint ndays)
+{
+
+    for (epiworld_fast_uint niter = 0; niter < ndays; ++niter)
+    {
+
+        #ifdef EPI_DEBUG
+        db.n_transmissions_potential = 0;
+        db.n_transmissions_today = 0;
+        #endif
+
+        // We can execute these components in whatever order the
+        // user needs.
+        this->update_state();
+
+        // We start with the Global events
+        this->run_globalevents();
+
+        // In this case we are applying degree sequence rewiring
+        // to change the network just a bit.
+        this->rewire();
+
+        // This locks all the changes
+        this->next();
+
+        // Mutation must happen at the very end of all
+        this->mutate_virus();
+
+        // Nothing else can happen, so only the records are left
+        if (fast_forward && (niter + 1u < ndays) && is_absorbing())
+        {
+
+            for (++niter; niter < ndays; ++niter)
+                this->next();
+
+            break;
+
+        }
+
+    }
+
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::is_aggregated() const
+{
+    return aggregated;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::aggregated_enable(std::vector< size_t > group_sizes)
+{
+
+    // Counts are kept as int (as the database)
+    size_t n = 0u;
+    for (auto s : group_sizes)
+    {
+
+        if (s == 0u)
+            throw std::invalid_argument("Group sizes must be positive.");
+
+        n += s;
+        if (n > static_cast< size_t >(std::numeric_limits< int >::max()))
+            throw std::range_error(
+                "The total of the group sizes cannot be above " +
+                std::to_string(std::numeric_limits< int >::max()) + "."
+            );
+
+    }
+
+    aggregated_sizes = std::move(group_sizes);
+    aggregated = true;
+
+    // Releasing the agents
+    agents_empty_graph(0u);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::aggregated_disable()
+{
+
+    if (!aggregated)
+        return;
+
+    size_t n = 0u;
+    for (auto s : aggregated_sizes)
+        n += s;
+
+    aggregated = false;
+    agents_empty_graph(n);
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::run_aggregated(epiworld_fast_uint)
+{
+    throw std::logic_error(
+        "The model '" + name + "' cannot run on counts."
+    );
+}
+
+template<typename TSeq>
+inline std::vector< int > Model<TSeq>::aggregated_split(
+    epiworld_double prevalence
+)
+{
+
+    size_t n = 0u;
+    for (auto s : aggregated_sizes)
+        n += s;
+
+    int n_left = static_cast< int >(
+        std::floor(prevalence * static_cast< epiworld_double >(n))
+    );
+    size_t size_left = n;
+
+    std::vector< int > cases(aggregated_sizes.size());
+    for (size_t g = 0u; g < aggregated_sizes.size(); ++g)
+    {
+
+        int size_g = static_cast< int >(aggregated_sizes[g]);
+        cases[g] = rbinom(
+            n_left,
+            static_cast< epiworld_double >(size_g) /
+                static_cast< epiworld_double >(size_left)
+        );
+
+        if (cases[g] > size_g)
+            cases[g] = size_g;
+
+        n_left    -= cases[g];
+        size_left -= aggregated_sizes[g];
+
+    }
+
+    return cases;
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::aggregated_escape(
+    const ContactMatrix & contact_matrix,
+    size_t i,
+    const std::vector< int > & I,
+    epiworld_double p_transmit
+) const
+{
+
+    epiworld_double log_escape = 0.0;
+    for (size_t g = 0u; g < aggregated_sizes.size(); ++g)
+    {
+
+        if (I[g] == 0)
+            continue;
+
+        epiworld_double p_contact =
+            contact_matrix.get_contact_rate(i, g, false) /
+            static_cast< epiworld_double >(aggregated_sizes[g]);
+
+        if (p_contact > 1.0)
+            p_contact = 1.0;
+
+        log_escape +=
+            static_cast< epiworld_double >(I[g]) *
+            std::log1p(-p_transmit * p_contact);
+
+    }
+
+    return std::exp(log_escape);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::aggregated_setup(
+    epiworld_fast_uint ndays,
+    const std::vector< int > & totals,
+    const std::vector< bool > & with_virus
+)
+{
+
+    if ((totals.size() != nstates) || (with_virus.size() != nstates))
+        throw std::length_error(
+            "The number of totals (" + std::to_string(totals.size()) +
+            ") must match the number of states (" +
+            std::to_string(nstates) + ")."
+        );
+
+    if (viruses.size() == 0u)
+        throw std::logic_error("Aggregated runs need at least one virus.");
+
+    this->ndays = ndays;
+
+    pb = Progress(ndays, 80);
+    current_date = 0;
+
+    // The counts are set by hand, as there are no agents
+    db.reset();
+    aggregated_with_virus = with_virus;
+    for (epiworld_fast_uint s = 0u; s < nstates; ++s)
+    {
+
+        db.today_total[s] = totals[s];
+        db.transition_matrix[s + s * nstates] = totals[s];
+
+        if (with_virus[s])
+            db.today_virus[0u][s] = totals[s];
+
+    }
+
+    // Record the baseline (day 0) and advance to day 1
+    next();
+
+    chrono_start();
+
+    if (get_verbose())
+    {
+        printf_epiworld("Running the model...\n");
+    }
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::aggregated_move(
+    epiworld_fast_uint from,
+    epiworld_fast_uint to,
+    int n
+)
+{
+
+    if (n == 0)
+        return;
+
+    db.today_total[from] -= n;
+    db.today_total[to]   += n;
+    db.transition_matrix[to * nstates + from]   += n;
+    db.transition_matrix[from * nstates + from] -= n;
+
+    if (aggregated_with_virus[from])
+        db.today_virus[0u][from] -= n;
+
+    if (aggregated_with_virus[to])
+        db.today_virus[0u][to] += n;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::aggregated_end()
+{
+
+    // The last reaches the end...
+    this->current_date--;
+
+    chrono_end();
+
+    sim_id++;
+
+}
+
+template<typename TSeq>
+inline size_t Model<TSeq>::run_jobs(
+    size_t njobs,
+    #ifdef _OPENMP
+    int nthreads,
+    #else
+    int,
+    #endif
+    std::function<void(size_t,Model<TSeq>*)> job,
+    std::function<void(size_t,Model<TSeq>*)> fun,
+    Progress & pb,
+    bool verbose
+)
+{
+
+    #ifdef _OPENMP
+
+    omp_set_num_threads(nthreads);
+
+    // Generating copies of the model (done serially to avoid races on original)
+    std::vector< std::unique_ptr< Model<TSeq> > > these;
+    for (size_t i = 1u; i < static_cast<size_t>(nthreads); ++i)
+        these.emplace_back(clone_ptr());
+
+    #ifdef EPI_DEBUG
+    // Checking the initial state of all the models. Throw an
+    // exception if they are not the same.
+    for (size_t i = 1; i < static_cast<size_t>(std::max(nthreads - 1, 0)); ++i)
+    {
+
+        if (db != these[i]->db)
+        {
+            throw std::runtime_error(
+                "The initial state of the models is not the same"
+            );
+        }
+    }
+    #endif
+
+    // Jobs are handed out dynamically (next free id), since their
+    // runtimes vary a lot
+    size_t next_job    = 0u;
+    size_t n_done      = 0u;
+    size_t n_done_here = 0u;
+    size_t n_ticks     = 0u;
+    Model<TSeq> * last_model = this;
+
+    #pragma omp parallel shared(these, next_job, n_done, n_done_here, \
+        n_ticks, pb, job, fun, last_model) firstprivate(verbose, njobs) \
+        default(none)
+    {
+
+        auto iam = static_cast<size_t>(omp_get_thread_num());
+        Model<TSeq> * model_ptr = iam == 0 ? this : &(*these[iam - 1u]);
+
+        while (true)
+        {
+
+            size_t job_id;
+            #pragma omp atomic capture
+            job_id = next_job++;
+
+            if (job_id >= njobs)
+                break;
+
+            if (iam == 0)
+            {
+
+                // Checking if the user interrupted the simulation
+                EPI_CHECK_USER_INTERRUPT(n_done_here);
+
+            }
+
+            job(job_id, model_ptr);
+
+            if (job_id == (njobs - 1u))
+                last_model = model_ptr;
+
+            if (fun)
+            {
+                // User callbacks often write into shared result containers.
+                // Serialize callback execution to avoid callback-induced races.
+                #pragma omp critical(epiworld_run_multiple_fun)
+                {
+                    fun(job_id, model_ptr);
+                }
+            }
+
+            #pragma omp atomic
+            n_done++;
+
+            if (iam == 0)
+            {
+
+                n_done_here++;
+
+                // Only the first one prints
+                if (verbose)
+                {
+                    size_t n_done_now;
+                    #pragma omp atomic read
+                    n_done_now = n_done;
+
+                    for (; n_ticks < n_done_now; ++n_ticks)
+                        pb.next();
+                }
+
+            }
+
+        }
+
+    }
+
+    if (verbose)
+        for (; n_ticks < njobs; ++n_ticks)
+            pb.next();
+
+    // The model ends with the state of the last job
+    if (last_model != this)
+    {
+
+        std::stringstream derived(
+            std::ios_base::in | std::ios_base::out | std::ios_base::binary
+        );
+        last_model->write_checkpoint_derived(derived);
+
+        Model<TSeq>::operator=(*last_model);
+
+        profile = last_model->profile;
+
+        read_checkpoint_derived_keep_rng(derived);
+
+    }
+
+    for (auto & m : these)
+        profile_total += m->profile_total;
+
+    return n_done_here;
+
+    #else
+
+    for (size_t n = 0u; n < njobs; ++n)
+    {
+
+        // Checking if the user interrupted the simulation
+        EPI_CHECK_USER_INTERRUPT(n);
+
+        job(n, this);
+
+        if (fun)
+            fun(n, this);
+
+        if (verbose)
+            pb.next();
+
+    }
+
+    return njobs;
+
+    #endif
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::run_multiple(
+    epiworld_fast_uint ndays,
+    epiworld_fast_uint nexperiments,
+    int seed_,
+    std::function<void(size_t,Model<TSeq>*)> fun,
+    bool reset,
+    bool verbose,
+    #ifdef _OPENMP
+    int nthreads
+    #else
+    int
+    #endif
+)
+{
+
+    if (seed_ >= 0)
+        this->seed(seed_);
+
+    if (nexperiments == 0u)
+        throw std::logic_error("The number of experiments must be above 0.");
+
+    // Seeds will be reproducible by default
+    std::vector< int > seeds_n(nexperiments);
+    for (auto & s : seeds_n)
+    {
+        s = static_cast<int>(
+            std::floor(
+                runif() * static_cast<double>(std::numeric_limits<int>::max())
+                )
+        );
+    }
+    // #endif
+
+    if (verbose)
+    {
+        EPI_DEBUG_NOTIFY_ACTIVE()
+    }
+
+    bool old_verb = this->verbose;
+    verbose_off();
+
+    // Setting up backup
+    if (reset)
+        set_backup();
+
+    Progress pb_multiple(
+        static_cast<int>(nexperiments),
+        EPIWORLD_PROGRESS_BAR_WIDTH
+        );
+
+    #ifdef _OPENMP
+    // Not more than the number of experiments
+    nthreads =
+        static_cast<size_t>(nthreads) > nexperiments ? nexperiments : nthreads;
+    #endif
+
+    if (verbose)
+    {
+
+        #ifdef _OPENMP
+        printf_epiworld(
+            "Starting multiple runs (%i) using %i thread(s)\n",
+            static_cast<int>(nexperiments),
+            static_cast<int>(nthreads)
+        );
+        #else
+        printf_epiworld(
+            "Starting multiple runs (%i)\n",
+            static_cast<int>(nexperiments)
+        );
+        #endif
+
+        pb_multiple.start();
+
+    }
+
+    // Seeds are bound to the replicate id, so the results don't depend on
+    // which thread runs which replicate
+    auto run_replicate = [&seeds_n, ndays](size_t run_id, Model<TSeq> * model) -> void {
+        model->set_sim_id(run_id);
+        model->run(ndays, seeds_n[run_id]);
+    };
+
+    size_t n_done_here = run_jobs(
+        nexperiments,
+        #ifdef _OPENMP
+        nthreads,
+        #else
+        1,
+        #endif
+        run_replicate, fun, pb_multiple, verbose
+    );
+
+    // Adjusting the number of replicates (run() counts those of this model)
+    n_replicates += (nexperiments - n_done_here);
+
+    if (old_verb)
+        verbose_on();
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::update_state() {
+
+    EPI_PROFILE_SCOPE(profile, UpdateState)
+
+    if (use_parallel_update)
+    {
+        update_state_parallel();
+        events_run();
+        return;
+    }
+
+    // Built-in models skip the std::function calls
+    if (update_state_static())
+    {
+        events_run();
+        return;
+    }
+
+    // Next state
+    if (use_queuing)
+    {
+
+        // Only agents in the queue (in ascending order)
+        const auto & active = queue.get_active_agents();
+        EPI_PROFILE_ADD(profile, AgentsVisited, active.size())
+        for (size_t i = 0u; i < active.size(); ++i)
+        {
+            const auto & fun = state_fun[agents_state[active[i]]];
+            if (fun)
+            {
+                EPI_PROFILE_ADD(profile, StateFunCalls, 1u)
+                fun(&population[active[i]], this);
+            }
+        }
+
+    }
+    else
+    {
+
+        // Agents in states without an update function aren't loaded
+        EPI_PROFILE_ADD(profile, AgentsVisited, population.size())
+        for (size_t i = 0u; i < agents_state.size(); ++i)
+        {
+            const auto & fun = state_fun[agents_state[i]];
+            if (fun)
+            {
+                EPI_PROFILE_ADD(profile, StateFunCalls, 1u)
+                fun(&population[i], this);
+            }
+        }
+
+    }
+
+    events_run();
+
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::update_state_static()
+{
+    return false;
+}
+
+template<typename TSeq>
+template<UpdateFunPtr<TSeq>... Funs>
+inline bool Model<TSeq>::update_state_table()
+{
+
+    constexpr size_t nfuns = sizeof...(Funs);
+    const UpdateFunPtr<TSeq> funs[nfuns] = {Funs...};
+
+    // Only if the states still have the model's own functions
+    if (state_fun.size() < nfuns)
+        return false;
+
+    for (size_t s = 0u; s < nfuns; ++s)
+        if (!state_fun_is(s, funs[s]))
+            return false;
+
+    if (use_queuing)
+    {
+
+        const auto & active = queue.get_active_agents();
+        EPI_PROFILE_ADD(profile, AgentsVisited, active.size())
+        for (size_t i = 0u; i < active.size(); ++i)
+            if (state_fun[agents_state[active[i]]])
+                update_state_dispatch<0u, Funs...>(population[active[i]]);
+
+    }
+    else
+    {
+
+        EPI_PROFILE_ADD(profile, AgentsVisited, population.size())
+        for (size_t i = 0u; i < agents_state.size(); ++i)
+            if (state_fun[agents_state[i]])
+                update_state_dispatch<0u, Funs...>(population[i]);
+
+    }
+
+    return true;
+
+}
+
+template<typename TSeq>
+template<size_t I, UpdateFunPtr<TSeq> Fun, UpdateFunPtr<TSeq>... Funs>
+inline void Model<TSeq>::update_state_dispatch(Agent<TSeq> & p)
+{
+
+    if (p.state == I)
+    {
+        if constexpr (Fun != nullptr)
+        {
+            EPI_PROFILE_ADD(profile, StateFunCalls, 1u)
+            Fun(&p, this);
+        }
+
+        return;
+    }
+
+    if constexpr (sizeof...(Funs) > 0u)
+        update_state_dispatch<I + 1u, Funs...>(p);
+    else if (state_fun[p.state])
+    {
+        EPI_PROFILE_ADD(profile, StateFunCalls, 1u)
+        state_fun[p.state](&p, this); // States added by the user
+    }
+
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::state_fun_is(
+    epiworld_fast_uint state,
+    UpdateFunPtr<TSeq> fun
+) const
+{
+
+    const auto & f = state_fun[state];
+
+    if (fun == nullptr)
+        return !f;
+
+    const UpdateFunPtr<TSeq> * target = f.template target< UpdateFunPtr<TSeq> >();
+    return (target != nullptr) && (*target == fun);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::update_state_parallel() {
+
+    const std::vector< size_t > * active = use_queuing ?
+        &queue.get_active_agents() : nullptr;
+
+    const size_t n = (active != nullptr) ? active->size() : population.size();
+    EPI_PROFILE_ADD(profile, AgentsVisited, n)
+
+    const size_t nthreads = static_cast< size_t >(parallel_update_nthreads);
+    if (events_threads.size() < nthreads)
+    {
+        events_threads.resize(nthreads);
+        engines_threads.resize(nthreads);
+    }
+
+    // Streams are keyed by (seed, sim_id) and positioned at (agent, day),
+    // so an agent's draws don't depend on which thread makes them.
+    const uint64_t key = rng_seed ^
+        (static_cast< uint64_t >(sim_id) * 0x9e3779b97f4a7c15ULL);
+
+    for (auto & eng : engines_threads)
+        eng.seed(key);
+
+    const uint32_t day = static_cast< uint32_t >(current_date);
+
+    std::vector< std::exception_ptr > errors(nthreads);
+
+    array_double_tmp.split(true, nthreads);
+    array_virus_tmp.split(true, nthreads);
+    in_parallel_update = true;
+
+    #pragma omp parallel num_threads(parallel_update_nthreads)
+    {
+
+        #ifdef _OPENMP
+        const size_t iam = static_cast< size_t >(omp_get_thread_num());
+        #else
+        const size_t iam = 0u;
+        #endif
+
+        // Static scheduling assigns contiguous blocks of agents to threads
+        // in thread order, so concatenating the buffers preserves the
+        // agent order.
+        #pragma omp for schedule(static)
+        for (size_t k = 0u; k < n; ++k)
+        {
+
+            if (errors[iam])
+                continue;
+
+            const size_t i = (active != nullptr) ? (*active)[k] : k;
+            if (!state_fun[agents_state[i]])
+                continue;
+
+            auto & p = population[i];
+
+            engines_threads[iam].set_stream(static_cast< uint64_t >(i), day);
+            EPI_PROFILE_ADD(profile, StateFunCalls, 1u)
+
+            try
+            {
+                state_fun[p.state](&p, this);
+            }
+            catch (...)
+            {
+                errors[iam] = std::current_exception();
+            }
+
+        }
+
+    }
+
+    in_parallel_update = false;
+    array_double_tmp.split(false);
+    array_virus_tmp.split(false);
+
+    for (auto & e : errors)
+        if (e)
+        {
+            for (auto & buffer : events_threads)
+                buffer.clear();
+            std::rethrow_exception(e);
+        }
+
+    // Merging the buffers
+    for (auto & buffer : events_threads)
+    {
+        for (auto & e : buffer)
+            _add_event(
+                e.agent, std::move(e.virus), std::move(e.tool), e.entity,
+                e.new_state, e.queue, e.action
+            );
+
+        buffer.clear();
+    }
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::mutate_virus() {
+
+    EPI_PROFILE_SCOPE(profile, MutateVirus)
+
+    // Checking if any virus has mutation
+    size_t nmutates = 0u;
+    for (const auto & v: viruses)
+        if (v->strain->mutation)
+            nmutates++;
+
+    if (nmutates == 0u)
+        return;
+
+    if (use_queuing)
+    {
+
+        const auto & active = queue.get_active_agents();
+        for (size_t i = 0u; i < active.size(); ++i)
+        {
+
+            auto & p = population[active[i]];
+            if (p.virus != nullptr)
+                p.virus->mutate(this);
+
+        }
+
+    }
+    else
+    {
+
+        for (auto & p: population)
+        {
+
+            if (p.virus != nullptr)
+                p.virus->mutate(this);
+
+        }
+
+    }
+
+
+}
+
+template<typename TSeq>
+inline size_t Model<TSeq>::get_n_viruses() const {
+    return db.size();
+}
+
+template<typename TSeq>
+inline size_t Model<TSeq>::get_n_tools() const {
+    return tools.size();
+}
+
+template<typename TSeq>
+inline epiworld_fast_uint Model<TSeq>::get_ndays() const {
+    return ndays;
+}
+
+template<typename TSeq>
+inline epiworld_fast_uint Model<TSeq>::get_n_replicates() const
+{
+    return n_replicates;
+}
+
+template<typename TSeq>
+inline size_t Model<TSeq>::get_sim_id() const
+{
+    return sim_id;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_sim_id(size_t id)
+{
+    sim_id = id;
+}
+
+template<typename TSeq>
+inline size_t Model<TSeq>::get_n_entities() const {
+    return entities.size();
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_ndays(epiworld_fast_uint ndays) {
+    this->ndays = ndays;
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::get_verbose() const {
+    return verbose;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::verbose_on() {
+    verbose = true;
+    return *this;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::verbose_off() {
+    verbose = false;
+    return *this;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rewire_fun(
+    std::function<void(std::vector<Agent<TSeq>>*,Model<TSeq>*,epiworld_double)> fun
+    ) {
+    rewire_fun = fun;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rewire_prop(epiworld_double prop)
+{
+
+    if (prop < 0.0)
+        throw std::range_error("Proportions cannot be negative.");
+
+    if (prop > 1.0)
+        throw std::range_error("Proportions cannot be above 1.0.");
+
+    rewire_prop = prop;
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::get_rewire_prop() const {
+    return rewire_prop;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::rewire() {
+
+    EPI_PROFILE_SCOPE(profile, Rewire)
+
+    if (rewire_fun)
+        rewire_fun(&population, this, rewire_prop);
+}
+
+
+template<typename TSeq>
+inline void Model<TSeq>::write_data(
+    std::string fn_virus_info,
+    std::string fn_virus_hist,
+    std::string fn_tool_info,
+    std::string fn_tool_hist,
+    std::string fn_total_hist,
+    std::string fn_transmission,
+    std::string fn_transition,
+    std::string fn_reproductive_number,
+    std::string fn_generation_time,
+    std::string fn_active_cases,
+    std::string fn_outbreak_size,
+    std::string fn_hospitalizations
+    ) const
+{
+
+    db.write_data(
+        fn_virus_info, fn_virus_hist,
+        fn_tool_info, fn_tool_hist,
+        fn_total_hist, fn_transmission, fn_transition,
+        fn_reproductive_number, fn_generation_time,
+        fn_active_cases, fn_outbreak_size,
+        fn_hospitalizations
+        );
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::write_edgelist(
+    std::string fn
+    ) const
+{
+
+    // Figuring out the writing sequence
+    std::vector< const Agent<TSeq> * > wseq(size());
+    for (const auto & p: population)
+        wseq[p.id] = &p;
+
+    std::ofstream efile(fn, std::ios_base::out);
+    efile << "source target\n";
+    if (this->is_directed())
+    {
+
+        for (const auto & p : wseq)
+        {
+
+            const epiworld_agent_index * neighbors = network->neighbors(p->id);
+            for (size_t n = 0u; n < p->n_neighbors; ++n)
+                efile << p->id << " " << neighbors[n] << "\n";
+        }
+
+    } else {
+
+        for (const auto & p : wseq)
+        {
+
+            const epiworld_agent_index * neighbors = network->neighbors(p->id);
+            for (size_t n = 0u; n < p->n_neighbors; ++n)
+                if (static_cast<int>(p->id) <= static_cast<int>(neighbors[n]))
+                    efile << p->id << " " << neighbors[n] << "\n";
+        }
+
+    }
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::write_edgelist(
+std::vector< int > & source,
+std::vector< int > & target
+) const {
+
+    // Figuring out the writing sequence
+    std::vector< const Agent<TSeq> * > wseq(size());
+    for (const auto & p: population)
+        wseq[p.id] = &p;
+
+    if (this->is_directed())
+    {
+
+        for (const auto & p : wseq)
+        {
+            const epiworld_agent_index * neighbors = network->neighbors(p->id);
+            for (size_t n = 0u; n < p->n_neighbors; ++n)
+            {
+                source.push_back(static_cast<int>(p->id));
+                target.push_back(static_cast<int>(neighbors[n]));
+            }
+        }
+
+    } else {
+
+        for (const auto & p : wseq)
+        {
+
+            const epiworld_agent_index * neighbors = network->neighbors(p->id);
+            for (size_t n = 0u; n < p->n_neighbors; ++n) {
+                if (static_cast<int>(p->id) <= static_cast<int>(neighbors[n])) {
+                    source.push_back(static_cast<int>(p->id));
+                    target.push_back(static_cast<int>(neighbors[n]));
+                }
+            }
+        }
+
+    }
+
+
+}
+
+template<typename TSeq>
+inline std::map<std::string,epiworld_double> & Model<TSeq>::params()
+{
+
+    // Binding the parameters added through a previous call
+    parameters_ptrs_update();
+
+    return parameters;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::reset() {
+
+
+    // Restablishing people
+    pb = Progress(ndays, 80);
+
+    // Only the network needs a backup; the rest of the agents' data
+    // is reset in place, keeping the memory already allocated.
+    if (network_backup && (network != network_backup))
+    {
+        network = network_backup;
+        for (auto & p : population)
+            p.n_neighbors = network->degree(p.id);
+    }
+
+    for (auto & p : population)
+        p.reset();
+
+    agents_state.assign(population.size(), 0u);
+
+    #ifdef EPI_DEBUG
+    for (auto & a: population)
+    {
+        if (a.get_state() != 0u)
+            throw std::logic_error("Model::reset population doesn't match."
+                "Some agents are not in the baseline state.");
+    }
+    #endif
+
+    for (auto & e: entities)
+        e.reset();
+
+    current_date = 0;
+
+    db.reset();
+
+    // This also clears the queue
+    if (use_queuing)
+        queue.reset();
+
+    // Reset contact tracing if active
+    if (use_contact_tracing)
+        contact_tracing = std::make_unique<ContactTracing>(
+            population.size(), contact_tracing_max_contacts
+        );
+
+    // Re distributing tools and virus
+    dist_entities();
+    dist_virus();
+    dist_tools();
+
+    // Distributing initial state, if specified
+    initial_states_fun(this);
+
+    // Recording day 0 and advancing to day 1 is handled by Model::run().
+    // Keeping reset() side-effect free from virtual next() prevents
+    // derived-model update code from running before derived reset state
+    // is fully initialized.
+
+
+}
+
+// Too big to keep here
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/model-meat-print.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODEL_MEAT_PRINT_HPP
+#define EPIWORLD_MODEL_MEAT_PRINT_HPP
+
+template<typename TSeq>
+inline const Model<TSeq> & Model<TSeq>::print(bool lite) const
+{
+
+    // Horizontal line
+    std::string line = "";
+    for (epiworld_fast_uint i = 0u; i < 80u; ++i)
+        line += "_";
+
+    // Prints a message if debugging is on
+    EPI_DEBUG_NOTIFY_ACTIVE()
+
+    printf_epiworld("%s\n",line.c_str());
+
+    if (lite)
+    {
+        // Printing the name of the model
+        printf_epiworld("%s", name.c_str());
+
+        // Printing the number of agents, viruses, and tools
+        printf_epiworld(
+            "\nIt features %i agents, %i virus(es), and %i tool(s).\n",
+            static_cast<int>(size()),
+            static_cast<int>(get_n_viruses()),
+            static_cast<int>(get_n_tools())
+            );
+
+        printf_epiworld(
+            "The model has %i states.",
+            static_cast<int>(nstates)
+            );
+
+        if (today() != 0)
+        {
+            printf_epiworld(
+                "\nThe final distribution is: "
+            );
+
+            int nstate_int = static_cast<int>(nstates);
+
+            for (int i = 0u; i < nstate_int; ++i)
+            {
+                printf_epiworld(
+                    "%i %s%s",
+                    static_cast<int>(db.today_total[ i ]),
+                    states_labels[i].c_str(),
+                    (
+                        i == (nstate_int - 2)
+                        ) ? ", and " : (
+                            (i == (nstate_int - 1)) ? ".\n" : ", "
+                            )
+                );
+            }
+        } else {
+            printf_epiworld(" The model hasn't been run yet.\n");
+        }
+
+        return *this;
+    }
+
+    printf_epiworld("%s\n%s\n\n",line.c_str(), "SIMULATION STUDY");
+
+    printf_epiworld("Name of the model   : %s\n", (this->name == "") ? std::string("(none)").c_str() : name.c_str());
+    printf_epiworld("Population size     : %i\n", static_cast<int>(size()));
+
+    auto ncols = get_agents_data_ncols();
+
+    if (ncols > 0)
+    {
+        printf_epiworld("Agents' data loaded : yes (%i columns/features)\n", static_cast<int>(ncols));
+    }
+    else
+    {
+        printf_epiworld("Agents' data        : (none)\n");
+    }
+
+    printf_epiworld("Number of entities  : %i\n", static_cast<int>(entities.size()));
+    printf_epiworld("Days (duration)     : %i (of %i)\n", today(), static_cast<int>(ndays));
+    printf_epiworld("Number of viruses   : %i\n", static_cast<int>(db.get_n_viruses()));
+    if (n_replicates > 0u)
+    {
+        std::string abbr;
+        epiworld_double elapsed;
+        epiworld_double total;
+        get_elapsed("auto", &elapsed, &total, &abbr, false);
+        printf_epiworld("Last run elapsed t  : %.2f%s\n", elapsed, abbr.c_str());
+        if (n_replicates > 1u)
+        {
+            printf_epiworld("Total elapsed t     : %.2f%s (%i runs)\n", total, abbr.c_str(), static_cast<int>(n_replicates));
+        }
+
+        // Elapsed time in speed
+        get_elapsed("microseconds", &elapsed, &total, &abbr, false);
+        printf_epiworld("Last run speed      : %.2f million agents x day / second\n",
+            static_cast<double>(this->size()) *
+            static_cast<double>(this->get_ndays()) /
+            static_cast<double>(elapsed)
+            );
+        if (n_replicates > 1u)
+        {
+            printf_epiworld("Average run speed   : %.2f million agents x day / second\n",
+                static_cast<double>(this->size()) *
+                static_cast<double>(this->get_ndays()) *
+                static_cast<double>(n_replicates) /
+                static_cast<double>(total)
+            );
+        }
+
+    } else {
+        printf_epiworld("Last run elapsed t  : -\n");
+    }
+    
+    
+    if (rewire_fun)
+    {
+        printf_epiworld("Rewiring            : on (%.2f)\n", rewire_prop);
+    } else {
+        printf_epiworld("Rewiring            : off\n");
+    }
+
+    printf_epiworld("Last seed used      : %i\n\n", static_cast<int>(last_seed));
+    
+    // Printing Global events
+    printf_epiworld("Global events:\n");
+    for (auto & a : globalevents)
+    {
+        if (a->get_day() < 0)
+        {
+            printf_epiworld(" - %s (runs daily)\n", a->get_name().c_str());
+        } else {
+            printf_epiworld(" - %s (day %i)\n", a->get_name().c_str(), a->get_day());
+        }
+    }
+
+    if (globalevents.size() == 0u)
+    {
+        printf_epiworld(" (none)\n");
+    }
+
+    printf_epiworld("\nVirus(es):\n");
+    size_t n_viruses_model = viruses.size();
+    for (size_t i = 0u; i < n_viruses_model; ++i)
+    {    
+
+        
+        const auto & virus = viruses[i];
+        if ((n_viruses_model > 10) && (i >= 10))
+        {
+            printf_epiworld(" ...and %i more viruses...\n",
+                static_cast<int>(n_viruses_model) - 
+                static_cast<int>(i)
+                );
+            break;
+        }
+
+        if (i < n_viruses_model)
+        {
+
+            printf_epiworld(
+                " - %s\n",
+                virus->get_name().c_str()
+            );
+
+        } else {
+
+            printf_epiworld(
+                " - %s (originated in the model...)\n",
+                virus->get_name().c_str()
+            );
+
+        }
+
+    }
+
+    auto nvariants = db.get_n_viruses() - n_viruses_model;
+    if (nvariants > 0)
+    {
+
+        printf_epiworld(" ...and %i more variants...\n", static_cast<int>(nvariants));
+
+    }
+
+    if (viruses.size() == 0u)
+    {
+        printf_epiworld(" (none)\n");
+    }
+
+    printf_epiworld("\nTool(s):\n");
+    size_t n_tools_model = tools.size();
+    for (size_t i = 0u; i < tools.size(); ++i)
+    {   
+        const auto & tool = tools[i];
+
+        if ((n_tools_model > 10) && (i >= 10))
+        {
+            printf_epiworld(
+                " ...and %i more tools...\n",
+                static_cast<int>(n_tools_model) - static_cast<int>(i)
+                );
+            break;
+        }
+
+        if (i < n_tools_model)
+        {
+            printf_epiworld(
+                " - %s\n",
+                tool->get_name().c_str()
+                );
+
+
+        } else {
+
+            printf_epiworld(
+                " - %s (originated in the model...)\n",
+                tool->get_name().c_str()
+            );
+
+        }
+        
+
+    }
+
+    if (tools.size() == 0u)
+    {
+        printf_epiworld(" (none)\n");
+    }
+
+    // Information about the parameters included
+    printf_epiworld("\nModel parameters:\n");
+    epiworld_fast_uint nchar = 0u;
+    for (auto & p : parameters)
+        if (p.first.length() > nchar)
+            nchar = p.first.length();
+
+    std::string fmt = " - %-" + std::to_string(nchar + 1) + "s: ";
+    for (auto & p : parameters)
+    {
+        std::string fmt_tmp = fmt;
+        if (std::fabs(p.second) < 0.0001)
+            fmt_tmp += "%.1e\n";
+        else
+            fmt_tmp += "%.4f\n";
+
+        printf_epiworld(
+            fmt_tmp.c_str(),
+            p.first.c_str(),
+            p.second
+        );
+        
+    }
+
+    if (parameters.size() == 0u)
+    {
+        printf_epiworld(" (none)\n");
+    }
+
+    nchar = 0u;
+    for (auto & p : states_labels)
+        if (p.length() > nchar)
+            nchar = p.length();
+
+    
+
+    if (today() != 0)
+    {
+        fmt =
+            std::string("  - (%") +
+                std::to_string(std::to_string(nstates).length()) +
+            std::string("d) %-") + std::to_string(nchar) +
+            std::string("s : %") +
+            std::to_string(std::to_string(size()).length()) +
+            std::string("i -> %i\n");
+    } else {
+        fmt =
+            std::string("  - (%") +
+                std::to_string(std::to_string(nstates).length()) +
+            std::string("d) %-") + std::to_string(nchar) +
+            std::string("s : %i\n");
+    }
+        
+    if (today() != 0)
+    {
+        printf_epiworld("\nDistribution of the population at time %i:\n", today());
+        for (size_t s = 0u; s < nstates; ++s)
+        {
+
+                printf_epiworld(
+                    fmt.c_str(),
+                    s,
+                    states_labels[s].c_str(),
+                    db.hist_total_counts[s],
+                    db.today_total[ s ]
+                    );
+
+        }
+    }
+
+    if (today() != 0)
+        (void) db.get_transition_probability(true);
+
+    return *this;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/model-meat-print.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+template<typename TSeq>
+inline epiworld_fast_int Model<TSeq>::state_of(std::string_view name) {
+    for (std::size_t i = 0; i < states_labels.size(); ++i) {
+        if (states_labels[i] == name) {
+            return static_cast<epiworld_fast_int>(i);
+        }
+    }
+
+    throw std::logic_error("The state " + std::string(name) + " was not found.");
+}
+
+template<typename TSeq>
+inline epiworld_fast_int Model<TSeq>::add_state(
+    std::string lab,
+    UpdateFun<TSeq> fun
+)
+{
+
+    // Checking it doesn't match
+    for (auto & s : states_labels)
+        if (s == lab)
+            throw std::logic_error("state \"" + s + "\" already registered.");
+
+    states_labels.push_back(lab);
+    state_fun.push_back(fun);
+
+    return nstates++;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::set_state_function(
+    epiworld_fast_uint state,
+    UpdateFun<TSeq> fun
+)
+{
+
+    if (state >= nstates)
+        throw std::range_error(
+            "The state " + std::to_string(state) + " is out of range. " +
+            "The model currently has " + std::to_string(nstates) + " states."
+        );
+
+    state_fun[state] = fun;
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::set_state_function(
+    std::string_view name,
+    UpdateFun<TSeq> fun
+)
+{
+
+    return set_state_function(
+        static_cast<epiworld_fast_uint>(state_of(name)),
+        fun
+    );
+
+}
+
+template<typename TSeq>
+inline const std::vector< std::string > &
+Model<TSeq>::get_states() const
+{
+    return states_labels;
+}
+
+template<typename TSeq>
+inline size_t Model<TSeq>::get_n_states() const
+{
+    return nstates;
+}
+
+template<typename TSeq>
+inline const std::vector< UpdateFun<TSeq> > &
+Model<TSeq>::get_state_fun() const
+{
+    return state_fun;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::print_state_codes() const
+{
+
+    // Horizontal line
+    std::string line = "";
+    for (epiworld_fast_uint i = 0u; i < 80u; ++i)
+        line += "_";
+
+    printf_epiworld("\n%s\nstates CODES\n\n", line.c_str());
+
+    epiworld_fast_uint nchar = 0u;
+    for (auto & p : states_labels)
+        if (p.length() > nchar)
+            nchar = p.length();
+
+    std::string fmt = " %2i = %-" + std::to_string(nchar + 1 + 4) + "s\n";
+    for (epiworld_fast_uint i = 0u; i < nstates; ++i)
+    {
+
+        printf_epiworld(
+            fmt.c_str(),
+            i,
+            (states_labels[i] + " (S)").c_str()
+        );
+
+    }
+
+}
+
+
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::add_param(
+    epiworld_double initial_value,
+    std::string pname,
+    bool overwrite
+    ) {
+
+    auto iter = parameters.find(pname);
+    if (iter == parameters.end())
+        iter = parameters.emplace(pname, initial_value).first;
+    else if (!overwrite)
+        throw std::logic_error("The parameter " + pname + " already exists.");
+    else
+        iter->second = initial_value;
+
+    // Binding the id
+    size_t id = param_id(pname);
+    if (id >= parameters_ptrs.size())
+        parameters_ptrs.resize(id + 1u, nullptr);
+
+    parameters_ptrs[id] = &iter->second;
+
+    return initial_value;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::parameters_ptrs_update()
+{
+
+    parameters_ptrs.clear();
+    for (auto & p : parameters)
+    {
+        size_t id = param_id(p.first);
+        if (id >= parameters_ptrs.size())
+            parameters_ptrs.resize(id + 1u, nullptr);
+
+        parameters_ptrs[id] = &p.second;
+    }
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::read_params(std::string fn, bool overwrite)
+{
+
+    auto params_map = read_yaml<epiworld_double>(fn);
+
+    for (auto & p : params_map)
+        add_param(p.second, p.first, overwrite);
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::get_param(const std::string & pname)
+{
+    const auto iter = parameters.find(pname);
+    if (iter == parameters.end())
+        throw std::logic_error("The parameter " + pname + " does not exists.");
+
+    return iter->second;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_param(const std::string & pname, epiworld_double value)
+{
+    const auto iter = parameters.find(pname);
+    if (iter == parameters.end())
+        throw std::logic_error("The parameter '" + pname + "' does not exists.");
+
+    iter->second = value;
+
+    return;
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::par(const std::string & pname) const
+{
+    const auto iter = parameters.find(pname);
+    if (iter == parameters.end())
+        throw std::logic_error("The parameter '" + pname + "' does not exists.");
+    return iter->second;
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::par(size_t id) const
+{
+
+    if ((id < parameters_ptrs.size()) && (parameters_ptrs[id] != nullptr))
+        return *parameters_ptrs[id];
+
+    // Not bound yet (added through `params()`). This is a read only, as
+    // it may be called from the threads of the parallel update.
+    return par(param_name(id));
+
+}
+
+/**
+ * @brief Process-wide table of parameter names (see `Model::param_id()`).
+ */
+struct ParamIdsRegistry {
+    std::mutex mtx;
+    std::unordered_map< std::string, size_t > ids;
+    std::vector< std::unique_ptr< std::string > > names;
+};
+
+inline ParamIdsRegistry & param_ids_registry()
+{
+    static ParamIdsRegistry registry;
+    return registry;
+}
+
+template<typename TSeq>
+inline size_t Model<TSeq>::param_id(const std::string & pname)
+{
+
+    auto & reg = param_ids_registry();
+    std::lock_guard< std::mutex > lock(reg.mtx);
+
+    auto iter = reg.ids.find(pname);
+    if (iter != reg.ids.end())
+        return iter->second;
+
+    size_t id = reg.names.size();
+    reg.names.emplace_back(std::make_unique< std::string >(pname));
+    reg.ids.emplace(pname, id);
+
+    return id;
+
+}
+
+template<typename TSeq>
+inline const std::string & Model<TSeq>::param_name(size_t id)
+{
+
+    auto & reg = param_ids_registry();
+    std::lock_guard< std::mutex > lock(reg.mtx);
+
+    if (id >= reg.names.size())
+        throw std::range_error(
+            "The parameter id " + std::to_string(id) + " is out of range."
+        );
+
+    return *reg.names[id];
+
+}
+
+#define DURCAST(tunit,txtunit) {\
+        elapsed       = std::chrono::duration_cast<std::chrono:: tunit>(\
+            time_end - time_start).count(); \
+        elapsed_total = std::chrono::duration_cast<std::chrono:: tunit>(time_elapsed).count(); \
+        abbr_unit     = txtunit;}
+
+template<typename TSeq>
+inline const Profiler & Model<TSeq>::get_profile() const
+{
+    return profile;
+}
+
+template<typename TSeq>
+inline const Profiler & Model<TSeq>::get_profile_total() const
+{
+    return profile_total;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::get_elapsed(
+    std::string unit,
+    epiworld_double * last_elapsed,
+    epiworld_double * total_elapsed,
+    std::string * unit_abbr,
+    bool print
+) const {
+
+    // Preparing the result
+    epiworld_double elapsed, elapsed_total;
+    std::string abbr_unit;
+
+    // Figuring out the length
+    if (unit == "auto")
+    {
+
+        size_t tlength = std::to_string(
+            static_cast<int>(floor(time_elapsed.count()))
+            ).length();
+
+        if (tlength <= 1)
+            unit = "nanoseconds";
+        else if (tlength <= 3)
+            unit = "microseconds";
+        else if (tlength <= 6)
+            unit = "milliseconds";
+        else if (tlength <= 8)
+            unit = "seconds";
+        else if (tlength <= 9)
+            unit = "minutes";
+        else
+            unit = "hours";
+
+    }
+
+    if (unit == "nanoseconds")       DURCAST(nanoseconds,"ns")
+    else if (unit == "microseconds") DURCAST(microseconds,"\xC2\xB5s")
+    else if (unit == "milliseconds") DURCAST(milliseconds,"ms")
+    else if (unit == "seconds")      DURCAST(seconds,"s")
+    else if (unit == "minutes")      DURCAST(minutes,"m")
+    else if (unit == "hours")        DURCAST(hours,"h")
+    else
+        throw std::range_error("The time unit " + unit + " is not supported.");
+
+
+    if (last_elapsed != nullptr)
+        *last_elapsed = elapsed;
+    if (total_elapsed != nullptr)
+        *total_elapsed = elapsed_total;
+    if (unit_abbr != nullptr)
+        *unit_abbr = abbr_unit;
+
+    if (!print)
+        return;
+
+    if (n_replicates > 1u)
+    {
+        printf_epiworld("last run elapsed time : %.2f%s\n",
+            elapsed, abbr_unit.c_str());
+        printf_epiworld("total elapsed time    : %.2f%s\n",
+            elapsed_total, abbr_unit.c_str());
+        printf_epiworld("total runs            : %i\n",
+            static_cast<int>(n_replicates));
+        printf_epiworld("mean run elapsed time : %.2f%s\n",
+            elapsed_total/static_cast<epiworld_double>(n_replicates), abbr_unit.c_str());
+
+    } else {
+        printf_epiworld("last run elapsed time : %.2f%s.\n", elapsed, abbr_unit.c_str());
+    }
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_user_data(std::vector< std::string > names)
+{
+    db.set_user_data(names);
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::add_user_data(epiworld_fast_uint j, epiworld_double x)
+{
+    db.add_user_data(j, x);
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::add_user_data(std::vector<epiworld_double> x)
+{
+    db.add_user_data(x);
+}
+
+template<typename TSeq>
+inline UserData<TSeq> & Model<TSeq>::get_user_data()
+{
+    return db.get_user_data();
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::add_globalevent(
+    std::function<void(Model<TSeq>*)> fun,
+    std::string name,
+    int date
+)
+{
+    auto event = GlobalEvent<TSeq>(fun, name, date);
+    add_globalevent(event);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::add_globalevent(
+    GlobalEvent<TSeq> & action
+)
+{
+    auto ptr = action.clone_ptr();
+    globalevents.push_back(GlobalEventPtr<TSeq>(std::move(ptr)));
+}
+
+template<typename TSeq>
+GlobalEvent<TSeq> & Model<TSeq>::get_globalevent(
+    std::string name
+)
+{
+
+    for (auto & a : globalevents)
+        if (a.name == name)
+            return a;
+
+    throw std::logic_error("The global action " + name + " was not found.");
+
+}
+
+template<typename TSeq>
+GlobalEvent<TSeq> & Model<TSeq>::get_globalevent(
+    size_t index
+)
+{
+
+    if (index >= globalevents.size())
+        throw std::range_error("The index " + std::to_string(index) + " is out of range.");
+
+    return *globalevents[index];
+
+}
+
+// Remove implementation
+template<typename TSeq>
+inline void Model<TSeq>::rm_globalevent(
+    std::string name
+)
+{
+
+    for (auto it = globalevents.begin(); it != globalevents.end(); ++it)
+    {
+        if ((*it)->get_name() == name)
+        {
+            globalevents.erase(it);
+            return;
+        }
+    }
+
+    throw std::logic_error("The global action " + name + " was not found.");
+
+}
+
+// Same as above, but the index implementation
+template<typename TSeq>
+inline void Model<TSeq>::rm_globalevent(
+    size_t index
+)
+{
+
+    if (index >= globalevents.size())
+        throw std::range_error("The index " + std::to_string(index) + " is out of range.");
+
+    globalevents.erase(globalevents.begin() + index);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::run_globalevents()
+{
+
+    EPI_PROFILE_SCOPE(profile, GlobalEvents)
+
+    for (auto & event: globalevents)
+    {
+        event->operator()(this, today());
+        events_run();
+    }    
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::queuing_on()
+{
+    use_queuing = true;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::queuing_off()
+{
+    use_queuing = false;
+    return *this;
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::is_queuing_on() const
+{
+    return use_queuing;
+}
+
+template<typename TSeq>
+inline Queue<TSeq> & Model<TSeq>::get_queue()
+{
+    return queue;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::contact_tracing_on(size_t max_contacts)
+{
+    if (max_contacts < 1u)
+        throw std::logic_error("Contact tracing should use at least one contact.");
+    use_contact_tracing = true;
+    contact_tracing_max_contacts = max_contacts;
+    return *this;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::contact_tracing_off()
+{
+    use_contact_tracing = false;
+    contact_tracing.reset();
+    return *this;
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::is_contact_tracing_on() const
+{
+    return use_contact_tracing;
+}
+
+template<typename TSeq>
+inline ContactTracing & Model<TSeq>::get_contact_tracing()
+{
+    if (!use_contact_tracing)
+        throw std::logic_error(
+            "Contact tracing is not active. Call contact_tracing_on() first."
+        );
+
+    if (!contact_tracing)
+        contact_tracing = std::make_unique<ContactTracing>();
+    return *contact_tracing;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::events_by_agent_on()
+{
+    events_by_agent = true;
+    return *this;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::events_by_agent_off()
+{
+    events_by_agent = false;
+    return *this;
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::is_events_by_agent_on() const
+{
+    return events_by_agent;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::fast_forward_on(
+    std::function<bool(Model<TSeq>*)> fun
+)
+{
+    fast_forward  = true;
+    absorbing_fun = fun;
+    return *this;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::fast_forward_off()
+{
+    fast_forward = false;
+    return *this;
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::is_fast_forward_on() const
+{
+    return fast_forward;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::runif_batch_on()
+{
+    use_runif_batch = true;
+    return *this;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::runif_batch_off()
+{
+    use_runif_batch = false;
+    return *this;
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::is_runif_batch_on() const
+{
+    return use_runif_batch;
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::is_absorbing()
+{
+
+    if (absorbing_fun)
+        return absorbing_fun(this);
+
+    // Global events left to run
+    for (const auto & e : globalevents)
+        if ((e->get_day() < 0) || (e->get_day() >= today()))
+            return false;
+
+    // Viruses still around
+    for (const auto & counts : db.today_virus)
+        for (auto n : counts)
+            if (n > 0)
+                return false;
+
+    // Without viruses, only these states can't change
+    for (epiworld_fast_uint s = 0u; s < nstates; ++s)
+    {
+
+        if (db.today_total[s] == 0)
+            continue;
+
+        if (
+            !state_fun_is(s, nullptr) &&
+            !state_fun_is(s, default_update_susceptible<TSeq>)
+        )
+            return false;
+
+    }
+
+    return true;
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::parallel_update_on(int nthreads)
+{
+    if (nthreads < 1)
+        throw std::logic_error("The parallel update needs at least one thread.");
+
+    use_parallel_update = true;
+    parallel_update_nthreads = nthreads;
+    return *this;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::parallel_update_off()
+{
+    use_parallel_update = false;
+    return *this;
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::is_parallel_update_on() const
+{
+    return use_parallel_update;
+}
+
+template<typename TSeq>
+inline const std::vector< VirusPtr<TSeq> > & Model<TSeq>::get_viruses() const
+{
+    return viruses;
+}
+
+template<typename TSeq>
+const std::vector< ToolPtr<TSeq> > & Model<TSeq>::get_tools() const
+{
+    return tools;
+}
+
+template<typename TSeq>
+inline Virus<TSeq> & Model<TSeq>::get_virus(size_t id)
+{
+
+    if (viruses.size() <= id)
+        throw std::length_error("The specified id for the virus is out of range");
+
+    return *viruses[id];
+
+}
+
+template<typename TSeq>
+inline Virus<TSeq> & Model<TSeq>::get_virus(std::string_view name)
+{
+
+    for (auto & v : viruses)
+        if (v->get_name() == name)
+            return *v;
+
+    throw std::logic_error("The virus " + std::string(name) + " was not found.");
+
+}
+
+template<typename TSeq>
+inline Tool<TSeq> & Model<TSeq>::get_tool(size_t id)
+{
+
+    if (tools.size() <= id)
+        throw std::length_error("The specified id for the tools is out of range");
+
+    return *tools[id];
+
+}
+
+template<typename TSeq>
+inline Tool<TSeq> & Model<TSeq>::get_tool(std::string_view name)
+{
+    for (auto & t : tools)
+        if (t->get_name() == name)
+            return *t;
+
+    throw std::logic_error("The tool " + std::string(name) + " was not found.");
+
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::has_virus(std::string_view name) const
+{
+    for (const auto & v : viruses)
+        if (v->get_name() == name)
+            return true;
+
+    return false;
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::has_tool(std::string_view name) const
+{
+    for (const auto & t : tools)
+        if (t->get_name() == name)
+            return true;
+    return false;
+}
+
+
+template<typename TSeq>
+inline void Model<TSeq>::set_agents_data(double * data_, size_t ncols_)
+{
+    agents_data = data_;
+    agents_data_ncols = ncols_;
+}
+
+template<typename TSeq>
+inline double * Model<TSeq>::get_agents_data() {
+    return this->agents_data;
+}
+
+template<typename TSeq>
+inline size_t Model<TSeq>::get_agents_data_ncols() const {
+    return this->agents_data_ncols;
+}
+
+
+template<typename TSeq>
+inline void Model<TSeq>::set_name(std::string name)
+{
+    this->name = name;
+}
+
+template<typename TSeq>
+inline std::string Model<TSeq>::get_name() const
+{
+    return this->name;
+}
+
+#define VECT_MATCH(a, b, c) \
+    EPI_DEBUG_FAIL_AT_TRUE(a.size() != b.size(), c) \
+    for (size_t __i = 0u; __i < a.size(); ++__i) \
+    {\
+        EPI_DEBUG_FAIL_AT_TRUE(a[__i] != b[__i], c) \
+    }
+
+template<typename TSeq>
+inline bool Model<TSeq>::operator==(const Model<TSeq> & other) const
+{
+    EPI_DEBUG_FAIL_AT_TRUE(name != other.name, "names don't match")
+    EPI_DEBUG_FAIL_AT_TRUE(db != other.db, "database don't match")
+
+    VECT_MATCH(population, other.population, "population doesn't match")
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        using_backup != other.using_backup,
+        "Model:: using_backup don't match"
+        )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        *network != *other.network,
+        "Model:: network don't match"
+    )
+
+    if ((network_backup == nullptr) != (other.network_backup == nullptr))
+        return false;
+
+    if (network_backup && (*network_backup != *other.network_backup))
+        return false;
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        agents_data != other.agents_data,
+        "Model:: agents_data don't match"
+    )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        agents_data_ncols != other.agents_data_ncols,
+        "Model:: agents_data_ncols don't match"
+    )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        directed != other.directed,
+        "Model:: directed don't match"
+    )
+
+    // Viruses -----------------------------------------------------------------
+    EPI_DEBUG_FAIL_AT_TRUE(
+        viruses.size() != other.viruses.size(),
+        "Model:: viruses.size() don't match"
+        )
+
+    for (size_t i = 0u; i < viruses.size(); ++i)
+    {
+        EPI_DEBUG_FAIL_AT_TRUE(
+            *viruses[i] != *other.viruses[i],
+            "Model:: *viruses[i] don't match"
+        )
+
+    }
+
+    // Tools -------------------------------------------------------------------
+    EPI_DEBUG_FAIL_AT_TRUE(
+        tools.size() != other.tools.size(),
+        "Model:: tools.size() don't match"
+        )
+
+    for (size_t i = 0u; i < tools.size(); ++i)
+    {
+        EPI_DEBUG_FAIL_AT_TRUE(
+            *tools[i] != *other.tools[i],
+            "Model:: *tools[i] don't match"
+        )
+
+    }
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        entities.size() != other.entities.size(),
+        "Model:: entities.size() don't match"
+        )
+    for (size_t i = 0u; i < entities.size(); ++i)
+    {
+        EPI_DEBUG_FAIL_AT_TRUE(
+            entities[i] != other.entities[i],
+            "Model:: *entities[i] don't match"
+        )
+
+    }
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        rewire_prop != other.rewire_prop,
+        "Model:: rewire_prop don't match"
+    )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        parameters.size() != other.parameters.size(),
+        "Model:: () don't match"
+    )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        parameters != other.parameters,
+        "Model:: parameters don't match"
+    )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        ndays != other.ndays,
+        "Model:: ndays don't match"
+    )
+
+    VECT_MATCH(
+        states_labels,
+        other.states_labels,
+        "state labels don't match"
+    )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        nstates != other.nstates,
+        "Model:: nstates don't match"
+    )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        verbose != other.verbose,
+        "Model:: verbose don't match"
+    )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        current_date != other.current_date,
+        "Model:: current_date don't match"
+    )
+
+    VECT_MATCH(globalevents, other.globalevents, "global action don't match");
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        queue != other.queue,
+        "Model:: queue don't match"
+    )
+
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        use_queuing != other.use_queuing,
+        "Model:: use_queuing don't match"
+    )
+
+    return true;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::draw(
+    DiagramType diagram_type,
+    const std::string & fn_output,
+    bool self
+) {
+
+    ModelDiagram diagram;
+
+    diagram.draw_from_data(
+        diagram_type,
+        this->get_states(),
+        this->get_db().get_transition_probability(false),
+        fn_output,
+        self
+    );
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::record_hospitalization(Agent<TSeq> & agent)
+{
+    db.record_hospitalization(agent);
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::get_hospitalizations(
+    std::vector<int> & date,
+    std::vector<int> & virus_id,
+    std::vector<int> & tool_id,
+    std::vector<int> & count,
+    std::vector<double> & weight
+) const
+{
+    db.get_hospitalizations(date, virus_id, tool_id, count, weight);
+}
+
+#undef VECT_MATCH
+#undef DURCAST
+#undef CASES_PAR
+#undef CASE_PAR
+#undef CHECK_INIT
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/model-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+// (already included ./include/epiworld/viruses-bones.hpp)
+
+// (already included ./include/epiworld/virus-bones.hpp)
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/virus-distribute-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_VIRUS_DISTRIBUTE_MEAT_HPP
+#define EPIWORLD_VIRUS_DISTRIBUTE_MEAT_HPP
+
+/**
+ * Distributes a virus to a set of agents.
+ *
+ * This function takes a vector of agent IDs and returns a lambda function that
+ * can be used to distribute a virus to the specified agents.
+ *
+ * @param agents_ids A vector of agent IDs representing the set of agents to
+ * distribute the virus to.
+ * 
+ * @return A lambda function that takes a Virus object and a Model object and
+ * distributes the virus to the specified agents.
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline VirusToAgentFun<TSeq> distribute_virus_to_set(
+    std::vector< size_t > agents_ids
+) {
+
+    return [agents_ids](
+        Virus<TSeq> & virus, Model<TSeq> * model
+    ) -> void 
+    { 
+        // Adding action
+        for (auto i: agents_ids)
+        {
+            model->get_agent(i).set_virus(
+                *model, virus
+                );
+        }
+    };
+
+}
+
+/**
+ * @brief Distributes a virus randomly to agents.
+ * 
+ * This function takes a sequence of agents and randomly assigns a virus to
+ * each agent.
+ * 
+ * @tparam TSeq The type of the sequence of agents.
+ * @param agents The sequence of agents to distribute the virus to.
+ * @return A function object that assigns a virus to each agent randomly.
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline VirusToAgentFun<TSeq> distribute_virus_randomly(
+    epiworld_double prevalence,
+    bool prevalence_as_proportion = true,
+    std::vector< size_t > agents_ids = {}
+) {
+
+    auto agents_ids_ptr = std::make_shared< std::vector< size_t > >(agents_ids);
+
+    return [prevalence,prevalence_as_proportion,agents_ids_ptr](
+        Virus<TSeq> & virus, Model<TSeq> * model
+    ) -> void 
+    { 
+        
+        // Figuring out how what agents are available
+        bool use_set = agents_ids_ptr->size() > 0;
+        std::vector< size_t > idx;
+        if (use_set)
+        {
+            for (const auto & agent: *agents_ids_ptr)
+                if (model->get_agent(agent).get_virus() == nullptr)
+                    idx.push_back(agent);
+        }
+        else 
+        {
+            for (const auto & agent: model->get_agents())
+                if (agent.get_virus() == nullptr)
+                    idx.push_back(agent.get_id());
+        }
+
+        // Picking how many
+        int n = use_set ?
+            static_cast<int>(idx.size()) :
+            static_cast<int>(model->size())
+            ;
+            
+        int n_available = static_cast<int>(idx.size());
+        int n_to_sample;
+        if (prevalence_as_proportion)
+        {
+            n_to_sample = static_cast<int>(std::floor(
+                prevalence * static_cast< epiworld_double >(n)
+            ));
+
+            // Correcting for possible overflow
+            if (n_to_sample > n)
+                n_to_sample = n;
+        }
+        else
+        {
+            n_to_sample = static_cast<int>(prevalence);
+        }
+
+        if (n_to_sample > n_available)
+            throw std::range_error(
+                "There are only " + std::to_string(n_available) + 
+                " individuals with no virus in the population. " +
+                "Cannot add the virus to " +
+                std::to_string(n_to_sample)
+            );
+        
+        auto & population = model->get_agents();
+        for (int i = 0; i < n_to_sample; ++i)
+        {
+
+            int loc = model->runif_index(n_available--);
+
+            // Correcting for possible overflow
+            if ((n_available > 0) && (loc >= n_available))
+                loc = n_available - 1;
+
+            Agent<TSeq> & agent = population[idx[loc]];
+            
+            // Adding action
+            agent.set_virus(
+                *model, virus
+                );
+
+            // Adjusting sample
+            std::swap(idx[loc], idx[n_available]);
+
+        }
+
+    };
+
+}
+
+/**
+ * Function template to distribute a virus to agents in each entity of a model.
+ * 
+ * @tparam TSeq The sequence type used in the model.
+ * @param prevalence A vector of prevalences for each entity in the model.
+ * @param as_proportion Flag indicating whether the prevalences are given as
+ * proportions or absolute values.
+ * @return A lambda function that distributes the virus to agents in each entity
+ * of the model.
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline VirusToAgentFun<TSeq> distribute_virus_to_entities(
+    std::vector< double > prevalence,
+    bool as_proportion = true
+)
+{
+
+    // Checking proportions are within range
+    if (prevalence.size() == 0)
+        throw std::range_error("Prevalence vector cannot be empty");
+
+    if (as_proportion)
+    {
+        for (auto p: prevalence)
+        {
+            if ((p < 0.0) || (p > 1.0))
+                throw std::range_error("Proportions must be between 0 and 1");
+        }
+    }
+    else
+    {
+        for (auto p: prevalence)
+        {
+            if (p < 0.0)
+                throw std::range_error("Count values in prevalence must be non-negative");
+        }
+    }
+
+    return [prevalence, as_proportion](
+        Virus<TSeq> & virus, Model<TSeq> * model
+    ) -> void 
+    { 
+
+        // Checking the number of entities
+        if (prevalence.size() != model->get_entities().size())
+            throw std::range_error(
+                "Prevalence vector size (" + std::to_string(prevalence.size()) +
+                ") does not match number of entities (" + std::to_string(model->get_entities().size()) + ")"
+                );
+
+        // Adding action
+        auto & entities = model->get_entities();
+        auto & population = model->get_agents();
+        for (size_t e = 0; e < entities.size(); ++e)
+        {
+            auto & entity_e = entities[e];
+            auto agents_ids = entity_e.get_agents_ids();
+            double prevalence_e = prevalence[e];
+            size_t n = agents_ids.size();
+            size_t n_to_distribute;
+            if (as_proportion)
+                n_to_distribute = static_cast<size_t>(std::floor(prevalence_e * n));
+            else
+                n_to_distribute = static_cast<size_t>(prevalence_e);
+
+            if (n_to_distribute > n)
+                n_to_distribute = n;
+
+            std::vector< epiworld_agent_index > idx = agents_ids;
+            for (size_t i = 0u; i < n_to_distribute; ++i)
+            {
+                size_t loc = model->runif_index(n--);
+
+                if ((n > 0) && (loc >= n))
+                    loc = n - 1;
+                
+                population[idx[loc]].set_virus(
+                    *model, virus
+                    );
+                
+                std::swap(idx[loc], idx[n]);
+
+            }
+        }
+    };
+
+}
+
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/virus-distribute-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/virus-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_VIRUS_MEAT_HPP
+#define EPIWORLD_VIRUS_MEAT_HPP
+
+// (already included include/epiworld/config.hpp)
+
+/**
+ * @brief Factory function of VirusFun base on logit
+ * 
+ * @tparam TSeq 
+ * @param vars Vector indicating the position of the variables to use.
+ * @param coefs Vector of coefficients.
+ * @return VirusFun<TSeq> 
+ */
+template<typename TSeq>
+inline VirusFun<TSeq> virus_fun_logit(
+    std::vector< int > vars,
+    std::vector< double > coefs,
+    Model<TSeq> * model
+) {
+
+    // Checking that there are features
+    if (coefs.size() == 0u)
+        throw std::logic_error(
+            "The -coefs- argument should feature at least one element."
+            );
+
+    if (coefs.size() != vars.size())
+        throw std::length_error(
+            std::string("The length of -coef- (") +
+            std::to_string(coefs.size()) + 
+            std::string(") and -vars- (") +
+            std::to_string(vars.size()) +
+            std::string(") should match. ")            
+            );
+
+    // Checking that there are variables in the model
+    if (model != nullptr)
+    {
+
+        size_t K = model->get_agents_data_ncols();
+        for (const auto & var: vars)
+        {
+            if ((var >= static_cast<int>(K)) | (var < 0))
+                throw std::range_error(
+                    std::string("The variable ") +
+                    std::to_string(var) +
+                    std::string(" is out of range.") +
+                    std::string(" The agents only feature ") +
+                    std::to_string(K) + 
+                    std::string("variables (features).")
+                );
+        }
+        
+    }
+
+    std::vector< epiworld_double > coefs_f;
+    for (auto c: coefs)
+        coefs_f.push_back(static_cast<epiworld_double>(c));
+
+    VirusFun<TSeq> fun_infect = [coefs_f,vars](
+        Agent<TSeq> * agent,
+        Virus<TSeq> &,
+        Model<TSeq> * model
+        ) -> epiworld_double {
+
+        size_t K = coefs_f.size();
+        epiworld_double res = 0.0;
+
+        #if defined(__OPENMP) || defined(_OPENMP)
+        #pragma omp simd reduction(+:res)
+        #endif
+        for (size_t i = 0u; i < K; ++i)
+            res += agent->operator()(vars.at(i), *model) * coefs_f.at(i);
+
+        return 1.0/(1.0 + std::exp(-res));
+
+    };
+
+    return fun_infect;
+
+}
+
+template<typename TSeq>
+inline Virus<TSeq>::Virus()
+{
+
+    #ifdef EPI_DEBUG_VIRUS
+    counter_construct++;
+    #endif
+
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        baseline_sequence = -1;
+    }
+    else
+    {
+        baseline_sequence = nullptr;
+    }
+
+}
+
+template<typename TSeq>
+inline Virus<TSeq>::Virus(
+    std::string name
+    ) {
+
+    #ifdef EPI_DEBUG_VIRUS
+    counter_construct++;
+    #endif
+
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        baseline_sequence = -1;
+    }
+    else
+    {
+        baseline_sequence = nullptr;
+    }
+    
+    set_name(name);
+}
+
+template<typename TSeq>
+inline Virus<TSeq>::Virus(
+    std::string name,
+    epiworld_double prevalence,
+    bool prevalence_as_proportion
+    ) {
+
+    #ifdef EPI_DEBUG_VIRUS
+    counter_construct++;
+    #endif
+
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        baseline_sequence = -1;
+    }
+    else
+    {
+        baseline_sequence = nullptr;
+    }
+
+    set_name(name);
+    set_distribution(
+        distribute_virus_randomly<TSeq>(
+            prevalence,
+            prevalence_as_proportion
+        )
+    );
+}
+
+#ifdef EPI_DEBUG_VIRUS
+template<typename TSeq>
+std::atomic<int> Virus<TSeq>::counter_construct = 0;
+
+template<typename TSeq>
+std::atomic<int> Virus<TSeq>::counter_copy_construct = 0;
+
+template<typename TSeq>
+std::atomic<int> Virus<TSeq>::counter_move_construct = 0;
+
+template<typename TSeq>
+std::atomic<int> Virus<TSeq>::counter_copy_assign = 0;
+
+template<typename TSeq>
+std::atomic<int> Virus<TSeq>::counter_move_assign = 0;
+
+template<typename TSeq>
+std::atomic<int> Virus<TSeq>::counter_destruct = 0;
+
+template<typename TSeq>
+inline Virus<TSeq>::~Virus()
+{
+    counter_destruct++;
+}
+
+// Copy constructor
+template<typename TSeq>
+inline Virus<TSeq>::Virus(const Virus<TSeq>& other)
+    : agent(other.agent),
+      baseline_sequence(other.baseline_sequence),
+      date(other.date),
+      id(other.id),
+      strain(other.strain)
+{
+    counter_copy_construct++;
+}
+
+// Move constructor
+template<typename TSeq>
+inline Virus<TSeq>::Virus(Virus<TSeq>&& other) noexcept
+    : agent(other.agent),
+      baseline_sequence(std::move(other.baseline_sequence)),
+      date(other.date),
+      id(other.id),
+      strain(std::move(other.strain))
+{
+    counter_move_construct++;
+    // other.agent = nullptr;
+}
+
+// Copy assignment
+template<typename TSeq>
+inline Virus<TSeq>& Virus<TSeq>::operator=(const Virus<TSeq>& other)
+{
+    if (this != &other) {
+        agent = other.agent;
+        baseline_sequence = other.baseline_sequence;
+        date = other.date;
+        id = other.id;
+        strain = other.strain;
+        counter_copy_assign++;
+    }
+    return *this;
+}
+
+// Move assignment
+template<typename TSeq>
+inline Virus<TSeq>& Virus<TSeq>::operator=(Virus<TSeq>&& other) noexcept
+{
+    if (this != &other) {
+        agent = other.agent;
+        baseline_sequence = std::move(other.baseline_sequence);
+        date = other.date;
+        id = other.id;
+        strain = std::move(other.strain);
+        other.agent = nullptr;
+        counter_move_assign++;
+    }
+    return *this;
+}
+#endif
+
+template<typename TSeq>
+inline typename Virus<TSeq>::Strain & Virus<TSeq>::strain_mut()
+{
+
+    // Copy-on-write: other copies of the virus keep the current strain
+    if (strain.use_count() > 1)
+        strain = std::make_shared<Strain>(*strain);
+
+    return *strain;
+
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::mutate(
+    Model<TSeq> * model
+) {
+
+    if (strain->mutation)
+        if (strain->mutation(agent, *this, model))
+            model->get_db().record_virus(*this);
+
+    return;
+    
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_mutation(
+    MutFun<TSeq> fun
+) {
+    strain_mut().mutation = MutFun<TSeq>(fun);
+}
+
+template<typename TSeq>
+inline EPI_TYPENAME_TRAITS(TSeq, int) Virus<TSeq>::get_sequence()
+{
+
+    return baseline_sequence;
+
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_sequence(TSeq sequence)
+{
+
+    baseline_sequence = std::make_shared<TSeq>(sequence);
+    return;
+
+}
+
+template<>
+inline void Virus<int>::set_sequence(int sequence)
+{
+
+    baseline_sequence = sequence;
+    return;
+
+}
+
+
+template<typename TSeq>
+inline Agent<TSeq> * Virus<TSeq>::get_agent()
+{
+
+    return agent;
+
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_agent(Agent<TSeq> * p)
+{
+    agent = p;
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_id(int idx)
+{
+
+    id = idx;
+    return;
+
+}
+
+template<typename TSeq>
+inline int Virus<TSeq>::get_id() const
+{
+    
+    return id;
+
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_date(int d) 
+{
+
+    date = d;
+    return;
+
+}
+
+template<typename TSeq>
+inline int Virus<TSeq>::get_date() const
+{
+    
+    return date;
+    
+}
+
+template<typename TSeq>
+inline epiworld_double Virus<TSeq>::get_prob_infecting(
+    Model<TSeq> * model
+)
+{
+
+    if (strain->probability_of_infecting)
+        return strain->probability_of_infecting(agent, *this, model);
+        
+    return EPI_DEFAULT_VIRUS_PROB_INFECTION;
+
+}
+
+
+
+template<typename TSeq>
+inline epiworld_double Virus<TSeq>::get_prob_recovery(
+    Model<TSeq> * model
+)
+{
+
+    if (strain->probability_of_recovery)
+        return strain->probability_of_recovery(agent, *this, model);
+        
+    return EPI_DEFAULT_VIRUS_PROB_RECOVERY;
+
+}
+
+
+
+template<typename TSeq>
+inline epiworld_double Virus<TSeq>::get_prob_death(
+    Model<TSeq> * model
+)
+{
+
+    if (strain->probability_of_death)
+        return strain->probability_of_death(agent, *this, model);
+        
+    return EPI_DEFAULT_VIRUS_PROB_DEATH;
+
+}
+
+template<typename TSeq>
+inline epiworld_double Virus<TSeq>::get_incubation(
+    Model<TSeq> * model
+)
+{
+
+    if (strain->incubation)
+        return strain->incubation(agent, *this, model);
+        
+    return EPI_DEFAULT_INCUBATION_DAYS;
+
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_prob_infecting_fun(VirusFun<TSeq> fun)
+{
+    strain_mut().probability_of_infecting = fun;
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_prob_recovery_fun(VirusFun<TSeq> fun)
+{
+    strain_mut().probability_of_recovery = fun;
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_prob_death_fun(VirusFun<TSeq> fun)
+{
+    strain_mut().probability_of_death = fun;
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_incubation_fun(VirusFun<TSeq> fun)
+{
+    strain_mut().incubation = fun;
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_prob_infecting(std::string param)
+{
+    const size_t param_id = Model<TSeq>::param_id(param);
+    VirusFun<TSeq> tmpfun = 
+        [param_id](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
+        {
+            return model->par(param_id);
+        };
+    
+    strain_mut().probability_of_infecting = tmpfun;
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_prob_recovery(std::string param)
+{
+    const size_t param_id = Model<TSeq>::param_id(param);
+    VirusFun<TSeq> tmpfun = 
+        [param_id](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
+        {
+            return model->par(param_id);
+        };
+    
+    strain_mut().probability_of_recovery = tmpfun;
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_prob_death(std::string param)
+{
+    const size_t param_id = Model<TSeq>::param_id(param);
+    VirusFun<TSeq> tmpfun = 
+        [param_id](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
+        {
+            return model->par(param_id);
+        };
+    
+    strain_mut().probability_of_death = tmpfun;
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_incubation(std::string param)
+{
+    const size_t param_id = Model<TSeq>::param_id(param);
+    VirusFun<TSeq> tmpfun = 
+        [param_id](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
+        {
+            return model->par(param_id);
+        };
+    
+    strain_mut().incubation = tmpfun;
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_prob_infecting(epiworld_double prob)
+{
+    VirusFun<TSeq> tmpfun = 
+        [prob](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> *)
+        {
+            return prob;
+        };
+    
+    strain_mut().probability_of_infecting = tmpfun;
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_prob_recovery(epiworld_double prob)
+{
+    VirusFun<TSeq> tmpfun = 
+        [prob](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> *)
+        {
+            return prob;
+        };
+    
+    strain_mut().probability_of_recovery = tmpfun;
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_prob_death(epiworld_double prob)
+{
+    VirusFun<TSeq> tmpfun = 
+        [prob](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> *)
+        {
+            return prob;
+        };
+    
+    strain_mut().probability_of_death = tmpfun;
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_incubation(epiworld_double prob)
+{
+    VirusFun<TSeq> tmpfun = 
+        [prob](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> *)
+        {
+            return prob;
+        };
+    
+    strain_mut().incubation = tmpfun;
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_post_recovery(PostRecoveryFun<TSeq> fun)
+{
+    if (strain->post_recovery_fun)
+    {
+        printf_epiworld(
+            "Warning: a PostRecoveryFun is alreay in place (overwriting)."
+            );
+    }
+
+    strain_mut().post_recovery_fun = fun;
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::post_recovery(
+    Model<TSeq> * model
+)
+{
+
+    if (strain->post_recovery_fun)
+        strain->post_recovery_fun(agent, *this, model);    
+
+    return;
+        
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_post_immunity(
+    epiworld_double prob
+)
+{
+
+    if (strain->post_recovery_fun)
+    {
+
+        std::string msg =
+            std::string(
+                "You cannot set post immunity when a post_recovery "
+                ) +
+            std::string(
+                "function is already in place. Redesign the post_recovery function."
+                );
+
+        throw std::logic_error(msg);
+        
+    }
+
+    // To make sure that we keep registering the virus
+    ToolPtr<TSeq> __no_reinfect = std::make_shared<Tool<TSeq>>(
+        "Immunity (" + strain->virus_name + ")"
+    );
+
+    __no_reinfect->set_susceptibility_reduction(prob);
+    __no_reinfect->set_death_reduction(0.0);
+    __no_reinfect->set_transmission_reduction(0.0);
+    __no_reinfect->set_recovery_enhancer(0.0);
+
+    PostRecoveryFun<TSeq> tmpfun = 
+        [__no_reinfect](
+            Agent<TSeq> * p, Virus<TSeq> &, Model<TSeq> * m
+            )
+        {
+            
+            // Have we registered the tool?
+            if (__no_reinfect->get_id() == -99)
+                m->get_db().record_tool(*__no_reinfect);
+
+            p->add_tool(*m, *__no_reinfect);
+
+            return;
+
+        };
+
+    strain_mut().post_recovery_fun = tmpfun;
+
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_post_immunity(
+    std::string param
+)
+{
+
+    if (strain->post_recovery_fun)
+    {
+
+        std::string msg =
+            std::string(
+                "You cannot set post immunity when a post_recovery "
+                ) +
+            std::string(
+                "function is already in place. Redesign the post_recovery function."
+                );
+
+        throw std::logic_error(msg);
+
+    }
+
+    // To make sure that we keep registering the virus
+    ToolPtr<TSeq> __no_reinfect = std::make_shared<Tool<TSeq>>(
+        "Immunity (" + strain->virus_name + ")"
+    );
+
+    __no_reinfect->set_susceptibility_reduction(param);
+    __no_reinfect->set_death_reduction(0.0);
+    __no_reinfect->set_transmission_reduction(0.0);
+    __no_reinfect->set_recovery_enhancer(0.0);
+
+    PostRecoveryFun<TSeq> tmpfun = 
+        [__no_reinfect](Agent<TSeq> * p, Virus<TSeq> &, Model<TSeq> * m)
+        {
+
+            // Have we registered the tool?
+            if (__no_reinfect->get_id() == -99)
+                m->get_db().record_tool(*__no_reinfect);
+
+            p->add_tool(*m, *__no_reinfect);
+
+            return;
+
+        };
+
+    strain_mut().post_recovery_fun = tmpfun;
+
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_name(std::string name)
+{
+
+    strain_mut().virus_name = name;
+
+}
+
+template<typename TSeq>
+inline std::string Virus<TSeq>::get_name() const
+{
+
+    return strain->virus_name;
+
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_state(
+    epiworld_fast_int init,
+    epiworld_fast_int end,
+    epiworld_fast_int removed
+)
+{
+    strain_mut().state_init    = init;
+    strain_mut().state_post    = end;
+    strain_mut().state_removed = removed;
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_queue(
+    epiworld_fast_int init,
+    epiworld_fast_int end,
+    epiworld_fast_int removed
+)
+{
+
+    strain_mut().queue_init    = init;
+    strain_mut().queue_post     = end;
+    strain_mut().queue_removed = removed;
+
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::get_state(
+    epiworld_fast_int * init,
+    epiworld_fast_int * end,
+    epiworld_fast_int * removed
+) const
+{
+
+    if (init != nullptr)
+        *init = strain->state_init;
+
+    if (end != nullptr)
+        *end = strain->state_post;
+
+    if (removed != nullptr)
+        *removed = strain->state_removed;
+
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::get_queue(
+    epiworld_fast_int * init,
+    epiworld_fast_int * end,
+    epiworld_fast_int * removed
+) const
+{
+
+    if (init != nullptr)
+        *init = strain->queue_init;
+
+    if (end != nullptr)
+        *end = strain->queue_post;
+
+    if (removed != nullptr)
+        *removed = strain->queue_removed;
+        
+}
+
+template<>
+inline bool Virus<std::vector<int>>::operator==(
+    const Virus<std::vector<int>> & other
+    ) const
+{
+    
+    EPI_DEBUG_FAIL_AT_TRUE(
+        baseline_sequence->size() != other.baseline_sequence->size(),
+        "Virus:: baseline_sequence don't match"
+        )
+
+    for (size_t i = 0u; i < baseline_sequence->size(); ++i)
+    {
+
+        EPI_DEBUG_FAIL_AT_TRUE(
+            baseline_sequence->operator[](i) != other.baseline_sequence->operator[](i),
+            "Virus:: baseline_sequence[i] don't match"
+            )
+
+    }
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->virus_name != other.strain->virus_name,
+        "Virus:: virus_name don't match"
+        )
+    
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->state_init != other.strain->state_init,
+        "Virus:: state_init don't match"
+        )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->state_post != other.strain->state_post,
+        "Virus:: state_post don't match"
+        )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->state_removed != other.strain->state_removed,
+        "Virus:: state_removed don't match"
+        )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->queue_init != other.strain->queue_init,
+        "Virus:: queue_init don't match"
+        )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->queue_post != other.strain->queue_post,
+        "Virus:: queue_post don't match"
+        )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->queue_removed != other.strain->queue_removed,
+        "Virus:: queue_removed don't match"
+        )
+
+    return true;
+
+}
+
+template<typename TSeq>
+inline bool Virus<TSeq>::operator==(const Virus<TSeq> & other) const
+{
+    
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        EPI_DEBUG_FAIL_AT_TRUE(
+            baseline_sequence != other.baseline_sequence,
+            "Virus:: baseline_sequence don't match"
+        )
+    }
+    else
+    {
+        EPI_DEBUG_FAIL_AT_TRUE(
+            baseline_sequence != other.baseline_sequence,
+            "Virus:: baseline_sequence don't match"
+        )
+    }
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->virus_name != other.strain->virus_name,
+        "Virus:: virus_name don't match"
+    )
+    
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->state_init != other.strain->state_init,
+        "Virus:: state_init don't match"
+    )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->state_post != other.strain->state_post,
+        "Virus:: state_post don't match"
+    )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->state_removed != other.strain->state_removed,
+        "Virus:: state_removed don't match"
+    )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->queue_init != other.strain->queue_init,
+        "Virus:: queue_init don't match"
+    )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->queue_post != other.strain->queue_post,
+        "Virus:: queue_post don't match"
+    )
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->queue_removed != other.strain->queue_removed,
+        "Virus:: queue_removed don't match"
+    )
+
+    return true;
+
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::print() const
+{
+
+    printf_epiworld("Virus         : %s\n", strain->virus_name.c_str());
+    printf_epiworld("Id            : %s\n", (id < 0)? std::string("(empty)").c_str() : std::to_string(id).c_str());
+    printf_epiworld("state_init    : %i\n", static_cast<int>(strain->state_init));
+    printf_epiworld("state_post    : %i\n", static_cast<int>(strain->state_post));
+    printf_epiworld("state_removed : %i\n", static_cast<int>(strain->state_removed));
+    printf_epiworld("queue_init    : %i\n", static_cast<int>(strain->queue_init));
+    printf_epiworld("queue_post    : %i\n", static_cast<int>(strain->queue_post));
+    printf_epiworld("queue_removed : %i\n", static_cast<int>(strain->queue_removed));
+
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::distribute(Model<TSeq> * model)
+{
+
+    if (strain->dist)
+    {
+
+        strain->dist(*this, model);
+
+    }
+
+}
+
+template<typename TSeq>
+inline void Virus<TSeq>::set_distribution(VirusToAgentFun<TSeq> fun)
+{
+    strain_mut().dist = fun;
+}
+
+template<typename TSeq>
+inline std::unique_ptr<Virus<TSeq>> Virus<TSeq>::clone_ptr() const
+{
+    auto cloned = std::make_unique<Virus<TSeq>>(*this);
+    return cloned;
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/virus-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+    
+    // #include "tools-bones.hpp"
+
+// (already included ./include/epiworld/tool-bones.hpp)
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/tool-distribute-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef TOOL_DISTRIBUTE_MEAT_HPP
+#define TOOL_DISTRIBUTE_MEAT_HPP
+
+/**
+ * @brief Distributes a tool to a set of agents.
+ * 
+ * This function takes a vector of agent IDs and returns a lambda function that
+ * distributes a tool to each agent in the set.
+ * 
+ * The lambda function takes a reference to a Tool object and a pointer to a
+ * Model object as parameters. It iterates over the agent IDs and adds the tool
+ * to each agent using the add_tool() method of the Model object.
+ * 
+ * @tparam TSeq The sequence type used in the Tool and Model objects.
+ * @param agents_ids A vector of agent IDs representing the set of agents to
+ * distribute the tool to.
+ * @return A lambda function that distributes the tool to the set of agents.
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline ToolToAgentFun<TSeq> distribute_tool_to_set(
+    std::vector< size_t > agents_ids
+) {
+
+    return [agents_ids](
+        Tool<TSeq> & tool, Model<TSeq> * model
+    ) -> void 
+    { 
+        // Adding action
+        for (auto i: agents_ids)
+        {
+            model->get_agent(i).add_tool(
+                *model, tool
+                );
+        }
+    };
+
+}
+
+/**
+ * Function template to distribute a tool randomly to agents in a model.
+ * 
+ * @tparam TSeq The sequence type used in the model.
+ * @param prevalence The prevalence of the tool in the population.
+ * @param as_proportion Flag indicating whether the prevalence is given as a
+ * proportion or an absolute value.
+ * @return A lambda function that distributes the tool randomly to agents in
+ * the model.
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline ToolToAgentFun<TSeq> distribute_tool_randomly(
+    epiworld_double prevalence,
+    bool as_proportion = true,
+    std::vector< size_t > agents_ids = {}
+) {
+
+    auto agents_ids_ptr = std::make_shared< std::vector< size_t > >(agents_ids);
+
+    return [prevalence,as_proportion,agents_ids_ptr](
+        Tool<TSeq> & tool, Model<TSeq> * model
+        ) -> void {
+
+            // Figuring out how what agents are available
+            bool use_set = agents_ids_ptr->size() > 0;
+
+            // Picking how many
+            int n_to_distribute;
+            int n = use_set ? 
+                static_cast<int>(agents_ids_ptr->size()) :
+                static_cast<int>(model->size());
+                
+            if (as_proportion)
+            {
+                n_to_distribute = static_cast<int>(std::floor(prevalence * n));
+
+                // Correcting for possible rounding errors
+                if (n_to_distribute > n)
+                    n_to_distribute = n;
+
+            }
+            else
+            {
+                n_to_distribute = static_cast<int>(prevalence);
+            }
+
+            if (n_to_distribute > n)
+                throw std::range_error("There are only " + std::to_string(n) + 
+                " individuals in the population. Cannot add the tool to " + std::to_string(n_to_distribute));
+            
+            std::vector< int > idx(n);
+            std::iota(idx.begin(), idx.end(), 0);
+            auto & population = model->get_agents();
+            for (int i = 0u; i < n_to_distribute; ++i)
+            {
+                int loc = model->runif_index(n--);
+
+                if ((n > 0) && (loc >= n))
+                    loc = n - 1;
+                
+                population[idx[loc]].add_tool(
+                    *model, tool
+                    );
+                
+                std::swap(idx[loc], idx[n]);
+
+            }
+
+        };
+
+}
+
+/**
+ * Function template to distribute a tool to agents in each entity of a model.
+ * 
+ * @tparam TSeq The sequence type used in the model.
+ * @param prevalence A vector of prevalences for each entity in the model.
+ * @param as_proportion Flag indicating whether the prevalences are given as
+ * proportions or absolute values.
+ * @return A lambda function that distributes the tool to agents in each entity
+ * of the model.
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline ToolToAgentFun<TSeq> distribute_tool_to_entities(
+    std::vector< double > prevalence,
+    bool as_proportion = true
+)
+{
+
+    // Checking proportions are within range
+    if (prevalence.size() == 0)
+        throw std::range_error("Prevalence vector cannot be empty");
+
+    if (as_proportion)
+    {
+        for (auto p: prevalence)
+        {
+            if ((p < 0.0) || (p > 1.0))
+                throw std::range_error("Proportions must be between 0 and 1");
+        }
+    }
+    else
+    {
+        for (auto p: prevalence)
+        {
+            if (p < 0.0)
+                throw std::range_error("Count values in prevalence must be non-negative");
+        }
+    }
+
+    return [prevalence, as_proportion](
+        Tool<TSeq> & tool, Model<TSeq> * model
+    ) -> void 
+    { 
+
+        // Checking the number of entities
+        if (prevalence.size() != model->get_entities().size())
+            throw std::range_error(
+                "Prevalence vector size (" + std::to_string(prevalence.size()) +
+                ") does not match number of entities (" + std::to_string(model->get_entities().size()) + ")"
+                );
+
+        // Adding action
+        auto & entities = model->get_entities();
+        auto & population = model->get_agents();
+        for (size_t e = 0; e < entities.size(); ++e)
+        {
+            auto & entity_e = entities[e];
+            auto agent_ids = entity_e.get_agents_ids();
+            double prevalence_e = prevalence[e];
+            size_t n = agent_ids.size();
+            size_t n_to_distribute;
+            if (as_proportion)
+                n_to_distribute = static_cast<size_t>(std::floor(prevalence_e * n));
+            else
+                n_to_distribute = static_cast<size_t>(prevalence_e);
+
+            if (n_to_distribute > n)
+                n_to_distribute = n;
+
+            std::vector< epiworld_agent_index > idx = agent_ids;
+            for (size_t i = 0u; i < n_to_distribute; ++i)
+            {
+                size_t loc = model->runif_index(n--);
+
+                if ((n > 0) && (loc >= n))
+                    loc = n - 1;
+                
+                population[idx[loc]].add_tool(
+                    *model, tool
+                    );
+                
+                std::swap(idx[loc], idx[n]);
+
+            }
+        }
+    };
+
+}
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/tool-distribute-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/tool-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+#ifndef EPIWORLD_TOOLS_MEAT_HPP
+#define EPIWORLD_TOOLS_MEAT_HPP
+
+/**
+ * @brief Factory function of ToolFun base on logit
+ * 
+ * @tparam TSeq 
+ * @param vars Vector indicating the position of the variables to use.
+ * @param coefs Vector of coefficients.
+ * @return ToolFun<TSeq> 
+ */
+template<typename TSeq>
+inline ToolFun<TSeq> tool_fun_logit(
+    std::vector< int > vars,
+    std::vector< double > coefs,
+    Model<TSeq> * model
+) {
+
+    // Checking that there are features
+    if (coefs.size() == 0u)
+        throw std::logic_error(
+            "The -coefs- argument should feature at least one element."
+            );
+
+    if (coefs.size() != vars.size())
+        throw std::length_error(
+            std::string("The length of -coef- (") +
+            std::to_string(coefs.size()) + 
+            std::string(") and -vars- (") +
+            std::to_string(vars.size()) +
+            std::string(") should match. ")            
+            );
+
+    // Checking that there are variables in the model
+    if (model != nullptr)
+    {
+
+        size_t K = model->get_agents_data_ncols();
+        for (const auto & var: vars)
+        {
+            if ((var >= static_cast<int>(K)) | (var < 0))
+                throw std::range_error(
+                    std::string("The variable ") +
+                    std::to_string(var) +
+                    std::string(" is out of range.") +
+                    std::string(" The agents only feature ") +
+                    std::to_string(K) + 
+                    std::string("variables (features).")
+                );
+        }
+        
+    }
+
+    std::vector< epiworld_double > coefs_f;
+    for (auto c: coefs)
+        coefs_f.push_back(static_cast<epiworld_double>(c));
+
+    ToolFun<TSeq> fun_ = [coefs_f,vars](
+        Tool<TSeq>&,
+        Agent<TSeq> * agent,
+        VirusPtr<TSeq> &,
+        Model<TSeq> * model
+        ) -> epiworld_double {
+
+        size_t K = coefs_f.size();
+        epiworld_double res = 0.0;
+
+        #if defined(__OPENMP) || defined(_OPENMP)
+        #pragma omp simd reduction(+:res)
+        #endif
+        for (size_t i = 0u; i < K; ++i)
+            res += agent->operator()(vars.at(i), *model) * coefs_f.at(i);
+
+        return 1.0/(1.0 + std::exp(-res));
+
+    };
+
+    return fun_;
+
+}
+
+template<typename TSeq>
+inline Tool<TSeq>::Tool()
+{
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        sequence = -1;
+    }
+    else
+    {
+        sequence = nullptr;
+    }
+
+    set_name("Tool");
+}
+
+template<typename TSeq>
+inline Tool<TSeq>::Tool(std::string name)
+{
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        sequence = -1;
+    }
+    else
+    {
+        sequence = nullptr;
+    }
+
+    set_name(name);
+}
+
+template<typename TSeq>
+inline Tool<TSeq>::Tool(
+    std::string name,
+    epiworld_double prevalence,
+    bool as_proportion
+    )
+{
+
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        sequence = -1;
+    }
+    else
+    {
+        sequence = nullptr;
+    }
+
+    set_name(name);
+
+    set_distribution(
+        distribute_tool_randomly<TSeq>(prevalence, as_proportion)
+    );
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_sequence(TSeq d) {
+    sequence = std::make_shared<TSeq>(d);
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_sequence(std::shared_ptr<TSeq> d) {
+    sequence = d;
+}
+
+template<>
+inline void Tool<int>::set_sequence(int d) {
+    sequence = d;
+}
+
+template<typename TSeq>
+inline EPI_TYPENAME_TRAITS(TSeq, int) Tool<TSeq>::get_sequence() {
+    return sequence;
+}
+
+template<typename TSeq>
+inline epiworld_double Tool<TSeq>::get_susceptibility_reduction(
+    VirusPtr<TSeq> & v,
+    Model<TSeq> * model
+)
+{
+
+    if (def->susceptibility_reduction)
+        return def->susceptibility_reduction(
+            *this, this->agent, v, model
+        );
+
+    return DEFAULT_TOOL_CONTAGION_REDUCTION;
+
+}
+
+template<typename TSeq>
+inline epiworld_double Tool<TSeq>::get_transmission_reduction(
+    VirusPtr<TSeq> & v,
+    Model<TSeq> * model
+)
+{
+
+    if (def->transmission_reduction)
+        return def->transmission_reduction(
+            *this, this->agent, v, model
+        );
+
+    return DEFAULT_TOOL_TRANSMISSION_REDUCTION;
+
+}
+
+template<typename TSeq>
+inline epiworld_double Tool<TSeq>::get_recovery_enhancer(
+    VirusPtr<TSeq> & v,
+    Model<TSeq> * model
+)
+{
+
+    if (def->recovery_enhancer)
+        return def->recovery_enhancer(*this, this->agent, v, model);
+
+    return DEFAULT_TOOL_RECOVERY_ENHANCER;
+
+}
+
+template<typename TSeq>
+inline epiworld_double Tool<TSeq>::get_death_reduction(
+    VirusPtr<TSeq> & v,
+    Model<TSeq> * model
+)
+{
+
+    if (def->death_reduction)
+        return def->death_reduction(*this, this->agent, v, model);
+
+    return DEFAULT_TOOL_DEATH_REDUCTION;
+
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_susceptibility_reduction_fun(
+    ToolFun<TSeq> fun
+)
+{
+    def_mut().susceptibility_reduction = fun;
+    set_fixed_effect(0u, fun == nullptr, DEFAULT_TOOL_CONTAGION_REDUCTION);
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_transmission_reduction_fun(
+    ToolFun<TSeq> fun
+)
+{
+    def_mut().transmission_reduction = fun;
+    set_fixed_effect(1u, fun == nullptr, DEFAULT_TOOL_TRANSMISSION_REDUCTION);
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_recovery_enhancer_fun(
+    ToolFun<TSeq> fun
+)
+{
+    def_mut().recovery_enhancer = fun;
+    set_fixed_effect(2u, fun == nullptr, DEFAULT_TOOL_RECOVERY_ENHANCER);
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_death_reduction_fun(
+    ToolFun<TSeq> fun
+)
+{
+    def_mut().death_reduction = fun;
+    set_fixed_effect(3u, fun == nullptr, DEFAULT_TOOL_DEATH_REDUCTION);
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_susceptibility_reduction(std::string param)
+{
+
+    const size_t param_id = Model<TSeq>::param_id(param);
+
+    ToolFun<TSeq> tmpfun =
+        [param_id](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
+        {
+            return model->par(param_id);
+        };
+
+    def_mut().susceptibility_reduction = tmpfun;
+    set_fixed_effect(0u, false, 0.0);
+
+}
+
+// EPIWORLD_SET_LAMBDA(susceptibility_reduction)
+template<typename TSeq>
+inline void Tool<TSeq>::set_transmission_reduction(std::string param)
+{
+
+    const size_t param_id = Model<TSeq>::param_id(param);
+    
+    ToolFun<TSeq> tmpfun =
+        [param_id](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
+        {
+            return model->par(param_id);
+        };
+
+    def_mut().transmission_reduction = tmpfun;
+    set_fixed_effect(1u, false, 0.0);
+
+}
+
+// EPIWORLD_SET_LAMBDA(transmission_reduction)
+template<typename TSeq>
+inline void Tool<TSeq>::set_recovery_enhancer(std::string param)
+{
+
+    const size_t param_id = Model<TSeq>::param_id(param);
+
+    ToolFun<TSeq> tmpfun =
+        [param_id](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
+        {
+            return model->par(param_id);
+        };
+
+    def_mut().recovery_enhancer = tmpfun;
+    set_fixed_effect(2u, false, 0.0);
+
+}
+
+// EPIWORLD_SET_LAMBDA(recovery_enhancer)
+template<typename TSeq>
+inline void Tool<TSeq>::set_death_reduction(std::string param)
+{
+
+    const size_t param_id = Model<TSeq>::param_id(param);
+
+    ToolFun<TSeq> tmpfun =
+        [param_id](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
+        {
+            return model->par(param_id);
+        };
+
+    def_mut().death_reduction = tmpfun;
+    set_fixed_effect(3u, false, 0.0);
+
+}
+
+// EPIWORLD_SET_LAMBDA(death_reduction)
+
+// #undef EPIWORLD_SET_LAMBDA
+template<typename TSeq>
+inline void Tool<TSeq>::set_susceptibility_reduction(
+    epiworld_double prob
+)
+{
+
+    ToolFun<TSeq> tmpfun = 
+        [prob](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq> *)
+        {
+            return prob;
+        };
+
+    def_mut().susceptibility_reduction = tmpfun;
+    set_fixed_effect(0u, true, prob);
+
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_transmission_reduction(
+    epiworld_double prob
+)
+{
+
+    ToolFun<TSeq> tmpfun = 
+        [prob](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq> *)
+        {
+            return prob;
+        };
+
+    def_mut().transmission_reduction = tmpfun;
+    set_fixed_effect(1u, true, prob);
+
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_recovery_enhancer(
+    epiworld_double prob
+)
+{
+
+    ToolFun<TSeq> tmpfun = 
+        [prob](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq> *)
+        {
+            return prob;
+        };
+
+    def_mut().recovery_enhancer = tmpfun;
+    set_fixed_effect(2u, true, prob);
+
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_death_reduction(
+    epiworld_double prob
+)
+{
+
+    ToolFun<TSeq> tmpfun = 
+        [prob](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq> *)
+        {
+            return prob;
+        };
+
+    def_mut().death_reduction = tmpfun;
+    set_fixed_effect(3u, true, prob);
+
+}
+
+template<typename TSeq>
+inline typename Tool<TSeq>::Definition & Tool<TSeq>::def_mut()
+{
+
+    // Copy-on-write: other copies of the tool keep the current definition
+    if (def.use_count() > 1)
+        def = std::make_shared<Definition>(*def);
+
+    return *def;
+
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_fixed_effect(
+    size_t k,
+    bool fixed,
+    epiworld_double value
+)
+{
+
+    Definition & d = def_mut();
+    if (fixed)
+    {
+        d.fixed_mask |= static_cast<unsigned char>(1u << k);
+        d.fixed_value[k] = value;
+    }
+    else
+        d.fixed_mask &= static_cast<unsigned char>(~(1u << k));
+
+    // Already in an agent, so its cache is stale
+    if (agent != nullptr)
+        agent->tools_effects_update();
+
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_name(std::string name)
+{
+    def_mut().tool_name = name;
+}
+
+template<typename TSeq>
+inline std::string Tool<TSeq>::get_name() const {
+
+    return def->tool_name;
+
+}
+
+template<typename TSeq>
+inline Agent<TSeq> * Tool<TSeq>::get_agent()
+{
+    return this->agent;
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_agent(Agent<TSeq> * p, size_t idx)
+{
+    agent        = p;
+    pos_in_agent = static_cast<int>(idx);
+}
+
+template<typename TSeq>
+inline int Tool<TSeq>::get_id() const {
+    return id;
+}
+
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_id(int id)
+{
+    this->id = id;
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_date(int d)
+{
+    this->date = d;
+}
+
+template<typename TSeq>
+inline int Tool<TSeq>::get_date() const
+{
+    return date;
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_state(
+    epiworld_fast_int init,
+    epiworld_fast_int end
+)
+{
+    def_mut().state_init = init;
+    def_mut().state_post = end;
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_queue(
+    epiworld_fast_int init,
+    epiworld_fast_int end
+)
+{
+    def_mut().queue_init = init;
+    def_mut().queue_post = end;
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::get_state(
+    epiworld_fast_int * init,
+    epiworld_fast_int * post
+)
+{
+    if (init != nullptr)
+        *init = def->state_init;
+
+    if (post != nullptr)
+        *post = def->state_post;
+
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::get_queue(
+    epiworld_fast_int * init,
+    epiworld_fast_int * post
+)
+{
+    if (init != nullptr)
+        *init = def->queue_init;
+
+    if (post != nullptr)
+        *post = def->queue_post;
+
+}
+
+template<>
+inline bool Tool<std::vector<int>>::operator==(
+    const Tool<std::vector<int>> & other
+    ) const
+{
+    
+    if (sequence->size() != other.sequence->size())
+        return false;
+
+    for (size_t i = 0u; i < sequence->size(); ++i)
+    {
+        if (sequence->operator[](i) != other.sequence->operator[](i))
+            return false;
+    }
+
+    if (def->tool_name != other.def->tool_name)
+        return false;
+    
+    if (def->state_init != other.def->state_init)
+        return false;
+
+    if (def->state_post != other.def->state_post)
+        return false;
+
+    if (def->queue_init != other.def->queue_init)
+        return false;
+
+    if (def->queue_post != other.def->queue_post)
+        return false;
+
+
+    return true;
+
+}
+
+template<typename TSeq>
+inline bool Tool<TSeq>::operator==(const Tool<TSeq> & other) const
+{
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        if (sequence != other.sequence)
+            return false;
+    }
+    else
+    {
+        if (*sequence != *other.sequence)
+            return false;
+    }
+
+
+    if (def->tool_name != other.def->tool_name)
+        return false;
+    
+    if (def->state_init != other.def->state_init)
+        return false;
+
+    if (def->state_post != other.def->state_post)
+        return false;
+
+    if (def->queue_init != other.def->queue_init)
+        return false;
+
+    if (def->queue_post != other.def->queue_post)
+        return false;
+
+    return true;
+
+}
+
+
+template<typename TSeq>
+inline void Tool<TSeq>::print() const
+{
+
+    printf_epiworld("Tool       : %s\n", this->get_name().c_str());
+    printf_epiworld("Id         : %s\n", (id < 0)? std::string("(empty)").c_str() : std::to_string(id).c_str());
+    printf_epiworld("state_init : %i\n", static_cast<int>(def->state_init));
+    printf_epiworld("state_post : %i\n", static_cast<int>(def->state_post));
+    printf_epiworld("queue_init : %i\n", static_cast<int>(def->queue_init));
+    printf_epiworld("queue_post : %i\n", static_cast<int>(def->queue_post));
+
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::distribute(Model<TSeq> * model)
+{
+
+    if (def->dist)
+    {
+
+        def->dist(*this, model);
+
+    }
+
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_distribution(ToolToAgentFun<TSeq> fun)
+{
+    def_mut().dist = fun;
+}
+
+template<typename TSeq>
+inline std::unique_ptr<Tool<TSeq>> Tool<TSeq>::clone_ptr() const
+{
+    auto cloned = std::make_unique<Tool<TSeq>>(*this);
+    return cloned;
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/tool-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/entity-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_ENTITY_BONES_HPP
+#define EPIWORLD_ENTITY_BONES_HPP
+
+template<typename TSeq>
+class Model;
+
+template<typename TSeq>
+class Agent;
+
+template<typename TSeq>
+class AgentsSample;
+
+/**
+ * @brief Groups of agents within a model.
+ */
+template<typename TSeq>
+class Entity {
+    friend class Agent<TSeq>;
+    friend class AgentsSample<TSeq>;
+    friend class Model<TSeq>;
+private:
+    
+    int id = -1;
+    std::vector< epiworld_agent_index > agents;   ///< Agent IDs (indices into Model::population)
+
+    int max_capacity = -1;
+    std::string entity_name = "Unnamed entity";
+
+    std::vector< epiworld_double > location = {0.0}; ///< An arbitrary vector for location
+
+    epiworld_fast_int state_init = -99;
+    epiworld_fast_int state_post = -99;
+
+    epiworld_fast_int queue_init = 0; ///< Change of state when added to agent.
+    epiworld_fast_int queue_post = 0; ///< Change of state when removed from agent.
+
+    EntityToAgentFun<TSeq> dist_fun = nullptr;
+
+    void reset();
+
+public:
+
+
+    /**
+     * @brief Constructs an Entity object.
+     *
+     * This constructor initializes an Entity object with the specified parameters.
+     *
+     * @param name The name of the entity.
+     * @param fun A function pointer to a function that maps the entity to an agent.
+     */
+    Entity(
+        std::string name,
+        EntityToAgentFun<TSeq> fun = nullptr
+        ) :
+            entity_name(name),
+            dist_fun(fun)
+        {};
+
+    ~Entity() = default;
+    
+    void add_agent(Agent<TSeq> & p, Model<TSeq> & model);
+    void add_agent(Agent<TSeq> * p, Model<TSeq> & model);
+    void rm_agent(size_t idx, Model<TSeq> & model);
+    size_t size() const noexcept;
+    void set_location(std::vector< epiworld_double > loc);
+    std::vector< epiworld_double > & get_location();
+
+    typename std::vector< epiworld_agent_index >::iterator begin();
+    typename std::vector< epiworld_agent_index >::iterator end();
+
+    typename std::vector< epiworld_agent_index >::const_iterator begin() const;
+    typename std::vector< epiworld_agent_index >::const_iterator end() const;
+
+    size_t operator[](size_t i);
+
+    int get_id() const noexcept;
+    const std::string & get_name() const noexcept;
+
+    void set_state(epiworld_fast_int init, epiworld_fast_int post);
+    void set_queue(epiworld_fast_int init, epiworld_fast_int post);
+    void get_state(epiworld_fast_int * init, epiworld_fast_int * post);
+    void get_queue(epiworld_fast_int * init, epiworld_fast_int * post);
+
+    bool operator==(const Entity<TSeq> & other) const;
+    bool operator!=(const Entity<TSeq> & other) const {return !operator==(other);};
+
+    /** 
+     * @name Entity distribution
+     * 
+     * @details These functions are used for distributing agents among entities.
+     * The idea is to have a flexible way of distributing agents among entities.
+     
+     */
+    void distribute(Model<TSeq> * model);
+
+    const std::vector< epiworld_agent_index > & get_agents() const;
+    const std::vector< epiworld_agent_index > & get_agents_ids() const;
+
+    void print() const;
+    void set_distribution(EntityToAgentFun<TSeq> fun);
+
+};
+
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/entity-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/entity-distribute-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_ENTITY_DISTRIBUTE_MEAT_HPP
+#define EPIWORLD_ENTITY_DISTRIBUTE_MEAT_HPP
+
+
+template <typename TSeq = EPI_DEFAULT_TSEQ>
+/**
+ * Distributes an entity to unassigned agents in the model.
+ * 
+ * @param prevalence The proportion of agents to distribute the entity to.
+ * @param as_proportion Flag indicating whether the prevalence is a proportion
+ * @param to_unassigned Flag indicating whether to distribute the entity only
+ * to unassigned agents.
+ * @return An EntityToAgentFun object that distributes the entity to unassigned
+ * agents.
+ */
+inline EntityToAgentFun<TSeq> distribute_entity_randomly(
+    epiworld_double prevalence,
+    bool as_proportion,
+    bool to_unassigned
+)
+{
+
+    return [prevalence, as_proportion, to_unassigned](
+        Entity<TSeq> & e, Model<TSeq> * m
+        ) -> void {
+
+        
+        // Preparing the sampling space
+        std::vector< size_t > idx;
+        if (to_unassigned)
+        {
+            for (const auto & a: m->get_agents())
+                if (a.get_n_entities() == 0)
+                    idx.push_back(a.get_id());
+        } 
+        else
+        {
+
+            for (const auto & a: m->get_agents())
+                idx.push_back(a.get_id());
+
+        }
+        
+        size_t n = idx.size();
+
+        // Figuring out how many to sample
+        int n_to_sample;
+        if (as_proportion)
+        {
+            n_to_sample = static_cast<int>(std::floor(prevalence * n));
+
+            // Correcting for possible overflow
+            if (n_to_sample > static_cast<int>(n))
+                n_to_sample = static_cast<int>(n);
+
+        } else
+        {
+            n_to_sample = static_cast<int>(prevalence);
+            if (n_to_sample > static_cast<int>(n))
+                throw std::range_error("There are only " + std::to_string(n) + 
+                " individuals in the population. Cannot add the entity to " +
+                    std::to_string(n_to_sample));
+        }
+
+        int n_left = n;
+        for (int i = 0; i < n_to_sample; ++i)
+        {
+            int loc = m->runif_index(n_left--);
+
+            // Correcting for possible overflow
+            if ((n_left > 0) && (loc > n_left))
+                loc = n_left - 1;
+
+            m->get_agent(idx[loc]).add_entity(*m, e);
+
+            std::swap(idx[loc], idx[n_left]);
+
+        }
+
+    };
+
+}
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+/**
+ * Distributes an entity to a range of agents.
+ *
+ * @param from The starting index of the range.
+ * @param to The ending index of the range.
+ * @param to_unassigned Flag indicating whether to distribute the entity only
+ * to unassigned agents.
+ * @return A lambda function that distributes the entity to the specified range
+ * of agents.
+ */
+inline EntityToAgentFun<TSeq> distribute_entity_to_range(
+    int from,
+    int to,
+    bool to_unassigned = false
+    ) {
+
+    if (to_unassigned)
+    {
+
+        return [from, to](Entity<TSeq> & e, Model<TSeq> * m) -> void {
+
+            auto & agents = m->get_agents();
+            for (int i = from; i < to; ++i)
+            {
+                if (agents[i].get_n_entities() == 0)
+                    e.add_agent(&agents[i], *m);
+                else
+                    throw std::logic_error(
+                        "Agent " + std::to_string(i) + " already has an entity."
+                    );
+            }
+            
+            return;
+
+        };
+
+    }
+    else
+    {
+
+        return [from, to](Entity<TSeq> & e, Model<TSeq> * m) -> void {
+
+            auto & agents = m->get_agents();
+            for (int i = from; i < to; ++i)
+            {
+                e.add_agent(&agents[i], *m);
+            }
+
+            return;
+
+        };
+
+    }
+}
+
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline EntityToAgentFun<TSeq> distribute_entity_to_set(
+    std::vector< size_t > & idx
+    ) {
+
+    auto idx_shared = std::make_shared< std::vector< size_t > >(idx);
+
+    return [idx_shared](Entity<TSeq> & e, Model<TSeq> * m) -> void {
+
+        for (const auto & i: *idx_shared)
+        {
+            e.add_agent(&m->get_agent(i), *m);
+        }
+
+    };
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/entity-distribute-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/entity-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_ENTITY_MEAT_HPP
+#define EPIWORLD_ENTITY_MEAT_HPP
+
+template<typename TSeq>
+inline void Entity<TSeq>::add_agent(
+    Agent<TSeq> & p,
+    Model<TSeq> & model
+    )
+{
+
+    // Need to add it to the events, through the individual
+    p.add_entity(model, *this);
+
+}
+
+template<typename TSeq>
+inline void Entity<TSeq>::add_agent(
+    Agent<TSeq> * p,
+    Model<TSeq> & model
+    )
+{
+    p->add_entity(model, *this);
+}
+
+template<typename TSeq>
+inline void Entity<TSeq>::rm_agent(size_t idx, Model<TSeq> & model)
+{
+    if (idx >= size())
+        throw std::out_of_range(
+            "Trying to remove agent "+ std::to_string(idx) +
+            " out of " + std::to_string(size())
+            );
+
+    model.population[agents[idx]].rm_entity(model, *this);
+
+    return;
+}
+
+template<typename TSeq>
+inline size_t Entity<TSeq>::size() const noexcept
+{
+    return agents.size();
+}
+
+template<typename TSeq>
+inline void Entity<TSeq>::set_location(std::vector< epiworld_double > loc)
+{
+    location = loc;
+}
+
+template<typename TSeq>
+inline std::vector< epiworld_double > & Entity<TSeq>::get_location()
+{
+    return location;
+}
+
+template<typename TSeq>
+inline typename std::vector< epiworld_agent_index >::iterator Entity<TSeq>::begin()
+{
+
+    return agents.begin();
+
+}
+
+template<typename TSeq>
+inline typename std::vector< epiworld_agent_index >::iterator Entity<TSeq>::end()
+{
+    return agents.end();
+}
+
+template<typename TSeq>
+inline typename std::vector< epiworld_agent_index >::const_iterator Entity<TSeq>::begin() const
+{
+
+    return agents.begin();
+
+}
+
+template<typename TSeq>
+inline typename std::vector< epiworld_agent_index >::const_iterator Entity<TSeq>::end() const
+{
+    return agents.end();
+}
+
+template<typename TSeq>
+size_t Entity<TSeq>::operator[](size_t i)
+{
+    if (agents.size() <= i)
+        throw std::logic_error(
+            "There are not that many agents in this entity. " +
+            std::to_string(agents.size()) + " <= " + std::to_string(i)
+            );
+
+    return agents[i];
+}
+
+template<typename TSeq>
+inline int Entity<TSeq>::get_id() const noexcept
+{
+    return id;
+}
+
+template<typename TSeq>
+inline const std::string & Entity<TSeq>::get_name() const noexcept
+{
+    return entity_name;
+}
+
+template<typename TSeq>
+inline void Entity<TSeq>::set_state(
+    epiworld_fast_int init,
+    epiworld_fast_int end
+)
+{
+    state_init = init;
+    state_post = end;
+}
+
+template<typename TSeq>
+inline void Entity<TSeq>::set_queue(
+    epiworld_fast_int init,
+    epiworld_fast_int end
+)
+{
+    queue_init = init;
+    queue_post = end;
+}
+
+template<typename TSeq>
+inline void Entity<TSeq>::get_state(
+    epiworld_fast_int * init,
+    epiworld_fast_int * post
+)
+{
+    if (init != nullptr)
+        *init = state_init;
+
+    if (post != nullptr)
+        *post = state_post;
+
+}
+
+template<typename TSeq>
+inline void Entity<TSeq>::get_queue(
+    epiworld_fast_int * init,
+    epiworld_fast_int * post
+)
+{
+    if (init != nullptr)
+        *init = queue_init;
+
+    if (post != nullptr)
+        *post = queue_post;
+
+}
+
+template<typename TSeq>
+inline void Entity<TSeq>::reset()
+{
+
+    this->agents.clear();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline bool Entity<TSeq>::operator==(const Entity<TSeq> & other) const
+{
+
+    if (id != other.id)
+        return false;
+
+    if (agents.size() != other.agents.size())
+        return false;
+
+    for (size_t i = 0u; i < agents.size(); ++i)
+    {
+        if (agents[i] != other.agents[i])
+            return false;
+    }
+
+
+    if (max_capacity != other.max_capacity)
+        return false;
+
+    if (entity_name != other.entity_name)
+        return false;
+
+    if (location.size() != other.location.size())
+        return false;
+
+    for (size_t i = 0u; i < location.size(); ++i)
+    {
+
+        if (location[i] != other.location[i])
+            return false;
+
+    }
+
+    if (state_init != other.state_init)
+        return false;
+
+    if (state_post != other.state_post)
+        return false;
+
+    if (queue_init != other.queue_init)
+        return false;
+
+    if (queue_post != other.queue_post)
+        return false;
+
+    return true;
+
+}
+
+template<typename TSeq>
+inline void Entity<TSeq>::distribute(Model<TSeq> * model)
+{
+
+    if (dist_fun)
+    {
+
+        dist_fun(*this, model);
+
+    }
+
+}
+
+template<typename TSeq>
+inline const std::vector< epiworld_agent_index > & Entity<TSeq>::get_agents() const
+{
+    return agents;
+}
+
+template<typename TSeq>
+inline const std::vector< epiworld_agent_index > & Entity<TSeq>::get_agents_ids() const
+{
+    return agents;
+}
+
+template<typename TSeq>
+inline void Entity<TSeq>::print() const
+{
+
+    printf_epiworld(
+        "Entity '%s' (id %i) with %i agents.\n",
+        this->entity_name.c_str(),
+        static_cast<int>(id),
+        static_cast<int>(agents.size())
+    );
+}
+
+template<typename TSeq>
+inline void Entity<TSeq>::set_distribution(EntityToAgentFun<TSeq> fun)
+{
+    dist_fun = fun;
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/entity-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+    
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/agent-meat-virus-sampling.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_AGENT_MEAT_VIRUS_SAMPLING
+#define EPIWORLD_AGENT_MEAT_VIRUS_SAMPLING
+
+/**
+ * @brief Functions for sampling viruses
+ * 
+ */
+namespace sampler {
+
+/**
+ * @brief Make a function to sample from neighbors
+ * 
+ * This is akin to the function default_update_susceptible, with the difference
+ * that it will create a function that supports excluding states from the sampling
+ * frame. For example, individuals who have acquired a virus can be excluded if
+ * in incubation state.
+ * 
+ * @tparam TSeq 
+ * @param exclude unsigned vector of states that need to be excluded from the sampling
+ * @return Virus<TSeq>* of the selected virus. If none selected (or none
+ * available,) returns a nullptr;
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline std::function<void(Agent<TSeq>*,Model<TSeq>*)> make_update_susceptible(
+    std::vector< epiworld_fast_uint > exclude = {}
+    )
+{
+  
+
+    if (exclude.size() == 0u)
+    {
+
+        std::function<void(Agent<TSeq>*,Model<TSeq>*)> sampler =
+            [](Agent<TSeq> * p, Model<TSeq> * m) -> void
+            {
+
+                if (p->get_virus() != nullptr)
+                    throw std::logic_error(
+                        std::string("Using the -default_update_susceptible- on agents WITH viruses makes no sense! ") +
+                        std::string("Agent id ") + std::to_string(p->get_id()) +
+                        std::string(" has a virus.")
+                        );
+
+                // This computes the prob of getting any neighbor variant
+                size_t nviruses_tmp = 0u;
+                for (auto & neighbor: p->neighbors(*m)) 
+                {
+                    
+                    auto & v = neighbor.get_virus();
+                    if (v == nullptr)
+                        continue;
+                    
+                    /* And it is a function of susceptibility_reduction as well */ 
+                    m->array_double_tmp[nviruses_tmp] =
+                        (1.0 - p->get_susceptibility_reduction(v, *m)) * 
+                        v->get_prob_infecting(m) * 
+                        (1.0 - neighbor.get_transmission_reduction(v, *m)) 
+                        ; 
+                
+                    m->array_virus_tmp[nviruses_tmp++] = &(*v);
+                        
+                }
+
+                // No virus to compute
+                if (nviruses_tmp == 0u)
+                    return;
+
+                // Running the roulette
+                int which = roulette(nviruses_tmp, m);
+
+                if (which < 0)
+                    return;
+
+                p->set_virus(*m, *m->array_virus_tmp[which]);
+
+                return; 
+            };
+
+        return sampler;
+
+    } else {
+
+        // Making room for the query
+        std::shared_ptr<std::vector<bool>> exclude_agent_bool =
+            std::make_shared<std::vector<bool>>(0);
+
+        std::shared_ptr<std::vector<epiworld_fast_uint>> exclude_agent_bool_idx =
+            std::make_shared<std::vector<epiworld_fast_uint>>(exclude);
+
+        std::function<void(Agent<TSeq>*,Model<TSeq>*)> sampler =
+            [exclude_agent_bool,exclude_agent_bool_idx](Agent<TSeq> * p, Model<TSeq> * m) -> void
+            {
+
+                // The first time we call it, we need to initialize the vector
+                if (exclude_agent_bool->size() == 0u)
+                {
+
+                    exclude_agent_bool->resize(m->get_states().size(), false);
+                    for (auto s : *exclude_agent_bool_idx)
+                    {
+                        if (s >= exclude_agent_bool->size())
+                            throw std::logic_error(
+                                std::string("You are trying to exclude a state that is out of range: ") +
+                                std::to_string(s) + std::string(". There are only ") +
+                                std::to_string(exclude_agent_bool->size()) + 
+                                std::string(" states in the model.")
+                                );
+
+                        exclude_agent_bool->operator[](s) = true;
+
+                    }
+
+                }                    
+
+                if (p->get_virus() != nullptr)
+                    throw std::logic_error(
+                        std::string("Using the -default_update_susceptible- on agents WITH viruses makes no sense! ") +
+                        std::string("Agent id ") + std::to_string(p->get_id()) +
+                        std::string(" has a virus.")
+                        );
+
+                // This computes the prob of getting any neighbor variant
+                size_t nviruses_tmp = 0u;
+                for (auto & neighbor: p->neighbors(*m)) 
+                {
+
+                    // If the state is in the list, exclude it
+                    if (exclude_agent_bool->operator[](neighbor.get_state()))
+                        continue;
+
+                    auto & v = neighbor.get_virus();
+                    if (v == nullptr)
+                        continue;
+                            
+                
+                    /* And it is a function of susceptibility_reduction as well */ 
+                    m->array_double_tmp[nviruses_tmp] =
+                        (1.0 - p->get_susceptibility_reduction(v, *m)) * 
+                        v->get_prob_infecting(m) * 
+                        (1.0 - neighbor.get_transmission_reduction(v, *m)) 
+                        ; 
+                
+                    m->array_virus_tmp[nviruses_tmp++] = &(*v);
+                    
+                }
+
+                // No virus to compute
+                if (nviruses_tmp == 0u)
+                    return;
+
+                // Running the roulette
+                int which = roulette(nviruses_tmp, m);
+
+                if (which < 0)
+                    return;
+
+                p->set_virus(*m, *m->array_virus_tmp[which]); 
+
+                return;
+
+            };
+
+        return sampler;
+
+    }
+    
+}
+
+/**
+ * @brief Make a function to sample from neighbors
+ * 
+ * This is akin to the function default_update_susceptible, with the difference
+ * that it will create a function that supports excluding states from the sampling
+ * frame. For example, individuals who have acquired a virus can be excluded if
+ * in incubation state.
+ * 
+ * @tparam TSeq 
+ * @param exclude unsigned vector of states that need to be excluded from the sampling
+ * @return Virus<TSeq>* of the selected virus. If none selected (or none
+ * available,) returns a nullptr;
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline std::function<Virus<TSeq>*(Agent<TSeq>*,Model<TSeq>*)> make_sample_virus_neighbors(
+    std::vector< epiworld_fast_uint > exclude = {}
+)
+{
+    if (exclude.size() == 0u)
+    {
+
+        std::function<Virus<TSeq>*(Agent<TSeq>*,Model<TSeq>*)> res = 
+            [](Agent<TSeq> * p, Model<TSeq> * m) -> Virus<TSeq>* {
+
+                if (p->get_virus() != nullptr)
+                    throw std::logic_error(
+                        std::string("Using the -default_update_susceptible- on agents WITH viruses makes no sense! ") +
+                        std::string("Agent id ") + std::to_string(p->get_id()) +
+                        std::string(" has a virus.")
+                        );
+
+                // This computes the prob of getting any neighbor variant
+                size_t nviruses_tmp = 0u;
+                for (auto & neighbor: p->neighbors(*m)) 
+                {
+                    
+                    if (neighbor.get_virus() == nullptr)
+                        continue;
+
+                    auto & v = neighbor.get_virus();
+
+                    #ifdef EPI_DEBUG
+                    if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+                        throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
+                    #endif
+                        
+                    /* And it is a function of susceptibility_reduction as well */ 
+                    m->array_double_tmp[nviruses_tmp] =
+                        (1.0 - p->get_susceptibility_reduction(v, *m)) * 
+                        v->get_prob_infecting(m) * 
+                        (1.0 - neighbor.get_transmission_reduction(v, *m)) 
+                        ; 
+                
+                    m->array_virus_tmp[nviruses_tmp++] = &(*v);
+                    
+                }
+
+                // No virus to compute
+                if (nviruses_tmp == 0u)
+                    return nullptr;
+
+                // Running the roulette
+                int which = roulette(nviruses_tmp, m);
+
+                if (which < 0)
+                    return nullptr;
+
+                return m->array_virus_tmp[which]; 
+
+            };
+
+        return res;
+
+
+    } else {
+
+        // Making room for the query
+        std::shared_ptr<std::vector<bool>> exclude_agent_bool =
+            std::make_shared<std::vector<bool>>(0);
+
+        std::shared_ptr<std::vector<epiworld_fast_uint>> exclude_agent_bool_idx =
+            std::make_shared<std::vector<epiworld_fast_uint>>(exclude);
+
+
+        std::function<Virus<TSeq>*(Agent<TSeq>*,Model<TSeq>*)> res = 
+            [exclude_agent_bool,exclude_agent_bool_idx](Agent<TSeq> * p, Model<TSeq> * m) -> Virus<TSeq>* {
+
+                // The first time we call it, we need to initialize the vector
+                if (exclude_agent_bool->size() == 0u)
+                {
+
+                    exclude_agent_bool->resize(m->get_states().size(), false);
+                    for (auto s : *exclude_agent_bool_idx)
+                    {
+                        if (s >= exclude_agent_bool->size())
+                            throw std::logic_error(
+                                std::string("You are trying to exclude a state that is out of range: ") +
+                                std::to_string(s) + std::string(". There are only ") +
+                                std::to_string(exclude_agent_bool->size()) + 
+                                std::string(" states in the model.")
+                                );
+
+                        exclude_agent_bool->operator[](s) = true;
+
+                    }
+
+                }    
+                
+                if (p->get_virus() != nullptr)
+                    throw std::logic_error(
+                        std::string("Using the -default_update_susceptible- on agents WITH viruses makes no sense! ") +
+                        std::string("Agent id ") + std::to_string(p->get_id()) +
+                        std::string(" has a virus.")
+                        );
+
+                // This computes the prob of getting any neighbor variant
+                size_t nviruses_tmp = 0u;
+                for (auto & neighbor: p->neighbors(*m)) 
+                {
+
+                    // If the state is in the list, exclude it
+                    if (exclude_agent_bool->operator[](neighbor.get_state()))
+                        continue;
+
+                    if (neighbor.get_virus() == nullptr)
+                        continue;
+
+                    auto & v = neighbor.get_virus();
+                            
+                    #ifdef EPI_DEBUG
+                    if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+                        throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
+                    #endif
+                        
+                    /* And it is a function of susceptibility_reduction as well */ 
+                    m->array_double_tmp[nviruses_tmp] =
+                        (1.0 - p->get_susceptibility_reduction(v, *m)) * 
+                        v->get_prob_infecting(m) * 
+                        (1.0 - neighbor.get_transmission_reduction(v, *m)) 
+                        ; 
+                
+                    m->array_virus_tmp[nviruses_tmp++] = &(*v);
+                    
+                }
+
+                // No virus to compute
+                if (nviruses_tmp == 0u)
+                    return nullptr;
+
+                // Running the roulette
+                int which = roulette(nviruses_tmp, m);
+
+                if (which < 0)
+                    return nullptr;
+
+                return m->array_virus_tmp[which]; 
+
+            };
+
+        return res;
+
+    }
+
+}
+
+/**
+ * @brief Sample from neighbors pool of viruses (at most one)
+ * 
+ * This function samples at most one virus from the pool of
+ * viruses from its neighbors. If no virus is selected, the function
+ * returns a `nullptr`, otherwise it returns a pointer to the
+ * selected virus.
+ * 
+ * This can be used to build a new update function (EPI_NEW_UPDATEFUN.)
+ * 
+ * @tparam TSeq 
+ * @param p Pointer to person 
+ * @param m Pointer to the model
+ * @return Virus<TSeq>* of the selected virus. If none selected (or none
+ * available,) returns a nullptr;
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline Virus<TSeq> * sample_virus_single(Agent<TSeq> * p, Model<TSeq> * m)
+{
+
+    if (p->get_virus() != nullptr)
+        throw std::logic_error(
+            std::string("Using the -default_update_susceptible- on agents WITH viruses makes no sense!") +
+            std::string("Agent id ") + std::to_string(p->get_id()) +
+            std::string(" has a virus.")
+            );
+
+    // This computes the prob of getting any neighbor variant
+    size_t nviruses_tmp = 0u;
+    for (auto & neighbor: p->neighbors(*m)) 
+    {   
+        #ifdef EPI_DEBUG
+        int _vcount_neigh = 0;
+        #endif                
+
+        if (neighbor.get_virus() == nullptr)
+            continue;
+
+        auto & v = neighbor.get_virus();
+
+        #ifdef EPI_DEBUG
+        if (nviruses_tmp >= m->array_virus_tmp.size())
+            throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
+        #endif
+            
+        /* And it is a function of susceptibility_reduction as well */ 
+        m->array_double_tmp[nviruses_tmp] =
+            (1.0 - p->get_susceptibility_reduction(v, *m)) * 
+            v->get_prob_infecting(m) * 
+            (1.0 - neighbor.get_transmission_reduction(v, *m)) 
+            ; 
+    
+        m->array_virus_tmp[nviruses_tmp++] = &(*v);
+
+        #ifdef EPI_DEBUG
+        if (
+            (m->array_double_tmp[nviruses_tmp - 1] < 0.0) |
+            (m->array_double_tmp[nviruses_tmp - 1] > 1.0)
+            )
+        {
+            printf_epiworld(
+                "[epi-debug] Agent %i's virus %i has transmission prob outside of [0, 1]: %.4f!\n",
+                static_cast<int>(neighbor.get_id()),
+                static_cast<int>(_vcount_neigh++),
+                m->array_double_tmp[nviruses_tmp - 1]
+                );
+        }
+        #endif
+            
+    }
+
+
+    // No virus to compute
+    if (nviruses_tmp == 0u)
+        return nullptr;
+
+    #ifdef EPI_DEBUG
+    #pragma omp atomic
+    m->get_db().n_transmissions_potential++;
+    #endif
+
+    // Running the roulette
+    int which = roulette(nviruses_tmp, m);
+
+    if (which < 0)
+        return nullptr;
+
+    #ifdef EPI_DEBUG
+    #pragma omp atomic
+    m->get_db().n_transmissions_today++;
+    #endif
+
+    return m->array_virus_tmp[which]; 
+    
+}
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/agent-meat-virus-sampling.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/agent-meat-state.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_PERSON_MEAT_STATE_HPP
+#define EPIWORLD_PERSON_MEAT_STATE_HPP
+
+// (already included include/epiworld/model-bones.hpp)
+// (already included include/epiworld/agent-meat-virus-sampling.hpp)
+// (already included include/epiworld/config.hpp)
+
+/**
+ * @file agent-meat-state.hpp
+ * @author George G. Vega Yon (g.vegayon en gmail)
+ * @brief Sampling functions are getting big, so we keep them in a separate file.
+ * @version 0.1
+ * @date 2022-06-15
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline void default_update_susceptible(
+    Agent<TSeq> * p,
+    Model<TSeq> * m
+    )
+{
+
+    Virus<TSeq> * virus = sampler::sample_virus_single<TSeq>(p, m);
+    
+    if (virus == nullptr)
+        return;
+
+    p->set_virus(*m, *virus);
+
+    return;
+
+}
+
+/**
+ * @brief Factory function to create a state update function based on
+ * transition rates.
+ *
+ * @details
+ * This function creates an `UpdateFun` that transitions agents between
+ * states using named model parameters as per-step transition probabilities.
+ * At each time step the generated function reads the current values of the
+ * parameters from the model and uses the roulette sampling algorithm to
+ * decide whether a transition occurs (and if so, to which target state).
+ *
+ * The parameter names must correspond to parameters that have already been
+ * added to the model (via `Model::add_param()`). The target states are
+ * specified as integer state codes (the indices returned by
+ * `Model::add_state()`).
+ *
+ * @tparam TSeq Type of the sequence (default `EPI_DEFAULT_TSEQ`).
+ * @param param_names  Names of the model parameters that hold the
+ *                     transition rates. The i-th name gives the rate for
+ *                     transitioning to the i-th target state.
+ * @param target_states Integer codes of the destination states, in the
+ *                      same order as `param_names`.
+ * @return An `UpdateFun<TSeq>` suitable for use with
+ *         `Model::add_state()`.
+ *
+ * @throws std::logic_error if `param_names` and `target_states` differ in
+ *         size, or if either is empty.
+ *
+ * ### Example: SEIRD model
+ *
+ * @code{.cpp}
+ * // E -> I transition
+ * auto update_exposed = new_state_update_transition<int>(
+ *     {"E->I transition rate"},
+ *     {2}  // state code for Infected
+ * );
+ *
+ * // I -> R or I -> D transitions
+ * auto update_infected = new_state_update_transition<int>(
+ *     {"I->R transition rate", "I->D transition rate"},
+ *     {3, 4}  // state codes for Recovered and Deceased
+ * );
+ *
+ * model.add_state("Susceptible", default_update_susceptible<int>);
+ * model.add_state("Exposed",     update_exposed);
+ * model.add_state("Infected",    update_infected);
+ * model.add_state("Recovered");
+ * model.add_state("Deceased");
+ * @endcode
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline UpdateFun<TSeq> new_state_update_transition(
+    std::vector< std::string > param_names,
+    std::vector< epiworld_fast_uint > target_states
+)
+{
+
+    if (param_names.size() != target_states.size())
+        throw std::logic_error(
+            "The number of parameter names (" +
+            std::to_string(param_names.size()) +
+            ") and target states (" +
+            std::to_string(target_states.size()) +
+            ") must match."
+        );
+
+    if (param_names.empty())
+        throw std::logic_error(
+            "At least one transition must be specified."
+        );
+
+    return [param_names, target_states](
+        Agent<TSeq> * p,
+        Model<TSeq> * m
+    ) -> void {
+
+        size_t n = param_names.size();
+        int which;
+
+        if (n <= 1024u)
+        {
+            for (size_t i = 0u; i < n; ++i)
+                m->array_double_tmp[i] = m->par(param_names[i]);
+
+            // Roulette sampling: returns -1 if no transition occurs,
+            // otherwise the index of the transition that fires.
+            which = roulette(static_cast<epiworld_fast_uint>(n), m);
+        }
+        else
+        {
+            std::vector< epiworld_double > probs(n);
+            for (size_t i = 0u; i < n; ++i)
+                probs[i] = m->par(param_names[i]);
+
+            // Fallback for transition tables larger than the temporary buffer.
+            which = roulette(probs, m);
+        }
+        if (which < 0)
+            return;
+
+        p->change_state(*m, target_states[which]);
+
+        return;
+
+    };
+
+}
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline void default_update_exposed(Agent<TSeq> * p, Model<TSeq> * m) {
+
+    if (p->get_virus() == nullptr)
+        throw std::logic_error(
+            std::string("Using the -default_update_exposed- on agents WITHOUT viruses makes no sense! ") +
+            std::string("Agent id ") + std::to_string(p->get_id()) + std::string(" has no virus registered.")
+            );
+
+    // Die
+    auto & virus = p->get_virus();
+    m->array_double_tmp[0u] = 
+        virus->get_prob_death(m) * (1.0 - p->get_death_reduction(virus, *m));
+
+    // Recover
+    m->array_double_tmp[1u] =
+        1.0 - (1.0 - virus->get_prob_recovery(m)) * (1.0 - p->get_recovery_enhancer(virus, *m)); 
+    
+
+    // Running the roulette
+    int which = roulette(2u, m);
+
+    if (which < 0)
+        return;
+
+    // Which roulette happen?
+    if (which == 0u) // If odd
+    {
+
+        int rm_state = -1;
+        p->get_virus()->get_state(nullptr, nullptr, &rm_state);
+        p->rm_virus(*m, rm_state);
+        
+    } else {
+
+        p->rm_virus(*m);
+
+    }
+
+    return ;
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/agent-meat-state.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+// (already included ./include/epiworld/agent-bones.hpp)
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/agent-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_PERSON_MEAT_HPP
+#define EPIWORLD_PERSON_MEAT_HPP
+
+#include <vector>
+#include <string>
+#include <typeinfo>
+// (already included include/epiworld/config.hpp)
+// (already included include/epiworld/epiworld-macros.hpp)
+// (already included include/epiworld/agent-bones.hpp)
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/agent-events-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_AGENT_EVENTS_MEAT_HPP
+#define EPIWORLD_AGENT_EVENTS_MEAT_HPP
+
+template<typename TSeq>
+inline void Model<TSeq>::_event_add_virus(Event<TSeq> & a)
+{
+
+    Agent<TSeq> *  p = a.agent;
+    VirusPtr<TSeq> & v = a.virus;
+    
+    db.record_transmission(
+        v->get_agent() ? v->get_agent()->get_id() : -1,
+        p->get_id(),
+        v->get_id(),
+        v->get_date() 
+    );
+    
+    p->virus = std::move(v);
+    p->virus->set_date(today());
+    p->virus->set_agent(p);
+
+    // Change of state needs to be recorded and updated on the
+    // tools.
+    if ((a.new_state != -99) && (static_cast<int>(p->state) != a.new_state))
+    {
+        db.update_state(p->state_prev, a.new_state);
+
+        // For tool counts, use current state (p->state) not state_prev
+        // because state_prev may be stale if multiple changes occurred today
+        for (size_t i = 0u; i < p->tools.size(); ++i)
+            db.update_tool(
+                p->tools[i]->get_id(),
+                p->state,
+                a.new_state
+            );
+    }
+
+    // Lastly, we increase the daily count of the virus
+    #ifdef EPI_DEBUG
+    db.today_virus.at(p->virus->get_id()).at(
+        a.new_state != -99 ? a.new_state : p->state
+    )++;
+    #else
+    db.today_virus[p->virus->get_id()][
+        a.new_state != -99 ? a.new_state : p->state
+    ]++;
+    #endif
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::_event_add_tool(Event<TSeq> & a)
+{
+
+    Agent<TSeq> * p = a.agent;
+    ToolPtr<TSeq> & t = a.tool;
+    
+    // Update tool accounting
+    p->tools.emplace_back(std::move(t));
+    size_t tool_pos = p->tools.size() - 1u;
+
+    p->tools[tool_pos]->set_date(today());
+    p->tools[tool_pos]->set_agent(p, tool_pos);
+    p->tools_effects_update();
+
+    // Change of state needs to be recorded and updated on the
+    // tools.
+    if ((a.new_state != -99) && static_cast<int>(p->state) != a.new_state)
+    {
+        db.update_state(p->state_prev, a.new_state);
+
+        // For virus counts, use current state (p->state) not state_prev
+        // because state_prev may be stale if multiple changes occurred today
+        if (p->virus)
+            db.update_virus(
+                p->virus->get_id(),
+                p->state,
+                a.new_state
+            );
+    }
+
+    db.today_tool[p->tools[tool_pos]->get_id()][
+        a.new_state != -99 ? a.new_state : p->state
+    ]++;
+
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::_event_rm_virus(Event<TSeq> & a)
+{
+
+    Agent<TSeq> * p    = a.agent;
+    VirusPtr<TSeq> & v = a.virus;
+
+    // Calling the virus action over the removed virus
+    v->post_recovery(this);
+
+    p->virus = nullptr;
+
+    // Change of state needs to be recorded and updated on the
+    // tools.
+    if ((a.new_state != -99) && (static_cast<int>(p->state) != a.new_state))
+    {
+        db.update_state(p->state_prev, a.new_state);
+
+        // For tool counts, use current state (p->state) not state_prev
+        // because state_prev may be stale if multiple changes occurred today
+        for (size_t i = 0u; i < p->tools.size(); ++i)
+            db.update_tool(
+                p->tools[i]->get_id(),
+                p->state,
+                a.new_state
+            );
+    }
+
+    // The counter of the removed virus must be decremented from the
+    // agent's current state (pre-transition), not state_prev.
+    // state_prev may refer to an earlier same-day state.
+    #ifdef EPI_DEBUG
+    db.today_virus.at(v->get_id()).at(p->state)--;
+    #else
+    db.today_virus[v->get_id()][p->state]--;
+    #endif
+
+    
+    return;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::_event_rm_tool(Event<TSeq> & a)
+{
+
+    Agent<TSeq> * p = a.agent;
+    ToolPtr<TSeq> & t = a.tool;
+    bool removed = false;
+
+    if (t)
+    {
+        // Remove tool(s) by id, following an erase/remove approach.
+        auto new_end = std::remove_if(
+            p->tools.begin(),
+            p->tools.end(),
+            [&t](const ToolPtr<TSeq> & tool_ptr) -> bool
+            {
+                return tool_ptr && (tool_ptr->get_id() == t->get_id());
+            }
+        );
+
+        removed = (new_end != p->tools.end());
+        p->tools.erase(new_end, p->tools.end());
+
+        for (size_t i = 0u; i < p->tools.size(); ++i)
+            p->tools[i]->pos_in_agent = static_cast<int>(i);
+
+        p->tools_effects_update();
+    }
+
+    // Change of state needs to be recorded and updated on the
+    // tools.
+    if ((a.new_state != -99) && (static_cast<int>(p->state) != a.new_state))
+    {
+        db.update_state(p->state_prev, a.new_state);
+
+        // For virus counts, use current state (p->state) not state_prev
+        // because state_prev may be stale if multiple changes occurred today
+        if (p->virus)
+            db.update_virus(
+                p->virus->get_id(),
+                p->state,
+                a.new_state
+            );
+    }
+
+    // Like rm_virus, remove the tool count from the agent's current
+    // state (pre-transition). Using state_prev can underflow when
+    // the agent changed state earlier in the day.
+    if (removed)
+    {
+        #ifdef EPI_DEBUG
+        db.today_tool.at(t->get_id()).at(p->state)--;
+        #else
+        db.today_tool[t->get_id()][p->state]--;
+        #endif
+
+        t->agent = nullptr;
+        t->pos_in_agent = -99;
+    }
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::_event_change_state(Event<TSeq> & a)
+{
+
+    Agent<TSeq> * p = a.agent;
+
+    if ((a.new_state != -99) && (static_cast<int>(p->state) != a.new_state))
+    {
+        db.update_state(p->state_prev, a.new_state);
+
+        // For virus and tool counts, use current state (p->state) not state_prev
+        // because state_prev may be stale if multiple changes occurred today
+        if (p->virus)
+            db.update_virus(
+                p->virus->get_id(), p->state, a.new_state
+            );
+
+        for (size_t i = 0u; i < p->tools.size(); ++i)
+            db.update_tool(
+                p->tools[i]->get_id(),
+                p->state,
+                a.new_state
+            );
+
+    }
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::_event_add_entity(Event<TSeq> & a)
+{
+
+    Agent<TSeq> *  p = a.agent;
+    Entity<TSeq> * e = a.entity;
+
+    // Checking the agent and the entity are not linked
+    if ((p->get_n_entities() > 0) && (e->size() > 0))
+    {
+
+        if (p->get_n_entities() > e->size()) // Slower search through the agent
+        {
+            for (size_t agent_id : e->get_agents())
+                if(static_cast<int>(agent_id) == p->get_id())
+                    throw std::logic_error("An entity cannot be reassigned to an agent.");
+        }
+        else                                 // Slower search through the entity
+        {
+            for (size_t entity_id : p->get_entities())
+                if(static_cast<int>(entity_id) == e->get_id())
+                    throw std::logic_error("An entity cannot be reassigned to an agent.");
+        }
+
+        // It means that agent and entity were not associated.
+    }
+
+    // Adding the to agent and the entity
+    p->entities.push_back(static_cast<epiworld_agent_index>(e->get_id()));
+    e->agents.push_back(static_cast<epiworld_agent_index>(p->get_id()));
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::_event_rm_entity(Event<TSeq> & a)
+{
+
+    Agent<TSeq> &  p = *a.agent;
+    Entity<TSeq> & e = *a.entity;
+
+    // Remove entity from agent's entity list
+    p.entities.erase(
+        std::remove(
+            p.entities.begin(),
+            p.entities.end(),
+            static_cast<epiworld_agent_index>(e.get_id())
+        ),
+        p.entities.end()
+    );
+
+    // Remove agent from entity's agent list
+    e.agents.erase(
+        std::remove(
+            e.agents.begin(),
+            e.agents.end(),
+            static_cast<epiworld_agent_index>(p.get_id())
+        ),
+        e.agents.end()
+    );
+
+    return;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/agent-events-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+template<typename TSeq>
+inline Agent<TSeq>::Agent(Agent<TSeq> && p) :
+    n_neighbors(p.n_neighbors),
+    entities(std::move(p.entities)),
+    state(p.state),
+    state_prev(p.state_prev), 
+    state_last_changed(p.state_last_changed),
+    id(p.id),
+    tools(std::move(p.tools)) /// Needs to be adjusted
+{
+
+    std::copy(
+        std::begin(p.tools_effects), std::end(p.tools_effects),
+        std::begin(tools_effects)
+    );
+    tools_effects_fixed = p.tools_effects_fixed;
+
+    state = p.state;
+    id     = p.id;
+    
+    // Dealing with the virus
+    if (p.virus != nullptr)
+    {
+        virus = std::move(p.virus);
+        virus->set_agent(this);
+    }
+
+    int loc = 0;
+    for (auto & t : tools)
+    {
+        
+        // Will create a copy of the virus, with the exeption of
+        // the virus code
+        t->agent     = this;
+        t->pos_in_agent = loc++;
+
+    }
+    
+}
+
+// Copy constructor
+template<typename TSeq>
+inline Agent<TSeq>::Agent(const Agent<TSeq> & p) :
+    n_neighbors(p.n_neighbors),
+    entities(p.entities)
+{
+
+    state = p.state;
+    id     = p.id;
+    
+    // Dealing with the virus
+    if (p.virus != nullptr)
+    {
+        virus = std::shared_ptr<Virus<TSeq>>(p.virus->clone_ptr());
+        virus->set_agent(this);
+    }
+    
+
+    tools.clear();
+    tools.reserve(p.get_n_tools());
+    for (size_t i = 0u; i < p.get_n_tools(); ++i)
+    {
+        tools.emplace_back(std::shared_ptr<Tool<TSeq>>(p.tools[i]->clone_ptr()));
+        tools.back()->set_agent(this, i);
+
+    }
+
+    tools_effects_update();
+    
+}
+
+template<typename TSeq>
+inline Agent<TSeq> & Agent<TSeq>::operator=(
+    const Agent<TSeq> & other_agent
+)
+{
+
+    n_neighbors = other_agent.n_neighbors;
+    
+    entities = other_agent.entities;
+
+    state              = other_agent.state;
+    state_prev         = other_agent.state_prev;
+    state_last_changed = other_agent.state_last_changed;
+    id                  = other_agent.id;
+    
+    if (other_agent.virus != nullptr)
+    {
+        virus = std::shared_ptr<Virus<TSeq>>(other_agent.virus->clone_ptr());
+        virus->set_agent(this);
+    } else
+        virus = nullptr;
+    
+    
+    tools.clear();
+    tools.reserve(other_agent.get_n_tools());
+    for (size_t i = 0u; i < other_agent.get_n_tools(); ++i)
+    {
+        tools.emplace_back(std::shared_ptr<Tool<TSeq>>(other_agent.tools[i]->clone_ptr()));
+        tools.back()->set_agent(this, i);
+    }
+
+    tools_effects_update();
+    
+    return *this;
+    
+}
+
+template<typename TSeq>
+inline Agent<TSeq>::~Agent()
+{
+
+}
+
+template<typename TSeq>
+inline void Agent<TSeq>::add_tool(
+    Model<TSeq> & model,
+    const Tool<TSeq> & tool,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+) {
+
+    // Checking the tool exists
+    if (tool.get_id() >= static_cast<int>(model.get_db().get_n_tools()))
+        throw std::range_error("The tool with id: " + std::to_string(tool.get_id()) +
+            " has not been registered. There are only " + std::to_string(model.get_n_tools()) +
+            " included in the model.");
+
+    ToolPtr<TSeq> tool_ptr = std::shared_ptr<Tool<TSeq>>(tool.clone_ptr());
+
+    model._add_event(
+        this, nullptr, tool_ptr, nullptr, state_new, queue, EventAction::AddTool
+        );
+
+}
+
+template<typename TSeq>
+inline void Agent<TSeq>::set_virus(
+    Model<TSeq> & model,
+    const Virus<TSeq> & virus,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+)
+{
+    
+        // Checking the virus exists
+    if (virus.get_id() >= static_cast<int>(model.get_db().get_n_viruses()))
+        throw std::range_error("The virus with id: " + std::to_string(virus.get_id()) +
+            " has not been registered. There are only " + std::to_string(model.get_n_viruses()) +
+            " included in the model.");
+
+    if (state_new == -99)
+        virus.get_state(&state_new, nullptr, nullptr);
+
+    if (queue == -99)
+        virus.get_queue(&queue, nullptr, nullptr);
+
+    VirusPtr<TSeq> virus_ptr = std::shared_ptr<Virus<TSeq>>(virus.clone_ptr());
+
+    model._add_event(
+        this, virus_ptr, nullptr, nullptr, state_new, queue, EventAction::AddVirus
+        );
+
+}
+
+template<typename TSeq>
+inline void Agent<TSeq>::add_entity(
+    Model<TSeq> & model,
+    Entity<TSeq> & entity,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+)
+{
+
+    model._add_event(
+        this, nullptr, nullptr, &entity, state_new, queue, EventAction::AddEntity
+    );
+
+}
+
+template<typename TSeq>
+inline void Agent<TSeq>::rm_tool(
+    Model<TSeq> & model,
+    epiworld_fast_uint tool_idx,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+)
+{
+
+    if (tool_idx >= tools.size())
+        throw std::range_error(
+            "The Tool you want to remove is out of range. This Agent only has " +
+            std::to_string(tools.size()) + " tools."
+        );
+
+    model._add_event(
+        this, nullptr, tools[tool_idx], nullptr, state_new, queue, EventAction::RemoveTool
+        );
+
+}
+
+template<typename TSeq>
+inline void Agent<TSeq>::rm_tool(
+    Model<TSeq> & model,
+    ToolPtr<TSeq> & tool,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+)
+{
+
+    if (tool->agent != this)
+        throw std::logic_error("Cannot remove a virus from another agent!");
+
+    model._add_event(
+        this, nullptr, tool, nullptr, state_new, queue, EventAction::RemoveTool
+        );
+
+}
+
+template<typename TSeq>
+inline void Agent<TSeq>::rm_virus(
+    Model<TSeq> & model,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+)
+{
+
+    if (virus == nullptr)
+        throw std::logic_error(
+            "There is no virus to remove here!"
+        );
+
+    if (state_new == -99)
+        virus->get_state(nullptr, &state_new, nullptr);
+
+    if (queue == -99)
+        virus->get_queue(nullptr, &queue, nullptr);
+
+    model._add_event(
+        this, virus, nullptr, nullptr,
+        state_new,
+        queue,
+        EventAction::RemoveVirus
+        );
+
+}
+
+template<typename TSeq>
+inline void Agent<TSeq>::rm_entity(
+    Model<TSeq> & model,
+    epiworld_fast_uint entity_idx,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+)
+{
+
+    if (entity_idx >= entities.size())
+        throw std::range_error(
+            "The Entity you want to remove is out of range. This Agent only has " +
+            std::to_string(entities.size()) + " entity(ies)."
+        );
+    else if (entities.size() == 0u)
+        throw std::logic_error(
+            "There is no entity to remove here!"
+        );
+
+    model._add_event(
+        this,
+        nullptr,
+        nullptr,
+        &model.get_entity(entities[entity_idx]),
+        state_new,
+        queue,
+        EventAction::RemoveEntity
+    );
+}
+
+template<typename TSeq>
+inline void Agent<TSeq>::rm_entity(
+    Model<TSeq> & model,
+    Entity<TSeq> & entity,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+)
+{
+
+    // Looking for entity location in the agent
+    bool found = std::find(
+        entities.begin(), entities.end(),
+        static_cast<size_t>(entity.get_id())
+    ) != entities.end();
+
+    if (!found)
+        throw std::logic_error(
+            std::string("The agent ") +
+            std::to_string(id) +
+            std::string(" is not associated with entity \"") +
+            entity.get_name() +
+            std::string("\".")
+            );
+
+    model._add_event(
+        this,
+        nullptr,
+        nullptr,
+        &model.get_entity(entity.get_id()),
+        state_new,
+        queue,
+        EventAction::RemoveEntity
+    );
+}
+
+template<typename TSeq>
+inline void Agent<TSeq>::tools_effects_update()
+{
+
+    tools_effects_fixed = 0x0Fu;
+    for (auto & e : tools_effects)
+        e = 1.0;
+
+    for (auto & tool : tools)
+    {
+
+        // Derived tools may override the getters, so only plain tools
+        // are trusted to report their constant effects
+        unsigned char mask = (typeid(*tool) == typeid(Tool<TSeq>)) ?
+            tool->def->fixed_mask : 0u;
+
+        tools_effects_fixed &= mask;
+        for (size_t k = 0u; k < 4u; ++k)
+            if (mask & (1u << k))
+                tools_effects[k] *= (1.0 - tool->def->fixed_value[k]);
+
+    }
+
+}
+
+template<typename TSeq>
+inline epiworld_double Agent<TSeq>::get_susceptibility_reduction(
+    VirusPtr<TSeq> & v,
+    Model<TSeq> & model
+) {
+
+    return model.susceptibility_reduction_mixer(this, v);
+}
+
+template<typename TSeq>
+inline epiworld_double Agent<TSeq>::get_transmission_reduction(
+    VirusPtr<TSeq> & v,
+    Model<TSeq> & model
+) {
+    return model.transmission_reduction_mixer(this, v);
+}
+
+template<typename TSeq>
+inline epiworld_double Agent<TSeq>::get_recovery_enhancer(
+    VirusPtr<TSeq> & v,
+    Model<TSeq> & model
+) {
+    return model.recovery_enhancer_mixer(this, v);
+}
+
+template<typename TSeq>
+inline epiworld_double Agent<TSeq>::get_death_reduction(
+    VirusPtr<TSeq> & v,
+    Model<TSeq> & model
+) {
+    return model.death_reduction_mixer(this, v);
+}
+
+template<typename TSeq>
+inline int Agent<TSeq>::get_id() const
+{
+    return id;
+}
+
+template<typename TSeq>
+inline VirusPtr<TSeq> & Agent<TSeq>::get_virus() {
+    return virus;
+}
+
+template<typename TSeq>
+inline const VirusPtr<TSeq> & Agent<TSeq>::get_virus() const {
+    return virus;
+}
+
+
+template<typename TSeq>
+inline std::vector< ToolPtr<TSeq> > Agent<TSeq>::get_tools() {
+    return tools;
+}
+
+template<typename TSeq>
+inline const std::vector< ToolPtr<TSeq> > Agent<TSeq>::get_tools() const {
+    return tools;
+}
+
+template<typename TSeq>
+inline ToolPtr<TSeq> & Agent<TSeq>::get_tool(int i)
+{
+    return tools.at(i);
+}
+
+template<typename TSeq>
+inline ToolPtr<TSeq> & Agent<TSeq>::get_tool(std::string name)
+{
+    for (auto & tool : tools)
+        if (tool->get_name() == name)
+            return tool;
+
+    throw std::logic_error(
+        "The agent does not have a tool with name: " + name
+    );
+
+}
+
+template<typename TSeq>
+inline size_t Agent<TSeq>::get_n_tools() const noexcept
+{
+    return tools.size();
+}
+
+template<typename TSeq>
+inline void Agent<TSeq>::mutate_virus()
+{
+
+    virus->mutate();
+
+}
+
+template<typename TSeq>
+inline void Agent<TSeq>::add_neighbor(
+    Agent<TSeq> & p,
+    Model<TSeq> & model,
+    bool check_source,
+    bool check_target
+) {
+
+    auto & net = model.get_network_mutable();
+    net.add_edge(
+        static_cast< size_t >(id),
+        static_cast< size_t >(p.id),
+        check_source,
+        check_target
+    );
+
+    n_neighbors   = net.degree(id);
+    p.n_neighbors = net.degree(p.id);
+
+}
+
+template<typename TSeq>
+inline void Agent<TSeq>::swap_neighbors(
+    Agent<TSeq> & other,
+    size_t n_this,
+    size_t n_other,
+    Model<TSeq> & model
+)
+{
+
+    if (n_this >= n_neighbors)
+        throw std::range_error(
+            "The neighbor you want to swap is out of range. This Agent only has " +
+            std::to_string(n_neighbors) + " neighbors."
+        );
+    if (n_other >= other.n_neighbors)
+        throw std::range_error(
+            "The neighbor you want to swap is out of range. This Agent only has " +
+            std::to_string(other.n_neighbors) + " neighbors."
+        );
+
+    // Getting the rows of the agents in the network
+    auto & net = model.get_network_mutable();
+    epiworld_agent_index * neighbors       = net.neighbors(id);
+    epiworld_agent_index * other_neighbors = net.neighbors(other.id);
+    epiworld_agent_index * locations       = net.neighbors_locations(id);
+    epiworld_agent_index * other_locations = net.neighbors_locations(other.id);
+
+    size_t neigh_this  = neighbors[n_this];
+    size_t neigh_other = other_neighbors[n_other];
+
+    // Getting the locations in the neighbors
+    size_t loc_this_in_neigh = locations[n_this];
+    size_t loc_other_in_neigh = other_locations[n_other];
+
+    // Changing ids
+    std::swap(neighbors[n_this], other_neighbors[n_other]);
+
+    if (!model.directed)
+    {
+        std::swap(
+            net.neighbors(neigh_this)[loc_this_in_neigh],
+            net.neighbors(neigh_other)[loc_other_in_neigh]
+            );
+
+        // Changing the locations
+        std::swap(locations[n_this], other_locations[n_other]);
+        
+        std::swap(
+            net.neighbors_locations(neigh_this)[loc_this_in_neigh],
+            net.neighbors_locations(neigh_other)[loc_other_in_neigh]
+            );
+    }
+
+}
+
+template<typename TSeq>
+inline std::vector< Agent<TSeq> *> Agent<TSeq>::get_neighbors(Model<TSeq> & model)
+{
+    std::vector< Agent<TSeq> * > res(n_neighbors, nullptr);
+    const epiworld_agent_index * neighbors = model.network->neighbors(id);
+    for (size_t i = 0u; i < n_neighbors; ++i)
+        res[i] = &model.population[neighbors[i]];
+    return res;
+}
+
+template<typename TSeq>
+inline AgentNeighbors<TSeq> Agent<TSeq>::neighbors(Model<TSeq> & model)
+{
+    return AgentNeighbors<TSeq>(
+        model.population.data(),
+        model.network->neighbors(id),
+        n_neighbors
+    );
+}
+
+template<typename TSeq>
+inline size_t Agent<TSeq>::get_n_neighbors() const
+{
+    return n_neighbors;
+}
+
+template<typename TSeq>
+inline void Agent<TSeq>::change_state(
+    Model<TSeq> & model,
+    epiworld_fast_uint new_state,
+    epiworld_fast_int queue
+    )
+{
+
+    model._add_event(
+        this, nullptr, nullptr, nullptr, new_state, queue,
+        EventAction::ChangeState
+    );
+
+    return;
+
+}
+
+template<typename TSeq>
+inline unsigned int Agent<TSeq>::get_state() const {
+    return state;
+}
+
+template<typename TSeq>
+inline unsigned int Agent<TSeq>::get_state_prev() const {
+    return state_prev;
+}
+
+template<typename TSeq>
+inline int Agent<TSeq>::get_state_last_changed() const {
+    return state_last_changed;
+}
+
+template<typename TSeq>
+inline void Agent<TSeq>::reset()
+{
+
+    this->virus = nullptr;
+
+    // Clearing keeps the capacity, so replicates don't reallocate
+    this->tools.clear();
+    this->entities.clear();
+    this->tools_effects_update();
+
+    this->state = 0u;
+    this->state_prev = 0u;
+
+    this->state_last_changed = -1;
+    
+}
+
+template<typename TSeq>
+inline bool Agent<TSeq>::has_tool(epiworld_fast_uint t) const
+{
+
+    for (auto & tool : tools)
+        if (tool->get_id() == static_cast<int>(t))
+            return true;
+
+    return false;
+
+}
+
+template<typename TSeq>
+inline bool Agent<TSeq>::has_tool(std::string_view name) const
+{
+
+    for (auto & tool : tools)
+        if (tool->get_name() == name)
+            return true;
+
+    return false;
+
+}
+
+template<typename TSeq>
+inline bool Agent<TSeq>::has_tool(const Tool<TSeq> & tool) const
+{
+
+    return has_tool(tool.get_id());
+
+}
+
+template<typename TSeq>
+inline bool Agent<TSeq>::has_virus(epiworld_fast_uint t) const
+{
+    if (virus->get_id() == static_cast<int>(t))
+        return true;
+
+    return false;
+}
+
+template<typename TSeq>
+inline bool Agent<TSeq>::has_virus(std::string_view name) const
+{
+    
+    if (virus->get_name() == name)
+        return true;
+
+    return false;
+
+}
+
+template<typename TSeq>
+inline bool Agent<TSeq>::has_virus(const Virus<TSeq> & virus) const
+{
+
+    return has_virus(virus.get_id());
+
+}
+
+template<typename TSeq>
+inline bool Agent<TSeq>::has_entity(epiworld_fast_uint t) const
+{
+
+    for (auto & entity_id : entities)
+        if (entity_id == static_cast<size_t>(t))
+            return true;
+
+    return false;
+
+}
+
+template<typename TSeq>
+inline bool Agent<TSeq>::has_entity(std::string_view name, const Model<TSeq> & model) const
+{
+
+    for (auto & entity_id : entities)
+        if (model.get_entity(entity_id).get_name() == name)
+            return true;
+
+    return false;
+
+}
+
+template<typename TSeq>
+inline void Agent<TSeq>::print(
+    Model<TSeq> & model,
+    bool compressed
+    ) const
+{
+
+    if (compressed)
+    {
+        printf_epiworld(
+            "Agent: %i, state: %s (%i), Has virus: %s, NTools: %ii NNeigh: %i\n",
+            static_cast<int>(id),
+            model.states_labels[state].c_str(),
+            static_cast<int>(state),
+            virus == nullptr ? std::string("no").c_str() : std::string("yes").c_str(),
+            static_cast<int>(tools.size()),
+            static_cast<int>(n_neighbors)
+        );
+    }
+    else {
+
+        printf_epiworld("Information about agent id %i\n",
+            static_cast<int>(this->id));
+        printf_epiworld("  State        : %s (%i)\n",
+            model.states_labels[state].c_str(), static_cast<int>(state));
+        printf_epiworld("  Has virus    : %s\n", virus == nullptr ?
+            std::string("no").c_str() : std::string("yes").c_str());
+        printf_epiworld("  Tool count   : %i\n", static_cast<int>(tools.size()));
+        printf_epiworld("  Neigh. count : %i\n", static_cast<int>(n_neighbors));
+
+        size_t nfeats = model.get_agents_data_ncols();
+        if (nfeats > 0)
+        {
+
+            printf_epiworld(
+                "This model includes features (%i): [ ",
+                static_cast<int>(nfeats)
+                );
+
+            int max_to_show = static_cast<int>((nfeats > 10)? 10 : nfeats);
+
+            for (int k = 0; k < max_to_show; ++k)
+            {
+                printf_epiworld("%.2f", this->operator()(k, model));
+
+                if (k != (max_to_show - 1))
+                {
+                    printf_epiworld(", ");
+                } else {
+                    printf_epiworld(" ]\n");
+                }
+
+            }
+            
+        }
+
+    }
+
+    return;
+
+}
+
+template<typename TSeq>
+inline double & Agent<TSeq>::operator()(size_t j, Model<TSeq> & model)
+{
+
+    if (model.agents_data_ncols <= j)
+        throw std::logic_error("The requested feature of the agent is out of range.");
+
+    return *(model.agents_data + j * model.size() + id);
+
+}
+
+template<typename TSeq>
+inline double Agent<TSeq>::operator()(size_t j, const Model<TSeq> & model) const
+{
+
+    if (model.agents_data_ncols <= j)
+        throw std::logic_error("The requested feature of the agent is out of range.");
+
+    return *(model.agents_data + j * model.size() + id);
+
+}
+
+template<typename TSeq>
+inline const std::vector< epiworld_agent_index > & Agent<TSeq>::get_entities() const
+{
+    return entities;
+}
+
+template<typename TSeq>
+inline const Entity<TSeq> & Agent<TSeq>::get_entity(size_t i, const Model<TSeq> & model) const
+{
+    if (entities.size() == 0)
+        throw std::range_error("Agent id " + std::to_string(id) + " has no entities.");
+
+    if (i >= entities.size())
+        throw std::range_error("Trying to get to an agent's entity outside of the range.");
+
+    return model.get_entity(
+        #ifdef EPI_DEBUG
+        entities.at(i)
+        #else
+        entities[i]
+        #endif
+    );
+}
+
+template<typename TSeq>
+inline Entity<TSeq> & Agent<TSeq>::get_entity(size_t i, Model<TSeq> & model)
+{
+    if (entities.size() == 0)
+        throw std::range_error("Agent id " + std::to_string(id) + " has no entities.");
+
+    if (i >= entities.size())
+        throw std::range_error("Trying to get to an agent's entity outside of the range.");
+
+    return model.get_entity(
+        #ifdef EPI_DEBUG
+        entities.at(i)
+        #else
+        entities[i]
+        #endif
+    );
+}
+
+template<typename TSeq>
+inline size_t Agent<TSeq>::get_n_entities() const
+{
+    return entities.size();
+}
+
+template<typename TSeq>
+inline bool Agent<TSeq>::operator==(const Agent<TSeq> & other) const
+{
+
+    // Checking the address
+    if (this == &other)
+        return true;
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        n_neighbors != other.n_neighbors,
+        "Agent:: n_eighbors don't match"
+        )
+
+    
+    EPI_DEBUG_FAIL_AT_TRUE(
+        entities.size() != other.entities.size(),
+        "Agent:: n_entities don't match"
+        )
+
+
+    for (size_t i = 0u; i < entities.size(); ++i)
+    {
+        EPI_DEBUG_FAIL_AT_TRUE(
+            entities[i] != other.entities[i],
+            "Agent:: entities[i] don't match"
+        )
+    }
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        state != other.state,
+        "Agent:: state don't match"
+        )
+        
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        state_prev != other.state_prev,
+        "Agent:: state_prev don't match"
+        )
+        
+
+    // EPI_DEBUG_FAIL_AT_TRUE(
+    //     state_last_changed != other.state_last_changed,
+    //     "Agent:: state_last_changed don't match"
+    //     ) ///< Last time the agent was updated.
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        ((virus == nullptr) && (other.virus != nullptr)) ||
+            ((virus != nullptr) && (other.virus == nullptr)),
+        "Agent:: virus don't match"
+    )
+
+    if ((virus != nullptr) && (other.virus != nullptr))
+    {
+        EPI_DEBUG_FAIL_AT_TRUE(
+            *virus != *other.virus,
+            "Agent:: virus doesn't match"
+        )
+    }
+    
+    EPI_DEBUG_FAIL_AT_TRUE(
+        tools.size() != other.tools.size(),
+        "Agent:: n_tools don't match"
+    )
+
+    for (size_t i = 0u; i < tools.size(); ++i)
+    {
+        
+        EPI_DEBUG_FAIL_AT_TRUE(
+            *tools[i] != *other.tools[i],
+            "Agent:: tools[i] don't match"
+        )
+         
+    }   
+    
+    return true;
+    
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/agent-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/agentssample-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_AGENTS_BONES_HPP
+#define EPIWORLD_AGENTS_BONES_HPP
+
+class SAMPLETYPE {
+public:
+    static const int MODEL  = 0;
+    static const int ENTITY = 1;
+    static const int AGENT  = 2;
+};
+
+// template<typename TSeq>
+// class Agent;
+
+// template<typename TSeq>
+// class Model;
+
+// template<typename TSeq>
+// class Entity;
+
+/**
+ * @brief Sample of agents
+ * 
+ * This class allows sampling agents from Entity<TSeq> and Model<TSeq>.
+ * 
+ * @tparam TSeq 
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class AgentsSample {
+private:
+
+    size_t sample_size = 0u;
+
+    std::vector< Agent<TSeq>* >* agents = nullptr; ///< Pointer to sample of agents
+    size_t * agents_n = nullptr;                    ///< Size of sample of agents
+    
+    std::vector< size_t >* agents_left = nullptr;  ///< Pointer to agents left (iota)
+    size_t * agents_left_n = nullptr;               ///< Size of agents left
+
+    Model<TSeq> * model   = nullptr;   ///< Extracts runif() and (if the case) population.
+    Entity<TSeq> * entity = nullptr; ///
+    Agent<TSeq> * agent   = nullptr;
+    
+    int sample_type = SAMPLETYPE::AGENT;
+    std::vector< size_t > states = {};
+
+    void sample_n(size_t n); ///< Backbone function for sampling
+
+
+public:
+
+    // Not available (for now)
+    AgentsSample() = delete;                             ///< Default constructor
+    AgentsSample(const AgentsSample<TSeq> & a) = delete; ///< Copy constructor
+    AgentsSample(AgentsSample<TSeq> && a) = delete;      ///< Move constructor
+
+    AgentsSample(
+        Model<TSeq> & model_, size_t n,
+        std::vector< size_t > states_ = {},
+        bool truncate = false
+        );
+
+    AgentsSample(
+        Model<TSeq> * model,
+        Entity<TSeq> & entity_,
+        size_t n,
+        std::vector< size_t > states_ = {},
+        bool truncate = false
+        );
+
+    AgentsSample(
+        Model<TSeq> * model,
+        Agent<TSeq> & agent_,
+        size_t n,
+        std::vector< size_t > states_ = {},
+        bool truncate = false
+        );
+
+    ~AgentsSample();
+
+    typename std::vector< Agent<TSeq> * >::iterator begin();
+    typename std::vector< Agent<TSeq> * >::iterator end();
+
+    Agent<TSeq> * operator[](size_t n);
+    Agent<TSeq> * operator()(size_t n);
+    size_t size() const noexcept;
+
+};
+
+template<typename TSeq>
+inline AgentsSample<TSeq>::AgentsSample(
+    Model<TSeq> & model_,
+    size_t n,
+    std::vector< size_t > states_,
+    bool truncate
+    ) {
+
+    states = states_;
+
+    if (truncate)
+    {
+        
+        if (n > model_.size())
+            n = model_.size();
+
+    } else if (n > model_.size())
+        throw std::logic_error(
+            "There are only " + std::to_string(model_.size()) + " agents. You cannot " +
+            "sample " + std::to_string(n));
+
+    sample_size   = n;
+    model         = &model_;
+    sample_type   = SAMPLETYPE::MODEL;
+
+    agents        = &model_.sampled_population;
+    agents_n      = &model_.sampled_population_n;
+
+    agents_left   = &model_.population_left;
+    agents_left_n = &model_.population_left_n;
+
+    sample_n(n);
+    
+    return; 
+
+}
+
+template<typename TSeq>
+inline AgentsSample<TSeq>::AgentsSample(
+    Model<TSeq> * model,
+    Entity<TSeq> & entity_,
+    size_t n,
+    std::vector< size_t > states_,
+    bool truncate
+    ) {
+
+    states = states_;
+
+    if (truncate)
+    {
+
+        if (n > entity_.size())
+            n = entity_.size();
+
+    } else if (n > entity_.size())
+        throw std::logic_error(
+            "There are only " + std::to_string(entity_.size()) + " agents. You cannot " +
+            "sample " + std::to_string(n));
+
+    sample_size   = n;
+    model         = &entity_.model;
+    sample_type   = SAMPLETYPE::ENTITY;
+
+    agents        = &entity_.sampled_agents;
+    agents_n      = &entity_.sampled_agents_n;
+
+    agents_left   = &entity_.sampled_agents_left;
+    agents_left_n = &entity_.sampled_agents_left_n;
+
+    sample_n(n);
+
+    return; 
+
+}
+
+/**
+ * @brief Sample from the agent's entities
+ * 
+ * For example, how many individuals the agent contacts in a given point in time.
+ * 
+ * @tparam TSeq 
+ * @param agent_ 
+ * @param n Sample size
+ * @param truncate If the agent has fewer than `n` connections, then truncate = true
+ * will automatically reduce the number of possible samples. Otherwise, if false, then
+ * it returns an error.
+ */
+template<typename TSeq>
+inline AgentsSample<TSeq>::AgentsSample(
+    Model<TSeq> * model,
+    Agent<TSeq> & agent_,
+    size_t n,
+    std::vector< size_t > states_,
+    bool truncate
+    )
+{
+
+    states = states_;
+    sample_type = SAMPLETYPE::AGENT;
+    
+    agent         = &agent_;
+
+    agents        = &agent_.sampled_agents;
+    agents_n      = &agent_.sampled_agents_n;
+
+    // Computing the cumulative sum of counts across entities
+    size_t agents_in_entities = 0;
+    const auto & entities_a = agent->get_entities();
+
+    std::vector< size_t > cum_agents_count(entities_a.size(), 0);
+    int idx = -1;
+    for (const Entity<TSeq> & e : entities_a)
+    {
+        if (++idx == 0)
+            cum_agents_count[idx] = (e.size() - 1u);
+        else
+            cum_agents_count[idx] = (
+                (e.size() - 1u) + 
+                cum_agents_count[idx - 1]
+            );
+
+        agents_in_entities += (e.size() - 1u);
+    }
+
+    if (truncate)
+    {
+        
+        if (n > agents_in_entities)
+            n = agents_in_entities;
+
+    } else if (n > agents_in_entities)
+        throw std::logic_error(
+            "There are only " + std::to_string(agents_in_entities) +
+            " agents. You cannot " +
+            "sample " + std::to_string(n)
+            );
+
+    sample_size = n;
+
+    if (agents->size() < n)
+        agents->resize(n);
+
+    size_t i_obs = 0u;
+    for (size_t i = 0u; i < sample_size; ++i)
+    {
+
+        // Sampling a single agent from the set of entities
+        int jth = model->runif_index(agents_in_entities);
+        for (size_t e = 0u; e < cum_agents_count.size(); ++e)
+        {
+            
+            // Are we in the limit?
+            if (jth <= cum_agents_count[e])
+            {
+                size_t agent_idx = 0u;
+                if (e == 0) // From the first group
+                    agent_idx = entities_a[e][jth]->get_id();
+                else
+                    agent_idx = entities_a[e][jth - cum_agents_count[e - 1]]->get_id();
+
+
+                // Checking if states was specified
+                if (states.size())
+                {
+
+                    // Getting the state
+                    size_t state = model->agents_state[agent_idx];
+
+                    if (std::find(states.begin(), states.end(), state) != states.end())
+                        continue;
+
+                }
+                
+                agents->operator[](i_obs++) = &(model->population[agent_idx]);
+
+                break;
+            }
+
+        }
+    }
+
+    return; 
+
+}
+
+template<typename TSeq>
+inline AgentsSample<TSeq>::~AgentsSample() {}
+
+template<typename TSeq>
+inline size_t AgentsSample<TSeq>::size() const noexcept
+{ 
+    return this->sample_size;
+}
+
+template<typename TSeq>
+inline Agent<TSeq> * AgentsSample<TSeq>::operator[](size_t i)
+{
+
+    return agents->operator[](i);
+
+}
+
+template<typename TSeq>
+inline Agent<TSeq> * AgentsSample<TSeq>::operator()(size_t i)
+{
+
+    if (i >= this->sample_size)
+        throw std::range_error("The requested agent is out of range.");
+
+    return agents->operator[](i);
+
+}
+
+template<typename TSeq>
+inline typename std::vector< Agent<TSeq> * >::iterator AgentsSample<TSeq>::begin()
+{
+    // Check for null pointer
+    if (agents == nullptr)
+        return typename std::vector< Agent<TSeq> * >::iterator{};
+    
+    return agents->begin();
+}
+
+template<typename TSeq>
+inline typename std::vector< Agent<TSeq> * >::iterator AgentsSample<TSeq>::end()
+{
+    // Check for null pointer
+    if (agents == nullptr)
+        return typename std::vector< Agent<TSeq> * >::iterator{};
+    
+    // Ensure we don't go beyond the actual vector size
+    size_t actual_end = std::min(sample_size, agents->size());
+    return agents->begin() + actual_end;
+}
+
+template<typename TSeq>
+inline void AgentsSample<TSeq>::sample_n(size_t n)
+{
+
+    // Reducing size
+    if (states.size())
+    {
+            
+        // Getting the number of agents left
+        agents_left->clear();
+
+        if (sample_type == SAMPLETYPE::MODEL)
+        {
+
+            // Making some room
+            agents_left->reserve(model->size());
+
+            // Flagging the selected states, so the scan over the agents'
+            // states (contiguous) doesn't search `states` for each agent
+            std::vector< unsigned char > selected(
+                *std::max_element(states.begin(), states.end()) + 1u, 0u
+            );
+            for (auto s : states)
+                selected[s] = 1u;
+
+            const auto & agents_state = model->agents_state;
+            for (size_t a_i = 0u; a_i < agents_state.size(); ++a_i)
+            {
+
+                // If the agent is within the selected set of states,
+                // then we add it to the list of agents left
+                size_t s = agents_state[a_i];
+                if ((s < selected.size()) && selected[s])
+                    agents_left->push_back(a_i);
+
+            }
+
+        } 
+        else if (sample_type == SAMPLETYPE::ENTITY)
+        {
+
+            // Making room
+            agents_left->reserve(entity->size());
+
+            // Iterating through the agents in the entity
+            for (size_t a_i = 0u; a_i < entity->size(); ++a_i)
+            {
+                size_t s = model->agents_state[entity->agents[a_i]];
+                if (std::find(states.begin(), states.end(), s) != states.end())
+                    agents_left->push_back(a_i);
+
+            }
+
+        }
+
+    } else {
+
+        // Checking if the size of the entity has changed (or hasn't been initialized)
+        if (sample_type == SAMPLETYPE::MODEL)
+        {
+
+            if (model->size() != agents_left->size())
+            {
+                agents_left->resize(model->size(), 0u);
+                std::iota(agents_left->begin(), agents_left->end(), 0u);
+            }
+
+        } else if (sample_type == SAMPLETYPE::ENTITY) {
+
+            if (entity->size() != agents_left->size())
+            {
+
+                agents_left->resize(entity->size(), 0u);
+                std::iota(agents_left->begin(), agents_left->end(), 0u);
+
+            }
+
+        } 
+
+    }
+
+    // Restart the counter of agents left
+    *agents_left_n = agents_left->size();
+
+    // Making sure we have enough room for the sample of agents
+    if (agents->size() < sample_size)
+        agents->resize(sample_size, nullptr);
+
+    if (sample_type == SAMPLETYPE::MODEL)
+    {
+
+        #ifdef EPI_DEBUG
+        std::vector< bool > __sampled(model->size(), true);
+        for (auto & a_i: *agents_left)
+            __sampled[a_i] = false;
+        #endif
+
+        for (size_t i = 0u; i < n; ++i)
+        {
+
+            // Sampling from 0 to (agents_left_n - 1)
+            size_t ith_ = static_cast<size_t>(model->runif() * ((*agents_left_n)--));
+            
+            // Getting the id of the agent and adding it to the list of agents
+            size_t ith  = agents_left->operator[](ith_);
+            agents->operator[](i) = &model->population[ith];
+
+            #ifdef EPI_DEBUG
+            if (__sampled[ith])
+                throw std::logic_error("The same agent was sampled twice.");
+            else
+                __sampled[ith] = true;
+            #endif
+
+            // Updating list
+            std::swap(
+                agents_left->operator[](ith_),
+                agents_left->operator[](*agents_left_n)
+                );
+
+        }
+
+
+    }
+    else if (sample_type == SAMPLETYPE::ENTITY)
+    {
+
+        #ifdef EPI_DEBUG
+        std::vector< bool > __sampled(entity->size(), true);
+        for (auto & a_i: *agents_left)
+            __sampled[a_i] = false;
+        #endif
+
+        for (size_t i = 0u; i < n; ++i)
+        {
+
+            size_t ith_ = static_cast<size_t>(
+                model->runif() * ((*agents_left_n)--)
+            );
+
+            size_t ith  = agents_left->operator[](ith_);
+            agents->operator[](i) = &model->population[entity->agents[ith]];
+
+            #ifdef EPI_DEBUG
+            if (__sampled[ith])
+                throw std::logic_error("The same agent was sampled twice.");
+            else
+                __sampled[ith] = true;
+            #endif
+
+            // Updating list
+            std::swap(agents_left->operator[](ith_), agents_left->operator[](*agents_left_n));
+
+        }
+
+    }
+
+    return;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/agentssample-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/model-meat-continuous.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODEL_MEAT_CONTINUOUS_HPP
+#define EPIWORLD_MODEL_MEAT_CONTINUOUS_HPP
+
+// (already included include/epiworld/model-bones.hpp)
+// (already included include/epiworld/indexedheap-bones.hpp)
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::run_continuous(
+    epiworld_fast_uint ndays,
+    int seed
+)
+{
+
+    // Classifying the states by their update function
+    static constexpr char absorbing   = 0;
+    static constexpr char susceptible = 1;
+    static constexpr char infected    = 2;
+
+    std::vector< char > kind(nstates, absorbing);
+    for (epiworld_fast_uint s = 0u; s < nstates; ++s)
+    {
+
+        if (state_fun_is(s, nullptr))
+            continue;
+        else if (state_fun_is(s, default_update_susceptible<TSeq>))
+            kind[s] = susceptible;
+        else if (state_fun_is(s, default_update_exposed<TSeq>))
+            kind[s] = infected;
+        else
+            throw std::logic_error(
+                "The state \"" + states_labels[s] + "\" has an update " +
+                "function that is not supported by -run_continuous()-. " +
+                "Only -default_update_susceptible- and " +
+                "-default_update_exposed- can be used."
+            );
+
+    }
+
+    run_setup(ndays, seed);
+
+    // Daily probabilities to rates. Certain events get a very large rate
+    // so they happen (almost) right away.
+    static constexpr epiworld_double rate_max = 1e9;
+    auto prob_to_rate = [](epiworld_double p) -> epiworld_double {
+
+        if (p <= 0.0)
+            return 0.0;
+
+        if (p >= 1.0)
+            return rate_max;
+
+        return -std::log1p(-p);
+
+    };
+
+    const size_t n = population.size();
+    std::vector< epiworld_double > rates(n, 0.0);
+    std::vector< epiworld_double > rates_death(n, 0.0);
+    IndexedMinHeap heap;
+    heap.reset(n);
+
+    // Infection rate from neighbor -> p (zero if the neighbor has no virus)
+    auto infection_rate = [&](Agent<TSeq> & p, Agent<TSeq> & neighbor) -> epiworld_double {
+
+        auto & v = neighbor.get_virus();
+        if (v == nullptr)
+            return 0.0;
+
+        return prob_to_rate(
+            (1.0 - p.get_susceptibility_reduction(v, *this)) *
+            v->get_prob_infecting(this) *
+            (1.0 - neighbor.get_transmission_reduction(v, *this))
+        );
+
+    };
+
+    // Total rate of the next event of the agent. For infected agents, the
+    // rate of death is stored in rates_death.
+    auto agent_rate = [&](Agent<TSeq> & p) -> epiworld_double {
+
+        char k = kind[p.get_state()];
+        if (k == susceptible)
+        {
+
+            if (p.get_virus() != nullptr)
+                return 0.0;
+
+            epiworld_double a = 0.0;
+            for (auto & neighbor : p.neighbors(*this))
+                a += infection_rate(p, neighbor);
+
+            return a;
+
+        }
+        else if (k == infected)
+        {
+
+            auto & v = p.get_virus();
+            if (v == nullptr)
+                return 0.0;
+
+            epiworld_double a_death = prob_to_rate(
+                v->get_prob_death(this) * (1.0 - p.get_death_reduction(v, *this))
+            );
+
+            epiworld_double a_recovery = prob_to_rate(
+                1.0 - (1.0 - v->get_prob_recovery(this)) *
+                    (1.0 - p.get_recovery_enhancer(v, *this))
+            );
+
+            rates_death[p.get_id()] = a_death;
+            return a_death + a_recovery;
+
+        }
+
+        return 0.0;
+
+    };
+
+    // Gibson-Bruck update: pending events are rescaled to the new rate, so
+    // only agents whose event fired (or had none) draw a new time.
+    epiworld_double t = 0.0;
+    auto reschedule = [&](size_t i, bool fired) -> void {
+
+        epiworld_double a_old = rates[i];
+        epiworld_double a_new = agent_rate(population[i]);
+        rates[i] = a_new;
+
+        if (a_new <= 0.0)
+            heap.update(i, std::numeric_limits< epiworld_double >::infinity());
+        else if (!fired && (a_old > 0.0))
+        {
+            if (a_old != a_new)
+                heap.update(i, t + (a_old / a_new) * (heap.key(i) - t));
+        }
+        else
+            heap.update(i, t + rexp(a_new));
+
+    };
+
+    auto fire = [&](size_t i) -> void {
+
+        Agent<TSeq> & p = population[i];
+
+        if (kind[p.get_state()] == infected)
+        {
+
+            if (runif() * rates[i] < rates_death[i])
+            {
+                int rm_state = -1;
+                p.get_virus()->get_state(nullptr, nullptr, &rm_state);
+                p.rm_virus(*this, rm_state);
+            }
+            else
+                p.rm_virus(*this);
+
+        }
+        else
+        {
+
+            // Picking the neighbor who transmits
+            epiworld_double u = runif() * rates[i];
+            Agent<TSeq> * source = nullptr;
+            for (auto & neighbor : p.neighbors(*this))
+            {
+
+                epiworld_double a = infection_rate(p, neighbor);
+                if (a <= 0.0)
+                    continue;
+
+                source = &neighbor;
+                if ((u -= a) < 0.0)
+                    break;
+
+            }
+
+            if (source != nullptr)
+                p.set_virus(*this, *source->get_virus());
+
+        }
+
+        events_run();
+
+        reschedule(i, true);
+
+        const epiworld_agent_index * neighbors = network->neighbors(i);
+        for (size_t j = 0u; j < p.get_n_neighbors(); ++j)
+            reschedule(neighbors[j], false);
+
+    };
+
+    for (size_t i = 0u; i < n; ++i)
+        reschedule(i, true);
+
+    bool refresh_daily = !globalevents.empty() || rewire_fun;
+    for (const auto & v : viruses)
+        if (v->strain->mutation)
+            refresh_daily = true;
+
+    for (epiworld_fast_uint niter = 0; niter < get_ndays(); ++niter)
+    {
+
+        epiworld_double t_end = static_cast< epiworld_double >(niter + 1u);
+        while (heap.top_key() < t_end)
+        {
+            t = heap.top_key();
+            fire(heap.top());
+        }
+
+        t = t_end;
+
+        this->run_globalevents();
+        this->rewire();
+        this->next();
+        this->mutate_virus();
+
+        if (refresh_daily)
+            for (size_t i = 0u; i < n; ++i)
+                reschedule(i, false);
+
+    }
+
+    // The last reaches the end...
+    this->current_date--;
+
+    chrono_end();
+
+    sim_id++;
+
+    return *this;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/model-meat-continuous.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/model-meat-checkpoint.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODEL_MEAT_CHECKPOINT_HPP
+#define EPIWORLD_MODEL_MEAT_CHECKPOINT_HPP
+
+// (already included include/epiworld/model-bones.hpp)
+
+/**
+ * @name Binary (de)serialization used by checkpoints
+ * @details Values are written in native byte order. Vectors of trivially
+ * copyable types are written as a size followed by a single block, so
+ * large arrays (e.g., the network and the history) are read with one
+ * call. All overloads are declared first so they can call each other.
+ */
+///@{
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const T & x);
+inline void checkpoint_write(std::ostream & out, const std::string & x);
+inline void checkpoint_write(std::ostream & out, const std::vector< bool > & x);
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const std::vector< T > & x);
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const std::shared_ptr< T > & x);
+template<typename K, typename V, typename... R>
+inline void checkpoint_write(std::ostream & out, const std::map< K, V, R... > & x);
+
+template<typename T>
+inline void checkpoint_read(std::istream & in, T & x);
+inline void checkpoint_read(std::istream & in, std::string & x);
+inline void checkpoint_read(std::istream & in, std::vector< bool > & x);
+template<typename T>
+inline void checkpoint_read(std::istream & in, std::vector< T > & x);
+template<typename T>
+inline void checkpoint_read(std::istream & in, std::shared_ptr< T > & x);
+template<typename K, typename V, typename... R>
+inline void checkpoint_read(std::istream & in, std::map< K, V, R... > & x);
+
+/** @brief Reads a size, checking the stream first (so garbage is not allocated). */
+inline size_t checkpoint_read_size(std::istream & in)
+{
+
+    uint64_t n = 0u;
+    in.read(reinterpret_cast< char * >(&n), sizeof(n));
+
+    if (!in)
+        throw std::runtime_error("Error reading the checkpoint (truncated file).");
+
+    return static_cast< size_t >(n);
+
+}
+
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const T & x)
+{
+    static_assert(
+        std::is_trivially_copyable< T >::value,
+        "Only trivially copyable types can be written as is."
+    );
+    out.write(reinterpret_cast< const char * >(&x), sizeof(T));
+}
+
+inline void checkpoint_write(std::ostream & out, const std::string & x)
+{
+    checkpoint_write(out, static_cast< uint64_t >(x.size()));
+    out.write(x.data(), static_cast< std::streamsize >(x.size()));
+}
+
+inline void checkpoint_write(std::ostream & out, const std::vector< bool > & x)
+{
+    checkpoint_write(out, static_cast< uint64_t >(x.size()));
+    for (bool b : x)
+        checkpoint_write(out, static_cast< unsigned char >(b));
+}
+
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const std::vector< T > & x)
+{
+
+    checkpoint_write(out, static_cast< uint64_t >(x.size()));
+
+    if constexpr (std::is_trivially_copyable< T >::value)
+        out.write(
+            reinterpret_cast< const char * >(x.data()),
+            static_cast< std::streamsize >(x.size() * sizeof(T))
+        );
+    else
+        for (const auto & x_i : x)
+            checkpoint_write(out, x_i);
+
+}
+
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const std::shared_ptr< T > & x)
+{
+    checkpoint_write(out, static_cast< unsigned char >(x != nullptr));
+    if (x != nullptr)
+        checkpoint_write(out, *x);
+}
+
+template<typename K, typename V, typename... R>
+inline void checkpoint_write(std::ostream & out, const std::map< K, V, R... > & x)
+{
+    checkpoint_write(out, static_cast< uint64_t >(x.size()));
+    for (const auto & kv : x)
+    {
+        checkpoint_write(out, kv.first);
+        checkpoint_write(out, kv.second);
+    }
+}
+
+template<typename T>
+inline void checkpoint_read(std::istream & in, T & x)
+{
+    static_assert(
+        std::is_trivially_copyable< T >::value,
+        "Only trivially copyable types can be read as is."
+    );
+    in.read(reinterpret_cast< char * >(&x), sizeof(T));
+}
+
+inline void checkpoint_read(std::istream & in, std::string & x)
+{
+    x.resize(checkpoint_read_size(in));
+    in.read(&x[0], static_cast< std::streamsize >(x.size()));
+}
+
+inline void checkpoint_read(std::istream & in, std::vector< bool > & x)
+{
+
+    x.resize(checkpoint_read_size(in));
+    for (size_t i = 0u; i < x.size(); ++i)
+    {
+        unsigned char b = 0u;
+        checkpoint_read(in, b);
+        x[i] = (b != 0u);
+    }
+
+}
+
+template<typename T>
+inline void checkpoint_read(std::istream & in, std::vector< T > & x)
+{
+
+    x.resize(checkpoint_read_size(in));
+
+    if constexpr (std::is_trivially_copyable< T >::value)
+        in.read(
+            reinterpret_cast< char * >(x.data()),
+            static_cast< std::streamsize >(x.size() * sizeof(T))
+        );
+    else
+        for (auto & x_i : x)
+            checkpoint_read(in, x_i);
+
+}
+
+template<typename T>
+inline void checkpoint_read(std::istream & in, std::shared_ptr< T > & x)
+{
+
+    unsigned char has_value = 0u;
+    checkpoint_read(in, has_value);
+
+    if (has_value == 0u)
+    {
+        x = nullptr;
+        return;
+    }
+
+    T value;
+    checkpoint_read(in, value);
+    x = std::make_shared< T >(std::move(value));
+
+}
+
+template<typename K, typename V, typename... R>
+inline void checkpoint_read(std::istream & in, std::map< K, V, R... > & x)
+{
+
+    x.clear();
+    size_t n = checkpoint_read_size(in);
+    for (size_t i = 0u; i < n; ++i)
+    {
+        K key;
+        checkpoint_read(in, key);
+        checkpoint_read(in, x[key]);
+    }
+
+}
+
+/**
+ * @brief Writes a map from hashes to ids `0, ..., n - 1` (e.g.,
+ * `DataBase::virus_id`) as the hashes in id order
+ * @details Reading inserts the hashes in the same order in a new map, as
+ * the database did when it registered them, so iterating over the map
+ * (e.g., in `DataBase::record()`) visits the ids in the same order.
+ */
+inline void checkpoint_write_ids(std::ostream & out, const MapVec_type<int,int> & x)
+{
+
+    std::vector< std::vector< int > > keys(x.size());
+    for (const auto & kv : x)
+        keys.at(static_cast< size_t >(kv.second)) = kv.first;
+
+    checkpoint_write(out, keys);
+
+}
+
+inline void checkpoint_read_ids(std::istream & in, MapVec_type<int,int> & x)
+{
+
+    std::vector< std::vector< int > > keys;
+    checkpoint_read(in, keys);
+
+    x = MapVec_type<int,int>();
+    for (size_t i = 0u; i < keys.size(); ++i)
+        x[keys[i]] = static_cast< int >(i);
+
+}
+
+/** @brief Writes the (textual) state of a random number distribution. */
+template<typename TDist>
+inline void checkpoint_write_dist(std::ostream & out, const TDist & dist)
+{
+    std::ostringstream ss;
+    ss << dist;
+    checkpoint_write(out, ss.str());
+}
+
+template<typename TDist>
+inline void checkpoint_read_dist(std::istream & in, TDist & dist)
+{
+    std::string s;
+    checkpoint_read(in, s);
+    std::istringstream ss(s);
+    ss >> dist;
+}
+///@}
+
+#define EPI_CHECKPOINT_MAGIC   "EPIWCKPT"
+#define EPI_CHECKPOINT_VERSION 1u
+
+template<typename TSeq>
+inline void Model<TSeq>::write_checkpoint(std::string fn) const
+{
+
+    std::ofstream out(fn, std::ios_base::out | std::ios_base::binary);
+
+    if (!out)
+        throw std::runtime_error(
+            "Could not open file \"" + fn + "\" for writing."
+        );
+
+    write_checkpoint(out);
+
+    if (!out)
+        throw std::runtime_error(
+            "Error writing the checkpoint to \"" + fn + "\"."
+        );
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::write_checkpoint(std::ostream & out) const
+{
+
+    // Header ------------------------------------------------------------------
+    out.write(EPI_CHECKPOINT_MAGIC, 8);
+    checkpoint_write(out, static_cast< uint32_t >(EPI_CHECKPOINT_VERSION));
+    checkpoint_write(out, std::vector< uint32_t >({
+        sizeof(size_t),
+        sizeof(epiworld_double),
+        sizeof(epiworld_fast_int),
+        sizeof(epiworld_fast_uint),
+        sizeof(epiworld_agent_index),
+        EPI_RUNIF_LANES
+    }));
+
+    // What the model must look like
+    checkpoint_write(out, std::vector< uint64_t >({
+        nstates,
+        population.size(),
+        viruses.size(),
+        tools.size(),
+        entities.size(),
+        globalevents.size()
+    }));
+
+    // Model -------------------------------------------------------------------
+    checkpoint_write(out, current_date);
+    checkpoint_write(out, ndays);
+    checkpoint_write(out, static_cast< uint64_t >(sim_id));
+    checkpoint_write(out, last_seed);
+    checkpoint_write(out, rng_seed);
+    checkpoint_write(out, parameters);
+
+    for (const auto & e : globalevents)
+        checkpoint_write(out, e->get_day());
+
+    // Random numbers
+    uint64_t engine_state[4u];
+    engine->get_state(engine_state);
+    for (auto s : engine_state)
+        checkpoint_write(out, s);
+
+    std::vector< uint64_t > engine_batch_state(4u * EPI_RUNIF_LANES);
+    engine_batch.get_state(engine_batch_state.data());
+    checkpoint_write(out, engine_batch_state);
+    checkpoint_write(out, runif_buffer);
+    checkpoint_write(out, static_cast< uint64_t >(runif_buffer_pos));
+
+    checkpoint_write(out, runifd_a);
+    checkpoint_write(out, runifd_b);
+    checkpoint_write(out, rbinomd_n);
+    checkpoint_write(out, rbinomd_fast_lambda);
+    checkpoint_write(out, rbinomd_use_poisson);
+    checkpoint_write_dist(out, rnormd);
+    checkpoint_write_dist(out, rgammad);
+    checkpoint_write_dist(out, rlognormald);
+    checkpoint_write_dist(out, rexpd);
+    checkpoint_write_dist(out, rbinomd);
+    checkpoint_write_dist(out, rnbinomd);
+    checkpoint_write_dist(out, rgeomd);
+    checkpoint_write_dist(out, rpoissd);
+
+    // Network and agents ------------------------------------------------------
+    checkpoint_write(out, network->offsets);
+    checkpoint_write(out, network->ids);
+    checkpoint_write(out, network->locations);
+
+    for (const auto & p : population)
+    {
+
+        checkpoint_write(out, p.state);
+        checkpoint_write(out, p.state_prev);
+        checkpoint_write(out, p.state_last_changed);
+        checkpoint_write(out, p.entities);
+
+        checkpoint_write(out, static_cast< unsigned char >(p.virus != nullptr));
+        if (p.virus != nullptr)
+        {
+            checkpoint_write(out, p.virus->id);
+            checkpoint_write(out, p.virus->date);
+            checkpoint_write(out, p.virus->baseline_sequence);
+        }
+
+        checkpoint_write(out, static_cast< uint64_t >(p.tools.size()));
+        for (const auto & t : p.tools)
+        {
+            checkpoint_write(out, t->id);
+            checkpoint_write(out, t->date);
+            checkpoint_write(out, t->sequence);
+        }
+
+    }
+
+    for (const auto & e : entities)
+        checkpoint_write(out, e.agents);
+
+    // Queue and contact tracing -----------------------------------------------
+    checkpoint_write(out, queue.active);
+    checkpoint_write(out, queue.n_in_queue);
+    checkpoint_write(out, queue.active_list);
+    checkpoint_write(out, queue.in_list);
+
+    bool has_contact_tracing = use_contact_tracing && contact_tracing;
+    checkpoint_write(out, has_contact_tracing);
+    if (has_contact_tracing)
+    {
+        checkpoint_write(out, contact_tracing->contact_matrix);
+        checkpoint_write(out, contact_tracing->contacts_per_agent);
+        checkpoint_write(out, contact_tracing->contact_date);
+        checkpoint_write(out, static_cast< uint64_t >(contact_tracing->n_agents));
+        checkpoint_write(out, static_cast< uint64_t >(contact_tracing->max_contacts));
+    }
+
+    // Database ----------------------------------------------------------------
+    checkpoint_write_ids(out, db.virus_id);
+    checkpoint_write(out, db.virus_name);
+    checkpoint_write(out, db.virus_sequence);
+    checkpoint_write(out, db.virus_origin_date);
+    checkpoint_write(out, db.virus_parent_id);
+
+    checkpoint_write_ids(out, db.tool_id);
+    checkpoint_write(out, db.tool_name);
+    checkpoint_write(out, db.tool_sequence);
+    checkpoint_write(out, db.tool_origin_date);
+
+    checkpoint_write(out, db.today_virus);
+    checkpoint_write(out, db.today_tool);
+    checkpoint_write(out, db.today_total);
+    checkpoint_write(out, db.today_total_nviruses_active);
+    checkpoint_write(out, db.sampling_freq);
+
+    checkpoint_write(out, db.hist_virus_date);
+    checkpoint_write(out, db.hist_virus_id);
+    checkpoint_write(out, db.hist_virus_state);
+    checkpoint_write(out, db.hist_virus_counts);
+
+    checkpoint_write(out, db.hist_tool_date);
+    checkpoint_write(out, db.hist_tool_id);
+    checkpoint_write(out, db.hist_tool_state);
+    checkpoint_write(out, db.hist_tool_counts);
+
+    checkpoint_write(out, db.hist_total_date);
+    checkpoint_write(out, db.hist_total_nviruses_active);
+    checkpoint_write(out, db.hist_total_state);
+    checkpoint_write(out, db.hist_total_counts);
+    checkpoint_write(out, db.hist_transition_matrix);
+
+    checkpoint_write(out, db.transmission_date);
+    checkpoint_write(out, db.transmission_source);
+    checkpoint_write(out, db.transmission_target);
+    checkpoint_write(out, db.transmission_virus);
+    checkpoint_write(out, db.transmission_source_exposure_date);
+
+    checkpoint_write(out, db.transition_matrix);
+    checkpoint_write(out, db.batch_transitions);
+    checkpoint_write(out, db.batch_dirty);
+    checkpoint_write(out, db.batch_counts);
+
+    checkpoint_write(out, db.m_hospitalizations._date);
+    checkpoint_write(out, db.m_hospitalizations._virus_id);
+    checkpoint_write(out, db.m_hospitalizations._tool_id);
+    checkpoint_write(out, db.m_hospitalizations._weight);
+
+    checkpoint_write(out, db.user_data.data_names);
+    checkpoint_write(out, db.user_data.data_dates);
+    checkpoint_write(out, db.user_data.data_data);
+    checkpoint_write(out, db.user_data.k);
+    checkpoint_write(out, db.user_data.n);
+    checkpoint_write(out, db.user_data.last_day);
+
+    write_checkpoint_derived(out);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::read_checkpoint(std::string fn)
+{
+
+    std::ifstream in(fn, std::ios_base::in | std::ios_base::binary);
+
+    if (!in)
+        throw std::runtime_error(
+            "Could not open file \"" + fn + "\" for reading."
+        );
+
+    read_checkpoint(in);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::read_checkpoint(std::istream & in)
+{
+
+    // Header ------------------------------------------------------------------
+    char magic[8u];
+    in.read(magic, 8);
+    if (!in || (std::string(magic, 8u) != EPI_CHECKPOINT_MAGIC))
+        throw std::runtime_error("The stream is not an epiworld checkpoint.");
+
+    uint32_t version = 0u;
+    checkpoint_read(in, version);
+    if (version != EPI_CHECKPOINT_VERSION)
+        throw std::runtime_error(
+            "Unsupported checkpoint version " + std::to_string(version) +
+            " (expected " + std::to_string(EPI_CHECKPOINT_VERSION) + ")."
+        );
+
+    std::vector< uint32_t > layout;
+    checkpoint_read(in, layout);
+    if (layout != std::vector< uint32_t >({
+        sizeof(size_t),
+        sizeof(epiworld_double),
+        sizeof(epiworld_fast_int),
+        sizeof(epiworld_fast_uint),
+        sizeof(epiworld_agent_index),
+        EPI_RUNIF_LANES
+    }))
+        throw std::runtime_error(
+            "The checkpoint was written with different type sizes (or RNG lanes)."
+        );
+
+    std::vector< uint64_t > dims;
+    checkpoint_read(in, dims);
+    std::vector< std::string > dims_names = {
+        "states", "agents", "viruses", "tools", "entities", "global events"
+    };
+    std::vector< uint64_t > dims_model = {
+        nstates,
+        population.size(),
+        viruses.size(),
+        tools.size(),
+        entities.size(),
+        globalevents.size()
+    };
+
+    for (size_t i = 0u; i < dims_model.size(); ++i)
+        if ((i >= dims.size()) || (dims[i] != dims_model[i]))
+            throw std::logic_error(
+                "The checkpoint doesn't match the model: the number of " +
+                dims_names[i] + " is " + std::to_string(dims_model[i]) +
+                " in the model."
+            );
+
+    // Model -------------------------------------------------------------------
+    uint64_t sim_id_ = 0u;
+    checkpoint_read(in, current_date);
+    checkpoint_read(in, ndays);
+    checkpoint_read(in, sim_id_);
+    checkpoint_read(in, last_seed);
+    checkpoint_read(in, rng_seed);
+    sim_id = static_cast< size_t >(sim_id_);
+
+    // Keeping the existing entries, since parameters_ptrs point to them
+    std::map< std::string, epiworld_double > parameters_;
+    checkpoint_read(in, parameters_);
+    for (const auto & kv : parameters_)
+        parameters[kv.first] = kv.second;
+
+    parameters_ptrs_update();
+
+    for (auto & e : globalevents)
+    {
+        int day = -99;
+        checkpoint_read(in, day);
+        e->set_day(day);
+    }
+
+    // Random numbers
+    uint64_t engine_state[4u];
+    for (auto & s : engine_state)
+        checkpoint_read(in, s);
+
+    engine->set_state(engine_state);
+
+    std::vector< uint64_t > engine_batch_state;
+    uint64_t runif_buffer_pos_ = 0u;
+    checkpoint_read(in, engine_batch_state);
+    checkpoint_read(in, runif_buffer);
+    checkpoint_read(in, runif_buffer_pos_);
+    engine_batch.set_state(engine_batch_state.data());
+    runif_buffer_pos = static_cast< size_t >(runif_buffer_pos_);
+
+    checkpoint_read(in, runifd_a);
+    checkpoint_read(in, runifd_b);
+    checkpoint_read(in, rbinomd_n);
+    checkpoint_read(in, rbinomd_fast_lambda);
+    checkpoint_read(in, rbinomd_use_poisson);
+    checkpoint_read_dist(in, rnormd);
+    checkpoint_read_dist(in, rgammad);
+    checkpoint_read_dist(in, rlognormald);
+    checkpoint_read_dist(in, rexpd);
+    checkpoint_read_dist(in, rbinomd);
+    checkpoint_read_dist(in, rnbinomd);
+    checkpoint_read_dist(in, rgeomd);
+    checkpoint_read_dist(in, rpoissd);
+
+    // Network and agents ------------------------------------------------------
+
+    // The network is only replaced if it changed (e.g., rewiring), so it
+    // stays shared with the backup and the copies of the model otherwise.
+    Network net;
+    checkpoint_read(in, net.offsets);
+    checkpoint_read(in, net.ids);
+    checkpoint_read(in, net.locations);
+
+    if (net.vcount() != population.size())
+        throw std::logic_error(
+            "The checkpoint doesn't match the model: the network has " +
+            std::to_string(net.vcount()) + " vertices."
+        );
+
+    if (net != *network)
+        network = std::make_shared< Network >(std::move(net));
+
+    // The templates of the viruses and tools are read after the database,
+    // so the agents' viruses and tools are set at the end.
+    struct Carried {
+        int id;
+        int date;
+        EPI_TYPENAME_TRAITS(TSeq, int) sequence;
+    };
+
+    std::vector< std::vector< Carried > > agents_viruses(population.size());
+    std::vector< std::vector< Carried > > agents_tools(population.size());
+    agents_state.resize(population.size());
+
+    for (auto & p : population)
+    {
+
+        p.n_neighbors = network->degree(p.id);
+
+        checkpoint_read(in, p.state);
+        agents_state[p.id] = p.state;
+        checkpoint_read(in, p.state_prev);
+        checkpoint_read(in, p.state_last_changed);
+        checkpoint_read(in, p.entities);
+
+        unsigned char has_virus = 0u;
+        checkpoint_read(in, has_virus);
+        if (has_virus != 0u)
+        {
+            Carried v;
+            checkpoint_read(in, v.id);
+            checkpoint_read(in, v.date);
+            checkpoint_read(in, v.sequence);
+            agents_viruses[p.id].push_back(std::move(v));
+        }
+
+        size_t ntools = checkpoint_read_size(in);
+        for (size_t i = 0u; i < ntools; ++i)
+        {
+            Carried t;
+            checkpoint_read(in, t.id);
+            checkpoint_read(in, t.date);
+            checkpoint_read(in, t.sequence);
+            agents_tools[p.id].push_back(std::move(t));
+        }
+
+    }
+
+    for (auto & e : entities)
+        checkpoint_read(in, e.agents);
+
+    // Queue and contact tracing -----------------------------------------------
+    checkpoint_read(in, queue.active);
+    checkpoint_read(in, queue.n_in_queue);
+    checkpoint_read(in, queue.active_list);
+    checkpoint_read(in, queue.in_list);
+
+    bool has_contact_tracing = false;
+    checkpoint_read(in, has_contact_tracing);
+    if (has_contact_tracing)
+    {
+
+        uint64_t n_agents = 0u, max_contacts = 0u;
+        std::vector< epiworld_agent_index > contact_matrix;
+        std::vector< size_t > contacts_per_agent, contact_date;
+        checkpoint_read(in, contact_matrix);
+        checkpoint_read(in, contacts_per_agent);
+        checkpoint_read(in, contact_date);
+        checkpoint_read(in, n_agents);
+        checkpoint_read(in, max_contacts);
+
+        contact_tracing = std::make_unique<ContactTracing>(
+            static_cast< size_t >(n_agents), static_cast< size_t >(max_contacts)
+        );
+        contact_tracing->contact_matrix     = std::move(contact_matrix);
+        contact_tracing->contacts_per_agent = std::move(contacts_per_agent);
+        contact_tracing->contact_date       = std::move(contact_date);
+
+    }
+
+    // Database ----------------------------------------------------------------
+    checkpoint_read_ids(in, db.virus_id);
+    checkpoint_read(in, db.virus_name);
+    checkpoint_read(in, db.virus_sequence);
+    checkpoint_read(in, db.virus_origin_date);
+    checkpoint_read(in, db.virus_parent_id);
+
+    checkpoint_read_ids(in, db.tool_id);
+    checkpoint_read(in, db.tool_name);
+    checkpoint_read(in, db.tool_sequence);
+    checkpoint_read(in, db.tool_origin_date);
+
+    checkpoint_read(in, db.today_virus);
+    checkpoint_read(in, db.today_tool);
+    checkpoint_read(in, db.today_total);
+    checkpoint_read(in, db.today_total_nviruses_active);
+    checkpoint_read(in, db.sampling_freq);
+
+    checkpoint_read(in, db.hist_virus_date);
+    checkpoint_read(in, db.hist_virus_id);
+    checkpoint_read(in, db.hist_virus_state);
+    checkpoint_read(in, db.hist_virus_counts);
+
+    checkpoint_read(in, db.hist_tool_date);
+    checkpoint_read(in, db.hist_tool_id);
+    checkpoint_read(in, db.hist_tool_state);
+    checkpoint_read(in, db.hist_tool_counts);
+
+    checkpoint_read(in, db.hist_total_date);
+    checkpoint_read(in, db.hist_total_nviruses_active);
+    checkpoint_read(in, db.hist_total_state);
+    checkpoint_read(in, db.hist_total_counts);
+    checkpoint_read(in, db.hist_transition_matrix);
+
+    checkpoint_read(in, db.transmission_date);
+    checkpoint_read(in, db.transmission_source);
+    checkpoint_read(in, db.transmission_target);
+    checkpoint_read(in, db.transmission_virus);
+    checkpoint_read(in, db.transmission_source_exposure_date);
+
+    checkpoint_read(in, db.transition_matrix);
+    checkpoint_read(in, db.batch_transitions);
+    checkpoint_read(in, db.batch_dirty);
+    checkpoint_read(in, db.batch_counts);
+
+    checkpoint_read(in, db.m_hospitalizations._date);
+    checkpoint_read(in, db.m_hospitalizations._virus_id);
+    checkpoint_read(in, db.m_hospitalizations._tool_id);
+    checkpoint_read(in, db.m_hospitalizations._weight);
+
+    checkpoint_read(in, db.user_data.data_names);
+    checkpoint_read(in, db.user_data.data_dates);
+    checkpoint_read(in, db.user_data.data_data);
+    checkpoint_read(in, db.user_data.k);
+    checkpoint_read(in, db.user_data.n);
+    checkpoint_read(in, db.user_data.last_day);
+
+    if (!in)
+        throw std::runtime_error("Error reading the checkpoint (truncated file).");
+
+    // Viruses and tools -------------------------------------------------------
+
+    // Each virus id is rebuilt from the model's virus it descends from
+    std::vector< const Virus<TSeq> * > virus_template(db.virus_name.size(), nullptr);
+    for (size_t i = 0u; i < virus_template.size(); ++i)
+    {
+
+        int ancestor = static_cast< int >(i);
+        while ((ancestor >= 0) && (virus_template[i] == nullptr))
+        {
+
+            for (const auto & v : viruses)
+                if (v->get_id() == ancestor)
+                    virus_template[i] = v.get();
+
+            if (static_cast< size_t >(ancestor) >= db.virus_parent_id.size())
+                break;
+
+            ancestor = db.virus_parent_id[ancestor];
+
+        }
+
+    }
+
+    std::vector< const Tool<TSeq> * > tool_template(db.tool_name.size(), nullptr);
+    for (const auto & t : tools)
+        if ((t->get_id() >= 0) && (static_cast< size_t >(t->get_id()) < tool_template.size()))
+            tool_template[t->get_id()] = t.get();
+
+    for (auto & p : population)
+    {
+
+        p.virus = nullptr;
+        for (auto & v : agents_viruses[p.id])
+        {
+
+            if ((v.id < 0) || (static_cast< size_t >(v.id) >= virus_template.size()) ||
+                (virus_template[v.id] == nullptr))
+                throw std::logic_error(
+                    "The checkpoint doesn't match the model: the virus with id " +
+                    std::to_string(v.id) + " is not in the model."
+                );
+
+            p.virus = VirusPtr<TSeq>(virus_template[v.id]->clone_ptr());
+            p.virus->id   = v.id;
+            p.virus->date = v.date;
+            p.virus->baseline_sequence = std::move(v.sequence);
+            p.virus->set_agent(&p);
+
+        }
+
+        p.tools.clear();
+        for (auto & t : agents_tools[p.id])
+        {
+
+            if ((t.id < 0) || (static_cast< size_t >(t.id) >= tool_template.size()) ||
+                (tool_template[t.id] == nullptr))
+                throw std::logic_error(
+                    "The checkpoint doesn't match the model: the tool with id " +
+                    std::to_string(t.id) + " is not in the model."
+                );
+
+            p.tools.emplace_back(ToolPtr<TSeq>(tool_template[t.id]->clone_ptr()));
+            p.tools.back()->id       = t.id;
+            p.tools.back()->date     = t.date;
+            p.tools.back()->sequence = std::move(t.sequence);
+            p.tools.back()->set_agent(&p, p.tools.size() - 1u);
+
+        }
+
+        p.tools_effects_update();
+
+    }
+
+    read_checkpoint_derived_keep_rng(in);
+
+    if (!in)
+        throw std::runtime_error("Error reading the checkpoint (truncated file).");
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::read_checkpoint_derived_keep_rng(std::istream & in)
+{
+
+    // Rebuilding the lists of derived models may also set the binomial
+    // distribution (e.g., `ModelSIRCONN::update_infected()`), which was
+    // already restored with its cached draws.
+    auto rbinomd_             = rbinomd;
+    auto rbinomd_n_           = rbinomd_n;
+    auto rbinomd_fast_lambda_ = rbinomd_fast_lambda;
+    auto rbinomd_use_poisson_ = rbinomd_use_poisson;
+
+    read_checkpoint_derived(in);
+
+    rbinomd             = rbinomd_;
+    rbinomd_n           = rbinomd_n_;
+    rbinomd_fast_lambda = rbinomd_fast_lambda_;
+    rbinomd_use_poisson = rbinomd_use_poisson_;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::write_checkpoint_derived(std::ostream &) const
+{
+    return;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::read_checkpoint_derived(std::istream &)
+{
+    return;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::resume(epiworld_fast_uint ndays)
+{
+
+    if (size() == 0u)
+        throw std::logic_error("There are no agents in this model!");
+
+    pb = Progress(ndays, 80);
+
+    // As in run_setup()
+    parameters_ptrs_update();
+
+    // Back to the day after the last recorded one (as in the loop of
+    // run()); the simulation id is kept, since this is the same run.
+    this->current_date++;
+
+    time_start = std::chrono::steady_clock::now();
+
+    // The profile of the run keeps growing; only the new days go to the total
+    Profiler profile_before = profile;
+    profile.reset();
+
+    run_days(ndays);
+
+    this->current_date--;
+    this->ndays += ndays;
+
+    time_end = std::chrono::steady_clock::now();
+    time_elapsed += (time_end - time_start);
+
+    profile_total  += profile;
+    profile_before += profile;
+    profile = profile_before;
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::run_scenarios(
+    epiworld_fast_uint ndays,
+    epiworld_fast_uint burnin,
+    const std::vector< std::map< std::string, epiworld_double > > & scenarios,
+    epiworld_fast_uint nreplicates,
+    int seed,
+    std::function<void(size_t,Model<TSeq>*)> fun,
+    bool verbose,
+    #ifdef _OPENMP
+    int nthreads
+    #else
+    int
+    #endif
+)
+{
+
+    if (burnin > ndays)
+        throw std::logic_error(
+            "The burn-in (" + std::to_string(burnin) + " days) cannot be " +
+            "longer than the simulation (" + std::to_string(ndays) + " days)."
+        );
+
+    if (scenarios.size() == 0u)
+        throw std::logic_error("There must be at least one scenario.");
+
+    if (nreplicates == 0u)
+        throw std::logic_error("The number of replicates must be above 0.");
+
+    // Failing early (and not within the threads) on unknown parameters
+    for (const auto & scenario : scenarios)
+        for (const auto & p : scenario)
+            if (parameters.find(p.first) == parameters.end())
+                throw std::logic_error(
+                    "The parameter '" + p.first + "' does not exists."
+                );
+
+    if (seed >= 0)
+        this->seed(static_cast< size_t >(seed));
+
+    // Seeds are bound to the fork (the first one is for the burn-in)
+    const size_t nforks = scenarios.size() * nreplicates;
+    std::vector< int > seeds_n(nforks + 1u);
+    for (auto & s : seeds_n)
+    {
+        s = static_cast<int>(
+            std::floor(
+                runif() * static_cast<double>(std::numeric_limits<int>::max())
+                )
+        );
+    }
+
+    bool old_verb = this->verbose;
+    verbose_off();
+
+    // Burn-in, shared by all the forks
+    run(burnin, seeds_n[0u]);
+
+    std::ostringstream snapshot_out(std::ios_base::out | std::ios_base::binary);
+    write_checkpoint(snapshot_out);
+    const std::string snapshot = snapshot_out.str();
+
+    auto run_fork = [&scenarios, &snapshot, &seeds_n, ndays, burnin, nreplicates](
+        size_t fork, Model<TSeq> * model
+    ) -> void {
+
+        std::istringstream snapshot_in(
+            snapshot, std::ios_base::in | std::ios_base::binary
+        );
+        model->read_checkpoint(snapshot_in);
+
+        for (const auto & p : scenarios[fork / nreplicates])
+            model->set_param(p.first, p.second);
+
+        model->set_sim_id(fork);
+        model->seed(static_cast< size_t >(seeds_n[fork + 1u]));
+        model->resume(ndays - burnin);
+
+    };
+
+    Progress pb_multiple(
+        static_cast<int>(nforks),
+        EPIWORLD_PROGRESS_BAR_WIDTH
+        );
+
+    #ifdef _OPENMP
+    // Not more than the number of forks
+    nthreads =
+        static_cast<size_t>(nthreads) > nforks ? nforks : nthreads;
+    #endif
+
+    if (verbose)
+    {
+
+        #ifdef _OPENMP
+        printf_epiworld(
+            "Starting %i scenario(s) x %i replicate(s) using %i thread(s)\n",
+            static_cast<int>(scenarios.size()),
+            static_cast<int>(nreplicates),
+            static_cast<int>(nthreads)
+        );
+        #else
+        printf_epiworld(
+            "Starting %i scenario(s) x %i replicate(s)\n",
+            static_cast<int>(scenarios.size()),
+            static_cast<int>(nreplicates)
+        );
+        #endif
+
+        pb_multiple.start();
+
+    }
+
+    // Forks are scheduled as the replicates of run_multiple()
+    run_jobs(
+        nforks,
+        #ifdef _OPENMP
+        nthreads,
+        #else
+        1,
+        #endif
+        run_fork, fun, pb_multiple, verbose
+    );
+
+    if (old_verb)
+        verbose_on();
+
+    return *this;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/model-meat-checkpoint.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/model-meat-memory.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODEL_MEAT_MEMORY_HPP
+#define EPIWORLD_MODEL_MEAT_MEMORY_HPP
+
+// (already included include/epiworld/model-bones.hpp)
+// (already included include/epiworld/memoryusage-bones.hpp)
+
+template<typename TSeq>
+inline MemoryUsage Model<TSeq>::memory_usage(int nthreads) const
+{
+
+    MemoryUsage res;
+
+    // Agents
+    res.agents = MemoryUsage::bytes(population) +
+        MemoryUsage::bytes(agents_state);
+    for (const auto & a : population)
+    {
+
+        res.agents_entities += MemoryUsage::bytes(a.entities);
+
+        if (a.virus != nullptr)
+            res.agents_viruses += sizeof(Virus<TSeq>);
+
+        res.agents_tools += MemoryUsage::bytes(a.tools) +
+            a.tools.size() * sizeof(Tool<TSeq>);
+
+    }
+
+    // Network (the backup counts only if it is not the same network)
+    auto network_bytes = [](const Network & net) -> size_t {
+        return MemoryUsage::bytes(net.offsets) + MemoryUsage::bytes(net.ids) +
+            MemoryUsage::bytes(net.locations);
+    };
+
+    res.network = network_bytes(*network);
+    if ((network_backup != nullptr) && (network_backup != network))
+        res.network_backup = network_bytes(*network_backup);
+
+    for (const auto & e : entities)
+        res.entities += sizeof(Entity<TSeq>) + MemoryUsage::bytes(e.agents) +
+            MemoryUsage::bytes(e.location);
+    res.entities += (entities.capacity() - entities.size()) *
+        sizeof(Entity<TSeq>);
+
+    res.queue = MemoryUsage::bytes(queue.active) +
+        MemoryUsage::bytes(queue.active_list) +
+        MemoryUsage::bytes(queue.in_list);
+
+    if (contact_tracing != nullptr)
+        res.contact_tracing = sizeof(ContactTracing) +
+            MemoryUsage::bytes(contact_tracing->contact_matrix) +
+            MemoryUsage::bytes(contact_tracing->contacts_per_agent) +
+            MemoryUsage::bytes(contact_tracing->contact_date);
+
+    auto event_bytes = [](const EventBuffer<TSeq> & e) -> size_t {
+        return MemoryUsage::bytes(e.agent) + MemoryUsage::bytes(e.action) +
+            MemoryUsage::bytes(e.new_state) + MemoryUsage::bytes(e.queue) +
+            MemoryUsage::bytes(e.payload) + MemoryUsage::bytes(e.viruses) +
+            MemoryUsage::bytes(e.tools) + MemoryUsage::bytes(e.entities) +
+            MemoryUsage::bytes(e.order);
+    };
+
+    res.events = event_bytes(events) + MemoryUsage::bytes(events_threads) +
+        MemoryUsage::bytes(engines_threads);
+    for (const auto & e : events_threads)
+        res.events += MemoryUsage::bytes(e);
+
+    res.sampling = MemoryUsage::bytes(sampled_population) +
+        MemoryUsage::bytes(population_left);
+
+    // Database
+    res.db_registry =
+        MemoryUsage::bytes(db.virus_id) +
+        MemoryUsage::bytes(db.virus_name) +
+        MemoryUsage::bytes(db.virus_sequence) +
+        MemoryUsage::bytes(db.virus_origin_date) +
+        MemoryUsage::bytes(db.virus_parent_id) +
+        MemoryUsage::bytes(db.tool_id) +
+        MemoryUsage::bytes(db.tool_name) +
+        MemoryUsage::bytes(db.tool_sequence) +
+        MemoryUsage::bytes(db.tool_origin_date);
+
+    res.db_today = MemoryUsage::bytes(db.today_virus) +
+        MemoryUsage::bytes(db.today_tool) + MemoryUsage::bytes(db.today_total);
+    for (const auto & v : db.today_virus)
+        res.db_today += MemoryUsage::bytes(v);
+    for (const auto & t : db.today_tool)
+        res.db_today += MemoryUsage::bytes(t);
+
+    res.db_hist_virus =
+        MemoryUsage::bytes(db.hist_virus_date) +
+        MemoryUsage::bytes(db.hist_virus_id) +
+        MemoryUsage::bytes(db.hist_virus_state) +
+        MemoryUsage::bytes(db.hist_virus_counts);
+
+    res.db_hist_tool =
+        MemoryUsage::bytes(db.hist_tool_date) +
+        MemoryUsage::bytes(db.hist_tool_id) +
+        MemoryUsage::bytes(db.hist_tool_state) +
+        MemoryUsage::bytes(db.hist_tool_counts);
+
+    res.db_hist_total =
+        MemoryUsage::bytes(db.hist_total_date) +
+        MemoryUsage::bytes(db.hist_total_nviruses_active) +
+        MemoryUsage::bytes(db.hist_total_state) +
+        MemoryUsage::bytes(db.hist_total_counts);
+
+    res.db_hist_transition = MemoryUsage::bytes(db.hist_transition_matrix);
+
+    res.db_transition = MemoryUsage::bytes(db.transition_matrix) +
+        MemoryUsage::bytes(db.batch_counts);
+
+    res.db_transmission =
+        MemoryUsage::bytes(db.transmission_date) +
+        MemoryUsage::bytes(db.transmission_source) +
+        MemoryUsage::bytes(db.transmission_target) +
+        MemoryUsage::bytes(db.transmission_virus) +
+        MemoryUsage::bytes(db.transmission_source_exposure_date);
+
+    res.db_user_data =
+        MemoryUsage::bytes(db.user_data.data_names) +
+        MemoryUsage::bytes(db.user_data.data_dates) +
+        MemoryUsage::bytes(db.user_data.data_data);
+
+    res.db_hospitalizations =
+        MemoryUsage::bytes(db.m_hospitalizations._date) +
+        MemoryUsage::bytes(db.m_hospitalizations._virus_id) +
+        MemoryUsage::bytes(db.m_hospitalizations._tool_id) +
+        MemoryUsage::bytes(db.m_hospitalizations._weight);
+
+    // Clones copy everything but the network
+    if (nthreads > 1)
+        res.thread_clones = static_cast< size_t >(nthreads - 1) *
+            (res.total() - res.network - res.network_backup);
+
+    return res;
+
+}
+
+template<typename TSeq>
+inline MemoryUsage Model<TSeq>::estimate_memory_usage(
+    size_t n,
+    epiworld_double mean_degree,
+    size_t nstates,
+    size_t ndays,
+    size_t nviruses,
+    size_t ntools,
+    int nthreads
+)
+{
+
+    MemoryUsage res;
+
+    size_t nties = static_cast< size_t >(
+        static_cast< epiworld_double >(n) * mean_degree + 0.5
+    );
+
+    // History rows (date, id or active viruses, state, and count), from
+    // day 0 to ndays
+    size_t nrecords = ndays + 1u;
+    size_t nrow     = sizeof(int) * 3u + sizeof(epiworld_fast_uint);
+
+    res.agents         = n * (sizeof(Agent<TSeq>) + sizeof(unsigned int));
+    res.agents_viruses = n * sizeof(Virus<TSeq>);
+    res.agents_tools   = n * ntools * (sizeof(ToolPtr<TSeq>) + sizeof(Tool<TSeq>));
+
+    res.network = (n + 1u) * sizeof(size_t) +
+        2u * nties * sizeof(epiworld_agent_index);
+    res.queue   = n * (sizeof(epiworld_fast_int) + sizeof(size_t)) +
+        (n + 7u) / 8u;
+
+    res.db_today = (nviruses + ntools + 1u) * nstates * sizeof(int);
+    res.db_hist_virus      = nrecords * nviruses * nstates * nrow;
+    res.db_hist_tool       = nrecords * ntools * nstates * nrow;
+    res.db_hist_total      = nrecords * nstates * nrow;
+    res.db_hist_transition = nrecords * nstates * nstates * sizeof(int);
+    res.db_transition      = nstates * nstates * sizeof(int);
+    res.db_transmission    = n * 5u * sizeof(int);
+
+    if (nthreads > 1)
+        res.thread_clones = static_cast< size_t >(nthreads - 1) *
+            (res.total() - res.network);
+
+    return res;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/model-meat-memory.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/tools/vaccine.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_TOOLS_VACCINE_HPP
+#define EPIWORLD_TOOLS_VACCINE_HPP
+
+#include <memory>
+#include <vector>
+#include <cassert>
+// (already included include/epiworld/tools/../config.hpp)
+// (already included include/epiworld/tools/../tool-bones.hpp)
+
+/**
+ * @brief Template for a common vaccine
+ * 
+ * The main difference with a regular tool is that the reduction
+ * in susceptibility is at the agent level and fixed for the
+ * entire simulation. In other words, if the efficacy is 65%,
+ * then 65% of the agents that receive the vaccine will be fully
+ * protected (100% reduction in susceptibility) and 35% will not be
+ * protected at all (0% reduction in susceptibility).
+ * 
+ * @ingroup tools
+ * 
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ToolVaccine: public Tool<TSeq> {
+private:
+
+    int _immune = -1;
+    epiworld_double _efficacy = 0.0;
+    epiworld_double _set_immunity(Model<TSeq> & model);
+
+public:
+    ToolVaccine(std::string name = "Vaccine") : Tool<TSeq>(name) {};
+
+    virtual epiworld_double get_susceptibility_reduction(
+        VirusPtr<TSeq> & v,
+        Model<TSeq> * model
+    ) override;
+    
+    virtual void set_susceptibility_reduction_fun(ToolFun<TSeq> fun) override;
+    virtual void set_susceptibility_reduction(std::string param) override;
+    virtual void set_susceptibility_reduction(epiworld_double prob) override;
+
+    std::unique_ptr<Tool<TSeq>> clone_ptr() const override;
+
+};
+
+template<typename TSeq>
+inline epiworld_double ToolVaccine<TSeq>::get_susceptibility_reduction(
+    VirusPtr<TSeq> &,
+    Model<TSeq> * model
+)
+{
+
+    // Updating a single agent (if needed)
+    if (_immune == -1)
+    {
+        _set_immunity(*model);
+    }
+
+    return  (_immune == 1) ? 1.0 : 0.0;
+
+}
+
+template<typename TSeq>
+inline void ToolVaccine<TSeq>::set_susceptibility_reduction_fun(
+    ToolFun<TSeq>
+)
+{
+    throw std::logic_error(
+        std::string(
+            "The susceptibility reduction function cannot be set for the "
+         ) +
+        std::string("ToolVaccine (Tool).")
+    );
+}
+
+template<typename TSeq>
+inline void ToolVaccine<TSeq>::set_susceptibility_reduction(std::string)
+{
+    throw std::logic_error(
+        std::string(
+            "The susceptibility reduction probability cannot be set for the "
+        ) +
+        std::string(
+            "ToolVaccine (Tool) using a pointer. Use the version that takes a "
+        ) +
+        std::string("double instead.")
+    );
+}
+
+template<typename TSeq>
+inline void ToolVaccine<TSeq>::set_susceptibility_reduction(epiworld_double prob)
+{
+
+    // assertm(prob >= 0 && prob <= 1, "The efficacy must be between 0 and 1.");
+    _efficacy = prob;
+
+}
+
+template<typename TSeq>
+inline epiworld_double ToolVaccine<TSeq>::_set_immunity(Model<TSeq> & model)
+{
+    _immune = (model.runif() < _efficacy) ? 1 : 0;
+    return _immune;
+}
+
+template<typename TSeq>
+inline std::unique_ptr<Tool<TSeq>> ToolVaccine<TSeq>::clone_ptr() const
+{
+    auto ans =  std::make_unique<ToolVaccine<TSeq>>(*this);
+    ans->_immune = -1;
+    return ans;
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/tools/vaccine.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/globalevents/quarantinetrigger-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef QUARANTINETRIGGER_MEAT_HPP
+#define QUARANTINETRIGGER_MEAT_HPP
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/globalevents/quarantinetrigger-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef QUARANTINETRIGGER_BONES_HPP
+#define QUARANTINETRIGGER_BONES_HPP
+
+#include <vector>
+// (already included include/epiworld/globalevents/../config.hpp)
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class QuarantineTrigger {
+private:
+    int _model_sim_id = -1;
+    int _day = -1;
+    std::vector< size_t > _agents_triggering_quarantine;
+    std::vector< int > _date_infectious;
+    
+    void _setup(const Model<TSeq> & model);
+public:
+    QuarantineTrigger() = default;
+    void add_triggering_agent(
+        const Model<TSeq> & model,
+        const Agent<TSeq> & agent,
+        int date_infectious
+    );
+
+    std::vector< size_t > & get_triggering_agents();
+    std::vector< int > & get_date_infectious();
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/globalevents/quarantinetrigger-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+template<typename TSeq>
+inline void QuarantineTrigger<TSeq>::_setup(const Model<TSeq> & model) {
+
+    if (
+        (static_cast<int>(model.get_sim_id()) != _model_sim_id) ||
+        (static_cast<int>(model.today()) != _day)
+    ) {
+        _model_sim_id = static_cast<int>(model.get_sim_id());
+        _day = static_cast<int>(model.today());
+        _agents_triggering_quarantine.clear();
+        _date_infectious.clear();
+    }
+
+}
+
+template<typename TSeq>
+inline void QuarantineTrigger<TSeq>::add_triggering_agent(
+    const Model<TSeq> & model,
+    const Agent<TSeq> & agent,
+    int date_infectious
+) {
+    
+    // Ensuring we are not in a different run
+    _setup(model);
+    this->_agents_triggering_quarantine.push_back(agent.get_id());
+    this->_date_infectious.push_back(date_infectious);
+}
+
+template<typename TSeq>
+inline std::vector< size_t > & QuarantineTrigger<TSeq>::get_triggering_agents() {
+    return this->_agents_triggering_quarantine;
+}
+
+template<typename TSeq>
+inline std::vector< int > & QuarantineTrigger<TSeq>::get_date_infectious() {
+    return this->_date_infectious;
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/globalevents/quarantinetrigger-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+    
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/models/models.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_HPP
+#define EPIWORLD_MODELS_HPP
+
+/**
+ * @defgroup epi_models Epidemiological Models
+ * @brief Collection of predefined epidemiological models for disease simulation
+ * 
+ * This module provides a comprehensive collection of epidemiological models commonly 
+ * used in disease simulation and modeling. The models range from basic compartmental 
+ * models to specialized scenarios including connected populations, population mixing, 
+ * quarantine measures, and disease-specific implementations.
+ * 
+ * **Implementation details:**
+ * <a href="../impl/core-simulation-models.md">Core Simulation Models</a>,
+ * <a href="../impl/extending-the-library-with-models.md">Extending the Library with Models</a>
+ */
+
+/**
+ * @defgroup basic_compartmental Basic Compartmental Models
+ * @ingroup epi_models
+ * @brief Fundamental compartmental models (SIS, SIR, SEIR)
+ * 
+ * These are the foundational compartmental models in epidemiology that divide 
+ * populations into distinct states based on disease status.
+ * 
+ * **Implementation details:**
+ * <a href="../impl/core-simulation-models.md">Core Simulation Models</a>
+ */
+
+/**
+ * @defgroup death_compartmental Models with Death Compartment
+ * @ingroup epi_models
+ * @brief Models that include a death state (SIRD, SISD, SEIRD)
+ * 
+ * Extended compartmental models that explicitly track mortality as a separate 
+ * compartment in the disease progression.
+ * 
+ * **Implementation details:**
+ * <a href="../impl/core-simulation-models.md">Core Simulation Models</a>
+ */
+
+/**
+ * @defgroup connected_models Connected Population Models
+ * @ingroup epi_models
+ * @brief Models for connected populations (SIRConnected, SEIRConnected, SIRDConnected, SEIRDConnected)
+ * 
+ * Models designed for populations with explicit network connections between individuals, 
+ * allowing for more realistic contact patterns.
+ * 
+ * **Implementation details:**
+ * <a href="../impl/core-simulation-models.md">Core Simulation Models</a>
+ */
+
+/**
+ * @defgroup mixing_models Population Mixing Models
+ * @ingroup epi_models
+ * @brief Models with population mixing (SEIRMixing, SIRMixing)
+ * 
+ * Models that incorporate heterogeneous mixing patterns between different population 
+ * groups or entities, often using contact matrices.
+ * 
+ * **Implementation details:**
+ * <a href="../impl/mixing-and-entity-distribution.md">Mixing and Entity Distribution</a>,
+ * <a href="../impl/sampling-contacts.md">Sampling Contacts</a>
+ */
+
+/**
+ * @defgroup disease_specific Disease-Specific Models
+ * @ingroup epi_models
+ * @brief Models tailored for specific diseases (Measles variants, Cholera)
+ * 
+ * Specialized implementations designed to capture the unique transmission dynamics 
+ * and characteristics of specific infectious diseases.
+ * 
+ * **Implementation details:**
+ * <a href="../impl/core-simulation-models.md">Core Simulation Models</a>,
+ * <a href="../impl/quarantine-isolation-and-contact-tracing.md">Quarantine, Isolation, and Contact Tracing</a>
+ */
+
+/**
+ * @defgroup special_models Specialized Models
+ * @ingroup epi_models
+ * @brief Other specialized models (DiffNet, SIRLogit, Surveillance)
+ * 
+ * Models for specific scenarios including diffusion networks, logistic regression-based 
+ * transmission, and surveillance systems.
+ */
+
+/**
+ * @defgroup model_utilities Model Utilities
+ * @ingroup epi_models
+ * @brief Utility functions for model initialization and global events
+ * 
+ * Helper functions and global event handlers that can be used across different 
+ * epidemiological models for initialization and event management.
+ * 
+ * **Implementation details:**
+ * <a href="../impl/events-and-multi-event-handling.md">Events and Multi-Event Handling</a>,
+ * <a href="../impl/extending-the-library.md">Extending the Library</a>
+ */
+
+/**
+ * @namespace epimodels
+ * @brief Namespace containing predefined epidemiological models and related functions
+ * @ingroup epi_models
+ * 
+ * This namespace provides a collection of epidemiological models commonly used in
+ * disease simulation and modeling. It includes various compartmental models such as
+ * SIS, SIR, SEIR, and their variations, as well as specialized models for specific
+ * scenarios like connected populations, quarantine measures, and school environments.
+ * 
+ * The namespace also contains initialization functions, global event handlers, and
+ * surveillance mechanisms that can be used across different epidemiological models.
+ * 
+ * Available model categories include:
+ * 
+ *   - Basic compartmental models (SIS, SIR, SEIR)
+ *   - Models with death compartments (SIRD, SISD, SEIRD)
+ *   - Connected population models (SIRConnected, SEIRConnected, SIRDConnected, SEIRDConnected)
+ *   - Logistic regression models (SIRLogit)
+ *   - Mixing population models (SEIRMixing, SIRMixing)
+ *   - Quarantine models (SEIRMixingQuarantine)
+ *   - School-specific models (MeaslesSchool)
+ *   - Disease-specific models (MeaslesMixing, MeaslesMixingRiskQuarantine)
+ *   - Diffusion network models (DiffNet)
+ *   - Surveillance systems
+ * 
+ */
+namespace epimodels {
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/init-functions.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_INIT_FUNCTIONS_HPP
+#define EPIWORLD_MODELS_INIT_FUNCTIONS_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+/**
+ * @brief Creates an initial function for the SIR-like models
+ * @ingroup model_utilities
+ * 
+ * The function is used for the initial states of the model.
+*/
+template<typename TSeq>
+inline std::function<void(Model<TSeq>*)> create_init_function_sir(
+    std::vector< double > proportions_
+) {
+
+    // Checking widths
+    if (proportions_.size() != 1u)
+        throw std::invalid_argument(
+            "The vector of proportions must have a single element."
+            );
+
+    // Proportion should be within [0, 1]
+    if ((proportions_[0] < 0.0) || (proportions_[0] > 1.0))
+        throw std::invalid_argument(
+            "The proportion must be within (0, 1)."
+            );
+
+    double prop = proportions_[0u];
+
+    std::function<void(Model<TSeq>*)> fun =
+    [prop] (Model<TSeq> * model) -> void {
+
+        // Figuring out information about the viruses
+        double tot = 0.0;
+        double n   = static_cast<double>(model->size());
+        for (const auto & agent: model->get_agents())
+        {
+            if (agent.get_virus() != nullptr)
+                tot += 1.0;
+        }
+        tot /= n;
+
+        // Putting the total into context
+        double tot_left = 1.0 - tot;
+
+        // Since susceptible and infected are "fixed,"
+        // we only need to change recovered
+        size_t nrecovered = prop * tot_left * n;
+        
+        AgentsSample<TSeq> sample(
+            *model,
+            nrecovered,
+            {0u},
+            true
+            );
+
+        // Setting up the initial states
+        for (auto & agent : sample)
+            agent->change_state(*model, 2, Queue<TSeq>::NoOne);
+
+        // Running the events
+        model->events_run();
+
+        return;
+
+    };
+
+    return fun;
+
+}
+
+/**
+ * @brief Creates an initial function for the SIR-like models
+ * @ingroup model_utilities
+ *
+ * The function is used for the initial states of the model.
+*/
+template<typename TSeq>
+inline std::function<void(Model<TSeq>*)> create_init_function_sird(
+    std::vector< double > prop
+) {
+
+    // Check length of prop equals two
+    if (prop.size() != 2u)
+        throw std::invalid_argument(
+            "The vector of proportions must have two elements."
+            );
+
+    // Check elements in prop are within [0, 1] and sum up to 1
+    double tot = 0.0;
+    for (auto & v : prop)
+    {
+        if ((v < 0.0) || (v > 1.0))
+            throw std::invalid_argument(
+                "The proportion must be within (0, 1)."
+                );
+        tot += v;
+    }
+
+    if (tot >= 1.0)
+        throw std::invalid_argument(
+            "The proportions must sum up to 1."
+            );
+
+    std::function<void(Model<TSeq>*)> fun =
+    [prop] (Model<TSeq> * model) -> void {
+
+        // Figuring out information about the viruses
+        double tot = 0.0;
+        double n   = static_cast<double>(model->size());
+        for (const auto & agent: model->get_agents())
+        {
+            if (agent.get_virus() != nullptr)
+                tot += 1.0;
+        }
+        tot /= n;
+
+        // Putting the total into context
+        double tot_left = 1.0 - tot;
+
+        // Since susceptible and infected are "fixed,"
+        // we only need to change recovered
+        size_t nrecovered = prop[0u] * tot_left * n;
+        size_t ndeceased  = prop[01] * tot_left * n;
+
+        AgentsSample<TSeq> sample_recover(
+            *model,
+            nrecovered,
+            {0u},
+            true
+            );
+
+        // Setting up the initial states
+        for (auto & agent : sample_recover)
+            agent->change_state(*model, 2, Queue<TSeq>::NoOne);
+
+        AgentsSample<TSeq> sample_deceased(
+            *model,
+            ndeceased,
+            {0u},
+            true
+            );
+
+        // Setting up the initial states
+        for (auto & agent : sample_deceased)
+            agent->change_state(*model, 3, Queue<TSeq>::NoOne);
+        
+        // Running the events
+        model->events_run();
+
+        return;
+
+    };
+
+    return fun;
+
+}
+
+
+/**
+ * @brief Creates an initial function for the SEIR-like models
+ * @ingroup model_utilities
+ * 
+ * The function is used for the initial states of the model.
+*/
+template<typename TSeq>
+inline std::function<void(Model<TSeq>*)> create_init_function_seir(
+    std::vector< double > proportions_
+) {
+
+    // Checking widths
+    if (proportions_.size() != 2u) {
+        throw std::invalid_argument("-proportions_- must have two entries.");
+    }
+
+    // proportions_ are values between 0 and 1, otherwise error
+    for (auto & v : proportions_)
+        if ((v < 0.0) || (v > 1.0))
+            throw std::invalid_argument(
+                "-proportions_- must have values between 0 and 1."
+                );
+
+
+    std::function<void(Model<TSeq>*)> fun = 
+        [proportions_] (Model<TSeq> * model) -> void {
+
+        // Figuring out information about the viruses
+        double tot = 0.0;
+        double n   = static_cast<double>(model->size());
+        for (const auto & agent: model->get_agents())
+        {
+            if (agent.get_virus() != nullptr)
+                tot += 1.0;
+        }
+        tot /= n;
+
+        // Putting the total into context
+        double tot_left = 1.0 - tot;
+
+        // Since susceptible and infected are "fixed,"
+        // we only need to change recovered
+        size_t nexposed   = proportions_[0u] * tot * n;
+        size_t nrecovered = proportions_[1u] * tot_left * n;
+        
+        AgentsSample<TSeq> sample_suscept(
+            *model,
+            nrecovered,
+            {0u},
+            true
+            );
+
+        // Setting up the initial states
+        for (auto & agent : sample_suscept)
+            agent->change_state(*model, 3, Queue<TSeq>::NoOne);
+
+        AgentsSample<TSeq> sample_exposed(
+            *model,
+            nexposed,
+            {1u},
+            true
+            );
+
+        // Setting up the initial states
+        for (auto & agent : sample_exposed)
+            agent->change_state(*model, 2, Queue<TSeq>::NoOne);
+
+        // Running the events
+        model->events_run();
+
+        return;
+
+    };
+
+    return fun;
+
+}
+
+/**
+ * @brief Creates an initial function for the SEIR-like models
+ * @ingroup model_utilities
+ *
+ * The function is used for the initial states of the model.
+*/
+template<typename TSeq>
+inline std::function<void(Model<TSeq>*)> create_init_function_seird(
+    std::vector< double > proportions_
+) {
+
+    // Checking widths
+    if (proportions_.size() != 3u) {
+        throw std::invalid_argument("-proportions_- must have three entries.");
+    }
+
+    // proportions_ are values between 0 and 1, otherwise error
+    for (auto & v : proportions_)
+        if ((v < 0.0) || (v > 1.0))
+            throw std::invalid_argument(
+                "-proportions_- must have values between 0 and 1."
+                );
+
+    // Last first two terms shouldn't add up to more than 1
+    if ((proportions_[1u] + proportions_[2u]) > 1.0)
+        throw std::invalid_argument(
+            "The last two terms of -proportions_- must add up to less than 1."
+            );
+
+    std::function<void(Model<TSeq>*)> fun = 
+        [proportions_] (Model<TSeq> * model) -> void {
+
+        // Figuring out information about the viruses
+        double tot = 0.0;
+        double n   = static_cast<double>(model->size());
+
+        for (const auto & agent: model->get_agents())
+        {
+            if (agent.get_virus() != nullptr)
+                tot += 1.0;
+        }
+        tot /= n;
+
+        // Putting the total into context
+        double tot_left = 1.0 - tot;
+
+        // Since susceptible and infected are "fixed,"
+        // we only need to change recovered
+        size_t nexposed   = proportions_[0u] * tot * n;
+        size_t nrecovered = proportions_[1u] * tot_left * n;
+        size_t ndeceased  = proportions_[2u] * tot_left * n;
+        
+        AgentsSample<TSeq> sample_suscept(
+            *model,
+            nrecovered,
+            {0u},
+            true
+            );
+
+        // Setting up the initial states
+        for (auto & agent : sample_suscept)
+            agent->change_state(*model, 3, Queue<TSeq>::NoOne);
+
+        AgentsSample<TSeq> sample_exposed(
+            *model,
+            nexposed,
+            {1u},
+            true
+            );
+
+        // Setting up the initial states
+        for (auto & agent : sample_exposed)
+            agent->change_state(*model, 2, Queue<TSeq>::NoOne);
+
+        // Running the events
+        model->events_run();
+
+        // Setting the initial states for the deceased
+        AgentsSample<TSeq> sample_deceased(
+            *model,
+            ndeceased,
+            {0u},
+            true
+            );
+
+        // Setting up the initial states
+        for (auto & agent : sample_deceased)
+            agent->change_state(*model, 4, Queue<TSeq>::NoOne);
+        
+        // Running the events
+        model->events_run();
+
+        return;
+
+    };
+
+    return fun;
+
+}
+
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/init-functions.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/globalevents.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_GLOBALEVENTS_HPP
+#define EPIWORLD_GLOBALEVENTS_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+// This function creates a global action that distributes a tool
+// to agents with probability p.
+/**
+ * @brief Global event that distributes a tool to agents with probability p.
+ * @ingroup model_utilities
+ * 
+ * @tparam TSeq Sequence type (should match `TSeq` across the model)
+ * @param p Probability of distributing the tool.
+ * @param tool Tool function.
+ * @return std::function<void(Model<TSeq>*)> 
+ */
+template<typename TSeq>
+inline std::function<void(Model<TSeq>*)> globalevent_tool(
+    Tool<TSeq> & tool,
+    double p
+) {
+
+    std::function<void(Model<TSeq>*)> fun = [p,&tool](
+        Model<TSeq> * model
+        ) -> void {
+
+        for (auto & agent : model->get_agents())
+        {
+
+            // Check if the agent has the tool
+            if (agent.has_tool(tool))
+                continue;
+
+            // Adding the tool
+            if (model->runif() < p)
+                agent.add_tool(*model, tool);
+            
+        
+        }
+
+        #ifdef EPIWORLD_DEBUG
+        tool.print();
+        #endif
+
+        return;
+            
+
+    };
+
+    return fun;
+
+}
+
+// Same function as above, but p is now a function of a vector of coefficients
+// and a vector of variables.
+/**
+ * @brief Global event that distributes a tool to agents with probability
+ * p = 1 / (1 + exp(-\sum_i coef_i * agent(vars_i))).
+ * @ingroup model_utilities
+ * 
+ * @tparam TSeq Sequence type (should match `TSeq` across the model)
+ * @param coefs Vector of coefficients.
+ * @param vars Vector of variables.
+ * @param tool_fun Tool function.
+ * @return std::function<void(Model<TSeq>*)> 
+ */
+template<typename TSeq>
+inline std::function<void(Model<TSeq>*)> globalevent_tool_logit(
+    Tool<TSeq> & tool,
+    std::vector< size_t > vars,
+    std::vector< double > coefs
+) {
+
+    std::function<void(Model<TSeq>*)> fun = [coefs,vars,&tool](
+        Model<TSeq> * model
+        ) -> void {
+
+        for (auto & agent : model->get_agents())
+        {
+
+            // Check if the agent has the tool
+            if (agent.has_tool(tool))
+                continue;
+
+            // Computing the probability using a logit. Uses OpenMP reduction
+            // to sum the coefficients.
+            double p = 0.0;
+            #if defined(__OPENMP) || defined(_OPENMP)
+            #pragma omp parallel for reduction(+:p)
+            #endif
+            for (size_t i = 0u; i < coefs.size(); ++i)
+                p += coefs.at(i) * agent(vars[i], *model);
+
+            p = 1.0 / (1.0 + std::exp(-p));
+
+            // Adding the tool
+            if (model->runif() < p)
+                agent.add_tool(*model, tool);
+            
+        
+        }
+
+        #ifdef EPIWORLD_DEBUG
+        tool.print();
+        #endif
+
+        return;
+            
+
+    };
+
+    return fun;
+
+}
+
+// A global action that updates a parameter in the model.
+/**
+ * @brief Global event that updates a parameter in the model.
+ * @ingroup model_utilities
+ * 
+ * @tparam TSeq Sequence type (should match `TSeq` across the model)
+ * @param param Parameter to update.
+ * @param value Value to update the parameter to.
+ * @return std::function<void(Model<TSeq>*)> 
+ */
+template<typename TSeq>
+inline std::function<void(Model<TSeq>*)> globalevent_set_param(
+    std::string param,
+    double value
+) {
+
+    std::function<void(Model<TSeq>*)> fun = [value,param](
+        Model<TSeq> * model
+        ) -> void {
+
+        model->set_param(param, value);
+
+        return;
+            
+
+    };
+
+    return fun;
+
+}
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/globalevents.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/sis.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_SIS_HPP 
+#define EPIWORLD_MODELS_SIS_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+/**
+ * @brief Template for a Susceptible-Infected-Susceptible (SIS) model
+ * 
+ * ![Model Diagram](../assets/img/sis.png)
+ * 
+ * @ingroup basic_compartmental
+ * 
+ * @param vname std::string Name of the virus
+ * @param initial_prevalence epiworld_double Initial prevalence
+ * @param initial_efficacy epiworld_double Initial susceptibility_reduction of the immune system
+ * @param initial_recovery epiworld_double Initial recovery_rate rate of the immune system
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSIS : public Model<TSeq>
+{
+
+public:
+
+    static const int SUSCEPTIBLE = 0;
+    static const int INFECTED    = 1;
+
+    ModelSIS() = delete;
+
+    ModelSIS(
+        const std::string & vname,
+        epiworld_double prevalence,
+        epiworld_double transmission_rate,
+        epiworld_double recovery_rate
+    );
+
+};
+
+template<typename TSeq>
+inline ModelSIS<TSeq>::ModelSIS(
+    const std::string & vname,
+    epiworld_double prevalence,
+    epiworld_double transmission_rate,
+    epiworld_double recovery_rate
+    )
+{
+
+    this->set_name("Susceptible-Infected-Susceptible (SIS)");
+
+    // Adding statuses
+    this->add_state("Susceptible", default_update_susceptible<TSeq>);
+    this->add_state("Infected", default_update_exposed<TSeq>);
+
+    // Setting up parameters
+    this->add_param(transmission_rate, "Transmission rate");
+    this->add_param(recovery_rate, "Recovery rate");
+
+    // Preparing the virus -------------------------------------------
+    Virus<TSeq> virus(vname, prevalence, true);
+    virus.set_state(INFECTED, SUSCEPTIBLE, SUSCEPTIBLE);
+    
+    virus.set_prob_infecting("Transmission rate");
+    virus.set_prob_recovery("Recovery rate");
+    virus.set_prob_death(0.0);
+    
+    this->add_virus(virus);
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/sis.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/sir.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_SIR_H 
+#define EPIWORLD_SIR_H
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+/**
+ * @brief Template for a Susceptible-Infected-Removed (SIR) model
+ * 
+ * ![Model Diagram](../assets/img/sir.png)
+ * 
+ * @ingroup basic_compartmental
+ * 
+ * @param model A Model<TSeq> object where to set up the SIR.
+ * @param vname std::string Name of the virus
+ * @param initial_prevalence epiworld_double Initial prevalence
+ * @param initial_efficacy epiworld_double Initial susceptibility_reduction of the immune system
+ * @param initial_recovery epiworld_double Initial recovery_rate rate of the immune system
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSIR : public Model<TSeq>
+{
+public:
+
+    ModelSIR() = delete;
+
+    ModelSIR(
+        const std::string & vname,
+        epiworld_double prevalence,
+        epiworld_double transmission_rate,
+        epiworld_double recovery_rate
+    );
+
+    /**
+     * @brief Set the initial states of the model
+     * @param proportions_ Double vector with a single element:
+     * - The proportion of non-infected individuals who have recovered.
+    */
+    ModelSIR<TSeq> & initial_states(
+        std::vector< double > proportions_,
+        std::vector< int > queue_ = {}
+    ) override;
+
+    /**
+     * @brief Runs the built-in states without `std::function` calls
+     * @return false if any state function was replaced by the user.
+     */
+    bool update_state_static() override;
+    
+};
+
+template<typename TSeq>
+inline bool ModelSIR<TSeq>::update_state_static()
+{
+    return this->template update_state_table<
+        default_update_susceptible<TSeq>,
+        default_update_exposed<TSeq>,
+        nullptr
+        >();
+}
+
+template<typename TSeq>
+inline ModelSIR<TSeq>::ModelSIR(
+    const std::string & vname,
+    epiworld_double prevalence,
+    epiworld_double transmission_rate,
+    epiworld_double recovery_rate
+    )
+{
+
+    // Adding statuses
+    this->add_state("Susceptible", default_update_susceptible<TSeq>);
+    this->add_state("Infected", default_update_exposed<TSeq>);
+    this->add_state("Recovered");
+
+    // Setting up parameters
+    this->add_param(recovery_rate, "Recovery rate");
+    this->add_param(transmission_rate, "Transmission rate");
+
+    // Preparing the virus -------------------------------------------
+    Virus<TSeq> virus(vname, prevalence, true);
+    virus.set_state(1,2,2);
+    
+    virus.set_prob_recovery("Recovery rate");
+    virus.set_prob_infecting("Transmission rate");
+    
+    this->add_virus(virus);
+
+    this->set_name("Susceptible-Infected-Recovered (SIR)");
+   
+}
+
+template<typename TSeq>
+inline ModelSIR<TSeq> & ModelSIR<TSeq>::initial_states(
+    std::vector< double > proportions_,
+    std::vector< int > /* queue_ */
+) {
+
+    Model<TSeq>::initial_states_fun =
+        create_init_function_sir<TSeq>(proportions_)
+        ;
+
+    return *this;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/sir.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/seir.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_SEIR_HPP
+#define EPIWORLD_MODELS_SEIR_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+/**
+ * @brief Template for a Susceptible-Exposed-Infected-Removed (SEIR) model
+ * 
+ * ![Model Diagram](../assets/img/seir.png)
+ * 
+ * @ingroup basic_compartmental
+ *
+ * @param model A Model<TSeq> object where to set up the SIR.
+ * @param vname std::string Name of the virus
+ * @param prevalence epiworld_double Initial prevalence the immune system
+ * @param transmission_rate epiworld_double Transmission rate of the virus
+ * @param avg_incubation_days epiworld_double Average incubation days of the virus.
+ * @param recovery_rate epiworld_double Recovery rate of the virus.
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSEIR : public Model<TSeq>
+{
+
+public:
+    static const int SUSCEPTIBLE = 0;
+    static const int EXPOSED     = 1;
+    static const int INFECTED    = 2;
+    static const int REMOVED     = 3;
+
+    ModelSEIR() = delete;
+
+    ModelSEIR(
+        const std::string & vname,
+        epiworld_double prevalence,
+        epiworld_double transmission_rate,
+        epiworld_double avg_incubation_days,
+        epiworld_double recovery_rate
+    );
+
+    static void update_exposed_seir(
+        Agent<TSeq> * p,
+        Model<TSeq> * m
+    ) {
+
+        // Getting the virus
+        auto v = p->get_virus();
+
+        // Does the agent become infected?
+        if (m->runif() < 1.0/(v->get_incubation(m)))
+            p->change_state(*m, ModelSEIR<TSeq>::INFECTED);
+
+        return;
+    }
+
+
+    static void update_infected_seir(
+        Agent<TSeq> * p,
+        Model<TSeq> * m
+    ) {
+        static const size_t par_recovery_rate =
+            Model<TSeq>::param_id("Recovery rate");
+
+        // Does the agent recover?
+        if (m->runif() < (m->par(par_recovery_rate)))
+            p->rm_virus(*m);
+
+        return;
+    }
+
+    /**
+     * @brief Set up the initial states of the model.
+     * @param proportions_ Double vector with the following values:
+     * - 0: Proportion of non-infected agents who are removed.
+     * - 1: Proportion of exposed agents to be set as infected.
+    */
+    ModelSEIR<TSeq> & initial_states(
+        std::vector< double > proportions_,
+        std::vector< int > queue_ = {}
+    ) override;
+
+    /**
+     * @brief Runs the built-in states without `std::function` calls
+     * @return false if any state function was replaced by the user.
+     */
+    bool update_state_static() override;
+
+};
+
+template<typename TSeq>
+inline bool ModelSEIR<TSeq>::update_state_static()
+{
+    return this->template update_state_table<
+        default_update_susceptible<TSeq>,
+        update_exposed_seir,
+        update_infected_seir,
+        nullptr
+        >();
+}
+
+
+template<typename TSeq>
+inline ModelSEIR<TSeq>::ModelSEIR(
+    const std::string & vname,
+    epiworld_double prevalence,
+    epiworld_double transmission_rate,
+    epiworld_double avg_incubation_days,
+    epiworld_double recovery_rate
+    )
+{
+
+    // Adding statuses
+    this->add_state("Susceptible", default_update_susceptible<TSeq>);
+    this->add_state("Exposed", this->update_exposed_seir);
+    this->add_state("Infected", this->update_infected_seir);
+    this->add_state("Removed");
+
+    // Setting up parameters
+    this->add_param(transmission_rate, "Transmission rate");
+    this->add_param(avg_incubation_days, "Incubation days");
+    this->add_param(recovery_rate, "Recovery rate");
+
+    // Preparing the virus -------------------------------------------
+    Virus<TSeq> virus(vname, prevalence, true);
+    virus.set_state(EXPOSED, REMOVED, REMOVED);
+
+    virus.set_prob_infecting("Transmission rate");
+    virus.set_incubation("Incubation days");
+    virus.set_prob_recovery("Recovery rate");
+
+    // Adding the tool and the virus
+    this->add_virus(virus);
+
+    this->set_name("Susceptible-Exposed-Infected-Removed (SEIR)");
+
+}
+
+template<typename TSeq>
+inline ModelSEIR<TSeq> & ModelSEIR<TSeq>::initial_states(
+    std::vector< double > proportions_,
+    std::vector< int > /**/
+) {
+
+    Model<TSeq>::initial_states_fun =
+        create_init_function_seir<TSeq>(proportions_)
+        ;
+
+    return *this;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/seir.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/surveillance.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_SURVEILLANCE_HPP
+#define EPIWORLD_MODELS_SURVEILLANCE_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+/**
+ * @brief Template for a Surveillance model
+ * @ingroup special_models
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSURV : public Model<TSeq> {
+
+private:
+    void write_checkpoint_derived(std::ostream & out) const override;
+    void read_checkpoint_derived(std::istream & in) override;
+
+public:
+    // state
+    static constexpr int SUSCEPTIBLE           = 0;
+    static constexpr int LATENT                = 1;
+    static constexpr int SYMPTOMATIC           = 2;
+    static constexpr int SYMPTOMATIC_ISOLATED  = 3; // sampled and discovered
+    static constexpr int ASYMPTOMATIC          = 4;
+    static constexpr int ASYMPTOMATIC_ISOLATED = 5;
+    static constexpr int RECOVERED             = 6;
+    static constexpr int REMOVED               = 7;
+
+    /**
+     * @brief Vector of days spent in latent and infectious states
+     * A row-major matrix
+     */
+    std::vector< epiworld_double > days_latent_and_infectious;
+
+    /**
+     * @name Construct a new ModelSURV object
+     * 
+     * The ModelSURV class simulates a survaillence model where agents can be
+     * isolated, even if asyptomatic.
+     * 
+     * @param vname String. Name of the virus
+     * @param prevalence Integer. Number of initial cases of the virus.
+     * @param efficacy_vax Double. Efficacy of the vaccine (1 - P(acquire the disease)).
+     * @param latent_period Double. Shape parameter of a `Gamma(latent_period, 1)`
+     *   distribution. This coincides with the expected number of latent days.
+     * @param infect_period Double. Shape parameter of a `Gamma(infected_period, 1)`
+     *   distribution. This coincides with the expected number of infectious days.
+     * @param prob_symptoms Double. Probability of generating symptoms.
+     * @param prop_vaccinated Double. Probability of vaccination. Coincides with
+     *   the initial prevalence of vaccinated individuals.
+     * @param prop_vax_redux_transm Double. Factor by which the vaccine reduces
+     *   transmissibility.
+     * @param prop_vax_redux_infect Double. Factor by which the vaccine reduces
+     *   the chances of becoming infected.
+     * @param surveillance_prob Double. Probability of testing an agent.
+     * @param prob_transmission Double. Raw transmission probability.
+     * @param prob_death Double. Raw probability of death for symptomatic individuals.
+     * @param prob_noreinfect Double. Probability of no re-infection.
+     * 
+     * @details
+     * This model features the following states:
+     * 
+     * - Susceptible
+     * - Latent
+     * - Symptomatic
+     * - Symptomatic isolated
+     * - Asymptomatic
+     * - Asymptomatic isolated
+     * - Recovered
+     * - Removed    
+     * 
+     * @returns An object of class `epiworld_surv`
+     * 
+     */
+    ///@{
+    ModelSURV() = delete;
+
+    ModelSURV(
+        const std::string & vname,
+        epiworld_fast_uint prevalence         = 50,
+        epiworld_double efficacy_vax          = 0.9,
+        epiworld_double latent_period         = 3u,
+        epiworld_double infect_period         = 6u,
+        epiworld_double prob_symptoms         = 0.6,
+        epiworld_double prop_vaccinated       = 0.25,
+        epiworld_double prop_vax_redux_transm = 0.5,
+        epiworld_double prop_vax_redux_infect = 0.5,
+        epiworld_double surveillance_prob     = 0.001,
+        epiworld_double prob_transmission     = 1.0,
+        epiworld_double prob_death            = 0.001,
+        epiworld_double prob_noreinfect       = 0.9
+    );
+    ///@}
+
+    void reset() override;
+
+};
+
+template<typename TSeq>
+inline void ModelSURV<TSeq>::write_checkpoint_derived(std::ostream & out) const
+{
+
+    checkpoint_write(out, days_latent_and_infectious);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSURV<TSeq>::read_checkpoint_derived(std::istream & in)
+{
+
+    checkpoint_read(in, days_latent_and_infectious);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSURV<TSeq>::reset()
+{
+    Model<TSeq>::reset();
+
+    days_latent_and_infectious.clear();
+    days_latent_and_infectious.resize(
+        2u * this->size(),
+        -1.0
+    );
+}
+
+template<typename TSeq>
+inline ModelSURV<TSeq>::ModelSURV(
+    const std::string & vname,
+    epiworld_fast_uint prevalence,
+    epiworld_double efficacy_vax,
+    epiworld_double latent_period,
+    epiworld_double infect_period,
+    epiworld_double prob_symptoms,
+    epiworld_double prop_vaccinated,
+    epiworld_double prop_vax_redux_transm,
+    epiworld_double,
+    epiworld_double surveillance_prob,
+    epiworld_double prob_transmission,
+    epiworld_double prob_death,
+    epiworld_double prob_noreinfect
+    )
+{
+
+    EPI_NEW_UPDATEFUN_LAMBDA(surveillance_update_susceptible, TSeq) {
+
+        // This computes the prob of getting any neighbor variant
+        epiworld_fast_uint nviruses_tmp = 0u;
+        auto & m_ref = *m;
+        for (auto & neighbor: p->neighbors(*m)) 
+        {
+                    
+            auto & v = neighbor.get_virus();
+
+            if (v == nullptr)
+                continue;
+                
+            /* And it is a function of susceptibility_reduction as well */ 
+            epiworld_double tmp_transmission = 
+                (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
+                v->get_prob_infecting(m) *
+                (1.0 - neighbor.get_transmission_reduction(v, m_ref)) 
+                ; 
+        
+            m->array_double_tmp[nviruses_tmp]  = tmp_transmission;
+            m->array_virus_tmp[nviruses_tmp++] = &(*v);
+        }
+
+        // No virus to compute on
+        if (nviruses_tmp == 0)
+            return;
+
+        // Running the roulette
+        int which = roulette(nviruses_tmp, m);
+
+        if (which < 0)
+            return;
+
+        p->set_virus(*m, *m->array_virus_tmp[which]);
+        return;
+
+    };
+
+
+    UpdateFun<TSeq> surveillance_update_exposed = 
+    [](Agent<TSeq> * p, Model<TSeq> * m) -> void
+    {
+
+        // Dynamically getting the ModelSURV
+        ModelSURV<TSeq> * model_surv = model_cast<ModelSURV<TSeq>,TSeq>(m);
+
+        static const size_t par_latent_period =
+            Model<TSeq>::param_id("Latent period");
+        static const size_t par_infect_period =
+            Model<TSeq>::param_id("Infect period");
+        static const size_t par_prob_symptoms =
+            Model<TSeq>::param_id("Prob of symptoms");
+
+        VirusPtr<TSeq> & v = p->get_virus(); 
+        epiworld_double p_die = v->get_prob_death(m) * (1.0 - p->get_death_reduction(v, *m));
+        
+        epiworld_fast_uint days_since_exposed = m->today() - v->get_date();
+        epiworld_fast_uint state = p->get_state();
+
+        // Figuring out latent period
+        auto & dat = model_surv->days_latent_and_infectious;
+        if (dat[p->get_id()] < 0)
+        {
+            epiworld_double latent_days = m->rgamma(
+                m->par(par_latent_period), 1.0
+            );
+
+            dat[p->get_id() * 2u] = latent_days;
+
+            dat[p->get_id() * 2u + 1u] = 
+                m->rgamma(m->par(par_infect_period), 1.0) +
+                latent_days;
+        }
+        
+        // If still latent, nothing happens
+        if (days_since_exposed <= dat[p->get_id() * 2u])
+            return;
+
+        // If past days infected + latent, then bye.
+        if (days_since_exposed >= dat[p->get_id() * 2u + 1u])
+        {
+            p->rm_virus(*m);
+            return;
+        }
+
+        // If it is infected, then it can be asymptomatic or symptomatic
+        if (state == ModelSURV<TSeq>::LATENT)
+        {
+
+            // Will be symptomatic?
+            if (EPI_RUNIF() < m->par(par_prob_symptoms))
+                p->change_state(*m, ModelSURV<TSeq>::SYMPTOMATIC);
+            else
+                p->change_state(*m, ModelSURV<TSeq>::ASYMPTOMATIC);
+            
+            return;
+
+        }
+        
+        // Otherwise, it can be removed
+        if (EPI_RUNIF() < p_die)
+        {
+            p->change_state(*m, ModelSURV<TSeq>::REMOVED, -1);
+            return;
+        }
+        
+        return;
+
+    };
+
+    std::vector< unsigned int > exposed_state = {
+        SYMPTOMATIC,
+        SYMPTOMATIC_ISOLATED,
+        ASYMPTOMATIC,
+        ASYMPTOMATIC_ISOLATED,
+        LATENT
+    };
+
+    GlobalFun<TSeq> surveillance_program = 
+    [exposed_state](
+        Model<TSeq>* m
+        ) -> void
+    {
+
+        static const size_t par_surveilance_prob =
+            Model<TSeq>::param_id("Surveilance prob.");
+
+        // How many will we find
+        std::binomial_distribution<> bdist(m->size(), m->par(par_surveilance_prob));
+        int nsampled = bdist(*m->get_rand_endgine());
+
+        int to_go = nsampled + 1;
+
+        epiworld_double ndetected        = 0.0;
+        epiworld_double ndetected_asympt = 0.0;
+        
+        auto & pop = m->get_agents();
+        std::vector< bool > sampled(m->size(), false);
+        
+        while (to_go-- > 0)
+        {
+
+            // Who is the lucky one
+            epiworld_fast_uint i = m->runif_index(m->size());
+
+            if (sampled[i])
+                continue;
+
+            sampled[i] = true;
+            Agent<TSeq> * p = &pop[i];
+            
+            // If still exposed for the next term
+            if (IN(p->get_state(), exposed_state ))
+            {
+
+                ndetected += 1.0;
+                if (p->get_state() == ModelSURV<TSeq>::ASYMPTOMATIC)
+                {
+                    ndetected_asympt += 1.0;
+                    p->change_state(*m, ModelSURV<TSeq>::ASYMPTOMATIC_ISOLATED);
+                }
+                else 
+                {
+                    p->change_state(*m, ModelSURV<TSeq>::SYMPTOMATIC_ISOLATED);
+                }
+
+            }
+
+        }
+
+        // Writing the user data
+        std::vector< int > totals;
+        m->get_db().get_today_total(nullptr,&totals);
+        m->add_user_data(
+            {
+                static_cast<epiworld_double>(nsampled),
+                ndetected,
+                ndetected_asympt,
+                static_cast<epiworld_double>(totals[ModelSURV<TSeq>::ASYMPTOMATIC])
+            }
+            );
+
+
+    };
+
+    this->add_state("Susceptible", surveillance_update_susceptible);
+    this->add_state("Latent", surveillance_update_exposed);
+    this->add_state("Symptomatic", surveillance_update_exposed);
+    this->add_state("Symptomatic isolated", surveillance_update_exposed);
+    this->add_state("Asymptomatic", surveillance_update_exposed);
+    this->add_state("Asymptomatic isolated", surveillance_update_exposed);
+    this->add_state("Recovered");
+    this->add_state("Removed");
+
+    // General model parameters
+    this->add_param(latent_period, "Latent period");
+    this->add_param(infect_period, "Infect period");
+    this->add_param(prob_symptoms, "Prob of symptoms");
+    this->add_param(surveillance_prob, "Surveilance prob.");
+    this->add_param(efficacy_vax, "Vax efficacy");
+    this->add_param(prop_vax_redux_transm, "Vax redux transmission");
+    this->add_param(prob_transmission, "Prob of transmission");
+    this->add_param(prob_death, "Prob. death");
+    this->add_param(prob_noreinfect, "Prob. no reinfect");
+
+    // Virus ------------------------------------------------------------------
+    Virus<TSeq> covid(vname, prevalence, false);
+    covid.set_state(LATENT, RECOVERED, REMOVED);
+    covid.set_post_immunity("Prob. no reinfect");
+    covid.set_prob_death("Prob. death");
+
+    VirusFun<TSeq> ptransmitfun = [](
+        Agent<TSeq> * p,
+        Virus<TSeq> &,
+        Model<TSeq> * m
+        ) -> epiworld_double
+    {
+        static const size_t par_prob_transmission =
+            Model<TSeq>::param_id("Prob of transmission");
+
+        // No chance of infecting
+        epiworld_fast_uint  s = p->get_state();
+        if (s == ModelSURV<TSeq>::LATENT)
+            return static_cast<epiworld_double>(0.0);
+        else if (s == ModelSURV<TSeq>::SYMPTOMATIC_ISOLATED)
+            return static_cast<epiworld_double>(0.0);
+        else if (s == ModelSURV<TSeq>::ASYMPTOMATIC_ISOLATED)
+            return static_cast<epiworld_double>(0.0);
+
+        // Otherwise
+        return m->par(par_prob_transmission);
+    };
+
+    covid.set_prob_infecting_fun(ptransmitfun);
+    
+    this->add_virus(covid);
+
+    this->set_user_data({"nsampled", "ndetected", "ndetected_asympt", "nasymptomatic"});
+    this->add_globalevent(surveillance_program, "Surveilance program", -1);
+   
+    // Vaccine tool -----------------------------------------------------------
+    Tool<TSeq> vax("Vaccine", prop_vaccinated, true);
+    vax.set_susceptibility_reduction("Vax efficacy");
+    vax.set_transmission_reduction("Vax redux transmission");
+    
+    this->add_tool(vax);
+
+    this->set_name("Surveillance");
+
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/surveillance.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/sirconnected.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_SIRCONNECTED_HPP 
+#define EPIWORLD_MODELS_SIRCONNECTED_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+/**
+ * @brief Template for a Susceptible-Infected-Removed (SIR) model with connected population
+ * 
+ * ![Model Diagram](../assets/img/sirconnected.png)
+ * 
+ * @ingroup connected_models
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSIRCONN : public Model<TSeq>
+{
+
+private:
+
+    std::vector< Agent<TSeq> * > infected;
+    void update_infected();
+    void read_checkpoint_derived(std::istream & in) override;
+
+    static void _update_susceptible(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_infected(Agent<TSeq> * p, Model<TSeq> * m);
+
+public:
+
+    static const int SUSCEPTIBLE = 0;
+    static const int INFECTED    = 1;
+    static const int RECOVERED   = 2;
+
+    
+    ModelSIRCONN() = delete;
+
+    ModelSIRCONN(
+        const std::string & vname,
+        epiworld_fast_uint n,
+        epiworld_double prevalence,
+        epiworld_double contact_rate,
+        epiworld_double transmission_rate,
+        epiworld_double recovery_rate
+    );
+    
+    void reset() override;
+
+    std::unique_ptr< Model<TSeq> > clone_ptr() override;
+
+    /**
+     * @brief Runs the built-in states without `std::function` calls
+     * @return false if any state function was replaced by the user.
+     */
+    bool update_state_static() override;
+
+    /**
+     * @brief Set the initial states of the model
+     * @param proportions_ Double vector with a single element:
+     * - The proportion of non-infected individuals who have recovered.
+    */
+    ModelSIRCONN<TSeq> & initial_states(
+        std::vector< double > proportions_,
+        std::vector< int > queue_ = {}
+    ) override;
+
+    /**
+     * @brief Get the infected individuals
+     * @return std::vector< Agent<TSeq> * > 
+     */
+    size_t get_n_infected() const
+    {
+        return infected.size();
+    }
+
+    /***
+     * @brief Compute expected generation time
+     * @param max_days Maximum number of days.
+     * @param max_contacts Maximum number of contacts.
+     */
+    std::vector< double > generation_time_expected(
+        int max_days = 200,
+        int max_contacts = 200
+    ) const;
+
+};
+
+template<typename TSeq>
+inline void ModelSIRCONN<TSeq>::update_infected()
+{
+
+    infected.clear();
+    infected.reserve(this->size());
+
+    for (auto & p : this->get_agents())
+    {
+        if (p.get_state() == ModelSIRCONN<TSeq>::INFECTED)
+        {
+            infected.push_back(&p);
+        }
+    }
+
+    Model<TSeq>::set_rand_binom(
+        this->get_n_infected(),
+        static_cast<double>(Model<TSeq>::par("Contact rate"))/
+            static_cast<double>(this->size())
+    );
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSIRCONN<TSeq>::reset()
+{
+
+    Model<TSeq>::reset();
+
+    this->update_infected();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSIRCONN<TSeq>::read_checkpoint_derived(std::istream &)
+{
+
+    this->update_infected();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline std::unique_ptr<Model<TSeq>> ModelSIRCONN<TSeq>::clone_ptr()
+{
+    
+    return std::make_unique<ModelSIRCONN<TSeq>>(*this);
+
+}
+
+template<typename TSeq>
+inline bool ModelSIRCONN<TSeq>::update_state_static()
+{
+    return this->template update_state_table<
+        _update_susceptible, _update_infected, nullptr
+        >();
+}
+
+template<typename TSeq>
+inline void ModelSIRCONN<TSeq>::_update_susceptible(
+    Agent<TSeq> * p, Model<TSeq> * m
+    )
+{
+
+    int ndraw = m->rbinom();
+
+    if (ndraw == 0)
+        return;
+
+    ModelSIRCONN<TSeq> * model = model_cast<ModelSIRCONN<TSeq>,TSeq>(m);
+    int ninfected = static_cast<int>(model->get_n_infected());
+
+    // Drawing from the set
+    int nviruses_tmp = 0;
+    auto & m_ref = *m;
+    for (int i = 0; i < ndraw; ++i)
+    {
+        // Now selecting who is transmitting the disease
+        auto which = m->runif_index(ninfected);
+
+        Agent<TSeq> & neighbor = *model->infected[which];
+
+        // Can't sample itself
+        if (neighbor.get_id() == p->get_id())
+            continue;
+
+        // The neighbor is infected because it is on the list!
+        if (neighbor.get_virus() == nullptr)
+            continue;
+
+        auto & v = neighbor.get_virus();
+
+        #ifdef EPI_DEBUG
+        if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+            throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
+        #endif
+
+        /* And it is a function of susceptibility_reduction as well */ 
+        m->array_double_tmp[nviruses_tmp] =
+            (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
+            v->get_prob_infecting(m) *
+            (1.0 - neighbor.get_transmission_reduction(v, m_ref))
+            ;
+
+        m->array_virus_tmp[nviruses_tmp++] = &(*v);
+
+    }
+
+    // No virus to compute
+    if (nviruses_tmp == 0u)
+        return;
+
+    // Running the roulette
+    int which = roulette(nviruses_tmp, m);
+
+    if (which < 0)
+        return;
+
+    p->set_virus(*m, *m->array_virus_tmp[which]);
+
+    return; 
+
+}
+
+template<typename TSeq>
+inline void ModelSIRCONN<TSeq>::_update_infected(
+    Agent<TSeq> * p, Model<TSeq> * m
+    )
+{
+
+    auto state = p->get_state();
+
+    if (state == ModelSIRCONN<TSeq>::INFECTED)
+    {
+
+
+        // Odd: Die, Even: Recover
+        epiworld_fast_uint n_events = 0u;
+        // Recover
+        m->array_double_tmp[n_events++] = 
+            1.0 - (1.0 - p->get_virus()->get_prob_recovery(m)) *
+                (1.0 - p->get_recovery_enhancer(p->get_virus(), *m));
+
+        #ifdef EPI_DEBUG
+        if (n_events == 0u)
+        {
+            printf_epiworld(
+                "[epi-debug] agent %i has 0 possible events!!\n",
+                static_cast<int>(p->get_id())
+                );
+            throw std::logic_error("Zero events in exposed.");
+        }
+        #else
+        if (n_events == 0u)
+            return;
+        #endif
+
+
+        // Running the roulette
+        int which = roulette(n_events, m);
+
+        if (which < 0)
+            return;
+
+        // Which roulette happen?
+        p->rm_virus(*m);
+
+        return ;
+
+    } else
+        throw std::logic_error(
+            "This function can only be applied to infected individuals. (SIR)"
+            ) ;
+
+    return;
+
+}
+
+/**
+ * @brief Template for a Susceptible-Infected-Removed (SIR) model
+ * 
+ * @param model A Model<TSeq> object where to set up the SIR.
+ * @param vname std::string Name of the virus
+ * @param prevalence Initial prevalence (proportion)
+ * @param contact_rate Average number of contacts (interactions) per step.
+ * @param transmission_rate Probability of transmission
+ * @param recovery_rate Probability of recovery
+ */
+template<typename TSeq>
+inline ModelSIRCONN<TSeq>::ModelSIRCONN(
+    const std::string & vname,
+    epiworld_fast_uint n,
+    epiworld_double prevalence,
+    epiworld_double contact_rate,
+    epiworld_double transmission_rate,
+    epiworld_double recovery_rate
+    // epiworld_double prob_reinfection
+    )
+{
+
+    // state
+    this->add_state("Susceptible", _update_susceptible);
+    this->add_state("Infected", _update_infected);
+    this->add_state("Recovered");
+
+    // Setting up parameters
+    this->add_param(contact_rate, "Contact rate");
+    this->add_param(transmission_rate, "Transmission rate");
+    this->add_param(recovery_rate, "Recovery rate");
+    // this->add_param(prob_reinfection, "Prob. Reinfection");
+
+    // Adding update function
+    GlobalFun<TSeq> update = [](Model<TSeq> * m) -> void
+    {
+        ModelSIRCONN<TSeq> * model = model_cast<ModelSIRCONN<TSeq>,TSeq>(m);
+        model->update_infected();
+        
+        return;
+    };
+
+    this->add_globalevent(update, "Update infected individuals");
+    
+    // Preparing the virus -------------------------------------------
+    Virus<TSeq> virus(vname, prevalence, true);
+    virus.set_state(1, 2, 2);
+    virus.set_prob_infecting("Transmission rate");
+    virus.set_prob_recovery("Recovery rate");
+
+    this->add_virus(virus);
+
+    this->queuing_off(); // No queuing need
+
+    this->agents_empty_graph(n);
+
+    this->set_name("Susceptible-Infected-Removed (SIR) (connected)");
+
+}
+
+template<typename TSeq>
+inline ModelSIRCONN<TSeq> & ModelSIRCONN<TSeq>::initial_states(
+    std::vector< double > proportions_,
+    std::vector< int > /**/ 
+) {
+
+    Model<TSeq>::initial_states_fun = 
+        create_init_function_sir<TSeq>(proportions_)
+        ;
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline std::vector< double > ModelSIRCONN<TSeq>::generation_time_expected(
+    int max_days,
+    int max_contacts
+) const
+{
+
+    // Retrieving total counts
+    std::vector< int > h_date;
+    std::vector< std::string > h_state;
+    std::vector< int > h_counts;
+    const auto this_const = dynamic_cast<const ModelSIRCONN<TSeq> *>(this);
+    this_const->get_db().get_hist_total(
+        &h_date,
+        &h_state,
+        &h_counts
+    );
+
+    // Retrieving information on susceptibles
+    std::vector< double > S(this_const->get_ndays(), 0.0);
+    for (size_t i = 0; i < h_date.size(); ++i)
+    {
+        if (h_state[i] == "Susceptible")
+            S[h_date[i]] += h_counts[i];
+    }
+
+    // The generation time in the SIR model starts from 1, as agents 
+    // spend at least one day in the infected state before starting
+    // transmitting.
+    std::vector< double > gen_times(this_const->get_ndays(), 1.0);
+    double p_c = this_const->par("Contact rate")/this_const->size();
+    double p_i = this_const->par("Transmission rate");
+    double p_r = this_const->par("Recovery rate");
+    for (size_t i = 0u; i < this_const->get_ndays(); ++i)
+    {
+        gen_times[i] = gen_int_mean(
+            S[i],
+            p_c,
+            p_i,
+            p_r,
+            max_days,
+            max_contacts
+        );
+
+    }
+
+    return gen_times;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/sirconnected.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/seirconnected.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_SEIRCONNECTED_HPP
+#define EPIWORLD_MODELS_SEIRCONNECTED_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+/**
+ * @brief Template for a Susceptible-Exposed-Infected-Removed (SEIR) model with connected population
+ * 
+ * ![Model Diagram](../assets/img/seirconnected.png)
+ * 
+ * @ingroup connected_models
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSEIRCONN : public Model<TSeq> 
+{
+private:
+    std::vector< Agent<TSeq> * > infected;
+    void update_infected();
+    void read_checkpoint_derived(std::istream & in) override;
+
+public:
+
+    static const int SUSCEPTIBLE = 0;
+    static const int EXPOSED     = 1;
+    static const int INFECTED    = 2;
+    static const int RECOVERED   = 3;
+
+
+    ModelSEIRCONN() = delete;
+
+    ModelSEIRCONN(
+        const std::string & vname,
+        epiworld_fast_uint n,
+        epiworld_double prevalence,
+        epiworld_double contact_rate,
+        epiworld_double transmission_rate,
+        epiworld_double avg_incubation_days,
+        epiworld_double recovery_rate
+    );
+
+    void reset() override;
+
+    std::unique_ptr< Model<TSeq> > clone_ptr() override;
+
+    /**
+     * @brief Set the initial states of the model
+     * @param proportions_ Double vector with a single element:
+     * - The proportion of non-infected individuals who have recovered.
+    */
+    ModelSEIRCONN<TSeq> & initial_states(
+        std::vector< double > proportions_,
+        std::vector< int > queue_ = {}
+    ) override;
+
+    size_t get_n_infected() const { return infected.size(); }
+
+    /***
+     * @brief Compute expected generation time
+     * @param max_days Maximum number of days.
+     * @param max_contacts Maximum number of contacts.
+     */
+    std::vector< double > generation_time_expected(
+        int max_days = 200,
+        int max_contacts = 200
+    ) const;
+
+};
+
+template<typename TSeq>
+inline void ModelSEIRCONN<TSeq>::update_infected()
+{
+
+    infected.clear();
+    infected.reserve(this->size());
+
+    for (auto & p : this->get_agents())
+    {
+        if (p.get_state() == ModelSEIRCONN<TSeq>::INFECTED)
+        {
+            infected.push_back(&p);
+        }
+    }
+
+    Model<TSeq>::set_rand_binom(
+        this->get_n_infected(),
+        static_cast<double>(Model<TSeq>::par("Contact rate"))/
+            static_cast<double>(this->size())
+    );
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRCONN<TSeq>::reset()
+{
+
+    Model<TSeq>::reset();
+    this->update_infected();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRCONN<TSeq>::read_checkpoint_derived(std::istream &)
+{
+
+    this->update_infected();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline std::unique_ptr<Model<TSeq>> ModelSEIRCONN<TSeq>::clone_ptr()
+{
+    
+    return std::make_unique<ModelSEIRCONN<TSeq>>(*this);
+
+}
+
+/**
+ * @brief Template for a Susceptible-Exposed-Infected-Removed (SEIR) model
+ * 
+ * @param vname std::string Name of the virus
+ * @param prevalence Initial prevalence (proportion)
+ * @param contact_rate Average number of contacts (interactions) per step.
+ * @param transmission_rate Probability of transmission
+ * @param recovery_rate Probability of recovery
+ */
+template<typename TSeq>
+inline ModelSEIRCONN<TSeq>::ModelSEIRCONN(
+    const std::string & vname,
+    epiworld_fast_uint n,
+    epiworld_double prevalence,
+    epiworld_double contact_rate,
+    epiworld_double transmission_rate,
+    epiworld_double avg_incubation_days,
+    epiworld_double recovery_rate
+    // epiworld_double prob_reinfection
+    )
+{
+
+    UpdateFun<TSeq> update_susceptible = [](
+        Agent<TSeq> * p, Model<TSeq> * m
+        ) -> void
+        {
+
+            // Sampling how many individuals
+            int ndraw = m->rbinom();
+
+            if (ndraw == 0)
+                return;
+
+            auto * model = model_cast<ModelSEIRCONN<TSeq>,TSeq>(m);
+            int ninfected = static_cast<int>(model->get_n_infected());
+
+            // Drawing from the set
+            int nviruses_tmp = 0;
+            auto & m_ref = *m;
+            for (int i = 0; i < ndraw; ++i)
+            {
+                // Now selecting who is transmitting the disease
+                auto which = m->runif_index(ninfected);
+
+                Agent<TSeq> & neighbor = *model->infected[which];
+
+                // Can't sample itself
+                if (neighbor.get_id() == p->get_id())
+                    continue;
+
+                // The neighbor is infected by construction
+                auto & v = neighbor.get_virus();
+
+                #ifdef EPI_DEBUG
+                if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+                    throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
+                #endif
+                    
+                /* And it is a function of susceptibility_reduction as well */ 
+                m->array_double_tmp[nviruses_tmp] =
+                    (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
+                    v->get_prob_infecting(m) *
+                    (1.0 - neighbor.get_transmission_reduction(v, m_ref))
+                    ;
+            
+                m->array_virus_tmp[nviruses_tmp++] = &(*v);
+
+            }
+
+            // No virus to compute
+            if (nviruses_tmp == 0u)
+                return;
+
+            // Running the roulette
+            int which = roulette(nviruses_tmp, m);
+
+            if (which < 0)
+                return;
+
+            p->set_virus(*m, 
+                *m->array_virus_tmp[which],
+                ModelSEIRCONN<TSeq>::EXPOSED
+                );
+
+            return; 
+
+        };
+
+    UpdateFun<TSeq> update_infected = [](
+        Agent<TSeq> * p, Model<TSeq> * m
+        ) -> void {
+
+            auto state = p->get_state();
+
+            if (state == ModelSEIRCONN<TSeq>::EXPOSED)
+            {
+
+                // Getting the virus
+                auto & v = p->get_virus();
+
+                // Does the agent become infected?
+                if (m->runif() < 1.0/(v->get_incubation(m)))
+                {
+
+                    p->change_state(*m, ModelSEIRCONN<TSeq>::INFECTED);
+                    return;
+
+                }
+
+
+            } else if (state == ModelSEIRCONN<TSeq>::INFECTED)
+            {
+
+
+                // Odd: Die, Even: Recover
+                epiworld_fast_uint n_events = 0u;
+                auto & v = p->get_virus();
+
+                // Recover
+                m->array_double_tmp[n_events++] = 
+                    1.0 - (1.0 - v->get_prob_recovery(m)) *
+                    (1.0 - p->get_recovery_enhancer(v, *m));
+
+                #ifdef EPI_DEBUG
+                if (n_events == 0u)
+                {
+                    printf_epiworld(
+                        "[epi-debug] agent %i has 0 possible events!!\n",
+                        static_cast<int>(p->get_id())
+                        );
+                    throw std::logic_error("Zero events in exposed.");
+                }
+                #else
+                if (n_events == 0u)
+                    return;
+                #endif
+                
+
+                // Running the roulette
+                int which = roulette(n_events, m);
+
+                if (which < 0)
+                    return;
+
+                // Which roulette happen?
+                p->rm_virus(*m);
+
+                return ;
+
+            } else
+                throw std::logic_error("This function can only be applied to exposed or infected individuals. (SEIR)") ;
+
+            return;
+
+        };
+
+    // Setting up parameters
+    this->add_param(contact_rate, "Contact rate");
+    this->add_param(transmission_rate, "Prob. Transmission");
+    this->add_param(recovery_rate, "Prob. Recovery");
+    this->add_param(avg_incubation_days, "Avg. Incubation days");
+    
+    // state
+    this->add_state("Susceptible", update_susceptible);
+    this->add_state("Exposed", update_infected);
+    this->add_state("Infected", update_infected);
+    this->add_state("Recovered");
+
+    // Adding update function
+    GlobalFun<TSeq> update = [](
+        Model<TSeq> * m
+        ) -> void
+        {
+
+            ModelSEIRCONN<TSeq> * model = model_cast<ModelSEIRCONN<TSeq>,TSeq>(m);
+
+            model->update_infected();
+
+            return;
+
+        };
+
+    this->add_globalevent(update, "Update infected individuals");
+
+
+    // Preparing the virus -------------------------------------------
+    Virus<TSeq> virus(vname, prevalence, true);
+    virus.set_state(
+        ModelSEIRCONN<TSeq>::EXPOSED,
+        ModelSEIRCONN<TSeq>::RECOVERED,
+        ModelSEIRCONN<TSeq>::RECOVERED
+        );
+
+    virus.set_prob_infecting("Prob. Transmission");
+    virus.set_prob_recovery("Prob. Recovery");
+    virus.set_incubation("Avg. Incubation days");
+
+    this->add_virus(virus);
+
+    this->queuing_off(); // No queuing need
+
+    // Adding the empty population
+    this->agents_empty_graph(n);
+
+    this->set_name("Susceptible-Exposed-Infected-Removed (SEIR) (connected)");
+
+}
+
+template<typename TSeq>
+inline ModelSEIRCONN<TSeq> & ModelSEIRCONN<TSeq>::initial_states(
+    std::vector< double > proportions_,
+    std::vector< int > /* queue_ */
+)
+{
+
+    Model<TSeq>::initial_states_fun =
+        create_init_function_seir<TSeq>(proportions_)
+        ;
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline std::vector< double > ModelSEIRCONN<TSeq>::generation_time_expected(
+    int max_days,
+    int max_contacts
+) const
+{
+
+    // Retrieving total counts
+    std::vector< int > h_date;
+    std::vector< std::string > h_state;
+    std::vector< int > h_counts;
+    const auto this_const = dynamic_cast<const ModelSEIRCONN<TSeq> *>(this);
+    this_const->get_db().get_hist_total(
+        &h_date,
+        &h_state,
+        &h_counts
+    );
+
+    // Retrieving information on susceptibles
+    std::vector< double > S(this_const->get_ndays(), 0.0);
+    for (size_t i = 0; i < h_date.size(); ++i)
+    {
+        if (h_state[i] == "Susceptible")
+            S[h_date[i]] += h_counts[i];
+    }
+
+    // Computing the expected number of days in exposed
+    double days_exposed = this_const->par("Avg. Incubation days");
+
+    // The generation time in the SEIR model starts from 2, as agents 
+    // spend at least one day in the exposed state, and 1 day in the 
+    // infectious state before starting transmitting.
+    std::vector< double > gen_times(
+        this_const->get_ndays(), 1.0 + days_exposed
+        );
+        
+    double p_c = this_const->par("Contact rate")/this_const->size();
+    double p_i = this_const->par("Prob. Transmission");
+    double p_r = this_const->par("Prob. Recovery");
+
+    for (size_t i = 0u; i < this_const->get_ndays(); ++i)
+    {
+        gen_times[i] += gen_int_mean(
+            S[i],
+            p_c,
+            p_i,
+            p_r,
+            max_days,
+            max_contacts
+        );
+
+    }
+
+    return gen_times;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/seirconnected.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/sird.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_SIRD_H 
+#define EPIWORLD_SIRD_H
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+/**
+ * @brief Template for a Susceptible-Infected-Removed-Deceased (SIRD) model
+ * 
+ * ![Model Diagram](../assets/img/sird.png)
+ * 
+ * @ingroup death_compartmental
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSIRD : public Model<TSeq>
+{
+public:
+
+    ModelSIRD() = delete;
+
+    /**
+     * @brief Constructs a new SIRD model with the given parameters.
+     * 
+     * @param vname The name of the vertex associated with this model.
+     * @param prevalence The initial prevalence of the disease in the population.
+     * @param transmission_rate The rate at which the disease spreads from infected to susceptible individuals.
+     * @param recovery_rate The rate at which infected individuals recover and become immune.
+     * @param death_rate The rate at which infected individuals die.
+     */
+    ///@{
+    ModelSIRD(
+        const std::string & vname,
+        epiworld_double prevalence,
+        epiworld_double transmission_rate,
+        epiworld_double recovery_rate, 
+        epiworld_double death_rate
+    );
+    ///@}
+
+    /**
+     * @brief Set the initial states of the model
+     * @param proportions_ Double vector with two elements:
+     * - The proportion of non-infected individuals who have recovered.
+     * - The proportion of non-infected individuals who have died.
+    */
+    ModelSIRD<TSeq> & initial_states(
+        std::vector< double > proportions_,
+        std::vector< int > queue_ = {}
+    ) override;
+    
+};
+
+template<typename TSeq>
+inline ModelSIRD<TSeq>::ModelSIRD(
+    const std::string & vname,
+    epiworld_double prevalence,
+    epiworld_double transmission_rate,
+    epiworld_double recovery_rate, 
+    epiworld_double death_rate
+    )
+{
+
+    // Adding statuses
+    this->add_state("Susceptible", default_update_susceptible<TSeq>);
+    this->add_state("Infected", default_update_exposed<TSeq>);
+    this->add_state("Recovered");
+    this->add_state("Deceased");
+
+    // Setting up parameters
+    this->add_param(recovery_rate, "Recovery rate");
+    this->add_param(transmission_rate, "Transmission rate"),
+    this->add_param(death_rate, "Death rate");
+
+    // Preparing the virus -------------------------------------------
+    Virus<TSeq> virus(vname, prevalence, true);
+    virus.set_state(1,2,3);
+    virus.set_prob_recovery("Recovery rate");
+    virus.set_prob_infecting("Transmission rate");
+    virus.set_prob_death("Death rate");
+    
+    this->add_virus(virus);
+
+    this->set_name("Susceptible-Infected-Recovered-Deceased (SIRD)");
+
+   
+}
+
+template<typename TSeq>
+inline ModelSIRD<TSeq> & ModelSIRD<TSeq>::initial_states(
+    std::vector< double > proportions_,
+    std::vector< int > /**/ 
+) {
+
+    Model<TSeq>::initial_states_fun = 
+        create_init_function_sird<TSeq>(proportions_)
+        ;
+
+    return *this;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/sird.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/sisd.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_SISD_HPP 
+#define EPIWORLD_MODELS_SISD_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+/**
+ * @brief Template for a Susceptible-Infected-Susceptible-Deceased (SISD) model
+ * 
+ * ![Model Diagram](../assets/img/sisd.png)
+ * 
+ * @ingroup death_compartmental
+ * 
+ * @param vname std::string Name of the virus
+ * @param initial_prevalence epiworld_double Initial prevalence
+ * @param initial_efficacy epiworld_double Initial susceptibility_reduction of the immune system
+ * @param initial_recovery epiworld_double Initial recovery_rate rate of the immune system
+ * @param inital_death epiworld_double Initial death_rate of the immune system
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSISD : public Model<TSeq>
+{
+
+public:
+
+    ModelSISD() = delete;
+
+    ModelSISD(
+        const std::string & vname,
+        epiworld_double prevalence,
+        epiworld_double transmission_rate,
+        epiworld_double recovery_rate,
+        epiworld_double death_rate
+    );
+
+};
+
+template<typename TSeq>
+inline ModelSISD<TSeq>::ModelSISD(
+    const std::string & vname,
+    epiworld_double prevalence,
+    epiworld_double transmission_rate,
+    epiworld_double recovery_rate,
+    epiworld_double death_rate
+    )
+{
+
+    this->set_name("Susceptible-Infected-Susceptible-Deceased (SISD)");
+
+    // Adding statuses
+    this->add_state("Susceptible", default_update_susceptible<TSeq>);
+    this->add_state("Infected", default_update_exposed<TSeq>);
+    this->add_state("Deceased");
+
+    // Setting up parameters
+    this->add_param(transmission_rate, "Transmission rate");
+    this->add_param(recovery_rate, "Recovery rate");
+    this->add_param(death_rate, "Death rate");
+
+    // Preparing the virus -------------------------------------------
+    Virus<TSeq> virus(vname, prevalence, true);
+    virus.set_state(1,0,2);
+    
+    virus.set_prob_infecting("Transmission rate");
+    virus.set_prob_recovery("Recovery rate");
+    virus.set_prob_death(0.01);
+    
+    this->add_virus(virus);
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/sisd.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/seird.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_SEIRD_HPP
+#define EPIWORLD_MODELS_SEIRD_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+/**
+ * @brief Template for a Susceptible-Exposed-Infected-Removed-Deceased (SEIRD) model
+ * 
+ * ![Model Diagram](../assets/img/seird.png)
+ * 
+ * @ingroup death_compartmental
+*/
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSEIRD : public Model<TSeq>
+{
+  
+public:
+  static const int SUSCEPTIBLE = 0;
+  static const int EXPOSED     = 1;
+  static const int INFECTED    = 2;
+  static const int REMOVED     = 3;
+  static const int DECEASED    = 4;
+  
+  ModelSEIRD() = delete;
+
+  /**
+   * @brief Constructor for the SEIRD model.
+   * 
+   * @param vname Name of the model.
+   * @param prevalence Initial prevalence of the disease.
+   * @param transmission_rate Transmission rate of the disease.
+   * @param avg_incubation_days Average incubation period of the disease.
+   * @param recovery_rate Recovery rate of the disease.
+   * @param death_rate Death rate of the disease.
+   */
+  ModelSEIRD(
+    const std::string & vname,
+    epiworld_double prevalence,
+    epiworld_double transmission_rate,
+    epiworld_double avg_incubation_days,
+    epiworld_double recovery_rate,
+    epiworld_double death_rate
+  );
+  
+  UpdateFun<TSeq> update_exposed_seir = [](
+    Agent<TSeq> * p,
+    Model<TSeq> * m
+  ) -> void {
+
+    // Getting the virus
+    auto v = p->get_virus();
+
+    // Does the agent become infected?
+    if (m->runif() < 1.0/(v->get_incubation(m)))
+      p->change_state(*m, ModelSEIRD<TSeq>::INFECTED);
+
+    return;
+  };
+
+  
+  UpdateFun<TSeq> update_infected = [](
+    Agent<TSeq> * p, Model<TSeq> * m
+  ) -> void {
+          
+    // Odd: Die, Even: Recover
+    epiworld_fast_uint n_events = 0u;
+
+    auto & v = p->get_virus();
+      
+    // Die
+    m->array_double_tmp[n_events++] = 
+      v->get_prob_death(m) * (1.0 - p->get_death_reduction(v, *m));
+    
+    // Recover
+    m->array_double_tmp[n_events++] = 
+      1.0 - (1.0 - v->get_prob_recovery(m)) * (1.0 - p->get_recovery_enhancer(v, *m));
+    
+    
+#ifdef EPI_DEBUG
+    if (n_events == 0u)
+    {
+      printf_epiworld(
+        "[epi-debug] agent %i has 0 possible events!!\n",
+        static_cast<int>(p->get_id())
+      );
+      throw std::logic_error("Zero events in exposed.");
+    }
+#else
+    if (n_events == 0u)
+      return;
+#endif
+    
+    
+    // Running the roulette
+    int which = roulette(n_events, m);
+    
+    if (which < 0)
+      return;
+    
+    // Which roulette happen?
+    if ((which % 2) == 0) // If odd
+    {
+      
+      p->rm_virus(*m, ModelSEIRD<TSeq>::DECEASED);
+      
+    } else {
+      
+      p->rm_virus(*m);
+      
+    }
+    
+    return ;
+      
+    
+    
+    return;
+    
+  };
+
+  ModelSEIRD<TSeq> & initial_states(
+    std::vector< double > proportions_,
+    std::vector< int > queue_ = {}
+  ) override;
+
+};
+
+
+
+template<typename TSeq>
+inline ModelSEIRD<TSeq>::ModelSEIRD(
+    const std::string & vname,
+    epiworld_double prevalence,
+    epiworld_double transmission_rate,
+    epiworld_double avg_incubation_days,
+    epiworld_double recovery_rate,
+    epiworld_double death_rate
+)
+{
+  
+  // Adding statuses
+  this->add_state("Susceptible", default_update_susceptible<TSeq>);
+  this->add_state("Exposed",  this->update_exposed_seir);
+  this->add_state("Infected", this->update_infected);
+  this->add_state("Removed");
+  this->add_state("Deceased");
+  
+  // Setting up parameters
+  this->add_param(transmission_rate, "Transmission rate");
+  this->add_param(avg_incubation_days, "Incubation days");
+  this->add_param(recovery_rate, "Recovery rate");
+  this->add_param(death_rate, "Death rate");
+  
+  // Preparing the virus -------------------------------------------
+  Virus<TSeq> virus(vname, prevalence, true);
+  virus.set_state(ModelSEIRD<TSeq>::EXPOSED, ModelSEIRD<TSeq>::REMOVED, ModelSEIRD<TSeq>::DECEASED);
+  
+  virus.set_prob_infecting("Transmission rate");
+  virus.set_incubation("Incubation days");
+  virus.set_prob_death("Death rate");
+  virus.set_prob_recovery("Recovery rate");
+  
+  // Adding the tool and the virus
+  this->add_virus(virus);
+  
+  this->set_name("Susceptible-Exposed-Infected-Removed-Deceased (SEIRD)");
+  
+}
+
+template<typename TSeq>
+inline ModelSEIRD<TSeq> & ModelSEIRD<TSeq>::initial_states(
+  std::vector< double > proportions_,
+  std::vector< int > /**/
+) {
+
+  Model<TSeq>::initial_states_fun =
+    create_init_function_seird<TSeq>(proportions_)
+    ;
+
+  return *this;
+
+}
+
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/seird.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/sirdconnected.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_SIRDCONNECTED_HPP 
+#define EPIWORLD_MODELS_SIRDCONNECTED_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+/**
+ * @brief Template for a Susceptible-Infected-Removed-Deceased (SIRD) model with connected population
+ * 
+ * ![Model Diagram](../assets/img/sirdconnected.png)
+ * 
+ * @ingroup connected_models
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSIRDCONN : public Model<TSeq>
+{
+public:
+    static const int SUSCEPTIBLE = 0;
+    static const int INFECTED    = 1;
+    static const int RECOVERED   = 2;
+    static const int DECEASED    = 3;
+
+    ModelSIRDCONN() = delete;
+
+    ModelSIRDCONN(
+        const std::string & vname,
+        epiworld_fast_uint n,
+        epiworld_double prevalence,
+        epiworld_double contact_rate,
+        epiworld_double transmission_rate,
+        epiworld_double recovery_rate,
+        epiworld_double death_rate
+    );
+
+    std::unique_ptr< Model<TSeq> > clone_ptr() override;
+
+
+};
+
+template<typename TSeq>
+inline std::unique_ptr<Model<TSeq>> ModelSIRDCONN<TSeq>::clone_ptr()
+{
+    
+    return std::make_unique<ModelSIRDCONN<TSeq>>(*this);
+
+}
+
+/**
+ * @brief Template for a Susceptible-Infected-Removed-Deceased (SIRD) model
+ * 
+ * @param vname std::string Name of the virus
+ * @param prevalence Initial prevalence (proportion)
+ * @param contact_rate Average number of contacts (interactions) per step.
+ * @param transmission_rate Probability of transmission
+ * @param recovery_rate Probability of recovery
+ * @param death_rate Probability of death
+ */
+template<typename TSeq>
+inline ModelSIRDCONN<TSeq>::ModelSIRDCONN(
+    const std::string & vname,
+    epiworld_fast_uint n,
+    epiworld_double prevalence,
+    epiworld_double contact_rate,
+    epiworld_double transmission_rate,
+    epiworld_double recovery_rate,
+    epiworld_double death_rate
+    // epiworld_double prob_reinfection
+    )
+{
+
+    UpdateFun<TSeq> update_susceptible = [](
+        Agent<TSeq> * p, Model<TSeq> * m
+        ) -> void
+        {
+
+            static const size_t par_contact_rate =
+                Model<TSeq>::param_id("Contact rate");
+
+            // Sampling how many individuals
+            m->set_rand_binom(
+                m->size(),
+                static_cast<double>(
+                    m->par(par_contact_rate))/
+                    static_cast<double>(m->size())
+            );
+
+            int ndraw = m->rbinom();
+
+            if (ndraw == 0)
+                return;
+
+            // Drawing from the set
+            int nviruses_tmp = 0;
+            auto & m_ref = *m;
+            for (int i = 0; i < ndraw; ++i)
+            {
+                // Now selecting who is transmitting the disease
+                auto which = m->runif_index(m->size());
+
+                // Can't sample itself
+                if (which == p->get_id())
+                    continue;
+
+                // If the neighbor is infected, then proceed
+                auto & neighbor = m->get_agents()[which];
+                if (neighbor.get_state() == ModelSIRDCONN<TSeq>::INFECTED)
+                {
+
+                    auto & v = neighbor.get_virus();
+                    
+                    #ifdef EPI_DEBUG
+                    if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+                        throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
+                    #endif
+                        
+                    /* And it is a function of susceptibility_reduction as well */ 
+                    m->array_double_tmp[nviruses_tmp] =
+                        (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
+                        v->get_prob_infecting(m) *
+                        (1.0 - neighbor.get_transmission_reduction(v, m_ref))
+                        ;
+                
+                    m->array_virus_tmp[nviruses_tmp++] = &(*v);
+
+                }
+            }
+
+            // No virus to compute
+            if (nviruses_tmp == 0u)
+                return;
+
+            // Running the roulette
+            int which = roulette(nviruses_tmp, m);
+
+            if (which < 0)
+                return;
+
+            p->set_virus(*m, *m->array_virus_tmp[which]);
+
+            return; 
+
+        };
+
+
+    UpdateFun<TSeq> update_infected = [](
+        Agent<TSeq> * p, Model<TSeq> * m
+        ) -> void {
+
+            auto state = p->get_state();
+
+            if (state == ModelSIRDCONN<TSeq>::INFECTED)
+            {
+
+
+                // Odd: Die, Even: Recover
+                epiworld_fast_uint n_events = 0u;
+                auto & v = p->get_virus();
+                    
+                // Die
+                m->array_double_tmp[n_events++] = 
+                v->get_prob_death(m) * (1.0 - p->get_death_reduction(v, *m));
+                
+                // Recover
+                m->array_double_tmp[n_events++] = 
+                1.0 - (1.0 - v->get_prob_recovery(m)) *
+                    (1.0 - p->get_recovery_enhancer(v, *m));
+                
+    #ifdef EPI_DEBUG
+                if (n_events == 0u)
+                {
+                    printf_epiworld(
+                    "[epi-debug] agent %i has 0 possible events!!\n",
+                    static_cast<int>(p->get_id())
+                    );
+                    throw std::logic_error("Zero events in exposed.");
+                }
+    #else
+                if (n_events == 0u)
+                    return;
+    #endif
+                
+                
+                // Running the roulette
+                int which = roulette(n_events, m);
+                
+                if (which < 0)
+                    return;
+                
+                // Which roulette happen?
+                if ((which % 2) == 0) // If odd
+                {
+                    
+                    p->rm_virus(*m, ModelSIRDCONN<TSeq>::DECEASED);
+                    
+                } else {
+                    
+                    p->rm_virus(*m);
+                    
+                }
+
+                return ;
+
+            } else
+                throw std::logic_error("This function can only be applied to infected individuals. (SIR)") ;
+
+            return;
+
+        };
+
+    // state
+    this->add_state("Susceptible", update_susceptible);
+    this->add_state("Infected", update_infected);
+    this->add_state("Recovered");
+    this->add_state("Deceased");
+      
+
+    // Setting up parameters
+    this->add_param(contact_rate, "Contact rate");
+    this->add_param(transmission_rate, "Transmission rate");
+    this->add_param(recovery_rate, "Recovery rate");
+    this->add_param(death_rate, "Death rate");
+    // this->add_param(prob_reinfection, "Prob. Reinfection");
+    
+    // Preparing the virus -------------------------------------------
+    Virus<TSeq> virus(vname, prevalence, true);
+    virus.set_state(1, 2, 3);
+    virus.set_prob_infecting("Transmission rate");
+    virus.set_prob_recovery("Recovery rate");
+    virus.set_prob_death("Death rate");
+    
+    this->add_virus(virus);
+
+    this->queuing_off(); // No queuing need
+
+    this->agents_empty_graph(n);
+
+    this->set_name("Susceptible-Infected-Removed-Deceased (SIRD) (connected)");
+
+}
+
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/sirdconnected.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/seirdconnected.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_SEIRDCONNECTED_HPP
+#define EPIWORLD_MODELS_SEIRDCONNECTED_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+/**
+ * @brief Template for a Susceptible-Exposed-Infected-Removed-Deceased (SEIRD) model with connected population
+ * 
+ * ![Model Diagram](../assets/img/seirdconnected.png)
+ * 
+ * @ingroup connected_models
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSEIRDCONN : public Model<TSeq> 
+{
+private:
+    std::vector< Agent<TSeq> * > infected;
+    void update_infected();
+    void read_checkpoint_derived(std::istream & in) override;
+
+public:
+
+    static const int SUSCEPTIBLE = 0;
+    static const int EXPOSED     = 1;
+    static const int INFECTED    = 2;
+    static const int REMOVED     = 3;
+    static const int DECEASED    = 4;
+
+    ModelSEIRDCONN() = delete;
+
+     /**
+     * @brief Constructor for the SEIRD model with connected population.
+     * 
+     * @param vname Name of the model.
+     * @param n Population size.
+     * @param prevalence Initial prevalence of the disease.
+     * @param contact_rate Average number of contacts (interactions) per step.
+     * @param transmission_rate Probability of transmission
+     * @param avg_incubation_days Average incubation period of the disease.
+     * @param recovery_rate Probability of recovery
+     * @param death_rate Probability of death
+     */
+    ModelSEIRDCONN(
+        const std::string & vname,
+        epiworld_fast_uint n,
+        epiworld_double prevalence,
+        epiworld_double contact_rate,
+        epiworld_double transmission_rate,
+        epiworld_double avg_incubation_days,
+        epiworld_double recovery_rate,
+        epiworld_double death_rate
+    );
+
+    void reset() override;
+
+    std::unique_ptr< Model<TSeq> > clone_ptr() override;
+
+    /**
+     * @brief Set up the initial states of the model.
+     * @param proportions_ Double vector with the following values:
+     * - 0: Proportion of non-infected agents who are removed.
+     * - 1: Proportion of exposed agents to be set as infected.
+    */
+    ModelSEIRDCONN<TSeq> & initial_states(
+        std::vector< double > proportions_,
+        std::vector< int > queue_ = {}
+    ) override;
+
+    size_t get_n_infected() const
+    {
+        return infected.size();
+    }
+
+};
+
+template<typename TSeq>
+inline void ModelSEIRDCONN<TSeq>::update_infected()
+{
+    infected.clear();
+    infected.reserve(this->size());
+
+    for (auto & p : this->get_agents())
+    {
+        if (p.get_state() == ModelSEIRDCONN<TSeq>::INFECTED)
+        {
+            infected.push_back(&p);
+        }
+    }
+
+    Model<TSeq>::set_rand_binom(
+        this->get_n_infected(),
+        static_cast<double>(Model<TSeq>::par("Contact rate"))/
+            static_cast<double>(this->size())
+    );
+
+    return; 
+}
+
+template<typename TSeq>
+inline void ModelSEIRDCONN<TSeq>::reset()
+{
+
+    Model<TSeq>::reset();
+
+    this->update_infected();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRDCONN<TSeq>::read_checkpoint_derived(std::istream &)
+{
+
+    this->update_infected();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline std::unique_ptr<Model<TSeq>> ModelSEIRDCONN<TSeq>::clone_ptr()
+{
+    
+    return std::make_unique<ModelSEIRDCONN<TSeq>>(*this);
+
+}
+
+/**
+ * @brief Template for a Susceptible-Exposed-Infected-Removed-Deceased (SEIRD) model
+ * 
+ * @param model A Model<TSeq> object where to set up the SEIRD.
+ * @param vname std::string Name of the virus
+ * @param prevalence Initial prevalence (proportion)
+ * @param contact_rate Average number of contacts (interactions) per step.
+ * @param transmission_rate Probability of transmission
+ * @param recovery_rate Probability of recovery
+ * @param death_rate Probability of death
+ */
+template<typename TSeq>
+inline ModelSEIRDCONN<TSeq>::ModelSEIRDCONN(
+    const std::string & vname,
+    epiworld_fast_uint n,
+    epiworld_double prevalence,
+    epiworld_double contact_rate,
+    epiworld_double transmission_rate,
+    epiworld_double avg_incubation_days,
+    epiworld_double recovery_rate,
+    epiworld_double death_rate
+    // epiworld_double prob_reinfection
+    )
+{
+
+    UpdateFun<TSeq> update_susceptible = [](
+        Agent<TSeq> * p, Model<TSeq> * m
+        ) -> void
+        {
+
+            // Sampling how many individuals
+            int ndraw = m->rbinom();
+
+            if (ndraw == 0)
+                return;
+
+            ModelSEIRDCONN<TSeq> * model = model_cast<ModelSEIRDCONN<TSeq>,TSeq>(
+                m
+                );
+
+            int ninfected = static_cast<int>(model->get_n_infected());
+
+            // Drawing from the set
+            int nviruses_tmp = 0;
+            auto & m_ref = *m;
+            for (int i = 0; i < ndraw; ++i)
+            {
+                // Now selecting who is transmitting the disease
+                auto which = m->runif_index(ninfected);
+
+                Agent<TSeq> & neighbor = *model->infected[which];
+
+                // Can't sample itself
+                if (neighbor.get_id() == p->get_id())
+                    continue;
+
+                // All neighbors in this set are infected by construction
+                auto & v = neighbor.get_virus();
+            
+                #ifdef EPI_DEBUG
+                if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+                    throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
+                #endif
+                    
+                /* And it is a function of susceptibility_reduction as well */ 
+                m->array_double_tmp[nviruses_tmp] =
+                    (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
+                    v->get_prob_infecting(m) *
+                    (1.0 - neighbor.get_transmission_reduction(v, m_ref))
+                    ;
+            
+                m->array_virus_tmp[nviruses_tmp++] = &(*v);
+            }
+
+            // No virus to compute
+            if (nviruses_tmp == 0u)
+                return;
+
+            // Running the roulette
+            int which = roulette(nviruses_tmp, m);
+
+            if (which < 0)
+                return;
+
+            p->set_virus(*m, 
+                *m->array_virus_tmp[which],
+                ModelSEIRDCONN<TSeq>::EXPOSED
+                );
+
+            return; 
+
+        };
+
+    UpdateFun<TSeq> update_infected = [](
+        Agent<TSeq> * p, Model<TSeq> * m
+        ) -> void {
+
+            auto state = p->get_state();
+
+            if (state == ModelSEIRDCONN<TSeq>::EXPOSED)
+            {
+
+                // Getting the virus
+                auto & v = p->get_virus();
+
+                // Does the agent become infected?
+                if (m->runif() < 1.0/(v->get_incubation(m)))
+                {
+
+                    p->change_state(*m, ModelSEIRDCONN<TSeq>::INFECTED);
+                    return;
+
+                }
+
+
+            } else if (state == ModelSEIRDCONN<TSeq>::INFECTED)
+            {
+
+                // Odd: Die, Even: Recover
+                epiworld_fast_uint n_events = 0u;
+                auto & v = p->get_virus();
+                
+                // Die
+                m->array_double_tmp[n_events++] = 
+                    v->get_prob_death(m) * (1.0 - p->get_death_reduction(v, *m));
+                
+                // Recover
+                m->array_double_tmp[n_events++] = 
+                    1.0 - (1.0 - v->get_prob_recovery(m)) * (1.0 - p->get_recovery_enhancer(v, *m));
+                                
+                #ifdef EPI_DEBUG
+                if (n_events == 0u)
+                {
+                printf_epiworld(
+                    "[epi-debug] agent %i has 0 possible events!!\n",
+                    static_cast<int>(p->get_id())
+                );
+                throw std::logic_error("Zero events in exposed.");
+                }
+                #else
+                if (n_events == 0u)
+                return;
+                #endif
+                
+                
+                // Running the roulette
+                int which = roulette(n_events, m);
+                
+                if (which < 0)
+                return;
+                
+                // Which roulette happen?
+                if ((which % 2) == 0) // If odd
+                {
+                
+                    p->rm_virus(*m, ModelSEIRDCONN<TSeq>::DECEASED);
+                
+                } else {
+                
+                    p->rm_virus(*m, ModelSEIRDCONN<TSeq>::REMOVED);
+                
+                }
+
+                return ;
+
+            } else
+                throw std::logic_error("This function can only be applied to exposed or infected individuals. (SEIRD)") ;
+
+            return;
+
+        };
+
+    // Setting up parameters
+    this->add_param(contact_rate, "Contact rate");
+    this->add_param(transmission_rate, "Prob. Transmission");
+    this->add_param(recovery_rate, "Prob. Recovery");
+    this->add_param(avg_incubation_days, "Avg. Incubation days");
+    this->add_param(death_rate, "Death rate");
+    
+    // state
+    this->add_state("Susceptible", update_susceptible);
+    this->add_state("Exposed", update_infected);
+    this->add_state("Infected", update_infected);
+    this->add_state("Removed");
+    this->add_state("Deceased");
+
+
+    // Adding update function
+    GlobalFun<TSeq> update = [](Model<TSeq> * m) -> void
+    {
+        ModelSEIRDCONN<TSeq> * model = model_cast<ModelSEIRDCONN<TSeq>,TSeq>(m);
+        
+        if (model == nullptr)
+            throw std::logic_error(
+                std::string("Internal error in the ModelSEIRDCONN model: ") +
+                std::string("The model returns a null pointer.")
+            );
+        else
+            model->update_infected();
+        
+        return;
+    };
+
+    this->add_globalevent(update, "Update infected individuals");
+
+
+    // Preparing the virus -------------------------------------------
+    Virus<TSeq> virus(vname, prevalence, true);
+    virus.set_state(EXPOSED, REMOVED, DECEASED);
+
+    virus.set_prob_infecting("Prob. Transmission");
+    virus.set_prob_recovery("Prob. Recovery");
+    virus.set_incubation("Avg. Incubation days");
+    virus.set_prob_death("Death rate");
+    this->add_virus(virus);
+
+    this->queuing_off(); // No queuing need
+
+    // Adding the empty population
+    this->agents_empty_graph(n);
+
+    this->set_name("Susceptible-Exposed-Infected-Removed-Deceased (SEIRD) (connected)");
+
+}
+
+template<typename TSeq>
+inline ModelSEIRDCONN<TSeq> & ModelSEIRDCONN<TSeq>::initial_states(
+    std::vector< double > proportions_,
+    std::vector< int > /**/
+) {
+
+    Model<TSeq>::initial_states_fun =
+        create_init_function_seird<TSeq>(proportions_)
+        ;
+
+    return *this;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/seirdconnected.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/sirlogit.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_SIRLOGIT_HPP 
+#define EPIWORLD_MODELS_SIRLOGIT_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+/**
+ * @brief Template for a Susceptible-Infected-Removed (SIR) model
+ * 
+ * ![Model Diagram](../assets/img/sirlogit.png)
+ * 
+ * @ingroup special_models
+ * 
+ * @details
+ * In this model, infection and recoveru probabilities are computed
+ * using a logit model. Particularly, the probability of infection
+ * is computed as:
+ * 
+ * \f[
+ * \frac{1}{1 + \exp\left(-\left(\beta_0 E_i + \sum_{i=1}^{n} \beta_i x_i\right)\right)}
+ * \f]
+ * 
+ * where \f$\beta_0\f$ is the exposure coefficient and \f$E_i\f$ is the exposure
+ * number, \f$\beta_i\f$ are the
+ * coefficients for the features \f$x_i\f$ of the agents, and \f$n\f$ is the
+ * number of features. The probability of recovery is computed as:
+ * 
+ * \f[
+ * \frac{1}{1 + \exp\left(-\left(\sum_{i=1}^{n} \beta_i x_i\right)\right)}
+ * \f]
+ * 
+ * where \f$\beta_i\f$ are the coefficients for the features \f$x_i\f$ of the agents,
+ * and \f$n\f$ is the number of features.
+ * 
+ * @param TSeq Type of the sequence (e.g. std::vector, std::deque)
+ 
+*/
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSIRLogit : public Model<TSeq>
+{
+public:
+    static const int SUSCEPTIBLE = 0;
+    static const int INFECTED    = 1;
+    static const int RECOVERED   = 2;
+
+    ModelSIRLogit() = delete;
+
+    /**
+      * @param vname Name of the virus.
+      * @param coefs_infect Double ptr. Infection coefficients.
+      * @param coefs_recover Double ptr. Recovery coefficients.
+      * @param ncoef_infect Unsigned int. Number of infection coefficients.
+      * @param ncoef_recover Unsigned int. Number of recovery coefficients.
+      * @param coef_infect_cols Vector<unsigned int>. Ids of infection vars.
+      * @param coef_recover_cols Vector<unsigned int>. Ids of recover vars.
+    */
+    ModelSIRLogit(
+        const std::string & vname,
+        double * data,
+        size_t ncols,
+        std::vector< double > coefs_infect,
+        std::vector< double > coefs_recover,
+        std::vector< size_t > coef_infect_cols,
+        std::vector< size_t > coef_recover_cols,
+        epiworld_double transmission_rate,
+        epiworld_double recovery_rate,
+        epiworld_double prevalence
+    );
+
+    std::unique_ptr< Model<TSeq> > clone_ptr() override;
+
+    void reset() override;
+    
+    std::vector< double > coefs_infect;
+    std::vector< double > coefs_recover;
+    std::vector< size_t > coef_infect_cols;
+    std::vector< size_t > coef_recover_cols;
+
+};
+
+template<typename TSeq>
+inline std::unique_ptr<Model<TSeq>> ModelSIRLogit<TSeq>::clone_ptr()
+{
+    
+    return std::make_unique<ModelSIRLogit<TSeq>>(*this);
+
+}
+
+template<typename TSeq>
+inline void ModelSIRLogit<TSeq>::reset()
+{
+
+    /* Checking specified columns in the model */
+    for (const auto & c : coef_infect_cols)
+    {
+        if (c >= Model<TSeq>::agents_data_ncols)
+            throw std::range_error("Columns specified in coef_infect_cols out of range.");
+    }
+
+    for (const auto & c : coef_recover_cols)
+    {
+        if (c >= Model<TSeq>::agents_data_ncols)
+            throw std::range_error("Columns specified in coef_recover_cols out of range.");
+    }
+
+    /* Checking attributes */ 
+    if (coefs_infect.size() != (coef_infect_cols.size() + 1u))
+        throw std::logic_error(
+            "The number of coefficients (infection) doesn't match the number of features. It must be as many features of the agents plus 1 (exposure.)"
+            );
+
+    if (coefs_recover.size() != coef_recover_cols.size())
+        throw std::logic_error(
+            "The number of coefficients (recovery) doesn't match the number of features. It must be as many features of the agents."
+            );
+    
+    Model<TSeq>::reset();
+
+    return;
+
+}
+
+/**
+ * @brief Template for a Susceptible-Infected-Removed (SIR) model
+ * 
+ * @param model A Model<TSeq> object where to set up the SIR.
+ * @param vname std::string Name of the virus
+ * @param prevalence Initial prevalence (proportion)
+ * @param contact_rate Average number of contacts (interactions) per step.
+ * @param prob_transmission Probability of transmission
+ * @param prob_recovery Probability of recovery
+ */
+template<typename TSeq>
+inline ModelSIRLogit<TSeq>::ModelSIRLogit(
+    const std::string & vname,
+    double * data,
+    size_t ncols,
+    std::vector< double > coefs_infect,
+    std::vector< double > coefs_recover,
+    std::vector< size_t > coef_infect_cols,
+    std::vector< size_t > coef_recover_cols,
+    epiworld_double transmission_rate,
+    epiworld_double recovery_rate,
+    epiworld_double prevalence
+    )
+{
+
+    if (coef_infect_cols.size() == 0u)
+        throw std::logic_error("No columns specified for coef_infect_cols.");
+
+    if (coef_recover_cols.size() == 0u)
+        throw std::logic_error("No columns specified for coef_recover_cols.");
+
+    // Saving the variables
+    this->set_agents_data(
+        data, ncols
+    );
+
+    this->coefs_infect = coefs_infect;
+    this->coefs_recover = coefs_recover;
+    this->coef_infect_cols = coef_infect_cols;
+    this->coef_recover_cols = coef_recover_cols;
+
+    UpdateFun<TSeq> update_susceptible = [](
+        Agent<TSeq> * p, Model<TSeq> * m
+        ) -> void
+        {
+
+            // Getting the right type
+            ModelSIRLogit<TSeq> * _m = model_cast<ModelSIRLogit<TSeq>,TSeq>(m);
+
+            // Exposure coefficient
+            const double coef_exposure = _m->coefs_infect[0u];
+
+            // This computes the prob of getting any neighbor variant
+            size_t nviruses_tmp = 0u;
+
+            double baseline = 0.0;
+            for (size_t k = 0u; k < _m->coef_infect_cols.size(); ++k)
+                baseline += p->operator()(k, *m) * _m->coefs_infect[k + 1u];
+
+            auto & m_ref = *m;
+            for (auto & neighbor: p->neighbors(*m)) 
+            {
+                
+                if (neighbor.get_virus() == nullptr)
+                    continue;
+
+                auto & v = neighbor.get_virus();
+
+                #ifdef EPI_DEBUG
+                if (nviruses_tmp >= m->array_virus_tmp.size())
+                    throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
+                #endif
+                    
+                /* And it is a function of susceptibility_reduction as well */ 
+                m->array_double_tmp[nviruses_tmp] =
+                    baseline +
+                    (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
+                    v->get_prob_infecting(m) *
+                    (1.0 - neighbor.get_transmission_reduction(v, m_ref))  *
+                    coef_exposure
+                    ; 
+
+                // Applying the plogis function
+                m->array_double_tmp[nviruses_tmp] = 1.0/
+                    (1.0 + std::exp(-m->array_double_tmp[nviruses_tmp]));
+            
+                m->array_virus_tmp[nviruses_tmp++] = &(*v);
+
+            }
+
+            // No virus to compute
+            if (nviruses_tmp == 0u)
+                return;
+
+            // Running the roulette
+            int which = roulette(nviruses_tmp, m);
+
+            if (which < 0)
+                return;
+
+            p->set_virus(*m, *m->array_virus_tmp[which]);
+
+            return;
+
+        };
+
+    UpdateFun<TSeq> update_infected = [](
+        Agent<TSeq> * p, Model<TSeq> * m
+        ) -> void
+        {
+
+            // Getting the right type
+            ModelSIRLogit<TSeq> * _m = model_cast<ModelSIRLogit<TSeq>,TSeq>(m);
+
+            // Computing recovery probability once
+            double prob    = 0.0;
+            #if defined(__OPENMP) || defined(_OPENMP)
+            #pragma omp simd reduction(+:prob)
+            #endif
+            for (size_t i = 0u; i < _m->coefs_recover.size(); ++i)
+                prob += p->operator()(i, *m) * _m->coefs_recover[i];
+
+            // Computing logis
+            prob = 1.0/(1.0 + std::exp(-prob));
+
+            if (prob > m->runif())
+                p->rm_virus(*m);
+            
+            return;
+
+        };
+
+    // state
+    this->add_state("Susceptible", update_susceptible);
+    this->add_state("Infected", update_infected);
+    this->add_state("Recovered");
+
+    // Setting up parameters
+    // this->add_param(contact_rate, "Contact rate");
+    this->add_param(transmission_rate, "Transmission rate");
+    this->add_param(recovery_rate, "Recovery rate");
+    // this->add_param(prob_reinfection, "Prob. Reinfection");
+    
+    // Preparing the virus -------------------------------------------
+    Virus<TSeq> virus(vname, prevalence, true);
+    virus.set_state(INFECTED, RECOVERED, RECOVERED);
+
+    virus.set_prob_infecting("Transmission rate");
+    virus.set_prob_recovery("Recovery rate");
+
+    // virus.set_prob
+
+    this->add_virus(virus);
+
+    this->set_name("Susceptible-Infected-Removed (SIR) (logit)");
+
+}
+
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/sirlogit.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/diffnet.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_DIFFNET_H 
+#define EPIWORLD_DIFFNET_H
+
+#include <string>
+#include <vector>
+// (already included include/epiworld/models/../config.hpp)
+// (already included include/epiworld/models/../model-bones.hpp)
+
+/**
+ * @brief Template for a Network Diffusion Model
+ * @ingroup special_models
+ * 
+ * @param model A Model<TSeq> object where to set up the SIR.
+ * @param vname std::string Name of the virus
+ * @param initial_prevalence epiworld_double Initial prevalence
+ * @param initial_efficacy epiworld_double Initial susceptibility_reduction of the immune system
+ * @param initial_recovery epiworld_double Initial recovery rate of the immune system
+ * 
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelDiffNet : public Model<TSeq>
+{
+private:
+public:
+
+    // Statuses
+    static const int NONADOPTER = 0;
+    static const int ADOPTER    = 1;
+
+    ModelDiffNet() = delete;
+
+    ModelDiffNet(
+        const std::string & innovation_name,
+        epiworld_double prevalence,
+        epiworld_double prob_adopt,
+        bool normalize_exposure = true,
+        double * agents_data = nullptr,
+        size_t data_ncols = 0u,
+        std::vector< size_t > data_cols = {},
+        std::vector< double > params = {}
+    );
+
+    bool normalize_exposure = true;
+    std::vector< size_t > data_cols;
+    std::vector< double > params;
+};
+
+template<typename TSeq>
+inline ModelDiffNet<TSeq>::ModelDiffNet(
+    const std::string & innovation_name,
+    epiworld_double prevalence,
+    epiworld_double prob_adopt,
+    bool normalize_exposure,
+    double * agents_data,
+    size_t data_ncols,
+    std::vector< size_t > data_cols,
+    std::vector< double > params
+    )
+{
+
+    // Adding additional parameters
+    this->normalize_exposure = normalize_exposure;
+    this->data_cols = data_cols;
+    this->params = params;
+
+    UpdateFun<TSeq> update_non_adopters = [](
+        Agent<TSeq> * p, Model<TSeq> * m
+    ) -> void {
+
+        // Measuring exposure
+        // If the neighbor is infected, then proceed
+        size_t nviruses = m->get_n_viruses();
+        std::vector< Virus<TSeq>* > innovations(nviruses, {});
+        std::vector< bool > stored(nviruses, false);
+        std::vector< double > exposure(nviruses, 0.0);
+
+        ModelDiffNet<TSeq> * diffmodel = model_cast<ModelDiffNet<TSeq>,TSeq>(m);
+
+        Agent<TSeq> & agent = *p;
+
+        // For each one of the possible innovations, we have to compute
+        // the adoption probability, which is a function of exposure
+        auto & m_ref = *m;
+        for (auto & neighbor: agent.neighbors(*m))
+        {
+
+            if (neighbor.get_state() == ModelDiffNet<TSeq>::ADOPTER)
+            {
+
+                auto & v = neighbor.get_virus();
+                
+                if (v == nullptr)
+                    continue;
+    
+                /* And it is a function of susceptibility_reduction as well */ 
+                double p_i =
+                    (1.0 - agent.get_susceptibility_reduction(v, m_ref)) *
+                    (1.0 - agent.get_transmission_reduction(v, m_ref)) 
+                    ; 
+            
+                size_t vid = v->get_id();
+                if (!stored[vid])
+                {
+                    stored[vid] = true;
+                    innovations[vid] = &(*v);
+                }
+                exposure[vid] += p_i;
+
+
+            }
+
+        }
+
+        // Computing probability of adoption
+        for (size_t i = 0u; i < nviruses; ++i)
+        {
+
+            if (diffmodel->normalize_exposure)
+                exposure.at(i) /= agent.get_n_neighbors();
+
+            for (auto & j: diffmodel->data_cols)
+                exposure.at(i) += agent(j, m_ref) * diffmodel->params.at(j);
+
+            // Baseline probability of adoption
+            double p = m->get_viruses()[i]->get_prob_infecting(m);
+            exposure.at(i) += std::log(p) - std::log(1.0 - p);
+
+            // Computing as log
+            exposure.at(i) = 1.0/(1.0 + std::exp(-exposure.at(i)));
+
+        }
+
+        // Running the roulette to see is an innovation is adopted
+        int which = roulette<int>(exposure, m);
+
+        // No innovation was adopted
+        if (which < 0)
+            return;
+
+        // Otherwise, it is adopted from any of the neighbors
+        agent.set_virus(*m, 
+            *innovations.at(which),
+            ADOPTER
+        );
+
+        return;
+
+        };
+
+    // Adding agents data
+    this->set_agents_data(agents_data, data_ncols);
+    
+    // Adding statuses
+    this->add_state("Non adopters", update_non_adopters);
+    this->add_state("Adopters");
+
+    // Adding parameters
+    std::string parname = std::string("Prob. Adopting ") + innovation_name;
+    this->add_param(prob_adopt, parname);
+
+    // Preparing the virus -------------------------------------------
+    Virus<TSeq> innovation(innovation_name, prevalence, true);
+    innovation.set_state(1,1,1);
+    
+    innovation.set_prob_infecting(parname);
+    
+    this->add_virus(innovation);
+
+    this->set_name(
+        std::string("Diffusion of Innovations - ") + innovation_name);
+
+    return;
+   
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/diffnet.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/seirmixing.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_SEIRMIXING_HPP
+#define EPIWORLD_MODELS_SEIRMIXING_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+#define MM(i, j, n) \
+    j * n + i
+
+/**
+ * @file seirentitiesconnected.hpp
+ * @brief Template for a Susceptible-Exposed-Infected-Removed (SEIR) model with mixing
+ * 
+ * ![Model Diagram](../assets/img/seirmixing.png)
+ * 
+ * **Implementation details:**
+ * <a href="../impl/mixing-and-entity-distribution.md">Mixing and Entity Distribution</a>,
+ * <a href="../impl/sampling-contacts.md">Sampling Contacts</a>
+ * 
+ * @ingroup mixing_models
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSEIRMixing :
+    public Model<TSeq>,
+    public ContactMatrix
+{
+private:
+
+    // Vector of vectors of infected agents
+    std::vector< epiworld_agent_index > infected;
+
+    // Number of infected agents in each group
+    std::vector< size_t > n_infected_per_group;
+
+    // Where the agents start in the `infected` vector
+    std::vector< size_t > entity_indices;
+
+    void update_infected_list();
+    void setup_groups(); ///< Sizes and fills the lists by group.
+    void read_checkpoint_derived(std::istream & in) override;
+    std::vector< epiworld_agent_index > sampled_agents;
+    size_t sample_agents(
+        Agent<TSeq> * agent,
+        std::vector< epiworld_agent_index > & sampled_agents
+        );
+    std::vector< double > adjusted_contact_rate;
+
+    static void _update_susceptible(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_exposed_and_infected(Agent<TSeq> * p, Model<TSeq> * m);
+
+    #ifdef EPI_DEBUG
+    std::vector< int > sampled_sizes;
+    #endif
+
+    // Aggregated mode (see aggregated_on())
+    epiworld_double prevalence;
+    std::vector< double > proportions = {};
+    Model<TSeq> & run_aggregated(epiworld_fast_uint ndays) override;
+
+public:
+
+    static const int SUSCEPTIBLE = 0;
+    static const int EXPOSED     = 1;
+    static const int INFECTED    = 2;
+    static const int RECOVERED   = 3;
+
+    ModelSEIRMixing() = delete;
+
+    /**
+     * @brief Constructs a ModelSEIRMixing object.
+     *
+     * @param vname The name of the ModelSEIRMixing object.
+     * @param n The number of entities in the model.
+     * @param prevalence The initial prevalence of the disease in the model.
+     * @param transmission_rate The transmission rate of the disease in the model.
+     * @param avg_incubation_days The average incubation period of the disease in the model.
+     * @param recovery_rate The recovery rate of the disease in the model.
+     * @param contact_matrix The contact matrix between entities in the model. Each entry
+     * (i,j) represents the expected number of contacts an agent in group i has
+     * with agents in group j per day.
+     */
+    ModelSEIRMixing(
+        const std::string & vname,
+        epiworld_fast_uint n,
+        epiworld_double prevalence,
+        epiworld_double transmission_rate,
+        epiworld_double avg_incubation_days,
+        epiworld_double recovery_rate,
+        std::vector< double > contact_matrix
+    );
+
+    void reset() override;
+
+    std::unique_ptr< Model<TSeq> > clone_ptr() override;
+
+    /**
+     * @brief Runs the built-in states without `std::function` calls
+     * @return false if any state function was replaced by the user.
+     */
+    bool update_state_static() override;
+
+    /**
+     * @brief Set the initial states of the model
+     * @param proportions_ Double vector with a single element:
+     * - The proportion of non-infected individuals who have recovered.
+    */
+    ModelSEIRMixing<TSeq> & initial_states(
+        std::vector< double > proportions_,
+        std::vector< int > queue_ = {}
+    ) override;
+
+    /**
+     * @name Aggregated mode
+     * @details Same as `ModelSIRMixing::aggregated_on()`: the model keeps
+     * counts per group and state, and advances them with binomial draws.
+     * Only the infected (not the exposed) transmit, and exposed become
+     * infected with probability `1 / incubation` each day.
+     *
+     * @param group_sizes Number of agents in each group (one per row of
+     * the contact matrix).
+     */
+    ///@{
+    ModelSEIRMixing<TSeq> & aggregated_on(std::vector< size_t > group_sizes);
+    ModelSEIRMixing<TSeq> & aggregated_off(); ///< Restores the agents.
+    ///@}
+
+};
+
+template<typename TSeq>
+inline void ModelSEIRMixing<TSeq>::update_infected_list()
+{
+
+    auto & agents = this->get_agents();
+
+    std::fill(n_infected_per_group.begin(), n_infected_per_group.end(), 0u);
+
+    for (auto & a : agents)
+    {
+
+        if (a.get_state() == ModelSEIRMixing<TSeq>::INFECTED)
+        {
+            if (a.get_n_entities() > 0u)
+            {
+                const auto & entity = a.get_entity(0u, *this);
+                infected[
+                    // Position of the group in the `infected` vector
+                    entity_indices[entity.get_id()] +
+                    // Position of the agent in the group
+                    n_infected_per_group[entity.get_id()]++
+                ] = a.get_id();
+
+            }
+        }
+
+    }
+
+    return;
+
+}
+
+template<typename TSeq>
+inline size_t ModelSEIRMixing<TSeq>::sample_agents(
+    Agent<TSeq> * agent,
+    std::vector< epiworld_agent_index > & sampled_agents
+    )
+{
+
+    size_t agent_group_id = agent->get_entity(0u, *this).get_id();
+    size_t ngroups = this->entities.size();
+
+    int samp_id = 0;
+    for (size_t g = 0; g < ngroups; ++g)
+    {
+
+        size_t group_size = n_infected_per_group[g];
+
+        // How many from this entity?
+        int nsamples = this->rbinom(
+            group_size,
+            adjusted_contact_rate[g] * this->get_contact_rate(agent_group_id, g, false)
+        );
+
+        if (nsamples == 0)
+            continue;
+
+        // Sampling from the entity
+        for (int s = 0; s < nsamples; ++s)
+        {
+
+            // Randomly selecting an agent
+            int which = this->runif() * group_size;
+
+            // Correcting overflow error
+            if (which >= static_cast<int>(group_size))
+                which = static_cast<int>(group_size) - 1;
+
+            #ifdef EPI_DEBUG
+            auto & a = this->population.at(infected.at(entity_indices[g] + which));
+            #else
+            auto & a = this->get_agent(infected[entity_indices[g] + which]);
+            #endif
+
+            #ifdef EPI_DEBUG
+            if (a.get_state() != ModelSEIRMixing<TSeq>::INFECTED)
+                throw std::logic_error(
+                    "The agent is not infected, but it should be."
+                );
+            #endif
+
+            // Can't sample itself
+            if (a.get_id() == agent->get_id())
+                continue;
+
+            sampled_agents[samp_id++] = a.get_id();
+
+        }
+
+    }
+
+    return samp_id;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixing<TSeq>::setup_groups()
+{
+
+    // Checking contact matrix dimensions
+    size_t nentities = this->entities.size();
+    this->validate_contact_matrix(nentities);
+
+    // Do it the first time only
+    sampled_agents.resize(this->size());
+
+    // We only do it once
+    n_infected_per_group.assign(this->entities.size(), 0u);
+
+    // We are assuming one agent per entity
+    infected.assign(this->size(), 0u);
+
+    // This will say when do the groups start in the `infected` vector
+    entity_indices.assign(this->entities.size(), 0u);
+    for (size_t i = 1u; i < this->entities.size(); ++i)
+    {
+
+        entity_indices[i] +=
+            this->entities[i - 1].size() +
+            entity_indices[i - 1]
+            ;
+
+    }
+
+    // Adjusting contact rate
+    adjusted_contact_rate.assign(this->entities.size(), 0.0);
+
+    for (size_t i = 0u; i < this->entities.size(); ++i)
+    {
+
+        adjusted_contact_rate[i] =
+            1.0 /
+                static_cast< epiworld_double > (this->get_entity(i).size());
+
+
+        // Possibly correcting for a small number of agents
+        if (adjusted_contact_rate[i] > 1.0)
+            adjusted_contact_rate[i] = 1.0;
+
+    }
+
+    this->update_infected_list();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixing<TSeq>::read_checkpoint_derived(std::istream &)
+{
+
+    this->setup_groups();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixing<TSeq>::reset()
+{
+
+    Model<TSeq>::reset();
+
+    this->setup_groups();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline std::unique_ptr<Model<TSeq>> ModelSEIRMixing<TSeq>::clone_ptr()
+{
+
+    return std::make_unique<ModelSEIRMixing<TSeq>>(*this);
+
+}
+
+template<typename TSeq>
+inline ModelSEIRMixing<TSeq> & ModelSEIRMixing<TSeq>::aggregated_on(
+    std::vector< size_t > group_sizes
+)
+{
+
+    this->validate_contact_matrix(group_sizes.size());
+    this->aggregated_enable(std::move(group_sizes));
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline ModelSEIRMixing<TSeq> & ModelSEIRMixing<TSeq>::aggregated_off()
+{
+
+    this->aggregated_disable();
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & ModelSEIRMixing<TSeq>::run_aggregated(
+    epiworld_fast_uint ndays
+)
+{
+
+    const size_t ngroups = this->aggregated_sizes.size();
+    this->validate_contact_matrix(ngroups);
+
+    // Initial infections (exposed), spread across groups
+    std::vector< int > S(ngroups), I(ngroups), R(ngroups);
+    std::vector< int > E = this->aggregated_split(prevalence);
+    for (size_t g = 0u; g < ngroups; ++g)
+    {
+
+        int size_g = static_cast< int >(this->aggregated_sizes[g]);
+
+        if (proportions.size() > 0u)
+        {
+            I[g] = this->rbinom(E[g], proportions[0u]);
+            R[g] = this->rbinom(size_g - E[g], proportions[1u]);
+        }
+        else
+        {
+            I[g] = 0;
+            R[g] = 0;
+        }
+
+        E[g] -= I[g];
+        S[g] = size_g - E[g] - I[g] - R[g];
+
+    }
+
+    std::vector< int > totals = {0, 0, 0, 0};
+    for (size_t g = 0u; g < ngroups; ++g)
+    {
+        totals[SUSCEPTIBLE] += S[g];
+        totals[EXPOSED]     += E[g];
+        totals[INFECTED]    += I[g];
+        totals[RECOVERED]   += R[g];
+    }
+
+    this->aggregated_setup(ndays, totals, {false, true, true, false});
+
+    auto & virus = this->get_virus(0u);
+    std::vector< int > new_exposed(ngroups), new_infected(ngroups),
+        new_recovered(ngroups);
+
+    for (epiworld_fast_uint niter = 0; niter < this->get_ndays(); ++niter)
+    {
+
+        epiworld_double p_transmit = virus.get_prob_infecting(this);
+        epiworld_double p_recover  = virus.get_prob_recovery(this);
+        epiworld_double p_onset    = 1.0 / virus.get_incubation(this);
+
+        // All draws use the counts at the start of the day
+        for (size_t i = 0u; i < ngroups; ++i)
+        {
+
+            epiworld_double p_escape =
+                this->aggregated_escape(*this, i, I, p_transmit);
+
+            new_exposed[i]   = this->rbinom(S[i], 1.0 - p_escape);
+            new_infected[i]  = this->rbinom(E[i], p_onset);
+            new_recovered[i] = this->rbinom(I[i], p_recover);
+
+        }
+
+        for (size_t i = 0u; i < ngroups; ++i)
+        {
+
+            S[i] -= new_exposed[i];
+            E[i] += new_exposed[i] - new_infected[i];
+            I[i] += new_infected[i] - new_recovered[i];
+            R[i] += new_recovered[i];
+
+            this->aggregated_move(SUSCEPTIBLE, EXPOSED, new_exposed[i]);
+            this->aggregated_move(EXPOSED, INFECTED, new_infected[i]);
+            this->aggregated_move(INFECTED, RECOVERED, new_recovered[i]);
+
+        }
+
+        this->run_globalevents();
+
+        this->next();
+
+    }
+
+    this->aggregated_end();
+
+    return *this;
+
+}
+
+
+template<typename TSeq>
+inline bool ModelSEIRMixing<TSeq>::update_state_static()
+{
+    return this->template update_state_table<
+        _update_susceptible,
+        _update_exposed_and_infected,
+        _update_exposed_and_infected,
+        nullptr
+        >();
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixing<TSeq>::_update_susceptible(
+    Agent<TSeq> * p, Model<TSeq> * m
+    )
+{
+
+    if (p->get_n_entities() == 0)
+        return;
+
+    // Downcasting to retrieve the sampler attached to the
+    // class
+    auto * m_down = model_cast<ModelSEIRMixing<TSeq>, TSeq>(m);
+
+    size_t ndraws = m_down->sample_agents(p, m_down->sampled_agents);
+
+    #ifdef EPI_DEBUG
+    m_down->sampled_sizes.push_back(static_cast<int>(ndraws));
+    #endif
+
+    if (ndraws == 0u)
+        return;
+
+    // Drawing from the set
+    int nviruses_tmp = 0;
+    auto & m_ref = *m;
+    for (size_t n = 0u; n < ndraws; ++n)
+    {
+
+        auto & neighbor = m->get_agent(m_down->sampled_agents[n]);
+
+        auto & v = neighbor.get_virus();
+
+        #ifdef EPI_DEBUG
+        if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+            throw std::logic_error(
+                "Trying to add an extra element to a temporal array outside of the range."
+            );
+        #endif
+
+        /* And it is a function of susceptibility_reduction as well */
+        m->array_double_tmp[nviruses_tmp] =
+            (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
+            v->get_prob_infecting(m) *
+            (1.0 - neighbor.get_transmission_reduction(v, m_ref))
+            ;
+
+        m->array_virus_tmp[nviruses_tmp++] = &(*v);
+
+    }
+
+    // Running the roulette
+    int which = roulette(nviruses_tmp, m);
+
+    if (which < 0)
+        return;
+
+    p->set_virus(*m, 
+        *m->array_virus_tmp[which],
+        ModelSEIRMixing<TSeq>::EXPOSED
+        );
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixing<TSeq>::_update_exposed_and_infected(
+    Agent<TSeq> * p, Model<TSeq> * m
+    )
+{
+
+    auto state = p->get_state();
+
+    if (state == ModelSEIRMixing<TSeq>::EXPOSED)
+    {
+
+        // Getting the virus
+        auto & v = p->get_virus();
+
+        // Does the agent become infected?
+        if (m->runif() < 1.0/(v->get_incubation(m)))
+        {
+
+            p->change_state(*m, ModelSEIRMixing<TSeq>::INFECTED);
+            return;
+
+        }
+
+
+    } else if (state == ModelSEIRMixing<TSeq>::INFECTED)
+    {
+
+
+        // Odd: Die, Even: Recover
+        epiworld_fast_uint n_events = 0u;
+        auto & v = p->get_virus();
+
+        // Recover
+        m->array_double_tmp[n_events++] =
+            1.0 - (1.0 - v->get_prob_recovery(m)) *
+                (1.0 - p->get_recovery_enhancer(v, *m));
+
+        #ifdef EPI_DEBUG
+        if (n_events == 0u)
+        {
+            printf_epiworld(
+                "[epi-debug] agent %i has 0 possible events!!\n",
+                static_cast<int>(p->get_id())
+                );
+            throw std::logic_error("Zero events in exposed.");
+        }
+        #else
+        if (n_events == 0u)
+            return;
+        #endif
+
+
+        // Running the roulette
+        int which = roulette(n_events, m);
+
+        if (which < 0)
+            return;
+
+        // Which roulette happen?
+        p->rm_virus(*m);
+
+        return ;
+
+    } else
+        throw std::logic_error("This function can only be applied to exposed or infected individuals. (SEIR)") ;
+
+    return;
+
+}
+
+/**
+ * @brief Template for a Susceptible-Exposed-Infected-Removed (SEIR) model
+ *
+ * @param model A Model<TSeq> object where to set up the SIR.
+ * @param vname std::string Name of the virus
+ * @param prevalence Initial prevalence (proportion)
+ * @param transmission_rate Probability of transmission
+ * @param recovery_rate Probability of recovery
+ * @param contact_matrix Contact matrix specifying expected contacts between groups.
+ * Each entry (i,j) represents the expected number of contacts an agent in
+ * group i has with agents in group j per day.
+ */
+template<typename TSeq>
+inline ModelSEIRMixing<TSeq>::ModelSEIRMixing(
+    const std::string & vname,
+    epiworld_fast_uint n,
+    epiworld_double prevalence,
+    epiworld_double transmission_rate,
+    epiworld_double avg_incubation_days,
+    epiworld_double recovery_rate,
+    std::vector< double > contact_matrix
+    )
+{
+
+    // Setting up the contact matrix
+    this->set_contact_matrix(contact_matrix, true);
+
+    this->prevalence = prevalence;
+
+    // Setting up parameters
+    this->add_param(transmission_rate, "Prob. Transmission");
+    this->add_param(recovery_rate, "Prob. Recovery");
+    this->add_param(avg_incubation_days, "Avg. Incubation days");
+
+    // state
+    this->add_state("Susceptible", _update_susceptible);
+    this->add_state("Exposed", _update_exposed_and_infected);
+    this->add_state("Infected", _update_exposed_and_infected);
+    this->add_state("Recovered");
+
+    // Global function
+    GlobalFun<TSeq> update = [](Model<TSeq> * m) -> void
+    {
+
+        auto * m_down = model_cast<ModelSEIRMixing<TSeq>, TSeq>(m);
+
+        m_down->update_infected_list();
+
+        return;
+
+    };
+
+    this->add_globalevent(update, "Update infected individuals");
+
+
+    // Preparing the virus -------------------------------------------
+    Virus<TSeq> virus(vname, prevalence, true);
+    virus.set_state(EXPOSED, RECOVERED, RECOVERED);
+
+    virus.set_prob_infecting("Prob. Transmission");
+    virus.set_prob_recovery("Prob. Recovery");
+    virus.set_incubation("Avg. Incubation days");
+
+    this->add_virus(virus);
+
+    this->queuing_off(); // No queuing need
+
+    // Adding the empty population
+    this->agents_empty_graph(n);
+
+    this->set_name("Susceptible-Exposed-Infected-Removed (SEIR) with Mixing");
+
+}
+
+template<typename TSeq>
+inline ModelSEIRMixing<TSeq> & ModelSEIRMixing<TSeq>::initial_states(
+    std::vector< double > proportions_,
+    std::vector< int > /* queue_ */
+)
+{
+
+    Model<TSeq>::initial_states_fun =
+        create_init_function_seir<TSeq>(proportions_)
+        ;
+
+    proportions = proportions_;
+
+    return *this;
+
+}
+#undef MM
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/seirmixing.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/sirmixing.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_SIRMIXING_HPP
+#define EPIWORLD_MODELS_SIRMIXING_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+/**
+ * @file sirmixing.hpp
+ * @brief Template for a Susceptible-Infected-Removed (SIR) model with mixing
+ * 
+ * ![Model Diagram](../assets/img/sirmixing.png)
+ * 
+ * **Implementation details:**
+ * <a href="../impl/mixing-and-entity-distribution.md">Mixing and Entity Distribution</a>,
+ * <a href="../impl/sampling-contacts.md">Sampling Contacts</a>
+ * 
+ * @ingroup mixing_models
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSIRMixing :
+    public Model<TSeq>,
+    public ContactMatrix
+{
+private:
+
+    // Vector of infected agents
+    std::vector< epiworld_agent_index > infected;
+    size_t n_infected;
+
+    // Number of infected agents in each group
+    std::vector< size_t > n_infected_per_group;
+
+    // Where the agents start in the `infected` vector
+    std::vector< size_t > entity_indices;
+
+    void update_infected_list();
+    void setup_groups(); ///< Sizes and fills the lists by group.
+    void read_checkpoint_derived(std::istream & in) override;
+    std::vector< epiworld_agent_index > sampled_agents;
+    size_t sample_agents(
+        Agent<TSeq> * agent,
+        std::vector< epiworld_agent_index > & sampled_agents
+        );
+
+    std::vector< double > adjusted_contact_rate;
+
+    size_t index(size_t i, size_t j, size_t n) {
+        return j * n + i;
+    }
+
+    // Aggregated mode (see aggregated_on())
+    epiworld_double prevalence;
+    std::vector< double > proportions = {};
+    Model<TSeq> & run_aggregated(epiworld_fast_uint ndays) override;
+
+public:
+
+    static const int SUSCEPTIBLE = 0;
+    static const int INFECTED    = 1;
+    static const int RECOVERED   = 2;
+
+    ModelSIRMixing() = delete;
+
+    /**
+     * @brief Constructs a ModelSIRMixing object.
+     *
+     * @param vname The name of the ModelSIRMixing object.
+     * @param n The number of agents in the model.
+     * @param prevalence The initial prevalence of the disease in the model.
+     * @param transmission_rate The transmission rate of the disease in the model.
+     * @param recovery_rate The recovery rate of the disease in the model.
+     * @param contact_matrix The contact matrix between entities in the model.
+     * Specified in column-major order. Each entry (i,j) represents the
+     * expected number of contacts an agent in group i has with agents in
+     * group j per day. Entry (i,j) is located at `contact_matrix[j * n + i]`.
+     */
+    ModelSIRMixing(
+        const std::string & vname,
+        epiworld_fast_uint n,
+        epiworld_double prevalence,
+        epiworld_double transmission_rate,
+        epiworld_double recovery_rate,
+        std::vector< double > contact_matrix
+    );
+
+    void reset() override;
+
+    std::unique_ptr< Model<TSeq> > clone_ptr() override;
+
+    /**
+     * @brief Set the initial states of the model
+     * @param proportions_ Double vector with a single element:
+     * - The proportion of non-infected individuals who have recovered.
+    */
+    ModelSIRMixing<TSeq> & initial_states(
+        std::vector< double > proportions_,
+        std::vector< int > queue_ = {}
+    ) override;
+
+    size_t get_n_infected(size_t group) const
+    {
+        return n_infected_per_group[group];
+    }
+
+    /**
+     * @name Aggregated mode
+     * @details In aggregated mode, the model keeps counts per group and
+     * state instead of agents. Each day, a susceptible in group `i`
+     * escapes infection from the `I_g` infected in group `g` with
+     * probability \f$(1 - p\,c_{ig}/N_g)^{I_g}\f$, which is what the
+     * agent-based model gives by drawing contacts with the infected
+     * and trying to transmit to each. New infections and recoveries are
+     * then binomial draws from the counts at the start of the day. The
+     * population is released, so memory does not grow with the number of
+     * agents, and the database (e.g., `get_hist_total()`, `write_data()`)
+     * is filled as in the agent-based model.
+     *
+     * Initial infections follow the prevalence passed to the constructor
+     * (spread across groups in proportion to their size), and the
+     * proportions from `initial_states()` are drawn per group. Tools,
+     * entities, and virus distribution functions are not used, and the
+     * virus probabilities must not depend on the agent. Transmission
+     * events are not recorded.
+     *
+     * @param group_sizes Number of agents in each group (one per row of
+     * the contact matrix).
+     */
+    ///@{
+    ModelSIRMixing<TSeq> & aggregated_on(std::vector< size_t > group_sizes);
+    ModelSIRMixing<TSeq> & aggregated_off(); ///< Restores the agents.
+    ///@}
+
+};
+
+template<typename TSeq>
+inline void ModelSIRMixing<TSeq>::update_infected_list()
+{
+    auto & agents = this->get_agents();
+
+    std::fill(n_infected_per_group.begin(), n_infected_per_group.end(), 0u);
+    n_infected = 0;
+
+    for (auto & a : agents)
+    {
+        if (a.get_state() == ModelSIRMixing<TSeq>::INFECTED)
+        {
+            if (a.get_n_entities() > 0u)
+            {
+                const auto & entity = a.get_entity(0u, *this);
+                infected[
+                    // Position of the group in the `infected` vector
+                    entity_indices[entity.get_id()] +
+                    // Position of the agent in the group
+                    n_infected_per_group[entity.get_id()]++
+                ] = a.get_id();
+
+                // Incrementing the overall counter
+                n_infected++;
+            }
+        }
+    }
+
+    return;
+}
+
+template<typename TSeq>
+inline size_t ModelSIRMixing<TSeq>::sample_agents(
+    Agent<TSeq> * agent,
+    std::vector< epiworld_agent_index > & sampled_agents
+    )
+{
+
+    size_t agent_group_id = agent->get_entity(0u, *this).get_id();
+    size_t ngroups = this->entities.size();
+
+    int samp_id = 0;
+    for (size_t g = 0; g < ngroups; ++g)
+    {
+
+        size_t group_size = n_infected_per_group[g];
+
+        // How many from this entity?
+        int nsamples = this->rbinom(
+            group_size,
+            adjusted_contact_rate[g] * this->get_contact_rate(agent_group_id, g, false)
+        );
+
+        if (nsamples == 0)
+            continue;
+
+        // Sampling from the entity
+        for (int s = 0; s < nsamples; ++s)
+        {
+
+            // Randomly selecting an agent
+            int which = this->runif() * group_size;
+
+            // Correcting overflow error
+            if (which >= static_cast<int>(group_size))
+                which = static_cast<int>(group_size) - 1;
+
+            #ifdef EPI_DEBUG
+            auto & a = this->population.at(infected.at(entity_indices[g] + which));
+            #else
+            auto & a = this->get_agent(infected[entity_indices[g] + which]);
+            #endif
+
+            #ifdef EPI_DEBUG
+            if (a.get_state() != ModelSIRMixing<TSeq>::INFECTED)
+                throw std::logic_error(
+                    "The agent is not infected, but it should be."
+                );
+            #endif
+
+            // Can't sample itself
+            if (a.get_id() == agent->get_id())
+                continue;
+
+            sampled_agents[samp_id++] = a.get_id();
+
+        }
+
+    }
+
+    return samp_id;
+
+}
+
+template<typename TSeq>
+inline void ModelSIRMixing<TSeq>::setup_groups()
+{
+
+    // Checking contact matrix dimensions
+    size_t nentities = this->entities.size();
+    this->validate_contact_matrix(nentities);
+
+    // Do it the first time only
+    sampled_agents.resize(this->size());
+
+    // We only do it once
+    n_infected_per_group.assign(this->entities.size(), 0u);
+
+    // We are assuming one agent per entity
+    infected.assign(this->size(), 0u);
+
+    // This will say when do the groups start in the `infected` vector
+    entity_indices.assign(this->entities.size(), 0u);
+    for (size_t i = 1u; i < this->entities.size(); ++i)
+    {
+        entity_indices[i] +=
+            this->entities[i - 1].size() +
+            entity_indices[i - 1]
+            ;
+    }
+
+    // Adjusting contact rate
+    adjusted_contact_rate.assign(this->entities.size(), 0.0);
+
+    for (size_t i = 0u; i < this->entities.size(); ++i)
+    {
+        adjusted_contact_rate[i] =
+            1.0 /
+                static_cast< epiworld_double > (this->get_entity(i).size());
+
+        // Possibly correcting for a small number of agents
+        if (adjusted_contact_rate[i] > 1.0)
+            adjusted_contact_rate[i] = 1.0;
+    }
+
+    this->update_infected_list();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSIRMixing<TSeq>::read_checkpoint_derived(std::istream &)
+{
+
+    this->setup_groups();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSIRMixing<TSeq>::reset()
+{
+
+    Model<TSeq>::reset();
+
+    this->setup_groups();
+
+    return;
+}
+
+template<typename TSeq>
+inline std::unique_ptr<Model<TSeq>> ModelSIRMixing<TSeq>::clone_ptr()
+{
+
+    return std::make_unique<ModelSIRMixing<TSeq>>(*this);
+
+}
+
+template<typename TSeq>
+inline ModelSIRMixing<TSeq> & ModelSIRMixing<TSeq>::aggregated_on(
+    std::vector< size_t > group_sizes
+)
+{
+
+    this->validate_contact_matrix(group_sizes.size());
+    this->aggregated_enable(std::move(group_sizes));
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline ModelSIRMixing<TSeq> & ModelSIRMixing<TSeq>::aggregated_off()
+{
+
+    this->aggregated_disable();
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & ModelSIRMixing<TSeq>::run_aggregated(
+    epiworld_fast_uint ndays
+)
+{
+
+    const size_t ngroups = this->aggregated_sizes.size();
+    this->validate_contact_matrix(ngroups);
+
+    // Initial infections, spread across groups
+    std::vector< int > S(ngroups), R(ngroups);
+    std::vector< int > I = this->aggregated_split(prevalence);
+    for (size_t g = 0u; g < ngroups; ++g)
+    {
+
+        int size_g = static_cast< int >(this->aggregated_sizes[g]);
+
+        R[g] = proportions.size() > 0u ?
+            this->rbinom(size_g - I[g], proportions[0u]) : 0;
+
+        S[g] = size_g - I[g] - R[g];
+
+    }
+
+    std::vector< int > totals = {0, 0, 0};
+    for (size_t g = 0u; g < ngroups; ++g)
+    {
+        totals[SUSCEPTIBLE] += S[g];
+        totals[INFECTED]    += I[g];
+        totals[RECOVERED]   += R[g];
+    }
+
+    this->aggregated_setup(ndays, totals, {false, true, false});
+
+    auto & virus = this->get_virus(0u);
+    std::vector< int > new_infected(ngroups), new_recovered(ngroups);
+    n_infected_per_group.assign(ngroups, 0u);
+    for (epiworld_fast_uint niter = 0; niter < this->get_ndays(); ++niter)
+    {
+
+        epiworld_double p_transmit = virus.get_prob_infecting(this);
+        epiworld_double p_recover  = virus.get_prob_recovery(this);
+
+        // All draws use the counts at the start of the day
+        for (size_t i = 0u; i < ngroups; ++i)
+        {
+
+            epiworld_double p_escape =
+                this->aggregated_escape(*this, i, I, p_transmit);
+
+            new_infected[i]  = this->rbinom(S[i], 1.0 - p_escape);
+            new_recovered[i] = this->rbinom(I[i], p_recover);
+
+        }
+
+        for (size_t i = 0u; i < ngroups; ++i)
+        {
+
+            S[i] -= new_infected[i];
+            I[i] += new_infected[i] - new_recovered[i];
+            R[i] += new_recovered[i];
+
+            this->aggregated_move(SUSCEPTIBLE, INFECTED, new_infected[i]);
+            this->aggregated_move(INFECTED, RECOVERED, new_recovered[i]);
+
+        }
+
+        this->run_globalevents();
+
+        // After the global events, which refresh the list from the agents
+        for (size_t i = 0u; i < ngroups; ++i)
+            n_infected_per_group[i] = static_cast< size_t >(I[i]);
+
+        this->next();
+
+    }
+
+    this->aggregated_end();
+
+    return *this;
+
+}
+
+
+/**
+ * @brief Template for a Susceptible-Exposed-Infected-Removed (SEIR) model
+ *
+ * @param model A Model<TSeq> object where to set up the SIR.
+ * @param vname std::string Name of the virus
+ * @param prevalence Initial prevalence (proportion)
+ * @param transmission_rate Probability of transmission
+ * @param recovery_rate Probability of recovery
+ * @param contact_matrix Contact matrix specifying expected contacts between groups.
+ * Each entry (i,j) represents the expected number of contacts an agent in
+ * group i has with agents in group j per day.
+ */
+template<typename TSeq>
+inline ModelSIRMixing<TSeq>::ModelSIRMixing(
+    const std::string & vname,
+    epiworld_fast_uint n,
+    epiworld_double prevalence,
+    epiworld_double transmission_rate,
+    epiworld_double recovery_rate,
+    std::vector< double > contact_matrix
+    )
+{
+
+    // Setting up the contact matrix
+    this->set_contact_matrix(contact_matrix, true);
+
+    this->prevalence = prevalence;
+
+    UpdateFun<TSeq> update_susceptible = [](
+        Agent<TSeq> * p, Model<TSeq> * m
+        ) -> void
+        {
+
+            if (p->get_n_entities() == 0)
+                return;
+
+            // Downcasting to retrieve the sampler attached to the
+            // class
+            auto * m_down = model_cast<ModelSIRMixing<TSeq>, TSeq>(m);
+
+            size_t ndraws = m_down->sample_agents(p, m_down->sampled_agents);
+
+            if (ndraws == 0u)
+                return;
+
+
+            // Drawing from the set
+            int nviruses_tmp = 0;
+            auto & m_ref = *m;
+            for (size_t n = 0u; n < ndraws; ++n)
+            {
+
+                auto & neighbor = m->get_agent(m_down->sampled_agents[n]);
+
+                auto & v = neighbor.get_virus();
+
+                #ifdef EPI_DEBUG
+                if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+                    throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
+                #endif
+
+                /* And it is a function of susceptibility_reduction as well */
+                m->array_double_tmp[nviruses_tmp] =
+                    (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
+                    v->get_prob_infecting(m) *
+                    (1.0 - neighbor.get_transmission_reduction(v, m_ref))
+                    ;
+
+                m->array_virus_tmp[nviruses_tmp++] = &(*v);
+
+            }
+
+            // Running the roulette
+            int which = roulette(nviruses_tmp, m);
+
+            if (which < 0)
+                return;
+
+            p->set_virus(*m, 
+                *m->array_virus_tmp[which],
+                ModelSIRMixing<TSeq>::INFECTED
+                );
+
+            return;
+
+        };
+
+    UpdateFun<TSeq> update_infected = [](
+        Agent<TSeq> * p, Model<TSeq> * m
+        ) -> void {
+
+            auto state = p->get_state();
+
+            if (state == ModelSIRMixing<TSeq>::INFECTED)
+            {
+
+
+                // Odd: Die, Even: Recover
+                epiworld_fast_uint n_events = 0u;
+                auto & v = p->get_virus();
+
+                // Recover
+                m->array_double_tmp[n_events++] =
+                    1.0 - (1.0 - v->get_prob_recovery(m)) * (1.0 - p->get_recovery_enhancer(v, *m));
+
+                #ifdef EPI_DEBUG
+                if (n_events == 0u)
+                {
+                    printf_epiworld(
+                        "[epi-debug] agent %i has 0 possible events!!\n",
+                        static_cast<int>(p->get_id())
+                        );
+                    throw std::logic_error("Zero events in infected.");
+                }
+                #else
+                if (n_events == 0u)
+                    return;
+                #endif
+
+
+                // Running the roulette
+                int which = roulette(n_events, m);
+
+                if (which < 0)
+                    return;
+
+                // Which roulette happen?
+                p->rm_virus(*m);
+
+                return ;
+
+            } else
+                throw std::logic_error("This function can only be applied to infected individuals. (SIR)") ;
+
+            return;
+
+        };
+
+    // Setting up parameters
+    this->add_param(transmission_rate, "Prob. Transmission");
+    this->add_param(recovery_rate, "Prob. Recovery");
+
+    // state
+    this->add_state("Susceptible", update_susceptible);
+    this->add_state("Infected", update_infected);
+    this->add_state("Recovered");
+
+    // Global function
+    GlobalFun<TSeq> update = [](Model<TSeq> * m) -> void
+    {
+
+        auto * m_down = model_cast<ModelSIRMixing<TSeq>, TSeq>(m);
+
+        m_down->update_infected_list();
+
+        return;
+
+    };
+
+    this->add_globalevent(update, "Update infected individuals");
+
+
+    // Preparing the virus -------------------------------------------
+    Virus<TSeq> virus(vname, prevalence, true);
+    virus.set_state(INFECTED, RECOVERED, RECOVERED);
+
+    virus.set_prob_infecting("Prob. Transmission");
+    virus.set_prob_recovery("Prob. Recovery");
+
+    this->add_virus(virus);
+
+    this->queuing_off(); // No queuing need
+
+    // Adding the empty population
+    this->agents_empty_graph(n);
+
+    this->set_name("Susceptible-Infected-Removed (SIR) with Mixing");
+
+    return;
+
+}
+
+template<typename TSeq>
+inline ModelSIRMixing<TSeq> & ModelSIRMixing<TSeq>::initial_states(
+    std::vector< double > proportions_,
+    std::vector< int > /* queue_ */
+)
+{
+
+    Model<TSeq>::initial_states_fun =
+        create_init_function_sir<TSeq>(proportions_)
+        ;
+
+    proportions = proportions_;
+
+    return *this;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/sirmixing.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/seirmixingquarantine.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_SEIRMIXINGQUARANTINE_HPP
+#define EPIWORLD_MODELS_SEIRMIXINGQUARANTINE_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+// (already included include/epiworld/models/../contactmatrix-bones.hpp)
+
+/**
+ * @file seirmixingquarantine.hpp
+ * @brief Template for a Susceptible-Exposed-Infected-Removed (SEIR) model with mixing, quarantine, and contact tracing
+ */
+
+/**
+ * @brief SEIR model with mixing, quarantine, and contact tracing
+ *
+ * This class implements a Susceptible-Exposed-Infected-Removed (SEIR) epidemiological model
+ * with additional features including:
+ *
+ * - Population mixing based on contact matrices
+ * - Quarantine measures for exposed contacts
+ * - Isolation policies for detected infected individuals
+ * - Contact tracing with configurable success rates
+ * - Hospitalization of severe cases
+ * - Individual willingness to comply with public health measures
+ *
+ * The model supports 9 distinct states:
+ *
+ * - Susceptible: Individuals who can become infected
+ * - Exposed: Infected but not yet infectious (incubation period)
+ * - Infected: Infectious individuals in the community
+ * - Isolated: Detected infected individuals in self-isolation
+ * - Quarantined Susceptible: Susceptible individuals in quarantine due to contact tracing
+ * - Quarantined Exposed: Exposed individuals in quarantine due to contact tracing
+ * - Isolated Recovered: Recovered individuals still in isolation
+ * - Hospitalized: Individuals requiring hospital care
+ * - Recovered: Individuals who have recovered and gained immunity
+ *
+ * ![Model Diagram](../assets/img/seirmixingquarantine.png)
+ *
+ * @tparam TSeq Type for genetic sequences (default: EPI_DEFAULT_TSEQ)
+ * @ingroup mixing_models
+ * 
+ * **Implementation details:**
+ * <a href="../impl/quarantine-isolation-and-contact-tracing.md">Quarantine, Isolation, and Contact Tracing</a>,
+ * <a href="../impl/mixing-and-entity-distribution.md">Mixing and Entity Distribution</a>,
+ * <a href="../impl/sampling-contacts.md">Sampling Contacts</a>
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSEIRMixingQuarantine :
+    public Model<TSeq>,
+    public ContactMatrix
+{
+private:
+
+    // Vector of vectors of infected agents
+    std::vector< epiworld_agent_index > infected;
+
+    // Number of infected agents in each group
+    std::vector< size_t > n_infected_per_group;
+
+    // Where the agents start in the `infected` vector
+    std::vector< size_t > entity_indices;
+
+    void _update_infected_list();
+    void _setup_groups(); ///< Sizes and fills the lists by group.
+    void write_checkpoint_derived(std::ostream & out) const override;
+    void read_checkpoint_derived(std::istream & in) override;
+    std::vector< epiworld_agent_index > sampled_agents;
+    size_t _sample_agents(
+        Agent<TSeq> * agent,
+        std::vector< epiworld_agent_index > & sampled_agents
+        );
+    std::vector< double > adjusted_contact_rate;
+
+    #ifdef EPI_DEBUG
+    std::vector< int > sampled_sizes;
+    #endif
+
+    // Update functions
+    static void _update_susceptible(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_exposed(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_infected(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_isolated(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_quarantine_suscep(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_quarantine_exposed(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_hospitalized(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_isolated_recovered(Agent<TSeq> * p, Model<TSeq> * m);
+
+    // Data about the quarantine process
+    std::vector< bool > quarantine_willingness; ///< Indicator
+    std::vector< bool > isolation_willingness; ///< Indicator for isolation willingness
+    std::vector< size_t > agent_quarantine_triggered; ///< Whether the quarantine process has started
+    std::vector< int > day_flagged; ///< Either detected or started quarantine
+    std::vector< int > day_onset; ///< Day of onset of the disease
+    std::vector< int > day_exposed; ///< Day of exposure
+
+    static void _quarantine_process(Model<TSeq> * m);
+
+public:
+
+    static const int SUSCEPTIBLE             = 0;
+    static const int EXPOSED                 = 1;
+    static const int INFECTED                = 2;
+    static const int ISOLATED                = 3;
+    static const int QUARANTINED_SUSCEPTIBLE = 4;
+    static const int QUARANTINED_EXPOSED     = 5;
+    static const int ISOLATED_RECOVERED      = 6;
+    static const int HOSPITALIZED            = 7;
+    static const int RECOVERED               = 8;
+
+    static const size_t QUARANTINE_PROCESS_INACTIVE = 0u;
+    static const size_t QUARANTINE_PROCESS_ACTIVE   = 1u;
+    static const size_t QUARANTINE_PROCESS_DONE     = 2u;
+
+    ModelSEIRMixingQuarantine() = delete;
+
+    /**
+     * @brief Constructs a ModelSEIRMixingQuarantine object.
+     *
+     * @param vname The name of the ModelSEIRMixingQuarantine object.
+     * @param n The number of agents in the model.
+     * @param prevalence The initial prevalence of the disease in the model.
+     * @param transmission_rate The transmission rate of the disease in the model.
+     * @param avg_incubation_days The average incubation period of the disease in the model.
+     * @param recovery_rate The recovery rate of the disease in the model.
+     * @param contact_matrix The contact matrix between entities in the model.
+     * Specified in column-major order. Each entry (i,j) represents the
+     * expected number of contacts an agent in group i has with agents in
+     * group j per day.
+     * @param hospitalization_rate The rate at which infected individuals are hospitalized.
+     * @param hospitalization_period The average duration of hospitalization in days.
+     * @param days_undetected The average number of days an infected individual remains undetected.
+     * @param quarantine_period The duration of quarantine in days for exposed contacts.
+     * @param quarantine_willingness The proportion of individuals willing to comply with quarantine measures.
+     * @param isolation_willingness The proportion of individuals willing to self-isolate when detected.
+     * @param isolation_period The duration of isolation in days for detected infected individuals.
+     * @param contact_tracing_success_rate The probability of successfully identifying and tracing contacts (default: 1.0).
+     * @param contact_tracing_days_prior The number of days prior to detection for which contacts are traced (default: 4).
+     */
+    ModelSEIRMixingQuarantine(
+        const std::string & vname,
+        epiworld_fast_uint n,
+        epiworld_double prevalence,
+        epiworld_double transmission_rate,
+        epiworld_double avg_incubation_days,
+        epiworld_double recovery_rate,
+        std::vector< double > contact_matrix,
+        epiworld_double hospitalization_rate,
+        epiworld_double hospitalization_period,
+        // Policy parameters
+        epiworld_double days_undetected,
+        epiworld_fast_int quarantine_period,
+        epiworld_double quarantine_willingness,
+        epiworld_double isolation_willingness,
+        epiworld_fast_int isolation_period,
+        epiworld_double contact_tracing_success_rate = 1.0,
+        epiworld_fast_uint contact_tracing_days_prior = 4u
+    );
+
+    /**
+     * @brief Reset the model to initial state
+     */
+    void reset() override;
+
+    /**
+     * @brief Create a clone of this model
+     * @return Pointer to a new model instance with the same configuration
+     */
+    std::unique_ptr< Model<TSeq> > clone_ptr() override;
+
+    /**
+     * @brief Set the initial states of the model
+     * @param proportions_ Double vector with two elements:
+     * - [0]: The proportion of initially infected individuals who start in the exposed state.
+     * - [1]: The proportion of initially non-infected individuals who have recovered (immune).
+     * @param queue_ Optional vector for queuing specifications (default: empty).
+     */
+    ModelSEIRMixingQuarantine<TSeq> & initial_states(
+        std::vector< double > proportions_,
+        std::vector< int > queue_ = {}
+    ) override;
+
+
+    /**
+     * @brief Get the quarantine trigger status for all agents
+     * @return Vector indicating quarantine process status for each agent
+     */
+    std::vector< size_t > get_agent_quarantine_triggered() const
+    {
+        return agent_quarantine_triggered;
+    };
+
+    /**
+     * @brief Get the quarantine willingness for all agents
+     * @return Vector of boolean values indicating each agent's willingness to quarantine
+     */
+    std::vector< bool > get_quarantine_willingness() const
+    {
+        return quarantine_willingness;
+    };
+
+    /**
+     * @brief Get the isolation willingness for all agents
+     * @return Vector of boolean values indicating each agent's willingness to self-isolate
+     */
+    std::vector< bool > get_isolation_willingness() const
+    {
+        return isolation_willingness;
+    };
+
+    void next() override;
+
+};
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::_update_infected_list()
+{
+
+    auto & agents = this->get_agents();
+
+    std::fill(n_infected_per_group.begin(), n_infected_per_group.end(), 0u);
+
+    // Resetting the number of available contacts
+    adjusted_contact_rate.assign(this->entities.size(), 0.0);
+
+    for (const auto & a : agents)
+    {
+
+        if (a.get_state() == INFECTED)
+        {
+            if (a.get_n_entities() > 0u)
+            {
+                const auto & entity = a.get_entity(0u, *this);
+                infected[
+                    // Position of the group in the `infected` vector
+                    entity_indices[entity.get_id()] +
+                    // Position of the agent in the group
+                    n_infected_per_group[entity.get_id()]++
+                ] = a.get_id();
+
+            }
+        }
+
+        // Setting how many agents are available for contact
+        if (
+            ((a.get_state() < ISOLATED) || (a.get_state() == RECOVERED)) &&
+            (a.get_n_entities() > 0u)
+        )
+        {
+            adjusted_contact_rate[
+                a.get_entity(0u, *this).get_id()
+            ] += 1.0;
+        }
+
+    }
+
+    // This simplifies calculations later
+    for (auto & rate: adjusted_contact_rate)
+    {
+        if (rate > 0.0)
+            rate = 1.0 / rate;
+        else
+            rate = 0.0;  // No available contacts in this group
+
+        if (rate > 1.0)
+            rate = 1.0;
+    }
+
+    return;
+
+}
+
+template<typename TSeq>
+inline size_t ModelSEIRMixingQuarantine<TSeq>::_sample_agents(
+    Agent<TSeq> * agent,
+    std::vector< epiworld_agent_index > & sampled_agents
+    )
+{
+
+    size_t agent_group_id = agent->get_entity(0u, *this).get_id();
+    size_t ngroups = this->entities.size();
+
+    int samp_id = 0;
+    for (size_t g = 0; g < ngroups; ++g)
+    {
+
+        size_t group_size = n_infected_per_group[g];
+
+        if (group_size == 0u)
+            continue;
+
+        // How many from this entity?
+        int nsamples = this->rbinom(
+            group_size,
+            adjusted_contact_rate[g] *
+            get_contact_rate(agent_group_id, g, false)
+        );
+
+        if (nsamples == 0)
+            continue;
+
+        // Sampling from the entity
+        for (int s = 0; s < nsamples; ++s)
+        {
+
+            // Randomly selecting an agent
+            int which = this->runif() * group_size;
+
+            // Correcting overflow error
+            if (which >= static_cast<int>(group_size))
+                which = static_cast<int>(group_size) - 1;
+
+            #ifdef EPI_DEBUG
+            auto & a = this->population.at(infected.at(entity_indices[g] + which));
+            #else
+            auto & a = this->get_agent(infected[entity_indices[g] + which]);
+            #endif
+
+            #ifdef EPI_DEBUG
+            if (a.get_state() != INFECTED)
+                throw std::logic_error(
+                    "The agent is not infected, but it should be."
+                );
+            #endif
+
+            // Can't sample itself
+            if (a.get_id() == agent->get_id())
+                continue;
+
+            sampled_agents[samp_id++] = a.get_id();
+
+        }
+
+    }
+
+    return samp_id;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::_setup_groups()
+{
+
+    // Checking contact matrix dimensions
+    size_t nentities = this->entities.size();
+    this->validate_contact_matrix(nentities);
+
+    // Do it the first time only
+    sampled_agents.resize(this->size());
+
+    // We only do it once
+    n_infected_per_group.assign(this->entities.size(), 0u);
+
+    // We are assuming one agent per entity
+    infected.assign(this->size(), 0u);
+
+    // This will say when do the groups start in the `infected` vector
+    entity_indices.assign(this->entities.size(), 0u);
+    for (size_t i = 1u; i < this->entities.size(); ++i)
+    {
+
+        entity_indices[i] +=
+            this->entities[i - 1].size() +
+            entity_indices[i - 1]
+            ;
+
+    }
+
+    this->_update_infected_list();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::write_checkpoint_derived(std::ostream & out) const
+{
+
+    checkpoint_write(out, quarantine_willingness);
+    checkpoint_write(out, isolation_willingness);
+    checkpoint_write(out, agent_quarantine_triggered);
+    checkpoint_write(out, day_flagged);
+    checkpoint_write(out, day_onset);
+    checkpoint_write(out, day_exposed);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::read_checkpoint_derived(std::istream & in)
+{
+
+    this->_setup_groups();
+
+    checkpoint_read(in, quarantine_willingness);
+    checkpoint_read(in, isolation_willingness);
+    checkpoint_read(in, agent_quarantine_triggered);
+    checkpoint_read(in, day_flagged);
+    checkpoint_read(in, day_onset);
+    checkpoint_read(in, day_exposed);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::reset()
+{
+
+    Model<TSeq>::reset();
+
+    this->_setup_groups();
+
+    // Setting up the quarantine parameters
+    quarantine_willingness.resize(this->size(), false);
+    isolation_willingness.resize(this->size(), false);
+    for (size_t idx = 0; idx < quarantine_willingness.size(); ++idx)
+    {
+        quarantine_willingness[idx] =
+            this->runif() < this->par("Quarantine willingness");
+        isolation_willingness[idx] =
+            this->runif() < this->par("Isolation willingness");
+    }
+
+    agent_quarantine_triggered.assign(this->size(), 0u);
+    day_flagged.assign(this->size(), 0);
+    day_onset.assign(this->size(), 0);
+    day_exposed.assign(this->size(), 0);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline std::unique_ptr<Model<TSeq>> ModelSEIRMixingQuarantine<TSeq>::clone_ptr()
+{
+
+    return std::make_unique<ModelSEIRMixingQuarantine<TSeq>>(*this);
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::_update_susceptible(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    if (p->get_n_entities() == 0)
+        return;
+
+    // Downcasting to retrieve the sampler attached to the
+    // class
+    auto * m_down = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
+
+    size_t ndraws = m_down->_sample_agents(p, m_down->sampled_agents);
+
+    #ifdef EPI_DEBUG
+    m_down->sampled_sizes.push_back(static_cast<int>(ndraws));
+    #endif
+
+    if (ndraws == 0u)
+        return;
+
+    // Drawing from the set
+    int nviruses_tmp = 0;
+    auto & m_ref = *m;
+    for (size_t n = 0u; n < ndraws; ++n)
+    {
+
+        auto & neighbor = m->get_agent(m_down->sampled_agents[n]);
+
+        auto & v = neighbor.get_virus();
+
+        #ifdef EPI_DEBUG
+        if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+            throw std::logic_error(
+                "Trying to add an extra element to a temporal array outside of the range."
+            );
+        #endif
+
+        // Adding the current agent to the tracked interactions
+        m_down->get_contact_tracing().add_contact(neighbor.get_id(), p->get_id(), m->today());
+
+        /* And it is a function of susceptibility_reduction as well */
+        m->array_double_tmp[nviruses_tmp] =
+            (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
+            v->get_prob_infecting(m) *
+            (1.0 - neighbor.get_transmission_reduction(v, m_ref))
+            ;
+
+        m->array_virus_tmp[nviruses_tmp++] = &(*v);
+
+    }
+
+    // Running the roulette
+    int which = roulette(nviruses_tmp, m);
+
+    if (which < 0)
+        return;
+
+    p->set_virus(*m, 
+        *m->array_virus_tmp[which],
+        ModelSEIRMixingQuarantine<TSeq>::EXPOSED
+        );
+
+    return;
+
+};
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::_update_exposed(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    // Getting the virus
+    auto & v = p->get_virus();
+
+    // Does the agent become infected?
+    if (m->runif() < 1.0/(v->get_incubation(m)))
+    {
+
+        p->change_state(*m, INFECTED);
+
+        auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
+        model->day_onset[p->get_id()] = m->today();
+
+    }
+
+    return;
+
+};
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::_update_infected(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    static const size_t par_days_undetected =
+        Model<TSeq>::param_id("Days undetected");
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
+    auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
+
+    // Sampling whether the agent is detected or not.
+    // If Days undetected < 0, detection is disabled (never detected).
+    // If Days undetected == 0, the agent is always detected.
+    epiworld_double days_undetected = m->par(par_days_undetected);
+    bool detected = (days_undetected < 0.0) ?
+        false : ((days_undetected == 0.0) ?
+            true : (m->runif() < 1.0 / days_undetected));
+
+    // If detected and the entity can quarantine, we start
+    // the quarantine process
+    if (detected)
+    {
+        model->agent_quarantine_triggered[p->get_id()] =
+            QUARANTINE_PROCESS_ACTIVE;
+    }
+
+    // Checking if the agent is willing to isolate individually
+    // This is separate from quarantine and can happen even if agent cannot quarantine
+    bool isolation_detected = (m->par(par_isolation_period) >= 0) &&
+        detected &&
+        (model->isolation_willingness[p->get_id()])
+    ;
+
+    // Recording the date of detection
+    if (isolation_detected)
+        model->day_flagged[p->get_id()] = m->today();
+
+    // Computing probabilities for state change
+    auto & v = p->get_virus();
+    m->array_double_tmp[0] = 1.0 - (1.0 - v->get_prob_recovery(m)) *
+        (1.0 - p->get_recovery_enhancer(v, *m));
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
+
+    auto which = m->sample_from_probs(2);
+
+    if (which == 0) // Recovers
+    {
+        if (isolation_detected)
+        {
+            p->change_state(*m, ISOLATED_RECOVERED);
+        }
+        else
+        {
+            p->rm_virus(*m, RECOVERED);
+        }
+
+        return;
+    }
+    else if (which == 1) // Hospitalized
+    {
+        m->record_hospitalization(*p);
+        p->change_state(*m, HOSPITALIZED);
+
+    }
+    else if ((which == 2) && isolation_detected) // Nothing, but detected
+    {
+        // If the agent is detected, it goes to isolation
+        p->change_state(*m, ISOLATED);
+
+    }
+
+    return ;
+
+};
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::_update_isolated(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
+    auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
+
+    // Figuring out if the agent can be released from isolation
+    // if the quarantine period is over.
+    int days_since = m->today() - model->day_onset[p->get_id()];
+
+    bool unisolate =
+        (m->par(par_isolation_period) <= days_since) ?
+        true: false;
+
+    // Sampling from the probabilities of recovery
+    m->array_double_tmp[0] = 1.0 -
+        (1.0 - p->get_virus()->get_prob_recovery(m)) *
+        (1.0 - p->get_recovery_enhancer(p->get_virus(), *m));
+
+    // And hospitalization
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
+
+    auto which = m->sample_from_probs(2);
+
+    // Recovers
+    if (which == 0)
+    {
+        if (unisolate)
+        {
+            p->rm_virus(*m, RECOVERED);
+        }
+        else
+            p->rm_virus(*m, ISOLATED_RECOVERED);
+    }
+    else if (which == 1)
+    {
+        m->record_hospitalization(*p);
+        p->change_state(*m, HOSPITALIZED);
+    }
+    else if ((which == 2) && unisolate)
+    {
+        p->change_state(*m, INFECTED);
+    }
+
+
+};
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::_update_quarantine_suscep(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
+    auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
+
+    // Figuring out if the agent can be released from quarantine
+    // if the quarantine period is over.
+    int days_since = m->today() - model->day_flagged[p->get_id()];
+
+    bool unquarantine =
+        (m->par(par_quarantine_period) <= days_since) ?
+        true: false;
+
+    if (unquarantine)
+    {
+        p->change_state(*m, 
+            ModelSEIRMixingQuarantine<TSeq>::SUSCEPTIBLE
+        );
+    }
+
+};
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::_update_quarantine_exposed(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
+    auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
+
+    // Figuring out if the agent can be released from quarantine
+    // if the quarantine period is over.
+    int days_since = m->today() - model->day_flagged[p->get_id()];
+
+    bool unquarantine =
+        (m->par(par_quarantine_period) <= days_since) ?
+        true: false;
+
+    if (m->runif() < 1.0/(p->get_virus()->get_incubation(m)))
+    {
+
+        // Recording the day of onset
+        model->day_onset[p->get_id()] = m->today();
+
+        // If the agent is unquarantined, it becomes infected
+        if (unquarantine)
+        {
+            p->change_state(*m, 
+                ModelSEIRMixingQuarantine<TSeq>::INFECTED
+            );
+        }
+        else
+        {
+            p->change_state(*m, 
+                ModelSEIRMixingQuarantine<TSeq>::ISOLATED
+            );
+        }
+
+    }
+    else if (unquarantine)
+    {
+        p->change_state(*m, 
+            ModelSEIRMixingQuarantine<TSeq>::EXPOSED
+        );
+    }
+
+};
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::_update_isolated_recovered(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+
+    auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
+
+    // Figuring out if the agent can be released from isolation
+    // if the quarantine period is over.
+    int days_since = m->today() - model->day_onset[p->get_id()];
+
+    bool unisolate =
+        (m->par(par_isolation_period) <= days_since) ?
+        true: false;
+
+    if (unisolate)
+    {
+        p->change_state(*m, 
+            ModelSEIRMixingQuarantine<TSeq>::RECOVERED
+        );
+    }
+
+};
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::_update_hospitalized(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    static const size_t par_hospitalization_period =
+        Model<TSeq>::param_id("Hospitalization period");
+
+    // The agent is removed from the system
+    if (m->runif() < 1.0/m->par(par_hospitalization_period))
+        p->rm_virus(*m, ModelSEIRMixingQuarantine<TSeq>::RECOVERED);
+
+};
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::_quarantine_process(Model<TSeq> * m) {
+
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+    static const size_t par_contact_tracing_success_rate =
+        Model<TSeq>::param_id("Contact tracing success rate");
+    static const size_t par_contact_tracing_days_prior =
+        Model<TSeq>::param_id("Contact tracing days prior");
+
+    auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
+
+    // Process entity-level quarantine
+    for (size_t agent_i = 0u; agent_i < m->size(); ++agent_i)
+    {
+
+        // Checking if the quarantine in the agent was triggered
+        // or not
+        if (
+            model->agent_quarantine_triggered[agent_i] !=
+            ModelSEIRMixingQuarantine<TSeq>::QUARANTINE_PROCESS_ACTIVE
+        )
+            continue;
+
+        if (m->par(par_quarantine_period) < 0)
+        {
+            model->agent_quarantine_triggered[agent_i] =
+            ModelSEIRMixingQuarantine<TSeq>::QUARANTINE_PROCESS_DONE;
+            continue;
+        }
+
+        // Getting the number of contacts, if it is greater
+        // than the maximum, it means that we overflowed, so
+        // we will only quarantine the first EPI_MAX_TRACKING
+        auto & ct = m->get_contact_tracing();
+        size_t n_contacts = ct.get_n_contacts(agent_i);
+        if (n_contacts >= EPI_MAX_TRACKING)
+            n_contacts = EPI_MAX_TRACKING;
+
+        auto success_rate = m->par(par_contact_tracing_success_rate);
+        auto days_prior = m->par(par_contact_tracing_days_prior);
+        for (size_t contact_i = 0u; contact_i < n_contacts; ++contact_i)
+        {
+
+            // Checking if we will detect the contact
+            if (m->runif() > success_rate)
+                continue;
+
+            auto [contact_id, contact_date] = ct.get_contact(
+                agent_i, contact_i
+            );
+
+            // Skip contacts outside the tracing window
+            if ((static_cast<double>(m->today()) -
+                static_cast<double>(contact_date)) > days_prior)
+                continue;
+
+            auto & agent = m->get_agent(contact_id);
+
+            if (agent.get_state() > INFECTED)
+                continue;
+
+            // Agents with some tool won't be quarantined
+            if (agent.get_n_tools() != 0u)
+                continue;
+
+            if (model->quarantine_willingness[contact_id])
+            {
+
+                switch (agent.get_state())
+                {
+                    case SUSCEPTIBLE:
+                        agent.change_state(*m, ModelSEIRMixingQuarantine<TSeq>::QUARANTINED_SUSCEPTIBLE);
+                        model->day_flagged[contact_id] = m->today();
+                        break;
+                    case EXPOSED:
+                        agent.change_state(*m, ModelSEIRMixingQuarantine<TSeq>::QUARANTINED_EXPOSED);
+                        model->day_flagged[contact_id] = m->today();
+                        break;
+                    case INFECTED:
+                        if (model->isolation_willingness[contact_id])
+                        {
+                            agent.change_state(*m, ModelSEIRMixingQuarantine<TSeq>::ISOLATED);
+                            model->day_flagged[contact_id] = m->today();
+                        }
+                        break;
+                    default:
+                        throw std::logic_error(
+                            "The agent is not in a state that can be quarantined."
+                        );
+                }
+
+            }
+        }
+
+        // Setting the quarantine process off
+        model->agent_quarantine_triggered[agent_i] =
+            ModelSEIRMixingQuarantine<TSeq>::QUARANTINE_PROCESS_DONE;
+    }
+
+    return;
+}
+
+/**
+ * @brief Template for a Susceptible-Exposed-Infected-Removed (SEIR) model with mixing, quarantine, and contact tracing
+ *
+ * @param model A ModelSEIRMixingQuarantine<TSeq> object where to set up the SEIR model.
+ * @param vname Name of the virus
+ * @param n Number of agents in the population
+ * @param prevalence Initial prevalence (proportion of infected individuals)
+ * @param transmission_rate Probability of transmission per contact
+ * @param avg_incubation_days Average incubation period in days
+ * @param recovery_rate Probability of recovery per day
+ * @param contact_matrix Contact matrix specifying expected contacts between groups.
+ * Each entry (i,j) represents the expected number of contacts an agent in
+ * group i has with agents in group j per day.
+ * @param hospitalization_rate Rate at which infected individuals are hospitalized
+ * @param hospitalization_period Average duration of hospitalization in days
+ * @param days_undetected Average number of days an infected individual remains undetected
+ * @param quarantine_period Duration of quarantine in days for exposed contacts
+ * @param quarantine_willingness Proportion of individuals willing to comply with quarantine
+ * @param isolation_willingness Proportion of individuals willing to self-isolate when detected
+ * @param isolation_period Duration of isolation in days for detected infected individuals
+ * @param contact_tracing_success_rate Probability of successfully identifying contacts during tracing
+ * @param contact_tracing_days_prior Number of days prior to detection for contact tracing
+ */
+template<typename TSeq>
+inline ModelSEIRMixingQuarantine<TSeq>::ModelSEIRMixingQuarantine(
+    const std::string & vname,
+    epiworld_fast_uint n,
+    epiworld_double prevalence,
+    epiworld_double transmission_rate,
+    epiworld_double avg_incubation_days,
+    epiworld_double recovery_rate,
+    std::vector< double > contact_matrix,
+    epiworld_double hospitalization_rate,
+    epiworld_double hospitalization_period,
+    // Policy parameters
+    epiworld_double days_undetected,
+    epiworld_fast_int quarantine_period,
+    epiworld_double quarantine_willingness,
+    epiworld_double isolation_willingness,
+    epiworld_fast_int isolation_period,
+    epiworld_double contact_tracing_success_rate,
+    epiworld_fast_uint contact_tracing_days_prior
+    )
+{
+
+    // Setting up the contact matrix
+    this->set_contact_matrix(contact_matrix, true);
+
+    // Setting up parameters
+    this->add_param(transmission_rate, "Prob. Transmission");
+    this->add_param(recovery_rate, "Prob. Recovery");
+    this->add_param(avg_incubation_days, "Avg. Incubation days");
+    this->add_param(hospitalization_rate, "Hospitalization rate");
+    this->add_param(hospitalization_period, "Hospitalization period");
+    this->add_param(days_undetected, "Days undetected");
+    this->add_param(quarantine_period, "Quarantine period");
+    this->add_param(
+        quarantine_willingness, "Quarantine willingness"
+    );
+    this->add_param(
+        isolation_willingness, "Isolation willingness"
+    );
+    this->add_param(isolation_period, "Isolation period");
+    this->add_param(
+        contact_tracing_success_rate, "Contact tracing success rate"
+    );
+    this->add_param(
+        contact_tracing_days_prior, "Contact tracing days prior"
+    );
+
+    // state
+    this->add_state("Susceptible", _update_susceptible);
+    this->add_state("Exposed", _update_exposed);
+    this->add_state("Infected", _update_infected);
+    this->add_state("Isolated", _update_isolated);
+    this->add_state("Quarantined Susceptible", _update_quarantine_suscep);
+    this->add_state("Quarantined Exposed", _update_quarantine_exposed);
+    this->add_state("Isolated Recovered", _update_isolated_recovered);
+    this->add_state("Hospitalized", _update_hospitalized);
+    this->add_state("Recovered");
+
+    // Global function
+    this->add_globalevent(
+        this->_quarantine_process,
+        "Update infected individuals"
+    );
+
+    this->queuing_off();
+
+    // Preparing the virus -------------------------------------------
+    Virus<TSeq> virus(vname, prevalence, true);
+    virus.set_state(EXPOSED, RECOVERED, RECOVERED);
+
+    virus.set_prob_infecting("Prob. Transmission");
+    virus.set_prob_recovery("Prob. Recovery");
+    virus.set_incubation("Avg. Incubation days");
+
+    this->add_virus(virus);
+
+    this->queuing_off(); // No queuing need
+
+    // Enable contact tracing for quarantine process
+    this->contact_tracing_on(EPI_MAX_TRACKING);
+
+    // Adding the empty population
+    this->agents_empty_graph(n);
+
+    this->set_name("SEIR with Mixing and Quarantine");
+
+    return;
+
+}
+
+template<typename TSeq>
+inline ModelSEIRMixingQuarantine<TSeq> & ModelSEIRMixingQuarantine<TSeq>::initial_states(
+    std::vector< double > proportions_,
+    std::vector< int > /* queue_ */
+)
+{
+
+    Model<TSeq>::initial_states_fun =
+        create_init_function_seir<TSeq>(proportions_)
+        ;
+
+    return *this;
+
+}
+
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::next() {
+
+    this->_update_infected_list();
+    Model<TSeq>::next();
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/seirmixingquarantine.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/models/seirnetworkquarantine.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODELS_SEIRNETWORKQUARANTINE_HPP
+#define EPIWORLD_MODELS_SEIRNETWORKQUARANTINE_HPP
+
+// (already included include/epiworld/models/../model-bones.hpp)
+
+/**
+ * @file seirnetworkquarantine.hpp
+ * @brief Template for a Susceptible-Exposed-Infected-Removed (SEIR) model
+ *        with network-based contacts, quarantine, and contact tracing
+ */
+
+/**
+ * @brief SEIR model with network-based contacts, quarantine, and contact tracing
+ *
+ * This class implements a Susceptible-Exposed-Infected-Removed (SEIR) epidemiological
+ * model that uses actual network neighbors (e.g., from a Stochastic Block Model) for
+ * contacts instead of a mixing matrix. This enables the queueing system for efficient
+ * iteration since only agents in contact with infected agents need updates.
+ *
+ * Features:
+ *
+ * - Network-based contacts (via adjacency list, e.g., from agents_sbm())
+ * - Quarantine measures for exposed contacts
+ * - Isolation policies for detected infected individuals
+ * - Contact tracing with configurable success rates
+ * - Hospitalization of severe cases
+ * - Individual willingness to comply with public health measures
+ * - Queueing system support for computational efficiency
+ *
+ * The model supports 10 distinct states (identical to SEIRMixingQuarantine):
+ *
+ * - Susceptible: Individuals who can become infected
+ * - Exposed: Infected but not yet infectious (incubation period)
+ * - Infected: Infectious individuals in the community
+ * - Isolated: Detected infected individuals in self-isolation
+ * - Detected Hospitalized: Hospitalized individuals who were contact-traced
+ * - Quarantined Susceptible: Susceptible individuals in quarantine due to contact tracing
+ * - Quarantined Exposed: Exposed individuals in quarantine due to contact tracing
+ * - Isolated Recovered: Recovered individuals still in isolation
+ * - Hospitalized: Individuals requiring hospital care
+ * - Recovered: Individuals who have recovered and gained immunity
+ *
+ * **Implementation details:**
+ * <a href="../impl/quarantine-isolation-and-contact-tracing.md">Quarantine, Isolation, and Contact Tracing</a>,
+ * <a href="../impl/queueing-system.md">Queueing System</a>
+ *
+ * @tparam TSeq Type for genetic sequences (default: EPI_DEFAULT_TSEQ)
+ * @ingroup connected_models
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class ModelSEIRNetworkQuarantine : public Model<TSeq>
+{
+private:
+
+    // Update functions
+    static void _update_susceptible(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_exposed(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_infected(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_isolated(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_quarantine_suscep(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_quarantine_exposed(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_hospitalized(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_isolated_recovered(Agent<TSeq> * p, Model<TSeq> * m);
+
+    // Data about the quarantine process
+    std::vector< bool > quarantine_willingness; ///< Indicator
+    std::vector< bool > isolation_willingness; ///< Indicator for isolation willingness
+    std::vector< size_t > agent_quarantine_triggered; ///< Whether the quarantine process has started
+    std::vector< int > day_flagged; ///< Either detected or started quarantine
+    std::vector< int > day_onset; ///< Day of onset of the disease
+
+    static void _quarantine_process(Model<TSeq> * m);
+    void write_checkpoint_derived(std::ostream & out) const override;
+    void read_checkpoint_derived(std::istream & in) override;
+
+public:
+
+    static const int SUSCEPTIBLE             = 0;
+    static const int EXPOSED                 = 1;
+    static const int INFECTED                = 2;
+    static const int ISOLATED                = 3;
+    static const int DETECTED_HOSPITALIZED   = 4;
+    static const int QUARANTINED_SUSCEPTIBLE = 5;
+    static const int QUARANTINED_EXPOSED     = 6;
+    static const int ISOLATED_RECOVERED      = 7;
+    static const int HOSPITALIZED            = 8;
+    static const int RECOVERED               = 9;
+
+    static const size_t QUARANTINE_PROCESS_INACTIVE = 0u;
+    static const size_t QUARANTINE_PROCESS_ACTIVE   = 1u;
+    static const size_t QUARANTINE_PROCESS_DONE     = 2u;
+
+    ModelSEIRNetworkQuarantine() = delete;
+
+    /**
+     * @brief Constructs a ModelSEIRNetworkQuarantine object.
+     *
+     * @param vname The name of the virus.
+     * @param n The number of agents in the model.
+     * @param prevalence The initial prevalence of the disease.
+     * @param transmission_rate The transmission rate of the disease.
+     * @param avg_incubation_days The average incubation period.
+     * @param recovery_rate The recovery rate of the disease.
+     * @param hospitalization_rate The rate at which infected individuals are hospitalized.
+     * @param hospitalization_period The average duration of hospitalization in days.
+     * @param days_undetected The average number of days an infected individual remains undetected.
+     * @param quarantine_period The duration of quarantine in days.
+     * @param quarantine_willingness The proportion willing to comply with quarantine.
+     * @param isolation_willingness The proportion willing to self-isolate.
+     * @param isolation_period The duration of isolation in days.
+     * @param contact_tracing_success_rate Probability of successfully tracing a contact (default: 1.0).
+     * @param contact_tracing_days_prior Days prior to detection for contact tracing (default: 4).
+     */
+    ModelSEIRNetworkQuarantine(
+        const std::string & vname,
+        epiworld_double prevalence,
+        epiworld_double transmission_rate,
+        epiworld_double avg_incubation_days,
+        epiworld_double recovery_rate,
+        epiworld_double hospitalization_rate,
+        epiworld_double hospitalization_period,
+        // Policy parameters
+        epiworld_double days_undetected,
+        epiworld_fast_int quarantine_period,
+        epiworld_double quarantine_willingness,
+        epiworld_double isolation_willingness,
+        epiworld_fast_int isolation_period,
+        epiworld_double contact_tracing_success_rate = 1.0,
+        epiworld_fast_uint contact_tracing_days_prior = 4u
+    );
+
+    /**
+     * @brief Reset the model to initial state
+     */
+    void reset() override;
+
+    /**
+     * @brief Create a clone of this model
+     * @return Pointer to a new model instance with the same configuration
+     */
+    std::unique_ptr< Model<TSeq> > clone_ptr() override;
+
+    /**
+     * @brief Set the initial states of the model
+     * @param proportions_ Double vector with two elements:
+     * - [0]: The proportion of initially infected individuals who start in the exposed state.
+     * - [1]: The proportion of initially non-infected individuals who have recovered (immune).
+     * @param queue_ Optional vector for queuing specifications (default: empty).
+     */
+    ModelSEIRNetworkQuarantine<TSeq> & initial_states(
+        std::vector< double > proportions_,
+        std::vector< int > queue_ = {}
+    ) override;
+
+    /**
+     * @brief Get the quarantine trigger status for all agents
+     * @return Vector indicating quarantine process status for each agent
+     */
+    std::vector< size_t > get_agent_quarantine_triggered() const
+    {
+        return agent_quarantine_triggered;
+    };
+
+    /**
+     * @brief Get the quarantine willingness for all agents
+     * @return Vector of boolean values indicating each agent's willingness to quarantine
+     */
+    std::vector< bool > get_quarantine_willingness() const
+    {
+        return quarantine_willingness;
+    };
+
+    /**
+     * @brief Get the isolation willingness for all agents
+     * @return Vector of boolean values indicating each agent's willingness to self-isolate
+     */
+    std::vector< bool > get_isolation_willingness() const
+    {
+        return isolation_willingness;
+    };
+
+};
+
+// -----------------------------------------------------------------------
+// Reset
+// -----------------------------------------------------------------------
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::write_checkpoint_derived(std::ostream & out) const
+{
+
+    checkpoint_write(out, quarantine_willingness);
+    checkpoint_write(out, isolation_willingness);
+    checkpoint_write(out, agent_quarantine_triggered);
+    checkpoint_write(out, day_flagged);
+    checkpoint_write(out, day_onset);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::read_checkpoint_derived(std::istream & in)
+{
+
+    checkpoint_read(in, quarantine_willingness);
+    checkpoint_read(in, isolation_willingness);
+    checkpoint_read(in, agent_quarantine_triggered);
+    checkpoint_read(in, day_flagged);
+    checkpoint_read(in, day_onset);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::reset()
+{
+    Model<TSeq>::reset();
+
+    // Setting up the quarantine parameters
+    quarantine_willingness.resize(this->size(), false);
+    isolation_willingness.resize(this->size(), false);
+    for (size_t idx = 0; idx < quarantine_willingness.size(); ++idx)
+    {
+        quarantine_willingness[idx] =
+            this->runif() < this->par("Quarantine willingness");
+        isolation_willingness[idx] =
+            this->runif() < this->par("Isolation willingness");
+    }
+
+    agent_quarantine_triggered.assign(this->size(), 0u);
+    day_flagged.assign(this->size(), 0);
+    day_onset.assign(this->size(), 0);
+
+    return;
+}
+
+template<typename TSeq>
+inline std::unique_ptr<Model<TSeq>> ModelSEIRNetworkQuarantine<TSeq>::clone_ptr()
+{
+    return std::make_unique<ModelSEIRNetworkQuarantine<TSeq>>(*this);
+}
+
+// -----------------------------------------------------------------------
+// Susceptible: iterate over network neighbors (like default_update_susceptible)
+// and record contacts for tracing
+// -----------------------------------------------------------------------
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::_update_susceptible(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    size_t nviruses_tmp = 0u;
+    for (auto & neighbor : p->neighbors(*m))
+    {
+        auto & v = neighbor.get_virus();
+        if (v == nullptr)
+            continue;
+
+        // Only infectious agents can transmit
+        if (neighbor.get_state() != ModelSEIRNetworkQuarantine<TSeq>::INFECTED)
+            continue;
+
+        // Record contact for tracing: infected neighbor -> susceptible agent
+        m->get_contact_tracing().add_contact(
+            neighbor.get_id(),
+            p->get_id(),
+            static_cast<size_t>(m->today())
+        );
+
+        #ifdef EPI_DEBUG
+        if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+            throw std::logic_error(
+                "Trying to add an extra element to a temporal array outside of the range."
+            );
+        #endif
+
+        m->array_double_tmp[nviruses_tmp] =
+            (1.0 - p->get_susceptibility_reduction(v, *m)) *
+            v->get_prob_infecting(m) *
+            (1.0 - neighbor.get_transmission_reduction(v, *m));
+
+        m->array_virus_tmp[nviruses_tmp++] = &(*v);
+    }
+
+    if (nviruses_tmp == 0u)
+        return;
+
+    // Running the roulette
+    int which = roulette(nviruses_tmp, m);
+
+    if (which < 0)
+        return;
+
+    p->set_virus(*m,
+        *m->array_virus_tmp[which],
+        ModelSEIRNetworkQuarantine<TSeq>::EXPOSED
+    );
+
+    return;
+};
+
+// -----------------------------------------------------------------------
+// Exposed: incubation -> infected transition
+// -----------------------------------------------------------------------
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::_update_exposed(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    auto & v = p->get_virus();
+
+    if (m->runif() < 1.0/(v->get_incubation(m)))
+    {
+        p->change_state(*m, ModelSEIRNetworkQuarantine<TSeq>::INFECTED);
+
+        auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
+        model->day_onset[p->get_id()] = m->today();
+    }
+
+    return;
+};
+
+// -----------------------------------------------------------------------
+// Infected: detection, isolation, hospitalization, recovery
+// -----------------------------------------------------------------------
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::_update_infected(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    static const size_t par_days_undetected =
+        Model<TSeq>::param_id("Days undetected");
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
+    auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
+
+    // Sampling whether the agent is detected or not.
+    // If Days undetected < 0, detection is disabled (never detected).
+    // If Days undetected == 0, the agent is always detected.
+    epiworld_double days_undetected = m->par(par_days_undetected);
+    bool detected = (days_undetected < 0.0) ?
+        false : ((days_undetected == 0.0) ?
+            true : (m->runif() < 1.0 / days_undetected));
+
+    // If detected, trigger the quarantine process
+    if (detected)
+    {
+        model->agent_quarantine_triggered[p->get_id()] =
+            ModelSEIRNetworkQuarantine<TSeq>::QUARANTINE_PROCESS_ACTIVE;
+    }
+
+    // Checking if the agent is willing to isolate individually
+    bool isolation_detected = (m->par(par_isolation_period) >= 0) &&
+        detected &&
+        (model->isolation_willingness[p->get_id()]);
+
+    // Recording the date of detection
+    if (isolation_detected)
+        model->day_flagged[p->get_id()] = m->today();
+
+    // Computing probabilities for state change
+    auto & v = p->get_virus();
+    m->array_double_tmp[0] = 1.0 - (1.0 - v->get_prob_recovery(m)) *
+        (1.0 - p->get_recovery_enhancer(v, *m));
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
+
+    auto which = m->sample_from_probs(2);
+
+    if (which == 0) // Recovers
+    {
+        if (isolation_detected)
+        {
+            p->change_state(*m,
+                ModelSEIRNetworkQuarantine<TSeq>::ISOLATED_RECOVERED
+            );
+        }
+        else
+        {
+            p->rm_virus(*m,
+                ModelSEIRNetworkQuarantine<TSeq>::RECOVERED
+            );
+        }
+        return;
+    }
+    else if (which == 1) // Hospitalized
+    {
+        m->record_hospitalization(*p);
+        if (detected)
+        {
+            p->change_state(*m, DETECTED_HOSPITALIZED);
+        }
+        else
+        {
+            p->change_state(*m, HOSPITALIZED);
+        }
+    }
+    else if ((which == 2) && isolation_detected) // Nothing, but detected
+    {
+        p->change_state(*m, ISOLATED);
+    }
+
+    return;
+};
+
+// -----------------------------------------------------------------------
+// Isolated: recovery, hospitalization, or release from isolation
+// -----------------------------------------------------------------------
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::_update_isolated(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
+    auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
+
+    int days_since = m->today() - model->day_onset[p->get_id()];
+
+    bool unisolate =
+        (m->par(par_isolation_period) <= days_since) ?
+        true : false;
+
+    // Sampling from the probabilities of recovery
+    m->array_double_tmp[0] = 1.0 -
+        (1.0 - p->get_virus()->get_prob_recovery(m)) *
+        (1.0 - p->get_recovery_enhancer(p->get_virus(), *m));
+
+    // And hospitalization
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
+
+    auto which = m->sample_from_probs(2);
+
+    // Recovers
+    if (which == 0)
+    {
+        if (unisolate)
+        {
+            p->rm_virus(*m,
+                ModelSEIRNetworkQuarantine<TSeq>::RECOVERED
+            );
+        }
+        else
+            p->rm_virus(*m,
+                ModelSEIRNetworkQuarantine<TSeq>::ISOLATED_RECOVERED
+            );
+    }
+    else if (which == 1)
+    {
+        m->record_hospitalization(*p);
+        if (unisolate)
+        {
+            p->change_state(*m, HOSPITALIZED);
+        }
+        else
+        {
+            p->change_state(*m, DETECTED_HOSPITALIZED);
+        }
+    }
+    else if ((which == 2) && unisolate)
+    {
+        p->change_state(*m, INFECTED);
+    }
+
+};
+
+// -----------------------------------------------------------------------
+// Quarantined Susceptible: release when quarantine period is over
+// -----------------------------------------------------------------------
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::_update_quarantine_suscep(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
+    auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
+
+    int days_since = m->today() - model->day_flagged[p->get_id()];
+
+    bool unquarantine =
+        (m->par(par_quarantine_period) <= days_since) ?
+        true : false;
+
+    if (unquarantine)
+    {
+        p->change_state(*m,
+            ModelSEIRNetworkQuarantine<TSeq>::SUSCEPTIBLE
+        );
+    }
+
+};
+
+// -----------------------------------------------------------------------
+// Quarantined Exposed: incubation or release
+// -----------------------------------------------------------------------
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::_update_quarantine_exposed(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
+    auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
+
+    int days_since = m->today() - model->day_flagged[p->get_id()];
+
+    bool unquarantine =
+        (m->par(par_quarantine_period) <= days_since) ?
+        true : false;
+
+    if (m->runif() < 1.0/(p->get_virus()->get_incubation(m)))
+    {
+        // Recording the day of onset
+        model->day_onset[p->get_id()] = m->today();
+
+        if (unquarantine)
+        {
+            p->change_state(*m,
+                ModelSEIRNetworkQuarantine<TSeq>::INFECTED
+            );
+        }
+        else
+        {
+            p->change_state(*m,
+                ModelSEIRNetworkQuarantine<TSeq>::ISOLATED
+            );
+        }
+    }
+    else if (unquarantine)
+    {
+        p->change_state(*m,
+            ModelSEIRNetworkQuarantine<TSeq>::EXPOSED
+        );
+    }
+
+};
+
+// -----------------------------------------------------------------------
+// Isolated Recovered: release when isolation period ends
+// -----------------------------------------------------------------------
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::_update_isolated_recovered(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+
+    auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
+
+    int days_since = m->today() - model->day_onset[p->get_id()];
+
+    bool unisolate =
+        (m->par(par_isolation_period) <= days_since) ?
+        true : false;
+
+    if (unisolate)
+    {
+        p->change_state(*m,
+            ModelSEIRNetworkQuarantine<TSeq>::RECOVERED
+        );
+    }
+
+};
+
+// -----------------------------------------------------------------------
+// Hospitalized: recovery after hospitalization period
+// -----------------------------------------------------------------------
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::_update_hospitalized(
+    Agent<TSeq> * p, Model<TSeq> * m
+) {
+
+    static const size_t par_hospitalization_period =
+        Model<TSeq>::param_id("Hospitalization period");
+
+    if (m->runif() < 1.0/m->par(par_hospitalization_period))
+        p->rm_virus(*m, ModelSEIRNetworkQuarantine<TSeq>::RECOVERED);
+
+};
+
+// -----------------------------------------------------------------------
+// Quarantine process: trace contacts and quarantine them
+// -----------------------------------------------------------------------
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::_quarantine_process(
+    Model<TSeq> * m
+) {
+
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+    static const size_t par_contact_tracing_success_rate =
+        Model<TSeq>::param_id("Contact tracing success rate");
+    static const size_t par_contact_tracing_days_prior =
+        Model<TSeq>::param_id("Contact tracing days prior");
+
+    auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
+
+    for (size_t agent_i = 0u; agent_i < m->size(); ++agent_i)
+    {
+
+        if (
+            model->agent_quarantine_triggered[agent_i] !=
+            ModelSEIRNetworkQuarantine<TSeq>::QUARANTINE_PROCESS_ACTIVE
+        )
+            continue;
+
+        if (m->par(par_quarantine_period) < 0)
+        {
+            model->agent_quarantine_triggered[agent_i] = QUARANTINE_PROCESS_DONE;
+            continue;
+        }
+
+        size_t n_contacts = m->get_contact_tracing().get_n_contacts(agent_i);
+        if (n_contacts >= EPI_MAX_TRACKING)
+            n_contacts = EPI_MAX_TRACKING;
+
+        auto success_rate = m->par(par_contact_tracing_success_rate);
+        auto days_prior = m->par(par_contact_tracing_days_prior);
+        for (size_t contact_i = 0u; contact_i < n_contacts; ++contact_i)
+        {
+            // Checking if we will detect the contact
+            if (m->runif() > success_rate)
+                continue;
+
+            auto [contact_id, contact_date] = m->get_contact_tracing().get_contact(
+                agent_i, contact_i
+            );
+
+            // Skip contacts outside the tracing window
+            if ((static_cast<double>(m->today()) -
+                static_cast<double>(contact_date)) > days_prior)
+                continue;
+
+            auto & agent = m->get_agent(contact_id);
+
+            if (agent.get_state() > INFECTED)
+                continue;
+
+            // Agents with some tool won't be quarantined
+            if (agent.get_n_tools() != 0u)
+                continue;
+
+            if (model->quarantine_willingness[contact_id])
+            {
+                switch (agent.get_state())
+                {
+                    case SUSCEPTIBLE:
+                        agent.change_state(*m, QUARANTINED_SUSCEPTIBLE);
+                        model->day_flagged[contact_id] = m->today();
+                        break;
+                    case EXPOSED:
+                        agent.change_state(*m, QUARANTINED_EXPOSED);
+                        model->day_flagged[contact_id] = m->today();
+                        break;
+                    case INFECTED:
+                        if (model->isolation_willingness[contact_id])
+                        {
+                            agent.change_state(*m, ISOLATED);
+                            model->day_flagged[contact_id] = m->today();
+                        }
+                        break;
+                    default:
+                        throw std::logic_error(
+                            "The agent is not in a state that can be quarantined."
+                        );
+                }
+            }
+        }
+
+        // Setting the quarantine process off
+        model->agent_quarantine_triggered[agent_i] = QUARANTINE_PROCESS_DONE;
+    }
+
+    return;
+}
+
+// -----------------------------------------------------------------------
+// Constructor (delegating)
+// -----------------------------------------------------------------------
+template<typename TSeq>
+inline ModelSEIRNetworkQuarantine<TSeq>::ModelSEIRNetworkQuarantine(
+    const std::string & vname,
+    epiworld_double prevalence,
+    epiworld_double transmission_rate,
+    epiworld_double avg_incubation_days,
+    epiworld_double recovery_rate,
+    epiworld_double hospitalization_rate,
+    epiworld_double hospitalization_period,
+    // Policy parameters
+    epiworld_double days_undetected,
+    epiworld_fast_int quarantine_period,
+    epiworld_double quarantine_willingness,
+    epiworld_double isolation_willingness,
+    epiworld_fast_int isolation_period,
+    epiworld_double contact_tracing_success_rate,
+    epiworld_fast_uint contact_tracing_days_prior
+    )
+{
+
+    // Setting up parameters
+    this->add_param(transmission_rate, "Prob. Transmission");
+    this->add_param(recovery_rate, "Prob. Recovery");
+    this->add_param(avg_incubation_days, "Avg. Incubation days");
+    this->add_param(hospitalization_rate, "Hospitalization rate");
+    this->add_param(hospitalization_period, "Hospitalization period");
+    this->add_param(days_undetected, "Days undetected");
+    this->add_param(quarantine_period, "Quarantine period");
+    this->add_param(
+        quarantine_willingness, "Quarantine willingness"
+    );
+    this->add_param(
+        isolation_willingness, "Isolation willingness"
+    );
+    this->add_param(isolation_period, "Isolation period");
+    this->add_param(
+        contact_tracing_success_rate, "Contact tracing success rate"
+    );
+    this->add_param(
+        contact_tracing_days_prior, "Contact tracing days prior"
+    );
+
+    // States
+    this->add_state("Susceptible", _update_susceptible);
+    this->add_state("Exposed", _update_exposed);
+    this->add_state("Infected", _update_infected);
+    this->add_state("Isolated", _update_isolated);
+    this->add_state("Detected Hospitalized", _update_hospitalized);
+    this->add_state("Quarantined Susceptible", _update_quarantine_suscep);
+    this->add_state("Quarantined Exposed", _update_quarantine_exposed);
+    this->add_state("Isolated Recovered", _update_isolated_recovered);
+    this->add_state("Hospitalized", _update_hospitalized);
+    this->add_state("Recovered");
+
+    // Global function (quarantine process runs before state updates)
+    this->add_globalevent(_quarantine_process, "Quarantine process");
+
+    // Preparing the virus -------------------------------------------
+    Virus<TSeq> virus(vname, prevalence, true);
+    virus.set_state(EXPOSED, RECOVERED, RECOVERED);
+
+    virus.set_prob_infecting("Prob. Transmission");
+    virus.set_prob_recovery("Prob. Recovery");
+    virus.set_incubation("Avg. Incubation days");
+
+    this->add_virus(virus);
+
+    // Enable contact tracing for quarantine process
+    this->contact_tracing_on(EPI_MAX_TRACKING);
+
+    this->set_name("SEIR with Network and Quarantine");
+
+    return;
+
+}
+
+template<typename TSeq>
+inline ModelSEIRNetworkQuarantine<TSeq> & ModelSEIRNetworkQuarantine<TSeq>::initial_states(
+    std::vector< double > proportions_,
+    std::vector< int > /* queue_ */
+)
+{
+
+    Model<TSeq>::initial_states_fun =
+        create_init_function_seir<TSeq>(proportions_)
+        ;
+
+    return *this;
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/models/seirnetworkquarantine.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/models/models.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+
+}
+
+// ---------------------------------------------------------------------------
+// Specializations of std::generate_canonical for epiworld::epi_xoshiro256ss.
+//
+// This is the agnostic performance fix: by specializing generate_canonical for
+// our custom engine, ALL std distributions (normal, gamma, binomial, etc.)
+// that call generate_canonical internally will automatically bypass the
+// long-double arithmetic that causes severe slowdowns on platforms where
+// long double is software-emulated 128-bit (e.g., Clang+libstdc++ on ARM).
+//
+// The specialisation converts the 64-bit engine output to a floating-point
+// value in [0, 1) using only the precision of the target type:
+//   - double (53 mantissa bits): top 53 bits of the 64-bit word, × 2^{-53}
+//   - float  (24 mantissa bits): top 24 bits,                      × 2^{-24}
+//
+// The result is strictly less than 1.0 by construction (max value is
+// (2^N - 1) / 2^N), so no nextafter clamp is required.
+// ---------------------------------------------------------------------------
+namespace std {
+    template<>
+    inline double generate_canonical<
+        double,
+        numeric_limits<double>::digits,
+        epiworld::epi_xoshiro256ss
+    >(epiworld::epi_xoshiro256ss& eng) {
+        return static_cast<double>(eng() >> 11) * 0x1.0p-53;
+    }
+
+    template<>
+    inline float generate_canonical<
+        float,
+        numeric_limits<float>::digits,
+        epiworld::epi_xoshiro256ss
+    >(epiworld::epi_xoshiro256ss& eng) {
+        return static_cast<float>(eng() >> 40) * 0x1.0p-24f;
+    }
+
+    template<>
+    inline double generate_canonical<
+        double,
+        numeric_limits<double>::digits,
+        epiworld::epi_philox4x32
+    >(epiworld::epi_philox4x32& eng) {
+        return static_cast<double>(eng() >> 11) * 0x1.0p-53;
+    }
+
+    template<>
+    inline float generate_canonical<
+        float,
+        numeric_limits<float>::digits,
+        epiworld::epi_philox4x32
+    >(epiworld::epi_philox4x32& eng) {
+        return static_cast<float>(eng() >> 40) * 0x1.0p-24f;
+    }
+}
+
+#endif
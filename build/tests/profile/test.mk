@@ -0,0 +1,41 @@
+# Auto-generated test Makefile for profile
+
+.SUFFIXES:
+.DEFAULT_GOAL := all
+
+# Test case: Profiler
+ifeq ($(WITH_COVERAGE),1)
+/root/repo/build/tests/profile/.coverage/coverage-851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997.info: COV_SILO = /root/repo/build/tests/profile/.coverage/coverage-851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997
+/root/repo/build/tests/profile/.coverage/coverage-851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997.info: /root/repo/build/tests/profile/.test/report-851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997.xml
+	$(SAY) 'LCOV' '$(COV_SILO)/coverage.info'
+	$(V)for f in /root/repo/build/tests/profile/*.gcno; do \
+		ln -sf "$$(realpath $$f)" "$(COV_SILO)/$$(basename $$f)"; \
+	done
+	$(V)$(LCOV) --capture --directory "$(COV_SILO)" --output-file "$(COV_SILO)/coverage.info" --quiet \
+		--ignore-errors inconsistent,inconsistent,unsupported,unsupported,format,format,empty,empty,count,count,unused,unused,version,version,gcov,gcov
+	$(V)$(LCOV) --extract "$(COV_SILO)/coverage.info" '/root/repo/include/epiworld' --output-file "/root/repo/build/tests/profile/.coverage/coverage-851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997.info" --quiet \
+		--ignore-errors inconsistent,inconsistent,unsupported,unsupported,format,format,empty,empty,count,count,unused,unused,version,version,gcov,gcov
+endif
+
+/root/repo/build/tests/profile/.test/report-851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997.xml: TTYP = /root/repo/build/tests/profile/.test/.tty-851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997
+/root/repo/build/tests/profile/.test/report-851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997.xml: COV_SILO = /root/repo/build/tests/profile/.coverage/coverage-851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997
+/root/repo/build/tests/profile/.test/report-851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997.xml: /root/repo/build/tests/profile/profile
+	$(SAY) 'TEST' 'Profiler'
+	$(V)mkdir -p $(COV_SILO)
+	$(V)GCOV_PREFIX_STRIP=999 GCOV_PREFIX='$(COV_SILO)' /root/repo/build/tests/profile/profile \
+		--reporter junit \
+		--out /root/repo/build/tests/profile/.test/report-851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997.xml \
+		'Profiler' \
+		>$(TTYP) 2>&1; \
+	perl -pi -e 's/name="tests"/name="Profiler"/g' /root/repo/build/tests/profile/.test/report-851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997.xml; \
+	cat '$(TTYP)'; \
+	rm '$(TTYP)'
+
+.PHONY: 851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997
+ifeq ($(WITH_COVERAGE),1)
+851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997: /root/repo/build/tests/profile/.coverage/coverage-851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997.info
+else
+851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997: /root/repo/build/tests/profile/.test/report-851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997.xml
+endif
+
+all: 851fea20e8898c7ebc5d3b14cb99bec297564eaa39c4e2063c87d4dfeb5a7997
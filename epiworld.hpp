@@ -18,6 +18,8 @@
 #include <iomanip>
 #include <set>
 #include <type_traits>
+#include <mutex>
+#include <iterator>
 #include <cassert>
 #ifdef EPI_DEBUG_VIRUS
 #include <atomic>
@@ -101,6 +103,13 @@ namespace epiworld {
     #define epiworld_fast_uint unsigned long long int
 #endif
 
+// Type used to store agent and entity ids in the network, the entities,
+// the agents, and contact tracing. Models with fewer than 2^32 agents can
+// define it as `uint32_t` to halve the memory of these arrays.
+#ifndef epiworld_agent_index
+    #define epiworld_agent_index size_t
+#endif
+
 // By default, `Model::rbinom` will use a Poisson approximation in the
 // rare-event regime where p <= 0.01 and n * p^2 <= 0.1. Advanced users can
 // disable this by defining EPI_NO_FAST_BINOM before including epiworld.
@@ -114,6 +123,12 @@ namespace epiworld {
     #define EPI_MAX_TRACKING 200
 #endif
 
+// Lanes of the generator used by `Model::runif_batch_on()`. The sequence of
+// batched uniforms is reproducible for a given number of lanes.
+#ifndef EPI_RUNIF_LANES
+    #define EPI_RUNIF_LANES 4
+#endif
+
 template<typename TSeq = EPI_DEFAULT_TSEQ>
 class Model;
 
@@ -171,6 +186,9 @@ using VirusFun = std::function<epiworld_double(Agent<TSeq>*,Virus<TSeq>&,Model<T
 template<typename TSeq = EPI_DEFAULT_TSEQ>
 using UpdateFun = std::function<void(Agent<TSeq>*,Model<TSeq>*)>;
 
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using UpdateFunPtr = void (*)(Agent<TSeq>*,Model<TSeq>*); ///< Plain `UpdateFun`.
+
 template<typename TSeq = EPI_DEFAULT_TSEQ>
 using GlobalFun = std::function<void(Model<TSeq>*)>;
 
@@ -1388,6 +1406,83 @@ inline void Progress::next() {
 //////////////////////////////////////////////////////////////////////////////*/
 
 
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/threadarray.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_THREADARRAY_HPP
+#define EPIWORLD_THREADARRAY_HPP
+
+/**
+ * @brief Fixed-size scratch array with one copy per thread
+ *
+ * @details Behaves like `std::array<T,N>` (only `operator[]` and `size()`
+ * are provided). By default there is a single copy. Once `split()` is on,
+ * every OpenMP thread indexes its own copy, so update functions running
+ * in parallel (see `Model<TSeq>::parallel_update_on()`) can use the
+ * model's temporary arrays without stepping on each other.
+ *
+ * @tparam T Type of the elements.
+ * @tparam N Number of elements.
+ */
+template<typename T, size_t N>
+class ThreadArray {
+private:
+    std::vector< std::array< T, N > > data = std::vector< std::array< T, N > >(1u);
+    bool splitted = false;
+
+public:
+
+    T & operator[](size_t i)
+    {
+        #ifdef _OPENMP
+        if (splitted)
+            return data[omp_get_thread_num()][i];
+        #endif
+        return data[0u][i];
+    }
+
+    const T & operator[](size_t i) const
+    {
+        #ifdef _OPENMP
+        if (splitted)
+            return data[omp_get_thread_num()][i];
+        #endif
+        return data[0u][i];
+    }
+
+    constexpr size_t size() const noexcept { return N; }
+
+    /**
+     * @brief Turns the per-thread copies on or off
+     * @param nthreads Number of copies to keep (ignored when `value` is
+     * false).
+     */
+    void split(bool value, size_t nthreads = 1u)
+    {
+        if (value && (data.size() < nthreads))
+            data.resize(nthreads);
+
+        splitted = value;
+    }
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/threadarray.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
 
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -1450,6 +1545,21 @@ public:
         s[3] = splitmix64(seed_val);
     }
 
+    /**
+     * @brief Copies the 256-bit state from/to `x` (e.g., for checkpoints)
+     */
+    ///@{
+    void get_state(uint64_t x[4]) const noexcept {
+        for (int i = 0; i < 4; ++i)
+            x[i] = s[i];
+    }
+
+    void set_state(const uint64_t x[4]) noexcept {
+        for (int i = 0; i < 4; ++i)
+            s[i] = x[i];
+    }
+    ///@}
+
     result_type operator()() noexcept {
         const uint64_t result = rotl(s[1] * 5, 7) * 9;
         const uint64_t t = s[1] << 17;
@@ -1461,32 +1571,317 @@ public:
         s[3] = rotl(s[3], 45);
         return result;
     }
+
+    /**
+     * @brief Advances the state by 2^128 draws
+     * @details Used to split the sequence into non-overlapping streams
+     * (see `epi_xoshiro256ss_lanes`).
+     */
+    void jump() noexcept {
+
+        static constexpr uint64_t JUMP[4] = {
+            0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+            0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+        };
+
+        uint64_t j[4] = {0u, 0u, 0u, 0u};
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int b = 0; b < 64; ++b)
+            {
+                if (JUMP[i] & (uint64_t(1) << b))
+                    for (int k = 0; k < 4; ++k)
+                        j[k] ^= s[k];
+
+                (*this)();
+            }
+        }
+
+        set_state(j);
+
+    }
 };
 
 /**
- * @brief Draw a uniform [0, 1) random number from an epi_xoshiro256ss engine.
- *
- * Uses the top N bits of the 64-bit output (where N =
- * std::numeric_limits<epiworld_double>::digits) to produce a value in [0, 1)
- * without any long-double arithmetic.
+ * @brief Draw a uniform [0, 1) number from 64 random bits.
  *
- * @param engine An epi_xoshiro256ss engine.
- * @return epiworld_double in [0, 1).
+ * Uses the top N bits (where N = std::numeric_limits<epiworld_double>::digits)
+ * to produce a value in [0, 1) without any long-double arithmetic.
  */
-inline epiworld_double runif_epi(epi_xoshiro256ss & engine) {
+inline epiworld_double runif_from_bits(uint64_t x) noexcept {
     static_assert(
         std::numeric_limits<epiworld_double>::digits < 64,
         "epiworld_double must have fewer than 64 mantissa bits; "
-        "the bit-extraction in runif_epi requires digits < 64 to avoid "
+        "the bit-extraction in runif_from_bits requires digits < 64 to avoid "
         "undefined behaviour in the shift and scale computation"
     );
-    
+
     constexpr int bits  = std::numeric_limits<epiworld_double>::digits;
     constexpr int shift = 64 - bits;
     // scale = 2^{-bits}: the result is in [0, 1) by construction (no clamp needed)
     constexpr epiworld_double scale =
         epiworld_double(1) / epiworld_double(uint64_t(1) << bits);
-    return static_cast<epiworld_double>(engine() >> shift) * scale;
+    // Going through a 32-bit integer when possible, which converts to
+    // floating point with a single (vector) instruction
+    if constexpr (bits < 32)
+        return static_cast<epiworld_double>(
+            static_cast<int32_t>(x >> shift)
+        ) * scale;
+    else
+        return static_cast<epiworld_double>(
+            static_cast<int64_t>(x >> shift)
+        ) * scale;
+}
+
+/**
+ * @brief `L` interleaved xoshiro256** generators that fill blocks of numbers.
+ *
+ * Lane `l` starts `l` jumps (2^128 draws) ahead of an `epi_xoshiro256ss`
+ * seeded with the same value, so lanes never overlap. The state is stored
+ * by word (`s[word][lane]`), so each step updates the `L` lanes with the
+ * same operations and compilers vectorize the loop (e.g., AVX2 with
+ * `L = 4`, AVX-512 with `L = 8`).
+ *
+ * Block `k` holds the `k`-th output of every lane, so the sequence is
+ * reproducible for a fixed `L` but differs across values of `L`.
+ *
+ * @tparam L Number of lanes.
+ */
+template<size_t L = 4u>
+class epi_xoshiro256ss_lanes {
+    alignas(64) uint64_t s[4][L];
+
+public:
+    static constexpr size_t lanes = L;
+
+    explicit epi_xoshiro256ss_lanes(uint64_t seed_val = 0) noexcept {
+        seed(seed_val);
+    }
+
+    void seed(uint64_t seed_val) noexcept {
+
+        epi_xoshiro256ss eng(seed_val);
+        uint64_t x[4];
+        for (size_t l = 0u; l < L; ++l)
+        {
+            eng.get_state(x);
+            for (int w = 0; w < 4; ++w)
+                s[w][l] = x[w];
+
+            eng.jump();
+        }
+
+    }
+
+    /**
+     * @brief Copies the `4 * L` words of state from/to `x` (lane-major within
+     * each word, as stored).
+     */
+    ///@{
+    void get_state(uint64_t * x) const noexcept {
+        for (int w = 0; w < 4; ++w)
+            for (size_t l = 0u; l < L; ++l)
+                x[w * L + l] = s[w][l];
+    }
+
+    void set_state(const uint64_t * x) noexcept {
+        for (int w = 0; w < 4; ++w)
+            for (size_t l = 0u; l < L; ++l)
+                s[w][l] = x[w * L + l];
+    }
+    ///@}
+
+    /**
+     * @brief Writes `nblocks` blocks of `L` numbers to `out`
+     * @param out Array of at least `nblocks * L` elements.
+     * @param nblocks Number of blocks.
+     * @param conv Conversion applied to each 64-bit output.
+     */
+    template<typename T, typename TConv>
+    void fill(T * out, size_t nblocks, TConv conv) noexcept {
+
+        // Working on local copies lets the compiler keep the state in
+        // (vector) registers across blocks
+        alignas(64) uint64_t s0[L], s1[L], s2[L], s3[L], res[L];
+        for (size_t l = 0u; l < L; ++l)
+        {
+            s0[l] = s[0][l];
+            s1[l] = s[1][l];
+            s2[l] = s[2][l];
+            s3[l] = s[3][l];
+        }
+
+        for (size_t k = 0u; k < nblocks; ++k, out += L)
+        {
+
+            // Same as epi_xoshiro256ss::operator(); the multiplications by
+            // 5 and 9 are written as shifts so they vectorize without a
+            // 64-bit vector multiply.
+            for (size_t l = 0u; l < L; ++l)
+            {
+                const uint64_t r = (s1[l] << 2) + s1[l];
+                const uint64_t x = (r << 7) | (r >> 57);
+                res[l] = (x << 3) + x;
+
+                const uint64_t t = s1[l] << 17;
+                s2[l] ^= s0[l];
+                s3[l] ^= s1[l];
+                s1[l] ^= s2[l];
+                s0[l] ^= s3[l];
+                s2[l] ^= t;
+                s3[l] = (s3[l] << 45) | (s3[l] >> 19);
+            }
+
+            for (size_t l = 0u; l < L; ++l)
+                out[l] = conv(res[l]);
+
+        }
+
+        for (size_t l = 0u; l < L; ++l)
+        {
+            s[0][l] = s0[l];
+            s[1][l] = s1[l];
+            s[2][l] = s2[l];
+            s[3][l] = s3[l];
+        }
+
+    }
+
+    void fill(uint64_t * out, size_t nblocks) noexcept {
+        fill(out, nblocks, [](uint64_t x) noexcept { return x; });
+    }
+
+    /**
+     * @brief Writes `nblocks` blocks of `L` uniform [0, 1) numbers to `out`
+     * (see `runif_from_bits()`).
+     */
+    void fill_unif(epiworld_double * out, size_t nblocks) noexcept {
+        fill(out, nblocks, [](uint64_t x) noexcept { return runif_from_bits(x); });
+    }
+
+};
+
+/**
+ * @brief Counter-based 64-bit PRNG based on the Philox4x32-10 algorithm.
+ *
+ * The output is a pure function of a 64-bit key and a 128-bit counter, so
+ * any stream can be generated independently of every other (e.g., in a
+ * different thread) without carrying state around. The counter is split in
+ * three parts: a 64-bit stream id (e.g., the agent), a 32-bit sub-stream id
+ * (e.g., the day), and a 32-bit block index that advances as numbers are
+ * drawn. Each block yields two 64-bit numbers.
+ *
+ * Reference: Salmon, Moraes, Dror & Shaw, "Parallel Random Numbers: As
+ * Easy as 1, 2, 3", SC'11. https://www.deshawresearch.com/resources_random123.html
+ */
+class epi_philox4x32 {
+    uint32_t key[2]   = {0u, 0u};
+    uint32_t ctr[4]   = {0u, 0u, 0u, 0u};
+    uint32_t block[4] = {0u, 0u, 0u, 0u};
+    int used = 2; ///< Number of 64-bit words of `block` already returned.
+
+    static constexpr uint32_t M0 = 0xD2511F53u;
+    static constexpr uint32_t M1 = 0xCD9E8D57u;
+    static constexpr uint32_t W0 = 0x9E3779B9u;
+    static constexpr uint32_t W1 = 0xBB67AE85u;
+
+    void generate() noexcept {
+
+        uint32_t c[4] = {ctr[0], ctr[1], ctr[2], ctr[3]};
+        uint32_t k0 = key[0];
+        uint32_t k1 = key[1];
+
+        for (int r = 0; r < 10; ++r)
+        {
+            const uint64_t p0 = static_cast<uint64_t>(M0) * c[0];
+            const uint64_t p1 = static_cast<uint64_t>(M1) * c[2];
+
+            c[0] = static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k0;
+            c[1] = static_cast<uint32_t>(p1);
+            c[2] = static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k1;
+            c[3] = static_cast<uint32_t>(p0);
+
+            k0 += W0;
+            k1 += W1;
+        }
+
+        for (int i = 0; i < 4; ++i)
+            block[i] = c[i];
+
+        ++ctr[0];
+        used = 0;
+
+    }
+
+public:
+    using result_type = uint64_t;
+
+    explicit epi_philox4x32(uint64_t key_val = 0) noexcept {
+        seed(key_val);
+    }
+
+    static constexpr result_type min() noexcept { return 0; }
+    static constexpr result_type max() noexcept {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    /**
+     * @brief Sets the key and moves to the beginning of stream 0.
+     */
+    void seed(uint64_t key_val) noexcept {
+        key[0] = static_cast<uint32_t>(key_val);
+        key[1] = static_cast<uint32_t>(key_val >> 32);
+        set_stream(0u);
+    }
+
+    /**
+     * @brief Moves to the beginning of a stream (the key is kept).
+     * @param stream Stream id (e.g., agent id).
+     * @param substream Sub-stream id (e.g., day).
+     */
+    void set_stream(uint64_t stream, uint32_t substream = 0u) noexcept {
+        ctr[0] = 0u;
+        ctr[1] = substream;
+        ctr[2] = static_cast<uint32_t>(stream);
+        ctr[3] = static_cast<uint32_t>(stream >> 32);
+        used = 2;
+    }
+
+    /**
+     * @brief Raw 128-bit block for the current counter (used for testing).
+     */
+    const uint32_t * next_block() noexcept {
+        generate();
+        used = 2;
+        return block;
+    }
+
+    result_type operator()() noexcept {
+
+        if (used == 2)
+            generate();
+
+        const int i = 2 * (used++);
+        return (static_cast<uint64_t>(block[i]) << 32) | block[i + 1];
+
+    }
+};
+
+/**
+ * @brief Draw a uniform [0, 1) random number from a 64-bit engine
+ * (`epi_xoshiro256ss` or `epi_philox4x32`). See `runif_from_bits()`.
+ *
+ * @param engine An epi_xoshiro256ss or epi_philox4x32 engine.
+ * @return epiworld_double in [0, 1).
+ */
+template<typename TEngine>
+inline epiworld_double runif_epi(TEngine & engine) {
+    static_assert(
+        TEngine::max() == std::numeric_limits<uint64_t>::max(),
+        "runif_epi requires an engine with 64-bit output"
+    );
+
+    return runif_from_bits(engine());
 }
 
 /**
@@ -3868,6 +4263,7 @@ class Model;
  */
 template<typename TSeq = EPI_DEFAULT_TSEQ>
 class HospitalizationsTracker {
+    friend class Model<TSeq>;
 
 private:
 
@@ -4222,6 +4618,21 @@ private:
 
     void record_transition(epiworld_fast_uint from, epiworld_fast_uint to, bool undo);
 
+    /**
+     * @name Batched state counters
+     * @details While batching is on, `update_state()` only accumulates the
+     * net number of transitions between each pair of states; they are
+     * applied to `today_total` and `transition_matrix` by `batch_off()`.
+     * `Model<TSeq>::events_run()` batches the updates of each day.
+     */
+    ///@{
+    bool batch_transitions = false;
+    bool batch_dirty = false;
+    std::vector< int > batch_counts; ///< Net transitions [to * nstates + from]
+    void batch_on();
+    void batch_off();
+    ///@}
+
 
 public:
 
@@ -4233,7 +4644,7 @@ public:
     DataBase() = delete;
     DataBase(Model<TSeq> & m) : model(&m), m_hospitalizations(), user_data(m) {};
     DataBase(const DataBase<TSeq> & db);
-    // DataBase<TSeq> & operator=(const DataBase<TSeq> & m);
+    DataBase<TSeq> & operator=(const DataBase<TSeq> & m) = default;
 
     /**
      * @brief Registering a new variant
@@ -4672,19 +5083,30 @@ inline void DataBase<TSeq>::record()
     ////////////////////////////////////////////////////////////////////////////
     // DEBUGGING BLOCK
     ////////////////////////////////////////////////////////////////////////////
-    EPI_DEBUG_SUM_INT(today_total, model->size())
     EPI_DEBUG_ALL_NON_NEGATIVE(today_total)
 
     #ifdef EPI_DEBUG
-    // Checking whether the sums correspond
-    std::vector< int > _today_total_cp(today_total.size(), 0);
-    for (auto & p : model->population)
-        _today_total_cp[p.get_state()]++;
-    
-    EPI_DEBUG_VECTOR_MATCH_INT(
-        _today_total_cp, today_total,
-        "Sums of __today_total_cp in database-meat.hpp"
-        )
+    // Checking whether the sums correspond (aggregated runs have no agents)
+    if (model->size() > 0u)
+    {
+        EPI_DEBUG_SUM_INT(today_total, model->size())
+
+        std::vector< int > _today_total_cp(today_total.size(), 0);
+        for (auto s : model->agents_state)
+            _today_total_cp[s]++;
+
+        for (auto & p : model->population)
+            if (model->agents_state[p.get_id()] != p.get_state())
+                throw std::logic_error(
+                    "Model::agents_state doesn't match the state of agent " +
+                    std::to_string(p.get_id()) + "."
+                );
+
+        EPI_DEBUG_VECTOR_MATCH_INT(
+            _today_total_cp, today_total,
+            "Sums of __today_total_cp in database-meat.hpp"
+            )
+    }
 
     if (model->today() == 0)
     {
@@ -5090,6 +5512,13 @@ inline void DataBase<TSeq>::update_state(
         );
     #endif
 
+    if (batch_transitions)
+    {
+        batch_counts[new_state * model->nstates + prev_state] += undo ? -1 : 1;
+        batch_dirty = true;
+        return;
+    }
+
     if (undo)
     {
 
@@ -5108,6 +5537,53 @@ inline void DataBase<TSeq>::update_state(
     return;
 }
 
+template<typename TSeq>
+inline void DataBase<TSeq>::batch_on()
+{
+
+    batch_counts.assign(model->nstates * model->nstates, 0);
+    batch_transitions = true;
+    batch_dirty = false;
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::batch_off()
+{
+
+    batch_transitions = false;
+
+    if (!batch_dirty)
+        return;
+
+    const size_t n = model->nstates;
+    for (size_t to = 0u; to < n; ++to)
+        for (size_t from = 0u; from < n; ++from)
+        {
+
+            int & c = batch_counts[to * n + from];
+            if (c == 0)
+                continue;
+
+            today_total[from] -= c;
+            today_total[to]   += c;
+
+            transition_matrix[to * n + from]   += c;
+            transition_matrix[from * n + from] -= c;
+
+            #ifdef EPI_DEBUG
+            if (transition_matrix[from * n + from] < 0)
+                throw std::logic_error("An entry in transition matrix is negative.");
+            #endif
+
+            c = 0;
+
+        }
+
+    batch_dirty = false;
+
+}
+
 template<typename TSeq>
 inline void DataBase<TSeq>::update_virus(
         epiworld_fast_uint virus_id,
@@ -7083,1238 +7559,1073 @@ inline bool AdjList::is_directed() const {
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- Start of -./include/epiworld/randgraph.hpp-
+ Start of -./include/epiworld/network-bones.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
-#ifndef EPIWORLD_RANDGRA
-#define EPIWORLD_RANDGRA
-
-template<typename TSeq>
-class Model;
+#ifndef EPIWORLD_NETWORK_BONES_HPP
+#define EPIWORLD_NETWORK_BONES_HPP
 
-template<typename TSeq>
-class Agent;
+#include <vector>
+#include <map>
+#include <limits>
+#include <stdexcept>
+// (already included include/epiworld/config.hpp)
 
 class AdjList;
 
+/**
+ * @brief Contact network stored in compressed sparse row (CSR) format
+ * @details
+ * The ties of agent `i` are stored in the half-open range
+ * `[offsets[i], offsets[i + 1])` of two flat arrays: `ids`, with the
+ * ids of the neighbors, and `locations`, with the position of the reverse
+ * tie within the neighbor's row. Storing the network this way avoids one
+ * heap allocation per agent, keeps neighbors contiguous in memory, and
+ * makes copying the population (e.g., in `Model<TSeq>::reset()` or when
+ * cloning the model in `Model<TSeq>::run_multiple()`) a handful of
+ * `memcpy`s.
+ *
+ * The network is owned by `Model<TSeq>`; agents only keep their degree.
+ * Ids and locations are stored as `epiworld_agent_index` (see
+ * `config.hpp`), so the number of vertices is bounded by that type.
+ */
+class Network
+{
+    template<typename TSeq> friend class Model;
 
-template<typename TSeq, typename TDat>
-inline void rewire_degseq(
-    TDat * agents,
-    Model<TSeq> * model,
-    epiworld_double proportion
-    );
-
-template<typename TSeq = EPI_DEFAULT_TSEQ>
-inline void rewire_degseq(
-    std::vector< Agent<TSeq> > * agents,
-    Model<TSeq> * model,
-    epiworld_double proportion
-    )
-{
+private:
 
-    #ifdef EPI_DEBUG
-    std::vector< int > _degree0(agents->size(), 0);
-    for (size_t i = 0u; i < _degree0.size(); ++i)
-        _degree0[i] = model->get_agents()[i].get_neighbors(*model).size();
-    #endif
+    std::vector< size_t > offsets = {0u};              ///< Row offsets (size `n + 1`).
+    std::vector< epiworld_agent_index > ids;           ///< Neighbor ids.
+    std::vector< epiworld_agent_index > locations;     ///< Location of the reverse tie in the neighbor's row.
 
-    // Identifying individuals with degree > 0
-    std::vector< epiworld_fast_uint > non_isolates;
-    std::vector< epiworld_double > weights;
-    epiworld_double nedges = 0.0;
+public:
 
-    for (epiworld_fast_uint i = 0u; i < agents->size(); ++i)
-    {
-        if (agents->operator[](i).get_neighbors(*model).size() > 0u)
-        {
-            non_isolates.push_back(i);
-            epiworld_double wtemp = static_cast<epiworld_double>(
-                agents->operator[](i).get_neighbors(*model).size()
-                );
-            weights.push_back(wtemp);
-            nedges += wtemp;
-        }
-    }
+    Network() = default;
 
-    if (non_isolates.size() == 0u)
-        throw std::logic_error("The graph is completely disconnected.");
+    /**
+     * @brief Construct an empty network
+     * @param n Number of vertices (agents).
+     */
+    Network(size_t n);
 
-    // Cumulative probs
-    weights[0u] /= nedges;
-    for (epiworld_fast_uint i = 1u; i < non_isolates.size(); ++i)
-    {
-         weights[i] /= nedges;
-         weights[i] += weights[i - 1u];
-    }
+    /**
+     * @brief Removes all ties and resizes the network to `n` vertices
+     * @param n Number of vertices (agents).
+     * @throws std::range_error if `n` does not fit in `epiworld_agent_index`.
+     */
+    void reset(size_t n);
 
-    // Only swap if needed
-    epiworld_fast_uint N = non_isolates.size();
-    epiworld_double prob;
-    int nrewires = floor(proportion * nedges);
-    while (nrewires-- > 0)
-    {
+    /**
+     * @brief Builds the network from an adjacency list
+     * @details
+     * The ties are added in the same order in which `Agent<TSeq>::add_neighbor()`
+     * adds them (both directions, skipping duplicates), so the resulting
+     * neighbor ordering is the same as adding the ties one at a time.
+     * @param al Adjacency list.
+     */
+    void build(AdjList & al);
 
-        // Picking egos
-        prob = model->runif();
-        int id0 = N - 1;
-        for (epiworld_fast_uint i = 0u; i < N; ++i)
-            if (prob <= weights[i])
-            {
-                id0 = i;
-                break;
-            }
+    /**
+     * @brief Adds the tie `i -> j` (and its reverse `j -> i`)
+     * @details
+     * Since the storage is contiguous, this is an `O(E)` operation. To
+     * build large networks, use `build()` instead.
+     * @param i, j Vertex ids.
+     * @param check_source If `true`, skips adding `j` to `i` if already present.
+     * @param check_target If `true`, skips adding `i` to `j` if already present.
+     */
+    void add_edge(
+        size_t i,
+        size_t j,
+        bool check_source = true,
+        bool check_target = true
+        );
 
-        prob = model->runif();
-        int id1 = N - 1;
-        for (epiworld_fast_uint i = 0u; i < N; ++i)
-            if (prob <= weights[i])
-            {
-                id1 = i;
-                break;
-            }
+    size_t vcount() const noexcept; ///< Number of vertices.
+    size_t ecount() const noexcept; ///< Number of stored ties (both directions).
+    size_t degree(size_t i) const;  ///< Number of neighbors of vertex `i`.
 
-        // Correcting for under or overflow.
-        if (id1 == id0)
-            id1++;
+    /**
+     * @name Row access
+     * @details Pointers to the first element of the row of vertex `i`. The
+     * row has `degree(i)` elements.
+     */
+    ///@{
+    epiworld_agent_index * neighbors(size_t i);
+    const epiworld_agent_index * neighbors(size_t i) const;
+    epiworld_agent_index * neighbors_locations(size_t i);
+    const epiworld_agent_index * neighbors_locations(size_t i) const;
+    ///@}
 
-        if (id1 >= static_cast<int>(N))
-            id1 = 0;
+    bool operator==(const Network & other) const;
+    bool operator!=(const Network & other) const {return !operator==(other);};
 
-        Agent<TSeq> & p0 = agents->operator[](non_isolates[id0]);
-        Agent<TSeq> & p1 = agents->operator[](non_isolates[id1]);
+};
 
-        // Picking alters (relative location in their lists)
-        // In this case, these are uniformly distributed within the list
-        int id01 = model->runif_index(p0.get_n_neighbors());
-        int id11 = model->runif_index(p1.get_n_neighbors());
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-        // Get the actual neighbor IDs that will be swapped
-        auto neighbors_p0 = p0.get_neighbors(*model);
-        auto neighbors_p1 = p1.get_neighbors(*model);
-        size_t neighbor_id_01 = neighbors_p0[id01]->get_id();
-        size_t neighbor_id_11 = neighbors_p1[id11]->get_id();
+ End of -./include/epiworld/network-bones.hpp-
 
-        // Check if the swap would create self-loops or invalid configurations
-        // After swap: p0 will be connected to neighbor_id_11, p1 to neighbor_id_01
-        // Skip if:
-        // 1. neighbor_id_01 == neighbor_id_11 (swapping the same neighbor)
-        // 2. neighbor_id_01 == non_isolates[id1] (p1's new neighbor would be p1 itself)
-        // 3. neighbor_id_11 == non_isolates[id0] (p0's new neighbor would be p0 itself)
-        if (neighbor_id_01 == neighbor_id_11 ||
-            neighbor_id_01 == non_isolates[id1] ||
-            neighbor_id_11 == non_isolates[id0]) {
-            continue;
-        }
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-        // Check if the swap would create duplicate edges
-        // After swap: p0 will be connected to neighbor_id_11, p1 to neighbor_id_01
-        bool would_create_duplicate = false;
-        for (auto* n : neighbors_p0) {
-            if (n->get_id() == neighbor_id_11 && n != neighbors_p0[id01]) {
-                would_create_duplicate = true;
-                break;
-            }
-        }
-        if (!would_create_duplicate) {
-            for (auto* n : neighbors_p1) {
-                if (n->get_id() == neighbor_id_01 && n != neighbors_p1[id11]) {
-                    would_create_duplicate = true;
-                    break;
-                }
-            }
-        }
 
-        if (would_create_duplicate) {
-            continue; // Skip this rewire attempt
-        }
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-        // When rewiring, we need to flip the individuals from the other
-        // end as well, since we are dealing withi an undirected graph
-        
-        // Swap neighbors between the two agents
-        // Note: id0 and id1 are indices in non_isolates, not agent IDs
-        model->get_agents()[non_isolates[id0]].swap_neighbors(
-            model->get_agents()[non_isolates[id1]],
-            id01,
-            id11,
-            *model
-            );
+ Start of -./include/epiworld/network-meat.hpp-
 
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    }
 
-    #ifdef EPI_DEBUG
-    for (size_t _i = 0u; _i < _degree0.size(); ++_i)
-    {
-        if (_degree0[_i] != static_cast<int>(model->get_agents()[_i].get_n_neighbors()))
-            throw std::logic_error("[epi-debug] Degree does not match afted rewire_degseq.");
-    }
-    #endif
+#ifndef EPIWORLD_NETWORK_MEAT_HPP
+#define EPIWORLD_NETWORK_MEAT_HPP
 
-    return;
+// (already included include/epiworld/network-bones.hpp)
+// (already included include/epiworld/adjlist-bones.hpp)
 
+inline Network::Network(size_t n)
+{
+    reset(n);
 }
 
-template<typename TSeq>
-inline void rewire_degseq(
-    AdjList * agents,
-    Model<TSeq> * model,
-    epiworld_double proportion
-    )
+inline void Network::reset(size_t n)
 {
 
-    // Identifying individuals with degree > 0
-    std::vector< epiworld_fast_int > nties(agents->vcount(), 0);
+    if (n > static_cast< size_t >(
+        std::numeric_limits< epiworld_agent_index >::max()
+    ))
+        throw std::range_error(
+            "The network cannot have " + std::to_string(n) +
+            " vertices, as ids are stored as `epiworld_agent_index` (" +
+            std::to_string(sizeof(epiworld_agent_index) * 8u) + " bits)."
+        );
 
-    #ifdef EPI_DEBUG
-    std::vector< int > _degree0(agents->vcount(), 0);
-    for (size_t i = 0u; i < _degree0.size(); ++i)
-        _degree0[i] = agents->get_dat()[i].size();
-    #endif
-    
-    std::vector< int > non_isolates;
-    non_isolates.reserve(nties.size());
+    offsets.assign(n + 1, 0u);
+    ids.clear();
+    locations.clear();
 
-    std::vector< epiworld_double > weights;
-    weights.reserve(nties.size());
+}
 
-    epiworld_double nedges = 0.0;
-    auto & dat = agents->get_dat();
+inline void Network::build(AdjList & al)
+{
 
-    if (dat.size() > nties.size())
-        throw std::logic_error("Inconsistent adjacency list data.");
+    const auto & dat = al.get_dat();
+    size_t n = al.vcount();
 
-    for (size_t i = 0u; i < dat.size(); ++i)
-        nties[i] += dat[i].size();
+    // Ties are staged by row first, since adding a tie can append to
+    // any row (the reverse tie).
+    std::vector< std::vector< epiworld_agent_index > > rows_ids(n);
+    std::vector< std::vector< epiworld_agent_index > > rows_locs(n);
+
+    auto find = [&rows_ids](size_t row, size_t what) -> bool {
+        for (auto k : rows_ids[row])
+            if (k == what)
+                return true;
+        return false;
+    };
 
-    bool directed = agents->is_directed();
     for (size_t i = 0u; i < dat.size(); ++i)
     {
-        if (nties[i] > 0)
+
+        for (const auto & link : dat[i])
         {
-            non_isolates.push_back(i);
-            if (directed)
+
+            size_t j = static_cast< size_t >(link.first);
+
+            if (!find(i, j))
             {
-                weights.push_back(
-                    static_cast<epiworld_double>(nties[i])
+                rows_locs[i].push_back(
+                    static_cast< epiworld_agent_index >(rows_ids[j].size())
                 );
-                nedges += static_cast<epiworld_double>(nties[i]);
+                rows_ids[i].push_back(static_cast< epiworld_agent_index >(j));
             }
-            else {
-                weights.push_back(
-                    static_cast<epiworld_double>(nties[i])/2.0
+
+            if (!find(j, i))
+            {
+                rows_locs[j].push_back(
+                    static_cast< epiworld_agent_index >(rows_ids[i].size() - 1)
                 );
-                nedges += static_cast<epiworld_double>(nties[i]) / 2.0;
+                rows_ids[j].push_back(static_cast< epiworld_agent_index >(i));
             }
+
         }
+
     }
 
-    if (non_isolates.size() == 0u)
-        throw std::logic_error("The graph is completely disconnected.");
+    // Flattening
+    offsets.assign(n + 1, 0u);
+    for (size_t i = 0u; i < n; ++i)
+        offsets[i + 1] = offsets[i] + rows_ids[i].size();
 
-    // Cumulative probs
-    weights[0u] /= nedges;
-    for (epiworld_fast_uint i = 1u; i < non_isolates.size(); ++i)
+    ids.resize(offsets[n]);
+    locations.resize(offsets[n]);
+    for (size_t i = 0u; i < n; ++i)
     {
-         weights[i] /= nedges;
-         weights[i] += weights[i - 1u];
+        std::copy(rows_ids[i].begin(), rows_ids[i].end(), ids.begin() + offsets[i]);
+        std::copy(rows_locs[i].begin(), rows_locs[i].end(), locations.begin() + offsets[i]);
     }
 
-    // Only swap if needed
-    epiworld_fast_uint N = non_isolates.size();
-    epiworld_double prob;
-    int nrewires = floor(proportion * nedges / (
-        agents->is_directed() ? 1.0 : 2.0
-    ));
+}
 
-    while (nrewires-- > 0)
-    {
+inline void Network::add_edge(
+    size_t i,
+    size_t j,
+    bool check_source,
+    bool check_target
+)
+{
 
-        // Picking egos
-        prob = model->runif();
-        int id0 = N - 1;
-        for (epiworld_fast_uint i = 0u; i < N; ++i)
-            if (prob <= weights[i])
-            {
-                id0 = i;
-                break;
-            }
+    if (std::max(i, j) >= vcount())
+        throw std::range_error(
+            "The vertex is out of range. The network only has " +
+            std::to_string(vcount()) + " vertices."
+        );
 
-        prob = model->runif();
-        int id1 = N - 1;
-        for (epiworld_fast_uint i = 0u; i < N; ++i)
-            if (prob <= weights[i])
-            {
-                id1 = i;
-                break;
-            }
+    auto insert = [this](size_t row, size_t id, size_t loc) -> void {
 
-        // Correcting for under or overflow.
-        if (id1 == id0)
-            id1++;
+        size_t pos = offsets[row + 1];
+        ids.insert(
+            ids.begin() + pos, static_cast< epiworld_agent_index >(id)
+        );
+        locations.insert(
+            locations.begin() + pos, static_cast< epiworld_agent_index >(loc)
+        );
 
-        if (id1 >= static_cast<int>(N))
-            id1 = 0;
+        for (size_t k = row + 1; k < offsets.size(); ++k)
+            ++offsets[k];
 
-        std::map<int,int> & p0 = agents->get_dat()[non_isolates[id0]];
-        std::map<int,int> & p1 = agents->get_dat()[non_isolates[id1]];
+    };
 
-        // Picking alters (relative location in their lists)
-        // In this case, these are uniformly distributed within the list
-        int id01 = model->runif_index(p0.size());
-        int id11 = model->runif_index(p1.size());
+    auto find = [this](size_t row, size_t what) -> bool {
+        for (size_t k = offsets[row]; k < offsets[row + 1]; ++k)
+            if (ids[k] == what)
+                return true;
+        return false;
+    };
 
-        // Since it is a map, we need to find the actual ids (positions)
-        // are not good enough.
-        int count = 0;
-        for (auto & n : p0)
-            if (count++ == id01)
-                id01 = n.first;
+    // Three things going on here:
+    // - Where in the neighbor will this be
+    // - What is the neighbor's id
+    // - Increasing the number of neighbors
+    if (!check_source || !find(i, j))
+        insert(i, j, degree(j));
 
-        count = 0;
-        for (auto & n : p1)
-            if (count++ == id11)
-                id11 = n.first;
+    if (!check_target || !find(j, i))
+        insert(j, i, degree(i) - 1);
 
-        // When rewiring, we need to actually swap the edges, not just the weights
-        // We'll swap edges: (id0, id01) <-> (id1, id11)
-        // After swap: (id0, id11) and (id1, id01)
-        // But first, check if the swap would create duplicate or self-loop edges
-        
-        // Check for self-loops (new edge would connect node to itself)
-        if (id01 == non_isolates[id1] || id11 == non_isolates[id0]) {
-            continue;
-        }
-        
-        // Check for duplicate edges (new edge already exists)
-        if (p0.find(id11) != p0.end() || p1.find(id01) != p1.end()) {
-            continue; // Skip this rewire attempt to avoid duplicate edges
-        }
-        
-        // Check if we're trying to swap the same neighbor
-        if (id01 == id11) {
-            continue;
-        }
-        
-        // Save the weights before removing edges
-        int weight_0_01 = p0[id01];
-        int weight_1_11 = p1[id11];
-        
-        // Remove old edges from ego perspectives
-        p0.erase(id01);
-        p1.erase(id11);
-        
-        // Add new edges from ego perspectives with swapped alters
-        p0[id11] = weight_0_01;
-        p1[id01] = weight_1_11;
-        
-        // For undirected graphs, also update from alter perspectives
-        if (!agents->is_directed())
-        {
-            std::map<int,int> & p01 = agents->get_dat()[id01];
-            std::map<int,int> & p11 = agents->get_dat()[id11];
-            
-            // Save weights from alter perspectives
-            int weight_01_0 = p01[non_isolates[id0]];
-            int weight_11_1 = p11[non_isolates[id1]];
-            
-            // Remove old edges from alter perspectives
-            p01.erase(non_isolates[id0]);
-            p11.erase(non_isolates[id1]);
-            
-            // Add new edges from alter perspectives
-            p01[non_isolates[id1]] = weight_11_1;
-            p11[non_isolates[id0]] = weight_01_0;
-        }
+}
 
-    }
+inline size_t Network::vcount() const noexcept
+{
+    return offsets.size() - 1u;
+}
 
-    #ifdef EPI_DEBUG
-    for (size_t _i = 0u; _i < _degree0.size(); ++_i)
-    {
-        if (_degree0[_i] != static_cast<int>(agents->get_dat()[_i].size()))
-            throw std::logic_error(
-                "[epi-debug] Degree does not match afted rewire_degseq. " +
-                std::string("Expected: ") +
-                std::to_string(_degree0[_i]) +
-                std::string(", observed: ") +
-                std::to_string(agents->get_dat()[_i].size())
-                );
-    }
-    #endif
+inline size_t Network::ecount() const noexcept
+{
+    return ids.size();
+}
 
+inline size_t Network::degree(size_t i) const
+{
+    return offsets[i + 1] - offsets[i];
+}
 
-    return;
+inline epiworld_agent_index * Network::neighbors(size_t i)
+{
+    return ids.data() + offsets[i];
+}
 
+inline const epiworld_agent_index * Network::neighbors(size_t i) const
+{
+    return ids.data() + offsets[i];
 }
 
-/**
- * Threshold for the hybrid row-advance in Batagelj-Brandes.
- *
- * When a geometric skip lands past the current row of the lower-triangle
- * enumeration, the flat index must be mapped back to (i, j). For small
- * excess (j - i <= threshold) the integer while-loop is fastest; for
- * large excess the O(1) inverse-triangular-number formula avoids
- * O(sqrt(excess)) iterations. 200 keeps the loop body to at most ~20
- * iterations (sqrt(2 * 200) ~ 20) before switching to FPU math.
- */
-static constexpr long long BB_FPU_THRESHOLD = 200;
+inline epiworld_agent_index * Network::neighbors_locations(size_t i)
+{
+    return locations.data() + offsets[i];
+}
 
-/**
- * @brief Generates an Erdős–Rényi random graph G(n, p) using the
- * Batagelj-Brandes algorithm.
- *
- * Uses geometric skipping to advance through the space of possible edges,
- * generating each edge independently with probability p. This produces
- * **unbiased** edge counts in O(n + m) expected time, where m is the
- * number of edges generated.
- *
- * Reference: V. Batagelj and U. Brandes, "Efficient generation of large
- * random networks," Physical Review E, vol. 71, no. 3, 2005.
- *
- * @tparam TSeq Type of the sequence (template parameter of the model).
- * @param n Number of nodes.
- * @param p Edge probability.
- * @param directed Whether the graph is directed.
- * @param model A reference to the Model, used for random number generation.
- * @return An AdjList representing the generated network.
- */
-template<typename TSeq>
-inline AdjList rgraph_bernoulli(
-    epiworld_fast_uint n,
-    epiworld_double p,
-    bool directed,
-    Model<TSeq> & model
-) {
+inline const epiworld_agent_index * Network::neighbors_locations(size_t i) const
+{
+    return locations.data() + offsets[i];
+}
 
-    std::vector< int > source;
-    std::vector< int > target;
+inline bool Network::operator==(const Network & other) const
+{
 
-    // Pre-allocate based on expected edge count
-    double n_possible = directed
-        ? static_cast<double>(n) * (n - 1.0)
-        : static_cast<double>(n) * (n - 1.0) / 2.0;
-    source.reserve(static_cast<size_t>(n_possible * p * 1.1));
-    target.reserve(static_cast<size_t>(n_possible * p * 1.1));
+    if (offsets != other.offsets)
+        return false;
 
-    // Batagelj-Brandes: use geometric skipping to enumerate edges.
-    // log(1 - p) is precomputed; each skip is 1 + floor(log(U) / lp).
-    double lp = std::log(1.0 - p);
+    return ids == other.ids;
 
-    if (!directed)
-    {
-        // Undirected: iterate over (i, j) with i > j
-        long long i = 1;
-        long long j = -1;
+}
 
-        while (i < static_cast<long long>(n))
-        {
-            // Geometric skip
-            double r = model.runif();
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-            // Avoid log(0)
-            if (r == 0.0)
-                r = std::numeric_limits<double>::min();
+ End of -./include/epiworld/network-meat.hpp-
 
-            j += 1 + static_cast<long long>(
-                std::floor(std::log(r) / lp)
-            );
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-            // Advance to the next row if j >= i.
-            // Hybrid approach: for large skips, use O(1) FPU
-            // inverse-triangular-number formula instead of the
-            // integer loop, avoiding O(sqrt(skip)) iterations.
-            if (j >= i && i < static_cast<long long>(n))
-            {
-                if (j - i > BB_FPU_THRESHOLD)
-                {
-                    // O(1) FPU mapping: flat index → (i, j) via
-                    // inverse triangular number. `flat` fits in
-                    // long long since n ≤ INT_MAX (AdjList limit),
-                    // so i*(i-1)/2 + j < n*(n-1)/2 ≪ 2^62.
-                    long long flat = i * (i - 1) / 2 + j;
-                    double df = static_cast<double>(flat);
-                    i = static_cast<long long>(std::floor(
-                        (1.0 + std::sqrt(1.0 + 8.0 * df)) / 2.0
-                    ));
-                    j = flat - i * (i - 1) / 2;
-                    // Floating-point correction: sqrt may round i
-                    // up or down by 1 for large flat values, so j
-                    // may land outside [0, i). Each correction loop
-                    // runs at most 1–2 iterations; only one of the
-                    // two can execute for a given (i, j).
-                    while (j >= i) { j -= i; i++; }
-                    while (j < 0)  { i--; j += i; }
-                }
-                else
-                {
-                    while (j >= i && i < static_cast<long long>(n))
-                    {
-                        j -= i;
-                        i++;
-                    }
-                }
-            }
 
-            if (i < static_cast<long long>(n))
-            {
-                source.push_back(static_cast<int>(i));
-                target.push_back(static_cast<int>(j));
-            }
-        }
-    }
-    else
-    {
-        // Directed: iterate over (i, j) with i != j
-        // We linearize pairs: for row i, columns [0..n-1] excluding i.
-        // Position k in [0, n*(n-1)) maps to row = k/(n-1),
-        // col = k%(n-1), if col >= row then col++.
-        long long total = static_cast<long long>(n) * (n - 1);
-        long long k = -1;
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-        while (true)
-        {
-            double r = model.runif();
-            if (r == 0.0)
-                r = std::numeric_limits<double>::min();
+ Start of -./include/epiworld/indexedheap-bones.hpp-
 
-            k += 1 + static_cast<long long>(
-                std::floor(std::log(r) / lp)
-            );
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-            if (k >= total)
-                break;
 
-            long long row = k / static_cast<long long>(n - 1);
-            long long col = k % static_cast<long long>(n - 1);
-            if (col >= row)
-                col++;
+#ifndef EPIWORLD_INDEXEDHEAP_BONES_HPP
+#define EPIWORLD_INDEXEDHEAP_BONES_HPP
 
-            source.push_back(static_cast<int>(row));
-            target.push_back(static_cast<int>(col));
-        }
-    }
+#include <vector>
+#include <limits>
+// (already included include/epiworld/config.hpp)
 
-    AdjList al(source, target, static_cast<int>(n), directed);
+/**
+ * @brief Binary min-heap over a fixed set of items with updatable keys
+ * @details
+ * Items are identified by their index in `[0, n)`. The heap keeps the
+ * position of each item (`pos`), so changing the key of an item is
+ * `O(log n)` and the minimum is available in `O(1)`. Used by the
+ * next-reaction engine (`Model<TSeq>::run_continuous()`) to keep the time
+ * of the next event of each agent. Items without a scheduled event carry
+ * an infinite key.
+ */
+class IndexedMinHeap
+{
+private:
 
-    return al;
+    std::vector< epiworld_double > keys; ///< Key of each item.
+    std::vector< size_t > heap;          ///< Items in heap order.
+    std::vector< size_t > pos;           ///< Position of each item in `heap`.
 
-}
+    void swap_at(size_t a, size_t b);
+    void sift_up(size_t i);
+    void sift_down(size_t i);
 
-template<typename TSeq>
-inline AdjList rgraph_bernoulli2(
-    epiworld_fast_uint n,
-    epiworld_double p,
-    bool directed,
-    Model<TSeq> & model
-) {
+public:
 
-    std::vector< int > source;
-    std::vector< int > target;
+    IndexedMinHeap() = default;
 
-    // Checking the density (how many)
-    std::binomial_distribution<> d(
-        n * (n - 1.0) / (directed ? 1.0 : 2.0),
-        p
-    );
+    /**
+     * @brief Resets the heap to `n` items, all with infinite keys
+     * @param n Number of items.
+     */
+    void reset(size_t n);
 
-    // Need to compensate for the possible number of diagonal
-    // elements sampled. If n * n, then each diag element has
-    // 1/(n^2) chance of sampling
+    /**
+     * @brief Sets the key of item `i` and restores the heap order
+     * @param i Item index.
+     * @param key New key.
+     */
+    void update(size_t i, epiworld_double key);
 
-    epiworld_fast_uint m = d(model.get_rand_endgine());
+    size_t top() const;                    ///< Item with the smallest key.
+    epiworld_double top_key() const;       ///< Smallest key.
+    epiworld_double key(size_t i) const;   ///< Key of item `i`.
+    size_t size() const noexcept;          ///< Number of items.
 
-    source.resize(m);
-    target.resize(m);
+};
 
-    double n2 = static_cast<double>(n * n);
+inline void IndexedMinHeap::swap_at(size_t a, size_t b)
+{
+    std::swap(heap[a], heap[b]);
+    pos[heap[a]] = a;
+    pos[heap[b]] = b;
+}
 
-    int loc,row,col;
-    for (epiworld_fast_uint i = 0u; i < m; ++i)
+inline void IndexedMinHeap::sift_up(size_t i)
+{
+
+    while (i > 0u)
     {
-        loc = floor(model.runif() * n2);
-        col = floor(static_cast<double>(loc)/static_cast<double>(n));
-        row = loc - row * n;
+        size_t parent = (i - 1u) / 2u;
+        if (keys[heap[parent]] <= keys[heap[i]])
+            break;
 
-        // Undirected needs to swap
-        if (!directed && (col > row))
-            std::swap(col, row);
+        swap_at(i, parent);
+        i = parent;
+    }
 
-        source[i] = row;
-        target[i] = col;
+}
 
-    }
+inline void IndexedMinHeap::sift_down(size_t i)
+{
 
-    AdjList al(source, target, static_cast<int>(n), directed);
+    size_t n = heap.size();
+    while (true)
+    {
+        size_t smallest = i;
+        size_t left     = 2u * i + 1u;
+        size_t right    = left + 1u;
 
-    return al;
+        if ((left < n) && (keys[heap[left]] < keys[heap[smallest]]))
+            smallest = left;
 
-}
+        if ((right < n) && (keys[heap[right]] < keys[heap[smallest]]))
+            smallest = right;
 
-inline AdjList rgraph_ring_lattice(
-    epiworld_fast_uint n,
-    epiworld_fast_uint k,
-    bool directed = false
-) {
+        if (smallest == i)
+            break;
 
-    if ((n - 1u) < k)
-        throw std::logic_error("k can be at most n - 1.");
+        swap_at(i, smallest);
+        i = smallest;
+    }
 
-    std::vector< int > source;
-    std::vector< int > target;
+}
 
-    if (!directed)
-        if (k > 1u) k = static_cast< size_t >(floor(k / 2.0));
+inline void IndexedMinHeap::reset(size_t n)
+{
 
-    for (size_t i = 0; i < n; ++i)
+    keys.assign(n, std::numeric_limits< epiworld_double >::infinity());
+    heap.resize(n);
+    pos.resize(n);
+
+    for (size_t i = 0u; i < n; ++i)
     {
+        heap[i] = i;
+        pos[i]  = i;
+    }
 
-        for (size_t j = 1u; j <= k; ++j)
-        {
+}
 
-            // Next neighbor
-            size_t l = i + j;
-            if (l >= n) l = l - n;
+inline void IndexedMinHeap::update(size_t i, epiworld_double key)
+{
 
-            source.push_back(i);
-            target.push_back(l);
+    epiworld_double old = keys[i];
+    keys[i] = key;
 
-        }
+    if (key < old)
+        sift_up(pos[i]);
+    else if (key > old)
+        sift_down(pos[i]);
 
-    }
+}
 
-    return AdjList(source, target, n, directed);
+inline size_t IndexedMinHeap::top() const
+{
+    if (heap.empty())
+        throw std::logic_error("The heap is empty.");
+
+    return heap[0u];
+}
+
+inline epiworld_double IndexedMinHeap::top_key() const
+{
+    if (heap.empty())
+        return std::numeric_limits< epiworld_double >::infinity();
+
+    return keys[heap[0u]];
+}
+
+inline epiworld_double IndexedMinHeap::key(size_t i) const
+{
+    return keys[i];
+}
 
+inline size_t IndexedMinHeap::size() const noexcept
+{
+    return heap.size();
 }
 
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/indexedheap-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/profiler-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_PROFILER_BONES_HPP
+#define EPIWORLD_PROFILER_BONES_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+// (already included include/epiworld/config.hpp)
+
 /**
- * @brief Smallworld network (Watts-Strogatz)
+ * @brief Time per phase and counters of a simulation
+ * @details
+ * `Model<TSeq>` keeps one for the last run and one for all its runs (see
+ * `Model<TSeq>::get_profile()`). Phases are timed exclusively: the time
+ * spent in a nested phase (e.g., `events_run()` called from the global
+ * events) is only counted in the nested phase.
  *
- * @tparam TSeq
- * @param n
- * @param k
- * @param p
- * @param directed
- * @param model
- * @return AdjList
+ * The instrumentation is only compiled when `EPI_PROFILE` is defined;
+ * otherwise the `EPI_PROFILE_*` macros expand to nothing and all the
+ * times and counters stay at zero.
  */
-template<typename TSeq>
-inline AdjList rgraph_smallworld(
-    epiworld_fast_uint n,
-    epiworld_fast_uint k,
-    epiworld_double p,
-    bool directed,
-    Model<TSeq> & model
-) {
+class Profiler
+{
+public:
 
-    // Creating the ring lattice
-    AdjList ring = rgraph_ring_lattice(n,k,directed);
+    enum Phase : size_t {
+        UpdateState,  ///< Update functions of the agents.
+        EventsRun,    ///< Applying the events (`Model::events_run()`).
+        GlobalEvents, ///< Global events (without the events they add).
+        Rewire,       ///< Rewiring the network.
+        Record,       ///< Recording the day (`DataBase::record()`).
+        MutateVirus,  ///< Mutating the viruses.
+        NPhases
+    };
 
-    // Rewiring and returning
-    if (k > 0u)
-        rewire_degseq(&ring, &model, p);
+    enum Counter : size_t {
+        AgentsVisited, ///< Agents whose state was checked for an update.
+        StateFunCalls, ///< Calls to update functions.
+        RngDraws,      ///< Random variates drawn from the model.
+        NCounters
+    };
 
-    return ring;
+    static constexpr size_t NEventActions =
+        static_cast< size_t >(EventAction::ChangeState) + 1u;
+
+private:
+
+    std::array< epiworld_double, NPhases > times = {};   ///< Microseconds.
+    std::array< uint64_t, NCounters > counters = {};
+    std::array< uint64_t, NEventActions > events = {};   ///< By `EventAction`.
+
+    // Stack of open phases (for exclusive timing)
+    std::array< size_t, 8u > stack = {};
+    size_t depth = 0u;
+    std::chrono::time_point< std::chrono::steady_clock > tic;
+
+    void stop_current(std::chrono::time_point< std::chrono::steady_clock > now);
+
+public:
+
+    Profiler() = default;
+
+    void reset(); ///< Sets all times and counters to zero.
+
+    /**
+     * @name Timing
+     * @details `enter()` pauses the current phase (if any) and starts
+     * `phase`; `leave()` stops it and resumes the previous one. `Scope`
+     * does both (RAII).
+     */
+    ///@{
+    void enter(Phase phase);
+    void leave();
+
+    class Scope {
+    private:
+        Profiler & profiler;
+    public:
+        Scope(Profiler & p, Phase phase) : profiler(p) { profiler.enter(phase); };
+        ~Scope() { profiler.leave(); };
+    };
+    ///@}
+
+    /**
+     * @brief Adds to a counter
+     * @details Thread-safe (atomic), since variates can be drawn within
+     * the parallel update.
+     */
+    void add(Counter counter, uint64_t n = 1u);
+    void add_event(EventAction action);
+
+    Profiler & operator+=(const Profiler & other); ///< Aggregates (e.g., replicates).
+
+    epiworld_double get_time(Phase phase) const; ///< Microseconds.
+    uint64_t get_count(Counter counter) const;
+    uint64_t get_events(EventAction action) const;
+
+    static const char * phase_name(Phase phase);
+    static const char * counter_name(Counter counter);
+    static const char * event_name(EventAction action);
+
+    void print() const;
+
+};
+
+#ifdef EPI_PROFILE
+    #define EPI_PROFILE_SCOPE(profiler, phase) \
+        Profiler::Scope epi_profile_scope_((profiler), Profiler::phase);
+    #define EPI_PROFILE_ADD(profiler, counter, n) \
+        (profiler).add(Profiler::counter, (n));
+    #define EPI_PROFILE_EVENT(profiler, action) \
+        (profiler).add_event(action);
+#else
+    #define EPI_PROFILE_SCOPE(profiler, phase)
+    #define EPI_PROFILE_ADD(profiler, counter, n)
+    #define EPI_PROFILE_EVENT(profiler, action)
+#endif
 
+inline void Profiler::reset()
+{
+    times.fill(0.0);
+    counters.fill(0u);
+    events.fill(0u);
+    depth = 0u;
 }
 
-/**
- * @brief Generates a blocked network
- *
- * Since block sizes and number of connections between blocks are fixed,
- * this routine is fully deterministic.
- *
- * @tparam TSeq
- * @param n Size of the network
- * @param blocksize Size of the block.
- * @param ncons Number of connections between blocks
- * @param model A model
- * @return AdjList
- */
-template<typename TSeq>
-inline AdjList rgraph_blocked(
-    epiworld_fast_uint n,
-    epiworld_fast_uint blocksize,
-    epiworld_fast_uint ncons,
-    Model<TSeq>&
-) {
+inline void Profiler::stop_current(
+    std::chrono::time_point< std::chrono::steady_clock > now
+)
+{
 
-    std::vector< int > source_;
-    std::vector< int > target_;
+    // Phases nested deeper than the stack are not timed
+    if ((depth == 0u) || (depth > stack.size()))
+        return;
 
-    size_t i = 0u;
-    size_t cum_node_count = 0u;
-    while (i < n)
-    {
+    times[stack[depth - 1u]] +=
+        std::chrono::duration< epiworld_double, std::micro >(now - tic).count();
 
-        for (size_t j = 0; j < blocksize; ++j)
-        {
+}
 
-            for (size_t k = 0; k < j; ++k)
-            {
-                // No loops
-                if (k == j)
-                    continue;
+inline void Profiler::enter(Phase phase)
+{
 
-                // Exists the loop in case there are no more
-                // nodes available
-                if ((i + k) >= n)
-                    break;
+    auto now = std::chrono::steady_clock::now();
+    stop_current(now);
 
-                source_.push_back(static_cast<int>(j + i));
-                target_.push_back(static_cast<int>(k + i));
-            }
+    if (depth < stack.size())
+        stack[depth] = phase;
 
-            // No more nodes left to build connections
-            if (++cum_node_count >= n)
-                break;
+    ++depth;
+    tic = now;
 
-        }
+}
 
-        // Connections between this and the previou sone
-        if (i != 0)
-        {
+inline void Profiler::leave()
+{
 
-            size_t max_cons = std::min(ncons, n - cum_node_count);
+    auto now = std::chrono::steady_clock::now();
 
-            // Generating the connections
-            for (size_t j = 0u; j < max_cons; ++j)
-            {
+    stop_current(now);
 
-                source_.push_back(static_cast<int>(i + j - blocksize));
-                target_.push_back(static_cast<int>(i + j));
+    if (depth > 0u)
+        --depth;
 
-            }
-        }
+    tic = now;
 
-        i += blocksize;
+}
 
-    }
+inline void Profiler::add(Counter counter, uint64_t n)
+{
+    #pragma omp atomic
+    counters[counter] += n;
+}
 
-    return AdjList(source_, target_, n, false);
+inline void Profiler::add_event(EventAction action)
+{
+    events[static_cast< size_t >(action)]++;
+}
+
+inline Profiler & Profiler::operator+=(const Profiler & other)
+{
+
+    for (size_t i = 0u; i < NPhases; ++i)
+        times[i] += other.times[i];
+
+    for (size_t i = 0u; i < NCounters; ++i)
+        counters[i] += other.counters[i];
+
+    for (size_t i = 0u; i < NEventActions; ++i)
+        events[i] += other.events[i];
+
+    return *this;
 
 }
 
-/**
- * @brief Generates a network using a Stochastic Block Model (SBM).
- *
- * This function creates a random undirected network where connections between
- * agents are determined by a mixing matrix and block (group) membership.
- * Each potential edge between agents in blocks \f$g\f$ and \f$h\f$ is included
- * independently with probability \f$M(g, h) / n_h\f$, where \f$M(g, h)\f$ is
- * the entry of the mixing matrix and \f$n_h\f$ is the number of agents in
- * block \f$h\f$.
- *
- * The mixing matrix is **not** row-stochastic. For undirected networks, its
- * row sums should be interpreted as the average expected degree for agents in
- * that group only when the balance condition
- * \f$M(g, h) \times n_g = M(h, g) \times n_h\f$ holds for all pairs
- * \f$(g, h)\f$. In that balanced case,
- * \f[
- *   \mathbb{E}[\text{degree of agent in group } g] = \sum_{h} M(g, h)
- * \f]
- *
- * For undirected networks, the implementation samples between-block edges only
- * once for each unordered pair of blocks (with \f$g \le h\f$) using
- * \f$M(g, h) / n_h\f$. Therefore, if the balance condition is violated, the
- * row sums generally do not match the expected degree from every group's
- * perspective.
- *
- * **Unbiased generation.** Edge generation uses the Batagelj-Brandes
- * algorithm (geometric skipping) independently for each block pair.
- * Each possible edge is included with exactly the correct probability,
- * with no duplicate edge collisions. The expected number of edges for a
- * block pair is exactly:
- * - Within-block: \f$\binom{n_g}{2} \times p_{gg}\f$
- * - Between-block: \f$n_g \times n_h \times p_{gh}\f$
- *
- * **Balance condition warning.** If the balance condition is violated for
- * any pair of blocks and the model's verbose mode is on, a warning is
- * printed indicating which entries are being silently ignored.
- *
- * Reference: V. Batagelj and U. Brandes, "Efficient generation of large
- * random networks," Physical Review E, vol. 71, no. 3, 2005.
- *
- * @tparam TSeq Type of the sequence (template parameter of the model).
- * @param block_sizes A vector of size \f$K\f$ indicating the number of agents
- *   per block. The total number of agents is \f$\sum_k \text{block\_sizes}[k]\f$.
- * @param mixing_matrix A vector of size \f$K \times K\f$ representing the
- *   mixing matrix. The entry \f$M(g, h)\f$ controls the expected number of
- *   connections agents in group \f$g\f$ make with agents in group \f$h\f$.
- * @param row_major If `true`, the mixing matrix is stored in row-major order
- *   (C-style), i.e., \f$M(g, h) = \text{mixing\_matrix}[g \times K + h]\f$.
- *   If `false`, column-major order (Fortran-style) is assumed, i.e.,
- *   \f$M(g, h) = \text{mixing\_matrix}[h \times K + g]\f$.
- * @param model A reference to the Model, used for random number generation.
- * @return An AdjList representing the generated undirected network.
- *
- * @throws std::length_error If `block_sizes` is empty, `mixing_matrix` size
- *   does not equal \f$K^2\f$, or any block size is zero.
- * @throws std::range_error If any mixing matrix entry is negative or if
- *   \f$M(g, h) / n_h > 1\f$ for any pair of blocks.
- */
-template<typename TSeq>
-inline AdjList rgraph_sbm(
-    const std::vector< size_t > & block_sizes,
-    const std::vector< double > & mixing_matrix,
-    bool row_major,
-    Model<TSeq> & model
-) {
+inline epiworld_double Profiler::get_time(Phase phase) const
+{
+    return times.at(phase);
+}
 
-    size_t n_blocks = block_sizes.size();
+inline uint64_t Profiler::get_count(Counter counter) const
+{
+    return counters.at(counter);
+}
 
-    if (n_blocks == 0u)
-        throw std::length_error(
-            "block_sizes must have at least one element."
-        );
+inline uint64_t Profiler::get_events(EventAction action) const
+{
+    return events.at(static_cast< size_t >(action));
+}
 
-    if (mixing_matrix.size() != n_blocks * n_blocks)
-        throw std::length_error(
-            "mixing_matrix must have size K * K, where K = block_sizes.size(). "
-            "Expected " + std::to_string(n_blocks * n_blocks) +
-            " but got " + std::to_string(mixing_matrix.size()) + "."
-        );
+inline const char * Profiler::phase_name(Phase phase)
+{
 
-    // Total number of agents
-    size_t n = 0u;
-    const size_t max_adjlist_n = static_cast<size_t>(
-        std::numeric_limits<int>::max()
-    );
-    for (auto bs : block_sizes)
-    {
-        if (bs == 0u)
-            throw std::length_error(
-                "All block sizes must be positive."
-            );
+    static const char * names[NPhases] = {
+        "update_state", "events_run", "run_globalevents", "rewire",
+        "record", "mutate_virus"
+    };
 
-        if (bs > max_adjlist_n - n)
-            throw std::length_error(
-                "The total number of agents implied by block_sizes exceeds "
-                "the maximum supported graph size (" +
-                std::to_string(std::numeric_limits<int>::max()) + ")."
-            );
+    return names[phase];
 
-        n += bs;
-    }
+}
 
-    // Compute the starting index for each block
-    std::vector< size_t > block_start(n_blocks, 0u);
-    for (size_t g = 1u; g < n_blocks; ++g)
-        block_start[g] = block_start[g - 1u] + block_sizes[g - 1u];
+inline const char * Profiler::counter_name(Counter counter)
+{
 
-    // Validate mixing matrix entries and compute probabilities.
-    // p(g, h) = M(g, h) / n_h for the undirected case.
-    // We validate that all entries are non-negative and p(g,h) <= 1.
-    // Also estimate the total expected edge count for vector reservation.
-    double estimated_edges = 0.0;
-    for (size_t g = 0u; g < n_blocks; ++g)
-    {
-        for (size_t h = 0u; h < n_blocks; ++h)
-        {
-            double m_gh = row_major
-                ? mixing_matrix[g * n_blocks + h]
-                : mixing_matrix[h * n_blocks + g];
+    static const char * names[NCounters] = {
+        "agents visited", "state_fun calls", "random draws"
+    };
 
-            if (m_gh < 0.0)
-                throw std::range_error(
-                    "Mixing matrix entries must be non-negative. "
-                    "Entry (" + std::to_string(g) + ", " +
-                    std::to_string(h) + ") = " + std::to_string(m_gh) + "."
-                );
+    return names[counter];
 
-            double p_gh = m_gh / static_cast<double>(block_sizes[h]);
-            if (p_gh > 1.0)
-                throw std::range_error(
-                    "Mixing matrix entry (" + std::to_string(g) + ", " +
-                    std::to_string(h) + ") = " + std::to_string(m_gh) +
-                    " implies probability " + std::to_string(p_gh) +
-                    " > 1 (block size = " +
-                    std::to_string(block_sizes[h]) + ")."
-                );
-        }
+}
 
-        // Accumulate expected edges for upper triangle (g <= h)
-        for (size_t h = g; h < n_blocks; ++h)
-        {
-            double m_gh = row_major
-                ? mixing_matrix[g * n_blocks + h]
-                : mixing_matrix[h * n_blocks + g];
+inline const char * Profiler::event_name(EventAction action)
+{
 
-            double p_gh = m_gh / static_cast<double>(block_sizes[h]);
-            if (p_gh <= 0.0)
-                continue;
+    static const char * names[NEventActions] = {
+        "add virus", "add tool", "add entity", "remove virus",
+        "remove tool", "remove entity", "change state"
+    };
 
-            double n_possible;
-            if (g == h)
-                n_possible = static_cast<double>(block_sizes[g]) *
-                    static_cast<double>(block_sizes[g] - 1u) / 2.0;
-            else
-                n_possible = static_cast<double>(block_sizes[g]) *
-                    static_cast<double>(block_sizes[h]);
+    return names[static_cast< size_t >(action)];
 
-            estimated_edges += n_possible * std::min(p_gh, 1.0);
-        }
-    }
+}
 
-    // Warn when the balance condition M(g,h)*n_g = M(h,g)*n_h is
-    // violated for any pair. The upper triangle is used for sampling,
-    // so the lower-triangle entries are silently ignored.
-    if (model.get_verbose())
+inline void Profiler::print() const
+{
+
+    printf_epiworld("Time per phase (ms):\n");
+    for (size_t i = 0u; i < NPhases; ++i)
     {
-        for (size_t g = 0u; g < n_blocks; ++g)
-        {
-            for (size_t h = g + 1u; h < n_blocks; ++h)
-            {
-                double m_gh = row_major
-                    ? mixing_matrix[g * n_blocks + h]
-                    : mixing_matrix[h * n_blocks + g];
-                double m_hg = row_major
-                    ? mixing_matrix[h * n_blocks + g]
-                    : mixing_matrix[g * n_blocks + h];
+        printf_epiworld(
+            "  %-20s: %.3f\n",
+            phase_name(static_cast< Phase >(i)), times[i] / 1000.0
+        );
+    }
 
-                double lhs = m_gh * static_cast<double>(block_sizes[g]);
-                double rhs = m_hg * static_cast<double>(block_sizes[h]);
+    printf_epiworld("Counters:\n");
+    for (size_t i = 0u; i < NCounters; ++i)
+    {
+        printf_epiworld(
+            "  %-20s: %llu\n",
+            counter_name(static_cast< Counter >(i)),
+            static_cast< unsigned long long >(counters[i])
+        );
+    }
 
-                if (std::abs(lhs - rhs) > 1e-10 *
-                    std::max(std::abs(lhs), std::abs(rhs)))
-                {
-                    printf_epiworld(
-                        "Warning [rgraph_sbm]: balance condition violated "
-                        "for blocks (%zu, %zu): M(%zu,%zu)*n_%zu = %.4f "
-                        "!= M(%zu,%zu)*n_%zu = %.4f. Only M(%zu,%zu)/n_%zu "
-                        "is used for edge sampling.\n",
-                        g, h,
-                        g, h, g, lhs,
-                        h, g, h, rhs,
-                        g, h, h
-                    );
-                }
-            }
-        }
+    printf_epiworld("Events:\n");
+    for (size_t i = 0u; i < NEventActions; ++i)
+    {
+        printf_epiworld(
+            "  %-20s: %llu\n",
+            event_name(static_cast< EventAction >(i)),
+            static_cast< unsigned long long >(events[i])
+        );
     }
 
-    std::vector< int > source;
-    std::vector< int > target;
+}
 
-    // Pre-allocate based on estimated edge count to avoid
-    // repeated reallocations during push_back.
-    source.reserve(static_cast<size_t>(estimated_edges * 1.1));
-    target.reserve(static_cast<size_t>(estimated_edges * 1.1));
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    // Batagelj-Brandes geometric skipping for each block pair.
-    // For each pair (g, h) with g <= h, we enumerate possible edges
-    // and skip ahead using geometric random variables, producing each
-    // edge independently with exactly probability p_gh. No duplicates,
-    // no bias.
-    for (size_t g = 0u; g < n_blocks; ++g)
-    {
-        for (size_t h = g; h < n_blocks; ++h)
-        {
+ End of -./include/epiworld/profiler-bones.hpp-
 
-            double m_gh = row_major
-                ? mixing_matrix[g * n_blocks + h]
-                : mixing_matrix[h * n_blocks + g];
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-            // Probability of an edge between agents in blocks g and h
-            double p_gh = m_gh / static_cast<double>(block_sizes[h]);
 
-            if (p_gh <= 0.0)
-                continue;
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-            // Fast path: p_gh >= 1.0 means all edges are present
-            if (p_gh >= 1.0)
-            {
-                if (g == h)
-                {
-                    // All unique pairs within the block
-                    for (size_t i = block_start[g];
-                         i < block_start[g] + block_sizes[g]; ++i)
-                    {
-                        for (size_t j = i + 1u;
-                             j < block_start[g] + block_sizes[g]; ++j)
-                        {
-                            source.push_back(static_cast<int>(i));
-                            target.push_back(static_cast<int>(j));
-                        }
-                    }
-                }
-                else
-                {
-                    // All pairs between blocks g and h
-                    for (size_t i = block_start[g];
-                         i < block_start[g] + block_sizes[g]; ++i)
-                    {
-                        for (size_t j = block_start[h];
-                             j < block_start[h] + block_sizes[h]; ++j)
-                        {
-                            source.push_back(static_cast<int>(i));
-                            target.push_back(static_cast<int>(j));
-                        }
-                    }
-                }
-                continue;
-            }
+ Start of -./include/epiworld/memoryusage-bones.hpp-
 
-            double lp = std::log(1.0 - p_gh);
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-            if (g == h)
-            {
-                // Within-block: iterate (i, j) with i > j, both in
-                // [0, n_g). Use BB geometric skipping.
-                long long n_g = static_cast<long long>(block_sizes[g]);
-                long long i = 1;
-                long long j = -1;
 
-                while (i < n_g)
-                {
-                    double r = model.runif();
-                    if (r == 0.0)
-                        r = std::numeric_limits<double>::min();
+#ifndef EPIWORLD_MEMORYUSAGE_BONES_HPP
+#define EPIWORLD_MEMORYUSAGE_BONES_HPP
 
-                    j += 1 + static_cast<long long>(
-                        std::floor(std::log(r) / lp)
-                    );
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unordered_map>
+// (already included include/epiworld/config.hpp)
 
-                    // Hybrid row-advance (see BB_FPU_THRESHOLD
-                    // comment in rgraph_bernoulli above).
-                    if (j >= i && i < n_g)
-                    {
-                        if (j - i > BB_FPU_THRESHOLD)
-                        {
-                            long long flat = i * (i - 1) / 2 + j;
-                            double df = static_cast<double>(flat);
-                            i = static_cast<long long>(std::floor(
-                                (1.0 + std::sqrt(1.0 + 8.0 * df)) / 2.0
-                            ));
-                            j = flat - i * (i - 1) / 2;
-                            while (j >= i) { j -= i; i++; }
-                            while (j < 0)  { i--; j += i; }
-                        }
-                        else
-                        {
-                            while (j >= i && i < n_g)
-                            {
-                                j -= i;
-                                i++;
-                            }
-                        }
-                    }
+/**
+ * @brief Memory used by a model, in bytes, by component
+ * @details
+ * Returned by `Model<TSeq>::memory_usage()` (measured) and
+ * `Model<TSeq>::estimate_memory_usage()` (predicted). Containers are
+ * counted by their capacity. Objects are counted by their own size, so
+ * heap memory owned by their members (strings, `std::function`s, user
+ * data) is not included; the figures are a lower bound of what the
+ * allocator sees.
+ */
+class MemoryUsage
+{
+public:
 
-                    if (i < n_g)
-                    {
-                        source.push_back(
-                            static_cast<int>(block_start[g] +
-                                static_cast<size_t>(i))
-                        );
-                        target.push_back(
-                            static_cast<int>(block_start[g] +
-                                static_cast<size_t>(j))
-                        );
-                    }
-                }
-            }
-            else
-            {
-                // Between-block: iterate (i, j) with i in [0, n_g),
-                // j in [0, n_h). Linearize as k = i * n_h + j.
-                long long n_g = static_cast<long long>(block_sizes[g]);
-                long long n_h = static_cast<long long>(block_sizes[h]);
-                long long total = n_g * n_h;
-                long long k = -1;
+    /**
+     * @name Agents
+     */
+    ///@{
+    size_t agents          = 0u; ///< `Agent` objects and their states.
+    size_t agents_entities = 0u; ///< Entity ids of each agent.
+    size_t agents_viruses  = 0u; ///< Viruses held by agents (one copy each).
+    size_t agents_tools    = 0u; ///< Tools held by agents (one copy each).
+    ///@}
 
-                while (true)
-                {
-                    double r = model.runif();
-                    if (r == 0.0)
-                        r = std::numeric_limits<double>::min();
+    size_t network         = 0u; ///< Neighbors (CSR arrays of `Network`).
+    size_t network_backup  = 0u; ///< Only when not shared with `network`.
+    size_t entities        = 0u; ///< `Entity` objects and their agent ids.
+    size_t queue           = 0u; ///< `Queue::active` and the active list.
+    size_t contact_tracing = 0u;
+    size_t events          = 0u; ///< Event buffers (including per thread).
+    size_t sampling        = 0u; ///< Scratch space of `AgentsSample`.
 
-                    k += 1 + static_cast<long long>(
-                        std::floor(std::log(r) / lp)
-                    );
+    /**
+     * @name Database
+     */
+    ///@{
+    size_t db_registry         = 0u; ///< Virus/tool ids, names, sequences.
+    size_t db_today            = 0u; ///< Today's counts.
+    size_t db_hist_virus       = 0u; ///< `hist_virus_*`.
+    size_t db_hist_tool        = 0u; ///< `hist_tool_*`.
+    size_t db_hist_total       = 0u; ///< `hist_total_*`.
+    size_t db_hist_transition  = 0u; ///< `hist_transition_matrix`.
+    size_t db_transition       = 0u; ///< Today's transition matrix.
+    size_t db_transmission     = 0u; ///< `transmission_*`.
+    size_t db_user_data        = 0u;
+    size_t db_hospitalizations = 0u;
+    ///@}
 
-                    if (k >= total)
-                        break;
+    /**
+     * @brief Additional memory of the thread clones of `run_multiple()`
+     * @details Each clone copies the model except for the network, which
+     * is shared until modified.
+     */
+    size_t thread_clones = 0u;
 
-                    long long row = k / n_h;
-                    long long col = k % n_h;
+    size_t database() const; ///< Sum of the `db_*` components.
+    size_t total() const;    ///< Sum of all the components.
 
-                    source.push_back(
-                        static_cast<int>(block_start[g] +
-                            static_cast<size_t>(row))
-                    );
-                    target.push_back(
-                        static_cast<int>(block_start[h] +
-                            static_cast<size_t>(col))
-                    );
-                }
-            }
+    void print() const;
 
-        }
-    }
+    /**
+     * @name Bytes used by a container
+     */
+    ///@{
+    template<typename T>
+    static size_t bytes(const std::vector< T > & x);
+    static size_t bytes(const std::vector< bool > & x);
+    template<typename Tk, typename Tv, typename Th>
+    static size_t bytes(const std::unordered_map< Tk, Tv, Th > & x);
+    ///@}
 
-    return AdjList(source, target, static_cast<int>(n), false);
+};
 
+template<typename T>
+inline size_t MemoryUsage::bytes(const std::vector< T > & x)
+{
+    return x.capacity() * sizeof(T);
 }
 
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-
- End of -./include/epiworld/randgraph.hpp-
-
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
-
+inline size_t MemoryUsage::bytes(const std::vector< bool > & x)
+{
+    return (x.capacity() + 7u) / 8u;
+}
 
+template<typename Tk, typename Tv, typename Th>
+inline size_t MemoryUsage::bytes(const std::unordered_map< Tk, Tv, Th > & x)
+{
 
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+    // Each entry is a node (value and pointer to the next one)
+    size_t res = x.bucket_count() * sizeof(void *) +
+        x.size() * (sizeof(std::pair< const Tk, Tv >) + sizeof(void *));
 
- Start of -./include/epiworld/queue-bones.hpp-
+    if constexpr (std::is_same_v< Tk, std::vector< int > >)
+        for (const auto & p : x)
+            res += bytes(p.first);
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    return res;
 
+}
 
-#ifndef EPIWORLD_QUEUE_BONES_HPP
-#define EPIWORLD_QUEUE_BONES_HPP
+inline size_t MemoryUsage::database() const
+{
+    return db_registry + db_today + db_hist_virus + db_hist_tool +
+        db_hist_total + db_hist_transition + db_transition +
+        db_transmission + db_user_data + db_hospitalizations;
+}
 
-/**
- * @brief Controls which agents are verified at each step
- * 
- * @details The idea is that only agents who are either in
- * an infected state or have an infected neighbor should be
- * checked. Otherwise it makes no sense (no chance to recover
- * or capture the disease).
- * 
- * **Implementation details:**
- * <a href="../impl/queueing-system.md">Queueing System</a>
- * 
- * @tparam TSeq 
- */
-template<typename TSeq>
-class Queue
+inline size_t MemoryUsage::total() const
 {
-    friend class Model<TSeq>;
+    return agents + agents_entities + agents_viruses + agents_tools +
+        network + network_backup + entities + queue + contact_tracing +
+        events + sampling + database() + thread_clones;
+}
 
-private:
+inline void MemoryUsage::print() const
+{
 
-    /**
-     * @brief Count of ego's neighbors in queue (including ego)
-     */
-    std::vector< epiworld_fast_int > active;
-    Model<TSeq> * model = nullptr;
-    int n_in_queue = 0;
+    auto print_line = [](const char * name, size_t x) -> void {
 
-    // Auxiliary variable that checks how many steps
-    // left are there
-    // int n_steps_left;
-    // bool queuing_started   = false;
+        double value = static_cast< double >(x);
+        const char * unit = "B ";
+        if (value >= 1073741824.0)
+        {
+            value /= 1073741824.0;
+            unit = "GB";
+        }
+        else if (value >= 1048576.0)
+        {
+            value /= 1048576.0;
+            unit = "MB";
+        }
+        else if (value >= 1024.0)
+        {
+            value /= 1024.0;
+            unit = "KB";
+        }
 
-public:
+        printf_epiworld(" - %-24s: %10.2f %s\n", name, value, unit);
 
-    void operator+=(Agent<TSeq> * p);
-    void operator-=(Agent<TSeq> * p);
-    epiworld_fast_int & operator[](epiworld_fast_uint i);
+    };
 
-    // void initialize(Model<TSeq> * m, Agent<TSeq> * p);
-    void reset();
+    printf_epiworld("Memory usage\n");
+    print_line("Agents", agents);
+    print_line("Agents' entities", agents_entities);
+    print_line("Agents' viruses", agents_viruses);
+    print_line("Agents' tools", agents_tools);
+    print_line("Network", network);
+    print_line("Network (backup)", network_backup);
+    print_line("Entities", entities);
+    print_line("Queue", queue);
+    print_line("Contact tracing", contact_tracing);
+    print_line("Events", events);
+    print_line("Sampling", sampling);
+    print_line("Database", database());
+    print_line("  registry", db_registry);
+    print_line("  today", db_today);
+    print_line("  hist virus", db_hist_virus);
+    print_line("  hist tool", db_hist_tool);
+    print_line("  hist total", db_hist_total);
+    print_line("  hist transition", db_hist_transition);
+    print_line("  transition", db_transition);
+    print_line("  transmission", db_transmission);
+    print_line("  user data", db_user_data);
+    print_line("  hospitalizations", db_hospitalizations);
+    print_line("Thread clones", thread_clones);
+    print_line("Total", total());
 
-    bool operator==(const Queue<TSeq> & other) const;
-    bool operator!=(const Queue<TSeq> & other) const {return !operator==(other);};
+}
 
-    static const int NoOne    = 0;
-    static const int OnlySelf = 1;
-    static const int Everyone = 2;
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-};
+ End of -./include/epiworld/memoryusage-bones.hpp-
 
-template<typename TSeq>
-inline void Queue<TSeq>::operator+=(Agent<TSeq> * p)
-{
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    if (++active[p->id] == 1)
-        n_in_queue++;
 
-    if (p->get_n_neighbors() == 0u)
-        return; // No neighbors, no need to add them
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    for (auto n : (*p->neighbors))
-    {
+ Start of -./include/epiworld/agentneighbors-bones.hpp-
 
-        if (++active[n] == 1)
-            n_in_queue++;
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    }
 
-}
+#ifndef EPIWORLD_AGENTNEIGHBORS_BONES_HPP
+#define EPIWORLD_AGENTNEIGHBORS_BONES_HPP
 
 template<typename TSeq>
-inline void Queue<TSeq>::operator-=(Agent<TSeq> * p)
-{
-
-    if (--active[p->id] == 0)
-        n_in_queue--;
+class Agent;
 
-    if (p->get_n_neighbors() == 0u)
-        return; // No neighbors, no need to add them
+/**
+ * @brief Non-owning view over the neighbors of an agent
+ *
+ * @details Iterates over the agent's row of the `Network` and yields
+ * references to the agents in the model's population, without allocating.
+ * The view is invalidated by any change to the network (e.g., adding ties or
+ * rewiring) or to the population. Returned by `Agent::neighbors()`.
+ *
+ * @tparam TSeq
+ */
+template<typename TSeq>
+class AgentNeighbors {
+private:
+    Agent<TSeq> * population;
+    const epiworld_agent_index * ids;
+    size_t n;
 
-    for (auto n : (*p->neighbors))
-    {
-        if (--active[n] == 0)
-            n_in_queue--;
-    }
+public:
 
-}
+    class iterator {
+    private:
+        Agent<TSeq> * population;
+        const epiworld_agent_index * ptr;
 
-template<typename TSeq>
-inline epiworld_fast_int & Queue<TSeq>::operator[](epiworld_fast_uint i)
-{
-    return active[i];
-}
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Agent<TSeq>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = Agent<TSeq> *;
+        using reference         = Agent<TSeq> &;
 
-template<typename TSeq>
-inline void Queue<TSeq>::reset()
-{
+        iterator(Agent<TSeq> * population_, const epiworld_agent_index * ptr_) :
+            population(population_), ptr(ptr_) {};
 
-    if (n_in_queue)
-    {
+        reference operator*() const { return population[*ptr]; };
+        pointer operator->() const { return &population[*ptr]; };
 
-        for (auto & q : this->active)
-            q = 0;
+        iterator & operator++() { ++ptr; return *this; };
+        iterator operator++(int) { iterator tmp = *this; ++ptr; return tmp; };
 
-        n_in_queue = 0;
-        
-    }
+        bool operator==(const iterator & other) const { return ptr == other.ptr; };
+        bool operator!=(const iterator & other) const { return ptr != other.ptr; };
+    };
 
-    active.resize(model->size(), 0);
+    AgentNeighbors(
+        Agent<TSeq> * population_,
+        const epiworld_agent_index * ids_,
+        size_t n_
+    ) : population(population_), ids(ids_), n(n_) {};
 
-}
+    iterator begin() const { return iterator(population, ids); };
+    iterator end() const { return iterator(population, ids + n); };
 
-template<typename TSeq>
-inline bool Queue<TSeq>::operator==(const Queue<TSeq> & other) const 
-{
-    if (active.size() != other.active.size())
-        return false;
+    size_t size() const noexcept { return n; };
+    bool empty() const noexcept { return n == 0u; };
 
-    for (size_t i = 0u; i < active.size(); ++i)
-    {
-        if (active[i] != other.active[i])
-            return false;
-    }
+    Agent<TSeq> & operator[](size_t i) const { return population[ids[i]]; };
+    size_t id(size_t i) const { return ids[i]; }; ///< Id of the i-th neighbor.
 
-    return true;
-}
+};
 
 #endif
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- End of -./include/epiworld/queue-bones.hpp-
+ End of -./include/epiworld/agentneighbors-bones.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
@@ -8324,877 +8635,1350 @@ inline bool Queue<TSeq>::operator==(const Queue<TSeq> & other) const
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- Start of -./include/epiworld/contacttracing-bones.hpp-
+ Start of -./include/epiworld/randgraph.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
-#ifndef EPIWORLD_CONTACTTRACING_BONES_H
-#define EPIWORLD_CONTACTTRACING_BONES_H
+#ifndef EPIWORLD_RANDGRA
+#define EPIWORLD_RANDGRA
 
-#include <vector>
-#include <stdexcept>
-// (already included include/epiworld/config.hpp)
+template<typename TSeq>
+class Model;
 
-/** 
- * @brief Class for tracing contacts between agents
- * @details
- * The class assumes that contacts are stored in a matrix-like
- * structure, where rows are agents and columns are contacts in a 
- * column-major format. Each entry stores the id of the contact
- * and the day of the contact is stored in a parallel array.
- * 
- * The maximum number of contacts per agent is fixed at initialization
- * time. If more contacts are added, they will overwrite previous
- * contacts in a circular buffer fashion.
- * */
-class ContactTracing
-{
-private:
+template<typename TSeq>
+class Agent;
 
-    std::vector< size_t > contact_matrix;
-    std::vector< size_t > contacts_per_agent;
-    std::vector< size_t > contact_date;
+class AdjList;
 
-    size_t n_agents;
-    size_t max_contacts;
 
-    size_t get_location(size_t row, size_t col) const;
+template<typename TSeq, typename TDat>
+inline void rewire_degseq(
+    TDat * agents,
+    Model<TSeq> * model,
+    epiworld_double proportion
+    );
 
-public:
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline void rewire_degseq(
+    std::vector< Agent<TSeq> > * agents,
+    Model<TSeq> * model,
+    epiworld_double proportion
+    )
+{
 
-    ContactTracing();
+    #ifdef EPI_DEBUG
+    std::vector< int > _degree0(agents->size(), 0);
+    for (size_t i = 0u; i < _degree0.size(); ++i)
+        _degree0[i] = model->get_agents()[i].get_n_neighbors();
+    #endif
 
-    /**
-     * @brief Construct a new Contact Tracing object
-     * 
-     * @param n_agents Agents in the system, usually `Model<TSeq>::size()`.
-     * @param max_contacts Maximum number of contacts to track per agent.
-     */
-    ContactTracing(size_t n_agents, size_t max_contacts);
+    // Identifying individuals with degree > 0
+    std::vector< epiworld_fast_uint > non_isolates;
+    std::vector< epiworld_double > weights;
+    epiworld_double nedges = 0.0;
 
-    /**
-     * @brief Add a contact between two agents at a given day.
-     * 
-     * @param agent_a Agent id (usually infectious agent)
-     * @param agent_b Agent id (usually susceptible agent)
-     * @param day Day of the contact (usually Model<TSeq>::today()).
-     */
-    void add_contact(size_t agent_a, size_t agent_b, size_t day);
+    for (epiworld_fast_uint i = 0u; i < agents->size(); ++i)
+    {
+        if (agents->operator[](i).get_n_neighbors() > 0u)
+        {
+            non_isolates.push_back(i);
+            epiworld_double wtemp = static_cast<epiworld_double>(
+                agents->operator[](i).get_n_neighbors()
+                );
+            weights.push_back(wtemp);
+            nedges += wtemp;
+        }
+    }
 
-    /**
-     * @brief Get the number of contacts for an agent
-     * 
-     * @param agent Agent id
-     * @return size_t Number of contacts recorded for that agent (can be more than max_contacts)
-     */
-    size_t get_n_contacts(size_t agent); 
+    if (non_isolates.size() == 0u)
+        throw std::logic_error("The graph is completely disconnected.");
 
-    size_t get_max_contacts() const;
-    
-    /**
-     * @brief Get the contact object
-     * 
-     * @param agent Source agent (id)
-     * @param idx Index of the contact (0 to get_n_contacts(agent)-1)
-     * @return std::pair<size_t, int> with (contact_id, contact_day)
-     * @throws std::out_of_range if idx is out of range.
-     */
-    std::pair<size_t, int> get_contact(size_t agent, size_t idx);
+    // Cumulative probs
+    weights[0u] /= nedges;
+    for (epiworld_fast_uint i = 1u; i < non_isolates.size(); ++i)
+    {
+         weights[i] /= nedges;
+         weights[i] += weights[i - 1u];
+    }
 
-    /**
-     * @brief Reset the contact tracing data
-     * 
-     * Usually called by `Model<TSeq>::reset()`.
-     * 
-     * @param n_agents Number of agents
-     * @param max_contacts Maximum number of contacts to track per agent
-     */
-    void reset(
-        size_t n_agents,
-        size_t max_contacts
-    );
+    // Only swap if needed
+    epiworld_fast_uint N = non_isolates.size();
+    epiworld_double prob;
+    int nrewires = floor(proportion * nedges);
+    while (nrewires-- > 0)
+    {
 
-    /**
-     * @brief Print the contacts of an agent 
-     * 
-     * @param agent Agent id
-     */
-    void print(size_t agent);
-};
+        // Picking egos
+        prob = model->runif();
+        int id0 = N - 1;
+        for (epiworld_fast_uint i = 0u; i < N; ++i)
+            if (prob <= weights[i])
+            {
+                id0 = i;
+                break;
+            }
 
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+        prob = model->runif();
+        int id1 = N - 1;
+        for (epiworld_fast_uint i = 0u; i < N; ++i)
+            if (prob <= weights[i])
+            {
+                id1 = i;
+                break;
+            }
 
- End of -./include/epiworld/contacttracing-bones.hpp-
+        // Correcting for under or overflow.
+        if (id1 == id0)
+            id1++;
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+        if (id1 >= static_cast<int>(N))
+            id1 = 0;
 
+        Agent<TSeq> & p0 = agents->operator[](non_isolates[id0]);
+        Agent<TSeq> & p1 = agents->operator[](non_isolates[id1]);
 
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+        // Picking alters (relative location in their lists)
+        // In this case, these are uniformly distributed within the list
+        int id01 = model->runif_index(p0.get_n_neighbors());
+        int id11 = model->runif_index(p1.get_n_neighbors());
 
- Start of -./include/epiworld/contacttracing-meat.hpp-
+        // Get the actual neighbor IDs that will be swapped
+        auto neighbors_p0 = p0.neighbors(*model);
+        auto neighbors_p1 = p1.neighbors(*model);
+        size_t neighbor_id_01 = neighbors_p0.id(id01);
+        size_t neighbor_id_11 = neighbors_p1.id(id11);
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+        // Check if the swap would create self-loops or invalid configurations
+        // After swap: p0 will be connected to neighbor_id_11, p1 to neighbor_id_01
+        // Skip if:
+        // 1. neighbor_id_01 == neighbor_id_11 (swapping the same neighbor)
+        // 2. neighbor_id_01 == non_isolates[id1] (p1's new neighbor would be p1 itself)
+        // 3. neighbor_id_11 == non_isolates[id0] (p0's new neighbor would be p0 itself)
+        if (neighbor_id_01 == neighbor_id_11 ||
+            neighbor_id_01 == non_isolates[id1] ||
+            neighbor_id_11 == non_isolates[id0]) {
+            continue;
+        }
+
+        // Check if the swap would create duplicate edges
+        // After swap: p0 will be connected to neighbor_id_11, p1 to neighbor_id_01
+        bool would_create_duplicate = false;
+        for (size_t k = 0u; k < neighbors_p0.size(); ++k) {
+            if (neighbors_p0.id(k) == neighbor_id_11 && neighbors_p0.id(k) != neighbor_id_01) {
+                would_create_duplicate = true;
+                break;
+            }
+        }
+        if (!would_create_duplicate) {
+            for (size_t k = 0u; k < neighbors_p1.size(); ++k) {
+                if (neighbors_p1.id(k) == neighbor_id_01 && neighbors_p1.id(k) != neighbor_id_11) {
+                    would_create_duplicate = true;
+                    break;
+                }
+            }
+        }
 
+        if (would_create_duplicate) {
+            continue; // Skip this rewire attempt
+        }
 
-#ifndef EPIWORLD_CONTACTTRACING_MEAT_H
-#define EPIWORLD_CONTACTTRACING_MEAT_H
+        // When rewiring, we need to flip the individuals from the other
+        // end as well, since we are dealing withi an undirected graph
+        
+        // Swap neighbors between the two agents
+        // Note: id0 and id1 are indices in non_isolates, not agent IDs
+        model->get_agents()[non_isolates[id0]].swap_neighbors(
+            model->get_agents()[non_isolates[id1]],
+            id01,
+            id11,
+            *model
+            );
 
-// (already included include/epiworld/contacttracing-bones.hpp)
 
-inline size_t ContactTracing::get_location(size_t row, size_t col) const
-{
-    return col * n_agents + row;
-}
+    }
 
-inline ContactTracing::ContactTracing()
-{
-    n_agents = 0u;
-    max_contacts = 0u;
-}
+    #ifdef EPI_DEBUG
+    for (size_t _i = 0u; _i < _degree0.size(); ++_i)
+    {
+        if (_degree0[_i] != static_cast<int>(model->get_agents()[_i].get_n_neighbors()))
+            throw std::logic_error("[epi-debug] Degree does not match afted rewire_degseq.");
+    }
+    #endif
 
-inline ContactTracing::ContactTracing(size_t n_agents, size_t max_contacts)
-{
-    this->n_agents = n_agents;
-    this->max_contacts = max_contacts;
+    return;
 
-    contact_matrix.resize(n_agents * max_contacts, 0u);
-    contacts_per_agent.resize(n_agents, 0);
-    contact_date.resize(n_agents * max_contacts, 0);
 }
 
-inline void ContactTracing::add_contact(size_t agent_a, size_t agent_b, size_t day)
+template<typename TSeq>
+inline void rewire_degseq(
+    AdjList * agents,
+    Model<TSeq> * model,
+    epiworld_double proportion
+    )
 {
-    
-    // Checking overflow
-    size_t col_location = contacts_per_agent[agent_a] % max_contacts;
-    size_t array_location = get_location(agent_a, col_location);
-
-    contact_matrix[array_location] = agent_b;
-    contact_date[array_location] = day;
 
-    contacts_per_agent[agent_a] += 1;
+    // Identifying individuals with degree > 0
+    std::vector< epiworld_fast_int > nties(agents->vcount(), 0);
 
-}
-
-inline size_t ContactTracing::get_n_contacts(size_t agent)
-{
-    return contacts_per_agent[agent];
-}
-
-inline size_t ContactTracing::get_max_contacts() const
-{
-    return max_contacts;
-}
-
-inline std::pair< size_t, int> ContactTracing::get_contact(size_t agent, size_t idx)
-{
-    if (
-        (idx >= contacts_per_agent[agent]) ||
-        (idx >= max_contacts)
-    )
-        throw std::out_of_range("Index out of range in get_contact");
-
-    size_t col_location = idx % max_contacts;
-    size_t array_location = get_location(agent, col_location);
+    #ifdef EPI_DEBUG
+    std::vector< int > _degree0(agents->vcount(), 0);
+    for (size_t i = 0u; i < _degree0.size(); ++i)
+        _degree0[i] = agents->get_dat()[i].size();
+    #endif
+    
+    std::vector< int > non_isolates;
+    non_isolates.reserve(nties.size());
 
-    return { contact_matrix[array_location], contact_date[array_location] };
-}
+    std::vector< epiworld_double > weights;
+    weights.reserve(nties.size());
 
-inline void ContactTracing::reset(size_t n_agents, size_t max_contacts)
-{
+    epiworld_double nedges = 0.0;
+    auto & dat = agents->get_dat();
 
-    this->n_agents = n_agents;
-    this->max_contacts = max_contacts;
+    if (dat.size() > nties.size())
+        throw std::logic_error("Inconsistent adjacency list data.");
 
-    contact_matrix.assign(n_agents * max_contacts, 0u);
-    contacts_per_agent.assign(n_agents, 0u);
-    contact_date.assign(n_agents * max_contacts, 0u);
-}
+    for (size_t i = 0u; i < dat.size(); ++i)
+        nties[i] += dat[i].size();
 
-inline void ContactTracing::print(size_t agent)
-{
+    bool directed = agents->is_directed();
+    for (size_t i = 0u; i < dat.size(); ++i)
+    {
+        if (nties[i] > 0)
+        {
+            non_isolates.push_back(i);
+            if (directed)
+            {
+                weights.push_back(
+                    static_cast<epiworld_double>(nties[i])
+                );
+                nedges += static_cast<epiworld_double>(nties[i]);
+            }
+            else {
+                weights.push_back(
+                    static_cast<epiworld_double>(nties[i])/2.0
+                );
+                nedges += static_cast<epiworld_double>(nties[i]) / 2.0;
+            }
+        }
+    }
 
-    size_t n_contacts = contacts_per_agent[agent];
-    if (n_contacts > max_contacts)
-        n_contacts = max_contacts;
+    if (non_isolates.size() == 0u)
+        throw std::logic_error("The graph is completely disconnected.");
 
-    printf_epiworld("Agent %zu has %zu contacts: ", agent, n_contacts);
-    for (size_t i = 0u; i < n_contacts; ++i)
+    // Cumulative probs
+    weights[0u] /= nedges;
+    for (epiworld_fast_uint i = 1u; i < non_isolates.size(); ++i)
     {
-        auto [contact_id, contact_day] = get_contact(agent, i);
-        printf_epiworld("(%zu, day %i) ", contact_id, contact_day);
+         weights[i] /= nedges;
+         weights[i] += weights[i - 1u];
     }
-    printf_epiworld("\n");
 
-    return;
+    // Only swap if needed
+    epiworld_fast_uint N = non_isolates.size();
+    epiworld_double prob;
+    int nrewires = floor(proportion * nedges / (
+        agents->is_directed() ? 1.0 : 2.0
+    ));
 
-}
+    while (nrewires-- > 0)
+    {
 
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+        // Picking egos
+        prob = model->runif();
+        int id0 = N - 1;
+        for (epiworld_fast_uint i = 0u; i < N; ++i)
+            if (prob <= weights[i])
+            {
+                id0 = i;
+                break;
+            }
 
- End of -./include/epiworld/contacttracing-meat.hpp-
+        prob = model->runif();
+        int id1 = N - 1;
+        for (epiworld_fast_uint i = 0u; i < N; ++i)
+            if (prob <= weights[i])
+            {
+                id1 = i;
+                break;
+            }
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+        // Correcting for under or overflow.
+        if (id1 == id0)
+            id1++;
 
+        if (id1 >= static_cast<int>(N))
+            id1 = 0;
 
+        std::map<int,int> & p0 = agents->get_dat()[non_isolates[id0]];
+        std::map<int,int> & p1 = agents->get_dat()[non_isolates[id1]];
 
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+        // Picking alters (relative location in their lists)
+        // In this case, these are uniformly distributed within the list
+        int id01 = model->runif_index(p0.size());
+        int id11 = model->runif_index(p1.size());
 
- Start of -./include/epiworld/contactmatrix-bones.hpp-
+        // Since it is a map, we need to find the actual ids (positions)
+        // are not good enough.
+        int count = 0;
+        for (auto & n : p0)
+            if (count++ == id01)
+                id01 = n.first;
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+        count = 0;
+        for (auto & n : p1)
+            if (count++ == id11)
+                id11 = n.first;
 
+        // When rewiring, we need to actually swap the edges, not just the weights
+        // We'll swap edges: (id0, id01) <-> (id1, id11)
+        // After swap: (id0, id11) and (id1, id01)
+        // But first, check if the swap would create duplicate or self-loop edges
+        
+        // Check for self-loops (new edge would connect node to itself)
+        if (id01 == non_isolates[id1] || id11 == non_isolates[id0]) {
+            continue;
+        }
+        
+        // Check for duplicate edges (new edge already exists)
+        if (p0.find(id11) != p0.end() || p1.find(id01) != p1.end()) {
+            continue; // Skip this rewire attempt to avoid duplicate edges
+        }
+        
+        // Check if we're trying to swap the same neighbor
+        if (id01 == id11) {
+            continue;
+        }
+        
+        // Save the weights before removing edges
+        int weight_0_01 = p0[id01];
+        int weight_1_11 = p1[id11];
+        
+        // Remove old edges from ego perspectives
+        p0.erase(id01);
+        p1.erase(id11);
+        
+        // Add new edges from ego perspectives with swapped alters
+        p0[id11] = weight_0_01;
+        p1[id01] = weight_1_11;
+        
+        // For undirected graphs, also update from alter perspectives
+        if (!agents->is_directed())
+        {
+            std::map<int,int> & p01 = agents->get_dat()[id01];
+            std::map<int,int> & p11 = agents->get_dat()[id11];
+            
+            // Save weights from alter perspectives
+            int weight_01_0 = p01[non_isolates[id0]];
+            int weight_11_1 = p11[non_isolates[id1]];
+            
+            // Remove old edges from alter perspectives
+            p01.erase(non_isolates[id0]);
+            p11.erase(non_isolates[id1]);
+            
+            // Add new edges from alter perspectives
+            p01[non_isolates[id1]] = weight_11_1;
+            p11[non_isolates[id0]] = weight_01_0;
+        }
 
-#ifndef EPIWORLD_CONTACTMATRIX_BONES_HPP
-#define EPIWORLD_CONTACTMATRIX_BONES_HPP
+    }
 
-#include <vector>
+    #ifdef EPI_DEBUG
+    for (size_t _i = 0u; _i < _degree0.size(); ++_i)
+    {
+        if (_degree0[_i] != static_cast<int>(agents->get_dat()[_i].size()))
+            throw std::logic_error(
+                "[epi-debug] Degree does not match afted rewire_degseq. " +
+                std::string("Expected: ") +
+                std::to_string(_degree0[_i]) +
+                std::string(", observed: ") +
+                std::to_string(agents->get_dat()[_i].size())
+                );
+    }
+    #endif
 
-/**
- * @file contactmatrix-bones.hpp
- * @brief Base class for handling contact matrices in epidemiological
- * models
- * 
- * This class provides functionality for setting and validating contact
- * matrices, which are essential for modeling population mixing in
- * epidemiological simulations. Models that require contact matrices can
- * inherit from this class.
- */
-class ContactMatrix 
-{
-private: 
 
-    std::vector< double > contact_matrix;
-    std::vector< double > contact_matrix_backup; ///< Used for resetting the model
-    int n_groups = -1;
+    return;
 
-public:
+}
 
-    ContactMatrix() = default;
+/**
+ * Threshold for the hybrid row-advance in Batagelj-Brandes.
+ *
+ * When a geometric skip lands past the current row of the lower-triangle
+ * enumeration, the flat index must be mapped back to (i, j). For small
+ * excess (j - i <= threshold) the integer while-loop is fastest; for
+ * large excess the O(1) inverse-triangular-number formula avoids
+ * O(sqrt(excess)) iterations. 200 keeps the loop body to at most ~20
+ * iterations (sqrt(2 * 200) ~ 20) before switching to FPU math.
+ */
+static constexpr long long BB_FPU_THRESHOLD = 200;
 
-    /**
-     * @brief Validates the contact matrix size and values
-     * @param expected_size The expected size of the contact matrix
-     */
-    void validate_contact_matrix(size_t expected_size);
-    /**
-     * @brief Set the contact matrix for population mixing
-     * @param cmat Contact matrix specifying interaction rates between groups
-     * @param as_backup Whether to use the matrix as a backup (default: true)
-     * If set to true, the new contact matrix will be saved as a backup for
-     * resetting the model.
-     */
-    void set_contact_matrix(std::vector< double > cmat, bool as_backup = true);
-
-    /**
-     * @brief Get the current contact matrix
-     * @return Vector representing the contact matrix
-     */
-    const std::vector< double > & get_contact_matrix() const;
-
-    /**
-     * @brief Get the current contact matrix
-     * @return Vector representing the contact matrix
-     */
-    std::vector< double > & get_contact_matrix_ref();
-
-    /**
-     * @brief Get the contact rate between two groups
-     * @param i Index of the first group
-     * @param j Index of the second group
-     * @return Contact rate between group i and group j
-     */
-    double get_contact_rate(size_t i, size_t j, bool check = true) const;
-
-    /**
-     * @brief Get the size of the contact matrix
-     * @return Size of the contact matrix
-     */
-    size_t get_contact_matrix_size() const;
-};
+/**
+ * @brief Generates an Erdős–Rényi random graph G(n, p) using the
+ * Batagelj-Brandes algorithm.
+ *
+ * Uses geometric skipping to advance through the space of possible edges,
+ * generating each edge independently with probability p. This produces
+ * **unbiased** edge counts in O(n + m) expected time, where m is the
+ * number of edges generated.
+ *
+ * Reference: V. Batagelj and U. Brandes, "Efficient generation of large
+ * random networks," Physical Review E, vol. 71, no. 3, 2005.
+ *
+ * @tparam TSeq Type of the sequence (template parameter of the model).
+ * @param n Number of nodes.
+ * @param p Edge probability.
+ * @param directed Whether the graph is directed.
+ * @param model A reference to the Model, used for random number generation.
+ * @return An AdjList representing the generated network.
+ */
+template<typename TSeq>
+inline AdjList rgraph_bernoulli(
+    epiworld_fast_uint n,
+    epiworld_double p,
+    bool directed,
+    Model<TSeq> & model
+) {
 
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+    std::vector< int > source;
+    std::vector< int > target;
 
- End of -./include/epiworld/contactmatrix-bones.hpp-
+    // Pre-allocate based on expected edge count
+    double n_possible = directed
+        ? static_cast<double>(n) * (n - 1.0)
+        : static_cast<double>(n) * (n - 1.0) / 2.0;
+    source.reserve(static_cast<size_t>(n_possible * p * 1.1));
+    target.reserve(static_cast<size_t>(n_possible * p * 1.1));
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    // Batagelj-Brandes: use geometric skipping to enumerate edges.
+    // log(1 - p) is precomputed; each skip is 1 + floor(log(U) / lp).
+    double lp = std::log(1.0 - p);
 
+    if (!directed)
+    {
+        // Undirected: iterate over (i, j) with i > j
+        long long i = 1;
+        long long j = -1;
 
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+        while (i < static_cast<long long>(n))
+        {
+            // Geometric skip
+            double r = model.runif();
 
- Start of -./include/epiworld/contactmatrix-meat.hpp-
+            // Avoid log(0)
+            if (r == 0.0)
+                r = std::numeric_limits<double>::min();
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+            j += 1 + static_cast<long long>(
+                std::floor(std::log(r) / lp)
+            );
 
+            // Advance to the next row if j >= i.
+            // Hybrid approach: for large skips, use O(1) FPU
+            // inverse-triangular-number formula instead of the
+            // integer loop, avoiding O(sqrt(skip)) iterations.
+            if (j >= i && i < static_cast<long long>(n))
+            {
+                if (j - i > BB_FPU_THRESHOLD)
+                {
+                    // O(1) FPU mapping: flat index → (i, j) via
+                    // inverse triangular number. `flat` fits in
+                    // long long since n ≤ INT_MAX (AdjList limit),
+                    // so i*(i-1)/2 + j < n*(n-1)/2 ≪ 2^62.
+                    long long flat = i * (i - 1) / 2 + j;
+                    double df = static_cast<double>(flat);
+                    i = static_cast<long long>(std::floor(
+                        (1.0 + std::sqrt(1.0 + 8.0 * df)) / 2.0
+                    ));
+                    j = flat - i * (i - 1) / 2;
+                    // Floating-point correction: sqrt may round i
+                    // up or down by 1 for large flat values, so j
+                    // may land outside [0, i). Each correction loop
+                    // runs at most 1–2 iterations; only one of the
+                    // two can execute for a given (i, j).
+                    while (j >= i) { j -= i; i++; }
+                    while (j < 0)  { i--; j += i; }
+                }
+                else
+                {
+                    while (j >= i && i < static_cast<long long>(n))
+                    {
+                        j -= i;
+                        i++;
+                    }
+                }
+            }
 
-#ifndef EPIWORLD_CONTACTMATRIX_MEAT_HPP
-#define EPIWORLD_CONTACTMATRIX_MEAT_HPP
+            if (i < static_cast<long long>(n))
+            {
+                source.push_back(static_cast<int>(i));
+                target.push_back(static_cast<int>(j));
+            }
+        }
+    }
+    else
+    {
+        // Directed: iterate over (i, j) with i != j
+        // We linearize pairs: for row i, columns [0..n-1] excluding i.
+        // Position k in [0, n*(n-1)) maps to row = k/(n-1),
+        // col = k%(n-1), if col >= row then col++.
+        long long total = static_cast<long long>(n) * (n - 1);
+        long long k = -1;
 
-// (already included include/epiworld/contactmatrix-bones.hpp)
-#include <stdexcept>
+        while (true)
+        {
+            double r = model.runif();
+            if (r == 0.0)
+                r = std::numeric_limits<double>::min();
 
-inline void ContactMatrix::validate_contact_matrix(size_t expected_size)
-{
+            k += 1 + static_cast<long long>(
+                std::floor(std::log(r) / lp)
+            );
 
-    if (!contact_matrix_backup.empty())
-        contact_matrix = contact_matrix_backup;
+            if (k >= total)
+                break;
 
-    if (contact_matrix.size() != expected_size * expected_size)
-        throw std::length_error(
-            std::string("Contact matrix size is ") +
-            std::to_string(contact_matrix.size()) +
-            std::string(", but expected size is ") +
-            std::to_string(expected_size * expected_size) + "."
-        );
+            long long row = k / static_cast<long long>(n - 1);
+            long long col = k % static_cast<long long>(n - 1);
+            if (col >= row)
+                col++;
 
-    for (int i = 0; i < n_groups; ++i)
-    {
-        for (int j = 0; j < n_groups; ++j)
-        {
-            if (get_contact_rate(i, j, false) < 0.0)
-                throw std::range_error(
-                    std::string("The contact matrix must be non-negative. ") +
-                    std::to_string(this->get_contact_rate(i, j, false)) +
-                    std::string(" < 0.")
-                    );
+            source.push_back(static_cast<int>(row));
+            target.push_back(static_cast<int>(col));
         }
     }
 
-}
-
-inline void ContactMatrix::set_contact_matrix(
-    std::vector< double > cmat,
-    bool as_backup
-)
-{
-    n_groups = static_cast<int>(std::sqrt(cmat.size()));
-    if (n_groups * n_groups != static_cast<int>(cmat.size()))
-        throw std::invalid_argument(
-            "Contact matrix size is not a perfect square, cannot determine number of groups."
-        );
-
-    if (as_backup)
-        contact_matrix_backup = cmat;
-
-    contact_matrix = cmat;
-    return;
-};
+    AdjList al(source, target, static_cast<int>(n), directed);
 
-inline const std::vector< double > & ContactMatrix::get_contact_matrix() const
-{
-    return contact_matrix;
-}
+    return al;
 
-inline std::vector< double > & ContactMatrix::get_contact_matrix_ref()
-{
-    return contact_matrix;
 }
 
-inline double ContactMatrix::get_contact_rate(
-    size_t i, size_t j, bool check
-) const
-{
-    if (check && (
-        (static_cast<int>(i) >= n_groups) ||
-        (static_cast<int>(j) >= n_groups)
-    ))
-        throw std::out_of_range(
-            std::string("Group indices out of range. ") +
-            std::to_string(i) + ", " + std::to_string(j) +
-            std::string(" >= ") + std::to_string(n_groups)
-        );
-    return contact_matrix[j * n_groups + i];
-}
+template<typename TSeq>
+inline AdjList rgraph_bernoulli2(
+    epiworld_fast_uint n,
+    epiworld_double p,
+    bool directed,
+    Model<TSeq> & model
+) {
 
-inline size_t ContactMatrix::get_contact_matrix_size() const
-{
-    return contact_matrix.size();
-}
+    std::vector< int > source;
+    std::vector< int > target;
 
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+    // Checking the density (how many)
+    std::binomial_distribution<> d(
+        n * (n - 1.0) / (directed ? 1.0 : 2.0),
+        p
+    );
 
- End of -./include/epiworld/contactmatrix-meat.hpp-
+    // Need to compensate for the possible number of diagonal
+    // elements sampled. If n * n, then each diag element has
+    // 1/(n^2) chance of sampling
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    epiworld_fast_uint m = d(model.get_rand_endgine());
 
+    source.resize(m);
+    target.resize(m);
 
+    double n2 = static_cast<double>(n * n);
 
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-
- Start of -./include/epiworld/globalevent-bones.hpp-
-
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
-
-
-#ifndef EPIWORLD_GLOBALEVENT_BONES_HPP
-#define EPIWORLD_GLOBALEVENT_BONES_HPP
+    int loc,row,col;
+    for (epiworld_fast_uint i = 0u; i < m; ++i)
+    {
+        loc = floor(model.runif() * n2);
+        col = floor(static_cast<double>(loc)/static_cast<double>(n));
+        row = loc - row * n;
 
-#include <string>
-// (already included include/epiworld/config.hpp)
+        // Undirected needs to swap
+        if (!directed && (col > row))
+            std::swap(col, row);
 
-/**
- * @brief Template for a Global Event
- * @details Global events are functions that Model<TSeq> executes
- * at the end of a day.
- * 
- */
-template<typename TSeq>
-class GlobalEvent
-{
-private:
-    GlobalFun<TSeq> fun = nullptr;
-    std::string name = "A global action";
-    int day = -99;
-public:
+        source[i] = row;
+        target[i] = col;
 
-    GlobalEvent() {};
+    }
 
-    /**
-     * @brief Construct a new Global Event object
-     * 
-     * @param fun A function that takes a Model<TSeq> * as argument and returns void.
-     * @param name A descriptive name for the action.
-     * @param day The day when the action will be executed. If negative, it will be executed every day.
-     */
-    GlobalEvent(GlobalFun<TSeq> fun, std::string name, int day = -99);
-    
-    virtual ~GlobalEvent() = default;
+    AdjList al(source, target, static_cast<int>(n), directed);
 
-    virtual void operator()(Model<TSeq> * m, int day);
+    return al;
 
-    void set_name(std::string name);
-    std::string get_name() const;
+}
 
-    void set_day(int day);
-    int get_day() const;
-    
-    void print() const;
+inline AdjList rgraph_ring_lattice(
+    epiworld_fast_uint n,
+    epiworld_fast_uint k,
+    bool directed = false
+) {
 
-    // Comparison operators
-    bool operator==(const GlobalEvent<TSeq> & other) const;
-    bool operator!=(const GlobalEvent<TSeq> & other) const;
+    if ((n - 1u) < k)
+        throw std::logic_error("k can be at most n - 1.");
 
-    virtual std::unique_ptr<GlobalEvent<TSeq>> clone_ptr() const;
+    std::vector< int > source;
+    std::vector< int > target;
 
-};
+    if (!directed)
+        if (k > 1u) k = static_cast< size_t >(floor(k / 2.0));
 
+    for (size_t i = 0; i < n; ++i)
+    {
 
+        for (size_t j = 1u; j <= k; ++j)
+        {
 
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+            // Next neighbor
+            size_t l = i + j;
+            if (l >= n) l = l - n;
 
- End of -./include/epiworld/globalevent-bones.hpp-
+            source.push_back(i);
+            target.push_back(l);
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+        }
 
+    }
 
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+    return AdjList(source, target, n, directed);
 
- Start of -./include/epiworld/globalevent-meat.hpp-
+}
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+/**
+ * @brief Smallworld network (Watts-Strogatz)
+ *
+ * @tparam TSeq
+ * @param n
+ * @param k
+ * @param p
+ * @param directed
+ * @param model
+ * @return AdjList
+ */
+template<typename TSeq>
+inline AdjList rgraph_smallworld(
+    epiworld_fast_uint n,
+    epiworld_fast_uint k,
+    epiworld_double p,
+    bool directed,
+    Model<TSeq> & model
+) {
 
+    // Creating the ring lattice
+    AdjList ring = rgraph_ring_lattice(n,k,directed);
 
-#ifndef EPIWORLD_GLOBALEVENT_MEAT_HPP
-#define EPIWORLD_GLOBALEVENT_MEAT_HPP
+    // Rewiring and returning
+    if (k > 0u)
+        rewire_degseq(&ring, &model, p);
 
-#include <memory>
-// (already included include/epiworld/globalevent-bones.hpp)
+    return ring;
 
-template<typename TSeq>
-inline GlobalEvent<TSeq>::GlobalEvent(
-    GlobalFun<TSeq> fun,
-    std::string name,
-    int day
-    )
-{
-    this->fun = fun;
-    this->name = name;
-    this->day = day;
 }
 
+/**
+ * @brief Generates a blocked network
+ *
+ * Since block sizes and number of connections between blocks are fixed,
+ * this routine is fully deterministic.
+ *
+ * @tparam TSeq
+ * @param n Size of the network
+ * @param blocksize Size of the block.
+ * @param ncons Number of connections between blocks
+ * @param model A model
+ * @return AdjList
+ */
 template<typename TSeq>
-inline void GlobalEvent<TSeq>::operator()(Model<TSeq> * m, int day)
-{   
-    
-    if (this->fun == nullptr)
-        return;
+inline AdjList rgraph_blocked(
+    epiworld_fast_uint n,
+    epiworld_fast_uint blocksize,
+    epiworld_fast_uint ncons,
+    Model<TSeq>&
+) {
 
-    // events apply if day is negative or if day is equal to the day of the action
-    if (this->day < 0 || this->day == day)
-        this->fun(m);
-    
-    return;
+    std::vector< int > source_;
+    std::vector< int > target_;
 
-}
+    size_t i = 0u;
+    size_t cum_node_count = 0u;
+    while (i < n)
+    {
 
-template<typename TSeq>
-inline void GlobalEvent<TSeq>::set_name(std::string name)
-{
-    this->name = name;
-}
+        for (size_t j = 0; j < blocksize; ++j)
+        {
 
-template<typename TSeq>
-inline std::string GlobalEvent<TSeq>::get_name() const
-{
-    return this->name;
-}
+            for (size_t k = 0; k < j; ++k)
+            {
+                // No loops
+                if (k == j)
+                    continue;
 
-template<typename TSeq>
-inline void GlobalEvent<TSeq>::set_day(int day)
-{
-    this->day = day;
-}
+                // Exists the loop in case there are no more
+                // nodes available
+                if ((i + k) >= n)
+                    break;
 
-template<typename TSeq>
-inline int GlobalEvent<TSeq>::get_day() const
-{
-    return this->day;
-}
+                source_.push_back(static_cast<int>(j + i));
+                target_.push_back(static_cast<int>(k + i));
+            }
 
-template<typename TSeq>
-inline void GlobalEvent<TSeq>::print() const
-{
-    printf_epiworld(
-        "Global action: %s\n"
-        "  - Day: %i\n",
-        this->name.c_str(),
-        this->day
-        );
-}
+            // No more nodes left to build connections
+            if (++cum_node_count >= n)
+                break;
 
-template<typename TSeq>
-inline bool GlobalEvent<TSeq>::operator==(const GlobalEvent<TSeq> & other) const
-{
-    return (this->name == other.name) && (this->day == other.day);
-}
+        }
 
-template<typename TSeq>
-inline bool GlobalEvent<TSeq>::operator!=(const GlobalEvent<TSeq> & other) const
-{
-    return !(*this == other);
-}
+        // Connections between this and the previou sone
+        if (i != 0)
+        {
 
-template<typename TSeq>
-inline std::unique_ptr<GlobalEvent<TSeq>> GlobalEvent<TSeq>::clone_ptr() const
-{
-    return std::make_unique<GlobalEvent<TSeq>>(*this);
-}
+            size_t max_cons = std::min(ncons, n - cum_node_count);
 
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+            // Generating the connections
+            for (size_t j = 0u; j < max_cons; ++j)
+            {
 
- End of -./include/epiworld/globalevent-meat.hpp-
+                source_.push_back(static_cast<int>(i + j - blocksize));
+                target_.push_back(static_cast<int>(i + j));
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+            }
+        }
 
+        i += blocksize;
 
+    }
 
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+    return AdjList(source_, target_, n, false);
 
- Start of -./include/epiworld/model-bones.hpp-
+}
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+/**
+ * @brief Generates a network using a Stochastic Block Model (SBM).
+ *
+ * This function creates a random undirected network where connections between
+ * agents are determined by a mixing matrix and block (group) membership.
+ * Each potential edge between agents in blocks \f$g\f$ and \f$h\f$ is included
+ * independently with probability \f$M(g, h) / n_h\f$, where \f$M(g, h)\f$ is
+ * the entry of the mixing matrix and \f$n_h\f$ is the number of agents in
+ * block \f$h\f$.
+ *
+ * The mixing matrix is **not** row-stochastic. For undirected networks, its
+ * row sums should be interpreted as the average expected degree for agents in
+ * that group only when the balance condition
+ * \f$M(g, h) \times n_g = M(h, g) \times n_h\f$ holds for all pairs
+ * \f$(g, h)\f$. In that balanced case,
+ * \f[
+ *   \mathbb{E}[\text{degree of agent in group } g] = \sum_{h} M(g, h)
+ * \f]
+ *
+ * For undirected networks, the implementation samples between-block edges only
+ * once for each unordered pair of blocks (with \f$g \le h\f$) using
+ * \f$M(g, h) / n_h\f$. Therefore, if the balance condition is violated, the
+ * row sums generally do not match the expected degree from every group's
+ * perspective.
+ *
+ * **Unbiased generation.** Edge generation uses the Batagelj-Brandes
+ * algorithm (geometric skipping) independently for each block pair.
+ * Each possible edge is included with exactly the correct probability,
+ * with no duplicate edge collisions. The expected number of edges for a
+ * block pair is exactly:
+ * - Within-block: \f$\binom{n_g}{2} \times p_{gg}\f$
+ * - Between-block: \f$n_g \times n_h \times p_{gh}\f$
+ *
+ * **Balance condition warning.** If the balance condition is violated for
+ * any pair of blocks and the model's verbose mode is on, a warning is
+ * printed indicating which entries are being silently ignored.
+ *
+ * Reference: V. Batagelj and U. Brandes, "Efficient generation of large
+ * random networks," Physical Review E, vol. 71, no. 3, 2005.
+ *
+ * @tparam TSeq Type of the sequence (template parameter of the model).
+ * @param block_sizes A vector of size \f$K\f$ indicating the number of agents
+ *   per block. The total number of agents is \f$\sum_k \text{block\_sizes}[k]\f$.
+ * @param mixing_matrix A vector of size \f$K \times K\f$ representing the
+ *   mixing matrix. The entry \f$M(g, h)\f$ controls the expected number of
+ *   connections agents in group \f$g\f$ make with agents in group \f$h\f$.
+ * @param row_major If `true`, the mixing matrix is stored in row-major order
+ *   (C-style), i.e., \f$M(g, h) = \text{mixing\_matrix}[g \times K + h]\f$.
+ *   If `false`, column-major order (Fortran-style) is assumed, i.e.,
+ *   \f$M(g, h) = \text{mixing\_matrix}[h \times K + g]\f$.
+ * @param model A reference to the Model, used for random number generation.
+ * @return An AdjList representing the generated undirected network.
+ *
+ * @throws std::length_error If `block_sizes` is empty, `mixing_matrix` size
+ *   does not equal \f$K^2\f$, or any block size is zero.
+ * @throws std::range_error If any mixing matrix entry is negative or if
+ *   \f$M(g, h) / n_h > 1\f$ for any pair of blocks.
+ */
+template<typename TSeq>
+inline AdjList rgraph_sbm(
+    const std::vector< size_t > & block_sizes,
+    const std::vector< double > & mixing_matrix,
+    bool row_major,
+    Model<TSeq> & model
+) {
 
+    size_t n_blocks = block_sizes.size();
 
-#ifndef EPIWORLD_MODEL_BONES_HPP
-#define EPIWORLD_MODEL_BONES_HPP
+    if (n_blocks == 0u)
+        throw std::length_error(
+            "block_sizes must have at least one element."
+        );
 
-#include <memory>
-#include <vector>
-#include <functional>
-#include <string>
-#include <map>
-// (already included include/epiworld/config.hpp)
+    if (mixing_matrix.size() != n_blocks * n_blocks)
+        throw std::length_error(
+            "mixing_matrix must have size K * K, where K = block_sizes.size(). "
+            "Expected " + std::to_string(n_blocks * n_blocks) +
+            " but got " + std::to_string(mixing_matrix.size()) + "."
+        );
 
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+    // Total number of agents
+    size_t n = 0u;
+    const size_t max_adjlist_n = static_cast<size_t>(
+        std::numeric_limits<int>::max()
+    );
+    for (auto bs : block_sizes)
+    {
+        if (bs == 0u)
+            throw std::length_error(
+                "All block sizes must be positive."
+            );
 
- Start of -include/epiworld/agent-bones.hpp-
+        if (bs > max_adjlist_n - n)
+            throw std::length_error(
+                "The total number of agents implied by block_sizes exceeds "
+                "the maximum supported graph size (" +
+                std::to_string(std::numeric_limits<int>::max()) + ")."
+            );
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+        n += bs;
+    }
 
+    // Compute the starting index for each block
+    std::vector< size_t > block_start(n_blocks, 0u);
+    for (size_t g = 1u; g < n_blocks; ++g)
+        block_start[g] = block_start[g - 1u] + block_sizes[g - 1u];
 
-#ifndef EPIWORLD_PERSON_BONES_HPP
-#define EPIWORLD_PERSON_BONES_HPP
+    // Validate mixing matrix entries and compute probabilities.
+    // p(g, h) = M(g, h) / n_h for the undirected case.
+    // We validate that all entries are non-negative and p(g,h) <= 1.
+    // Also estimate the total expected edge count for vector reservation.
+    double estimated_edges = 0.0;
+    for (size_t g = 0u; g < n_blocks; ++g)
+    {
+        for (size_t h = 0u; h < n_blocks; ++h)
+        {
+            double m_gh = row_major
+                ? mixing_matrix[g * n_blocks + h]
+                : mixing_matrix[h * n_blocks + g];
 
-template<typename TSeq>
-class Model;
+            if (m_gh < 0.0)
+                throw std::range_error(
+                    "Mixing matrix entries must be non-negative. "
+                    "Entry (" + std::to_string(g) + ", " +
+                    std::to_string(h) + ") = " + std::to_string(m_gh) + "."
+                );
 
-template<typename TSeq>
-class Virus;
+            double p_gh = m_gh / static_cast<double>(block_sizes[h]);
+            if (p_gh > 1.0)
+                throw std::range_error(
+                    "Mixing matrix entry (" + std::to_string(g) + ", " +
+                    std::to_string(h) + ") = " + std::to_string(m_gh) +
+                    " implies probability " + std::to_string(p_gh) +
+                    " > 1 (block size = " +
+                    std::to_string(block_sizes[h]) + ")."
+                );
+        }
 
-template<typename TSeq>
-class Viruses;
+        // Accumulate expected edges for upper triangle (g <= h)
+        for (size_t h = g; h < n_blocks; ++h)
+        {
+            double m_gh = row_major
+                ? mixing_matrix[g * n_blocks + h]
+                : mixing_matrix[h * n_blocks + g];
 
-template<typename TSeq>
-class Viruses_const;
+            double p_gh = m_gh / static_cast<double>(block_sizes[h]);
+            if (p_gh <= 0.0)
+                continue;
 
-template<typename TSeq>
-class Tool;
+            double n_possible;
+            if (g == h)
+                n_possible = static_cast<double>(block_sizes[g]) *
+                    static_cast<double>(block_sizes[g] - 1u) / 2.0;
+            else
+                n_possible = static_cast<double>(block_sizes[g]) *
+                    static_cast<double>(block_sizes[h]);
 
+            estimated_edges += n_possible * std::min(p_gh, 1.0);
+        }
+    }
 
-template<typename TSeq>
-class Queue;
+    // Warn when the balance condition M(g,h)*n_g = M(h,g)*n_h is
+    // violated for any pair. The upper triangle is used for sampling,
+    // so the lower-triangle entries are silently ignored.
+    if (model.get_verbose())
+    {
+        for (size_t g = 0u; g < n_blocks; ++g)
+        {
+            for (size_t h = g + 1u; h < n_blocks; ++h)
+            {
+                double m_gh = row_major
+                    ? mixing_matrix[g * n_blocks + h]
+                    : mixing_matrix[h * n_blocks + g];
+                double m_hg = row_major
+                    ? mixing_matrix[h * n_blocks + g]
+                    : mixing_matrix[g * n_blocks + h];
 
-template<typename TSeq>
-struct Event;
+                double lhs = m_gh * static_cast<double>(block_sizes[g]);
+                double rhs = m_hg * static_cast<double>(block_sizes[h]);
 
-template<typename TSeq>
-class Entity;
+                if (std::abs(lhs - rhs) > 1e-10 *
+                    std::max(std::abs(lhs), std::abs(rhs)))
+                {
+                    printf_epiworld(
+                        "Warning [rgraph_sbm]: balance condition violated "
+                        "for blocks (%zu, %zu): M(%zu,%zu)*n_%zu = %.4f "
+                        "!= M(%zu,%zu)*n_%zu = %.4f. Only M(%zu,%zu)/n_%zu "
+                        "is used for edge sampling.\n",
+                        g, h,
+                        g, h, g, lhs,
+                        h, g, h, rhs,
+                        g, h, h
+                    );
+                }
+            }
+        }
+    }
 
-template<typename TSeq>
-class Entities;
+    std::vector< int > source;
+    std::vector< int > target;
 
-template<typename TSeq>
-class AgentsSample;
+    // Pre-allocate based on estimated edge count to avoid
+    // repeated reallocations during push_back.
+    source.reserve(static_cast<size_t>(estimated_edges * 1.1));
+    target.reserve(static_cast<size_t>(estimated_edges * 1.1));
 
-/**
- * @brief Agent (agents)
- * 
- * @tparam TSeq Sequence type (should match `TSeq` across the model)
- */
-template<typename TSeq>
-class Agent {
-    friend class Model<TSeq>;
-    friend class Virus<TSeq>;
-    friend class Tool<TSeq>;
-    friend class Queue<TSeq>;
-    friend class AgentsSample<TSeq>;
-protected:
+    // Batagelj-Brandes geometric skipping for each block pair.
+    // For each pair (g, h) with g <= h, we enumerate possible edges
+    // and skip ahead using geometric random variables, producing each
+    // edge independently with exactly probability p_gh. No duplicates,
+    // no bias.
+    for (size_t g = 0u; g < n_blocks; ++g)
+    {
+        for (size_t h = g; h < n_blocks; ++h)
+        {
 
-    std::vector< size_t > * neighbors = nullptr;
-    std::vector< size_t > * neighbors_locations = nullptr;
-    size_t n_neighbors = 0u;
+            double m_gh = row_major
+                ? mixing_matrix[g * n_blocks + h]
+                : mixing_matrix[h * n_blocks + g];
 
-    std::vector< size_t > entities; ///< Entity IDs (indices into Model::entities)
+            // Probability of an edge between agents in blocks g and h
+            double p_gh = m_gh / static_cast<double>(block_sizes[h]);
 
-    unsigned int state = 0u;
-    unsigned int state_prev = 0u; ///< For accounting, if need to undo a change.
-    
-    int state_last_changed = -1; ///< Last time the agent was updated.
-    int id = -1;
-    
-    VirusPtr<TSeq> virus = nullptr;
-
-    std::vector< ToolPtr<TSeq> > tools;
+            if (p_gh <= 0.0)
+                continue;
 
-    void reset(); ///< Resets the agent to the initial state (no virus, no tools, no entities, state 0.)
+            // Fast path: p_gh >= 1.0 means all edges are present
+            if (p_gh >= 1.0)
+            {
+                if (g == h)
+                {
+                    // All unique pairs within the block
+                    for (size_t i = block_start[g];
+                         i < block_start[g] + block_sizes[g]; ++i)
+                    {
+                        for (size_t j = i + 1u;
+                             j < block_start[g] + block_sizes[g]; ++j)
+                        {
+                            source.push_back(static_cast<int>(i));
+                            target.push_back(static_cast<int>(j));
+                        }
+                    }
+                }
+                else
+                {
+                    // All pairs between blocks g and h
+                    for (size_t i = block_start[g];
+                         i < block_start[g] + block_sizes[g]; ++i)
+                    {
+                        for (size_t j = block_start[h];
+                             j < block_start[h] + block_sizes[h]; ++j)
+                        {
+                            source.push_back(static_cast<int>(i));
+                            target.push_back(static_cast<int>(j));
+                        }
+                    }
+                }
+                continue;
+            }
 
-public:
+            double lp = std::log(1.0 - p_gh);
 
-    Agent() = default;
-    Agent(Agent<TSeq> && p);
-    Agent(const Agent<TSeq> & p);
-    Agent<TSeq> & operator=(const Agent<TSeq> & other_agent);
-    ~Agent();
+            if (g == h)
+            {
+                // Within-block: iterate (i, j) with i > j, both in
+                // [0, n_g). Use BB geometric skipping.
+                long long n_g = static_cast<long long>(block_sizes[g]);
+                long long i = 1;
+                long long j = -1;
 
-    /**
-     * @name Add/Remove Virus/Tool
-     * 
-     * Any of these is ultimately reflected at the end of the iteration.
-     * 
-     * @param tool Tool to add
-     * @param virus Virus to add
-     * @param state_new state after the change
-     * @param queue 
-     */
-    ///@{
-    void add_tool(
-        Model<TSeq> & model,
-        const Tool<TSeq> & tool,
-        epiworld_fast_int state_new = -99,
-        epiworld_fast_int queue = -99
-        );
+                while (i < n_g)
+                {
+                    double r = model.runif();
+                    if (r == 0.0)
+                        r = std::numeric_limits<double>::min();
 
-    void set_virus(
-        Model<TSeq> & model,
-        const Virus<TSeq> & virus,
-        epiworld_fast_int state_new = -99,
-        epiworld_fast_int queue = -99
-        );
+                    j += 1 + static_cast<long long>(
+                        std::floor(std::log(r) / lp)
+                    );
 
-    void add_entity(
-        Model<TSeq> & model,
-        Entity<TSeq> & entity,
-        epiworld_fast_int state_new = -99,
-        epiworld_fast_int queue = -99
-        );
+                    // Hybrid row-advance (see BB_FPU_THRESHOLD
+                    // comment in rgraph_bernoulli above).
+                    if (j >= i && i < n_g)
+                    {
+                        if (j - i > BB_FPU_THRESHOLD)
+                        {
+                            long long flat = i * (i - 1) / 2 + j;
+                            double df = static_cast<double>(flat);
+                            i = static_cast<long long>(std::floor(
+                                (1.0 + std::sqrt(1.0 + 8.0 * df)) / 2.0
+                            ));
+                            j = flat - i * (i - 1) / 2;
+                            while (j >= i) { j -= i; i++; }
+                            while (j < 0)  { i--; j += i; }
+                        }
+                        else
+                        {
+                            while (j >= i && i < n_g)
+                            {
+                                j -= i;
+                                i++;
+                            }
+                        }
+                    }
 
-    void rm_tool(
-        Model<TSeq> & model,
-        epiworld_fast_uint tool_idx,
-        epiworld_fast_int state_new = -99,
-        epiworld_fast_int queue = -99
-    );
+                    if (i < n_g)
+                    {
+                        source.push_back(
+                            static_cast<int>(block_start[g] +
+                                static_cast<size_t>(i))
+                        );
+                        target.push_back(
+                            static_cast<int>(block_start[g] +
+                                static_cast<size_t>(j))
+                        );
+                    }
+                }
+            }
+            else
+            {
+                // Between-block: iterate (i, j) with i in [0, n_g),
+                // j in [0, n_h). Linearize as k = i * n_h + j.
+                long long n_g = static_cast<long long>(block_sizes[g]);
+                long long n_h = static_cast<long long>(block_sizes[h]);
+                long long total = n_g * n_h;
+                long long k = -1;
 
-    void rm_tool(
-        Model<TSeq> & model,
-        ToolPtr<TSeq> & tool,
-        epiworld_fast_int state_new = -99,
-        epiworld_fast_int queue = -99
-    );
+                while (true)
+                {
+                    double r = model.runif();
+                    if (r == 0.0)
+                        r = std::numeric_limits<double>::min();
 
-    void rm_virus(
-        Model<TSeq> & model,
-        epiworld_fast_int state_new = -99,
-        epiworld_fast_int queue = -99
-    );
+                    k += 1 + static_cast<long long>(
+                        std::floor(std::log(r) / lp)
+                    );
 
-    void rm_entity(
-        Model<TSeq> & model,
-        epiworld_fast_uint entity_idx,
-        epiworld_fast_int state_new = -99,
-        epiworld_fast_int queue = -99
-    );
+                    if (k >= total)
+                        break;
 
-    void rm_entity(
-        Model<TSeq> & model,
-        Entity<TSeq> & entity,
-        epiworld_fast_int state_new = -99,
-        epiworld_fast_int queue = -99
-    );
+                    long long row = k / n_h;
+                    long long col = k % n_h;
 
-    void rm_agent_by_virus(Model<TSeq> & model) = delete; ///< Agent removed by virus
-    ///@}
-    
-    /**
-     * @name Get the rates (multipliers) for the agent
-     * 
-     * @param v A pointer to a virus.
-     * @return epiworld_double 
-     */
-    ///@{
-    epiworld_double get_susceptibility_reduction(VirusPtr<TSeq> & v, Model<TSeq> & model);
-    epiworld_double get_transmission_reduction(VirusPtr<TSeq> & v, Model<TSeq> & model);
-    epiworld_double get_recovery_enhancer(VirusPtr<TSeq> & v, Model<TSeq> & model);
-    epiworld_double get_death_reduction(VirusPtr<TSeq> & v, Model<TSeq> & model);
-    ///@}
+                    source.push_back(
+                        static_cast<int>(block_start[g] +
+                            static_cast<size_t>(row))
+                    );
+                    target.push_back(
+                        static_cast<int>(block_start[h] +
+                            static_cast<size_t>(col))
+                    );
+                }
+            }
 
-    int get_id() const; ///< Id of the individual
+        }
+    }
 
-    VirusPtr<TSeq> & get_virus();
-    const VirusPtr<TSeq> & get_virus() const;
+    return AdjList(source, target, static_cast<int>(n), false);
 
-    ToolPtr<TSeq> & get_tool(int i);
-    ToolPtr<TSeq> & get_tool(std::string name);
+}
 
-    std::vector<ToolPtr<TSeq>> get_tools();
-    const std::vector<ToolPtr<TSeq>> get_tools() const;
-    size_t get_n_tools() const noexcept;
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    void mutate_virus();
-    void add_neighbor(
-        Agent<TSeq> & p,
-        bool check_source = true,
-        bool check_target = true
-        );
+ End of -./include/epiworld/randgraph.hpp-
 
-    /**
-     * @brief Swaps neighbors between the current agent and agent `other`
-     * 
-     * @param other 
-     * @param n_this 
-     * @param n_other 
-     */
-    void swap_neighbors(
-        Agent<TSeq> & other,
-        size_t n_this,
-        size_t n_other,
-        Model<TSeq> & model
-    );
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    std::vector< Agent<TSeq> * > get_neighbors(Model<TSeq> & model);
-    size_t get_n_neighbors() const;
 
-    void change_state(
-        Model<TSeq> & model,
-        epiworld_fast_uint new_state,
-        epiworld_fast_int queue = 0
-        );
 
-    unsigned int get_state() const;
-    unsigned int get_state_prev() const;
-    int get_state_last_changed() const;
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
+ Start of -./include/epiworld/queue-bones.hpp-
 
-    bool has_tool(epiworld_fast_uint t) const;
-    bool has_tool(std::string_view name) const;
-    bool has_tool(const Tool<TSeq> & t) const;
-    bool has_virus(epiworld_fast_uint t) const;
-    bool has_virus(std::string_view name) const;
-    bool has_virus(const Virus<TSeq> & v) const;
-    bool has_entity(epiworld_fast_uint t) const;
-    bool has_entity(std::string_view name, const Model<TSeq> & model) const;
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    void print(Model<TSeq> & model, bool compressed = false) const;
+
+#ifndef EPIWORLD_QUEUE_BONES_HPP
+#define EPIWORLD_QUEUE_BONES_HPP
+
+/**
+ * @brief Controls which agents are verified at each step
+ * 
+ * @details The idea is that only agents who are either in
+ * an infected state or have an infected neighbor should be
+ * checked. Otherwise it makes no sense (no chance to recover
+ * or capture the disease).
+ * 
+ * **Implementation details:**
+ * <a href="../impl/queueing-system.md">Queueing System</a>
+ * 
+ * @tparam TSeq 
+ */
+template<typename TSeq>
+class Queue
+{
+    friend class Model<TSeq>;
+
+private:
 
     /**
-     * @brief Access the j-th column of the agent
-     * 
-     * If an external array has been specified, then these two
-     * functions can be used to access additional agent's features 
-     * not included in the model.
-     * 
-     * @param j 
-     * @param model Reference to the Model
-     * @return double& 
+     * @brief Count of ego's neighbors in queue (including ego)
+     */
+    std::vector< epiworld_fast_int > active;
+    Model<TSeq> * model = nullptr;
+    int n_in_queue = 0;
+
+    /**
+     * @brief Worklist of agents that may be in the queue
+     * @details Agents are added (once, as tracked by `in_list`) when their
+     * counter is increased or accessed through `operator[]`, and are
+     * removed lazily by `get_active_agents()` once their counter is back
+     * to zero. This way, iterating over the queue costs as much as the
+     * number of active agents, not the size of the population.
      */
     ///@{
-    double & operator()(size_t j, Model<TSeq> & model);
-    double operator()(size_t j, const Model<TSeq> & model) const;
+    std::vector< size_t > active_list;
+    std::vector< bool > in_list;
+    void touch(size_t i);
     ///@}
 
-    const std::vector< size_t > & get_entities() const;
+    // Auxiliary variable that checks how many steps
+    // left are there
+    // int n_steps_left;
+    // bool queuing_started   = false;
 
-    const Entity<TSeq> & get_entity(size_t i, const Model<TSeq> & model) const;
-    Entity<TSeq> & get_entity(size_t i, Model<TSeq> & model);
+public:
 
-    size_t get_n_entities() const;
+    void operator+=(Agent<TSeq> * p);
+    void operator-=(Agent<TSeq> * p);
+    epiworld_fast_int & operator[](epiworld_fast_uint i);
 
-    bool operator==(const Agent<TSeq> & other) const;
-    bool operator!=(const Agent<TSeq> & other) const {return !operator==(other);};
+    /**
+     * @brief Reads the counter of agent `i` without adding it to the
+     * worklist.
+     */
+    epiworld_fast_int operator[](epiworld_fast_uint i) const;
+
+    /**
+     * @brief Number of agents in the worklist, including those that left
+     * the queue since the last call to `get_active_agents()`.
+     */
+    size_t get_worklist_size() const {return active_list.size();};
+
+    /**
+     * @brief Ids of the agents in the queue, in ascending order
+     * @details Compacts the worklist before returning it. Iterating in
+     * ascending order keeps the draws from the random number generator
+     * in the same order as looping over the entire population.
+     */
+    const std::vector< size_t > & get_active_agents();
+
+    // void initialize(Model<TSeq> * m, Agent<TSeq> * p);
+    void reset();
+
+    bool operator==(const Queue<TSeq> & other) const;
+    bool operator!=(const Queue<TSeq> & other) const {return !operator==(other);};
+
+    static const int NoOne    = 0;
+    static const int OnlySelf = 1;
+    static const int Everyone = 2;
 
 };
 
+template<typename TSeq>
+inline void Queue<TSeq>::touch(size_t i)
+{
+
+    if (!in_list[i])
+    {
+        in_list[i] = true;
+        active_list.push_back(i);
+    }
+
+}
+
+template<typename TSeq>
+inline void Queue<TSeq>::operator+=(Agent<TSeq> * p)
+{
+
+    if (++active[p->id] == 1)
+        n_in_queue++;
+
+    touch(p->id);
+
+    if (p->get_n_neighbors() == 0u)
+        return; // No neighbors, no need to add them
+
+    const epiworld_agent_index * neighbors = model->network->neighbors(p->id);
+    for (size_t i = 0u; i < p->n_neighbors; ++i)
+    {
+
+        size_t n = neighbors[i];
+
+        if (++active[n] == 1)
+            n_in_queue++;
+
+        touch(n);
+
+    }
+
+}
+
+template<typename TSeq>
+inline void Queue<TSeq>::operator-=(Agent<TSeq> * p)
+{
+
+    if (--active[p->id] == 0)
+        n_in_queue--;
+
+    if (p->get_n_neighbors() == 0u)
+        return; // No neighbors, no need to add them
+
+    const epiworld_agent_index * neighbors = model->network->neighbors(p->id);
+    for (size_t i = 0u; i < p->n_neighbors; ++i)
+    {
+
+        size_t n = neighbors[i];
+
+        if (--active[n] == 0)
+            n_in_queue--;
+    }
+
+}
+
+template<typename TSeq>
+inline epiworld_fast_int & Queue<TSeq>::operator[](epiworld_fast_uint i)
+{
+    // The counter may be modified through the reference
+    touch(i);
+    return active[i];
+}
+
+template<typename TSeq>
+inline epiworld_fast_int Queue<TSeq>::operator[](epiworld_fast_uint i) const
+{
+    return active[i];
+}
+
+template<typename TSeq>
+inline const std::vector< size_t > & Queue<TSeq>::get_active_agents()
+{
+
+    if ((active_list.size() * 4u) > active.size())
+    {
+
+        // Dense queue: a single pass over the counters returns
+        // the agents already sorted
+        active_list.clear();
+        for (size_t i = 0u; i < active.size(); ++i)
+        {
+            in_list[i] = active[i] > 0;
+            if (in_list[i])
+                active_list.push_back(i);
+        }
+
+    }
+    else
+    {
+
+        // Sparse queue: dropping the agents that left the queue
+        size_t n = 0u;
+        for (auto i : active_list)
+        {
+            if (active[i] > 0)
+                active_list[n++] = i;
+            else
+                in_list[i] = false;
+        }
+
+        active_list.resize(n);
+        std::sort(active_list.begin(), active_list.end());
+
+    }
+
+    return active_list;
+
+}
+
+template<typename TSeq>
+inline void Queue<TSeq>::reset()
+{
+
+    if (n_in_queue)
+    {
+
+        for (auto & q : this->active)
+            q = 0;
+
+        n_in_queue = 0;
+        
+    }
+
+    active.resize(model->size(), 0);
+
+    // Rebuilding the worklist from the counters that were kept
+    active_list.clear();
+    in_list.assign(active.size(), false);
+    for (size_t i = 0u; i < active.size(); ++i)
+        if (active[i] > 0)
+            touch(i);
+
+}
+
+template<typename TSeq>
+inline bool Queue<TSeq>::operator==(const Queue<TSeq> & other) const 
+{
+    if (active.size() != other.active.size())
+        return false;
+
+    for (size_t i = 0u; i < active.size(); ++i)
+    {
+        if (active[i] != other.active[i])
+            return false;
+    }
 
+    return true;
+}
 
 #endif
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- End of -include/epiworld/agent-bones.hpp-
+ End of -./include/epiworld/queue-bones.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
@@ -9203,213 +9987,171 @@ public:
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- Start of -include/epiworld/virus-bones.hpp-
+ Start of -./include/epiworld/eventbuffer.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
-#ifndef EPIWORLD_VIRUS_HPP
-#define EPIWORLD_VIRUS_HPP
+#ifndef EPIWORLD_EVENTBUFFER_HPP
+#define EPIWORLD_EVENTBUFFER_HPP
 
 template<typename TSeq>
 class Agent;
 
 template<typename TSeq>
-class Virus;
-
-template<typename TSeq>
-class Model;
+class Entity;
 
 /**
- * @brief Virus
- * 
- * @tparam TSeq 
- * @details
- * Raw transmisibility of a virus should be a function of its genetic
- * sequence. Nonetheless, transmisibility can be reduced as a result of
- * having one or more tools to fight the virus. Because of this, transmisibility
- * should be a function of the agent.
+ * @brief Pending events of a model, stored as parallel arrays
+ *
+ * @details Each event is a row across the arrays `agent`, `action`,
+ * `new_state`, `queue`, and `payload`. Viruses, tools, and entities travel
+ * in their own arrays and events refer to them by index (`payload`, `-1`
+ * if none), so most events (e.g., changes of state) carry no shared
+ * pointers. The arrays keep their capacity across days. Filled by
+ * `Model<TSeq>::_add_event()` and consumed by `Model<TSeq>::events_run()`.
+ *
+ * @tparam TSeq
  */
 template<typename TSeq>
-class Virus {
-    friend class Agent<TSeq>;
+class EventBuffer {
     friend class Model<TSeq>;
-    friend class DataBase<TSeq>;
 private:
-    
-    Agent<TSeq> * agent = nullptr;
 
-    EPI_TYPENAME_TRAITS(TSeq, int) baseline_sequence = 
-        EPI_TYPENAME_TRAITS(TSeq, int)(); 
+    std::vector< Agent<TSeq> * > agent;
+    std::vector< EventAction > action;
+    std::vector< epiworld_fast_int > new_state;
+    std::vector< epiworld_fast_int > queue;
+    std::vector< int > payload; ///< Index in `viruses`, `tools`, or `entities`.
 
-    std::string virus_name = "unknown virus";
-    int date = -99;
-    int id   = -99;    
-    epiworld_fast_int state_init    = -99; ///< Change of state when added to agent.
-    epiworld_fast_int state_post    = -99; ///< Change of state when removed from agent.
-    epiworld_fast_int state_removed = -99; ///< Change of state when agent is removed
-
-    epiworld_fast_int queue_init    = Queue<TSeq>::Everyone; ///< Change of state when added to agent.
-    epiworld_fast_int queue_post    = -Queue<TSeq>::Everyone; ///< Change of state when removed from agent.
-    epiworld_fast_int queue_removed = -Queue<TSeq>::Everyone; ///< Change of state when agent is removed
-
-    MutFun<TSeq>          mutation                 = nullptr;
-    PostRecoveryFun<TSeq> post_recovery_fun        = nullptr;
-    VirusFun<TSeq>        probability_of_infecting = nullptr;
-    VirusFun<TSeq>        probability_of_recovery  = nullptr;
-    VirusFun<TSeq>        probability_of_death     = nullptr;
-    VirusFun<TSeq>        incubation               = nullptr;
-
-    // Information about how distribution works
-    VirusToAgentFun<TSeq> dist = nullptr;
-        
-public:
+    std::vector< VirusPtr<TSeq> > viruses;
+    std::vector< ToolPtr<TSeq> > tools;
+    std::vector< Entity<TSeq> * > entities;
 
-    #ifdef EPI_DEBUG_VIRUS
-    static std::atomic<int> counter_construct;          // Default and parameterized constructors
-    static std::atomic<int> counter_copy_construct;     // Copy constructor
-    static std::atomic<int> counter_move_construct;     // Move constructor
-    static std::atomic<int> counter_copy_assign;        // Copy assignment
-    static std::atomic<int> counter_move_assign;        // Move assignment
-    static std::atomic<int> counter_destruct;           // Destructor
-    #endif
+    std::vector< size_t > order; ///< Scratch space for `sort_by_agent()`.
 
-    Virus();
+public:
 
-    Virus(std::string name = "unknown virus");
-    
-    Virus(
-        std::string name,
-        epiworld_double prevalence,
-        bool as_proportion
-    );
-    
-    #ifdef EPI_DEBUG_VIRUS
-    
-    // Copy and move operations for debugging
-    Virus(const Virus<TSeq>& other);                    // Copy constructor
-    Virus(Virus<TSeq>&& other) noexcept;                // Move constructor
-    Virus<TSeq>& operator=(const Virus<TSeq>& other);   // Copy assignment
-    Virus<TSeq>& operator=(Virus<TSeq>&& other) noexcept; // Move assignment
+    size_t size() const noexcept { return action.size(); };
+    bool empty() const noexcept { return action.empty(); };
 
-    ~Virus();
-    #endif
-    
-    void mutate(Model<TSeq> * model);
-    void set_mutation(MutFun<TSeq> fun);
-    
-    EPI_TYPENAME_TRAITS(TSeq, int) get_sequence();
-    void set_sequence(TSeq sequence);
-    
-    Agent<TSeq> * get_agent();
-    void set_agent(Agent<TSeq> * p);
-    
-    void set_date(int d);
-    int get_date() const;
+    void push(
+        Agent<TSeq> * agent_,
+        VirusPtr<TSeq> && virus_,
+        ToolPtr<TSeq> && tool_,
+        Entity<TSeq> * entity_,
+        epiworld_fast_int new_state_,
+        epiworld_fast_int queue_,
+        EventAction action_
+    )
+    {
 
-    void set_id(int idx);
-    int get_id() const;
+        int idx = -1;
+        switch (action_)
+        {
+        case EventAction::AddVirus:
+        case EventAction::RemoveVirus:
+            idx = static_cast< int >(viruses.size());
+            viruses.push_back(std::move(virus_));
+            break;
+        case EventAction::AddTool:
+        case EventAction::RemoveTool:
+            idx = static_cast< int >(tools.size());
+            tools.push_back(std::move(tool_));
+            break;
+        case EventAction::AddEntity:
+        case EventAction::RemoveEntity:
+            idx = static_cast< int >(entities.size());
+            entities.push_back(entity_);
+            break;
+        default:
+            break;
+        }
+
+        agent.push_back(agent_);
+        action.push_back(action_);
+        new_state.push_back(new_state_);
+        queue.push_back(queue_);
+        payload.push_back(idx);
+
+    };
 
     /**
-     * @name Get and set the tool functions
-     * 
-     * @param v The virus over which to operate
-     * @param fun the function to be used
-     * 
-     * @return epiworld_double 
+     * @brief Moves the i-th event into `a`
+     * @details The virus or tool of the event (if any) is moved out of the
+     * buffer, so each event can only be retrieved once.
      */
-    ///@{
-    epiworld_double get_prob_infecting(Model<TSeq> * model);
-    epiworld_double get_prob_recovery(Model<TSeq> * model);
-    epiworld_double get_prob_death(Model<TSeq> * model);
-    epiworld_double get_incubation(Model<TSeq> * model);
-    
-    void post_recovery(Model<TSeq> * model);
-    void set_post_recovery(PostRecoveryFun<TSeq> fun);
-    void set_post_immunity(epiworld_double prob);
-    void set_post_immunity(std::string param);
+    void get(size_t i, Event<TSeq> & a)
+    {
 
-    void set_prob_infecting_fun(VirusFun<TSeq> fun);
-    void set_prob_recovery_fun(VirusFun<TSeq> fun);
-    void set_prob_death_fun(VirusFun<TSeq> fun);
-    void set_incubation_fun(VirusFun<TSeq> fun);
-    
-    void set_prob_infecting(std::string param);
-    void set_prob_recovery(std::string param);
-    void set_prob_death(std::string param);
-    void set_incubation(std::string param);
+        a.agent     = agent[i];
+        a.action    = action[i];
+        a.new_state = new_state[i];
+        a.queue     = queue[i];
+        a.virus     = nullptr;
+        a.tool      = nullptr;
+        a.entity    = nullptr;
 
-    // Deleting pointer versions to avoid mistakes
-    void set_prob_infecting(epiworld_double * prob) = delete;
-    void set_prob_recovery(epiworld_double * prob) = delete;
-    void set_prob_death(epiworld_double * prob) = delete;
-    void set_incubation(epiworld_double * prob) = delete;
-    void set_post_immunity(epiworld_double * prob) = delete;
-    
-    void set_prob_infecting(epiworld_double prob);
-    void set_prob_recovery(epiworld_double prob);
-    void set_prob_death(epiworld_double prob);
-    void set_incubation(epiworld_double prob);
-    ///@}
+        const int idx = payload[i];
+        if (idx < 0)
+            return;
 
+        switch (a.action)
+        {
+        case EventAction::AddVirus:
+        case EventAction::RemoveVirus:
+            a.virus = std::move(viruses[idx]);
+            break;
+        case EventAction::AddTool:
+        case EventAction::RemoveTool:
+            a.tool = std::move(tools[idx]);
+            break;
+        default:
+            a.entity = entities[idx];
+            break;
+        }
 
-    void set_name(std::string name);
-    std::string get_name() const;
+    };
 
     /**
-     * @name Get and set the state and queue
-     * 
-     * After applied, viruses can change the state and affect
-     * the queue of agents. These function sets the default values,
-     * which are retrieved when adding or removing a virus does not
-     * specify a change in state or in queue.
-     * 
-     * @param init After the virus/tool is added to the agent.
-     * @param end After the virus/tool is removed.
-     * @param removed After the agent (Agent) is removed.
+     * @brief Order in which to apply the events in `[from, to)`
+     * @details Sorted by agent id. The sort is stable, so the events of
+     * each agent keep the order in which they were added.
+     * @return Reference to a vector of `to - from` event indices.
      */
-    ///@{
-    void set_state(
-        epiworld_fast_int init,
-        epiworld_fast_int end,
-        epiworld_fast_int removed = -99
-        );
-        
-    void set_queue(
-        epiworld_fast_int init,
-        epiworld_fast_int end,
-        epiworld_fast_int removed = -99
-        );
+    const std::vector< size_t > & sort_by_agent(size_t from, size_t to)
+    {
 
-    void get_state(
-        epiworld_fast_int * init,
-        epiworld_fast_int * end,
-        epiworld_fast_int * removed = nullptr
-        ) const;
+        order.resize(to - from);
+        for (size_t i = from; i < to; ++i)
+            order[i - from] = i;
 
-    void get_queue(
-        epiworld_fast_int * init,
-        epiworld_fast_int * end,
-        epiworld_fast_int * removed = nullptr
-        ) const;
-    ///@}
+        std::stable_sort(
+            order.begin(), order.end(),
+            [this](size_t i, size_t j) {
+                return agent[i]->get_id() < agent[j]->get_id();
+            }
+        );
 
-    bool operator==(const Virus<TSeq> & other) const;
-    bool operator!=(const Virus<TSeq> & other) const {return !operator==(other);};
+        return order;
 
-    void print() const;
+    };
 
     /**
-     * @brief Get information about the prevalence of the virus
+     * @brief Removes all the events (keeps the capacity)
      */
-    ///@{
-    void distribute(Model<TSeq> * model);
-    void set_distribution(VirusToAgentFun<TSeq> fun);
-    ///@}
-
-    virtual ~Virus() = default;
-    virtual std::unique_ptr<Virus<TSeq>> clone_ptr() const;
+    void clear()
+    {
+        agent.clear();
+        action.clear();
+        new_state.clear();
+        queue.clear();
+        payload.clear();
+        viruses.clear();
+        tools.clear();
+        entities.clear();
+    };
 
 };
 
@@ -9417,4652 +10159,8387 @@ public:
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- End of -include/epiworld/virus-bones.hpp-
+ End of -./include/epiworld/eventbuffer.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
+
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- Start of -include/epiworld/viruses-bones.hpp-
+ Start of -./include/epiworld/contacttracing-bones.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
-#ifndef EPIWORLD_VIRUSES_BONES_HPP
-#define EPIWORLD_VIRUSES_BONES_HPP
-
-template<typename TSeq>
-class Virus;
+#ifndef EPIWORLD_CONTACTTRACING_BONES_H
+#define EPIWORLD_CONTACTTRACING_BONES_H
 
-template<typename TSeq>
-class Agent;
+#include <vector>
+#include <stdexcept>
+// (already included include/epiworld/config.hpp)
 
-/**
- * @brief Set of viruses (useful for building iterators)
+/** 
+ * @brief Class for tracing contacts between agents
+ * @details
+ * The class assumes that contacts are stored in a matrix-like
+ * structure, where rows are agents and columns are contacts in a 
+ * column-major format. Each entry stores the id of the contact
+ * and the day of the contact is stored in a parallel array.
  * 
- * @tparam TSeq 
- */
-template<typename TSeq>
-class Viruses {
-    friend class Virus<TSeq>;
-    friend class Agent<TSeq>;
+ * The maximum number of contacts per agent is fixed at initialization
+ * time. If more contacts are added, they will overwrite previous
+ * contacts in a circular buffer fashion.
+ * */
+class ContactTracing
+{
+    template<typename TSeq> friend class Model;
+
 private:
-    std::vector< VirusPtr<TSeq> > * dat;
-    const epiworld_fast_uint * n_viruses;
 
-public:
+    std::vector< epiworld_agent_index > contact_matrix;
+    std::vector< size_t > contacts_per_agent;
+    std::vector< size_t > contact_date;
 
-    Viruses() = delete;
-    Viruses(Agent<TSeq> & p) : dat(&p.viruses), n_viruses(&p.n_viruses) {};
+    size_t n_agents;
+    size_t max_contacts;
 
-    typename std::vector< VirusPtr<TSeq> >::iterator begin();
-    typename std::vector< VirusPtr<TSeq> >::iterator end();
+    size_t get_location(size_t row, size_t col) const;
 
-    VirusPtr<TSeq> & operator()(size_t i);
-    VirusPtr<TSeq> & operator[](size_t i);
+public:
 
-    size_t size() const noexcept;
+    ContactTracing();
 
-    void print() const noexcept;
+    /**
+     * @brief Construct a new Contact Tracing object
+     * 
+     * @param n_agents Agents in the system, usually `Model<TSeq>::size()`.
+     * @param max_contacts Maximum number of contacts to track per agent.
+     */
+    ContactTracing(size_t n_agents, size_t max_contacts);
 
-};
+    /**
+     * @brief Add a contact between two agents at a given day.
+     * 
+     * @param agent_a Agent id (usually infectious agent)
+     * @param agent_b Agent id (usually susceptible agent)
+     * @param day Day of the contact (usually Model<TSeq>::today()).
+     */
+    void add_contact(size_t agent_a, size_t agent_b, size_t day);
 
-template<typename TSeq>
-inline typename std::vector< VirusPtr<TSeq> >::iterator Viruses<TSeq>::begin()
-{
+    /**
+     * @brief Get the number of contacts for an agent
+     * 
+     * @param agent Agent id
+     * @return size_t Number of contacts recorded for that agent (can be more than max_contacts)
+     */
+    size_t get_n_contacts(size_t agent); 
 
-    if (*n_viruses == 0u)
-        return dat->end();
+    size_t get_max_contacts() const;
     
-    return dat->begin();
-}
+    /**
+     * @brief Get the contact object
+     * 
+     * @param agent Source agent (id)
+     * @param idx Index of the contact (0 to get_n_contacts(agent)-1)
+     * @return std::pair<size_t, int> with (contact_id, contact_day)
+     * @throws std::out_of_range if idx is out of range.
+     */
+    std::pair<size_t, int> get_contact(size_t agent, size_t idx);
 
-template<typename TSeq>
-inline typename std::vector< VirusPtr<TSeq> >::iterator Viruses<TSeq>::end()
-{
-    
-    #ifdef EPI_DEBUG
-    if (dat->size() < *n_viruses)
-        throw EPI_DEBUG_ERROR(std::logic_error, "Viruses:: The end of the virus is out of range");
-    #endif 
+    /**
+     * @brief Reset the contact tracing data
+     * 
+     * Usually called by `Model<TSeq>::reset()`.
+     * 
+     * @param n_agents Number of agents
+     * @param max_contacts Maximum number of contacts to track per agent
+     */
+    void reset(
+        size_t n_agents,
+        size_t max_contacts
+    );
 
-    return begin() + *n_viruses;
-}
-
-template<typename TSeq>
-inline VirusPtr<TSeq> & Viruses<TSeq>::operator()(size_t i)
-{
-
-    if (i >= *n_viruses)
-        throw std::range_error("Virus index out of range.");
+    /**
+     * @brief Print the contacts of an agent 
+     * 
+     * @param agent Agent id
+     */
+    void print(size_t agent);
+};
 
-    return dat->operator[](i);
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-}
+ End of -./include/epiworld/contacttracing-bones.hpp-
 
-template<typename TSeq>
-inline VirusPtr<TSeq> & Viruses<TSeq>::operator[](size_t i)
-{
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    return dat->operator[](i);
 
-}
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-template<typename TSeq>
-inline size_t Viruses<TSeq>::size() const noexcept 
-{
-    return *n_viruses;
-}
+ Start of -./include/epiworld/contacttracing-meat.hpp-
 
-template<typename TSeq>
-inline void Viruses<TSeq>::print() const noexcept
-{
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    if (*n_viruses == 0u)
-    {
-        printf_epiworld("List of viruses (none)\n");
-        return;
-    }
 
-    printf_epiworld("List of viruses (%i): ", *n_viruses);
+#ifndef EPIWORLD_CONTACTTRACING_MEAT_H
+#define EPIWORLD_CONTACTTRACING_MEAT_H
 
-    // Printing the name of each virus separated by a comma
-    for (size_t i = 0u; i < *n_viruses; ++i)
-    {
-        if (i == *n_viruses - 1u)
-        {
-            printf_epiworld("%s", dat->operator[](i)->get_name().c_str());
-        } else 
-        {
-            printf_epiworld("%s, ", dat->operator[](i)->get_name().c_str());
-        }
-    }
-    
-    printf_epiworld("\n");
+// (already included include/epiworld/contacttracing-bones.hpp)
 
+inline size_t ContactTracing::get_location(size_t row, size_t col) const
+{
+    return col * n_agents + row;
 }
 
-/**
- * @brief Set of Viruses (const) (useful for iterators)
- * 
- * @tparam TSeq 
- */
-template<typename TSeq>
-class Viruses_const {
-    friend class Virus<TSeq>;
-    friend class Agent<TSeq>;
-private:
-    const std::vector< VirusPtr<TSeq> > * dat;
-    const epiworld_fast_uint * n_viruses;
-
-public:
-
-    Viruses_const() = delete;
-    Viruses_const(const Agent<TSeq> & p) : dat(&p.viruses), n_viruses(&p.n_viruses) {};
-
-    typename std::vector< VirusPtr<TSeq> >::const_iterator begin() const;
-    typename std::vector< VirusPtr<TSeq> >::const_iterator end() const;
+inline ContactTracing::ContactTracing()
+{
+    n_agents = 0u;
+    max_contacts = 0u;
+}
 
-    const VirusPtr<TSeq> & operator()(size_t i);
-    const VirusPtr<TSeq> & operator[](size_t i);
+inline ContactTracing::ContactTracing(size_t n_agents, size_t max_contacts)
+{
+    this->n_agents = n_agents;
+    this->max_contacts = max_contacts;
 
-    size_t size() const noexcept;
+    contact_matrix.resize(n_agents * max_contacts, 0u);
+    contacts_per_agent.resize(n_agents, 0);
+    contact_date.resize(n_agents * max_contacts, 0);
+}
 
-    void print() const noexcept;
+inline void ContactTracing::add_contact(size_t agent_a, size_t agent_b, size_t day)
+{
+    
+    // Checking overflow
+    size_t col_location = contacts_per_agent[agent_a] % max_contacts;
+    size_t array_location = get_location(agent_a, col_location);
 
-};
+    contact_matrix[array_location] = static_cast< epiworld_agent_index >(agent_b);
+    contact_date[array_location] = day;
 
-template<typename TSeq>
-inline typename std::vector< VirusPtr<TSeq> >::const_iterator Viruses_const<TSeq>::begin() const {
+    contacts_per_agent[agent_a] += 1;
 
-    if (*n_viruses == 0u)
-        return dat->end();
-    
-    return dat->begin();
 }
 
-template<typename TSeq>
-inline typename std::vector< VirusPtr<TSeq> >::const_iterator Viruses_const<TSeq>::end() const {
-
-    #ifdef EPI_DEBUG
-    if (dat->size() < *n_viruses)
-        throw EPI_DEBUG_ERROR(std::logic_error, "Viruses_const:: The end of the virus is out of range");
-    #endif 
-    return begin() + *n_viruses;
+inline size_t ContactTracing::get_n_contacts(size_t agent)
+{
+    return contacts_per_agent[agent];
 }
 
-template<typename TSeq>
-inline const VirusPtr<TSeq> & Viruses_const<TSeq>::operator()(size_t i)
+inline size_t ContactTracing::get_max_contacts() const
 {
-
-    if (i >= *n_viruses)
-        throw std::range_error("Virus index out of range.");
-
-    return dat->operator[](i);
-
+    return max_contacts;
 }
 
-template<typename TSeq>
-inline const VirusPtr<TSeq> & Viruses_const<TSeq>::operator[](size_t i)
+inline std::pair< size_t, int> ContactTracing::get_contact(size_t agent, size_t idx)
 {
+    if (
+        (idx >= contacts_per_agent[agent]) ||
+        (idx >= max_contacts)
+    )
+        throw std::out_of_range("Index out of range in get_contact");
 
-    return dat->operator[](i);
+    size_t col_location = idx % max_contacts;
+    size_t array_location = get_location(agent, col_location);
 
+    return { contact_matrix[array_location], contact_date[array_location] };
 }
 
-template<typename TSeq>
-inline size_t Viruses_const<TSeq>::size() const noexcept 
+inline void ContactTracing::reset(size_t n_agents, size_t max_contacts)
 {
-    return *n_viruses;
+
+    this->n_agents = n_agents;
+    this->max_contacts = max_contacts;
+
+    contact_matrix.assign(n_agents * max_contacts, 0u);
+    contacts_per_agent.assign(n_agents, 0u);
+    contact_date.assign(n_agents * max_contacts, 0u);
 }
 
-template<typename TSeq>
-inline void Viruses_const<TSeq>::print() const noexcept
+inline void ContactTracing::print(size_t agent)
 {
 
-    if (*n_viruses == 0u)
-    {
-        printf_epiworld("List of viruses (none)\n");
-        return;
-    }
-
-    printf_epiworld("List of viruses (%i): ", *n_viruses);
+    size_t n_contacts = contacts_per_agent[agent];
+    if (n_contacts > max_contacts)
+        n_contacts = max_contacts;
 
-    // Printing the name of each virus separated by a comma
-    for (size_t i = 0u; i < *n_viruses; ++i)
+    printf_epiworld("Agent %zu has %zu contacts: ", agent, n_contacts);
+    for (size_t i = 0u; i < n_contacts; ++i)
     {
-        if (i == *n_viruses - 1u)
-        {
-            printf_epiworld("%s", dat->operator[](i)->get_name().c_str());
-        } else
-        {
-            printf_epiworld("%s, ", dat->operator[](i)->get_name().c_str());
-        }
+        auto [contact_id, contact_day] = get_contact(agent, i);
+        printf_epiworld("(%zu, day %i) ", contact_id, contact_day);
     }
-    
     printf_epiworld("\n");
 
-}
+    return;
 
+}
 
 #endif
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- End of -include/epiworld/viruses-bones.hpp-
+ End of -./include/epiworld/contacttracing-meat.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
+
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- Start of -include/epiworld/tool-bones.hpp-
+ Start of -./include/epiworld/contactmatrix-bones.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
-#ifndef EPIWORLD_TOOL_BONES_HPP
-#define EPIWORLD_TOOL_BONES_HPP
-
-template<typename TSeq>
-class Virus;
-
-template<typename TSeq>
-class Agent;
-
-template<typename TSeq>
-class Model;
+#ifndef EPIWORLD_CONTACTMATRIX_BONES_HPP
+#define EPIWORLD_CONTACTMATRIX_BONES_HPP
 
-template<typename TSeq>
-class Tool;
+#include <vector>
 
 /**
- * @brief Tools for defending the agent against the virus
+ * @file contactmatrix-bones.hpp
+ * @brief Base class for handling contact matrices in epidemiological
+ * models
  * 
- * @tparam TSeq Type of sequence
+ * This class provides functionality for setting and validating contact
+ * matrices, which are essential for modeling population mixing in
+ * epidemiological simulations. Models that require contact matrices can
+ * inherit from this class.
  */
-template<typename TSeq> 
-class Tool {
-    friend class Agent<TSeq>;
-    friend class Model<TSeq>;
-protected:
+class ContactMatrix 
+{
+private: 
 
-    Agent<TSeq> * agent = nullptr;
-    int pos_in_agent        = -99; ///< Location in the agent
+    std::vector< double > contact_matrix;
+    std::vector< double > contact_matrix_backup; ///< Used for resetting the model
+    int n_groups = -1;
 
-    int date = -99;
-    int id   = -99;
-    std::string tool_name;
-    
-    EPI_TYPENAME_TRAITS(TSeq, int) sequence = 
-        EPI_TYPENAME_TRAITS(TSeq, int)(); ///< Sequence of the tool
+public:
 
-    ToolFun<TSeq> susceptibility_reduction = nullptr;
-    ToolFun<TSeq> transmission_reduction   = nullptr;
-    ToolFun<TSeq> recovery_enhancer        = nullptr;
-    ToolFun<TSeq> death_reduction          = nullptr;
+    ContactMatrix() = default;
 
-    ToolToAgentFun<TSeq> dist = nullptr;
+    /**
+     * @brief Validates the contact matrix size and values
+     * @param expected_size The expected size of the contact matrix
+     */
+    void validate_contact_matrix(size_t expected_size);
+    /**
+     * @brief Set the contact matrix for population mixing
+     * @param cmat Contact matrix specifying interaction rates between groups
+     * @param as_backup Whether to use the matrix as a backup (default: true)
+     * If set to true, the new contact matrix will be saved as a backup for
+     * resetting the model.
+     */
+    void set_contact_matrix(std::vector< double > cmat, bool as_backup = true);
 
-    epiworld_fast_int state_init = -99;
-    epiworld_fast_int state_post = -99;
+    /**
+     * @brief Get the current contact matrix
+     * @return Vector representing the contact matrix
+     */
+    const std::vector< double > & get_contact_matrix() const;
 
-    epiworld_fast_int queue_init = Queue<TSeq>::NoOne; ///< Change of state when added to agent.
-    epiworld_fast_int queue_post = Queue<TSeq>::NoOne; ///< Change of state when removed from agent.
+    /**
+     * @brief Get the current contact matrix
+     * @return Vector representing the contact matrix
+     */
+    std::vector< double > & get_contact_matrix_ref();
 
-    void set_agent(Agent<TSeq> * p, size_t idx);
+    /**
+     * @brief Get the contact rate between two groups
+     * @param i Index of the first group
+     * @param j Index of the second group
+     * @return Contact rate between group i and group j
+     */
+    double get_contact_rate(size_t i, size_t j, bool check = true) const;
 
-public:
-    Tool();
-    Tool(std::string name = "unknown tool");
-    Tool(
-        std::string name,
-        epiworld_double prevalence,
-        bool as_proportion
-    );
+    /**
+     * @brief Get the size of the contact matrix
+     * @return Size of the contact matrix
+     */
+    size_t get_contact_matrix_size() const;
+};
 
-    virtual ~Tool() = default;
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    void set_sequence(TSeq d);
-    void set_sequence(std::shared_ptr<TSeq> d);
-    EPI_TYPENAME_TRAITS(TSeq, int) get_sequence();
+ End of -./include/epiworld/contactmatrix-bones.hpp-
 
-    /**
-     * @name Get and set the tool functions
-     * 
-     * @param v The virus over which to operate
-     * @param fun the function to be used
-     * 
-     * @return epiworld_double 
-     */
-    ///@{
-    virtual epiworld_double get_susceptibility_reduction(VirusPtr<TSeq> & v, Model<TSeq> * model);
-    virtual epiworld_double get_transmission_reduction(VirusPtr<TSeq> & v, Model<TSeq> * model);
-    virtual epiworld_double get_recovery_enhancer(VirusPtr<TSeq> & v, Model<TSeq> * model);
-    virtual epiworld_double get_death_reduction(VirusPtr<TSeq> & v, Model<TSeq> * model);
-    
-    virtual void set_susceptibility_reduction_fun(ToolFun<TSeq> fun);
-    virtual void set_transmission_reduction_fun(ToolFun<TSeq> fun);
-    virtual void set_recovery_enhancer_fun(ToolFun<TSeq> fun);
-    virtual void set_death_reduction_fun(ToolFun<TSeq> fun);
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    virtual void set_susceptibility_reduction(std::string param);
-    virtual void set_transmission_reduction(std::string param);
-    virtual void set_recovery_enhancer(std::string param);
-    virtual void set_death_reduction(std::string param);
 
-    // Deleting pointer versions to avoid mistakes
-    virtual void set_susceptibility_reduction(epiworld_double * prob) = delete;
-    virtual void set_transmission_reduction(epiworld_double * prob) = delete;
-    virtual void set_recovery_enhancer(epiworld_double * prob) = delete;
-    virtual void set_death_reduction(epiworld_double * prob) = delete;
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    virtual void set_susceptibility_reduction(epiworld_double prob);
-    virtual void set_transmission_reduction(epiworld_double prob);
-    virtual void set_recovery_enhancer(epiworld_double prob);
-    virtual void set_death_reduction(epiworld_double prob);
-    ///@}
+ Start of -./include/epiworld/contactmatrix-meat.hpp-
 
-    void set_name(std::string name);
-    virtual std::string get_name() const;
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    Agent<TSeq> * get_agent();
-    int get_id() const;
-    void set_id(int id);
-    void set_date(int d);
-    int get_date() const;
 
-    void set_state(epiworld_fast_int init, epiworld_fast_int post);
-    void set_queue(epiworld_fast_int init, epiworld_fast_int post);
-    void get_state(epiworld_fast_int * init, epiworld_fast_int * post);
-    void get_queue(epiworld_fast_int * init, epiworld_fast_int * post);
+#ifndef EPIWORLD_CONTACTMATRIX_MEAT_HPP
+#define EPIWORLD_CONTACTMATRIX_MEAT_HPP
 
-    bool operator==(const Tool<TSeq> & other) const;
-    bool operator!=(const Tool<TSeq> & other) const {return !operator==(other);};
+// (already included include/epiworld/contactmatrix-bones.hpp)
+#include <stdexcept>
 
-    void print() const;
+inline void ContactMatrix::validate_contact_matrix(size_t expected_size)
+{
 
-    void distribute(Model<TSeq> * model);
-    void set_distribution(ToolToAgentFun<TSeq> fun);
+    if (!contact_matrix_backup.empty())
+        contact_matrix = contact_matrix_backup;
 
-    virtual std::unique_ptr<Tool<TSeq>> clone_ptr() const; 
+    if (contact_matrix.size() != expected_size * expected_size)
+        throw std::length_error(
+            std::string("Contact matrix size is ") +
+            std::to_string(contact_matrix.size()) +
+            std::string(", but expected size is ") +
+            std::to_string(expected_size * expected_size) + "."
+        );
+
+    for (int i = 0; i < n_groups; ++i)
+    {
+        for (int j = 0; j < n_groups; ++j)
+        {
+            if (get_contact_rate(i, j, false) < 0.0)
+                throw std::range_error(
+                    std::string("The contact matrix must be non-negative. ") +
+                    std::to_string(this->get_contact_rate(i, j, false)) +
+                    std::string(" < 0.")
+                    );
+        }
+    }
+
+}
 
+inline void ContactMatrix::set_contact_matrix(
+    std::vector< double > cmat,
+    bool as_backup
+)
+{
+    n_groups = static_cast<int>(std::sqrt(cmat.size()));
+    if (n_groups * n_groups != static_cast<int>(cmat.size()))
+        throw std::invalid_argument(
+            "Contact matrix size is not a perfect square, cannot determine number of groups."
+        );
+
+    if (as_backup)
+        contact_matrix_backup = cmat;
+
+    contact_matrix = cmat;
+    return;
 };
 
+inline const std::vector< double > & ContactMatrix::get_contact_matrix() const
+{
+    return contact_matrix;
+}
+
+inline std::vector< double > & ContactMatrix::get_contact_matrix_ref()
+{
+    return contact_matrix;
+}
+
+inline double ContactMatrix::get_contact_rate(
+    size_t i, size_t j, bool check
+) const
+{
+    if (check && (
+        (static_cast<int>(i) >= n_groups) ||
+        (static_cast<int>(j) >= n_groups)
+    ))
+        throw std::out_of_range(
+            std::string("Group indices out of range. ") +
+            std::to_string(i) + ", " + std::to_string(j) +
+            std::string(" >= ") + std::to_string(n_groups)
+        );
+    return contact_matrix[j * n_groups + i];
+}
+
+inline size_t ContactMatrix::get_contact_matrix_size() const
+{
+    return contact_matrix.size();
+}
+
 #endif
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- End of -include/epiworld/tool-bones.hpp-
+ End of -./include/epiworld/contactmatrix-meat.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
-// (already included include/epiworld/database-bones.hpp)
-// (already included include/epiworld/queue-bones.hpp)
-// (already included include/epiworld/globalevent-bones.hpp)
-// (already included include/epiworld/contacttracing-bones.hpp)
 
-template<typename TSeq>
-class AgentsSample;
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-class AdjList;
+ Start of -./include/epiworld/globalevent-bones.hpp-
 
-template<typename TSeq = EPI_DEFAULT_TSEQ>
-inline std::function<void(size_t,Model<TSeq>*)> make_save_run(
-    std::string fmt = "%03lu-episimulation.csv",
-    bool total_hist = true,
-    bool virus_info = false,
-    bool virus_hist = false,
-    bool tool_info = false,
-    bool tool_hist = false,
-    bool transmission = false,
-    bool transition = false,
-    bool reproductive = false,
-    bool generation = false,
-    bool active_cases = false,
-    bool outbreak_size = false,
-    bool hospitalizations = false
-    );
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-// template<typename TSeq>
-// class VirusPtr;
 
-// template<typename TSeq>
-// class ToolPtr;
+#ifndef EPIWORLD_GLOBALEVENT_BONES_HPP
+#define EPIWORLD_GLOBALEVENT_BONES_HPP
+
+#include <string>
+// (already included include/epiworld/config.hpp)
 
 /**
- * @brief Core class of epiworld.
- *
- * The model class provides the wrapper that puts together `Agent`, `Virus`, and
- * `Tools`.
- *
- * @tparam TSeq Type of sequence. In principle, users can build models in which
- * virus and human sequence is represented as numeric vectors (if needed.)
+ * @brief Template for a Global Event
+ * @details Global events are functions that Model<TSeq> executes
+ * at the end of a day.
+ * 
  */
 template<typename TSeq>
-class Model {
-    friend class Agent<TSeq>;
-    friend class AgentsSample<TSeq>;
-    friend class DataBase<TSeq>;
-    friend class Queue<TSeq>;
+class GlobalEvent
+{
+private:
+    GlobalFun<TSeq> fun = nullptr;
+    std::string name = "A global action";
+    int day = -99;
+public:
 
-protected:
+    GlobalEvent() {};
 
-    std::string name = ""; ///< Name of the model
+    /**
+     * @brief Construct a new Global Event object
+     * 
+     * @param fun A function that takes a Model<TSeq> * as argument and returns void.
+     * @param name A descriptive name for the action.
+     * @param day The day when the action will be executed. If negative, it will be executed every day.
+     */
+    GlobalEvent(GlobalFun<TSeq> fun, std::string name, int day = -99);
+    
+    virtual ~GlobalEvent() = default;
 
-    DataBase<TSeq> db = DataBase<TSeq>(*this);
+    virtual void operator()(Model<TSeq> * m, int day);
 
-    std::vector< Agent<TSeq> > population = {};
+    void set_name(std::string name);
+    std::string get_name() const;
 
-    bool using_backup = true;
-    std::vector< Agent<TSeq> > population_backup = {};
+    void set_day(int day);
+    int get_day() const;
+    
+    void print() const;
 
-    /**
-     * @name Auxiliary variables for AgentsSample<TSeq> iterators
-     *
-     * @details These variables+objects are used by the AgentsSample<TSeq>
-     * class for building efficient iterators over agents. The idea is to
-     * reduce the memory allocation, so only during the first call of
-     * AgentsSample<TSeq>::AgentsSample(Model<TSeq>) these vectors are allocated.
-     */
-    ///@{
-    std::vector< Agent<TSeq> * > sampled_population;
-    size_t sampled_population_n = 0u;
-    std::vector< size_t > population_left;
-    size_t population_left_n = 0u;
-    ///@}
+    // Comparison operators
+    bool operator==(const GlobalEvent<TSeq> & other) const;
+    bool operator!=(const GlobalEvent<TSeq> & other) const;
 
-    /**
-     * @name Agents features
-     *
-     * @details Optionally, a model can include an external data source
-     * pointing to agents information. The data can then be access through
-     * the `Agent::operator()` method.
-     *
-     */
-    ///@{
-    double * agents_data = nullptr;
-    size_t agents_data_ncols = 0u;
-    ///@}
+    virtual std::unique_ptr<GlobalEvent<TSeq>> clone_ptr() const;
 
-    bool directed = false;
+};
 
-    std::vector< VirusPtr<TSeq> > viruses = {};
-    std::vector< ToolPtr<TSeq> > tools = {};
 
-    std::vector< Entity<TSeq> > entities = {};
 
-    std::shared_ptr< epi_xoshiro256ss > engine = std::make_shared< epi_xoshiro256ss >();
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    epiworld_double runifd_a = 0.0;
-    epiworld_double runifd_b = 1.0;
-    std::normal_distribution<>       rnormd      =
-        std::normal_distribution<>(0.0);
-    std::gamma_distribution<>        rgammad     =
-        std::gamma_distribution<>();
-    std::lognormal_distribution<>    rlognormald =
-        std::lognormal_distribution<>();
-    std::exponential_distribution<>  rexpd       =
-        std::exponential_distribution<>();
-    std::binomial_distribution<> rbinomd         =
-        std::binomial_distribution<>();
-    int rbinomd_n = 1;
-    epiworld_double rbinomd_fast_lambda = 0.0;
-    bool rbinomd_use_poisson = false;
-    std::negative_binomial_distribution<> rnbinomd =
-        std::negative_binomial_distribution<>();
-    std::geometric_distribution<> rgeomd          =
-        std::geometric_distribution<>();
-    std::poisson_distribution<> rpoissd           =
-        std::poisson_distribution<>();
+ End of -./include/epiworld/globalevent-bones.hpp-
 
-    std::function<void(std::vector<Agent<TSeq>>*,Model<TSeq>*,epiworld_double)> rewire_fun;
-    epiworld_double rewire_prop = 0.0;
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    std::map<std::string, epiworld_double > parameters;
-    epiworld_fast_uint ndays = 0;
-    Progress pb;
 
-    std::vector< UpdateFun<TSeq> >    state_fun = {};                  ///< Functions to update states
-    std::vector< std::string >        states_labels = {};              ///< Labels of the states
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    /** Function to distribute states. Goes along with the function  */
-    std::function<void(Model<TSeq>*)> initial_states_fun = [](Model<TSeq> * /**/)
-    -> void {};
+ Start of -./include/epiworld/globalevent-meat.hpp-
 
-    epiworld_fast_uint nstates = 0u;
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    bool verbose     = true;
-    int current_date = 0;
 
-    void dist_tools();
-    void dist_virus();
-    void dist_entities();
+#ifndef EPIWORLD_GLOBALEVENT_MEAT_HPP
+#define EPIWORLD_GLOBALEVENT_MEAT_HPP
 
-    std::chrono::time_point<std::chrono::steady_clock> time_start;
-    std::chrono::time_point<std::chrono::steady_clock> time_end;
+#include <memory>
+// (already included include/epiworld/globalevent-bones.hpp)
 
-    // std::chrono::milliseconds
-    std::chrono::duration<epiworld_double,std::micro> time_elapsed =
-        std::chrono::duration<epiworld_double,std::micro>::zero();
-    epiworld_fast_uint n_replicates = 0u;
-    int last_seed = 0;
-    void chrono_start();
-    void chrono_end();
+template<typename TSeq>
+inline GlobalEvent<TSeq>::GlobalEvent(
+    GlobalFun<TSeq> fun,
+    std::string name,
+    int day
+    )
+{
+    this->fun = fun;
+    this->name = name;
+    this->day = day;
+}
 
-    std::vector<GlobalEventPtr<TSeq>> globalevents;
+template<typename TSeq>
+inline void GlobalEvent<TSeq>::operator()(Model<TSeq> * m, int day)
+{   
+    
+    if (this->fun == nullptr)
+        return;
 
-    Queue<TSeq> queue;
-    bool use_queuing   = true;
-    size_t sim_id = 0u;
-    void set_sim_id(size_t id);
+    // events apply if day is negative or if day is equal to the day of the action
+    if (this->day < 0 || this->day == day)
+        this->fun(m);
+    
+    return;
 
-    std::unique_ptr<ContactTracing> contact_tracing;
-    bool use_contact_tracing = false;
-    size_t contact_tracing_max_contacts = EPI_MAX_TRACKING;
+}
 
-    /**
-     * @brief Variables used to keep track of the events
-     * to be made regarding viruses.
-     */
-    std::vector< Event<TSeq> > events = {};
-    epiworld_fast_uint nactions = 0u;
+template<typename TSeq>
+inline void GlobalEvent<TSeq>::set_name(std::string name)
+{
+    this->name = name;
+}
 
-    /**
-     * @brief Construct a new Event object
-     *
-     * @param agent_ Agent over which the action will be called
-     * @param virus_ Virus pointer included in the action
-     * @param tool_ Tool pointer included in the action
-     * @param entity_ Entity pointer included in the action
-     * @param new_state_ New state of the agent
-     * @param queue_ Change in the queue
-      * @param action_ Action to execute when processing the event
-     */
-    void _add_event(
-        Agent<TSeq> * agent_,
-        VirusPtr<TSeq> virus_,
-        ToolPtr<TSeq> tool_,
-        Entity<TSeq> * entity_,
-        epiworld_fast_int new_state_,
-        epiworld_fast_int queue_,
-          EventAction action_
+template<typename TSeq>
+inline std::string GlobalEvent<TSeq>::get_name() const
+{
+    return this->name;
+}
+
+template<typename TSeq>
+inline void GlobalEvent<TSeq>::set_day(int day)
+{
+    this->day = day;
+}
+
+template<typename TSeq>
+inline int GlobalEvent<TSeq>::get_day() const
+{
+    return this->day;
+}
+
+template<typename TSeq>
+inline void GlobalEvent<TSeq>::print() const
+{
+    printf_epiworld(
+        "Global action: %s\n"
+        "  - Day: %i\n",
+        this->name.c_str(),
+        this->day
         );
+}
 
-    /**
-     * @name Default event handlers
-     *
-     * These member functions implement the default behavior for each
-     * event action (add/remove virus, tool, entity, or change state).
-     */
-    ///@{
-    void _event_add_virus(Event<TSeq> & a);
-    void _event_add_tool(Event<TSeq> & a);
-    void _event_add_entity(Event<TSeq> & a);
-    void _event_rm_virus(Event<TSeq> & a);
-    void _event_rm_tool(Event<TSeq> & a);
-    void _event_rm_entity(Event<TSeq> & a);
-    void _event_change_state(Event<TSeq> & a);
-    ///@}
+template<typename TSeq>
+inline bool GlobalEvent<TSeq>::operator==(const GlobalEvent<TSeq> & other) const
+{
+    return (this->name == other.name) && (this->day == other.day);
+}
 
-    /**
-     * @name Tool Mixers
-     *
-     * These functions combine the effects tools have to deliver
-     * a single effect. For example, wearing a mask, been vaccinated,
-     * and the immune system combine together to jointly reduce
-     * the susceptibility for a given virus.
-     *
-     */
-    virtual epiworld_double susceptibility_reduction_mixer(
-        Agent<TSeq> * agent, VirusPtr<TSeq> & virus
-    );
-    virtual epiworld_double transmission_reduction_mixer(
-        Agent<TSeq> * agent, VirusPtr<TSeq> & virus
-    );
-    virtual epiworld_double recovery_enhancer_mixer(
-        Agent<TSeq> * agent, VirusPtr<TSeq> & virus
-    );
-    virtual epiworld_double death_reduction_mixer(
-        Agent<TSeq> * agent, VirusPtr<TSeq> & virus
-    );
+template<typename TSeq>
+inline bool GlobalEvent<TSeq>::operator!=(const GlobalEvent<TSeq> & other) const
+{
+    return !(*this == other);
+}
 
-    /**
-     * @brief Advanced usage: Makes a copy of data and returns it as undeleted pointer
-     *
-     * @param copy
-     */
-    virtual std::unique_ptr<Model<TSeq>> clone_ptr();
+template<typename TSeq>
+inline std::unique_ptr<GlobalEvent<TSeq>> GlobalEvent<TSeq>::clone_ptr() const
+{
+    return std::make_unique<GlobalEvent<TSeq>>(*this);
+}
 
-public:
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    std::array<epiworld_double, 1024u * 2u> array_double_tmp;
-    std::array<Virus<TSeq> *, 1024u * 2u> array_virus_tmp;
+ End of -./include/epiworld/globalevent-meat.hpp-
 
-    Model();
-    Model(const Model<TSeq> & m);
-    Model(Model<TSeq> && m);
-    Model<TSeq> & operator=(const Model<TSeq> & m);
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    virtual ~Model() {};
 
-    /**
-     * @name Set the backup object
-     * @details `backup` can be used to restore the entire object
-     * after a run. This can be useful if the user wishes to have
-     * individuals start with the same network from the beginning.
-     *
-     */
-    ///@{
-    void set_backup();
-    // void restore_backup();
-    ///@}
-
-    DataBase<TSeq> & get_db();
-    const DataBase<TSeq> & get_db() const;
-    epiworld_double operator()(std::string pname);
 
-    size_t size() const;
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    /**
-     * @name Random number generation
-     *
-     * @param eng Random number generator
-     * @param s Seed
-     */
-    ///@{
-    void set_rand_engine(std::shared_ptr< epi_xoshiro256ss > & eng);
-    std::shared_ptr< epi_xoshiro256ss > & get_rand_endgine();
-    void seed(size_t s);
-    void set_rand_norm(epiworld_double mean, epiworld_double sd);
-    void set_rand_unif(epiworld_double a, epiworld_double b);
-    void set_rand_exp(epiworld_double lambda);
-    void set_rand_gamma(epiworld_double alpha, epiworld_double beta);
-    void set_rand_lognormal(epiworld_double mean, epiworld_double shape);
-    void set_rand_binom(int n, epiworld_double p);
-    void set_rand_nbinom(int n, epiworld_double p);
-    void set_rand_geom(epiworld_double p);
-    void set_rand_poiss(epiworld_double lambda);
-    epiworld_double rnorm();
-    epiworld_double rnorm(epiworld_double mean, epiworld_double sd);
-    epiworld_double rgamma();
-    epiworld_double rgamma(epiworld_double alpha, epiworld_double beta);
-    epiworld_double rexp();
-    epiworld_double rexp(epiworld_double lambda);
-    epiworld_double rlognormal();
-    epiworld_double rlognormal(epiworld_double mean, epiworld_double shape);
+ Start of -./include/epiworld/model-bones.hpp-
 
-    /**
-     * @brief Draw from the currently configured uniform distribution.
-     * @return A random draw from the configured uniform distribution.
-     * @details
-     * These uniform draws make use of Lemire's algorithm for fast
-     * uniform integer generation, which is both faster and more accurate than
-     * the common `std::uniform_int_distribution` approach.
-     * 
-     * 
-     * Lemire, D. (2019). Fast Random Integer Generation in an Interval.
-     * ACM Trans. Model. Comput. Simul., 29(1), 3:1-3:12.
-     * <https://doi.org/10.1145/3230636>
-     */
-    epiworld_double runif();
-    epiworld_double runif(epiworld_double a, epiworld_double b);
-    int runif_int(int a, int b);
-    uint32_t runif_index(uint32_t n);
-    /**
-     * @brief Draw from the currently configured binomial distribution.
-     * @details When `EPI_FAST_BINOM` is enabled (default), this uses
-     * `rpoiss(lambda)` with `lambda = n * p` after `set_rand_binom(n, p)` in the
-     * rare-event regime `p <= 0.01` and `n * p * p <= 0.1`. Define
-     * `EPI_NO_FAST_BINOM` before including epiworld to disable this behavior.
-     * @return A random draw from the configured binomial distribution, or from
-     * its Poisson approximation when the fast path is active.
-     */
-    int rbinom();
-    /**
-     * @brief Draw from a binomial distribution with parameters `n` and `p`.
-     * @details When `EPI_FAST_BINOM` is enabled (default), this uses
-     * `rpoiss(lambda)` with `lambda = n * p` in the rare-event regime
-     * `p <= 0.01` and `n * p * p <= 0.1`. This preserves the mean and is often
-     * substantially faster in practice while remaining very accurate in that
-     * region. Define `EPI_NO_FAST_BINOM` before including epiworld to disable
-     * this behavior and force the exact binomial draw.
-     * @param n Number of trials.
-     * @param p Success probability.
-     * @return A random draw from the binomial distribution, or from its
-     * Poisson approximation when the fast path is active.
-     */
-    int rbinom(int n, epiworld_double p);
-    int rnbinom();
-    int rnbinom(int n, epiworld_double p);
-    int rgeom();
-    int rgeom(epiworld_double p);
-    int rpoiss();
-    int rpoiss(epiworld_double lambda);
-    ///@}
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    /**
-     * @brief Sample from a set of probabilities stored in array_double_tmp.
-     * @details Uses a cumulative probability approach: draws a uniform random
-     * number and walks through array_double_tmp[0..n-1], accumulating
-     * probabilities until the draw is exceeded. If no event fires, returns n
-     * (meaning "none of the above").
-     * @param n Number of probability entries in array_double_tmp to consider.
-     * @return Index in [0, n] of the sampled event (n = no event).
-     */
-    size_t sample_from_probs(size_t n);
 
-    /**
-     * @name Add Virus/Tool to the model
-     *
-     * This is done before the model has been initialized.
-     *
-     * @param v Virus to be added
-     * @param t Tool to be added
-     * @param preval Initial prevalence (initial state.) It can be
-     * specified as a proportion (between zero and one,) or an integer
-     * indicating number of individuals.
-     */
-    ///@{
-    void add_virus(Virus<TSeq> & v);
-    void add_tool(Tool<TSeq> & t);
-    void add_entity(Entity<TSeq> e);
-    void rm_virus(size_t virus_pos);
-    void rm_tool(size_t tool_pos);
-    void rm_entity(size_t entity_id);
-    ///@}
+#ifndef EPIWORLD_MODEL_BONES_HPP
+#define EPIWORLD_MODEL_BONES_HPP
 
-    /**
-     * @brief Associate agents-entities from a file
-     *
-     * The structure of the file should be two columns separated by
-     * space. The first column indexing between 0 and nagents-1, and the
-     * second column between 0 and nentities - 1.
-     *
-     * @param fn Path to the file.
-     * @param skip How many rows to skip.
-     */
-    void load_agents_entities_ties(std::string fn, int skip);
+#include <memory>
+#include <vector>
+#include <functional>
+#include <string>
+#include <map>
+// (already included include/epiworld/config.hpp)
 
-    /**
-     * @brief Associate agents-entities from data
-    */
-    void load_agents_entities_ties(
-        const std::vector<int> & agents_ids,
-        const std::vector<int> & entities_ids
-        );
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    void load_agents_entities_ties(
-        const int * agents_id,
-        const int * entities_id,
-        size_t n
-        );
+ Start of -include/epiworld/agent-bones.hpp-
 
-    /**
-     * @name Accessing population of the model
-     *
-     * @param fn std::string Filename of the edgelist file.
-     * @param skip int Number of lines to skip in `fn`.
-     * @param directed bool Whether the graph is directed or not.
-     * @param size Size of the network.
-     * @param al AdjList to read into the model.
-     */
-    ///@{
-    void agents_from_adjlist(
-        std::string fn,
-        int size,
-        int skip = 0,
-        bool directed = false
-        );
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    void agents_from_edgelist(
-        const std::vector< int > & source,
-        const std::vector< int > & target,
-        int size,
-        bool directed
-    );
 
-    void agents_from_adjlist(AdjList al);
+#ifndef EPIWORLD_PERSON_BONES_HPP
+#define EPIWORLD_PERSON_BONES_HPP
 
-    bool is_directed() const;
+template<typename TSeq>
+class Model;
 
-    std::vector< Agent<TSeq> > & get_agents(); ///< Returns a reference to the vector of agents.
+template<typename TSeq>
+class Virus;
 
-    Agent<TSeq> & get_agent(size_t i);
+template<typename TSeq>
+class Viruses;
 
-    std::vector< epiworld_fast_uint > get_agents_states() const; ///< Returns a vector with the states of the agents.
+template<typename TSeq>
+class Viruses_const;
 
-    std::vector< Viruses_const<TSeq> > get_agents_viruses() const; ///< Returns a const vector with the viruses of the agents.
+template<typename TSeq>
+class Tool;
 
-    std::vector< Viruses<TSeq> > get_agents_viruses(); ///< Returns a vector with the viruses of the agents.
 
-    std::vector< Entity<TSeq> > & get_entities();
+template<typename TSeq>
+class Queue;
 
-    Entity<TSeq> & get_entity(size_t entity_id, int * entity_pos = nullptr);
-    const Entity<TSeq> & get_entity(size_t entity_id, int * entity_pos = nullptr) const;
+template<typename TSeq>
+struct Event;
 
-    Model<TSeq> & agents_smallworld(
-        epiworld_fast_uint n = 1000,
-        epiworld_fast_uint k = 5,
-        bool d = false,
-        epiworld_double p = .01
-        );
-    void agents_empty_graph(epiworld_fast_uint n = 1000);
+template<typename TSeq>
+class Entity;
 
-    /**
-     * @brief Initialize agents using a Stochastic Block Model (SBM).
-     *
-     * Creates agents and connects them according to an SBM defined by
-     * `block_sizes` and `mixing_matrix`.
-     *
-     * @param block_sizes Number of agents per block.
-     * @param mixing_matrix Mixing matrix of size K*K; row sums give average
-     *   expected degree per group.
-     * @param row_major If `true`, matrix is row-major; otherwise column-major.
-     * @return Reference to this Model.
-     *
-     * @see rgraph_sbm
-     */
-    Model<TSeq> & agents_sbm(
-        const std::vector< size_t > & block_sizes,
-        const std::vector< double > & mixing_matrix,
-        bool row_major = true
-        );
-    ///@}
+template<typename TSeq>
+class Entities;
 
-    /**
-     * @name Initialize agents using a Bernoulli random graph
-     * @param n Number of agents.
-     * @param p Probability of tie formation.
-     * @param d Whether the graph is directed or not.
-     * @return Reference to this Model.
-     */
-    Model<TSeq> & agents_bernoulli(
-        epiworld_fast_uint n,
-        epiworld_double p,
-        bool d = false
-    );
+template<typename TSeq>
+class AgentsSample;
 
-    /**
-     * @name Functions to run the model
-     *
-     * @param seed Seed to be used for Pseudo-RNG.
-     * @param ndays Number of days (steps) of the simulation.
-     * @param fun In the case of `run_multiple`, a function that is called
-     * after each experiment.
-     *
-     */
-    ///@{
-    void update_state();
-    void mutate_virus();
-    virtual void next();
-    virtual Model<TSeq> & run(
-        epiworld_fast_uint ndays,
-        int seed = -1
-    ); ///< Runs the simulation (after initialization)
-    Model<TSeq> & run_multiple( ///< Multiple runs of the simulation
-        epiworld_fast_uint ndays,
-        epiworld_fast_uint nexperiments,
-        int seed_ = -1,
-        std::function<void(size_t,Model<TSeq>*)> fun = make_save_run<TSeq>(),
-        bool reset = true,
-        bool verbose = true,
-        int nthreads = 1
-        );
-    ///@}
+/**
+ * @brief Agent (agents)
+ * 
+ * @tparam TSeq Sequence type (should match `TSeq` across the model)
+ */
+template<typename TSeq>
+class Agent {
+    friend class Model<TSeq>;
+    friend class Virus<TSeq>;
+    friend class Tool<TSeq>;
+    friend class Queue<TSeq>;
+    friend class AgentsSample<TSeq>;
+protected:
 
-    size_t get_n_viruses() const; ///< Number of viruses in the model
-    size_t get_n_tools() const; ///< Number of tools in the model
-    epiworld_fast_uint get_ndays() const;
-    epiworld_fast_uint get_n_replicates() const;
-    size_t get_sim_id() const;
-    size_t get_n_entities() const;
-    void set_ndays(epiworld_fast_uint ndays);
-    bool get_verbose() const;
-    Model<TSeq> & verbose_off();
-    Model<TSeq> & verbose_on();
-    int today() const; ///< The current time of the model
+    size_t n_neighbors = 0u; ///< Degree (ties are stored in `Model<TSeq>::network`).
+
+    std::vector< epiworld_agent_index > entities; ///< Entity IDs (indices into Model::entities)
+
+    unsigned int state = 0u;
+    unsigned int state_prev = 0u; ///< For accounting, if need to undo a change.
+    
+    int state_last_changed = -1; ///< Last time the agent was updated.
+    int id = -1;
+    
+    VirusPtr<TSeq> virus = nullptr;
+
+    std::vector< ToolPtr<TSeq> > tools;
 
     /**
-     * @name Rewire the network preserving the degree sequence.
-     *
-     * @details This implementation assumes an undirected network,
-     * thus if {(i,j), (k,l)} -> {(i,l), (k,j)}, the reciprocal
-     * is also true, i.e., {(j,i), (l,k)} -> {(j,k), (l,i)}.
-     *
-     * @param proportion Proportion of ties to be rewired.
-     *
-     * @result A rewired version of the network.
+     * @name Cached tool effects
+     * @details `tools_effects[k]` is the product of `(1 - effect k)` across
+     * the agent's tools, valid when bit `k` of `tools_effects_fixed` is on
+     * (i.e., all the tools have a constant k-th effect; see
+     * `Tool<TSeq>::fixed_mask`). Refreshed every time the tools change, so
+     * the mixers in `Model<TSeq>` can skip calling the tools' functions.
      */
     ///@{
-    void set_rewire_fun(std::function<void(std::vector<Agent<TSeq>>*,Model<TSeq>*,epiworld_double)> fun);
-    void set_rewire_prop(epiworld_double prop);
-    epiworld_double get_rewire_prop() const;
-    void rewire();
+    epiworld_double tools_effects[4u] = {1.0, 1.0, 1.0, 1.0};
+    unsigned char tools_effects_fixed = 0x0Fu;
+    void tools_effects_update();
     ///@}
 
-    /**
-     * @brief Wrapper of `DataBase::write_data`
-     *
-     * @param fn_virus_info Filename. Information about the virus.
-     * @param fn_virus_hist Filename. History of the virus.
-     * @param fn_tool_info Filename. Information about the tool.
-     * @param fn_tool_hist Filename. History of the tool.
-     * @param fn_total_hist   Filename. Aggregated history (state)
-     * @param fn_transmission Filename. Transmission history.
-     * @param fn_transition   Filename. Markov transition history.
-     * @param fn_reproductive_number Filename. Case by case reproductive number
-     * @param fn_generation_time Filename. Generation time data.
-     * @param fn_active_cases Filename. Active cases data.
-     * @param fn_outbreak_size Filename. Outbreak size data.
-     * @param fn_hospitalizations Filename. Hospitalization data.
-     */
-    void write_data(
-        std::string fn_virus_info,
-        std::string fn_virus_hist,
-        std::string fn_tool_info,
-        std::string fn_tool_hist,
-        std::string fn_total_hist,
-        std::string fn_transmission,
-        std::string fn_transition,
-        std::string fn_reproductive_number,
-        std::string fn_generation_time,
-        std::string fn_active_cases,
-        std::string fn_outbreak_size,
-        std::string fn_hospitalizations
-        ) const;
+    void reset(); ///< Resets the agent to the initial state (no virus, no tools, no entities, state 0.)
+
+public:
+
+    Agent() = default;
+    Agent(Agent<TSeq> && p);
+    Agent(const Agent<TSeq> & p);
+    Agent<TSeq> & operator=(const Agent<TSeq> & other_agent);
+    ~Agent();
 
     /**
-     * @name Export the network data in edgelist form
-     *
-     * @param fn std::string. File name.
-     * @param source Integer vector
-     * @param target Integer vector
-     *
-     * @details When passing the source and target, the function will
-     * write the edgelist on those.
+     * @name Add/Remove Virus/Tool
+     * 
+     * Any of these is ultimately reflected at the end of the iteration.
+     * 
+     * @param tool Tool to add
+     * @param virus Virus to add
+     * @param state_new state after the change
+     * @param queue 
      */
     ///@{
-    void write_edgelist(
-        std::string fn
-        ) const;
+    void add_tool(
+        Model<TSeq> & model,
+        const Tool<TSeq> & tool,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+        );
 
-    void write_edgelist(
-        std::vector< int > & source,
-        std::vector< int > & target
-        ) const;
-    ///@}
+    void set_virus(
+        Model<TSeq> & model,
+        const Virus<TSeq> & virus,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+        );
 
-    std::map<std::string, epiworld_double> & params();
+    void add_entity(
+        Model<TSeq> & model,
+        Entity<TSeq> & entity,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+        );
 
-    /**
-     * @brief Reset the model
-     *
-     * @details Resetting the model will:
-     * - clear the database
-     * - restore the population (if `set_backup()` was called before)
-     * - re-distribute tools
-     * - re-distribute viruses
-     * - set the date to 0
-     *
-     */
-    virtual void reset();
-    const Model<TSeq> & print(bool lite = false) const;
+    void rm_tool(
+        Model<TSeq> & model,
+        epiworld_fast_uint tool_idx,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+    );
+
+    void rm_tool(
+        Model<TSeq> & model,
+        ToolPtr<TSeq> & tool,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+    );
+
+    void rm_virus(
+        Model<TSeq> & model,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+    );
+
+    void rm_entity(
+        Model<TSeq> & model,
+        epiworld_fast_uint entity_idx,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+    );
+
+    void rm_entity(
+        Model<TSeq> & model,
+        Entity<TSeq> & entity,
+        epiworld_fast_int state_new = -99,
+        epiworld_fast_int queue = -99
+    );
 
+    void rm_agent_by_virus(Model<TSeq> & model) = delete; ///< Agent removed by virus
+    ///@}
+    
     /**
-     * @name Manage state (states) in the model
-     *
-     * @details
-     *
-     * The functions `get_state` return the current values for the
-     * states included in the model. The function `set_state_function`
-     * replaces the update function associated with an existing state.
-     *
-     * @param lab `std::string` Name of the state.
-     *
-     * @return `add_state*` returns the ID (index) of the registered state.
-     * @return `set_state_function` returns a reference to the model.
-     * @return `get_state_*` returns a vector of pairs with the
-     * states and their labels.
+     * @name Get the rates (multipliers) for the agent
+     * 
+     * @param v A pointer to a virus.
+     * @return epiworld_double 
      */
     ///@{
-    epiworld_fast_int state_of(std::string_view name);
-    epiworld_fast_int add_state(std::string lab, UpdateFun<TSeq> fun = nullptr);
-    Model<TSeq> & set_state_function(epiworld_fast_uint state, UpdateFun<TSeq> fun = nullptr);
-    Model<TSeq> & set_state_function(std::string_view name, UpdateFun<TSeq> fun = nullptr);
-    const std::vector< std::string > & get_states() const;
-    size_t get_n_states() const;
-    const std::vector< UpdateFun<TSeq> > & get_state_fun() const;
-    void print_state_codes() const;
+    epiworld_double get_susceptibility_reduction(VirusPtr<TSeq> & v, Model<TSeq> & model);
+    epiworld_double get_transmission_reduction(VirusPtr<TSeq> & v, Model<TSeq> & model);
+    epiworld_double get_recovery_enhancer(VirusPtr<TSeq> & v, Model<TSeq> & model);
+    epiworld_double get_death_reduction(VirusPtr<TSeq> & v, Model<TSeq> & model);
     ///@}
 
-    /**
-     * @name Initial states
-     *
-     * @details These functions are called before the simulation starts.
-     *
-     * @param proportions_ Vector of proportions for each state.
-     * @param queue_ Vector of queue for each state.
-     */
-    virtual Model<TSeq> & initial_states(
-        std::vector< double > /*proportions_*/,
-        std::vector< int > /*queue_*/
-    ) {return *this;};
+    int get_id() const; ///< Id of the individual
 
-    /**
-     * @name Setting and accessing parameters from the model
-     *
-     * @details Tools can incorporate parameters included in the model.
-     * Internally, parameters in the tool are stored as pointers to
-     * an std::map<> of parameters in the model. Using the `epiworld_fast_uint`
-     * method directly fetches the parameters in the order these were
-     * added to the tool. Accessing parameters via the `std::string` method
-     * involves searching the parameter directly in the std::map<> member
-     * of the model (so it is not recommended.)
-     *
-     * The `par()` function members are aliases for `get_param()`.
-     *
-     * In the case of the function `read_params`, users can pass a file
-     * listing parameters to be included in the model. Each line in the
-     * file should have the following structure:
-     *
-     * ```
-     * [name of parameter 1]: [value in double]
-     * [name of parameter 2]: [value in double]
-     * ...
-     * ```
-     *
-     * The only condition for parameter names is that these do not include
-     * a colon.
-     *
-     *
-     * @param initial_val
-     * @param pname Name of the parameter to add or to fetch
-     * @param fn Path to the file containing parameters
-     * @return The current value of the parameter
-     * in the model.
-     *
+    VirusPtr<TSeq> & get_virus();
+    const VirusPtr<TSeq> & get_virus() const;
+
+    ToolPtr<TSeq> & get_tool(int i);
+    ToolPtr<TSeq> & get_tool(std::string name);
+
+    std::vector<ToolPtr<TSeq>> get_tools();
+    const std::vector<ToolPtr<TSeq>> get_tools() const;
+    size_t get_n_tools() const noexcept;
+
+    void mutate_virus();
+    void add_neighbor(
+        Agent<TSeq> & p,
+        Model<TSeq> & model,
+        bool check_source = true,
+        bool check_target = true
+        );
+
+    /**
+     * @brief Swaps neighbors between the current agent and agent `other`
+     * 
+     * @param other 
+     * @param n_this 
+     * @param n_other 
      */
-    ///@{
-    epiworld_double add_param(
-        epiworld_double initial_val, std::string pname, bool overwrite = false
+    void swap_neighbors(
+        Agent<TSeq> & other,
+        size_t n_this,
+        size_t n_other,
+        Model<TSeq> & model
     );
-    Model<TSeq> & read_params(std::string fn, bool overwrite = false);
-    epiworld_double get_param(std::string pname);
-    void set_param(std::string pname, epiworld_double val);
-    epiworld_double par(std::string pname) const;
-    ///@}
 
-    void get_elapsed(
-        std::string unit = "auto",
-        epiworld_double * last_elapsed = nullptr,
-        epiworld_double * total_elapsed = nullptr,
-        std::string * unit_abbr = nullptr,
-        bool print = true
-    ) const;
+    std::vector< Agent<TSeq> * > get_neighbors(Model<TSeq> & model);
+    AgentNeighbors<TSeq> neighbors(Model<TSeq> & model); ///< Non-allocating view of the neighbors.
+    size_t get_n_neighbors() const;
+
+    void change_state(
+        Model<TSeq> & model,
+        epiworld_fast_uint new_state,
+        epiworld_fast_int queue = 0
+        );
+
+    unsigned int get_state() const;
+    unsigned int get_state_prev() const;
+    int get_state_last_changed() const;
+
+
+    bool has_tool(epiworld_fast_uint t) const;
+    bool has_tool(std::string_view name) const;
+    bool has_tool(const Tool<TSeq> & t) const;
+    bool has_virus(epiworld_fast_uint t) const;
+    bool has_virus(std::string_view name) const;
+    bool has_virus(const Virus<TSeq> & v) const;
+    bool has_entity(epiworld_fast_uint t) const;
+    bool has_entity(std::string_view name, const Model<TSeq> & model) const;
+
+    void print(Model<TSeq> & model, bool compressed = false) const;
 
     /**
-     * @name Set the user data object
-     *
-     * @param names string vector with the names of the variables.
+     * @brief Access the j-th column of the agent
+     * 
+     * If an external array has been specified, then these two
+     * functions can be used to access additional agent's features 
+     * not included in the model.
+     * 
+     * @param j 
+     * @param model Reference to the Model
+     * @return double& 
      */
-    ///[@
-    void set_user_data(std::vector< std::string > names);
-    void add_user_data(epiworld_fast_uint j, epiworld_double x);
-    void add_user_data(std::vector< epiworld_double > x);
-    UserData<TSeq> & get_user_data();
+    ///@{
+    double & operator()(size_t j, Model<TSeq> & model);
+    double operator()(size_t j, const Model<TSeq> & model) const;
     ///@}
 
-    /**
-     * @brief Set a global action
-     *
-     * @param fun A function to be called on the prescribed date
-     * @param name Name of the action.
-     * @param date Integer indicating when the function is called (see details)
-     *
-     * @details When date is less than zero, then the function is called
-     * at the end of every day. Otherwise, the function will be called only
-     * at the end of the indicated date.
-     */
-    void add_globalevent(
-        std::function<void(Model<TSeq>*)> fun,
-        std::string name = "A global action",
-        int date = -99
-        );
+    const std::vector< epiworld_agent_index > & get_entities() const;
+
+    const Entity<TSeq> & get_entity(size_t i, const Model<TSeq> & model) const;
+    Entity<TSeq> & get_entity(size_t i, Model<TSeq> & model);
+
+    size_t get_n_entities() const;
+
+    bool operator==(const Agent<TSeq> & other) const;
+    bool operator!=(const Agent<TSeq> & other) const {return !operator==(other);};
+
+};
+
+
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/agent-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/virus-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_VIRUS_HPP
+#define EPIWORLD_VIRUS_HPP
+
+template<typename TSeq>
+class Agent;
+
+template<typename TSeq>
+class Virus;
+
+template<typename TSeq>
+class Model;
+
+/**
+ * @brief Virus
+ * 
+ * @tparam TSeq 
+ * @details
+ * Raw transmisibility of a virus should be a function of its genetic
+ * sequence. Nonetheless, transmisibility can be reduced as a result of
+ * having one or more tools to fight the virus. Because of this, transmisibility
+ * should be a function of the agent.
+ */
+template<typename TSeq>
+class Virus {
+    friend class Agent<TSeq>;
+    friend class Model<TSeq>;
+    friend class DataBase<TSeq>;
+private:
+    
+    /**
+     * @brief Fields shared by the copies of a virus
+     * @details Agents carry their own copy of the virus, but the name,
+     * states, queues, and functions are the same for every carrier, so
+     * copies share a single `Strain`. Setters detach it first
+     * (copy-on-write), so copying a virus is cheap and only viruses that are
+     * modified after the copy (e.g., by a mutation) own a new strain.
+     */
+    struct Strain {
+
+        std::string virus_name = "unknown virus";
+        epiworld_fast_int state_init    = -99; ///< Change of state when added to agent.
+        epiworld_fast_int state_post    = -99; ///< Change of state when removed from agent.
+        epiworld_fast_int state_removed = -99; ///< Change of state when agent is removed
+
+        epiworld_fast_int queue_init    = Queue<TSeq>::Everyone; ///< Change of state when added to agent.
+        epiworld_fast_int queue_post    = -Queue<TSeq>::Everyone; ///< Change of state when removed from agent.
+        epiworld_fast_int queue_removed = -Queue<TSeq>::Everyone; ///< Change of state when agent is removed
+
+        MutFun<TSeq>          mutation                 = nullptr;
+        PostRecoveryFun<TSeq> post_recovery_fun        = nullptr;
+        VirusFun<TSeq>        probability_of_infecting = nullptr;
+        VirusFun<TSeq>        probability_of_recovery  = nullptr;
+        VirusFun<TSeq>        probability_of_death     = nullptr;
+        VirusFun<TSeq>        incubation               = nullptr;
+
+        // Information about how distribution works
+        VirusToAgentFun<TSeq> dist = nullptr;
+
+    };
+
+    // Per-carrier data
+    Agent<TSeq> * agent = nullptr;
+
+    EPI_TYPENAME_TRAITS(TSeq, int) baseline_sequence = 
+        EPI_TYPENAME_TRAITS(TSeq, int)(); 
+
+    int date = -99;
+    int id   = -99;
+
+    std::shared_ptr< Strain > strain = std::make_shared< Strain >();
+    Strain & strain_mut(); ///< Strain to modify (detached if shared).
+        
+public:
+
+    #ifdef EPI_DEBUG_VIRUS
+    static std::atomic<int> counter_construct;          // Default and parameterized constructors
+    static std::atomic<int> counter_copy_construct;     // Copy constructor
+    static std::atomic<int> counter_move_construct;     // Move constructor
+    static std::atomic<int> counter_copy_assign;        // Copy assignment
+    static std::atomic<int> counter_move_assign;        // Move assignment
+    static std::atomic<int> counter_destruct;           // Destructor
+    #endif
+
+    Virus();
+
+    Virus(std::string name = "unknown virus");
+    
+    Virus(
+        std::string name,
+        epiworld_double prevalence,
+        bool as_proportion
+    );
+    
+    #ifdef EPI_DEBUG_VIRUS
+    
+    // Copy and move operations for debugging
+    Virus(const Virus<TSeq>& other);                    // Copy constructor
+    Virus(Virus<TSeq>&& other) noexcept;                // Move constructor
+    Virus<TSeq>& operator=(const Virus<TSeq>& other);   // Copy assignment
+    Virus<TSeq>& operator=(Virus<TSeq>&& other) noexcept; // Move assignment
+
+    ~Virus();
+    #endif
+    
+    void mutate(Model<TSeq> * model);
+    void set_mutation(MutFun<TSeq> fun);
+    
+    EPI_TYPENAME_TRAITS(TSeq, int) get_sequence();
+    void set_sequence(TSeq sequence);
+    
+    Agent<TSeq> * get_agent();
+    void set_agent(Agent<TSeq> * p);
+    
+    void set_date(int d);
+    int get_date() const;
+
+    void set_id(int idx);
+    int get_id() const;
+
+    /**
+     * @name Get and set the tool functions
+     * 
+     * @param v The virus over which to operate
+     * @param fun the function to be used
+     * 
+     * @return epiworld_double 
+     */
+    ///@{
+    epiworld_double get_prob_infecting(Model<TSeq> * model);
+    epiworld_double get_prob_recovery(Model<TSeq> * model);
+    epiworld_double get_prob_death(Model<TSeq> * model);
+    epiworld_double get_incubation(Model<TSeq> * model);
+    
+    void post_recovery(Model<TSeq> * model);
+    void set_post_recovery(PostRecoveryFun<TSeq> fun);
+    void set_post_immunity(epiworld_double prob);
+    void set_post_immunity(std::string param);
+
+    void set_prob_infecting_fun(VirusFun<TSeq> fun);
+    void set_prob_recovery_fun(VirusFun<TSeq> fun);
+    void set_prob_death_fun(VirusFun<TSeq> fun);
+    void set_incubation_fun(VirusFun<TSeq> fun);
+    
+    void set_prob_infecting(std::string param);
+    void set_prob_recovery(std::string param);
+    void set_prob_death(std::string param);
+    void set_incubation(std::string param);
+
+    // Deleting pointer versions to avoid mistakes
+    void set_prob_infecting(epiworld_double * prob) = delete;
+    void set_prob_recovery(epiworld_double * prob) = delete;
+    void set_prob_death(epiworld_double * prob) = delete;
+    void set_incubation(epiworld_double * prob) = delete;
+    void set_post_immunity(epiworld_double * prob) = delete;
+    
+    void set_prob_infecting(epiworld_double prob);
+    void set_prob_recovery(epiworld_double prob);
+    void set_prob_death(epiworld_double prob);
+    void set_incubation(epiworld_double prob);
+    ///@}
+
+
+    void set_name(std::string name);
+    std::string get_name() const;
+
+    /**
+     * @name Get and set the state and queue
+     * 
+     * After applied, viruses can change the state and affect
+     * the queue of agents. These function sets the default values,
+     * which are retrieved when adding or removing a virus does not
+     * specify a change in state or in queue.
+     * 
+     * @param init After the virus/tool is added to the agent.
+     * @param end After the virus/tool is removed.
+     * @param removed After the agent (Agent) is removed.
+     */
+    ///@{
+    void set_state(
+        epiworld_fast_int init,
+        epiworld_fast_int end,
+        epiworld_fast_int removed = -99
+        );
+        
+    void set_queue(
+        epiworld_fast_int init,
+        epiworld_fast_int end,
+        epiworld_fast_int removed = -99
+        );
+
+    void get_state(
+        epiworld_fast_int * init,
+        epiworld_fast_int * end,
+        epiworld_fast_int * removed = nullptr
+        ) const;
+
+    void get_queue(
+        epiworld_fast_int * init,
+        epiworld_fast_int * end,
+        epiworld_fast_int * removed = nullptr
+        ) const;
+    ///@}
+
+    bool operator==(const Virus<TSeq> & other) const;
+    bool operator!=(const Virus<TSeq> & other) const {return !operator==(other);};
+
+    void print() const;
+
+    /**
+     * @brief Get information about the prevalence of the virus
+     */
+    ///@{
+    void distribute(Model<TSeq> * model);
+    void set_distribution(VirusToAgentFun<TSeq> fun);
+    ///@}
+
+    virtual ~Virus() = default;
+    virtual std::unique_ptr<Virus<TSeq>> clone_ptr() const;
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/virus-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/viruses-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_VIRUSES_BONES_HPP
+#define EPIWORLD_VIRUSES_BONES_HPP
+
+template<typename TSeq>
+class Virus;
+
+template<typename TSeq>
+class Agent;
+
+/**
+ * @brief Set of viruses (useful for building iterators)
+ * 
+ * @tparam TSeq 
+ */
+template<typename TSeq>
+class Viruses {
+    friend class Virus<TSeq>;
+    friend class Agent<TSeq>;
+private:
+    std::vector< VirusPtr<TSeq> > * dat;
+    const epiworld_fast_uint * n_viruses;
+
+public:
+
+    Viruses() = delete;
+    Viruses(Agent<TSeq> & p) : dat(&p.viruses), n_viruses(&p.n_viruses) {};
+
+    typename std::vector< VirusPtr<TSeq> >::iterator begin();
+    typename std::vector< VirusPtr<TSeq> >::iterator end();
+
+    VirusPtr<TSeq> & operator()(size_t i);
+    VirusPtr<TSeq> & operator[](size_t i);
+
+    size_t size() const noexcept;
+
+    void print() const noexcept;
+
+};
+
+template<typename TSeq>
+inline typename std::vector< VirusPtr<TSeq> >::iterator Viruses<TSeq>::begin()
+{
+
+    if (*n_viruses == 0u)
+        return dat->end();
+    
+    return dat->begin();
+}
+
+template<typename TSeq>
+inline typename std::vector< VirusPtr<TSeq> >::iterator Viruses<TSeq>::end()
+{
+    
+    #ifdef EPI_DEBUG
+    if (dat->size() < *n_viruses)
+        throw EPI_DEBUG_ERROR(std::logic_error, "Viruses:: The end of the virus is out of range");
+    #endif 
+
+    return begin() + *n_viruses;
+}
+
+template<typename TSeq>
+inline VirusPtr<TSeq> & Viruses<TSeq>::operator()(size_t i)
+{
+
+    if (i >= *n_viruses)
+        throw std::range_error("Virus index out of range.");
+
+    return dat->operator[](i);
+
+}
+
+template<typename TSeq>
+inline VirusPtr<TSeq> & Viruses<TSeq>::operator[](size_t i)
+{
+
+    return dat->operator[](i);
+
+}
+
+template<typename TSeq>
+inline size_t Viruses<TSeq>::size() const noexcept 
+{
+    return *n_viruses;
+}
+
+template<typename TSeq>
+inline void Viruses<TSeq>::print() const noexcept
+{
+
+    if (*n_viruses == 0u)
+    {
+        printf_epiworld("List of viruses (none)\n");
+        return;
+    }
+
+    printf_epiworld("List of viruses (%i): ", *n_viruses);
+
+    // Printing the name of each virus separated by a comma
+    for (size_t i = 0u; i < *n_viruses; ++i)
+    {
+        if (i == *n_viruses - 1u)
+        {
+            printf_epiworld("%s", dat->operator[](i)->get_name().c_str());
+        } else 
+        {
+            printf_epiworld("%s, ", dat->operator[](i)->get_name().c_str());
+        }
+    }
+    
+    printf_epiworld("\n");
+
+}
+
+/**
+ * @brief Set of Viruses (const) (useful for iterators)
+ * 
+ * @tparam TSeq 
+ */
+template<typename TSeq>
+class Viruses_const {
+    friend class Virus<TSeq>;
+    friend class Agent<TSeq>;
+private:
+    const std::vector< VirusPtr<TSeq> > * dat;
+    const epiworld_fast_uint * n_viruses;
+
+public:
+
+    Viruses_const() = delete;
+    Viruses_const(const Agent<TSeq> & p) : dat(&p.viruses), n_viruses(&p.n_viruses) {};
+
+    typename std::vector< VirusPtr<TSeq> >::const_iterator begin() const;
+    typename std::vector< VirusPtr<TSeq> >::const_iterator end() const;
+
+    const VirusPtr<TSeq> & operator()(size_t i);
+    const VirusPtr<TSeq> & operator[](size_t i);
+
+    size_t size() const noexcept;
+
+    void print() const noexcept;
+
+};
+
+template<typename TSeq>
+inline typename std::vector< VirusPtr<TSeq> >::const_iterator Viruses_const<TSeq>::begin() const {
+
+    if (*n_viruses == 0u)
+        return dat->end();
+    
+    return dat->begin();
+}
+
+template<typename TSeq>
+inline typename std::vector< VirusPtr<TSeq> >::const_iterator Viruses_const<TSeq>::end() const {
+
+    #ifdef EPI_DEBUG
+    if (dat->size() < *n_viruses)
+        throw EPI_DEBUG_ERROR(std::logic_error, "Viruses_const:: The end of the virus is out of range");
+    #endif 
+    return begin() + *n_viruses;
+}
+
+template<typename TSeq>
+inline const VirusPtr<TSeq> & Viruses_const<TSeq>::operator()(size_t i)
+{
+
+    if (i >= *n_viruses)
+        throw std::range_error("Virus index out of range.");
+
+    return dat->operator[](i);
+
+}
+
+template<typename TSeq>
+inline const VirusPtr<TSeq> & Viruses_const<TSeq>::operator[](size_t i)
+{
+
+    return dat->operator[](i);
+
+}
+
+template<typename TSeq>
+inline size_t Viruses_const<TSeq>::size() const noexcept 
+{
+    return *n_viruses;
+}
+
+template<typename TSeq>
+inline void Viruses_const<TSeq>::print() const noexcept
+{
+
+    if (*n_viruses == 0u)
+    {
+        printf_epiworld("List of viruses (none)\n");
+        return;
+    }
+
+    printf_epiworld("List of viruses (%i): ", *n_viruses);
+
+    // Printing the name of each virus separated by a comma
+    for (size_t i = 0u; i < *n_viruses; ++i)
+    {
+        if (i == *n_viruses - 1u)
+        {
+            printf_epiworld("%s", dat->operator[](i)->get_name().c_str());
+        } else
+        {
+            printf_epiworld("%s, ", dat->operator[](i)->get_name().c_str());
+        }
+    }
+    
+    printf_epiworld("\n");
+
+}
+
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/viruses-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -include/epiworld/tool-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_TOOL_BONES_HPP
+#define EPIWORLD_TOOL_BONES_HPP
+
+template<typename TSeq>
+class Virus;
+
+template<typename TSeq>
+class Agent;
+
+template<typename TSeq>
+class Model;
+
+template<typename TSeq>
+class Tool;
+
+/**
+ * @brief Tools for defending the agent against the virus
+ * 
+ * @tparam TSeq Type of sequence
+ */
+template<typename TSeq> 
+class Tool {
+    friend class Agent<TSeq>;
+    friend class Model<TSeq>;
+protected:
+
+    /**
+     * @brief Fields shared by the copies of a tool
+     * @details Every agent holding the tool gets its own copy, but the name,
+     * functions, states, and queues are the same across them, so copies
+     * share a single `Definition`. Setters detach it first (copy-on-write).
+     */
+    struct Definition {
+
+        std::string tool_name;
+
+        ToolFun<TSeq> susceptibility_reduction = nullptr;
+        ToolFun<TSeq> transmission_reduction   = nullptr;
+        ToolFun<TSeq> recovery_enhancer        = nullptr;
+        ToolFun<TSeq> death_reduction          = nullptr;
+
+        ToolToAgentFun<TSeq> dist = nullptr;
+
+        epiworld_fast_int state_init = -99;
+        epiworld_fast_int state_post = -99;
+
+        epiworld_fast_int queue_init = Queue<TSeq>::NoOne; ///< Change of state when added to agent.
+        epiworld_fast_int queue_post = Queue<TSeq>::NoOne; ///< Change of state when removed from agent.
+
+        /**
+         * @brief Effects known to be constant
+         * @details Bit `k` of `fixed_mask` is on when the k-th effect
+         * (susceptibility, transmission, recovery, death) does not depend on
+         * the virus or the day, in which case its value is `fixed_value[k]`.
+         * Agents use these to cache the product of their tools' effects (see
+         * `Agent<TSeq>::tools_effects_update()`).
+         */
+        ///@{
+        unsigned char fixed_mask = 0x0Fu;
+        epiworld_double fixed_value[4u] = {
+            DEFAULT_TOOL_CONTAGION_REDUCTION,
+            DEFAULT_TOOL_TRANSMISSION_REDUCTION,
+            DEFAULT_TOOL_RECOVERY_ENHANCER,
+            DEFAULT_TOOL_DEATH_REDUCTION
+        };
+        ///@}
+
+    };
+
+    // Per-agent data
+    Agent<TSeq> * agent = nullptr;
+    int pos_in_agent        = -99; ///< Location in the agent
+
+    int date = -99;
+    int id   = -99;
+    
+    EPI_TYPENAME_TRAITS(TSeq, int) sequence = 
+        EPI_TYPENAME_TRAITS(TSeq, int)(); ///< Sequence of the tool
+
+    std::shared_ptr< Definition > def = std::make_shared< Definition >();
+    Definition & def_mut(); ///< Definition to modify (detached if shared).
+    void set_fixed_effect(size_t k, bool fixed, epiworld_double value);
+
+    void set_agent(Agent<TSeq> * p, size_t idx);
+
+public:
+    Tool();
+    Tool(std::string name = "unknown tool");
+    Tool(
+        std::string name,
+        epiworld_double prevalence,
+        bool as_proportion
+    );
+
+    virtual ~Tool() = default;
+
+    void set_sequence(TSeq d);
+    void set_sequence(std::shared_ptr<TSeq> d);
+    EPI_TYPENAME_TRAITS(TSeq, int) get_sequence();
+
+    /**
+     * @name Get and set the tool functions
+     * 
+     * @param v The virus over which to operate
+     * @param fun the function to be used
+     * 
+     * @return epiworld_double 
+     */
+    ///@{
+    virtual epiworld_double get_susceptibility_reduction(VirusPtr<TSeq> & v, Model<TSeq> * model);
+    virtual epiworld_double get_transmission_reduction(VirusPtr<TSeq> & v, Model<TSeq> * model);
+    virtual epiworld_double get_recovery_enhancer(VirusPtr<TSeq> & v, Model<TSeq> * model);
+    virtual epiworld_double get_death_reduction(VirusPtr<TSeq> & v, Model<TSeq> * model);
+    
+    virtual void set_susceptibility_reduction_fun(ToolFun<TSeq> fun);
+    virtual void set_transmission_reduction_fun(ToolFun<TSeq> fun);
+    virtual void set_recovery_enhancer_fun(ToolFun<TSeq> fun);
+    virtual void set_death_reduction_fun(ToolFun<TSeq> fun);
+
+    virtual void set_susceptibility_reduction(std::string param);
+    virtual void set_transmission_reduction(std::string param);
+    virtual void set_recovery_enhancer(std::string param);
+    virtual void set_death_reduction(std::string param);
+
+    // Deleting pointer versions to avoid mistakes
+    virtual void set_susceptibility_reduction(epiworld_double * prob) = delete;
+    virtual void set_transmission_reduction(epiworld_double * prob) = delete;
+    virtual void set_recovery_enhancer(epiworld_double * prob) = delete;
+    virtual void set_death_reduction(epiworld_double * prob) = delete;
+
+    virtual void set_susceptibility_reduction(epiworld_double prob);
+    virtual void set_transmission_reduction(epiworld_double prob);
+    virtual void set_recovery_enhancer(epiworld_double prob);
+    virtual void set_death_reduction(epiworld_double prob);
+    ///@}
+
+    void set_name(std::string name);
+    virtual std::string get_name() const;
+
+    Agent<TSeq> * get_agent();
+    int get_id() const;
+    void set_id(int id);
+    void set_date(int d);
+    int get_date() const;
+
+    void set_state(epiworld_fast_int init, epiworld_fast_int post);
+    void set_queue(epiworld_fast_int init, epiworld_fast_int post);
+    void get_state(epiworld_fast_int * init, epiworld_fast_int * post);
+    void get_queue(epiworld_fast_int * init, epiworld_fast_int * post);
+
+    bool operator==(const Tool<TSeq> & other) const;
+    bool operator!=(const Tool<TSeq> & other) const {return !operator==(other);};
+
+    void print() const;
+
+    void distribute(Model<TSeq> * model);
+    void set_distribution(ToolToAgentFun<TSeq> fun);
+
+    virtual std::unique_ptr<Tool<TSeq>> clone_ptr() const; 
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/tool-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+// (already included include/epiworld/database-bones.hpp)
+// (already included include/epiworld/queue-bones.hpp)
+// (already included include/epiworld/globalevent-bones.hpp)
+// (already included include/epiworld/contacttracing-bones.hpp)
+// (already included include/epiworld/profiler-bones.hpp)
+// (already included include/epiworld/memoryusage-bones.hpp)
+
+template<typename TSeq>
+class AgentsSample;
+
+class AdjList;
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline std::function<void(size_t,Model<TSeq>*)> make_save_run(
+    std::string fmt = "%03lu-episimulation.csv",
+    bool total_hist = true,
+    bool virus_info = false,
+    bool virus_hist = false,
+    bool tool_info = false,
+    bool tool_hist = false,
+    bool transmission = false,
+    bool transition = false,
+    bool reproductive = false,
+    bool generation = false,
+    bool active_cases = false,
+    bool outbreak_size = false,
+    bool hospitalizations = false
+    );
+
+// template<typename TSeq>
+// class VirusPtr;
+
+// template<typename TSeq>
+// class ToolPtr;
+
+template<typename TSeq>
+inline void default_update_susceptible(Agent<TSeq> * p, Model<TSeq> * m);
+
+/**
+ * @brief Core class of epiworld.
+ *
+ * The model class provides the wrapper that puts together `Agent`, `Virus`, and
+ * `Tools`.
+ *
+ * @tparam TSeq Type of sequence. In principle, users can build models in which
+ * virus and human sequence is represented as numeric vectors (if needed.)
+ */
+template<typename TSeq>
+class Model {
+    friend class Agent<TSeq>;
+    friend class AgentsSample<TSeq>;
+    friend class DataBase<TSeq>;
+    friend class Queue<TSeq>;
+
+protected:
+
+    std::string name = ""; ///< Name of the model
+
+    DataBase<TSeq> db = DataBase<TSeq>(*this);
+
+    std::vector< Agent<TSeq> > population = {};
+
+    /**
+     * @brief State of each agent, stored contiguously (by agent id)
+     * @details A structure-of-arrays copy of `Agent<TSeq>::state`, so
+     * whole-population scans (the update sweeps, the state filters of
+     * `AgentsSample`, and `get_agents_states()`) read one array instead
+     * of loading every `Agent`. It is written together with the agents'
+     * states in `events_run()`, `reset()`, and `agents_empty_graph()`.
+     */
+    std::vector< unsigned int > agents_state = {};
+
+    bool using_backup = true;
+
+    /**
+     * @name Contact network
+     *
+     * @details The network (see `Network`) is shared between copies of
+     * the model (e.g., the thread clones in `run_multiple()`) and the
+     * backup. It is only copied when modified through
+     * `get_network_mutable()` while being shared (copy-on-write), so
+     * read-only topologies are stored once regardless of the number of
+     * threads.
+     */
+    ///@{
+    std::shared_ptr< Network > network = std::make_shared< Network >();
+    std::shared_ptr< Network > network_backup = nullptr; ///< Set by `set_backup()`.
+    Network & get_network_mutable();
+    ///@}
+
+    /**
+     * @name Auxiliary variables for AgentsSample<TSeq> iterators
+     *
+     * @details These variables+objects are used by the AgentsSample<TSeq>
+     * class for building efficient iterators over agents. The idea is to
+     * reduce the memory allocation, so only during the first call of
+     * AgentsSample<TSeq>::AgentsSample(Model<TSeq>) these vectors are allocated.
+     */
+    ///@{
+    std::vector< Agent<TSeq> * > sampled_population;
+    size_t sampled_population_n = 0u;
+    std::vector< size_t > population_left;
+    size_t population_left_n = 0u;
+    ///@}
+
+    /**
+     * @name Agents features
+     *
+     * @details Optionally, a model can include an external data source
+     * pointing to agents information. The data can then be access through
+     * the `Agent::operator()` method.
+     *
+     */
+    ///@{
+    double * agents_data = nullptr;
+    size_t agents_data_ncols = 0u;
+    ///@}
+
+    bool directed = false;
+
+    std::vector< VirusPtr<TSeq> > viruses = {};
+    std::vector< ToolPtr<TSeq> > tools = {};
+
+    std::vector< Entity<TSeq> > entities = {};
+
+    std::shared_ptr< epi_xoshiro256ss > engine = std::make_shared< epi_xoshiro256ss >();
+    uint64_t rng_seed = 0u; ///< Last value passed to `seed()` (keys the per-agent streams).
+
+    /**
+     * @name Batched uniforms
+     * @details See `runif_batch_on()`.
+     */
+    ///@{
+    bool use_runif_batch = false;
+    epi_xoshiro256ss_lanes< EPI_RUNIF_LANES > engine_batch;
+    std::vector< epiworld_double > runif_buffer = {};
+    size_t runif_buffer_pos = 0u;
+    static constexpr size_t runif_batch_blocks = 64u; ///< Blocks per refill.
+    epiworld_double runif_next(); ///< Next uniform (from the buffer, if on).
+    ///@}
+
+    epiworld_double runifd_a = 0.0;
+    epiworld_double runifd_b = 1.0;
+    std::normal_distribution<>       rnormd      =
+        std::normal_distribution<>(0.0);
+    std::gamma_distribution<>        rgammad     =
+        std::gamma_distribution<>();
+    std::lognormal_distribution<>    rlognormald =
+        std::lognormal_distribution<>();
+    std::exponential_distribution<>  rexpd       =
+        std::exponential_distribution<>();
+    std::binomial_distribution<> rbinomd         =
+        std::binomial_distribution<>();
+    int rbinomd_n = 1;
+    epiworld_double rbinomd_fast_lambda = 0.0;
+    bool rbinomd_use_poisson = false;
+    std::negative_binomial_distribution<> rnbinomd =
+        std::negative_binomial_distribution<>();
+    std::geometric_distribution<> rgeomd          =
+        std::geometric_distribution<>();
+    std::poisson_distribution<> rpoissd           =
+        std::poisson_distribution<>();
+
+    std::function<void(std::vector<Agent<TSeq>>*,Model<TSeq>*,epiworld_double)> rewire_fun;
+    epiworld_double rewire_prop = 0.0;
+
+    std::map<std::string, epiworld_double > parameters;
+    std::vector< const epiworld_double * > parameters_ptrs = {}; ///< Indexed by `param_id()`.
+    void parameters_ptrs_update();
+    epiworld_fast_uint ndays = 0;
+    Progress pb;
+
+    std::vector< UpdateFun<TSeq> >    state_fun = {};                  ///< Functions to update states
+    std::vector< std::string >        states_labels = {};              ///< Labels of the states
+
+    /** Function to distribute states. Goes along with the function  */
+    std::function<void(Model<TSeq>*)> initial_states_fun = [](Model<TSeq> * /**/)
+    -> void {};
+
+    epiworld_fast_uint nstates = 0u;
+
+    bool verbose     = true;
+    int current_date = 0;
+
+    void dist_tools();
+    void dist_virus();
+    void dist_entities();
+
+    std::chrono::time_point<std::chrono::steady_clock> time_start;
+    std::chrono::time_point<std::chrono::steady_clock> time_end;
+
+    // std::chrono::milliseconds
+    std::chrono::duration<epiworld_double,std::micro> time_elapsed =
+        std::chrono::duration<epiworld_double,std::micro>::zero();
+    epiworld_fast_uint n_replicates = 0u;
+    int last_seed = 0;
+    void chrono_start();
+    void chrono_end();
+
+    Profiler profile;       ///< Last run (reset by `chrono_start()`).
+    Profiler profile_total; ///< All the runs (added by `chrono_end()`).
+
+    std::vector<GlobalEventPtr<TSeq>> globalevents;
+
+    Queue<TSeq> queue;
+    bool use_queuing   = true;
+    size_t sim_id = 0u;
+    void set_sim_id(size_t id);
+
+    /**
+     * @brief Checks the model and prepares day 0 (shared by `run()` and
+     * `run_continuous()`).
+     */
+    void run_setup(epiworld_fast_uint ndays, int seed);
+
+    /**
+     * @brief Runs `ndays` days from the current date (the loop of `run()`,
+     * also used by `resume()`).
+     */
+    void run_days(epiworld_fast_uint ndays);
+
+    /**
+     * @name Aggregated runs
+     * @details Helpers for models that can run on counts instead of
+     * agents (e.g., `ModelSIRMixing::aggregated_on()`). Since there are no
+     * agents to count, `aggregated_setup()` sets the database to the given
+     * totals (and records day 0), `aggregated_move()` records `n`
+     * transitions at once, and `aggregated_end()` closes the run as
+     * `run()` does. States flagged in `with_virus` count towards the first
+     * virus.
+     *
+     * Models turn the mode on with `aggregated_enable()`, which keeps the
+     * group sizes and releases the agents, and implement
+     * `run_aggregated()`, which `run()` calls after seeding the model.
+     * `aggregated_split()` spreads `n` cases across groups in proportion
+     * to their size, and `aggregated_escape()` is the probability that a
+     * susceptible in group `i` escapes infection from the infected `I`
+     * (by group) in a day.
+     */
+    ///@{
+    bool aggregated = false;
+    std::vector< size_t > aggregated_sizes = {};
+    std::vector< bool > aggregated_with_virus = {};
+    void aggregated_enable(std::vector< size_t > group_sizes);
+    void aggregated_disable();
+    virtual Model<TSeq> & run_aggregated(epiworld_fast_uint ndays);
+    std::vector< int > aggregated_split(epiworld_double prevalence);
+    epiworld_double aggregated_escape(
+        const ContactMatrix & contact_matrix,
+        size_t i,
+        const std::vector< int > & I,
+        epiworld_double p_transmit
+    ) const;
+    void aggregated_setup(
+        epiworld_fast_uint ndays,
+        const std::vector< int > & totals,
+        const std::vector< bool > & with_virus
+    );
+    void aggregated_move(epiworld_fast_uint from, epiworld_fast_uint to, int n);
+    void aggregated_end();
+    ///@}
+
+    std::unique_ptr<ContactTracing> contact_tracing;
+    bool use_contact_tracing = false;
+    size_t contact_tracing_max_contacts = EPI_MAX_TRACKING;
+
+    /**
+     * @brief Variables used to keep track of the events
+     * to be made regarding viruses.
+     */
+    EventBuffer<TSeq> events;
+    bool events_by_agent = false; ///< Apply the events in agent order.
+
+    /**
+     * @name Fast-forward
+     * @details See `fast_forward_on()`.
+     */
+    ///@{
+    bool fast_forward = false;
+    std::function<bool(Model<TSeq>*)> absorbing_fun = nullptr;
+    ///@}
+
+    /**
+     * @name Parallel update
+     * @details When on, `update_state()` splits the agents across threads.
+     * Events are collected in per-thread buffers (`events_threads`) and
+     * merged in agent order before calling `events_run()`. Each agent
+     * draws from its own counter-based stream (`engines_threads` are keyed
+     * by seed and simulation id, and positioned at the agent and day), so
+     * results do not depend on the number of threads.
+     */
+    ///@{
+    bool use_parallel_update = false;
+    int parallel_update_nthreads = 1;
+    bool in_parallel_update = false; ///< True while inside the parallel region.
+    std::vector< std::vector< Event<TSeq> > > events_threads = {};
+    std::vector< epi_philox4x32 > engines_threads = {};
+    void update_state_parallel();
+    epi_philox4x32 & rng_engine_thread(); ///< Engine of the current thread.
+    uint64_t rng_next(); ///< Next 64 random bits (from the thread's engine, if any).
+
+    /**
+     * @brief Draws from a (possibly stateful) distribution.
+     * @details Within a parallel update, a fresh distribution with the same
+     * parameters is used so cached values are not shared across threads.
+     */
+    template<typename TDist, typename... TArgs>
+    typename TDist::result_type rand_draw(TDist & dist, TArgs... args);
+    ///@}
+
+    /**
+     * @name Statically dispatched update
+     * @details Built-in models override `update_state_static()` to run
+     * their states through `update_state_table()`, which calls the update
+     * functions directly (not through `std::function`), so the compiler can
+     * inline them. The table is only used while `state_fun` still holds
+     * the model's own functions (see `state_fun_is()`); user-defined
+     * functions, extra states, and the parallel update go through
+     * `state_fun`.
+     */
+    ///@{
+    virtual bool update_state_static(); ///< Returns false if not available.
+
+    template<UpdateFunPtr<TSeq>... Funs>
+    bool update_state_table();
+
+    template<size_t I, UpdateFunPtr<TSeq> Fun, UpdateFunPtr<TSeq>... Funs>
+    void update_state_dispatch(Agent<TSeq> & p);
+
+    bool state_fun_is(epiworld_fast_uint state, UpdateFunPtr<TSeq> fun) const;
+    ///@}
+
+    /**
+     * @name Members of derived models in checkpoints
+     * @details `write_checkpoint()` ends by calling
+     * `write_checkpoint_derived()`, and `read_checkpoint()` calls
+     * `read_checkpoint_derived()` once the agents, viruses, and tools are
+     * restored. Built-in models write the per-agent data kept by their
+     * update functions (e.g., quarantine days) and rebuild the lists they
+     * derive from the agents' states (e.g., infected agents by group).
+     * The default writes and reads nothing.
+     */
+    ///@{
+    virtual void write_checkpoint_derived(std::ostream & out) const;
+    virtual void read_checkpoint_derived(std::istream & in);
+    void read_checkpoint_derived_keep_rng(std::istream & in); ///< Keeps the binomial distribution.
+    ///@}
+
+    /**
+     * @brief Runs jobs `0, ..., njobs - 1` (see `run_multiple()`)
+     * @details With OpenMP, each thread works on its own copy of the
+     * model (the calling thread on this one) and takes the next free job,
+     * so threads stay busy when runtimes vary. `job(i, model)` runs job
+     * `i`, and `fun(i, model)` (if any) is then called one thread at a
+     * time. If a copy ran the last job, its state is copied into this
+     * model at the end (with the members of derived models, see
+     * `write_checkpoint_derived()`), so the model always ends as the last
+     * job left it. Without OpenMP, the jobs run in order on this model.
+     * @return The number of jobs run by this model.
+     */
+    size_t run_jobs(
+        size_t njobs,
+        int nthreads,
+        std::function<void(size_t,Model<TSeq>*)> job,
+        std::function<void(size_t,Model<TSeq>*)> fun,
+        Progress & pb,
+        bool verbose
+    );
+
+    /**
+     * @brief Construct a new Event object
+     *
+     * @param agent_ Agent over which the action will be called
+     * @param virus_ Virus pointer included in the action
+     * @param tool_ Tool pointer included in the action
+     * @param entity_ Entity pointer included in the action
+     * @param new_state_ New state of the agent
+     * @param queue_ Change in the queue
+      * @param action_ Action to execute when processing the event
+     */
+    void _add_event(
+        Agent<TSeq> * agent_,
+        VirusPtr<TSeq> virus_,
+        ToolPtr<TSeq> tool_,
+        Entity<TSeq> * entity_,
+        epiworld_fast_int new_state_,
+        epiworld_fast_int queue_,
+          EventAction action_
+        );
+
+    /**
+     * @name Default event handlers
+     *
+     * These member functions implement the default behavior for each
+     * event action (add/remove virus, tool, entity, or change state).
+     */
+    ///@{
+    void _event_add_virus(Event<TSeq> & a);
+    void _event_add_tool(Event<TSeq> & a);
+    void _event_add_entity(Event<TSeq> & a);
+    void _event_rm_virus(Event<TSeq> & a);
+    void _event_rm_tool(Event<TSeq> & a);
+    void _event_rm_entity(Event<TSeq> & a);
+    void _event_change_state(Event<TSeq> & a);
+    ///@}
+
+    /**
+     * @name Tool Mixers
+     *
+     * These functions combine the effects tools have to deliver
+     * a single effect. For example, wearing a mask, been vaccinated,
+     * and the immune system combine together to jointly reduce
+     * the susceptibility for a given virus.
+     *
+     */
+    virtual epiworld_double susceptibility_reduction_mixer(
+        Agent<TSeq> * agent, VirusPtr<TSeq> & virus
+    );
+    virtual epiworld_double transmission_reduction_mixer(
+        Agent<TSeq> * agent, VirusPtr<TSeq> & virus
+    );
+    virtual epiworld_double recovery_enhancer_mixer(
+        Agent<TSeq> * agent, VirusPtr<TSeq> & virus
+    );
+    virtual epiworld_double death_reduction_mixer(
+        Agent<TSeq> * agent, VirusPtr<TSeq> & virus
+    );
+
+    /**
+     * @brief Advanced usage: Makes a copy of data and returns it as undeleted pointer
+     *
+     * @param copy
+     */
+    virtual std::unique_ptr<Model<TSeq>> clone_ptr();
+
+public:
+
+    ThreadArray<epiworld_double, 1024u * 2u> array_double_tmp;
+    ThreadArray<Virus<TSeq> *, 1024u * 2u> array_virus_tmp;
+
+    Model();
+    Model(const Model<TSeq> & m);
+    Model(Model<TSeq> && m);
+    Model<TSeq> & operator=(const Model<TSeq> & m);
+
+    virtual ~Model() {};
+
+    /**
+     * @name Set the backup object
+     * @details `backup` can be used to restore the network
+     * after a run. This can be useful if the user wishes to have
+     * individuals start with the same network from the beginning
+     * (e.g., when the network is rewired during the simulation). The
+     * rest of the agents' state is always restored by `reset()`.
+     *
+     */
+    ///@{
+    void set_backup();
+    // void restore_backup();
+    ///@}
+
+    DataBase<TSeq> & get_db();
+    const DataBase<TSeq> & get_db() const;
+    epiworld_double operator()(std::string pname);
+
+    size_t size() const;
+
+    /**
+     * @name Random number generation
+     *
+     * @param eng Random number generator
+     * @param s Seed
+     */
+    ///@{
+    void set_rand_engine(std::shared_ptr< epi_xoshiro256ss > & eng);
+    std::shared_ptr< epi_xoshiro256ss > & get_rand_endgine();
+    void seed(size_t s);
+    void set_rand_norm(epiworld_double mean, epiworld_double sd);
+    void set_rand_unif(epiworld_double a, epiworld_double b);
+    void set_rand_exp(epiworld_double lambda);
+    void set_rand_gamma(epiworld_double alpha, epiworld_double beta);
+    void set_rand_lognormal(epiworld_double mean, epiworld_double shape);
+    void set_rand_binom(int n, epiworld_double p);
+    void set_rand_nbinom(int n, epiworld_double p);
+    void set_rand_geom(epiworld_double p);
+    void set_rand_poiss(epiworld_double lambda);
+    epiworld_double rnorm();
+    epiworld_double rnorm(epiworld_double mean, epiworld_double sd);
+    epiworld_double rgamma();
+    epiworld_double rgamma(epiworld_double alpha, epiworld_double beta);
+    epiworld_double rexp();
+    epiworld_double rexp(epiworld_double lambda);
+    epiworld_double rlognormal();
+    epiworld_double rlognormal(epiworld_double mean, epiworld_double shape);
+
+    /**
+     * @brief Draw from the currently configured uniform distribution.
+     * @return A random draw from the configured uniform distribution.
+     * @details
+     * These uniform draws make use of Lemire's algorithm for fast
+     * uniform integer generation, which is both faster and more accurate than
+     * the common `std::uniform_int_distribution` approach.
+     * 
+     * 
+     * Lemire, D. (2019). Fast Random Integer Generation in an Interval.
+     * ACM Trans. Model. Comput. Simul., 29(1), 3:1-3:12.
+     * <https://doi.org/10.1145/3230636>
+     */
+    epiworld_double runif();
+    epiworld_double runif(epiworld_double a, epiworld_double b);
+    int runif_int(int a, int b);
+    uint32_t runif_index(uint32_t n);
+    /**
+     * @brief Draw from the currently configured binomial distribution.
+     * @details When `EPI_FAST_BINOM` is enabled (default), this uses
+     * `rpoiss(lambda)` with `lambda = n * p` after `set_rand_binom(n, p)` in the
+     * rare-event regime `p <= 0.01` and `n * p * p <= 0.1`. Define
+     * `EPI_NO_FAST_BINOM` before including epiworld to disable this behavior.
+     * @return A random draw from the configured binomial distribution, or from
+     * its Poisson approximation when the fast path is active.
+     */
+    int rbinom();
+    /**
+     * @brief Draw from a binomial distribution with parameters `n` and `p`.
+     * @details When `EPI_FAST_BINOM` is enabled (default), this uses
+     * `rpoiss(lambda)` with `lambda = n * p` in the rare-event regime
+     * `p <= 0.01` and `n * p * p <= 0.1`. This preserves the mean and is often
+     * substantially faster in practice while remaining very accurate in that
+     * region. Define `EPI_NO_FAST_BINOM` before including epiworld to disable
+     * this behavior and force the exact binomial draw.
+     * @param n Number of trials.
+     * @param p Success probability.
+     * @return A random draw from the binomial distribution, or from its
+     * Poisson approximation when the fast path is active.
+     */
+    int rbinom(int n, epiworld_double p);
+    int rnbinom();
+    int rnbinom(int n, epiworld_double p);
+    int rgeom();
+    int rgeom(epiworld_double p);
+    int rpoiss();
+    int rpoiss(epiworld_double lambda);
+    ///@}
+
+    /**
+     * @brief Sample from a set of probabilities stored in array_double_tmp.
+     * @details Uses a cumulative probability approach: draws a uniform random
+     * number and walks through array_double_tmp[0..n-1], accumulating
+     * probabilities until the draw is exceeded. If no event fires, returns n
+     * (meaning "none of the above").
+     * @param n Number of probability entries in array_double_tmp to consider.
+     * @return Index in [0, n] of the sampled event (n = no event).
+     */
+    size_t sample_from_probs(size_t n);
+
+    /**
+     * @name Add Virus/Tool to the model
+     *
+     * This is done before the model has been initialized.
+     *
+     * @param v Virus to be added
+     * @param t Tool to be added
+     * @param preval Initial prevalence (initial state.) It can be
+     * specified as a proportion (between zero and one,) or an integer
+     * indicating number of individuals.
+     */
+    ///@{
+    void add_virus(Virus<TSeq> & v);
+    void add_tool(Tool<TSeq> & t);
+    void add_entity(Entity<TSeq> e);
+    void rm_virus(size_t virus_pos);
+    void rm_tool(size_t tool_pos);
+    void rm_entity(size_t entity_id);
+    ///@}
+
+    /**
+     * @brief Associate agents-entities from a file
+     *
+     * The structure of the file should be two columns separated by
+     * space. The first column indexing between 0 and nagents-1, and the
+     * second column between 0 and nentities - 1.
+     *
+     * @param fn Path to the file.
+     * @param skip How many rows to skip.
+     */
+    void load_agents_entities_ties(std::string fn, int skip);
+
+    /**
+     * @brief Associate agents-entities from data
+    */
+    void load_agents_entities_ties(
+        const std::vector<int> & agents_ids,
+        const std::vector<int> & entities_ids
+        );
+
+    void load_agents_entities_ties(
+        const int * agents_id,
+        const int * entities_id,
+        size_t n
+        );
+
+    /**
+     * @name Accessing population of the model
+     *
+     * @param fn std::string Filename of the edgelist file.
+     * @param skip int Number of lines to skip in `fn`.
+     * @param directed bool Whether the graph is directed or not.
+     * @param size Size of the network.
+     * @param al AdjList to read into the model.
+     */
+    ///@{
+    void agents_from_adjlist(
+        std::string fn,
+        int size,
+        int skip = 0,
+        bool directed = false
+        );
+
+    void agents_from_edgelist(
+        const std::vector< int > & source,
+        const std::vector< int > & target,
+        int size,
+        bool directed
+    );
+
+    void agents_from_adjlist(AdjList al);
+
+    bool is_directed() const;
+
+    std::vector< Agent<TSeq> > & get_agents(); ///< Returns a reference to the vector of agents.
+
+    const Network & get_network() const; ///< Returns the contact network.
+
+    Agent<TSeq> & get_agent(size_t i);
+
+    std::vector< epiworld_fast_uint > get_agents_states() const; ///< Returns a vector with the states of the agents.
+
+    std::vector< Viruses_const<TSeq> > get_agents_viruses() const; ///< Returns a const vector with the viruses of the agents.
+
+    std::vector< Viruses<TSeq> > get_agents_viruses(); ///< Returns a vector with the viruses of the agents.
+
+    std::vector< Entity<TSeq> > & get_entities();
+
+    Entity<TSeq> & get_entity(size_t entity_id, int * entity_pos = nullptr);
+    const Entity<TSeq> & get_entity(size_t entity_id, int * entity_pos = nullptr) const;
+
+    Model<TSeq> & agents_smallworld(
+        epiworld_fast_uint n = 1000,
+        epiworld_fast_uint k = 5,
+        bool d = false,
+        epiworld_double p = .01
+        );
+    void agents_empty_graph(epiworld_fast_uint n = 1000);
+
+    /**
+     * @brief Initialize agents using a Stochastic Block Model (SBM).
+     *
+     * Creates agents and connects them according to an SBM defined by
+     * `block_sizes` and `mixing_matrix`.
+     *
+     * @param block_sizes Number of agents per block.
+     * @param mixing_matrix Mixing matrix of size K*K; row sums give average
+     *   expected degree per group.
+     * @param row_major If `true`, matrix is row-major; otherwise column-major.
+     * @return Reference to this Model.
+     *
+     * @see rgraph_sbm
+     */
+    Model<TSeq> & agents_sbm(
+        const std::vector< size_t > & block_sizes,
+        const std::vector< double > & mixing_matrix,
+        bool row_major = true
+        );
+    ///@}
+
+    /**
+     * @name Initialize agents using a Bernoulli random graph
+     * @param n Number of agents.
+     * @param p Probability of tie formation.
+     * @param d Whether the graph is directed or not.
+     * @return Reference to this Model.
+     */
+    Model<TSeq> & agents_bernoulli(
+        epiworld_fast_uint n,
+        epiworld_double p,
+        bool d = false
+    );
+
+    /**
+     * @name Functions to run the model
+     *
+     * @param seed Seed to be used for Pseudo-RNG.
+     * @param ndays Number of days (steps) of the simulation.
+     * @param fun In the case of `run_multiple`, a function that is called
+     * after each experiment.
+     *
+     */
+    ///@{
+    void update_state();
+    void mutate_virus();
+    virtual void next();
+    virtual Model<TSeq> & run(
+        epiworld_fast_uint ndays,
+        int seed = -1
+    ); ///< Runs the simulation (after initialization)
+    bool is_aggregated() const; ///< Runs on counts (see `run_aggregated()`)
+    Model<TSeq> & run_multiple( ///< Multiple runs of the simulation
+        epiworld_fast_uint ndays,
+        epiworld_fast_uint nexperiments,
+        int seed_ = -1,
+        std::function<void(size_t,Model<TSeq>*)> fun = make_save_run<TSeq>(),
+        bool reset = true,
+        bool verbose = true,
+        int nthreads = 1
+        );
+    ///@}
+
+    /**
+     * @brief Runs the simulation in continuous time (next-reaction method)
+     *
+     * @details Instead of visiting every active agent each day, each agent
+     * has a single pending event (infection if susceptible, recovery or
+     * death if infected) scheduled in an indexed priority queue. The daily
+     * probabilities of the virus and tools are turned into rates,
+     * \f$\lambda = -\log(1 - p)\f$, so an agent that does not interact
+     * with anyone keeps the same daily probabilities as in `run()`. After
+     * each event, only the agent and its neighbors are rescheduled, so the
+     * cost is proportional to the number of events rather than to the
+     * number of days times active agents.
+     *
+     * The database is recorded at day boundaries, where the global events,
+     * rewiring, and mutations also run (as in `run()`). Rates are assumed
+     * to be constant between events; they are all recomputed after a day
+     * boundary only if the model has global events, rewiring, or mutating
+     * viruses.
+     *
+     * Only models whose states use `default_update_susceptible()`,
+     * `default_update_exposed()`, or no update function are supported
+     * (e.g., SIR, SIS, SIRD, and SISD over a network).
+     *
+     * @param ndays Number of days of the simulation.
+     * @param seed Seed to be used for Pseudo-RNG.
+     * @throws std::logic_error If a state uses a different update function.
+     */
+    Model<TSeq> & run_continuous(
+        epiworld_fast_uint ndays,
+        int seed = -1
+    );
+
+    /**
+     * @name Checkpoints
+     *
+     * @details `write_checkpoint()` saves the state of the model (e.g.,
+     * after `run()`) to a versioned binary file: the date, parameters, and
+     * RNG state (including the distributions' cached draws), the agents'
+     * states, viruses, tools, and entities, the network, the queue, the
+     * global events' days, and the database (history, transmissions, and
+     * user data). `read_checkpoint()` restores it, and `resume()` continues
+     * the simulation, so the following days are the same as if the
+     * original model had kept running.
+     *
+     * Functions cannot be stored, so the checkpoint must be read by a
+     * model built by the same code (same states, viruses, tools, entities,
+     * global events, and number of agents). Viruses and tools are rebuilt
+     * from the ones in the model (mutated viruses from their ancestor
+     * in the model), keeping each carrier's id, date, and sequence, so
+     * tools created during the simulation (e.g., by
+     * `Virus::set_post_immunity()`) cannot be restored.
+     * Members added by derived models are only included if the model
+     * overrides `write_checkpoint_derived()` and `read_checkpoint_derived()`
+     * (as the built-in models do).
+     *
+     * @param fn Filename.
+     * @param ndays Number of days to add to the simulation.
+     * @throws std::runtime_error If the file cannot be opened or read.
+     * @throws std::logic_error If the checkpoint doesn't match the model.
+     */
+    ///@{
+    void write_checkpoint(std::string fn) const;
+    void write_checkpoint(std::ostream & out) const;
+    void read_checkpoint(std::string fn);
+    void read_checkpoint(std::istream & in);
+    Model<TSeq> & resume(epiworld_fast_uint ndays);
+    ///@}
+
+    /**
+     * @brief Runs scenarios that share a burn-in period
+     *
+     * @details The model runs the first `burnin` days once, and the result
+     * is kept as an in-memory checkpoint (see `write_checkpoint()`). Then,
+     * each of the `scenarios.size()` scenarios is run `nreplicates` times
+     * from that checkpoint until day `ndays`: the parameters listed in the
+     * scenario are set (see `set_param()`), the model is seeded with the
+     * fork's own seed, and the simulation continues with `resume()`. The
+     * database of each fork has the full history (burn-in included).
+     *
+     * Forks are numbered `scenario * nreplicates + replicate`; the number
+     * is passed to `fun` and used as the simulation id. As in
+     * `run_multiple()`, seeds are bound to the fork number, so the results
+     * don't depend on the number of threads, and the model ends with the
+     * state of the last fork.
+     *
+     * @param ndays Number of days of the simulation (burn-in included).
+     * @param burnin Number of days shared by all the forks.
+     * @param scenarios Parameters to set in each scenario (an empty map
+     * runs the model as is).
+     * @param nreplicates Number of replicates of each scenario.
+     * @param seed Seed to be used for Pseudo-RNG.
+     * @param fun Function called after each fork.
+     * @param verbose When `true`, shows a progress bar.
+     * @param nthreads Number of threads (with OpenMP).
+     */
+    Model<TSeq> & run_scenarios(
+        epiworld_fast_uint ndays,
+        epiworld_fast_uint burnin,
+        const std::vector< std::map< std::string, epiworld_double > > & scenarios,
+        epiworld_fast_uint nreplicates,
+        int seed = -1,
+        std::function<void(size_t,Model<TSeq>*)> fun = make_save_run<TSeq>(),
+        bool verbose = true,
+        int nthreads = 1
+    );
+
+    size_t get_n_viruses() const; ///< Number of viruses in the model
+    size_t get_n_tools() const; ///< Number of tools in the model
+    epiworld_fast_uint get_ndays() const;
+    epiworld_fast_uint get_n_replicates() const;
+    size_t get_sim_id() const;
+    size_t get_n_entities() const;
+    void set_ndays(epiworld_fast_uint ndays);
+    bool get_verbose() const;
+    Model<TSeq> & verbose_off();
+    Model<TSeq> & verbose_on();
+    int today() const; ///< The current time of the model
+
+    /**
+     * @name Rewire the network preserving the degree sequence.
+     *
+     * @details This implementation assumes an undirected network,
+     * thus if {(i,j), (k,l)} -> {(i,l), (k,j)}, the reciprocal
+     * is also true, i.e., {(j,i), (l,k)} -> {(j,k), (l,i)}.
+     *
+     * @param proportion Proportion of ties to be rewired.
+     *
+     * @result A rewired version of the network.
+     */
+    ///@{
+    void set_rewire_fun(std::function<void(std::vector<Agent<TSeq>>*,Model<TSeq>*,epiworld_double)> fun);
+    void set_rewire_prop(epiworld_double prop);
+    epiworld_double get_rewire_prop() const;
+    void rewire();
+    ///@}
+
+    /**
+     * @brief Wrapper of `DataBase::write_data`
+     *
+     * @param fn_virus_info Filename. Information about the virus.
+     * @param fn_virus_hist Filename. History of the virus.
+     * @param fn_tool_info Filename. Information about the tool.
+     * @param fn_tool_hist Filename. History of the tool.
+     * @param fn_total_hist   Filename. Aggregated history (state)
+     * @param fn_transmission Filename. Transmission history.
+     * @param fn_transition   Filename. Markov transition history.
+     * @param fn_reproductive_number Filename. Case by case reproductive number
+     * @param fn_generation_time Filename. Generation time data.
+     * @param fn_active_cases Filename. Active cases data.
+     * @param fn_outbreak_size Filename. Outbreak size data.
+     * @param fn_hospitalizations Filename. Hospitalization data.
+     */
+    void write_data(
+        std::string fn_virus_info,
+        std::string fn_virus_hist,
+        std::string fn_tool_info,
+        std::string fn_tool_hist,
+        std::string fn_total_hist,
+        std::string fn_transmission,
+        std::string fn_transition,
+        std::string fn_reproductive_number,
+        std::string fn_generation_time,
+        std::string fn_active_cases,
+        std::string fn_outbreak_size,
+        std::string fn_hospitalizations
+        ) const;
+
+    /**
+     * @name Export the network data in edgelist form
+     *
+     * @param fn std::string. File name.
+     * @param source Integer vector
+     * @param target Integer vector
+     *
+     * @details When passing the source and target, the function will
+     * write the edgelist on those.
+     */
+    ///@{
+    void write_edgelist(
+        std::string fn
+        ) const;
+
+    void write_edgelist(
+        std::vector< int > & source,
+        std::vector< int > & target
+        ) const;
+    ///@}
+
+    std::map<std::string, epiworld_double> & params();
+
+    /**
+     * @brief Reset the model
+     *
+     * @details Resetting the model will:
+     * - clear the database
+     * - reset the agents' state, viruses, and tools (in place)
+     * - restore the network (if `set_backup()` was called before and
+     *   the network was rewired)
+     * - re-distribute tools
+     * - re-distribute viruses
+     * - set the date to 0
+     *
+     */
+    virtual void reset();
+    const Model<TSeq> & print(bool lite = false) const;
+
+    /**
+     * @name Manage state (states) in the model
+     *
+     * @details
+     *
+     * The functions `get_state` return the current values for the
+     * states included in the model. The function `set_state_function`
+     * replaces the update function associated with an existing state.
+     *
+     * @param lab `std::string` Name of the state.
+     *
+     * @return `add_state*` returns the ID (index) of the registered state.
+     * @return `set_state_function` returns a reference to the model.
+     * @return `get_state_*` returns a vector of pairs with the
+     * states and their labels.
+     */
+    ///@{
+    epiworld_fast_int state_of(std::string_view name);
+    epiworld_fast_int add_state(std::string lab, UpdateFun<TSeq> fun = nullptr);
+    Model<TSeq> & set_state_function(epiworld_fast_uint state, UpdateFun<TSeq> fun = nullptr);
+    Model<TSeq> & set_state_function(std::string_view name, UpdateFun<TSeq> fun = nullptr);
+    const std::vector< std::string > & get_states() const;
+    size_t get_n_states() const;
+    const std::vector< UpdateFun<TSeq> > & get_state_fun() const;
+    void print_state_codes() const;
+    ///@}
+
+    /**
+     * @name Initial states
+     *
+     * @details These functions are called before the simulation starts.
+     *
+     * @param proportions_ Vector of proportions for each state.
+     * @param queue_ Vector of queue for each state.
+     */
+    virtual Model<TSeq> & initial_states(
+        std::vector< double > /*proportions_*/,
+        std::vector< int > /*queue_*/
+    ) {return *this;};
+
+    /**
+     * @name Setting and accessing parameters from the model
+     *
+     * @details Tools can incorporate parameters included in the model.
+     * Internally, parameters in the tool are stored as pointers to
+     * an std::map<> of parameters in the model. Using the `epiworld_fast_uint`
+     * method directly fetches the parameters in the order these were
+     * added to the tool. Accessing parameters via the `std::string` method
+     * involves searching the parameter directly in the std::map<> member
+     * of the model (so it is not recommended.)
+     *
+     * The `par()` function members are aliases for `get_param()`.
+     *
+     * Update functions called for every agent should use parameter ids
+     * instead of names. `param_id()` maps a name to an id that is the same
+     * across models (so it can be resolved once, e.g., in a `static`
+     * variable), and `par(id)` is then a single load. The `std::map<>`
+     * returned by `params()` is still the storage, so values modified
+     * through it are seen by `par(id)`. Parameters added through it are
+     * bound to their ids the next time `params()` is called or the model
+     * runs (until then, `par(id)` searches them by name). Parameters
+     * should not be erased from it.
+     *
+     * In the case of the function `read_params`, users can pass a file
+     * listing parameters to be included in the model. Each line in the
+     * file should have the following structure:
+     *
+     * ```
+     * [name of parameter 1]: [value in double]
+     * [name of parameter 2]: [value in double]
+     * ...
+     * ```
+     *
+     * The only condition for parameter names is that these do not include
+     * a colon.
+     *
+     *
+     * @param initial_val
+     * @param pname Name of the parameter to add or to fetch
+     * @param fn Path to the file containing parameters
+     * @return The current value of the parameter
+     * in the model.
+     *
+     */
+    ///@{
+    epiworld_double add_param(
+        epiworld_double initial_val, std::string pname, bool overwrite = false
+    );
+    Model<TSeq> & read_params(std::string fn, bool overwrite = false);
+    epiworld_double get_param(const std::string & pname);
+    void set_param(const std::string & pname, epiworld_double val);
+    epiworld_double par(const std::string & pname) const;
+    epiworld_double par(size_t id) const;
+    static size_t param_id(const std::string & pname);
+    static const std::string & param_name(size_t id);
+    ///@}
+
+    void get_elapsed(
+        std::string unit = "auto",
+        epiworld_double * last_elapsed = nullptr,
+        epiworld_double * total_elapsed = nullptr,
+        std::string * unit_abbr = nullptr,
+        bool print = true
+    ) const;
+
+    /**
+     * @name Profiling
+     * @details Time per phase and counters (agents visited, update
+     * functions called, events by type, and random draws) of the last run
+     * and of all the runs of the model, including the ones made by the
+     * threads of `run_multiple()` and `run_scenarios()`. Only collected
+     * when compiled with `EPI_PROFILE` (see `Profiler`).
+     */
+    ///@{
+    const Profiler & get_profile() const; ///< Profile of the last run.
+    const Profiler & get_profile_total() const; ///< Profile of all the runs.
+    ///@}
+
+    /**
+     * @name Memory usage
+     * @details `memory_usage()` measures the memory held by the model now
+     * (see `MemoryUsage` for what is counted). With `nthreads > 1`, it
+     * adds the clones that `run_multiple()` would make with that many
+     * threads.
+     *
+     * `estimate_memory_usage()` predicts the usage of a model before
+     * building it, after a run of `ndays`. The estimate is an upper bound
+     * for the outbreak: it assumes every agent carries a virus at some
+     * point and is infected once (the transmission records). Entities,
+     * events and contact tracing are not included. Since history vectors
+     * grow geometrically, their capacity (and what `memory_usage()`
+     * reports) can be up to twice the estimate.
+     *
+     * @param n Number of agents.
+     * @param mean_degree Average number of neighbors per agent.
+     * @param nstates Number of states.
+     * @param ndays Number of days.
+     * @param nviruses, ntools Number of viruses and tools (variants
+     * included).
+     * @param nthreads Threads passed to `run_multiple()`.
+     */
+    ///@{
+    MemoryUsage memory_usage(int nthreads = 1) const;
+    static MemoryUsage estimate_memory_usage(
+        size_t n,
+        epiworld_double mean_degree,
+        size_t nstates,
+        size_t ndays,
+        size_t nviruses = 1u,
+        size_t ntools = 0u,
+        int nthreads = 1
+    );
+    ///@}
+
+    /**
+     * @name Set the user data object
+     *
+     * @param names string vector with the names of the variables.
+     */
+    ///[@
+    void set_user_data(std::vector< std::string > names);
+    void add_user_data(epiworld_fast_uint j, epiworld_double x);
+    void add_user_data(std::vector< epiworld_double > x);
+    UserData<TSeq> & get_user_data();
+    ///@}
+
+    /**
+     * @brief Set a global action
+     *
+     * @param fun A function to be called on the prescribed date
+     * @param name Name of the action.
+     * @param date Integer indicating when the function is called (see details)
+     *
+     * @details When date is less than zero, then the function is called
+     * at the end of every day. Otherwise, the function will be called only
+     * at the end of the indicated date.
+     */
+    void add_globalevent(
+        std::function<void(Model<TSeq>*)> fun,
+        std::string name = "A global action",
+        int date = -99
+        );
+
+    void add_globalevent(
+        GlobalEvent<TSeq> & action
+    );
+
+    GlobalEvent<TSeq> & get_globalevent(std::string name); ///< Retrieve a global action by name
+    GlobalEvent<TSeq> & get_globalevent(size_t i); ///< Retrieve a global action by index
+
+    void rm_globalevent(std::string name); ///< Remove a global action by name
+    void rm_globalevent(size_t i); ///< Remove a global action by index
+
+    void run_globalevents();
+
+    void clear_state_set();
+
+    /**
+     * @name Queuing system
+     * @details When queueing is on, the model will keep track of which agents
+     * are either in risk of exposure or exposed. This then is used at each
+     * step to act only on the aforementioned agents.
+     *
+     */
+    ////@{
+    void queuing_on(); ///< Activates the queuing system (default.)
+    Model<TSeq> & queuing_off(); ///< Deactivates the queuing system.
+    bool is_queuing_on() const; ///< Query if the queuing system is on.
+    Queue<TSeq> & get_queue(); ///< Retrieve the `Queue` object.
+    ///@}
+
+    /**
+     * @name Contact tracing
+     * @details When contact tracing is on, the model will track contacts
+     * between agents. Users must actively record contacts in their update
+     * functions by calling `get_contact_tracing().add_contact(...)`.
+     * Contact tracing is off by default.
+     *
+     * @param max_contacts Maximum number of contacts to track per agent
+     * (default: EPI_MAX_TRACKING). Only used when turning tracing on.
+     */
+    ///@{
+    Model<TSeq> & contact_tracing_on(size_t max_contacts = EPI_MAX_TRACKING); ///< Activates contact tracing.
+    Model<TSeq> & contact_tracing_off(); ///< Deactivates contact tracing.
+    bool is_contact_tracing_on() const; ///< Query if contact tracing is on.
+    ContactTracing & get_contact_tracing(); ///< Retrieve the `ContactTracing` object.
+    ///@}
+
+    /**
+     * @name Order of the events
+     * @details By default, `events_run()` applies the events of the day in
+     * the order in which they were added. When on, events are applied
+     * sorted by agent id (each agent's events keep their relative order),
+     * which walks the population sequentially. Counts and states are the
+     * same either way, but records kept in order of occurrence (e.g., the
+     * transmissions) may be listed in a different order.
+     */
+    ///@{
+    Model<TSeq> & events_by_agent_on(); ///< Applies the events in agent order.
+    Model<TSeq> & events_by_agent_off(); ///< Applies the events in insertion order (default.)
+    bool is_events_by_agent_on() const; ///< Query if the events are applied in agent order.
+    ///@}
+
+    /**
+     * @name Fast-forward after extinction
+     * @details When on, `run()` (and `resume()`) check after each day
+     * whether the model reached an absorbing state, i.e., nothing can change
+     * anymore. If so, the remaining days only call `next()`, which records
+     * the (unchanged) counts in the database, skipping the update of the
+     * agents, global events, rewiring, and mutation. The history is the
+     * same as in a full run; only the random numbers left undrawn differ.
+     *
+     * By default (`fun = nullptr`), `is_absorbing()` is `true` when no agent
+     * has a virus, no global event is left to run (events without a day
+     * run every day), and agents are only in states without an update
+     * function or with `default_update_susceptible()`. Models with other
+     * update functions can pass their own detector.
+     *
+     * @param fun Function returning `true` if the model can no longer change.
+     */
+    ///@{
+    Model<TSeq> & fast_forward_on(std::function<bool(Model<TSeq>*)> fun = nullptr); ///< Activates the fast-forward.
+    Model<TSeq> & fast_forward_off(); ///< Deactivates the fast-forward (default.)
+    bool is_fast_forward_on() const; ///< Query if the fast-forward is on.
+    bool is_absorbing(); ///< Query if the model reached an absorbing state.
+    ///@}
+
+    /**
+     * @name Batched uniforms
+     * @details When on, `runif()` takes its numbers from a buffer filled
+     * in blocks by `EPI_RUNIF_LANES` interleaved xoshiro256** generators
+     * (`epi_xoshiro256ss_lanes`), instead of drawing them one at a time from
+     * the model's engine. This speeds up models drawing many uniforms (e.g.,
+     * the contact sampling of the mixing models).
+     *
+     * The batched stream is seeded by `seed()` and is separate from the
+     * engine used by the other distributions. Results are reproducible
+     * for a given seed and number of lanes, but differ from those obtained
+     * with the option off. Within a parallel update, `runif()` still draws
+     * from the per-agent streams.
+     */
+    ///@{
+    Model<TSeq> & runif_batch_on(); ///< Activates the batched uniforms.
+    Model<TSeq> & runif_batch_off(); ///< Deactivates the batched uniforms (default.)
+    bool is_runif_batch_on() const; ///< Query if the batched uniforms are on.
+    ///@}
+
+    /**
+     * @name Parallel update of the agents' states
+     * @details When on, `update_state()` runs the update functions of the
+     * agents in parallel (OpenMP) and the resulting events are applied in
+     * the same order as in a serial run. Each agent draws random numbers
+     * from its own Philox stream, keyed by the seed and the simulation id
+     * (`rng_seed ^ sim_id * 0x9e3779b97f4a7c15`) and positioned at the
+     * agent and day, so the results are identical for any number of
+     * threads (but differ from those obtained with the option off).
+     *
+     * Update functions must only read the model and register changes
+     * through events (e.g., `Agent::change_state()`, `Agent::set_virus()`).
+     * Functions writing to model members (including contact tracing) are
+     * not safe to run in parallel.
+     *
+     * @param nthreads Number of threads to use.
+     */
+    ///@{
+    Model<TSeq> & parallel_update_on(int nthreads = 2); ///< Activates the parallel update.
+    Model<TSeq> & parallel_update_off(); ///< Deactivates the parallel update (default.)
+    bool is_parallel_update_on() const; ///< Query if the parallel update is on.
+    ///@}
+
+    const std::vector< VirusPtr<TSeq> > & get_viruses() const;
+    const std::vector< ToolPtr<TSeq> > & get_tools() const;
+    Virus<TSeq> & get_virus(size_t id);
+    Virus<TSeq> & get_virus(std::string_view name);
+    Tool<TSeq> & get_tool(size_t id);
+    Tool<TSeq> & get_tool(std::string_view name);
+
+    bool has_virus(std::string_view name) const;
+    bool has_tool(std::string_view name) const;
+
+    /**
+     * @brief Set the agents data object
+     *
+     * @details The data should be an array with the data stored in a
+     * column major order, i.e., by column.
+     *
+     * @param data_ Pointer to the first element of an array of size
+     * `size() * ncols_`.
+     * @param ncols_ Number of features included in the data.
+     *
+     */
+    void set_agents_data(double * data_, size_t ncols_);
+    double * get_agents_data();
+    size_t get_agents_data_ncols() const;
+
+    /**
+     * @brief Set the name object
+     *
+     * @param name
+     */
+    void set_name(std::string name);
+    std::string get_name() const;
+
+    bool operator==(const Model<TSeq> & other) const;
+    bool operator!=(const Model<TSeq> & other) const {return !operator==(other);};
+
+    /**
+     * @brief Executes the stored action
+     *
+     * @param model_ Model over which it will be executed.
+     */
+    void events_run();
+
+    /**
+     * @brief Draws a mermaid diagram of the model.
+     * @param model The model to draw.
+     * @param fn_output The name of the file to write the diagram.
+     * If empty, the diagram will be printed to the standard output.
+     * @param self Whether to allow self-transitions.
+     */
+    void draw(
+        DiagramType diagram_type = DiagramType::Mermaid,
+        const std::string & fn_output = "",
+        bool self = false
+    );
+
+    /**
+     * @brief Record a hospitalization event for an agent.
+     * 
+     * @param agent Reference to the agent being hospitalized.
+     * 
+     * @details
+     * This is a wrapper for `DataBase::record_hospitalization()`.
+     * For each hospitalization, the method records:
+     * - The current date from the model
+     * - The virus ID from the agent's virus
+     * - For each tool the agent has, a separate record with weight = 1/N
+     *   where N is the number of tools
+     * - If the agent has no tools, a single record with tool_id = -1 and
+     *   weight = 1.0
+     */
+    void record_hospitalization(Agent<TSeq> & agent);
+
+    /**
+     * @brief Get the full time series of hospitalization data.
+     * 
+     * @param date Output vector for dates.
+     * @param virus_id Output vector for virus IDs.
+     * @param tool_id Output vector for tool IDs.
+     * @param count Output vector for counts (number of hospitalized individuals).
+     * @param weight Output vector for summed weights (fractional contribution
+     *   based on tool distribution).
+     * 
+     * @details
+     * This is a wrapper for `DataBase::get_hospitalizations()`.
+     * Returns the full time series of hospitalization data. For each unique 
+     * (virus_id, tool_id) combination observed, returns an entry for every 
+     * day from 0 to ndays-1.
+     * 
+     * The `count` vector contains the actual number of individuals hospitalized 
+     * for that (date, virus_id, tool_id) combination. This is useful for 
+     * answering questions like "how many total people were hospitalized?" 
+     * regardless of their tools.
+     * 
+     * The `weight` vector contains fractional contributions: if an agent has N 
+     * tools, each tool gets weight = 1/N. Summing weights across all tool_ids 
+     * for a given date and virus_id gives the total number of hospitalizations.
+     */
+    void get_hospitalizations(
+        std::vector<int> & date,
+        std::vector<int> & virus_id,
+        std::vector<int> & tool_id,
+        std::vector<int> & count,
+        std::vector<double> & weight
+    ) const;
+
+
+};
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/model-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/model-rand-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODEL_RAND_MEAT_HPP
+#define EPIWORLD_MODEL_RAND_MEAT_HPP
+
+// (already included include/epiworld/rng-utils.hpp)
+// (already included include/epiworld/model-bones.hpp)
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_gamma(epiworld_double alpha, epiworld_double beta)
+{
+    rgammad = std::gamma_distribution<>(alpha,beta);
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_norm(epiworld_double mean, epiworld_double sd)
+{
+    rnormd  = std::normal_distribution<>(mean, sd);
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_unif(epiworld_double a, epiworld_double b)
+{
+    runifd_a = a;
+    runifd_b = b;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_lognormal(epiworld_double mean, epiworld_double shape)
+{
+    rlognormald  = std::lognormal_distribution<>(mean, shape);
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_exp(epiworld_double lambda)
+{
+    rexpd  = std::exponential_distribution<>(lambda);
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_binom(int n, epiworld_double p)
+{
+    rbinomd  = std::binomial_distribution<>(n, p);
+    rbinomd_n = n;
+#ifdef EPI_FAST_BINOM
+    rbinomd_fast_lambda = static_cast<epiworld_double>(n) * p;
+    rbinomd_use_poisson =
+        (p <= static_cast<epiworld_double>(0.01)) &&
+        (static_cast<epiworld_double>(n) * p * p <= static_cast<epiworld_double>(0.1));
+#else
+    rbinomd_fast_lambda = 0.0;
+    rbinomd_use_poisson = false;
+#endif
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_nbinom(int n, epiworld_double p)
+{
+    rnbinomd  = std::negative_binomial_distribution<>(n, p);
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_geom(epiworld_double p)
+{
+    rgeomd  = std::geometric_distribution<>(p);
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_poiss(epiworld_double lambda)
+{
+    rpoissd  = std::poisson_distribution<>(lambda);
+}
+
+template<typename TSeq>
+inline std::shared_ptr< epi_xoshiro256ss > & Model<TSeq>::get_rand_endgine()
+{
+    return engine;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_rand_engine(std::shared_ptr< epi_xoshiro256ss > & eng)
+{
+    engine = eng;
+}
+
+template<typename TSeq>
+inline epi_philox4x32 & Model<TSeq>::rng_engine_thread()
+{
+    #ifdef _OPENMP
+    return engines_threads[omp_get_thread_num()];
+    #else
+    return engines_threads[0u];
+    #endif
+}
+
+template<typename TSeq>
+inline uint64_t Model<TSeq>::rng_next()
+{
+
+    EPI_PROFILE_ADD(profile, RngDraws, 1u)
+
+    if (in_parallel_update)
+        return rng_engine_thread()();
+
+    return (*engine)();
+
+}
+
+template<typename TSeq>
+template<typename TDist, typename... TArgs>
+inline typename TDist::result_type Model<TSeq>::rand_draw(
+    TDist & dist,
+    TArgs... args
+)
+{
+
+    EPI_PROFILE_ADD(profile, RngDraws, 1u)
+
+    if (in_parallel_update)
+    {
+        TDist dist_thread(dist.param());
+        return dist_thread(rng_engine_thread(), args...);
+    }
+
+    return dist(*engine, args...);
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::runif_next()
+{
+
+    if (in_parallel_update)
+        return runif_epi(rng_engine_thread());
+
+    if (!use_runif_batch)
+        return runif_epi(*engine);
+
+    if (runif_buffer_pos == runif_buffer.size())
+    {
+        runif_buffer.resize(runif_batch_blocks * EPI_RUNIF_LANES);
+        engine_batch.fill_unif(runif_buffer.data(), runif_batch_blocks);
+        runif_buffer_pos = 0u;
+    }
+
+    return runif_buffer[runif_buffer_pos++];
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::runif() {
+    // CHECK_INIT()
+    EPI_PROFILE_ADD(profile, RngDraws, 1u)
+    return runif_next() * (runifd_b - runifd_a) + runifd_a;
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::runif_int(int a, int b) {
+    // CHECK_INIT()
+    return a + runif_index(static_cast<uint32_t>(b - a + 1));
+}
+
+template<typename TSeq>
+inline uint32_t Model<TSeq>::runif_index(uint32_t n) {
+
+    // If asking for a 0-range, return 0 to prevent division by zero in the bias check
+    if (n == 0) return 0;
+
+    // Grab 32 perfectly uniform random bits directly from xoshiro256ss
+    uint32_t x = static_cast<uint32_t>(rng_next());
+    
+    // Multiply by the bound N to get a 64-bit result
+    uint64_t m = static_cast<uint64_t>(x) * static_cast<uint64_t>(n);
+    
+    // The fractional part (lower 32 bits)
+    uint32_t l = static_cast<uint32_t>(m);
+    
+    // Unbiased rejection sampling for the rare edge case
+    if (l < n) {
+        uint32_t t = -n % n; // Two's complement trick to get (2^32 - n) % n
+        while (l < t) {
+            x = static_cast<uint32_t>(rng_next());
+            m = static_cast<uint64_t>(x) * static_cast<uint64_t>(n);
+            l = static_cast<uint32_t>(m);
+        }
+    }
+    
+    // The integer part (upper 32 bits) is our unbiased scaled random index
+    return static_cast<uint32_t>(m >> 32);
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::runif(epiworld_double a, epiworld_double b) {
+    // CHECK_INIT()
+    EPI_PROFILE_ADD(profile, RngDraws, 1u)
+    return runif_next() * (b - a) + a;
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rnorm() {
+    // CHECK_INIT()
+    return rand_draw(rnormd);
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rnorm(epiworld_double mean, epiworld_double sd) {
+    // CHECK_INIT()
+    return rand_draw(rnormd) * sd + mean;
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rgamma() {
+    return rand_draw(rgammad);
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rgamma(epiworld_double alpha, epiworld_double beta) {
+
+    return rand_draw(
+        rgammad,
+        std::gamma_distribution<>::param_type(alpha, beta)
+    );
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rexp() {
+    return rand_draw(rexpd);
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rexp(epiworld_double lambda) {
+
+    return rand_draw(
+        rexpd,
+        std::exponential_distribution<>::param_type(lambda)
+    );
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rlognormal() {
+    return rand_draw(rlognormald);
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::rlognormal(epiworld_double mean, epiworld_double shape) {
+
+    return rand_draw(
+        rlognormald,
+        std::lognormal_distribution<>::param_type(mean, shape)
+    );
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rbinom() {
+#ifdef EPI_FAST_BINOM
+    if (rbinomd_use_poisson)
+    {
+        int res = rpoiss(rbinomd_fast_lambda);
+        return std::min(res, rbinomd_n);
+    }
+#endif
+    return rand_draw(rbinomd);
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rbinom(int n, epiworld_double p) {
+
+    if (n == 0 || p == 0.0)
+        return 0;
+
+#ifdef EPI_FAST_BINOM
+    if (
+        (p <= static_cast<epiworld_double>(0.01)) &&
+        (static_cast<epiworld_double>(n) * p * p <= static_cast<epiworld_double>(0.1))
+    )
+    {
+        int res = rpoiss(static_cast<epiworld_double>(n) * p);
+        return std::min(res, n);
+    }
+#endif
+
+    return rand_draw(
+        rbinomd,
+        std::binomial_distribution<>::param_type(n, p)
+    );
+
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rnbinom() {
+    return rand_draw(rnbinomd);
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rnbinom(int n, epiworld_double p) {
+
+    return rand_draw(
+        rnbinomd,
+        std::negative_binomial_distribution<>::param_type(n, p)
+    );
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rgeom() {
+    return rand_draw(rgeomd);
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rgeom(epiworld_double p) {
+
+    return rand_draw(
+        rgeomd,
+        std::geometric_distribution<>::param_type(p)
+    );
+
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rpoiss() {
+    return rand_draw(rpoissd);
+}
+
+template<typename TSeq>
+inline int Model<TSeq>::rpoiss(epiworld_double lambda) {
+
+    return rand_draw(
+        rpoissd,
+        std::poisson_distribution<>::param_type(lambda)
+    );
+
+}
+
+template<typename TSeq>
+inline size_t Model<TSeq>::sample_from_probs(size_t n) {
+
+    epiworld_double p_total = runif();
+    size_t ans;
+    for (ans = 0u; ans < n; ++ans)
+    {
+        if (p_total < array_double_tmp[ans])
+            break;
+        array_double_tmp[ans + 1] += array_double_tmp[ans];
+    }
+    return ans;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::seed(size_t s) {
+    this->rng_seed = static_cast< uint64_t >(s);
+    this->engine->seed(s);
+
+    // The batched stream is keyed apart from the engine, so their
+    // sequences do not coincide
+    this->engine_batch.seed(
+        static_cast< uint64_t >(s) ^ 0x9e3779b97f4a7c15ULL
+    );
+    this->runif_buffer.clear();
+    this->runif_buffer_pos = 0u;
+
+    // Some distributions keep draws for the next call (e.g., the normal
+    // makes two at a time), which would make the sequence depend on what
+    // was drawn before seeding
+    this->rnormd.reset();
+    this->rgammad.reset();
+    this->rlognormald.reset();
+    this->rexpd.reset();
+    this->rbinomd.reset();
+    this->rnbinomd.reset();
+    this->rgeomd.reset();
+    this->rpoissd.reset();
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/model-rand-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ Start of -./include/epiworld/model-meat.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODEL_MEAT_HPP
+#define EPIWORLD_MODEL_MEAT_HPP
+
+#include <vector>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <map>
+#include <unordered_map>
+// (already included include/epiworld/config.hpp)
+// (already included include/epiworld/userdata-bones.hpp)
+// (already included include/epiworld/adjlist-bones.hpp)
+// (already included include/epiworld/model-bones.hpp)
+// (already included include/epiworld/virus-bones.hpp)
+// (already included include/epiworld/agent-bones.hpp)
+// (already included include/epiworld/tool-bones.hpp)
+// (already included include/epiworld/rng-utils.hpp)
+// (already included include/epiworld/modeldiagram-bones.hpp)
+
+/**
+ * @brief Function factory for saving model runs
+ *
+ * @details This function is the default behavior of the `run_multiple`
+ * member of `Model<TSeq>`. By default only the total history (
+ * case counts by unit of time.)
+ *
+ * @tparam TSeq
+ * @param fmt
+ * @param total_hist
+ * @param virus_info
+ * @param virus_hist
+ * @param tool_info
+ * @param tool_hist
+ * @param transmission
+ * @param transition
+ * @return std::function<void(size_t,Model<TSeq>*)>
+ */
+template<typename TSeq>
+inline std::function<void(size_t,Model<TSeq>*)> make_save_run(
+    std::string fmt,
+    bool total_hist,
+    bool virus_info,
+    bool virus_hist,
+    bool tool_info,
+    bool tool_hist,
+    bool transmission,
+    bool transition,
+    bool reproductive,
+    bool generation,
+    bool active_cases,
+    bool outbreak_size,
+    bool hospitalizations
+    )
+{
+
+    // Counting number of %
+    int n_fmt = 0;
+    for (auto & f : fmt)
+        if (f == '%')
+            n_fmt++;
+
+    if (n_fmt != 1)
+        throw std::logic_error("The -fmt- argument must have only one \"%\" symbol.");
+
+    // Listting things to save
+    std::vector< bool > what_to_save = {
+        virus_info,
+        virus_hist,
+        tool_info,
+        tool_hist,
+        total_hist,
+        transmission,
+        transition,
+        reproductive,
+        generation,
+        active_cases,
+        outbreak_size,
+        hospitalizations
+    };
+
+    std::function<void(size_t,Model<TSeq>*)> saver = [fmt,what_to_save](
+        size_t niter, Model<TSeq> * m
+    ) -> void {
+
+        auto set_saver = [fmt,niter](
+            bool condition,
+            std::string suffix
+        ) -> std::string
+        {
+            if (condition)
+            {
+                std::string var = fmt + suffix;
+                char buff[1024u];
+                snprintf(buff, sizeof(buff), var.c_str(), niter);
+                return std::string(buff);
+            }
+            return std::string("");
+        };
+
+        auto virus_info = set_saver(what_to_save[0u], "_virus_info.csv");
+        auto virus_hist = set_saver(what_to_save[1u], "_virus_hist.csv");
+        auto tool_info = set_saver(what_to_save[2u], "_tool_info.csv");
+        auto tool_hist = set_saver(what_to_save[3u], "_tool_hist.csv");
+        auto total_hist = set_saver(what_to_save[4u], "_total_hist.csv");
+        auto transmission = set_saver(what_to_save[5u], "_transmission.csv");
+        auto transition = set_saver(what_to_save[6u], "_transition.csv");
+        auto reproductive = set_saver(what_to_save[7u], "_reproductive.csv");
+        auto generation = set_saver(what_to_save[8u], "_generation.csv");
+        auto active_cases = set_saver(what_to_save[9u], "_active_cases.csv");
+        auto outbreak_size = set_saver(what_to_save[10u], "_outbreak_size.csv");
+        auto hospitalizations = set_saver(what_to_save[11u], "_hospitalizations.csv");
+
+        m->write_data(
+            virus_info,
+            virus_hist,
+            tool_info,
+            tool_hist,
+            total_hist,
+            transmission,
+            transition,
+            reproductive,
+            generation,
+            active_cases,
+            outbreak_size,
+            hospitalizations
+        );
+
+    };
+
+    return saver;
+}
+
+
+template<typename TSeq>
+inline void Model<TSeq>::_add_event(
+    Agent<TSeq> * agent_,
+    VirusPtr<TSeq> virus_,
+    ToolPtr<TSeq> tool_,
+    Entity<TSeq> * entity_,
+    epiworld_fast_int new_state_,
+    epiworld_fast_int queue_,
+    EventAction action_
+) {
+
+    // Within a parallel update, events go to the thread's buffer and
+    // are merged (in agent order) afterwards.
+    if (in_parallel_update)
+    {
+        #ifdef _OPENMP
+        auto & buffer = events_threads[omp_get_thread_num()];
+        #else
+        auto & buffer = events_threads[0u];
+        #endif
+
+        buffer.emplace_back(
+            agent_, virus_, tool_, entity_, new_state_, queue_, action_
+        );
+
+        return;
+    }
+
+    events.push(
+        agent_, std::move(virus_), std::move(tool_), entity_,
+        new_state_, queue_, action_
+    );
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::events_run()
+{
+
+    EPI_PROFILE_SCOPE(profile, EventsRun)
+
+    // State counters are accumulated and applied once
+    db.batch_on();
+
+    VirusPtr<TSeq> virus_null = nullptr;
+    ToolPtr<TSeq> tool_null = nullptr;
+    Event<TSeq> a(
+        nullptr, virus_null, tool_null, nullptr, -99, -99,
+        EventAction::ChangeState
+    );
+
+    try
+    {
+
+        // Events added while running (e.g., by post-recovery functions) are
+        // applied after the current ones
+        size_t nevents_tmp = 0u;
+        while (nevents_tmp < events.size())
+        {
+
+            const size_t nevents_end = events.size();
+            const std::vector< size_t > * order = events_by_agent ?
+                &events.sort_by_agent(nevents_tmp, nevents_end) : nullptr;
+
+            for (size_t k = nevents_tmp; k < nevents_end; ++k)
+            {
+
+                events.get(
+                    order ? (*order)[k - nevents_tmp] : k,
+                    a
+                );
+                Agent<TSeq> * p  = a.agent;
+
+                EPI_PROFILE_EVENT(profile, a.action)
+
+                #ifdef EPI_DEBUG
+                if (a.new_state >= static_cast<epiworld_fast_int>(nstates))
+                {
+                    throw std::range_error(
+                        "The proposed state " + std::to_string(a.new_state) + " is out of range. " +
+                        "The model currently has " + std::to_string(nstates - 1) + " states.");
+
+                }
+                else if ((a.new_state != -99) && (a.new_state < 0))
+                {
+                    throw std::range_error(
+                        "The proposed state " + std::to_string(a.new_state) + " is out of range. " +
+                        "The state cannot be negative.");
+                }
+                #endif
+
+                // Undoing the change in the transition matrix
+                if (
+                    (a.new_state != -99) &&
+                    (p->state_last_changed == today()) &&
+                    (static_cast<int>(p->state) != a.new_state)
+                )
+                {
+                    // Undoing state change in the transition matrix
+                    // The previous state is already recorded
+                    db.update_state(p->state_prev, p->state, true);
+
+                } else if (p->state_last_changed != today())
+                    p->state_prev = p->state; // Recording the previous state
+
+                switch (a.action)
+                {
+                case EventAction::AddVirus:
+                    _event_add_virus(a);
+                    break;
+                case EventAction::AddTool:
+                    _event_add_tool(a);
+                    break;
+                case EventAction::AddEntity:
+                    _event_add_entity(a);
+                    break;
+                case EventAction::RemoveVirus:
+                    _event_rm_virus(a);
+                    break;
+                case EventAction::RemoveTool:
+                    _event_rm_tool(a);
+                    break;
+                case EventAction::RemoveEntity:
+                    _event_rm_entity(a);
+                    break;
+                case EventAction::ChangeState:
+                    _event_change_state(a);
+                    break;
+                default:
+                    throw std::logic_error("The requested event action is not supported.");
+                }
+
+                if (a.new_state != -99)
+                {
+                    p->state = a.new_state;
+                    agents_state[static_cast< size_t >(p->id)] = p->state;
+                }
+
+                // Registering that the last change was today
+                p->state_last_changed = today();
+
+
+                #ifdef EPI_DEBUG
+                if (static_cast<int>(p->state) >= static_cast<int>(nstates))
+                        throw std::range_error(
+                            "The new state " + std::to_string(p->state) + " is out of range. " +
+                            "The model currently has " + std::to_string(nstates - 1) + " states.");
+                #endif
+
+                // Updating queue
+                if (use_queuing && a.queue != -99)
+                {
+
+                    if (a.queue == Queue<TSeq>::Everyone)
+                        queue += p;
+                    else if (a.queue == -Queue<TSeq>::Everyone)
+                        queue -= p;
+                    else if (a.queue == Queue<TSeq>::OnlySelf)
+                        queue[p->get_id()]++;
+                    else if (a.queue == -Queue<TSeq>::OnlySelf)
+                        queue[p->get_id()]--;
+                    else if (a.queue != Queue<TSeq>::NoOne)
+                        throw std::logic_error(
+                            "The proposed queue change is not valid. Queue values can be {-2, -1, 0, 1, 2}."
+                            );
+
+                }
+
+            }
+
+            nevents_tmp = nevents_end;
+
+        }
+
+    } catch (...) {
+
+        // Dropping the rest of the day's events (their payloads may have
+        // been moved out already)
+        db.batch_off();
+        events.clear();
+        throw;
+
+    }
+
+    db.batch_off();
+
+    // Go back to square 1
+    events.clear();
+
+    return;
+
+}
+
+/**
+ * @name Default function for combining susceptibility_reduction levels
+ *
+ * @tparam TSeq
+ * @param pt
+ * @return epiworld_double
+ */
+///@{
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::susceptibility_reduction_mixer(
+    Agent<TSeq>* p,
+    VirusPtr<TSeq> & v
+)
+{
+    if (p->tools_effects_fixed & (1u << 0u))
+        return 1.0 - p->tools_effects[0u];
+
+    epiworld_double total = 1.0;
+    for (auto & tool : p->tools)
+        total *= (1.0 - tool->get_susceptibility_reduction(v, this));
+
+    return 1.0 - total;
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::transmission_reduction_mixer(
+    Agent<TSeq>* p,
+    VirusPtr<TSeq> & v
+)
+{
+    if (p->tools_effects_fixed & (1u << 1u))
+        return 1.0 - p->tools_effects[1u];
+
+    epiworld_double total = 1.0;
+    for (auto & tool : p->tools)
+        total *= (1.0 - tool->get_transmission_reduction(v, this));
+
+    return (1.0 - total);
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::recovery_enhancer_mixer(
+    Agent<TSeq>* p,
+    VirusPtr<TSeq> & v
+)
+{
+    if (p->tools_effects_fixed & (1u << 2u))
+        return 1.0 - p->tools_effects[2u];
+
+    epiworld_double total = 1.0;
+    for (auto & tool : p->tools)
+        total *= (1.0 - tool->get_recovery_enhancer(v, this));
+
+    return 1.0 - total;
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::death_reduction_mixer(
+    Agent<TSeq>* p,
+    VirusPtr<TSeq> & v
+) {
+
+    if (p->tools_effects_fixed & (1u << 3u))
+        return 1.0 - p->tools_effects[3u];
+
+    epiworld_double total = 1.0;
+    for (auto & tool : p->tools)
+    {
+        total *= (1.0 - tool->get_death_reduction(v, this));
+    }
+
+    return 1.0 - total;
+
+}
+///@}
+
+template<typename TSeq>
+inline std::unique_ptr<Model<TSeq>> Model<TSeq>::clone_ptr()
+{
+    // Everything is copied
+    auto ptr = std::make_unique<Model<TSeq>>(*this);
+
+    #ifdef EPI_DEBUG
+    if (*this != *ptr)
+        throw std::logic_error("Model::clone_ptr The copies of the model don't match.");
+    #endif
+
+    return ptr;
+}
+
+template<typename TSeq>
+inline Model<TSeq>::Model()
+{
+    db.model = this;
+    db.user_data = this;
+    if (use_queuing)
+        queue.model = this;
+}
+
+template<typename TSeq>
+inline Model<TSeq>::Model(const Model<TSeq> & model) :
+    name(model.name),
+    db(model.db),
+    population(model.population),
+    agents_state(model.agents_state),
+    network(model.network),
+    network_backup(model.network_backup),
+    directed(model.directed),
+    viruses(),
+    tools(),
+    entities(model.entities),
+    use_runif_batch(model.use_runif_batch),
+    rewire_fun(model.rewire_fun),
+    rewire_prop(model.rewire_prop),
+    parameters(model.parameters),
+    ndays(model.ndays),
+    pb(model.pb),
+    state_fun(model.state_fun),
+    states_labels(model.states_labels),
+    initial_states_fun(model.initial_states_fun),
+    nstates(model.nstates),
+    verbose(model.verbose),
+    current_date(model.current_date),
+    globalevents(),
+    queue(model.queue),
+    use_queuing(model.use_queuing),
+    sim_id(model.sim_id),
+    aggregated(model.aggregated),
+    aggregated_sizes(model.aggregated_sizes),
+    contact_tracing(
+        model.contact_tracing
+            ? std::make_unique<ContactTracing>(*model.contact_tracing)
+            : nullptr
+    ),
+    use_contact_tracing(model.use_contact_tracing),
+    contact_tracing_max_contacts(model.contact_tracing_max_contacts),
+    events_by_agent(model.events_by_agent),
+    fast_forward(model.fast_forward),
+    absorbing_fun(model.absorbing_fun),
+    use_parallel_update(model.use_parallel_update),
+    parallel_update_nthreads(model.parallel_update_nthreads)
+{
+
+    // Pointing to the right place. This needs
+    // to be done afterwards since the state zero is set as a function
+    // of the population.
+    db.model = this;
+    db.user_data.model = this;
+
+    if (use_queuing)
+        queue.model = this;
+
+    parameters_ptrs_update();
+
+    agents_data = model.agents_data;
+    agents_data_ncols = model.agents_data_ncols;
+
+    rbinomd = model.rbinomd;
+    rbinomd_n = model.rbinomd_n;
+    rbinomd_fast_lambda = model.rbinomd_fast_lambda;
+    rbinomd_use_poisson = model.rbinomd_use_poisson;
+
+    // Deep-copy model-level objects so clones can run independently in parallel.
+    viruses.reserve(model.viruses.size());
+    for (const auto & v : model.viruses)
+        viruses.emplace_back(std::shared_ptr<Virus<TSeq>>(v->clone_ptr()));
+
+    tools.reserve(model.tools.size());
+    for (const auto & t : model.tools)
+        tools.emplace_back(std::shared_ptr<Tool<TSeq>>(t->clone_ptr()));
+
+    globalevents.reserve(model.globalevents.size());
+    for (const auto & ge : model.globalevents)
+        globalevents.emplace_back(std::shared_ptr<GlobalEvent<TSeq>>(ge->clone_ptr()));
+
+    // Entity-agent relationships now use size_t IDs, so they copy
+    // correctly without any rebinding needed.
+
+}
+
+template<typename TSeq>
+inline Model<TSeq>::Model(Model<TSeq> && model) :
+    name(std::move(model.name)),
+    db(std::move(model.db)),
+    population(std::move(model.population)),
+    agents_state(std::move(model.agents_state)),
+    network(std::move(model.network)),
+    network_backup(std::move(model.network_backup)),
+    agents_data(std::move(model.agents_data)),
+    agents_data_ncols(std::move(model.agents_data_ncols)),
+    directed(std::move(model.directed)),
+    // Virus
+    viruses(std::move(model.viruses)),
+    // Tools
+    tools(std::move(model.tools)),
+    // Entities
+    entities(std::move(model.entities)),
+    // Pseudo-RNG
+    engine(std::move(model.engine)),
+    rng_seed(model.rng_seed),
+    use_runif_batch(model.use_runif_batch),
+    engine_batch(model.engine_batch),
+    runif_buffer(std::move(model.runif_buffer)),
+    runif_buffer_pos(model.runif_buffer_pos),
+    runifd_a(model.runifd_a),
+    runifd_b(model.runifd_b),
+    rnormd(std::move(model.rnormd)),
+    rgammad(std::move(model.rgammad)),
+    rlognormald(std::move(model.rlognormald)),
+    rexpd(std::move(model.rexpd)),
+    rbinomd(std::move(model.rbinomd)),
+    rbinomd_n(model.rbinomd_n),
+    rbinomd_fast_lambda(model.rbinomd_fast_lambda),
+    rbinomd_use_poisson(model.rbinomd_use_poisson),
+    // Rewiring
+    rewire_fun(std::move(model.rewire_fun)),
+    rewire_prop(std::move(model.rewire_prop)),
+    parameters(std::move(model.parameters)),
+    // Others
+    ndays(model.ndays),
+    pb(std::move(model.pb)),
+    state_fun(std::move(model.state_fun)),
+    states_labels(std::move(model.states_labels)),
+    initial_states_fun(std::move(model.initial_states_fun)),
+    nstates(model.nstates),
+    verbose(model.verbose),
+    current_date(std::move(model.current_date)),
+    globalevents(std::move(model.globalevents)),
+    queue(std::move(model.queue)),
+    use_queuing(model.use_queuing),
+    sim_id(model.sim_id),
+    aggregated(model.aggregated),
+    aggregated_sizes(model.aggregated_sizes),
+    contact_tracing(std::move(model.contact_tracing)),
+    use_contact_tracing(model.use_contact_tracing),
+    contact_tracing_max_contacts(model.contact_tracing_max_contacts),
+    events_by_agent(model.events_by_agent),
+    fast_forward(model.fast_forward),
+    absorbing_fun(model.absorbing_fun),
+    use_parallel_update(model.use_parallel_update),
+    parallel_update_nthreads(model.parallel_update_nthreads)
+{
+
+    db.model = this;
+    db.user_data.model = this;
+
+    if (use_queuing)
+        queue.model = this;
+
+    parameters_ptrs_update();
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::operator=(const Model<TSeq> & m)
+{
+    if (this == &m)
+        return *this;
+
+    name = m.name;
+
+    population        = m.population;
+    agents_state      = m.agents_state;
+    network           = m.network;
+    network_backup    = m.network_backup;
+
+    db = m.db;
+    db.model = this;
+    db.user_data.model = this;
+
+    directed = m.directed;
+
+    viruses.clear();
+    viruses.reserve(m.viruses.size());
+    for (const auto & v : m.viruses)
+        viruses.emplace_back(std::shared_ptr<Virus<TSeq>>(v->clone_ptr()));
+
+    tools.clear();
+    tools.reserve(m.tools.size());
+    for (const auto & t : m.tools)
+        tools.emplace_back(std::shared_ptr<Tool<TSeq>>(t->clone_ptr()));
+
+    entities        = m.entities;
+
+    rewire_fun  = m.rewire_fun;
+    rewire_prop = m.rewire_prop;
+
+    parameters = m.parameters;
+    parameters_ptrs_update();
+    ndays      = m.ndays;
+    pb         = m.pb;
+
+    state_fun    = m.state_fun;
+    states_labels = m.states_labels;
+    initial_states_fun = m.initial_states_fun;
+    nstates       = m.nstates;
+
+    verbose     = m.verbose;
+
+    current_date = m.current_date;
+
+    globalevents.clear();
+    globalevents.reserve(m.globalevents.size());
+    for (const auto & ge : m.globalevents)
+        globalevents.emplace_back(std::shared_ptr<GlobalEvent<TSeq>>(ge->clone_ptr()));
+
+    queue = m.queue;
+    use_queuing = m.use_queuing;
+
+    aggregated = m.aggregated;
+    aggregated_sizes = m.aggregated_sizes;
+
+    contact_tracing = m.contact_tracing
+        ? std::make_unique<ContactTracing>(*m.contact_tracing)
+        : nullptr;
+    use_contact_tracing = m.use_contact_tracing;
+    contact_tracing_max_contacts = m.contact_tracing_max_contacts;
+
+    events_by_agent = m.events_by_agent;
+    fast_forward = m.fast_forward;
+    absorbing_fun = m.absorbing_fun;
+    use_parallel_update = m.use_parallel_update;
+    parallel_update_nthreads = m.parallel_update_nthreads;
+    use_runif_batch = m.use_runif_batch;
+
+    agents_data = m.agents_data;
+    agents_data_ncols = m.agents_data_ncols;
+
+    // The random numbers continue where those of m are
+    *engine = *m.engine;
+    rng_seed = m.rng_seed;
+    last_seed = m.last_seed;
+    engine_batch = m.engine_batch;
+    runif_buffer = m.runif_buffer;
+    runif_buffer_pos = m.runif_buffer_pos;
+    runifd_a = m.runifd_a;
+    runifd_b = m.runifd_b;
+    rnormd = m.rnormd;
+    rgammad = m.rgammad;
+    rlognormald = m.rlognormald;
+    rexpd = m.rexpd;
+    rbinomd = m.rbinomd;
+    rbinomd_n = m.rbinomd_n;
+    rbinomd_fast_lambda = m.rbinomd_fast_lambda;
+    rbinomd_use_poisson = m.rbinomd_use_poisson;
+    rnbinomd = m.rnbinomd;
+    rgeomd = m.rgeomd;
+    rpoissd = m.rpoissd;
+
+    // Figure out the queuing
+    if (use_queuing)
+        queue.model = this;
+
+    sim_id = m.sim_id;
+    // Entity-agent relationships now use size_t IDs, so they copy
+    // correctly without any rebinding needed.
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline DataBase<TSeq> & Model<TSeq>::get_db()
+{
+    return db;
+}
+
+template<typename TSeq>
+inline const DataBase<TSeq> & Model<TSeq>::get_db() const
+{
+    return db;
+}
+
+
+template<typename TSeq>
+inline std::vector<Agent<TSeq>> & Model<TSeq>::get_agents()
+{
+    return population;
+}
+
+template<typename TSeq>
+inline const Network & Model<TSeq>::get_network() const
+{
+    return *network;
+}
+
+template<typename TSeq>
+inline Network & Model<TSeq>::get_network_mutable()
+{
+
+    // Shared with a clone or the backup, so we need our own copy
+    if (network.use_count() > 1)
+        network = std::make_shared< Network >(*network);
+
+    return *network;
+
+}
+
+template<typename TSeq>
+inline Agent<TSeq> & Model<TSeq>::get_agent(size_t i)
+{
+    return population[i];
+}
+
+template<typename TSeq>
+inline std::vector< epiworld_fast_uint > Model<TSeq>::get_agents_states() const
+{
+    return std::vector< epiworld_fast_uint >(
+        agents_state.begin(), agents_state.end()
+    );
+}
+
+template<typename TSeq>
+inline std::vector< Viruses_const<TSeq> > Model<TSeq>::get_agents_viruses() const
+{
+
+    std::vector< Viruses_const<TSeq> > viruses(population.size());
+    for (size_t i = 0u; i < population.size(); ++i)
+        viruses[i] = population[i].get_virus();
+
+    return viruses;
+
+}
+
+// Same as before, but the non const version
+template<typename TSeq>
+inline std::vector< Viruses<TSeq> > Model<TSeq>::get_agents_viruses()
+{
+
+    std::vector< Viruses<TSeq> > viruses(population.size());
+    for (size_t i = 0u; i < population.size(); ++i)
+        viruses[i] = population[i].get_virus();
+
+    return viruses;
+
+}
+
+template<typename TSeq>
+inline std::vector<Entity<TSeq>> & Model<TSeq>::get_entities()
+{
+    return entities;
+}
+
+template<typename TSeq>
+inline Entity<TSeq> & Model<TSeq>::get_entity(size_t i, int * entity_pos)
+{
+
+    for (size_t j = 0u; j < entities.size(); ++j)
+        if (entities[j].get_id() == static_cast<int>(i))
+        {
+
+            if (entity_pos)
+                *entity_pos = j;
+
+            return entities[j];
+
+        }
+
+    throw std::range_error("The entity with id " + std::to_string(i) + " was not found.");
+
+}
+
+template<typename TSeq>
+inline const Entity<TSeq> & Model<TSeq>::get_entity(size_t i, int * entity_pos) const
+{
+    for (size_t j = 0u; j < entities.size(); ++j)
+        if (entities[j].get_id() == static_cast<int>(i))
+        {
+
+            if (entity_pos)
+                *entity_pos = j;
+
+            return entities[j];
+
+        }
+
+    throw std::range_error("The entity with id " + std::to_string(i) + " was not found.");
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::agents_smallworld(
+    epiworld_fast_uint n,
+    epiworld_fast_uint k,
+    bool d,
+    epiworld_double p
+)
+{
+
+    agents_from_adjlist(
+        rgraph_smallworld(n, k, p, d, *this)
+    );
+
+    return *this;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::agents_empty_graph(
+    epiworld_fast_uint n
+)
+{
+
+
+    // Resizing the people
+    population.clear();
+    population.resize(n);
+    agents_state.assign(n, 0u);
+    network = std::make_shared< Network >(n);
+
+    // A new network invalidates the backup
+    network_backup = nullptr;
+
+    // Filling the model and ids
+    size_t i = 0u;
+    for (auto & p : population)
+    {
+        p.id = i++;
+    }
+
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::agents_sbm(
+    const std::vector< size_t > & block_sizes,
+    const std::vector< double > & mixing_matrix,
+    bool row_major
+)
+{
+
+    agents_from_adjlist(
+        rgraph_sbm(block_sizes, mixing_matrix, row_major, *this)
+    );
+
+    return *this;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::agents_bernoulli(
+    epiworld_fast_uint n,
+    epiworld_double p,
+    bool d
+)
+{
+
+    agents_from_adjlist(
+        rgraph_bernoulli(n, p, d, *this)
+    );
+
+    return *this;
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::operator()(std::string pname) {
+
+    const auto iter = parameters.find(pname);
+    if (iter == parameters.end())
+        throw std::range_error("The parameter '"+ pname + "' is not in the model.");
+
+    return iter->second;
+
+}
+
+template<typename TSeq>
+inline size_t Model<TSeq>::size() const {
+    return population.size();
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::dist_virus()
+{
+
+    for (auto & v: viruses)
+    {
+
+        v->distribute(this);
+
+        // Apply the events
+        events_run();
+    }
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::dist_tools()
+{
+
+    for (auto & tool: tools)
+    {
+
+        tool->distribute(this);
+
+        // Apply the events
+        events_run();
+
+    }
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::dist_entities()
+{
+
+    for (auto & entity: entities)
+    {
+
+        entity.distribute(this);
+
+        // Apply the events
+        events_run();
+
+    }
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::chrono_start() {
+    profile.reset();
+    time_start = std::chrono::steady_clock::now();
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::chrono_end() {
+    time_end = std::chrono::steady_clock::now();
+    time_elapsed += (time_end - time_start);
+    n_replicates++;
+    profile_total += profile;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::set_backup()
+{
+
+    // No copy is made here; the backup shares the network until
+    // the network is modified (e.g., by rewiring).
+    if (!network_backup)
+        network_backup = network;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::add_virus(
+    Virus<TSeq> & v
+    )
+{
+
+    // Checking the state
+    epiworld_fast_int init_, post_, rm_;
+    v.get_state(&init_, &post_, &rm_);
+
+    if (init_ == -99)
+        throw std::logic_error(
+            "The virus \"" + v.get_name() + "\" has no -init- state."
+            );
+    else if (post_ == -99)
+        throw std::logic_error(
+            "The virus \"" + v.get_name() + "\" has no -post- state."
+            );
+
+    // Recording the variant
+    db.record_virus(v);
+
+    // Adding new virus
+    auto cloned = v.clone_ptr();
+    viruses.push_back(std::shared_ptr<Virus<TSeq>>(std::move(cloned)));
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::add_tool(Tool<TSeq> & t)
+{
+
+
+    db.record_tool(t);
+
+    // Adding the tool to the model (and database.)
+    auto cloned = t.clone_ptr();
+    tools.push_back(std::shared_ptr<Tool<TSeq>>(std::move(cloned)));
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::add_entity(Entity<TSeq> e)
+{
+
+    e.id = entities.size();
+    entities.push_back(e);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::rm_entity(size_t entity_id)
+{
+
+    int entity_pos = 0;
+    auto & entity = this->get_entity(entity_id, &entity_pos);
+
+    // First, resetting the entity
+    entity.reset();
+
+    // How should
+    if (entity_pos != (static_cast<int>(entities.size()) - 1))
+        std::swap(entities[entity_pos], entities[entities.size() - 1]);
+
+    entities.pop_back();
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::rm_virus(size_t virus_pos)
+{
+
+    if (viruses.size() <= virus_pos)
+        throw std::range_error(
+            std::string("The specified virus (") +
+            std::to_string(virus_pos) +
+            std::string(") is out of range. ") +
+            std::string("There are only ") +
+            std::to_string(viruses.size()) +
+            std::string(" viruses.")
+            );
+
+    // Flipping with the last one
+    std::swap(viruses[virus_pos], viruses[viruses.size() - 1]);
+    viruses.pop_back();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::rm_tool(size_t tool_pos)
+{
+
+    if (tools.size() <= tool_pos)
+        throw std::range_error(
+            std::string("The specified tool (") +
+            std::to_string(tool_pos) +
+            std::string(") is out of range. ") +
+            std::string("There are only ") +
+            std::to_string(tools.size()) +
+            std::string(" tools.")
+            );
+
+    // Flipping with the last one
+    std::swap(tools[tool_pos], tools[tools.size() - 1]);
+
+    /* There's an error on windows:
+    https://github.com/UofUEpiBio/epiworldR/actions/runs/4801482395/jobs/8543744180#step:6:84
+
+    More clear here:
+    https://stackoverflow.com/questions/58660207/why-doesnt-stdswap-work-on-vectorbool-elements-under-clang-win
+    */
+
+    tools.pop_back();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::load_agents_entities_ties(
+    std::string fn,
+    int skip
+    )
+{
+
+
+    int i,j;
+    std::ifstream filei(fn);
+
+    if (!filei)
+        throw std::logic_error("The file " + fn + " was not found.");
+
+    int linenum = 0;
+    std::vector< std::vector< epiworld_fast_uint > > target_(entities.size());
+
+    target_.reserve(1e5);
+
+    while (!filei.eof())
+    {
+
+        if (linenum++ < skip)
+            continue;
+
+        filei >> i >> j;
+
+        // Looking for exceptions
+        if (filei.bad())
+            throw std::logic_error(
+                "I/O error while reading the file " +
+                fn
+            );
+
+        if (filei.fail())
+            break;
+
+        if (i >= static_cast<int>(this->size()))
+            throw std::range_error(
+                "The agent["+std::to_string(linenum)+"] = " + std::to_string(i) +
+                " is above the max id " + std::to_string(this->size() - 1)
+                );
+
+        if (j >= static_cast<int>(this->entities.size()))
+            throw std::range_error(
+                "The entity["+std::to_string(linenum)+"] = " + std::to_string(j) +
+                " is above the max id " + std::to_string(this->entities.size() - 1)
+                );
+
+        target_[j].push_back(i);
+
+        population[i].add_entity(*this, entities[j]);
+
+    }
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::load_agents_entities_ties(
+    const std::vector< int > & agents_ids,
+    const std::vector< int > & entities_ids
+) {
+
+
+    // Checking the size
+    if (agents_ids.size() != entities_ids.size())
+        throw std::length_error(
+            std::string("The size of agents_ids (") +
+            std::to_string(agents_ids.size()) +
+            std::string(") and entities_ids (") +
+            std::to_string(entities_ids.size()) +
+            std::string(") must be the same.")
+            );
+
+    return this->load_agents_entities_ties(
+        agents_ids.data(),
+        entities_ids.data(),
+        agents_ids.size()
+    );
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::load_agents_entities_ties(
+    const int * agents_ids,
+    const int * entities_ids,
+    size_t n
+) {
+
+
+    auto get_agent = [agents_ids](int i) -> int {
+        return *(agents_ids + i);
+        };
+
+    auto get_entity = [entities_ids](int i) -> int {
+        return *(entities_ids + i);
+        };
+
+    for (size_t i = 0u; i < n; ++i)
+    {
+
+        if (get_agent(i) < 0)
+            throw std::length_error(
+                std::string("agents_ids[") +
+                std::to_string(i) +
+                std::string("] = ") +
+                std::to_string(get_agent(i)) +
+                std::string(" is negative.")
+                );
+
+        if (get_entity(i) < 0)
+            throw std::length_error(
+                std::string("entities_ids[") +
+                std::to_string(i) +
+                std::string("] = ") +
+                std::to_string(get_entity(i)) +
+                std::string(" is negative.")
+                );
+
+        int pop_size = static_cast<int>(this->population.size());
+        if (get_agent(i) >= pop_size)
+            throw std::length_error(
+                std::string("agents_ids[") +
+                std::to_string(i) +
+                std::string("] = ") +
+                std::to_string(get_agent(i)) +
+                std::string(" is out of range (population size: ") +
+                std::to_string(pop_size) +
+                std::string(").")
+                );
+
+        int ent_size = static_cast<int>(this->entities.size());
+        if (get_entity(i) >= ent_size)
+            throw std::length_error(
+                std::string("entities_ids[") +
+                std::to_string(i) +
+                std::string("] = ") +
+                std::to_string(get_entity(i)) +
+                std::string(" is out of range (entities size: ") +
+                std::to_string(ent_size) +
+                std::string(").")
+                );
+
+        // Adding the entity to the agent
+        this->population[get_agent(i)].add_entity(
+            *this,
+            this->entities[get_entity(i)]
+        );
+
+    }
+
+    return;
+
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::agents_from_adjlist(
+    std::string fn,
+    int size,
+    int skip,
+    bool directed
+    ) {
+
+
+    AdjList al;
+    al.read_edgelist(fn, size, skip, directed);
+    this->agents_from_adjlist(al);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::agents_from_edgelist(
+    const std::vector< int > & source,
+    const std::vector< int > & target,
+    int size,
+    bool directed
+) {
+
+
+    AdjList al(source, target, size, directed);
+    agents_from_adjlist(al);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::agents_from_adjlist(AdjList al) {
+
 
-    void add_globalevent(
-        GlobalEvent<TSeq> & action
-    );
+    // Resizing the people
+    agents_empty_graph(al.vcount());
 
-    GlobalEvent<TSeq> & get_globalevent(std::string name); ///< Retrieve a global action by name
-    GlobalEvent<TSeq> & get_globalevent(size_t i); ///< Retrieve a global action by index
+    // Building the network and updating the degrees
+    auto & net = get_network_mutable();
+    net.build(al);
+    for (auto & p: population)
+        p.n_neighbors = net.degree(p.id);
 
-    void rm_globalevent(std::string name); ///< Remove a global action by name
-    void rm_globalevent(size_t i); ///< Remove a global action by index
+    #ifdef EPI_DEBUG
+    for (auto & p: population)
+    {
+        if (p.id >= static_cast<int>(al.vcount()))
+            throw std::logic_error(
+                "Agent's id cannot be negative above or equal to the number of agents!");
+    }
+    #endif
 
-    void run_globalevents();
+}
 
-    void clear_state_set();
+template<typename TSeq>
+inline bool Model<TSeq>::is_directed() const
+{
+    if (population.size() == 0u)
+        throw std::logic_error("The population hasn't been initialized.");
 
-    /**
-     * @name Queuing system
-     * @details When queueing is on, the model will keep track of which agents
-     * are either in risk of exposure or exposed. This then is used at each
-     * step to act only on the aforementioned agents.
-     *
-     */
-    ////@{
-    void queuing_on(); ///< Activates the queuing system (default.)
-    Model<TSeq> & queuing_off(); ///< Deactivates the queuing system.
-    bool is_queuing_on() const; ///< Query if the queuing system is on.
-    Queue<TSeq> & get_queue(); ///< Retrieve the `Queue` object.
-    ///@}
+    return directed;
+}
 
-    /**
-     * @name Contact tracing
-     * @details When contact tracing is on, the model will track contacts
-     * between agents. Users must actively record contacts in their update
-     * functions by calling `get_contact_tracing().add_contact(...)`.
-     * Contact tracing is off by default.
-     *
-     * @param max_contacts Maximum number of contacts to track per agent
-     * (default: EPI_MAX_TRACKING). Only used when turning tracing on.
-     */
-    ///@{
-    Model<TSeq> & contact_tracing_on(size_t max_contacts = EPI_MAX_TRACKING); ///< Activates contact tracing.
-    Model<TSeq> & contact_tracing_off(); ///< Deactivates contact tracing.
-    bool is_contact_tracing_on() const; ///< Query if contact tracing is on.
-    ContactTracing & get_contact_tracing(); ///< Retrieve the `ContactTracing` object.
-    ///@}
+template<typename TSeq>
+inline int Model<TSeq>::today() const {
 
-    const std::vector< VirusPtr<TSeq> > & get_viruses() const;
-    const std::vector< ToolPtr<TSeq> > & get_tools() const;
-    Virus<TSeq> & get_virus(size_t id);
-    Virus<TSeq> & get_virus(std::string_view name);
-    Tool<TSeq> & get_tool(size_t id);
-    Tool<TSeq> & get_tool(std::string_view name);
+    if (ndays == 0)
+      return 0;
 
-    bool has_virus(std::string_view name) const;
-    bool has_tool(std::string_view name) const;
+    return this->current_date;
+}
 
-    /**
-     * @brief Set the agents data object
-     *
-     * @details The data should be an array with the data stored in a
-     * column major order, i.e., by column.
-     *
-     * @param data_ Pointer to the first element of an array of size
-     * `size() * ncols_`.
-     * @param ncols_ Number of features included in the data.
-     *
-     */
-    void set_agents_data(double * data_, size_t ncols_);
-    double * get_agents_data();
-    size_t get_agents_data_ncols() const;
+template<typename TSeq>
+inline void Model<TSeq>::next() {
 
-    /**
-     * @brief Set the name object
-     *
-     * @param name
-     */
-    void set_name(std::string name);
-    std::string get_name() const;
+    #ifdef EPI_DEBUG
+    // Checking all the agents have proper states
+    for (auto & p : population)
+    {
+        if ((p.state >= nstates) || (p.state < 0))
+        {
+            throw std::range_error(
+                "The agent " + std::to_string(p.id) +
+                " has state " + std::to_string(p.state) +
+                " which is above the maximum state of " +
+                std::to_string(nstates - 1) + "."
+            );
+        }
 
-    bool operator==(const Model<TSeq> & other) const;
-    bool operator!=(const Model<TSeq> & other) const {return !operator==(other);};
+        if ((p.state_prev >= nstates) || (p.state_prev < 0))
+        {
+            throw std::range_error(
+                "The agent " + std::to_string(p.id) +
+                " has previous state " + std::to_string(p.state_prev) +
+                " which is above the maximum state of " +
+                std::to_string(nstates - 1) + "."
+            );
+        }
 
-    /**
-     * @brief Executes the stored action
-     *
-     * @param model_ Model over which it will be executed.
-     */
-    void events_run();
+    }
 
-    /**
-     * @brief Draws a mermaid diagram of the model.
-     * @param model The model to draw.
-     * @param fn_output The name of the file to write the diagram.
-     * If empty, the diagram will be printed to the standard output.
-     * @param self Whether to allow self-transitions.
-     */
-    void draw(
-        DiagramType diagram_type = DiagramType::Mermaid,
-        const std::string & fn_output = "",
-        bool self = false
-    );
+    #endif
 
-    /**
-     * @brief Record a hospitalization event for an agent.
-     * 
-     * @param agent Reference to the agent being hospitalized.
-     * 
-     * @details
-     * This is a wrapper for `DataBase::record_hospitalization()`.
-     * For each hospitalization, the method records:
-     * - The current date from the model
-     * - The virus ID from the agent's virus
-     * - For each tool the agent has, a separate record with weight = 1/N
-     *   where N is the number of tools
-     * - If the agent has no tools, a single record with tool_id = -1 and
-     *   weight = 1.0
-     */
-    void record_hospitalization(Agent<TSeq> & agent);
+    {
+        EPI_PROFILE_SCOPE(profile, Record)
+        db.record();
+    }
 
-    /**
-     * @brief Get the full time series of hospitalization data.
-     * 
-     * @param date Output vector for dates.
-     * @param virus_id Output vector for virus IDs.
-     * @param tool_id Output vector for tool IDs.
-     * @param count Output vector for counts (number of hospitalized individuals).
-     * @param weight Output vector for summed weights (fractional contribution
-     *   based on tool distribution).
-     * 
-     * @details
-     * This is a wrapper for `DataBase::get_hospitalizations()`.
-     * Returns the full time series of hospitalization data. For each unique 
-     * (virus_id, tool_id) combination observed, returns an entry for every 
-     * day from 0 to ndays-1.
-     * 
-     * The `count` vector contains the actual number of individuals hospitalized 
-     * for that (date, virus_id, tool_id) combination. This is useful for 
-     * answering questions like "how many total people were hospitalized?" 
-     * regardless of their tools.
-     * 
-     * The `weight` vector contains fractional contributions: if an agent has N 
-     * tools, each tool gets weight = 1/N. Summing weights across all tool_ids 
-     * for a given date and virus_id gives the total number of hospitalizations.
-     */
-    void get_hospitalizations(
-        std::vector<int> & date,
-        std::vector<int> & virus_id,
-        std::vector<int> & tool_id,
-        std::vector<int> & count,
-        std::vector<double> & weight
-    ) const;
+    ++this->current_date;
 
+    // Advancing the progress bar
+    if ((this->current_date >= 1) && verbose)
+        pb.next();
 
-};
+    return ;
+}
 
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+template<typename TSeq>
+inline void Model<TSeq>::run_setup(
+    epiworld_fast_uint ndays,
+    int seed
+)
+{
 
- End of -./include/epiworld/model-bones.hpp-
+    // Set this model as the current model in scope for this thread.
+    // This enables Model::the() calls from agents, entities, etc.
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    if (size() == 0u)
+        throw std::logic_error("There are no agents in this model!");
 
+    if (nstates == 0u)
+        throw std::logic_error(
+            std::string("No states registered in this model. ") +
+            std::string("At least one state should be included. See the ") +
+            std::string("function -Model::add_state()-")
+            );
 
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+    // Setting up the number of steps
+    this->ndays = ndays;
 
- Start of -./include/epiworld/model-rand-meat.hpp-
+    if (seed >= 0)
+        this->seed(static_cast< size_t >(seed));
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    last_seed = seed;
+
+    // Binding the parameters added through `params()` (par(id) only reads)
+    parameters_ptrs_update();
+
+    // Checking whether the proposed state in/out/removed
+    // are valid
+    epiworld_fast_int _init, _end, _removed;
+    int nstate_int = static_cast<int>(nstates);
 
+    // Function to validate the states of viruses
+    // and tools.
+    auto check_init_states = [nstate_int](int x) -> void {
+
+        if (((x != -99) && (x < 0)) || (x >= nstate_int))
+            throw std::range_error("States must be between 0 and " +
+                std::to_string(nstate_int - 1));
+    };
 
-#ifndef EPIWORLD_MODEL_RAND_MEAT_HPP
-#define EPIWORLD_MODEL_RAND_MEAT_HPP
+    for (auto & v : viruses)
+    {
+        v->get_state(&_init, &_end, &_removed);
 
-// (already included include/epiworld/rng-utils.hpp)
-// (already included include/epiworld/model-bones.hpp)
+        check_init_states(_init);
+        check_init_states(_end);
+        check_init_states(_removed);
 
-template<typename TSeq>
-inline void Model<TSeq>::set_rand_gamma(epiworld_double alpha, epiworld_double beta)
-{
-    rgammad = std::gamma_distribution<>(alpha,beta);
-}
+    }
 
-template<typename TSeq>
-inline void Model<TSeq>::set_rand_norm(epiworld_double mean, epiworld_double sd)
-{
-    rnormd  = std::normal_distribution<>(mean, sd);
-}
+    for (auto & t : tools)
+    {
+        t->get_state(&_init, &_end);
 
-template<typename TSeq>
-inline void Model<TSeq>::set_rand_unif(epiworld_double a, epiworld_double b)
-{
-    runifd_a = a;
-    runifd_b = b;
-}
+        check_init_states(_init);
+        check_init_states(_end);
 
-template<typename TSeq>
-inline void Model<TSeq>::set_rand_lognormal(epiworld_double mean, epiworld_double shape)
-{
-    rlognormald  = std::lognormal_distribution<>(mean, shape);
-}
+    }
 
-template<typename TSeq>
-inline void Model<TSeq>::set_rand_exp(epiworld_double lambda)
-{
-    rexpd  = std::exponential_distribution<>(lambda);
-}
+    // Starting first infection and tools
+    reset();
 
-template<typename TSeq>
-inline void Model<TSeq>::set_rand_binom(int n, epiworld_double p)
-{
-    rbinomd  = std::binomial_distribution<>(n, p);
-    rbinomd_n = n;
-#ifdef EPI_FAST_BINOM
-    rbinomd_fast_lambda = static_cast<epiworld_double>(n) * p;
-    rbinomd_use_poisson =
-        (p <= static_cast<epiworld_double>(0.01)) &&
-        (static_cast<epiworld_double>(n) * p * p <= static_cast<epiworld_double>(0.1));
-#else
-    rbinomd_fast_lambda = 0.0;
-    rbinomd_use_poisson = false;
-#endif
-}
+    // Record the baseline (day 0) and advance to day 1
+    next();
 
-template<typename TSeq>
-inline void Model<TSeq>::set_rand_nbinom(int n, epiworld_double p)
-{
-    rnbinomd  = std::negative_binomial_distribution<>(n, p);
-}
+    // Initializing the simulation
+    chrono_start();
 
-template<typename TSeq>
-inline void Model<TSeq>::set_rand_geom(epiworld_double p)
-{
-    rgeomd  = std::geometric_distribution<>(p);
-}
+    // Verifying if the user wants to see the progress bar
+    if (get_verbose())
+    {
+        printf_epiworld("Running the model...\n");
+    }
 
-template<typename TSeq>
-inline void Model<TSeq>::set_rand_poiss(epiworld_double lambda)
-{
-    rpoissd  = std::poisson_distribution<>(lambda);
 }
 
 template<typename TSeq>
-inline std::shared_ptr< epi_xoshiro256ss > & Model<TSeq>::get_rand_endgine()
+inline Model<TSeq> & Model<TSeq>::run(
+    epiworld_fast_uint ndays,
+    int seed
+)
 {
-    return engine;
-}
 
-template<typename TSeq>
-inline void Model<TSeq>::set_rand_engine(std::shared_ptr< epi_xoshiro256ss > & eng)
-{
-    engine = eng;
-}
+    if (aggregated)
+    {
 
-template<typename TSeq>
-inline epiworld_double Model<TSeq>::runif() {
-    // CHECK_INIT()
-    epiworld_double res = runif_epi(*engine);
-    return res * (runifd_b - runifd_a) + runifd_a;
-}
+        if (seed >= 0)
+            this->seed(static_cast< size_t >(seed));
 
-template<typename TSeq>
-inline int Model<TSeq>::runif_int(int a, int b) {
-    // CHECK_INIT()
-    return a + runif_index(static_cast<uint32_t>(b - a + 1));
-}
+        last_seed = seed;
 
-template<typename TSeq>
-inline uint32_t Model<TSeq>::runif_index(uint32_t n) {
+        // The binomial keeps cached draws (large n), which would make the
+        // run depend on the previous one
+        rbinomd.reset();
 
-    // If asking for a 0-range, return 0 to prevent division by zero in the bias check
-    if (n == 0) return 0;
+        return run_aggregated(ndays);
 
-    // Grab 32 perfectly uniform random bits directly from xoshiro256ss
-    uint32_t x = static_cast<uint32_t>((*engine)());
-    
-    // Multiply by the bound N to get a 64-bit result
-    uint64_t m = static_cast<uint64_t>(x) * static_cast<uint64_t>(n);
-    
-    // The fractional part (lower 32 bits)
-    uint32_t l = static_cast<uint32_t>(m);
-    
-    // Unbiased rejection sampling for the rare edge case
-    if (l < n) {
-        uint32_t t = -n % n; // Two's complement trick to get (2^32 - n) % n
-        while (l < t) {
-            x = static_cast<uint32_t>((*engine)());
-            m = static_cast<uint64_t>(x) * static_cast<uint64_t>(n);
-            l = static_cast<uint32_t>(m);
-        }
     }
-    
-    // The integer part (upper 32 bits) is our unbiased scaled random index
-    return static_cast<uint32_t>(m >> 32);
-}
 
-template<typename TSeq>
-inline epiworld_double Model<TSeq>::runif(epiworld_double a, epiworld_double b) {
-    // CHECK_INIT()
-    return runif_epi(*engine) * (b - a) + a;
-}
+    run_setup(ndays, seed);
 
-template<typename TSeq>
-inline epiworld_double Model<TSeq>::rnorm() {
-    // CHECK_INIT()
-    return rnormd(*engine);
-}
+    run_days(get_ndays());
 
-template<typename TSeq>
-inline epiworld_double Model<TSeq>::rnorm(epiworld_double mean, epiworld_double sd) {
-    // CHECK_INIT()
-    return rnormd(*engine) * sd + mean;
-}
+    // The last reaches the end...
+    this->current_date--;
 
-template<typename TSeq>
-inline epiworld_double Model<TSeq>::rgamma() {
-    return rgammad(*engine);
-}
+    chrono_end();
 
-template<typename TSeq>
-inline epiworld_double Model<TSeq>::rgamma(epiworld_double alpha, epiworld_double beta) {
+    sim_id++;
 
-    return rgammad(
-        *engine,
-        std::gamma_distribution<>::param_type(alpha, beta)
-    );
+    return *this;
 
 }
 
 template<typename TSeq>
-inline epiworld_double Model<TSeq>::rexp() {
-    return rexpd(*engine);
-}
+inline void Model<TSeq>::run_days(epiworld_fast_uint ndays)
+{
 
-template<typename TSeq>
-inline epiworld_double Model<TSeq>::rexp(epiworld_double lambda) {
+    for (epiworld_fast_uint niter = 0; niter < ndays; ++niter)
+    {
 
-    return rexpd(
-        *engine,
-        std::exponential_distribution<>::param_type(lambda)
-    );
+        #ifdef EPI_DEBUG
+        db.n_transmissions_potential = 0;
+        db.n_transmissions_today = 0;
+        #endif
 
-}
+        // We can execute these components in whatever order the
+        // user needs.
+        this->update_state();
 
-template<typename TSeq>
-inline epiworld_double Model<TSeq>::rlognormal() {
-    return rlognormald(*engine);
-}
+        // We start with the Global events
+        this->run_globalevents();
 
-template<typename TSeq>
-inline epiworld_double Model<TSeq>::rlognormal(epiworld_double mean, epiworld_double shape) {
+        // In this case we are applying degree sequence rewiring
+        // to change the network just a bit.
+        this->rewire();
 
-    return rlognormald(
-        *engine,
-        std::lognormal_distribution<>::param_type(mean, shape)
-    );
-}
+        // This locks all the changes
+        this->next();
 
-template<typename TSeq>
-inline int Model<TSeq>::rbinom() {
-#ifdef EPI_FAST_BINOM
-    if (rbinomd_use_poisson)
-    {
-        int res = rpoiss(rbinomd_fast_lambda);
-        return std::min(res, rbinomd_n);
-    }
-#endif
-    return rbinomd(*engine);
-}
+        // Mutation must happen at the very end of all
+        this->mutate_virus();
 
-template<typename TSeq>
-inline int Model<TSeq>::rbinom(int n, epiworld_double p) {
+        // Nothing else can happen, so only the records are left
+        if (fast_forward && (niter + 1u < ndays) && is_absorbing())
+        {
 
-    if (n == 0 || p == 0.0)
-        return 0;
+            for (++niter; niter < ndays; ++niter)
+                this->next();
 
-#ifdef EPI_FAST_BINOM
-    if (
-        (p <= static_cast<epiworld_double>(0.01)) &&
-        (static_cast<epiworld_double>(n) * p * p <= static_cast<epiworld_double>(0.1))
-    )
-    {
-        int res = rpoiss(static_cast<epiworld_double>(n) * p);
-        return std::min(res, n);
-    }
-#endif
+            break;
 
-    return rbinomd(
-        *engine,
-        std::binomial_distribution<>::param_type(n, p)
-    );
+        }
 
-}
+    }
 
-template<typename TSeq>
-inline int Model<TSeq>::rnbinom() {
-    return rnbinomd(*engine);
 }
 
 template<typename TSeq>
-inline int Model<TSeq>::rnbinom(int n, epiworld_double p) {
-
-    return rnbinomd(
-        *engine,
-        std::negative_binomial_distribution<>::param_type(n, p)
-    );
+inline bool Model<TSeq>::is_aggregated() const
+{
+    return aggregated;
 }
 
 template<typename TSeq>
-inline int Model<TSeq>::rgeom() {
-    return rgeomd(*engine);
-}
+inline void Model<TSeq>::aggregated_enable(std::vector< size_t > group_sizes)
+{
 
-template<typename TSeq>
-inline int Model<TSeq>::rgeom(epiworld_double p) {
+    // Counts are kept as int (as the database)
+    size_t n = 0u;
+    for (auto s : group_sizes)
+    {
 
-    return rgeomd(
-        *engine,
-        std::geometric_distribution<>::param_type(p)
-    );
+        if (s == 0u)
+            throw std::invalid_argument("Group sizes must be positive.");
 
-}
+        n += s;
+        if (n > static_cast< size_t >(std::numeric_limits< int >::max()))
+            throw std::range_error(
+                "The total of the group sizes cannot be above " +
+                std::to_string(std::numeric_limits< int >::max()) + "."
+            );
 
-template<typename TSeq>
-inline int Model<TSeq>::rpoiss() {
-    return rpoissd(*engine);
-}
+    }
 
-template<typename TSeq>
-inline int Model<TSeq>::rpoiss(epiworld_double lambda) {
+    aggregated_sizes = std::move(group_sizes);
+    aggregated = true;
 
-    return rpoissd(
-        *engine,
-        std::poisson_distribution<>::param_type(lambda)
-    );
+    // Releasing the agents
+    agents_empty_graph(0u);
 
 }
 
 template<typename TSeq>
-inline size_t Model<TSeq>::sample_from_probs(size_t n) {
+inline void Model<TSeq>::aggregated_disable()
+{
 
-    epiworld_double p_total = runif();
-    size_t ans;
-    for (ans = 0u; ans < n; ++ans)
-    {
-        if (p_total < array_double_tmp[ans])
-            break;
-        array_double_tmp[ans + 1] += array_double_tmp[ans];
-    }
-    return ans;
+    if (!aggregated)
+        return;
+
+    size_t n = 0u;
+    for (auto s : aggregated_sizes)
+        n += s;
+
+    aggregated = false;
+    agents_empty_graph(n);
 
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::seed(size_t s) {
-    this->engine->seed(s);
+inline Model<TSeq> & Model<TSeq>::run_aggregated(epiworld_fast_uint)
+{
+    throw std::logic_error(
+        "The model '" + name + "' cannot run on counts."
+    );
 }
 
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+template<typename TSeq>
+inline std::vector< int > Model<TSeq>::aggregated_split(
+    epiworld_double prevalence
+)
+{
 
- End of -./include/epiworld/model-rand-meat.hpp-
+    size_t n = 0u;
+    for (auto s : aggregated_sizes)
+        n += s;
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    int n_left = static_cast< int >(
+        std::floor(prevalence * static_cast< epiworld_double >(n))
+    );
+    size_t size_left = n;
 
+    std::vector< int > cases(aggregated_sizes.size());
+    for (size_t g = 0u; g < aggregated_sizes.size(); ++g)
+    {
 
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+        int size_g = static_cast< int >(aggregated_sizes[g]);
+        cases[g] = rbinom(
+            n_left,
+            static_cast< epiworld_double >(size_g) /
+                static_cast< epiworld_double >(size_left)
+        );
 
- Start of -./include/epiworld/model-meat.hpp-
+        if (cases[g] > size_g)
+            cases[g] = size_g;
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+        n_left    -= cases[g];
+        size_left -= aggregated_sizes[g];
 
+    }
 
-#ifndef EPIWORLD_MODEL_MEAT_HPP
-#define EPIWORLD_MODEL_MEAT_HPP
+    return cases;
 
-#include <vector>
-#include <functional>
-#include <memory>
-#include <random>
-#include <string>
-#include <map>
-#include <unordered_map>
-// (already included include/epiworld/config.hpp)
-// (already included include/epiworld/userdata-bones.hpp)
-// (already included include/epiworld/adjlist-bones.hpp)
-// (already included include/epiworld/model-bones.hpp)
-// (already included include/epiworld/virus-bones.hpp)
-// (already included include/epiworld/agent-bones.hpp)
-// (already included include/epiworld/tool-bones.hpp)
-// (already included include/epiworld/rng-utils.hpp)
-// (already included include/epiworld/modeldiagram-bones.hpp)
+}
 
-/**
- * @brief Function factory for saving model runs
- *
- * @details This function is the default behavior of the `run_multiple`
- * member of `Model<TSeq>`. By default only the total history (
- * case counts by unit of time.)
- *
- * @tparam TSeq
- * @param fmt
- * @param total_hist
- * @param virus_info
- * @param virus_hist
- * @param tool_info
- * @param tool_hist
- * @param transmission
- * @param transition
- * @return std::function<void(size_t,Model<TSeq>*)>
- */
 template<typename TSeq>
-inline std::function<void(size_t,Model<TSeq>*)> make_save_run(
-    std::string fmt,
-    bool total_hist,
-    bool virus_info,
-    bool virus_hist,
-    bool tool_info,
-    bool tool_hist,
-    bool transmission,
-    bool transition,
-    bool reproductive,
-    bool generation,
-    bool active_cases,
-    bool outbreak_size,
-    bool hospitalizations
-    )
+inline epiworld_double Model<TSeq>::aggregated_escape(
+    const ContactMatrix & contact_matrix,
+    size_t i,
+    const std::vector< int > & I,
+    epiworld_double p_transmit
+) const
 {
 
-    // Counting number of %
-    int n_fmt = 0;
-    for (auto & f : fmt)
-        if (f == '%')
-            n_fmt++;
-
-    if (n_fmt != 1)
-        throw std::logic_error("The -fmt- argument must have only one \"%\" symbol.");
+    epiworld_double log_escape = 0.0;
+    for (size_t g = 0u; g < aggregated_sizes.size(); ++g)
+    {
 
-    // Listting things to save
-    std::vector< bool > what_to_save = {
-        virus_info,
-        virus_hist,
-        tool_info,
-        tool_hist,
-        total_hist,
-        transmission,
-        transition,
-        reproductive,
-        generation,
-        active_cases,
-        outbreak_size,
-        hospitalizations
-    };
+        if (I[g] == 0)
+            continue;
 
-    std::function<void(size_t,Model<TSeq>*)> saver = [fmt,what_to_save](
-        size_t niter, Model<TSeq> * m
-    ) -> void {
+        epiworld_double p_contact =
+            contact_matrix.get_contact_rate(i, g, false) /
+            static_cast< epiworld_double >(aggregated_sizes[g]);
 
-        auto set_saver = [fmt,niter](
-            bool condition,
-            std::string suffix
-        ) -> std::string
-        {
-            if (condition)
-            {
-                std::string var = fmt + suffix;
-                char buff[1024u];
-                snprintf(buff, sizeof(buff), var.c_str(), niter);
-                return std::string(buff);
-            }
-            return std::string("");
-        };
+        if (p_contact > 1.0)
+            p_contact = 1.0;
 
-        auto virus_info = set_saver(what_to_save[0u], "_virus_info.csv");
-        auto virus_hist = set_saver(what_to_save[1u], "_virus_hist.csv");
-        auto tool_info = set_saver(what_to_save[2u], "_tool_info.csv");
-        auto tool_hist = set_saver(what_to_save[3u], "_tool_hist.csv");
-        auto total_hist = set_saver(what_to_save[4u], "_total_hist.csv");
-        auto transmission = set_saver(what_to_save[5u], "_transmission.csv");
-        auto transition = set_saver(what_to_save[6u], "_transition.csv");
-        auto reproductive = set_saver(what_to_save[7u], "_reproductive.csv");
-        auto generation = set_saver(what_to_save[8u], "_generation.csv");
-        auto active_cases = set_saver(what_to_save[9u], "_active_cases.csv");
-        auto outbreak_size = set_saver(what_to_save[10u], "_outbreak_size.csv");
-        auto hospitalizations = set_saver(what_to_save[11u], "_hospitalizations.csv");
+        log_escape +=
+            static_cast< epiworld_double >(I[g]) *
+            std::log1p(-p_transmit * p_contact);
 
-        m->write_data(
-            virus_info,
-            virus_hist,
-            tool_info,
-            tool_hist,
-            total_hist,
-            transmission,
-            transition,
-            reproductive,
-            generation,
-            active_cases,
-            outbreak_size,
-            hospitalizations
-        );
+    }
 
-    };
+    return std::exp(log_escape);
 
-    return saver;
 }
 
-
 template<typename TSeq>
-inline void Model<TSeq>::_add_event(
-    Agent<TSeq> * agent_,
-    VirusPtr<TSeq> virus_,
-    ToolPtr<TSeq> tool_,
-    Entity<TSeq> * entity_,
-    epiworld_fast_int new_state_,
-    epiworld_fast_int queue_,
-    EventAction action_
-) {
+inline void Model<TSeq>::aggregated_setup(
+    epiworld_fast_uint ndays,
+    const std::vector< int > & totals,
+    const std::vector< bool > & with_virus
+)
+{
 
-    ++nactions;
+    if ((totals.size() != nstates) || (with_virus.size() != nstates))
+        throw std::length_error(
+            "The number of totals (" + std::to_string(totals.size()) +
+            ") must match the number of states (" +
+            std::to_string(nstates) + ")."
+        );
 
-    #ifdef EPI_DEBUG
-    if (nactions == 0)
-        throw std::logic_error("Events cannot be zero!!");
-    #endif
+    if (viruses.size() == 0u)
+        throw std::logic_error("Aggregated runs need at least one virus.");
+
+    this->ndays = ndays;
+
+    pb = Progress(ndays, 80);
+    current_date = 0;
 
-    if (nactions > events.size())
+    // The counts are set by hand, as there are no agents
+    db.reset();
+    aggregated_with_virus = with_virus;
+    for (epiworld_fast_uint s = 0u; s < nstates; ++s)
     {
 
-        events.emplace_back(
-            Event<TSeq>(
-                agent_, virus_, tool_, entity_, new_state_, queue_, action_
-            ));
+        db.today_total[s] = totals[s];
+        db.transition_matrix[s + s * nstates] = totals[s];
+
+        if (with_virus[s])
+            db.today_virus[0u][s] = totals[s];
 
     }
-    else
-    {
 
-        Event<TSeq> & A = events.at(nactions - 1u);
+    // Record the baseline (day 0) and advance to day 1
+    next();
 
-        A.agent      = std::move(agent_);
-        A.virus      = std::move(virus_);
-        A.tool       = std::move(tool_);
-        A.entity     = std::move(entity_);
-        A.new_state  = std::move(new_state_);
-        A.queue      = std::move(queue_);
-        A.action     = std::move(action_);
+    chrono_start();
 
+    if (get_verbose())
+    {
+        printf_epiworld("Running the model...\n");
     }
 
-    return;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::aggregated_move(
+    epiworld_fast_uint from,
+    epiworld_fast_uint to,
+    int n
+)
+{
+
+    if (n == 0)
+        return;
+
+    db.today_total[from] -= n;
+    db.today_total[to]   += n;
+    db.transition_matrix[to * nstates + from]   += n;
+    db.transition_matrix[from * nstates + from] -= n;
+
+    if (aggregated_with_virus[from])
+        db.today_virus[0u][from] -= n;
+
+    if (aggregated_with_virus[to])
+        db.today_virus[0u][to] += n;
 
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::events_run()
+inline void Model<TSeq>::aggregated_end()
 {
-    // Making the call
-    size_t nevents_tmp = 0;
-    while (nevents_tmp < nactions)
-    {
 
-        Event<TSeq> & a = events[nevents_tmp++];
-        Agent<TSeq> * p  = a.agent;
+    // The last reaches the end...
+    this->current_date--;
 
-        #ifdef EPI_DEBUG
-        if (a.new_state >= static_cast<epiworld_fast_int>(nstates))
-        {
-            throw std::range_error(
-                "The proposed state " + std::to_string(a.new_state) + " is out of range. " +
-                "The model currently has " + std::to_string(nstates - 1) + " states.");
+    chrono_end();
 
-        }
-        else if ((a.new_state != -99) && (a.new_state < 0))
-        {
-            throw std::range_error(
-                "The proposed state " + std::to_string(a.new_state) + " is out of range. " +
-                "The state cannot be negative.");
-        }
-        #endif
+    sim_id++;
 
-        // Undoing the change in the transition matrix
-        if (
-            (a.new_state != -99) &&
-            (p->state_last_changed == today()) &&
-            (static_cast<int>(p->state) != a.new_state)
-        )
-        {
-            // Undoing state change in the transition matrix
-            // The previous state is already recorded
-            db.update_state(p->state_prev, p->state, true);
+}
+
+template<typename TSeq>
+inline size_t Model<TSeq>::run_jobs(
+    size_t njobs,
+    #ifdef _OPENMP
+    int nthreads,
+    #else
+    int,
+    #endif
+    std::function<void(size_t,Model<TSeq>*)> job,
+    std::function<void(size_t,Model<TSeq>*)> fun,
+    Progress & pb,
+    bool verbose
+)
+{
 
-        } else if (p->state_last_changed != today())
-            p->state_prev = p->state; // Recording the previous state
+    #ifdef _OPENMP
 
-        switch (a.action)
+    omp_set_num_threads(nthreads);
+
+    // Generating copies of the model (done serially to avoid races on original)
+    std::vector< std::unique_ptr< Model<TSeq> > > these;
+    for (size_t i = 1u; i < static_cast<size_t>(nthreads); ++i)
+        these.emplace_back(clone_ptr());
+
+    #ifdef EPI_DEBUG
+    // Checking the initial state of all the models. Throw an
+    // exception if they are not the same.
+    for (size_t i = 1; i < static_cast<size_t>(std::max(nthreads - 1, 0)); ++i)
+    {
+
+        if (db != these[i]->db)
         {
-        case EventAction::AddVirus:
-            _event_add_virus(a);
-            break;
-        case EventAction::AddTool:
-            _event_add_tool(a);
-            break;
-        case EventAction::AddEntity:
-            _event_add_entity(a);
-            break;
-        case EventAction::RemoveVirus:
-            _event_rm_virus(a);
-            break;
-        case EventAction::RemoveTool:
-            _event_rm_tool(a);
-            break;
-        case EventAction::RemoveEntity:
-            _event_rm_entity(a);
-            break;
-        case EventAction::ChangeState:
-            _event_change_state(a);
-            break;
-        default:
-            throw std::logic_error("The requested event action is not supported.");
+            throw std::runtime_error(
+                "The initial state of the models is not the same"
+            );
         }
+    }
+    #endif
 
-        if (a.new_state != -99)
-            p->state = a.new_state;
-
-        // Registering that the last change was today
-        p->state_last_changed = today();
+    // Jobs are handed out dynamically (next free id), since their
+    // runtimes vary a lot
+    size_t next_job    = 0u;
+    size_t n_done      = 0u;
+    size_t n_done_here = 0u;
+    size_t n_ticks     = 0u;
+    Model<TSeq> * last_model = this;
 
+    #pragma omp parallel shared(these, next_job, n_done, n_done_here, \
+        n_ticks, pb, job, fun, last_model) firstprivate(verbose, njobs) \
+        default(none)
+    {
 
-        #ifdef EPI_DEBUG
-        if (static_cast<int>(p->state) >= static_cast<int>(nstates))
-                throw std::range_error(
-                    "The new state " + std::to_string(p->state) + " is out of range. " +
-                    "The model currently has " + std::to_string(nstates - 1) + " states.");
-        #endif
+        auto iam = static_cast<size_t>(omp_get_thread_num());
+        Model<TSeq> * model_ptr = iam == 0 ? this : &(*these[iam - 1u]);
 
-        // Updating queue
-        if (use_queuing && a.queue != -99)
+        while (true)
         {
 
-            if (a.queue == Queue<TSeq>::Everyone)
-                queue += p;
-            else if (a.queue == -Queue<TSeq>::Everyone)
-                queue -= p;
-            else if (a.queue == Queue<TSeq>::OnlySelf)
-                queue[p->get_id()]++;
-            else if (a.queue == -Queue<TSeq>::OnlySelf)
-                queue[p->get_id()]--;
-            else if (a.queue != Queue<TSeq>::NoOne)
-                throw std::logic_error(
-                    "The proposed queue change is not valid. Queue values can be {-2, -1, 0, 1, 2}."
-                    );
+            size_t job_id;
+            #pragma omp atomic capture
+            job_id = next_job++;
 
-        }
+            if (job_id >= njobs)
+                break;
 
-    }
+            if (iam == 0)
+            {
 
-    // Go back to square 1
-    nactions = 0u;
+                // Checking if the user interrupted the simulation
+                EPI_CHECK_USER_INTERRUPT(n_done_here);
 
-    return;
+            }
 
-}
+            job(job_id, model_ptr);
 
-/**
- * @name Default function for combining susceptibility_reduction levels
- *
- * @tparam TSeq
- * @param pt
- * @return epiworld_double
- */
-///@{
-template<typename TSeq>
-inline epiworld_double Model<TSeq>::susceptibility_reduction_mixer(
-    Agent<TSeq>* p,
-    VirusPtr<TSeq> & v
-)
-{
-    epiworld_double total = 1.0;
-    for (auto & tool : p->get_tools())
-        total *= (1.0 - tool->get_susceptibility_reduction(v, this));
+            if (job_id == (njobs - 1u))
+                last_model = model_ptr;
 
-    return 1.0 - total;
+            if (fun)
+            {
+                // User callbacks often write into shared result containers.
+                // Serialize callback execution to avoid callback-induced races.
+                #pragma omp critical(epiworld_run_multiple_fun)
+                {
+                    fun(job_id, model_ptr);
+                }
+            }
 
-}
+            #pragma omp atomic
+            n_done++;
 
-template<typename TSeq>
-inline epiworld_double Model<TSeq>::transmission_reduction_mixer(
-    Agent<TSeq>* p,
-    VirusPtr<TSeq> & v
-)
-{
-    epiworld_double total = 1.0;
-    for (auto & tool : p->get_tools())
-        total *= (1.0 - tool->get_transmission_reduction(v, this));
+            if (iam == 0)
+            {
 
-    return (1.0 - total);
+                n_done_here++;
 
-}
+                // Only the first one prints
+                if (verbose)
+                {
+                    size_t n_done_now;
+                    #pragma omp atomic read
+                    n_done_now = n_done;
 
-template<typename TSeq>
-inline epiworld_double Model<TSeq>::recovery_enhancer_mixer(
-    Agent<TSeq>* p,
-    VirusPtr<TSeq> & v
-)
-{
-    epiworld_double total = 1.0;
-    for (auto & tool : p->get_tools())
-        total *= (1.0 - tool->get_recovery_enhancer(v, this));
+                    for (; n_ticks < n_done_now; ++n_ticks)
+                        pb.next();
+                }
 
-    return 1.0 - total;
+            }
 
-}
+        }
 
-template<typename TSeq>
-inline epiworld_double Model<TSeq>::death_reduction_mixer(
-    Agent<TSeq>* p,
-    VirusPtr<TSeq> & v
-) {
+    }
 
-    epiworld_double total = 1.0;
-    for (auto & tool : p->get_tools())
+    if (verbose)
+        for (; n_ticks < njobs; ++n_ticks)
+            pb.next();
+
+    // The model ends with the state of the last job
+    if (last_model != this)
     {
-        total *= (1.0 - tool->get_death_reduction(v, this));
-    }
 
-    return 1.0 - total;
+        std::stringstream derived(
+            std::ios_base::in | std::ios_base::out | std::ios_base::binary
+        );
+        last_model->write_checkpoint_derived(derived);
 
-}
-///@}
+        Model<TSeq>::operator=(*last_model);
 
-template<typename TSeq>
-inline std::unique_ptr<Model<TSeq>> Model<TSeq>::clone_ptr()
-{
-    // Everything is copied
-    auto ptr = std::make_unique<Model<TSeq>>(*this);
+        profile = last_model->profile;
 
-    #ifdef EPI_DEBUG
-    if (*this != *ptr)
-        throw std::logic_error("Model::clone_ptr The copies of the model don't match.");
-    #endif
+        read_checkpoint_derived_keep_rng(derived);
 
-    return ptr;
-}
+    }
 
-template<typename TSeq>
-inline Model<TSeq>::Model()
-{
-    db.model = this;
-    db.user_data = this;
-    if (use_queuing)
-        queue.model = this;
-}
+    for (auto & m : these)
+        profile_total += m->profile_total;
 
-template<typename TSeq>
-inline Model<TSeq>::Model(const Model<TSeq> & model) :
-    name(model.name),
-    db(model.db),
-    population(model.population),
-    population_backup(model.population_backup),
-    directed(model.directed),
-    viruses(),
-    tools(),
-    entities(model.entities),
-    rewire_fun(model.rewire_fun),
-    rewire_prop(model.rewire_prop),
-    parameters(model.parameters),
-    ndays(model.ndays),
-    pb(model.pb),
-    state_fun(model.state_fun),
-    states_labels(model.states_labels),
-    initial_states_fun(model.initial_states_fun),
-    nstates(model.nstates),
-    verbose(model.verbose),
-    current_date(model.current_date),
-    globalevents(),
-    queue(model.queue),
-    use_queuing(model.use_queuing),
-    sim_id(model.sim_id),
-    contact_tracing(
-        model.contact_tracing
-            ? std::make_unique<ContactTracing>(*model.contact_tracing)
-            : nullptr
-    ),
-    use_contact_tracing(model.use_contact_tracing),
-    contact_tracing_max_contacts(model.contact_tracing_max_contacts)
-{
+    return n_done_here;
 
-    // Pointing to the right place. This needs
-    // to be done afterwards since the state zero is set as a function
-    // of the population.
-    db.model = this;
-    db.user_data.model = this;
+    #else
 
-    if (use_queuing)
-        queue.model = this;
+    for (size_t n = 0u; n < njobs; ++n)
+    {
 
-    agents_data = model.agents_data;
-    agents_data_ncols = model.agents_data_ncols;
+        // Checking if the user interrupted the simulation
+        EPI_CHECK_USER_INTERRUPT(n);
 
-    rbinomd = model.rbinomd;
-    rbinomd_n = model.rbinomd_n;
-    rbinomd_fast_lambda = model.rbinomd_fast_lambda;
-    rbinomd_use_poisson = model.rbinomd_use_poisson;
+        job(n, this);
 
-    // Deep-copy model-level objects so clones can run independently in parallel.
-    viruses.reserve(model.viruses.size());
-    for (const auto & v : model.viruses)
-        viruses.emplace_back(std::shared_ptr<Virus<TSeq>>(v->clone_ptr()));
+        if (fun)
+            fun(n, this);
 
-    tools.reserve(model.tools.size());
-    for (const auto & t : model.tools)
-        tools.emplace_back(std::shared_ptr<Tool<TSeq>>(t->clone_ptr()));
+        if (verbose)
+            pb.next();
 
-    globalevents.reserve(model.globalevents.size());
-    for (const auto & ge : model.globalevents)
-        globalevents.emplace_back(std::shared_ptr<GlobalEvent<TSeq>>(ge->clone_ptr()));
+    }
 
-    // Entity-agent relationships now use size_t IDs, so they copy
-    // correctly without any rebinding needed.
+    return njobs;
+
+    #endif
 
 }
 
 template<typename TSeq>
-inline Model<TSeq>::Model(Model<TSeq> && model) :
-    name(std::move(model.name)),
-    db(std::move(model.db)),
-    population(std::move(model.population)),
-    population_backup(std::move(model.population_backup)),
-    agents_data(std::move(model.agents_data)),
-    agents_data_ncols(std::move(model.agents_data_ncols)),
-    directed(std::move(model.directed)),
-    // Virus
-    viruses(std::move(model.viruses)),
-    // Tools
-    tools(std::move(model.tools)),
-    // Entities
-    entities(std::move(model.entities)),
-    // Pseudo-RNG
-    engine(std::move(model.engine)),
-    runifd_a(model.runifd_a),
-    runifd_b(model.runifd_b),
-    rnormd(std::move(model.rnormd)),
-    rgammad(std::move(model.rgammad)),
-    rlognormald(std::move(model.rlognormald)),
-    rexpd(std::move(model.rexpd)),
-    rbinomd(std::move(model.rbinomd)),
-    rbinomd_n(model.rbinomd_n),
-    rbinomd_fast_lambda(model.rbinomd_fast_lambda),
-    rbinomd_use_poisson(model.rbinomd_use_poisson),
-    // Rewiring
-    rewire_fun(std::move(model.rewire_fun)),
-    rewire_prop(std::move(model.rewire_prop)),
-    parameters(std::move(model.parameters)),
-    // Others
-    ndays(model.ndays),
-    pb(std::move(model.pb)),
-    state_fun(std::move(model.state_fun)),
-    states_labels(std::move(model.states_labels)),
-    initial_states_fun(std::move(model.initial_states_fun)),
-    nstates(model.nstates),
-    verbose(model.verbose),
-    current_date(std::move(model.current_date)),
-    globalevents(std::move(model.globalevents)),
-    queue(std::move(model.queue)),
-    use_queuing(model.use_queuing),
-    sim_id(model.sim_id),
-    contact_tracing(std::move(model.contact_tracing)),
-    use_contact_tracing(model.use_contact_tracing),
-    contact_tracing_max_contacts(model.contact_tracing_max_contacts)
+inline Model<TSeq> & Model<TSeq>::run_multiple(
+    epiworld_fast_uint ndays,
+    epiworld_fast_uint nexperiments,
+    int seed_,
+    std::function<void(size_t,Model<TSeq>*)> fun,
+    bool reset,
+    bool verbose,
+    #ifdef _OPENMP
+    int nthreads
+    #else
+    int
+    #endif
+)
 {
 
-    db.model = this;
-    db.user_data.model = this;
+    if (seed_ >= 0)
+        this->seed(seed_);
+
+    if (nexperiments == 0u)
+        throw std::logic_error("The number of experiments must be above 0.");
+
+    // Seeds will be reproducible by default
+    std::vector< int > seeds_n(nexperiments);
+    for (auto & s : seeds_n)
+    {
+        s = static_cast<int>(
+            std::floor(
+                runif() * static_cast<double>(std::numeric_limits<int>::max())
+                )
+        );
+    }
+    // #endif
+
+    if (verbose)
+    {
+        EPI_DEBUG_NOTIFY_ACTIVE()
+    }
+
+    bool old_verb = this->verbose;
+    verbose_off();
 
-    if (use_queuing)
-        queue.model = this;
+    // Setting up backup
+    if (reset)
+        set_backup();
 
-}
+    Progress pb_multiple(
+        static_cast<int>(nexperiments),
+        EPIWORLD_PROGRESS_BAR_WIDTH
+        );
 
-template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::operator=(const Model<TSeq> & m)
-{
-    if (this == &m)
-        return *this;
+    #ifdef _OPENMP
+    // Not more than the number of experiments
+    nthreads =
+        static_cast<size_t>(nthreads) > nexperiments ? nexperiments : nthreads;
+    #endif
 
-    name = m.name;
+    if (verbose)
+    {
 
-    population        = m.population;
-    population_backup = m.population_backup;
+        #ifdef _OPENMP
+        printf_epiworld(
+            "Starting multiple runs (%i) using %i thread(s)\n",
+            static_cast<int>(nexperiments),
+            static_cast<int>(nthreads)
+        );
+        #else
+        printf_epiworld(
+            "Starting multiple runs (%i)\n",
+            static_cast<int>(nexperiments)
+        );
+        #endif
 
-    db = m.db;
-    db.model = this;
-    db.user_data.model = this;
+        pb_multiple.start();
 
-    directed = m.directed;
+    }
 
-    viruses.clear();
-    viruses.reserve(m.viruses.size());
-    for (const auto & v : m.viruses)
-        viruses.emplace_back(std::shared_ptr<Virus<TSeq>>(v->clone_ptr()));
+    // Seeds are bound to the replicate id, so the results don't depend on
+    // which thread runs which replicate
+    auto run_replicate = [&seeds_n, ndays](size_t run_id, Model<TSeq> * model) -> void {
+        model->set_sim_id(run_id);
+        model->run(ndays, seeds_n[run_id]);
+    };
 
-    tools.clear();
-    tools.reserve(m.tools.size());
-    for (const auto & t : m.tools)
-        tools.emplace_back(std::shared_ptr<Tool<TSeq>>(t->clone_ptr()));
+    size_t n_done_here = run_jobs(
+        nexperiments,
+        #ifdef _OPENMP
+        nthreads,
+        #else
+        1,
+        #endif
+        run_replicate, fun, pb_multiple, verbose
+    );
 
-    entities        = m.entities;
+    // Adjusting the number of replicates (run() counts those of this model)
+    n_replicates += (nexperiments - n_done_here);
 
-    rewire_fun  = m.rewire_fun;
-    rewire_prop = m.rewire_prop;
+    if (old_verb)
+        verbose_on();
 
-    parameters = m.parameters;
-    ndays      = m.ndays;
-    pb         = m.pb;
+    return *this;
 
-    state_fun    = m.state_fun;
-    states_labels = m.states_labels;
-    initial_states_fun = m.initial_states_fun;
-    nstates       = m.nstates;
+}
 
-    verbose     = m.verbose;
+template<typename TSeq>
+inline void Model<TSeq>::update_state() {
 
-    current_date = m.current_date;
+    EPI_PROFILE_SCOPE(profile, UpdateState)
 
-    globalevents.clear();
-    globalevents.reserve(m.globalevents.size());
-    for (const auto & ge : m.globalevents)
-        globalevents.emplace_back(std::shared_ptr<GlobalEvent<TSeq>>(ge->clone_ptr()));
+    if (use_parallel_update)
+    {
+        update_state_parallel();
+        events_run();
+        return;
+    }
 
-    queue = m.queue;
-    use_queuing = m.use_queuing;
+    // Built-in models skip the std::function calls
+    if (update_state_static())
+    {
+        events_run();
+        return;
+    }
 
-    contact_tracing = m.contact_tracing
-        ? std::make_unique<ContactTracing>(*m.contact_tracing)
-        : nullptr;
-    use_contact_tracing = m.use_contact_tracing;
-    contact_tracing_max_contacts = m.contact_tracing_max_contacts;
+    // Next state
+    if (use_queuing)
+    {
 
-    agents_data = m.agents_data;
-    agents_data_ncols = m.agents_data_ncols;
+        // Only agents in the queue (in ascending order)
+        const auto & active = queue.get_active_agents();
+        EPI_PROFILE_ADD(profile, AgentsVisited, active.size())
+        for (size_t i = 0u; i < active.size(); ++i)
+        {
+            const auto & fun = state_fun[agents_state[active[i]]];
+            if (fun)
+            {
+                EPI_PROFILE_ADD(profile, StateFunCalls, 1u)
+                fun(&population[active[i]], this);
+            }
+        }
 
-    rbinomd = m.rbinomd;
-    rbinomd_n = m.rbinomd_n;
-    rbinomd_fast_lambda = m.rbinomd_fast_lambda;
-    rbinomd_use_poisson = m.rbinomd_use_poisson;
+    }
+    else
+    {
 
-    // Figure out the queuing
-    if (use_queuing)
-        queue.model = this;
+        // Agents in states without an update function aren't loaded
+        EPI_PROFILE_ADD(profile, AgentsVisited, population.size())
+        for (size_t i = 0u; i < agents_state.size(); ++i)
+        {
+            const auto & fun = state_fun[agents_state[i]];
+            if (fun)
+            {
+                EPI_PROFILE_ADD(profile, StateFunCalls, 1u)
+                fun(&population[i], this);
+            }
+        }
 
-    sim_id = m.sim_id;
-    // Entity-agent relationships now use size_t IDs, so they copy
-    // correctly without any rebinding needed.
+    }
 
-    return *this;
+    events_run();
 
 }
 
 template<typename TSeq>
-inline DataBase<TSeq> & Model<TSeq>::get_db()
+inline bool Model<TSeq>::update_state_static()
 {
-    return db;
+    return false;
 }
 
 template<typename TSeq>
-inline const DataBase<TSeq> & Model<TSeq>::get_db() const
+template<UpdateFunPtr<TSeq>... Funs>
+inline bool Model<TSeq>::update_state_table()
 {
-    return db;
-}
 
+    constexpr size_t nfuns = sizeof...(Funs);
+    const UpdateFunPtr<TSeq> funs[nfuns] = {Funs...};
 
-template<typename TSeq>
-inline std::vector<Agent<TSeq>> & Model<TSeq>::get_agents()
-{
-    return population;
-}
+    // Only if the states still have the model's own functions
+    if (state_fun.size() < nfuns)
+        return false;
 
-template<typename TSeq>
-inline Agent<TSeq> & Model<TSeq>::get_agent(size_t i)
-{
-    return population[i];
-}
+    for (size_t s = 0u; s < nfuns; ++s)
+        if (!state_fun_is(s, funs[s]))
+            return false;
 
-template<typename TSeq>
-inline std::vector< epiworld_fast_uint > Model<TSeq>::get_agents_states() const
-{
-    std::vector< epiworld_fast_uint > states(population.size());
-    for (size_t i = 0u; i < population.size(); ++i)
-        states[i] = population[i].get_state();
+    if (use_queuing)
+    {
 
-    return states;
-}
+        const auto & active = queue.get_active_agents();
+        EPI_PROFILE_ADD(profile, AgentsVisited, active.size())
+        for (size_t i = 0u; i < active.size(); ++i)
+            if (state_fun[agents_state[active[i]]])
+                update_state_dispatch<0u, Funs...>(population[active[i]]);
 
-template<typename TSeq>
-inline std::vector< Viruses_const<TSeq> > Model<TSeq>::get_agents_viruses() const
-{
+    }
+    else
+    {
 
-    std::vector< Viruses_const<TSeq> > viruses(population.size());
-    for (size_t i = 0u; i < population.size(); ++i)
-        viruses[i] = population[i].get_virus();
+        EPI_PROFILE_ADD(profile, AgentsVisited, population.size())
+        for (size_t i = 0u; i < agents_state.size(); ++i)
+            if (state_fun[agents_state[i]])
+                update_state_dispatch<0u, Funs...>(population[i]);
 
-    return viruses;
+    }
+
+    return true;
 
 }
 
-// Same as before, but the non const version
 template<typename TSeq>
-inline std::vector< Viruses<TSeq> > Model<TSeq>::get_agents_viruses()
+template<size_t I, UpdateFunPtr<TSeq> Fun, UpdateFunPtr<TSeq>... Funs>
+inline void Model<TSeq>::update_state_dispatch(Agent<TSeq> & p)
 {
 
-    std::vector< Viruses<TSeq> > viruses(population.size());
-    for (size_t i = 0u; i < population.size(); ++i)
-        viruses[i] = population[i].get_virus();
+    if (p.state == I)
+    {
+        if constexpr (Fun != nullptr)
+        {
+            EPI_PROFILE_ADD(profile, StateFunCalls, 1u)
+            Fun(&p, this);
+        }
 
-    return viruses;
+        return;
+    }
+
+    if constexpr (sizeof...(Funs) > 0u)
+        update_state_dispatch<I + 1u, Funs...>(p);
+    else if (state_fun[p.state])
+    {
+        EPI_PROFILE_ADD(profile, StateFunCalls, 1u)
+        state_fun[p.state](&p, this); // States added by the user
+    }
 
 }
 
 template<typename TSeq>
-inline std::vector<Entity<TSeq>> & Model<TSeq>::get_entities()
+inline bool Model<TSeq>::state_fun_is(
+    epiworld_fast_uint state,
+    UpdateFunPtr<TSeq> fun
+) const
 {
-    return entities;
+
+    const auto & f = state_fun[state];
+
+    if (fun == nullptr)
+        return !f;
+
+    const UpdateFunPtr<TSeq> * target = f.template target< UpdateFunPtr<TSeq> >();
+    return (target != nullptr) && (*target == fun);
+
 }
 
 template<typename TSeq>
-inline Entity<TSeq> & Model<TSeq>::get_entity(size_t i, int * entity_pos)
-{
+inline void Model<TSeq>::update_state_parallel() {
 
-    for (size_t j = 0u; j < entities.size(); ++j)
-        if (entities[j].get_id() == static_cast<int>(i))
+    const std::vector< size_t > * active = use_queuing ?
+        &queue.get_active_agents() : nullptr;
+
+    const size_t n = (active != nullptr) ? active->size() : population.size();
+    EPI_PROFILE_ADD(profile, AgentsVisited, n)
+
+    const size_t nthreads = static_cast< size_t >(parallel_update_nthreads);
+    if (events_threads.size() < nthreads)
+    {
+        events_threads.resize(nthreads);
+        engines_threads.resize(nthreads);
+    }
+
+    // Streams are keyed by (seed, sim_id) and positioned at (agent, day),
+    // so an agent's draws don't depend on which thread makes them.
+    const uint64_t key = rng_seed ^
+        (static_cast< uint64_t >(sim_id) * 0x9e3779b97f4a7c15ULL);
+
+    for (auto & eng : engines_threads)
+        eng.seed(key);
+
+    const uint32_t day = static_cast< uint32_t >(current_date);
+
+    std::vector< std::exception_ptr > errors(nthreads);
+
+    array_double_tmp.split(true, nthreads);
+    array_virus_tmp.split(true, nthreads);
+    in_parallel_update = true;
+
+    #pragma omp parallel num_threads(parallel_update_nthreads)
+    {
+
+        #ifdef _OPENMP
+        const size_t iam = static_cast< size_t >(omp_get_thread_num());
+        #else
+        const size_t iam = 0u;
+        #endif
+
+        // Static scheduling assigns contiguous blocks of agents to threads
+        // in thread order, so concatenating the buffers preserves the
+        // agent order.
+        #pragma omp for schedule(static)
+        for (size_t k = 0u; k < n; ++k)
         {
 
-            if (entity_pos)
-                *entity_pos = j;
+            if (errors[iam])
+                continue;
 
-            return entities[j];
+            const size_t i = (active != nullptr) ? (*active)[k] : k;
+            if (!state_fun[agents_state[i]])
+                continue;
+
+            auto & p = population[i];
+
+            engines_threads[iam].set_stream(static_cast< uint64_t >(i), day);
+            EPI_PROFILE_ADD(profile, StateFunCalls, 1u)
+
+            try
+            {
+                state_fun[p.state](&p, this);
+            }
+            catch (...)
+            {
+                errors[iam] = std::current_exception();
+            }
 
         }
 
-    throw std::range_error("The entity with id " + std::to_string(i) + " was not found.");
+    }
+
+    in_parallel_update = false;
+    array_double_tmp.split(false);
+    array_virus_tmp.split(false);
+
+    for (auto & e : errors)
+        if (e)
+        {
+            for (auto & buffer : events_threads)
+                buffer.clear();
+            std::rethrow_exception(e);
+        }
+
+    // Merging the buffers
+    for (auto & buffer : events_threads)
+    {
+        for (auto & e : buffer)
+            _add_event(
+                e.agent, std::move(e.virus), std::move(e.tool), e.entity,
+                e.new_state, e.queue, e.action
+            );
+
+        buffer.clear();
+    }
 
 }
 
-template<typename TSeq>
-inline const Entity<TSeq> & Model<TSeq>::get_entity(size_t i, int * entity_pos) const
-{
-    for (size_t j = 0u; j < entities.size(); ++j)
-        if (entities[j].get_id() == static_cast<int>(i))
+template<typename TSeq>
+inline void Model<TSeq>::mutate_virus() {
+
+    EPI_PROFILE_SCOPE(profile, MutateVirus)
+
+    // Checking if any virus has mutation
+    size_t nmutates = 0u;
+    for (const auto & v: viruses)
+        if (v->strain->mutation)
+            nmutates++;
+
+    if (nmutates == 0u)
+        return;
+
+    if (use_queuing)
+    {
+
+        const auto & active = queue.get_active_agents();
+        for (size_t i = 0u; i < active.size(); ++i)
+        {
+
+            auto & p = population[active[i]];
+            if (p.virus != nullptr)
+                p.virus->mutate(this);
+
+        }
+
+    }
+    else
+    {
+
+        for (auto & p: population)
         {
 
-            if (entity_pos)
-                *entity_pos = j;
-
-            return entities[j];
+            if (p.virus != nullptr)
+                p.virus->mutate(this);
 
         }
 
-    throw std::range_error("The entity with id " + std::to_string(i) + " was not found.");
+    }
+
 
 }
 
 template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::agents_smallworld(
-    epiworld_fast_uint n,
-    epiworld_fast_uint k,
-    bool d,
-    epiworld_double p
-)
-{
+inline size_t Model<TSeq>::get_n_viruses() const {
+    return db.size();
+}
 
-    agents_from_adjlist(
-        rgraph_smallworld(n, k, p, d, *this)
-    );
+template<typename TSeq>
+inline size_t Model<TSeq>::get_n_tools() const {
+    return tools.size();
+}
 
-    return *this;
+template<typename TSeq>
+inline epiworld_fast_uint Model<TSeq>::get_ndays() const {
+    return ndays;
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::agents_empty_graph(
-    epiworld_fast_uint n
-)
+inline epiworld_fast_uint Model<TSeq>::get_n_replicates() const
 {
-
-
-    // Resizing the people
-    population.clear();
-    population.resize(n);
-
-    // Filling the model and ids
-    size_t i = 0u;
-    for (auto & p : population)
-    {
-        p.id = i++;
-    }
-
-
+    return n_replicates;
 }
 
 template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::agents_sbm(
-    const std::vector< size_t > & block_sizes,
-    const std::vector< double > & mixing_matrix,
-    bool row_major
-)
+inline size_t Model<TSeq>::get_sim_id() const
 {
-
-    agents_from_adjlist(
-        rgraph_sbm(block_sizes, mixing_matrix, row_major, *this)
-    );
-
-    return *this;
+    return sim_id;
 }
 
 template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::agents_bernoulli(
-    epiworld_fast_uint n,
-    epiworld_double p,
-    bool d
-)
+inline void Model<TSeq>::set_sim_id(size_t id)
 {
+    sim_id = id;
+}
 
-    agents_from_adjlist(
-        rgraph_bernoulli(n, p, d, *this)
-    );
-
-    return *this;
+template<typename TSeq>
+inline size_t Model<TSeq>::get_n_entities() const {
+    return entities.size();
 }
 
 template<typename TSeq>
-inline epiworld_double Model<TSeq>::operator()(std::string pname) {
+inline void Model<TSeq>::set_ndays(epiworld_fast_uint ndays) {
+    this->ndays = ndays;
+}
 
-    if (parameters.find(pname) == parameters.end())
-        throw std::range_error("The parameter '"+ pname + "' is not in the model.");
+template<typename TSeq>
+inline bool Model<TSeq>::get_verbose() const {
+    return verbose;
+}
 
-    return parameters[pname];
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::verbose_on() {
+    verbose = true;
+    return *this;
+}
 
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::verbose_off() {
+    verbose = false;
+    return *this;
 }
 
 template<typename TSeq>
-inline size_t Model<TSeq>::size() const {
-    return population.size();
+inline void Model<TSeq>::set_rewire_fun(
+    std::function<void(std::vector<Agent<TSeq>>*,Model<TSeq>*,epiworld_double)> fun
+    ) {
+    rewire_fun = fun;
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::dist_virus()
+inline void Model<TSeq>::set_rewire_prop(epiworld_double prop)
 {
 
-    for (auto & v: viruses)
-    {
+    if (prop < 0.0)
+        throw std::range_error("Proportions cannot be negative.");
 
-        v->distribute(this);
+    if (prop > 1.0)
+        throw std::range_error("Proportions cannot be above 1.0.");
 
-        // Apply the events
-        events_run();
-    }
+    rewire_prop = prop;
+}
 
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::get_rewire_prop() const {
+    return rewire_prop;
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::dist_tools()
-{
+inline void Model<TSeq>::rewire() {
 
-    for (auto & tool: tools)
-    {
+    EPI_PROFILE_SCOPE(profile, Rewire)
 
-        tool->distribute(this);
+    if (rewire_fun)
+        rewire_fun(&population, this, rewire_prop);
+}
 
-        // Apply the events
-        events_run();
 
-    }
+template<typename TSeq>
+inline void Model<TSeq>::write_data(
+    std::string fn_virus_info,
+    std::string fn_virus_hist,
+    std::string fn_tool_info,
+    std::string fn_tool_hist,
+    std::string fn_total_hist,
+    std::string fn_transmission,
+    std::string fn_transition,
+    std::string fn_reproductive_number,
+    std::string fn_generation_time,
+    std::string fn_active_cases,
+    std::string fn_outbreak_size,
+    std::string fn_hospitalizations
+    ) const
+{
+
+    db.write_data(
+        fn_virus_info, fn_virus_hist,
+        fn_tool_info, fn_tool_hist,
+        fn_total_hist, fn_transmission, fn_transition,
+        fn_reproductive_number, fn_generation_time,
+        fn_active_cases, fn_outbreak_size,
+        fn_hospitalizations
+        );
 
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::dist_entities()
+inline void Model<TSeq>::write_edgelist(
+    std::string fn
+    ) const
 {
 
-    for (auto & entity: entities)
-    {
-
-        entity.distribute(this);
+    // Figuring out the writing sequence
+    std::vector< const Agent<TSeq> * > wseq(size());
+    for (const auto & p: population)
+        wseq[p.id] = &p;
 
-        // Apply the events
-        events_run();
+    std::ofstream efile(fn, std::ios_base::out);
+    efile << "source target\n";
+    if (this->is_directed())
+    {
 
-    }
+        for (const auto & p : wseq)
+        {
 
-}
+            const epiworld_agent_index * neighbors = network->neighbors(p->id);
+            for (size_t n = 0u; n < p->n_neighbors; ++n)
+                efile << p->id << " " << neighbors[n] << "\n";
+        }
 
-template<typename TSeq>
-inline void Model<TSeq>::chrono_start() {
-    time_start = std::chrono::steady_clock::now();
-}
+    } else {
 
-template<typename TSeq>
-inline void Model<TSeq>::chrono_end() {
-    time_end = std::chrono::steady_clock::now();
-    time_elapsed += (time_end - time_start);
-    n_replicates++;
-}
+        for (const auto & p : wseq)
+        {
 
-template<typename TSeq>
-inline void Model<TSeq>::set_backup()
-{
+            const epiworld_agent_index * neighbors = network->neighbors(p->id);
+            for (size_t n = 0u; n < p->n_neighbors; ++n)
+                if (static_cast<int>(p->id) <= static_cast<int>(neighbors[n]))
+                    efile << p->id << " " << neighbors[n] << "\n";
+        }
 
-    if (population_backup.size() == 0u)
-        population_backup = std::vector< Agent<TSeq> >(population);
+    }
 
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::add_virus(
-    Virus<TSeq> & v
-    )
-{
-
-    // Checking the state
-    epiworld_fast_int init_, post_, rm_;
-    v.get_state(&init_, &post_, &rm_);
-
-    if (init_ == -99)
-        throw std::logic_error(
-            "The virus \"" + v.get_name() + "\" has no -init- state."
-            );
-    else if (post_ == -99)
-        throw std::logic_error(
-            "The virus \"" + v.get_name() + "\" has no -post- state."
-            );
+inline void Model<TSeq>::write_edgelist(
+std::vector< int > & source,
+std::vector< int > & target
+) const {
 
-    // Recording the variant
-    db.record_virus(v);
+    // Figuring out the writing sequence
+    std::vector< const Agent<TSeq> * > wseq(size());
+    for (const auto & p: population)
+        wseq[p.id] = &p;
 
-    // Adding new virus
-    auto cloned = v.clone_ptr();
-    viruses.push_back(std::shared_ptr<Virus<TSeq>>(std::move(cloned)));
+    if (this->is_directed())
+    {
 
-}
+        for (const auto & p : wseq)
+        {
+            const epiworld_agent_index * neighbors = network->neighbors(p->id);
+            for (size_t n = 0u; n < p->n_neighbors; ++n)
+            {
+                source.push_back(static_cast<int>(p->id));
+                target.push_back(static_cast<int>(neighbors[n]));
+            }
+        }
 
-template<typename TSeq>
-inline void Model<TSeq>::add_tool(Tool<TSeq> & t)
-{
+    } else {
 
+        for (const auto & p : wseq)
+        {
 
-    db.record_tool(t);
+            const epiworld_agent_index * neighbors = network->neighbors(p->id);
+            for (size_t n = 0u; n < p->n_neighbors; ++n) {
+                if (static_cast<int>(p->id) <= static_cast<int>(neighbors[n])) {
+                    source.push_back(static_cast<int>(p->id));
+                    target.push_back(static_cast<int>(neighbors[n]));
+                }
+            }
+        }
+
+    }
 
-    // Adding the tool to the model (and database.)
-    auto cloned = t.clone_ptr();
-    tools.push_back(std::shared_ptr<Tool<TSeq>>(std::move(cloned)));
 
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::add_entity(Entity<TSeq> e)
+inline std::map<std::string,epiworld_double> & Model<TSeq>::params()
 {
 
-    e.id = entities.size();
-    entities.push_back(e);
+    // Binding the parameters added through a previous call
+    parameters_ptrs_update();
+
+    return parameters;
 
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::rm_entity(size_t entity_id)
-{
-
-    int entity_pos = 0;
-    auto & entity = this->get_entity(entity_id, &entity_pos);
+inline void Model<TSeq>::reset() {
 
-    // First, resetting the entity
-    entity.reset();
 
-    // How should
-    if (entity_pos != (static_cast<int>(entities.size()) - 1))
-        std::swap(entities[entity_pos], entities[entities.size() - 1]);
+    // Restablishing people
+    pb = Progress(ndays, 80);
 
-    entities.pop_back();
-}
+    // Only the network needs a backup; the rest of the agents' data
+    // is reset in place, keeping the memory already allocated.
+    if (network_backup && (network != network_backup))
+    {
+        network = network_backup;
+        for (auto & p : population)
+            p.n_neighbors = network->degree(p.id);
+    }
 
-template<typename TSeq>
-inline void Model<TSeq>::rm_virus(size_t virus_pos)
-{
+    for (auto & p : population)
+        p.reset();
 
-    if (viruses.size() <= virus_pos)
-        throw std::range_error(
-            std::string("The specified virus (") +
-            std::to_string(virus_pos) +
-            std::string(") is out of range. ") +
-            std::string("There are only ") +
-            std::to_string(viruses.size()) +
-            std::string(" viruses.")
-            );
+    agents_state.assign(population.size(), 0u);
 
-    // Flipping with the last one
-    std::swap(viruses[virus_pos], viruses[viruses.size() - 1]);
-    viruses.pop_back();
+    #ifdef EPI_DEBUG
+    for (auto & a: population)
+    {
+        if (a.get_state() != 0u)
+            throw std::logic_error("Model::reset population doesn't match."
+                "Some agents are not in the baseline state.");
+    }
+    #endif
 
-    return;
+    for (auto & e: entities)
+        e.reset();
 
-}
+    current_date = 0;
 
-template<typename TSeq>
-inline void Model<TSeq>::rm_tool(size_t tool_pos)
-{
+    db.reset();
 
-    if (tools.size() <= tool_pos)
-        throw std::range_error(
-            std::string("The specified tool (") +
-            std::to_string(tool_pos) +
-            std::string(") is out of range. ") +
-            std::string("There are only ") +
-            std::to_string(tools.size()) +
-            std::string(" tools.")
-            );
+    // This also clears the queue
+    if (use_queuing)
+        queue.reset();
 
-    // Flipping with the last one
-    std::swap(tools[tool_pos], tools[tools.size() - 1]);
+    // Reset contact tracing if active
+    if (use_contact_tracing)
+        contact_tracing = std::make_unique<ContactTracing>(
+            population.size(), contact_tracing_max_contacts
+        );
 
-    /* There's an error on windows:
-    https://github.com/UofUEpiBio/epiworldR/actions/runs/4801482395/jobs/8543744180#step:6:84
+    // Re distributing tools and virus
+    dist_entities();
+    dist_virus();
+    dist_tools();
 
-    More clear here:
-    https://stackoverflow.com/questions/58660207/why-doesnt-stdswap-work-on-vectorbool-elements-under-clang-win
-    */
+    // Distributing initial state, if specified
+    initial_states_fun(this);
 
-    tools.pop_back();
+    // Recording day 0 and advancing to day 1 is handled by Model::run().
+    // Keeping reset() side-effect free from virtual next() prevents
+    // derived-model update code from running before derived reset state
+    // is fully initialized.
 
-    return;
 
 }
 
-template<typename TSeq>
-inline void Model<TSeq>::load_agents_entities_ties(
-    std::string fn,
-    int skip
-    )
-{
+// Too big to keep here
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
+ Start of -include/epiworld/model-meat-print.hpp-
 
-    int i,j;
-    std::ifstream filei(fn);
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    if (!filei)
-        throw std::logic_error("The file " + fn + " was not found.");
 
-    int linenum = 0;
-    std::vector< std::vector< epiworld_fast_uint > > target_(entities.size());
+#ifndef EPIWORLD_MODEL_MEAT_PRINT_HPP
+#define EPIWORLD_MODEL_MEAT_PRINT_HPP
 
-    target_.reserve(1e5);
+template<typename TSeq>
+inline const Model<TSeq> & Model<TSeq>::print(bool lite) const
+{
 
-    while (!filei.eof())
+    // Horizontal line
+    std::string line = "";
+    for (epiworld_fast_uint i = 0u; i < 80u; ++i)
+        line += "_";
+
+    // Prints a message if debugging is on
+    EPI_DEBUG_NOTIFY_ACTIVE()
+
+    printf_epiworld("%s\n",line.c_str());
+
+    if (lite)
     {
+        // Printing the name of the model
+        printf_epiworld("%s", name.c_str());
 
-        if (linenum++ < skip)
-            continue;
+        // Printing the number of agents, viruses, and tools
+        printf_epiworld(
+            "\nIt features %i agents, %i virus(es), and %i tool(s).\n",
+            static_cast<int>(size()),
+            static_cast<int>(get_n_viruses()),
+            static_cast<int>(get_n_tools())
+            );
 
-        filei >> i >> j;
+        printf_epiworld(
+            "The model has %i states.",
+            static_cast<int>(nstates)
+            );
 
-        // Looking for exceptions
-        if (filei.bad())
-            throw std::logic_error(
-                "I/O error while reading the file " +
-                fn
+        if (today() != 0)
+        {
+            printf_epiworld(
+                "\nThe final distribution is: "
             );
 
-        if (filei.fail())
-            break;
+            int nstate_int = static_cast<int>(nstates);
 
-        if (i >= static_cast<int>(this->size()))
-            throw std::range_error(
-                "The agent["+std::to_string(linenum)+"] = " + std::to_string(i) +
-                " is above the max id " + std::to_string(this->size() - 1)
+            for (int i = 0u; i < nstate_int; ++i)
+            {
+                printf_epiworld(
+                    "%i %s%s",
+                    static_cast<int>(db.today_total[ i ]),
+                    states_labels[i].c_str(),
+                    (
+                        i == (nstate_int - 2)
+                        ) ? ", and " : (
+                            (i == (nstate_int - 1)) ? ".\n" : ", "
+                            )
                 );
+            }
+        } else {
+            printf_epiworld(" The model hasn't been run yet.\n");
+        }
 
-        if (j >= static_cast<int>(this->entities.size()))
-            throw std::range_error(
-                "The entity["+std::to_string(linenum)+"] = " + std::to_string(j) +
-                " is above the max id " + std::to_string(this->entities.size() - 1)
-                );
+        return *this;
+    }
 
-        target_[j].push_back(i);
+    printf_epiworld("%s\n%s\n\n",line.c_str(), "SIMULATION STUDY");
 
-        population[i].add_entity(*this, entities[j]);
+    printf_epiworld("Name of the model   : %s\n", (this->name == "") ? std::string("(none)").c_str() : name.c_str());
+    printf_epiworld("Population size     : %i\n", static_cast<int>(size()));
+
+    auto ncols = get_agents_data_ncols();
 
+    if (ncols > 0)
+    {
+        printf_epiworld("Agents' data loaded : yes (%i columns/features)\n", static_cast<int>(ncols));
+    }
+    else
+    {
+        printf_epiworld("Agents' data        : (none)\n");
+    }
+
+    printf_epiworld("Number of entities  : %i\n", static_cast<int>(entities.size()));
+    printf_epiworld("Days (duration)     : %i (of %i)\n", today(), static_cast<int>(ndays));
+    printf_epiworld("Number of viruses   : %i\n", static_cast<int>(db.get_n_viruses()));
+    if (n_replicates > 0u)
+    {
+        std::string abbr;
+        epiworld_double elapsed;
+        epiworld_double total;
+        get_elapsed("auto", &elapsed, &total, &abbr, false);
+        printf_epiworld("Last run elapsed t  : %.2f%s\n", elapsed, abbr.c_str());
+        if (n_replicates > 1u)
+        {
+            printf_epiworld("Total elapsed t     : %.2f%s (%i runs)\n", total, abbr.c_str(), static_cast<int>(n_replicates));
+        }
+
+        // Elapsed time in speed
+        get_elapsed("microseconds", &elapsed, &total, &abbr, false);
+        printf_epiworld("Last run speed      : %.2f million agents x day / second\n",
+            static_cast<double>(this->size()) *
+            static_cast<double>(this->get_ndays()) /
+            static_cast<double>(elapsed)
+            );
+        if (n_replicates > 1u)
+        {
+            printf_epiworld("Average run speed   : %.2f million agents x day / second\n",
+                static_cast<double>(this->size()) *
+                static_cast<double>(this->get_ndays()) *
+                static_cast<double>(n_replicates) /
+                static_cast<double>(total)
+            );
+        }
+
+    } else {
+        printf_epiworld("Last run elapsed t  : -\n");
+    }
+    
+    
+    if (rewire_fun)
+    {
+        printf_epiworld("Rewiring            : on (%.2f)\n", rewire_prop);
+    } else {
+        printf_epiworld("Rewiring            : off\n");
+    }
+
+    printf_epiworld("Last seed used      : %i\n\n", static_cast<int>(last_seed));
+    
+    // Printing Global events
+    printf_epiworld("Global events:\n");
+    for (auto & a : globalevents)
+    {
+        if (a->get_day() < 0)
+        {
+            printf_epiworld(" - %s (runs daily)\n", a->get_name().c_str());
+        } else {
+            printf_epiworld(" - %s (day %i)\n", a->get_name().c_str(), a->get_day());
+        }
     }
 
-    return;
+    if (globalevents.size() == 0u)
+    {
+        printf_epiworld(" (none)\n");
+    }
 
-}
+    printf_epiworld("\nVirus(es):\n");
+    size_t n_viruses_model = viruses.size();
+    for (size_t i = 0u; i < n_viruses_model; ++i)
+    {    
 
-template<typename TSeq>
-inline void Model<TSeq>::load_agents_entities_ties(
-    const std::vector< int > & agents_ids,
-    const std::vector< int > & entities_ids
-) {
+        
+        const auto & virus = viruses[i];
+        if ((n_viruses_model > 10) && (i >= 10))
+        {
+            printf_epiworld(" ...and %i more viruses...\n",
+                static_cast<int>(n_viruses_model) - 
+                static_cast<int>(i)
+                );
+            break;
+        }
 
+        if (i < n_viruses_model)
+        {
 
-    // Checking the size
-    if (agents_ids.size() != entities_ids.size())
-        throw std::length_error(
-            std::string("The size of agents_ids (") +
-            std::to_string(agents_ids.size()) +
-            std::string(") and entities_ids (") +
-            std::to_string(entities_ids.size()) +
-            std::string(") must be the same.")
+            printf_epiworld(
+                " - %s\n",
+                virus->get_name().c_str()
             );
 
-    return this->load_agents_entities_ties(
-        agents_ids.data(),
-        entities_ids.data(),
-        agents_ids.size()
-    );
+        } else {
 
-}
+            printf_epiworld(
+                " - %s (originated in the model...)\n",
+                virus->get_name().c_str()
+            );
 
-template<typename TSeq>
-inline void Model<TSeq>::load_agents_entities_ties(
-    const int * agents_ids,
-    const int * entities_ids,
-    size_t n
-) {
+        }
 
+    }
 
-    auto get_agent = [agents_ids](int i) -> int {
-        return *(agents_ids + i);
-        };
+    auto nvariants = db.get_n_viruses() - n_viruses_model;
+    if (nvariants > 0)
+    {
 
-    auto get_entity = [entities_ids](int i) -> int {
-        return *(entities_ids + i);
-        };
+        printf_epiworld(" ...and %i more variants...\n", static_cast<int>(nvariants));
 
-    for (size_t i = 0u; i < n; ++i)
-    {
+    }
 
-        if (get_agent(i) < 0)
-            throw std::length_error(
-                std::string("agents_ids[") +
-                std::to_string(i) +
-                std::string("] = ") +
-                std::to_string(get_agent(i)) +
-                std::string(" is negative.")
-                );
+    if (viruses.size() == 0u)
+    {
+        printf_epiworld(" (none)\n");
+    }
 
-        if (get_entity(i) < 0)
-            throw std::length_error(
-                std::string("entities_ids[") +
-                std::to_string(i) +
-                std::string("] = ") +
-                std::to_string(get_entity(i)) +
-                std::string(" is negative.")
-                );
+    printf_epiworld("\nTool(s):\n");
+    size_t n_tools_model = tools.size();
+    for (size_t i = 0u; i < tools.size(); ++i)
+    {   
+        const auto & tool = tools[i];
 
-        int pop_size = static_cast<int>(this->population.size());
-        if (get_agent(i) >= pop_size)
-            throw std::length_error(
-                std::string("agents_ids[") +
-                std::to_string(i) +
-                std::string("] = ") +
-                std::to_string(get_agent(i)) +
-                std::string(" is out of range (population size: ") +
-                std::to_string(pop_size) +
-                std::string(").")
+        if ((n_tools_model > 10) && (i >= 10))
+        {
+            printf_epiworld(
+                " ...and %i more tools...\n",
+                static_cast<int>(n_tools_model) - static_cast<int>(i)
                 );
+            break;
+        }
 
-        int ent_size = static_cast<int>(this->entities.size());
-        if (get_entity(i) >= ent_size)
-            throw std::length_error(
-                std::string("entities_ids[") +
-                std::to_string(i) +
-                std::string("] = ") +
-                std::to_string(get_entity(i)) +
-                std::string(" is out of range (entities size: ") +
-                std::to_string(ent_size) +
-                std::string(").")
+        if (i < n_tools_model)
+        {
+            printf_epiworld(
+                " - %s\n",
+                tool->get_name().c_str()
                 );
 
-        // Adding the entity to the agent
-        this->population[get_agent(i)].add_entity(
-            *this,
-            this->entities[get_entity(i)]
-        );
 
-    }
+        } else {
 
-    return;
+            printf_epiworld(
+                " - %s (originated in the model...)\n",
+                tool->get_name().c_str()
+            );
 
+        }
+        
 
-}
+    }
 
-template<typename TSeq>
-inline void Model<TSeq>::agents_from_adjlist(
-    std::string fn,
-    int size,
-    int skip,
-    bool directed
-    ) {
+    if (tools.size() == 0u)
+    {
+        printf_epiworld(" (none)\n");
+    }
 
+    // Information about the parameters included
+    printf_epiworld("\nModel parameters:\n");
+    epiworld_fast_uint nchar = 0u;
+    for (auto & p : parameters)
+        if (p.first.length() > nchar)
+            nchar = p.first.length();
 
-    AdjList al;
-    al.read_edgelist(fn, size, skip, directed);
-    this->agents_from_adjlist(al);
+    std::string fmt = " - %-" + std::to_string(nchar + 1) + "s: ";
+    for (auto & p : parameters)
+    {
+        std::string fmt_tmp = fmt;
+        if (std::fabs(p.second) < 0.0001)
+            fmt_tmp += "%.1e\n";
+        else
+            fmt_tmp += "%.4f\n";
 
-}
+        printf_epiworld(
+            fmt_tmp.c_str(),
+            p.first.c_str(),
+            p.second
+        );
+        
+    }
 
-template<typename TSeq>
-inline void Model<TSeq>::agents_from_edgelist(
-    const std::vector< int > & source,
-    const std::vector< int > & target,
-    int size,
-    bool directed
-) {
+    if (parameters.size() == 0u)
+    {
+        printf_epiworld(" (none)\n");
+    }
 
+    nchar = 0u;
+    for (auto & p : states_labels)
+        if (p.length() > nchar)
+            nchar = p.length();
 
-    AdjList al(source, target, size, directed);
-    agents_from_adjlist(al);
+    
 
-}
+    if (today() != 0)
+    {
+        fmt =
+            std::string("  - (%") +
+                std::to_string(std::to_string(nstates).length()) +
+            std::string("d) %-") + std::to_string(nchar) +
+            std::string("s : %") +
+            std::to_string(std::to_string(size()).length()) +
+            std::string("i -> %i\n");
+    } else {
+        fmt =
+            std::string("  - (%") +
+                std::to_string(std::to_string(nstates).length()) +
+            std::string("d) %-") + std::to_string(nchar) +
+            std::string("s : %i\n");
+    }
+        
+    if (today() != 0)
+    {
+        printf_epiworld("\nDistribution of the population at time %i:\n", today());
+        for (size_t s = 0u; s < nstates; ++s)
+        {
 
-template<typename TSeq>
-inline void Model<TSeq>::agents_from_adjlist(AdjList al) {
+                printf_epiworld(
+                    fmt.c_str(),
+                    s,
+                    states_labels[s].c_str(),
+                    db.hist_total_counts[s],
+                    db.today_total[ s ]
+                    );
 
+        }
+    }
 
-    // Resizing the people
-    agents_empty_graph(al.vcount());
+    if (today() != 0)
+        (void) db.get_transition_probability(true);
 
-    const auto & tmpdat = al.get_dat();
+    return *this;
 
-    for (size_t i = 0u; i < tmpdat.size(); ++i)
-    {
+}
 
-        // population[i].id    = i;
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-        for (const auto & link: tmpdat[i])
-        {
+ End of -include/epiworld/model-meat-print.hpp-
 
-            population[i].add_neighbor(
-                population[link.first],
-                true, true
-                );
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-        }
 
-    }
 
-    #ifdef EPI_DEBUG
-    for (auto & p: population)
-    {
-        if (p.id >= static_cast<int>(al.vcount()))
-            throw std::logic_error(
-                "Agent's id cannot be negative above or equal to the number of agents!");
+template<typename TSeq>
+inline epiworld_fast_int Model<TSeq>::state_of(std::string_view name) {
+    for (std::size_t i = 0; i < states_labels.size(); ++i) {
+        if (states_labels[i] == name) {
+            return static_cast<epiworld_fast_int>(i);
+        }
     }
-    #endif
 
+    throw std::logic_error("The state " + std::string(name) + " was not found.");
 }
 
 template<typename TSeq>
-inline bool Model<TSeq>::is_directed() const
+inline epiworld_fast_int Model<TSeq>::add_state(
+    std::string lab,
+    UpdateFun<TSeq> fun
+)
 {
-    if (population.size() == 0u)
-        throw std::logic_error("The population hasn't been initialized.");
-
-    return directed;
-}
 
-template<typename TSeq>
-inline int Model<TSeq>::today() const {
+    // Checking it doesn't match
+    for (auto & s : states_labels)
+        if (s == lab)
+            throw std::logic_error("state \"" + s + "\" already registered.");
 
-    if (ndays == 0)
-      return 0;
+    states_labels.push_back(lab);
+    state_fun.push_back(fun);
 
-    return this->current_date;
+    return nstates++;
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::next() {
-
-    #ifdef EPI_DEBUG
-    // Checking all the agents have proper states
-    for (auto & p : population)
-    {
-        if ((p.state >= nstates) || (p.state < 0))
-        {
-            throw std::range_error(
-                "The agent " + std::to_string(p.id) +
-                " has state " + std::to_string(p.state) +
-                " which is above the maximum state of " +
-                std::to_string(nstates - 1) + "."
-            );
-        }
-
-        if ((p.state_prev >= nstates) || (p.state_prev < 0))
-        {
-            throw std::range_error(
-                "The agent " + std::to_string(p.id) +
-                " has previous state " + std::to_string(p.state_prev) +
-                " which is above the maximum state of " +
-                std::to_string(nstates - 1) + "."
-            );
-        }
-
-    }
+inline Model<TSeq> & Model<TSeq>::set_state_function(
+    epiworld_fast_uint state,
+    UpdateFun<TSeq> fun
+)
+{
 
-    #endif
+    if (state >= nstates)
+        throw std::range_error(
+            "The state " + std::to_string(state) + " is out of range. " +
+            "The model currently has " + std::to_string(nstates) + " states."
+        );
 
-    db.record();
-    ++this->current_date;
+    state_fun[state] = fun;
 
-    // Advancing the progress bar
-    if ((this->current_date >= 1) && verbose)
-        pb.next();
+    return *this;
 
-    return ;
 }
 
 template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::run(
-    epiworld_fast_uint ndays,
-    int seed
+inline Model<TSeq> & Model<TSeq>::set_state_function(
+    std::string_view name,
+    UpdateFun<TSeq> fun
 )
 {
 
-    // Set this model as the current model in scope for this thread.
-    // This enables Model::the() calls from agents, entities, etc.
+    return set_state_function(
+        static_cast<epiworld_fast_uint>(state_of(name)),
+        fun
+    );
 
-    if (size() == 0u)
-        throw std::logic_error("There are no agents in this model!");
+}
 
-    if (nstates == 0u)
-        throw std::logic_error(
-            std::string("No states registered in this model. ") +
-            std::string("At least one state should be included. See the ") +
-            std::string("function -Model::add_state()-")
-            );
+template<typename TSeq>
+inline const std::vector< std::string > &
+Model<TSeq>::get_states() const
+{
+    return states_labels;
+}
 
-    // Setting up the number of steps
-    this->ndays = ndays;
+template<typename TSeq>
+inline size_t Model<TSeq>::get_n_states() const
+{
+    return nstates;
+}
 
-    if (seed >= 0)
-        engine->seed(seed);
+template<typename TSeq>
+inline const std::vector< UpdateFun<TSeq> > &
+Model<TSeq>::get_state_fun() const
+{
+    return state_fun;
+}
 
-    last_seed = seed;
+template<typename TSeq>
+inline void Model<TSeq>::print_state_codes() const
+{
 
-    // Checking whether the proposed state in/out/removed
-    // are valid
-    epiworld_fast_int _init, _end, _removed;
-    int nstate_int = static_cast<int>(nstates);
+    // Horizontal line
+    std::string line = "";
+    for (epiworld_fast_uint i = 0u; i < 80u; ++i)
+        line += "_";
 
-    // Function to validate the states of viruses
-    // and tools.
-    auto check_init_states = [nstate_int](int x) -> void {
+    printf_epiworld("\n%s\nstates CODES\n\n", line.c_str());
 
-        if (((x != -99) && (x < 0)) || (x >= nstate_int))
-            throw std::range_error("States must be between 0 and " +
-                std::to_string(nstate_int - 1));
-    };
+    epiworld_fast_uint nchar = 0u;
+    for (auto & p : states_labels)
+        if (p.length() > nchar)
+            nchar = p.length();
 
-    for (auto & v : viruses)
+    std::string fmt = " %2i = %-" + std::to_string(nchar + 1 + 4) + "s\n";
+    for (epiworld_fast_uint i = 0u; i < nstates; ++i)
     {
-        v->get_state(&_init, &_end, &_removed);
 
-        check_init_states(_init);
-        check_init_states(_end);
-        check_init_states(_removed);
+        printf_epiworld(
+            fmt.c_str(),
+            i,
+            (states_labels[i] + " (S)").c_str()
+        );
 
     }
 
-    for (auto & t : tools)
-    {
-        t->get_state(&_init, &_end);
+}
 
-        check_init_states(_init);
-        check_init_states(_end);
 
-    }
 
-    // Starting first infection and tools
-    reset();
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::add_param(
+    epiworld_double initial_value,
+    std::string pname,
+    bool overwrite
+    ) {
 
-    // Record the baseline (day 0) and advance to day 1
-    next();
+    auto iter = parameters.find(pname);
+    if (iter == parameters.end())
+        iter = parameters.emplace(pname, initial_value).first;
+    else if (!overwrite)
+        throw std::logic_error("The parameter " + pname + " already exists.");
+    else
+        iter->second = initial_value;
 
-    // Initializing the simulation
-    chrono_start();
+    // Binding the id
+    size_t id = param_id(pname);
+    if (id >= parameters_ptrs.size())
+        parameters_ptrs.resize(id + 1u, nullptr);
 
-    // Verifying if the user wants to see the progress bar
-    if (get_verbose())
-    {
-        printf_epiworld("Running the model...\n");
-    }
+    parameters_ptrs[id] = &iter->second;
 
-    for (epiworld_fast_uint niter = 0; niter < get_ndays(); ++niter)
-    {
+    return initial_value;
 
-        #ifdef EPI_DEBUG
-        db.n_transmissions_potential = 0;
-        db.n_transmissions_today = 0;
-        #endif
+}
 
-        // We can execute these components in whatever order the
-        // user needs.
-        this->update_state();
+template<typename TSeq>
+inline void Model<TSeq>::parameters_ptrs_update()
+{
 
-        // We start with the Global events
-        this->run_globalevents();
+    parameters_ptrs.clear();
+    for (auto & p : parameters)
+    {
+        size_t id = param_id(p.first);
+        if (id >= parameters_ptrs.size())
+            parameters_ptrs.resize(id + 1u, nullptr);
 
-        // In this case we are applying degree sequence rewiring
-        // to change the network just a bit.
-        this->rewire();
+        parameters_ptrs[id] = &p.second;
+    }
 
-        // This locks all the changes
-        this->next();
+}
 
-        // Mutation must happen at the very end of all
-        this->mutate_virus();
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::read_params(std::string fn, bool overwrite)
+{
 
-    }
+    auto params_map = read_yaml<epiworld_double>(fn);
 
-    // The last reaches the end...
-    this->current_date--;
+    for (auto & p : params_map)
+        add_param(p.second, p.first, overwrite);
 
-    chrono_end();
+    return *this;
 
-    sim_id++;
+}
 
-    return *this;
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::get_param(const std::string & pname)
+{
+    const auto iter = parameters.find(pname);
+    if (iter == parameters.end())
+        throw std::logic_error("The parameter " + pname + " does not exists.");
 
+    return iter->second;
 }
 
 template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::run_multiple(
-    epiworld_fast_uint ndays,
-    epiworld_fast_uint nexperiments,
-    int seed_,
-    std::function<void(size_t,Model<TSeq>*)> fun,
-    bool reset,
-    bool verbose,
-    #ifdef _OPENMP
-    int nthreads
-    #else
-    int
-    #endif
-)
+inline void Model<TSeq>::set_param(const std::string & pname, epiworld_double value)
 {
+    const auto iter = parameters.find(pname);
+    if (iter == parameters.end())
+        throw std::logic_error("The parameter '" + pname + "' does not exists.");
 
-    if (seed_ >= 0)
-        this->seed(seed_);
+    iter->second = value;
 
-    if (nexperiments == 0u)
-        throw std::logic_error("The number of experiments must be above 0.");
+    return;
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::par(const std::string & pname) const
+{
+    const auto iter = parameters.find(pname);
+    if (iter == parameters.end())
+        throw std::logic_error("The parameter '" + pname + "' does not exists.");
+    return iter->second;
+}
 
-    // Seeds will be reproducible by default
-    std::vector< int > seeds_n(nexperiments);
-    for (auto & s : seeds_n)
-    {
-        s = static_cast<int>(
-            std::floor(
-                runif() * static_cast<double>(std::numeric_limits<int>::max())
-                )
-        );
-    }
-    // #endif
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::par(size_t id) const
+{
 
-    if (verbose)
-    {
-        EPI_DEBUG_NOTIFY_ACTIVE()
-    }
+    if ((id < parameters_ptrs.size()) && (parameters_ptrs[id] != nullptr))
+        return *parameters_ptrs[id];
 
-    bool old_verb = this->verbose;
-    verbose_off();
+    // Not bound yet (added through `params()`). This is a read only, as
+    // it may be called from the threads of the parallel update.
+    return par(param_name(id));
 
-    // Setting up backup
-    if (reset)
-        set_backup();
+}
 
-    #ifdef _OPENMP
+/**
+ * @brief Process-wide table of parameter names (see `Model::param_id()`).
+ */
+struct ParamIdsRegistry {
+    std::mutex mtx;
+    std::unordered_map< std::string, size_t > ids;
+    std::vector< std::unique_ptr< std::string > > names;
+};
 
-    // Not more than the number of experiments
-    nthreads =
-        static_cast<size_t>(nthreads) > nexperiments ? nexperiments : nthreads;
-    
-    omp_set_num_threads(nthreads);
+inline ParamIdsRegistry & param_ids_registry()
+{
+    static ParamIdsRegistry registry;
+    return registry;
+}
 
-    // Generating copies of the model (done serially to avoid races on original)
-    std::vector< std::unique_ptr< Model<TSeq> > > these;
+template<typename TSeq>
+inline size_t Model<TSeq>::param_id(const std::string & pname)
+{
 
-    for (size_t i = 1u; i < static_cast<size_t>(nthreads); ++i)
-    {
-        these.emplace_back(clone_ptr());
-    }
+    auto & reg = param_ids_registry();
+    std::lock_guard< std::mutex > lock(reg.mtx);
 
+    auto iter = reg.ids.find(pname);
+    if (iter != reg.ids.end())
+        return iter->second;
 
-    // Figuring out how many replicates - distribute remainder evenly
-    std::vector< size_t > nreplicates(nthreads, 0);
-    std::vector< size_t > nreplicates_csum(nthreads, 0);
+    size_t id = reg.names.size();
+    reg.names.emplace_back(std::make_unique< std::string >(pname));
+    reg.ids.emplace(pname, id);
 
-    size_t base_replicates = nexperiments / nthreads;
-    size_t remainder = nexperiments % nthreads;
+    return id;
 
-    size_t sums = 0u;
-    for (int i = 0; i < nthreads; ++i)
-    {
-        // Distribute remainder to first 'remainder' threads
-        nreplicates[i] = base_replicates + (static_cast<size_t>(i) < remainder ? 1 : 0);
+}
 
-        // This takes the cumsum
-        nreplicates_csum[i] = sums;
-        sums += nreplicates[i];
-    }
+template<typename TSeq>
+inline const std::string & Model<TSeq>::param_name(size_t id)
+{
 
-    Progress pb_multiple(
-        nreplicates[0u],
-        EPIWORLD_PROGRESS_BAR_WIDTH
+    auto & reg = param_ids_registry();
+    std::lock_guard< std::mutex > lock(reg.mtx);
+
+    if (id >= reg.names.size())
+        throw std::range_error(
+            "The parameter id " + std::to_string(id) + " is out of range."
         );
 
-    if (verbose)
-    {
+    return *reg.names[id];
 
-        printf_epiworld(
-            "Starting multiple runs (%i) using %i thread(s)\n",
-            static_cast<int>(nexperiments),
-            static_cast<int>(nthreads)
-        );
+}
 
-        pb_multiple.start();
+#define DURCAST(tunit,txtunit) {\
+        elapsed       = std::chrono::duration_cast<std::chrono:: tunit>(\
+            time_end - time_start).count(); \
+        elapsed_total = std::chrono::duration_cast<std::chrono:: tunit>(time_elapsed).count(); \
+        abbr_unit     = txtunit;}
 
-    }
+template<typename TSeq>
+inline const Profiler & Model<TSeq>::get_profile() const
+{
+    return profile;
+}
 
-    #ifdef EPI_DEBUG
-    // Checking the initial state of all the models. Throw an
-    // exception if they are not the same.
-    for (size_t i = 1; i < static_cast<size_t>(std::max(nthreads - 1, 0)); ++i)
-    {
+template<typename TSeq>
+inline const Profiler & Model<TSeq>::get_profile_total() const
+{
+    return profile_total;
+}
 
-        if (db != these[i]->db)
-        {
-            throw std::runtime_error(
-                "The initial state of the models is not the same"
-            );
-        }
-    }
-    #endif
+template<typename TSeq>
+inline void Model<TSeq>::get_elapsed(
+    std::string unit,
+    epiworld_double * last_elapsed,
+    epiworld_double * total_elapsed,
+    std::string * unit_abbr,
+    bool print
+) const {
+
+    // Preparing the result
+    epiworld_double elapsed, elapsed_total;
+    std::string abbr_unit;
 
-    #pragma omp parallel shared(these) \
-        firstprivate(nexperiments, nthreads, fun, reset, verbose, pb_multiple, \
-        ndays, nreplicates, nreplicates_csum, seeds_n) default(none)
+    // Figuring out the length
+    if (unit == "auto")
     {
 
-        auto iam = static_cast<size_t>(omp_get_thread_num());
-        Model<TSeq> * model_ptr = iam == 0 ? this : &(*these[iam - 1u]);
-        size_t my_replicates = nreplicates[iam];
-        size_t my_replicates_csum = nreplicates_csum[iam];
+        size_t tlength = std::to_string(
+            static_cast<int>(floor(time_elapsed.count()))
+            ).length();
 
-        for (size_t n = 0u; n < my_replicates; ++n)
-        {
-            size_t run_id = my_replicates_csum + n;
-            if (iam == 0)
-            {
+        if (tlength <= 1)
+            unit = "nanoseconds";
+        else if (tlength <= 3)
+            unit = "microseconds";
+        else if (tlength <= 6)
+            unit = "milliseconds";
+        else if (tlength <= 8)
+            unit = "seconds";
+        else if (tlength <= 9)
+            unit = "minutes";
+        else
+            unit = "hours";
 
-                // Checking if the user interrupted the simulation
-                EPI_CHECK_USER_INTERRUPT(n);
+    }
+
+    if (unit == "nanoseconds")       DURCAST(nanoseconds,"ns")
+    else if (unit == "microseconds") DURCAST(microseconds,"\xC2\xB5s")
+    else if (unit == "milliseconds") DURCAST(milliseconds,"ms")
+    else if (unit == "seconds")      DURCAST(seconds,"s")
+    else if (unit == "minutes")      DURCAST(minutes,"m")
+    else if (unit == "hours")        DURCAST(hours,"h")
+    else
+        throw std::range_error("The time unit " + unit + " is not supported.");
 
-                // Setting the simulation id
-                model_ptr->set_sim_id(run_id);
 
-                // Initializing the seed
-                model_ptr->run(ndays, seeds_n[run_id]);
+    if (last_elapsed != nullptr)
+        *last_elapsed = elapsed;
+    if (total_elapsed != nullptr)
+        *total_elapsed = elapsed_total;
+    if (unit_abbr != nullptr)
+        *unit_abbr = abbr_unit;
 
-                // Only the first one prints
-                if (verbose)
-                    pb_multiple.next();
+    if (!print)
+        return;
 
-            } else {
+    if (n_replicates > 1u)
+    {
+        printf_epiworld("last run elapsed time : %.2f%s\n",
+            elapsed, abbr_unit.c_str());
+        printf_epiworld("total elapsed time    : %.2f%s\n",
+            elapsed_total, abbr_unit.c_str());
+        printf_epiworld("total runs            : %i\n",
+            static_cast<int>(n_replicates));
+        printf_epiworld("mean run elapsed time : %.2f%s\n",
+            elapsed_total/static_cast<epiworld_double>(n_replicates), abbr_unit.c_str());
 
-                // Setting the simulation id
-                model_ptr->set_sim_id(run_id);
+    } else {
+        printf_epiworld("last run elapsed time : %.2f%s.\n", elapsed, abbr_unit.c_str());
+    }
+}
 
-                // Initializing the seed
-                model_ptr->run(ndays, seeds_n[run_id]);
+template<typename TSeq>
+inline void Model<TSeq>::set_user_data(std::vector< std::string > names)
+{
+    db.set_user_data(names);
+}
 
-            }
+template<typename TSeq>
+inline void Model<TSeq>::add_user_data(epiworld_fast_uint j, epiworld_double x)
+{
+    db.add_user_data(j, x);
+}
 
-            if (fun)
-            {
-                // User callbacks often write into shared result containers.
-                // Serialize callback execution to avoid callback-induced races.
-                #pragma omp critical(epiworld_run_multiple_fun)
-                {
-                    fun(run_id, model_ptr);
-                }
-            }
+template<typename TSeq>
+inline void Model<TSeq>::add_user_data(std::vector<epiworld_double> x)
+{
+    db.add_user_data(x);
+}
 
-        }
+template<typename TSeq>
+inline UserData<TSeq> & Model<TSeq>::get_user_data()
+{
+    return db.get_user_data();
+}
 
-    }
+template<typename TSeq>
+inline void Model<TSeq>::add_globalevent(
+    std::function<void(Model<TSeq>*)> fun,
+    std::string name,
+    int date
+)
+{
+    auto event = GlobalEvent<TSeq>(fun, name, date);
+    add_globalevent(event);
 
-    // Adjusting the number of replicates
-    n_replicates += (nexperiments - nreplicates[0u]);
+}
 
-    #else
+template<typename TSeq>
+inline void Model<TSeq>::add_globalevent(
+    GlobalEvent<TSeq> & action
+)
+{
+    auto ptr = action.clone_ptr();
+    globalevents.push_back(GlobalEventPtr<TSeq>(std::move(ptr)));
+}
 
-    Progress pb_multiple(
-        nexperiments,
-        EPIWORLD_PROGRESS_BAR_WIDTH
-        )
-        ;
-    if (verbose)
-    {
+template<typename TSeq>
+GlobalEvent<TSeq> & Model<TSeq>::get_globalevent(
+    std::string name
+)
+{
 
-        printf_epiworld(
-            "Starting multiple runs (%i)\n",
-            static_cast<int>(nexperiments)
-        );
+    for (auto & a : globalevents)
+        if (a.name == name)
+            return a;
 
-        pb_multiple.start();
+    throw std::logic_error("The global action " + name + " was not found.");
 
-    }
+}
 
-    for (size_t n = 0u; n < nexperiments; ++n)
-    {
+template<typename TSeq>
+GlobalEvent<TSeq> & Model<TSeq>::get_globalevent(
+    size_t index
+)
+{
 
-        // Checking if the user interrupted the simulation
-        EPI_CHECK_USER_INTERRUPT(n);
+    if (index >= globalevents.size())
+        throw std::range_error("The index " + std::to_string(index) + " is out of range.");
 
-        set_sim_id(n);
-        run(ndays, seeds_n[n]);
+    return *globalevents[index];
 
-        if (fun)
-            fun(n, this);
+}
 
-        if (verbose)
-            pb_multiple.next();
+// Remove implementation
+template<typename TSeq>
+inline void Model<TSeq>::rm_globalevent(
+    std::string name
+)
+{
 
+    for (auto it = globalevents.begin(); it != globalevents.end(); ++it)
+    {
+        if ((*it)->get_name() == name)
+        {
+            globalevents.erase(it);
+            return;
+        }
     }
-    #endif
-
-    if (old_verb)
-        verbose_on();
 
-    return *this;
+    throw std::logic_error("The global action " + name + " was not found.");
 
 }
 
+// Same as above, but the index implementation
 template<typename TSeq>
-inline void Model<TSeq>::update_state() {
-
-    // Next state
-    if (use_queuing)
-    {
-        int i = -1;
-        for (auto & p: population)
-            if (queue[++i] > 0)
-            {
-                if (state_fun[p.state])
-                    state_fun[p.state](&p, this);
-            }
-
-    }
-    else
-    {
-
-        for (auto & p: population)
-            if (state_fun[p.state])
-                    state_fun[p.state](&p, this);
+inline void Model<TSeq>::rm_globalevent(
+    size_t index
+)
+{
 
-    }
+    if (index >= globalevents.size())
+        throw std::range_error("The index " + std::to_string(index) + " is out of range.");
 
-    events_run();
+    globalevents.erase(globalevents.begin() + index);
 
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::mutate_virus() {
-
-    // Checking if any virus has mutation
-    size_t nmutates = 0u;
-    for (const auto & v: viruses)
-        if (v->mutation)
-            nmutates++;
+inline void Model<TSeq>::run_globalevents()
+{
 
-    if (nmutates == 0u)
-        return;
+    EPI_PROFILE_SCOPE(profile, GlobalEvents)
 
-    if (use_queuing)
+    for (auto & event: globalevents)
     {
+        event->operator()(this, today());
+        events_run();
+    }    
 
-        int i = -1;
-        for (auto & p: population)
-        {
+}
 
-            if (queue[++i] == 0)
-                continue;
+template<typename TSeq>
+inline void Model<TSeq>::queuing_on()
+{
+    use_queuing = true;
+}
 
-            if (p.virus != nullptr)
-                p.virus->mutate(this);
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::queuing_off()
+{
+    use_queuing = false;
+    return *this;
+}
 
-        }
+template<typename TSeq>
+inline bool Model<TSeq>::is_queuing_on() const
+{
+    return use_queuing;
+}
 
-    }
-    else
-    {
+template<typename TSeq>
+inline Queue<TSeq> & Model<TSeq>::get_queue()
+{
+    return queue;
+}
 
-        for (auto & p: population)
-        {
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::contact_tracing_on(size_t max_contacts)
+{
+    if (max_contacts < 1u)
+        throw std::logic_error("Contact tracing should use at least one contact.");
+    use_contact_tracing = true;
+    contact_tracing_max_contacts = max_contacts;
+    return *this;
+}
 
-            if (p.virus != nullptr)
-                p.virus->mutate(this);
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::contact_tracing_off()
+{
+    use_contact_tracing = false;
+    contact_tracing.reset();
+    return *this;
+}
 
-        }
+template<typename TSeq>
+inline bool Model<TSeq>::is_contact_tracing_on() const
+{
+    return use_contact_tracing;
+}
 
-    }
+template<typename TSeq>
+inline ContactTracing & Model<TSeq>::get_contact_tracing()
+{
+    if (!use_contact_tracing)
+        throw std::logic_error(
+            "Contact tracing is not active. Call contact_tracing_on() first."
+        );
 
+    if (!contact_tracing)
+        contact_tracing = std::make_unique<ContactTracing>();
+    return *contact_tracing;
+}
 
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::events_by_agent_on()
+{
+    events_by_agent = true;
+    return *this;
 }
 
 template<typename TSeq>
-inline size_t Model<TSeq>::get_n_viruses() const {
-    return db.size();
+inline Model<TSeq> & Model<TSeq>::events_by_agent_off()
+{
+    events_by_agent = false;
+    return *this;
 }
 
 template<typename TSeq>
-inline size_t Model<TSeq>::get_n_tools() const {
-    return tools.size();
+inline bool Model<TSeq>::is_events_by_agent_on() const
+{
+    return events_by_agent;
 }
 
 template<typename TSeq>
-inline epiworld_fast_uint Model<TSeq>::get_ndays() const {
-    return ndays;
+inline Model<TSeq> & Model<TSeq>::fast_forward_on(
+    std::function<bool(Model<TSeq>*)> fun
+)
+{
+    fast_forward  = true;
+    absorbing_fun = fun;
+    return *this;
 }
 
 template<typename TSeq>
-inline epiworld_fast_uint Model<TSeq>::get_n_replicates() const
+inline Model<TSeq> & Model<TSeq>::fast_forward_off()
 {
-    return n_replicates;
+    fast_forward = false;
+    return *this;
 }
 
 template<typename TSeq>
-inline size_t Model<TSeq>::get_sim_id() const
+inline bool Model<TSeq>::is_fast_forward_on() const
 {
-    return sim_id;
+    return fast_forward;
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::set_sim_id(size_t id)
+inline Model<TSeq> & Model<TSeq>::runif_batch_on()
 {
-    sim_id = id;
+    use_runif_batch = true;
+    return *this;
 }
 
 template<typename TSeq>
-inline size_t Model<TSeq>::get_n_entities() const {
-    return entities.size();
+inline Model<TSeq> & Model<TSeq>::runif_batch_off()
+{
+    use_runif_batch = false;
+    return *this;
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::set_ndays(epiworld_fast_uint ndays) {
-    this->ndays = ndays;
+inline bool Model<TSeq>::is_runif_batch_on() const
+{
+    return use_runif_batch;
 }
 
 template<typename TSeq>
-inline bool Model<TSeq>::get_verbose() const {
-    return verbose;
+inline bool Model<TSeq>::is_absorbing()
+{
+
+    if (absorbing_fun)
+        return absorbing_fun(this);
+
+    // Global events left to run
+    for (const auto & e : globalevents)
+        if ((e->get_day() < 0) || (e->get_day() >= today()))
+            return false;
+
+    // Viruses still around
+    for (const auto & counts : db.today_virus)
+        for (auto n : counts)
+            if (n > 0)
+                return false;
+
+    // Without viruses, only these states can't change
+    for (epiworld_fast_uint s = 0u; s < nstates; ++s)
+    {
+
+        if (db.today_total[s] == 0)
+            continue;
+
+        if (
+            !state_fun_is(s, nullptr) &&
+            !state_fun_is(s, default_update_susceptible<TSeq>)
+        )
+            return false;
+
+    }
+
+    return true;
+
 }
 
 template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::verbose_on() {
-    verbose = true;
+inline Model<TSeq> & Model<TSeq>::parallel_update_on(int nthreads)
+{
+    if (nthreads < 1)
+        throw std::logic_error("The parallel update needs at least one thread.");
+
+    use_parallel_update = true;
+    parallel_update_nthreads = nthreads;
     return *this;
 }
 
 template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::verbose_off() {
-    verbose = false;
+inline Model<TSeq> & Model<TSeq>::parallel_update_off()
+{
+    use_parallel_update = false;
     return *this;
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::set_rewire_fun(
-    std::function<void(std::vector<Agent<TSeq>>*,Model<TSeq>*,epiworld_double)> fun
-    ) {
-    rewire_fun = fun;
+inline bool Model<TSeq>::is_parallel_update_on() const
+{
+    return use_parallel_update;
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::set_rewire_prop(epiworld_double prop)
+inline const std::vector< VirusPtr<TSeq> > & Model<TSeq>::get_viruses() const
 {
+    return viruses;
+}
 
-    if (prop < 0.0)
-        throw std::range_error("Proportions cannot be negative.");
+template<typename TSeq>
+const std::vector< ToolPtr<TSeq> > & Model<TSeq>::get_tools() const
+{
+    return tools;
+}
 
-    if (prop > 1.0)
-        throw std::range_error("Proportions cannot be above 1.0.");
+template<typename TSeq>
+inline Virus<TSeq> & Model<TSeq>::get_virus(size_t id)
+{
+
+    if (viruses.size() <= id)
+        throw std::length_error("The specified id for the virus is out of range");
+
+    return *viruses[id];
 
-    rewire_prop = prop;
 }
 
 template<typename TSeq>
-inline epiworld_double Model<TSeq>::get_rewire_prop() const {
-    return rewire_prop;
+inline Virus<TSeq> & Model<TSeq>::get_virus(std::string_view name)
+{
+
+    for (auto & v : viruses)
+        if (v->get_name() == name)
+            return *v;
+
+    throw std::logic_error("The virus " + std::string(name) + " was not found.");
+
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::rewire() {
+inline Tool<TSeq> & Model<TSeq>::get_tool(size_t id)
+{
+
+    if (tools.size() <= id)
+        throw std::length_error("The specified id for the tools is out of range");
+
+    return *tools[id];
 
-    if (rewire_fun)
-        rewire_fun(&population, this, rewire_prop);
 }
 
+template<typename TSeq>
+inline Tool<TSeq> & Model<TSeq>::get_tool(std::string_view name)
+{
+    for (auto & t : tools)
+        if (t->get_name() == name)
+            return *t;
+
+    throw std::logic_error("The tool " + std::string(name) + " was not found.");
+
+}
 
 template<typename TSeq>
-inline void Model<TSeq>::write_data(
-    std::string fn_virus_info,
-    std::string fn_virus_hist,
-    std::string fn_tool_info,
-    std::string fn_tool_hist,
-    std::string fn_total_hist,
-    std::string fn_transmission,
-    std::string fn_transition,
-    std::string fn_reproductive_number,
-    std::string fn_generation_time,
-    std::string fn_active_cases,
-    std::string fn_outbreak_size,
-    std::string fn_hospitalizations
-    ) const
+inline bool Model<TSeq>::has_virus(std::string_view name) const
 {
+    for (const auto & v : viruses)
+        if (v->get_name() == name)
+            return true;
 
-    db.write_data(
-        fn_virus_info, fn_virus_hist,
-        fn_tool_info, fn_tool_hist,
-        fn_total_hist, fn_transmission, fn_transition,
-        fn_reproductive_number, fn_generation_time,
-        fn_active_cases, fn_outbreak_size,
-        fn_hospitalizations
-        );
+    return false;
+}
 
+template<typename TSeq>
+inline bool Model<TSeq>::has_tool(std::string_view name) const
+{
+    for (const auto & t : tools)
+        if (t->get_name() == name)
+            return true;
+    return false;
 }
 
+
 template<typename TSeq>
-inline void Model<TSeq>::write_edgelist(
-    std::string fn
-    ) const
+inline void Model<TSeq>::set_agents_data(double * data_, size_t ncols_)
 {
+    agents_data = data_;
+    agents_data_ncols = ncols_;
+}
 
-    // Figuring out the writing sequence
-    std::vector< const Agent<TSeq> * > wseq(size());
-    for (const auto & p: population)
-        wseq[p.id] = &p;
+template<typename TSeq>
+inline double * Model<TSeq>::get_agents_data() {
+    return this->agents_data;
+}
 
-    std::ofstream efile(fn, std::ios_base::out);
-    efile << "source target\n";
-    if (this->is_directed())
-    {
+template<typename TSeq>
+inline size_t Model<TSeq>::get_agents_data_ncols() const {
+    return this->agents_data_ncols;
+}
 
-        for (const auto & p : wseq)
-        {
 
-            if (p->neighbors == nullptr)
-                continue;
+template<typename TSeq>
+inline void Model<TSeq>::set_name(std::string name)
+{
+    this->name = name;
+}
 
-            for (auto & n : *p->neighbors)
-                efile << p->id << " " << n << "\n";
-        }
+template<typename TSeq>
+inline std::string Model<TSeq>::get_name() const
+{
+    return this->name;
+}
 
-    } else {
+#define VECT_MATCH(a, b, c) \
+    EPI_DEBUG_FAIL_AT_TRUE(a.size() != b.size(), c) \
+    for (size_t __i = 0u; __i < a.size(); ++__i) \
+    {\
+        EPI_DEBUG_FAIL_AT_TRUE(a[__i] != b[__i], c) \
+    }
 
-        for (const auto & p : wseq)
-        {
+template<typename TSeq>
+inline bool Model<TSeq>::operator==(const Model<TSeq> & other) const
+{
+    EPI_DEBUG_FAIL_AT_TRUE(name != other.name, "names don't match")
+    EPI_DEBUG_FAIL_AT_TRUE(db != other.db, "database don't match")
 
-            if (p->neighbors == nullptr)
-                continue;
+    VECT_MATCH(population, other.population, "population doesn't match")
 
-            for (auto & n : *p->neighbors)
-                if (static_cast<int>(p->id) <= static_cast<int>(n))
-                    efile << p->id << " " << n << "\n";
-        }
+    EPI_DEBUG_FAIL_AT_TRUE(
+        using_backup != other.using_backup,
+        "Model:: using_backup don't match"
+        )
 
-    }
+    EPI_DEBUG_FAIL_AT_TRUE(
+        *network != *other.network,
+        "Model:: network don't match"
+    )
 
-}
+    if ((network_backup == nullptr) != (other.network_backup == nullptr))
+        return false;
 
-template<typename TSeq>
-inline void Model<TSeq>::write_edgelist(
-std::vector< int > & source,
-std::vector< int > & target
-) const {
+    if (network_backup && (*network_backup != *other.network_backup))
+        return false;
 
-    // Figuring out the writing sequence
-    std::vector< const Agent<TSeq> * > wseq(size());
-    for (const auto & p: population)
-        wseq[p.id] = &p;
+    EPI_DEBUG_FAIL_AT_TRUE(
+        agents_data != other.agents_data,
+        "Model:: agents_data don't match"
+    )
 
-    if (this->is_directed())
-    {
+    EPI_DEBUG_FAIL_AT_TRUE(
+        agents_data_ncols != other.agents_data_ncols,
+        "Model:: agents_data_ncols don't match"
+    )
 
-        for (const auto & p : wseq)
-        {
-            if (p->neighbors == nullptr)
-                continue;
+    EPI_DEBUG_FAIL_AT_TRUE(
+        directed != other.directed,
+        "Model:: directed don't match"
+    )
 
-            for (auto & n : *p->neighbors)
-            {
-                source.push_back(static_cast<int>(p->id));
-                target.push_back(static_cast<int>(n));
-            }
-        }
+    // Viruses -----------------------------------------------------------------
+    EPI_DEBUG_FAIL_AT_TRUE(
+        viruses.size() != other.viruses.size(),
+        "Model:: viruses.size() don't match"
+        )
 
-    } else {
+    for (size_t i = 0u; i < viruses.size(); ++i)
+    {
+        EPI_DEBUG_FAIL_AT_TRUE(
+            *viruses[i] != *other.viruses[i],
+            "Model:: *viruses[i] don't match"
+        )
 
-        for (const auto & p : wseq)
-        {
+    }
 
-            if (p->neighbors == nullptr)
-                continue;
+    // Tools -------------------------------------------------------------------
+    EPI_DEBUG_FAIL_AT_TRUE(
+        tools.size() != other.tools.size(),
+        "Model:: tools.size() don't match"
+        )
 
-            for (auto & n : *p->neighbors) {
-                if (static_cast<int>(p->id) <= static_cast<int>(n)) {
-                    source.push_back(static_cast<int>(p->id));
-                    target.push_back(static_cast<int>(n));
-                }
-            }
-        }
+    for (size_t i = 0u; i < tools.size(); ++i)
+    {
+        EPI_DEBUG_FAIL_AT_TRUE(
+            *tools[i] != *other.tools[i],
+            "Model:: *tools[i] don't match"
+        )
 
     }
 
+    EPI_DEBUG_FAIL_AT_TRUE(
+        entities.size() != other.entities.size(),
+        "Model:: entities.size() don't match"
+        )
+    for (size_t i = 0u; i < entities.size(); ++i)
+    {
+        EPI_DEBUG_FAIL_AT_TRUE(
+            entities[i] != other.entities[i],
+            "Model:: *entities[i] don't match"
+        )
 
-}
+    }
 
-template<typename TSeq>
-inline std::map<std::string,epiworld_double> & Model<TSeq>::params()
-{
-    return parameters;
-}
+    EPI_DEBUG_FAIL_AT_TRUE(
+        rewire_prop != other.rewire_prop,
+        "Model:: rewire_prop don't match"
+    )
 
-template<typename TSeq>
-inline void Model<TSeq>::reset() {
+    EPI_DEBUG_FAIL_AT_TRUE(
+        parameters.size() != other.parameters.size(),
+        "Model:: () don't match"
+    )
 
+    EPI_DEBUG_FAIL_AT_TRUE(
+        parameters != other.parameters,
+        "Model:: parameters don't match"
+    )
 
-    // Restablishing people
-    pb = Progress(ndays, 80);
+    EPI_DEBUG_FAIL_AT_TRUE(
+        ndays != other.ndays,
+        "Model:: ndays don't match"
+    )
 
-    if (population_backup.size())
-    {
-        population = population_backup;
+    VECT_MATCH(
+        states_labels,
+        other.states_labels,
+        "state labels don't match"
+    )
 
-        #ifdef EPI_DEBUG
-        for (size_t i = 0; i < population.size(); ++i)
-        {
+    EPI_DEBUG_FAIL_AT_TRUE(
+        nstates != other.nstates,
+        "Model:: nstates don't match"
+    )
 
-            if (population[i] != (population_backup)[i])
-                throw std::logic_error("Model::reset population doesn't match.");
+    EPI_DEBUG_FAIL_AT_TRUE(
+        verbose != other.verbose,
+        "Model:: verbose don't match"
+    )
 
-        }
-        #endif
+    EPI_DEBUG_FAIL_AT_TRUE(
+        current_date != other.current_date,
+        "Model:: current_date don't match"
+    )
 
-    }
+    VECT_MATCH(globalevents, other.globalevents, "global action don't match");
 
-    for (auto & p : population)
-        p.reset();
+    EPI_DEBUG_FAIL_AT_TRUE(
+        queue != other.queue,
+        "Model:: queue don't match"
+    )
 
-    #ifdef EPI_DEBUG
-    for (auto & a: population)
-    {
-        if (a.get_state() != 0u)
-            throw std::logic_error("Model::reset population doesn't match."
-                "Some agents are not in the baseline state.");
-    }
-    #endif
 
-    for (auto & e: entities)
-        e.reset();
+    EPI_DEBUG_FAIL_AT_TRUE(
+        use_queuing != other.use_queuing,
+        "Model:: use_queuing don't match"
+    )
 
-    current_date = 0;
+    return true;
 
-    db.reset();
+}
 
-    // This also clears the queue
-    if (use_queuing)
-        queue.reset();
+template<typename TSeq>
+inline void Model<TSeq>::draw(
+    DiagramType diagram_type,
+    const std::string & fn_output,
+    bool self
+) {
 
-    // Reset contact tracing if active
-    if (use_contact_tracing)
-        contact_tracing = std::make_unique<ContactTracing>(
-            population.size(), contact_tracing_max_contacts
-        );
+    ModelDiagram diagram;
 
-    // Re distributing tools and virus
-    dist_entities();
-    dist_virus();
-    dist_tools();
+    diagram.draw_from_data(
+        diagram_type,
+        this->get_states(),
+        this->get_db().get_transition_probability(false),
+        fn_output,
+        self
+    );
 
-    // Distributing initial state, if specified
-    initial_states_fun(this);
+    return;
 
-    // Recording day 0 and advancing to day 1 is handled by Model::run().
-    // Keeping reset() side-effect free from virtual next() prevents
-    // derived-model update code from running before derived reset state
-    // is fully initialized.
+}
 
+template<typename TSeq>
+inline void Model<TSeq>::record_hospitalization(Agent<TSeq> & agent)
+{
+    db.record_hospitalization(agent);
+}
 
+template<typename TSeq>
+inline void Model<TSeq>::get_hospitalizations(
+    std::vector<int> & date,
+    std::vector<int> & virus_id,
+    std::vector<int> & tool_id,
+    std::vector<int> & count,
+    std::vector<double> & weight
+) const
+{
+    db.get_hospitalizations(date, virus_id, tool_id, count, weight);
 }
 
-// Too big to keep here
+#undef VECT_MATCH
+#undef DURCAST
+#undef CASES_PAR
+#undef CASE_PAR
+#undef CHECK_INIT
+#endif
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- Start of -include/epiworld/model-meat-print.hpp-
+ End of -./include/epiworld/model-meat.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
-#ifndef EPIWORLD_MODEL_MEAT_PRINT_HPP
-#define EPIWORLD_MODEL_MEAT_PRINT_HPP
 
-template<typename TSeq>
-inline const Model<TSeq> & Model<TSeq>::print(bool lite) const
-{
+// (already included ./include/epiworld/viruses-bones.hpp)
 
-    // Horizontal line
-    std::string line = "";
-    for (epiworld_fast_uint i = 0u; i < 80u; ++i)
-        line += "_";
+// (already included ./include/epiworld/virus-bones.hpp)
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    // Prints a message if debugging is on
-    EPI_DEBUG_NOTIFY_ACTIVE()
+ Start of -./include/epiworld/virus-distribute-meat.hpp-
 
-    printf_epiworld("%s\n",line.c_str());
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    if (lite)
-    {
-        // Printing the name of the model
-        printf_epiworld("%s", name.c_str());
 
-        // Printing the number of agents, viruses, and tools
-        printf_epiworld(
-            "\nIt features %i agents, %i virus(es), and %i tool(s).\n",
-            static_cast<int>(size()),
-            static_cast<int>(get_n_viruses()),
-            static_cast<int>(get_n_tools())
-            );
+#ifndef EPIWORLD_VIRUS_DISTRIBUTE_MEAT_HPP
+#define EPIWORLD_VIRUS_DISTRIBUTE_MEAT_HPP
 
-        printf_epiworld(
-            "The model has %i states.",
-            static_cast<int>(nstates)
-            );
+/**
+ * Distributes a virus to a set of agents.
+ *
+ * This function takes a vector of agent IDs and returns a lambda function that
+ * can be used to distribute a virus to the specified agents.
+ *
+ * @param agents_ids A vector of agent IDs representing the set of agents to
+ * distribute the virus to.
+ * 
+ * @return A lambda function that takes a Virus object and a Model object and
+ * distributes the virus to the specified agents.
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline VirusToAgentFun<TSeq> distribute_virus_to_set(
+    std::vector< size_t > agents_ids
+) {
 
-        if (today() != 0)
+    return [agents_ids](
+        Virus<TSeq> & virus, Model<TSeq> * model
+    ) -> void 
+    { 
+        // Adding action
+        for (auto i: agents_ids)
         {
-            printf_epiworld(
-                "\nThe final distribution is: "
-            );
-
-            int nstate_int = static_cast<int>(nstates);
-
-            for (int i = 0u; i < nstate_int; ++i)
-            {
-                printf_epiworld(
-                    "%i %s%s",
-                    static_cast<int>(db.today_total[ i ]),
-                    states_labels[i].c_str(),
-                    (
-                        i == (nstate_int - 2)
-                        ) ? ", and " : (
-                            (i == (nstate_int - 1)) ? ".\n" : ", "
-                            )
+            model->get_agent(i).set_virus(
+                *model, virus
                 );
-            }
-        } else {
-            printf_epiworld(" The model hasn't been run yet.\n");
         }
+    };
 
-        return *this;
-    }
+}
 
-    printf_epiworld("%s\n%s\n\n",line.c_str(), "SIMULATION STUDY");
+/**
+ * @brief Distributes a virus randomly to agents.
+ * 
+ * This function takes a sequence of agents and randomly assigns a virus to
+ * each agent.
+ * 
+ * @tparam TSeq The type of the sequence of agents.
+ * @param agents The sequence of agents to distribute the virus to.
+ * @return A function object that assigns a virus to each agent randomly.
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline VirusToAgentFun<TSeq> distribute_virus_randomly(
+    epiworld_double prevalence,
+    bool prevalence_as_proportion = true,
+    std::vector< size_t > agents_ids = {}
+) {
 
-    printf_epiworld("Name of the model   : %s\n", (this->name == "") ? std::string("(none)").c_str() : name.c_str());
-    printf_epiworld("Population size     : %i\n", static_cast<int>(size()));
+    auto agents_ids_ptr = std::make_shared< std::vector< size_t > >(agents_ids);
 
-    auto ncols = get_agents_data_ncols();
+    return [prevalence,prevalence_as_proportion,agents_ids_ptr](
+        Virus<TSeq> & virus, Model<TSeq> * model
+    ) -> void 
+    { 
+        
+        // Figuring out how what agents are available
+        bool use_set = agents_ids_ptr->size() > 0;
+        std::vector< size_t > idx;
+        if (use_set)
+        {
+            for (const auto & agent: *agents_ids_ptr)
+                if (model->get_agent(agent).get_virus() == nullptr)
+                    idx.push_back(agent);
+        }
+        else 
+        {
+            for (const auto & agent: model->get_agents())
+                if (agent.get_virus() == nullptr)
+                    idx.push_back(agent.get_id());
+        }
 
-    if (ncols > 0)
-    {
-        printf_epiworld("Agents' data loaded : yes (%i columns/features)\n", static_cast<int>(ncols));
-    }
-    else
-    {
-        printf_epiworld("Agents' data        : (none)\n");
-    }
+        // Picking how many
+        int n = use_set ?
+            static_cast<int>(idx.size()) :
+            static_cast<int>(model->size())
+            ;
+            
+        int n_available = static_cast<int>(idx.size());
+        int n_to_sample;
+        if (prevalence_as_proportion)
+        {
+            n_to_sample = static_cast<int>(std::floor(
+                prevalence * static_cast< epiworld_double >(n)
+            ));
 
-    printf_epiworld("Number of entities  : %i\n", static_cast<int>(entities.size()));
-    printf_epiworld("Days (duration)     : %i (of %i)\n", today(), static_cast<int>(ndays));
-    printf_epiworld("Number of viruses   : %i\n", static_cast<int>(db.get_n_viruses()));
-    if (n_replicates > 0u)
-    {
-        std::string abbr;
-        epiworld_double elapsed;
-        epiworld_double total;
-        get_elapsed("auto", &elapsed, &total, &abbr, false);
-        printf_epiworld("Last run elapsed t  : %.2f%s\n", elapsed, abbr.c_str());
-        if (n_replicates > 1u)
+            // Correcting for possible overflow
+            if (n_to_sample > n)
+                n_to_sample = n;
+        }
+        else
         {
-            printf_epiworld("Total elapsed t     : %.2f%s (%i runs)\n", total, abbr.c_str(), static_cast<int>(n_replicates));
+            n_to_sample = static_cast<int>(prevalence);
         }
 
-        // Elapsed time in speed
-        get_elapsed("microseconds", &elapsed, &total, &abbr, false);
-        printf_epiworld("Last run speed      : %.2f million agents x day / second\n",
-            static_cast<double>(this->size()) *
-            static_cast<double>(this->get_ndays()) /
-            static_cast<double>(elapsed)
+        if (n_to_sample > n_available)
+            throw std::range_error(
+                "There are only " + std::to_string(n_available) + 
+                " individuals with no virus in the population. " +
+                "Cannot add the virus to " +
+                std::to_string(n_to_sample)
             );
-        if (n_replicates > 1u)
+        
+        auto & population = model->get_agents();
+        for (int i = 0; i < n_to_sample; ++i)
         {
-            printf_epiworld("Average run speed   : %.2f million agents x day / second\n",
-                static_cast<double>(this->size()) *
-                static_cast<double>(this->get_ndays()) *
-                static_cast<double>(n_replicates) /
-                static_cast<double>(total)
-            );
+
+            int loc = model->runif_index(n_available--);
+
+            // Correcting for possible overflow
+            if ((n_available > 0) && (loc >= n_available))
+                loc = n_available - 1;
+
+            Agent<TSeq> & agent = population[idx[loc]];
+            
+            // Adding action
+            agent.set_virus(
+                *model, virus
+                );
+
+            // Adjusting sample
+            std::swap(idx[loc], idx[n_available]);
+
         }
 
-    } else {
-        printf_epiworld("Last run elapsed t  : -\n");
-    }
-    
-    
-    if (rewire_fun)
-    {
-        printf_epiworld("Rewiring            : on (%.2f)\n", rewire_prop);
-    } else {
-        printf_epiworld("Rewiring            : off\n");
-    }
+    };
+
+}
+
+/**
+ * Function template to distribute a virus to agents in each entity of a model.
+ * 
+ * @tparam TSeq The sequence type used in the model.
+ * @param prevalence A vector of prevalences for each entity in the model.
+ * @param as_proportion Flag indicating whether the prevalences are given as
+ * proportions or absolute values.
+ * @return A lambda function that distributes the virus to agents in each entity
+ * of the model.
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline VirusToAgentFun<TSeq> distribute_virus_to_entities(
+    std::vector< double > prevalence,
+    bool as_proportion = true
+)
+{
 
-    printf_epiworld("Last seed used      : %i\n\n", static_cast<int>(last_seed));
-    
-    // Printing Global events
-    printf_epiworld("Global events:\n");
-    for (auto & a : globalevents)
+    // Checking proportions are within range
+    if (prevalence.size() == 0)
+        throw std::range_error("Prevalence vector cannot be empty");
+
+    if (as_proportion)
     {
-        if (a->get_day() < 0)
+        for (auto p: prevalence)
         {
-            printf_epiworld(" - %s (runs daily)\n", a->get_name().c_str());
-        } else {
-            printf_epiworld(" - %s (day %i)\n", a->get_name().c_str(), a->get_day());
+            if ((p < 0.0) || (p > 1.0))
+                throw std::range_error("Proportions must be between 0 and 1");
         }
     }
-
-    if (globalevents.size() == 0u)
+    else
     {
-        printf_epiworld(" (none)\n");
+        for (auto p: prevalence)
+        {
+            if (p < 0.0)
+                throw std::range_error("Count values in prevalence must be non-negative");
+        }
     }
 
-    printf_epiworld("\nVirus(es):\n");
-    size_t n_viruses_model = viruses.size();
-    for (size_t i = 0u; i < n_viruses_model; ++i)
-    {    
+    return [prevalence, as_proportion](
+        Virus<TSeq> & virus, Model<TSeq> * model
+    ) -> void 
+    { 
 
-        
-        const auto & virus = viruses[i];
-        if ((n_viruses_model > 10) && (i >= 10))
-        {
-            printf_epiworld(" ...and %i more viruses...\n",
-                static_cast<int>(n_viruses_model) - 
-                static_cast<int>(i)
+        // Checking the number of entities
+        if (prevalence.size() != model->get_entities().size())
+            throw std::range_error(
+                "Prevalence vector size (" + std::to_string(prevalence.size()) +
+                ") does not match number of entities (" + std::to_string(model->get_entities().size()) + ")"
                 );
-            break;
-        }
 
-        if (i < n_viruses_model)
+        // Adding action
+        auto & entities = model->get_entities();
+        auto & population = model->get_agents();
+        for (size_t e = 0; e < entities.size(); ++e)
         {
+            auto & entity_e = entities[e];
+            auto agents_ids = entity_e.get_agents_ids();
+            double prevalence_e = prevalence[e];
+            size_t n = agents_ids.size();
+            size_t n_to_distribute;
+            if (as_proportion)
+                n_to_distribute = static_cast<size_t>(std::floor(prevalence_e * n));
+            else
+                n_to_distribute = static_cast<size_t>(prevalence_e);
 
-            printf_epiworld(
-                " - %s\n",
-                virus->get_name().c_str()
-            );
+            if (n_to_distribute > n)
+                n_to_distribute = n;
 
-        } else {
+            std::vector< epiworld_agent_index > idx = agents_ids;
+            for (size_t i = 0u; i < n_to_distribute; ++i)
+            {
+                size_t loc = model->runif_index(n--);
 
-            printf_epiworld(
-                " - %s (originated in the model...)\n",
-                virus->get_name().c_str()
-            );
+                if ((n > 0) && (loc >= n))
+                    loc = n - 1;
+                
+                population[idx[loc]].set_virus(
+                    *model, virus
+                    );
+                
+                std::swap(idx[loc], idx[n]);
 
+            }
         }
+    };
 
-    }
-
-    auto nvariants = db.get_n_viruses() - n_viruses_model;
-    if (nvariants > 0)
-    {
-
-        printf_epiworld(" ...and %i more variants...\n", static_cast<int>(nvariants));
+}
 
-    }
 
-    if (viruses.size() == 0u)
-    {
-        printf_epiworld(" (none)\n");
-    }
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    printf_epiworld("\nTool(s):\n");
-    size_t n_tools_model = tools.size();
-    for (size_t i = 0u; i < tools.size(); ++i)
-    {   
-        const auto & tool = tools[i];
+ End of -./include/epiworld/virus-distribute-meat.hpp-
 
-        if ((n_tools_model > 10) && (i >= 10))
-        {
-            printf_epiworld(
-                " ...and %i more tools...\n",
-                static_cast<int>(n_tools_model) - static_cast<int>(i)
-                );
-            break;
-        }
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-        if (i < n_tools_model)
-        {
-            printf_epiworld(
-                " - %s\n",
-                tool->get_name().c_str()
-                );
 
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-        } else {
+ Start of -./include/epiworld/virus-meat.hpp-
 
-            printf_epiworld(
-                " - %s (originated in the model...)\n",
-                tool->get_name().c_str()
-            );
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-        }
-        
 
-    }
+#ifndef EPIWORLD_VIRUS_MEAT_HPP
+#define EPIWORLD_VIRUS_MEAT_HPP
 
-    if (tools.size() == 0u)
-    {
-        printf_epiworld(" (none)\n");
-    }
+// (already included include/epiworld/config.hpp)
 
-    // Information about the parameters included
-    printf_epiworld("\nModel parameters:\n");
-    epiworld_fast_uint nchar = 0u;
-    for (auto & p : parameters)
-        if (p.first.length() > nchar)
-            nchar = p.first.length();
+/**
+ * @brief Factory function of VirusFun base on logit
+ * 
+ * @tparam TSeq 
+ * @param vars Vector indicating the position of the variables to use.
+ * @param coefs Vector of coefficients.
+ * @return VirusFun<TSeq> 
+ */
+template<typename TSeq>
+inline VirusFun<TSeq> virus_fun_logit(
+    std::vector< int > vars,
+    std::vector< double > coefs,
+    Model<TSeq> * model
+) {
 
-    std::string fmt = " - %-" + std::to_string(nchar + 1) + "s: ";
-    for (auto & p : parameters)
-    {
-        std::string fmt_tmp = fmt;
-        if (std::fabs(p.second) < 0.0001)
-            fmt_tmp += "%.1e\n";
-        else
-            fmt_tmp += "%.4f\n";
+    // Checking that there are features
+    if (coefs.size() == 0u)
+        throw std::logic_error(
+            "The -coefs- argument should feature at least one element."
+            );
 
-        printf_epiworld(
-            fmt_tmp.c_str(),
-            p.first.c_str(),
-            p.second
-        );
-        
-    }
+    if (coefs.size() != vars.size())
+        throw std::length_error(
+            std::string("The length of -coef- (") +
+            std::to_string(coefs.size()) + 
+            std::string(") and -vars- (") +
+            std::to_string(vars.size()) +
+            std::string(") should match. ")            
+            );
 
-    if (parameters.size() == 0u)
+    // Checking that there are variables in the model
+    if (model != nullptr)
     {
-        printf_epiworld(" (none)\n");
-    }
-
-    nchar = 0u;
-    for (auto & p : states_labels)
-        if (p.length() > nchar)
-            nchar = p.length();
-
-    
 
-    if (today() != 0)
-    {
-        fmt =
-            std::string("  - (%") +
-                std::to_string(std::to_string(nstates).length()) +
-            std::string("d) %-") + std::to_string(nchar) +
-            std::string("s : %") +
-            std::to_string(std::to_string(size()).length()) +
-            std::string("i -> %i\n");
-    } else {
-        fmt =
-            std::string("  - (%") +
-                std::to_string(std::to_string(nstates).length()) +
-            std::string("d) %-") + std::to_string(nchar) +
-            std::string("s : %i\n");
-    }
-        
-    if (today() != 0)
-    {
-        printf_epiworld("\nDistribution of the population at time %i:\n", today());
-        for (size_t s = 0u; s < nstates; ++s)
+        size_t K = model->get_agents_data_ncols();
+        for (const auto & var: vars)
         {
-
-                printf_epiworld(
-                    fmt.c_str(),
-                    s,
-                    states_labels[s].c_str(),
-                    db.hist_total_counts[s],
-                    db.today_total[ s ]
-                    );
-
+            if ((var >= static_cast<int>(K)) | (var < 0))
+                throw std::range_error(
+                    std::string("The variable ") +
+                    std::to_string(var) +
+                    std::string(" is out of range.") +
+                    std::string(" The agents only feature ") +
+                    std::to_string(K) + 
+                    std::string("variables (features).")
+                );
         }
+        
     }
 
-    if (today() != 0)
-        (void) db.get_transition_probability(true);
+    std::vector< epiworld_double > coefs_f;
+    for (auto c: coefs)
+        coefs_f.push_back(static_cast<epiworld_double>(c));
 
-    return *this;
+    VirusFun<TSeq> fun_infect = [coefs_f,vars](
+        Agent<TSeq> * agent,
+        Virus<TSeq> &,
+        Model<TSeq> * model
+        ) -> epiworld_double {
 
-}
+        size_t K = coefs_f.size();
+        epiworld_double res = 0.0;
 
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+        #if defined(__OPENMP) || defined(_OPENMP)
+        #pragma omp simd reduction(+:res)
+        #endif
+        for (size_t i = 0u; i < K; ++i)
+            res += agent->operator()(vars.at(i), *model) * coefs_f.at(i);
 
- End of -include/epiworld/model-meat-print.hpp-
+        return 1.0/(1.0 + std::exp(-res));
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    };
 
+    return fun_infect;
 
+}
 
 template<typename TSeq>
-inline epiworld_fast_int Model<TSeq>::state_of(std::string_view name) {
-    for (std::size_t i = 0; i < states_labels.size(); ++i) {
-        if (states_labels[i] == name) {
-            return static_cast<epiworld_fast_int>(i);
-        }
+inline Virus<TSeq>::Virus()
+{
+
+    #ifdef EPI_DEBUG_VIRUS
+    counter_construct++;
+    #endif
+
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        baseline_sequence = -1;
+    }
+    else
+    {
+        baseline_sequence = nullptr;
     }
 
-    throw std::logic_error("The state " + std::string(name) + " was not found.");
 }
 
 template<typename TSeq>
-inline epiworld_fast_int Model<TSeq>::add_state(
-    std::string lab,
-    UpdateFun<TSeq> fun
-)
-{
-
-    // Checking it doesn't match
-    for (auto & s : states_labels)
-        if (s == lab)
-            throw std::logic_error("state \"" + s + "\" already registered.");
+inline Virus<TSeq>::Virus(
+    std::string name
+    ) {
 
-    states_labels.push_back(lab);
-    state_fun.push_back(fun);
+    #ifdef EPI_DEBUG_VIRUS
+    counter_construct++;
+    #endif
 
-    return nstates++;
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        baseline_sequence = -1;
+    }
+    else
+    {
+        baseline_sequence = nullptr;
+    }
+    
+    set_name(name);
 }
 
 template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::set_state_function(
-    epiworld_fast_uint state,
-    UpdateFun<TSeq> fun
-)
-{
-
-    if (state >= nstates)
-        throw std::range_error(
-            "The state " + std::to_string(state) + " is out of range. " +
-            "The model currently has " + std::to_string(nstates) + " states."
-        );
+inline Virus<TSeq>::Virus(
+    std::string name,
+    epiworld_double prevalence,
+    bool prevalence_as_proportion
+    ) {
 
-    state_fun[state] = fun;
+    #ifdef EPI_DEBUG_VIRUS
+    counter_construct++;
+    #endif
 
-    return *this;
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        baseline_sequence = -1;
+    }
+    else
+    {
+        baseline_sequence = nullptr;
+    }
 
+    set_name(name);
+    set_distribution(
+        distribute_virus_randomly<TSeq>(
+            prevalence,
+            prevalence_as_proportion
+        )
+    );
 }
 
+#ifdef EPI_DEBUG_VIRUS
 template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::set_state_function(
-    std::string_view name,
-    UpdateFun<TSeq> fun
-)
-{
+std::atomic<int> Virus<TSeq>::counter_construct = 0;
 
-    return set_state_function(
-        static_cast<epiworld_fast_uint>(state_of(name)),
-        fun
-    );
+template<typename TSeq>
+std::atomic<int> Virus<TSeq>::counter_copy_construct = 0;
 
-}
+template<typename TSeq>
+std::atomic<int> Virus<TSeq>::counter_move_construct = 0;
 
 template<typename TSeq>
-inline const std::vector< std::string > &
-Model<TSeq>::get_states() const
-{
-    return states_labels;
-}
+std::atomic<int> Virus<TSeq>::counter_copy_assign = 0;
 
 template<typename TSeq>
-inline size_t Model<TSeq>::get_n_states() const
-{
-    return nstates;
-}
+std::atomic<int> Virus<TSeq>::counter_move_assign = 0;
 
 template<typename TSeq>
-inline const std::vector< UpdateFun<TSeq> > &
-Model<TSeq>::get_state_fun() const
+std::atomic<int> Virus<TSeq>::counter_destruct = 0;
+
+template<typename TSeq>
+inline Virus<TSeq>::~Virus()
 {
-    return state_fun;
+    counter_destruct++;
 }
 
+// Copy constructor
 template<typename TSeq>
-inline void Model<TSeq>::print_state_codes() const
+inline Virus<TSeq>::Virus(const Virus<TSeq>& other)
+    : agent(other.agent),
+      baseline_sequence(other.baseline_sequence),
+      date(other.date),
+      id(other.id),
+      strain(other.strain)
 {
-
-    // Horizontal line
-    std::string line = "";
-    for (epiworld_fast_uint i = 0u; i < 80u; ++i)
-        line += "_";
-
-    printf_epiworld("\n%s\nstates CODES\n\n", line.c_str());
-
-    epiworld_fast_uint nchar = 0u;
-    for (auto & p : states_labels)
-        if (p.length() > nchar)
-            nchar = p.length();
-
-    std::string fmt = " %2i = %-" + std::to_string(nchar + 1 + 4) + "s\n";
-    for (epiworld_fast_uint i = 0u; i < nstates; ++i)
-    {
-
-        printf_epiworld(
-            fmt.c_str(),
-            i,
-            (states_labels[i] + " (S)").c_str()
-        );
-
-    }
-
+    counter_copy_construct++;
 }
 
-
-
+// Move constructor
 template<typename TSeq>
-inline epiworld_double Model<TSeq>::add_param(
-    epiworld_double initial_value,
-    std::string pname,
-    bool overwrite
-    ) {
-
-    if (parameters.find(pname) == parameters.end())
-        parameters[pname] = initial_value;
-    else if (!overwrite)
-        throw std::logic_error("The parameter " + pname + " already exists.");
-    else
-        parameters[pname] = initial_value;
-
-    return initial_value;
-
+inline Virus<TSeq>::Virus(Virus<TSeq>&& other) noexcept
+    : agent(other.agent),
+      baseline_sequence(std::move(other.baseline_sequence)),
+      date(other.date),
+      id(other.id),
+      strain(std::move(other.strain))
+{
+    counter_move_construct++;
+    // other.agent = nullptr;
 }
 
+// Copy assignment
 template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::read_params(std::string fn, bool overwrite)
+inline Virus<TSeq>& Virus<TSeq>::operator=(const Virus<TSeq>& other)
 {
-
-    auto params_map = read_yaml<epiworld_double>(fn);
-
-    for (auto & p : params_map)
-        add_param(p.second, p.first, overwrite);
-
+    if (this != &other) {
+        agent = other.agent;
+        baseline_sequence = other.baseline_sequence;
+        date = other.date;
+        id = other.id;
+        strain = other.strain;
+        counter_copy_assign++;
+    }
     return *this;
-
 }
 
+// Move assignment
 template<typename TSeq>
-inline epiworld_double Model<TSeq>::get_param(std::string pname)
+inline Virus<TSeq>& Virus<TSeq>::operator=(Virus<TSeq>&& other) noexcept
 {
-    if (parameters.find(pname) == parameters.end())
-        throw std::logic_error("The parameter " + pname + " does not exists.");
-
-    return parameters[pname];
+    if (this != &other) {
+        agent = other.agent;
+        baseline_sequence = std::move(other.baseline_sequence);
+        date = other.date;
+        id = other.id;
+        strain = std::move(other.strain);
+        other.agent = nullptr;
+        counter_move_assign++;
+    }
+    return *this;
 }
+#endif
 
 template<typename TSeq>
-inline void Model<TSeq>::set_param(std::string pname, epiworld_double value)
+inline typename Virus<TSeq>::Strain & Virus<TSeq>::strain_mut()
 {
-    if (parameters.find(pname) == parameters.end())
-        throw std::logic_error("The parameter '" + pname + "' does not exists.");
 
-    parameters[pname] = value;
+    // Copy-on-write: other copies of the virus keep the current strain
+    if (strain.use_count() > 1)
+        strain = std::make_shared<Strain>(*strain);
 
-    return;
+    return *strain;
 
 }
 
 template<typename TSeq>
-inline epiworld_double Model<TSeq>::par(std::string pname) const
-{
-    const auto iter = parameters.find(pname);
-    if (iter == parameters.end())
-        throw std::logic_error("The parameter '" + pname + "' does not exists.");
-    return iter->second;
-}
-
-#define DURCAST(tunit,txtunit) {\
-        elapsed       = std::chrono::duration_cast<std::chrono:: tunit>(\
-            time_end - time_start).count(); \
-        elapsed_total = std::chrono::duration_cast<std::chrono:: tunit>(time_elapsed).count(); \
-        abbr_unit     = txtunit;}
+inline void Virus<TSeq>::mutate(
+    Model<TSeq> * model
+) {
 
-template<typename TSeq>
-inline void Model<TSeq>::get_elapsed(
-    std::string unit,
-    epiworld_double * last_elapsed,
-    epiworld_double * total_elapsed,
-    std::string * unit_abbr,
-    bool print
-) const {
+    if (strain->mutation)
+        if (strain->mutation(agent, *this, model))
+            model->get_db().record_virus(*this);
 
-    // Preparing the result
-    epiworld_double elapsed, elapsed_total;
-    std::string abbr_unit;
+    return;
+    
+}
 
-    // Figuring out the length
-    if (unit == "auto")
-    {
+template<typename TSeq>
+inline void Virus<TSeq>::set_mutation(
+    MutFun<TSeq> fun
+) {
+    strain_mut().mutation = MutFun<TSeq>(fun);
+}
 
-        size_t tlength = std::to_string(
-            static_cast<int>(floor(time_elapsed.count()))
-            ).length();
+template<typename TSeq>
+inline EPI_TYPENAME_TRAITS(TSeq, int) Virus<TSeq>::get_sequence()
+{
 
-        if (tlength <= 1)
-            unit = "nanoseconds";
-        else if (tlength <= 3)
-            unit = "microseconds";
-        else if (tlength <= 6)
-            unit = "milliseconds";
-        else if (tlength <= 8)
-            unit = "seconds";
-        else if (tlength <= 9)
-            unit = "minutes";
-        else
-            unit = "hours";
+    return baseline_sequence;
 
-    }
+}
 
-    if (unit == "nanoseconds")       DURCAST(nanoseconds,"ns")
-    else if (unit == "microseconds") DURCAST(microseconds,"\xC2\xB5s")
-    else if (unit == "milliseconds") DURCAST(milliseconds,"ms")
-    else if (unit == "seconds")      DURCAST(seconds,"s")
-    else if (unit == "minutes")      DURCAST(minutes,"m")
-    else if (unit == "hours")        DURCAST(hours,"h")
-    else
-        throw std::range_error("The time unit " + unit + " is not supported.");
+template<typename TSeq>
+inline void Virus<TSeq>::set_sequence(TSeq sequence)
+{
 
+    baseline_sequence = std::make_shared<TSeq>(sequence);
+    return;
 
-    if (last_elapsed != nullptr)
-        *last_elapsed = elapsed;
-    if (total_elapsed != nullptr)
-        *total_elapsed = elapsed_total;
-    if (unit_abbr != nullptr)
-        *unit_abbr = abbr_unit;
+}
 
-    if (!print)
-        return;
+template<>
+inline void Virus<int>::set_sequence(int sequence)
+{
 
-    if (n_replicates > 1u)
-    {
-        printf_epiworld("last run elapsed time : %.2f%s\n",
-            elapsed, abbr_unit.c_str());
-        printf_epiworld("total elapsed time    : %.2f%s\n",
-            elapsed_total, abbr_unit.c_str());
-        printf_epiworld("total runs            : %i\n",
-            static_cast<int>(n_replicates));
-        printf_epiworld("mean run elapsed time : %.2f%s\n",
-            elapsed_total/static_cast<epiworld_double>(n_replicates), abbr_unit.c_str());
+    baseline_sequence = sequence;
+    return;
 
-    } else {
-        printf_epiworld("last run elapsed time : %.2f%s.\n", elapsed, abbr_unit.c_str());
-    }
 }
 
+
 template<typename TSeq>
-inline void Model<TSeq>::set_user_data(std::vector< std::string > names)
+inline Agent<TSeq> * Virus<TSeq>::get_agent()
 {
-    db.set_user_data(names);
+
+    return agent;
+
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::add_user_data(epiworld_fast_uint j, epiworld_double x)
+inline void Virus<TSeq>::set_agent(Agent<TSeq> * p)
 {
-    db.add_user_data(j, x);
+    agent = p;
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::add_user_data(std::vector<epiworld_double> x)
+inline void Virus<TSeq>::set_id(int idx)
 {
-    db.add_user_data(x);
+
+    id = idx;
+    return;
+
 }
 
 template<typename TSeq>
-inline UserData<TSeq> & Model<TSeq>::get_user_data()
+inline int Virus<TSeq>::get_id() const
 {
-    return db.get_user_data();
+    
+    return id;
+
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::add_globalevent(
-    std::function<void(Model<TSeq>*)> fun,
-    std::string name,
-    int date
-)
+inline void Virus<TSeq>::set_date(int d) 
 {
-    auto event = GlobalEvent<TSeq>(fun, name, date);
-    add_globalevent(event);
+
+    date = d;
+    return;
 
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::add_globalevent(
-    GlobalEvent<TSeq> & action
-)
+inline int Virus<TSeq>::get_date() const
 {
-    auto ptr = action.clone_ptr();
-    globalevents.push_back(GlobalEventPtr<TSeq>(std::move(ptr)));
+    
+    return date;
+    
 }
 
 template<typename TSeq>
-GlobalEvent<TSeq> & Model<TSeq>::get_globalevent(
-    std::string name
+inline epiworld_double Virus<TSeq>::get_prob_infecting(
+    Model<TSeq> * model
 )
 {
 
-    for (auto & a : globalevents)
-        if (a.name == name)
-            return a;
-
-    throw std::logic_error("The global action " + name + " was not found.");
+    if (strain->probability_of_infecting)
+        return strain->probability_of_infecting(agent, *this, model);
+        
+    return EPI_DEFAULT_VIRUS_PROB_INFECTION;
 
 }
 
+
+
 template<typename TSeq>
-GlobalEvent<TSeq> & Model<TSeq>::get_globalevent(
-    size_t index
+inline epiworld_double Virus<TSeq>::get_prob_recovery(
+    Model<TSeq> * model
 )
 {
 
-    if (index >= globalevents.size())
-        throw std::range_error("The index " + std::to_string(index) + " is out of range.");
-
-    return *globalevents[index];
+    if (strain->probability_of_recovery)
+        return strain->probability_of_recovery(agent, *this, model);
+        
+    return EPI_DEFAULT_VIRUS_PROB_RECOVERY;
 
 }
 
-// Remove implementation
+
+
 template<typename TSeq>
-inline void Model<TSeq>::rm_globalevent(
-    std::string name
+inline epiworld_double Virus<TSeq>::get_prob_death(
+    Model<TSeq> * model
 )
 {
 
-    for (auto it = globalevents.begin(); it != globalevents.end(); ++it)
-    {
-        if ((*it)->get_name() == name)
-        {
-            globalevents.erase(it);
-            return;
-        }
-    }
-
-    throw std::logic_error("The global action " + name + " was not found.");
+    if (strain->probability_of_death)
+        return strain->probability_of_death(agent, *this, model);
+        
+    return EPI_DEFAULT_VIRUS_PROB_DEATH;
 
 }
 
-// Same as above, but the index implementation
 template<typename TSeq>
-inline void Model<TSeq>::rm_globalevent(
-    size_t index
+inline epiworld_double Virus<TSeq>::get_incubation(
+    Model<TSeq> * model
 )
 {
 
-    if (index >= globalevents.size())
-        throw std::range_error("The index " + std::to_string(index) + " is out of range.");
-
-    globalevents.erase(globalevents.begin() + index);
+    if (strain->incubation)
+        return strain->incubation(agent, *this, model);
+        
+    return EPI_DEFAULT_INCUBATION_DAYS;
 
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::run_globalevents()
+inline void Virus<TSeq>::set_prob_infecting_fun(VirusFun<TSeq> fun)
 {
+    strain_mut().probability_of_infecting = fun;
+}
 
-    for (auto & event: globalevents)
-    {
-        event->operator()(this, today());
-        events_run();
-    }    
-
+template<typename TSeq>
+inline void Virus<TSeq>::set_prob_recovery_fun(VirusFun<TSeq> fun)
+{
+    strain_mut().probability_of_recovery = fun;
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::queuing_on()
+inline void Virus<TSeq>::set_prob_death_fun(VirusFun<TSeq> fun)
 {
-    use_queuing = true;
+    strain_mut().probability_of_death = fun;
 }
 
 template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::queuing_off()
+inline void Virus<TSeq>::set_incubation_fun(VirusFun<TSeq> fun)
 {
-    use_queuing = false;
-    return *this;
+    strain_mut().incubation = fun;
 }
 
 template<typename TSeq>
-inline bool Model<TSeq>::is_queuing_on() const
+inline void Virus<TSeq>::set_prob_infecting(std::string param)
 {
-    return use_queuing;
+    const size_t param_id = Model<TSeq>::param_id(param);
+    VirusFun<TSeq> tmpfun = 
+        [param_id](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
+        {
+            return model->par(param_id);
+        };
+    
+    strain_mut().probability_of_infecting = tmpfun;
 }
 
 template<typename TSeq>
-inline Queue<TSeq> & Model<TSeq>::get_queue()
+inline void Virus<TSeq>::set_prob_recovery(std::string param)
 {
-    return queue;
+    const size_t param_id = Model<TSeq>::param_id(param);
+    VirusFun<TSeq> tmpfun = 
+        [param_id](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
+        {
+            return model->par(param_id);
+        };
+    
+    strain_mut().probability_of_recovery = tmpfun;
 }
 
 template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::contact_tracing_on(size_t max_contacts)
+inline void Virus<TSeq>::set_prob_death(std::string param)
 {
-    if (max_contacts < 1u)
-        throw std::logic_error("Contact tracing should use at least one contact.");
-    use_contact_tracing = true;
-    contact_tracing_max_contacts = max_contacts;
-    return *this;
+    const size_t param_id = Model<TSeq>::param_id(param);
+    VirusFun<TSeq> tmpfun = 
+        [param_id](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
+        {
+            return model->par(param_id);
+        };
+    
+    strain_mut().probability_of_death = tmpfun;
 }
 
 template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::contact_tracing_off()
+inline void Virus<TSeq>::set_incubation(std::string param)
 {
-    use_contact_tracing = false;
-    contact_tracing.reset();
-    return *this;
+    const size_t param_id = Model<TSeq>::param_id(param);
+    VirusFun<TSeq> tmpfun = 
+        [param_id](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
+        {
+            return model->par(param_id);
+        };
+    
+    strain_mut().incubation = tmpfun;
 }
 
 template<typename TSeq>
-inline bool Model<TSeq>::is_contact_tracing_on() const
+inline void Virus<TSeq>::set_prob_infecting(epiworld_double prob)
 {
-    return use_contact_tracing;
+    VirusFun<TSeq> tmpfun = 
+        [prob](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> *)
+        {
+            return prob;
+        };
+    
+    strain_mut().probability_of_infecting = tmpfun;
 }
 
 template<typename TSeq>
-inline ContactTracing & Model<TSeq>::get_contact_tracing()
+inline void Virus<TSeq>::set_prob_recovery(epiworld_double prob)
 {
-    if (!use_contact_tracing)
-        throw std::logic_error(
-            "Contact tracing is not active. Call contact_tracing_on() first."
-        );
+    VirusFun<TSeq> tmpfun = 
+        [prob](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> *)
+        {
+            return prob;
+        };
+    
+    strain_mut().probability_of_recovery = tmpfun;
+}
 
-    if (!contact_tracing)
-        contact_tracing = std::make_unique<ContactTracing>();
-    return *contact_tracing;
+template<typename TSeq>
+inline void Virus<TSeq>::set_prob_death(epiworld_double prob)
+{
+    VirusFun<TSeq> tmpfun = 
+        [prob](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> *)
+        {
+            return prob;
+        };
+    
+    strain_mut().probability_of_death = tmpfun;
 }
 
 template<typename TSeq>
-inline const std::vector< VirusPtr<TSeq> > & Model<TSeq>::get_viruses() const
+inline void Virus<TSeq>::set_incubation(epiworld_double prob)
 {
-    return viruses;
+    VirusFun<TSeq> tmpfun = 
+        [prob](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> *)
+        {
+            return prob;
+        };
+    
+    strain_mut().incubation = tmpfun;
 }
 
 template<typename TSeq>
-const std::vector< ToolPtr<TSeq> > & Model<TSeq>::get_tools() const
+inline void Virus<TSeq>::set_post_recovery(PostRecoveryFun<TSeq> fun)
 {
-    return tools;
+    if (strain->post_recovery_fun)
+    {
+        printf_epiworld(
+            "Warning: a PostRecoveryFun is alreay in place (overwriting)."
+            );
+    }
+
+    strain_mut().post_recovery_fun = fun;
 }
 
 template<typename TSeq>
-inline Virus<TSeq> & Model<TSeq>::get_virus(size_t id)
+inline void Virus<TSeq>::post_recovery(
+    Model<TSeq> * model
+)
 {
 
-    if (viruses.size() <= id)
-        throw std::length_error("The specified id for the virus is out of range");
-
-    return *viruses[id];
+    if (strain->post_recovery_fun)
+        strain->post_recovery_fun(agent, *this, model);    
 
+    return;
+        
 }
 
 template<typename TSeq>
-inline Virus<TSeq> & Model<TSeq>::get_virus(std::string_view name)
+inline void Virus<TSeq>::set_post_immunity(
+    epiworld_double prob
+)
 {
 
-    for (auto & v : viruses)
-        if (v->get_name() == name)
-            return *v;
+    if (strain->post_recovery_fun)
+    {
 
-    throw std::logic_error("The virus " + std::string(name) + " was not found.");
+        std::string msg =
+            std::string(
+                "You cannot set post immunity when a post_recovery "
+                ) +
+            std::string(
+                "function is already in place. Redesign the post_recovery function."
+                );
+
+        throw std::logic_error(msg);
+        
+    }
+
+    // To make sure that we keep registering the virus
+    ToolPtr<TSeq> __no_reinfect = std::make_shared<Tool<TSeq>>(
+        "Immunity (" + strain->virus_name + ")"
+    );
+
+    __no_reinfect->set_susceptibility_reduction(prob);
+    __no_reinfect->set_death_reduction(0.0);
+    __no_reinfect->set_transmission_reduction(0.0);
+    __no_reinfect->set_recovery_enhancer(0.0);
+
+    PostRecoveryFun<TSeq> tmpfun = 
+        [__no_reinfect](
+            Agent<TSeq> * p, Virus<TSeq> &, Model<TSeq> * m
+            )
+        {
+            
+            // Have we registered the tool?
+            if (__no_reinfect->get_id() == -99)
+                m->get_db().record_tool(*__no_reinfect);
+
+            p->add_tool(*m, *__no_reinfect);
+
+            return;
+
+        };
+
+    strain_mut().post_recovery_fun = tmpfun;
 
 }
 
 template<typename TSeq>
-inline Tool<TSeq> & Model<TSeq>::get_tool(size_t id)
+inline void Virus<TSeq>::set_post_immunity(
+    std::string param
+)
 {
 
-    if (tools.size() <= id)
-        throw std::length_error("The specified id for the tools is out of range");
+    if (strain->post_recovery_fun)
+    {
 
-    return *tools[id];
+        std::string msg =
+            std::string(
+                "You cannot set post immunity when a post_recovery "
+                ) +
+            std::string(
+                "function is already in place. Redesign the post_recovery function."
+                );
+
+        throw std::logic_error(msg);
+
+    }
+
+    // To make sure that we keep registering the virus
+    ToolPtr<TSeq> __no_reinfect = std::make_shared<Tool<TSeq>>(
+        "Immunity (" + strain->virus_name + ")"
+    );
+
+    __no_reinfect->set_susceptibility_reduction(param);
+    __no_reinfect->set_death_reduction(0.0);
+    __no_reinfect->set_transmission_reduction(0.0);
+    __no_reinfect->set_recovery_enhancer(0.0);
+
+    PostRecoveryFun<TSeq> tmpfun = 
+        [__no_reinfect](Agent<TSeq> * p, Virus<TSeq> &, Model<TSeq> * m)
+        {
+
+            // Have we registered the tool?
+            if (__no_reinfect->get_id() == -99)
+                m->get_db().record_tool(*__no_reinfect);
+
+            p->add_tool(*m, *__no_reinfect);
+
+            return;
+
+        };
+
+    strain_mut().post_recovery_fun = tmpfun;
 
 }
 
 template<typename TSeq>
-inline Tool<TSeq> & Model<TSeq>::get_tool(std::string_view name)
+inline void Virus<TSeq>::set_name(std::string name)
 {
-    for (auto & t : tools)
-        if (t->get_name() == name)
-            return *t;
 
-    throw std::logic_error("The tool " + std::string(name) + " was not found.");
+    strain_mut().virus_name = name;
 
 }
 
 template<typename TSeq>
-inline bool Model<TSeq>::has_virus(std::string_view name) const
+inline std::string Virus<TSeq>::get_name() const
 {
-    for (const auto & v : viruses)
-        if (v->get_name() == name)
-            return true;
 
-    return false;
+    return strain->virus_name;
+
 }
 
 template<typename TSeq>
-inline bool Model<TSeq>::has_tool(std::string_view name) const
+inline void Virus<TSeq>::set_state(
+    epiworld_fast_int init,
+    epiworld_fast_int end,
+    epiworld_fast_int removed
+)
 {
-    for (const auto & t : tools)
-        if (t->get_name() == name)
-            return true;
-    return false;
+    strain_mut().state_init    = init;
+    strain_mut().state_post    = end;
+    strain_mut().state_removed = removed;
 }
 
-
 template<typename TSeq>
-inline void Model<TSeq>::set_agents_data(double * data_, size_t ncols_)
+inline void Virus<TSeq>::set_queue(
+    epiworld_fast_int init,
+    epiworld_fast_int end,
+    epiworld_fast_int removed
+)
 {
-    agents_data = data_;
-    agents_data_ncols = ncols_;
-}
 
-template<typename TSeq>
-inline double * Model<TSeq>::get_agents_data() {
-    return this->agents_data;
-}
+    strain_mut().queue_init    = init;
+    strain_mut().queue_post     = end;
+    strain_mut().queue_removed = removed;
 
-template<typename TSeq>
-inline size_t Model<TSeq>::get_agents_data_ncols() const {
-    return this->agents_data_ncols;
 }
 
-
 template<typename TSeq>
-inline void Model<TSeq>::set_name(std::string name)
+inline void Virus<TSeq>::get_state(
+    epiworld_fast_int * init,
+    epiworld_fast_int * end,
+    epiworld_fast_int * removed
+) const
 {
-    this->name = name;
+
+    if (init != nullptr)
+        *init = strain->state_init;
+
+    if (end != nullptr)
+        *end = strain->state_post;
+
+    if (removed != nullptr)
+        *removed = strain->state_removed;
+
 }
 
 template<typename TSeq>
-inline std::string Model<TSeq>::get_name() const
+inline void Virus<TSeq>::get_queue(
+    epiworld_fast_int * init,
+    epiworld_fast_int * end,
+    epiworld_fast_int * removed
+) const
 {
-    return this->name;
-}
 
-#define VECT_MATCH(a, b, c) \
-    EPI_DEBUG_FAIL_AT_TRUE(a.size() != b.size(), c) \
-    for (size_t __i = 0u; __i < a.size(); ++__i) \
-    {\
-        EPI_DEBUG_FAIL_AT_TRUE(a[__i] != b[__i], c) \
-    }
+    if (init != nullptr)
+        *init = strain->queue_init;
 
-template<typename TSeq>
-inline bool Model<TSeq>::operator==(const Model<TSeq> & other) const
-{
-    EPI_DEBUG_FAIL_AT_TRUE(name != other.name, "names don't match")
-    EPI_DEBUG_FAIL_AT_TRUE(db != other.db, "database don't match")
+    if (end != nullptr)
+        *end = strain->queue_post;
 
-    VECT_MATCH(population, other.population, "population doesn't match")
+    if (removed != nullptr)
+        *removed = strain->queue_removed;
+        
+}
 
+template<>
+inline bool Virus<std::vector<int>>::operator==(
+    const Virus<std::vector<int>> & other
+    ) const
+{
+    
     EPI_DEBUG_FAIL_AT_TRUE(
-        using_backup != other.using_backup,
-        "Model:: using_backup don't match"
+        baseline_sequence->size() != other.baseline_sequence->size(),
+        "Virus:: baseline_sequence don't match"
         )
 
-    if ((population_backup.size() != 0) & (other.population_backup.size() != 0))
+    for (size_t i = 0u; i < baseline_sequence->size(); ++i)
     {
 
-        // False is population_backup.size() != other.population_backup.size()
-        if (population_backup.size() != other.population_backup.size())
-            return false;
-
-        for (size_t i = 0u; i < population_backup.size(); ++i)
-        {
-            if (population_backup[i] != other.population_backup[i])
-                return false;
-        }
+        EPI_DEBUG_FAIL_AT_TRUE(
+            baseline_sequence->operator[](i) != other.baseline_sequence->operator[](i),
+            "Virus:: baseline_sequence[i] don't match"
+            )
 
-    } else if ((population_backup.size() == 0) & (other.population_backup.size() != 0)) {
-        return false;
-    } else if ((population_backup.size() != 0) & (other.population_backup.size() == 0))
-    {
-        return false;
     }
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        agents_data != other.agents_data,
-        "Model:: agents_data don't match"
-    )
-
+        strain->virus_name != other.strain->virus_name,
+        "Virus:: virus_name don't match"
+        )
+    
     EPI_DEBUG_FAIL_AT_TRUE(
-        agents_data_ncols != other.agents_data_ncols,
-        "Model:: agents_data_ncols don't match"
-    )
+        strain->state_init != other.strain->state_init,
+        "Virus:: state_init don't match"
+        )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        directed != other.directed,
-        "Model:: directed don't match"
-    )
+        strain->state_post != other.strain->state_post,
+        "Virus:: state_post don't match"
+        )
 
-    // Viruses -----------------------------------------------------------------
     EPI_DEBUG_FAIL_AT_TRUE(
-        viruses.size() != other.viruses.size(),
-        "Model:: viruses.size() don't match"
+        strain->state_removed != other.strain->state_removed,
+        "Virus:: state_removed don't match"
         )
 
-    for (size_t i = 0u; i < viruses.size(); ++i)
-    {
-        EPI_DEBUG_FAIL_AT_TRUE(
-            *viruses[i] != *other.viruses[i],
-            "Model:: *viruses[i] don't match"
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->queue_init != other.strain->queue_init,
+        "Virus:: queue_init don't match"
         )
 
-    }
+    EPI_DEBUG_FAIL_AT_TRUE(
+        strain->queue_post != other.strain->queue_post,
+        "Virus:: queue_post don't match"
+        )
 
-    // Tools -------------------------------------------------------------------
     EPI_DEBUG_FAIL_AT_TRUE(
-        tools.size() != other.tools.size(),
-        "Model:: tools.size() don't match"
+        strain->queue_removed != other.strain->queue_removed,
+        "Virus:: queue_removed don't match"
         )
 
-    for (size_t i = 0u; i < tools.size(); ++i)
+    return true;
+
+}
+
+template<typename TSeq>
+inline bool Virus<TSeq>::operator==(const Virus<TSeq> & other) const
+{
+    
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
     {
         EPI_DEBUG_FAIL_AT_TRUE(
-            *tools[i] != *other.tools[i],
-            "Model:: *tools[i] don't match"
+            baseline_sequence != other.baseline_sequence,
+            "Virus:: baseline_sequence don't match"
         )
-
     }
-
-    EPI_DEBUG_FAIL_AT_TRUE(
-        entities.size() != other.entities.size(),
-        "Model:: entities.size() don't match"
-        )
-    for (size_t i = 0u; i < entities.size(); ++i)
+    else
     {
         EPI_DEBUG_FAIL_AT_TRUE(
-            entities[i] != other.entities[i],
-            "Model:: *entities[i] don't match"
+            baseline_sequence != other.baseline_sequence,
+            "Virus:: baseline_sequence don't match"
         )
-
     }
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        rewire_prop != other.rewire_prop,
-        "Model:: rewire_prop don't match"
+        strain->virus_name != other.strain->virus_name,
+        "Virus:: virus_name don't match"
     )
-
+    
     EPI_DEBUG_FAIL_AT_TRUE(
-        parameters.size() != other.parameters.size(),
-        "Model:: () don't match"
+        strain->state_init != other.strain->state_init,
+        "Virus:: state_init don't match"
     )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        parameters != other.parameters,
-        "Model:: parameters don't match"
+        strain->state_post != other.strain->state_post,
+        "Virus:: state_post don't match"
     )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        ndays != other.ndays,
-        "Model:: ndays don't match"
-    )
-
-    VECT_MATCH(
-        states_labels,
-        other.states_labels,
-        "state labels don't match"
+        strain->state_removed != other.strain->state_removed,
+        "Virus:: state_removed don't match"
     )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        nstates != other.nstates,
-        "Model:: nstates don't match"
+        strain->queue_init != other.strain->queue_init,
+        "Virus:: queue_init don't match"
     )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        verbose != other.verbose,
-        "Model:: verbose don't match"
+        strain->queue_post != other.strain->queue_post,
+        "Virus:: queue_post don't match"
     )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        current_date != other.current_date,
-        "Model:: current_date don't match"
+        strain->queue_removed != other.strain->queue_removed,
+        "Virus:: queue_removed don't match"
     )
 
-    VECT_MATCH(globalevents, other.globalevents, "global action don't match");
-
-    EPI_DEBUG_FAIL_AT_TRUE(
-        queue != other.queue,
-        "Model:: queue don't match"
-    )
+    return true;
 
+}
 
-    EPI_DEBUG_FAIL_AT_TRUE(
-        use_queuing != other.use_queuing,
-        "Model:: use_queuing don't match"
-    )
+template<typename TSeq>
+inline void Virus<TSeq>::print() const
+{
 
-    return true;
+    printf_epiworld("Virus         : %s\n", strain->virus_name.c_str());
+    printf_epiworld("Id            : %s\n", (id < 0)? std::string("(empty)").c_str() : std::to_string(id).c_str());
+    printf_epiworld("state_init    : %i\n", static_cast<int>(strain->state_init));
+    printf_epiworld("state_post    : %i\n", static_cast<int>(strain->state_post));
+    printf_epiworld("state_removed : %i\n", static_cast<int>(strain->state_removed));
+    printf_epiworld("queue_init    : %i\n", static_cast<int>(strain->queue_init));
+    printf_epiworld("queue_post    : %i\n", static_cast<int>(strain->queue_post));
+    printf_epiworld("queue_removed : %i\n", static_cast<int>(strain->queue_removed));
 
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::draw(
-    DiagramType diagram_type,
-    const std::string & fn_output,
-    bool self
-) {
+inline void Virus<TSeq>::distribute(Model<TSeq> * model)
+{
 
-    ModelDiagram diagram;
+    if (strain->dist)
+    {
 
-    diagram.draw_from_data(
-        diagram_type,
-        this->get_states(),
-        this->get_db().get_transition_probability(false),
-        fn_output,
-        self
-    );
+        strain->dist(*this, model);
 
-    return;
+    }
 
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::record_hospitalization(Agent<TSeq> & agent)
+inline void Virus<TSeq>::set_distribution(VirusToAgentFun<TSeq> fun)
 {
-    db.record_hospitalization(agent);
+    strain_mut().dist = fun;
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::get_hospitalizations(
-    std::vector<int> & date,
-    std::vector<int> & virus_id,
-    std::vector<int> & tool_id,
-    std::vector<int> & count,
-    std::vector<double> & weight
-) const
+inline std::unique_ptr<Virus<TSeq>> Virus<TSeq>::clone_ptr() const
 {
-    db.get_hospitalizations(date, virus_id, tool_id, count, weight);
+    auto cloned = std::make_unique<Virus<TSeq>>(*this);
+    return cloned;
 }
 
-#undef VECT_MATCH
-#undef DURCAST
-#undef CASES_PAR
-#undef CASE_PAR
-#undef CHECK_INIT
 #endif
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- End of -./include/epiworld/model-meat.hpp-
+ End of -./include/epiworld/virus-meat.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
+    
+    // #include "tools-bones.hpp"
 
-// (already included ./include/epiworld/viruses-bones.hpp)
-
-// (already included ./include/epiworld/virus-bones.hpp)
+// (already included ./include/epiworld/tool-bones.hpp)
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- Start of -./include/epiworld/virus-distribute-meat.hpp-
+ Start of -./include/epiworld/tool-distribute-meat.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
-#ifndef EPIWORLD_VIRUS_DISTRIBUTE_MEAT_HPP
-#define EPIWORLD_VIRUS_DISTRIBUTE_MEAT_HPP
+#ifndef TOOL_DISTRIBUTE_MEAT_HPP
+#define TOOL_DISTRIBUTE_MEAT_HPP
 
 /**
- * Distributes a virus to a set of agents.
- *
+ * @brief Distributes a tool to a set of agents.
+ * 
  * This function takes a vector of agent IDs and returns a lambda function that
- * can be used to distribute a virus to the specified agents.
- *
- * @param agents_ids A vector of agent IDs representing the set of agents to
- * distribute the virus to.
+ * distributes a tool to each agent in the set.
  * 
- * @return A lambda function that takes a Virus object and a Model object and
- * distributes the virus to the specified agents.
+ * The lambda function takes a reference to a Tool object and a pointer to a
+ * Model object as parameters. It iterates over the agent IDs and adds the tool
+ * to each agent using the add_tool() method of the Model object.
+ * 
+ * @tparam TSeq The sequence type used in the Tool and Model objects.
+ * @param agents_ids A vector of agent IDs representing the set of agents to
+ * distribute the tool to.
+ * @return A lambda function that distributes the tool to the set of agents.
  */
 template<typename TSeq = EPI_DEFAULT_TSEQ>
-inline VirusToAgentFun<TSeq> distribute_virus_to_set(
+inline ToolToAgentFun<TSeq> distribute_tool_to_set(
     std::vector< size_t > agents_ids
 ) {
 
     return [agents_ids](
-        Virus<TSeq> & virus, Model<TSeq> * model
+        Tool<TSeq> & tool, Model<TSeq> * model
     ) -> void 
     { 
         // Adding action
         for (auto i: agents_ids)
         {
-            model->get_agent(i).set_virus(
-                *model, virus
+            model->get_agent(i).add_tool(
+                *model, tool
                 );
         }
     };
@@ -14070,114 +18547,89 @@ inline VirusToAgentFun<TSeq> distribute_virus_to_set(
 }
 
 /**
- * @brief Distributes a virus randomly to agents.
- * 
- * This function takes a sequence of agents and randomly assigns a virus to
- * each agent.
+ * Function template to distribute a tool randomly to agents in a model.
  * 
- * @tparam TSeq The type of the sequence of agents.
- * @param agents The sequence of agents to distribute the virus to.
- * @return A function object that assigns a virus to each agent randomly.
+ * @tparam TSeq The sequence type used in the model.
+ * @param prevalence The prevalence of the tool in the population.
+ * @param as_proportion Flag indicating whether the prevalence is given as a
+ * proportion or an absolute value.
+ * @return A lambda function that distributes the tool randomly to agents in
+ * the model.
  */
 template<typename TSeq = EPI_DEFAULT_TSEQ>
-inline VirusToAgentFun<TSeq> distribute_virus_randomly(
+inline ToolToAgentFun<TSeq> distribute_tool_randomly(
     epiworld_double prevalence,
-    bool prevalence_as_proportion = true,
+    bool as_proportion = true,
     std::vector< size_t > agents_ids = {}
 ) {
 
     auto agents_ids_ptr = std::make_shared< std::vector< size_t > >(agents_ids);
 
-    return [prevalence,prevalence_as_proportion,agents_ids_ptr](
-        Virus<TSeq> & virus, Model<TSeq> * model
-    ) -> void 
-    { 
-        
-        // Figuring out how what agents are available
-        bool use_set = agents_ids_ptr->size() > 0;
-        std::vector< size_t > idx;
-        if (use_set)
-        {
-            for (const auto & agent: *agents_ids_ptr)
-                if (model->get_agent(agent).get_virus() == nullptr)
-                    idx.push_back(agent);
-        }
-        else 
-        {
-            for (const auto & agent: model->get_agents())
-                if (agent.get_virus() == nullptr)
-                    idx.push_back(agent.get_id());
-        }
-
-        // Picking how many
-        int n = use_set ?
-            static_cast<int>(idx.size()) :
-            static_cast<int>(model->size())
-            ;
-            
-        int n_available = static_cast<int>(idx.size());
-        int n_to_sample;
-        if (prevalence_as_proportion)
-        {
-            n_to_sample = static_cast<int>(std::floor(
-                prevalence * static_cast< epiworld_double >(n)
-            ));
+    return [prevalence,as_proportion,agents_ids_ptr](
+        Tool<TSeq> & tool, Model<TSeq> * model
+        ) -> void {
 
-            // Correcting for possible overflow
-            if (n_to_sample > n)
-                n_to_sample = n;
-        }
-        else
-        {
-            n_to_sample = static_cast<int>(prevalence);
-        }
+            // Figuring out how what agents are available
+            bool use_set = agents_ids_ptr->size() > 0;
 
-        if (n_to_sample > n_available)
-            throw std::range_error(
-                "There are only " + std::to_string(n_available) + 
-                " individuals with no virus in the population. " +
-                "Cannot add the virus to " +
-                std::to_string(n_to_sample)
-            );
-        
-        auto & population = model->get_agents();
-        for (int i = 0; i < n_to_sample; ++i)
-        {
+            // Picking how many
+            int n_to_distribute;
+            int n = use_set ? 
+                static_cast<int>(agents_ids_ptr->size()) :
+                static_cast<int>(model->size());
+                
+            if (as_proportion)
+            {
+                n_to_distribute = static_cast<int>(std::floor(prevalence * n));
 
-            int loc = model->runif_index(n_available--);
+                // Correcting for possible rounding errors
+                if (n_to_distribute > n)
+                    n_to_distribute = n;
 
-            // Correcting for possible overflow
-            if ((n_available > 0) && (loc >= n_available))
-                loc = n_available - 1;
+            }
+            else
+            {
+                n_to_distribute = static_cast<int>(prevalence);
+            }
 
-            Agent<TSeq> & agent = population[idx[loc]];
-            
-            // Adding action
-            agent.set_virus(
-                *model, virus
-                );
+            if (n_to_distribute > n)
+                throw std::range_error("There are only " + std::to_string(n) + 
+                " individuals in the population. Cannot add the tool to " + std::to_string(n_to_distribute));
+            
+            std::vector< int > idx(n);
+            std::iota(idx.begin(), idx.end(), 0);
+            auto & population = model->get_agents();
+            for (int i = 0u; i < n_to_distribute; ++i)
+            {
+                int loc = model->runif_index(n--);
 
-            // Adjusting sample
-            std::swap(idx[loc], idx[n_available]);
+                if ((n > 0) && (loc >= n))
+                    loc = n - 1;
+                
+                population[idx[loc]].add_tool(
+                    *model, tool
+                    );
+                
+                std::swap(idx[loc], idx[n]);
 
-        }
+            }
 
-    };
+        };
 
 }
 
 /**
- * Function template to distribute a virus to agents in each entity of a model.
+ * Function template to distribute a tool to agents in each entity of a model.
  * 
  * @tparam TSeq The sequence type used in the model.
  * @param prevalence A vector of prevalences for each entity in the model.
  * @param as_proportion Flag indicating whether the prevalences are given as
  * proportions or absolute values.
- * @return A lambda function that distributes the virus to agents in each entity
+ * @return A lambda function that distributes the tool to agents in each entity
  * of the model.
  */
 template<typename TSeq = EPI_DEFAULT_TSEQ>
-inline VirusToAgentFun<TSeq> distribute_virus_to_entities(
+inline ToolToAgentFun<TSeq> distribute_tool_to_entities(
     std::vector< double > prevalence,
     bool as_proportion = true
 )
@@ -14205,7 +18657,7 @@ inline VirusToAgentFun<TSeq> distribute_virus_to_entities(
     }
 
     return [prevalence, as_proportion](
-        Virus<TSeq> & virus, Model<TSeq> * model
+        Tool<TSeq> & tool, Model<TSeq> * model
     ) -> void 
     { 
 
@@ -14222,9 +18674,9 @@ inline VirusToAgentFun<TSeq> distribute_virus_to_entities(
         for (size_t e = 0; e < entities.size(); ++e)
         {
             auto & entity_e = entities[e];
-            auto agents_ids = entity_e.get_agents_ids();
+            auto agent_ids = entity_e.get_agents_ids();
             double prevalence_e = prevalence[e];
-            size_t n = agents_ids.size();
+            size_t n = agent_ids.size();
             size_t n_to_distribute;
             if (as_proportion)
                 n_to_distribute = static_cast<size_t>(std::floor(prevalence_e * n));
@@ -14234,7 +18686,7 @@ inline VirusToAgentFun<TSeq> distribute_virus_to_entities(
             if (n_to_distribute > n)
                 n_to_distribute = n;
 
-            std::vector< size_t > idx = agents_ids;
+            std::vector< epiworld_agent_index > idx = agent_ids;
             for (size_t i = 0u; i < n_to_distribute; ++i)
             {
                 size_t loc = model->runif_index(n--);
@@ -14242,8 +18694,8 @@ inline VirusToAgentFun<TSeq> distribute_virus_to_entities(
                 if ((n > 0) && (loc >= n))
                     loc = n - 1;
                 
-                population[idx[loc]].set_virus(
-                    *model, virus
+                population[idx[loc]].add_tool(
+                    *model, tool
                     );
                 
                 std::swap(idx[loc], idx[n]);
@@ -14253,13 +18705,11 @@ inline VirusToAgentFun<TSeq> distribute_virus_to_entities(
     };
 
 }
-
-
 #endif
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- End of -./include/epiworld/virus-distribute-meat.hpp-
+ End of -./include/epiworld/tool-distribute-meat.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
@@ -14268,906 +18718,645 @@ inline VirusToAgentFun<TSeq> distribute_virus_to_entities(
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- Start of -./include/epiworld/virus-meat.hpp-
+ Start of -./include/epiworld/tool-meat.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
-#ifndef EPIWORLD_VIRUS_MEAT_HPP
-#define EPIWORLD_VIRUS_MEAT_HPP
-
-// (already included include/epiworld/config.hpp)
-
-/**
- * @brief Factory function of VirusFun base on logit
- * 
- * @tparam TSeq 
- * @param vars Vector indicating the position of the variables to use.
- * @param coefs Vector of coefficients.
- * @return VirusFun<TSeq> 
- */
-template<typename TSeq>
-inline VirusFun<TSeq> virus_fun_logit(
-    std::vector< int > vars,
-    std::vector< double > coefs,
-    Model<TSeq> * model
-) {
-
-    // Checking that there are features
-    if (coefs.size() == 0u)
-        throw std::logic_error(
-            "The -coefs- argument should feature at least one element."
-            );
-
-    if (coefs.size() != vars.size())
-        throw std::length_error(
-            std::string("The length of -coef- (") +
-            std::to_string(coefs.size()) + 
-            std::string(") and -vars- (") +
-            std::to_string(vars.size()) +
-            std::string(") should match. ")            
-            );
-
-    // Checking that there are variables in the model
-    if (model != nullptr)
-    {
-
-        size_t K = model->get_agents_data_ncols();
-        for (const auto & var: vars)
-        {
-            if ((var >= static_cast<int>(K)) | (var < 0))
-                throw std::range_error(
-                    std::string("The variable ") +
-                    std::to_string(var) +
-                    std::string(" is out of range.") +
-                    std::string(" The agents only feature ") +
-                    std::to_string(K) + 
-                    std::string("variables (features).")
-                );
-        }
-        
-    }
-
-    std::vector< epiworld_double > coefs_f;
-    for (auto c: coefs)
-        coefs_f.push_back(static_cast<epiworld_double>(c));
-
-    VirusFun<TSeq> fun_infect = [coefs_f,vars](
-        Agent<TSeq> * agent,
-        Virus<TSeq> &,
-        Model<TSeq> * model
-        ) -> epiworld_double {
-
-        size_t K = coefs_f.size();
-        epiworld_double res = 0.0;
-
-        #if defined(__OPENMP) || defined(_OPENMP)
-        #pragma omp simd reduction(+:res)
-        #endif
-        for (size_t i = 0u; i < K; ++i)
-            res += agent->operator()(vars.at(i), *model) * coefs_f.at(i);
-
-        return 1.0/(1.0 + std::exp(-res));
-
-    };
-
-    return fun_infect;
-
-}
-
-template<typename TSeq>
-inline Virus<TSeq>::Virus()
-{
-
-    #ifdef EPI_DEBUG_VIRUS
-    counter_construct++;
-    #endif
-
-    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
-    {
-        baseline_sequence = -1;
-    }
-    else
-    {
-        baseline_sequence = nullptr;
-    }
-
-}
-
-template<typename TSeq>
-inline Virus<TSeq>::Virus(
-    std::string name
-    ) {
-
-    #ifdef EPI_DEBUG_VIRUS
-    counter_construct++;
-    #endif
-
-    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
-    {
-        baseline_sequence = -1;
-    }
-    else
-    {
-        baseline_sequence = nullptr;
-    }
-    
-    set_name(name);
-}
-
-template<typename TSeq>
-inline Virus<TSeq>::Virus(
-    std::string name,
-    epiworld_double prevalence,
-    bool prevalence_as_proportion
-    ) {
-
-    #ifdef EPI_DEBUG_VIRUS
-    counter_construct++;
-    #endif
-
-    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
-    {
-        baseline_sequence = -1;
-    }
-    else
-    {
-        baseline_sequence = nullptr;
-    }
-
-    set_name(name);
-    set_distribution(
-        distribute_virus_randomly<TSeq>(
-            prevalence,
-            prevalence_as_proportion
-        )
-    );
-}
-
-#ifdef EPI_DEBUG_VIRUS
-template<typename TSeq>
-std::atomic<int> Virus<TSeq>::counter_construct = 0;
-
-template<typename TSeq>
-std::atomic<int> Virus<TSeq>::counter_copy_construct = 0;
-
-template<typename TSeq>
-std::atomic<int> Virus<TSeq>::counter_move_construct = 0;
-
-template<typename TSeq>
-std::atomic<int> Virus<TSeq>::counter_copy_assign = 0;
-
-template<typename TSeq>
-std::atomic<int> Virus<TSeq>::counter_move_assign = 0;
-
-template<typename TSeq>
-std::atomic<int> Virus<TSeq>::counter_destruct = 0;
-
-template<typename TSeq>
-inline Virus<TSeq>::~Virus()
-{
-    counter_destruct++;
-}
-
-// Copy constructor
-template<typename TSeq>
-inline Virus<TSeq>::Virus(const Virus<TSeq>& other)
-    : agent(other.agent),
-      baseline_sequence(other.baseline_sequence),
-      virus_name(other.virus_name),
-      date(other.date),
-      id(other.id),
-      state_init(other.state_init),
-      state_post(other.state_post),
-      state_removed(other.state_removed),
-      queue_init(other.queue_init),
-      queue_post(other.queue_post),
-      queue_removed(other.queue_removed)
-{
-    counter_copy_construct++;
-}
-
-// Move constructor
-template<typename TSeq>
-inline Virus<TSeq>::Virus(Virus<TSeq>&& other) noexcept
-    : agent(other.agent),
-      baseline_sequence(std::move(other.baseline_sequence)),
-      virus_name(std::move(other.virus_name)),
-      date(other.date),
-      id(other.id),
-      state_init(other.state_init),
-      state_post(other.state_post),
-      state_removed(other.state_removed),
-      queue_init(other.queue_init),
-      queue_post(other.queue_post),
-      queue_removed(other.queue_removed)
-{
-    counter_move_construct++;
-    // other.agent = nullptr;
-}
-
-// Copy assignment
-template<typename TSeq>
-inline Virus<TSeq>& Virus<TSeq>::operator=(const Virus<TSeq>& other)
-{
-    if (this != &other) {
-        agent = other.agent;
-        baseline_sequence = other.baseline_sequence;
-        virus_name = other.virus_name;
-        date = other.date;
-        id = other.id;
-        state_init = other.state_init;
-        state_post = other.state_post;
-        state_removed = other.state_removed;
-        queue_init = other.queue_init;
-        queue_post = other.queue_post;
-        queue_removed = other.queue_removed;
-        counter_copy_assign++;
-    }
-    return *this;
-}
 
-// Move assignment
-template<typename TSeq>
-inline Virus<TSeq>& Virus<TSeq>::operator=(Virus<TSeq>&& other) noexcept
-{
-    if (this != &other) {
-        agent = other.agent;
-        baseline_sequence = std::move(other.baseline_sequence);
-        virus_name = std::move(other.virus_name);
-        date = other.date;
-        id = other.id;
-        state_init = other.state_init;
-        state_post = other.state_post;
-        state_removed = other.state_removed;
-        queue_init = other.queue_init;
-        queue_post = other.queue_post;
-        queue_removed = other.queue_removed;
-        other.agent = nullptr;
-        counter_move_assign++;
-    }
-    return *this;
-}
-#endif
+#ifndef EPIWORLD_TOOLS_MEAT_HPP
+#define EPIWORLD_TOOLS_MEAT_HPP
 
+/**
+ * @brief Factory function of ToolFun base on logit
+ * 
+ * @tparam TSeq 
+ * @param vars Vector indicating the position of the variables to use.
+ * @param coefs Vector of coefficients.
+ * @return ToolFun<TSeq> 
+ */
 template<typename TSeq>
-inline void Virus<TSeq>::mutate(
+inline ToolFun<TSeq> tool_fun_logit(
+    std::vector< int > vars,
+    std::vector< double > coefs,
     Model<TSeq> * model
 ) {
 
-    if (mutation)
-        if (mutation(agent, *this, model))
-            model->get_db().record_virus(*this);
+    // Checking that there are features
+    if (coefs.size() == 0u)
+        throw std::logic_error(
+            "The -coefs- argument should feature at least one element."
+            );
 
-    return;
-    
-}
+    if (coefs.size() != vars.size())
+        throw std::length_error(
+            std::string("The length of -coef- (") +
+            std::to_string(coefs.size()) + 
+            std::string(") and -vars- (") +
+            std::to_string(vars.size()) +
+            std::string(") should match. ")            
+            );
 
-template<typename TSeq>
-inline void Virus<TSeq>::set_mutation(
-    MutFun<TSeq> fun
-) {
-    mutation = MutFun<TSeq>(fun);
-}
+    // Checking that there are variables in the model
+    if (model != nullptr)
+    {
 
-template<typename TSeq>
-inline EPI_TYPENAME_TRAITS(TSeq, int) Virus<TSeq>::get_sequence()
-{
+        size_t K = model->get_agents_data_ncols();
+        for (const auto & var: vars)
+        {
+            if ((var >= static_cast<int>(K)) | (var < 0))
+                throw std::range_error(
+                    std::string("The variable ") +
+                    std::to_string(var) +
+                    std::string(" is out of range.") +
+                    std::string(" The agents only feature ") +
+                    std::to_string(K) + 
+                    std::string("variables (features).")
+                );
+        }
+        
+    }
 
-    return baseline_sequence;
+    std::vector< epiworld_double > coefs_f;
+    for (auto c: coefs)
+        coefs_f.push_back(static_cast<epiworld_double>(c));
 
-}
+    ToolFun<TSeq> fun_ = [coefs_f,vars](
+        Tool<TSeq>&,
+        Agent<TSeq> * agent,
+        VirusPtr<TSeq> &,
+        Model<TSeq> * model
+        ) -> epiworld_double {
 
-template<typename TSeq>
-inline void Virus<TSeq>::set_sequence(TSeq sequence)
-{
+        size_t K = coefs_f.size();
+        epiworld_double res = 0.0;
 
-    baseline_sequence = std::make_shared<TSeq>(sequence);
-    return;
+        #if defined(__OPENMP) || defined(_OPENMP)
+        #pragma omp simd reduction(+:res)
+        #endif
+        for (size_t i = 0u; i < K; ++i)
+            res += agent->operator()(vars.at(i), *model) * coefs_f.at(i);
 
-}
+        return 1.0/(1.0 + std::exp(-res));
 
-template<>
-inline void Virus<int>::set_sequence(int sequence)
-{
+    };
 
-    baseline_sequence = sequence;
-    return;
+    return fun_;
 
 }
 
-
 template<typename TSeq>
-inline Agent<TSeq> * Virus<TSeq>::get_agent()
+inline Tool<TSeq>::Tool()
 {
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        sequence = -1;
+    }
+    else
+    {
+        sequence = nullptr;
+    }
 
-    return agent;
-
+    set_name("Tool");
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::set_agent(Agent<TSeq> * p)
+inline Tool<TSeq>::Tool(std::string name)
 {
-    agent = p;
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        sequence = -1;
+    }
+    else
+    {
+        sequence = nullptr;
+    }
+
+    set_name(name);
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::set_id(int idx)
+inline Tool<TSeq>::Tool(
+    std::string name,
+    epiworld_double prevalence,
+    bool as_proportion
+    )
 {
 
-    id = idx;
-    return;
+    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
+    {
+        sequence = -1;
+    }
+    else
+    {
+        sequence = nullptr;
+    }
+
+    set_name(name);
 
+    set_distribution(
+        distribute_tool_randomly<TSeq>(prevalence, as_proportion)
+    );
 }
 
 template<typename TSeq>
-inline int Virus<TSeq>::get_id() const
-{
-    
-    return id;
-
+inline void Tool<TSeq>::set_sequence(TSeq d) {
+    sequence = std::make_shared<TSeq>(d);
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::set_date(int d) 
-{
-
-    date = d;
-    return;
+inline void Tool<TSeq>::set_sequence(std::shared_ptr<TSeq> d) {
+    sequence = d;
+}
 
+template<>
+inline void Tool<int>::set_sequence(int d) {
+    sequence = d;
 }
 
 template<typename TSeq>
-inline int Virus<TSeq>::get_date() const
-{
-    
-    return date;
-    
+inline EPI_TYPENAME_TRAITS(TSeq, int) Tool<TSeq>::get_sequence() {
+    return sequence;
 }
 
 template<typename TSeq>
-inline epiworld_double Virus<TSeq>::get_prob_infecting(
+inline epiworld_double Tool<TSeq>::get_susceptibility_reduction(
+    VirusPtr<TSeq> & v,
     Model<TSeq> * model
 )
 {
 
-    if (probability_of_infecting)
-        return probability_of_infecting(agent, *this, model);
-        
-    return EPI_DEFAULT_VIRUS_PROB_INFECTION;
-
-}
+    if (def->susceptibility_reduction)
+        return def->susceptibility_reduction(
+            *this, this->agent, v, model
+        );
 
+    return DEFAULT_TOOL_CONTAGION_REDUCTION;
 
+}
 
 template<typename TSeq>
-inline epiworld_double Virus<TSeq>::get_prob_recovery(
+inline epiworld_double Tool<TSeq>::get_transmission_reduction(
+    VirusPtr<TSeq> & v,
     Model<TSeq> * model
 )
 {
 
-    if (probability_of_recovery)
-        return probability_of_recovery(agent, *this, model);
-        
-    return EPI_DEFAULT_VIRUS_PROB_RECOVERY;
-
-}
+    if (def->transmission_reduction)
+        return def->transmission_reduction(
+            *this, this->agent, v, model
+        );
 
+    return DEFAULT_TOOL_TRANSMISSION_REDUCTION;
 
+}
 
 template<typename TSeq>
-inline epiworld_double Virus<TSeq>::get_prob_death(
+inline epiworld_double Tool<TSeq>::get_recovery_enhancer(
+    VirusPtr<TSeq> & v,
     Model<TSeq> * model
 )
 {
 
-    if (probability_of_death)
-        return probability_of_death(agent, *this, model);
-        
-    return EPI_DEFAULT_VIRUS_PROB_DEATH;
+    if (def->recovery_enhancer)
+        return def->recovery_enhancer(*this, this->agent, v, model);
+
+    return DEFAULT_TOOL_RECOVERY_ENHANCER;
 
 }
 
 template<typename TSeq>
-inline epiworld_double Virus<TSeq>::get_incubation(
+inline epiworld_double Tool<TSeq>::get_death_reduction(
+    VirusPtr<TSeq> & v,
     Model<TSeq> * model
 )
 {
 
-    if (incubation)
-        return incubation(agent, *this, model);
-        
-    return EPI_DEFAULT_INCUBATION_DAYS;
+    if (def->death_reduction)
+        return def->death_reduction(*this, this->agent, v, model);
 
-}
+    return DEFAULT_TOOL_DEATH_REDUCTION;
 
-template<typename TSeq>
-inline void Virus<TSeq>::set_prob_infecting_fun(VirusFun<TSeq> fun)
-{
-    probability_of_infecting = fun;
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::set_prob_recovery_fun(VirusFun<TSeq> fun)
+inline void Tool<TSeq>::set_susceptibility_reduction_fun(
+    ToolFun<TSeq> fun
+)
 {
-    probability_of_recovery = fun;
+    def_mut().susceptibility_reduction = fun;
+    set_fixed_effect(0u, fun == nullptr, DEFAULT_TOOL_CONTAGION_REDUCTION);
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::set_prob_death_fun(VirusFun<TSeq> fun)
+inline void Tool<TSeq>::set_transmission_reduction_fun(
+    ToolFun<TSeq> fun
+)
 {
-    probability_of_death = fun;
+    def_mut().transmission_reduction = fun;
+    set_fixed_effect(1u, fun == nullptr, DEFAULT_TOOL_TRANSMISSION_REDUCTION);
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::set_incubation_fun(VirusFun<TSeq> fun)
+inline void Tool<TSeq>::set_recovery_enhancer_fun(
+    ToolFun<TSeq> fun
+)
 {
-    incubation = fun;
+    def_mut().recovery_enhancer = fun;
+    set_fixed_effect(2u, fun == nullptr, DEFAULT_TOOL_RECOVERY_ENHANCER);
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::set_prob_infecting(std::string param)
+inline void Tool<TSeq>::set_death_reduction_fun(
+    ToolFun<TSeq> fun
+)
 {
-    auto parname_ptr = std::make_shared< const std::string >(param);
-    VirusFun<TSeq> tmpfun = 
-        [parname_ptr](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
-        {
-            return model->get_param(*parname_ptr);
-        };
-    
-    probability_of_infecting = tmpfun;
+    def_mut().death_reduction = fun;
+    set_fixed_effect(3u, fun == nullptr, DEFAULT_TOOL_DEATH_REDUCTION);
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::set_prob_recovery(std::string param)
+inline void Tool<TSeq>::set_susceptibility_reduction(std::string param)
 {
-    auto parname_ptr = std::make_shared< const std::string >(param);
-    VirusFun<TSeq> tmpfun = 
-        [parname_ptr](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
-        {
-            return model->get_param(*parname_ptr);
-        };
-    
-    probability_of_recovery = tmpfun;
-}
 
-template<typename TSeq>
-inline void Virus<TSeq>::set_prob_death(std::string param)
-{
-    auto parname_ptr = std::make_shared< const std::string >(param);
-    VirusFun<TSeq> tmpfun = 
-        [parname_ptr](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
+    const size_t param_id = Model<TSeq>::param_id(param);
+
+    ToolFun<TSeq> tmpfun =
+        [param_id](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
         {
-            return model->get_param(*parname_ptr);
+            return model->par(param_id);
         };
-    
-    probability_of_death = tmpfun;
+
+    def_mut().susceptibility_reduction = tmpfun;
+    set_fixed_effect(0u, false, 0.0);
+
 }
 
+// EPIWORLD_SET_LAMBDA(susceptibility_reduction)
 template<typename TSeq>
-inline void Virus<TSeq>::set_incubation(std::string param)
+inline void Tool<TSeq>::set_transmission_reduction(std::string param)
 {
-    auto parname_ptr = std::make_shared< const std::string >(param);
-    VirusFun<TSeq> tmpfun = 
-        [parname_ptr](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
+
+    const size_t param_id = Model<TSeq>::param_id(param);
+    
+    ToolFun<TSeq> tmpfun =
+        [param_id](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
         {
-            return model->get_param(*parname_ptr);
+            return model->par(param_id);
         };
-    
-    incubation = tmpfun;
+
+    def_mut().transmission_reduction = tmpfun;
+    set_fixed_effect(1u, false, 0.0);
+
 }
 
+// EPIWORLD_SET_LAMBDA(transmission_reduction)
 template<typename TSeq>
-inline void Virus<TSeq>::set_prob_infecting(epiworld_double prob)
+inline void Tool<TSeq>::set_recovery_enhancer(std::string param)
 {
-    VirusFun<TSeq> tmpfun = 
-        [prob](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> *)
+
+    const size_t param_id = Model<TSeq>::param_id(param);
+
+    ToolFun<TSeq> tmpfun =
+        [param_id](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
         {
-            return prob;
+            return model->par(param_id);
         };
-    
-    probability_of_infecting = tmpfun;
+
+    def_mut().recovery_enhancer = tmpfun;
+    set_fixed_effect(2u, false, 0.0);
+
 }
 
+// EPIWORLD_SET_LAMBDA(recovery_enhancer)
 template<typename TSeq>
-inline void Virus<TSeq>::set_prob_recovery(epiworld_double prob)
+inline void Tool<TSeq>::set_death_reduction(std::string param)
 {
-    VirusFun<TSeq> tmpfun = 
-        [prob](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> *)
+
+    const size_t param_id = Model<TSeq>::param_id(param);
+
+    ToolFun<TSeq> tmpfun =
+        [param_id](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
         {
-            return prob;
+            return model->par(param_id);
         };
-    
-    probability_of_recovery = tmpfun;
+
+    def_mut().death_reduction = tmpfun;
+    set_fixed_effect(3u, false, 0.0);
+
 }
 
+// EPIWORLD_SET_LAMBDA(death_reduction)
+
+// #undef EPIWORLD_SET_LAMBDA
 template<typename TSeq>
-inline void Virus<TSeq>::set_prob_death(epiworld_double prob)
+inline void Tool<TSeq>::set_susceptibility_reduction(
+    epiworld_double prob
+)
 {
-    VirusFun<TSeq> tmpfun = 
-        [prob](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> *)
+
+    ToolFun<TSeq> tmpfun = 
+        [prob](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq> *)
         {
             return prob;
         };
-    
-    probability_of_death = tmpfun;
+
+    def_mut().susceptibility_reduction = tmpfun;
+    set_fixed_effect(0u, true, prob);
+
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::set_incubation(epiworld_double prob)
+inline void Tool<TSeq>::set_transmission_reduction(
+    epiworld_double prob
+)
 {
-    VirusFun<TSeq> tmpfun = 
-        [prob](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> *)
+
+    ToolFun<TSeq> tmpfun = 
+        [prob](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq> *)
         {
             return prob;
         };
-    
-    incubation = tmpfun;
-}
 
-template<typename TSeq>
-inline void Virus<TSeq>::set_post_recovery(PostRecoveryFun<TSeq> fun)
-{
-    if (post_recovery_fun)
-    {
-        printf_epiworld(
-            "Warning: a PostRecoveryFun is alreay in place (overwriting)."
-            );
-    }
+    def_mut().transmission_reduction = tmpfun;
+    set_fixed_effect(1u, true, prob);
 
-    post_recovery_fun = fun;
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::post_recovery(
-    Model<TSeq> * model
+inline void Tool<TSeq>::set_recovery_enhancer(
+    epiworld_double prob
 )
 {
 
-    if (post_recovery_fun)
-        post_recovery_fun(agent, *this, model);    
+    ToolFun<TSeq> tmpfun = 
+        [prob](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq> *)
+        {
+            return prob;
+        };
+
+    def_mut().recovery_enhancer = tmpfun;
+    set_fixed_effect(2u, true, prob);
 
-    return;
-        
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::set_post_immunity(
+inline void Tool<TSeq>::set_death_reduction(
     epiworld_double prob
 )
 {
 
-    if (post_recovery_fun)
-    {
-
-        std::string msg =
-            std::string(
-                "You cannot set post immunity when a post_recovery "
-                ) +
-            std::string(
-                "function is already in place. Redesign the post_recovery function."
-                );
-
-        throw std::logic_error(msg);
-        
-    }
-
-    // To make sure that we keep registering the virus
-    ToolPtr<TSeq> __no_reinfect = std::make_shared<Tool<TSeq>>(
-        "Immunity (" + virus_name + ")"
-    );
-
-    __no_reinfect->set_susceptibility_reduction(prob);
-    __no_reinfect->set_death_reduction(0.0);
-    __no_reinfect->set_transmission_reduction(0.0);
-    __no_reinfect->set_recovery_enhancer(0.0);
-
-    PostRecoveryFun<TSeq> tmpfun = 
-        [__no_reinfect](
-            Agent<TSeq> * p, Virus<TSeq> &, Model<TSeq> * m
-            )
+    ToolFun<TSeq> tmpfun = 
+        [prob](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq> *)
         {
-            
-            // Have we registered the tool?
-            if (__no_reinfect->get_id() == -99)
-                m->get_db().record_tool(*__no_reinfect);
+            return prob;
+        };
 
-            p->add_tool(*m, *__no_reinfect);
+    def_mut().death_reduction = tmpfun;
+    set_fixed_effect(3u, true, prob);
 
-            return;
+}
 
-        };
+template<typename TSeq>
+inline typename Tool<TSeq>::Definition & Tool<TSeq>::def_mut()
+{
+
+    // Copy-on-write: other copies of the tool keep the current definition
+    if (def.use_count() > 1)
+        def = std::make_shared<Definition>(*def);
 
-    post_recovery_fun = tmpfun;
+    return *def;
 
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::set_post_immunity(
-    std::string param
+inline void Tool<TSeq>::set_fixed_effect(
+    size_t k,
+    bool fixed,
+    epiworld_double value
 )
 {
 
-    if (post_recovery_fun)
+    Definition & d = def_mut();
+    if (fixed)
     {
-
-        std::string msg =
-            std::string(
-                "You cannot set post immunity when a post_recovery "
-                ) +
-            std::string(
-                "function is already in place. Redesign the post_recovery function."
-                );
-
-        throw std::logic_error(msg);
-
+        d.fixed_mask |= static_cast<unsigned char>(1u << k);
+        d.fixed_value[k] = value;
     }
+    else
+        d.fixed_mask &= static_cast<unsigned char>(~(1u << k));
 
-    // To make sure that we keep registering the virus
-    ToolPtr<TSeq> __no_reinfect = std::make_shared<Tool<TSeq>>(
-        "Immunity (" + virus_name + ")"
-    );
-
-    __no_reinfect->set_susceptibility_reduction(param);
-    __no_reinfect->set_death_reduction(0.0);
-    __no_reinfect->set_transmission_reduction(0.0);
-    __no_reinfect->set_recovery_enhancer(0.0);
-
-    PostRecoveryFun<TSeq> tmpfun = 
-        [__no_reinfect](Agent<TSeq> * p, Virus<TSeq> &, Model<TSeq> * m)
-        {
-
-            // Have we registered the tool?
-            if (__no_reinfect->get_id() == -99)
-                m->get_db().record_tool(*__no_reinfect);
+    // Already in an agent, so its cache is stale
+    if (agent != nullptr)
+        agent->tools_effects_update();
 
-            p->add_tool(*m, *__no_reinfect);
+}
 
-            return;
+template<typename TSeq>
+inline void Tool<TSeq>::set_name(std::string name)
+{
+    def_mut().tool_name = name;
+}
 
-        };
+template<typename TSeq>
+inline std::string Tool<TSeq>::get_name() const {
 
-    post_recovery_fun = tmpfun;
+    return def->tool_name;
 
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::set_name(std::string name)
+inline Agent<TSeq> * Tool<TSeq>::get_agent()
 {
+    return this->agent;
+}
 
-    virus_name = name;
+template<typename TSeq>
+inline void Tool<TSeq>::set_agent(Agent<TSeq> * p, size_t idx)
+{
+    agent        = p;
+    pos_in_agent = static_cast<int>(idx);
+}
 
+template<typename TSeq>
+inline int Tool<TSeq>::get_id() const {
+    return id;
 }
 
+
 template<typename TSeq>
-inline std::string Virus<TSeq>::get_name() const
+inline void Tool<TSeq>::set_id(int id)
 {
+    this->id = id;
+}
 
-    return virus_name;
+template<typename TSeq>
+inline void Tool<TSeq>::set_date(int d)
+{
+    this->date = d;
+}
 
+template<typename TSeq>
+inline int Tool<TSeq>::get_date() const
+{
+    return date;
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::set_state(
+inline void Tool<TSeq>::set_state(
     epiworld_fast_int init,
-    epiworld_fast_int end,
-    epiworld_fast_int removed
+    epiworld_fast_int end
 )
 {
-    state_init    = init;
-    state_post    = end;
-    state_removed = removed;
+    def_mut().state_init = init;
+    def_mut().state_post = end;
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::set_queue(
+inline void Tool<TSeq>::set_queue(
     epiworld_fast_int init,
-    epiworld_fast_int end,
-    epiworld_fast_int removed
+    epiworld_fast_int end
 )
 {
-
-    queue_init    = init;
-    queue_post     = end;
-    queue_removed = removed;
-
+    def_mut().queue_init = init;
+    def_mut().queue_post = end;
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::get_state(
+inline void Tool<TSeq>::get_state(
     epiworld_fast_int * init,
-    epiworld_fast_int * end,
-    epiworld_fast_int * removed
-) const
+    epiworld_fast_int * post
+)
 {
-
     if (init != nullptr)
-        *init = state_init;
+        *init = def->state_init;
 
-    if (end != nullptr)
-        *end = state_post;
-
-    if (removed != nullptr)
-        *removed = state_removed;
+    if (post != nullptr)
+        *post = def->state_post;
 
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::get_queue(
+inline void Tool<TSeq>::get_queue(
     epiworld_fast_int * init,
-    epiworld_fast_int * end,
-    epiworld_fast_int * removed
-) const
+    epiworld_fast_int * post
+)
 {
-
     if (init != nullptr)
-        *init = queue_init;
+        *init = def->queue_init;
 
-    if (end != nullptr)
-        *end = queue_post;
+    if (post != nullptr)
+        *post = def->queue_post;
 
-    if (removed != nullptr)
-        *removed = queue_removed;
-        
 }
 
 template<>
-inline bool Virus<std::vector<int>>::operator==(
-    const Virus<std::vector<int>> & other
+inline bool Tool<std::vector<int>>::operator==(
+    const Tool<std::vector<int>> & other
     ) const
 {
     
-    EPI_DEBUG_FAIL_AT_TRUE(
-        baseline_sequence->size() != other.baseline_sequence->size(),
-        "Virus:: baseline_sequence don't match"
-        )
+    if (sequence->size() != other.sequence->size())
+        return false;
 
-    for (size_t i = 0u; i < baseline_sequence->size(); ++i)
+    for (size_t i = 0u; i < sequence->size(); ++i)
     {
-
-        EPI_DEBUG_FAIL_AT_TRUE(
-            baseline_sequence->operator[](i) != other.baseline_sequence->operator[](i),
-            "Virus:: baseline_sequence[i] don't match"
-            )
-
+        if (sequence->operator[](i) != other.sequence->operator[](i))
+            return false;
     }
 
-    EPI_DEBUG_FAIL_AT_TRUE(
-        virus_name != other.virus_name,
-        "Virus:: virus_name don't match"
-        )
+    if (def->tool_name != other.def->tool_name)
+        return false;
     
-    EPI_DEBUG_FAIL_AT_TRUE(
-        state_init != other.state_init,
-        "Virus:: state_init don't match"
-        )
-
-    EPI_DEBUG_FAIL_AT_TRUE(
-        state_post != other.state_post,
-        "Virus:: state_post don't match"
-        )
+    if (def->state_init != other.def->state_init)
+        return false;
 
-    EPI_DEBUG_FAIL_AT_TRUE(
-        state_removed != other.state_removed,
-        "Virus:: state_removed don't match"
-        )
+    if (def->state_post != other.def->state_post)
+        return false;
 
-    EPI_DEBUG_FAIL_AT_TRUE(
-        queue_init != other.queue_init,
-        "Virus:: queue_init don't match"
-        )
+    if (def->queue_init != other.def->queue_init)
+        return false;
 
-    EPI_DEBUG_FAIL_AT_TRUE(
-        queue_post != other.queue_post,
-        "Virus:: queue_post don't match"
-        )
+    if (def->queue_post != other.def->queue_post)
+        return false;
 
-    EPI_DEBUG_FAIL_AT_TRUE(
-        queue_removed != other.queue_removed,
-        "Virus:: queue_removed don't match"
-        )
 
     return true;
 
 }
 
 template<typename TSeq>
-inline bool Virus<TSeq>::operator==(const Virus<TSeq> & other) const
+inline bool Tool<TSeq>::operator==(const Tool<TSeq> & other) const
 {
-    
     EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
     {
-        EPI_DEBUG_FAIL_AT_TRUE(
-            baseline_sequence != other.baseline_sequence,
-            "Virus:: baseline_sequence don't match"
-        )
+        if (sequence != other.sequence)
+            return false;
     }
     else
     {
-        EPI_DEBUG_FAIL_AT_TRUE(
-            baseline_sequence != other.baseline_sequence,
-            "Virus:: baseline_sequence don't match"
-        )
+        if (*sequence != *other.sequence)
+            return false;
     }
 
-    EPI_DEBUG_FAIL_AT_TRUE(
-        virus_name != other.virus_name,
-        "Virus:: virus_name don't match"
-    )
-    
-    EPI_DEBUG_FAIL_AT_TRUE(
-        state_init != other.state_init,
-        "Virus:: state_init don't match"
-    )
-
-    EPI_DEBUG_FAIL_AT_TRUE(
-        state_post != other.state_post,
-        "Virus:: state_post don't match"
-    )
 
-    EPI_DEBUG_FAIL_AT_TRUE(
-        state_removed != other.state_removed,
-        "Virus:: state_removed don't match"
-    )
+    if (def->tool_name != other.def->tool_name)
+        return false;
+    
+    if (def->state_init != other.def->state_init)
+        return false;
 
-    EPI_DEBUG_FAIL_AT_TRUE(
-        queue_init != other.queue_init,
-        "Virus:: queue_init don't match"
-    )
+    if (def->state_post != other.def->state_post)
+        return false;
 
-    EPI_DEBUG_FAIL_AT_TRUE(
-        queue_post != other.queue_post,
-        "Virus:: queue_post don't match"
-    )
+    if (def->queue_init != other.def->queue_init)
+        return false;
 
-    EPI_DEBUG_FAIL_AT_TRUE(
-        queue_removed != other.queue_removed,
-        "Virus:: queue_removed don't match"
-    )
+    if (def->queue_post != other.def->queue_post)
+        return false;
 
     return true;
 
 }
 
+
 template<typename TSeq>
-inline void Virus<TSeq>::print() const
+inline void Tool<TSeq>::print() const
 {
 
-    printf_epiworld("Virus         : %s\n", virus_name.c_str());
-    printf_epiworld("Id            : %s\n", (id < 0)? std::string("(empty)").c_str() : std::to_string(id).c_str());
-    printf_epiworld("state_init    : %i\n", static_cast<int>(state_init));
-    printf_epiworld("state_post    : %i\n", static_cast<int>(state_post));
-    printf_epiworld("state_removed : %i\n", static_cast<int>(state_removed));
-    printf_epiworld("queue_init    : %i\n", static_cast<int>(queue_init));
-    printf_epiworld("queue_post    : %i\n", static_cast<int>(queue_post));
-    printf_epiworld("queue_removed : %i\n", static_cast<int>(queue_removed));
+    printf_epiworld("Tool       : %s\n", this->get_name().c_str());
+    printf_epiworld("Id         : %s\n", (id < 0)? std::string("(empty)").c_str() : std::to_string(id).c_str());
+    printf_epiworld("state_init : %i\n", static_cast<int>(def->state_init));
+    printf_epiworld("state_post : %i\n", static_cast<int>(def->state_post));
+    printf_epiworld("queue_init : %i\n", static_cast<int>(def->queue_init));
+    printf_epiworld("queue_post : %i\n", static_cast<int>(def->queue_post));
 
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::distribute(Model<TSeq> * model)
+inline void Tool<TSeq>::distribute(Model<TSeq> * model)
 {
 
-    if (dist)
+    if (def->dist)
     {
 
-        dist(*this, model);
+        def->dist(*this, model);
 
     }
 
 }
 
 template<typename TSeq>
-inline void Virus<TSeq>::set_distribution(VirusToAgentFun<TSeq> fun)
+inline void Tool<TSeq>::set_distribution(ToolToAgentFun<TSeq> fun)
 {
-    dist = fun;
+    def_mut().dist = fun;
 }
 
 template<typename TSeq>
-inline std::unique_ptr<Virus<TSeq>> Virus<TSeq>::clone_ptr() const
+inline std::unique_ptr<Tool<TSeq>> Tool<TSeq>::clone_ptr() const
 {
-    auto cloned = std::make_unique<Virus<TSeq>>(*this);
+    auto cloned = std::make_unique<Tool<TSeq>>(*this);
     return cloned;
 }
 
@@ -15175,960 +19364,1038 @@ inline std::unique_ptr<Virus<TSeq>> Virus<TSeq>::clone_ptr() const
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- End of -./include/epiworld/virus-meat.hpp-
+ End of -./include/epiworld/tool-meat.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
-    
-    // #include "tools-bones.hpp"
 
-// (already included ./include/epiworld/tool-bones.hpp)
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- Start of -./include/epiworld/tool-distribute-meat.hpp-
+ Start of -./include/epiworld/entity-bones.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
-#ifndef TOOL_DISTRIBUTE_MEAT_HPP
-#define TOOL_DISTRIBUTE_MEAT_HPP
+#ifndef EPIWORLD_ENTITY_BONES_HPP
+#define EPIWORLD_ENTITY_BONES_HPP
 
-/**
- * @brief Distributes a tool to a set of agents.
- * 
- * This function takes a vector of agent IDs and returns a lambda function that
- * distributes a tool to each agent in the set.
- * 
- * The lambda function takes a reference to a Tool object and a pointer to a
- * Model object as parameters. It iterates over the agent IDs and adds the tool
- * to each agent using the add_tool() method of the Model object.
- * 
- * @tparam TSeq The sequence type used in the Tool and Model objects.
- * @param agents_ids A vector of agent IDs representing the set of agents to
- * distribute the tool to.
- * @return A lambda function that distributes the tool to the set of agents.
- */
-template<typename TSeq = EPI_DEFAULT_TSEQ>
-inline ToolToAgentFun<TSeq> distribute_tool_to_set(
-    std::vector< size_t > agents_ids
-) {
+template<typename TSeq>
+class Model;
 
-    return [agents_ids](
-        Tool<TSeq> & tool, Model<TSeq> * model
-    ) -> void 
-    { 
-        // Adding action
-        for (auto i: agents_ids)
-        {
-            model->get_agent(i).add_tool(
-                *model, tool
-                );
-        }
-    };
+template<typename TSeq>
+class Agent;
 
-}
+template<typename TSeq>
+class AgentsSample;
 
 /**
- * Function template to distribute a tool randomly to agents in a model.
- * 
- * @tparam TSeq The sequence type used in the model.
- * @param prevalence The prevalence of the tool in the population.
- * @param as_proportion Flag indicating whether the prevalence is given as a
- * proportion or an absolute value.
- * @return A lambda function that distributes the tool randomly to agents in
- * the model.
+ * @brief Groups of agents within a model.
  */
-template<typename TSeq = EPI_DEFAULT_TSEQ>
-inline ToolToAgentFun<TSeq> distribute_tool_randomly(
-    epiworld_double prevalence,
-    bool as_proportion = true,
-    std::vector< size_t > agents_ids = {}
-) {
+template<typename TSeq>
+class Entity {
+    friend class Agent<TSeq>;
+    friend class AgentsSample<TSeq>;
+    friend class Model<TSeq>;
+private:
+    
+    int id = -1;
+    std::vector< epiworld_agent_index > agents;   ///< Agent IDs (indices into Model::population)
 
-    auto agents_ids_ptr = std::make_shared< std::vector< size_t > >(agents_ids);
+    int max_capacity = -1;
+    std::string entity_name = "Unnamed entity";
 
-    return [prevalence,as_proportion,agents_ids_ptr](
-        Tool<TSeq> & tool, Model<TSeq> * model
-        ) -> void {
+    std::vector< epiworld_double > location = {0.0}; ///< An arbitrary vector for location
 
-            // Figuring out how what agents are available
-            bool use_set = agents_ids_ptr->size() > 0;
+    epiworld_fast_int state_init = -99;
+    epiworld_fast_int state_post = -99;
 
-            // Picking how many
-            int n_to_distribute;
-            int n = use_set ? 
-                static_cast<int>(agents_ids_ptr->size()) :
-                static_cast<int>(model->size());
-                
-            if (as_proportion)
-            {
-                n_to_distribute = static_cast<int>(std::floor(prevalence * n));
+    epiworld_fast_int queue_init = 0; ///< Change of state when added to agent.
+    epiworld_fast_int queue_post = 0; ///< Change of state when removed from agent.
 
-                // Correcting for possible rounding errors
-                if (n_to_distribute > n)
-                    n_to_distribute = n;
+    EntityToAgentFun<TSeq> dist_fun = nullptr;
 
-            }
-            else
-            {
-                n_to_distribute = static_cast<int>(prevalence);
-            }
+    void reset();
+
+public:
+
+
+    /**
+     * @brief Constructs an Entity object.
+     *
+     * This constructor initializes an Entity object with the specified parameters.
+     *
+     * @param name The name of the entity.
+     * @param fun A function pointer to a function that maps the entity to an agent.
+     */
+    Entity(
+        std::string name,
+        EntityToAgentFun<TSeq> fun = nullptr
+        ) :
+            entity_name(name),
+            dist_fun(fun)
+        {};
+
+    ~Entity() = default;
+    
+    void add_agent(Agent<TSeq> & p, Model<TSeq> & model);
+    void add_agent(Agent<TSeq> * p, Model<TSeq> & model);
+    void rm_agent(size_t idx, Model<TSeq> & model);
+    size_t size() const noexcept;
+    void set_location(std::vector< epiworld_double > loc);
+    std::vector< epiworld_double > & get_location();
+
+    typename std::vector< epiworld_agent_index >::iterator begin();
+    typename std::vector< epiworld_agent_index >::iterator end();
+
+    typename std::vector< epiworld_agent_index >::const_iterator begin() const;
+    typename std::vector< epiworld_agent_index >::const_iterator end() const;
+
+    size_t operator[](size_t i);
+
+    int get_id() const noexcept;
+    const std::string & get_name() const noexcept;
+
+    void set_state(epiworld_fast_int init, epiworld_fast_int post);
+    void set_queue(epiworld_fast_int init, epiworld_fast_int post);
+    void get_state(epiworld_fast_int * init, epiworld_fast_int * post);
+    void get_queue(epiworld_fast_int * init, epiworld_fast_int * post);
+
+    bool operator==(const Entity<TSeq> & other) const;
+    bool operator!=(const Entity<TSeq> & other) const {return !operator==(other);};
+
+    /** 
+     * @name Entity distribution
+     * 
+     * @details These functions are used for distributing agents among entities.
+     * The idea is to have a flexible way of distributing agents among entities.
+     
+     */
+    void distribute(Model<TSeq> * model);
+
+    const std::vector< epiworld_agent_index > & get_agents() const;
+    const std::vector< epiworld_agent_index > & get_agents_ids() const;
+
+    void print() const;
+    void set_distribution(EntityToAgentFun<TSeq> fun);
+
+};
+
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/entity-bones.hpp-
+
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-            if (n_to_distribute > n)
-                throw std::range_error("There are only " + std::to_string(n) + 
-                " individuals in the population. Cannot add the tool to " + std::to_string(n_to_distribute));
-            
-            std::vector< int > idx(n);
-            std::iota(idx.begin(), idx.end(), 0);
-            auto & population = model->get_agents();
-            for (int i = 0u; i < n_to_distribute; ++i)
-            {
-                int loc = model->runif_index(n--);
 
-                if ((n > 0) && (loc >= n))
-                    loc = n - 1;
-                
-                population[idx[loc]].add_tool(
-                    *model, tool
-                    );
-                
-                std::swap(idx[loc], idx[n]);
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-            }
+ Start of -./include/epiworld/entity-distribute-meat.hpp-
 
-        };
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-}
 
+#ifndef EPIWORLD_ENTITY_DISTRIBUTE_MEAT_HPP
+#define EPIWORLD_ENTITY_DISTRIBUTE_MEAT_HPP
+
+
+template <typename TSeq = EPI_DEFAULT_TSEQ>
 /**
- * Function template to distribute a tool to agents in each entity of a model.
+ * Distributes an entity to unassigned agents in the model.
  * 
- * @tparam TSeq The sequence type used in the model.
- * @param prevalence A vector of prevalences for each entity in the model.
- * @param as_proportion Flag indicating whether the prevalences are given as
- * proportions or absolute values.
- * @return A lambda function that distributes the tool to agents in each entity
- * of the model.
+ * @param prevalence The proportion of agents to distribute the entity to.
+ * @param as_proportion Flag indicating whether the prevalence is a proportion
+ * @param to_unassigned Flag indicating whether to distribute the entity only
+ * to unassigned agents.
+ * @return An EntityToAgentFun object that distributes the entity to unassigned
+ * agents.
  */
-template<typename TSeq = EPI_DEFAULT_TSEQ>
-inline ToolToAgentFun<TSeq> distribute_tool_to_entities(
-    std::vector< double > prevalence,
-    bool as_proportion = true
+inline EntityToAgentFun<TSeq> distribute_entity_randomly(
+    epiworld_double prevalence,
+    bool as_proportion,
+    bool to_unassigned
 )
 {
 
-    // Checking proportions are within range
-    if (prevalence.size() == 0)
-        throw std::range_error("Prevalence vector cannot be empty");
+    return [prevalence, as_proportion, to_unassigned](
+        Entity<TSeq> & e, Model<TSeq> * m
+        ) -> void {
 
-    if (as_proportion)
-    {
-        for (auto p: prevalence)
+        
+        // Preparing the sampling space
+        std::vector< size_t > idx;
+        if (to_unassigned)
         {
-            if ((p < 0.0) || (p > 1.0))
-                throw std::range_error("Proportions must be between 0 and 1");
-        }
-    }
-    else
-    {
-        for (auto p: prevalence)
+            for (const auto & a: m->get_agents())
+                if (a.get_n_entities() == 0)
+                    idx.push_back(a.get_id());
+        } 
+        else
         {
-            if (p < 0.0)
-                throw std::range_error("Count values in prevalence must be non-negative");
+
+            for (const auto & a: m->get_agents())
+                idx.push_back(a.get_id());
+
         }
-    }
+        
+        size_t n = idx.size();
 
-    return [prevalence, as_proportion](
-        Tool<TSeq> & tool, Model<TSeq> * model
-    ) -> void 
-    { 
+        // Figuring out how many to sample
+        int n_to_sample;
+        if (as_proportion)
+        {
+            n_to_sample = static_cast<int>(std::floor(prevalence * n));
 
-        // Checking the number of entities
-        if (prevalence.size() != model->get_entities().size())
-            throw std::range_error(
-                "Prevalence vector size (" + std::to_string(prevalence.size()) +
-                ") does not match number of entities (" + std::to_string(model->get_entities().size()) + ")"
-                );
+            // Correcting for possible overflow
+            if (n_to_sample > static_cast<int>(n))
+                n_to_sample = static_cast<int>(n);
 
-        // Adding action
-        auto & entities = model->get_entities();
-        auto & population = model->get_agents();
-        for (size_t e = 0; e < entities.size(); ++e)
+        } else
         {
-            auto & entity_e = entities[e];
-            auto agent_ids = entity_e.get_agents_ids();
-            double prevalence_e = prevalence[e];
-            size_t n = agent_ids.size();
-            size_t n_to_distribute;
-            if (as_proportion)
-                n_to_distribute = static_cast<size_t>(std::floor(prevalence_e * n));
-            else
-                n_to_distribute = static_cast<size_t>(prevalence_e);
+            n_to_sample = static_cast<int>(prevalence);
+            if (n_to_sample > static_cast<int>(n))
+                throw std::range_error("There are only " + std::to_string(n) + 
+                " individuals in the population. Cannot add the entity to " +
+                    std::to_string(n_to_sample));
+        }
 
-            if (n_to_distribute > n)
-                n_to_distribute = n;
+        int n_left = n;
+        for (int i = 0; i < n_to_sample; ++i)
+        {
+            int loc = m->runif_index(n_left--);
 
-            std::vector< size_t > idx = agent_ids;
-            for (size_t i = 0u; i < n_to_distribute; ++i)
-            {
-                size_t loc = model->runif_index(n--);
+            // Correcting for possible overflow
+            if ((n_left > 0) && (loc > n_left))
+                loc = n_left - 1;
 
-                if ((n > 0) && (loc >= n))
-                    loc = n - 1;
-                
-                population[idx[loc]].add_tool(
-                    *model, tool
-                    );
-                
-                std::swap(idx[loc], idx[n]);
+            m->get_agent(idx[loc]).add_entity(*m, e);
+
+            std::swap(idx[loc], idx[n_left]);
 
-            }
         }
+
     };
 
 }
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
 
- End of -./include/epiworld/tool-distribute-meat.hpp-
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+/**
+ * Distributes an entity to a range of agents.
+ *
+ * @param from The starting index of the range.
+ * @param to The ending index of the range.
+ * @param to_unassigned Flag indicating whether to distribute the entity only
+ * to unassigned agents.
+ * @return A lambda function that distributes the entity to the specified range
+ * of agents.
+ */
+inline EntityToAgentFun<TSeq> distribute_entity_to_range(
+    int from,
+    int to,
+    bool to_unassigned = false
+    ) {
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    if (to_unassigned)
+    {
 
+        return [from, to](Entity<TSeq> & e, Model<TSeq> * m) -> void {
 
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+            auto & agents = m->get_agents();
+            for (int i = from; i < to; ++i)
+            {
+                if (agents[i].get_n_entities() == 0)
+                    e.add_agent(&agents[i], *m);
+                else
+                    throw std::logic_error(
+                        "Agent " + std::to_string(i) + " already has an entity."
+                    );
+            }
+            
+            return;
 
- Start of -./include/epiworld/tool-meat.hpp-
+        };
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    }
+    else
+    {
+
+        return [from, to](Entity<TSeq> & e, Model<TSeq> * m) -> void {
+
+            auto & agents = m->get_agents();
+            for (int i = from; i < to; ++i)
+            {
+                e.add_agent(&agents[i], *m);
+            }
 
+            return;
 
+        };
 
-#ifndef EPIWORLD_TOOLS_MEAT_HPP
-#define EPIWORLD_TOOLS_MEAT_HPP
+    }
+}
 
-/**
- * @brief Factory function of ToolFun base on logit
- * 
- * @tparam TSeq 
- * @param vars Vector indicating the position of the variables to use.
- * @param coefs Vector of coefficients.
- * @return ToolFun<TSeq> 
- */
-template<typename TSeq>
-inline ToolFun<TSeq> tool_fun_logit(
-    std::vector< int > vars,
-    std::vector< double > coefs,
-    Model<TSeq> * model
-) {
 
-    // Checking that there are features
-    if (coefs.size() == 0u)
-        throw std::logic_error(
-            "The -coefs- argument should feature at least one element."
-            );
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline EntityToAgentFun<TSeq> distribute_entity_to_set(
+    std::vector< size_t > & idx
+    ) {
 
-    if (coefs.size() != vars.size())
-        throw std::length_error(
-            std::string("The length of -coef- (") +
-            std::to_string(coefs.size()) + 
-            std::string(") and -vars- (") +
-            std::to_string(vars.size()) +
-            std::string(") should match. ")            
-            );
+    auto idx_shared = std::make_shared< std::vector< size_t > >(idx);
 
-    // Checking that there are variables in the model
-    if (model != nullptr)
-    {
+    return [idx_shared](Entity<TSeq> & e, Model<TSeq> * m) -> void {
 
-        size_t K = model->get_agents_data_ncols();
-        for (const auto & var: vars)
+        for (const auto & i: *idx_shared)
         {
-            if ((var >= static_cast<int>(K)) | (var < 0))
-                throw std::range_error(
-                    std::string("The variable ") +
-                    std::to_string(var) +
-                    std::string(" is out of range.") +
-                    std::string(" The agents only feature ") +
-                    std::to_string(K) + 
-                    std::string("variables (features).")
-                );
+            e.add_agent(&m->get_agent(i), *m);
         }
-        
-    }
 
-    std::vector< epiworld_double > coefs_f;
-    for (auto c: coefs)
-        coefs_f.push_back(static_cast<epiworld_double>(c));
+    };
+
+}
+
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -./include/epiworld/entity-distribute-meat.hpp-
 
-    ToolFun<TSeq> fun_ = [coefs_f,vars](
-        Tool<TSeq>&,
-        Agent<TSeq> * agent,
-        VirusPtr<TSeq> &,
-        Model<TSeq> * model
-        ) -> epiworld_double {
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-        size_t K = coefs_f.size();
-        epiworld_double res = 0.0;
 
-        #if defined(__OPENMP) || defined(_OPENMP)
-        #pragma omp simd reduction(+:res)
-        #endif
-        for (size_t i = 0u; i < K; ++i)
-            res += agent->operator()(vars.at(i), *model) * coefs_f.at(i);
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-        return 1.0/(1.0 + std::exp(-res));
+ Start of -./include/epiworld/entity-meat.hpp-
 
-    };
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    return fun_;
 
-}
+#ifndef EPIWORLD_ENTITY_MEAT_HPP
+#define EPIWORLD_ENTITY_MEAT_HPP
 
 template<typename TSeq>
-inline Tool<TSeq>::Tool()
+inline void Entity<TSeq>::add_agent(
+    Agent<TSeq> & p,
+    Model<TSeq> & model
+    )
 {
-    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
-    {
-        sequence = -1;
-    }
-    else
-    {
-        sequence = nullptr;
-    }
 
-    set_name("Tool");
+    // Need to add it to the events, through the individual
+    p.add_entity(model, *this);
+
 }
 
 template<typename TSeq>
-inline Tool<TSeq>::Tool(std::string name)
+inline void Entity<TSeq>::add_agent(
+    Agent<TSeq> * p,
+    Model<TSeq> & model
+    )
 {
-    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
-    {
-        sequence = -1;
-    }
-    else
-    {
-        sequence = nullptr;
-    }
-
-    set_name(name);
+    p->add_entity(model, *this);
 }
 
 template<typename TSeq>
-inline Tool<TSeq>::Tool(
-    std::string name,
-    epiworld_double prevalence,
-    bool as_proportion
-    )
+inline void Entity<TSeq>::rm_agent(size_t idx, Model<TSeq> & model)
 {
+    if (idx >= size())
+        throw std::out_of_range(
+            "Trying to remove agent "+ std::to_string(idx) +
+            " out of " + std::to_string(size())
+            );
 
-    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
-    {
-        sequence = -1;
-    }
-    else
-    {
-        sequence = nullptr;
-    }
-
-    set_name(name);
+    model.population[agents[idx]].rm_entity(model, *this);
 
-    set_distribution(
-        distribute_tool_randomly<TSeq>(prevalence, as_proportion)
-    );
+    return;
 }
 
 template<typename TSeq>
-inline void Tool<TSeq>::set_sequence(TSeq d) {
-    sequence = std::make_shared<TSeq>(d);
+inline size_t Entity<TSeq>::size() const noexcept
+{
+    return agents.size();
 }
 
 template<typename TSeq>
-inline void Tool<TSeq>::set_sequence(std::shared_ptr<TSeq> d) {
-    sequence = d;
-}
-
-template<>
-inline void Tool<int>::set_sequence(int d) {
-    sequence = d;
+inline void Entity<TSeq>::set_location(std::vector< epiworld_double > loc)
+{
+    location = loc;
 }
 
 template<typename TSeq>
-inline EPI_TYPENAME_TRAITS(TSeq, int) Tool<TSeq>::get_sequence() {
-    return sequence;
+inline std::vector< epiworld_double > & Entity<TSeq>::get_location()
+{
+    return location;
 }
 
 template<typename TSeq>
-inline epiworld_double Tool<TSeq>::get_susceptibility_reduction(
-    VirusPtr<TSeq> & v,
-    Model<TSeq> * model
-)
+inline typename std::vector< epiworld_agent_index >::iterator Entity<TSeq>::begin()
 {
 
-    if (susceptibility_reduction)
-        return susceptibility_reduction(
-            *this, this->agent, v, model
-        );
-
-    return DEFAULT_TOOL_CONTAGION_REDUCTION;
+    return agents.begin();
 
 }
 
 template<typename TSeq>
-inline epiworld_double Tool<TSeq>::get_transmission_reduction(
-    VirusPtr<TSeq> & v,
-    Model<TSeq> * model
-)
+inline typename std::vector< epiworld_agent_index >::iterator Entity<TSeq>::end()
 {
-
-    if (transmission_reduction)
-        return transmission_reduction(
-            *this, this->agent, v, model
-        );
-
-    return DEFAULT_TOOL_TRANSMISSION_REDUCTION;
-
+    return agents.end();
 }
 
 template<typename TSeq>
-inline epiworld_double Tool<TSeq>::get_recovery_enhancer(
-    VirusPtr<TSeq> & v,
-    Model<TSeq> * model
-)
+inline typename std::vector< epiworld_agent_index >::const_iterator Entity<TSeq>::begin() const
 {
 
-    if (recovery_enhancer)
-        return recovery_enhancer(*this, this->agent, v, model);
+    return agents.begin();
 
-    return DEFAULT_TOOL_RECOVERY_ENHANCER;
+}
 
+template<typename TSeq>
+inline typename std::vector< epiworld_agent_index >::const_iterator Entity<TSeq>::end() const
+{
+    return agents.end();
 }
 
 template<typename TSeq>
-inline epiworld_double Tool<TSeq>::get_death_reduction(
-    VirusPtr<TSeq> & v,
-    Model<TSeq> * model
-)
+size_t Entity<TSeq>::operator[](size_t i)
 {
+    if (agents.size() <= i)
+        throw std::logic_error(
+            "There are not that many agents in this entity. " +
+            std::to_string(agents.size()) + " <= " + std::to_string(i)
+            );
 
-    if (death_reduction)
-        return death_reduction(*this, this->agent, v, model);
+    return agents[i];
+}
 
-    return DEFAULT_TOOL_DEATH_REDUCTION;
+template<typename TSeq>
+inline int Entity<TSeq>::get_id() const noexcept
+{
+    return id;
+}
 
+template<typename TSeq>
+inline const std::string & Entity<TSeq>::get_name() const noexcept
+{
+    return entity_name;
 }
 
 template<typename TSeq>
-inline void Tool<TSeq>::set_susceptibility_reduction_fun(
-    ToolFun<TSeq> fun
+inline void Entity<TSeq>::set_state(
+    epiworld_fast_int init,
+    epiworld_fast_int end
 )
 {
-    susceptibility_reduction = fun;
+    state_init = init;
+    state_post = end;
 }
 
 template<typename TSeq>
-inline void Tool<TSeq>::set_transmission_reduction_fun(
-    ToolFun<TSeq> fun
+inline void Entity<TSeq>::set_queue(
+    epiworld_fast_int init,
+    epiworld_fast_int end
 )
 {
-    transmission_reduction = fun;
+    queue_init = init;
+    queue_post = end;
 }
 
 template<typename TSeq>
-inline void Tool<TSeq>::set_recovery_enhancer_fun(
-    ToolFun<TSeq> fun
+inline void Entity<TSeq>::get_state(
+    epiworld_fast_int * init,
+    epiworld_fast_int * post
 )
 {
-    recovery_enhancer = fun;
+    if (init != nullptr)
+        *init = state_init;
+
+    if (post != nullptr)
+        *post = state_post;
+
 }
 
 template<typename TSeq>
-inline void Tool<TSeq>::set_death_reduction_fun(
-    ToolFun<TSeq> fun
+inline void Entity<TSeq>::get_queue(
+    epiworld_fast_int * init,
+    epiworld_fast_int * post
 )
 {
-    death_reduction = fun;
+    if (init != nullptr)
+        *init = queue_init;
+
+    if (post != nullptr)
+        *post = queue_post;
+
 }
 
 template<typename TSeq>
-inline void Tool<TSeq>::set_susceptibility_reduction(std::string param)
+inline void Entity<TSeq>::reset()
 {
 
-    auto parname_ptr = std::make_shared<const std::string>(param);
-
-    ToolFun<TSeq> tmpfun =
-        [parname_ptr](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
-        {
-            return model->get_param(*parname_ptr);
-        };
+    this->agents.clear();
 
-    susceptibility_reduction = tmpfun;
+    return;
 
 }
 
-// EPIWORLD_SET_LAMBDA(susceptibility_reduction)
 template<typename TSeq>
-inline void Tool<TSeq>::set_transmission_reduction(std::string param)
+inline bool Entity<TSeq>::operator==(const Entity<TSeq> & other) const
 {
 
-    auto parname_ptr = std::make_shared<const std::string>(param);
-    
-    ToolFun<TSeq> tmpfun =
-        [parname_ptr](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
-        {
-            return model->get_param(*parname_ptr);
-        };
+    if (id != other.id)
+        return false;
+
+    if (agents.size() != other.agents.size())
+        return false;
+
+    for (size_t i = 0u; i < agents.size(); ++i)
+    {
+        if (agents[i] != other.agents[i])
+            return false;
+    }
+
+
+    if (max_capacity != other.max_capacity)
+        return false;
+
+    if (entity_name != other.entity_name)
+        return false;
+
+    if (location.size() != other.location.size())
+        return false;
+
+    for (size_t i = 0u; i < location.size(); ++i)
+    {
+
+        if (location[i] != other.location[i])
+            return false;
+
+    }
+
+    if (state_init != other.state_init)
+        return false;
+
+    if (state_post != other.state_post)
+        return false;
+
+    if (queue_init != other.queue_init)
+        return false;
+
+    if (queue_post != other.queue_post)
+        return false;
 
-    transmission_reduction = tmpfun;
+    return true;
 
 }
 
-// EPIWORLD_SET_LAMBDA(transmission_reduction)
 template<typename TSeq>
-inline void Tool<TSeq>::set_recovery_enhancer(std::string param)
+inline void Entity<TSeq>::distribute(Model<TSeq> * model)
 {
 
-    auto parname_ptr = std::make_shared<const std::string>(param);
+    if (dist_fun)
+    {
 
-    ToolFun<TSeq> tmpfun =
-        [parname_ptr](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
-        {
-            return model->get_param(*parname_ptr);
-        };
+        dist_fun(*this, model);
 
-    recovery_enhancer = tmpfun;
+    }
 
 }
 
-// EPIWORLD_SET_LAMBDA(recovery_enhancer)
 template<typename TSeq>
-inline void Tool<TSeq>::set_death_reduction(std::string param)
+inline const std::vector< epiworld_agent_index > & Entity<TSeq>::get_agents() const
 {
-
-    auto parname_ptr = std::make_shared<const std::string>(param);
-
-    ToolFun<TSeq> tmpfun =
-        [parname_ptr](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
-        {
-            return model->get_param(*parname_ptr);
-        };
-
-    death_reduction = tmpfun;
-
+    return agents;
 }
 
-// EPIWORLD_SET_LAMBDA(death_reduction)
-
-// #undef EPIWORLD_SET_LAMBDA
 template<typename TSeq>
-inline void Tool<TSeq>::set_susceptibility_reduction(
-    epiworld_double prob
-)
+inline const std::vector< epiworld_agent_index > & Entity<TSeq>::get_agents_ids() const
 {
+    return agents;
+}
 
-    ToolFun<TSeq> tmpfun = 
-        [prob](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq> *)
-        {
-            return prob;
-        };
-
-    susceptibility_reduction = tmpfun;
+template<typename TSeq>
+inline void Entity<TSeq>::print() const
+{
 
+    printf_epiworld(
+        "Entity '%s' (id %i) with %i agents.\n",
+        this->entity_name.c_str(),
+        static_cast<int>(id),
+        static_cast<int>(agents.size())
+    );
 }
 
 template<typename TSeq>
-inline void Tool<TSeq>::set_transmission_reduction(
-    epiworld_double prob
-)
+inline void Entity<TSeq>::set_distribution(EntityToAgentFun<TSeq> fun)
 {
+    dist_fun = fun;
+}
 
-    ToolFun<TSeq> tmpfun = 
-        [prob](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq> *)
-        {
-            return prob;
-        };
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    transmission_reduction = tmpfun;
+ End of -./include/epiworld/entity-meat.hpp-
 
-}
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-template<typename TSeq>
-inline void Tool<TSeq>::set_recovery_enhancer(
-    epiworld_double prob
-)
-{
 
-    ToolFun<TSeq> tmpfun = 
-        [prob](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq> *)
-        {
-            return prob;
-        };
+    
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    recovery_enhancer = tmpfun;
+ Start of -./include/epiworld/agent-meat-virus-sampling.hpp-
 
-}
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-template<typename TSeq>
-inline void Tool<TSeq>::set_death_reduction(
-    epiworld_double prob
-)
+
+#ifndef EPIWORLD_AGENT_MEAT_VIRUS_SAMPLING
+#define EPIWORLD_AGENT_MEAT_VIRUS_SAMPLING
+
+/**
+ * @brief Functions for sampling viruses
+ * 
+ */
+namespace sampler {
+
+/**
+ * @brief Make a function to sample from neighbors
+ * 
+ * This is akin to the function default_update_susceptible, with the difference
+ * that it will create a function that supports excluding states from the sampling
+ * frame. For example, individuals who have acquired a virus can be excluded if
+ * in incubation state.
+ * 
+ * @tparam TSeq 
+ * @param exclude unsigned vector of states that need to be excluded from the sampling
+ * @return Virus<TSeq>* of the selected virus. If none selected (or none
+ * available,) returns a nullptr;
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline std::function<void(Agent<TSeq>*,Model<TSeq>*)> make_update_susceptible(
+    std::vector< epiworld_fast_uint > exclude = {}
+    )
 {
+  
 
-    ToolFun<TSeq> tmpfun = 
-        [prob](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq> *)
-        {
-            return prob;
-        };
+    if (exclude.size() == 0u)
+    {
 
-    death_reduction = tmpfun;
+        std::function<void(Agent<TSeq>*,Model<TSeq>*)> sampler =
+            [](Agent<TSeq> * p, Model<TSeq> * m) -> void
+            {
 
-}
+                if (p->get_virus() != nullptr)
+                    throw std::logic_error(
+                        std::string("Using the -default_update_susceptible- on agents WITH viruses makes no sense! ") +
+                        std::string("Agent id ") + std::to_string(p->get_id()) +
+                        std::string(" has a virus.")
+                        );
 
-template<typename TSeq>
-inline void Tool<TSeq>::set_name(std::string name)
-{
-    tool_name = name;
-}
+                // This computes the prob of getting any neighbor variant
+                size_t nviruses_tmp = 0u;
+                for (auto & neighbor: p->neighbors(*m)) 
+                {
+                    
+                    auto & v = neighbor.get_virus();
+                    if (v == nullptr)
+                        continue;
+                    
+                    /* And it is a function of susceptibility_reduction as well */ 
+                    m->array_double_tmp[nviruses_tmp] =
+                        (1.0 - p->get_susceptibility_reduction(v, *m)) * 
+                        v->get_prob_infecting(m) * 
+                        (1.0 - neighbor.get_transmission_reduction(v, *m)) 
+                        ; 
+                
+                    m->array_virus_tmp[nviruses_tmp++] = &(*v);
+                        
+                }
 
-template<typename TSeq>
-inline std::string Tool<TSeq>::get_name() const {
+                // No virus to compute
+                if (nviruses_tmp == 0u)
+                    return;
 
-    return tool_name;
+                // Running the roulette
+                int which = roulette(nviruses_tmp, m);
 
-}
+                if (which < 0)
+                    return;
 
-template<typename TSeq>
-inline Agent<TSeq> * Tool<TSeq>::get_agent()
-{
-    return this->agent;
-}
+                p->set_virus(*m, *m->array_virus_tmp[which]);
 
-template<typename TSeq>
-inline void Tool<TSeq>::set_agent(Agent<TSeq> * p, size_t idx)
-{
-    agent        = p;
-    pos_in_agent = static_cast<int>(idx);
-}
+                return; 
+            };
 
-template<typename TSeq>
-inline int Tool<TSeq>::get_id() const {
-    return id;
-}
+        return sampler;
 
+    } else {
 
-template<typename TSeq>
-inline void Tool<TSeq>::set_id(int id)
-{
-    this->id = id;
-}
+        // Making room for the query
+        std::shared_ptr<std::vector<bool>> exclude_agent_bool =
+            std::make_shared<std::vector<bool>>(0);
 
-template<typename TSeq>
-inline void Tool<TSeq>::set_date(int d)
-{
-    this->date = d;
-}
+        std::shared_ptr<std::vector<epiworld_fast_uint>> exclude_agent_bool_idx =
+            std::make_shared<std::vector<epiworld_fast_uint>>(exclude);
 
-template<typename TSeq>
-inline int Tool<TSeq>::get_date() const
-{
-    return date;
-}
+        std::function<void(Agent<TSeq>*,Model<TSeq>*)> sampler =
+            [exclude_agent_bool,exclude_agent_bool_idx](Agent<TSeq> * p, Model<TSeq> * m) -> void
+            {
 
-template<typename TSeq>
-inline void Tool<TSeq>::set_state(
-    epiworld_fast_int init,
-    epiworld_fast_int end
-)
-{
-    state_init = init;
-    state_post = end;
-}
+                // The first time we call it, we need to initialize the vector
+                if (exclude_agent_bool->size() == 0u)
+                {
 
-template<typename TSeq>
-inline void Tool<TSeq>::set_queue(
-    epiworld_fast_int init,
-    epiworld_fast_int end
-)
-{
-    queue_init = init;
-    queue_post = end;
-}
+                    exclude_agent_bool->resize(m->get_states().size(), false);
+                    for (auto s : *exclude_agent_bool_idx)
+                    {
+                        if (s >= exclude_agent_bool->size())
+                            throw std::logic_error(
+                                std::string("You are trying to exclude a state that is out of range: ") +
+                                std::to_string(s) + std::string(". There are only ") +
+                                std::to_string(exclude_agent_bool->size()) + 
+                                std::string(" states in the model.")
+                                );
 
-template<typename TSeq>
-inline void Tool<TSeq>::get_state(
-    epiworld_fast_int * init,
-    epiworld_fast_int * post
-)
-{
-    if (init != nullptr)
-        *init = state_init;
+                        exclude_agent_bool->operator[](s) = true;
 
-    if (post != nullptr)
-        *post = state_post;
+                    }
 
-}
+                }                    
 
-template<typename TSeq>
-inline void Tool<TSeq>::get_queue(
-    epiworld_fast_int * init,
-    epiworld_fast_int * post
-)
-{
-    if (init != nullptr)
-        *init = queue_init;
+                if (p->get_virus() != nullptr)
+                    throw std::logic_error(
+                        std::string("Using the -default_update_susceptible- on agents WITH viruses makes no sense! ") +
+                        std::string("Agent id ") + std::to_string(p->get_id()) +
+                        std::string(" has a virus.")
+                        );
 
-    if (post != nullptr)
-        *post = queue_post;
+                // This computes the prob of getting any neighbor variant
+                size_t nviruses_tmp = 0u;
+                for (auto & neighbor: p->neighbors(*m)) 
+                {
 
-}
+                    // If the state is in the list, exclude it
+                    if (exclude_agent_bool->operator[](neighbor.get_state()))
+                        continue;
 
-template<>
-inline bool Tool<std::vector<int>>::operator==(
-    const Tool<std::vector<int>> & other
-    ) const
-{
-    
-    if (sequence->size() != other.sequence->size())
-        return false;
+                    auto & v = neighbor.get_virus();
+                    if (v == nullptr)
+                        continue;
+                            
+                
+                    /* And it is a function of susceptibility_reduction as well */ 
+                    m->array_double_tmp[nviruses_tmp] =
+                        (1.0 - p->get_susceptibility_reduction(v, *m)) * 
+                        v->get_prob_infecting(m) * 
+                        (1.0 - neighbor.get_transmission_reduction(v, *m)) 
+                        ; 
+                
+                    m->array_virus_tmp[nviruses_tmp++] = &(*v);
+                    
+                }
 
-    for (size_t i = 0u; i < sequence->size(); ++i)
-    {
-        if (sequence->operator[](i) != other.sequence->operator[](i))
-            return false;
-    }
+                // No virus to compute
+                if (nviruses_tmp == 0u)
+                    return;
 
-    if (tool_name != other.tool_name)
-        return false;
-    
-    if (state_init != other.state_init)
-        return false;
+                // Running the roulette
+                int which = roulette(nviruses_tmp, m);
 
-    if (state_post != other.state_post)
-        return false;
+                if (which < 0)
+                    return;
 
-    if (queue_init != other.queue_init)
-        return false;
+                p->set_virus(*m, *m->array_virus_tmp[which]); 
 
-    if (queue_post != other.queue_post)
-        return false;
+                return;
 
+            };
 
-    return true;
+        return sampler;
 
+    }
+    
 }
 
-template<typename TSeq>
-inline bool Tool<TSeq>::operator==(const Tool<TSeq> & other) const
+/**
+ * @brief Make a function to sample from neighbors
+ * 
+ * This is akin to the function default_update_susceptible, with the difference
+ * that it will create a function that supports excluding states from the sampling
+ * frame. For example, individuals who have acquired a virus can be excluded if
+ * in incubation state.
+ * 
+ * @tparam TSeq 
+ * @param exclude unsigned vector of states that need to be excluded from the sampling
+ * @return Virus<TSeq>* of the selected virus. If none selected (or none
+ * available,) returns a nullptr;
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline std::function<Virus<TSeq>*(Agent<TSeq>*,Model<TSeq>*)> make_sample_virus_neighbors(
+    std::vector< epiworld_fast_uint > exclude = {}
+)
 {
-    EPI_IF_TSEQ_LESS_EQ_INT( TSeq )
-    {
-        if (sequence != other.sequence)
-            return false;
-    }
-    else
+    if (exclude.size() == 0u)
     {
-        if (*sequence != *other.sequence)
-            return false;
-    }
-
-
-    if (tool_name != other.tool_name)
-        return false;
-    
-    if (state_init != other.state_init)
-        return false;
-
-    if (state_post != other.state_post)
-        return false;
-
-    if (queue_init != other.queue_init)
-        return false;
 
-    if (queue_post != other.queue_post)
-        return false;
+        std::function<Virus<TSeq>*(Agent<TSeq>*,Model<TSeq>*)> res = 
+            [](Agent<TSeq> * p, Model<TSeq> * m) -> Virus<TSeq>* {
 
-    return true;
+                if (p->get_virus() != nullptr)
+                    throw std::logic_error(
+                        std::string("Using the -default_update_susceptible- on agents WITH viruses makes no sense! ") +
+                        std::string("Agent id ") + std::to_string(p->get_id()) +
+                        std::string(" has a virus.")
+                        );
 
-}
+                // This computes the prob of getting any neighbor variant
+                size_t nviruses_tmp = 0u;
+                for (auto & neighbor: p->neighbors(*m)) 
+                {
+                    
+                    if (neighbor.get_virus() == nullptr)
+                        continue;
 
+                    auto & v = neighbor.get_virus();
 
-template<typename TSeq>
-inline void Tool<TSeq>::print() const
-{
+                    #ifdef EPI_DEBUG
+                    if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+                        throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
+                    #endif
+                        
+                    /* And it is a function of susceptibility_reduction as well */ 
+                    m->array_double_tmp[nviruses_tmp] =
+                        (1.0 - p->get_susceptibility_reduction(v, *m)) * 
+                        v->get_prob_infecting(m) * 
+                        (1.0 - neighbor.get_transmission_reduction(v, *m)) 
+                        ; 
+                
+                    m->array_virus_tmp[nviruses_tmp++] = &(*v);
+                    
+                }
 
-    printf_epiworld("Tool       : %s\n", this->get_name().c_str());
-    printf_epiworld("Id         : %s\n", (id < 0)? std::string("(empty)").c_str() : std::to_string(id).c_str());
-    printf_epiworld("state_init : %i\n", static_cast<int>(state_init));
-    printf_epiworld("state_post : %i\n", static_cast<int>(state_post));
-    printf_epiworld("queue_init : %i\n", static_cast<int>(queue_init));
-    printf_epiworld("queue_post : %i\n", static_cast<int>(queue_post));
+                // No virus to compute
+                if (nviruses_tmp == 0u)
+                    return nullptr;
 
-}
+                // Running the roulette
+                int which = roulette(nviruses_tmp, m);
 
-template<typename TSeq>
-inline void Tool<TSeq>::distribute(Model<TSeq> * model)
-{
+                if (which < 0)
+                    return nullptr;
 
-    if (dist)
-    {
+                return m->array_virus_tmp[which]; 
 
-        dist(*this, model);
+            };
 
-    }
+        return res;
 
-}
 
-template<typename TSeq>
-inline void Tool<TSeq>::set_distribution(ToolToAgentFun<TSeq> fun)
-{
-    dist = fun;
-}
+    } else {
 
-template<typename TSeq>
-inline std::unique_ptr<Tool<TSeq>> Tool<TSeq>::clone_ptr() const
-{
-    auto cloned = std::make_unique<Tool<TSeq>>(*this);
-    return cloned;
-}
+        // Making room for the query
+        std::shared_ptr<std::vector<bool>> exclude_agent_bool =
+            std::make_shared<std::vector<bool>>(0);
 
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+        std::shared_ptr<std::vector<epiworld_fast_uint>> exclude_agent_bool_idx =
+            std::make_shared<std::vector<epiworld_fast_uint>>(exclude);
 
- End of -./include/epiworld/tool-meat.hpp-
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+        std::function<Virus<TSeq>*(Agent<TSeq>*,Model<TSeq>*)> res = 
+            [exclude_agent_bool,exclude_agent_bool_idx](Agent<TSeq> * p, Model<TSeq> * m) -> Virus<TSeq>* {
 
+                // The first time we call it, we need to initialize the vector
+                if (exclude_agent_bool->size() == 0u)
+                {
 
+                    exclude_agent_bool->resize(m->get_states().size(), false);
+                    for (auto s : *exclude_agent_bool_idx)
+                    {
+                        if (s >= exclude_agent_bool->size())
+                            throw std::logic_error(
+                                std::string("You are trying to exclude a state that is out of range: ") +
+                                std::to_string(s) + std::string(". There are only ") +
+                                std::to_string(exclude_agent_bool->size()) + 
+                                std::string(" states in the model.")
+                                );
 
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+                        exclude_agent_bool->operator[](s) = true;
 
- Start of -./include/epiworld/entity-bones.hpp-
+                    }
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+                }    
+                
+                if (p->get_virus() != nullptr)
+                    throw std::logic_error(
+                        std::string("Using the -default_update_susceptible- on agents WITH viruses makes no sense! ") +
+                        std::string("Agent id ") + std::to_string(p->get_id()) +
+                        std::string(" has a virus.")
+                        );
 
+                // This computes the prob of getting any neighbor variant
+                size_t nviruses_tmp = 0u;
+                for (auto & neighbor: p->neighbors(*m)) 
+                {
 
-#ifndef EPIWORLD_ENTITY_BONES_HPP
-#define EPIWORLD_ENTITY_BONES_HPP
+                    // If the state is in the list, exclude it
+                    if (exclude_agent_bool->operator[](neighbor.get_state()))
+                        continue;
 
-template<typename TSeq>
-class Model;
+                    if (neighbor.get_virus() == nullptr)
+                        continue;
 
-template<typename TSeq>
-class Agent;
+                    auto & v = neighbor.get_virus();
+                            
+                    #ifdef EPI_DEBUG
+                    if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+                        throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
+                    #endif
+                        
+                    /* And it is a function of susceptibility_reduction as well */ 
+                    m->array_double_tmp[nviruses_tmp] =
+                        (1.0 - p->get_susceptibility_reduction(v, *m)) * 
+                        v->get_prob_infecting(m) * 
+                        (1.0 - neighbor.get_transmission_reduction(v, *m)) 
+                        ; 
+                
+                    m->array_virus_tmp[nviruses_tmp++] = &(*v);
+                    
+                }
 
-template<typename TSeq>
-class AgentsSample;
+                // No virus to compute
+                if (nviruses_tmp == 0u)
+                    return nullptr;
 
-/**
- * @brief Groups of agents within a model.
- */
-template<typename TSeq>
-class Entity {
-    friend class Agent<TSeq>;
-    friend class AgentsSample<TSeq>;
-    friend class Model<TSeq>;
-private:
-    
-    int id = -1;
-    std::vector< size_t > agents;   ///< Agent IDs (indices into Model::population)
+                // Running the roulette
+                int which = roulette(nviruses_tmp, m);
 
-    int max_capacity = -1;
-    std::string entity_name = "Unnamed entity";
+                if (which < 0)
+                    return nullptr;
 
-    std::vector< epiworld_double > location = {0.0}; ///< An arbitrary vector for location
+                return m->array_virus_tmp[which]; 
 
-    epiworld_fast_int state_init = -99;
-    epiworld_fast_int state_post = -99;
+            };
 
-    epiworld_fast_int queue_init = 0; ///< Change of state when added to agent.
-    epiworld_fast_int queue_post = 0; ///< Change of state when removed from agent.
+        return res;
 
-    EntityToAgentFun<TSeq> dist_fun = nullptr;
+    }
 
-    void reset();
+}
 
-public:
+/**
+ * @brief Sample from neighbors pool of viruses (at most one)
+ * 
+ * This function samples at most one virus from the pool of
+ * viruses from its neighbors. If no virus is selected, the function
+ * returns a `nullptr`, otherwise it returns a pointer to the
+ * selected virus.
+ * 
+ * This can be used to build a new update function (EPI_NEW_UPDATEFUN.)
+ * 
+ * @tparam TSeq 
+ * @param p Pointer to person 
+ * @param m Pointer to the model
+ * @return Virus<TSeq>* of the selected virus. If none selected (or none
+ * available,) returns a nullptr;
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline Virus<TSeq> * sample_virus_single(Agent<TSeq> * p, Model<TSeq> * m)
+{
 
+    if (p->get_virus() != nullptr)
+        throw std::logic_error(
+            std::string("Using the -default_update_susceptible- on agents WITH viruses makes no sense!") +
+            std::string("Agent id ") + std::to_string(p->get_id()) +
+            std::string(" has a virus.")
+            );
 
-    /**
-     * @brief Constructs an Entity object.
-     *
-     * This constructor initializes an Entity object with the specified parameters.
-     *
-     * @param name The name of the entity.
-     * @param fun A function pointer to a function that maps the entity to an agent.
-     */
-    Entity(
-        std::string name,
-        EntityToAgentFun<TSeq> fun = nullptr
-        ) :
-            entity_name(name),
-            dist_fun(fun)
-        {};
+    // This computes the prob of getting any neighbor variant
+    size_t nviruses_tmp = 0u;
+    for (auto & neighbor: p->neighbors(*m)) 
+    {   
+        #ifdef EPI_DEBUG
+        int _vcount_neigh = 0;
+        #endif                
 
-    ~Entity() = default;
-    
-    void add_agent(Agent<TSeq> & p, Model<TSeq> & model);
-    void add_agent(Agent<TSeq> * p, Model<TSeq> & model);
-    void rm_agent(size_t idx, Model<TSeq> & model);
-    size_t size() const noexcept;
-    void set_location(std::vector< epiworld_double > loc);
-    std::vector< epiworld_double > & get_location();
+        if (neighbor.get_virus() == nullptr)
+            continue;
 
-    typename std::vector< size_t >::iterator begin();
-    typename std::vector< size_t >::iterator end();
+        auto & v = neighbor.get_virus();
 
-    typename std::vector< size_t >::const_iterator begin() const;
-    typename std::vector< size_t >::const_iterator end() const;
+        #ifdef EPI_DEBUG
+        if (nviruses_tmp >= m->array_virus_tmp.size())
+            throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
+        #endif
+            
+        /* And it is a function of susceptibility_reduction as well */ 
+        m->array_double_tmp[nviruses_tmp] =
+            (1.0 - p->get_susceptibility_reduction(v, *m)) * 
+            v->get_prob_infecting(m) * 
+            (1.0 - neighbor.get_transmission_reduction(v, *m)) 
+            ; 
+    
+        m->array_virus_tmp[nviruses_tmp++] = &(*v);
 
-    size_t operator[](size_t i);
+        #ifdef EPI_DEBUG
+        if (
+            (m->array_double_tmp[nviruses_tmp - 1] < 0.0) |
+            (m->array_double_tmp[nviruses_tmp - 1] > 1.0)
+            )
+        {
+            printf_epiworld(
+                "[epi-debug] Agent %i's virus %i has transmission prob outside of [0, 1]: %.4f!\n",
+                static_cast<int>(neighbor.get_id()),
+                static_cast<int>(_vcount_neigh++),
+                m->array_double_tmp[nviruses_tmp - 1]
+                );
+        }
+        #endif
+            
+    }
 
-    int get_id() const noexcept;
-    const std::string & get_name() const noexcept;
 
-    void set_state(epiworld_fast_int init, epiworld_fast_int post);
-    void set_queue(epiworld_fast_int init, epiworld_fast_int post);
-    void get_state(epiworld_fast_int * init, epiworld_fast_int * post);
-    void get_queue(epiworld_fast_int * init, epiworld_fast_int * post);
+    // No virus to compute
+    if (nviruses_tmp == 0u)
+        return nullptr;
 
-    bool operator==(const Entity<TSeq> & other) const;
-    bool operator!=(const Entity<TSeq> & other) const {return !operator==(other);};
+    #ifdef EPI_DEBUG
+    #pragma omp atomic
+    m->get_db().n_transmissions_potential++;
+    #endif
 
-    /** 
-     * @name Entity distribution
-     * 
-     * @details These functions are used for distributing agents among entities.
-     * The idea is to have a flexible way of distributing agents among entities.
-     
-     */
-    void distribute(Model<TSeq> * model);
+    // Running the roulette
+    int which = roulette(nviruses_tmp, m);
 
-    const std::vector< size_t > & get_agents() const;
-    const std::vector< size_t > & get_agents_ids() const;
+    if (which < 0)
+        return nullptr;
 
-    void print() const;
-    void set_distribution(EntityToAgentFun<TSeq> fun);
+    #ifdef EPI_DEBUG
+    #pragma omp atomic
+    m->get_db().n_transmissions_today++;
+    #endif
 
-};
+    return m->array_virus_tmp[which]; 
+    
+}
 
+}
 
 #endif
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- End of -./include/epiworld/entity-bones.hpp-
+ End of -./include/epiworld/agent-meat-virus-sampling.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
@@ -16137,2845 +20404,3385 @@ public:
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- Start of -./include/epiworld/entity-distribute-meat.hpp-
+ Start of -./include/epiworld/agent-meat-state.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
-#ifndef EPIWORLD_ENTITY_DISTRIBUTE_MEAT_HPP
-#define EPIWORLD_ENTITY_DISTRIBUTE_MEAT_HPP
+#ifndef EPIWORLD_PERSON_MEAT_STATE_HPP
+#define EPIWORLD_PERSON_MEAT_STATE_HPP
 
+// (already included include/epiworld/model-bones.hpp)
+// (already included include/epiworld/agent-meat-virus-sampling.hpp)
+// (already included include/epiworld/config.hpp)
 
-template <typename TSeq = EPI_DEFAULT_TSEQ>
 /**
- * Distributes an entity to unassigned agents in the model.
+ * @file agent-meat-state.hpp
+ * @author George G. Vega Yon (g.vegayon en gmail)
+ * @brief Sampling functions are getting big, so we keep them in a separate file.
+ * @version 0.1
+ * @date 2022-06-15
+ * 
+ * @copyright Copyright (c) 2022
  * 
- * @param prevalence The proportion of agents to distribute the entity to.
- * @param as_proportion Flag indicating whether the prevalence is a proportion
- * @param to_unassigned Flag indicating whether to distribute the entity only
- * to unassigned agents.
- * @return An EntityToAgentFun object that distributes the entity to unassigned
- * agents.
  */
-inline EntityToAgentFun<TSeq> distribute_entity_randomly(
-    epiworld_double prevalence,
-    bool as_proportion,
-    bool to_unassigned
-)
+
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline void default_update_susceptible(
+    Agent<TSeq> * p,
+    Model<TSeq> * m
+    )
 {
 
-    return [prevalence, as_proportion, to_unassigned](
-        Entity<TSeq> & e, Model<TSeq> * m
-        ) -> void {
+    Virus<TSeq> * virus = sampler::sample_virus_single<TSeq>(p, m);
+    
+    if (virus == nullptr)
+        return;
 
-        
-        // Preparing the sampling space
-        std::vector< size_t > idx;
-        if (to_unassigned)
-        {
-            for (const auto & a: m->get_agents())
-                if (a.get_n_entities() == 0)
-                    idx.push_back(a.get_id());
-        } 
-        else
-        {
+    p->set_virus(*m, *virus);
 
-            for (const auto & a: m->get_agents())
-                idx.push_back(a.get_id());
+    return;
+
+}
+
+/**
+ * @brief Factory function to create a state update function based on
+ * transition rates.
+ *
+ * @details
+ * This function creates an `UpdateFun` that transitions agents between
+ * states using named model parameters as per-step transition probabilities.
+ * At each time step the generated function reads the current values of the
+ * parameters from the model and uses the roulette sampling algorithm to
+ * decide whether a transition occurs (and if so, to which target state).
+ *
+ * The parameter names must correspond to parameters that have already been
+ * added to the model (via `Model::add_param()`). The target states are
+ * specified as integer state codes (the indices returned by
+ * `Model::add_state()`).
+ *
+ * @tparam TSeq Type of the sequence (default `EPI_DEFAULT_TSEQ`).
+ * @param param_names  Names of the model parameters that hold the
+ *                     transition rates. The i-th name gives the rate for
+ *                     transitioning to the i-th target state.
+ * @param target_states Integer codes of the destination states, in the
+ *                      same order as `param_names`.
+ * @return An `UpdateFun<TSeq>` suitable for use with
+ *         `Model::add_state()`.
+ *
+ * @throws std::logic_error if `param_names` and `target_states` differ in
+ *         size, or if either is empty.
+ *
+ * ### Example: SEIRD model
+ *
+ * @code{.cpp}
+ * // E -> I transition
+ * auto update_exposed = new_state_update_transition<int>(
+ *     {"E->I transition rate"},
+ *     {2}  // state code for Infected
+ * );
+ *
+ * // I -> R or I -> D transitions
+ * auto update_infected = new_state_update_transition<int>(
+ *     {"I->R transition rate", "I->D transition rate"},
+ *     {3, 4}  // state codes for Recovered and Deceased
+ * );
+ *
+ * model.add_state("Susceptible", default_update_susceptible<int>);
+ * model.add_state("Exposed",     update_exposed);
+ * model.add_state("Infected",    update_infected);
+ * model.add_state("Recovered");
+ * model.add_state("Deceased");
+ * @endcode
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+inline UpdateFun<TSeq> new_state_update_transition(
+    std::vector< std::string > param_names,
+    std::vector< epiworld_fast_uint > target_states
+)
+{
 
-        }
-        
-        size_t n = idx.size();
+    if (param_names.size() != target_states.size())
+        throw std::logic_error(
+            "The number of parameter names (" +
+            std::to_string(param_names.size()) +
+            ") and target states (" +
+            std::to_string(target_states.size()) +
+            ") must match."
+        );
 
-        // Figuring out how many to sample
-        int n_to_sample;
-        if (as_proportion)
-        {
-            n_to_sample = static_cast<int>(std::floor(prevalence * n));
+    if (param_names.empty())
+        throw std::logic_error(
+            "At least one transition must be specified."
+        );
 
-            // Correcting for possible overflow
-            if (n_to_sample > static_cast<int>(n))
-                n_to_sample = static_cast<int>(n);
+    return [param_names, target_states](
+        Agent<TSeq> * p,
+        Model<TSeq> * m
+    ) -> void {
 
-        } else
-        {
-            n_to_sample = static_cast<int>(prevalence);
-            if (n_to_sample > static_cast<int>(n))
-                throw std::range_error("There are only " + std::to_string(n) + 
-                " individuals in the population. Cannot add the entity to " +
-                    std::to_string(n_to_sample));
-        }
+        size_t n = param_names.size();
+        int which;
 
-        int n_left = n;
-        for (int i = 0; i < n_to_sample; ++i)
+        if (n <= 1024u)
         {
-            int loc = m->runif_index(n_left--);
+            for (size_t i = 0u; i < n; ++i)
+                m->array_double_tmp[i] = m->par(param_names[i]);
 
-            // Correcting for possible overflow
-            if ((n_left > 0) && (loc > n_left))
-                loc = n_left - 1;
+            // Roulette sampling: returns -1 if no transition occurs,
+            // otherwise the index of the transition that fires.
+            which = roulette(static_cast<epiworld_fast_uint>(n), m);
+        }
+        else
+        {
+            std::vector< epiworld_double > probs(n);
+            for (size_t i = 0u; i < n; ++i)
+                probs[i] = m->par(param_names[i]);
 
-            m->get_agent(idx[loc]).add_entity(*m, e);
+            // Fallback for transition tables larger than the temporary buffer.
+            which = roulette(probs, m);
+        }
+        if (which < 0)
+            return;
 
-            std::swap(idx[loc], idx[n_left]);
+        p->change_state(*m, target_states[which]);
 
-        }
+        return;
 
     };
 
 }
 
 template<typename TSeq = EPI_DEFAULT_TSEQ>
-/**
- * Distributes an entity to a range of agents.
- *
- * @param from The starting index of the range.
- * @param to The ending index of the range.
- * @param to_unassigned Flag indicating whether to distribute the entity only
- * to unassigned agents.
- * @return A lambda function that distributes the entity to the specified range
- * of agents.
- */
-inline EntityToAgentFun<TSeq> distribute_entity_to_range(
-    int from,
-    int to,
-    bool to_unassigned = false
-    ) {
-
-    if (to_unassigned)
-    {
+inline void default_update_exposed(Agent<TSeq> * p, Model<TSeq> * m) {
 
-        return [from, to](Entity<TSeq> & e, Model<TSeq> * m) -> void {
+    if (p->get_virus() == nullptr)
+        throw std::logic_error(
+            std::string("Using the -default_update_exposed- on agents WITHOUT viruses makes no sense! ") +
+            std::string("Agent id ") + std::to_string(p->get_id()) + std::string(" has no virus registered.")
+            );
 
-            auto & agents = m->get_agents();
-            for (int i = from; i < to; ++i)
-            {
-                if (agents[i].get_n_entities() == 0)
-                    e.add_agent(&agents[i], *m);
-                else
-                    throw std::logic_error(
-                        "Agent " + std::to_string(i) + " already has an entity."
-                    );
-            }
-            
-            return;
+    // Die
+    auto & virus = p->get_virus();
+    m->array_double_tmp[0u] = 
+        virus->get_prob_death(m) * (1.0 - p->get_death_reduction(virus, *m));
 
-        };
+    // Recover
+    m->array_double_tmp[1u] =
+        1.0 - (1.0 - virus->get_prob_recovery(m)) * (1.0 - p->get_recovery_enhancer(virus, *m)); 
+    
 
-    }
-    else
-    {
+    // Running the roulette
+    int which = roulette(2u, m);
 
-        return [from, to](Entity<TSeq> & e, Model<TSeq> * m) -> void {
+    if (which < 0)
+        return;
 
-            auto & agents = m->get_agents();
-            for (int i = from; i < to; ++i)
-            {
-                e.add_agent(&agents[i], *m);
-            }
+    // Which roulette happen?
+    if (which == 0u) // If odd
+    {
 
-            return;
+        int rm_state = -1;
+        p->get_virus()->get_state(nullptr, nullptr, &rm_state);
+        p->rm_virus(*m, rm_state);
+        
+    } else {
 
-        };
+        p->rm_virus(*m);
 
     }
-}
 
+    return ;
 
-template<typename TSeq = EPI_DEFAULT_TSEQ>
-inline EntityToAgentFun<TSeq> distribute_entity_to_set(
-    std::vector< size_t > & idx
-    ) {
-
-    auto idx_shared = std::make_shared< std::vector< size_t > >(idx);
+};
 
-    return [idx_shared](Entity<TSeq> & e, Model<TSeq> * m) -> void {
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-        for (const auto & i: *idx_shared)
-        {
-            e.add_agent(&m->get_agent(i), *m);
-        }
+ End of -./include/epiworld/agent-meat-state.hpp-
 
-    };
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-}
 
-#endif
+// (already included ./include/epiworld/agent-bones.hpp)
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- End of -./include/epiworld/entity-distribute-meat.hpp-
+ Start of -./include/epiworld/agent-meat.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
+#ifndef EPIWORLD_PERSON_MEAT_HPP
+#define EPIWORLD_PERSON_MEAT_HPP
+
+#include <vector>
+#include <string>
+#include <typeinfo>
+// (already included include/epiworld/config.hpp)
+// (already included include/epiworld/epiworld-macros.hpp)
+// (already included include/epiworld/agent-bones.hpp)
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- Start of -./include/epiworld/entity-meat.hpp-
+ Start of -include/epiworld/agent-events-meat.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
 
 
-#ifndef EPIWORLD_ENTITY_MEAT_HPP
-#define EPIWORLD_ENTITY_MEAT_HPP
+#ifndef EPIWORLD_AGENT_EVENTS_MEAT_HPP
+#define EPIWORLD_AGENT_EVENTS_MEAT_HPP
+
+template<typename TSeq>
+inline void Model<TSeq>::_event_add_virus(Event<TSeq> & a)
+{
+
+    Agent<TSeq> *  p = a.agent;
+    VirusPtr<TSeq> & v = a.virus;
+    
+    db.record_transmission(
+        v->get_agent() ? v->get_agent()->get_id() : -1,
+        p->get_id(),
+        v->get_id(),
+        v->get_date() 
+    );
+    
+    p->virus = std::move(v);
+    p->virus->set_date(today());
+    p->virus->set_agent(p);
+
+    // Change of state needs to be recorded and updated on the
+    // tools.
+    if ((a.new_state != -99) && (static_cast<int>(p->state) != a.new_state))
+    {
+        db.update_state(p->state_prev, a.new_state);
+
+        // For tool counts, use current state (p->state) not state_prev
+        // because state_prev may be stale if multiple changes occurred today
+        for (size_t i = 0u; i < p->tools.size(); ++i)
+            db.update_tool(
+                p->tools[i]->get_id(),
+                p->state,
+                a.new_state
+            );
+    }
+
+    // Lastly, we increase the daily count of the virus
+    #ifdef EPI_DEBUG
+    db.today_virus.at(p->virus->get_id()).at(
+        a.new_state != -99 ? a.new_state : p->state
+    )++;
+    #else
+    db.today_virus[p->virus->get_id()][
+        a.new_state != -99 ? a.new_state : p->state
+    ]++;
+    #endif
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::_event_add_tool(Event<TSeq> & a)
+{
+
+    Agent<TSeq> * p = a.agent;
+    ToolPtr<TSeq> & t = a.tool;
+    
+    // Update tool accounting
+    p->tools.emplace_back(std::move(t));
+    size_t tool_pos = p->tools.size() - 1u;
+
+    p->tools[tool_pos]->set_date(today());
+    p->tools[tool_pos]->set_agent(p, tool_pos);
+    p->tools_effects_update();
+
+    // Change of state needs to be recorded and updated on the
+    // tools.
+    if ((a.new_state != -99) && static_cast<int>(p->state) != a.new_state)
+    {
+        db.update_state(p->state_prev, a.new_state);
+
+        // For virus counts, use current state (p->state) not state_prev
+        // because state_prev may be stale if multiple changes occurred today
+        if (p->virus)
+            db.update_virus(
+                p->virus->get_id(),
+                p->state,
+                a.new_state
+            );
+    }
+
+    db.today_tool[p->tools[tool_pos]->get_id()][
+        a.new_state != -99 ? a.new_state : p->state
+    ]++;
+
+
+}
 
 template<typename TSeq>
-inline void Entity<TSeq>::add_agent(
-    Agent<TSeq> & p,
-    Model<TSeq> & model
-    )
+inline void Model<TSeq>::_event_rm_virus(Event<TSeq> & a)
 {
 
-    // Need to add it to the events, through the individual
-    p.add_entity(model, *this);
+    Agent<TSeq> * p    = a.agent;
+    VirusPtr<TSeq> & v = a.virus;
 
-}
+    // Calling the virus action over the removed virus
+    v->post_recovery(this);
 
-template<typename TSeq>
-inline void Entity<TSeq>::add_agent(
-    Agent<TSeq> * p,
-    Model<TSeq> & model
-    )
-{
-    p->add_entity(model, *this);
-}
+    p->virus = nullptr;
 
-template<typename TSeq>
-inline void Entity<TSeq>::rm_agent(size_t idx, Model<TSeq> & model)
-{
-    if (idx >= size())
-        throw std::out_of_range(
-            "Trying to remove agent "+ std::to_string(idx) +
-            " out of " + std::to_string(size())
+    // Change of state needs to be recorded and updated on the
+    // tools.
+    if ((a.new_state != -99) && (static_cast<int>(p->state) != a.new_state))
+    {
+        db.update_state(p->state_prev, a.new_state);
+
+        // For tool counts, use current state (p->state) not state_prev
+        // because state_prev may be stale if multiple changes occurred today
+        for (size_t i = 0u; i < p->tools.size(); ++i)
+            db.update_tool(
+                p->tools[i]->get_id(),
+                p->state,
+                a.new_state
             );
+    }
 
-    model.population[agents[idx]].rm_entity(model, *this);
+    // The counter of the removed virus must be decremented from the
+    // agent's current state (pre-transition), not state_prev.
+    // state_prev may refer to an earlier same-day state.
+    #ifdef EPI_DEBUG
+    db.today_virus.at(v->get_id()).at(p->state)--;
+    #else
+    db.today_virus[v->get_id()][p->state]--;
+    #endif
 
+    
     return;
-}
 
-template<typename TSeq>
-inline size_t Entity<TSeq>::size() const noexcept
-{
-    return agents.size();
 }
 
 template<typename TSeq>
-inline void Entity<TSeq>::set_location(std::vector< epiworld_double > loc)
+inline void Model<TSeq>::_event_rm_tool(Event<TSeq> & a)
 {
-    location = loc;
-}
 
-template<typename TSeq>
-inline std::vector< epiworld_double > & Entity<TSeq>::get_location()
-{
-    return location;
-}
+    Agent<TSeq> * p = a.agent;
+    ToolPtr<TSeq> & t = a.tool;
+    bool removed = false;
 
-template<typename TSeq>
-inline typename std::vector< size_t >::iterator Entity<TSeq>::begin()
-{
+    if (t)
+    {
+        // Remove tool(s) by id, following an erase/remove approach.
+        auto new_end = std::remove_if(
+            p->tools.begin(),
+            p->tools.end(),
+            [&t](const ToolPtr<TSeq> & tool_ptr) -> bool
+            {
+                return tool_ptr && (tool_ptr->get_id() == t->get_id());
+            }
+        );
 
-    return agents.begin();
+        removed = (new_end != p->tools.end());
+        p->tools.erase(new_end, p->tools.end());
 
-}
+        for (size_t i = 0u; i < p->tools.size(); ++i)
+            p->tools[i]->pos_in_agent = static_cast<int>(i);
 
-template<typename TSeq>
-inline typename std::vector< size_t >::iterator Entity<TSeq>::end()
-{
-    return agents.end();
-}
+        p->tools_effects_update();
+    }
 
-template<typename TSeq>
-inline typename std::vector< size_t >::const_iterator Entity<TSeq>::begin() const
-{
+    // Change of state needs to be recorded and updated on the
+    // tools.
+    if ((a.new_state != -99) && (static_cast<int>(p->state) != a.new_state))
+    {
+        db.update_state(p->state_prev, a.new_state);
 
-    return agents.begin();
+        // For virus counts, use current state (p->state) not state_prev
+        // because state_prev may be stale if multiple changes occurred today
+        if (p->virus)
+            db.update_virus(
+                p->virus->get_id(),
+                p->state,
+                a.new_state
+            );
+    }
 
-}
+    // Like rm_virus, remove the tool count from the agent's current
+    // state (pre-transition). Using state_prev can underflow when
+    // the agent changed state earlier in the day.
+    if (removed)
+    {
+        #ifdef EPI_DEBUG
+        db.today_tool.at(t->get_id()).at(p->state)--;
+        #else
+        db.today_tool[t->get_id()][p->state]--;
+        #endif
+
+        t->agent = nullptr;
+        t->pos_in_agent = -99;
+    }
+
+    return;
 
-template<typename TSeq>
-inline typename std::vector< size_t >::const_iterator Entity<TSeq>::end() const
-{
-    return agents.end();
 }
 
 template<typename TSeq>
-size_t Entity<TSeq>::operator[](size_t i)
+inline void Model<TSeq>::_event_change_state(Event<TSeq> & a)
 {
-    if (agents.size() <= i)
-        throw std::logic_error(
-            "There are not that many agents in this entity. " +
-            std::to_string(agents.size()) + " <= " + std::to_string(i)
+
+    Agent<TSeq> * p = a.agent;
+
+    if ((a.new_state != -99) && (static_cast<int>(p->state) != a.new_state))
+    {
+        db.update_state(p->state_prev, a.new_state);
+
+        // For virus and tool counts, use current state (p->state) not state_prev
+        // because state_prev may be stale if multiple changes occurred today
+        if (p->virus)
+            db.update_virus(
+                p->virus->get_id(), p->state, a.new_state
             );
 
-    return agents[i];
-}
+        for (size_t i = 0u; i < p->tools.size(); ++i)
+            db.update_tool(
+                p->tools[i]->get_id(),
+                p->state,
+                a.new_state
+            );
 
-template<typename TSeq>
-inline int Entity<TSeq>::get_id() const noexcept
-{
-    return id;
-}
+    }
 
-template<typename TSeq>
-inline const std::string & Entity<TSeq>::get_name() const noexcept
-{
-    return entity_name;
 }
 
 template<typename TSeq>
-inline void Entity<TSeq>::set_state(
-    epiworld_fast_int init,
-    epiworld_fast_int end
-)
+inline void Model<TSeq>::_event_add_entity(Event<TSeq> & a)
 {
-    state_init = init;
-    state_post = end;
-}
 
-template<typename TSeq>
-inline void Entity<TSeq>::set_queue(
-    epiworld_fast_int init,
-    epiworld_fast_int end
-)
-{
-    queue_init = init;
-    queue_post = end;
-}
+    Agent<TSeq> *  p = a.agent;
+    Entity<TSeq> * e = a.entity;
 
-template<typename TSeq>
-inline void Entity<TSeq>::get_state(
-    epiworld_fast_int * init,
-    epiworld_fast_int * post
-)
-{
-    if (init != nullptr)
-        *init = state_init;
+    // Checking the agent and the entity are not linked
+    if ((p->get_n_entities() > 0) && (e->size() > 0))
+    {
 
-    if (post != nullptr)
-        *post = state_post;
+        if (p->get_n_entities() > e->size()) // Slower search through the agent
+        {
+            for (size_t agent_id : e->get_agents())
+                if(static_cast<int>(agent_id) == p->get_id())
+                    throw std::logic_error("An entity cannot be reassigned to an agent.");
+        }
+        else                                 // Slower search through the entity
+        {
+            for (size_t entity_id : p->get_entities())
+                if(static_cast<int>(entity_id) == e->get_id())
+                    throw std::logic_error("An entity cannot be reassigned to an agent.");
+        }
+
+        // It means that agent and entity were not associated.
+    }
+
+    // Adding the to agent and the entity
+    p->entities.push_back(static_cast<epiworld_agent_index>(e->get_id()));
+    e->agents.push_back(static_cast<epiworld_agent_index>(p->get_id()));
 
 }
 
 template<typename TSeq>
-inline void Entity<TSeq>::get_queue(
-    epiworld_fast_int * init,
-    epiworld_fast_int * post
-)
+inline void Model<TSeq>::_event_rm_entity(Event<TSeq> & a)
 {
-    if (init != nullptr)
-        *init = queue_init;
 
-    if (post != nullptr)
-        *post = queue_post;
+    Agent<TSeq> &  p = *a.agent;
+    Entity<TSeq> & e = *a.entity;
+
+    // Remove entity from agent's entity list
+    p.entities.erase(
+        std::remove(
+            p.entities.begin(),
+            p.entities.end(),
+            static_cast<epiworld_agent_index>(e.get_id())
+        ),
+        p.entities.end()
+    );
+
+    // Remove agent from entity's agent list
+    e.agents.erase(
+        std::remove(
+            e.agents.begin(),
+            e.agents.end(),
+            static_cast<epiworld_agent_index>(p.get_id())
+        ),
+        e.agents.end()
+    );
+
+    return;
 
 }
 
-template<typename TSeq>
-inline void Entity<TSeq>::reset()
-{
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ End of -include/epiworld/agent-events-meat.hpp-
 
-    this->agents.clear();
-    this->agents.shrink_to_fit();
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    return;
 
-}
 
 template<typename TSeq>
-inline bool Entity<TSeq>::operator==(const Entity<TSeq> & other) const
+inline Agent<TSeq>::Agent(Agent<TSeq> && p) :
+    n_neighbors(p.n_neighbors),
+    entities(std::move(p.entities)),
+    state(p.state),
+    state_prev(p.state_prev), 
+    state_last_changed(p.state_last_changed),
+    id(p.id),
+    tools(std::move(p.tools)) /// Needs to be adjusted
 {
 
-    if (id != other.id)
-        return false;
-
-    if (agents.size() != other.agents.size())
-        return false;
+    std::copy(
+        std::begin(p.tools_effects), std::end(p.tools_effects),
+        std::begin(tools_effects)
+    );
+    tools_effects_fixed = p.tools_effects_fixed;
 
-    for (size_t i = 0u; i < agents.size(); ++i)
+    state = p.state;
+    id     = p.id;
+    
+    // Dealing with the virus
+    if (p.virus != nullptr)
     {
-        if (agents[i] != other.agents[i])
-            return false;
+        virus = std::move(p.virus);
+        virus->set_agent(this);
     }
 
-
-    if (max_capacity != other.max_capacity)
-        return false;
-
-    if (entity_name != other.entity_name)
-        return false;
-
-    if (location.size() != other.location.size())
-        return false;
-
-    for (size_t i = 0u; i < location.size(); ++i)
+    int loc = 0;
+    for (auto & t : tools)
     {
-
-        if (location[i] != other.location[i])
-            return false;
+        
+        // Will create a copy of the virus, with the exeption of
+        // the virus code
+        t->agent     = this;
+        t->pos_in_agent = loc++;
 
     }
-
-    if (state_init != other.state_init)
-        return false;
-
-    if (state_post != other.state_post)
-        return false;
-
-    if (queue_init != other.queue_init)
-        return false;
-
-    if (queue_post != other.queue_post)
-        return false;
-
-    return true;
-
+    
 }
 
+// Copy constructor
 template<typename TSeq>
-inline void Entity<TSeq>::distribute(Model<TSeq> * model)
+inline Agent<TSeq>::Agent(const Agent<TSeq> & p) :
+    n_neighbors(p.n_neighbors),
+    entities(p.entities)
 {
 
-    if (dist_fun)
+    state = p.state;
+    id     = p.id;
+    
+    // Dealing with the virus
+    if (p.virus != nullptr)
     {
+        virus = std::shared_ptr<Virus<TSeq>>(p.virus->clone_ptr());
+        virus->set_agent(this);
+    }
+    
 
-        dist_fun(*this, model);
+    tools.clear();
+    tools.reserve(p.get_n_tools());
+    for (size_t i = 0u; i < p.get_n_tools(); ++i)
+    {
+        tools.emplace_back(std::shared_ptr<Tool<TSeq>>(p.tools[i]->clone_ptr()));
+        tools.back()->set_agent(this, i);
 
     }
 
+    tools_effects_update();
+    
 }
 
 template<typename TSeq>
-inline const std::vector< size_t > & Entity<TSeq>::get_agents() const
+inline Agent<TSeq> & Agent<TSeq>::operator=(
+    const Agent<TSeq> & other_agent
+)
 {
-    return agents;
-}
 
-template<typename TSeq>
-inline const std::vector< size_t > & Entity<TSeq>::get_agents_ids() const
-{
-    return agents;
-}
+    n_neighbors = other_agent.n_neighbors;
+    
+    entities = other_agent.entities;
 
-template<typename TSeq>
-inline void Entity<TSeq>::print() const
-{
+    state              = other_agent.state;
+    state_prev         = other_agent.state_prev;
+    state_last_changed = other_agent.state_last_changed;
+    id                  = other_agent.id;
+    
+    if (other_agent.virus != nullptr)
+    {
+        virus = std::shared_ptr<Virus<TSeq>>(other_agent.virus->clone_ptr());
+        virus->set_agent(this);
+    } else
+        virus = nullptr;
+    
+    
+    tools.clear();
+    tools.reserve(other_agent.get_n_tools());
+    for (size_t i = 0u; i < other_agent.get_n_tools(); ++i)
+    {
+        tools.emplace_back(std::shared_ptr<Tool<TSeq>>(other_agent.tools[i]->clone_ptr()));
+        tools.back()->set_agent(this, i);
+    }
 
-    printf_epiworld(
-        "Entity '%s' (id %i) with %i agents.\n",
-        this->entity_name.c_str(),
-        static_cast<int>(id),
-        static_cast<int>(agents.size())
-    );
+    tools_effects_update();
+    
+    return *this;
+    
 }
 
 template<typename TSeq>
-inline void Entity<TSeq>::set_distribution(EntityToAgentFun<TSeq> fun)
+inline Agent<TSeq>::~Agent()
 {
-    dist_fun = fun;
-}
-
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-
- End of -./include/epiworld/entity-meat.hpp-
-
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
 
+}
 
-    
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-
- Start of -./include/epiworld/agent-meat-virus-sampling.hpp-
+template<typename TSeq>
+inline void Agent<TSeq>::add_tool(
+    Model<TSeq> & model,
+    const Tool<TSeq> & tool,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+) {
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    // Checking the tool exists
+    if (tool.get_id() >= static_cast<int>(model.get_db().get_n_tools()))
+        throw std::range_error("The tool with id: " + std::to_string(tool.get_id()) +
+            " has not been registered. There are only " + std::to_string(model.get_n_tools()) +
+            " included in the model.");
 
+    ToolPtr<TSeq> tool_ptr = std::shared_ptr<Tool<TSeq>>(tool.clone_ptr());
 
-#ifndef EPIWORLD_AGENT_MEAT_VIRUS_SAMPLING
-#define EPIWORLD_AGENT_MEAT_VIRUS_SAMPLING
+    model._add_event(
+        this, nullptr, tool_ptr, nullptr, state_new, queue, EventAction::AddTool
+        );
 
-/**
- * @brief Functions for sampling viruses
- * 
- */
-namespace sampler {
+}
 
-/**
- * @brief Make a function to sample from neighbors
- * 
- * This is akin to the function default_update_susceptible, with the difference
- * that it will create a function that supports excluding states from the sampling
- * frame. For example, individuals who have acquired a virus can be excluded if
- * in incubation state.
- * 
- * @tparam TSeq 
- * @param exclude unsigned vector of states that need to be excluded from the sampling
- * @return Virus<TSeq>* of the selected virus. If none selected (or none
- * available,) returns a nullptr;
- */
-template<typename TSeq = EPI_DEFAULT_TSEQ>
-inline std::function<void(Agent<TSeq>*,Model<TSeq>*)> make_update_susceptible(
-    std::vector< epiworld_fast_uint > exclude = {}
-    )
+template<typename TSeq>
+inline void Agent<TSeq>::set_virus(
+    Model<TSeq> & model,
+    const Virus<TSeq> & virus,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+)
 {
-  
-
-    if (exclude.size() == 0u)
-    {
-
-        std::function<void(Agent<TSeq>*,Model<TSeq>*)> sampler =
-            [](Agent<TSeq> * p, Model<TSeq> * m) -> void
-            {
-
-                if (p->get_virus() != nullptr)
-                    throw std::logic_error(
-                        std::string("Using the -default_update_susceptible- on agents WITH viruses makes no sense! ") +
-                        std::string("Agent id ") + std::to_string(p->get_id()) +
-                        std::string(" has a virus.")
-                        );
+    
+        // Checking the virus exists
+    if (virus.get_id() >= static_cast<int>(model.get_db().get_n_viruses()))
+        throw std::range_error("The virus with id: " + std::to_string(virus.get_id()) +
+            " has not been registered. There are only " + std::to_string(model.get_n_viruses()) +
+            " included in the model.");
 
-                // This computes the prob of getting any neighbor variant
-                size_t nviruses_tmp = 0u;
-                for (auto & neighbor: p->get_neighbors(*m)) 
-                {
-                    
-                    auto & v = neighbor->get_virus();
-                    if (v == nullptr)
-                        continue;
-                    
-                    /* And it is a function of susceptibility_reduction as well */ 
-                    m->array_double_tmp[nviruses_tmp] =
-                        (1.0 - p->get_susceptibility_reduction(v, *m)) * 
-                        v->get_prob_infecting(m) * 
-                        (1.0 - neighbor->get_transmission_reduction(v, *m)) 
-                        ; 
-                
-                    m->array_virus_tmp[nviruses_tmp++] = &(*v);
-                        
-                }
+    if (state_new == -99)
+        virus.get_state(&state_new, nullptr, nullptr);
 
-                // No virus to compute
-                if (nviruses_tmp == 0u)
-                    return;
+    if (queue == -99)
+        virus.get_queue(&queue, nullptr, nullptr);
 
-                // Running the roulette
-                int which = roulette(nviruses_tmp, m);
+    VirusPtr<TSeq> virus_ptr = std::shared_ptr<Virus<TSeq>>(virus.clone_ptr());
 
-                if (which < 0)
-                    return;
+    model._add_event(
+        this, virus_ptr, nullptr, nullptr, state_new, queue, EventAction::AddVirus
+        );
 
-                p->set_virus(*m, *m->array_virus_tmp[which]);
+}
 
-                return; 
-            };
+template<typename TSeq>
+inline void Agent<TSeq>::add_entity(
+    Model<TSeq> & model,
+    Entity<TSeq> & entity,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+)
+{
 
-        return sampler;
+    model._add_event(
+        this, nullptr, nullptr, &entity, state_new, queue, EventAction::AddEntity
+    );
 
-    } else {
+}
 
-        // Making room for the query
-        std::shared_ptr<std::vector<bool>> exclude_agent_bool =
-            std::make_shared<std::vector<bool>>(0);
+template<typename TSeq>
+inline void Agent<TSeq>::rm_tool(
+    Model<TSeq> & model,
+    epiworld_fast_uint tool_idx,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+)
+{
 
-        std::shared_ptr<std::vector<epiworld_fast_uint>> exclude_agent_bool_idx =
-            std::make_shared<std::vector<epiworld_fast_uint>>(exclude);
+    if (tool_idx >= tools.size())
+        throw std::range_error(
+            "The Tool you want to remove is out of range. This Agent only has " +
+            std::to_string(tools.size()) + " tools."
+        );
 
-        std::function<void(Agent<TSeq>*,Model<TSeq>*)> sampler =
-            [exclude_agent_bool,exclude_agent_bool_idx](Agent<TSeq> * p, Model<TSeq> * m) -> void
-            {
+    model._add_event(
+        this, nullptr, tools[tool_idx], nullptr, state_new, queue, EventAction::RemoveTool
+        );
 
-                // The first time we call it, we need to initialize the vector
-                if (exclude_agent_bool->size() == 0u)
-                {
+}
 
-                    exclude_agent_bool->resize(m->get_states().size(), false);
-                    for (auto s : *exclude_agent_bool_idx)
-                    {
-                        if (s >= exclude_agent_bool->size())
-                            throw std::logic_error(
-                                std::string("You are trying to exclude a state that is out of range: ") +
-                                std::to_string(s) + std::string(". There are only ") +
-                                std::to_string(exclude_agent_bool->size()) + 
-                                std::string(" states in the model.")
-                                );
+template<typename TSeq>
+inline void Agent<TSeq>::rm_tool(
+    Model<TSeq> & model,
+    ToolPtr<TSeq> & tool,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+)
+{
 
-                        exclude_agent_bool->operator[](s) = true;
+    if (tool->agent != this)
+        throw std::logic_error("Cannot remove a virus from another agent!");
 
-                    }
+    model._add_event(
+        this, nullptr, tool, nullptr, state_new, queue, EventAction::RemoveTool
+        );
 
-                }                    
+}
 
-                if (p->get_virus() != nullptr)
-                    throw std::logic_error(
-                        std::string("Using the -default_update_susceptible- on agents WITH viruses makes no sense! ") +
-                        std::string("Agent id ") + std::to_string(p->get_id()) +
-                        std::string(" has a virus.")
-                        );
+template<typename TSeq>
+inline void Agent<TSeq>::rm_virus(
+    Model<TSeq> & model,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+)
+{
 
-                // This computes the prob of getting any neighbor variant
-                size_t nviruses_tmp = 0u;
-                for (auto & neighbor: p->get_neighbors(*m)) 
-                {
+    if (virus == nullptr)
+        throw std::logic_error(
+            "There is no virus to remove here!"
+        );
 
-                    // If the state is in the list, exclude it
-                    if (exclude_agent_bool->operator[](neighbor->get_state()))
-                        continue;
+    if (state_new == -99)
+        virus->get_state(nullptr, &state_new, nullptr);
 
-                    auto & v = neighbor->get_virus();
-                    if (v == nullptr)
-                        continue;
-                            
-                
-                    /* And it is a function of susceptibility_reduction as well */ 
-                    m->array_double_tmp[nviruses_tmp] =
-                        (1.0 - p->get_susceptibility_reduction(v, *m)) * 
-                        v->get_prob_infecting(m) * 
-                        (1.0 - neighbor->get_transmission_reduction(v, *m)) 
-                        ; 
-                
-                    m->array_virus_tmp[nviruses_tmp++] = &(*v);
-                    
-                }
+    if (queue == -99)
+        virus->get_queue(nullptr, &queue, nullptr);
 
-                // No virus to compute
-                if (nviruses_tmp == 0u)
-                    return;
+    model._add_event(
+        this, virus, nullptr, nullptr,
+        state_new,
+        queue,
+        EventAction::RemoveVirus
+        );
 
-                // Running the roulette
-                int which = roulette(nviruses_tmp, m);
+}
 
-                if (which < 0)
-                    return;
+template<typename TSeq>
+inline void Agent<TSeq>::rm_entity(
+    Model<TSeq> & model,
+    epiworld_fast_uint entity_idx,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+)
+{
 
-                p->set_virus(*m, *m->array_virus_tmp[which]); 
+    if (entity_idx >= entities.size())
+        throw std::range_error(
+            "The Entity you want to remove is out of range. This Agent only has " +
+            std::to_string(entities.size()) + " entity(ies)."
+        );
+    else if (entities.size() == 0u)
+        throw std::logic_error(
+            "There is no entity to remove here!"
+        );
 
-                return;
+    model._add_event(
+        this,
+        nullptr,
+        nullptr,
+        &model.get_entity(entities[entity_idx]),
+        state_new,
+        queue,
+        EventAction::RemoveEntity
+    );
+}
 
-            };
+template<typename TSeq>
+inline void Agent<TSeq>::rm_entity(
+    Model<TSeq> & model,
+    Entity<TSeq> & entity,
+    epiworld_fast_int state_new,
+    epiworld_fast_int queue
+)
+{
 
-        return sampler;
+    // Looking for entity location in the agent
+    bool found = std::find(
+        entities.begin(), entities.end(),
+        static_cast<size_t>(entity.get_id())
+    ) != entities.end();
 
-    }
-    
+    if (!found)
+        throw std::logic_error(
+            std::string("The agent ") +
+            std::to_string(id) +
+            std::string(" is not associated with entity \"") +
+            entity.get_name() +
+            std::string("\".")
+            );
+
+    model._add_event(
+        this,
+        nullptr,
+        nullptr,
+        &model.get_entity(entity.get_id()),
+        state_new,
+        queue,
+        EventAction::RemoveEntity
+    );
 }
 
-/**
- * @brief Make a function to sample from neighbors
- * 
- * This is akin to the function default_update_susceptible, with the difference
- * that it will create a function that supports excluding states from the sampling
- * frame. For example, individuals who have acquired a virus can be excluded if
- * in incubation state.
- * 
- * @tparam TSeq 
- * @param exclude unsigned vector of states that need to be excluded from the sampling
- * @return Virus<TSeq>* of the selected virus. If none selected (or none
- * available,) returns a nullptr;
- */
-template<typename TSeq = EPI_DEFAULT_TSEQ>
-inline std::function<Virus<TSeq>*(Agent<TSeq>*,Model<TSeq>*)> make_sample_virus_neighbors(
-    std::vector< epiworld_fast_uint > exclude = {}
-)
+template<typename TSeq>
+inline void Agent<TSeq>::tools_effects_update()
 {
-    if (exclude.size() == 0u)
+
+    tools_effects_fixed = 0x0Fu;
+    for (auto & e : tools_effects)
+        e = 1.0;
+
+    for (auto & tool : tools)
     {
 
-        std::function<Virus<TSeq>*(Agent<TSeq>*,Model<TSeq>*)> res = 
-            [](Agent<TSeq> * p, Model<TSeq> * m) -> Virus<TSeq>* {
+        // Derived tools may override the getters, so only plain tools
+        // are trusted to report their constant effects
+        unsigned char mask = (typeid(*tool) == typeid(Tool<TSeq>)) ?
+            tool->def->fixed_mask : 0u;
 
-                if (p->get_virus() != nullptr)
-                    throw std::logic_error(
-                        std::string("Using the -default_update_susceptible- on agents WITH viruses makes no sense! ") +
-                        std::string("Agent id ") + std::to_string(p->get_id()) +
-                        std::string(" has a virus.")
-                        );
+        tools_effects_fixed &= mask;
+        for (size_t k = 0u; k < 4u; ++k)
+            if (mask & (1u << k))
+                tools_effects[k] *= (1.0 - tool->def->fixed_value[k]);
 
-                // This computes the prob of getting any neighbor variant
-                size_t nviruses_tmp = 0u;
-                for (auto & neighbor: p->get_neighbors(*m)) 
-                {
-                    
-                    if (neighbor->get_virus() == nullptr)
-                        continue;
+    }
 
-                    auto & v = neighbor->get_virus();
+}
 
-                    #ifdef EPI_DEBUG
-                    if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
-                        throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
-                    #endif
-                        
-                    /* And it is a function of susceptibility_reduction as well */ 
-                    m->array_double_tmp[nviruses_tmp] =
-                        (1.0 - p->get_susceptibility_reduction(v, *m)) * 
-                        v->get_prob_infecting(m) * 
-                        (1.0 - neighbor->get_transmission_reduction(v, *m)) 
-                        ; 
-                
-                    m->array_virus_tmp[nviruses_tmp++] = &(*v);
-                    
-                }
+template<typename TSeq>
+inline epiworld_double Agent<TSeq>::get_susceptibility_reduction(
+    VirusPtr<TSeq> & v,
+    Model<TSeq> & model
+) {
+
+    return model.susceptibility_reduction_mixer(this, v);
+}
+
+template<typename TSeq>
+inline epiworld_double Agent<TSeq>::get_transmission_reduction(
+    VirusPtr<TSeq> & v,
+    Model<TSeq> & model
+) {
+    return model.transmission_reduction_mixer(this, v);
+}
 
-                // No virus to compute
-                if (nviruses_tmp == 0u)
-                    return nullptr;
+template<typename TSeq>
+inline epiworld_double Agent<TSeq>::get_recovery_enhancer(
+    VirusPtr<TSeq> & v,
+    Model<TSeq> & model
+) {
+    return model.recovery_enhancer_mixer(this, v);
+}
 
-                // Running the roulette
-                int which = roulette(nviruses_tmp, m);
+template<typename TSeq>
+inline epiworld_double Agent<TSeq>::get_death_reduction(
+    VirusPtr<TSeq> & v,
+    Model<TSeq> & model
+) {
+    return model.death_reduction_mixer(this, v);
+}
 
-                if (which < 0)
-                    return nullptr;
+template<typename TSeq>
+inline int Agent<TSeq>::get_id() const
+{
+    return id;
+}
 
-                return m->array_virus_tmp[which]; 
+template<typename TSeq>
+inline VirusPtr<TSeq> & Agent<TSeq>::get_virus() {
+    return virus;
+}
 
-            };
+template<typename TSeq>
+inline const VirusPtr<TSeq> & Agent<TSeq>::get_virus() const {
+    return virus;
+}
 
-        return res;
 
+template<typename TSeq>
+inline std::vector< ToolPtr<TSeq> > Agent<TSeq>::get_tools() {
+    return tools;
+}
 
-    } else {
+template<typename TSeq>
+inline const std::vector< ToolPtr<TSeq> > Agent<TSeq>::get_tools() const {
+    return tools;
+}
 
-        // Making room for the query
-        std::shared_ptr<std::vector<bool>> exclude_agent_bool =
-            std::make_shared<std::vector<bool>>(0);
+template<typename TSeq>
+inline ToolPtr<TSeq> & Agent<TSeq>::get_tool(int i)
+{
+    return tools.at(i);
+}
 
-        std::shared_ptr<std::vector<epiworld_fast_uint>> exclude_agent_bool_idx =
-            std::make_shared<std::vector<epiworld_fast_uint>>(exclude);
+template<typename TSeq>
+inline ToolPtr<TSeq> & Agent<TSeq>::get_tool(std::string name)
+{
+    for (auto & tool : tools)
+        if (tool->get_name() == name)
+            return tool;
 
+    throw std::logic_error(
+        "The agent does not have a tool with name: " + name
+    );
 
-        std::function<Virus<TSeq>*(Agent<TSeq>*,Model<TSeq>*)> res = 
-            [exclude_agent_bool,exclude_agent_bool_idx](Agent<TSeq> * p, Model<TSeq> * m) -> Virus<TSeq>* {
+}
 
-                // The first time we call it, we need to initialize the vector
-                if (exclude_agent_bool->size() == 0u)
-                {
+template<typename TSeq>
+inline size_t Agent<TSeq>::get_n_tools() const noexcept
+{
+    return tools.size();
+}
 
-                    exclude_agent_bool->resize(m->get_states().size(), false);
-                    for (auto s : *exclude_agent_bool_idx)
-                    {
-                        if (s >= exclude_agent_bool->size())
-                            throw std::logic_error(
-                                std::string("You are trying to exclude a state that is out of range: ") +
-                                std::to_string(s) + std::string(". There are only ") +
-                                std::to_string(exclude_agent_bool->size()) + 
-                                std::string(" states in the model.")
-                                );
+template<typename TSeq>
+inline void Agent<TSeq>::mutate_virus()
+{
 
-                        exclude_agent_bool->operator[](s) = true;
+    virus->mutate();
 
-                    }
+}
 
-                }    
-                
-                if (p->get_virus() != nullptr)
-                    throw std::logic_error(
-                        std::string("Using the -default_update_susceptible- on agents WITH viruses makes no sense! ") +
-                        std::string("Agent id ") + std::to_string(p->get_id()) +
-                        std::string(" has a virus.")
-                        );
+template<typename TSeq>
+inline void Agent<TSeq>::add_neighbor(
+    Agent<TSeq> & p,
+    Model<TSeq> & model,
+    bool check_source,
+    bool check_target
+) {
 
-                // This computes the prob of getting any neighbor variant
-                size_t nviruses_tmp = 0u;
-                for (auto & neighbor: p->get_neighbors(*m)) 
-                {
+    auto & net = model.get_network_mutable();
+    net.add_edge(
+        static_cast< size_t >(id),
+        static_cast< size_t >(p.id),
+        check_source,
+        check_target
+    );
 
-                    // If the state is in the list, exclude it
-                    if (exclude_agent_bool->operator[](neighbor->get_state()))
-                        continue;
+    n_neighbors   = net.degree(id);
+    p.n_neighbors = net.degree(p.id);
 
-                    if (neighbor->get_virus() == nullptr)
-                        continue;
+}
 
-                    auto & v = neighbor->get_virus();
-                            
-                    #ifdef EPI_DEBUG
-                    if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
-                        throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
-                    #endif
-                        
-                    /* And it is a function of susceptibility_reduction as well */ 
-                    m->array_double_tmp[nviruses_tmp] =
-                        (1.0 - p->get_susceptibility_reduction(v, *m)) * 
-                        v->get_prob_infecting(m) * 
-                        (1.0 - neighbor->get_transmission_reduction(v, *m)) 
-                        ; 
-                
-                    m->array_virus_tmp[nviruses_tmp++] = &(*v);
-                    
-                }
+template<typename TSeq>
+inline void Agent<TSeq>::swap_neighbors(
+    Agent<TSeq> & other,
+    size_t n_this,
+    size_t n_other,
+    Model<TSeq> & model
+)
+{
 
-                // No virus to compute
-                if (nviruses_tmp == 0u)
-                    return nullptr;
+    if (n_this >= n_neighbors)
+        throw std::range_error(
+            "The neighbor you want to swap is out of range. This Agent only has " +
+            std::to_string(n_neighbors) + " neighbors."
+        );
+    if (n_other >= other.n_neighbors)
+        throw std::range_error(
+            "The neighbor you want to swap is out of range. This Agent only has " +
+            std::to_string(other.n_neighbors) + " neighbors."
+        );
 
-                // Running the roulette
-                int which = roulette(nviruses_tmp, m);
+    // Getting the rows of the agents in the network
+    auto & net = model.get_network_mutable();
+    epiworld_agent_index * neighbors       = net.neighbors(id);
+    epiworld_agent_index * other_neighbors = net.neighbors(other.id);
+    epiworld_agent_index * locations       = net.neighbors_locations(id);
+    epiworld_agent_index * other_locations = net.neighbors_locations(other.id);
 
-                if (which < 0)
-                    return nullptr;
+    size_t neigh_this  = neighbors[n_this];
+    size_t neigh_other = other_neighbors[n_other];
 
-                return m->array_virus_tmp[which]; 
+    // Getting the locations in the neighbors
+    size_t loc_this_in_neigh = locations[n_this];
+    size_t loc_other_in_neigh = other_locations[n_other];
 
-            };
+    // Changing ids
+    std::swap(neighbors[n_this], other_neighbors[n_other]);
 
-        return res;
+    if (!model.directed)
+    {
+        std::swap(
+            net.neighbors(neigh_this)[loc_this_in_neigh],
+            net.neighbors(neigh_other)[loc_other_in_neigh]
+            );
 
+        // Changing the locations
+        std::swap(locations[n_this], other_locations[n_other]);
+        
+        std::swap(
+            net.neighbors_locations(neigh_this)[loc_this_in_neigh],
+            net.neighbors_locations(neigh_other)[loc_other_in_neigh]
+            );
     }
 
 }
 
-/**
- * @brief Sample from neighbors pool of viruses (at most one)
- * 
- * This function samples at most one virus from the pool of
- * viruses from its neighbors. If no virus is selected, the function
- * returns a `nullptr`, otherwise it returns a pointer to the
- * selected virus.
- * 
- * This can be used to build a new update function (EPI_NEW_UPDATEFUN.)
- * 
- * @tparam TSeq 
- * @param p Pointer to person 
- * @param m Pointer to the model
- * @return Virus<TSeq>* of the selected virus. If none selected (or none
- * available,) returns a nullptr;
- */
-template<typename TSeq = EPI_DEFAULT_TSEQ>
-inline Virus<TSeq> * sample_virus_single(Agent<TSeq> * p, Model<TSeq> * m)
+template<typename TSeq>
+inline std::vector< Agent<TSeq> *> Agent<TSeq>::get_neighbors(Model<TSeq> & model)
 {
+    std::vector< Agent<TSeq> * > res(n_neighbors, nullptr);
+    const epiworld_agent_index * neighbors = model.network->neighbors(id);
+    for (size_t i = 0u; i < n_neighbors; ++i)
+        res[i] = &model.population[neighbors[i]];
+    return res;
+}
 
-    if (p->get_virus() != nullptr)
-        throw std::logic_error(
-            std::string("Using the -default_update_susceptible- on agents WITH viruses makes no sense!") +
-            std::string("Agent id ") + std::to_string(p->get_id()) +
-            std::string(" has a virus.")
-            );
-
-    // This computes the prob of getting any neighbor variant
-    size_t nviruses_tmp = 0u;
-    for (auto & neighbor: p->get_neighbors(*m)) 
-    {   
-        #ifdef EPI_DEBUG
-        int _vcount_neigh = 0;
-        #endif                
-
-        if (neighbor->get_virus() == nullptr)
-            continue;
-
-        auto & v = neighbor->get_virus();
-
-        #ifdef EPI_DEBUG
-        if (nviruses_tmp >= m->array_virus_tmp.size())
-            throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
-        #endif
-            
-        /* And it is a function of susceptibility_reduction as well */ 
-        m->array_double_tmp[nviruses_tmp] =
-            (1.0 - p->get_susceptibility_reduction(v, *m)) * 
-            v->get_prob_infecting(m) * 
-            (1.0 - neighbor->get_transmission_reduction(v, *m)) 
-            ; 
-    
-        m->array_virus_tmp[nviruses_tmp++] = &(*v);
-
-        #ifdef EPI_DEBUG
-        if (
-            (m->array_double_tmp[nviruses_tmp - 1] < 0.0) |
-            (m->array_double_tmp[nviruses_tmp - 1] > 1.0)
-            )
-        {
-            printf_epiworld(
-                "[epi-debug] Agent %i's virus %i has transmission prob outside of [0, 1]: %.4f!\n",
-                static_cast<int>(neighbor->get_id()),
-                static_cast<int>(_vcount_neigh++),
-                m->array_double_tmp[nviruses_tmp - 1]
-                );
-        }
-        #endif
-            
-    }
+template<typename TSeq>
+inline AgentNeighbors<TSeq> Agent<TSeq>::neighbors(Model<TSeq> & model)
+{
+    return AgentNeighbors<TSeq>(
+        model.population.data(),
+        model.network->neighbors(id),
+        n_neighbors
+    );
+}
 
+template<typename TSeq>
+inline size_t Agent<TSeq>::get_n_neighbors() const
+{
+    return n_neighbors;
+}
 
-    // No virus to compute
-    if (nviruses_tmp == 0u)
-        return nullptr;
+template<typename TSeq>
+inline void Agent<TSeq>::change_state(
+    Model<TSeq> & model,
+    epiworld_fast_uint new_state,
+    epiworld_fast_int queue
+    )
+{
 
-    #ifdef EPI_DEBUG
-    m->get_db().n_transmissions_potential++;
-    #endif
+    model._add_event(
+        this, nullptr, nullptr, nullptr, new_state, queue,
+        EventAction::ChangeState
+    );
 
-    // Running the roulette
-    int which = roulette(nviruses_tmp, m);
+    return;
 
-    if (which < 0)
-        return nullptr;
+}
 
-    #ifdef EPI_DEBUG
-    m->get_db().n_transmissions_today++;
-    #endif
+template<typename TSeq>
+inline unsigned int Agent<TSeq>::get_state() const {
+    return state;
+}
 
-    return m->array_virus_tmp[which]; 
-    
+template<typename TSeq>
+inline unsigned int Agent<TSeq>::get_state_prev() const {
+    return state_prev;
 }
 
+template<typename TSeq>
+inline int Agent<TSeq>::get_state_last_changed() const {
+    return state_last_changed;
 }
 
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+template<typename TSeq>
+inline void Agent<TSeq>::reset()
+{
 
- End of -./include/epiworld/agent-meat-virus-sampling.hpp-
+    this->virus = nullptr;
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    // Clearing keeps the capacity, so replicates don't reallocate
+    this->tools.clear();
+    this->entities.clear();
+    this->tools_effects_update();
 
+    this->state = 0u;
+    this->state_prev = 0u;
 
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+    this->state_last_changed = -1;
+    
+}
 
- Start of -./include/epiworld/agent-meat-state.hpp-
+template<typename TSeq>
+inline bool Agent<TSeq>::has_tool(epiworld_fast_uint t) const
+{
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    for (auto & tool : tools)
+        if (tool->get_id() == static_cast<int>(t))
+            return true;
 
+    return false;
 
-#ifndef EPIWORLD_PERSON_MEAT_STATE_HPP
-#define EPIWORLD_PERSON_MEAT_STATE_HPP
+}
 
-// (already included include/epiworld/model-bones.hpp)
-// (already included include/epiworld/agent-meat-virus-sampling.hpp)
-// (already included include/epiworld/config.hpp)
+template<typename TSeq>
+inline bool Agent<TSeq>::has_tool(std::string_view name) const
+{
 
-/**
- * @file agent-meat-state.hpp
- * @author George G. Vega Yon (g.vegayon en gmail)
- * @brief Sampling functions are getting big, so we keep them in a separate file.
- * @version 0.1
- * @date 2022-06-15
- * 
- * @copyright Copyright (c) 2022
- * 
- */
+    for (auto & tool : tools)
+        if (tool->get_name() == name)
+            return true;
 
-template<typename TSeq = EPI_DEFAULT_TSEQ>
-inline void default_update_susceptible(
-    Agent<TSeq> * p,
-    Model<TSeq> * m
-    )
-{
+    return false;
 
-    Virus<TSeq> * virus = sampler::sample_virus_single<TSeq>(p, m);
-    
-    if (virus == nullptr)
-        return;
+}
 
-    p->set_virus(*m, *virus);
+template<typename TSeq>
+inline bool Agent<TSeq>::has_tool(const Tool<TSeq> & tool) const
+{
 
-    return;
+    return has_tool(tool.get_id());
 
 }
 
-/**
- * @brief Factory function to create a state update function based on
- * transition rates.
- *
- * @details
- * This function creates an `UpdateFun` that transitions agents between
- * states using named model parameters as per-step transition probabilities.
- * At each time step the generated function reads the current values of the
- * parameters from the model and uses the roulette sampling algorithm to
- * decide whether a transition occurs (and if so, to which target state).
- *
- * The parameter names must correspond to parameters that have already been
- * added to the model (via `Model::add_param()`). The target states are
- * specified as integer state codes (the indices returned by
- * `Model::add_state()`).
- *
- * @tparam TSeq Type of the sequence (default `EPI_DEFAULT_TSEQ`).
- * @param param_names  Names of the model parameters that hold the
- *                     transition rates. The i-th name gives the rate for
- *                     transitioning to the i-th target state.
- * @param target_states Integer codes of the destination states, in the
- *                      same order as `param_names`.
- * @return An `UpdateFun<TSeq>` suitable for use with
- *         `Model::add_state()`.
- *
- * @throws std::logic_error if `param_names` and `target_states` differ in
- *         size, or if either is empty.
- *
- * ### Example: SEIRD model
- *
- * @code{.cpp}
- * // E -> I transition
- * auto update_exposed = new_state_update_transition<int>(
- *     {"E->I transition rate"},
- *     {2}  // state code for Infected
- * );
- *
- * // I -> R or I -> D transitions
- * auto update_infected = new_state_update_transition<int>(
- *     {"I->R transition rate", "I->D transition rate"},
- *     {3, 4}  // state codes for Recovered and Deceased
- * );
- *
- * model.add_state("Susceptible", default_update_susceptible<int>);
- * model.add_state("Exposed",     update_exposed);
- * model.add_state("Infected",    update_infected);
- * model.add_state("Recovered");
- * model.add_state("Deceased");
- * @endcode
- */
-template<typename TSeq = EPI_DEFAULT_TSEQ>
-inline UpdateFun<TSeq> new_state_update_transition(
-    std::vector< std::string > param_names,
-    std::vector< epiworld_fast_uint > target_states
-)
+template<typename TSeq>
+inline bool Agent<TSeq>::has_virus(epiworld_fast_uint t) const
 {
+    if (virus->get_id() == static_cast<int>(t))
+        return true;
 
-    if (param_names.size() != target_states.size())
-        throw std::logic_error(
-            "The number of parameter names (" +
-            std::to_string(param_names.size()) +
-            ") and target states (" +
-            std::to_string(target_states.size()) +
-            ") must match."
-        );
+    return false;
+}
 
-    if (param_names.empty())
-        throw std::logic_error(
-            "At least one transition must be specified."
-        );
+template<typename TSeq>
+inline bool Agent<TSeq>::has_virus(std::string_view name) const
+{
+    
+    if (virus->get_name() == name)
+        return true;
 
-    return [param_names, target_states](
-        Agent<TSeq> * p,
-        Model<TSeq> * m
-    ) -> void {
+    return false;
 
-        size_t n = param_names.size();
-        int which;
+}
 
-        if (n <= 1024u)
-        {
-            for (size_t i = 0u; i < n; ++i)
-                m->array_double_tmp[i] = m->par(param_names[i]);
+template<typename TSeq>
+inline bool Agent<TSeq>::has_virus(const Virus<TSeq> & virus) const
+{
 
-            // Roulette sampling: returns -1 if no transition occurs,
-            // otherwise the index of the transition that fires.
-            which = roulette(static_cast<epiworld_fast_uint>(n), m);
-        }
-        else
-        {
-            std::vector< epiworld_double > probs(n);
-            for (size_t i = 0u; i < n; ++i)
-                probs[i] = m->par(param_names[i]);
+    return has_virus(virus.get_id());
 
-            // Fallback for transition tables larger than the temporary buffer.
-            which = roulette(probs, m);
-        }
-        if (which < 0)
-            return;
+}
 
-        p->change_state(*m, target_states[which]);
+template<typename TSeq>
+inline bool Agent<TSeq>::has_entity(epiworld_fast_uint t) const
+{
 
-        return;
+    for (auto & entity_id : entities)
+        if (entity_id == static_cast<size_t>(t))
+            return true;
 
-    };
+    return false;
 
 }
 
-template<typename TSeq = EPI_DEFAULT_TSEQ>
-inline void default_update_exposed(Agent<TSeq> * p, Model<TSeq> * m) {
-
-    if (p->get_virus() == nullptr)
-        throw std::logic_error(
-            std::string("Using the -default_update_exposed- on agents WITHOUT viruses makes no sense! ") +
-            std::string("Agent id ") + std::to_string(p->get_id()) + std::string(" has no virus registered.")
-            );
-
-    // Die
-    auto & virus = p->get_virus();
-    m->array_double_tmp[0u] = 
-        virus->get_prob_death(m) * (1.0 - p->get_death_reduction(virus, *m));
+template<typename TSeq>
+inline bool Agent<TSeq>::has_entity(std::string_view name, const Model<TSeq> & model) const
+{
 
-    // Recover
-    m->array_double_tmp[1u] =
-        1.0 - (1.0 - virus->get_prob_recovery(m)) * (1.0 - p->get_recovery_enhancer(virus, *m)); 
-    
+    for (auto & entity_id : entities)
+        if (model.get_entity(entity_id).get_name() == name)
+            return true;
 
-    // Running the roulette
-    int which = roulette(2u, m);
+    return false;
 
-    if (which < 0)
-        return;
+}
 
-    // Which roulette happen?
-    if (which == 0u) // If odd
+template<typename TSeq>
+inline void Agent<TSeq>::print(
+    Model<TSeq> & model,
+    bool compressed
+    ) const
+{
+
+    if (compressed)
     {
+        printf_epiworld(
+            "Agent: %i, state: %s (%i), Has virus: %s, NTools: %ii NNeigh: %i\n",
+            static_cast<int>(id),
+            model.states_labels[state].c_str(),
+            static_cast<int>(state),
+            virus == nullptr ? std::string("no").c_str() : std::string("yes").c_str(),
+            static_cast<int>(tools.size()),
+            static_cast<int>(n_neighbors)
+        );
+    }
+    else {
 
-        int rm_state = -1;
-        p->get_virus()->get_state(nullptr, nullptr, &rm_state);
-        p->rm_virus(*m, rm_state);
-        
-    } else {
+        printf_epiworld("Information about agent id %i\n",
+            static_cast<int>(this->id));
+        printf_epiworld("  State        : %s (%i)\n",
+            model.states_labels[state].c_str(), static_cast<int>(state));
+        printf_epiworld("  Has virus    : %s\n", virus == nullptr ?
+            std::string("no").c_str() : std::string("yes").c_str());
+        printf_epiworld("  Tool count   : %i\n", static_cast<int>(tools.size()));
+        printf_epiworld("  Neigh. count : %i\n", static_cast<int>(n_neighbors));
 
-        p->rm_virus(*m);
+        size_t nfeats = model.get_agents_data_ncols();
+        if (nfeats > 0)
+        {
 
-    }
+            printf_epiworld(
+                "This model includes features (%i): [ ",
+                static_cast<int>(nfeats)
+                );
 
-    return ;
+            int max_to_show = static_cast<int>((nfeats > 10)? 10 : nfeats);
 
-};
+            for (int k = 0; k < max_to_show; ++k)
+            {
+                printf_epiworld("%.2f", this->operator()(k, model));
 
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+                if (k != (max_to_show - 1))
+                {
+                    printf_epiworld(", ");
+                } else {
+                    printf_epiworld(" ]\n");
+                }
 
- End of -./include/epiworld/agent-meat-state.hpp-
+            }
+            
+        }
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    }
 
+    return;
 
-// (already included ./include/epiworld/agent-bones.hpp)
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+}
 
- Start of -./include/epiworld/agent-meat.hpp-
+template<typename TSeq>
+inline double & Agent<TSeq>::operator()(size_t j, Model<TSeq> & model)
+{
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    if (model.agents_data_ncols <= j)
+        throw std::logic_error("The requested feature of the agent is out of range.");
 
+    return *(model.agents_data + j * model.size() + id);
 
-#ifndef EPIWORLD_PERSON_MEAT_HPP
-#define EPIWORLD_PERSON_MEAT_HPP
+}
 
-#include <vector>
-#include <string>
-// (already included include/epiworld/config.hpp)
-// (already included include/epiworld/epiworld-macros.hpp)
-// (already included include/epiworld/agent-bones.hpp)
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+template<typename TSeq>
+inline double Agent<TSeq>::operator()(size_t j, const Model<TSeq> & model) const
+{
 
- Start of -include/epiworld/agent-events-meat.hpp-
+    if (model.agents_data_ncols <= j)
+        throw std::logic_error("The requested feature of the agent is out of range.");
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    return *(model.agents_data + j * model.size() + id);
 
+}
 
-#ifndef EPIWORLD_AGENT_EVENTS_MEAT_HPP
-#define EPIWORLD_AGENT_EVENTS_MEAT_HPP
+template<typename TSeq>
+inline const std::vector< epiworld_agent_index > & Agent<TSeq>::get_entities() const
+{
+    return entities;
+}
 
 template<typename TSeq>
-inline void Model<TSeq>::_event_add_virus(Event<TSeq> & a)
+inline const Entity<TSeq> & Agent<TSeq>::get_entity(size_t i, const Model<TSeq> & model) const
 {
+    if (entities.size() == 0)
+        throw std::range_error("Agent id " + std::to_string(id) + " has no entities.");
 
-    Agent<TSeq> *  p = a.agent;
-    VirusPtr<TSeq> & v = a.virus;
-    
-    db.record_transmission(
-        v->get_agent() ? v->get_agent()->get_id() : -1,
-        p->get_id(),
-        v->get_id(),
-        v->get_date() 
+    if (i >= entities.size())
+        throw std::range_error("Trying to get to an agent's entity outside of the range.");
+
+    return model.get_entity(
+        #ifdef EPI_DEBUG
+        entities.at(i)
+        #else
+        entities[i]
+        #endif
     );
-    
-    p->virus = std::move(v);
-    p->virus->set_date(today());
-    p->virus->set_agent(p);
+}
 
-    // Change of state needs to be recorded and updated on the
-    // tools.
-    if ((a.new_state != -99) && (static_cast<int>(p->state) != a.new_state))
-    {
-        db.update_state(p->state_prev, a.new_state);
+template<typename TSeq>
+inline Entity<TSeq> & Agent<TSeq>::get_entity(size_t i, Model<TSeq> & model)
+{
+    if (entities.size() == 0)
+        throw std::range_error("Agent id " + std::to_string(id) + " has no entities.");
 
-        // For tool counts, use current state (p->state) not state_prev
-        // because state_prev may be stale if multiple changes occurred today
-        for (size_t i = 0u; i < p->tools.size(); ++i)
-            db.update_tool(
-                p->tools[i]->get_id(),
-                p->state,
-                a.new_state
-            );
-    }
+    if (i >= entities.size())
+        throw std::range_error("Trying to get to an agent's entity outside of the range.");
 
-    // Lastly, we increase the daily count of the virus
-    #ifdef EPI_DEBUG
-    db.today_virus.at(p->virus->get_id()).at(
-        a.new_state != -99 ? a.new_state : p->state
-    )++;
-    #else
-    db.today_virus[p->virus->get_id()][
-        a.new_state != -99 ? a.new_state : p->state
-    ]++;
-    #endif
+    return model.get_entity(
+        #ifdef EPI_DEBUG
+        entities.at(i)
+        #else
+        entities[i]
+        #endif
+    );
+}
 
+template<typename TSeq>
+inline size_t Agent<TSeq>::get_n_entities() const
+{
+    return entities.size();
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::_event_add_tool(Event<TSeq> & a)
+inline bool Agent<TSeq>::operator==(const Agent<TSeq> & other) const
 {
 
-    Agent<TSeq> * p = a.agent;
-    ToolPtr<TSeq> & t = a.tool;
+    // Checking the address
+    if (this == &other)
+        return true;
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        n_neighbors != other.n_neighbors,
+        "Agent:: n_eighbors don't match"
+        )
+
     
-    // Update tool accounting
-    p->tools.emplace_back(std::move(t));
-    size_t tool_pos = p->tools.size() - 1u;
+    EPI_DEBUG_FAIL_AT_TRUE(
+        entities.size() != other.entities.size(),
+        "Agent:: n_entities don't match"
+        )
 
-    p->tools[tool_pos]->set_date(today());
-    p->tools[tool_pos]->set_agent(p, tool_pos);
 
-    // Change of state needs to be recorded and updated on the
-    // tools.
-    if ((a.new_state != -99) && static_cast<int>(p->state) != a.new_state)
+    for (size_t i = 0u; i < entities.size(); ++i)
     {
-        db.update_state(p->state_prev, a.new_state);
+        EPI_DEBUG_FAIL_AT_TRUE(
+            entities[i] != other.entities[i],
+            "Agent:: entities[i] don't match"
+        )
+    }
 
-        // For virus counts, use current state (p->state) not state_prev
-        // because state_prev may be stale if multiple changes occurred today
-        if (p->virus)
-            db.update_virus(
-                p->virus->get_id(),
-                p->state,
-                a.new_state
-            );
+    EPI_DEBUG_FAIL_AT_TRUE(
+        state != other.state,
+        "Agent:: state don't match"
+        )
+        
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        state_prev != other.state_prev,
+        "Agent:: state_prev don't match"
+        )
+        
+
+    // EPI_DEBUG_FAIL_AT_TRUE(
+    //     state_last_changed != other.state_last_changed,
+    //     "Agent:: state_last_changed don't match"
+    //     ) ///< Last time the agent was updated.
+
+    EPI_DEBUG_FAIL_AT_TRUE(
+        ((virus == nullptr) && (other.virus != nullptr)) ||
+            ((virus != nullptr) && (other.virus == nullptr)),
+        "Agent:: virus don't match"
+    )
+
+    if ((virus != nullptr) && (other.virus != nullptr))
+    {
+        EPI_DEBUG_FAIL_AT_TRUE(
+            *virus != *other.virus,
+            "Agent:: virus doesn't match"
+        )
     }
+    
+    EPI_DEBUG_FAIL_AT_TRUE(
+        tools.size() != other.tools.size(),
+        "Agent:: n_tools don't match"
+    )
 
-    db.today_tool[p->tools[tool_pos]->get_id()][
-        a.new_state != -99 ? a.new_state : p->state
-    ]++;
+    for (size_t i = 0u; i < tools.size(); ++i)
+    {
+        
+        EPI_DEBUG_FAIL_AT_TRUE(
+            *tools[i] != *other.tools[i],
+            "Agent:: tools[i] don't match"
+        )
+         
+    }   
+    
+    return true;
+    
+}
 
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-}
+ End of -./include/epiworld/agent-meat.hpp-
 
-template<typename TSeq>
-inline void Model<TSeq>::_event_rm_virus(Event<TSeq> & a)
-{
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    Agent<TSeq> * p    = a.agent;
-    VirusPtr<TSeq> & v = a.virus;
 
-    // Calling the virus action over the removed virus
-    v->post_recovery(this);
 
-    p->virus = nullptr;
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    // Change of state needs to be recorded and updated on the
-    // tools.
-    if ((a.new_state != -99) && (static_cast<int>(p->state) != a.new_state))
-    {
-        db.update_state(p->state_prev, a.new_state);
+ Start of -./include/epiworld/agentssample-bones.hpp-
 
-        // For tool counts, use current state (p->state) not state_prev
-        // because state_prev may be stale if multiple changes occurred today
-        for (size_t i = 0u; i < p->tools.size(); ++i)
-            db.update_tool(
-                p->tools[i]->get_id(),
-                p->state,
-                a.new_state
-            );
-    }
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    // The counter of the removed virus must be decremented from the
-    // agent's current state (pre-transition), not state_prev.
-    // state_prev may refer to an earlier same-day state.
-    #ifdef EPI_DEBUG
-    db.today_virus.at(v->get_id()).at(p->state)--;
-    #else
-    db.today_virus[v->get_id()][p->state]--;
-    #endif
 
-    
-    return;
+#ifndef EPIWORLD_AGENTS_BONES_HPP
+#define EPIWORLD_AGENTS_BONES_HPP
 
-}
+class SAMPLETYPE {
+public:
+    static const int MODEL  = 0;
+    static const int ENTITY = 1;
+    static const int AGENT  = 2;
+};
 
-template<typename TSeq>
-inline void Model<TSeq>::_event_rm_tool(Event<TSeq> & a)
-{
+// template<typename TSeq>
+// class Agent;
 
-    Agent<TSeq> * p = a.agent;
-    ToolPtr<TSeq> & t = a.tool;
-    bool removed = false;
+// template<typename TSeq>
+// class Model;
 
-    if (t)
-    {
-        // Remove tool(s) by id, following an erase/remove approach.
-        auto new_end = std::remove_if(
-            p->tools.begin(),
-            p->tools.end(),
-            [&t](const ToolPtr<TSeq> & tool_ptr) -> bool
-            {
-                return tool_ptr && (tool_ptr->get_id() == t->get_id());
-            }
-        );
+// template<typename TSeq>
+// class Entity;
 
-        removed = (new_end != p->tools.end());
-        p->tools.erase(new_end, p->tools.end());
+/**
+ * @brief Sample of agents
+ * 
+ * This class allows sampling agents from Entity<TSeq> and Model<TSeq>.
+ * 
+ * @tparam TSeq 
+ */
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+class AgentsSample {
+private:
 
-        for (size_t i = 0u; i < p->tools.size(); ++i)
-            p->tools[i]->pos_in_agent = static_cast<int>(i);
-    }
+    size_t sample_size = 0u;
 
-    // Change of state needs to be recorded and updated on the
-    // tools.
-    if ((a.new_state != -99) && (static_cast<int>(p->state) != a.new_state))
-    {
-        db.update_state(p->state_prev, a.new_state);
+    std::vector< Agent<TSeq>* >* agents = nullptr; ///< Pointer to sample of agents
+    size_t * agents_n = nullptr;                    ///< Size of sample of agents
+    
+    std::vector< size_t >* agents_left = nullptr;  ///< Pointer to agents left (iota)
+    size_t * agents_left_n = nullptr;               ///< Size of agents left
 
-        // For virus counts, use current state (p->state) not state_prev
-        // because state_prev may be stale if multiple changes occurred today
-        if (p->virus)
-            db.update_virus(
-                p->virus->get_id(),
-                p->state,
-                a.new_state
-            );
-    }
+    Model<TSeq> * model   = nullptr;   ///< Extracts runif() and (if the case) population.
+    Entity<TSeq> * entity = nullptr; ///
+    Agent<TSeq> * agent   = nullptr;
+    
+    int sample_type = SAMPLETYPE::AGENT;
+    std::vector< size_t > states = {};
 
-    // Like rm_virus, remove the tool count from the agent's current
-    // state (pre-transition). Using state_prev can underflow when
-    // the agent changed state earlier in the day.
-    if (removed)
-    {
-        #ifdef EPI_DEBUG
-        db.today_tool.at(t->get_id()).at(p->state)--;
-        #else
-        db.today_tool[t->get_id()][p->state]--;
-        #endif
+    void sample_n(size_t n); ///< Backbone function for sampling
 
-        t->agent = nullptr;
-        t->pos_in_agent = -99;
-    }
 
-    return;
+public:
 
-}
+    // Not available (for now)
+    AgentsSample() = delete;                             ///< Default constructor
+    AgentsSample(const AgentsSample<TSeq> & a) = delete; ///< Copy constructor
+    AgentsSample(AgentsSample<TSeq> && a) = delete;      ///< Move constructor
 
-template<typename TSeq>
-inline void Model<TSeq>::_event_change_state(Event<TSeq> & a)
-{
+    AgentsSample(
+        Model<TSeq> & model_, size_t n,
+        std::vector< size_t > states_ = {},
+        bool truncate = false
+        );
 
-    Agent<TSeq> * p = a.agent;
+    AgentsSample(
+        Model<TSeq> * model,
+        Entity<TSeq> & entity_,
+        size_t n,
+        std::vector< size_t > states_ = {},
+        bool truncate = false
+        );
 
-    if ((a.new_state != -99) && (static_cast<int>(p->state) != a.new_state))
-    {
-        db.update_state(p->state_prev, a.new_state);
+    AgentsSample(
+        Model<TSeq> * model,
+        Agent<TSeq> & agent_,
+        size_t n,
+        std::vector< size_t > states_ = {},
+        bool truncate = false
+        );
 
-        // For virus and tool counts, use current state (p->state) not state_prev
-        // because state_prev may be stale if multiple changes occurred today
-        if (p->virus)
-            db.update_virus(
-                p->virus->get_id(), p->state, a.new_state
-            );
+    ~AgentsSample();
 
-        for (size_t i = 0u; i < p->tools.size(); ++i)
-            db.update_tool(
-                p->tools[i]->get_id(),
-                p->state,
-                a.new_state
-            );
+    typename std::vector< Agent<TSeq> * >::iterator begin();
+    typename std::vector< Agent<TSeq> * >::iterator end();
 
-    }
+    Agent<TSeq> * operator[](size_t n);
+    Agent<TSeq> * operator()(size_t n);
+    size_t size() const noexcept;
 
-}
+};
 
 template<typename TSeq>
-inline void Model<TSeq>::_event_add_entity(Event<TSeq> & a)
-{
+inline AgentsSample<TSeq>::AgentsSample(
+    Model<TSeq> & model_,
+    size_t n,
+    std::vector< size_t > states_,
+    bool truncate
+    ) {
 
-    Agent<TSeq> *  p = a.agent;
-    Entity<TSeq> * e = a.entity;
+    states = states_;
 
-    // Checking the agent and the entity are not linked
-    if ((p->get_n_entities() > 0) && (e->size() > 0))
+    if (truncate)
     {
+        
+        if (n > model_.size())
+            n = model_.size();
 
-        if (p->get_n_entities() > e->size()) // Slower search through the agent
-        {
-            for (size_t agent_id : e->get_agents())
-                if(static_cast<int>(agent_id) == p->get_id())
-                    throw std::logic_error("An entity cannot be reassigned to an agent.");
-        }
-        else                                 // Slower search through the entity
-        {
-            for (size_t entity_id : p->get_entities())
-                if(static_cast<int>(entity_id) == e->get_id())
-                    throw std::logic_error("An entity cannot be reassigned to an agent.");
-        }
-
-        // It means that agent and entity were not associated.
-    }
-
-    // Adding the to agent and the entity
-    p->entities.push_back(static_cast<size_t>(e->get_id()));
-    e->agents.push_back(static_cast<size_t>(p->get_id()));
-
-}
-
-template<typename TSeq>
-inline void Model<TSeq>::_event_rm_entity(Event<TSeq> & a)
-{
+    } else if (n > model_.size())
+        throw std::logic_error(
+            "There are only " + std::to_string(model_.size()) + " agents. You cannot " +
+            "sample " + std::to_string(n));
 
-    Agent<TSeq> &  p = *a.agent;
-    Entity<TSeq> & e = *a.entity;
+    sample_size   = n;
+    model         = &model_;
+    sample_type   = SAMPLETYPE::MODEL;
 
-    // Remove entity from agent's entity list
-    p.entities.erase(
-        std::remove(
-            p.entities.begin(),
-            p.entities.end(),
-            static_cast<size_t>(e.get_id())
-        ),
-        p.entities.end()
-    );
+    agents        = &model_.sampled_population;
+    agents_n      = &model_.sampled_population_n;
 
-    // Remove agent from entity's agent list
-    e.agents.erase(
-        std::remove(
-            e.agents.begin(),
-            e.agents.end(),
-            static_cast<size_t>(p.get_id())
-        ),
-        e.agents.end()
-    );
+    agents_left   = &model_.population_left;
+    agents_left_n = &model_.population_left_n;
 
-    return;
+    sample_n(n);
+    
+    return; 
 
 }
 
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+template<typename TSeq>
+inline AgentsSample<TSeq>::AgentsSample(
+    Model<TSeq> * model,
+    Entity<TSeq> & entity_,
+    size_t n,
+    std::vector< size_t > states_,
+    bool truncate
+    ) {
 
- End of -include/epiworld/agent-events-meat.hpp-
+    states = states_;
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    if (truncate)
+    {
 
+        if (n > entity_.size())
+            n = entity_.size();
 
+    } else if (n > entity_.size())
+        throw std::logic_error(
+            "There are only " + std::to_string(entity_.size()) + " agents. You cannot " +
+            "sample " + std::to_string(n));
 
-template<typename TSeq>
-inline Agent<TSeq>::Agent(Agent<TSeq> && p) :
-    neighbors(std::move(p.neighbors)),
-    neighbors_locations(std::move(p.neighbors_locations)),
-    n_neighbors(p.n_neighbors),
-    entities(std::move(p.entities)),
-    state(p.state),
-    state_prev(p.state_prev), 
-    state_last_changed(p.state_last_changed),
-    id(p.id),
-    tools(std::move(p.tools)) /// Needs to be adjusted
-{
+    sample_size   = n;
+    model         = &entity_.model;
+    sample_type   = SAMPLETYPE::ENTITY;
 
-    state = p.state;
-    id     = p.id;
-    
-    // Dealing with the virus
-    if (p.virus != nullptr)
-    {
-        virus = std::move(p.virus);
-        virus->set_agent(this);
-    }
+    agents        = &entity_.sampled_agents;
+    agents_n      = &entity_.sampled_agents_n;
 
-    int loc = 0;
-    for (auto & t : tools)
-    {
-        
-        // Will create a copy of the virus, with the exeption of
-        // the virus code
-        t->agent     = this;
-        t->pos_in_agent = loc++;
+    agents_left   = &entity_.sampled_agents_left;
+    agents_left_n = &entity_.sampled_agents_left_n;
+
+    sample_n(n);
+
+    return; 
 
-    }
-    
 }
 
-// Copy constructor
+/**
+ * @brief Sample from the agent's entities
+ * 
+ * For example, how many individuals the agent contacts in a given point in time.
+ * 
+ * @tparam TSeq 
+ * @param agent_ 
+ * @param n Sample size
+ * @param truncate If the agent has fewer than `n` connections, then truncate = true
+ * will automatically reduce the number of possible samples. Otherwise, if false, then
+ * it returns an error.
+ */
 template<typename TSeq>
-inline Agent<TSeq>::Agent(const Agent<TSeq> & p) :
-    neighbors(nullptr),
-    neighbors_locations(nullptr),
-    n_neighbors(p.n_neighbors),
-    entities(p.entities)
+inline AgentsSample<TSeq>::AgentsSample(
+    Model<TSeq> * model,
+    Agent<TSeq> & agent_,
+    size_t n,
+    std::vector< size_t > states_,
+    bool truncate
+    )
 {
 
-    if (n_neighbors > 0u)
-    {
-        neighbors = new std::vector< size_t >(*p.neighbors);
-        neighbors_locations = new std::vector< size_t >(*p.neighbors_locations);
-    }
-
-    state = p.state;
-    id     = p.id;
-    
-    // Dealing with the virus
-    if (p.virus != nullptr)
-    {
-        virus = std::shared_ptr<Virus<TSeq>>(p.virus->clone_ptr());
-        virus->set_agent(this);
-    }
+    states = states_;
+    sample_type = SAMPLETYPE::AGENT;
     
+    agent         = &agent_;
 
-    tools.clear();
-    tools.reserve(p.get_n_tools());
-    for (size_t i = 0u; i < p.get_n_tools(); ++i)
-    {
-        tools.emplace_back(std::shared_ptr<Tool<TSeq>>(p.tools[i]->clone_ptr()));
-        tools.back()->set_agent(this, i);
-
-    }
-    
-}
+    agents        = &agent_.sampled_agents;
+    agents_n      = &agent_.sampled_agents_n;
 
-template<typename TSeq>
-inline Agent<TSeq> & Agent<TSeq>::operator=(
-    const Agent<TSeq> & other_agent
-)
-{
+    // Computing the cumulative sum of counts across entities
+    size_t agents_in_entities = 0;
+    const auto & entities_a = agent->get_entities();
 
-    n_neighbors = other_agent.n_neighbors;
-    if (neighbors != nullptr)
+    std::vector< size_t > cum_agents_count(entities_a.size(), 0);
+    int idx = -1;
+    for (const Entity<TSeq> & e : entities_a)
     {
-        delete neighbors;
-        delete neighbors_locations;
-    }
+        if (++idx == 0)
+            cum_agents_count[idx] = (e.size() - 1u);
+        else
+            cum_agents_count[idx] = (
+                (e.size() - 1u) + 
+                cum_agents_count[idx - 1]
+            );
 
-    if (other_agent.n_neighbors > 0u)
-    {
-        neighbors = new std::vector< size_t >(*other_agent.neighbors);
-        neighbors_locations = new std::vector< size_t >(*other_agent.neighbors_locations);
-    }
-    else 
-    {
-        neighbors = nullptr;
-        neighbors_locations = nullptr;
+        agents_in_entities += (e.size() - 1u);
     }
-    
-    entities = other_agent.entities;
 
-    state              = other_agent.state;
-    state_prev         = other_agent.state_prev;
-    state_last_changed = other_agent.state_last_changed;
-    id                  = other_agent.id;
-    
-    if (other_agent.virus != nullptr)
-    {
-        virus = std::shared_ptr<Virus<TSeq>>(other_agent.virus->clone_ptr());
-        virus->set_agent(this);
-    } else
-        virus = nullptr;
-    
-    
-    tools.clear();
-    tools.reserve(other_agent.get_n_tools());
-    for (size_t i = 0u; i < other_agent.get_n_tools(); ++i)
+    if (truncate)
     {
-        tools.emplace_back(std::shared_ptr<Tool<TSeq>>(other_agent.tools[i]->clone_ptr()));
-        tools.back()->set_agent(this, i);
-    }
-    
-    return *this;
-    
-}
+        
+        if (n > agents_in_entities)
+            n = agents_in_entities;
 
-template<typename TSeq>
-inline Agent<TSeq>::~Agent()
-{
+    } else if (n > agents_in_entities)
+        throw std::logic_error(
+            "There are only " + std::to_string(agents_in_entities) +
+            " agents. You cannot " +
+            "sample " + std::to_string(n)
+            );
+
+    sample_size = n;
+
+    if (agents->size() < n)
+        agents->resize(n);
 
-    if (neighbors != nullptr)
+    size_t i_obs = 0u;
+    for (size_t i = 0u; i < sample_size; ++i)
     {
-        delete neighbors;
-        delete neighbors_locations;
-    }
 
-}
+        // Sampling a single agent from the set of entities
+        int jth = model->runif_index(agents_in_entities);
+        for (size_t e = 0u; e < cum_agents_count.size(); ++e)
+        {
+            
+            // Are we in the limit?
+            if (jth <= cum_agents_count[e])
+            {
+                size_t agent_idx = 0u;
+                if (e == 0) // From the first group
+                    agent_idx = entities_a[e][jth]->get_id();
+                else
+                    agent_idx = entities_a[e][jth - cum_agents_count[e - 1]]->get_id();
 
-template<typename TSeq>
-inline void Agent<TSeq>::add_tool(
-    Model<TSeq> & model,
-    const Tool<TSeq> & tool,
-    epiworld_fast_int state_new,
-    epiworld_fast_int queue
-) {
 
-    // Checking the tool exists
-    if (tool.get_id() >= static_cast<int>(model.get_db().get_n_tools()))
-        throw std::range_error("The tool with id: " + std::to_string(tool.get_id()) +
-            " has not been registered. There are only " + std::to_string(model.get_n_tools()) +
-            " included in the model.");
+                // Checking if states was specified
+                if (states.size())
+                {
 
-    ToolPtr<TSeq> tool_ptr = std::shared_ptr<Tool<TSeq>>(tool.clone_ptr());
+                    // Getting the state
+                    size_t state = model->agents_state[agent_idx];
 
-    model._add_event(
-        this, nullptr, tool_ptr, nullptr, state_new, queue, EventAction::AddTool
-        );
+                    if (std::find(states.begin(), states.end(), state) != states.end())
+                        continue;
 
-}
+                }
+                
+                agents->operator[](i_obs++) = &(model->population[agent_idx]);
 
-template<typename TSeq>
-inline void Agent<TSeq>::set_virus(
-    Model<TSeq> & model,
-    const Virus<TSeq> & virus,
-    epiworld_fast_int state_new,
-    epiworld_fast_int queue
-)
-{
-    
-        // Checking the virus exists
-    if (virus.get_id() >= static_cast<int>(model.get_db().get_n_viruses()))
-        throw std::range_error("The virus with id: " + std::to_string(virus.get_id()) +
-            " has not been registered. There are only " + std::to_string(model.get_n_viruses()) +
-            " included in the model.");
+                break;
+            }
 
-    if (state_new == -99)
-        virus.get_state(&state_new, nullptr, nullptr);
+        }
+    }
 
-    if (queue == -99)
-        virus.get_queue(&queue, nullptr, nullptr);
+    return; 
 
-    VirusPtr<TSeq> virus_ptr = std::shared_ptr<Virus<TSeq>>(virus.clone_ptr());
+}
 
-    model._add_event(
-        this, virus_ptr, nullptr, nullptr, state_new, queue, EventAction::AddVirus
-        );
+template<typename TSeq>
+inline AgentsSample<TSeq>::~AgentsSample() {}
 
+template<typename TSeq>
+inline size_t AgentsSample<TSeq>::size() const noexcept
+{ 
+    return this->sample_size;
 }
 
 template<typename TSeq>
-inline void Agent<TSeq>::add_entity(
-    Model<TSeq> & model,
-    Entity<TSeq> & entity,
-    epiworld_fast_int state_new,
-    epiworld_fast_int queue
-)
+inline Agent<TSeq> * AgentsSample<TSeq>::operator[](size_t i)
 {
 
-    model._add_event(
-        this, nullptr, nullptr, &entity, state_new, queue, EventAction::AddEntity
-    );
+    return agents->operator[](i);
 
 }
 
 template<typename TSeq>
-inline void Agent<TSeq>::rm_tool(
-    Model<TSeq> & model,
-    epiworld_fast_uint tool_idx,
-    epiworld_fast_int state_new,
-    epiworld_fast_int queue
-)
+inline Agent<TSeq> * AgentsSample<TSeq>::operator()(size_t i)
 {
 
-    if (tool_idx >= tools.size())
-        throw std::range_error(
-            "The Tool you want to remove is out of range. This Agent only has " +
-            std::to_string(tools.size()) + " tools."
-        );
+    if (i >= this->sample_size)
+        throw std::range_error("The requested agent is out of range.");
 
-    model._add_event(
-        this, nullptr, tools[tool_idx], nullptr, state_new, queue, EventAction::RemoveTool
-        );
+    return agents->operator[](i);
 
 }
 
 template<typename TSeq>
-inline void Agent<TSeq>::rm_tool(
-    Model<TSeq> & model,
-    ToolPtr<TSeq> & tool,
-    epiworld_fast_int state_new,
-    epiworld_fast_int queue
-)
+inline typename std::vector< Agent<TSeq> * >::iterator AgentsSample<TSeq>::begin()
 {
+    // Check for null pointer
+    if (agents == nullptr)
+        return typename std::vector< Agent<TSeq> * >::iterator{};
+    
+    return agents->begin();
+}
 
-    if (tool->agent != this)
-        throw std::logic_error("Cannot remove a virus from another agent!");
-
-    model._add_event(
-        this, nullptr, tool, nullptr, state_new, queue, EventAction::RemoveTool
-        );
-
+template<typename TSeq>
+inline typename std::vector< Agent<TSeq> * >::iterator AgentsSample<TSeq>::end()
+{
+    // Check for null pointer
+    if (agents == nullptr)
+        return typename std::vector< Agent<TSeq> * >::iterator{};
+    
+    // Ensure we don't go beyond the actual vector size
+    size_t actual_end = std::min(sample_size, agents->size());
+    return agents->begin() + actual_end;
 }
 
 template<typename TSeq>
-inline void Agent<TSeq>::rm_virus(
-    Model<TSeq> & model,
-    epiworld_fast_int state_new,
-    epiworld_fast_int queue
-)
+inline void AgentsSample<TSeq>::sample_n(size_t n)
 {
 
-    if (virus == nullptr)
-        throw std::logic_error(
-            "There is no virus to remove here!"
-        );
+    // Reducing size
+    if (states.size())
+    {
+            
+        // Getting the number of agents left
+        agents_left->clear();
 
-    if (state_new == -99)
-        virus->get_state(nullptr, &state_new, nullptr);
+        if (sample_type == SAMPLETYPE::MODEL)
+        {
 
-    if (queue == -99)
-        virus->get_queue(nullptr, &queue, nullptr);
+            // Making some room
+            agents_left->reserve(model->size());
 
-    model._add_event(
-        this, virus, nullptr, nullptr,
-        state_new,
-        queue,
-        EventAction::RemoveVirus
-        );
+            // Flagging the selected states, so the scan over the agents'
+            // states (contiguous) doesn't search `states` for each agent
+            std::vector< unsigned char > selected(
+                *std::max_element(states.begin(), states.end()) + 1u, 0u
+            );
+            for (auto s : states)
+                selected[s] = 1u;
 
-}
+            const auto & agents_state = model->agents_state;
+            for (size_t a_i = 0u; a_i < agents_state.size(); ++a_i)
+            {
 
-template<typename TSeq>
-inline void Agent<TSeq>::rm_entity(
-    Model<TSeq> & model,
-    epiworld_fast_uint entity_idx,
-    epiworld_fast_int state_new,
-    epiworld_fast_int queue
-)
-{
+                // If the agent is within the selected set of states,
+                // then we add it to the list of agents left
+                size_t s = agents_state[a_i];
+                if ((s < selected.size()) && selected[s])
+                    agents_left->push_back(a_i);
 
-    if (entity_idx >= entities.size())
-        throw std::range_error(
-            "The Entity you want to remove is out of range. This Agent only has " +
-            std::to_string(entities.size()) + " entity(ies)."
-        );
-    else if (entities.size() == 0u)
-        throw std::logic_error(
-            "There is no entity to remove here!"
-        );
+            }
 
-    model._add_event(
-        this,
-        nullptr,
-        nullptr,
-        &model.get_entity(entities[entity_idx]),
-        state_new,
-        queue,
-        EventAction::RemoveEntity
-    );
-}
+        } 
+        else if (sample_type == SAMPLETYPE::ENTITY)
+        {
 
-template<typename TSeq>
-inline void Agent<TSeq>::rm_entity(
-    Model<TSeq> & model,
-    Entity<TSeq> & entity,
-    epiworld_fast_int state_new,
-    epiworld_fast_int queue
-)
-{
+            // Making room
+            agents_left->reserve(entity->size());
 
-    // Looking for entity location in the agent
-    bool found = std::find(
-        entities.begin(), entities.end(),
-        static_cast<size_t>(entity.get_id())
-    ) != entities.end();
+            // Iterating through the agents in the entity
+            for (size_t a_i = 0u; a_i < entity->size(); ++a_i)
+            {
+                size_t s = model->agents_state[entity->agents[a_i]];
+                if (std::find(states.begin(), states.end(), s) != states.end())
+                    agents_left->push_back(a_i);
 
-    if (!found)
-        throw std::logic_error(
-            std::string("The agent ") +
-            std::to_string(id) +
-            std::string(" is not associated with entity \"") +
-            entity.get_name() +
-            std::string("\".")
-            );
+            }
 
-    model._add_event(
-        this,
-        nullptr,
-        nullptr,
-        &model.get_entity(entity.get_id()),
-        state_new,
-        queue,
-        EventAction::RemoveEntity
-    );
-}
+        }
 
-template<typename TSeq>
-inline epiworld_double Agent<TSeq>::get_susceptibility_reduction(
-    VirusPtr<TSeq> & v,
-    Model<TSeq> & model
-) {
+    } else {
 
-    return model.susceptibility_reduction_mixer(this, v);
-}
+        // Checking if the size of the entity has changed (or hasn't been initialized)
+        if (sample_type == SAMPLETYPE::MODEL)
+        {
 
-template<typename TSeq>
-inline epiworld_double Agent<TSeq>::get_transmission_reduction(
-    VirusPtr<TSeq> & v,
-    Model<TSeq> & model
-) {
-    return model.transmission_reduction_mixer(this, v);
-}
+            if (model->size() != agents_left->size())
+            {
+                agents_left->resize(model->size(), 0u);
+                std::iota(agents_left->begin(), agents_left->end(), 0u);
+            }
 
-template<typename TSeq>
-inline epiworld_double Agent<TSeq>::get_recovery_enhancer(
-    VirusPtr<TSeq> & v,
-    Model<TSeq> & model
-) {
-    return model.recovery_enhancer_mixer(this, v);
-}
+        } else if (sample_type == SAMPLETYPE::ENTITY) {
 
-template<typename TSeq>
-inline epiworld_double Agent<TSeq>::get_death_reduction(
-    VirusPtr<TSeq> & v,
-    Model<TSeq> & model
-) {
-    return model.death_reduction_mixer(this, v);
-}
+            if (entity->size() != agents_left->size())
+            {
 
-template<typename TSeq>
-inline int Agent<TSeq>::get_id() const
-{
-    return id;
-}
+                agents_left->resize(entity->size(), 0u);
+                std::iota(agents_left->begin(), agents_left->end(), 0u);
 
-template<typename TSeq>
-inline VirusPtr<TSeq> & Agent<TSeq>::get_virus() {
-    return virus;
-}
+            }
 
-template<typename TSeq>
-inline const VirusPtr<TSeq> & Agent<TSeq>::get_virus() const {
-    return virus;
-}
+        } 
+
+    }
+
+    // Restart the counter of agents left
+    *agents_left_n = agents_left->size();
+
+    // Making sure we have enough room for the sample of agents
+    if (agents->size() < sample_size)
+        agents->resize(sample_size, nullptr);
+
+    if (sample_type == SAMPLETYPE::MODEL)
+    {
+
+        #ifdef EPI_DEBUG
+        std::vector< bool > __sampled(model->size(), true);
+        for (auto & a_i: *agents_left)
+            __sampled[a_i] = false;
+        #endif
+
+        for (size_t i = 0u; i < n; ++i)
+        {
+
+            // Sampling from 0 to (agents_left_n - 1)
+            size_t ith_ = static_cast<size_t>(model->runif() * ((*agents_left_n)--));
+            
+            // Getting the id of the agent and adding it to the list of agents
+            size_t ith  = agents_left->operator[](ith_);
+            agents->operator[](i) = &model->population[ith];
 
+            #ifdef EPI_DEBUG
+            if (__sampled[ith])
+                throw std::logic_error("The same agent was sampled twice.");
+            else
+                __sampled[ith] = true;
+            #endif
 
-template<typename TSeq>
-inline std::vector< ToolPtr<TSeq> > Agent<TSeq>::get_tools() {
-    return tools;
-}
+            // Updating list
+            std::swap(
+                agents_left->operator[](ith_),
+                agents_left->operator[](*agents_left_n)
+                );
 
-template<typename TSeq>
-inline const std::vector< ToolPtr<TSeq> > Agent<TSeq>::get_tools() const {
-    return tools;
-}
+        }
 
-template<typename TSeq>
-inline ToolPtr<TSeq> & Agent<TSeq>::get_tool(int i)
-{
-    return tools.at(i);
-}
 
-template<typename TSeq>
-inline ToolPtr<TSeq> & Agent<TSeq>::get_tool(std::string name)
-{
-    for (auto & tool : tools)
-        if (tool->get_name() == name)
-            return tool;
+    }
+    else if (sample_type == SAMPLETYPE::ENTITY)
+    {
 
-    throw std::logic_error(
-        "The agent does not have a tool with name: " + name
-    );
+        #ifdef EPI_DEBUG
+        std::vector< bool > __sampled(entity->size(), true);
+        for (auto & a_i: *agents_left)
+            __sampled[a_i] = false;
+        #endif
 
-}
+        for (size_t i = 0u; i < n; ++i)
+        {
 
-template<typename TSeq>
-inline size_t Agent<TSeq>::get_n_tools() const noexcept
-{
-    return tools.size();
-}
+            size_t ith_ = static_cast<size_t>(
+                model->runif() * ((*agents_left_n)--)
+            );
 
-template<typename TSeq>
-inline void Agent<TSeq>::mutate_virus()
-{
+            size_t ith  = agents_left->operator[](ith_);
+            agents->operator[](i) = &model->population[entity->agents[ith]];
 
-    virus->mutate();
+            #ifdef EPI_DEBUG
+            if (__sampled[ith])
+                throw std::logic_error("The same agent was sampled twice.");
+            else
+                __sampled[ith] = true;
+            #endif
 
-}
+            // Updating list
+            std::swap(agents_left->operator[](ith_), agents_left->operator[](*agents_left_n));
 
-template<typename TSeq>
-inline void Agent<TSeq>::add_neighbor(
-    Agent<TSeq> & p,
-    bool check_source,
-    bool check_target
-) {
-    // Can we find the neighbor?
-    bool found = false;
+        }
 
-    if (neighbors == nullptr)
-    {
-        neighbors = new std::vector< size_t >();
-        neighbors_locations = new std::vector< size_t >();
     }
 
-    if (check_source && neighbors)
-    {
+    return;
 
-        for (auto & n: *neighbors)    
-            if (static_cast<int>(n) == p.get_id())
-            {
-                found = true;
-                break;
-            }
+}
 
-    }
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    // Three things going on here:
-    // - Where in the neighbor will this be
-    // - What is the neighbor's id
-    // - Increasing the number of neighbors
-    if (!found)
-    {
+ End of -./include/epiworld/agentssample-bones.hpp-
 
-        neighbors_locations->push_back(p.get_n_neighbors());
-        neighbors->push_back(p.get_id());
-        n_neighbors++;
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    }
 
 
-    found = false;
-    if (check_target && p.neighbors)
-    {
-       
-        for (auto & n: *p.neighbors)
-            if (static_cast<int>(n) == id)
-            {
-                found = true;
-                break;
-            }
-    
-    }
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    if (!found)
-    {
+ Start of -./include/epiworld/model-meat-continuous.hpp-
 
-        if (p.neighbors == nullptr)
-        {
-            p.neighbors = new std::vector< size_t >();
-            p.neighbors_locations = new std::vector< size_t >();
-        }
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-        p.neighbors_locations->push_back(n_neighbors - 1);
-        p.neighbors->push_back(id);
-        p.n_neighbors++;
-        
-    }
-    
 
-}
+#ifndef EPIWORLD_MODEL_MEAT_CONTINUOUS_HPP
+#define EPIWORLD_MODEL_MEAT_CONTINUOUS_HPP
+
+// (already included include/epiworld/model-bones.hpp)
+// (already included include/epiworld/indexedheap-bones.hpp)
 
 template<typename TSeq>
-inline void Agent<TSeq>::swap_neighbors(
-    Agent<TSeq> & other,
-    size_t n_this,
-    size_t n_other,
-    Model<TSeq> & model
+inline Model<TSeq> & Model<TSeq>::run_continuous(
+    epiworld_fast_uint ndays,
+    int seed
 )
 {
 
-    if (n_this >= n_neighbors)
-        throw std::range_error(
-            "The neighbor you want to swap is out of range. This Agent only has " +
-            std::to_string(n_neighbors) + " neighbors."
-        );
-    if (n_other >= other.n_neighbors)
-        throw std::range_error(
-            "The neighbor you want to swap is out of range. This Agent only has " +
-            std::to_string(other.n_neighbors) + " neighbors."
-        );
-
-    // Getting the agents
-    auto & pop = model.population;
-    auto & neigh_this  = pop[(*neighbors)[n_this]];
-    auto & neigh_other = pop[(*other.neighbors)[n_other]];
-
-    // Getting the locations in the neighbors
-    size_t loc_this_in_neigh = (*neighbors_locations)[n_this];
-    size_t loc_other_in_neigh = (*other.neighbors_locations)[n_other];
-
-    // Changing ids
-    std::swap((*neighbors)[n_this], (*other.neighbors)[n_other]);
+    // Classifying the states by their update function
+    static constexpr char absorbing   = 0;
+    static constexpr char susceptible = 1;
+    static constexpr char infected    = 2;
 
-    if (!model.directed)
+    std::vector< char > kind(nstates, absorbing);
+    for (epiworld_fast_uint s = 0u; s < nstates; ++s)
     {
-        std::swap(
-            (*neigh_this.neighbors)[loc_this_in_neigh],
-            (*neigh_other.neighbors)[loc_other_in_neigh]
-            );
 
-        // Changing the locations
-        std::swap((*neighbors_locations)[n_this], (*other.neighbors_locations)[n_other]);
-        
-        std::swap(
-            (*neigh_this.neighbors_locations)[loc_this_in_neigh],
-            (*neigh_other.neighbors_locations)[loc_other_in_neigh]
+        if (state_fun_is(s, nullptr))
+            continue;
+        else if (state_fun_is(s, default_update_susceptible<TSeq>))
+            kind[s] = susceptible;
+        else if (state_fun_is(s, default_update_exposed<TSeq>))
+            kind[s] = infected;
+        else
+            throw std::logic_error(
+                "The state \"" + states_labels[s] + "\" has an update " +
+                "function that is not supported by -run_continuous()-. " +
+                "Only -default_update_susceptible- and " +
+                "-default_update_exposed- can be used."
             );
+
     }
 
-}
+    run_setup(ndays, seed);
 
-template<typename TSeq>
-inline std::vector< Agent<TSeq> *> Agent<TSeq>::get_neighbors(Model<TSeq> & model)
-{
-    std::vector< Agent<TSeq> * > res(n_neighbors, nullptr);
-    for (size_t i = 0u; i < n_neighbors; ++i)
-        res[i] = &model.population[(*neighbors)[i]];
-    return res;
-}
+    // Daily probabilities to rates. Certain events get a very large rate
+    // so they happen (almost) right away.
+    static constexpr epiworld_double rate_max = 1e9;
+    auto prob_to_rate = [](epiworld_double p) -> epiworld_double {
 
-template<typename TSeq>
-inline size_t Agent<TSeq>::get_n_neighbors() const
-{
-    return n_neighbors;
-}
+        if (p <= 0.0)
+            return 0.0;
 
-template<typename TSeq>
-inline void Agent<TSeq>::change_state(
-    Model<TSeq> & model,
-    epiworld_fast_uint new_state,
-    epiworld_fast_int queue
-    )
-{
+        if (p >= 1.0)
+            return rate_max;
 
-    model._add_event(
-        this, nullptr, nullptr, nullptr, new_state, queue,
-        EventAction::ChangeState
-    );
+        return -std::log1p(-p);
 
-    return;
+    };
 
-}
+    const size_t n = population.size();
+    std::vector< epiworld_double > rates(n, 0.0);
+    std::vector< epiworld_double > rates_death(n, 0.0);
+    IndexedMinHeap heap;
+    heap.reset(n);
 
-template<typename TSeq>
-inline unsigned int Agent<TSeq>::get_state() const {
-    return state;
-}
+    // Infection rate from neighbor -> p (zero if the neighbor has no virus)
+    auto infection_rate = [&](Agent<TSeq> & p, Agent<TSeq> & neighbor) -> epiworld_double {
 
-template<typename TSeq>
-inline unsigned int Agent<TSeq>::get_state_prev() const {
-    return state_prev;
-}
+        auto & v = neighbor.get_virus();
+        if (v == nullptr)
+            return 0.0;
 
-template<typename TSeq>
-inline int Agent<TSeq>::get_state_last_changed() const {
-    return state_last_changed;
-}
+        return prob_to_rate(
+            (1.0 - p.get_susceptibility_reduction(v, *this)) *
+            v->get_prob_infecting(this) *
+            (1.0 - neighbor.get_transmission_reduction(v, *this))
+        );
 
-template<typename TSeq>
-inline void Agent<TSeq>::reset()
-{
+    };
 
-    this->virus = nullptr;
+    // Total rate of the next event of the agent. For infected agents, the
+    // rate of death is stored in rates_death.
+    auto agent_rate = [&](Agent<TSeq> & p) -> epiworld_double {
 
-    this->tools.clear();
-    decltype(this->tools)().swap(this->tools);
+        char k = kind[p.get_state()];
+        if (k == susceptible)
+        {
 
-    this->entities.clear();
-    decltype(this->entities)().swap(this->entities);
+            if (p.get_virus() != nullptr)
+                return 0.0;
 
-    this->state = 0u;
-    this->state_prev = 0u;
+            epiworld_double a = 0.0;
+            for (auto & neighbor : p.neighbors(*this))
+                a += infection_rate(p, neighbor);
 
-    this->state_last_changed = -1;
-    
-}
+            return a;
 
-template<typename TSeq>
-inline bool Agent<TSeq>::has_tool(epiworld_fast_uint t) const
-{
+        }
+        else if (k == infected)
+        {
 
-    for (auto & tool : tools)
-        if (tool->get_id() == static_cast<int>(t))
-            return true;
+            auto & v = p.get_virus();
+            if (v == nullptr)
+                return 0.0;
 
-    return false;
+            epiworld_double a_death = prob_to_rate(
+                v->get_prob_death(this) * (1.0 - p.get_death_reduction(v, *this))
+            );
 
-}
+            epiworld_double a_recovery = prob_to_rate(
+                1.0 - (1.0 - v->get_prob_recovery(this)) *
+                    (1.0 - p.get_recovery_enhancer(v, *this))
+            );
 
-template<typename TSeq>
-inline bool Agent<TSeq>::has_tool(std::string_view name) const
-{
+            rates_death[p.get_id()] = a_death;
+            return a_death + a_recovery;
 
-    for (auto & tool : tools)
-        if (tool->get_name() == name)
-            return true;
+        }
 
-    return false;
+        return 0.0;
 
-}
+    };
 
-template<typename TSeq>
-inline bool Agent<TSeq>::has_tool(const Tool<TSeq> & tool) const
-{
+    // Gibson-Bruck update: pending events are rescaled to the new rate, so
+    // only agents whose event fired (or had none) draw a new time.
+    epiworld_double t = 0.0;
+    auto reschedule = [&](size_t i, bool fired) -> void {
 
-    return has_tool(tool.get_id());
+        epiworld_double a_old = rates[i];
+        epiworld_double a_new = agent_rate(population[i]);
+        rates[i] = a_new;
 
-}
+        if (a_new <= 0.0)
+            heap.update(i, std::numeric_limits< epiworld_double >::infinity());
+        else if (!fired && (a_old > 0.0))
+        {
+            if (a_old != a_new)
+                heap.update(i, t + (a_old / a_new) * (heap.key(i) - t));
+        }
+        else
+            heap.update(i, t + rexp(a_new));
 
-template<typename TSeq>
-inline bool Agent<TSeq>::has_virus(epiworld_fast_uint t) const
-{
-    if (virus->get_id() == static_cast<int>(t))
-        return true;
+    };
+
+    auto fire = [&](size_t i) -> void {
+
+        Agent<TSeq> & p = population[i];
+
+        if (kind[p.get_state()] == infected)
+        {
+
+            if (runif() * rates[i] < rates_death[i])
+            {
+                int rm_state = -1;
+                p.get_virus()->get_state(nullptr, nullptr, &rm_state);
+                p.rm_virus(*this, rm_state);
+            }
+            else
+                p.rm_virus(*this);
+
+        }
+        else
+        {
+
+            // Picking the neighbor who transmits
+            epiworld_double u = runif() * rates[i];
+            Agent<TSeq> * source = nullptr;
+            for (auto & neighbor : p.neighbors(*this))
+            {
 
-    return false;
-}
+                epiworld_double a = infection_rate(p, neighbor);
+                if (a <= 0.0)
+                    continue;
 
-template<typename TSeq>
-inline bool Agent<TSeq>::has_virus(std::string_view name) const
-{
-    
-    if (virus->get_name() == name)
-        return true;
+                source = &neighbor;
+                if ((u -= a) < 0.0)
+                    break;
 
-    return false;
+            }
 
-}
+            if (source != nullptr)
+                p.set_virus(*this, *source->get_virus());
 
-template<typename TSeq>
-inline bool Agent<TSeq>::has_virus(const Virus<TSeq> & virus) const
-{
+        }
 
-    return has_virus(virus.get_id());
+        events_run();
 
-}
+        reschedule(i, true);
 
-template<typename TSeq>
-inline bool Agent<TSeq>::has_entity(epiworld_fast_uint t) const
-{
+        const epiworld_agent_index * neighbors = network->neighbors(i);
+        for (size_t j = 0u; j < p.get_n_neighbors(); ++j)
+            reschedule(neighbors[j], false);
 
-    for (auto & entity_id : entities)
-        if (entity_id == static_cast<size_t>(t))
-            return true;
+    };
 
-    return false;
+    for (size_t i = 0u; i < n; ++i)
+        reschedule(i, true);
 
-}
+    bool refresh_daily = !globalevents.empty() || rewire_fun;
+    for (const auto & v : viruses)
+        if (v->strain->mutation)
+            refresh_daily = true;
 
-template<typename TSeq>
-inline bool Agent<TSeq>::has_entity(std::string_view name, const Model<TSeq> & model) const
-{
+    for (epiworld_fast_uint niter = 0; niter < get_ndays(); ++niter)
+    {
 
-    for (auto & entity_id : entities)
-        if (model.get_entity(entity_id).get_name() == name)
-            return true;
+        epiworld_double t_end = static_cast< epiworld_double >(niter + 1u);
+        while (heap.top_key() < t_end)
+        {
+            t = heap.top_key();
+            fire(heap.top());
+        }
 
-    return false;
+        t = t_end;
 
-}
+        this->run_globalevents();
+        this->rewire();
+        this->next();
+        this->mutate_virus();
 
-template<typename TSeq>
-inline void Agent<TSeq>::print(
-    Model<TSeq> & model,
-    bool compressed
-    ) const
-{
+        if (refresh_daily)
+            for (size_t i = 0u; i < n; ++i)
+                reschedule(i, false);
 
-    if (compressed)
-    {
-        printf_epiworld(
-            "Agent: %i, state: %s (%i), Has virus: %s, NTools: %ii NNeigh: %i\n",
-            static_cast<int>(id),
-            model.states_labels[state].c_str(),
-            static_cast<int>(state),
-            virus == nullptr ? std::string("no").c_str() : std::string("yes").c_str(),
-            static_cast<int>(tools.size()),
-            static_cast<int>(n_neighbors)
-        );
     }
-    else {
 
-        printf_epiworld("Information about agent id %i\n",
-            static_cast<int>(this->id));
-        printf_epiworld("  State        : %s (%i)\n",
-            model.states_labels[state].c_str(), static_cast<int>(state));
-        printf_epiworld("  Has virus    : %s\n", virus == nullptr ?
-            std::string("no").c_str() : std::string("yes").c_str());
-        printf_epiworld("  Tool count   : %i\n", static_cast<int>(tools.size()));
-        printf_epiworld("  Neigh. count : %i\n", static_cast<int>(n_neighbors));
+    // The last reaches the end...
+    this->current_date--;
 
-        size_t nfeats = model.get_agents_data_ncols();
-        if (nfeats > 0)
-        {
+    chrono_end();
 
-            printf_epiworld(
-                "This model includes features (%i): [ ",
-                static_cast<int>(nfeats)
-                );
+    sim_id++;
 
-            int max_to_show = static_cast<int>((nfeats > 10)? 10 : nfeats);
+    return *this;
 
-            for (int k = 0; k < max_to_show; ++k)
-            {
-                printf_epiworld("%.2f", this->operator()(k, model));
+}
 
-                if (k != (max_to_show - 1))
-                {
-                    printf_epiworld(", ");
-                } else {
-                    printf_epiworld(" ]\n");
-                }
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-            }
-            
-        }
+ End of -./include/epiworld/model-meat-continuous.hpp-
 
-    }
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    return;
 
-}
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-template<typename TSeq>
-inline double & Agent<TSeq>::operator()(size_t j, Model<TSeq> & model)
-{
+ Start of -./include/epiworld/model-meat-checkpoint.hpp-
 
-    if (model.agents_data_ncols <= j)
-        throw std::logic_error("The requested feature of the agent is out of range.");
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-    return *(model.agents_data + j * model.size() + id);
 
-}
+#ifndef EPIWORLD_MODEL_MEAT_CHECKPOINT_HPP
+#define EPIWORLD_MODEL_MEAT_CHECKPOINT_HPP
 
-template<typename TSeq>
-inline double Agent<TSeq>::operator()(size_t j, const Model<TSeq> & model) const
+// (already included include/epiworld/model-bones.hpp)
+
+/**
+ * @name Binary (de)serialization used by checkpoints
+ * @details Values are written in native byte order. Vectors of trivially
+ * copyable types are written as a size followed by a single block, so
+ * large arrays (e.g., the network and the history) are read with one
+ * call. All overloads are declared first so they can call each other.
+ */
+///@{
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const T & x);
+inline void checkpoint_write(std::ostream & out, const std::string & x);
+inline void checkpoint_write(std::ostream & out, const std::vector< bool > & x);
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const std::vector< T > & x);
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const std::shared_ptr< T > & x);
+template<typename K, typename V, typename... R>
+inline void checkpoint_write(std::ostream & out, const std::map< K, V, R... > & x);
+
+template<typename T>
+inline void checkpoint_read(std::istream & in, T & x);
+inline void checkpoint_read(std::istream & in, std::string & x);
+inline void checkpoint_read(std::istream & in, std::vector< bool > & x);
+template<typename T>
+inline void checkpoint_read(std::istream & in, std::vector< T > & x);
+template<typename T>
+inline void checkpoint_read(std::istream & in, std::shared_ptr< T > & x);
+template<typename K, typename V, typename... R>
+inline void checkpoint_read(std::istream & in, std::map< K, V, R... > & x);
+
+/** @brief Reads a size, checking the stream first (so garbage is not allocated). */
+inline size_t checkpoint_read_size(std::istream & in)
 {
 
-    if (model.agents_data_ncols <= j)
-        throw std::logic_error("The requested feature of the agent is out of range.");
+    uint64_t n = 0u;
+    in.read(reinterpret_cast< char * >(&n), sizeof(n));
 
-    return *(model.agents_data + j * model.size() + id);
+    if (!in)
+        throw std::runtime_error("Error reading the checkpoint (truncated file).");
 
-}
+    return static_cast< size_t >(n);
 
-template<typename TSeq>
-inline const std::vector< size_t > & Agent<TSeq>::get_entities() const
-{
-    return entities;
 }
 
-template<typename TSeq>
-inline const Entity<TSeq> & Agent<TSeq>::get_entity(size_t i, const Model<TSeq> & model) const
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const T & x)
 {
-    if (entities.size() == 0)
-        throw std::range_error("Agent id " + std::to_string(id) + " has no entities.");
-
-    if (i >= entities.size())
-        throw std::range_error("Trying to get to an agent's entity outside of the range.");
-
-    return model.get_entity(
-        #ifdef EPI_DEBUG
-        entities.at(i)
-        #else
-        entities[i]
-        #endif
+    static_assert(
+        std::is_trivially_copyable< T >::value,
+        "Only trivially copyable types can be written as is."
     );
+    out.write(reinterpret_cast< const char * >(&x), sizeof(T));
 }
 
-template<typename TSeq>
-inline Entity<TSeq> & Agent<TSeq>::get_entity(size_t i, Model<TSeq> & model)
+inline void checkpoint_write(std::ostream & out, const std::string & x)
 {
-    if (entities.size() == 0)
-        throw std::range_error("Agent id " + std::to_string(id) + " has no entities.");
-
-    if (i >= entities.size())
-        throw std::range_error("Trying to get to an agent's entity outside of the range.");
-
-    return model.get_entity(
-        #ifdef EPI_DEBUG
-        entities.at(i)
-        #else
-        entities[i]
-        #endif
-    );
+    checkpoint_write(out, static_cast< uint64_t >(x.size()));
+    out.write(x.data(), static_cast< std::streamsize >(x.size()));
 }
 
-template<typename TSeq>
-inline size_t Agent<TSeq>::get_n_entities() const
+inline void checkpoint_write(std::ostream & out, const std::vector< bool > & x)
 {
-    return entities.size();
+    checkpoint_write(out, static_cast< uint64_t >(x.size()));
+    for (bool b : x)
+        checkpoint_write(out, static_cast< unsigned char >(b));
 }
 
-template<typename TSeq>
-inline bool Agent<TSeq>::operator==(const Agent<TSeq> & other) const
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const std::vector< T > & x)
 {
 
-    // Checking the address
-    if (this == &other)
-        return true;
+    checkpoint_write(out, static_cast< uint64_t >(x.size()));
 
-    EPI_DEBUG_FAIL_AT_TRUE(
-        n_neighbors != other.n_neighbors,
-        "Agent:: n_eighbors don't match"
-        )
+    if constexpr (std::is_trivially_copyable< T >::value)
+        out.write(
+            reinterpret_cast< const char * >(x.data()),
+            static_cast< std::streamsize >(x.size() * sizeof(T))
+        );
+    else
+        for (const auto & x_i : x)
+            checkpoint_write(out, x_i);
 
-    
-    for (size_t i = 0u; i < n_neighbors; ++i)
-    {
-        EPI_DEBUG_FAIL_AT_TRUE(
-            (*neighbors)[i] != (*other.neighbors)[i],
-            "Agent:: neighbor[i] don't match"
-        )
-    }
-    
-    EPI_DEBUG_FAIL_AT_TRUE(
-        entities.size() != other.entities.size(),
-        "Agent:: n_entities don't match"
-        )
+}
 
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const std::shared_ptr< T > & x)
+{
+    checkpoint_write(out, static_cast< unsigned char >(x != nullptr));
+    if (x != nullptr)
+        checkpoint_write(out, *x);
+}
 
-    for (size_t i = 0u; i < entities.size(); ++i)
+template<typename K, typename V, typename... R>
+inline void checkpoint_write(std::ostream & out, const std::map< K, V, R... > & x)
+{
+    checkpoint_write(out, static_cast< uint64_t >(x.size()));
+    for (const auto & kv : x)
     {
-        EPI_DEBUG_FAIL_AT_TRUE(
-            entities[i] != other.entities[i],
-            "Agent:: entities[i] don't match"
-        )
+        checkpoint_write(out, kv.first);
+        checkpoint_write(out, kv.second);
     }
+}
 
-    EPI_DEBUG_FAIL_AT_TRUE(
-        state != other.state,
-        "Agent:: state don't match"
-        )
-        
-
-    EPI_DEBUG_FAIL_AT_TRUE(
-        state_prev != other.state_prev,
-        "Agent:: state_prev don't match"
-        )
-        
+template<typename T>
+inline void checkpoint_read(std::istream & in, T & x)
+{
+    static_assert(
+        std::is_trivially_copyable< T >::value,
+        "Only trivially copyable types can be read as is."
+    );
+    in.read(reinterpret_cast< char * >(&x), sizeof(T));
+}
 
-    // EPI_DEBUG_FAIL_AT_TRUE(
-    //     state_last_changed != other.state_last_changed,
-    //     "Agent:: state_last_changed don't match"
-    //     ) ///< Last time the agent was updated.
+inline void checkpoint_read(std::istream & in, std::string & x)
+{
+    x.resize(checkpoint_read_size(in));
+    in.read(&x[0], static_cast< std::streamsize >(x.size()));
+}
 
-    EPI_DEBUG_FAIL_AT_TRUE(
-        ((virus == nullptr) && (other.virus != nullptr)) ||
-            ((virus != nullptr) && (other.virus == nullptr)),
-        "Agent:: virus don't match"
-    )
+inline void checkpoint_read(std::istream & in, std::vector< bool > & x)
+{
 
-    if ((virus != nullptr) && (other.virus != nullptr))
+    x.resize(checkpoint_read_size(in));
+    for (size_t i = 0u; i < x.size(); ++i)
     {
-        EPI_DEBUG_FAIL_AT_TRUE(
-            *virus != *other.virus,
-            "Agent:: virus doesn't match"
-        )
+        unsigned char b = 0u;
+        checkpoint_read(in, b);
+        x[i] = (b != 0u);
     }
-    
-    EPI_DEBUG_FAIL_AT_TRUE(
-        tools.size() != other.tools.size(),
-        "Agent:: n_tools don't match"
-    )
 
-    for (size_t i = 0u; i < tools.size(); ++i)
-    {
-        
-        EPI_DEBUG_FAIL_AT_TRUE(
-            *tools[i] != *other.tools[i],
-            "Agent:: tools[i] don't match"
-        )
-         
-    }   
-    
-    return true;
-    
 }
 
-#endif
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-
- End of -./include/epiworld/agent-meat.hpp-
-
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+template<typename T>
+inline void checkpoint_read(std::istream & in, std::vector< T > & x)
+{
 
+    x.resize(checkpoint_read_size(in));
 
+    if constexpr (std::is_trivially_copyable< T >::value)
+        in.read(
+            reinterpret_cast< char * >(x.data()),
+            static_cast< std::streamsize >(x.size() * sizeof(T))
+        );
+    else
+        for (auto & x_i : x)
+            checkpoint_read(in, x_i);
 
-/*//////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+}
 
- Start of -./include/epiworld/agentssample-bones.hpp-
+template<typename T>
+inline void checkpoint_read(std::istream & in, std::shared_ptr< T > & x)
+{
 
-////////////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////////*/
+    unsigned char has_value = 0u;
+    checkpoint_read(in, has_value);
 
+    if (has_value == 0u)
+    {
+        x = nullptr;
+        return;
+    }
 
-#ifndef EPIWORLD_AGENTS_BONES_HPP
-#define EPIWORLD_AGENTS_BONES_HPP
+    T value;
+    checkpoint_read(in, value);
+    x = std::make_shared< T >(std::move(value));
 
-class SAMPLETYPE {
-public:
-    static const int MODEL  = 0;
-    static const int ENTITY = 1;
-    static const int AGENT  = 2;
-};
+}
 
-// template<typename TSeq>
-// class Agent;
+template<typename K, typename V, typename... R>
+inline void checkpoint_read(std::istream & in, std::map< K, V, R... > & x)
+{
 
-// template<typename TSeq>
-// class Model;
+    x.clear();
+    size_t n = checkpoint_read_size(in);
+    for (size_t i = 0u; i < n; ++i)
+    {
+        K key;
+        checkpoint_read(in, key);
+        checkpoint_read(in, x[key]);
+    }
 
-// template<typename TSeq>
-// class Entity;
+}
 
 /**
- * @brief Sample of agents
- * 
- * This class allows sampling agents from Entity<TSeq> and Model<TSeq>.
- * 
- * @tparam TSeq 
+ * @brief Writes a map from hashes to ids `0, ..., n - 1` (e.g.,
+ * `DataBase::virus_id`) as the hashes in id order
+ * @details Reading inserts the hashes in the same order in a new map, as
+ * the database did when it registered them, so iterating over the map
+ * (e.g., in `DataBase::record()`) visits the ids in the same order.
  */
-template<typename TSeq = EPI_DEFAULT_TSEQ>
-class AgentsSample {
-private:
+inline void checkpoint_write_ids(std::ostream & out, const MapVec_type<int,int> & x)
+{
 
-    size_t sample_size = 0u;
+    std::vector< std::vector< int > > keys(x.size());
+    for (const auto & kv : x)
+        keys.at(static_cast< size_t >(kv.second)) = kv.first;
 
-    std::vector< Agent<TSeq>* >* agents = nullptr; ///< Pointer to sample of agents
-    size_t * agents_n = nullptr;                    ///< Size of sample of agents
-    
-    std::vector< size_t >* agents_left = nullptr;  ///< Pointer to agents left (iota)
-    size_t * agents_left_n = nullptr;               ///< Size of agents left
+    checkpoint_write(out, keys);
 
-    Model<TSeq> * model   = nullptr;   ///< Extracts runif() and (if the case) population.
-    Entity<TSeq> * entity = nullptr; ///
-    Agent<TSeq> * agent   = nullptr;
-    
-    int sample_type = SAMPLETYPE::AGENT;
-    std::vector< size_t > states = {};
+}
 
-    void sample_n(size_t n); ///< Backbone function for sampling
+inline void checkpoint_read_ids(std::istream & in, MapVec_type<int,int> & x)
+{
 
+    std::vector< std::vector< int > > keys;
+    checkpoint_read(in, keys);
 
-public:
+    x = MapVec_type<int,int>();
+    for (size_t i = 0u; i < keys.size(); ++i)
+        x[keys[i]] = static_cast< int >(i);
 
-    // Not available (for now)
-    AgentsSample() = delete;                             ///< Default constructor
-    AgentsSample(const AgentsSample<TSeq> & a) = delete; ///< Copy constructor
-    AgentsSample(AgentsSample<TSeq> && a) = delete;      ///< Move constructor
+}
 
-    AgentsSample(
-        Model<TSeq> & model_, size_t n,
-        std::vector< size_t > states_ = {},
-        bool truncate = false
-        );
+/** @brief Writes the (textual) state of a random number distribution. */
+template<typename TDist>
+inline void checkpoint_write_dist(std::ostream & out, const TDist & dist)
+{
+    std::ostringstream ss;
+    ss << dist;
+    checkpoint_write(out, ss.str());
+}
 
-    AgentsSample(
-        Model<TSeq> * model,
-        Entity<TSeq> & entity_,
-        size_t n,
-        std::vector< size_t > states_ = {},
-        bool truncate = false
+template<typename TDist>
+inline void checkpoint_read_dist(std::istream & in, TDist & dist)
+{
+    std::string s;
+    checkpoint_read(in, s);
+    std::istringstream ss(s);
+    ss >> dist;
+}
+///@}
+
+#define EPI_CHECKPOINT_MAGIC   "EPIWCKPT"
+#define EPI_CHECKPOINT_VERSION 1u
+
+template<typename TSeq>
+inline void Model<TSeq>::write_checkpoint(std::string fn) const
+{
+
+    std::ofstream out(fn, std::ios_base::out | std::ios_base::binary);
+
+    if (!out)
+        throw std::runtime_error(
+            "Could not open file \"" + fn + "\" for writing."
         );
 
-    AgentsSample(
-        Model<TSeq> * model,
-        Agent<TSeq> & agent_,
-        size_t n,
-        std::vector< size_t > states_ = {},
-        bool truncate = false
+    write_checkpoint(out);
+
+    if (!out)
+        throw std::runtime_error(
+            "Error writing the checkpoint to \"" + fn + "\"."
         );
 
-    ~AgentsSample();
+}
 
-    typename std::vector< Agent<TSeq> * >::iterator begin();
-    typename std::vector< Agent<TSeq> * >::iterator end();
+template<typename TSeq>
+inline void Model<TSeq>::write_checkpoint(std::ostream & out) const
+{
+
+    // Header ------------------------------------------------------------------
+    out.write(EPI_CHECKPOINT_MAGIC, 8);
+    checkpoint_write(out, static_cast< uint32_t >(EPI_CHECKPOINT_VERSION));
+    checkpoint_write(out, std::vector< uint32_t >({
+        sizeof(size_t),
+        sizeof(epiworld_double),
+        sizeof(epiworld_fast_int),
+        sizeof(epiworld_fast_uint),
+        sizeof(epiworld_agent_index),
+        EPI_RUNIF_LANES
+    }));
+
+    // What the model must look like
+    checkpoint_write(out, std::vector< uint64_t >({
+        nstates,
+        population.size(),
+        viruses.size(),
+        tools.size(),
+        entities.size(),
+        globalevents.size()
+    }));
+
+    // Model -------------------------------------------------------------------
+    checkpoint_write(out, current_date);
+    checkpoint_write(out, ndays);
+    checkpoint_write(out, static_cast< uint64_t >(sim_id));
+    checkpoint_write(out, last_seed);
+    checkpoint_write(out, rng_seed);
+    checkpoint_write(out, parameters);
+
+    for (const auto & e : globalevents)
+        checkpoint_write(out, e->get_day());
+
+    // Random numbers
+    uint64_t engine_state[4u];
+    engine->get_state(engine_state);
+    for (auto s : engine_state)
+        checkpoint_write(out, s);
+
+    std::vector< uint64_t > engine_batch_state(4u * EPI_RUNIF_LANES);
+    engine_batch.get_state(engine_batch_state.data());
+    checkpoint_write(out, engine_batch_state);
+    checkpoint_write(out, runif_buffer);
+    checkpoint_write(out, static_cast< uint64_t >(runif_buffer_pos));
+
+    checkpoint_write(out, runifd_a);
+    checkpoint_write(out, runifd_b);
+    checkpoint_write(out, rbinomd_n);
+    checkpoint_write(out, rbinomd_fast_lambda);
+    checkpoint_write(out, rbinomd_use_poisson);
+    checkpoint_write_dist(out, rnormd);
+    checkpoint_write_dist(out, rgammad);
+    checkpoint_write_dist(out, rlognormald);
+    checkpoint_write_dist(out, rexpd);
+    checkpoint_write_dist(out, rbinomd);
+    checkpoint_write_dist(out, rnbinomd);
+    checkpoint_write_dist(out, rgeomd);
+    checkpoint_write_dist(out, rpoissd);
+
+    // Network and agents ------------------------------------------------------
+    checkpoint_write(out, network->offsets);
+    checkpoint_write(out, network->ids);
+    checkpoint_write(out, network->locations);
+
+    for (const auto & p : population)
+    {
+
+        checkpoint_write(out, p.state);
+        checkpoint_write(out, p.state_prev);
+        checkpoint_write(out, p.state_last_changed);
+        checkpoint_write(out, p.entities);
+
+        checkpoint_write(out, static_cast< unsigned char >(p.virus != nullptr));
+        if (p.virus != nullptr)
+        {
+            checkpoint_write(out, p.virus->id);
+            checkpoint_write(out, p.virus->date);
+            checkpoint_write(out, p.virus->baseline_sequence);
+        }
 
-    Agent<TSeq> * operator[](size_t n);
-    Agent<TSeq> * operator()(size_t n);
-    size_t size() const noexcept;
+        checkpoint_write(out, static_cast< uint64_t >(p.tools.size()));
+        for (const auto & t : p.tools)
+        {
+            checkpoint_write(out, t->id);
+            checkpoint_write(out, t->date);
+            checkpoint_write(out, t->sequence);
+        }
 
-};
+    }
 
-template<typename TSeq>
-inline AgentsSample<TSeq>::AgentsSample(
-    Model<TSeq> & model_,
-    size_t n,
-    std::vector< size_t > states_,
-    bool truncate
-    ) {
+    for (const auto & e : entities)
+        checkpoint_write(out, e.agents);
 
-    states = states_;
+    // Queue and contact tracing -----------------------------------------------
+    checkpoint_write(out, queue.active);
+    checkpoint_write(out, queue.n_in_queue);
+    checkpoint_write(out, queue.active_list);
+    checkpoint_write(out, queue.in_list);
 
-    if (truncate)
+    bool has_contact_tracing = use_contact_tracing && contact_tracing;
+    checkpoint_write(out, has_contact_tracing);
+    if (has_contact_tracing)
     {
-        
-        if (n > model_.size())
-            n = model_.size();
+        checkpoint_write(out, contact_tracing->contact_matrix);
+        checkpoint_write(out, contact_tracing->contacts_per_agent);
+        checkpoint_write(out, contact_tracing->contact_date);
+        checkpoint_write(out, static_cast< uint64_t >(contact_tracing->n_agents));
+        checkpoint_write(out, static_cast< uint64_t >(contact_tracing->max_contacts));
+    }
 
-    } else if (n > model_.size())
-        throw std::logic_error(
-            "There are only " + std::to_string(model_.size()) + " agents. You cannot " +
-            "sample " + std::to_string(n));
+    // Database ----------------------------------------------------------------
+    checkpoint_write_ids(out, db.virus_id);
+    checkpoint_write(out, db.virus_name);
+    checkpoint_write(out, db.virus_sequence);
+    checkpoint_write(out, db.virus_origin_date);
+    checkpoint_write(out, db.virus_parent_id);
 
-    sample_size   = n;
-    model         = &model_;
-    sample_type   = SAMPLETYPE::MODEL;
+    checkpoint_write_ids(out, db.tool_id);
+    checkpoint_write(out, db.tool_name);
+    checkpoint_write(out, db.tool_sequence);
+    checkpoint_write(out, db.tool_origin_date);
 
-    agents        = &model_.sampled_population;
-    agents_n      = &model_.sampled_population_n;
+    checkpoint_write(out, db.today_virus);
+    checkpoint_write(out, db.today_tool);
+    checkpoint_write(out, db.today_total);
+    checkpoint_write(out, db.today_total_nviruses_active);
+    checkpoint_write(out, db.sampling_freq);
 
-    agents_left   = &model_.population_left;
-    agents_left_n = &model_.population_left_n;
+    checkpoint_write(out, db.hist_virus_date);
+    checkpoint_write(out, db.hist_virus_id);
+    checkpoint_write(out, db.hist_virus_state);
+    checkpoint_write(out, db.hist_virus_counts);
 
-    sample_n(n);
-    
-    return; 
+    checkpoint_write(out, db.hist_tool_date);
+    checkpoint_write(out, db.hist_tool_id);
+    checkpoint_write(out, db.hist_tool_state);
+    checkpoint_write(out, db.hist_tool_counts);
 
-}
+    checkpoint_write(out, db.hist_total_date);
+    checkpoint_write(out, db.hist_total_nviruses_active);
+    checkpoint_write(out, db.hist_total_state);
+    checkpoint_write(out, db.hist_total_counts);
+    checkpoint_write(out, db.hist_transition_matrix);
 
-template<typename TSeq>
-inline AgentsSample<TSeq>::AgentsSample(
-    Model<TSeq> * model,
-    Entity<TSeq> & entity_,
-    size_t n,
-    std::vector< size_t > states_,
-    bool truncate
-    ) {
+    checkpoint_write(out, db.transmission_date);
+    checkpoint_write(out, db.transmission_source);
+    checkpoint_write(out, db.transmission_target);
+    checkpoint_write(out, db.transmission_virus);
+    checkpoint_write(out, db.transmission_source_exposure_date);
 
-    states = states_;
+    checkpoint_write(out, db.transition_matrix);
+    checkpoint_write(out, db.batch_transitions);
+    checkpoint_write(out, db.batch_dirty);
+    checkpoint_write(out, db.batch_counts);
 
-    if (truncate)
-    {
+    checkpoint_write(out, db.m_hospitalizations._date);
+    checkpoint_write(out, db.m_hospitalizations._virus_id);
+    checkpoint_write(out, db.m_hospitalizations._tool_id);
+    checkpoint_write(out, db.m_hospitalizations._weight);
 
-        if (n > entity_.size())
-            n = entity_.size();
+    checkpoint_write(out, db.user_data.data_names);
+    checkpoint_write(out, db.user_data.data_dates);
+    checkpoint_write(out, db.user_data.data_data);
+    checkpoint_write(out, db.user_data.k);
+    checkpoint_write(out, db.user_data.n);
+    checkpoint_write(out, db.user_data.last_day);
 
-    } else if (n > entity_.size())
-        throw std::logic_error(
-            "There are only " + std::to_string(entity_.size()) + " agents. You cannot " +
-            "sample " + std::to_string(n));
+    write_checkpoint_derived(out);
 
-    sample_size   = n;
-    model         = &entity_.model;
-    sample_type   = SAMPLETYPE::ENTITY;
+}
 
-    agents        = &entity_.sampled_agents;
-    agents_n      = &entity_.sampled_agents_n;
+template<typename TSeq>
+inline void Model<TSeq>::read_checkpoint(std::string fn)
+{
 
-    agents_left   = &entity_.sampled_agents_left;
-    agents_left_n = &entity_.sampled_agents_left_n;
+    std::ifstream in(fn, std::ios_base::in | std::ios_base::binary);
 
-    sample_n(n);
+    if (!in)
+        throw std::runtime_error(
+            "Could not open file \"" + fn + "\" for reading."
+        );
 
-    return; 
+    read_checkpoint(in);
 
 }
 
-/**
- * @brief Sample from the agent's entities
- * 
- * For example, how many individuals the agent contacts in a given point in time.
- * 
- * @tparam TSeq 
- * @param agent_ 
- * @param n Sample size
- * @param truncate If the agent has fewer than `n` connections, then truncate = true
- * will automatically reduce the number of possible samples. Otherwise, if false, then
- * it returns an error.
- */
 template<typename TSeq>
-inline AgentsSample<TSeq>::AgentsSample(
-    Model<TSeq> * model,
-    Agent<TSeq> & agent_,
-    size_t n,
-    std::vector< size_t > states_,
-    bool truncate
-    )
+inline void Model<TSeq>::read_checkpoint(std::istream & in)
 {
 
-    states = states_;
-    sample_type = SAMPLETYPE::AGENT;
-    
-    agent         = &agent_;
+    // Header ------------------------------------------------------------------
+    char magic[8u];
+    in.read(magic, 8);
+    if (!in || (std::string(magic, 8u) != EPI_CHECKPOINT_MAGIC))
+        throw std::runtime_error("The stream is not an epiworld checkpoint.");
 
-    agents        = &agent_.sampled_agents;
-    agents_n      = &agent_.sampled_agents_n;
+    uint32_t version = 0u;
+    checkpoint_read(in, version);
+    if (version != EPI_CHECKPOINT_VERSION)
+        throw std::runtime_error(
+            "Unsupported checkpoint version " + std::to_string(version) +
+            " (expected " + std::to_string(EPI_CHECKPOINT_VERSION) + ")."
+        );
 
-    // Computing the cumulative sum of counts across entities
-    size_t agents_in_entities = 0;
-    const auto & entities_a = agent->get_entities();
+    std::vector< uint32_t > layout;
+    checkpoint_read(in, layout);
+    if (layout != std::vector< uint32_t >({
+        sizeof(size_t),
+        sizeof(epiworld_double),
+        sizeof(epiworld_fast_int),
+        sizeof(epiworld_fast_uint),
+        sizeof(epiworld_agent_index),
+        EPI_RUNIF_LANES
+    }))
+        throw std::runtime_error(
+            "The checkpoint was written with different type sizes (or RNG lanes)."
+        );
 
-    std::vector< size_t > cum_agents_count(entities_a.size(), 0);
-    int idx = -1;
-    for (const Entity<TSeq> & e : entities_a)
-    {
-        if (++idx == 0)
-            cum_agents_count[idx] = (e.size() - 1u);
-        else
-            cum_agents_count[idx] = (
-                (e.size() - 1u) + 
-                cum_agents_count[idx - 1]
+    std::vector< uint64_t > dims;
+    checkpoint_read(in, dims);
+    std::vector< std::string > dims_names = {
+        "states", "agents", "viruses", "tools", "entities", "global events"
+    };
+    std::vector< uint64_t > dims_model = {
+        nstates,
+        population.size(),
+        viruses.size(),
+        tools.size(),
+        entities.size(),
+        globalevents.size()
+    };
+
+    for (size_t i = 0u; i < dims_model.size(); ++i)
+        if ((i >= dims.size()) || (dims[i] != dims_model[i]))
+            throw std::logic_error(
+                "The checkpoint doesn't match the model: the number of " +
+                dims_names[i] + " is " + std::to_string(dims_model[i]) +
+                " in the model."
             );
 
-        agents_in_entities += (e.size() - 1u);
+    // Model -------------------------------------------------------------------
+    uint64_t sim_id_ = 0u;
+    checkpoint_read(in, current_date);
+    checkpoint_read(in, ndays);
+    checkpoint_read(in, sim_id_);
+    checkpoint_read(in, last_seed);
+    checkpoint_read(in, rng_seed);
+    sim_id = static_cast< size_t >(sim_id_);
+
+    // Keeping the existing entries, since parameters_ptrs point to them
+    std::map< std::string, epiworld_double > parameters_;
+    checkpoint_read(in, parameters_);
+    for (const auto & kv : parameters_)
+        parameters[kv.first] = kv.second;
+
+    parameters_ptrs_update();
+
+    for (auto & e : globalevents)
+    {
+        int day = -99;
+        checkpoint_read(in, day);
+        e->set_day(day);
+    }
+
+    // Random numbers
+    uint64_t engine_state[4u];
+    for (auto & s : engine_state)
+        checkpoint_read(in, s);
+
+    engine->set_state(engine_state);
+
+    std::vector< uint64_t > engine_batch_state;
+    uint64_t runif_buffer_pos_ = 0u;
+    checkpoint_read(in, engine_batch_state);
+    checkpoint_read(in, runif_buffer);
+    checkpoint_read(in, runif_buffer_pos_);
+    engine_batch.set_state(engine_batch_state.data());
+    runif_buffer_pos = static_cast< size_t >(runif_buffer_pos_);
+
+    checkpoint_read(in, runifd_a);
+    checkpoint_read(in, runifd_b);
+    checkpoint_read(in, rbinomd_n);
+    checkpoint_read(in, rbinomd_fast_lambda);
+    checkpoint_read(in, rbinomd_use_poisson);
+    checkpoint_read_dist(in, rnormd);
+    checkpoint_read_dist(in, rgammad);
+    checkpoint_read_dist(in, rlognormald);
+    checkpoint_read_dist(in, rexpd);
+    checkpoint_read_dist(in, rbinomd);
+    checkpoint_read_dist(in, rnbinomd);
+    checkpoint_read_dist(in, rgeomd);
+    checkpoint_read_dist(in, rpoissd);
+
+    // Network and agents ------------------------------------------------------
+
+    // The network is only replaced if it changed (e.g., rewiring), so it
+    // stays shared with the backup and the copies of the model otherwise.
+    Network net;
+    checkpoint_read(in, net.offsets);
+    checkpoint_read(in, net.ids);
+    checkpoint_read(in, net.locations);
+
+    if (net.vcount() != population.size())
+        throw std::logic_error(
+            "The checkpoint doesn't match the model: the network has " +
+            std::to_string(net.vcount()) + " vertices."
+        );
+
+    if (net != *network)
+        network = std::make_shared< Network >(std::move(net));
+
+    // The templates of the viruses and tools are read after the database,
+    // so the agents' viruses and tools are set at the end.
+    struct Carried {
+        int id;
+        int date;
+        EPI_TYPENAME_TRAITS(TSeq, int) sequence;
+    };
+
+    std::vector< std::vector< Carried > > agents_viruses(population.size());
+    std::vector< std::vector< Carried > > agents_tools(population.size());
+    agents_state.resize(population.size());
+
+    for (auto & p : population)
+    {
+
+        p.n_neighbors = network->degree(p.id);
+
+        checkpoint_read(in, p.state);
+        agents_state[p.id] = p.state;
+        checkpoint_read(in, p.state_prev);
+        checkpoint_read(in, p.state_last_changed);
+        checkpoint_read(in, p.entities);
+
+        unsigned char has_virus = 0u;
+        checkpoint_read(in, has_virus);
+        if (has_virus != 0u)
+        {
+            Carried v;
+            checkpoint_read(in, v.id);
+            checkpoint_read(in, v.date);
+            checkpoint_read(in, v.sequence);
+            agents_viruses[p.id].push_back(std::move(v));
+        }
+
+        size_t ntools = checkpoint_read_size(in);
+        for (size_t i = 0u; i < ntools; ++i)
+        {
+            Carried t;
+            checkpoint_read(in, t.id);
+            checkpoint_read(in, t.date);
+            checkpoint_read(in, t.sequence);
+            agents_tools[p.id].push_back(std::move(t));
+        }
+
     }
 
-    if (truncate)
+    for (auto & e : entities)
+        checkpoint_read(in, e.agents);
+
+    // Queue and contact tracing -----------------------------------------------
+    checkpoint_read(in, queue.active);
+    checkpoint_read(in, queue.n_in_queue);
+    checkpoint_read(in, queue.active_list);
+    checkpoint_read(in, queue.in_list);
+
+    bool has_contact_tracing = false;
+    checkpoint_read(in, has_contact_tracing);
+    if (has_contact_tracing)
     {
-        
-        if (n > agents_in_entities)
-            n = agents_in_entities;
 
-    } else if (n > agents_in_entities)
-        throw std::logic_error(
-            "There are only " + std::to_string(agents_in_entities) +
-            " agents. You cannot " +
-            "sample " + std::to_string(n)
-            );
+        uint64_t n_agents = 0u, max_contacts = 0u;
+        std::vector< epiworld_agent_index > contact_matrix;
+        std::vector< size_t > contacts_per_agent, contact_date;
+        checkpoint_read(in, contact_matrix);
+        checkpoint_read(in, contacts_per_agent);
+        checkpoint_read(in, contact_date);
+        checkpoint_read(in, n_agents);
+        checkpoint_read(in, max_contacts);
+
+        contact_tracing = std::make_unique<ContactTracing>(
+            static_cast< size_t >(n_agents), static_cast< size_t >(max_contacts)
+        );
+        contact_tracing->contact_matrix     = std::move(contact_matrix);
+        contact_tracing->contacts_per_agent = std::move(contacts_per_agent);
+        contact_tracing->contact_date       = std::move(contact_date);
+
+    }
+
+    // Database ----------------------------------------------------------------
+    checkpoint_read_ids(in, db.virus_id);
+    checkpoint_read(in, db.virus_name);
+    checkpoint_read(in, db.virus_sequence);
+    checkpoint_read(in, db.virus_origin_date);
+    checkpoint_read(in, db.virus_parent_id);
+
+    checkpoint_read_ids(in, db.tool_id);
+    checkpoint_read(in, db.tool_name);
+    checkpoint_read(in, db.tool_sequence);
+    checkpoint_read(in, db.tool_origin_date);
+
+    checkpoint_read(in, db.today_virus);
+    checkpoint_read(in, db.today_tool);
+    checkpoint_read(in, db.today_total);
+    checkpoint_read(in, db.today_total_nviruses_active);
+    checkpoint_read(in, db.sampling_freq);
+
+    checkpoint_read(in, db.hist_virus_date);
+    checkpoint_read(in, db.hist_virus_id);
+    checkpoint_read(in, db.hist_virus_state);
+    checkpoint_read(in, db.hist_virus_counts);
+
+    checkpoint_read(in, db.hist_tool_date);
+    checkpoint_read(in, db.hist_tool_id);
+    checkpoint_read(in, db.hist_tool_state);
+    checkpoint_read(in, db.hist_tool_counts);
+
+    checkpoint_read(in, db.hist_total_date);
+    checkpoint_read(in, db.hist_total_nviruses_active);
+    checkpoint_read(in, db.hist_total_state);
+    checkpoint_read(in, db.hist_total_counts);
+    checkpoint_read(in, db.hist_transition_matrix);
+
+    checkpoint_read(in, db.transmission_date);
+    checkpoint_read(in, db.transmission_source);
+    checkpoint_read(in, db.transmission_target);
+    checkpoint_read(in, db.transmission_virus);
+    checkpoint_read(in, db.transmission_source_exposure_date);
+
+    checkpoint_read(in, db.transition_matrix);
+    checkpoint_read(in, db.batch_transitions);
+    checkpoint_read(in, db.batch_dirty);
+    checkpoint_read(in, db.batch_counts);
+
+    checkpoint_read(in, db.m_hospitalizations._date);
+    checkpoint_read(in, db.m_hospitalizations._virus_id);
+    checkpoint_read(in, db.m_hospitalizations._tool_id);
+    checkpoint_read(in, db.m_hospitalizations._weight);
+
+    checkpoint_read(in, db.user_data.data_names);
+    checkpoint_read(in, db.user_data.data_dates);
+    checkpoint_read(in, db.user_data.data_data);
+    checkpoint_read(in, db.user_data.k);
+    checkpoint_read(in, db.user_data.n);
+    checkpoint_read(in, db.user_data.last_day);
+
+    if (!in)
+        throw std::runtime_error("Error reading the checkpoint (truncated file).");
+
+    // Viruses and tools -------------------------------------------------------
+
+    // Each virus id is rebuilt from the model's virus it descends from
+    std::vector< const Virus<TSeq> * > virus_template(db.virus_name.size(), nullptr);
+    for (size_t i = 0u; i < virus_template.size(); ++i)
+    {
+
+        int ancestor = static_cast< int >(i);
+        while ((ancestor >= 0) && (virus_template[i] == nullptr))
+        {
+
+            for (const auto & v : viruses)
+                if (v->get_id() == ancestor)
+                    virus_template[i] = v.get();
+
+            if (static_cast< size_t >(ancestor) >= db.virus_parent_id.size())
+                break;
+
+            ancestor = db.virus_parent_id[ancestor];
+
+        }
 
-    sample_size = n;
+    }
 
-    if (agents->size() < n)
-        agents->resize(n);
+    std::vector< const Tool<TSeq> * > tool_template(db.tool_name.size(), nullptr);
+    for (const auto & t : tools)
+        if ((t->get_id() >= 0) && (static_cast< size_t >(t->get_id()) < tool_template.size()))
+            tool_template[t->get_id()] = t.get();
 
-    size_t i_obs = 0u;
-    for (size_t i = 0u; i < sample_size; ++i)
+    for (auto & p : population)
     {
 
-        // Sampling a single agent from the set of entities
-        int jth = model->runif_index(agents_in_entities);
-        for (size_t e = 0u; e < cum_agents_count.size(); ++e)
+        p.virus = nullptr;
+        for (auto & v : agents_viruses[p.id])
         {
-            
-            // Are we in the limit?
-            if (jth <= cum_agents_count[e])
-            {
-                size_t agent_idx = 0u;
-                if (e == 0) // From the first group
-                    agent_idx = entities_a[e][jth]->get_id();
-                else
-                    agent_idx = entities_a[e][jth - cum_agents_count[e - 1]]->get_id();
 
+            if ((v.id < 0) || (static_cast< size_t >(v.id) >= virus_template.size()) ||
+                (virus_template[v.id] == nullptr))
+                throw std::logic_error(
+                    "The checkpoint doesn't match the model: the virus with id " +
+                    std::to_string(v.id) + " is not in the model."
+                );
 
-                // Checking if states was specified
-                if (states.size())
-                {
+            p.virus = VirusPtr<TSeq>(virus_template[v.id]->clone_ptr());
+            p.virus->id   = v.id;
+            p.virus->date = v.date;
+            p.virus->baseline_sequence = std::move(v.sequence);
+            p.virus->set_agent(&p);
 
-                    // Getting the state
-                    size_t state = model->population[agent_idx].get_state();
+        }
 
-                    if (std::find(states.begin(), states.end(), state) != states.end())
-                        continue;
+        p.tools.clear();
+        for (auto & t : agents_tools[p.id])
+        {
 
-                }
-                
-                agents->operator[](i_obs++) = &(model->population[agent_idx]);
+            if ((t.id < 0) || (static_cast< size_t >(t.id) >= tool_template.size()) ||
+                (tool_template[t.id] == nullptr))
+                throw std::logic_error(
+                    "The checkpoint doesn't match the model: the tool with id " +
+                    std::to_string(t.id) + " is not in the model."
+                );
 
-                break;
-            }
+            p.tools.emplace_back(ToolPtr<TSeq>(tool_template[t.id]->clone_ptr()));
+            p.tools.back()->id       = t.id;
+            p.tools.back()->date     = t.date;
+            p.tools.back()->sequence = std::move(t.sequence);
+            p.tools.back()->set_agent(&p, p.tools.size() - 1u);
 
         }
-    }
 
-    return; 
+        p.tools_effects_update();
 
-}
+    }
 
-template<typename TSeq>
-inline AgentsSample<TSeq>::~AgentsSample() {}
+    read_checkpoint_derived_keep_rng(in);
+
+    if (!in)
+        throw std::runtime_error("Error reading the checkpoint (truncated file).");
 
-template<typename TSeq>
-inline size_t AgentsSample<TSeq>::size() const noexcept
-{ 
-    return this->sample_size;
 }
 
 template<typename TSeq>
-inline Agent<TSeq> * AgentsSample<TSeq>::operator[](size_t i)
+inline void Model<TSeq>::read_checkpoint_derived_keep_rng(std::istream & in)
 {
 
-    return agents->operator[](i);
+    // Rebuilding the lists of derived models may also set the binomial
+    // distribution (e.g., `ModelSIRCONN::update_infected()`), which was
+    // already restored with its cached draws.
+    auto rbinomd_             = rbinomd;
+    auto rbinomd_n_           = rbinomd_n;
+    auto rbinomd_fast_lambda_ = rbinomd_fast_lambda;
+    auto rbinomd_use_poisson_ = rbinomd_use_poisson;
+
+    read_checkpoint_derived(in);
+
+    rbinomd             = rbinomd_;
+    rbinomd_n           = rbinomd_n_;
+    rbinomd_fast_lambda = rbinomd_fast_lambda_;
+    rbinomd_use_poisson = rbinomd_use_poisson_;
 
 }
 
 template<typename TSeq>
-inline Agent<TSeq> * AgentsSample<TSeq>::operator()(size_t i)
+inline void Model<TSeq>::write_checkpoint_derived(std::ostream &) const
 {
-
-    if (i >= this->sample_size)
-        throw std::range_error("The requested agent is out of range.");
-
-    return agents->operator[](i);
-
+    return;
 }
 
 template<typename TSeq>
-inline typename std::vector< Agent<TSeq> * >::iterator AgentsSample<TSeq>::begin()
+inline void Model<TSeq>::read_checkpoint_derived(std::istream &)
 {
-    // Check for null pointer
-    if (agents == nullptr)
-        return typename std::vector< Agent<TSeq> * >::iterator{};
-    
-    return agents->begin();
+    return;
 }
 
 template<typename TSeq>
-inline typename std::vector< Agent<TSeq> * >::iterator AgentsSample<TSeq>::end()
+inline Model<TSeq> & Model<TSeq>::resume(epiworld_fast_uint ndays)
 {
-    // Check for null pointer
-    if (agents == nullptr)
-        return typename std::vector< Agent<TSeq> * >::iterator{};
-    
-    // Ensure we don't go beyond the actual vector size
-    size_t actual_end = std::min(sample_size, agents->size());
-    return agents->begin() + actual_end;
+
+    if (size() == 0u)
+        throw std::logic_error("There are no agents in this model!");
+
+    pb = Progress(ndays, 80);
+
+    // As in run_setup()
+    parameters_ptrs_update();
+
+    // Back to the day after the last recorded one (as in the loop of
+    // run()); the simulation id is kept, since this is the same run.
+    this->current_date++;
+
+    time_start = std::chrono::steady_clock::now();
+
+    // The profile of the run keeps growing; only the new days go to the total
+    Profiler profile_before = profile;
+    profile.reset();
+
+    run_days(ndays);
+
+    this->current_date--;
+    this->ndays += ndays;
+
+    time_end = std::chrono::steady_clock::now();
+    time_elapsed += (time_end - time_start);
+
+    profile_total  += profile;
+    profile_before += profile;
+    profile = profile_before;
+
+    return *this;
+
 }
 
 template<typename TSeq>
-inline void AgentsSample<TSeq>::sample_n(size_t n)
+inline Model<TSeq> & Model<TSeq>::run_scenarios(
+    epiworld_fast_uint ndays,
+    epiworld_fast_uint burnin,
+    const std::vector< std::map< std::string, epiworld_double > > & scenarios,
+    epiworld_fast_uint nreplicates,
+    int seed,
+    std::function<void(size_t,Model<TSeq>*)> fun,
+    bool verbose,
+    #ifdef _OPENMP
+    int nthreads
+    #else
+    int
+    #endif
+)
 {
 
-    // Reducing size
-    if (states.size())
-    {
-            
-        // Getting the number of agents left
-        agents_left->clear();
+    if (burnin > ndays)
+        throw std::logic_error(
+            "The burn-in (" + std::to_string(burnin) + " days) cannot be " +
+            "longer than the simulation (" + std::to_string(ndays) + " days)."
+        );
 
-        if (sample_type == SAMPLETYPE::MODEL)
-        {
+    if (scenarios.size() == 0u)
+        throw std::logic_error("There must be at least one scenario.");
 
-            // Making some room
-            agents_left->reserve(model->size());
+    if (nreplicates == 0u)
+        throw std::logic_error("The number of replicates must be above 0.");
 
-            // Iterating through the agents in the population
-            for (size_t a_i = 0u; a_i < model->population.size(); ++a_i)
-            {
+    // Failing early (and not within the threads) on unknown parameters
+    for (const auto & scenario : scenarios)
+        for (const auto & p : scenario)
+            if (parameters.find(p.first) == parameters.end())
+                throw std::logic_error(
+                    "The parameter '" + p.first + "' does not exists."
+                );
 
-                // If the agent is within the selected set of states,
-                // then we add it to the list of agents left
-                size_t s = model->population[a_i].get_state();
-                if (std::find(states.begin(), states.end(), s) != states.end())
-                    agents_left->push_back(a_i);
+    if (seed >= 0)
+        this->seed(static_cast< size_t >(seed));
 
-            }
+    // Seeds are bound to the fork (the first one is for the burn-in)
+    const size_t nforks = scenarios.size() * nreplicates;
+    std::vector< int > seeds_n(nforks + 1u);
+    for (auto & s : seeds_n)
+    {
+        s = static_cast<int>(
+            std::floor(
+                runif() * static_cast<double>(std::numeric_limits<int>::max())
+                )
+        );
+    }
 
-        } 
-        else if (sample_type == SAMPLETYPE::ENTITY)
-        {
+    bool old_verb = this->verbose;
+    verbose_off();
 
-            // Making room
-            agents_left->reserve(entity->size());
+    // Burn-in, shared by all the forks
+    run(burnin, seeds_n[0u]);
 
-            // Iterating through the agents in the entity
-            for (size_t a_i = 0u; a_i < entity->size(); ++a_i)
-            {
-                size_t s = model->population[entity->agents[a_i]].get_state();
-                if (std::find(states.begin(), states.end(), s) != states.end())
-                    agents_left->push_back(a_i);
+    std::ostringstream snapshot_out(std::ios_base::out | std::ios_base::binary);
+    write_checkpoint(snapshot_out);
+    const std::string snapshot = snapshot_out.str();
 
-            }
+    auto run_fork = [&scenarios, &snapshot, &seeds_n, ndays, burnin, nreplicates](
+        size_t fork, Model<TSeq> * model
+    ) -> void {
 
-        }
+        std::istringstream snapshot_in(
+            snapshot, std::ios_base::in | std::ios_base::binary
+        );
+        model->read_checkpoint(snapshot_in);
 
-    } else {
+        for (const auto & p : scenarios[fork / nreplicates])
+            model->set_param(p.first, p.second);
 
-        // Checking if the size of the entity has changed (or hasn't been initialized)
-        if (sample_type == SAMPLETYPE::MODEL)
-        {
+        model->set_sim_id(fork);
+        model->seed(static_cast< size_t >(seeds_n[fork + 1u]));
+        model->resume(ndays - burnin);
 
-            if (model->size() != agents_left->size())
-            {
-                agents_left->resize(model->size(), 0u);
-                std::iota(agents_left->begin(), agents_left->end(), 0u);
-            }
+    };
 
-        } else if (sample_type == SAMPLETYPE::ENTITY) {
+    Progress pb_multiple(
+        static_cast<int>(nforks),
+        EPIWORLD_PROGRESS_BAR_WIDTH
+        );
 
-            if (entity->size() != agents_left->size())
-            {
+    #ifdef _OPENMP
+    // Not more than the number of forks
+    nthreads =
+        static_cast<size_t>(nthreads) > nforks ? nforks : nthreads;
+    #endif
 
-                agents_left->resize(entity->size(), 0u);
-                std::iota(agents_left->begin(), agents_left->end(), 0u);
+    if (verbose)
+    {
 
-            }
+        #ifdef _OPENMP
+        printf_epiworld(
+            "Starting %i scenario(s) x %i replicate(s) using %i thread(s)\n",
+            static_cast<int>(scenarios.size()),
+            static_cast<int>(nreplicates),
+            static_cast<int>(nthreads)
+        );
+        #else
+        printf_epiworld(
+            "Starting %i scenario(s) x %i replicate(s)\n",
+            static_cast<int>(scenarios.size()),
+            static_cast<int>(nreplicates)
+        );
+        #endif
 
-        } 
+        pb_multiple.start();
 
     }
 
-    // Restart the counter of agents left
-    *agents_left_n = agents_left->size();
+    // Forks are scheduled as the replicates of run_multiple()
+    run_jobs(
+        nforks,
+        #ifdef _OPENMP
+        nthreads,
+        #else
+        1,
+        #endif
+        run_fork, fun, pb_multiple, verbose
+    );
 
-    // Making sure we have enough room for the sample of agents
-    if (agents->size() < sample_size)
-        agents->resize(sample_size, nullptr);
+    if (old_verb)
+        verbose_on();
 
-    if (sample_type == SAMPLETYPE::MODEL)
-    {
+    return *this;
 
-        #ifdef EPI_DEBUG
-        std::vector< bool > __sampled(model->size(), true);
-        for (auto & a_i: *agents_left)
-            __sampled[a_i] = false;
-        #endif
+}
 
-        for (size_t i = 0u; i < n; ++i)
-        {
+#endif
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-            // Sampling from 0 to (agents_left_n - 1)
-            size_t ith_ = static_cast<size_t>(model->runif() * ((*agents_left_n)--));
-            
-            // Getting the id of the agent and adding it to the list of agents
-            size_t ith  = agents_left->operator[](ith_);
-            agents->operator[](i) = &model->population[ith];
+ End of -./include/epiworld/model-meat-checkpoint.hpp-
 
-            #ifdef EPI_DEBUG
-            if (__sampled[ith])
-                throw std::logic_error("The same agent was sampled twice.");
-            else
-                __sampled[ith] = true;
-            #endif
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
 
-            // Updating list
-            std::swap(
-                agents_left->operator[](ith_),
-                agents_left->operator[](*agents_left_n)
-                );
 
-        }
+/*//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
+ Start of -./include/epiworld/model-meat-memory.hpp-
 
-    }
-    else if (sample_type == SAMPLETYPE::ENTITY)
+////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////*/
+
+
+#ifndef EPIWORLD_MODEL_MEAT_MEMORY_HPP
+#define EPIWORLD_MODEL_MEAT_MEMORY_HPP
+
+// (already included include/epiworld/model-bones.hpp)
+// (already included include/epiworld/memoryusage-bones.hpp)
+
+template<typename TSeq>
+inline MemoryUsage Model<TSeq>::memory_usage(int nthreads) const
+{
+
+    MemoryUsage res;
+
+    // Agents
+    res.agents = MemoryUsage::bytes(population) +
+        MemoryUsage::bytes(agents_state);
+    for (const auto & a : population)
     {
 
-        #ifdef EPI_DEBUG
-        std::vector< bool > __sampled(entity->size(), true);
-        for (auto & a_i: *agents_left)
-            __sampled[a_i] = false;
-        #endif
+        res.agents_entities += MemoryUsage::bytes(a.entities);
+
+        if (a.virus != nullptr)
+            res.agents_viruses += sizeof(Virus<TSeq>);
+
+        res.agents_tools += MemoryUsage::bytes(a.tools) +
+            a.tools.size() * sizeof(Tool<TSeq>);
+
+    }
+
+    // Network (the backup counts only if it is not the same network)
+    auto network_bytes = [](const Network & net) -> size_t {
+        return MemoryUsage::bytes(net.offsets) + MemoryUsage::bytes(net.ids) +
+            MemoryUsage::bytes(net.locations);
+    };
+
+    res.network = network_bytes(*network);
+    if ((network_backup != nullptr) && (network_backup != network))
+        res.network_backup = network_bytes(*network_backup);
+
+    for (const auto & e : entities)
+        res.entities += sizeof(Entity<TSeq>) + MemoryUsage::bytes(e.agents) +
+            MemoryUsage::bytes(e.location);
+    res.entities += (entities.capacity() - entities.size()) *
+        sizeof(Entity<TSeq>);
+
+    res.queue = MemoryUsage::bytes(queue.active) +
+        MemoryUsage::bytes(queue.active_list) +
+        MemoryUsage::bytes(queue.in_list);
+
+    if (contact_tracing != nullptr)
+        res.contact_tracing = sizeof(ContactTracing) +
+            MemoryUsage::bytes(contact_tracing->contact_matrix) +
+            MemoryUsage::bytes(contact_tracing->contacts_per_agent) +
+            MemoryUsage::bytes(contact_tracing->contact_date);
+
+    auto event_bytes = [](const EventBuffer<TSeq> & e) -> size_t {
+        return MemoryUsage::bytes(e.agent) + MemoryUsage::bytes(e.action) +
+            MemoryUsage::bytes(e.new_state) + MemoryUsage::bytes(e.queue) +
+            MemoryUsage::bytes(e.payload) + MemoryUsage::bytes(e.viruses) +
+            MemoryUsage::bytes(e.tools) + MemoryUsage::bytes(e.entities) +
+            MemoryUsage::bytes(e.order);
+    };
+
+    res.events = event_bytes(events) + MemoryUsage::bytes(events_threads) +
+        MemoryUsage::bytes(engines_threads);
+    for (const auto & e : events_threads)
+        res.events += MemoryUsage::bytes(e);
+
+    res.sampling = MemoryUsage::bytes(sampled_population) +
+        MemoryUsage::bytes(population_left);
+
+    // Database
+    res.db_registry =
+        MemoryUsage::bytes(db.virus_id) +
+        MemoryUsage::bytes(db.virus_name) +
+        MemoryUsage::bytes(db.virus_sequence) +
+        MemoryUsage::bytes(db.virus_origin_date) +
+        MemoryUsage::bytes(db.virus_parent_id) +
+        MemoryUsage::bytes(db.tool_id) +
+        MemoryUsage::bytes(db.tool_name) +
+        MemoryUsage::bytes(db.tool_sequence) +
+        MemoryUsage::bytes(db.tool_origin_date);
+
+    res.db_today = MemoryUsage::bytes(db.today_virus) +
+        MemoryUsage::bytes(db.today_tool) + MemoryUsage::bytes(db.today_total);
+    for (const auto & v : db.today_virus)
+        res.db_today += MemoryUsage::bytes(v);
+    for (const auto & t : db.today_tool)
+        res.db_today += MemoryUsage::bytes(t);
+
+    res.db_hist_virus =
+        MemoryUsage::bytes(db.hist_virus_date) +
+        MemoryUsage::bytes(db.hist_virus_id) +
+        MemoryUsage::bytes(db.hist_virus_state) +
+        MemoryUsage::bytes(db.hist_virus_counts);
+
+    res.db_hist_tool =
+        MemoryUsage::bytes(db.hist_tool_date) +
+        MemoryUsage::bytes(db.hist_tool_id) +
+        MemoryUsage::bytes(db.hist_tool_state) +
+        MemoryUsage::bytes(db.hist_tool_counts);
+
+    res.db_hist_total =
+        MemoryUsage::bytes(db.hist_total_date) +
+        MemoryUsage::bytes(db.hist_total_nviruses_active) +
+        MemoryUsage::bytes(db.hist_total_state) +
+        MemoryUsage::bytes(db.hist_total_counts);
+
+    res.db_hist_transition = MemoryUsage::bytes(db.hist_transition_matrix);
+
+    res.db_transition = MemoryUsage::bytes(db.transition_matrix) +
+        MemoryUsage::bytes(db.batch_counts);
+
+    res.db_transmission =
+        MemoryUsage::bytes(db.transmission_date) +
+        MemoryUsage::bytes(db.transmission_source) +
+        MemoryUsage::bytes(db.transmission_target) +
+        MemoryUsage::bytes(db.transmission_virus) +
+        MemoryUsage::bytes(db.transmission_source_exposure_date);
+
+    res.db_user_data =
+        MemoryUsage::bytes(db.user_data.data_names) +
+        MemoryUsage::bytes(db.user_data.data_dates) +
+        MemoryUsage::bytes(db.user_data.data_data);
+
+    res.db_hospitalizations =
+        MemoryUsage::bytes(db.m_hospitalizations._date) +
+        MemoryUsage::bytes(db.m_hospitalizations._virus_id) +
+        MemoryUsage::bytes(db.m_hospitalizations._tool_id) +
+        MemoryUsage::bytes(db.m_hospitalizations._weight);
+
+    // Clones copy everything but the network
+    if (nthreads > 1)
+        res.thread_clones = static_cast< size_t >(nthreads - 1) *
+            (res.total() - res.network - res.network_backup);
+
+    return res;
+
+}
+
+template<typename TSeq>
+inline MemoryUsage Model<TSeq>::estimate_memory_usage(
+    size_t n,
+    epiworld_double mean_degree,
+    size_t nstates,
+    size_t ndays,
+    size_t nviruses,
+    size_t ntools,
+    int nthreads
+)
+{
 
-        for (size_t i = 0u; i < n; ++i)
-        {
+    MemoryUsage res;
 
-            size_t ith_ = static_cast<size_t>(
-                model->runif() * ((*agents_left_n)--)
-            );
+    size_t nties = static_cast< size_t >(
+        static_cast< epiworld_double >(n) * mean_degree + 0.5
+    );
 
-            size_t ith  = agents_left->operator[](ith_);
-            agents->operator[](i) = &model->population[entity->agents[ith]];
+    // History rows (date, id or active viruses, state, and count), from
+    // day 0 to ndays
+    size_t nrecords = ndays + 1u;
+    size_t nrow     = sizeof(int) * 3u + sizeof(epiworld_fast_uint);
 
-            #ifdef EPI_DEBUG
-            if (__sampled[ith])
-                throw std::logic_error("The same agent was sampled twice.");
-            else
-                __sampled[ith] = true;
-            #endif
+    res.agents         = n * (sizeof(Agent<TSeq>) + sizeof(unsigned int));
+    res.agents_viruses = n * sizeof(Virus<TSeq>);
+    res.agents_tools   = n * ntools * (sizeof(ToolPtr<TSeq>) + sizeof(Tool<TSeq>));
 
-            // Updating list
-            std::swap(agents_left->operator[](ith_), agents_left->operator[](*agents_left_n));
+    res.network = (n + 1u) * sizeof(size_t) +
+        2u * nties * sizeof(epiworld_agent_index);
+    res.queue   = n * (sizeof(epiworld_fast_int) + sizeof(size_t)) +
+        (n + 7u) / 8u;
 
-        }
+    res.db_today = (nviruses + ntools + 1u) * nstates * sizeof(int);
+    res.db_hist_virus      = nrecords * nviruses * nstates * nrow;
+    res.db_hist_tool       = nrecords * ntools * nstates * nrow;
+    res.db_hist_total      = nrecords * nstates * nrow;
+    res.db_hist_transition = nrecords * nstates * nstates * sizeof(int);
+    res.db_transition      = nstates * nstates * sizeof(int);
+    res.db_transmission    = n * 5u * sizeof(int);
 
-    }
+    if (nthreads > 1)
+        res.thread_clones = static_cast< size_t >(nthreads - 1) *
+            (res.total() - res.network);
 
-    return;
+    return res;
 
 }
 
@@ -18983,7 +23790,7 @@ inline void AgentsSample<TSeq>::sample_n(size_t n)
 /*//////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
- End of -./include/epiworld/agentssample-bones.hpp-
+ End of -./include/epiworld/model-meat-memory.hpp-
 
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////*/
@@ -20030,9 +24837,25 @@ public:
         std::vector< double > proportions_,
         std::vector< int > queue_ = {}
     ) override;
+
+    /**
+     * @brief Runs the built-in states without `std::function` calls
+     * @return false if any state function was replaced by the user.
+     */
+    bool update_state_static() override;
     
 };
 
+template<typename TSeq>
+inline bool ModelSIR<TSeq>::update_state_static()
+{
+    return this->template update_state_table<
+        default_update_susceptible<TSeq>,
+        default_update_exposed<TSeq>,
+        nullptr
+        >();
+}
+
 template<typename TSeq>
 inline ModelSIR<TSeq>::ModelSIR(
     const std::string & vname,
@@ -20136,10 +24959,10 @@ public:
         epiworld_double recovery_rate
     );
 
-    UpdateFun<TSeq> update_exposed_seir = [](
+    static void update_exposed_seir(
         Agent<TSeq> * p,
         Model<TSeq> * m
-    ) -> void {
+    ) {
 
         // Getting the virus
         auto v = p->get_virus();
@@ -20149,19 +24972,22 @@ public:
             p->change_state(*m, ModelSEIR<TSeq>::INFECTED);
 
         return;
-    };
+    }
 
 
-    UpdateFun<TSeq> update_infected_seir = [](
+    static void update_infected_seir(
         Agent<TSeq> * p,
         Model<TSeq> * m
-    ) -> void {
+    ) {
+        static const size_t par_recovery_rate =
+            Model<TSeq>::param_id("Recovery rate");
+
         // Does the agent recover?
-        if (m->runif() < (m->par("Recovery rate")))
+        if (m->runif() < (m->par(par_recovery_rate)))
             p->rm_virus(*m);
 
         return;
-    };
+    }
 
     /**
      * @brief Set up the initial states of the model.
@@ -20174,8 +25000,25 @@ public:
         std::vector< int > queue_ = {}
     ) override;
 
+    /**
+     * @brief Runs the built-in states without `std::function` calls
+     * @return false if any state function was replaced by the user.
+     */
+    bool update_state_static() override;
+
 };
 
+template<typename TSeq>
+inline bool ModelSEIR<TSeq>::update_state_static()
+{
+    return this->template update_state_table<
+        default_update_susceptible<TSeq>,
+        update_exposed_seir,
+        update_infected_seir,
+        nullptr
+        >();
+}
+
 
 template<typename TSeq>
 inline ModelSEIR<TSeq>::ModelSEIR(
@@ -20258,6 +25101,10 @@ inline ModelSEIR<TSeq> & ModelSEIR<TSeq>::initial_states(
 template<typename TSeq = EPI_DEFAULT_TSEQ>
 class ModelSURV : public Model<TSeq> {
 
+private:
+    void write_checkpoint_derived(std::ostream & out) const override;
+    void read_checkpoint_derived(std::istream & in) override;
+
 public:
     // state
     static constexpr int SUSCEPTIBLE           = 0;
@@ -20339,6 +25186,26 @@ public:
 
 };
 
+template<typename TSeq>
+inline void ModelSURV<TSeq>::write_checkpoint_derived(std::ostream & out) const
+{
+
+    checkpoint_write(out, days_latent_and_infectious);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSURV<TSeq>::read_checkpoint_derived(std::istream & in)
+{
+
+    checkpoint_read(in, days_latent_and_infectious);
+
+    return;
+
+}
+
 template<typename TSeq>
 inline void ModelSURV<TSeq>::reset()
 {
@@ -20374,10 +25241,10 @@ inline ModelSURV<TSeq>::ModelSURV(
         // This computes the prob of getting any neighbor variant
         epiworld_fast_uint nviruses_tmp = 0u;
         auto & m_ref = *m;
-        for (auto & neighbor: p->get_neighbors(*m)) 
+        for (auto & neighbor: p->neighbors(*m)) 
         {
                     
-            auto & v = neighbor->get_virus();
+            auto & v = neighbor.get_virus();
 
             if (v == nullptr)
                 continue;
@@ -20386,7 +25253,7 @@ inline ModelSURV<TSeq>::ModelSURV(
             epiworld_double tmp_transmission = 
                 (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
                 v->get_prob_infecting(m) *
-                (1.0 - neighbor->get_transmission_reduction(v, m_ref)) 
+                (1.0 - neighbor.get_transmission_reduction(v, m_ref)) 
                 ; 
         
             m->array_double_tmp[nviruses_tmp]  = tmp_transmission;
@@ -20416,6 +25283,13 @@ inline ModelSURV<TSeq>::ModelSURV(
         // Dynamically getting the ModelSURV
         ModelSURV<TSeq> * model_surv = model_cast<ModelSURV<TSeq>,TSeq>(m);
 
+        static const size_t par_latent_period =
+            Model<TSeq>::param_id("Latent period");
+        static const size_t par_infect_period =
+            Model<TSeq>::param_id("Infect period");
+        static const size_t par_prob_symptoms =
+            Model<TSeq>::param_id("Prob of symptoms");
+
         VirusPtr<TSeq> & v = p->get_virus(); 
         epiworld_double p_die = v->get_prob_death(m) * (1.0 - p->get_death_reduction(v, *m));
         
@@ -20427,13 +25301,13 @@ inline ModelSURV<TSeq>::ModelSURV(
         if (dat[p->get_id()] < 0)
         {
             epiworld_double latent_days = m->rgamma(
-                m->par("Latent period"), 1.0
+                m->par(par_latent_period), 1.0
             );
 
             dat[p->get_id() * 2u] = latent_days;
 
             dat[p->get_id() * 2u + 1u] = 
-                m->rgamma(m->par("Infect period"), 1.0) +
+                m->rgamma(m->par(par_infect_period), 1.0) +
                 latent_days;
         }
         
@@ -20453,7 +25327,7 @@ inline ModelSURV<TSeq>::ModelSURV(
         {
 
             // Will be symptomatic?
-            if (EPI_RUNIF() < m->par("Prob of symptoms"))
+            if (EPI_RUNIF() < m->par(par_prob_symptoms))
                 p->change_state(*m, ModelSURV<TSeq>::SYMPTOMATIC);
             else
                 p->change_state(*m, ModelSURV<TSeq>::ASYMPTOMATIC);
@@ -20487,8 +25361,11 @@ inline ModelSURV<TSeq>::ModelSURV(
         ) -> void
     {
 
+        static const size_t par_surveilance_prob =
+            Model<TSeq>::param_id("Surveilance prob.");
+
         // How many will we find
-        std::binomial_distribution<> bdist(m->size(), m->par("Surveilance prob."));
+        std::binomial_distribution<> bdist(m->size(), m->par(par_surveilance_prob));
         int nsampled = bdist(*m->get_rand_endgine());
 
         int to_go = nsampled + 1;
@@ -20577,6 +25454,9 @@ inline ModelSURV<TSeq>::ModelSURV(
         Model<TSeq> * m
         ) -> epiworld_double
     {
+        static const size_t par_prob_transmission =
+            Model<TSeq>::param_id("Prob of transmission");
+
         // No chance of infecting
         epiworld_fast_uint  s = p->get_state();
         if (s == ModelSURV<TSeq>::LATENT)
@@ -20587,7 +25467,7 @@ inline ModelSURV<TSeq>::ModelSURV(
             return static_cast<epiworld_double>(0.0);
 
         // Otherwise
-        return m->par("Prob of transmission");
+        return m->par(par_prob_transmission);
     };
 
     covid.set_prob_infecting_fun(ptransmitfun);
@@ -20647,6 +25527,10 @@ private:
 
     std::vector< Agent<TSeq> * > infected;
     void update_infected();
+    void read_checkpoint_derived(std::istream & in) override;
+
+    static void _update_susceptible(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_infected(Agent<TSeq> * p, Model<TSeq> * m);
 
 public:
 
@@ -20670,6 +25554,12 @@ public:
 
     std::unique_ptr< Model<TSeq> > clone_ptr() override;
 
+    /**
+     * @brief Runs the built-in states without `std::function` calls
+     * @return false if any state function was replaced by the user.
+     */
+    bool update_state_static() override;
+
     /**
      * @brief Set the initial states of the model
      * @param proportions_ Double vector with a single element:
@@ -20738,6 +25628,16 @@ inline void ModelSIRCONN<TSeq>::reset()
 
 }
 
+template<typename TSeq>
+inline void ModelSIRCONN<TSeq>::read_checkpoint_derived(std::istream &)
+{
+
+    this->update_infected();
+
+    return;
+
+}
+
 template<typename TSeq>
 inline std::unique_ptr<Model<TSeq>> ModelSIRCONN<TSeq>::clone_ptr()
 {
@@ -20746,149 +25646,159 @@ inline std::unique_ptr<Model<TSeq>> ModelSIRCONN<TSeq>::clone_ptr()
 
 }
 
-/**
- * @brief Template for a Susceptible-Infected-Removed (SIR) model
- * 
- * @param model A Model<TSeq> object where to set up the SIR.
- * @param vname std::string Name of the virus
- * @param prevalence Initial prevalence (proportion)
- * @param contact_rate Average number of contacts (interactions) per step.
- * @param transmission_rate Probability of transmission
- * @param recovery_rate Probability of recovery
- */
 template<typename TSeq>
-inline ModelSIRCONN<TSeq>::ModelSIRCONN(
-    const std::string & vname,
-    epiworld_fast_uint n,
-    epiworld_double prevalence,
-    epiworld_double contact_rate,
-    epiworld_double transmission_rate,
-    epiworld_double recovery_rate
-    // epiworld_double prob_reinfection
-    )
+inline bool ModelSIRCONN<TSeq>::update_state_static()
 {
+    return this->template update_state_table<
+        _update_susceptible, _update_infected, nullptr
+        >();
+}
 
-    UpdateFun<TSeq> update_susceptible = [](
-        Agent<TSeq> * p, Model<TSeq> * m
-        ) -> void
-        {
+template<typename TSeq>
+inline void ModelSIRCONN<TSeq>::_update_susceptible(
+    Agent<TSeq> * p, Model<TSeq> * m
+    )
+{
 
-            int ndraw = m->rbinom();
+    int ndraw = m->rbinom();
 
-            if (ndraw == 0)
-                return;
+    if (ndraw == 0)
+        return;
 
-            ModelSIRCONN<TSeq> * model = model_cast<ModelSIRCONN<TSeq>,TSeq>(m);
-            int ninfected = static_cast<int>(model->get_n_infected());
+    ModelSIRCONN<TSeq> * model = model_cast<ModelSIRCONN<TSeq>,TSeq>(m);
+    int ninfected = static_cast<int>(model->get_n_infected());
 
-            // Drawing from the set
-            int nviruses_tmp = 0;
-            auto & m_ref = *m;
-            for (int i = 0; i < ndraw; ++i)
-            {
-                // Now selecting who is transmitting the disease
-                auto which = m->runif_index(ninfected);
-                
-                Agent<TSeq> & neighbor = *model->infected[which];
+    // Drawing from the set
+    int nviruses_tmp = 0;
+    auto & m_ref = *m;
+    for (int i = 0; i < ndraw; ++i)
+    {
+        // Now selecting who is transmitting the disease
+        auto which = m->runif_index(ninfected);
 
-                // Can't sample itself
-                if (neighbor.get_id() == p->get_id())
-                    continue;
+        Agent<TSeq> & neighbor = *model->infected[which];
 
-                // The neighbor is infected because it is on the list!
-                if (neighbor.get_virus() == nullptr)
-                    continue;
+        // Can't sample itself
+        if (neighbor.get_id() == p->get_id())
+            continue;
 
-                auto & v = neighbor.get_virus();
+        // The neighbor is infected because it is on the list!
+        if (neighbor.get_virus() == nullptr)
+            continue;
 
-                #ifdef EPI_DEBUG
-                if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
-                    throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
-                #endif
-                    
-                /* And it is a function of susceptibility_reduction as well */ 
-                m->array_double_tmp[nviruses_tmp] =
-                    (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
-                    v->get_prob_infecting(m) *
-                    (1.0 - neighbor.get_transmission_reduction(v, m_ref))
-                    ;
-            
-                m->array_virus_tmp[nviruses_tmp++] = &(*v);
-                 
-            }
+        auto & v = neighbor.get_virus();
 
-            // No virus to compute
-            if (nviruses_tmp == 0u)
-                return;
+        #ifdef EPI_DEBUG
+        if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+            throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
+        #endif
 
-            // Running the roulette
-            int which = roulette(nviruses_tmp, m);
+        /* And it is a function of susceptibility_reduction as well */ 
+        m->array_double_tmp[nviruses_tmp] =
+            (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
+            v->get_prob_infecting(m) *
+            (1.0 - neighbor.get_transmission_reduction(v, m_ref))
+            ;
 
-            if (which < 0)
-                return;
+        m->array_virus_tmp[nviruses_tmp++] = &(*v);
 
-            p->set_virus(*m, *m->array_virus_tmp[which]);
+    }
 
-            return; 
+    // No virus to compute
+    if (nviruses_tmp == 0u)
+        return;
 
-        };
+    // Running the roulette
+    int which = roulette(nviruses_tmp, m);
 
+    if (which < 0)
+        return;
 
-    UpdateFun<TSeq> update_infected = [](
-        Agent<TSeq> * p, Model<TSeq> * m
-        ) -> void {
+    p->set_virus(*m, *m->array_virus_tmp[which]);
 
-            auto state = p->get_state();
+    return; 
 
-            if (state == ModelSIRCONN<TSeq>::INFECTED)
-            {
+}
 
+template<typename TSeq>
+inline void ModelSIRCONN<TSeq>::_update_infected(
+    Agent<TSeq> * p, Model<TSeq> * m
+    )
+{
 
-                // Odd: Die, Even: Recover
-                epiworld_fast_uint n_events = 0u;
-                // Recover
-                m->array_double_tmp[n_events++] = 
-                    1.0 - (1.0 - p->get_virus()->get_prob_recovery(m)) *
-                        (1.0 - p->get_recovery_enhancer(p->get_virus(), *m));
+    auto state = p->get_state();
 
-                #ifdef EPI_DEBUG
-                if (n_events == 0u)
-                {
-                    printf_epiworld(
-                        "[epi-debug] agent %i has 0 possible events!!\n",
-                        static_cast<int>(p->get_id())
-                        );
-                    throw std::logic_error("Zero events in exposed.");
-                }
-                #else
-                if (n_events == 0u)
-                    return;
-                #endif
-                
+    if (state == ModelSIRCONN<TSeq>::INFECTED)
+    {
 
-                // Running the roulette
-                int which = roulette(n_events, m);
 
-                if (which < 0)
-                    return;
+        // Odd: Die, Even: Recover
+        epiworld_fast_uint n_events = 0u;
+        // Recover
+        m->array_double_tmp[n_events++] = 
+            1.0 - (1.0 - p->get_virus()->get_prob_recovery(m)) *
+                (1.0 - p->get_recovery_enhancer(p->get_virus(), *m));
 
-                // Which roulette happen?
-                p->rm_virus(*m);
+        #ifdef EPI_DEBUG
+        if (n_events == 0u)
+        {
+            printf_epiworld(
+                "[epi-debug] agent %i has 0 possible events!!\n",
+                static_cast<int>(p->get_id())
+                );
+            throw std::logic_error("Zero events in exposed.");
+        }
+        #else
+        if (n_events == 0u)
+            return;
+        #endif
 
-                return ;
 
-            } else
-                throw std::logic_error(
-                    "This function can only be applied to infected individuals. (SIR)"
-                    ) ;
+        // Running the roulette
+        int which = roulette(n_events, m);
 
+        if (which < 0)
             return;
 
-        };
+        // Which roulette happen?
+        p->rm_virus(*m);
+
+        return ;
+
+    } else
+        throw std::logic_error(
+            "This function can only be applied to infected individuals. (SIR)"
+            ) ;
+
+    return;
+
+}
+
+/**
+ * @brief Template for a Susceptible-Infected-Removed (SIR) model
+ * 
+ * @param model A Model<TSeq> object where to set up the SIR.
+ * @param vname std::string Name of the virus
+ * @param prevalence Initial prevalence (proportion)
+ * @param contact_rate Average number of contacts (interactions) per step.
+ * @param transmission_rate Probability of transmission
+ * @param recovery_rate Probability of recovery
+ */
+template<typename TSeq>
+inline ModelSIRCONN<TSeq>::ModelSIRCONN(
+    const std::string & vname,
+    epiworld_fast_uint n,
+    epiworld_double prevalence,
+    epiworld_double contact_rate,
+    epiworld_double transmission_rate,
+    epiworld_double recovery_rate
+    // epiworld_double prob_reinfection
+    )
+{
 
     // state
-    this->add_state("Susceptible", update_susceptible);
-    this->add_state("Infected", update_infected);
+    this->add_state("Susceptible", _update_susceptible);
+    this->add_state("Infected", _update_infected);
     this->add_state("Recovered");
 
     // Setting up parameters
@@ -21025,6 +25935,7 @@ class ModelSEIRCONN : public Model<TSeq>
 private:
     std::vector< Agent<TSeq> * > infected;
     void update_infected();
+    void read_checkpoint_derived(std::istream & in) override;
 
 public:
 
@@ -21110,6 +26021,16 @@ inline void ModelSEIRCONN<TSeq>::reset()
 
 }
 
+template<typename TSeq>
+inline void ModelSEIRCONN<TSeq>::read_checkpoint_derived(std::istream &)
+{
+
+    this->update_infected();
+
+    return;
+
+}
+
 template<typename TSeq>
 inline std::unique_ptr<Model<TSeq>> ModelSEIRCONN<TSeq>::clone_ptr()
 {
@@ -21901,11 +26822,14 @@ inline ModelSIRDCONN<TSeq>::ModelSIRDCONN(
         ) -> void
         {
 
+            static const size_t par_contact_rate =
+                Model<TSeq>::param_id("Contact rate");
+
             // Sampling how many individuals
             m->set_rand_binom(
                 m->size(),
                 static_cast<double>(
-                    m->par("Contact rate"))/
+                    m->par(par_contact_rate))/
                     static_cast<double>(m->size())
             );
 
@@ -22101,6 +27025,7 @@ class ModelSEIRDCONN : public Model<TSeq>
 private:
     std::vector< Agent<TSeq> * > infected;
     void update_infected();
+    void read_checkpoint_derived(std::istream & in) override;
 
 public:
 
@@ -22192,6 +27117,16 @@ inline void ModelSEIRDCONN<TSeq>::reset()
 
 }
 
+template<typename TSeq>
+inline void ModelSEIRDCONN<TSeq>::read_checkpoint_derived(std::istream &)
+{
+
+    this->update_infected();
+
+    return;
+
+}
+
 template<typename TSeq>
 inline std::unique_ptr<Model<TSeq>> ModelSEIRDCONN<TSeq>::clone_ptr()
 {
@@ -22639,13 +27574,13 @@ inline ModelSIRLogit<TSeq>::ModelSIRLogit(
                 baseline += p->operator()(k, *m) * _m->coefs_infect[k + 1u];
 
             auto & m_ref = *m;
-            for (auto & neighbor: p->get_neighbors(*m)) 
+            for (auto & neighbor: p->neighbors(*m)) 
             {
                 
-                if (neighbor->get_virus() == nullptr)
+                if (neighbor.get_virus() == nullptr)
                     continue;
 
-                auto & v = neighbor->get_virus();
+                auto & v = neighbor.get_virus();
 
                 #ifdef EPI_DEBUG
                 if (nviruses_tmp >= m->array_virus_tmp.size())
@@ -22657,7 +27592,7 @@ inline ModelSIRLogit<TSeq>::ModelSIRLogit(
                     baseline +
                     (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
                     v->get_prob_infecting(m) *
-                    (1.0 - neighbor->get_transmission_reduction(v, m_ref))  *
+                    (1.0 - neighbor.get_transmission_reduction(v, m_ref))  *
                     coef_exposure
                     ; 
 
@@ -22840,13 +27775,13 @@ inline ModelDiffNet<TSeq>::ModelDiffNet(
         // For each one of the possible innovations, we have to compute
         // the adoption probability, which is a function of exposure
         auto & m_ref = *m;
-        for (auto & neighbor: agent.get_neighbors(*m))
+        for (auto & neighbor: agent.neighbors(*m))
         {
 
-            if (neighbor->get_state() == ModelDiffNet<TSeq>::ADOPTER)
+            if (neighbor.get_state() == ModelDiffNet<TSeq>::ADOPTER)
             {
 
-                auto & v = neighbor->get_virus();
+                auto & v = neighbor.get_virus();
                 
                 if (v == nullptr)
                     continue;
@@ -22979,7 +27914,7 @@ class ModelSEIRMixing :
 private:
 
     // Vector of vectors of infected agents
-    std::vector< size_t > infected;
+    std::vector< epiworld_agent_index > infected;
 
     // Number of infected agents in each group
     std::vector< size_t > n_infected_per_group;
@@ -22988,17 +27923,27 @@ private:
     std::vector< size_t > entity_indices;
 
     void update_infected_list();
-    std::vector< size_t > sampled_agents;
+    void setup_groups(); ///< Sizes and fills the lists by group.
+    void read_checkpoint_derived(std::istream & in) override;
+    std::vector< epiworld_agent_index > sampled_agents;
     size_t sample_agents(
         Agent<TSeq> * agent,
-        std::vector< size_t > & sampled_agents
+        std::vector< epiworld_agent_index > & sampled_agents
         );
     std::vector< double > adjusted_contact_rate;
 
+    static void _update_susceptible(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_exposed_and_infected(Agent<TSeq> * p, Model<TSeq> * m);
+
     #ifdef EPI_DEBUG
     std::vector< int > sampled_sizes;
     #endif
 
+    // Aggregated mode (see aggregated_on())
+    epiworld_double prevalence;
+    std::vector< double > proportions = {};
+    Model<TSeq> & run_aggregated(epiworld_fast_uint ndays) override;
+
 public:
 
     static const int SUSCEPTIBLE = 0;
@@ -23035,6 +27980,12 @@ public:
 
     std::unique_ptr< Model<TSeq> > clone_ptr() override;
 
+    /**
+     * @brief Runs the built-in states without `std::function` calls
+     * @return false if any state function was replaced by the user.
+     */
+    bool update_state_static() override;
+
     /**
      * @brief Set the initial states of the model
      * @param proportions_ Double vector with a single element:
@@ -23045,6 +27996,21 @@ public:
         std::vector< int > queue_ = {}
     ) override;
 
+    /**
+     * @name Aggregated mode
+     * @details Same as `ModelSIRMixing::aggregated_on()`: the model keeps
+     * counts per group and state, and advances them with binomial draws.
+     * Only the infected (not the exposed) transmit, and exposed become
+     * infected with probability `1 / incubation` each day.
+     *
+     * @param group_sizes Number of agents in each group (one per row of
+     * the contact matrix).
+     */
+    ///@{
+    ModelSEIRMixing<TSeq> & aggregated_on(std::vector< size_t > group_sizes);
+    ModelSEIRMixing<TSeq> & aggregated_off(); ///< Restores the agents.
+    ///@}
+
 };
 
 template<typename TSeq>
@@ -23082,7 +28048,7 @@ inline void ModelSEIRMixing<TSeq>::update_infected_list()
 template<typename TSeq>
 inline size_t ModelSEIRMixing<TSeq>::sample_agents(
     Agent<TSeq> * agent,
-    std::vector< size_t > & sampled_agents
+    std::vector< epiworld_agent_index > & sampled_agents
     )
 {
 
@@ -23143,11 +28109,9 @@ inline size_t ModelSEIRMixing<TSeq>::sample_agents(
 }
 
 template<typename TSeq>
-inline void ModelSEIRMixing<TSeq>::reset()
+inline void ModelSEIRMixing<TSeq>::setup_groups()
 {
 
-    Model<TSeq>::reset();
-
     // Checking contact matrix dimensions
     size_t nentities = this->entities.size();
     this->validate_contact_matrix(nentities);
@@ -23196,6 +28160,28 @@ inline void ModelSEIRMixing<TSeq>::reset()
 
 }
 
+template<typename TSeq>
+inline void ModelSEIRMixing<TSeq>::read_checkpoint_derived(std::istream &)
+{
+
+    this->setup_groups();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixing<TSeq>::reset()
+{
+
+    Model<TSeq>::reset();
+
+    this->setup_groups();
+
+    return;
+
+}
+
 template<typename TSeq>
 inline std::unique_ptr<Model<TSeq>> ModelSEIRMixing<TSeq>::clone_ptr()
 {
@@ -23204,165 +28190,298 @@ inline std::unique_ptr<Model<TSeq>> ModelSEIRMixing<TSeq>::clone_ptr()
 
 }
 
+template<typename TSeq>
+inline ModelSEIRMixing<TSeq> & ModelSEIRMixing<TSeq>::aggregated_on(
+    std::vector< size_t > group_sizes
+)
+{
+
+    this->validate_contact_matrix(group_sizes.size());
+    this->aggregated_enable(std::move(group_sizes));
+
+    return *this;
+
+}
 
-/**
- * @brief Template for a Susceptible-Exposed-Infected-Removed (SEIR) model
- *
- * @param model A Model<TSeq> object where to set up the SIR.
- * @param vname std::string Name of the virus
- * @param prevalence Initial prevalence (proportion)
- * @param transmission_rate Probability of transmission
- * @param recovery_rate Probability of recovery
- * @param contact_matrix Contact matrix specifying expected contacts between groups.
- * Each entry (i,j) represents the expected number of contacts an agent in
- * group i has with agents in group j per day.
- */
 template<typename TSeq>
-inline ModelSEIRMixing<TSeq>::ModelSEIRMixing(
-    const std::string & vname,
-    epiworld_fast_uint n,
-    epiworld_double prevalence,
-    epiworld_double transmission_rate,
-    epiworld_double avg_incubation_days,
-    epiworld_double recovery_rate,
-    std::vector< double > contact_matrix
-    )
+inline ModelSEIRMixing<TSeq> & ModelSEIRMixing<TSeq>::aggregated_off()
 {
 
-    // Setting up the contact matrix
-    this->set_contact_matrix(contact_matrix, true);
+    this->aggregated_disable();
 
-    UpdateFun<TSeq> update_susceptible = [](
-        Agent<TSeq> * p, Model<TSeq> * m
-        ) -> void
+    return *this;
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & ModelSEIRMixing<TSeq>::run_aggregated(
+    epiworld_fast_uint ndays
+)
+{
+
+    const size_t ngroups = this->aggregated_sizes.size();
+    this->validate_contact_matrix(ngroups);
+
+    // Initial infections (exposed), spread across groups
+    std::vector< int > S(ngroups), I(ngroups), R(ngroups);
+    std::vector< int > E = this->aggregated_split(prevalence);
+    for (size_t g = 0u; g < ngroups; ++g)
+    {
+
+        int size_g = static_cast< int >(this->aggregated_sizes[g]);
+
+        if (proportions.size() > 0u)
+        {
+            I[g] = this->rbinom(E[g], proportions[0u]);
+            R[g] = this->rbinom(size_g - E[g], proportions[1u]);
+        }
+        else
         {
+            I[g] = 0;
+            R[g] = 0;
+        }
 
-            if (p->get_n_entities() == 0)
-                return;
+        E[g] -= I[g];
+        S[g] = size_g - E[g] - I[g] - R[g];
 
-            // Downcasting to retrieve the sampler attached to the
-            // class
-            auto * m_down = model_cast<ModelSEIRMixing<TSeq>, TSeq>(m);
+    }
 
-            size_t ndraws = m_down->sample_agents(p, m_down->sampled_agents);
+    std::vector< int > totals = {0, 0, 0, 0};
+    for (size_t g = 0u; g < ngroups; ++g)
+    {
+        totals[SUSCEPTIBLE] += S[g];
+        totals[EXPOSED]     += E[g];
+        totals[INFECTED]    += I[g];
+        totals[RECOVERED]   += R[g];
+    }
 
-            #ifdef EPI_DEBUG
-            m_down->sampled_sizes.push_back(static_cast<int>(ndraws));
-            #endif
+    this->aggregated_setup(ndays, totals, {false, true, true, false});
 
-            if (ndraws == 0u)
-                return;
+    auto & virus = this->get_virus(0u);
+    std::vector< int > new_exposed(ngroups), new_infected(ngroups),
+        new_recovered(ngroups);
 
-            // Drawing from the set
-            int nviruses_tmp = 0;
-            auto & m_ref = *m;
-            for (size_t n = 0u; n < ndraws; ++n)
-            {
+    for (epiworld_fast_uint niter = 0; niter < this->get_ndays(); ++niter)
+    {
 
-                auto & neighbor = m->get_agent(m_down->sampled_agents[n]);
+        epiworld_double p_transmit = virus.get_prob_infecting(this);
+        epiworld_double p_recover  = virus.get_prob_recovery(this);
+        epiworld_double p_onset    = 1.0 / virus.get_incubation(this);
 
-                auto & v = neighbor.get_virus();
+        // All draws use the counts at the start of the day
+        for (size_t i = 0u; i < ngroups; ++i)
+        {
 
-                #ifdef EPI_DEBUG
-                if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
-                    throw std::logic_error(
-                        "Trying to add an extra element to a temporal array outside of the range."
-                    );
-                #endif
+            epiworld_double p_escape =
+                this->aggregated_escape(*this, i, I, p_transmit);
 
-                /* And it is a function of susceptibility_reduction as well */
-                m->array_double_tmp[nviruses_tmp] =
-                    (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
-                    v->get_prob_infecting(m) *
-                    (1.0 - neighbor.get_transmission_reduction(v, m_ref))
-                    ;
+            new_exposed[i]   = this->rbinom(S[i], 1.0 - p_escape);
+            new_infected[i]  = this->rbinom(E[i], p_onset);
+            new_recovered[i] = this->rbinom(I[i], p_recover);
 
-                m->array_virus_tmp[nviruses_tmp++] = &(*v);
+        }
 
-            }
+        for (size_t i = 0u; i < ngroups; ++i)
+        {
 
-            // Running the roulette
-            int which = roulette(nviruses_tmp, m);
+            S[i] -= new_exposed[i];
+            E[i] += new_exposed[i] - new_infected[i];
+            I[i] += new_infected[i] - new_recovered[i];
+            R[i] += new_recovered[i];
 
-            if (which < 0)
-                return;
+            this->aggregated_move(SUSCEPTIBLE, EXPOSED, new_exposed[i]);
+            this->aggregated_move(EXPOSED, INFECTED, new_infected[i]);
+            this->aggregated_move(INFECTED, RECOVERED, new_recovered[i]);
 
-            p->set_virus(*m, 
-                *m->array_virus_tmp[which],
-                ModelSEIRMixing<TSeq>::EXPOSED
-                );
+        }
 
-            return;
+        this->run_globalevents();
 
-        };
+        this->next();
 
-    UpdateFun<TSeq> update_exposed_and_infected = [](
-        Agent<TSeq> * p, Model<TSeq> * m
-        ) -> void {
+    }
 
-            auto state = p->get_state();
+    this->aggregated_end();
+
+    return *this;
+
+}
+
+
+template<typename TSeq>
+inline bool ModelSEIRMixing<TSeq>::update_state_static()
+{
+    return this->template update_state_table<
+        _update_susceptible,
+        _update_exposed_and_infected,
+        _update_exposed_and_infected,
+        nullptr
+        >();
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixing<TSeq>::_update_susceptible(
+    Agent<TSeq> * p, Model<TSeq> * m
+    )
+{
+
+    if (p->get_n_entities() == 0)
+        return;
+
+    // Downcasting to retrieve the sampler attached to the
+    // class
+    auto * m_down = model_cast<ModelSEIRMixing<TSeq>, TSeq>(m);
+
+    size_t ndraws = m_down->sample_agents(p, m_down->sampled_agents);
+
+    #ifdef EPI_DEBUG
+    m_down->sampled_sizes.push_back(static_cast<int>(ndraws));
+    #endif
+
+    if (ndraws == 0u)
+        return;
+
+    // Drawing from the set
+    int nviruses_tmp = 0;
+    auto & m_ref = *m;
+    for (size_t n = 0u; n < ndraws; ++n)
+    {
+
+        auto & neighbor = m->get_agent(m_down->sampled_agents[n]);
+
+        auto & v = neighbor.get_virus();
+
+        #ifdef EPI_DEBUG
+        if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+            throw std::logic_error(
+                "Trying to add an extra element to a temporal array outside of the range."
+            );
+        #endif
+
+        /* And it is a function of susceptibility_reduction as well */
+        m->array_double_tmp[nviruses_tmp] =
+            (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
+            v->get_prob_infecting(m) *
+            (1.0 - neighbor.get_transmission_reduction(v, m_ref))
+            ;
+
+        m->array_virus_tmp[nviruses_tmp++] = &(*v);
+
+    }
+
+    // Running the roulette
+    int which = roulette(nviruses_tmp, m);
+
+    if (which < 0)
+        return;
+
+    p->set_virus(*m, 
+        *m->array_virus_tmp[which],
+        ModelSEIRMixing<TSeq>::EXPOSED
+        );
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixing<TSeq>::_update_exposed_and_infected(
+    Agent<TSeq> * p, Model<TSeq> * m
+    )
+{
+
+    auto state = p->get_state();
+
+    if (state == ModelSEIRMixing<TSeq>::EXPOSED)
+    {
+
+        // Getting the virus
+        auto & v = p->get_virus();
+
+        // Does the agent become infected?
+        if (m->runif() < 1.0/(v->get_incubation(m)))
+        {
 
-            if (state == ModelSEIRMixing<TSeq>::EXPOSED)
-            {
+            p->change_state(*m, ModelSEIRMixing<TSeq>::INFECTED);
+            return;
 
-                // Getting the virus
-                auto & v = p->get_virus();
+        }
 
-                // Does the agent become infected?
-                if (m->runif() < 1.0/(v->get_incubation(m)))
-                {
 
-                    p->change_state(*m, ModelSEIRMixing<TSeq>::INFECTED);
-                    return;
+    } else if (state == ModelSEIRMixing<TSeq>::INFECTED)
+    {
 
-                }
 
+        // Odd: Die, Even: Recover
+        epiworld_fast_uint n_events = 0u;
+        auto & v = p->get_virus();
 
-            } else if (state == ModelSEIRMixing<TSeq>::INFECTED)
-            {
+        // Recover
+        m->array_double_tmp[n_events++] =
+            1.0 - (1.0 - v->get_prob_recovery(m)) *
+                (1.0 - p->get_recovery_enhancer(v, *m));
 
+        #ifdef EPI_DEBUG
+        if (n_events == 0u)
+        {
+            printf_epiworld(
+                "[epi-debug] agent %i has 0 possible events!!\n",
+                static_cast<int>(p->get_id())
+                );
+            throw std::logic_error("Zero events in exposed.");
+        }
+        #else
+        if (n_events == 0u)
+            return;
+        #endif
 
-                // Odd: Die, Even: Recover
-                epiworld_fast_uint n_events = 0u;
-                auto & v = p->get_virus();
 
-                // Recover
-                m->array_double_tmp[n_events++] =
-                    1.0 - (1.0 - v->get_prob_recovery(m)) *
-                        (1.0 - p->get_recovery_enhancer(v, *m));
+        // Running the roulette
+        int which = roulette(n_events, m);
 
-                #ifdef EPI_DEBUG
-                if (n_events == 0u)
-                {
-                    printf_epiworld(
-                        "[epi-debug] agent %i has 0 possible events!!\n",
-                        static_cast<int>(p->get_id())
-                        );
-                    throw std::logic_error("Zero events in exposed.");
-                }
-                #else
-                if (n_events == 0u)
-                    return;
-                #endif
+        if (which < 0)
+            return;
 
+        // Which roulette happen?
+        p->rm_virus(*m);
 
-                // Running the roulette
-                int which = roulette(n_events, m);
+        return ;
 
-                if (which < 0)
-                    return;
+    } else
+        throw std::logic_error("This function can only be applied to exposed or infected individuals. (SEIR)") ;
 
-                // Which roulette happen?
-                p->rm_virus(*m);
+    return;
 
-                return ;
+}
 
-            } else
-                throw std::logic_error("This function can only be applied to exposed or infected individuals. (SEIR)") ;
+/**
+ * @brief Template for a Susceptible-Exposed-Infected-Removed (SEIR) model
+ *
+ * @param model A Model<TSeq> object where to set up the SIR.
+ * @param vname std::string Name of the virus
+ * @param prevalence Initial prevalence (proportion)
+ * @param transmission_rate Probability of transmission
+ * @param recovery_rate Probability of recovery
+ * @param contact_matrix Contact matrix specifying expected contacts between groups.
+ * Each entry (i,j) represents the expected number of contacts an agent in
+ * group i has with agents in group j per day.
+ */
+template<typename TSeq>
+inline ModelSEIRMixing<TSeq>::ModelSEIRMixing(
+    const std::string & vname,
+    epiworld_fast_uint n,
+    epiworld_double prevalence,
+    epiworld_double transmission_rate,
+    epiworld_double avg_incubation_days,
+    epiworld_double recovery_rate,
+    std::vector< double > contact_matrix
+    )
+{
 
-            return;
+    // Setting up the contact matrix
+    this->set_contact_matrix(contact_matrix, true);
 
-        };
+    this->prevalence = prevalence;
 
     // Setting up parameters
     this->add_param(transmission_rate, "Prob. Transmission");
@@ -23370,9 +28489,9 @@ inline ModelSEIRMixing<TSeq>::ModelSEIRMixing(
     this->add_param(avg_incubation_days, "Avg. Incubation days");
 
     // state
-    this->add_state("Susceptible", update_susceptible);
-    this->add_state("Exposed", update_exposed_and_infected);
-    this->add_state("Infected", update_exposed_and_infected);
+    this->add_state("Susceptible", _update_susceptible);
+    this->add_state("Exposed", _update_exposed_and_infected);
+    this->add_state("Infected", _update_exposed_and_infected);
     this->add_state("Recovered");
 
     // Global function
@@ -23420,6 +28539,8 @@ inline ModelSEIRMixing<TSeq> & ModelSEIRMixing<TSeq>::initial_states(
         create_init_function_seir<TSeq>(proportions_)
         ;
 
+    proportions = proportions_;
+
     return *this;
 
 }
@@ -23468,7 +28589,7 @@ class ModelSIRMixing :
 private:
 
     // Vector of infected agents
-    std::vector< size_t > infected;
+    std::vector< epiworld_agent_index > infected;
     size_t n_infected;
 
     // Number of infected agents in each group
@@ -23478,10 +28599,12 @@ private:
     std::vector< size_t > entity_indices;
 
     void update_infected_list();
-    std::vector< size_t > sampled_agents;
+    void setup_groups(); ///< Sizes and fills the lists by group.
+    void read_checkpoint_derived(std::istream & in) override;
+    std::vector< epiworld_agent_index > sampled_agents;
     size_t sample_agents(
         Agent<TSeq> * agent,
-        std::vector< size_t > & sampled_agents
+        std::vector< epiworld_agent_index > & sampled_agents
         );
 
     std::vector< double > adjusted_contact_rate;
@@ -23490,6 +28613,11 @@ private:
         return j * n + i;
     }
 
+    // Aggregated mode (see aggregated_on())
+    epiworld_double prevalence;
+    std::vector< double > proportions = {};
+    Model<TSeq> & run_aggregated(epiworld_fast_uint ndays) override;
+
 public:
 
     static const int SUSCEPTIBLE = 0;
@@ -23539,6 +28667,34 @@ public:
         return n_infected_per_group[group];
     }
 
+    /**
+     * @name Aggregated mode
+     * @details In aggregated mode, the model keeps counts per group and
+     * state instead of agents. Each day, a susceptible in group `i`
+     * escapes infection from the `I_g` infected in group `g` with
+     * probability \f$(1 - p\,c_{ig}/N_g)^{I_g}\f$, which is what the
+     * agent-based model gives by drawing contacts with the infected
+     * and trying to transmit to each. New infections and recoveries are
+     * then binomial draws from the counts at the start of the day. The
+     * population is released, so memory does not grow with the number of
+     * agents, and the database (e.g., `get_hist_total()`, `write_data()`)
+     * is filled as in the agent-based model.
+     *
+     * Initial infections follow the prevalence passed to the constructor
+     * (spread across groups in proportion to their size), and the
+     * proportions from `initial_states()` are drawn per group. Tools,
+     * entities, and virus distribution functions are not used, and the
+     * virus probabilities must not depend on the agent. Transmission
+     * events are not recorded.
+     *
+     * @param group_sizes Number of agents in each group (one per row of
+     * the contact matrix).
+     */
+    ///@{
+    ModelSIRMixing<TSeq> & aggregated_on(std::vector< size_t > group_sizes);
+    ModelSIRMixing<TSeq> & aggregated_off(); ///< Restores the agents.
+    ///@}
+
 };
 
 template<typename TSeq>
@@ -23575,7 +28731,7 @@ inline void ModelSIRMixing<TSeq>::update_infected_list()
 template<typename TSeq>
 inline size_t ModelSIRMixing<TSeq>::sample_agents(
     Agent<TSeq> * agent,
-    std::vector< size_t > & sampled_agents
+    std::vector< epiworld_agent_index > & sampled_agents
     )
 {
 
@@ -23636,11 +28792,9 @@ inline size_t ModelSIRMixing<TSeq>::sample_agents(
 }
 
 template<typename TSeq>
-inline void ModelSIRMixing<TSeq>::reset()
+inline void ModelSIRMixing<TSeq>::setup_groups()
 {
 
-    Model<TSeq>::reset();
-
     // Checking contact matrix dimensions
     size_t nentities = this->entities.size();
     this->validate_contact_matrix(nentities);
@@ -23680,6 +28834,28 @@ inline void ModelSIRMixing<TSeq>::reset()
 
     this->update_infected_list();
 
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSIRMixing<TSeq>::read_checkpoint_derived(std::istream &)
+{
+
+    this->setup_groups();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSIRMixing<TSeq>::reset()
+{
+
+    Model<TSeq>::reset();
+
+    this->setup_groups();
+
     return;
 }
 
@@ -23691,6 +28867,112 @@ inline std::unique_ptr<Model<TSeq>> ModelSIRMixing<TSeq>::clone_ptr()
 
 }
 
+template<typename TSeq>
+inline ModelSIRMixing<TSeq> & ModelSIRMixing<TSeq>::aggregated_on(
+    std::vector< size_t > group_sizes
+)
+{
+
+    this->validate_contact_matrix(group_sizes.size());
+    this->aggregated_enable(std::move(group_sizes));
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline ModelSIRMixing<TSeq> & ModelSIRMixing<TSeq>::aggregated_off()
+{
+
+    this->aggregated_disable();
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & ModelSIRMixing<TSeq>::run_aggregated(
+    epiworld_fast_uint ndays
+)
+{
+
+    const size_t ngroups = this->aggregated_sizes.size();
+    this->validate_contact_matrix(ngroups);
+
+    // Initial infections, spread across groups
+    std::vector< int > S(ngroups), R(ngroups);
+    std::vector< int > I = this->aggregated_split(prevalence);
+    for (size_t g = 0u; g < ngroups; ++g)
+    {
+
+        int size_g = static_cast< int >(this->aggregated_sizes[g]);
+
+        R[g] = proportions.size() > 0u ?
+            this->rbinom(size_g - I[g], proportions[0u]) : 0;
+
+        S[g] = size_g - I[g] - R[g];
+
+    }
+
+    std::vector< int > totals = {0, 0, 0};
+    for (size_t g = 0u; g < ngroups; ++g)
+    {
+        totals[SUSCEPTIBLE] += S[g];
+        totals[INFECTED]    += I[g];
+        totals[RECOVERED]   += R[g];
+    }
+
+    this->aggregated_setup(ndays, totals, {false, true, false});
+
+    auto & virus = this->get_virus(0u);
+    std::vector< int > new_infected(ngroups), new_recovered(ngroups);
+    n_infected_per_group.assign(ngroups, 0u);
+    for (epiworld_fast_uint niter = 0; niter < this->get_ndays(); ++niter)
+    {
+
+        epiworld_double p_transmit = virus.get_prob_infecting(this);
+        epiworld_double p_recover  = virus.get_prob_recovery(this);
+
+        // All draws use the counts at the start of the day
+        for (size_t i = 0u; i < ngroups; ++i)
+        {
+
+            epiworld_double p_escape =
+                this->aggregated_escape(*this, i, I, p_transmit);
+
+            new_infected[i]  = this->rbinom(S[i], 1.0 - p_escape);
+            new_recovered[i] = this->rbinom(I[i], p_recover);
+
+        }
+
+        for (size_t i = 0u; i < ngroups; ++i)
+        {
+
+            S[i] -= new_infected[i];
+            I[i] += new_infected[i] - new_recovered[i];
+            R[i] += new_recovered[i];
+
+            this->aggregated_move(SUSCEPTIBLE, INFECTED, new_infected[i]);
+            this->aggregated_move(INFECTED, RECOVERED, new_recovered[i]);
+
+        }
+
+        this->run_globalevents();
+
+        // After the global events, which refresh the list from the agents
+        for (size_t i = 0u; i < ngroups; ++i)
+            n_infected_per_group[i] = static_cast< size_t >(I[i]);
+
+        this->next();
+
+    }
+
+    this->aggregated_end();
+
+    return *this;
+
+}
+
 
 /**
  * @brief Template for a Susceptible-Exposed-Infected-Removed (SEIR) model
@@ -23718,6 +29000,8 @@ inline ModelSIRMixing<TSeq>::ModelSIRMixing(
     // Setting up the contact matrix
     this->set_contact_matrix(contact_matrix, true);
 
+    this->prevalence = prevalence;
+
     UpdateFun<TSeq> update_susceptible = [](
         Agent<TSeq> * p, Model<TSeq> * m
         ) -> void
@@ -23883,6 +29167,8 @@ inline ModelSIRMixing<TSeq> & ModelSIRMixing<TSeq>::initial_states(
         create_init_function_sir<TSeq>(proportions_)
         ;
 
+    proportions = proportions_;
+
     return *this;
 
 }
@@ -23960,7 +29246,7 @@ class ModelSEIRMixingQuarantine :
 private:
 
     // Vector of vectors of infected agents
-    std::vector< size_t > infected;
+    std::vector< epiworld_agent_index > infected;
 
     // Number of infected agents in each group
     std::vector< size_t > n_infected_per_group;
@@ -23969,10 +29255,13 @@ private:
     std::vector< size_t > entity_indices;
 
     void _update_infected_list();
-    std::vector< size_t > sampled_agents;
+    void _setup_groups(); ///< Sizes and fills the lists by group.
+    void write_checkpoint_derived(std::ostream & out) const override;
+    void read_checkpoint_derived(std::istream & in) override;
+    std::vector< epiworld_agent_index > sampled_agents;
     size_t _sample_agents(
         Agent<TSeq> * agent,
-        std::vector< size_t > & sampled_agents
+        std::vector< epiworld_agent_index > & sampled_agents
         );
     std::vector< double > adjusted_contact_rate;
 
@@ -24177,7 +29466,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_infected_list()
 template<typename TSeq>
 inline size_t ModelSEIRMixingQuarantine<TSeq>::_sample_agents(
     Agent<TSeq> * agent,
-    std::vector< size_t > & sampled_agents
+    std::vector< epiworld_agent_index > & sampled_agents
     )
 {
 
@@ -24242,11 +29531,9 @@ inline size_t ModelSEIRMixingQuarantine<TSeq>::_sample_agents(
 }
 
 template<typename TSeq>
-inline void ModelSEIRMixingQuarantine<TSeq>::reset()
+inline void ModelSEIRMixingQuarantine<TSeq>::_setup_groups()
 {
 
-    Model<TSeq>::reset();
-
     // Checking contact matrix dimensions
     size_t nentities = this->entities.size();
     this->validate_contact_matrix(nentities);
@@ -24274,6 +29561,50 @@ inline void ModelSEIRMixingQuarantine<TSeq>::reset()
 
     this->_update_infected_list();
 
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::write_checkpoint_derived(std::ostream & out) const
+{
+
+    checkpoint_write(out, quarantine_willingness);
+    checkpoint_write(out, isolation_willingness);
+    checkpoint_write(out, agent_quarantine_triggered);
+    checkpoint_write(out, day_flagged);
+    checkpoint_write(out, day_onset);
+    checkpoint_write(out, day_exposed);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::read_checkpoint_derived(std::istream & in)
+{
+
+    this->_setup_groups();
+
+    checkpoint_read(in, quarantine_willingness);
+    checkpoint_read(in, isolation_willingness);
+    checkpoint_read(in, agent_quarantine_triggered);
+    checkpoint_read(in, day_flagged);
+    checkpoint_read(in, day_onset);
+    checkpoint_read(in, day_exposed);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::reset()
+{
+
+    Model<TSeq>::reset();
+
+    this->_setup_groups();
+
     // Setting up the quarantine parameters
     quarantine_willingness.resize(this->size(), false);
     isolation_willingness.resize(this->size(), false);
@@ -24397,12 +29728,19 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_infected(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_days_undetected =
+        Model<TSeq>::param_id("Days undetected");
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
     auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
 
     // Sampling whether the agent is detected or not.
     // If Days undetected < 0, detection is disabled (never detected).
     // If Days undetected == 0, the agent is always detected.
-    epiworld_double days_undetected = m->par("Days undetected");
+    epiworld_double days_undetected = m->par(par_days_undetected);
     bool detected = (days_undetected < 0.0) ?
         false : ((days_undetected == 0.0) ?
             true : (m->runif() < 1.0 / days_undetected));
@@ -24417,7 +29755,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_infected(
 
     // Checking if the agent is willing to isolate individually
     // This is separate from quarantine and can happen even if agent cannot quarantine
-    bool isolation_detected = (m->par("Isolation period") >= 0) &&
+    bool isolation_detected = (m->par(par_isolation_period) >= 0) &&
         detected &&
         (model->isolation_willingness[p->get_id()])
     ;
@@ -24430,7 +29768,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_infected(
     auto & v = p->get_virus();
     m->array_double_tmp[0] = 1.0 - (1.0 - v->get_prob_recovery(m)) *
         (1.0 - p->get_recovery_enhancer(v, *m));
-    m->array_double_tmp[1] = m->par("Hospitalization rate");
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
 
     auto which = m->sample_from_probs(2);
 
@@ -24469,6 +29807,11 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_isolated(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
     auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
 
     // Figuring out if the agent can be released from isolation
@@ -24476,7 +29819,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_isolated(
     int days_since = m->today() - model->day_onset[p->get_id()];
 
     bool unisolate =
-        (m->par("Isolation period") <= days_since) ?
+        (m->par(par_isolation_period) <= days_since) ?
         true: false;
 
     // Sampling from the probabilities of recovery
@@ -24485,7 +29828,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_isolated(
         (1.0 - p->get_recovery_enhancer(p->get_virus(), *m));
 
     // And hospitalization
-    m->array_double_tmp[1] = m->par("Hospitalization rate");
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
 
     auto which = m->sample_from_probs(2);
 
@@ -24517,6 +29860,9 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_quarantine_suscep(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
     auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
 
     // Figuring out if the agent can be released from quarantine
@@ -24524,7 +29870,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_quarantine_suscep(
     int days_since = m->today() - model->day_flagged[p->get_id()];
 
     bool unquarantine =
-        (m->par("Quarantine period") <= days_since) ?
+        (m->par(par_quarantine_period) <= days_since) ?
         true: false;
 
     if (unquarantine)
@@ -24541,6 +29887,9 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_quarantine_exposed(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
     auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
 
     // Figuring out if the agent can be released from quarantine
@@ -24548,7 +29897,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_quarantine_exposed(
     int days_since = m->today() - model->day_flagged[p->get_id()];
 
     bool unquarantine =
-        (m->par("Quarantine period") <= days_since) ?
+        (m->par(par_quarantine_period) <= days_since) ?
         true: false;
 
     if (m->runif() < 1.0/(p->get_virus()->get_incubation(m)))
@@ -24586,6 +29935,9 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_isolated_recovered(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+
     auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
 
     // Figuring out if the agent can be released from isolation
@@ -24593,7 +29945,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_isolated_recovered(
     int days_since = m->today() - model->day_onset[p->get_id()];
 
     bool unisolate =
-        (m->par("Isolation period") <= days_since) ?
+        (m->par(par_isolation_period) <= days_since) ?
         true: false;
 
     if (unisolate)
@@ -24610,8 +29962,11 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_hospitalized(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_hospitalization_period =
+        Model<TSeq>::param_id("Hospitalization period");
+
     // The agent is removed from the system
-    if (m->runif() < 1.0/m->par("Hospitalization period"))
+    if (m->runif() < 1.0/m->par(par_hospitalization_period))
         p->rm_virus(*m, ModelSEIRMixingQuarantine<TSeq>::RECOVERED);
 
 };
@@ -24619,6 +29974,13 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_hospitalized(
 template<typename TSeq>
 inline void ModelSEIRMixingQuarantine<TSeq>::_quarantine_process(Model<TSeq> * m) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+    static const size_t par_contact_tracing_success_rate =
+        Model<TSeq>::param_id("Contact tracing success rate");
+    static const size_t par_contact_tracing_days_prior =
+        Model<TSeq>::param_id("Contact tracing days prior");
+
     auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
 
     // Process entity-level quarantine
@@ -24633,7 +29995,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_quarantine_process(Model<TSeq> * m
         )
             continue;
 
-        if (m->par("Quarantine period") < 0)
+        if (m->par(par_quarantine_period) < 0)
         {
             model->agent_quarantine_triggered[agent_i] =
             ModelSEIRMixingQuarantine<TSeq>::QUARANTINE_PROCESS_DONE;
@@ -24648,8 +30010,8 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_quarantine_process(Model<TSeq> * m
         if (n_contacts >= EPI_MAX_TRACKING)
             n_contacts = EPI_MAX_TRACKING;
 
-        auto success_rate = m->par("Contact tracing success rate");
-        auto days_prior = m->par("Contact tracing days prior");
+        auto success_rate = m->par(par_contact_tracing_success_rate);
+        auto days_prior = m->par(par_contact_tracing_days_prior);
         for (size_t contact_i = 0u; contact_i < n_contacts; ++contact_i)
         {
 
@@ -24940,6 +30302,8 @@ private:
     std::vector< int > day_onset; ///< Day of onset of the disease
 
     static void _quarantine_process(Model<TSeq> * m);
+    void write_checkpoint_derived(std::ostream & out) const override;
+    void read_checkpoint_derived(std::istream & in) override;
 
 public:
 
@@ -25052,6 +30416,34 @@ public:
 // -----------------------------------------------------------------------
 // Reset
 // -----------------------------------------------------------------------
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::write_checkpoint_derived(std::ostream & out) const
+{
+
+    checkpoint_write(out, quarantine_willingness);
+    checkpoint_write(out, isolation_willingness);
+    checkpoint_write(out, agent_quarantine_triggered);
+    checkpoint_write(out, day_flagged);
+    checkpoint_write(out, day_onset);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::read_checkpoint_derived(std::istream & in)
+{
+
+    checkpoint_read(in, quarantine_willingness);
+    checkpoint_read(in, isolation_willingness);
+    checkpoint_read(in, agent_quarantine_triggered);
+    checkpoint_read(in, day_flagged);
+    checkpoint_read(in, day_onset);
+
+    return;
+
+}
+
 template<typename TSeq>
 inline void ModelSEIRNetworkQuarantine<TSeq>::reset()
 {
@@ -25091,19 +30483,19 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_susceptible(
 ) {
 
     size_t nviruses_tmp = 0u;
-    for (auto & neighbor : p->get_neighbors(*m))
+    for (auto & neighbor : p->neighbors(*m))
     {
-        auto & v = neighbor->get_virus();
+        auto & v = neighbor.get_virus();
         if (v == nullptr)
             continue;
 
         // Only infectious agents can transmit
-        if (neighbor->get_state() != ModelSEIRNetworkQuarantine<TSeq>::INFECTED)
+        if (neighbor.get_state() != ModelSEIRNetworkQuarantine<TSeq>::INFECTED)
             continue;
 
         // Record contact for tracing: infected neighbor -> susceptible agent
         m->get_contact_tracing().add_contact(
-            neighbor->get_id(),
+            neighbor.get_id(),
             p->get_id(),
             static_cast<size_t>(m->today())
         );
@@ -25118,7 +30510,7 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_susceptible(
         m->array_double_tmp[nviruses_tmp] =
             (1.0 - p->get_susceptibility_reduction(v, *m)) *
             v->get_prob_infecting(m) *
-            (1.0 - neighbor->get_transmission_reduction(v, *m));
+            (1.0 - neighbor.get_transmission_reduction(v, *m));
 
         m->array_virus_tmp[nviruses_tmp++] = &(*v);
     }
@@ -25169,12 +30561,19 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_infected(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_days_undetected =
+        Model<TSeq>::param_id("Days undetected");
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
     auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
 
     // Sampling whether the agent is detected or not.
     // If Days undetected < 0, detection is disabled (never detected).
     // If Days undetected == 0, the agent is always detected.
-    epiworld_double days_undetected = m->par("Days undetected");
+    epiworld_double days_undetected = m->par(par_days_undetected);
     bool detected = (days_undetected < 0.0) ?
         false : ((days_undetected == 0.0) ?
             true : (m->runif() < 1.0 / days_undetected));
@@ -25187,7 +30586,7 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_infected(
     }
 
     // Checking if the agent is willing to isolate individually
-    bool isolation_detected = (m->par("Isolation period") >= 0) &&
+    bool isolation_detected = (m->par(par_isolation_period) >= 0) &&
         detected &&
         (model->isolation_willingness[p->get_id()]);
 
@@ -25199,7 +30598,7 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_infected(
     auto & v = p->get_virus();
     m->array_double_tmp[0] = 1.0 - (1.0 - v->get_prob_recovery(m)) *
         (1.0 - p->get_recovery_enhancer(v, *m));
-    m->array_double_tmp[1] = m->par("Hospitalization rate");
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
 
     auto which = m->sample_from_probs(2);
 
@@ -25247,12 +30646,17 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_isolated(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
     auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
 
     int days_since = m->today() - model->day_onset[p->get_id()];
 
     bool unisolate =
-        (m->par("Isolation period") <= days_since) ?
+        (m->par(par_isolation_period) <= days_since) ?
         true : false;
 
     // Sampling from the probabilities of recovery
@@ -25261,7 +30665,7 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_isolated(
         (1.0 - p->get_recovery_enhancer(p->get_virus(), *m));
 
     // And hospitalization
-    m->array_double_tmp[1] = m->par("Hospitalization rate");
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
 
     auto which = m->sample_from_probs(2);
 
@@ -25306,12 +30710,15 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_quarantine_suscep(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
     auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
 
     int days_since = m->today() - model->day_flagged[p->get_id()];
 
     bool unquarantine =
-        (m->par("Quarantine period") <= days_since) ?
+        (m->par(par_quarantine_period) <= days_since) ?
         true : false;
 
     if (unquarantine)
@@ -25331,12 +30738,15 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_quarantine_exposed(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
     auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
 
     int days_since = m->today() - model->day_flagged[p->get_id()];
 
     bool unquarantine =
-        (m->par("Quarantine period") <= days_since) ?
+        (m->par(par_quarantine_period) <= days_since) ?
         true : false;
 
     if (m->runif() < 1.0/(p->get_virus()->get_incubation(m)))
@@ -25374,12 +30784,15 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_isolated_recovered(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+
     auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
 
     int days_since = m->today() - model->day_onset[p->get_id()];
 
     bool unisolate =
-        (m->par("Isolation period") <= days_since) ?
+        (m->par(par_isolation_period) <= days_since) ?
         true : false;
 
     if (unisolate)
@@ -25399,7 +30812,10 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_hospitalized(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
-    if (m->runif() < 1.0/m->par("Hospitalization period"))
+    static const size_t par_hospitalization_period =
+        Model<TSeq>::param_id("Hospitalization period");
+
+    if (m->runif() < 1.0/m->par(par_hospitalization_period))
         p->rm_virus(*m, ModelSEIRNetworkQuarantine<TSeq>::RECOVERED);
 
 };
@@ -25412,6 +30828,13 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_quarantine_process(
     Model<TSeq> * m
 ) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+    static const size_t par_contact_tracing_success_rate =
+        Model<TSeq>::param_id("Contact tracing success rate");
+    static const size_t par_contact_tracing_days_prior =
+        Model<TSeq>::param_id("Contact tracing days prior");
+
     auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
 
     for (size_t agent_i = 0u; agent_i < m->size(); ++agent_i)
@@ -25423,7 +30846,7 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_quarantine_process(
         )
             continue;
 
-        if (m->par("Quarantine period") < 0)
+        if (m->par(par_quarantine_period) < 0)
         {
             model->agent_quarantine_triggered[agent_i] = QUARANTINE_PROCESS_DONE;
             continue;
@@ -25433,8 +30856,8 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_quarantine_process(
         if (n_contacts >= EPI_MAX_TRACKING)
             n_contacts = EPI_MAX_TRACKING;
 
-        auto success_rate = m->par("Contact tracing success rate");
-        auto days_prior = m->par("Contact tracing days prior");
+        auto success_rate = m->par(par_contact_tracing_success_rate);
+        auto days_prior = m->par(par_contact_tracing_days_prior);
         for (size_t contact_i = 0u; contact_i < n_contacts; ++contact_i)
         {
             // Checking if we will detect the contact
@@ -25647,6 +31070,24 @@ namespace std {
     >(epiworld::epi_xoshiro256ss& eng) {
         return static_cast<float>(eng() >> 40) * 0x1.0p-24f;
     }
+
+    template<>
+    inline double generate_canonical<
+        double,
+        numeric_limits<double>::digits,
+        epiworld::epi_philox4x32
+    >(epiworld::epi_philox4x32& eng) {
+        return static_cast<double>(eng() >> 11) * 0x1.0p-53;
+    }
+
+    template<>
+    inline float generate_canonical<
+        float,
+        numeric_limits<float>::digits,
+        epiworld::epi_philox4x32
+    >(epiworld::epi_philox4x32& eng) {
+        return static_cast<float>(eng() >> 40) * 0x1.0p-24f;
+    }
 }
 
 #endif
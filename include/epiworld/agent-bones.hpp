@@ -46,11 +46,9 @@ class Agent {
     friend class AgentsSample<TSeq>;
 protected:
 
-    std::vector< size_t > * neighbors = nullptr;
-    std::vector< size_t > * neighbors_locations = nullptr;
-    size_t n_neighbors = 0u;
+    size_t n_neighbors = 0u; ///< Degree (ties are stored in `Model<TSeq>::network`).
 
-    std::vector< size_t > entities; ///< Entity IDs (indices into Model::entities)
+    std::vector< epiworld_agent_index > entities; ///< Entity IDs (indices into Model::entities)
 
     unsigned int state = 0u;
     unsigned int state_prev = 0u; ///< For accounting, if need to undo a change.
@@ -62,6 +60,20 @@ protected:
 
     std::vector< ToolPtr<TSeq> > tools;
 
+    /**
+     * @name Cached tool effects
+     * @details `tools_effects[k]` is the product of `(1 - effect k)` across
+     * the agent's tools, valid when bit `k` of `tools_effects_fixed` is on
+     * (i.e., all the tools have a constant k-th effect; see
+     * `Tool<TSeq>::fixed_mask`). Refreshed every time the tools change, so
+     * the mixers in `Model<TSeq>` can skip calling the tools' functions.
+     */
+    ///@{
+    epiworld_double tools_effects[4u] = {1.0, 1.0, 1.0, 1.0};
+    unsigned char tools_effects_fixed = 0x0Fu;
+    void tools_effects_update();
+    ///@}
+
     void reset(); ///< Resets the agent to the initial state (no virus, no tools, no entities, state 0.)
 
 public:
@@ -169,6 +181,7 @@ public:
     void mutate_virus();
     void add_neighbor(
         Agent<TSeq> & p,
+        Model<TSeq> & model,
         bool check_source = true,
         bool check_target = true
         );
@@ -188,6 +201,7 @@ public:
     );
 
     std::vector< Agent<TSeq> * > get_neighbors(Model<TSeq> & model);
+    AgentNeighbors<TSeq> neighbors(Model<TSeq> & model); ///< Non-allocating view of the neighbors.
     size_t get_n_neighbors() const;
 
     void change_state(
@@ -228,7 +242,7 @@ public:
     double operator()(size_t j, const Model<TSeq> & model) const;
     ///@}
 
-    const std::vector< size_t > & get_entities() const;
+    const std::vector< epiworld_agent_index > & get_entities() const;
 
     const Entity<TSeq> & get_entity(size_t i, const Model<TSeq> & model) const;
     Entity<TSeq> & get_entity(size_t i, Model<TSeq> & model);
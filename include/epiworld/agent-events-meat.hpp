@@ -61,6 +61,7 @@ inline void Model<TSeq>::_event_add_tool(Event<TSeq> & a)
 
     p->tools[tool_pos]->set_date(today());
     p->tools[tool_pos]->set_agent(p, tool_pos);
+    p->tools_effects_update();
 
     // Change of state needs to be recorded and updated on the
     // tools.
@@ -152,6 +153,8 @@ inline void Model<TSeq>::_event_rm_tool(Event<TSeq> & a)
 
         for (size_t i = 0u; i < p->tools.size(); ++i)
             p->tools[i]->pos_in_agent = static_cast<int>(i);
+
+        p->tools_effects_update();
     }
 
     // Change of state needs to be recorded and updated on the
@@ -245,8 +248,8 @@ inline void Model<TSeq>::_event_add_entity(Event<TSeq> & a)
     }
 
     // Adding the to agent and the entity
-    p->entities.push_back(static_cast<size_t>(e->get_id()));
-    e->agents.push_back(static_cast<size_t>(p->get_id()));
+    p->entities.push_back(static_cast<epiworld_agent_index>(e->get_id()));
+    e->agents.push_back(static_cast<epiworld_agent_index>(p->get_id()));
 
 }
 
@@ -262,7 +265,7 @@ inline void Model<TSeq>::_event_rm_entity(Event<TSeq> & a)
         std::remove(
             p.entities.begin(),
             p.entities.end(),
-            static_cast<size_t>(e.get_id())
+            static_cast<epiworld_agent_index>(e.get_id())
         ),
         p.entities.end()
     );
@@ -272,7 +275,7 @@ inline void Model<TSeq>::_event_rm_entity(Event<TSeq> & a)
         std::remove(
             e.agents.begin(),
             e.agents.end(),
-            static_cast<size_t>(p.get_id())
+            static_cast<epiworld_agent_index>(p.get_id())
         ),
         e.agents.end()
     );
@@ -43,10 +43,10 @@ inline std::function<void(Agent<TSeq>*,Model<TSeq>*)> make_update_susceptible(
 
                 // This computes the prob of getting any neighbor variant
                 size_t nviruses_tmp = 0u;
-                for (auto & neighbor: p->get_neighbors(*m)) 
+                for (auto & neighbor: p->neighbors(*m)) 
                 {
                     
-                    auto & v = neighbor->get_virus();
+                    auto & v = neighbor.get_virus();
                     if (v == nullptr)
                         continue;
                     
@@ -54,7 +54,7 @@ inline std::function<void(Agent<TSeq>*,Model<TSeq>*)> make_update_susceptible(
                     m->array_double_tmp[nviruses_tmp] =
                         (1.0 - p->get_susceptibility_reduction(v, *m)) * 
                         v->get_prob_infecting(m) * 
-                        (1.0 - neighbor->get_transmission_reduction(v, *m)) 
+                        (1.0 - neighbor.get_transmission_reduction(v, *m)) 
                         ; 
                 
                     m->array_virus_tmp[nviruses_tmp++] = &(*v);
@@ -121,14 +121,14 @@ inline std::function<void(Agent<TSeq>*,Model<TSeq>*)> make_update_susceptible(
 
                 // This computes the prob of getting any neighbor variant
                 size_t nviruses_tmp = 0u;
-                for (auto & neighbor: p->get_neighbors(*m)) 
+                for (auto & neighbor: p->neighbors(*m)) 
                 {
 
                     // If the state is in the list, exclude it
-                    if (exclude_agent_bool->operator[](neighbor->get_state()))
+                    if (exclude_agent_bool->operator[](neighbor.get_state()))
                         continue;
 
-                    auto & v = neighbor->get_virus();
+                    auto & v = neighbor.get_virus();
                     if (v == nullptr)
                         continue;
                             
@@ -137,7 +137,7 @@ inline std::function<void(Agent<TSeq>*,Model<TSeq>*)> make_update_susceptible(
                     m->array_double_tmp[nviruses_tmp] =
                         (1.0 - p->get_susceptibility_reduction(v, *m)) * 
                         v->get_prob_infecting(m) * 
-                        (1.0 - neighbor->get_transmission_reduction(v, *m)) 
+                        (1.0 - neighbor.get_transmission_reduction(v, *m)) 
                         ; 
                 
                     m->array_virus_tmp[nviruses_tmp++] = &(*v);
@@ -199,13 +199,13 @@ inline std::function<Virus<TSeq>*(Agent<TSeq>*,Model<TSeq>*)> make_sample_virus_
 
                 // This computes the prob of getting any neighbor variant
                 size_t nviruses_tmp = 0u;
-                for (auto & neighbor: p->get_neighbors(*m)) 
+                for (auto & neighbor: p->neighbors(*m)) 
                 {
                     
-                    if (neighbor->get_virus() == nullptr)
+                    if (neighbor.get_virus() == nullptr)
                         continue;
 
-                    auto & v = neighbor->get_virus();
+                    auto & v = neighbor.get_virus();
 
                     #ifdef EPI_DEBUG
                     if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
@@ -216,7 +216,7 @@ inline std::function<Virus<TSeq>*(Agent<TSeq>*,Model<TSeq>*)> make_sample_virus_
                     m->array_double_tmp[nviruses_tmp] =
                         (1.0 - p->get_susceptibility_reduction(v, *m)) * 
                         v->get_prob_infecting(m) * 
-                        (1.0 - neighbor->get_transmission_reduction(v, *m)) 
+                        (1.0 - neighbor.get_transmission_reduction(v, *m)) 
                         ; 
                 
                     m->array_virus_tmp[nviruses_tmp++] = &(*v);
@@ -283,17 +283,17 @@ inline std::function<Virus<TSeq>*(Agent<TSeq>*,Model<TSeq>*)> make_sample_virus_
 
                 // This computes the prob of getting any neighbor variant
                 size_t nviruses_tmp = 0u;
-                for (auto & neighbor: p->get_neighbors(*m)) 
+                for (auto & neighbor: p->neighbors(*m)) 
                 {
 
                     // If the state is in the list, exclude it
-                    if (exclude_agent_bool->operator[](neighbor->get_state()))
+                    if (exclude_agent_bool->operator[](neighbor.get_state()))
                         continue;
 
-                    if (neighbor->get_virus() == nullptr)
+                    if (neighbor.get_virus() == nullptr)
                         continue;
 
-                    auto & v = neighbor->get_virus();
+                    auto & v = neighbor.get_virus();
                             
                     #ifdef EPI_DEBUG
                     if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
@@ -304,7 +304,7 @@ inline std::function<Virus<TSeq>*(Agent<TSeq>*,Model<TSeq>*)> make_sample_virus_
                     m->array_double_tmp[nviruses_tmp] =
                         (1.0 - p->get_susceptibility_reduction(v, *m)) * 
                         v->get_prob_infecting(m) * 
-                        (1.0 - neighbor->get_transmission_reduction(v, *m)) 
+                        (1.0 - neighbor.get_transmission_reduction(v, *m)) 
                         ; 
                 
                     m->array_virus_tmp[nviruses_tmp++] = &(*v);
@@ -360,16 +360,16 @@ inline Virus<TSeq> * sample_virus_single(Agent<TSeq> * p, Model<TSeq> * m)
 
     // This computes the prob of getting any neighbor variant
     size_t nviruses_tmp = 0u;
-    for (auto & neighbor: p->get_neighbors(*m)) 
+    for (auto & neighbor: p->neighbors(*m)) 
     {   
         #ifdef EPI_DEBUG
         int _vcount_neigh = 0;
         #endif                
 
-        if (neighbor->get_virus() == nullptr)
+        if (neighbor.get_virus() == nullptr)
             continue;
 
-        auto & v = neighbor->get_virus();
+        auto & v = neighbor.get_virus();
 
         #ifdef EPI_DEBUG
         if (nviruses_tmp >= m->array_virus_tmp.size())
@@ -380,7 +380,7 @@ inline Virus<TSeq> * sample_virus_single(Agent<TSeq> * p, Model<TSeq> * m)
         m->array_double_tmp[nviruses_tmp] =
             (1.0 - p->get_susceptibility_reduction(v, *m)) * 
             v->get_prob_infecting(m) * 
-            (1.0 - neighbor->get_transmission_reduction(v, *m)) 
+            (1.0 - neighbor.get_transmission_reduction(v, *m)) 
             ; 
     
         m->array_virus_tmp[nviruses_tmp++] = &(*v);
@@ -393,7 +393,7 @@ inline Virus<TSeq> * sample_virus_single(Agent<TSeq> * p, Model<TSeq> * m)
         {
             printf_epiworld(
                 "[epi-debug] Agent %i's virus %i has transmission prob outside of [0, 1]: %.4f!\n",
-                static_cast<int>(neighbor->get_id()),
+                static_cast<int>(neighbor.get_id()),
                 static_cast<int>(_vcount_neigh++),
                 m->array_double_tmp[nviruses_tmp - 1]
                 );
@@ -408,6 +408,7 @@ inline Virus<TSeq> * sample_virus_single(Agent<TSeq> * p, Model<TSeq> * m)
         return nullptr;
 
     #ifdef EPI_DEBUG
+    #pragma omp atomic
     m->get_db().n_transmissions_potential++;
     #endif
 
@@ -418,6 +419,7 @@ inline Virus<TSeq> * sample_virus_single(Agent<TSeq> * p, Model<TSeq> * m)
         return nullptr;
 
     #ifdef EPI_DEBUG
+    #pragma omp atomic
     m->get_db().n_transmissions_today++;
     #endif
 
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <string>
+#include <typeinfo>
 #include "config.hpp"
 #include "epiworld-macros.hpp"
 #include "agent-bones.hpp"
@@ -10,8 +11,6 @@
 
 template<typename TSeq>
 inline Agent<TSeq>::Agent(Agent<TSeq> && p) :
-    neighbors(std::move(p.neighbors)),
-    neighbors_locations(std::move(p.neighbors_locations)),
     n_neighbors(p.n_neighbors),
     entities(std::move(p.entities)),
     state(p.state),
@@ -21,6 +20,12 @@ inline Agent<TSeq>::Agent(Agent<TSeq> && p) :
     tools(std::move(p.tools)) /// Needs to be adjusted
 {
 
+    std::copy(
+        std::begin(p.tools_effects), std::end(p.tools_effects),
+        std::begin(tools_effects)
+    );
+    tools_effects_fixed = p.tools_effects_fixed;
+
     state = p.state;
     id     = p.id;
     
@@ -47,18 +52,10 @@ inline Agent<TSeq>::Agent(Agent<TSeq> && p) :
 // Copy constructor
 template<typename TSeq>
 inline Agent<TSeq>::Agent(const Agent<TSeq> & p) :
-    neighbors(nullptr),
-    neighbors_locations(nullptr),
     n_neighbors(p.n_neighbors),
     entities(p.entities)
 {
 
-    if (n_neighbors > 0u)
-    {
-        neighbors = new std::vector< size_t >(*p.neighbors);
-        neighbors_locations = new std::vector< size_t >(*p.neighbors_locations);
-    }
-
     state = p.state;
     id     = p.id;
     
@@ -78,6 +75,8 @@ inline Agent<TSeq>::Agent(const Agent<TSeq> & p) :
         tools.back()->set_agent(this, i);
 
     }
+
+    tools_effects_update();
     
 }
 
@@ -88,22 +87,6 @@ inline Agent<TSeq> & Agent<TSeq>::operator=(
 {
 
     n_neighbors = other_agent.n_neighbors;
-    if (neighbors != nullptr)
-    {
-        delete neighbors;
-        delete neighbors_locations;
-    }
-
-    if (other_agent.n_neighbors > 0u)
-    {
-        neighbors = new std::vector< size_t >(*other_agent.neighbors);
-        neighbors_locations = new std::vector< size_t >(*other_agent.neighbors_locations);
-    }
-    else 
-    {
-        neighbors = nullptr;
-        neighbors_locations = nullptr;
-    }
     
     entities = other_agent.entities;
 
@@ -127,6 +110,8 @@ inline Agent<TSeq> & Agent<TSeq>::operator=(
         tools.emplace_back(std::shared_ptr<Tool<TSeq>>(other_agent.tools[i]->clone_ptr()));
         tools.back()->set_agent(this, i);
     }
+
+    tools_effects_update();
     
     return *this;
     
@@ -136,12 +121,6 @@ template<typename TSeq>
 inline Agent<TSeq>::~Agent()
 {
 
-    if (neighbors != nullptr)
-    {
-        delete neighbors;
-        delete neighbors_locations;
-    }
-
 }
 
 template<typename TSeq>
@@ -342,6 +321,31 @@ inline void Agent<TSeq>::rm_entity(
     );
 }
 
+template<typename TSeq>
+inline void Agent<TSeq>::tools_effects_update()
+{
+
+    tools_effects_fixed = 0x0Fu;
+    for (auto & e : tools_effects)
+        e = 1.0;
+
+    for (auto & tool : tools)
+    {
+
+        // Derived tools may override the getters, so only plain tools
+        // are trusted to report their constant effects
+        unsigned char mask = (typeid(*tool) == typeid(Tool<TSeq>)) ?
+            tool->def->fixed_mask : 0u;
+
+        tools_effects_fixed &= mask;
+        for (size_t k = 0u; k < 4u; ++k)
+            if (mask & (1u << k))
+                tools_effects[k] *= (1.0 - tool->def->fixed_value[k]);
+
+    }
+
+}
+
 template<typename TSeq>
 inline epiworld_double Agent<TSeq>::get_susceptibility_reduction(
     VirusPtr<TSeq> & v,
@@ -438,72 +442,21 @@ inline void Agent<TSeq>::mutate_virus()
 template<typename TSeq>
 inline void Agent<TSeq>::add_neighbor(
     Agent<TSeq> & p,
+    Model<TSeq> & model,
     bool check_source,
     bool check_target
 ) {
-    // Can we find the neighbor?
-    bool found = false;
-
-    if (neighbors == nullptr)
-    {
-        neighbors = new std::vector< size_t >();
-        neighbors_locations = new std::vector< size_t >();
-    }
-
-    if (check_source && neighbors)
-    {
-
-        for (auto & n: *neighbors)    
-            if (static_cast<int>(n) == p.get_id())
-            {
-                found = true;
-                break;
-            }
-
-    }
-
-    // Three things going on here:
-    // - Where in the neighbor will this be
-    // - What is the neighbor's id
-    // - Increasing the number of neighbors
-    if (!found)
-    {
-
-        neighbors_locations->push_back(p.get_n_neighbors());
-        neighbors->push_back(p.get_id());
-        n_neighbors++;
-
-    }
-
-
-    found = false;
-    if (check_target && p.neighbors)
-    {
-       
-        for (auto & n: *p.neighbors)
-            if (static_cast<int>(n) == id)
-            {
-                found = true;
-                break;
-            }
-    
-    }
-
-    if (!found)
-    {
 
-        if (p.neighbors == nullptr)
-        {
-            p.neighbors = new std::vector< size_t >();
-            p.neighbors_locations = new std::vector< size_t >();
-        }
+    auto & net = model.get_network_mutable();
+    net.add_edge(
+        static_cast< size_t >(id),
+        static_cast< size_t >(p.id),
+        check_source,
+        check_target
+    );
 
-        p.neighbors_locations->push_back(n_neighbors - 1);
-        p.neighbors->push_back(id);
-        p.n_neighbors++;
-        
-    }
-    
+    n_neighbors   = net.degree(id);
+    p.n_neighbors = net.degree(p.id);
 
 }
 
@@ -527,31 +480,36 @@ inline void Agent<TSeq>::swap_neighbors(
             std::to_string(other.n_neighbors) + " neighbors."
         );
 
-    // Getting the agents
-    auto & pop = model.population;
-    auto & neigh_this  = pop[(*neighbors)[n_this]];
-    auto & neigh_other = pop[(*other.neighbors)[n_other]];
+    // Getting the rows of the agents in the network
+    auto & net = model.get_network_mutable();
+    epiworld_agent_index * neighbors       = net.neighbors(id);
+    epiworld_agent_index * other_neighbors = net.neighbors(other.id);
+    epiworld_agent_index * locations       = net.neighbors_locations(id);
+    epiworld_agent_index * other_locations = net.neighbors_locations(other.id);
+
+    size_t neigh_this  = neighbors[n_this];
+    size_t neigh_other = other_neighbors[n_other];
 
     // Getting the locations in the neighbors
-    size_t loc_this_in_neigh = (*neighbors_locations)[n_this];
-    size_t loc_other_in_neigh = (*other.neighbors_locations)[n_other];
+    size_t loc_this_in_neigh = locations[n_this];
+    size_t loc_other_in_neigh = other_locations[n_other];
 
     // Changing ids
-    std::swap((*neighbors)[n_this], (*other.neighbors)[n_other]);
+    std::swap(neighbors[n_this], other_neighbors[n_other]);
 
     if (!model.directed)
     {
         std::swap(
-            (*neigh_this.neighbors)[loc_this_in_neigh],
-            (*neigh_other.neighbors)[loc_other_in_neigh]
+            net.neighbors(neigh_this)[loc_this_in_neigh],
+            net.neighbors(neigh_other)[loc_other_in_neigh]
             );
 
         // Changing the locations
-        std::swap((*neighbors_locations)[n_this], (*other.neighbors_locations)[n_other]);
+        std::swap(locations[n_this], other_locations[n_other]);
         
         std::swap(
-            (*neigh_this.neighbors_locations)[loc_this_in_neigh],
-            (*neigh_other.neighbors_locations)[loc_other_in_neigh]
+            net.neighbors_locations(neigh_this)[loc_this_in_neigh],
+            net.neighbors_locations(neigh_other)[loc_other_in_neigh]
             );
     }
 
@@ -561,11 +519,22 @@ template<typename TSeq>
 inline std::vector< Agent<TSeq> *> Agent<TSeq>::get_neighbors(Model<TSeq> & model)
 {
     std::vector< Agent<TSeq> * > res(n_neighbors, nullptr);
+    const epiworld_agent_index * neighbors = model.network->neighbors(id);
     for (size_t i = 0u; i < n_neighbors; ++i)
-        res[i] = &model.population[(*neighbors)[i]];
+        res[i] = &model.population[neighbors[i]];
     return res;
 }
 
+template<typename TSeq>
+inline AgentNeighbors<TSeq> Agent<TSeq>::neighbors(Model<TSeq> & model)
+{
+    return AgentNeighbors<TSeq>(
+        model.population.data(),
+        model.network->neighbors(id),
+        n_neighbors
+    );
+}
+
 template<typename TSeq>
 inline size_t Agent<TSeq>::get_n_neighbors() const
 {
@@ -610,11 +579,10 @@ inline void Agent<TSeq>::reset()
 
     this->virus = nullptr;
 
+    // Clearing keeps the capacity, so replicates don't reallocate
     this->tools.clear();
-    decltype(this->tools)().swap(this->tools);
-
     this->entities.clear();
-    decltype(this->entities)().swap(this->entities);
+    this->tools_effects_update();
 
     this->state = 0u;
     this->state_prev = 0u;
@@ -792,7 +760,7 @@ inline double Agent<TSeq>::operator()(size_t j, const Model<TSeq> & model) const
 }
 
 template<typename TSeq>
-inline const std::vector< size_t > & Agent<TSeq>::get_entities() const
+inline const std::vector< epiworld_agent_index > & Agent<TSeq>::get_entities() const
 {
     return entities;
 }
@@ -853,14 +821,6 @@ inline bool Agent<TSeq>::operator==(const Agent<TSeq> & other) const
         )
 
     
-    for (size_t i = 0u; i < n_neighbors; ++i)
-    {
-        EPI_DEBUG_FAIL_AT_TRUE(
-            (*neighbors)[i] != (*other.neighbors)[i],
-            "Agent:: neighbor[i] don't match"
-        )
-    }
-    
     EPI_DEBUG_FAIL_AT_TRUE(
         entities.size() != other.entities.size(),
         "Agent:: n_entities don't match"
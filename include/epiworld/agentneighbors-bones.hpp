@@ -0,0 +1,68 @@
+#ifndef EPIWORLD_AGENTNEIGHBORS_BONES_HPP
+#define EPIWORLD_AGENTNEIGHBORS_BONES_HPP
+
+template<typename TSeq>
+class Agent;
+
+/**
+ * @brief Non-owning view over the neighbors of an agent
+ *
+ * @details Iterates over the agent's row of the `Network` and yields
+ * references to the agents in the model's population, without allocating.
+ * The view is invalidated by any change to the network (e.g., adding ties or
+ * rewiring) or to the population. Returned by `Agent::neighbors()`.
+ *
+ * @tparam TSeq
+ */
+template<typename TSeq>
+class AgentNeighbors {
+private:
+    Agent<TSeq> * population;
+    const epiworld_agent_index * ids;
+    size_t n;
+
+public:
+
+    class iterator {
+    private:
+        Agent<TSeq> * population;
+        const epiworld_agent_index * ptr;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Agent<TSeq>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = Agent<TSeq> *;
+        using reference         = Agent<TSeq> &;
+
+        iterator(Agent<TSeq> * population_, const epiworld_agent_index * ptr_) :
+            population(population_), ptr(ptr_) {};
+
+        reference operator*() const { return population[*ptr]; };
+        pointer operator->() const { return &population[*ptr]; };
+
+        iterator & operator++() { ++ptr; return *this; };
+        iterator operator++(int) { iterator tmp = *this; ++ptr; return tmp; };
+
+        bool operator==(const iterator & other) const { return ptr == other.ptr; };
+        bool operator!=(const iterator & other) const { return ptr != other.ptr; };
+    };
+
+    AgentNeighbors(
+        Agent<TSeq> * population_,
+        const epiworld_agent_index * ids_,
+        size_t n_
+    ) : population(population_), ids(ids_), n(n_) {};
+
+    iterator begin() const { return iterator(population, ids); };
+    iterator end() const { return iterator(population, ids + n); };
+
+    size_t size() const noexcept { return n; };
+    bool empty() const noexcept { return n == 0u; };
+
+    Agent<TSeq> & operator[](size_t i) const { return population[ids[i]]; };
+    size_t id(size_t i) const { return ids[i]; }; ///< Id of the i-th neighbor.
+
+};
+
+#endif
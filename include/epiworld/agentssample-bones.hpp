@@ -252,7 +252,7 @@ inline AgentsSample<TSeq>::AgentsSample(
                 {
 
                     // Getting the state
-                    size_t state = model->population[agent_idx].get_state();
+                    size_t state = model->agents_state[agent_idx];
 
                     if (std::find(states.begin(), states.end(), state) != states.end())
                         continue;
@@ -338,14 +338,22 @@ inline void AgentsSample<TSeq>::sample_n(size_t n)
             // Making some room
             agents_left->reserve(model->size());
 
-            // Iterating through the agents in the population
-            for (size_t a_i = 0u; a_i < model->population.size(); ++a_i)
+            // Flagging the selected states, so the scan over the agents'
+            // states (contiguous) doesn't search `states` for each agent
+            std::vector< unsigned char > selected(
+                *std::max_element(states.begin(), states.end()) + 1u, 0u
+            );
+            for (auto s : states)
+                selected[s] = 1u;
+
+            const auto & agents_state = model->agents_state;
+            for (size_t a_i = 0u; a_i < agents_state.size(); ++a_i)
             {
 
                 // If the agent is within the selected set of states,
                 // then we add it to the list of agents left
-                size_t s = model->population[a_i].get_state();
-                if (std::find(states.begin(), states.end(), s) != states.end())
+                size_t s = agents_state[a_i];
+                if ((s < selected.size()) && selected[s])
                     agents_left->push_back(a_i);
 
             }
@@ -360,7 +368,7 @@ inline void AgentsSample<TSeq>::sample_n(size_t n)
             // Iterating through the agents in the entity
             for (size_t a_i = 0u; a_i < entity->size(); ++a_i)
             {
-                size_t s = model->population[entity->agents[a_i]].get_state();
+                size_t s = model->agents_state[entity->agents[a_i]];
                 if (std::find(states.begin(), states.end(), s) != states.end())
                     agents_left->push_back(a_i);
 
@@ -35,6 +35,13 @@
     #define epiworld_fast_uint unsigned long long int
 #endif
 
+// Type used to store agent and entity ids in the network, the entities,
+// the agents, and contact tracing. Models with fewer than 2^32 agents can
+// define it as `uint32_t` to halve the memory of these arrays.
+#ifndef epiworld_agent_index
+    #define epiworld_agent_index size_t
+#endif
+
 // By default, `Model::rbinom` will use a Poisson approximation in the
 // rare-event regime where p <= 0.01 and n * p^2 <= 0.1. Advanced users can
 // disable this by defining EPI_NO_FAST_BINOM before including epiworld.
@@ -48,6 +55,12 @@
     #define EPI_MAX_TRACKING 200
 #endif
 
+// Lanes of the generator used by `Model::runif_batch_on()`. The sequence of
+// batched uniforms is reproducible for a given number of lanes.
+#ifndef EPI_RUNIF_LANES
+    #define EPI_RUNIF_LANES 4
+#endif
+
 template<typename TSeq = EPI_DEFAULT_TSEQ>
 class Model;
 
@@ -105,6 +118,9 @@ using VirusFun = std::function<epiworld_double(Agent<TSeq>*,Virus<TSeq>&,Model<T
 template<typename TSeq = EPI_DEFAULT_TSEQ>
 using UpdateFun = std::function<void(Agent<TSeq>*,Model<TSeq>*)>;
 
+template<typename TSeq = EPI_DEFAULT_TSEQ>
+using UpdateFunPtr = void (*)(Agent<TSeq>*,Model<TSeq>*); ///< Plain `UpdateFun`.
+
 template<typename TSeq = EPI_DEFAULT_TSEQ>
 using GlobalFun = std::function<void(Model<TSeq>*)>;
 
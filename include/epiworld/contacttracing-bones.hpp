@@ -19,9 +19,11 @@
  * */
 class ContactTracing
 {
+    template<typename TSeq> friend class Model;
+
 private:
 
-    std::vector< size_t > contact_matrix;
+    std::vector< epiworld_agent_index > contact_matrix;
     std::vector< size_t > contacts_per_agent;
     std::vector< size_t > contact_date;
 
@@ -31,7 +31,7 @@ inline void ContactTracing::add_contact(size_t agent_a, size_t agent_b, size_t d
     size_t col_location = contacts_per_agent[agent_a] % max_contacts;
     size_t array_location = get_location(agent_a, col_location);
 
-    contact_matrix[array_location] = agent_b;
+    contact_matrix[array_location] = static_cast< epiworld_agent_index >(agent_b);
     contact_date[array_location] = day;
 
     contacts_per_agent[agent_a] += 1;
@@ -108,6 +108,21 @@ private:
 
     void record_transition(epiworld_fast_uint from, epiworld_fast_uint to, bool undo);
 
+    /**
+     * @name Batched state counters
+     * @details While batching is on, `update_state()` only accumulates the
+     * net number of transitions between each pair of states; they are
+     * applied to `today_total` and `transition_matrix` by `batch_off()`.
+     * `Model<TSeq>::events_run()` batches the updates of each day.
+     */
+    ///@{
+    bool batch_transitions = false;
+    bool batch_dirty = false;
+    std::vector< int > batch_counts; ///< Net transitions [to * nstates + from]
+    void batch_on();
+    void batch_off();
+    ///@}
+
 
 public:
 
@@ -119,7 +134,7 @@ public:
     DataBase() = delete;
     DataBase(Model<TSeq> & m) : model(&m), m_hospitalizations(), user_data(m) {};
     DataBase(const DataBase<TSeq> & db);
-    // DataBase<TSeq> & operator=(const DataBase<TSeq> & m);
+    DataBase<TSeq> & operator=(const DataBase<TSeq> & m) = default;
 
     /**
      * @brief Registering a new variant
@@ -142,19 +142,30 @@ inline void DataBase<TSeq>::record()
     ////////////////////////////////////////////////////////////////////////////
     // DEBUGGING BLOCK
     ////////////////////////////////////////////////////////////////////////////
-    EPI_DEBUG_SUM_INT(today_total, model->size())
     EPI_DEBUG_ALL_NON_NEGATIVE(today_total)
 
     #ifdef EPI_DEBUG
-    // Checking whether the sums correspond
-    std::vector< int > _today_total_cp(today_total.size(), 0);
-    for (auto & p : model->population)
-        _today_total_cp[p.get_state()]++;
-    
-    EPI_DEBUG_VECTOR_MATCH_INT(
-        _today_total_cp, today_total,
-        "Sums of __today_total_cp in database-meat.hpp"
-        )
+    // Checking whether the sums correspond (aggregated runs have no agents)
+    if (model->size() > 0u)
+    {
+        EPI_DEBUG_SUM_INT(today_total, model->size())
+
+        std::vector< int > _today_total_cp(today_total.size(), 0);
+        for (auto s : model->agents_state)
+            _today_total_cp[s]++;
+
+        for (auto & p : model->population)
+            if (model->agents_state[p.get_id()] != p.get_state())
+                throw std::logic_error(
+                    "Model::agents_state doesn't match the state of agent " +
+                    std::to_string(p.get_id()) + "."
+                );
+
+        EPI_DEBUG_VECTOR_MATCH_INT(
+            _today_total_cp, today_total,
+            "Sums of __today_total_cp in database-meat.hpp"
+            )
+    }
 
     if (model->today() == 0)
     {
@@ -560,6 +571,13 @@ inline void DataBase<TSeq>::update_state(
         );
     #endif
 
+    if (batch_transitions)
+    {
+        batch_counts[new_state * model->nstates + prev_state] += undo ? -1 : 1;
+        batch_dirty = true;
+        return;
+    }
+
     if (undo)
     {
 
@@ -578,6 +596,53 @@ inline void DataBase<TSeq>::update_state(
     return;
 }
 
+template<typename TSeq>
+inline void DataBase<TSeq>::batch_on()
+{
+
+    batch_counts.assign(model->nstates * model->nstates, 0);
+    batch_transitions = true;
+    batch_dirty = false;
+
+}
+
+template<typename TSeq>
+inline void DataBase<TSeq>::batch_off()
+{
+
+    batch_transitions = false;
+
+    if (!batch_dirty)
+        return;
+
+    const size_t n = model->nstates;
+    for (size_t to = 0u; to < n; ++to)
+        for (size_t from = 0u; from < n; ++from)
+        {
+
+            int & c = batch_counts[to * n + from];
+            if (c == 0)
+                continue;
+
+            today_total[from] -= c;
+            today_total[to]   += c;
+
+            transition_matrix[to * n + from]   += c;
+            transition_matrix[from * n + from] -= c;
+
+            #ifdef EPI_DEBUG
+            if (transition_matrix[from * n + from] < 0)
+                throw std::logic_error("An entry in transition matrix is negative.");
+            #endif
+
+            c = 0;
+
+        }
+
+    batch_dirty = false;
+
+}
+
 template<typename TSeq>
 inline void DataBase<TSeq>::update_virus(
         epiworld_fast_uint virus_id,
@@ -21,7 +21,7 @@ class Entity {
 private:
     
     int id = -1;
-    std::vector< size_t > agents;   ///< Agent IDs (indices into Model::population)
+    std::vector< epiworld_agent_index > agents;   ///< Agent IDs (indices into Model::population)
 
     int max_capacity = -1;
     std::string entity_name = "Unnamed entity";
@@ -66,11 +66,11 @@ public:
     void set_location(std::vector< epiworld_double > loc);
     std::vector< epiworld_double > & get_location();
 
-    typename std::vector< size_t >::iterator begin();
-    typename std::vector< size_t >::iterator end();
+    typename std::vector< epiworld_agent_index >::iterator begin();
+    typename std::vector< epiworld_agent_index >::iterator end();
 
-    typename std::vector< size_t >::const_iterator begin() const;
-    typename std::vector< size_t >::const_iterator end() const;
+    typename std::vector< epiworld_agent_index >::const_iterator begin() const;
+    typename std::vector< epiworld_agent_index >::const_iterator end() const;
 
     size_t operator[](size_t i);
 
@@ -94,8 +94,8 @@ public:
      */
     void distribute(Model<TSeq> * model);
 
-    const std::vector< size_t > & get_agents() const;
-    const std::vector< size_t > & get_agents_ids() const;
+    const std::vector< epiworld_agent_index > & get_agents() const;
+    const std::vector< epiworld_agent_index > & get_agents_ids() const;
 
     void print() const;
     void set_distribution(EntityToAgentFun<TSeq> fun);
@@ -55,7 +55,7 @@ inline std::vector< epiworld_double > & Entity<TSeq>::get_location()
 }
 
 template<typename TSeq>
-inline typename std::vector< size_t >::iterator Entity<TSeq>::begin()
+inline typename std::vector< epiworld_agent_index >::iterator Entity<TSeq>::begin()
 {
 
     return agents.begin();
@@ -63,13 +63,13 @@ inline typename std::vector< size_t >::iterator Entity<TSeq>::begin()
 }
 
 template<typename TSeq>
-inline typename std::vector< size_t >::iterator Entity<TSeq>::end()
+inline typename std::vector< epiworld_agent_index >::iterator Entity<TSeq>::end()
 {
     return agents.end();
 }
 
 template<typename TSeq>
-inline typename std::vector< size_t >::const_iterator Entity<TSeq>::begin() const
+inline typename std::vector< epiworld_agent_index >::const_iterator Entity<TSeq>::begin() const
 {
 
     return agents.begin();
@@ -77,7 +77,7 @@ inline typename std::vector< size_t >::const_iterator Entity<TSeq>::begin() cons
 }
 
 template<typename TSeq>
-inline typename std::vector< size_t >::const_iterator Entity<TSeq>::end() const
+inline typename std::vector< epiworld_agent_index >::const_iterator Entity<TSeq>::end() const
 {
     return agents.end();
 }
@@ -159,7 +159,6 @@ inline void Entity<TSeq>::reset()
 {
 
     this->agents.clear();
-    this->agents.shrink_to_fit();
 
     return;
 
@@ -229,13 +228,13 @@ inline void Entity<TSeq>::distribute(Model<TSeq> * model)
 }
 
 template<typename TSeq>
-inline const std::vector< size_t > & Entity<TSeq>::get_agents() const
+inline const std::vector< epiworld_agent_index > & Entity<TSeq>::get_agents() const
 {
     return agents;
 }
 
 template<typename TSeq>
-inline const std::vector< size_t > & Entity<TSeq>::get_agents_ids() const
+inline const std::vector< epiworld_agent_index > & Entity<TSeq>::get_agents_ids() const
 {
     return agents;
 }
@@ -18,6 +18,8 @@
 #include <iomanip>
 #include <set>
 #include <type_traits>
+#include <mutex>
+#include <iterator>
 #include <cassert>
 #ifdef EPI_DEBUG_VIRUS
 #include <atomic>
@@ -62,6 +64,7 @@ namespace epiworld {
 
     #include "misc.hpp"
     #include "progress.hpp"
+    #include "threadarray.hpp"
 
     #include "rng-utils.hpp"
     #include "modeldiagram-meat.hpp"
@@ -83,9 +86,17 @@ namespace epiworld {
     #include "adjlist-bones.hpp"
     #include "adjlist-meat.hpp"
 
+    #include "network-bones.hpp"
+    #include "network-meat.hpp"
+    #include "indexedheap-bones.hpp"
+    #include "profiler-bones.hpp"
+    #include "memoryusage-bones.hpp"
+    #include "agentneighbors-bones.hpp"
+
     #include "randgraph.hpp"
 
     #include "queue-bones.hpp"
+    #include "eventbuffer.hpp"
 
     #include "contacttracing-bones.hpp"
     #include "contacttracing-meat.hpp"
@@ -123,6 +134,10 @@ namespace epiworld {
 
     #include "agentssample-bones.hpp"
 
+    #include "model-meat-continuous.hpp"
+    #include "model-meat-checkpoint.hpp"
+    #include "model-meat-memory.hpp"
+
     #include "tools/vaccine.hpp"
     #include "globalevents/quarantinetrigger-meat.hpp"
     
@@ -165,6 +180,24 @@ namespace std {
     >(epiworld::epi_xoshiro256ss& eng) {
         return static_cast<float>(eng() >> 40) * 0x1.0p-24f;
     }
+
+    template<>
+    inline double generate_canonical<
+        double,
+        numeric_limits<double>::digits,
+        epiworld::epi_philox4x32
+    >(epiworld::epi_philox4x32& eng) {
+        return static_cast<double>(eng() >> 11) * 0x1.0p-53;
+    }
+
+    template<>
+    inline float generate_canonical<
+        float,
+        numeric_limits<float>::digits,
+        epiworld::epi_philox4x32
+    >(epiworld::epi_philox4x32& eng) {
+        return static_cast<float>(eng() >> 40) * 0x1.0p-24f;
+    }
 }
 
 #endif
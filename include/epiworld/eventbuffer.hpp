@@ -0,0 +1,163 @@
+#ifndef EPIWORLD_EVENTBUFFER_HPP
+#define EPIWORLD_EVENTBUFFER_HPP
+
+template<typename TSeq>
+class Agent;
+
+template<typename TSeq>
+class Entity;
+
+/**
+ * @brief Pending events of a model, stored as parallel arrays
+ *
+ * @details Each event is a row across the arrays `agent`, `action`,
+ * `new_state`, `queue`, and `payload`. Viruses, tools, and entities travel
+ * in their own arrays and events refer to them by index (`payload`, `-1`
+ * if none), so most events (e.g., changes of state) carry no shared
+ * pointers. The arrays keep their capacity across days. Filled by
+ * `Model<TSeq>::_add_event()` and consumed by `Model<TSeq>::events_run()`.
+ *
+ * @tparam TSeq
+ */
+template<typename TSeq>
+class EventBuffer {
+    friend class Model<TSeq>;
+private:
+
+    std::vector< Agent<TSeq> * > agent;
+    std::vector< EventAction > action;
+    std::vector< epiworld_fast_int > new_state;
+    std::vector< epiworld_fast_int > queue;
+    std::vector< int > payload; ///< Index in `viruses`, `tools`, or `entities`.
+
+    std::vector< VirusPtr<TSeq> > viruses;
+    std::vector< ToolPtr<TSeq> > tools;
+    std::vector< Entity<TSeq> * > entities;
+
+    std::vector< size_t > order; ///< Scratch space for `sort_by_agent()`.
+
+public:
+
+    size_t size() const noexcept { return action.size(); };
+    bool empty() const noexcept { return action.empty(); };
+
+    void push(
+        Agent<TSeq> * agent_,
+        VirusPtr<TSeq> && virus_,
+        ToolPtr<TSeq> && tool_,
+        Entity<TSeq> * entity_,
+        epiworld_fast_int new_state_,
+        epiworld_fast_int queue_,
+        EventAction action_
+    )
+    {
+
+        int idx = -1;
+        switch (action_)
+        {
+        case EventAction::AddVirus:
+        case EventAction::RemoveVirus:
+            idx = static_cast< int >(viruses.size());
+            viruses.push_back(std::move(virus_));
+            break;
+        case EventAction::AddTool:
+        case EventAction::RemoveTool:
+            idx = static_cast< int >(tools.size());
+            tools.push_back(std::move(tool_));
+            break;
+        case EventAction::AddEntity:
+        case EventAction::RemoveEntity:
+            idx = static_cast< int >(entities.size());
+            entities.push_back(entity_);
+            break;
+        default:
+            break;
+        }
+
+        agent.push_back(agent_);
+        action.push_back(action_);
+        new_state.push_back(new_state_);
+        queue.push_back(queue_);
+        payload.push_back(idx);
+
+    };
+
+    /**
+     * @brief Moves the i-th event into `a`
+     * @details The virus or tool of the event (if any) is moved out of the
+     * buffer, so each event can only be retrieved once.
+     */
+    void get(size_t i, Event<TSeq> & a)
+    {
+
+        a.agent     = agent[i];
+        a.action    = action[i];
+        a.new_state = new_state[i];
+        a.queue     = queue[i];
+        a.virus     = nullptr;
+        a.tool      = nullptr;
+        a.entity    = nullptr;
+
+        const int idx = payload[i];
+        if (idx < 0)
+            return;
+
+        switch (a.action)
+        {
+        case EventAction::AddVirus:
+        case EventAction::RemoveVirus:
+            a.virus = std::move(viruses[idx]);
+            break;
+        case EventAction::AddTool:
+        case EventAction::RemoveTool:
+            a.tool = std::move(tools[idx]);
+            break;
+        default:
+            a.entity = entities[idx];
+            break;
+        }
+
+    };
+
+    /**
+     * @brief Order in which to apply the events in `[from, to)`
+     * @details Sorted by agent id. The sort is stable, so the events of
+     * each agent keep the order in which they were added.
+     * @return Reference to a vector of `to - from` event indices.
+     */
+    const std::vector< size_t > & sort_by_agent(size_t from, size_t to)
+    {
+
+        order.resize(to - from);
+        for (size_t i = from; i < to; ++i)
+            order[i - from] = i;
+
+        std::stable_sort(
+            order.begin(), order.end(),
+            [this](size_t i, size_t j) {
+                return agent[i]->get_id() < agent[j]->get_id();
+            }
+        );
+
+        return order;
+
+    };
+
+    /**
+     * @brief Removes all the events (keeps the capacity)
+     */
+    void clear()
+    {
+        agent.clear();
+        action.clear();
+        new_state.clear();
+        queue.clear();
+        payload.clear();
+        viruses.clear();
+        tools.clear();
+        entities.clear();
+    };
+
+};
+
+#endif
@@ -27,6 +27,7 @@ class Model;
  */
 template<typename TSeq = EPI_DEFAULT_TSEQ>
 class HospitalizationsTracker {
+    friend class Model<TSeq>;
 
 private:
 
@@ -0,0 +1,155 @@
+#ifndef EPIWORLD_INDEXEDHEAP_BONES_HPP
+#define EPIWORLD_INDEXEDHEAP_BONES_HPP
+
+#include <vector>
+#include <limits>
+#include "config.hpp"
+
+/**
+ * @brief Binary min-heap over a fixed set of items with updatable keys
+ * @details
+ * Items are identified by their index in `[0, n)`. The heap keeps the
+ * position of each item (`pos`), so changing the key of an item is
+ * `O(log n)` and the minimum is available in `O(1)`. Used by the
+ * next-reaction engine (`Model<TSeq>::run_continuous()`) to keep the time
+ * of the next event of each agent. Items without a scheduled event carry
+ * an infinite key.
+ */
+class IndexedMinHeap
+{
+private:
+
+    std::vector< epiworld_double > keys; ///< Key of each item.
+    std::vector< size_t > heap;          ///< Items in heap order.
+    std::vector< size_t > pos;           ///< Position of each item in `heap`.
+
+    void swap_at(size_t a, size_t b);
+    void sift_up(size_t i);
+    void sift_down(size_t i);
+
+public:
+
+    IndexedMinHeap() = default;
+
+    /**
+     * @brief Resets the heap to `n` items, all with infinite keys
+     * @param n Number of items.
+     */
+    void reset(size_t n);
+
+    /**
+     * @brief Sets the key of item `i` and restores the heap order
+     * @param i Item index.
+     * @param key New key.
+     */
+    void update(size_t i, epiworld_double key);
+
+    size_t top() const;                    ///< Item with the smallest key.
+    epiworld_double top_key() const;       ///< Smallest key.
+    epiworld_double key(size_t i) const;   ///< Key of item `i`.
+    size_t size() const noexcept;          ///< Number of items.
+
+};
+
+inline void IndexedMinHeap::swap_at(size_t a, size_t b)
+{
+    std::swap(heap[a], heap[b]);
+    pos[heap[a]] = a;
+    pos[heap[b]] = b;
+}
+
+inline void IndexedMinHeap::sift_up(size_t i)
+{
+
+    while (i > 0u)
+    {
+        size_t parent = (i - 1u) / 2u;
+        if (keys[heap[parent]] <= keys[heap[i]])
+            break;
+
+        swap_at(i, parent);
+        i = parent;
+    }
+
+}
+
+inline void IndexedMinHeap::sift_down(size_t i)
+{
+
+    size_t n = heap.size();
+    while (true)
+    {
+        size_t smallest = i;
+        size_t left     = 2u * i + 1u;
+        size_t right    = left + 1u;
+
+        if ((left < n) && (keys[heap[left]] < keys[heap[smallest]]))
+            smallest = left;
+
+        if ((right < n) && (keys[heap[right]] < keys[heap[smallest]]))
+            smallest = right;
+
+        if (smallest == i)
+            break;
+
+        swap_at(i, smallest);
+        i = smallest;
+    }
+
+}
+
+inline void IndexedMinHeap::reset(size_t n)
+{
+
+    keys.assign(n, std::numeric_limits< epiworld_double >::infinity());
+    heap.resize(n);
+    pos.resize(n);
+
+    for (size_t i = 0u; i < n; ++i)
+    {
+        heap[i] = i;
+        pos[i]  = i;
+    }
+
+}
+
+inline void IndexedMinHeap::update(size_t i, epiworld_double key)
+{
+
+    epiworld_double old = keys[i];
+    keys[i] = key;
+
+    if (key < old)
+        sift_up(pos[i]);
+    else if (key > old)
+        sift_down(pos[i]);
+
+}
+
+inline size_t IndexedMinHeap::top() const
+{
+    if (heap.empty())
+        throw std::logic_error("The heap is empty.");
+
+    return heap[0u];
+}
+
+inline epiworld_double IndexedMinHeap::top_key() const
+{
+    if (heap.empty())
+        return std::numeric_limits< epiworld_double >::infinity();
+
+    return keys[heap[0u]];
+}
+
+inline epiworld_double IndexedMinHeap::key(size_t i) const
+{
+    return keys[i];
+}
+
+inline size_t IndexedMinHeap::size() const noexcept
+{
+    return heap.size();
+}
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef EPIWORLD_MEMORYUSAGE_BONES_HPP
+#define EPIWORLD_MEMORYUSAGE_BONES_HPP
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "config.hpp"
+
+/**
+ * @brief Memory used by a model, in bytes, by component
+ * @details
+ * Returned by `Model<TSeq>::memory_usage()` (measured) and
+ * `Model<TSeq>::estimate_memory_usage()` (predicted). Containers are
+ * counted by their capacity. Objects are counted by their own size, so
+ * heap memory owned by their members (strings, `std::function`s, user
+ * data) is not included; the figures are a lower bound of what the
+ * allocator sees.
+ */
+class MemoryUsage
+{
+public:
+
+    /**
+     * @name Agents
+     */
+    ///@{
+    size_t agents          = 0u; ///< `Agent` objects and their states.
+    size_t agents_entities = 0u; ///< Entity ids of each agent.
+    size_t agents_viruses  = 0u; ///< Viruses held by agents (one copy each).
+    size_t agents_tools    = 0u; ///< Tools held by agents (one copy each).
+    ///@}
+
+    size_t network         = 0u; ///< Neighbors (CSR arrays of `Network`).
+    size_t network_backup  = 0u; ///< Only when not shared with `network`.
+    size_t entities        = 0u; ///< `Entity` objects and their agent ids.
+    size_t queue           = 0u; ///< `Queue::active` and the active list.
+    size_t contact_tracing = 0u;
+    size_t events          = 0u; ///< Event buffers (including per thread).
+    size_t sampling        = 0u; ///< Scratch space of `AgentsSample`.
+
+    /**
+     * @name Database
+     */
+    ///@{
+    size_t db_registry         = 0u; ///< Virus/tool ids, names, sequences.
+    size_t db_today            = 0u; ///< Today's counts.
+    size_t db_hist_virus       = 0u; ///< `hist_virus_*`.
+    size_t db_hist_tool        = 0u; ///< `hist_tool_*`.
+    size_t db_hist_total       = 0u; ///< `hist_total_*`.
+    size_t db_hist_transition  = 0u; ///< `hist_transition_matrix`.
+    size_t db_transition       = 0u; ///< Today's transition matrix.
+    size_t db_transmission     = 0u; ///< `transmission_*`.
+    size_t db_user_data        = 0u;
+    size_t db_hospitalizations = 0u;
+    ///@}
+
+    /**
+     * @brief Additional memory of the thread clones of `run_multiple()`
+     * @details Each clone copies the model except for the network, which
+     * is shared until modified.
+     */
+    size_t thread_clones = 0u;
+
+    size_t database() const; ///< Sum of the `db_*` components.
+    size_t total() const;    ///< Sum of all the components.
+
+    void print() const;
+
+    /**
+     * @name Bytes used by a container
+     */
+    ///@{
+    template<typename T>
+    static size_t bytes(const std::vector< T > & x);
+    static size_t bytes(const std::vector< bool > & x);
+    template<typename Tk, typename Tv, typename Th>
+    static size_t bytes(const std::unordered_map< Tk, Tv, Th > & x);
+    ///@}
+
+};
+
+template<typename T>
+inline size_t MemoryUsage::bytes(const std::vector< T > & x)
+{
+    return x.capacity() * sizeof(T);
+}
+
+inline size_t MemoryUsage::bytes(const std::vector< bool > & x)
+{
+    return (x.capacity() + 7u) / 8u;
+}
+
+template<typename Tk, typename Tv, typename Th>
+inline size_t MemoryUsage::bytes(const std::unordered_map< Tk, Tv, Th > & x)
+{
+
+    // Each entry is a node (value and pointer to the next one)
+    size_t res = x.bucket_count() * sizeof(void *) +
+        x.size() * (sizeof(std::pair< const Tk, Tv >) + sizeof(void *));
+
+    if constexpr (std::is_same_v< Tk, std::vector< int > >)
+        for (const auto & p : x)
+            res += bytes(p.first);
+
+    return res;
+
+}
+
+inline size_t MemoryUsage::database() const
+{
+    return db_registry + db_today + db_hist_virus + db_hist_tool +
+        db_hist_total + db_hist_transition + db_transition +
+        db_transmission + db_user_data + db_hospitalizations;
+}
+
+inline size_t MemoryUsage::total() const
+{
+    return agents + agents_entities + agents_viruses + agents_tools +
+        network + network_backup + entities + queue + contact_tracing +
+        events + sampling + database() + thread_clones;
+}
+
+inline void MemoryUsage::print() const
+{
+
+    auto print_line = [](const char * name, size_t x) -> void {
+
+        double value = static_cast< double >(x);
+        const char * unit = "B ";
+        if (value >= 1073741824.0)
+        {
+            value /= 1073741824.0;
+            unit = "GB";
+        }
+        else if (value >= 1048576.0)
+        {
+            value /= 1048576.0;
+            unit = "MB";
+        }
+        else if (value >= 1024.0)
+        {
+            value /= 1024.0;
+            unit = "KB";
+        }
+
+        printf_epiworld(" - %-24s: %10.2f %s\n", name, value, unit);
+
+    };
+
+    printf_epiworld("Memory usage\n");
+    print_line("Agents", agents);
+    print_line("Agents' entities", agents_entities);
+    print_line("Agents' viruses", agents_viruses);
+    print_line("Agents' tools", agents_tools);
+    print_line("Network", network);
+    print_line("Network (backup)", network_backup);
+    print_line("Entities", entities);
+    print_line("Queue", queue);
+    print_line("Contact tracing", contact_tracing);
+    print_line("Events", events);
+    print_line("Sampling", sampling);
+    print_line("Database", database());
+    print_line("  registry", db_registry);
+    print_line("  today", db_today);
+    print_line("  hist virus", db_hist_virus);
+    print_line("  hist tool", db_hist_tool);
+    print_line("  hist total", db_hist_total);
+    print_line("  hist transition", db_hist_transition);
+    print_line("  transition", db_transition);
+    print_line("  transmission", db_transmission);
+    print_line("  user data", db_user_data);
+    print_line("  hospitalizations", db_hospitalizations);
+    print_line("Thread clones", thread_clones);
+    print_line("Total", total());
+
+}
+
+#endif
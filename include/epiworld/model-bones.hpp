@@ -16,6 +16,8 @@
 #include "queue-bones.hpp"
 #include "globalevent-bones.hpp"
 #include "contacttracing-bones.hpp"
+#include "profiler-bones.hpp"
+#include "memoryusage-bones.hpp"
 
 template<typename TSeq>
 class AgentsSample;
@@ -45,6 +47,9 @@ inline std::function<void(size_t,Model<TSeq>*)> make_save_run(
 // template<typename TSeq>
 // class ToolPtr;
 
+template<typename TSeq>
+inline void default_update_susceptible(Agent<TSeq> * p, Model<TSeq> * m);
+
 /**
  * @brief Core class of epiworld.
  *
@@ -69,8 +74,33 @@ protected:
 
     std::vector< Agent<TSeq> > population = {};
 
+    /**
+     * @brief State of each agent, stored contiguously (by agent id)
+     * @details A structure-of-arrays copy of `Agent<TSeq>::state`, so
+     * whole-population scans (the update sweeps, the state filters of
+     * `AgentsSample`, and `get_agents_states()`) read one array instead
+     * of loading every `Agent`. It is written together with the agents'
+     * states in `events_run()`, `reset()`, and `agents_empty_graph()`.
+     */
+    std::vector< unsigned int > agents_state = {};
+
     bool using_backup = true;
-    std::vector< Agent<TSeq> > population_backup = {};
+
+    /**
+     * @name Contact network
+     *
+     * @details The network (see `Network`) is shared between copies of
+     * the model (e.g., the thread clones in `run_multiple()`) and the
+     * backup. It is only copied when modified through
+     * `get_network_mutable()` while being shared (copy-on-write), so
+     * read-only topologies are stored once regardless of the number of
+     * threads.
+     */
+    ///@{
+    std::shared_ptr< Network > network = std::make_shared< Network >();
+    std::shared_ptr< Network > network_backup = nullptr; ///< Set by `set_backup()`.
+    Network & get_network_mutable();
+    ///@}
 
     /**
      * @name Auxiliary variables for AgentsSample<TSeq> iterators
@@ -108,6 +138,20 @@ protected:
     std::vector< Entity<TSeq> > entities = {};
 
     std::shared_ptr< epi_xoshiro256ss > engine = std::make_shared< epi_xoshiro256ss >();
+    uint64_t rng_seed = 0u; ///< Last value passed to `seed()` (keys the per-agent streams).
+
+    /**
+     * @name Batched uniforms
+     * @details See `runif_batch_on()`.
+     */
+    ///@{
+    bool use_runif_batch = false;
+    epi_xoshiro256ss_lanes< EPI_RUNIF_LANES > engine_batch;
+    std::vector< epiworld_double > runif_buffer = {};
+    size_t runif_buffer_pos = 0u;
+    static constexpr size_t runif_batch_blocks = 64u; ///< Blocks per refill.
+    epiworld_double runif_next(); ///< Next uniform (from the buffer, if on).
+    ///@}
 
     epiworld_double runifd_a = 0.0;
     epiworld_double runifd_b = 1.0;
@@ -135,6 +179,8 @@ protected:
     epiworld_double rewire_prop = 0.0;
 
     std::map<std::string, epiworld_double > parameters;
+    std::vector< const epiworld_double * > parameters_ptrs = {}; ///< Indexed by `param_id()`.
+    void parameters_ptrs_update();
     epiworld_fast_uint ndays = 0;
     Progress pb;
 
@@ -165,6 +211,9 @@ protected:
     void chrono_start();
     void chrono_end();
 
+    Profiler profile;       ///< Last run (reset by `chrono_start()`).
+    Profiler profile_total; ///< All the runs (added by `chrono_end()`).
+
     std::vector<GlobalEventPtr<TSeq>> globalevents;
 
     Queue<TSeq> queue;
@@ -172,6 +221,59 @@ protected:
     size_t sim_id = 0u;
     void set_sim_id(size_t id);
 
+    /**
+     * @brief Checks the model and prepares day 0 (shared by `run()` and
+     * `run_continuous()`).
+     */
+    void run_setup(epiworld_fast_uint ndays, int seed);
+
+    /**
+     * @brief Runs `ndays` days from the current date (the loop of `run()`,
+     * also used by `resume()`).
+     */
+    void run_days(epiworld_fast_uint ndays);
+
+    /**
+     * @name Aggregated runs
+     * @details Helpers for models that can run on counts instead of
+     * agents (e.g., `ModelSIRMixing::aggregated_on()`). Since there are no
+     * agents to count, `aggregated_setup()` sets the database to the given
+     * totals (and records day 0), `aggregated_move()` records `n`
+     * transitions at once, and `aggregated_end()` closes the run as
+     * `run()` does. States flagged in `with_virus` count towards the first
+     * virus.
+     *
+     * Models turn the mode on with `aggregated_enable()`, which keeps the
+     * group sizes and releases the agents, and implement
+     * `run_aggregated()`, which `run()` calls after seeding the model.
+     * `aggregated_split()` spreads `n` cases across groups in proportion
+     * to their size, and `aggregated_escape()` is the probability that a
+     * susceptible in group `i` escapes infection from the infected `I`
+     * (by group) in a day.
+     */
+    ///@{
+    bool aggregated = false;
+    std::vector< size_t > aggregated_sizes = {};
+    std::vector< bool > aggregated_with_virus = {};
+    void aggregated_enable(std::vector< size_t > group_sizes);
+    void aggregated_disable();
+    virtual Model<TSeq> & run_aggregated(epiworld_fast_uint ndays);
+    std::vector< int > aggregated_split(epiworld_double prevalence);
+    epiworld_double aggregated_escape(
+        const ContactMatrix & contact_matrix,
+        size_t i,
+        const std::vector< int > & I,
+        epiworld_double p_transmit
+    ) const;
+    void aggregated_setup(
+        epiworld_fast_uint ndays,
+        const std::vector< int > & totals,
+        const std::vector< bool > & with_virus
+    );
+    void aggregated_move(epiworld_fast_uint from, epiworld_fast_uint to, int n);
+    void aggregated_end();
+    ///@}
+
     std::unique_ptr<ContactTracing> contact_tracing;
     bool use_contact_tracing = false;
     size_t contact_tracing_max_contacts = EPI_MAX_TRACKING;
@@ -180,8 +282,104 @@ protected:
      * @brief Variables used to keep track of the events
      * to be made regarding viruses.
      */
-    std::vector< Event<TSeq> > events = {};
-    epiworld_fast_uint nactions = 0u;
+    EventBuffer<TSeq> events;
+    bool events_by_agent = false; ///< Apply the events in agent order.
+
+    /**
+     * @name Fast-forward
+     * @details See `fast_forward_on()`.
+     */
+    ///@{
+    bool fast_forward = false;
+    std::function<bool(Model<TSeq>*)> absorbing_fun = nullptr;
+    ///@}
+
+    /**
+     * @name Parallel update
+     * @details When on, `update_state()` splits the agents across threads.
+     * Events are collected in per-thread buffers (`events_threads`) and
+     * merged in agent order before calling `events_run()`. Each agent
+     * draws from its own counter-based stream (`engines_threads` are keyed
+     * by seed and simulation id, and positioned at the agent and day), so
+     * results do not depend on the number of threads.
+     */
+    ///@{
+    bool use_parallel_update = false;
+    int parallel_update_nthreads = 1;
+    bool in_parallel_update = false; ///< True while inside the parallel region.
+    std::vector< std::vector< Event<TSeq> > > events_threads = {};
+    std::vector< epi_philox4x32 > engines_threads = {};
+    void update_state_parallel();
+    epi_philox4x32 & rng_engine_thread(); ///< Engine of the current thread.
+    uint64_t rng_next(); ///< Next 64 random bits (from the thread's engine, if any).
+
+    /**
+     * @brief Draws from a (possibly stateful) distribution.
+     * @details Within a parallel update, a fresh distribution with the same
+     * parameters is used so cached values are not shared across threads.
+     */
+    template<typename TDist, typename... TArgs>
+    typename TDist::result_type rand_draw(TDist & dist, TArgs... args);
+    ///@}
+
+    /**
+     * @name Statically dispatched update
+     * @details Built-in models override `update_state_static()` to run
+     * their states through `update_state_table()`, which calls the update
+     * functions directly (not through `std::function`), so the compiler can
+     * inline them. The table is only used while `state_fun` still holds
+     * the model's own functions (see `state_fun_is()`); user-defined
+     * functions, extra states, and the parallel update go through
+     * `state_fun`.
+     */
+    ///@{
+    virtual bool update_state_static(); ///< Returns false if not available.
+
+    template<UpdateFunPtr<TSeq>... Funs>
+    bool update_state_table();
+
+    template<size_t I, UpdateFunPtr<TSeq> Fun, UpdateFunPtr<TSeq>... Funs>
+    void update_state_dispatch(Agent<TSeq> & p);
+
+    bool state_fun_is(epiworld_fast_uint state, UpdateFunPtr<TSeq> fun) const;
+    ///@}
+
+    /**
+     * @name Members of derived models in checkpoints
+     * @details `write_checkpoint()` ends by calling
+     * `write_checkpoint_derived()`, and `read_checkpoint()` calls
+     * `read_checkpoint_derived()` once the agents, viruses, and tools are
+     * restored. Built-in models write the per-agent data kept by their
+     * update functions (e.g., quarantine days) and rebuild the lists they
+     * derive from the agents' states (e.g., infected agents by group).
+     * The default writes and reads nothing.
+     */
+    ///@{
+    virtual void write_checkpoint_derived(std::ostream & out) const;
+    virtual void read_checkpoint_derived(std::istream & in);
+    void read_checkpoint_derived_keep_rng(std::istream & in); ///< Keeps the binomial distribution.
+    ///@}
+
+    /**
+     * @brief Runs jobs `0, ..., njobs - 1` (see `run_multiple()`)
+     * @details With OpenMP, each thread works on its own copy of the
+     * model (the calling thread on this one) and takes the next free job,
+     * so threads stay busy when runtimes vary. `job(i, model)` runs job
+     * `i`, and `fun(i, model)` (if any) is then called one thread at a
+     * time. If a copy ran the last job, its state is copied into this
+     * model at the end (with the members of derived models, see
+     * `write_checkpoint_derived()`), so the model always ends as the last
+     * job left it. Without OpenMP, the jobs run in order on this model.
+     * @return The number of jobs run by this model.
+     */
+    size_t run_jobs(
+        size_t njobs,
+        int nthreads,
+        std::function<void(size_t,Model<TSeq>*)> job,
+        std::function<void(size_t,Model<TSeq>*)> fun,
+        Progress & pb,
+        bool verbose
+    );
 
     /**
      * @brief Construct a new Event object
@@ -251,8 +449,8 @@ protected:
 
 public:
 
-    std::array<epiworld_double, 1024u * 2u> array_double_tmp;
-    std::array<Virus<TSeq> *, 1024u * 2u> array_virus_tmp;
+    ThreadArray<epiworld_double, 1024u * 2u> array_double_tmp;
+    ThreadArray<Virus<TSeq> *, 1024u * 2u> array_virus_tmp;
 
     Model();
     Model(const Model<TSeq> & m);
@@ -263,9 +461,11 @@ public:
 
     /**
      * @name Set the backup object
-     * @details `backup` can be used to restore the entire object
+     * @details `backup` can be used to restore the network
      * after a run. This can be useful if the user wishes to have
-     * individuals start with the same network from the beginning.
+     * individuals start with the same network from the beginning
+     * (e.g., when the network is rewired during the simulation). The
+     * rest of the agents' state is always restored by `reset()`.
      *
      */
     ///@{
@@ -443,6 +643,8 @@ public:
 
     std::vector< Agent<TSeq> > & get_agents(); ///< Returns a reference to the vector of agents.
 
+    const Network & get_network() const; ///< Returns the contact network.
+
     Agent<TSeq> & get_agent(size_t i);
 
     std::vector< epiworld_fast_uint > get_agents_states() const; ///< Returns a vector with the states of the agents.
@@ -515,6 +717,7 @@ public:
         epiworld_fast_uint ndays,
         int seed = -1
     ); ///< Runs the simulation (after initialization)
+    bool is_aggregated() const; ///< Runs on counts (see `run_aggregated()`)
     Model<TSeq> & run_multiple( ///< Multiple runs of the simulation
         epiworld_fast_uint ndays,
         epiworld_fast_uint nexperiments,
@@ -526,6 +729,112 @@ public:
         );
     ///@}
 
+    /**
+     * @brief Runs the simulation in continuous time (next-reaction method)
+     *
+     * @details Instead of visiting every active agent each day, each agent
+     * has a single pending event (infection if susceptible, recovery or
+     * death if infected) scheduled in an indexed priority queue. The daily
+     * probabilities of the virus and tools are turned into rates,
+     * \f$\lambda = -\log(1 - p)\f$, so an agent that does not interact
+     * with anyone keeps the same daily probabilities as in `run()`. After
+     * each event, only the agent and its neighbors are rescheduled, so the
+     * cost is proportional to the number of events rather than to the
+     * number of days times active agents.
+     *
+     * The database is recorded at day boundaries, where the global events,
+     * rewiring, and mutations also run (as in `run()`). Rates are assumed
+     * to be constant between events; they are all recomputed after a day
+     * boundary only if the model has global events, rewiring, or mutating
+     * viruses.
+     *
+     * Only models whose states use `default_update_susceptible()`,
+     * `default_update_exposed()`, or no update function are supported
+     * (e.g., SIR, SIS, SIRD, and SISD over a network).
+     *
+     * @param ndays Number of days of the simulation.
+     * @param seed Seed to be used for Pseudo-RNG.
+     * @throws std::logic_error If a state uses a different update function.
+     */
+    Model<TSeq> & run_continuous(
+        epiworld_fast_uint ndays,
+        int seed = -1
+    );
+
+    /**
+     * @name Checkpoints
+     *
+     * @details `write_checkpoint()` saves the state of the model (e.g.,
+     * after `run()`) to a versioned binary file: the date, parameters, and
+     * RNG state (including the distributions' cached draws), the agents'
+     * states, viruses, tools, and entities, the network, the queue, the
+     * global events' days, and the database (history, transmissions, and
+     * user data). `read_checkpoint()` restores it, and `resume()` continues
+     * the simulation, so the following days are the same as if the
+     * original model had kept running.
+     *
+     * Functions cannot be stored, so the checkpoint must be read by a
+     * model built by the same code (same states, viruses, tools, entities,
+     * global events, and number of agents). Viruses and tools are rebuilt
+     * from the ones in the model (mutated viruses from their ancestor
+     * in the model), keeping each carrier's id, date, and sequence, so
+     * tools created during the simulation (e.g., by
+     * `Virus::set_post_immunity()`) cannot be restored.
+     * Members added by derived models are only included if the model
+     * overrides `write_checkpoint_derived()` and `read_checkpoint_derived()`
+     * (as the built-in models do).
+     *
+     * @param fn Filename.
+     * @param ndays Number of days to add to the simulation.
+     * @throws std::runtime_error If the file cannot be opened or read.
+     * @throws std::logic_error If the checkpoint doesn't match the model.
+     */
+    ///@{
+    void write_checkpoint(std::string fn) const;
+    void write_checkpoint(std::ostream & out) const;
+    void read_checkpoint(std::string fn);
+    void read_checkpoint(std::istream & in);
+    Model<TSeq> & resume(epiworld_fast_uint ndays);
+    ///@}
+
+    /**
+     * @brief Runs scenarios that share a burn-in period
+     *
+     * @details The model runs the first `burnin` days once, and the result
+     * is kept as an in-memory checkpoint (see `write_checkpoint()`). Then,
+     * each of the `scenarios.size()` scenarios is run `nreplicates` times
+     * from that checkpoint until day `ndays`: the parameters listed in the
+     * scenario are set (see `set_param()`), the model is seeded with the
+     * fork's own seed, and the simulation continues with `resume()`. The
+     * database of each fork has the full history (burn-in included).
+     *
+     * Forks are numbered `scenario * nreplicates + replicate`; the number
+     * is passed to `fun` and used as the simulation id. As in
+     * `run_multiple()`, seeds are bound to the fork number, so the results
+     * don't depend on the number of threads, and the model ends with the
+     * state of the last fork.
+     *
+     * @param ndays Number of days of the simulation (burn-in included).
+     * @param burnin Number of days shared by all the forks.
+     * @param scenarios Parameters to set in each scenario (an empty map
+     * runs the model as is).
+     * @param nreplicates Number of replicates of each scenario.
+     * @param seed Seed to be used for Pseudo-RNG.
+     * @param fun Function called after each fork.
+     * @param verbose When `true`, shows a progress bar.
+     * @param nthreads Number of threads (with OpenMP).
+     */
+    Model<TSeq> & run_scenarios(
+        epiworld_fast_uint ndays,
+        epiworld_fast_uint burnin,
+        const std::vector< std::map< std::string, epiworld_double > > & scenarios,
+        epiworld_fast_uint nreplicates,
+        int seed = -1,
+        std::function<void(size_t,Model<TSeq>*)> fun = make_save_run<TSeq>(),
+        bool verbose = true,
+        int nthreads = 1
+    );
+
     size_t get_n_viruses() const; ///< Number of viruses in the model
     size_t get_n_tools() const; ///< Number of tools in the model
     epiworld_fast_uint get_ndays() const;
@@ -615,7 +924,9 @@ public:
      *
      * @details Resetting the model will:
      * - clear the database
-     * - restore the population (if `set_backup()` was called before)
+     * - reset the agents' state, viruses, and tools (in place)
+     * - restore the network (if `set_backup()` was called before and
+     *   the network was rewired)
      * - re-distribute tools
      * - re-distribute viruses
      * - set the date to 0
@@ -677,6 +988,16 @@ public:
      *
      * The `par()` function members are aliases for `get_param()`.
      *
+     * Update functions called for every agent should use parameter ids
+     * instead of names. `param_id()` maps a name to an id that is the same
+     * across models (so it can be resolved once, e.g., in a `static`
+     * variable), and `par(id)` is then a single load. The `std::map<>`
+     * returned by `params()` is still the storage, so values modified
+     * through it are seen by `par(id)`. Parameters added through it are
+     * bound to their ids the next time `params()` is called or the model
+     * runs (until then, `par(id)` searches them by name). Parameters
+     * should not be erased from it.
+     *
      * In the case of the function `read_params`, users can pass a file
      * listing parameters to be included in the model. Each line in the
      * file should have the following structure:
@@ -703,9 +1024,12 @@ public:
         epiworld_double initial_val, std::string pname, bool overwrite = false
     );
     Model<TSeq> & read_params(std::string fn, bool overwrite = false);
-    epiworld_double get_param(std::string pname);
-    void set_param(std::string pname, epiworld_double val);
-    epiworld_double par(std::string pname) const;
+    epiworld_double get_param(const std::string & pname);
+    void set_param(const std::string & pname, epiworld_double val);
+    epiworld_double par(const std::string & pname) const;
+    epiworld_double par(size_t id) const;
+    static size_t param_id(const std::string & pname);
+    static const std::string & param_name(size_t id);
     ///@}
 
     void get_elapsed(
@@ -716,6 +1040,55 @@ public:
         bool print = true
     ) const;
 
+    /**
+     * @name Profiling
+     * @details Time per phase and counters (agents visited, update
+     * functions called, events by type, and random draws) of the last run
+     * and of all the runs of the model, including the ones made by the
+     * threads of `run_multiple()` and `run_scenarios()`. Only collected
+     * when compiled with `EPI_PROFILE` (see `Profiler`).
+     */
+    ///@{
+    const Profiler & get_profile() const; ///< Profile of the last run.
+    const Profiler & get_profile_total() const; ///< Profile of all the runs.
+    ///@}
+
+    /**
+     * @name Memory usage
+     * @details `memory_usage()` measures the memory held by the model now
+     * (see `MemoryUsage` for what is counted). With `nthreads > 1`, it
+     * adds the clones that `run_multiple()` would make with that many
+     * threads.
+     *
+     * `estimate_memory_usage()` predicts the usage of a model before
+     * building it, after a run of `ndays`. The estimate is an upper bound
+     * for the outbreak: it assumes every agent carries a virus at some
+     * point and is infected once (the transmission records). Entities,
+     * events and contact tracing are not included. Since history vectors
+     * grow geometrically, their capacity (and what `memory_usage()`
+     * reports) can be up to twice the estimate.
+     *
+     * @param n Number of agents.
+     * @param mean_degree Average number of neighbors per agent.
+     * @param nstates Number of states.
+     * @param ndays Number of days.
+     * @param nviruses, ntools Number of viruses and tools (variants
+     * included).
+     * @param nthreads Threads passed to `run_multiple()`.
+     */
+    ///@{
+    MemoryUsage memory_usage(int nthreads = 1) const;
+    static MemoryUsage estimate_memory_usage(
+        size_t n,
+        epiworld_double mean_degree,
+        size_t nstates,
+        size_t ndays,
+        size_t nviruses = 1u,
+        size_t ntools = 0u,
+        int nthreads = 1
+    );
+    ///@}
+
     /**
      * @name Set the user data object
      *
@@ -790,6 +1163,88 @@ public:
     ContactTracing & get_contact_tracing(); ///< Retrieve the `ContactTracing` object.
     ///@}
 
+    /**
+     * @name Order of the events
+     * @details By default, `events_run()` applies the events of the day in
+     * the order in which they were added. When on, events are applied
+     * sorted by agent id (each agent's events keep their relative order),
+     * which walks the population sequentially. Counts and states are the
+     * same either way, but records kept in order of occurrence (e.g., the
+     * transmissions) may be listed in a different order.
+     */
+    ///@{
+    Model<TSeq> & events_by_agent_on(); ///< Applies the events in agent order.
+    Model<TSeq> & events_by_agent_off(); ///< Applies the events in insertion order (default.)
+    bool is_events_by_agent_on() const; ///< Query if the events are applied in agent order.
+    ///@}
+
+    /**
+     * @name Fast-forward after extinction
+     * @details When on, `run()` (and `resume()`) check after each day
+     * whether the model reached an absorbing state, i.e., nothing can change
+     * anymore. If so, the remaining days only call `next()`, which records
+     * the (unchanged) counts in the database, skipping the update of the
+     * agents, global events, rewiring, and mutation. The history is the
+     * same as in a full run; only the random numbers left undrawn differ.
+     *
+     * By default (`fun = nullptr`), `is_absorbing()` is `true` when no agent
+     * has a virus, no global event is left to run (events without a day
+     * run every day), and agents are only in states without an update
+     * function or with `default_update_susceptible()`. Models with other
+     * update functions can pass their own detector.
+     *
+     * @param fun Function returning `true` if the model can no longer change.
+     */
+    ///@{
+    Model<TSeq> & fast_forward_on(std::function<bool(Model<TSeq>*)> fun = nullptr); ///< Activates the fast-forward.
+    Model<TSeq> & fast_forward_off(); ///< Deactivates the fast-forward (default.)
+    bool is_fast_forward_on() const; ///< Query if the fast-forward is on.
+    bool is_absorbing(); ///< Query if the model reached an absorbing state.
+    ///@}
+
+    /**
+     * @name Batched uniforms
+     * @details When on, `runif()` takes its numbers from a buffer filled
+     * in blocks by `EPI_RUNIF_LANES` interleaved xoshiro256** generators
+     * (`epi_xoshiro256ss_lanes`), instead of drawing them one at a time from
+     * the model's engine. This speeds up models drawing many uniforms (e.g.,
+     * the contact sampling of the mixing models).
+     *
+     * The batched stream is seeded by `seed()` and is separate from the
+     * engine used by the other distributions. Results are reproducible
+     * for a given seed and number of lanes, but differ from those obtained
+     * with the option off. Within a parallel update, `runif()` still draws
+     * from the per-agent streams.
+     */
+    ///@{
+    Model<TSeq> & runif_batch_on(); ///< Activates the batched uniforms.
+    Model<TSeq> & runif_batch_off(); ///< Deactivates the batched uniforms (default.)
+    bool is_runif_batch_on() const; ///< Query if the batched uniforms are on.
+    ///@}
+
+    /**
+     * @name Parallel update of the agents' states
+     * @details When on, `update_state()` runs the update functions of the
+     * agents in parallel (OpenMP) and the resulting events are applied in
+     * the same order as in a serial run. Each agent draws random numbers
+     * from its own Philox stream, keyed by the seed and the simulation id
+     * (`rng_seed ^ sim_id * 0x9e3779b97f4a7c15`) and positioned at the
+     * agent and day, so the results are identical for any number of
+     * threads (but differ from those obtained with the option off).
+     *
+     * Update functions must only read the model and register changes
+     * through events (e.g., `Agent::change_state()`, `Agent::set_virus()`).
+     * Functions writing to model members (including contact tracing) are
+     * not safe to run in parallel.
+     *
+     * @param nthreads Number of threads to use.
+     */
+    ///@{
+    Model<TSeq> & parallel_update_on(int nthreads = 2); ///< Activates the parallel update.
+    Model<TSeq> & parallel_update_off(); ///< Deactivates the parallel update (default.)
+    bool is_parallel_update_on() const; ///< Query if the parallel update is on.
+    ///@}
+
     const std::vector< VirusPtr<TSeq> > & get_viruses() const;
     const std::vector< ToolPtr<TSeq> > & get_tools() const;
     Virus<TSeq> & get_virus(size_t id);
@@ -0,0 +1,997 @@
+#ifndef EPIWORLD_MODEL_MEAT_CHECKPOINT_HPP
+#define EPIWORLD_MODEL_MEAT_CHECKPOINT_HPP
+
+#include "model-bones.hpp"
+
+/**
+ * @name Binary (de)serialization used by checkpoints
+ * @details Values are written in native byte order. Vectors of trivially
+ * copyable types are written as a size followed by a single block, so
+ * large arrays (e.g., the network and the history) are read with one
+ * call. All overloads are declared first so they can call each other.
+ */
+///@{
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const T & x);
+inline void checkpoint_write(std::ostream & out, const std::string & x);
+inline void checkpoint_write(std::ostream & out, const std::vector< bool > & x);
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const std::vector< T > & x);
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const std::shared_ptr< T > & x);
+template<typename K, typename V, typename... R>
+inline void checkpoint_write(std::ostream & out, const std::map< K, V, R... > & x);
+
+template<typename T>
+inline void checkpoint_read(std::istream & in, T & x);
+inline void checkpoint_read(std::istream & in, std::string & x);
+inline void checkpoint_read(std::istream & in, std::vector< bool > & x);
+template<typename T>
+inline void checkpoint_read(std::istream & in, std::vector< T > & x);
+template<typename T>
+inline void checkpoint_read(std::istream & in, std::shared_ptr< T > & x);
+template<typename K, typename V, typename... R>
+inline void checkpoint_read(std::istream & in, std::map< K, V, R... > & x);
+
+/** @brief Reads a size, checking the stream first (so garbage is not allocated). */
+inline size_t checkpoint_read_size(std::istream & in)
+{
+
+    uint64_t n = 0u;
+    in.read(reinterpret_cast< char * >(&n), sizeof(n));
+
+    if (!in)
+        throw std::runtime_error("Error reading the checkpoint (truncated file).");
+
+    return static_cast< size_t >(n);
+
+}
+
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const T & x)
+{
+    static_assert(
+        std::is_trivially_copyable< T >::value,
+        "Only trivially copyable types can be written as is."
+    );
+    out.write(reinterpret_cast< const char * >(&x), sizeof(T));
+}
+
+inline void checkpoint_write(std::ostream & out, const std::string & x)
+{
+    checkpoint_write(out, static_cast< uint64_t >(x.size()));
+    out.write(x.data(), static_cast< std::streamsize >(x.size()));
+}
+
+inline void checkpoint_write(std::ostream & out, const std::vector< bool > & x)
+{
+    checkpoint_write(out, static_cast< uint64_t >(x.size()));
+    for (bool b : x)
+        checkpoint_write(out, static_cast< unsigned char >(b));
+}
+
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const std::vector< T > & x)
+{
+
+    checkpoint_write(out, static_cast< uint64_t >(x.size()));
+
+    if constexpr (std::is_trivially_copyable< T >::value)
+        out.write(
+            reinterpret_cast< const char * >(x.data()),
+            static_cast< std::streamsize >(x.size() * sizeof(T))
+        );
+    else
+        for (const auto & x_i : x)
+            checkpoint_write(out, x_i);
+
+}
+
+template<typename T>
+inline void checkpoint_write(std::ostream & out, const std::shared_ptr< T > & x)
+{
+    checkpoint_write(out, static_cast< unsigned char >(x != nullptr));
+    if (x != nullptr)
+        checkpoint_write(out, *x);
+}
+
+template<typename K, typename V, typename... R>
+inline void checkpoint_write(std::ostream & out, const std::map< K, V, R... > & x)
+{
+    checkpoint_write(out, static_cast< uint64_t >(x.size()));
+    for (const auto & kv : x)
+    {
+        checkpoint_write(out, kv.first);
+        checkpoint_write(out, kv.second);
+    }
+}
+
+template<typename T>
+inline void checkpoint_read(std::istream & in, T & x)
+{
+    static_assert(
+        std::is_trivially_copyable< T >::value,
+        "Only trivially copyable types can be read as is."
+    );
+    in.read(reinterpret_cast< char * >(&x), sizeof(T));
+}
+
+inline void checkpoint_read(std::istream & in, std::string & x)
+{
+    x.resize(checkpoint_read_size(in));
+    in.read(&x[0], static_cast< std::streamsize >(x.size()));
+}
+
+inline void checkpoint_read(std::istream & in, std::vector< bool > & x)
+{
+
+    x.resize(checkpoint_read_size(in));
+    for (size_t i = 0u; i < x.size(); ++i)
+    {
+        unsigned char b = 0u;
+        checkpoint_read(in, b);
+        x[i] = (b != 0u);
+    }
+
+}
+
+template<typename T>
+inline void checkpoint_read(std::istream & in, std::vector< T > & x)
+{
+
+    x.resize(checkpoint_read_size(in));
+
+    if constexpr (std::is_trivially_copyable< T >::value)
+        in.read(
+            reinterpret_cast< char * >(x.data()),
+            static_cast< std::streamsize >(x.size() * sizeof(T))
+        );
+    else
+        for (auto & x_i : x)
+            checkpoint_read(in, x_i);
+
+}
+
+template<typename T>
+inline void checkpoint_read(std::istream & in, std::shared_ptr< T > & x)
+{
+
+    unsigned char has_value = 0u;
+    checkpoint_read(in, has_value);
+
+    if (has_value == 0u)
+    {
+        x = nullptr;
+        return;
+    }
+
+    T value;
+    checkpoint_read(in, value);
+    x = std::make_shared< T >(std::move(value));
+
+}
+
+template<typename K, typename V, typename... R>
+inline void checkpoint_read(std::istream & in, std::map< K, V, R... > & x)
+{
+
+    x.clear();
+    size_t n = checkpoint_read_size(in);
+    for (size_t i = 0u; i < n; ++i)
+    {
+        K key;
+        checkpoint_read(in, key);
+        checkpoint_read(in, x[key]);
+    }
+
+}
+
+/**
+ * @brief Writes a map from hashes to ids `0, ..., n - 1` (e.g.,
+ * `DataBase::virus_id`) as the hashes in id order
+ * @details Reading inserts the hashes in the same order in a new map, as
+ * the database did when it registered them, so iterating over the map
+ * (e.g., in `DataBase::record()`) visits the ids in the same order.
+ */
+inline void checkpoint_write_ids(std::ostream & out, const MapVec_type<int,int> & x)
+{
+
+    std::vector< std::vector< int > > keys(x.size());
+    for (const auto & kv : x)
+        keys.at(static_cast< size_t >(kv.second)) = kv.first;
+
+    checkpoint_write(out, keys);
+
+}
+
+inline void checkpoint_read_ids(std::istream & in, MapVec_type<int,int> & x)
+{
+
+    std::vector< std::vector< int > > keys;
+    checkpoint_read(in, keys);
+
+    x = MapVec_type<int,int>();
+    for (size_t i = 0u; i < keys.size(); ++i)
+        x[keys[i]] = static_cast< int >(i);
+
+}
+
+/** @brief Writes the (textual) state of a random number distribution. */
+template<typename TDist>
+inline void checkpoint_write_dist(std::ostream & out, const TDist & dist)
+{
+    std::ostringstream ss;
+    ss << dist;
+    checkpoint_write(out, ss.str());
+}
+
+template<typename TDist>
+inline void checkpoint_read_dist(std::istream & in, TDist & dist)
+{
+    std::string s;
+    checkpoint_read(in, s);
+    std::istringstream ss(s);
+    ss >> dist;
+}
+///@}
+
+#define EPI_CHECKPOINT_MAGIC   "EPIWCKPT"
+#define EPI_CHECKPOINT_VERSION 1u
+
+template<typename TSeq>
+inline void Model<TSeq>::write_checkpoint(std::string fn) const
+{
+
+    std::ofstream out(fn, std::ios_base::out | std::ios_base::binary);
+
+    if (!out)
+        throw std::runtime_error(
+            "Could not open file \"" + fn + "\" for writing."
+        );
+
+    write_checkpoint(out);
+
+    if (!out)
+        throw std::runtime_error(
+            "Error writing the checkpoint to \"" + fn + "\"."
+        );
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::write_checkpoint(std::ostream & out) const
+{
+
+    // Header ------------------------------------------------------------------
+    out.write(EPI_CHECKPOINT_MAGIC, 8);
+    checkpoint_write(out, static_cast< uint32_t >(EPI_CHECKPOINT_VERSION));
+    checkpoint_write(out, std::vector< uint32_t >({
+        sizeof(size_t),
+        sizeof(epiworld_double),
+        sizeof(epiworld_fast_int),
+        sizeof(epiworld_fast_uint),
+        sizeof(epiworld_agent_index),
+        EPI_RUNIF_LANES
+    }));
+
+    // What the model must look like
+    checkpoint_write(out, std::vector< uint64_t >({
+        nstates,
+        population.size(),
+        viruses.size(),
+        tools.size(),
+        entities.size(),
+        globalevents.size()
+    }));
+
+    // Model -------------------------------------------------------------------
+    checkpoint_write(out, current_date);
+    checkpoint_write(out, ndays);
+    checkpoint_write(out, static_cast< uint64_t >(sim_id));
+    checkpoint_write(out, last_seed);
+    checkpoint_write(out, rng_seed);
+    checkpoint_write(out, parameters);
+
+    for (const auto & e : globalevents)
+        checkpoint_write(out, e->get_day());
+
+    // Random numbers
+    uint64_t engine_state[4u];
+    engine->get_state(engine_state);
+    for (auto s : engine_state)
+        checkpoint_write(out, s);
+
+    std::vector< uint64_t > engine_batch_state(4u * EPI_RUNIF_LANES);
+    engine_batch.get_state(engine_batch_state.data());
+    checkpoint_write(out, engine_batch_state);
+    checkpoint_write(out, runif_buffer);
+    checkpoint_write(out, static_cast< uint64_t >(runif_buffer_pos));
+
+    checkpoint_write(out, runifd_a);
+    checkpoint_write(out, runifd_b);
+    checkpoint_write(out, rbinomd_n);
+    checkpoint_write(out, rbinomd_fast_lambda);
+    checkpoint_write(out, rbinomd_use_poisson);
+    checkpoint_write_dist(out, rnormd);
+    checkpoint_write_dist(out, rgammad);
+    checkpoint_write_dist(out, rlognormald);
+    checkpoint_write_dist(out, rexpd);
+    checkpoint_write_dist(out, rbinomd);
+    checkpoint_write_dist(out, rnbinomd);
+    checkpoint_write_dist(out, rgeomd);
+    checkpoint_write_dist(out, rpoissd);
+
+    // Network and agents ------------------------------------------------------
+    checkpoint_write(out, network->offsets);
+    checkpoint_write(out, network->ids);
+    checkpoint_write(out, network->locations);
+
+    for (const auto & p : population)
+    {
+
+        checkpoint_write(out, p.state);
+        checkpoint_write(out, p.state_prev);
+        checkpoint_write(out, p.state_last_changed);
+        checkpoint_write(out, p.entities);
+
+        checkpoint_write(out, static_cast< unsigned char >(p.virus != nullptr));
+        if (p.virus != nullptr)
+        {
+            checkpoint_write(out, p.virus->id);
+            checkpoint_write(out, p.virus->date);
+            checkpoint_write(out, p.virus->baseline_sequence);
+        }
+
+        checkpoint_write(out, static_cast< uint64_t >(p.tools.size()));
+        for (const auto & t : p.tools)
+        {
+            checkpoint_write(out, t->id);
+            checkpoint_write(out, t->date);
+            checkpoint_write(out, t->sequence);
+        }
+
+    }
+
+    for (const auto & e : entities)
+        checkpoint_write(out, e.agents);
+
+    // Queue and contact tracing -----------------------------------------------
+    checkpoint_write(out, queue.active);
+    checkpoint_write(out, queue.n_in_queue);
+    checkpoint_write(out, queue.active_list);
+    checkpoint_write(out, queue.in_list);
+
+    bool has_contact_tracing = use_contact_tracing && contact_tracing;
+    checkpoint_write(out, has_contact_tracing);
+    if (has_contact_tracing)
+    {
+        checkpoint_write(out, contact_tracing->contact_matrix);
+        checkpoint_write(out, contact_tracing->contacts_per_agent);
+        checkpoint_write(out, contact_tracing->contact_date);
+        checkpoint_write(out, static_cast< uint64_t >(contact_tracing->n_agents));
+        checkpoint_write(out, static_cast< uint64_t >(contact_tracing->max_contacts));
+    }
+
+    // Database ----------------------------------------------------------------
+    checkpoint_write_ids(out, db.virus_id);
+    checkpoint_write(out, db.virus_name);
+    checkpoint_write(out, db.virus_sequence);
+    checkpoint_write(out, db.virus_origin_date);
+    checkpoint_write(out, db.virus_parent_id);
+
+    checkpoint_write_ids(out, db.tool_id);
+    checkpoint_write(out, db.tool_name);
+    checkpoint_write(out, db.tool_sequence);
+    checkpoint_write(out, db.tool_origin_date);
+
+    checkpoint_write(out, db.today_virus);
+    checkpoint_write(out, db.today_tool);
+    checkpoint_write(out, db.today_total);
+    checkpoint_write(out, db.today_total_nviruses_active);
+    checkpoint_write(out, db.sampling_freq);
+
+    checkpoint_write(out, db.hist_virus_date);
+    checkpoint_write(out, db.hist_virus_id);
+    checkpoint_write(out, db.hist_virus_state);
+    checkpoint_write(out, db.hist_virus_counts);
+
+    checkpoint_write(out, db.hist_tool_date);
+    checkpoint_write(out, db.hist_tool_id);
+    checkpoint_write(out, db.hist_tool_state);
+    checkpoint_write(out, db.hist_tool_counts);
+
+    checkpoint_write(out, db.hist_total_date);
+    checkpoint_write(out, db.hist_total_nviruses_active);
+    checkpoint_write(out, db.hist_total_state);
+    checkpoint_write(out, db.hist_total_counts);
+    checkpoint_write(out, db.hist_transition_matrix);
+
+    checkpoint_write(out, db.transmission_date);
+    checkpoint_write(out, db.transmission_source);
+    checkpoint_write(out, db.transmission_target);
+    checkpoint_write(out, db.transmission_virus);
+    checkpoint_write(out, db.transmission_source_exposure_date);
+
+    checkpoint_write(out, db.transition_matrix);
+    checkpoint_write(out, db.batch_transitions);
+    checkpoint_write(out, db.batch_dirty);
+    checkpoint_write(out, db.batch_counts);
+
+    checkpoint_write(out, db.m_hospitalizations._date);
+    checkpoint_write(out, db.m_hospitalizations._virus_id);
+    checkpoint_write(out, db.m_hospitalizations._tool_id);
+    checkpoint_write(out, db.m_hospitalizations._weight);
+
+    checkpoint_write(out, db.user_data.data_names);
+    checkpoint_write(out, db.user_data.data_dates);
+    checkpoint_write(out, db.user_data.data_data);
+    checkpoint_write(out, db.user_data.k);
+    checkpoint_write(out, db.user_data.n);
+    checkpoint_write(out, db.user_data.last_day);
+
+    write_checkpoint_derived(out);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::read_checkpoint(std::string fn)
+{
+
+    std::ifstream in(fn, std::ios_base::in | std::ios_base::binary);
+
+    if (!in)
+        throw std::runtime_error(
+            "Could not open file \"" + fn + "\" for reading."
+        );
+
+    read_checkpoint(in);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::read_checkpoint(std::istream & in)
+{
+
+    // Header ------------------------------------------------------------------
+    char magic[8u];
+    in.read(magic, 8);
+    if (!in || (std::string(magic, 8u) != EPI_CHECKPOINT_MAGIC))
+        throw std::runtime_error("The stream is not an epiworld checkpoint.");
+
+    uint32_t version = 0u;
+    checkpoint_read(in, version);
+    if (version != EPI_CHECKPOINT_VERSION)
+        throw std::runtime_error(
+            "Unsupported checkpoint version " + std::to_string(version) +
+            " (expected " + std::to_string(EPI_CHECKPOINT_VERSION) + ")."
+        );
+
+    std::vector< uint32_t > layout;
+    checkpoint_read(in, layout);
+    if (layout != std::vector< uint32_t >({
+        sizeof(size_t),
+        sizeof(epiworld_double),
+        sizeof(epiworld_fast_int),
+        sizeof(epiworld_fast_uint),
+        sizeof(epiworld_agent_index),
+        EPI_RUNIF_LANES
+    }))
+        throw std::runtime_error(
+            "The checkpoint was written with different type sizes (or RNG lanes)."
+        );
+
+    std::vector< uint64_t > dims;
+    checkpoint_read(in, dims);
+    std::vector< std::string > dims_names = {
+        "states", "agents", "viruses", "tools", "entities", "global events"
+    };
+    std::vector< uint64_t > dims_model = {
+        nstates,
+        population.size(),
+        viruses.size(),
+        tools.size(),
+        entities.size(),
+        globalevents.size()
+    };
+
+    for (size_t i = 0u; i < dims_model.size(); ++i)
+        if ((i >= dims.size()) || (dims[i] != dims_model[i]))
+            throw std::logic_error(
+                "The checkpoint doesn't match the model: the number of " +
+                dims_names[i] + " is " + std::to_string(dims_model[i]) +
+                " in the model."
+            );
+
+    // Model -------------------------------------------------------------------
+    uint64_t sim_id_ = 0u;
+    checkpoint_read(in, current_date);
+    checkpoint_read(in, ndays);
+    checkpoint_read(in, sim_id_);
+    checkpoint_read(in, last_seed);
+    checkpoint_read(in, rng_seed);
+    sim_id = static_cast< size_t >(sim_id_);
+
+    // Keeping the existing entries, since parameters_ptrs point to them
+    std::map< std::string, epiworld_double > parameters_;
+    checkpoint_read(in, parameters_);
+    for (const auto & kv : parameters_)
+        parameters[kv.first] = kv.second;
+
+    parameters_ptrs_update();
+
+    for (auto & e : globalevents)
+    {
+        int day = -99;
+        checkpoint_read(in, day);
+        e->set_day(day);
+    }
+
+    // Random numbers
+    uint64_t engine_state[4u];
+    for (auto & s : engine_state)
+        checkpoint_read(in, s);
+
+    engine->set_state(engine_state);
+
+    std::vector< uint64_t > engine_batch_state;
+    uint64_t runif_buffer_pos_ = 0u;
+    checkpoint_read(in, engine_batch_state);
+    checkpoint_read(in, runif_buffer);
+    checkpoint_read(in, runif_buffer_pos_);
+    engine_batch.set_state(engine_batch_state.data());
+    runif_buffer_pos = static_cast< size_t >(runif_buffer_pos_);
+
+    checkpoint_read(in, runifd_a);
+    checkpoint_read(in, runifd_b);
+    checkpoint_read(in, rbinomd_n);
+    checkpoint_read(in, rbinomd_fast_lambda);
+    checkpoint_read(in, rbinomd_use_poisson);
+    checkpoint_read_dist(in, rnormd);
+    checkpoint_read_dist(in, rgammad);
+    checkpoint_read_dist(in, rlognormald);
+    checkpoint_read_dist(in, rexpd);
+    checkpoint_read_dist(in, rbinomd);
+    checkpoint_read_dist(in, rnbinomd);
+    checkpoint_read_dist(in, rgeomd);
+    checkpoint_read_dist(in, rpoissd);
+
+    // Network and agents ------------------------------------------------------
+
+    // The network is only replaced if it changed (e.g., rewiring), so it
+    // stays shared with the backup and the copies of the model otherwise.
+    Network net;
+    checkpoint_read(in, net.offsets);
+    checkpoint_read(in, net.ids);
+    checkpoint_read(in, net.locations);
+
+    if (net.vcount() != population.size())
+        throw std::logic_error(
+            "The checkpoint doesn't match the model: the network has " +
+            std::to_string(net.vcount()) + " vertices."
+        );
+
+    if (net != *network)
+        network = std::make_shared< Network >(std::move(net));
+
+    // The templates of the viruses and tools are read after the database,
+    // so the agents' viruses and tools are set at the end.
+    struct Carried {
+        int id;
+        int date;
+        EPI_TYPENAME_TRAITS(TSeq, int) sequence;
+    };
+
+    std::vector< std::vector< Carried > > agents_viruses(population.size());
+    std::vector< std::vector< Carried > > agents_tools(population.size());
+    agents_state.resize(population.size());
+
+    for (auto & p : population)
+    {
+
+        p.n_neighbors = network->degree(p.id);
+
+        checkpoint_read(in, p.state);
+        agents_state[p.id] = p.state;
+        checkpoint_read(in, p.state_prev);
+        checkpoint_read(in, p.state_last_changed);
+        checkpoint_read(in, p.entities);
+
+        unsigned char has_virus = 0u;
+        checkpoint_read(in, has_virus);
+        if (has_virus != 0u)
+        {
+            Carried v;
+            checkpoint_read(in, v.id);
+            checkpoint_read(in, v.date);
+            checkpoint_read(in, v.sequence);
+            agents_viruses[p.id].push_back(std::move(v));
+        }
+
+        size_t ntools = checkpoint_read_size(in);
+        for (size_t i = 0u; i < ntools; ++i)
+        {
+            Carried t;
+            checkpoint_read(in, t.id);
+            checkpoint_read(in, t.date);
+            checkpoint_read(in, t.sequence);
+            agents_tools[p.id].push_back(std::move(t));
+        }
+
+    }
+
+    for (auto & e : entities)
+        checkpoint_read(in, e.agents);
+
+    // Queue and contact tracing -----------------------------------------------
+    checkpoint_read(in, queue.active);
+    checkpoint_read(in, queue.n_in_queue);
+    checkpoint_read(in, queue.active_list);
+    checkpoint_read(in, queue.in_list);
+
+    bool has_contact_tracing = false;
+    checkpoint_read(in, has_contact_tracing);
+    if (has_contact_tracing)
+    {
+
+        uint64_t n_agents = 0u, max_contacts = 0u;
+        std::vector< epiworld_agent_index > contact_matrix;
+        std::vector< size_t > contacts_per_agent, contact_date;
+        checkpoint_read(in, contact_matrix);
+        checkpoint_read(in, contacts_per_agent);
+        checkpoint_read(in, contact_date);
+        checkpoint_read(in, n_agents);
+        checkpoint_read(in, max_contacts);
+
+        contact_tracing = std::make_unique<ContactTracing>(
+            static_cast< size_t >(n_agents), static_cast< size_t >(max_contacts)
+        );
+        contact_tracing->contact_matrix     = std::move(contact_matrix);
+        contact_tracing->contacts_per_agent = std::move(contacts_per_agent);
+        contact_tracing->contact_date       = std::move(contact_date);
+
+    }
+
+    // Database ----------------------------------------------------------------
+    checkpoint_read_ids(in, db.virus_id);
+    checkpoint_read(in, db.virus_name);
+    checkpoint_read(in, db.virus_sequence);
+    checkpoint_read(in, db.virus_origin_date);
+    checkpoint_read(in, db.virus_parent_id);
+
+    checkpoint_read_ids(in, db.tool_id);
+    checkpoint_read(in, db.tool_name);
+    checkpoint_read(in, db.tool_sequence);
+    checkpoint_read(in, db.tool_origin_date);
+
+    checkpoint_read(in, db.today_virus);
+    checkpoint_read(in, db.today_tool);
+    checkpoint_read(in, db.today_total);
+    checkpoint_read(in, db.today_total_nviruses_active);
+    checkpoint_read(in, db.sampling_freq);
+
+    checkpoint_read(in, db.hist_virus_date);
+    checkpoint_read(in, db.hist_virus_id);
+    checkpoint_read(in, db.hist_virus_state);
+    checkpoint_read(in, db.hist_virus_counts);
+
+    checkpoint_read(in, db.hist_tool_date);
+    checkpoint_read(in, db.hist_tool_id);
+    checkpoint_read(in, db.hist_tool_state);
+    checkpoint_read(in, db.hist_tool_counts);
+
+    checkpoint_read(in, db.hist_total_date);
+    checkpoint_read(in, db.hist_total_nviruses_active);
+    checkpoint_read(in, db.hist_total_state);
+    checkpoint_read(in, db.hist_total_counts);
+    checkpoint_read(in, db.hist_transition_matrix);
+
+    checkpoint_read(in, db.transmission_date);
+    checkpoint_read(in, db.transmission_source);
+    checkpoint_read(in, db.transmission_target);
+    checkpoint_read(in, db.transmission_virus);
+    checkpoint_read(in, db.transmission_source_exposure_date);
+
+    checkpoint_read(in, db.transition_matrix);
+    checkpoint_read(in, db.batch_transitions);
+    checkpoint_read(in, db.batch_dirty);
+    checkpoint_read(in, db.batch_counts);
+
+    checkpoint_read(in, db.m_hospitalizations._date);
+    checkpoint_read(in, db.m_hospitalizations._virus_id);
+    checkpoint_read(in, db.m_hospitalizations._tool_id);
+    checkpoint_read(in, db.m_hospitalizations._weight);
+
+    checkpoint_read(in, db.user_data.data_names);
+    checkpoint_read(in, db.user_data.data_dates);
+    checkpoint_read(in, db.user_data.data_data);
+    checkpoint_read(in, db.user_data.k);
+    checkpoint_read(in, db.user_data.n);
+    checkpoint_read(in, db.user_data.last_day);
+
+    if (!in)
+        throw std::runtime_error("Error reading the checkpoint (truncated file).");
+
+    // Viruses and tools -------------------------------------------------------
+
+    // Each virus id is rebuilt from the model's virus it descends from
+    std::vector< const Virus<TSeq> * > virus_template(db.virus_name.size(), nullptr);
+    for (size_t i = 0u; i < virus_template.size(); ++i)
+    {
+
+        int ancestor = static_cast< int >(i);
+        while ((ancestor >= 0) && (virus_template[i] == nullptr))
+        {
+
+            for (const auto & v : viruses)
+                if (v->get_id() == ancestor)
+                    virus_template[i] = v.get();
+
+            if (static_cast< size_t >(ancestor) >= db.virus_parent_id.size())
+                break;
+
+            ancestor = db.virus_parent_id[ancestor];
+
+        }
+
+    }
+
+    std::vector< const Tool<TSeq> * > tool_template(db.tool_name.size(), nullptr);
+    for (const auto & t : tools)
+        if ((t->get_id() >= 0) && (static_cast< size_t >(t->get_id()) < tool_template.size()))
+            tool_template[t->get_id()] = t.get();
+
+    for (auto & p : population)
+    {
+
+        p.virus = nullptr;
+        for (auto & v : agents_viruses[p.id])
+        {
+
+            if ((v.id < 0) || (static_cast< size_t >(v.id) >= virus_template.size()) ||
+                (virus_template[v.id] == nullptr))
+                throw std::logic_error(
+                    "The checkpoint doesn't match the model: the virus with id " +
+                    std::to_string(v.id) + " is not in the model."
+                );
+
+            p.virus = VirusPtr<TSeq>(virus_template[v.id]->clone_ptr());
+            p.virus->id   = v.id;
+            p.virus->date = v.date;
+            p.virus->baseline_sequence = std::move(v.sequence);
+            p.virus->set_agent(&p);
+
+        }
+
+        p.tools.clear();
+        for (auto & t : agents_tools[p.id])
+        {
+
+            if ((t.id < 0) || (static_cast< size_t >(t.id) >= tool_template.size()) ||
+                (tool_template[t.id] == nullptr))
+                throw std::logic_error(
+                    "The checkpoint doesn't match the model: the tool with id " +
+                    std::to_string(t.id) + " is not in the model."
+                );
+
+            p.tools.emplace_back(ToolPtr<TSeq>(tool_template[t.id]->clone_ptr()));
+            p.tools.back()->id       = t.id;
+            p.tools.back()->date     = t.date;
+            p.tools.back()->sequence = std::move(t.sequence);
+            p.tools.back()->set_agent(&p, p.tools.size() - 1u);
+
+        }
+
+        p.tools_effects_update();
+
+    }
+
+    read_checkpoint_derived_keep_rng(in);
+
+    if (!in)
+        throw std::runtime_error("Error reading the checkpoint (truncated file).");
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::read_checkpoint_derived_keep_rng(std::istream & in)
+{
+
+    // Rebuilding the lists of derived models may also set the binomial
+    // distribution (e.g., `ModelSIRCONN::update_infected()`), which was
+    // already restored with its cached draws.
+    auto rbinomd_             = rbinomd;
+    auto rbinomd_n_           = rbinomd_n;
+    auto rbinomd_fast_lambda_ = rbinomd_fast_lambda;
+    auto rbinomd_use_poisson_ = rbinomd_use_poisson;
+
+    read_checkpoint_derived(in);
+
+    rbinomd             = rbinomd_;
+    rbinomd_n           = rbinomd_n_;
+    rbinomd_fast_lambda = rbinomd_fast_lambda_;
+    rbinomd_use_poisson = rbinomd_use_poisson_;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::write_checkpoint_derived(std::ostream &) const
+{
+    return;
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::read_checkpoint_derived(std::istream &)
+{
+    return;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::resume(epiworld_fast_uint ndays)
+{
+
+    if (size() == 0u)
+        throw std::logic_error("There are no agents in this model!");
+
+    pb = Progress(ndays, 80);
+
+    // As in run_setup()
+    parameters_ptrs_update();
+
+    // Back to the day after the last recorded one (as in the loop of
+    // run()); the simulation id is kept, since this is the same run.
+    this->current_date++;
+
+    time_start = std::chrono::steady_clock::now();
+
+    // The profile of the run keeps growing; only the new days go to the total
+    Profiler profile_before = profile;
+    profile.reset();
+
+    run_days(ndays);
+
+    this->current_date--;
+    this->ndays += ndays;
+
+    time_end = std::chrono::steady_clock::now();
+    time_elapsed += (time_end - time_start);
+
+    profile_total  += profile;
+    profile_before += profile;
+    profile = profile_before;
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::run_scenarios(
+    epiworld_fast_uint ndays,
+    epiworld_fast_uint burnin,
+    const std::vector< std::map< std::string, epiworld_double > > & scenarios,
+    epiworld_fast_uint nreplicates,
+    int seed,
+    std::function<void(size_t,Model<TSeq>*)> fun,
+    bool verbose,
+    #ifdef _OPENMP
+    int nthreads
+    #else
+    int
+    #endif
+)
+{
+
+    if (burnin > ndays)
+        throw std::logic_error(
+            "The burn-in (" + std::to_string(burnin) + " days) cannot be " +
+            "longer than the simulation (" + std::to_string(ndays) + " days)."
+        );
+
+    if (scenarios.size() == 0u)
+        throw std::logic_error("There must be at least one scenario.");
+
+    if (nreplicates == 0u)
+        throw std::logic_error("The number of replicates must be above 0.");
+
+    // Failing early (and not within the threads) on unknown parameters
+    for (const auto & scenario : scenarios)
+        for (const auto & p : scenario)
+            if (parameters.find(p.first) == parameters.end())
+                throw std::logic_error(
+                    "The parameter '" + p.first + "' does not exists."
+                );
+
+    if (seed >= 0)
+        this->seed(static_cast< size_t >(seed));
+
+    // Seeds are bound to the fork (the first one is for the burn-in)
+    const size_t nforks = scenarios.size() * nreplicates;
+    std::vector< int > seeds_n(nforks + 1u);
+    for (auto & s : seeds_n)
+    {
+        s = static_cast<int>(
+            std::floor(
+                runif() * static_cast<double>(std::numeric_limits<int>::max())
+                )
+        );
+    }
+
+    bool old_verb = this->verbose;
+    verbose_off();
+
+    // Burn-in, shared by all the forks
+    run(burnin, seeds_n[0u]);
+
+    std::ostringstream snapshot_out(std::ios_base::out | std::ios_base::binary);
+    write_checkpoint(snapshot_out);
+    const std::string snapshot = snapshot_out.str();
+
+    auto run_fork = [&scenarios, &snapshot, &seeds_n, ndays, burnin, nreplicates](
+        size_t fork, Model<TSeq> * model
+    ) -> void {
+
+        std::istringstream snapshot_in(
+            snapshot, std::ios_base::in | std::ios_base::binary
+        );
+        model->read_checkpoint(snapshot_in);
+
+        for (const auto & p : scenarios[fork / nreplicates])
+            model->set_param(p.first, p.second);
+
+        model->set_sim_id(fork);
+        model->seed(static_cast< size_t >(seeds_n[fork + 1u]));
+        model->resume(ndays - burnin);
+
+    };
+
+    Progress pb_multiple(
+        static_cast<int>(nforks),
+        EPIWORLD_PROGRESS_BAR_WIDTH
+        );
+
+    #ifdef _OPENMP
+    // Not more than the number of forks
+    nthreads =
+        static_cast<size_t>(nthreads) > nforks ? nforks : nthreads;
+    #endif
+
+    if (verbose)
+    {
+
+        #ifdef _OPENMP
+        printf_epiworld(
+            "Starting %i scenario(s) x %i replicate(s) using %i thread(s)\n",
+            static_cast<int>(scenarios.size()),
+            static_cast<int>(nreplicates),
+            static_cast<int>(nthreads)
+        );
+        #else
+        printf_epiworld(
+            "Starting %i scenario(s) x %i replicate(s)\n",
+            static_cast<int>(scenarios.size()),
+            static_cast<int>(nreplicates)
+        );
+        #endif
+
+        pb_multiple.start();
+
+    }
+
+    // Forks are scheduled as the replicates of run_multiple()
+    run_jobs(
+        nforks,
+        #ifdef _OPENMP
+        nthreads,
+        #else
+        1,
+        #endif
+        run_fork, fun, pb_multiple, verbose
+    );
+
+    if (old_verb)
+        verbose_on();
+
+    return *this;
+
+}
+
+#endif
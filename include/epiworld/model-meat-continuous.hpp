@@ -0,0 +1,234 @@
+#ifndef EPIWORLD_MODEL_MEAT_CONTINUOUS_HPP
+#define EPIWORLD_MODEL_MEAT_CONTINUOUS_HPP
+
+#include "model-bones.hpp"
+#include "indexedheap-bones.hpp"
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::run_continuous(
+    epiworld_fast_uint ndays,
+    int seed
+)
+{
+
+    // Classifying the states by their update function
+    static constexpr char absorbing   = 0;
+    static constexpr char susceptible = 1;
+    static constexpr char infected    = 2;
+
+    std::vector< char > kind(nstates, absorbing);
+    for (epiworld_fast_uint s = 0u; s < nstates; ++s)
+    {
+
+        if (state_fun_is(s, nullptr))
+            continue;
+        else if (state_fun_is(s, default_update_susceptible<TSeq>))
+            kind[s] = susceptible;
+        else if (state_fun_is(s, default_update_exposed<TSeq>))
+            kind[s] = infected;
+        else
+            throw std::logic_error(
+                "The state \"" + states_labels[s] + "\" has an update " +
+                "function that is not supported by -run_continuous()-. " +
+                "Only -default_update_susceptible- and " +
+                "-default_update_exposed- can be used."
+            );
+
+    }
+
+    run_setup(ndays, seed);
+
+    // Daily probabilities to rates. Certain events get a very large rate
+    // so they happen (almost) right away.
+    static constexpr epiworld_double rate_max = 1e9;
+    auto prob_to_rate = [](epiworld_double p) -> epiworld_double {
+
+        if (p <= 0.0)
+            return 0.0;
+
+        if (p >= 1.0)
+            return rate_max;
+
+        return -std::log1p(-p);
+
+    };
+
+    const size_t n = population.size();
+    std::vector< epiworld_double > rates(n, 0.0);
+    std::vector< epiworld_double > rates_death(n, 0.0);
+    IndexedMinHeap heap;
+    heap.reset(n);
+
+    // Infection rate from neighbor -> p (zero if the neighbor has no virus)
+    auto infection_rate = [&](Agent<TSeq> & p, Agent<TSeq> & neighbor) -> epiworld_double {
+
+        auto & v = neighbor.get_virus();
+        if (v == nullptr)
+            return 0.0;
+
+        return prob_to_rate(
+            (1.0 - p.get_susceptibility_reduction(v, *this)) *
+            v->get_prob_infecting(this) *
+            (1.0 - neighbor.get_transmission_reduction(v, *this))
+        );
+
+    };
+
+    // Total rate of the next event of the agent. For infected agents, the
+    // rate of death is stored in rates_death.
+    auto agent_rate = [&](Agent<TSeq> & p) -> epiworld_double {
+
+        char k = kind[p.get_state()];
+        if (k == susceptible)
+        {
+
+            if (p.get_virus() != nullptr)
+                return 0.0;
+
+            epiworld_double a = 0.0;
+            for (auto & neighbor : p.neighbors(*this))
+                a += infection_rate(p, neighbor);
+
+            return a;
+
+        }
+        else if (k == infected)
+        {
+
+            auto & v = p.get_virus();
+            if (v == nullptr)
+                return 0.0;
+
+            epiworld_double a_death = prob_to_rate(
+                v->get_prob_death(this) * (1.0 - p.get_death_reduction(v, *this))
+            );
+
+            epiworld_double a_recovery = prob_to_rate(
+                1.0 - (1.0 - v->get_prob_recovery(this)) *
+                    (1.0 - p.get_recovery_enhancer(v, *this))
+            );
+
+            rates_death[p.get_id()] = a_death;
+            return a_death + a_recovery;
+
+        }
+
+        return 0.0;
+
+    };
+
+    // Gibson-Bruck update: pending events are rescaled to the new rate, so
+    // only agents whose event fired (or had none) draw a new time.
+    epiworld_double t = 0.0;
+    auto reschedule = [&](size_t i, bool fired) -> void {
+
+        epiworld_double a_old = rates[i];
+        epiworld_double a_new = agent_rate(population[i]);
+        rates[i] = a_new;
+
+        if (a_new <= 0.0)
+            heap.update(i, std::numeric_limits< epiworld_double >::infinity());
+        else if (!fired && (a_old > 0.0))
+        {
+            if (a_old != a_new)
+                heap.update(i, t + (a_old / a_new) * (heap.key(i) - t));
+        }
+        else
+            heap.update(i, t + rexp(a_new));
+
+    };
+
+    auto fire = [&](size_t i) -> void {
+
+        Agent<TSeq> & p = population[i];
+
+        if (kind[p.get_state()] == infected)
+        {
+
+            if (runif() * rates[i] < rates_death[i])
+            {
+                int rm_state = -1;
+                p.get_virus()->get_state(nullptr, nullptr, &rm_state);
+                p.rm_virus(*this, rm_state);
+            }
+            else
+                p.rm_virus(*this);
+
+        }
+        else
+        {
+
+            // Picking the neighbor who transmits
+            epiworld_double u = runif() * rates[i];
+            Agent<TSeq> * source = nullptr;
+            for (auto & neighbor : p.neighbors(*this))
+            {
+
+                epiworld_double a = infection_rate(p, neighbor);
+                if (a <= 0.0)
+                    continue;
+
+                source = &neighbor;
+                if ((u -= a) < 0.0)
+                    break;
+
+            }
+
+            if (source != nullptr)
+                p.set_virus(*this, *source->get_virus());
+
+        }
+
+        events_run();
+
+        reschedule(i, true);
+
+        const epiworld_agent_index * neighbors = network->neighbors(i);
+        for (size_t j = 0u; j < p.get_n_neighbors(); ++j)
+            reschedule(neighbors[j], false);
+
+    };
+
+    for (size_t i = 0u; i < n; ++i)
+        reschedule(i, true);
+
+    bool refresh_daily = !globalevents.empty() || rewire_fun;
+    for (const auto & v : viruses)
+        if (v->strain->mutation)
+            refresh_daily = true;
+
+    for (epiworld_fast_uint niter = 0; niter < get_ndays(); ++niter)
+    {
+
+        epiworld_double t_end = static_cast< epiworld_double >(niter + 1u);
+        while (heap.top_key() < t_end)
+        {
+            t = heap.top_key();
+            fire(heap.top());
+        }
+
+        t = t_end;
+
+        this->run_globalevents();
+        this->rewire();
+        this->next();
+        this->mutate_virus();
+
+        if (refresh_daily)
+            for (size_t i = 0u; i < n; ++i)
+                reschedule(i, false);
+
+    }
+
+    // The last reaches the end...
+    this->current_date--;
+
+    chrono_end();
+
+    sim_id++;
+
+    return *this;
+
+}
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef EPIWORLD_MODEL_MEAT_MEMORY_HPP
+#define EPIWORLD_MODEL_MEAT_MEMORY_HPP
+
+#include "model-bones.hpp"
+#include "memoryusage-bones.hpp"
+
+template<typename TSeq>
+inline MemoryUsage Model<TSeq>::memory_usage(int nthreads) const
+{
+
+    MemoryUsage res;
+
+    // Agents
+    res.agents = MemoryUsage::bytes(population) +
+        MemoryUsage::bytes(agents_state);
+    for (const auto & a : population)
+    {
+
+        res.agents_entities += MemoryUsage::bytes(a.entities);
+
+        if (a.virus != nullptr)
+            res.agents_viruses += sizeof(Virus<TSeq>);
+
+        res.agents_tools += MemoryUsage::bytes(a.tools) +
+            a.tools.size() * sizeof(Tool<TSeq>);
+
+    }
+
+    // Network (the backup counts only if it is not the same network)
+    auto network_bytes = [](const Network & net) -> size_t {
+        return MemoryUsage::bytes(net.offsets) + MemoryUsage::bytes(net.ids) +
+            MemoryUsage::bytes(net.locations);
+    };
+
+    res.network = network_bytes(*network);
+    if ((network_backup != nullptr) && (network_backup != network))
+        res.network_backup = network_bytes(*network_backup);
+
+    for (const auto & e : entities)
+        res.entities += sizeof(Entity<TSeq>) + MemoryUsage::bytes(e.agents) +
+            MemoryUsage::bytes(e.location);
+    res.entities += (entities.capacity() - entities.size()) *
+        sizeof(Entity<TSeq>);
+
+    res.queue = MemoryUsage::bytes(queue.active) +
+        MemoryUsage::bytes(queue.active_list) +
+        MemoryUsage::bytes(queue.in_list);
+
+    if (contact_tracing != nullptr)
+        res.contact_tracing = sizeof(ContactTracing) +
+            MemoryUsage::bytes(contact_tracing->contact_matrix) +
+            MemoryUsage::bytes(contact_tracing->contacts_per_agent) +
+            MemoryUsage::bytes(contact_tracing->contact_date);
+
+    auto event_bytes = [](const EventBuffer<TSeq> & e) -> size_t {
+        return MemoryUsage::bytes(e.agent) + MemoryUsage::bytes(e.action) +
+            MemoryUsage::bytes(e.new_state) + MemoryUsage::bytes(e.queue) +
+            MemoryUsage::bytes(e.payload) + MemoryUsage::bytes(e.viruses) +
+            MemoryUsage::bytes(e.tools) + MemoryUsage::bytes(e.entities) +
+            MemoryUsage::bytes(e.order);
+    };
+
+    res.events = event_bytes(events) + MemoryUsage::bytes(events_threads) +
+        MemoryUsage::bytes(engines_threads);
+    for (const auto & e : events_threads)
+        res.events += MemoryUsage::bytes(e);
+
+    res.sampling = MemoryUsage::bytes(sampled_population) +
+        MemoryUsage::bytes(population_left);
+
+    // Database
+    res.db_registry =
+        MemoryUsage::bytes(db.virus_id) +
+        MemoryUsage::bytes(db.virus_name) +
+        MemoryUsage::bytes(db.virus_sequence) +
+        MemoryUsage::bytes(db.virus_origin_date) +
+        MemoryUsage::bytes(db.virus_parent_id) +
+        MemoryUsage::bytes(db.tool_id) +
+        MemoryUsage::bytes(db.tool_name) +
+        MemoryUsage::bytes(db.tool_sequence) +
+        MemoryUsage::bytes(db.tool_origin_date);
+
+    res.db_today = MemoryUsage::bytes(db.today_virus) +
+        MemoryUsage::bytes(db.today_tool) + MemoryUsage::bytes(db.today_total);
+    for (const auto & v : db.today_virus)
+        res.db_today += MemoryUsage::bytes(v);
+    for (const auto & t : db.today_tool)
+        res.db_today += MemoryUsage::bytes(t);
+
+    res.db_hist_virus =
+        MemoryUsage::bytes(db.hist_virus_date) +
+        MemoryUsage::bytes(db.hist_virus_id) +
+        MemoryUsage::bytes(db.hist_virus_state) +
+        MemoryUsage::bytes(db.hist_virus_counts);
+
+    res.db_hist_tool =
+        MemoryUsage::bytes(db.hist_tool_date) +
+        MemoryUsage::bytes(db.hist_tool_id) +
+        MemoryUsage::bytes(db.hist_tool_state) +
+        MemoryUsage::bytes(db.hist_tool_counts);
+
+    res.db_hist_total =
+        MemoryUsage::bytes(db.hist_total_date) +
+        MemoryUsage::bytes(db.hist_total_nviruses_active) +
+        MemoryUsage::bytes(db.hist_total_state) +
+        MemoryUsage::bytes(db.hist_total_counts);
+
+    res.db_hist_transition = MemoryUsage::bytes(db.hist_transition_matrix);
+
+    res.db_transition = MemoryUsage::bytes(db.transition_matrix) +
+        MemoryUsage::bytes(db.batch_counts);
+
+    res.db_transmission =
+        MemoryUsage::bytes(db.transmission_date) +
+        MemoryUsage::bytes(db.transmission_source) +
+        MemoryUsage::bytes(db.transmission_target) +
+        MemoryUsage::bytes(db.transmission_virus) +
+        MemoryUsage::bytes(db.transmission_source_exposure_date);
+
+    res.db_user_data =
+        MemoryUsage::bytes(db.user_data.data_names) +
+        MemoryUsage::bytes(db.user_data.data_dates) +
+        MemoryUsage::bytes(db.user_data.data_data);
+
+    res.db_hospitalizations =
+        MemoryUsage::bytes(db.m_hospitalizations._date) +
+        MemoryUsage::bytes(db.m_hospitalizations._virus_id) +
+        MemoryUsage::bytes(db.m_hospitalizations._tool_id) +
+        MemoryUsage::bytes(db.m_hospitalizations._weight);
+
+    // Clones copy everything but the network
+    if (nthreads > 1)
+        res.thread_clones = static_cast< size_t >(nthreads - 1) *
+            (res.total() - res.network - res.network_backup);
+
+    return res;
+
+}
+
+template<typename TSeq>
+inline MemoryUsage Model<TSeq>::estimate_memory_usage(
+    size_t n,
+    epiworld_double mean_degree,
+    size_t nstates,
+    size_t ndays,
+    size_t nviruses,
+    size_t ntools,
+    int nthreads
+)
+{
+
+    MemoryUsage res;
+
+    size_t nties = static_cast< size_t >(
+        static_cast< epiworld_double >(n) * mean_degree + 0.5
+    );
+
+    // History rows (date, id or active viruses, state, and count), from
+    // day 0 to ndays
+    size_t nrecords = ndays + 1u;
+    size_t nrow     = sizeof(int) * 3u + sizeof(epiworld_fast_uint);
+
+    res.agents         = n * (sizeof(Agent<TSeq>) + sizeof(unsigned int));
+    res.agents_viruses = n * sizeof(Virus<TSeq>);
+    res.agents_tools   = n * ntools * (sizeof(ToolPtr<TSeq>) + sizeof(Tool<TSeq>));
+
+    res.network = (n + 1u) * sizeof(size_t) +
+        2u * nties * sizeof(epiworld_agent_index);
+    res.queue   = n * (sizeof(epiworld_fast_int) + sizeof(size_t)) +
+        (n + 7u) / 8u;
+
+    res.db_today = (nviruses + ntools + 1u) * nstates * sizeof(int);
+    res.db_hist_virus      = nrecords * nviruses * nstates * nrow;
+    res.db_hist_tool       = nrecords * ntools * nstates * nrow;
+    res.db_hist_total      = nrecords * nstates * nrow;
+    res.db_hist_transition = nrecords * nstates * nstates * sizeof(int);
+    res.db_transition      = nstates * nstates * sizeof(int);
+    res.db_transmission    = n * 5u * sizeof(int);
+
+    if (nthreads > 1)
+        res.thread_clones = static_cast< size_t >(nthreads - 1) *
+            (res.total() - res.network);
+
+    return res;
+
+}
+
+#endif
@@ -143,36 +143,27 @@ inline void Model<TSeq>::_add_event(
     EventAction action_
 ) {
 
-    ++nactions;
-
-    #ifdef EPI_DEBUG
-    if (nactions == 0)
-        throw std::logic_error("Events cannot be zero!!");
-    #endif
-
-    if (nactions > events.size())
+    // Within a parallel update, events go to the thread's buffer and
+    // are merged (in agent order) afterwards.
+    if (in_parallel_update)
     {
+        #ifdef _OPENMP
+        auto & buffer = events_threads[omp_get_thread_num()];
+        #else
+        auto & buffer = events_threads[0u];
+        #endif
 
-        events.emplace_back(
-            Event<TSeq>(
-                agent_, virus_, tool_, entity_, new_state_, queue_, action_
-            ));
+        buffer.emplace_back(
+            agent_, virus_, tool_, entity_, new_state_, queue_, action_
+        );
 
+        return;
     }
-    else
-    {
-
-        Event<TSeq> & A = events.at(nactions - 1u);
 
-        A.agent      = std::move(agent_);
-        A.virus      = std::move(virus_);
-        A.tool       = std::move(tool_);
-        A.entity     = std::move(entity_);
-        A.new_state  = std::move(new_state_);
-        A.queue      = std::move(queue_);
-        A.action     = std::move(action_);
-
-    }
+    events.push(
+        agent_, std::move(virus_), std::move(tool_), entity_,
+        new_state_, queue_, action_
+    );
 
     return;
 
@@ -181,108 +172,156 @@ inline void Model<TSeq>::_add_event(
 template<typename TSeq>
 inline void Model<TSeq>::events_run()
 {
-    // Making the call
-    size_t nevents_tmp = 0;
-    while (nevents_tmp < nactions)
-    {
 
-        Event<TSeq> & a = events[nevents_tmp++];
-        Agent<TSeq> * p  = a.agent;
+    EPI_PROFILE_SCOPE(profile, EventsRun)
 
-        #ifdef EPI_DEBUG
-        if (a.new_state >= static_cast<epiworld_fast_int>(nstates))
-        {
-            throw std::range_error(
-                "The proposed state " + std::to_string(a.new_state) + " is out of range. " +
-                "The model currently has " + std::to_string(nstates - 1) + " states.");
+    // State counters are accumulated and applied once
+    db.batch_on();
 
-        }
-        else if ((a.new_state != -99) && (a.new_state < 0))
-        {
-            throw std::range_error(
-                "The proposed state " + std::to_string(a.new_state) + " is out of range. " +
-                "The state cannot be negative.");
-        }
-        #endif
+    VirusPtr<TSeq> virus_null = nullptr;
+    ToolPtr<TSeq> tool_null = nullptr;
+    Event<TSeq> a(
+        nullptr, virus_null, tool_null, nullptr, -99, -99,
+        EventAction::ChangeState
+    );
 
-        // Undoing the change in the transition matrix
-        if (
-            (a.new_state != -99) &&
-            (p->state_last_changed == today()) &&
-            (static_cast<int>(p->state) != a.new_state)
-        )
+    try
+    {
+
+        // Events added while running (e.g., by post-recovery functions) are
+        // applied after the current ones
+        size_t nevents_tmp = 0u;
+        while (nevents_tmp < events.size())
         {
-            // Undoing state change in the transition matrix
-            // The previous state is already recorded
-            db.update_state(p->state_prev, p->state, true);
 
-        } else if (p->state_last_changed != today())
-            p->state_prev = p->state; // Recording the previous state
+            const size_t nevents_end = events.size();
+            const std::vector< size_t > * order = events_by_agent ?
+                &events.sort_by_agent(nevents_tmp, nevents_end) : nullptr;
 
-        switch (a.action)
-        {
-        case EventAction::AddVirus:
-            _event_add_virus(a);
-            break;
-        case EventAction::AddTool:
-            _event_add_tool(a);
-            break;
-        case EventAction::AddEntity:
-            _event_add_entity(a);
-            break;
-        case EventAction::RemoveVirus:
-            _event_rm_virus(a);
-            break;
-        case EventAction::RemoveTool:
-            _event_rm_tool(a);
-            break;
-        case EventAction::RemoveEntity:
-            _event_rm_entity(a);
-            break;
-        case EventAction::ChangeState:
-            _event_change_state(a);
-            break;
-        default:
-            throw std::logic_error("The requested event action is not supported.");
-        }
+            for (size_t k = nevents_tmp; k < nevents_end; ++k)
+            {
 
-        if (a.new_state != -99)
-            p->state = a.new_state;
+                events.get(
+                    order ? (*order)[k - nevents_tmp] : k,
+                    a
+                );
+                Agent<TSeq> * p  = a.agent;
 
-        // Registering that the last change was today
-        p->state_last_changed = today();
+                EPI_PROFILE_EVENT(profile, a.action)
 
+                #ifdef EPI_DEBUG
+                if (a.new_state >= static_cast<epiworld_fast_int>(nstates))
+                {
+                    throw std::range_error(
+                        "The proposed state " + std::to_string(a.new_state) + " is out of range. " +
+                        "The model currently has " + std::to_string(nstates - 1) + " states.");
 
-        #ifdef EPI_DEBUG
-        if (static_cast<int>(p->state) >= static_cast<int>(nstates))
-                throw std::range_error(
-                    "The new state " + std::to_string(p->state) + " is out of range. " +
-                    "The model currently has " + std::to_string(nstates - 1) + " states.");
-        #endif
+                }
+                else if ((a.new_state != -99) && (a.new_state < 0))
+                {
+                    throw std::range_error(
+                        "The proposed state " + std::to_string(a.new_state) + " is out of range. " +
+                        "The state cannot be negative.");
+                }
+                #endif
 
-        // Updating queue
-        if (use_queuing && a.queue != -99)
-        {
+                // Undoing the change in the transition matrix
+                if (
+                    (a.new_state != -99) &&
+                    (p->state_last_changed == today()) &&
+                    (static_cast<int>(p->state) != a.new_state)
+                )
+                {
+                    // Undoing state change in the transition matrix
+                    // The previous state is already recorded
+                    db.update_state(p->state_prev, p->state, true);
+
+                } else if (p->state_last_changed != today())
+                    p->state_prev = p->state; // Recording the previous state
+
+                switch (a.action)
+                {
+                case EventAction::AddVirus:
+                    _event_add_virus(a);
+                    break;
+                case EventAction::AddTool:
+                    _event_add_tool(a);
+                    break;
+                case EventAction::AddEntity:
+                    _event_add_entity(a);
+                    break;
+                case EventAction::RemoveVirus:
+                    _event_rm_virus(a);
+                    break;
+                case EventAction::RemoveTool:
+                    _event_rm_tool(a);
+                    break;
+                case EventAction::RemoveEntity:
+                    _event_rm_entity(a);
+                    break;
+                case EventAction::ChangeState:
+                    _event_change_state(a);
+                    break;
+                default:
+                    throw std::logic_error("The requested event action is not supported.");
+                }
+
+                if (a.new_state != -99)
+                {
+                    p->state = a.new_state;
+                    agents_state[static_cast< size_t >(p->id)] = p->state;
+                }
+
+                // Registering that the last change was today
+                p->state_last_changed = today();
+
+
+                #ifdef EPI_DEBUG
+                if (static_cast<int>(p->state) >= static_cast<int>(nstates))
+                        throw std::range_error(
+                            "The new state " + std::to_string(p->state) + " is out of range. " +
+                            "The model currently has " + std::to_string(nstates - 1) + " states.");
+                #endif
+
+                // Updating queue
+                if (use_queuing && a.queue != -99)
+                {
+
+                    if (a.queue == Queue<TSeq>::Everyone)
+                        queue += p;
+                    else if (a.queue == -Queue<TSeq>::Everyone)
+                        queue -= p;
+                    else if (a.queue == Queue<TSeq>::OnlySelf)
+                        queue[p->get_id()]++;
+                    else if (a.queue == -Queue<TSeq>::OnlySelf)
+                        queue[p->get_id()]--;
+                    else if (a.queue != Queue<TSeq>::NoOne)
+                        throw std::logic_error(
+                            "The proposed queue change is not valid. Queue values can be {-2, -1, 0, 1, 2}."
+                            );
+
+                }
+
+            }
 
-            if (a.queue == Queue<TSeq>::Everyone)
-                queue += p;
-            else if (a.queue == -Queue<TSeq>::Everyone)
-                queue -= p;
-            else if (a.queue == Queue<TSeq>::OnlySelf)
-                queue[p->get_id()]++;
-            else if (a.queue == -Queue<TSeq>::OnlySelf)
-                queue[p->get_id()]--;
-            else if (a.queue != Queue<TSeq>::NoOne)
-                throw std::logic_error(
-                    "The proposed queue change is not valid. Queue values can be {-2, -1, 0, 1, 2}."
-                    );
+            nevents_tmp = nevents_end;
 
         }
 
+    } catch (...) {
+
+        // Dropping the rest of the day's events (their payloads may have
+        // been moved out already)
+        db.batch_off();
+        events.clear();
+        throw;
+
     }
 
+    db.batch_off();
+
     // Go back to square 1
-    nactions = 0u;
+    events.clear();
 
     return;
 
@@ -302,8 +341,11 @@ inline epiworld_double Model<TSeq>::susceptibility_reduction_mixer(
     VirusPtr<TSeq> & v
 )
 {
+    if (p->tools_effects_fixed & (1u << 0u))
+        return 1.0 - p->tools_effects[0u];
+
     epiworld_double total = 1.0;
-    for (auto & tool : p->get_tools())
+    for (auto & tool : p->tools)
         total *= (1.0 - tool->get_susceptibility_reduction(v, this));
 
     return 1.0 - total;
@@ -316,8 +358,11 @@ inline epiworld_double Model<TSeq>::transmission_reduction_mixer(
     VirusPtr<TSeq> & v
 )
 {
+    if (p->tools_effects_fixed & (1u << 1u))
+        return 1.0 - p->tools_effects[1u];
+
     epiworld_double total = 1.0;
-    for (auto & tool : p->get_tools())
+    for (auto & tool : p->tools)
         total *= (1.0 - tool->get_transmission_reduction(v, this));
 
     return (1.0 - total);
@@ -330,8 +375,11 @@ inline epiworld_double Model<TSeq>::recovery_enhancer_mixer(
     VirusPtr<TSeq> & v
 )
 {
+    if (p->tools_effects_fixed & (1u << 2u))
+        return 1.0 - p->tools_effects[2u];
+
     epiworld_double total = 1.0;
-    for (auto & tool : p->get_tools())
+    for (auto & tool : p->tools)
         total *= (1.0 - tool->get_recovery_enhancer(v, this));
 
     return 1.0 - total;
@@ -344,8 +392,11 @@ inline epiworld_double Model<TSeq>::death_reduction_mixer(
     VirusPtr<TSeq> & v
 ) {
 
+    if (p->tools_effects_fixed & (1u << 3u))
+        return 1.0 - p->tools_effects[3u];
+
     epiworld_double total = 1.0;
-    for (auto & tool : p->get_tools())
+    for (auto & tool : p->tools)
     {
         total *= (1.0 - tool->get_death_reduction(v, this));
     }
@@ -383,11 +434,14 @@ inline Model<TSeq>::Model(const Model<TSeq> & model) :
     name(model.name),
     db(model.db),
     population(model.population),
-    population_backup(model.population_backup),
+    agents_state(model.agents_state),
+    network(model.network),
+    network_backup(model.network_backup),
     directed(model.directed),
     viruses(),
     tools(),
     entities(model.entities),
+    use_runif_batch(model.use_runif_batch),
     rewire_fun(model.rewire_fun),
     rewire_prop(model.rewire_prop),
     parameters(model.parameters),
@@ -403,13 +457,20 @@ inline Model<TSeq>::Model(const Model<TSeq> & model) :
     queue(model.queue),
     use_queuing(model.use_queuing),
     sim_id(model.sim_id),
+    aggregated(model.aggregated),
+    aggregated_sizes(model.aggregated_sizes),
     contact_tracing(
         model.contact_tracing
             ? std::make_unique<ContactTracing>(*model.contact_tracing)
             : nullptr
     ),
     use_contact_tracing(model.use_contact_tracing),
-    contact_tracing_max_contacts(model.contact_tracing_max_contacts)
+    contact_tracing_max_contacts(model.contact_tracing_max_contacts),
+    events_by_agent(model.events_by_agent),
+    fast_forward(model.fast_forward),
+    absorbing_fun(model.absorbing_fun),
+    use_parallel_update(model.use_parallel_update),
+    parallel_update_nthreads(model.parallel_update_nthreads)
 {
 
     // Pointing to the right place. This needs
@@ -421,6 +482,8 @@ inline Model<TSeq>::Model(const Model<TSeq> & model) :
     if (use_queuing)
         queue.model = this;
 
+    parameters_ptrs_update();
+
     agents_data = model.agents_data;
     agents_data_ncols = model.agents_data_ncols;
 
@@ -452,7 +515,9 @@ inline Model<TSeq>::Model(Model<TSeq> && model) :
     name(std::move(model.name)),
     db(std::move(model.db)),
     population(std::move(model.population)),
-    population_backup(std::move(model.population_backup)),
+    agents_state(std::move(model.agents_state)),
+    network(std::move(model.network)),
+    network_backup(std::move(model.network_backup)),
     agents_data(std::move(model.agents_data)),
     agents_data_ncols(std::move(model.agents_data_ncols)),
     directed(std::move(model.directed)),
@@ -464,6 +529,11 @@ inline Model<TSeq>::Model(Model<TSeq> && model) :
     entities(std::move(model.entities)),
     // Pseudo-RNG
     engine(std::move(model.engine)),
+    rng_seed(model.rng_seed),
+    use_runif_batch(model.use_runif_batch),
+    engine_batch(model.engine_batch),
+    runif_buffer(std::move(model.runif_buffer)),
+    runif_buffer_pos(model.runif_buffer_pos),
     runifd_a(model.runifd_a),
     runifd_b(model.runifd_b),
     rnormd(std::move(model.rnormd)),
@@ -491,9 +561,16 @@ inline Model<TSeq>::Model(Model<TSeq> && model) :
     queue(std::move(model.queue)),
     use_queuing(model.use_queuing),
     sim_id(model.sim_id),
+    aggregated(model.aggregated),
+    aggregated_sizes(model.aggregated_sizes),
     contact_tracing(std::move(model.contact_tracing)),
     use_contact_tracing(model.use_contact_tracing),
-    contact_tracing_max_contacts(model.contact_tracing_max_contacts)
+    contact_tracing_max_contacts(model.contact_tracing_max_contacts),
+    events_by_agent(model.events_by_agent),
+    fast_forward(model.fast_forward),
+    absorbing_fun(model.absorbing_fun),
+    use_parallel_update(model.use_parallel_update),
+    parallel_update_nthreads(model.parallel_update_nthreads)
 {
 
     db.model = this;
@@ -502,6 +579,8 @@ inline Model<TSeq>::Model(Model<TSeq> && model) :
     if (use_queuing)
         queue.model = this;
 
+    parameters_ptrs_update();
+
 }
 
 template<typename TSeq>
@@ -513,7 +592,9 @@ inline Model<TSeq> & Model<TSeq>::operator=(const Model<TSeq> & m)
     name = m.name;
 
     population        = m.population;
-    population_backup = m.population_backup;
+    agents_state      = m.agents_state;
+    network           = m.network;
+    network_backup    = m.network_backup;
 
     db = m.db;
     db.model = this;
@@ -537,6 +618,7 @@ inline Model<TSeq> & Model<TSeq>::operator=(const Model<TSeq> & m)
     rewire_prop = m.rewire_prop;
 
     parameters = m.parameters;
+    parameters_ptrs_update();
     ndays      = m.ndays;
     pb         = m.pb;
 
@@ -557,19 +639,45 @@ inline Model<TSeq> & Model<TSeq>::operator=(const Model<TSeq> & m)
     queue = m.queue;
     use_queuing = m.use_queuing;
 
+    aggregated = m.aggregated;
+    aggregated_sizes = m.aggregated_sizes;
+
     contact_tracing = m.contact_tracing
         ? std::make_unique<ContactTracing>(*m.contact_tracing)
         : nullptr;
     use_contact_tracing = m.use_contact_tracing;
     contact_tracing_max_contacts = m.contact_tracing_max_contacts;
 
+    events_by_agent = m.events_by_agent;
+    fast_forward = m.fast_forward;
+    absorbing_fun = m.absorbing_fun;
+    use_parallel_update = m.use_parallel_update;
+    parallel_update_nthreads = m.parallel_update_nthreads;
+    use_runif_batch = m.use_runif_batch;
+
     agents_data = m.agents_data;
     agents_data_ncols = m.agents_data_ncols;
 
+    // The random numbers continue where those of m are
+    *engine = *m.engine;
+    rng_seed = m.rng_seed;
+    last_seed = m.last_seed;
+    engine_batch = m.engine_batch;
+    runif_buffer = m.runif_buffer;
+    runif_buffer_pos = m.runif_buffer_pos;
+    runifd_a = m.runifd_a;
+    runifd_b = m.runifd_b;
+    rnormd = m.rnormd;
+    rgammad = m.rgammad;
+    rlognormald = m.rlognormald;
+    rexpd = m.rexpd;
     rbinomd = m.rbinomd;
     rbinomd_n = m.rbinomd_n;
     rbinomd_fast_lambda = m.rbinomd_fast_lambda;
     rbinomd_use_poisson = m.rbinomd_use_poisson;
+    rnbinomd = m.rnbinomd;
+    rgeomd = m.rgeomd;
+    rpoissd = m.rpoissd;
 
     // Figure out the queuing
     if (use_queuing)
@@ -602,6 +710,24 @@ inline std::vector<Agent<TSeq>> & Model<TSeq>::get_agents()
     return population;
 }
 
+template<typename TSeq>
+inline const Network & Model<TSeq>::get_network() const
+{
+    return *network;
+}
+
+template<typename TSeq>
+inline Network & Model<TSeq>::get_network_mutable()
+{
+
+    // Shared with a clone or the backup, so we need our own copy
+    if (network.use_count() > 1)
+        network = std::make_shared< Network >(*network);
+
+    return *network;
+
+}
+
 template<typename TSeq>
 inline Agent<TSeq> & Model<TSeq>::get_agent(size_t i)
 {
@@ -611,11 +737,9 @@ inline Agent<TSeq> & Model<TSeq>::get_agent(size_t i)
 template<typename TSeq>
 inline std::vector< epiworld_fast_uint > Model<TSeq>::get_agents_states() const
 {
-    std::vector< epiworld_fast_uint > states(population.size());
-    for (size_t i = 0u; i < population.size(); ++i)
-        states[i] = population[i].get_state();
-
-    return states;
+    return std::vector< epiworld_fast_uint >(
+        agents_state.begin(), agents_state.end()
+    );
 }
 
 template<typename TSeq>
@@ -712,6 +836,11 @@ inline void Model<TSeq>::agents_empty_graph(
     // Resizing the people
     population.clear();
     population.resize(n);
+    agents_state.assign(n, 0u);
+    network = std::make_shared< Network >(n);
+
+    // A new network invalidates the backup
+    network_backup = nullptr;
 
     // Filling the model and ids
     size_t i = 0u;
@@ -756,10 +885,11 @@ inline Model<TSeq> & Model<TSeq>::agents_bernoulli(
 template<typename TSeq>
 inline epiworld_double Model<TSeq>::operator()(std::string pname) {
 
-    if (parameters.find(pname) == parameters.end())
+    const auto iter = parameters.find(pname);
+    if (iter == parameters.end())
         throw std::range_error("The parameter '"+ pname + "' is not in the model.");
 
-    return parameters[pname];
+    return iter->second;
 
 }
 
@@ -817,6 +947,7 @@ inline void Model<TSeq>::dist_entities()
 
 template<typename TSeq>
 inline void Model<TSeq>::chrono_start() {
+    profile.reset();
     time_start = std::chrono::steady_clock::now();
 }
 
@@ -825,14 +956,17 @@ inline void Model<TSeq>::chrono_end() {
     time_end = std::chrono::steady_clock::now();
     time_elapsed += (time_end - time_start);
     n_replicates++;
+    profile_total += profile;
 }
 
 template<typename TSeq>
 inline void Model<TSeq>::set_backup()
 {
 
-    if (population_backup.size() == 0u)
-        population_backup = std::vector< Agent<TSeq> >(population);
+    // No copy is made here; the backup shares the network until
+    // the network is modified (e.g., by rewiring).
+    if (!network_backup)
+        network_backup = network;
 
 }
 
@@ -1149,24 +1283,11 @@ inline void Model<TSeq>::agents_from_adjlist(AdjList al) {
     // Resizing the people
     agents_empty_graph(al.vcount());
 
-    const auto & tmpdat = al.get_dat();
-
-    for (size_t i = 0u; i < tmpdat.size(); ++i)
-    {
-
-        // population[i].id    = i;
-
-        for (const auto & link: tmpdat[i])
-        {
-
-            population[i].add_neighbor(
-                population[link.first],
-                true, true
-                );
-
-        }
-
-    }
+    // Building the network and updating the degrees
+    auto & net = get_network_mutable();
+    net.build(al);
+    for (auto & p: population)
+        p.n_neighbors = net.degree(p.id);
 
     #ifdef EPI_DEBUG
     for (auto & p: population)
@@ -1228,7 +1349,11 @@ inline void Model<TSeq>::next() {
 
     #endif
 
-    db.record();
+    {
+        EPI_PROFILE_SCOPE(profile, Record)
+        db.record();
+    }
+
     ++this->current_date;
 
     // Advancing the progress bar
@@ -1239,7 +1364,7 @@ inline void Model<TSeq>::next() {
 }
 
 template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::run(
+inline void Model<TSeq>::run_setup(
     epiworld_fast_uint ndays,
     int seed
 )
@@ -1262,10 +1387,13 @@ inline Model<TSeq> & Model<TSeq>::run(
     this->ndays = ndays;
 
     if (seed >= 0)
-        engine->seed(seed);
+        this->seed(static_cast< size_t >(seed));
 
     last_seed = seed;
 
+    // Binding the parameters added through `params()` (par(id) only reads)
+    parameters_ptrs_update();
+
     // Checking whether the proposed state in/out/removed
     // are valid
     epiworld_fast_int _init, _end, _removed;
@@ -1314,7 +1442,51 @@ inline Model<TSeq> & Model<TSeq>::run(
         printf_epiworld("Running the model...\n");
     }
 
-    for (epiworld_fast_uint niter = 0; niter < get_ndays(); ++niter)
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::run(
+    epiworld_fast_uint ndays,
+    int seed
+)
+{
+
+    if (aggregated)
+    {
+
+        if (seed >= 0)
+            this->seed(static_cast< size_t >(seed));
+
+        last_seed = seed;
+
+        // The binomial keeps cached draws (large n), which would make the
+        // run depend on the previous one
+        rbinomd.reset();
+
+        return run_aggregated(ndays);
+
+    }
+
+    run_setup(ndays, seed);
+
+    run_days(get_ndays());
+
+    // The last reaches the end...
+    this->current_date--;
+
+    chrono_end();
+
+    sim_id++;
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::run_days(epiworld_fast_uint ndays)
+{
+
+    for (epiworld_fast_uint niter = 0; niter < ndays; ++niter)
     {
 
         #ifdef EPI_DEBUG
@@ -1339,268 +1511,759 @@ inline Model<TSeq> & Model<TSeq>::run(
         // Mutation must happen at the very end of all
         this->mutate_virus();
 
-    }
+        // Nothing else can happen, so only the records are left
+        if (fast_forward && (niter + 1u < ndays) && is_absorbing())
+        {
 
-    // The last reaches the end...
-    this->current_date--;
+            for (++niter; niter < ndays; ++niter)
+                this->next();
 
-    chrono_end();
+            break;
 
-    sim_id++;
+        }
 
-    return *this;
+    }
 
 }
 
 template<typename TSeq>
-inline Model<TSeq> & Model<TSeq>::run_multiple(
-    epiworld_fast_uint ndays,
-    epiworld_fast_uint nexperiments,
-    int seed_,
-    std::function<void(size_t,Model<TSeq>*)> fun,
-    bool reset,
-    bool verbose,
-    #ifdef _OPENMP
-    int nthreads
-    #else
-    int
-    #endif
-)
+inline bool Model<TSeq>::is_aggregated() const
 {
+    return aggregated;
+}
 
-    if (seed_ >= 0)
-        this->seed(seed_);
-
-    if (nexperiments == 0u)
-        throw std::logic_error("The number of experiments must be above 0.");
+template<typename TSeq>
+inline void Model<TSeq>::aggregated_enable(std::vector< size_t > group_sizes)
+{
 
-    // Seeds will be reproducible by default
-    std::vector< int > seeds_n(nexperiments);
-    for (auto & s : seeds_n)
+    // Counts are kept as int (as the database)
+    size_t n = 0u;
+    for (auto s : group_sizes)
     {
-        s = static_cast<int>(
-            std::floor(
-                runif() * static_cast<double>(std::numeric_limits<int>::max())
-                )
-        );
-    }
-    // #endif
 
-    if (verbose)
-    {
-        EPI_DEBUG_NOTIFY_ACTIVE()
+        if (s == 0u)
+            throw std::invalid_argument("Group sizes must be positive.");
+
+        n += s;
+        if (n > static_cast< size_t >(std::numeric_limits< int >::max()))
+            throw std::range_error(
+                "The total of the group sizes cannot be above " +
+                std::to_string(std::numeric_limits< int >::max()) + "."
+            );
+
     }
 
-    bool old_verb = this->verbose;
-    verbose_off();
+    aggregated_sizes = std::move(group_sizes);
+    aggregated = true;
 
-    // Setting up backup
-    if (reset)
-        set_backup();
+    // Releasing the agents
+    agents_empty_graph(0u);
 
-    #ifdef _OPENMP
+}
 
-    // Not more than the number of experiments
-    nthreads =
-        static_cast<size_t>(nthreads) > nexperiments ? nexperiments : nthreads;
-    
-    omp_set_num_threads(nthreads);
+template<typename TSeq>
+inline void Model<TSeq>::aggregated_disable()
+{
 
-    // Generating copies of the model (done serially to avoid races on original)
-    std::vector< std::unique_ptr< Model<TSeq> > > these;
+    if (!aggregated)
+        return;
 
-    for (size_t i = 1u; i < static_cast<size_t>(nthreads); ++i)
-    {
-        these.emplace_back(clone_ptr());
-    }
+    size_t n = 0u;
+    for (auto s : aggregated_sizes)
+        n += s;
 
+    aggregated = false;
+    agents_empty_graph(n);
 
-    // Figuring out how many replicates - distribute remainder evenly
-    std::vector< size_t > nreplicates(nthreads, 0);
-    std::vector< size_t > nreplicates_csum(nthreads, 0);
+}
 
-    size_t base_replicates = nexperiments / nthreads;
-    size_t remainder = nexperiments % nthreads;
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::run_aggregated(epiworld_fast_uint)
+{
+    throw std::logic_error(
+        "The model '" + name + "' cannot run on counts."
+    );
+}
 
-    size_t sums = 0u;
-    for (int i = 0; i < nthreads; ++i)
-    {
-        // Distribute remainder to first 'remainder' threads
-        nreplicates[i] = base_replicates + (static_cast<size_t>(i) < remainder ? 1 : 0);
+template<typename TSeq>
+inline std::vector< int > Model<TSeq>::aggregated_split(
+    epiworld_double prevalence
+)
+{
 
-        // This takes the cumsum
-        nreplicates_csum[i] = sums;
-        sums += nreplicates[i];
-    }
+    size_t n = 0u;
+    for (auto s : aggregated_sizes)
+        n += s;
 
-    Progress pb_multiple(
-        nreplicates[0u],
-        EPIWORLD_PROGRESS_BAR_WIDTH
-        );
+    int n_left = static_cast< int >(
+        std::floor(prevalence * static_cast< epiworld_double >(n))
+    );
+    size_t size_left = n;
 
-    if (verbose)
+    std::vector< int > cases(aggregated_sizes.size());
+    for (size_t g = 0u; g < aggregated_sizes.size(); ++g)
     {
 
-        printf_epiworld(
-            "Starting multiple runs (%i) using %i thread(s)\n",
-            static_cast<int>(nexperiments),
-            static_cast<int>(nthreads)
+        int size_g = static_cast< int >(aggregated_sizes[g]);
+        cases[g] = rbinom(
+            n_left,
+            static_cast< epiworld_double >(size_g) /
+                static_cast< epiworld_double >(size_left)
         );
 
-        pb_multiple.start();
+        if (cases[g] > size_g)
+            cases[g] = size_g;
+
+        n_left    -= cases[g];
+        size_left -= aggregated_sizes[g];
 
     }
 
-    #ifdef EPI_DEBUG
-    // Checking the initial state of all the models. Throw an
-    // exception if they are not the same.
-    for (size_t i = 1; i < static_cast<size_t>(std::max(nthreads - 1, 0)); ++i)
-    {
+    return cases;
 
-        if (db != these[i]->db)
-        {
-            throw std::runtime_error(
-                "The initial state of the models is not the same"
-            );
-        }
-    }
-    #endif
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::aggregated_escape(
+    const ContactMatrix & contact_matrix,
+    size_t i,
+    const std::vector< int > & I,
+    epiworld_double p_transmit
+) const
+{
 
-    #pragma omp parallel shared(these) \
-        firstprivate(nexperiments, nthreads, fun, reset, verbose, pb_multiple, \
-        ndays, nreplicates, nreplicates_csum, seeds_n) default(none)
+    epiworld_double log_escape = 0.0;
+    for (size_t g = 0u; g < aggregated_sizes.size(); ++g)
     {
 
-        auto iam = static_cast<size_t>(omp_get_thread_num());
-        Model<TSeq> * model_ptr = iam == 0 ? this : &(*these[iam - 1u]);
-        size_t my_replicates = nreplicates[iam];
-        size_t my_replicates_csum = nreplicates_csum[iam];
+        if (I[g] == 0)
+            continue;
 
-        for (size_t n = 0u; n < my_replicates; ++n)
-        {
-            size_t run_id = my_replicates_csum + n;
-            if (iam == 0)
-            {
+        epiworld_double p_contact =
+            contact_matrix.get_contact_rate(i, g, false) /
+            static_cast< epiworld_double >(aggregated_sizes[g]);
+
+        if (p_contact > 1.0)
+            p_contact = 1.0;
+
+        log_escape +=
+            static_cast< epiworld_double >(I[g]) *
+            std::log1p(-p_transmit * p_contact);
+
+    }
+
+    return std::exp(log_escape);
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::aggregated_setup(
+    epiworld_fast_uint ndays,
+    const std::vector< int > & totals,
+    const std::vector< bool > & with_virus
+)
+{
+
+    if ((totals.size() != nstates) || (with_virus.size() != nstates))
+        throw std::length_error(
+            "The number of totals (" + std::to_string(totals.size()) +
+            ") must match the number of states (" +
+            std::to_string(nstates) + ")."
+        );
+
+    if (viruses.size() == 0u)
+        throw std::logic_error("Aggregated runs need at least one virus.");
+
+    this->ndays = ndays;
+
+    pb = Progress(ndays, 80);
+    current_date = 0;
+
+    // The counts are set by hand, as there are no agents
+    db.reset();
+    aggregated_with_virus = with_virus;
+    for (epiworld_fast_uint s = 0u; s < nstates; ++s)
+    {
+
+        db.today_total[s] = totals[s];
+        db.transition_matrix[s + s * nstates] = totals[s];
+
+        if (with_virus[s])
+            db.today_virus[0u][s] = totals[s];
+
+    }
+
+    // Record the baseline (day 0) and advance to day 1
+    next();
+
+    chrono_start();
+
+    if (get_verbose())
+    {
+        printf_epiworld("Running the model...\n");
+    }
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::aggregated_move(
+    epiworld_fast_uint from,
+    epiworld_fast_uint to,
+    int n
+)
+{
+
+    if (n == 0)
+        return;
+
+    db.today_total[from] -= n;
+    db.today_total[to]   += n;
+    db.transition_matrix[to * nstates + from]   += n;
+    db.transition_matrix[from * nstates + from] -= n;
+
+    if (aggregated_with_virus[from])
+        db.today_virus[0u][from] -= n;
+
+    if (aggregated_with_virus[to])
+        db.today_virus[0u][to] += n;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::aggregated_end()
+{
+
+    // The last reaches the end...
+    this->current_date--;
+
+    chrono_end();
+
+    sim_id++;
+
+}
+
+template<typename TSeq>
+inline size_t Model<TSeq>::run_jobs(
+    size_t njobs,
+    #ifdef _OPENMP
+    int nthreads,
+    #else
+    int,
+    #endif
+    std::function<void(size_t,Model<TSeq>*)> job,
+    std::function<void(size_t,Model<TSeq>*)> fun,
+    Progress & pb,
+    bool verbose
+)
+{
+
+    #ifdef _OPENMP
+
+    omp_set_num_threads(nthreads);
+
+    // Generating copies of the model (done serially to avoid races on original)
+    std::vector< std::unique_ptr< Model<TSeq> > > these;
+    for (size_t i = 1u; i < static_cast<size_t>(nthreads); ++i)
+        these.emplace_back(clone_ptr());
+
+    #ifdef EPI_DEBUG
+    // Checking the initial state of all the models. Throw an
+    // exception if they are not the same.
+    for (size_t i = 1; i < static_cast<size_t>(std::max(nthreads - 1, 0)); ++i)
+    {
+
+        if (db != these[i]->db)
+        {
+            throw std::runtime_error(
+                "The initial state of the models is not the same"
+            );
+        }
+    }
+    #endif
+
+    // Jobs are handed out dynamically (next free id), since their
+    // runtimes vary a lot
+    size_t next_job    = 0u;
+    size_t n_done      = 0u;
+    size_t n_done_here = 0u;
+    size_t n_ticks     = 0u;
+    Model<TSeq> * last_model = this;
+
+    #pragma omp parallel shared(these, next_job, n_done, n_done_here, \
+        n_ticks, pb, job, fun, last_model) firstprivate(verbose, njobs) \
+        default(none)
+    {
+
+        auto iam = static_cast<size_t>(omp_get_thread_num());
+        Model<TSeq> * model_ptr = iam == 0 ? this : &(*these[iam - 1u]);
+
+        while (true)
+        {
+
+            size_t job_id;
+            #pragma omp atomic capture
+            job_id = next_job++;
+
+            if (job_id >= njobs)
+                break;
+
+            if (iam == 0)
+            {
 
                 // Checking if the user interrupted the simulation
-                EPI_CHECK_USER_INTERRUPT(n);
+                EPI_CHECK_USER_INTERRUPT(n_done_here);
+
+            }
+
+            job(job_id, model_ptr);
+
+            if (job_id == (njobs - 1u))
+                last_model = model_ptr;
+
+            if (fun)
+            {
+                // User callbacks often write into shared result containers.
+                // Serialize callback execution to avoid callback-induced races.
+                #pragma omp critical(epiworld_run_multiple_fun)
+                {
+                    fun(job_id, model_ptr);
+                }
+            }
+
+            #pragma omp atomic
+            n_done++;
+
+            if (iam == 0)
+            {
+
+                n_done_here++;
+
+                // Only the first one prints
+                if (verbose)
+                {
+                    size_t n_done_now;
+                    #pragma omp atomic read
+                    n_done_now = n_done;
+
+                    for (; n_ticks < n_done_now; ++n_ticks)
+                        pb.next();
+                }
+
+            }
+
+        }
+
+    }
+
+    if (verbose)
+        for (; n_ticks < njobs; ++n_ticks)
+            pb.next();
+
+    // The model ends with the state of the last job
+    if (last_model != this)
+    {
+
+        std::stringstream derived(
+            std::ios_base::in | std::ios_base::out | std::ios_base::binary
+        );
+        last_model->write_checkpoint_derived(derived);
+
+        Model<TSeq>::operator=(*last_model);
+
+        profile = last_model->profile;
+
+        read_checkpoint_derived_keep_rng(derived);
+
+    }
+
+    for (auto & m : these)
+        profile_total += m->profile_total;
+
+    return n_done_here;
+
+    #else
+
+    for (size_t n = 0u; n < njobs; ++n)
+    {
+
+        // Checking if the user interrupted the simulation
+        EPI_CHECK_USER_INTERRUPT(n);
+
+        job(n, this);
+
+        if (fun)
+            fun(n, this);
+
+        if (verbose)
+            pb.next();
+
+    }
+
+    return njobs;
+
+    #endif
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::run_multiple(
+    epiworld_fast_uint ndays,
+    epiworld_fast_uint nexperiments,
+    int seed_,
+    std::function<void(size_t,Model<TSeq>*)> fun,
+    bool reset,
+    bool verbose,
+    #ifdef _OPENMP
+    int nthreads
+    #else
+    int
+    #endif
+)
+{
+
+    if (seed_ >= 0)
+        this->seed(seed_);
+
+    if (nexperiments == 0u)
+        throw std::logic_error("The number of experiments must be above 0.");
+
+    // Seeds will be reproducible by default
+    std::vector< int > seeds_n(nexperiments);
+    for (auto & s : seeds_n)
+    {
+        s = static_cast<int>(
+            std::floor(
+                runif() * static_cast<double>(std::numeric_limits<int>::max())
+                )
+        );
+    }
+    // #endif
+
+    if (verbose)
+    {
+        EPI_DEBUG_NOTIFY_ACTIVE()
+    }
+
+    bool old_verb = this->verbose;
+    verbose_off();
+
+    // Setting up backup
+    if (reset)
+        set_backup();
+
+    Progress pb_multiple(
+        static_cast<int>(nexperiments),
+        EPIWORLD_PROGRESS_BAR_WIDTH
+        );
+
+    #ifdef _OPENMP
+    // Not more than the number of experiments
+    nthreads =
+        static_cast<size_t>(nthreads) > nexperiments ? nexperiments : nthreads;
+    #endif
+
+    if (verbose)
+    {
+
+        #ifdef _OPENMP
+        printf_epiworld(
+            "Starting multiple runs (%i) using %i thread(s)\n",
+            static_cast<int>(nexperiments),
+            static_cast<int>(nthreads)
+        );
+        #else
+        printf_epiworld(
+            "Starting multiple runs (%i)\n",
+            static_cast<int>(nexperiments)
+        );
+        #endif
+
+        pb_multiple.start();
+
+    }
+
+    // Seeds are bound to the replicate id, so the results don't depend on
+    // which thread runs which replicate
+    auto run_replicate = [&seeds_n, ndays](size_t run_id, Model<TSeq> * model) -> void {
+        model->set_sim_id(run_id);
+        model->run(ndays, seeds_n[run_id]);
+    };
+
+    size_t n_done_here = run_jobs(
+        nexperiments,
+        #ifdef _OPENMP
+        nthreads,
+        #else
+        1,
+        #endif
+        run_replicate, fun, pb_multiple, verbose
+    );
+
+    // Adjusting the number of replicates (run() counts those of this model)
+    n_replicates += (nexperiments - n_done_here);
+
+    if (old_verb)
+        verbose_on();
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline void Model<TSeq>::update_state() {
+
+    EPI_PROFILE_SCOPE(profile, UpdateState)
+
+    if (use_parallel_update)
+    {
+        update_state_parallel();
+        events_run();
+        return;
+    }
+
+    // Built-in models skip the std::function calls
+    if (update_state_static())
+    {
+        events_run();
+        return;
+    }
+
+    // Next state
+    if (use_queuing)
+    {
+
+        // Only agents in the queue (in ascending order)
+        const auto & active = queue.get_active_agents();
+        EPI_PROFILE_ADD(profile, AgentsVisited, active.size())
+        for (size_t i = 0u; i < active.size(); ++i)
+        {
+            const auto & fun = state_fun[agents_state[active[i]]];
+            if (fun)
+            {
+                EPI_PROFILE_ADD(profile, StateFunCalls, 1u)
+                fun(&population[active[i]], this);
+            }
+        }
+
+    }
+    else
+    {
+
+        // Agents in states without an update function aren't loaded
+        EPI_PROFILE_ADD(profile, AgentsVisited, population.size())
+        for (size_t i = 0u; i < agents_state.size(); ++i)
+        {
+            const auto & fun = state_fun[agents_state[i]];
+            if (fun)
+            {
+                EPI_PROFILE_ADD(profile, StateFunCalls, 1u)
+                fun(&population[i], this);
+            }
+        }
+
+    }
+
+    events_run();
+
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::update_state_static()
+{
+    return false;
+}
+
+template<typename TSeq>
+template<UpdateFunPtr<TSeq>... Funs>
+inline bool Model<TSeq>::update_state_table()
+{
+
+    constexpr size_t nfuns = sizeof...(Funs);
+    const UpdateFunPtr<TSeq> funs[nfuns] = {Funs...};
+
+    // Only if the states still have the model's own functions
+    if (state_fun.size() < nfuns)
+        return false;
+
+    for (size_t s = 0u; s < nfuns; ++s)
+        if (!state_fun_is(s, funs[s]))
+            return false;
+
+    if (use_queuing)
+    {
+
+        const auto & active = queue.get_active_agents();
+        EPI_PROFILE_ADD(profile, AgentsVisited, active.size())
+        for (size_t i = 0u; i < active.size(); ++i)
+            if (state_fun[agents_state[active[i]]])
+                update_state_dispatch<0u, Funs...>(population[active[i]]);
+
+    }
+    else
+    {
+
+        EPI_PROFILE_ADD(profile, AgentsVisited, population.size())
+        for (size_t i = 0u; i < agents_state.size(); ++i)
+            if (state_fun[agents_state[i]])
+                update_state_dispatch<0u, Funs...>(population[i]);
+
+    }
+
+    return true;
+
+}
+
+template<typename TSeq>
+template<size_t I, UpdateFunPtr<TSeq> Fun, UpdateFunPtr<TSeq>... Funs>
+inline void Model<TSeq>::update_state_dispatch(Agent<TSeq> & p)
+{
 
-                // Setting the simulation id
-                model_ptr->set_sim_id(run_id);
+    if (p.state == I)
+    {
+        if constexpr (Fun != nullptr)
+        {
+            EPI_PROFILE_ADD(profile, StateFunCalls, 1u)
+            Fun(&p, this);
+        }
 
-                // Initializing the seed
-                model_ptr->run(ndays, seeds_n[run_id]);
+        return;
+    }
 
-                // Only the first one prints
-                if (verbose)
-                    pb_multiple.next();
+    if constexpr (sizeof...(Funs) > 0u)
+        update_state_dispatch<I + 1u, Funs...>(p);
+    else if (state_fun[p.state])
+    {
+        EPI_PROFILE_ADD(profile, StateFunCalls, 1u)
+        state_fun[p.state](&p, this); // States added by the user
+    }
 
-            } else {
+}
 
-                // Setting the simulation id
-                model_ptr->set_sim_id(run_id);
+template<typename TSeq>
+inline bool Model<TSeq>::state_fun_is(
+    epiworld_fast_uint state,
+    UpdateFunPtr<TSeq> fun
+) const
+{
 
-                // Initializing the seed
-                model_ptr->run(ndays, seeds_n[run_id]);
+    const auto & f = state_fun[state];
 
-            }
+    if (fun == nullptr)
+        return !f;
 
-            if (fun)
-            {
-                // User callbacks often write into shared result containers.
-                // Serialize callback execution to avoid callback-induced races.
-                #pragma omp critical(epiworld_run_multiple_fun)
-                {
-                    fun(run_id, model_ptr);
-                }
-            }
+    const UpdateFunPtr<TSeq> * target = f.template target< UpdateFunPtr<TSeq> >();
+    return (target != nullptr) && (*target == fun);
 
-        }
+}
 
-    }
+template<typename TSeq>
+inline void Model<TSeq>::update_state_parallel() {
 
-    // Adjusting the number of replicates
-    n_replicates += (nexperiments - nreplicates[0u]);
+    const std::vector< size_t > * active = use_queuing ?
+        &queue.get_active_agents() : nullptr;
 
-    #else
+    const size_t n = (active != nullptr) ? active->size() : population.size();
+    EPI_PROFILE_ADD(profile, AgentsVisited, n)
 
-    Progress pb_multiple(
-        nexperiments,
-        EPIWORLD_PROGRESS_BAR_WIDTH
-        )
-        ;
-    if (verbose)
+    const size_t nthreads = static_cast< size_t >(parallel_update_nthreads);
+    if (events_threads.size() < nthreads)
     {
+        events_threads.resize(nthreads);
+        engines_threads.resize(nthreads);
+    }
 
-        printf_epiworld(
-            "Starting multiple runs (%i)\n",
-            static_cast<int>(nexperiments)
-        );
-
-        pb_multiple.start();
+    // Streams are keyed by (seed, sim_id) and positioned at (agent, day),
+    // so an agent's draws don't depend on which thread makes them.
+    const uint64_t key = rng_seed ^
+        (static_cast< uint64_t >(sim_id) * 0x9e3779b97f4a7c15ULL);
 
-    }
+    for (auto & eng : engines_threads)
+        eng.seed(key);
 
-    for (size_t n = 0u; n < nexperiments; ++n)
-    {
+    const uint32_t day = static_cast< uint32_t >(current_date);
 
-        // Checking if the user interrupted the simulation
-        EPI_CHECK_USER_INTERRUPT(n);
+    std::vector< std::exception_ptr > errors(nthreads);
 
-        set_sim_id(n);
-        run(ndays, seeds_n[n]);
+    array_double_tmp.split(true, nthreads);
+    array_virus_tmp.split(true, nthreads);
+    in_parallel_update = true;
 
-        if (fun)
-            fun(n, this);
+    #pragma omp parallel num_threads(parallel_update_nthreads)
+    {
 
-        if (verbose)
-            pb_multiple.next();
+        #ifdef _OPENMP
+        const size_t iam = static_cast< size_t >(omp_get_thread_num());
+        #else
+        const size_t iam = 0u;
+        #endif
 
-    }
-    #endif
+        // Static scheduling assigns contiguous blocks of agents to threads
+        // in thread order, so concatenating the buffers preserves the
+        // agent order.
+        #pragma omp for schedule(static)
+        for (size_t k = 0u; k < n; ++k)
+        {
 
-    if (old_verb)
-        verbose_on();
+            if (errors[iam])
+                continue;
 
-    return *this;
+            const size_t i = (active != nullptr) ? (*active)[k] : k;
+            if (!state_fun[agents_state[i]])
+                continue;
 
-}
+            auto & p = population[i];
 
-template<typename TSeq>
-inline void Model<TSeq>::update_state() {
+            engines_threads[iam].set_stream(static_cast< uint64_t >(i), day);
+            EPI_PROFILE_ADD(profile, StateFunCalls, 1u)
 
-    // Next state
-    if (use_queuing)
-    {
-        int i = -1;
-        for (auto & p: population)
-            if (queue[++i] > 0)
+            try
+            {
+                state_fun[p.state](&p, this);
+            }
+            catch (...)
             {
-                if (state_fun[p.state])
-                    state_fun[p.state](&p, this);
+                errors[iam] = std::current_exception();
             }
 
+        }
+
     }
-    else
-    {
 
-        for (auto & p: population)
-            if (state_fun[p.state])
-                    state_fun[p.state](&p, this);
+    in_parallel_update = false;
+    array_double_tmp.split(false);
+    array_virus_tmp.split(false);
 
-    }
+    for (auto & e : errors)
+        if (e)
+        {
+            for (auto & buffer : events_threads)
+                buffer.clear();
+            std::rethrow_exception(e);
+        }
 
-    events_run();
+    // Merging the buffers
+    for (auto & buffer : events_threads)
+    {
+        for (auto & e : buffer)
+            _add_event(
+                e.agent, std::move(e.virus), std::move(e.tool), e.entity,
+                e.new_state, e.queue, e.action
+            );
+
+        buffer.clear();
+    }
 
 }
 
 template<typename TSeq>
 inline void Model<TSeq>::mutate_virus() {
 
+    EPI_PROFILE_SCOPE(profile, MutateVirus)
+
     // Checking if any virus has mutation
     size_t nmutates = 0u;
     for (const auto & v: viruses)
-        if (v->mutation)
+        if (v->strain->mutation)
             nmutates++;
 
     if (nmutates == 0u)
@@ -1609,13 +2272,11 @@ inline void Model<TSeq>::mutate_virus() {
     if (use_queuing)
     {
 
-        int i = -1;
-        for (auto & p: population)
+        const auto & active = queue.get_active_agents();
+        for (size_t i = 0u; i < active.size(); ++i)
         {
 
-            if (queue[++i] == 0)
-                continue;
-
+            auto & p = population[active[i]];
             if (p.virus != nullptr)
                 p.virus->mutate(this);
 
@@ -1726,6 +2387,8 @@ inline epiworld_double Model<TSeq>::get_rewire_prop() const {
 template<typename TSeq>
 inline void Model<TSeq>::rewire() {
 
+    EPI_PROFILE_SCOPE(profile, Rewire)
+
     if (rewire_fun)
         rewire_fun(&population, this, rewire_prop);
 }
@@ -1778,11 +2441,9 @@ inline void Model<TSeq>::write_edgelist(
         for (const auto & p : wseq)
         {
 
-            if (p->neighbors == nullptr)
-                continue;
-
-            for (auto & n : *p->neighbors)
-                efile << p->id << " " << n << "\n";
+            const epiworld_agent_index * neighbors = network->neighbors(p->id);
+            for (size_t n = 0u; n < p->n_neighbors; ++n)
+                efile << p->id << " " << neighbors[n] << "\n";
         }
 
     } else {
@@ -1790,12 +2451,10 @@ inline void Model<TSeq>::write_edgelist(
         for (const auto & p : wseq)
         {
 
-            if (p->neighbors == nullptr)
-                continue;
-
-            for (auto & n : *p->neighbors)
-                if (static_cast<int>(p->id) <= static_cast<int>(n))
-                    efile << p->id << " " << n << "\n";
+            const epiworld_agent_index * neighbors = network->neighbors(p->id);
+            for (size_t n = 0u; n < p->n_neighbors; ++n)
+                if (static_cast<int>(p->id) <= static_cast<int>(neighbors[n]))
+                    efile << p->id << " " << neighbors[n] << "\n";
         }
 
     }
@@ -1818,13 +2477,11 @@ std::vector< int > & target
 
         for (const auto & p : wseq)
         {
-            if (p->neighbors == nullptr)
-                continue;
-
-            for (auto & n : *p->neighbors)
+            const epiworld_agent_index * neighbors = network->neighbors(p->id);
+            for (size_t n = 0u; n < p->n_neighbors; ++n)
             {
                 source.push_back(static_cast<int>(p->id));
-                target.push_back(static_cast<int>(n));
+                target.push_back(static_cast<int>(neighbors[n]));
             }
         }
 
@@ -1833,13 +2490,11 @@ std::vector< int > & target
         for (const auto & p : wseq)
         {
 
-            if (p->neighbors == nullptr)
-                continue;
-
-            for (auto & n : *p->neighbors) {
-                if (static_cast<int>(p->id) <= static_cast<int>(n)) {
+            const epiworld_agent_index * neighbors = network->neighbors(p->id);
+            for (size_t n = 0u; n < p->n_neighbors; ++n) {
+                if (static_cast<int>(p->id) <= static_cast<int>(neighbors[n])) {
                     source.push_back(static_cast<int>(p->id));
-                    target.push_back(static_cast<int>(n));
+                    target.push_back(static_cast<int>(neighbors[n]));
                 }
             }
         }
@@ -1852,7 +2507,12 @@ std::vector< int > & target
 template<typename TSeq>
 inline std::map<std::string,epiworld_double> & Model<TSeq>::params()
 {
+
+    // Binding the parameters added through a previous call
+    parameters_ptrs_update();
+
     return parameters;
+
 }
 
 template<typename TSeq>
@@ -1862,25 +2522,20 @@ inline void Model<TSeq>::reset() {
     // Restablishing people
     pb = Progress(ndays, 80);
 
-    if (population_backup.size())
+    // Only the network needs a backup; the rest of the agents' data
+    // is reset in place, keeping the memory already allocated.
+    if (network_backup && (network != network_backup))
     {
-        population = population_backup;
-
-        #ifdef EPI_DEBUG
-        for (size_t i = 0; i < population.size(); ++i)
-        {
-
-            if (population[i] != (population_backup)[i])
-                throw std::logic_error("Model::reset population doesn't match.");
-
-        }
-        #endif
-
+        network = network_backup;
+        for (auto & p : population)
+            p.n_neighbors = network->degree(p.id);
     }
 
     for (auto & p : population)
         p.reset();
 
+    agents_state.assign(population.size(), 0u);
+
     #ifdef EPI_DEBUG
     for (auto & a: population)
     {
@@ -2047,17 +2702,41 @@ inline epiworld_double Model<TSeq>::add_param(
     bool overwrite
     ) {
 
-    if (parameters.find(pname) == parameters.end())
-        parameters[pname] = initial_value;
+    auto iter = parameters.find(pname);
+    if (iter == parameters.end())
+        iter = parameters.emplace(pname, initial_value).first;
     else if (!overwrite)
         throw std::logic_error("The parameter " + pname + " already exists.");
     else
-        parameters[pname] = initial_value;
+        iter->second = initial_value;
+
+    // Binding the id
+    size_t id = param_id(pname);
+    if (id >= parameters_ptrs.size())
+        parameters_ptrs.resize(id + 1u, nullptr);
+
+    parameters_ptrs[id] = &iter->second;
 
     return initial_value;
 
 }
 
+template<typename TSeq>
+inline void Model<TSeq>::parameters_ptrs_update()
+{
+
+    parameters_ptrs.clear();
+    for (auto & p : parameters)
+    {
+        size_t id = param_id(p.first);
+        if (id >= parameters_ptrs.size())
+            parameters_ptrs.resize(id + 1u, nullptr);
+
+        parameters_ptrs[id] = &p.second;
+    }
+
+}
+
 template<typename TSeq>
 inline Model<TSeq> & Model<TSeq>::read_params(std::string fn, bool overwrite)
 {
@@ -2072,28 +2751,30 @@ inline Model<TSeq> & Model<TSeq>::read_params(std::string fn, bool overwrite)
 }
 
 template<typename TSeq>
-inline epiworld_double Model<TSeq>::get_param(std::string pname)
+inline epiworld_double Model<TSeq>::get_param(const std::string & pname)
 {
-    if (parameters.find(pname) == parameters.end())
+    const auto iter = parameters.find(pname);
+    if (iter == parameters.end())
         throw std::logic_error("The parameter " + pname + " does not exists.");
 
-    return parameters[pname];
+    return iter->second;
 }
 
 template<typename TSeq>
-inline void Model<TSeq>::set_param(std::string pname, epiworld_double value)
+inline void Model<TSeq>::set_param(const std::string & pname, epiworld_double value)
 {
-    if (parameters.find(pname) == parameters.end())
+    const auto iter = parameters.find(pname);
+    if (iter == parameters.end())
         throw std::logic_error("The parameter '" + pname + "' does not exists.");
 
-    parameters[pname] = value;
+    iter->second = value;
 
     return;
 
 }
 
 template<typename TSeq>
-inline epiworld_double Model<TSeq>::par(std::string pname) const
+inline epiworld_double Model<TSeq>::par(const std::string & pname) const
 {
     const auto iter = parameters.find(pname);
     if (iter == parameters.end())
@@ -2101,12 +2782,87 @@ inline epiworld_double Model<TSeq>::par(std::string pname) const
     return iter->second;
 }
 
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::par(size_t id) const
+{
+
+    if ((id < parameters_ptrs.size()) && (parameters_ptrs[id] != nullptr))
+        return *parameters_ptrs[id];
+
+    // Not bound yet (added through `params()`). This is a read only, as
+    // it may be called from the threads of the parallel update.
+    return par(param_name(id));
+
+}
+
+/**
+ * @brief Process-wide table of parameter names (see `Model::param_id()`).
+ */
+struct ParamIdsRegistry {
+    std::mutex mtx;
+    std::unordered_map< std::string, size_t > ids;
+    std::vector< std::unique_ptr< std::string > > names;
+};
+
+inline ParamIdsRegistry & param_ids_registry()
+{
+    static ParamIdsRegistry registry;
+    return registry;
+}
+
+template<typename TSeq>
+inline size_t Model<TSeq>::param_id(const std::string & pname)
+{
+
+    auto & reg = param_ids_registry();
+    std::lock_guard< std::mutex > lock(reg.mtx);
+
+    auto iter = reg.ids.find(pname);
+    if (iter != reg.ids.end())
+        return iter->second;
+
+    size_t id = reg.names.size();
+    reg.names.emplace_back(std::make_unique< std::string >(pname));
+    reg.ids.emplace(pname, id);
+
+    return id;
+
+}
+
+template<typename TSeq>
+inline const std::string & Model<TSeq>::param_name(size_t id)
+{
+
+    auto & reg = param_ids_registry();
+    std::lock_guard< std::mutex > lock(reg.mtx);
+
+    if (id >= reg.names.size())
+        throw std::range_error(
+            "The parameter id " + std::to_string(id) + " is out of range."
+        );
+
+    return *reg.names[id];
+
+}
+
 #define DURCAST(tunit,txtunit) {\
         elapsed       = std::chrono::duration_cast<std::chrono:: tunit>(\
             time_end - time_start).count(); \
         elapsed_total = std::chrono::duration_cast<std::chrono:: tunit>(time_elapsed).count(); \
         abbr_unit     = txtunit;}
 
+template<typename TSeq>
+inline const Profiler & Model<TSeq>::get_profile() const
+{
+    return profile;
+}
+
+template<typename TSeq>
+inline const Profiler & Model<TSeq>::get_profile_total() const
+{
+    return profile_total;
+}
+
 template<typename TSeq>
 inline void Model<TSeq>::get_elapsed(
     std::string unit,
@@ -2289,6 +3045,8 @@ template<typename TSeq>
 inline void Model<TSeq>::run_globalevents()
 {
 
+    EPI_PROFILE_SCOPE(profile, GlobalEvents)
+
     for (auto & event: globalevents)
     {
         event->operator()(this, today());
@@ -2359,6 +3117,130 @@ inline ContactTracing & Model<TSeq>::get_contact_tracing()
     return *contact_tracing;
 }
 
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::events_by_agent_on()
+{
+    events_by_agent = true;
+    return *this;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::events_by_agent_off()
+{
+    events_by_agent = false;
+    return *this;
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::is_events_by_agent_on() const
+{
+    return events_by_agent;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::fast_forward_on(
+    std::function<bool(Model<TSeq>*)> fun
+)
+{
+    fast_forward  = true;
+    absorbing_fun = fun;
+    return *this;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::fast_forward_off()
+{
+    fast_forward = false;
+    return *this;
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::is_fast_forward_on() const
+{
+    return fast_forward;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::runif_batch_on()
+{
+    use_runif_batch = true;
+    return *this;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::runif_batch_off()
+{
+    use_runif_batch = false;
+    return *this;
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::is_runif_batch_on() const
+{
+    return use_runif_batch;
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::is_absorbing()
+{
+
+    if (absorbing_fun)
+        return absorbing_fun(this);
+
+    // Global events left to run
+    for (const auto & e : globalevents)
+        if ((e->get_day() < 0) || (e->get_day() >= today()))
+            return false;
+
+    // Viruses still around
+    for (const auto & counts : db.today_virus)
+        for (auto n : counts)
+            if (n > 0)
+                return false;
+
+    // Without viruses, only these states can't change
+    for (epiworld_fast_uint s = 0u; s < nstates; ++s)
+    {
+
+        if (db.today_total[s] == 0)
+            continue;
+
+        if (
+            !state_fun_is(s, nullptr) &&
+            !state_fun_is(s, default_update_susceptible<TSeq>)
+        )
+            return false;
+
+    }
+
+    return true;
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::parallel_update_on(int nthreads)
+{
+    if (nthreads < 1)
+        throw std::logic_error("The parallel update needs at least one thread.");
+
+    use_parallel_update = true;
+    parallel_update_nthreads = nthreads;
+    return *this;
+}
+
+template<typename TSeq>
+inline Model<TSeq> & Model<TSeq>::parallel_update_off()
+{
+    use_parallel_update = false;
+    return *this;
+}
+
+template<typename TSeq>
+inline bool Model<TSeq>::is_parallel_update_on() const
+{
+    return use_parallel_update;
+}
+
 template<typename TSeq>
 inline const std::vector< VirusPtr<TSeq> > & Model<TSeq>::get_viruses() const
 {
@@ -2486,25 +3368,16 @@ inline bool Model<TSeq>::operator==(const Model<TSeq> & other) const
         "Model:: using_backup don't match"
         )
 
-    if ((population_backup.size() != 0) & (other.population_backup.size() != 0))
-    {
-
-        // False is population_backup.size() != other.population_backup.size()
-        if (population_backup.size() != other.population_backup.size())
-            return false;
-
-        for (size_t i = 0u; i < population_backup.size(); ++i)
-        {
-            if (population_backup[i] != other.population_backup[i])
-                return false;
-        }
+    EPI_DEBUG_FAIL_AT_TRUE(
+        *network != *other.network,
+        "Model:: network don't match"
+    )
 
-    } else if ((population_backup.size() == 0) & (other.population_backup.size() != 0)) {
+    if ((network_backup == nullptr) != (other.network_backup == nullptr))
         return false;
-    } else if ((population_backup.size() != 0) & (other.population_backup.size() == 0))
-    {
+
+    if (network_backup && (*network_backup != *other.network_backup))
         return false;
-    }
 
     EPI_DEBUG_FAIL_AT_TRUE(
         agents_data != other.agents_data,
@@ -81,11 +81,75 @@ inline void Model<TSeq>::set_rand_engine(std::shared_ptr< epi_xoshiro256ss > & e
     engine = eng;
 }
 
+template<typename TSeq>
+inline epi_philox4x32 & Model<TSeq>::rng_engine_thread()
+{
+    #ifdef _OPENMP
+    return engines_threads[omp_get_thread_num()];
+    #else
+    return engines_threads[0u];
+    #endif
+}
+
+template<typename TSeq>
+inline uint64_t Model<TSeq>::rng_next()
+{
+
+    EPI_PROFILE_ADD(profile, RngDraws, 1u)
+
+    if (in_parallel_update)
+        return rng_engine_thread()();
+
+    return (*engine)();
+
+}
+
+template<typename TSeq>
+template<typename TDist, typename... TArgs>
+inline typename TDist::result_type Model<TSeq>::rand_draw(
+    TDist & dist,
+    TArgs... args
+)
+{
+
+    EPI_PROFILE_ADD(profile, RngDraws, 1u)
+
+    if (in_parallel_update)
+    {
+        TDist dist_thread(dist.param());
+        return dist_thread(rng_engine_thread(), args...);
+    }
+
+    return dist(*engine, args...);
+
+}
+
+template<typename TSeq>
+inline epiworld_double Model<TSeq>::runif_next()
+{
+
+    if (in_parallel_update)
+        return runif_epi(rng_engine_thread());
+
+    if (!use_runif_batch)
+        return runif_epi(*engine);
+
+    if (runif_buffer_pos == runif_buffer.size())
+    {
+        runif_buffer.resize(runif_batch_blocks * EPI_RUNIF_LANES);
+        engine_batch.fill_unif(runif_buffer.data(), runif_batch_blocks);
+        runif_buffer_pos = 0u;
+    }
+
+    return runif_buffer[runif_buffer_pos++];
+
+}
+
 template<typename TSeq>
 inline epiworld_double Model<TSeq>::runif() {
     // CHECK_INIT()
-    epiworld_double res = runif_epi(*engine);
-    return res * (runifd_b - runifd_a) + runifd_a;
+    EPI_PROFILE_ADD(profile, RngDraws, 1u)
+    return runif_next() * (runifd_b - runifd_a) + runifd_a;
 }
 
 template<typename TSeq>
@@ -101,7 +165,7 @@ inline uint32_t Model<TSeq>::runif_index(uint32_t n) {
     if (n == 0) return 0;
 
     // Grab 32 perfectly uniform random bits directly from xoshiro256ss
-    uint32_t x = static_cast<uint32_t>((*engine)());
+    uint32_t x = static_cast<uint32_t>(rng_next());
     
     // Multiply by the bound N to get a 64-bit result
     uint64_t m = static_cast<uint64_t>(x) * static_cast<uint64_t>(n);
@@ -113,7 +177,7 @@ inline uint32_t Model<TSeq>::runif_index(uint32_t n) {
     if (l < n) {
         uint32_t t = -n % n; // Two's complement trick to get (2^32 - n) % n
         while (l < t) {
-            x = static_cast<uint32_t>((*engine)());
+            x = static_cast<uint32_t>(rng_next());
             m = static_cast<uint64_t>(x) * static_cast<uint64_t>(n);
             l = static_cast<uint32_t>(m);
         }
@@ -126,31 +190,32 @@ inline uint32_t Model<TSeq>::runif_index(uint32_t n) {
 template<typename TSeq>
 inline epiworld_double Model<TSeq>::runif(epiworld_double a, epiworld_double b) {
     // CHECK_INIT()
-    return runif_epi(*engine) * (b - a) + a;
+    EPI_PROFILE_ADD(profile, RngDraws, 1u)
+    return runif_next() * (b - a) + a;
 }
 
 template<typename TSeq>
 inline epiworld_double Model<TSeq>::rnorm() {
     // CHECK_INIT()
-    return rnormd(*engine);
+    return rand_draw(rnormd);
 }
 
 template<typename TSeq>
 inline epiworld_double Model<TSeq>::rnorm(epiworld_double mean, epiworld_double sd) {
     // CHECK_INIT()
-    return rnormd(*engine) * sd + mean;
+    return rand_draw(rnormd) * sd + mean;
 }
 
 template<typename TSeq>
 inline epiworld_double Model<TSeq>::rgamma() {
-    return rgammad(*engine);
+    return rand_draw(rgammad);
 }
 
 template<typename TSeq>
 inline epiworld_double Model<TSeq>::rgamma(epiworld_double alpha, epiworld_double beta) {
 
-    return rgammad(
-        *engine,
+    return rand_draw(
+        rgammad,
         std::gamma_distribution<>::param_type(alpha, beta)
     );
 
@@ -158,14 +223,14 @@ inline epiworld_double Model<TSeq>::rgamma(epiworld_double alpha, epiworld_doubl
 
 template<typename TSeq>
 inline epiworld_double Model<TSeq>::rexp() {
-    return rexpd(*engine);
+    return rand_draw(rexpd);
 }
 
 template<typename TSeq>
 inline epiworld_double Model<TSeq>::rexp(epiworld_double lambda) {
 
-    return rexpd(
-        *engine,
+    return rand_draw(
+        rexpd,
         std::exponential_distribution<>::param_type(lambda)
     );
 
@@ -173,14 +238,14 @@ inline epiworld_double Model<TSeq>::rexp(epiworld_double lambda) {
 
 template<typename TSeq>
 inline epiworld_double Model<TSeq>::rlognormal() {
-    return rlognormald(*engine);
+    return rand_draw(rlognormald);
 }
 
 template<typename TSeq>
 inline epiworld_double Model<TSeq>::rlognormal(epiworld_double mean, epiworld_double shape) {
 
-    return rlognormald(
-        *engine,
+    return rand_draw(
+        rlognormald,
         std::lognormal_distribution<>::param_type(mean, shape)
     );
 }
@@ -194,7 +259,7 @@ inline int Model<TSeq>::rbinom() {
         return std::min(res, rbinomd_n);
     }
 #endif
-    return rbinomd(*engine);
+    return rand_draw(rbinomd);
 }
 
 template<typename TSeq>
@@ -214,8 +279,8 @@ inline int Model<TSeq>::rbinom(int n, epiworld_double p) {
     }
 #endif
 
-    return rbinomd(
-        *engine,
+    return rand_draw(
+        rbinomd,
         std::binomial_distribution<>::param_type(n, p)
     );
 
@@ -223,28 +288,28 @@ inline int Model<TSeq>::rbinom(int n, epiworld_double p) {
 
 template<typename TSeq>
 inline int Model<TSeq>::rnbinom() {
-    return rnbinomd(*engine);
+    return rand_draw(rnbinomd);
 }
 
 template<typename TSeq>
 inline int Model<TSeq>::rnbinom(int n, epiworld_double p) {
 
-    return rnbinomd(
-        *engine,
+    return rand_draw(
+        rnbinomd,
         std::negative_binomial_distribution<>::param_type(n, p)
     );
 }
 
 template<typename TSeq>
 inline int Model<TSeq>::rgeom() {
-    return rgeomd(*engine);
+    return rand_draw(rgeomd);
 }
 
 template<typename TSeq>
 inline int Model<TSeq>::rgeom(epiworld_double p) {
 
-    return rgeomd(
-        *engine,
+    return rand_draw(
+        rgeomd,
         std::geometric_distribution<>::param_type(p)
     );
 
@@ -252,14 +317,14 @@ inline int Model<TSeq>::rgeom(epiworld_double p) {
 
 template<typename TSeq>
 inline int Model<TSeq>::rpoiss() {
-    return rpoissd(*engine);
+    return rand_draw(rpoissd);
 }
 
 template<typename TSeq>
 inline int Model<TSeq>::rpoiss(epiworld_double lambda) {
 
-    return rpoissd(
-        *engine,
+    return rand_draw(
+        rpoissd,
         std::poisson_distribution<>::param_type(lambda)
     );
 
@@ -282,7 +347,28 @@ inline size_t Model<TSeq>::sample_from_probs(size_t n) {
 
 template<typename TSeq>
 inline void Model<TSeq>::seed(size_t s) {
+    this->rng_seed = static_cast< uint64_t >(s);
     this->engine->seed(s);
+
+    // The batched stream is keyed apart from the engine, so their
+    // sequences do not coincide
+    this->engine_batch.seed(
+        static_cast< uint64_t >(s) ^ 0x9e3779b97f4a7c15ULL
+    );
+    this->runif_buffer.clear();
+    this->runif_buffer_pos = 0u;
+
+    // Some distributions keep draws for the next call (e.g., the normal
+    // makes two at a time), which would make the sequence depend on what
+    // was drawn before seeding
+    this->rnormd.reset();
+    this->rgammad.reset();
+    this->rlognormald.reset();
+    this->rexpd.reset();
+    this->rbinomd.reset();
+    this->rnbinomd.reset();
+    this->rgeomd.reset();
+    this->rpoissd.reset();
 }
 
 #endif
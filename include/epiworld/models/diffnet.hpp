@@ -81,13 +81,13 @@ inline ModelDiffNet<TSeq>::ModelDiffNet(
         // For each one of the possible innovations, we have to compute
         // the adoption probability, which is a function of exposure
         auto & m_ref = *m;
-        for (auto & neighbor: agent.get_neighbors(*m))
+        for (auto & neighbor: agent.neighbors(*m))
         {
 
-            if (neighbor->get_state() == ModelDiffNet<TSeq>::ADOPTER)
+            if (neighbor.get_state() == ModelDiffNet<TSeq>::ADOPTER)
             {
 
-                auto & v = neighbor->get_virus();
+                auto & v = neighbor.get_virus();
                 
                 if (v == nullptr)
                     continue;
@@ -37,10 +37,10 @@ public:
         epiworld_double recovery_rate
     );
 
-    UpdateFun<TSeq> update_exposed_seir = [](
+    static void update_exposed_seir(
         Agent<TSeq> * p,
         Model<TSeq> * m
-    ) -> void {
+    ) {
 
         // Getting the virus
         auto v = p->get_virus();
@@ -50,19 +50,22 @@ public:
             p->change_state(*m, ModelSEIR<TSeq>::INFECTED);
 
         return;
-    };
+    }
 
 
-    UpdateFun<TSeq> update_infected_seir = [](
+    static void update_infected_seir(
         Agent<TSeq> * p,
         Model<TSeq> * m
-    ) -> void {
+    ) {
+        static const size_t par_recovery_rate =
+            Model<TSeq>::param_id("Recovery rate");
+
         // Does the agent recover?
-        if (m->runif() < (m->par("Recovery rate")))
+        if (m->runif() < (m->par(par_recovery_rate)))
             p->rm_virus(*m);
 
         return;
-    };
+    }
 
     /**
      * @brief Set up the initial states of the model.
@@ -75,8 +78,25 @@ public:
         std::vector< int > queue_ = {}
     ) override;
 
+    /**
+     * @brief Runs the built-in states without `std::function` calls
+     * @return false if any state function was replaced by the user.
+     */
+    bool update_state_static() override;
+
 };
 
+template<typename TSeq>
+inline bool ModelSEIR<TSeq>::update_state_static()
+{
+    return this->template update_state_table<
+        default_update_susceptible<TSeq>,
+        update_exposed_seir,
+        update_infected_seir,
+        nullptr
+        >();
+}
+
 
 template<typename TSeq>
 inline ModelSEIR<TSeq>::ModelSEIR(
@@ -16,6 +16,7 @@ class ModelSEIRCONN : public Model<TSeq>
 private:
     std::vector< Agent<TSeq> * > infected;
     void update_infected();
+    void read_checkpoint_derived(std::istream & in) override;
 
 public:
 
@@ -101,6 +102,16 @@ inline void ModelSEIRCONN<TSeq>::reset()
 
 }
 
+template<typename TSeq>
+inline void ModelSEIRCONN<TSeq>::read_checkpoint_derived(std::istream &)
+{
+
+    this->update_infected();
+
+    return;
+
+}
+
 template<typename TSeq>
 inline std::unique_ptr<Model<TSeq>> ModelSEIRCONN<TSeq>::clone_ptr()
 {
@@ -16,6 +16,7 @@ class ModelSEIRDCONN : public Model<TSeq>
 private:
     std::vector< Agent<TSeq> * > infected;
     void update_infected();
+    void read_checkpoint_derived(std::istream & in) override;
 
 public:
 
@@ -107,6 +108,16 @@ inline void ModelSEIRDCONN<TSeq>::reset()
 
 }
 
+template<typename TSeq>
+inline void ModelSEIRDCONN<TSeq>::read_checkpoint_derived(std::istream &)
+{
+
+    this->update_infected();
+
+    return;
+
+}
+
 template<typename TSeq>
 inline std::unique_ptr<Model<TSeq>> ModelSEIRDCONN<TSeq>::clone_ptr()
 {
@@ -26,7 +26,7 @@ class ModelSEIRMixing :
 private:
 
     // Vector of vectors of infected agents
-    std::vector< size_t > infected;
+    std::vector< epiworld_agent_index > infected;
 
     // Number of infected agents in each group
     std::vector< size_t > n_infected_per_group;
@@ -35,17 +35,27 @@ private:
     std::vector< size_t > entity_indices;
 
     void update_infected_list();
-    std::vector< size_t > sampled_agents;
+    void setup_groups(); ///< Sizes and fills the lists by group.
+    void read_checkpoint_derived(std::istream & in) override;
+    std::vector< epiworld_agent_index > sampled_agents;
     size_t sample_agents(
         Agent<TSeq> * agent,
-        std::vector< size_t > & sampled_agents
+        std::vector< epiworld_agent_index > & sampled_agents
         );
     std::vector< double > adjusted_contact_rate;
 
+    static void _update_susceptible(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_exposed_and_infected(Agent<TSeq> * p, Model<TSeq> * m);
+
     #ifdef EPI_DEBUG
     std::vector< int > sampled_sizes;
     #endif
 
+    // Aggregated mode (see aggregated_on())
+    epiworld_double prevalence;
+    std::vector< double > proportions = {};
+    Model<TSeq> & run_aggregated(epiworld_fast_uint ndays) override;
+
 public:
 
     static const int SUSCEPTIBLE = 0;
@@ -82,6 +92,12 @@ public:
 
     std::unique_ptr< Model<TSeq> > clone_ptr() override;
 
+    /**
+     * @brief Runs the built-in states without `std::function` calls
+     * @return false if any state function was replaced by the user.
+     */
+    bool update_state_static() override;
+
     /**
      * @brief Set the initial states of the model
      * @param proportions_ Double vector with a single element:
@@ -92,6 +108,21 @@ public:
         std::vector< int > queue_ = {}
     ) override;
 
+    /**
+     * @name Aggregated mode
+     * @details Same as `ModelSIRMixing::aggregated_on()`: the model keeps
+     * counts per group and state, and advances them with binomial draws.
+     * Only the infected (not the exposed) transmit, and exposed become
+     * infected with probability `1 / incubation` each day.
+     *
+     * @param group_sizes Number of agents in each group (one per row of
+     * the contact matrix).
+     */
+    ///@{
+    ModelSEIRMixing<TSeq> & aggregated_on(std::vector< size_t > group_sizes);
+    ModelSEIRMixing<TSeq> & aggregated_off(); ///< Restores the agents.
+    ///@}
+
 };
 
 template<typename TSeq>
@@ -129,7 +160,7 @@ inline void ModelSEIRMixing<TSeq>::update_infected_list()
 template<typename TSeq>
 inline size_t ModelSEIRMixing<TSeq>::sample_agents(
     Agent<TSeq> * agent,
-    std::vector< size_t > & sampled_agents
+    std::vector< epiworld_agent_index > & sampled_agents
     )
 {
 
@@ -190,11 +221,9 @@ inline size_t ModelSEIRMixing<TSeq>::sample_agents(
 }
 
 template<typename TSeq>
-inline void ModelSEIRMixing<TSeq>::reset()
+inline void ModelSEIRMixing<TSeq>::setup_groups()
 {
 
-    Model<TSeq>::reset();
-
     // Checking contact matrix dimensions
     size_t nentities = this->entities.size();
     this->validate_contact_matrix(nentities);
@@ -243,6 +272,28 @@ inline void ModelSEIRMixing<TSeq>::reset()
 
 }
 
+template<typename TSeq>
+inline void ModelSEIRMixing<TSeq>::read_checkpoint_derived(std::istream &)
+{
+
+    this->setup_groups();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixing<TSeq>::reset()
+{
+
+    Model<TSeq>::reset();
+
+    this->setup_groups();
+
+    return;
+
+}
+
 template<typename TSeq>
 inline std::unique_ptr<Model<TSeq>> ModelSEIRMixing<TSeq>::clone_ptr()
 {
@@ -251,165 +302,298 @@ inline std::unique_ptr<Model<TSeq>> ModelSEIRMixing<TSeq>::clone_ptr()
 
 }
 
+template<typename TSeq>
+inline ModelSEIRMixing<TSeq> & ModelSEIRMixing<TSeq>::aggregated_on(
+    std::vector< size_t > group_sizes
+)
+{
+
+    this->validate_contact_matrix(group_sizes.size());
+    this->aggregated_enable(std::move(group_sizes));
+
+    return *this;
+
+}
 
-/**
- * @brief Template for a Susceptible-Exposed-Infected-Removed (SEIR) model
- *
- * @param model A Model<TSeq> object where to set up the SIR.
- * @param vname std::string Name of the virus
- * @param prevalence Initial prevalence (proportion)
- * @param transmission_rate Probability of transmission
- * @param recovery_rate Probability of recovery
- * @param contact_matrix Contact matrix specifying expected contacts between groups.
- * Each entry (i,j) represents the expected number of contacts an agent in
- * group i has with agents in group j per day.
- */
 template<typename TSeq>
-inline ModelSEIRMixing<TSeq>::ModelSEIRMixing(
-    const std::string & vname,
-    epiworld_fast_uint n,
-    epiworld_double prevalence,
-    epiworld_double transmission_rate,
-    epiworld_double avg_incubation_days,
-    epiworld_double recovery_rate,
-    std::vector< double > contact_matrix
-    )
+inline ModelSEIRMixing<TSeq> & ModelSEIRMixing<TSeq>::aggregated_off()
 {
 
-    // Setting up the contact matrix
-    this->set_contact_matrix(contact_matrix, true);
+    this->aggregated_disable();
 
-    UpdateFun<TSeq> update_susceptible = [](
-        Agent<TSeq> * p, Model<TSeq> * m
-        ) -> void
+    return *this;
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & ModelSEIRMixing<TSeq>::run_aggregated(
+    epiworld_fast_uint ndays
+)
+{
+
+    const size_t ngroups = this->aggregated_sizes.size();
+    this->validate_contact_matrix(ngroups);
+
+    // Initial infections (exposed), spread across groups
+    std::vector< int > S(ngroups), I(ngroups), R(ngroups);
+    std::vector< int > E = this->aggregated_split(prevalence);
+    for (size_t g = 0u; g < ngroups; ++g)
+    {
+
+        int size_g = static_cast< int >(this->aggregated_sizes[g]);
+
+        if (proportions.size() > 0u)
         {
+            I[g] = this->rbinom(E[g], proportions[0u]);
+            R[g] = this->rbinom(size_g - E[g], proportions[1u]);
+        }
+        else
+        {
+            I[g] = 0;
+            R[g] = 0;
+        }
 
-            if (p->get_n_entities() == 0)
-                return;
+        E[g] -= I[g];
+        S[g] = size_g - E[g] - I[g] - R[g];
 
-            // Downcasting to retrieve the sampler attached to the
-            // class
-            auto * m_down = model_cast<ModelSEIRMixing<TSeq>, TSeq>(m);
+    }
 
-            size_t ndraws = m_down->sample_agents(p, m_down->sampled_agents);
+    std::vector< int > totals = {0, 0, 0, 0};
+    for (size_t g = 0u; g < ngroups; ++g)
+    {
+        totals[SUSCEPTIBLE] += S[g];
+        totals[EXPOSED]     += E[g];
+        totals[INFECTED]    += I[g];
+        totals[RECOVERED]   += R[g];
+    }
 
-            #ifdef EPI_DEBUG
-            m_down->sampled_sizes.push_back(static_cast<int>(ndraws));
-            #endif
+    this->aggregated_setup(ndays, totals, {false, true, true, false});
 
-            if (ndraws == 0u)
-                return;
+    auto & virus = this->get_virus(0u);
+    std::vector< int > new_exposed(ngroups), new_infected(ngroups),
+        new_recovered(ngroups);
 
-            // Drawing from the set
-            int nviruses_tmp = 0;
-            auto & m_ref = *m;
-            for (size_t n = 0u; n < ndraws; ++n)
-            {
+    for (epiworld_fast_uint niter = 0; niter < this->get_ndays(); ++niter)
+    {
 
-                auto & neighbor = m->get_agent(m_down->sampled_agents[n]);
+        epiworld_double p_transmit = virus.get_prob_infecting(this);
+        epiworld_double p_recover  = virus.get_prob_recovery(this);
+        epiworld_double p_onset    = 1.0 / virus.get_incubation(this);
 
-                auto & v = neighbor.get_virus();
+        // All draws use the counts at the start of the day
+        for (size_t i = 0u; i < ngroups; ++i)
+        {
 
-                #ifdef EPI_DEBUG
-                if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
-                    throw std::logic_error(
-                        "Trying to add an extra element to a temporal array outside of the range."
-                    );
-                #endif
+            epiworld_double p_escape =
+                this->aggregated_escape(*this, i, I, p_transmit);
 
-                /* And it is a function of susceptibility_reduction as well */
-                m->array_double_tmp[nviruses_tmp] =
-                    (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
-                    v->get_prob_infecting(m) *
-                    (1.0 - neighbor.get_transmission_reduction(v, m_ref))
-                    ;
+            new_exposed[i]   = this->rbinom(S[i], 1.0 - p_escape);
+            new_infected[i]  = this->rbinom(E[i], p_onset);
+            new_recovered[i] = this->rbinom(I[i], p_recover);
 
-                m->array_virus_tmp[nviruses_tmp++] = &(*v);
+        }
 
-            }
+        for (size_t i = 0u; i < ngroups; ++i)
+        {
 
-            // Running the roulette
-            int which = roulette(nviruses_tmp, m);
+            S[i] -= new_exposed[i];
+            E[i] += new_exposed[i] - new_infected[i];
+            I[i] += new_infected[i] - new_recovered[i];
+            R[i] += new_recovered[i];
 
-            if (which < 0)
-                return;
+            this->aggregated_move(SUSCEPTIBLE, EXPOSED, new_exposed[i]);
+            this->aggregated_move(EXPOSED, INFECTED, new_infected[i]);
+            this->aggregated_move(INFECTED, RECOVERED, new_recovered[i]);
 
-            p->set_virus(*m, 
-                *m->array_virus_tmp[which],
-                ModelSEIRMixing<TSeq>::EXPOSED
-                );
+        }
 
-            return;
+        this->run_globalevents();
 
-        };
+        this->next();
 
-    UpdateFun<TSeq> update_exposed_and_infected = [](
-        Agent<TSeq> * p, Model<TSeq> * m
-        ) -> void {
+    }
 
-            auto state = p->get_state();
+    this->aggregated_end();
 
-            if (state == ModelSEIRMixing<TSeq>::EXPOSED)
-            {
+    return *this;
 
-                // Getting the virus
-                auto & v = p->get_virus();
+}
 
-                // Does the agent become infected?
-                if (m->runif() < 1.0/(v->get_incubation(m)))
-                {
 
-                    p->change_state(*m, ModelSEIRMixing<TSeq>::INFECTED);
-                    return;
+template<typename TSeq>
+inline bool ModelSEIRMixing<TSeq>::update_state_static()
+{
+    return this->template update_state_table<
+        _update_susceptible,
+        _update_exposed_and_infected,
+        _update_exposed_and_infected,
+        nullptr
+        >();
+}
 
-                }
+template<typename TSeq>
+inline void ModelSEIRMixing<TSeq>::_update_susceptible(
+    Agent<TSeq> * p, Model<TSeq> * m
+    )
+{
 
+    if (p->get_n_entities() == 0)
+        return;
 
-            } else if (state == ModelSEIRMixing<TSeq>::INFECTED)
-            {
+    // Downcasting to retrieve the sampler attached to the
+    // class
+    auto * m_down = model_cast<ModelSEIRMixing<TSeq>, TSeq>(m);
+
+    size_t ndraws = m_down->sample_agents(p, m_down->sampled_agents);
+
+    #ifdef EPI_DEBUG
+    m_down->sampled_sizes.push_back(static_cast<int>(ndraws));
+    #endif
+
+    if (ndraws == 0u)
+        return;
+
+    // Drawing from the set
+    int nviruses_tmp = 0;
+    auto & m_ref = *m;
+    for (size_t n = 0u; n < ndraws; ++n)
+    {
+
+        auto & neighbor = m->get_agent(m_down->sampled_agents[n]);
+
+        auto & v = neighbor.get_virus();
+
+        #ifdef EPI_DEBUG
+        if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+            throw std::logic_error(
+                "Trying to add an extra element to a temporal array outside of the range."
+            );
+        #endif
+
+        /* And it is a function of susceptibility_reduction as well */
+        m->array_double_tmp[nviruses_tmp] =
+            (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
+            v->get_prob_infecting(m) *
+            (1.0 - neighbor.get_transmission_reduction(v, m_ref))
+            ;
+
+        m->array_virus_tmp[nviruses_tmp++] = &(*v);
+
+    }
+
+    // Running the roulette
+    int which = roulette(nviruses_tmp, m);
+
+    if (which < 0)
+        return;
+
+    p->set_virus(*m, 
+        *m->array_virus_tmp[which],
+        ModelSEIRMixing<TSeq>::EXPOSED
+        );
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixing<TSeq>::_update_exposed_and_infected(
+    Agent<TSeq> * p, Model<TSeq> * m
+    )
+{
+
+    auto state = p->get_state();
+
+    if (state == ModelSEIRMixing<TSeq>::EXPOSED)
+    {
 
+        // Getting the virus
+        auto & v = p->get_virus();
 
-                // Odd: Die, Even: Recover
-                epiworld_fast_uint n_events = 0u;
-                auto & v = p->get_virus();
+        // Does the agent become infected?
+        if (m->runif() < 1.0/(v->get_incubation(m)))
+        {
+
+            p->change_state(*m, ModelSEIRMixing<TSeq>::INFECTED);
+            return;
+
+        }
 
-                // Recover
-                m->array_double_tmp[n_events++] =
-                    1.0 - (1.0 - v->get_prob_recovery(m)) *
-                        (1.0 - p->get_recovery_enhancer(v, *m));
 
-                #ifdef EPI_DEBUG
-                if (n_events == 0u)
-                {
-                    printf_epiworld(
-                        "[epi-debug] agent %i has 0 possible events!!\n",
-                        static_cast<int>(p->get_id())
-                        );
-                    throw std::logic_error("Zero events in exposed.");
-                }
-                #else
-                if (n_events == 0u)
-                    return;
-                #endif
+    } else if (state == ModelSEIRMixing<TSeq>::INFECTED)
+    {
 
 
-                // Running the roulette
-                int which = roulette(n_events, m);
+        // Odd: Die, Even: Recover
+        epiworld_fast_uint n_events = 0u;
+        auto & v = p->get_virus();
 
-                if (which < 0)
-                    return;
+        // Recover
+        m->array_double_tmp[n_events++] =
+            1.0 - (1.0 - v->get_prob_recovery(m)) *
+                (1.0 - p->get_recovery_enhancer(v, *m));
 
-                // Which roulette happen?
-                p->rm_virus(*m);
+        #ifdef EPI_DEBUG
+        if (n_events == 0u)
+        {
+            printf_epiworld(
+                "[epi-debug] agent %i has 0 possible events!!\n",
+                static_cast<int>(p->get_id())
+                );
+            throw std::logic_error("Zero events in exposed.");
+        }
+        #else
+        if (n_events == 0u)
+            return;
+        #endif
 
-                return ;
 
-            } else
-                throw std::logic_error("This function can only be applied to exposed or infected individuals. (SEIR)") ;
+        // Running the roulette
+        int which = roulette(n_events, m);
 
+        if (which < 0)
             return;
 
-        };
+        // Which roulette happen?
+        p->rm_virus(*m);
+
+        return ;
+
+    } else
+        throw std::logic_error("This function can only be applied to exposed or infected individuals. (SEIR)") ;
+
+    return;
+
+}
+
+/**
+ * @brief Template for a Susceptible-Exposed-Infected-Removed (SEIR) model
+ *
+ * @param model A Model<TSeq> object where to set up the SIR.
+ * @param vname std::string Name of the virus
+ * @param prevalence Initial prevalence (proportion)
+ * @param transmission_rate Probability of transmission
+ * @param recovery_rate Probability of recovery
+ * @param contact_matrix Contact matrix specifying expected contacts between groups.
+ * Each entry (i,j) represents the expected number of contacts an agent in
+ * group i has with agents in group j per day.
+ */
+template<typename TSeq>
+inline ModelSEIRMixing<TSeq>::ModelSEIRMixing(
+    const std::string & vname,
+    epiworld_fast_uint n,
+    epiworld_double prevalence,
+    epiworld_double transmission_rate,
+    epiworld_double avg_incubation_days,
+    epiworld_double recovery_rate,
+    std::vector< double > contact_matrix
+    )
+{
+
+    // Setting up the contact matrix
+    this->set_contact_matrix(contact_matrix, true);
+
+    this->prevalence = prevalence;
 
     // Setting up parameters
     this->add_param(transmission_rate, "Prob. Transmission");
@@ -417,9 +601,9 @@ inline ModelSEIRMixing<TSeq>::ModelSEIRMixing(
     this->add_param(avg_incubation_days, "Avg. Incubation days");
 
     // state
-    this->add_state("Susceptible", update_susceptible);
-    this->add_state("Exposed", update_exposed_and_infected);
-    this->add_state("Infected", update_exposed_and_infected);
+    this->add_state("Susceptible", _update_susceptible);
+    this->add_state("Exposed", _update_exposed_and_infected);
+    this->add_state("Infected", _update_exposed_and_infected);
     this->add_state("Recovered");
 
     // Global function
@@ -467,6 +651,8 @@ inline ModelSEIRMixing<TSeq> & ModelSEIRMixing<TSeq>::initial_states(
         create_init_function_seir<TSeq>(proportions_)
         ;
 
+    proportions = proportions_;
+
     return *this;
 
 }
@@ -52,7 +52,7 @@ class ModelSEIRMixingQuarantine :
 private:
 
     // Vector of vectors of infected agents
-    std::vector< size_t > infected;
+    std::vector< epiworld_agent_index > infected;
 
     // Number of infected agents in each group
     std::vector< size_t > n_infected_per_group;
@@ -61,10 +61,13 @@ private:
     std::vector< size_t > entity_indices;
 
     void _update_infected_list();
-    std::vector< size_t > sampled_agents;
+    void _setup_groups(); ///< Sizes and fills the lists by group.
+    void write_checkpoint_derived(std::ostream & out) const override;
+    void read_checkpoint_derived(std::istream & in) override;
+    std::vector< epiworld_agent_index > sampled_agents;
     size_t _sample_agents(
         Agent<TSeq> * agent,
-        std::vector< size_t > & sampled_agents
+        std::vector< epiworld_agent_index > & sampled_agents
         );
     std::vector< double > adjusted_contact_rate;
 
@@ -269,7 +272,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_infected_list()
 template<typename TSeq>
 inline size_t ModelSEIRMixingQuarantine<TSeq>::_sample_agents(
     Agent<TSeq> * agent,
-    std::vector< size_t > & sampled_agents
+    std::vector< epiworld_agent_index > & sampled_agents
     )
 {
 
@@ -334,11 +337,9 @@ inline size_t ModelSEIRMixingQuarantine<TSeq>::_sample_agents(
 }
 
 template<typename TSeq>
-inline void ModelSEIRMixingQuarantine<TSeq>::reset()
+inline void ModelSEIRMixingQuarantine<TSeq>::_setup_groups()
 {
 
-    Model<TSeq>::reset();
-
     // Checking contact matrix dimensions
     size_t nentities = this->entities.size();
     this->validate_contact_matrix(nentities);
@@ -366,6 +367,50 @@ inline void ModelSEIRMixingQuarantine<TSeq>::reset()
 
     this->_update_infected_list();
 
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::write_checkpoint_derived(std::ostream & out) const
+{
+
+    checkpoint_write(out, quarantine_willingness);
+    checkpoint_write(out, isolation_willingness);
+    checkpoint_write(out, agent_quarantine_triggered);
+    checkpoint_write(out, day_flagged);
+    checkpoint_write(out, day_onset);
+    checkpoint_write(out, day_exposed);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::read_checkpoint_derived(std::istream & in)
+{
+
+    this->_setup_groups();
+
+    checkpoint_read(in, quarantine_willingness);
+    checkpoint_read(in, isolation_willingness);
+    checkpoint_read(in, agent_quarantine_triggered);
+    checkpoint_read(in, day_flagged);
+    checkpoint_read(in, day_onset);
+    checkpoint_read(in, day_exposed);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRMixingQuarantine<TSeq>::reset()
+{
+
+    Model<TSeq>::reset();
+
+    this->_setup_groups();
+
     // Setting up the quarantine parameters
     quarantine_willingness.resize(this->size(), false);
     isolation_willingness.resize(this->size(), false);
@@ -489,12 +534,19 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_infected(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_days_undetected =
+        Model<TSeq>::param_id("Days undetected");
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
     auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
 
     // Sampling whether the agent is detected or not.
     // If Days undetected < 0, detection is disabled (never detected).
     // If Days undetected == 0, the agent is always detected.
-    epiworld_double days_undetected = m->par("Days undetected");
+    epiworld_double days_undetected = m->par(par_days_undetected);
     bool detected = (days_undetected < 0.0) ?
         false : ((days_undetected == 0.0) ?
             true : (m->runif() < 1.0 / days_undetected));
@@ -509,7 +561,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_infected(
 
     // Checking if the agent is willing to isolate individually
     // This is separate from quarantine and can happen even if agent cannot quarantine
-    bool isolation_detected = (m->par("Isolation period") >= 0) &&
+    bool isolation_detected = (m->par(par_isolation_period) >= 0) &&
         detected &&
         (model->isolation_willingness[p->get_id()])
     ;
@@ -522,7 +574,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_infected(
     auto & v = p->get_virus();
     m->array_double_tmp[0] = 1.0 - (1.0 - v->get_prob_recovery(m)) *
         (1.0 - p->get_recovery_enhancer(v, *m));
-    m->array_double_tmp[1] = m->par("Hospitalization rate");
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
 
     auto which = m->sample_from_probs(2);
 
@@ -561,6 +613,11 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_isolated(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
     auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
 
     // Figuring out if the agent can be released from isolation
@@ -568,7 +625,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_isolated(
     int days_since = m->today() - model->day_onset[p->get_id()];
 
     bool unisolate =
-        (m->par("Isolation period") <= days_since) ?
+        (m->par(par_isolation_period) <= days_since) ?
         true: false;
 
     // Sampling from the probabilities of recovery
@@ -577,7 +634,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_isolated(
         (1.0 - p->get_recovery_enhancer(p->get_virus(), *m));
 
     // And hospitalization
-    m->array_double_tmp[1] = m->par("Hospitalization rate");
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
 
     auto which = m->sample_from_probs(2);
 
@@ -609,6 +666,9 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_quarantine_suscep(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
     auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
 
     // Figuring out if the agent can be released from quarantine
@@ -616,7 +676,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_quarantine_suscep(
     int days_since = m->today() - model->day_flagged[p->get_id()];
 
     bool unquarantine =
-        (m->par("Quarantine period") <= days_since) ?
+        (m->par(par_quarantine_period) <= days_since) ?
         true: false;
 
     if (unquarantine)
@@ -633,6 +693,9 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_quarantine_exposed(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
     auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
 
     // Figuring out if the agent can be released from quarantine
@@ -640,7 +703,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_quarantine_exposed(
     int days_since = m->today() - model->day_flagged[p->get_id()];
 
     bool unquarantine =
-        (m->par("Quarantine period") <= days_since) ?
+        (m->par(par_quarantine_period) <= days_since) ?
         true: false;
 
     if (m->runif() < 1.0/(p->get_virus()->get_incubation(m)))
@@ -678,6 +741,9 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_isolated_recovered(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+
     auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
 
     // Figuring out if the agent can be released from isolation
@@ -685,7 +751,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_isolated_recovered(
     int days_since = m->today() - model->day_onset[p->get_id()];
 
     bool unisolate =
-        (m->par("Isolation period") <= days_since) ?
+        (m->par(par_isolation_period) <= days_since) ?
         true: false;
 
     if (unisolate)
@@ -702,8 +768,11 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_hospitalized(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_hospitalization_period =
+        Model<TSeq>::param_id("Hospitalization period");
+
     // The agent is removed from the system
-    if (m->runif() < 1.0/m->par("Hospitalization period"))
+    if (m->runif() < 1.0/m->par(par_hospitalization_period))
         p->rm_virus(*m, ModelSEIRMixingQuarantine<TSeq>::RECOVERED);
 
 };
@@ -711,6 +780,13 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_update_hospitalized(
 template<typename TSeq>
 inline void ModelSEIRMixingQuarantine<TSeq>::_quarantine_process(Model<TSeq> * m) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+    static const size_t par_contact_tracing_success_rate =
+        Model<TSeq>::param_id("Contact tracing success rate");
+    static const size_t par_contact_tracing_days_prior =
+        Model<TSeq>::param_id("Contact tracing days prior");
+
     auto * model = model_cast<ModelSEIRMixingQuarantine<TSeq>, TSeq>(m);
 
     // Process entity-level quarantine
@@ -725,7 +801,7 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_quarantine_process(Model<TSeq> * m
         )
             continue;
 
-        if (m->par("Quarantine period") < 0)
+        if (m->par(par_quarantine_period) < 0)
         {
             model->agent_quarantine_triggered[agent_i] =
             ModelSEIRMixingQuarantine<TSeq>::QUARANTINE_PROCESS_DONE;
@@ -740,8 +816,8 @@ inline void ModelSEIRMixingQuarantine<TSeq>::_quarantine_process(Model<TSeq> * m
         if (n_contacts >= EPI_MAX_TRACKING)
             n_contacts = EPI_MAX_TRACKING;
 
-        auto success_rate = m->par("Contact tracing success rate");
-        auto days_prior = m->par("Contact tracing days prior");
+        auto success_rate = m->par(par_contact_tracing_success_rate);
+        auto days_prior = m->par(par_contact_tracing_days_prior);
         for (size_t contact_i = 0u; contact_i < n_contacts; ++contact_i)
         {
 
@@ -70,6 +70,8 @@ private:
     std::vector< int > day_onset; ///< Day of onset of the disease
 
     static void _quarantine_process(Model<TSeq> * m);
+    void write_checkpoint_derived(std::ostream & out) const override;
+    void read_checkpoint_derived(std::istream & in) override;
 
 public:
 
@@ -182,6 +184,34 @@ public:
 // -----------------------------------------------------------------------
 // Reset
 // -----------------------------------------------------------------------
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::write_checkpoint_derived(std::ostream & out) const
+{
+
+    checkpoint_write(out, quarantine_willingness);
+    checkpoint_write(out, isolation_willingness);
+    checkpoint_write(out, agent_quarantine_triggered);
+    checkpoint_write(out, day_flagged);
+    checkpoint_write(out, day_onset);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSEIRNetworkQuarantine<TSeq>::read_checkpoint_derived(std::istream & in)
+{
+
+    checkpoint_read(in, quarantine_willingness);
+    checkpoint_read(in, isolation_willingness);
+    checkpoint_read(in, agent_quarantine_triggered);
+    checkpoint_read(in, day_flagged);
+    checkpoint_read(in, day_onset);
+
+    return;
+
+}
+
 template<typename TSeq>
 inline void ModelSEIRNetworkQuarantine<TSeq>::reset()
 {
@@ -221,19 +251,19 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_susceptible(
 ) {
 
     size_t nviruses_tmp = 0u;
-    for (auto & neighbor : p->get_neighbors(*m))
+    for (auto & neighbor : p->neighbors(*m))
     {
-        auto & v = neighbor->get_virus();
+        auto & v = neighbor.get_virus();
         if (v == nullptr)
             continue;
 
         // Only infectious agents can transmit
-        if (neighbor->get_state() != ModelSEIRNetworkQuarantine<TSeq>::INFECTED)
+        if (neighbor.get_state() != ModelSEIRNetworkQuarantine<TSeq>::INFECTED)
             continue;
 
         // Record contact for tracing: infected neighbor -> susceptible agent
         m->get_contact_tracing().add_contact(
-            neighbor->get_id(),
+            neighbor.get_id(),
             p->get_id(),
             static_cast<size_t>(m->today())
         );
@@ -248,7 +278,7 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_susceptible(
         m->array_double_tmp[nviruses_tmp] =
             (1.0 - p->get_susceptibility_reduction(v, *m)) *
             v->get_prob_infecting(m) *
-            (1.0 - neighbor->get_transmission_reduction(v, *m));
+            (1.0 - neighbor.get_transmission_reduction(v, *m));
 
         m->array_virus_tmp[nviruses_tmp++] = &(*v);
     }
@@ -299,12 +329,19 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_infected(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_days_undetected =
+        Model<TSeq>::param_id("Days undetected");
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
     auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
 
     // Sampling whether the agent is detected or not.
     // If Days undetected < 0, detection is disabled (never detected).
     // If Days undetected == 0, the agent is always detected.
-    epiworld_double days_undetected = m->par("Days undetected");
+    epiworld_double days_undetected = m->par(par_days_undetected);
     bool detected = (days_undetected < 0.0) ?
         false : ((days_undetected == 0.0) ?
             true : (m->runif() < 1.0 / days_undetected));
@@ -317,7 +354,7 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_infected(
     }
 
     // Checking if the agent is willing to isolate individually
-    bool isolation_detected = (m->par("Isolation period") >= 0) &&
+    bool isolation_detected = (m->par(par_isolation_period) >= 0) &&
         detected &&
         (model->isolation_willingness[p->get_id()]);
 
@@ -329,7 +366,7 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_infected(
     auto & v = p->get_virus();
     m->array_double_tmp[0] = 1.0 - (1.0 - v->get_prob_recovery(m)) *
         (1.0 - p->get_recovery_enhancer(v, *m));
-    m->array_double_tmp[1] = m->par("Hospitalization rate");
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
 
     auto which = m->sample_from_probs(2);
 
@@ -377,12 +414,17 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_isolated(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
     auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
 
     int days_since = m->today() - model->day_onset[p->get_id()];
 
     bool unisolate =
-        (m->par("Isolation period") <= days_since) ?
+        (m->par(par_isolation_period) <= days_since) ?
         true : false;
 
     // Sampling from the probabilities of recovery
@@ -391,7 +433,7 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_isolated(
         (1.0 - p->get_recovery_enhancer(p->get_virus(), *m));
 
     // And hospitalization
-    m->array_double_tmp[1] = m->par("Hospitalization rate");
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
 
     auto which = m->sample_from_probs(2);
 
@@ -436,12 +478,15 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_quarantine_suscep(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
     auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
 
     int days_since = m->today() - model->day_flagged[p->get_id()];
 
     bool unquarantine =
-        (m->par("Quarantine period") <= days_since) ?
+        (m->par(par_quarantine_period) <= days_since) ?
         true : false;
 
     if (unquarantine)
@@ -461,12 +506,15 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_quarantine_exposed(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
     auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
 
     int days_since = m->today() - model->day_flagged[p->get_id()];
 
     bool unquarantine =
-        (m->par("Quarantine period") <= days_since) ?
+        (m->par(par_quarantine_period) <= days_since) ?
         true : false;
 
     if (m->runif() < 1.0/(p->get_virus()->get_incubation(m)))
@@ -504,12 +552,15 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_isolated_recovered(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+
     auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
 
     int days_since = m->today() - model->day_onset[p->get_id()];
 
     bool unisolate =
-        (m->par("Isolation period") <= days_since) ?
+        (m->par(par_isolation_period) <= days_since) ?
         true : false;
 
     if (unisolate)
@@ -529,7 +580,10 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_update_hospitalized(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
-    if (m->runif() < 1.0/m->par("Hospitalization period"))
+    static const size_t par_hospitalization_period =
+        Model<TSeq>::param_id("Hospitalization period");
+
+    if (m->runif() < 1.0/m->par(par_hospitalization_period))
         p->rm_virus(*m, ModelSEIRNetworkQuarantine<TSeq>::RECOVERED);
 
 };
@@ -542,6 +596,13 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_quarantine_process(
     Model<TSeq> * m
 ) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+    static const size_t par_contact_tracing_success_rate =
+        Model<TSeq>::param_id("Contact tracing success rate");
+    static const size_t par_contact_tracing_days_prior =
+        Model<TSeq>::param_id("Contact tracing days prior");
+
     auto * model = model_cast<ModelSEIRNetworkQuarantine<TSeq>, TSeq>(m);
 
     for (size_t agent_i = 0u; agent_i < m->size(); ++agent_i)
@@ -553,7 +614,7 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_quarantine_process(
         )
             continue;
 
-        if (m->par("Quarantine period") < 0)
+        if (m->par(par_quarantine_period) < 0)
         {
             model->agent_quarantine_triggered[agent_i] = QUARANTINE_PROCESS_DONE;
             continue;
@@ -563,8 +624,8 @@ inline void ModelSEIRNetworkQuarantine<TSeq>::_quarantine_process(
         if (n_contacts >= EPI_MAX_TRACKING)
             n_contacts = EPI_MAX_TRACKING;
 
-        auto success_rate = m->par("Contact tracing success rate");
-        auto days_prior = m->par("Contact tracing days prior");
+        auto success_rate = m->par(par_contact_tracing_success_rate);
+        auto days_prior = m->par(par_contact_tracing_days_prior);
         for (size_t contact_i = 0u; contact_i < n_contacts; ++contact_i)
         {
             // Checking if we will detect the contact
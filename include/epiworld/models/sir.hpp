@@ -39,9 +39,25 @@ public:
         std::vector< double > proportions_,
         std::vector< int > queue_ = {}
     ) override;
+
+    /**
+     * @brief Runs the built-in states without `std::function` calls
+     * @return false if any state function was replaced by the user.
+     */
+    bool update_state_static() override;
     
 };
 
+template<typename TSeq>
+inline bool ModelSIR<TSeq>::update_state_static()
+{
+    return this->template update_state_table<
+        default_update_susceptible<TSeq>,
+        default_update_exposed<TSeq>,
+        nullptr
+        >();
+}
+
 template<typename TSeq>
 inline ModelSIR<TSeq>::ModelSIR(
     const std::string & vname,
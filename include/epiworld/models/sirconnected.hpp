@@ -17,6 +17,10 @@ private:
 
     std::vector< Agent<TSeq> * > infected;
     void update_infected();
+    void read_checkpoint_derived(std::istream & in) override;
+
+    static void _update_susceptible(Agent<TSeq> * p, Model<TSeq> * m);
+    static void _update_infected(Agent<TSeq> * p, Model<TSeq> * m);
 
 public:
 
@@ -40,6 +44,12 @@ public:
 
     std::unique_ptr< Model<TSeq> > clone_ptr() override;
 
+    /**
+     * @brief Runs the built-in states without `std::function` calls
+     * @return false if any state function was replaced by the user.
+     */
+    bool update_state_static() override;
+
     /**
      * @brief Set the initial states of the model
      * @param proportions_ Double vector with a single element:
@@ -108,6 +118,16 @@ inline void ModelSIRCONN<TSeq>::reset()
 
 }
 
+template<typename TSeq>
+inline void ModelSIRCONN<TSeq>::read_checkpoint_derived(std::istream &)
+{
+
+    this->update_infected();
+
+    return;
+
+}
+
 template<typename TSeq>
 inline std::unique_ptr<Model<TSeq>> ModelSIRCONN<TSeq>::clone_ptr()
 {
@@ -116,149 +136,159 @@ inline std::unique_ptr<Model<TSeq>> ModelSIRCONN<TSeq>::clone_ptr()
 
 }
 
-/**
- * @brief Template for a Susceptible-Infected-Removed (SIR) model
- * 
- * @param model A Model<TSeq> object where to set up the SIR.
- * @param vname std::string Name of the virus
- * @param prevalence Initial prevalence (proportion)
- * @param contact_rate Average number of contacts (interactions) per step.
- * @param transmission_rate Probability of transmission
- * @param recovery_rate Probability of recovery
- */
 template<typename TSeq>
-inline ModelSIRCONN<TSeq>::ModelSIRCONN(
-    const std::string & vname,
-    epiworld_fast_uint n,
-    epiworld_double prevalence,
-    epiworld_double contact_rate,
-    epiworld_double transmission_rate,
-    epiworld_double recovery_rate
-    // epiworld_double prob_reinfection
+inline bool ModelSIRCONN<TSeq>::update_state_static()
+{
+    return this->template update_state_table<
+        _update_susceptible, _update_infected, nullptr
+        >();
+}
+
+template<typename TSeq>
+inline void ModelSIRCONN<TSeq>::_update_susceptible(
+    Agent<TSeq> * p, Model<TSeq> * m
     )
 {
 
-    UpdateFun<TSeq> update_susceptible = [](
-        Agent<TSeq> * p, Model<TSeq> * m
-        ) -> void
-        {
+    int ndraw = m->rbinom();
 
-            int ndraw = m->rbinom();
+    if (ndraw == 0)
+        return;
 
-            if (ndraw == 0)
-                return;
+    ModelSIRCONN<TSeq> * model = model_cast<ModelSIRCONN<TSeq>,TSeq>(m);
+    int ninfected = static_cast<int>(model->get_n_infected());
 
-            ModelSIRCONN<TSeq> * model = model_cast<ModelSIRCONN<TSeq>,TSeq>(m);
-            int ninfected = static_cast<int>(model->get_n_infected());
-
-            // Drawing from the set
-            int nviruses_tmp = 0;
-            auto & m_ref = *m;
-            for (int i = 0; i < ndraw; ++i)
-            {
-                // Now selecting who is transmitting the disease
-                auto which = m->runif_index(ninfected);
-                
-                Agent<TSeq> & neighbor = *model->infected[which];
+    // Drawing from the set
+    int nviruses_tmp = 0;
+    auto & m_ref = *m;
+    for (int i = 0; i < ndraw; ++i)
+    {
+        // Now selecting who is transmitting the disease
+        auto which = m->runif_index(ninfected);
 
-                // Can't sample itself
-                if (neighbor.get_id() == p->get_id())
-                    continue;
+        Agent<TSeq> & neighbor = *model->infected[which];
 
-                // The neighbor is infected because it is on the list!
-                if (neighbor.get_virus() == nullptr)
-                    continue;
+        // Can't sample itself
+        if (neighbor.get_id() == p->get_id())
+            continue;
 
-                auto & v = neighbor.get_virus();
+        // The neighbor is infected because it is on the list!
+        if (neighbor.get_virus() == nullptr)
+            continue;
 
-                #ifdef EPI_DEBUG
-                if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
-                    throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
-                #endif
-                    
-                /* And it is a function of susceptibility_reduction as well */ 
-                m->array_double_tmp[nviruses_tmp] =
-                    (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
-                    v->get_prob_infecting(m) *
-                    (1.0 - neighbor.get_transmission_reduction(v, m_ref))
-                    ;
-            
-                m->array_virus_tmp[nviruses_tmp++] = &(*v);
-                 
-            }
+        auto & v = neighbor.get_virus();
 
-            // No virus to compute
-            if (nviruses_tmp == 0u)
-                return;
+        #ifdef EPI_DEBUG
+        if (nviruses_tmp >= static_cast<int>(m->array_virus_tmp.size()))
+            throw std::logic_error("Trying to add an extra element to a temporal array outside of the range.");
+        #endif
 
-            // Running the roulette
-            int which = roulette(nviruses_tmp, m);
+        /* And it is a function of susceptibility_reduction as well */ 
+        m->array_double_tmp[nviruses_tmp] =
+            (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
+            v->get_prob_infecting(m) *
+            (1.0 - neighbor.get_transmission_reduction(v, m_ref))
+            ;
 
-            if (which < 0)
-                return;
+        m->array_virus_tmp[nviruses_tmp++] = &(*v);
 
-            p->set_virus(*m, *m->array_virus_tmp[which]);
+    }
 
-            return; 
+    // No virus to compute
+    if (nviruses_tmp == 0u)
+        return;
 
-        };
+    // Running the roulette
+    int which = roulette(nviruses_tmp, m);
 
+    if (which < 0)
+        return;
+
+    p->set_virus(*m, *m->array_virus_tmp[which]);
 
-    UpdateFun<TSeq> update_infected = [](
-        Agent<TSeq> * p, Model<TSeq> * m
-        ) -> void {
+    return; 
 
-            auto state = p->get_state();
+}
+
+template<typename TSeq>
+inline void ModelSIRCONN<TSeq>::_update_infected(
+    Agent<TSeq> * p, Model<TSeq> * m
+    )
+{
 
-            if (state == ModelSIRCONN<TSeq>::INFECTED)
-            {
+    auto state = p->get_state();
 
+    if (state == ModelSIRCONN<TSeq>::INFECTED)
+    {
 
-                // Odd: Die, Even: Recover
-                epiworld_fast_uint n_events = 0u;
-                // Recover
-                m->array_double_tmp[n_events++] = 
-                    1.0 - (1.0 - p->get_virus()->get_prob_recovery(m)) *
-                        (1.0 - p->get_recovery_enhancer(p->get_virus(), *m));
 
-                #ifdef EPI_DEBUG
-                if (n_events == 0u)
-                {
-                    printf_epiworld(
-                        "[epi-debug] agent %i has 0 possible events!!\n",
-                        static_cast<int>(p->get_id())
-                        );
-                    throw std::logic_error("Zero events in exposed.");
-                }
-                #else
-                if (n_events == 0u)
-                    return;
-                #endif
-                
+        // Odd: Die, Even: Recover
+        epiworld_fast_uint n_events = 0u;
+        // Recover
+        m->array_double_tmp[n_events++] = 
+            1.0 - (1.0 - p->get_virus()->get_prob_recovery(m)) *
+                (1.0 - p->get_recovery_enhancer(p->get_virus(), *m));
 
-                // Running the roulette
-                int which = roulette(n_events, m);
+        #ifdef EPI_DEBUG
+        if (n_events == 0u)
+        {
+            printf_epiworld(
+                "[epi-debug] agent %i has 0 possible events!!\n",
+                static_cast<int>(p->get_id())
+                );
+            throw std::logic_error("Zero events in exposed.");
+        }
+        #else
+        if (n_events == 0u)
+            return;
+        #endif
 
-                if (which < 0)
-                    return;
 
-                // Which roulette happen?
-                p->rm_virus(*m);
-
-                return ;
-
-            } else
-                throw std::logic_error(
-                    "This function can only be applied to infected individuals. (SIR)"
-                    ) ;
+        // Running the roulette
+        int which = roulette(n_events, m);
 
+        if (which < 0)
             return;
 
-        };
+        // Which roulette happen?
+        p->rm_virus(*m);
+
+        return ;
+
+    } else
+        throw std::logic_error(
+            "This function can only be applied to infected individuals. (SIR)"
+            ) ;
+
+    return;
+
+}
+
+/**
+ * @brief Template for a Susceptible-Infected-Removed (SIR) model
+ * 
+ * @param model A Model<TSeq> object where to set up the SIR.
+ * @param vname std::string Name of the virus
+ * @param prevalence Initial prevalence (proportion)
+ * @param contact_rate Average number of contacts (interactions) per step.
+ * @param transmission_rate Probability of transmission
+ * @param recovery_rate Probability of recovery
+ */
+template<typename TSeq>
+inline ModelSIRCONN<TSeq>::ModelSIRCONN(
+    const std::string & vname,
+    epiworld_fast_uint n,
+    epiworld_double prevalence,
+    epiworld_double contact_rate,
+    epiworld_double transmission_rate,
+    epiworld_double recovery_rate
+    // epiworld_double prob_reinfection
+    )
+{
 
     // state
-    this->add_state("Susceptible", update_susceptible);
-    this->add_state("Infected", update_infected);
+    this->add_state("Susceptible", _update_susceptible);
+    this->add_state("Infected", _update_infected);
     this->add_state("Recovered");
 
     // Setting up parameters
@@ -72,11 +72,14 @@ inline ModelSIRDCONN<TSeq>::ModelSIRDCONN(
         ) -> void
         {
 
+            static const size_t par_contact_rate =
+                Model<TSeq>::param_id("Contact rate");
+
             // Sampling how many individuals
             m->set_rand_binom(
                 m->size(),
                 static_cast<double>(
-                    m->par("Contact rate"))/
+                    m->par(par_contact_rate))/
                     static_cast<double>(m->size())
             );
 
@@ -179,13 +179,13 @@ inline ModelSIRLogit<TSeq>::ModelSIRLogit(
                 baseline += p->operator()(k, *m) * _m->coefs_infect[k + 1u];
 
             auto & m_ref = *m;
-            for (auto & neighbor: p->get_neighbors(*m)) 
+            for (auto & neighbor: p->neighbors(*m)) 
             {
                 
-                if (neighbor->get_virus() == nullptr)
+                if (neighbor.get_virus() == nullptr)
                     continue;
 
-                auto & v = neighbor->get_virus();
+                auto & v = neighbor.get_virus();
 
                 #ifdef EPI_DEBUG
                 if (nviruses_tmp >= m->array_virus_tmp.size())
@@ -197,7 +197,7 @@ inline ModelSIRLogit<TSeq>::ModelSIRLogit(
                     baseline +
                     (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
                     v->get_prob_infecting(m) *
-                    (1.0 - neighbor->get_transmission_reduction(v, m_ref))  *
+                    (1.0 - neighbor.get_transmission_reduction(v, m_ref))  *
                     coef_exposure
                     ; 
 
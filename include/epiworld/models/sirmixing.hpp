@@ -23,7 +23,7 @@ class ModelSIRMixing :
 private:
 
     // Vector of infected agents
-    std::vector< size_t > infected;
+    std::vector< epiworld_agent_index > infected;
     size_t n_infected;
 
     // Number of infected agents in each group
@@ -33,10 +33,12 @@ private:
     std::vector< size_t > entity_indices;
 
     void update_infected_list();
-    std::vector< size_t > sampled_agents;
+    void setup_groups(); ///< Sizes and fills the lists by group.
+    void read_checkpoint_derived(std::istream & in) override;
+    std::vector< epiworld_agent_index > sampled_agents;
     size_t sample_agents(
         Agent<TSeq> * agent,
-        std::vector< size_t > & sampled_agents
+        std::vector< epiworld_agent_index > & sampled_agents
         );
 
     std::vector< double > adjusted_contact_rate;
@@ -45,6 +47,11 @@ private:
         return j * n + i;
     }
 
+    // Aggregated mode (see aggregated_on())
+    epiworld_double prevalence;
+    std::vector< double > proportions = {};
+    Model<TSeq> & run_aggregated(epiworld_fast_uint ndays) override;
+
 public:
 
     static const int SUSCEPTIBLE = 0;
@@ -94,6 +101,34 @@ public:
         return n_infected_per_group[group];
     }
 
+    /**
+     * @name Aggregated mode
+     * @details In aggregated mode, the model keeps counts per group and
+     * state instead of agents. Each day, a susceptible in group `i`
+     * escapes infection from the `I_g` infected in group `g` with
+     * probability \f$(1 - p\,c_{ig}/N_g)^{I_g}\f$, which is what the
+     * agent-based model gives by drawing contacts with the infected
+     * and trying to transmit to each. New infections and recoveries are
+     * then binomial draws from the counts at the start of the day. The
+     * population is released, so memory does not grow with the number of
+     * agents, and the database (e.g., `get_hist_total()`, `write_data()`)
+     * is filled as in the agent-based model.
+     *
+     * Initial infections follow the prevalence passed to the constructor
+     * (spread across groups in proportion to their size), and the
+     * proportions from `initial_states()` are drawn per group. Tools,
+     * entities, and virus distribution functions are not used, and the
+     * virus probabilities must not depend on the agent. Transmission
+     * events are not recorded.
+     *
+     * @param group_sizes Number of agents in each group (one per row of
+     * the contact matrix).
+     */
+    ///@{
+    ModelSIRMixing<TSeq> & aggregated_on(std::vector< size_t > group_sizes);
+    ModelSIRMixing<TSeq> & aggregated_off(); ///< Restores the agents.
+    ///@}
+
 };
 
 template<typename TSeq>
@@ -130,7 +165,7 @@ inline void ModelSIRMixing<TSeq>::update_infected_list()
 template<typename TSeq>
 inline size_t ModelSIRMixing<TSeq>::sample_agents(
     Agent<TSeq> * agent,
-    std::vector< size_t > & sampled_agents
+    std::vector< epiworld_agent_index > & sampled_agents
     )
 {
 
@@ -191,11 +226,9 @@ inline size_t ModelSIRMixing<TSeq>::sample_agents(
 }
 
 template<typename TSeq>
-inline void ModelSIRMixing<TSeq>::reset()
+inline void ModelSIRMixing<TSeq>::setup_groups()
 {
 
-    Model<TSeq>::reset();
-
     // Checking contact matrix dimensions
     size_t nentities = this->entities.size();
     this->validate_contact_matrix(nentities);
@@ -235,6 +268,28 @@ inline void ModelSIRMixing<TSeq>::reset()
 
     this->update_infected_list();
 
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSIRMixing<TSeq>::read_checkpoint_derived(std::istream &)
+{
+
+    this->setup_groups();
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSIRMixing<TSeq>::reset()
+{
+
+    Model<TSeq>::reset();
+
+    this->setup_groups();
+
     return;
 }
 
@@ -246,6 +301,112 @@ inline std::unique_ptr<Model<TSeq>> ModelSIRMixing<TSeq>::clone_ptr()
 
 }
 
+template<typename TSeq>
+inline ModelSIRMixing<TSeq> & ModelSIRMixing<TSeq>::aggregated_on(
+    std::vector< size_t > group_sizes
+)
+{
+
+    this->validate_contact_matrix(group_sizes.size());
+    this->aggregated_enable(std::move(group_sizes));
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline ModelSIRMixing<TSeq> & ModelSIRMixing<TSeq>::aggregated_off()
+{
+
+    this->aggregated_disable();
+
+    return *this;
+
+}
+
+template<typename TSeq>
+inline Model<TSeq> & ModelSIRMixing<TSeq>::run_aggregated(
+    epiworld_fast_uint ndays
+)
+{
+
+    const size_t ngroups = this->aggregated_sizes.size();
+    this->validate_contact_matrix(ngroups);
+
+    // Initial infections, spread across groups
+    std::vector< int > S(ngroups), R(ngroups);
+    std::vector< int > I = this->aggregated_split(prevalence);
+    for (size_t g = 0u; g < ngroups; ++g)
+    {
+
+        int size_g = static_cast< int >(this->aggregated_sizes[g]);
+
+        R[g] = proportions.size() > 0u ?
+            this->rbinom(size_g - I[g], proportions[0u]) : 0;
+
+        S[g] = size_g - I[g] - R[g];
+
+    }
+
+    std::vector< int > totals = {0, 0, 0};
+    for (size_t g = 0u; g < ngroups; ++g)
+    {
+        totals[SUSCEPTIBLE] += S[g];
+        totals[INFECTED]    += I[g];
+        totals[RECOVERED]   += R[g];
+    }
+
+    this->aggregated_setup(ndays, totals, {false, true, false});
+
+    auto & virus = this->get_virus(0u);
+    std::vector< int > new_infected(ngroups), new_recovered(ngroups);
+    n_infected_per_group.assign(ngroups, 0u);
+    for (epiworld_fast_uint niter = 0; niter < this->get_ndays(); ++niter)
+    {
+
+        epiworld_double p_transmit = virus.get_prob_infecting(this);
+        epiworld_double p_recover  = virus.get_prob_recovery(this);
+
+        // All draws use the counts at the start of the day
+        for (size_t i = 0u; i < ngroups; ++i)
+        {
+
+            epiworld_double p_escape =
+                this->aggregated_escape(*this, i, I, p_transmit);
+
+            new_infected[i]  = this->rbinom(S[i], 1.0 - p_escape);
+            new_recovered[i] = this->rbinom(I[i], p_recover);
+
+        }
+
+        for (size_t i = 0u; i < ngroups; ++i)
+        {
+
+            S[i] -= new_infected[i];
+            I[i] += new_infected[i] - new_recovered[i];
+            R[i] += new_recovered[i];
+
+            this->aggregated_move(SUSCEPTIBLE, INFECTED, new_infected[i]);
+            this->aggregated_move(INFECTED, RECOVERED, new_recovered[i]);
+
+        }
+
+        this->run_globalevents();
+
+        // After the global events, which refresh the list from the agents
+        for (size_t i = 0u; i < ngroups; ++i)
+            n_infected_per_group[i] = static_cast< size_t >(I[i]);
+
+        this->next();
+
+    }
+
+    this->aggregated_end();
+
+    return *this;
+
+}
+
 
 /**
  * @brief Template for a Susceptible-Exposed-Infected-Removed (SEIR) model
@@ -273,6 +434,8 @@ inline ModelSIRMixing<TSeq>::ModelSIRMixing(
     // Setting up the contact matrix
     this->set_contact_matrix(contact_matrix, true);
 
+    this->prevalence = prevalence;
+
     UpdateFun<TSeq> update_susceptible = [](
         Agent<TSeq> * p, Model<TSeq> * m
         ) -> void
@@ -438,6 +601,8 @@ inline ModelSIRMixing<TSeq> & ModelSIRMixing<TSeq>::initial_states(
         create_init_function_sir<TSeq>(proportions_)
         ;
 
+    proportions = proportions_;
+
     return *this;
 
 }
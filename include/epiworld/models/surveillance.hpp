@@ -10,6 +10,10 @@
 template<typename TSeq = EPI_DEFAULT_TSEQ>
 class ModelSURV : public Model<TSeq> {
 
+private:
+    void write_checkpoint_derived(std::ostream & out) const override;
+    void read_checkpoint_derived(std::istream & in) override;
+
 public:
     // state
     static constexpr int SUSCEPTIBLE           = 0;
@@ -91,6 +95,26 @@ public:
 
 };
 
+template<typename TSeq>
+inline void ModelSURV<TSeq>::write_checkpoint_derived(std::ostream & out) const
+{
+
+    checkpoint_write(out, days_latent_and_infectious);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelSURV<TSeq>::read_checkpoint_derived(std::istream & in)
+{
+
+    checkpoint_read(in, days_latent_and_infectious);
+
+    return;
+
+}
+
 template<typename TSeq>
 inline void ModelSURV<TSeq>::reset()
 {
@@ -126,10 +150,10 @@ inline ModelSURV<TSeq>::ModelSURV(
         // This computes the prob of getting any neighbor variant
         epiworld_fast_uint nviruses_tmp = 0u;
         auto & m_ref = *m;
-        for (auto & neighbor: p->get_neighbors(*m)) 
+        for (auto & neighbor: p->neighbors(*m)) 
         {
                     
-            auto & v = neighbor->get_virus();
+            auto & v = neighbor.get_virus();
 
             if (v == nullptr)
                 continue;
@@ -138,7 +162,7 @@ inline ModelSURV<TSeq>::ModelSURV(
             epiworld_double tmp_transmission = 
                 (1.0 - p->get_susceptibility_reduction(v, m_ref)) *
                 v->get_prob_infecting(m) *
-                (1.0 - neighbor->get_transmission_reduction(v, m_ref)) 
+                (1.0 - neighbor.get_transmission_reduction(v, m_ref)) 
                 ; 
         
             m->array_double_tmp[nviruses_tmp]  = tmp_transmission;
@@ -168,6 +192,13 @@ inline ModelSURV<TSeq>::ModelSURV(
         // Dynamically getting the ModelSURV
         ModelSURV<TSeq> * model_surv = model_cast<ModelSURV<TSeq>,TSeq>(m);
 
+        static const size_t par_latent_period =
+            Model<TSeq>::param_id("Latent period");
+        static const size_t par_infect_period =
+            Model<TSeq>::param_id("Infect period");
+        static const size_t par_prob_symptoms =
+            Model<TSeq>::param_id("Prob of symptoms");
+
         VirusPtr<TSeq> & v = p->get_virus(); 
         epiworld_double p_die = v->get_prob_death(m) * (1.0 - p->get_death_reduction(v, *m));
         
@@ -179,13 +210,13 @@ inline ModelSURV<TSeq>::ModelSURV(
         if (dat[p->get_id()] < 0)
         {
             epiworld_double latent_days = m->rgamma(
-                m->par("Latent period"), 1.0
+                m->par(par_latent_period), 1.0
             );
 
             dat[p->get_id() * 2u] = latent_days;
 
             dat[p->get_id() * 2u + 1u] = 
-                m->rgamma(m->par("Infect period"), 1.0) +
+                m->rgamma(m->par(par_infect_period), 1.0) +
                 latent_days;
         }
         
@@ -205,7 +236,7 @@ inline ModelSURV<TSeq>::ModelSURV(
         {
 
             // Will be symptomatic?
-            if (EPI_RUNIF() < m->par("Prob of symptoms"))
+            if (EPI_RUNIF() < m->par(par_prob_symptoms))
                 p->change_state(*m, ModelSURV<TSeq>::SYMPTOMATIC);
             else
                 p->change_state(*m, ModelSURV<TSeq>::ASYMPTOMATIC);
@@ -239,8 +270,11 @@ inline ModelSURV<TSeq>::ModelSURV(
         ) -> void
     {
 
+        static const size_t par_surveilance_prob =
+            Model<TSeq>::param_id("Surveilance prob.");
+
         // How many will we find
-        std::binomial_distribution<> bdist(m->size(), m->par("Surveilance prob."));
+        std::binomial_distribution<> bdist(m->size(), m->par(par_surveilance_prob));
         int nsampled = bdist(*m->get_rand_endgine());
 
         int to_go = nsampled + 1;
@@ -329,6 +363,9 @@ inline ModelSURV<TSeq>::ModelSURV(
         Model<TSeq> * m
         ) -> epiworld_double
     {
+        static const size_t par_prob_transmission =
+            Model<TSeq>::param_id("Prob of transmission");
+
         // No chance of infecting
         epiworld_fast_uint  s = p->get_state();
         if (s == ModelSURV<TSeq>::LATENT)
@@ -339,7 +376,7 @@ inline ModelSURV<TSeq>::ModelSURV(
             return static_cast<epiworld_double>(0.0);
 
         // Otherwise
-        return m->par("Prob of transmission");
+        return m->par(par_prob_transmission);
     };
 
     covid.set_prob_infecting_fun(ptransmitfun);
@@ -0,0 +1,102 @@
+#ifndef EPIWORLD_NETWORK_BONES_HPP
+#define EPIWORLD_NETWORK_BONES_HPP
+
+#include <vector>
+#include <map>
+#include <limits>
+#include <stdexcept>
+#include "config.hpp"
+
+class AdjList;
+
+/**
+ * @brief Contact network stored in compressed sparse row (CSR) format
+ * @details
+ * The ties of agent `i` are stored in the half-open range
+ * `[offsets[i], offsets[i + 1])` of two flat arrays: `ids`, with the
+ * ids of the neighbors, and `locations`, with the position of the reverse
+ * tie within the neighbor's row. Storing the network this way avoids one
+ * heap allocation per agent, keeps neighbors contiguous in memory, and
+ * makes copying the population (e.g., in `Model<TSeq>::reset()` or when
+ * cloning the model in `Model<TSeq>::run_multiple()`) a handful of
+ * `memcpy`s.
+ *
+ * The network is owned by `Model<TSeq>`; agents only keep their degree.
+ * Ids and locations are stored as `epiworld_agent_index` (see
+ * `config.hpp`), so the number of vertices is bounded by that type.
+ */
+class Network
+{
+    template<typename TSeq> friend class Model;
+
+private:
+
+    std::vector< size_t > offsets = {0u};              ///< Row offsets (size `n + 1`).
+    std::vector< epiworld_agent_index > ids;           ///< Neighbor ids.
+    std::vector< epiworld_agent_index > locations;     ///< Location of the reverse tie in the neighbor's row.
+
+public:
+
+    Network() = default;
+
+    /**
+     * @brief Construct an empty network
+     * @param n Number of vertices (agents).
+     */
+    Network(size_t n);
+
+    /**
+     * @brief Removes all ties and resizes the network to `n` vertices
+     * @param n Number of vertices (agents).
+     * @throws std::range_error if `n` does not fit in `epiworld_agent_index`.
+     */
+    void reset(size_t n);
+
+    /**
+     * @brief Builds the network from an adjacency list
+     * @details
+     * The ties are added in the same order in which `Agent<TSeq>::add_neighbor()`
+     * adds them (both directions, skipping duplicates), so the resulting
+     * neighbor ordering is the same as adding the ties one at a time.
+     * @param al Adjacency list.
+     */
+    void build(AdjList & al);
+
+    /**
+     * @brief Adds the tie `i -> j` (and its reverse `j -> i`)
+     * @details
+     * Since the storage is contiguous, this is an `O(E)` operation. To
+     * build large networks, use `build()` instead.
+     * @param i, j Vertex ids.
+     * @param check_source If `true`, skips adding `j` to `i` if already present.
+     * @param check_target If `true`, skips adding `i` to `j` if already present.
+     */
+    void add_edge(
+        size_t i,
+        size_t j,
+        bool check_source = true,
+        bool check_target = true
+        );
+
+    size_t vcount() const noexcept; ///< Number of vertices.
+    size_t ecount() const noexcept; ///< Number of stored ties (both directions).
+    size_t degree(size_t i) const;  ///< Number of neighbors of vertex `i`.
+
+    /**
+     * @name Row access
+     * @details Pointers to the first element of the row of vertex `i`. The
+     * row has `degree(i)` elements.
+     */
+    ///@{
+    epiworld_agent_index * neighbors(size_t i);
+    const epiworld_agent_index * neighbors(size_t i) const;
+    epiworld_agent_index * neighbors_locations(size_t i);
+    const epiworld_agent_index * neighbors_locations(size_t i) const;
+    ///@}
+
+    bool operator==(const Network & other) const;
+    bool operator!=(const Network & other) const {return !operator==(other);};
+
+};
+
+#endif
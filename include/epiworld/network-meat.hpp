@@ -0,0 +1,184 @@
+#ifndef EPIWORLD_NETWORK_MEAT_HPP
+#define EPIWORLD_NETWORK_MEAT_HPP
+
+#include "network-bones.hpp"
+#include "adjlist-bones.hpp"
+
+inline Network::Network(size_t n)
+{
+    reset(n);
+}
+
+inline void Network::reset(size_t n)
+{
+
+    if (n > static_cast< size_t >(
+        std::numeric_limits< epiworld_agent_index >::max()
+    ))
+        throw std::range_error(
+            "The network cannot have " + std::to_string(n) +
+            " vertices, as ids are stored as `epiworld_agent_index` (" +
+            std::to_string(sizeof(epiworld_agent_index) * 8u) + " bits)."
+        );
+
+    offsets.assign(n + 1, 0u);
+    ids.clear();
+    locations.clear();
+
+}
+
+inline void Network::build(AdjList & al)
+{
+
+    const auto & dat = al.get_dat();
+    size_t n = al.vcount();
+
+    // Ties are staged by row first, since adding a tie can append to
+    // any row (the reverse tie).
+    std::vector< std::vector< epiworld_agent_index > > rows_ids(n);
+    std::vector< std::vector< epiworld_agent_index > > rows_locs(n);
+
+    auto find = [&rows_ids](size_t row, size_t what) -> bool {
+        for (auto k : rows_ids[row])
+            if (k == what)
+                return true;
+        return false;
+    };
+
+    for (size_t i = 0u; i < dat.size(); ++i)
+    {
+
+        for (const auto & link : dat[i])
+        {
+
+            size_t j = static_cast< size_t >(link.first);
+
+            if (!find(i, j))
+            {
+                rows_locs[i].push_back(
+                    static_cast< epiworld_agent_index >(rows_ids[j].size())
+                );
+                rows_ids[i].push_back(static_cast< epiworld_agent_index >(j));
+            }
+
+            if (!find(j, i))
+            {
+                rows_locs[j].push_back(
+                    static_cast< epiworld_agent_index >(rows_ids[i].size() - 1)
+                );
+                rows_ids[j].push_back(static_cast< epiworld_agent_index >(i));
+            }
+
+        }
+
+    }
+
+    // Flattening
+    offsets.assign(n + 1, 0u);
+    for (size_t i = 0u; i < n; ++i)
+        offsets[i + 1] = offsets[i] + rows_ids[i].size();
+
+    ids.resize(offsets[n]);
+    locations.resize(offsets[n]);
+    for (size_t i = 0u; i < n; ++i)
+    {
+        std::copy(rows_ids[i].begin(), rows_ids[i].end(), ids.begin() + offsets[i]);
+        std::copy(rows_locs[i].begin(), rows_locs[i].end(), locations.begin() + offsets[i]);
+    }
+
+}
+
+inline void Network::add_edge(
+    size_t i,
+    size_t j,
+    bool check_source,
+    bool check_target
+)
+{
+
+    if (std::max(i, j) >= vcount())
+        throw std::range_error(
+            "The vertex is out of range. The network only has " +
+            std::to_string(vcount()) + " vertices."
+        );
+
+    auto insert = [this](size_t row, size_t id, size_t loc) -> void {
+
+        size_t pos = offsets[row + 1];
+        ids.insert(
+            ids.begin() + pos, static_cast< epiworld_agent_index >(id)
+        );
+        locations.insert(
+            locations.begin() + pos, static_cast< epiworld_agent_index >(loc)
+        );
+
+        for (size_t k = row + 1; k < offsets.size(); ++k)
+            ++offsets[k];
+
+    };
+
+    auto find = [this](size_t row, size_t what) -> bool {
+        for (size_t k = offsets[row]; k < offsets[row + 1]; ++k)
+            if (ids[k] == what)
+                return true;
+        return false;
+    };
+
+    // Three things going on here:
+    // - Where in the neighbor will this be
+    // - What is the neighbor's id
+    // - Increasing the number of neighbors
+    if (!check_source || !find(i, j))
+        insert(i, j, degree(j));
+
+    if (!check_target || !find(j, i))
+        insert(j, i, degree(i) - 1);
+
+}
+
+inline size_t Network::vcount() const noexcept
+{
+    return offsets.size() - 1u;
+}
+
+inline size_t Network::ecount() const noexcept
+{
+    return ids.size();
+}
+
+inline size_t Network::degree(size_t i) const
+{
+    return offsets[i + 1] - offsets[i];
+}
+
+inline epiworld_agent_index * Network::neighbors(size_t i)
+{
+    return ids.data() + offsets[i];
+}
+
+inline const epiworld_agent_index * Network::neighbors(size_t i) const
+{
+    return ids.data() + offsets[i];
+}
+
+inline epiworld_agent_index * Network::neighbors_locations(size_t i)
+{
+    return locations.data() + offsets[i];
+}
+
+inline const epiworld_agent_index * Network::neighbors_locations(size_t i) const
+{
+    return locations.data() + offsets[i];
+}
+
+inline bool Network::operator==(const Network & other) const
+{
+
+    if (offsets != other.offsets)
+        return false;
+
+    return ids == other.ids;
+
+}
+
+#endif
@@ -0,0 +1,279 @@
+#ifndef EPIWORLD_PROFILER_BONES_HPP
+#define EPIWORLD_PROFILER_BONES_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include "config.hpp"
+
+/**
+ * @brief Time per phase and counters of a simulation
+ * @details
+ * `Model<TSeq>` keeps one for the last run and one for all its runs (see
+ * `Model<TSeq>::get_profile()`). Phases are timed exclusively: the time
+ * spent in a nested phase (e.g., `events_run()` called from the global
+ * events) is only counted in the nested phase.
+ *
+ * The instrumentation is only compiled when `EPI_PROFILE` is defined;
+ * otherwise the `EPI_PROFILE_*` macros expand to nothing and all the
+ * times and counters stay at zero.
+ */
+class Profiler
+{
+public:
+
+    enum Phase : size_t {
+        UpdateState,  ///< Update functions of the agents.
+        EventsRun,    ///< Applying the events (`Model::events_run()`).
+        GlobalEvents, ///< Global events (without the events they add).
+        Rewire,       ///< Rewiring the network.
+        Record,       ///< Recording the day (`DataBase::record()`).
+        MutateVirus,  ///< Mutating the viruses.
+        NPhases
+    };
+
+    enum Counter : size_t {
+        AgentsVisited, ///< Agents whose state was checked for an update.
+        StateFunCalls, ///< Calls to update functions.
+        RngDraws,      ///< Random variates drawn from the model.
+        NCounters
+    };
+
+    static constexpr size_t NEventActions =
+        static_cast< size_t >(EventAction::ChangeState) + 1u;
+
+private:
+
+    std::array< epiworld_double, NPhases > times = {};   ///< Microseconds.
+    std::array< uint64_t, NCounters > counters = {};
+    std::array< uint64_t, NEventActions > events = {};   ///< By `EventAction`.
+
+    // Stack of open phases (for exclusive timing)
+    std::array< size_t, 8u > stack = {};
+    size_t depth = 0u;
+    std::chrono::time_point< std::chrono::steady_clock > tic;
+
+    void stop_current(std::chrono::time_point< std::chrono::steady_clock > now);
+
+public:
+
+    Profiler() = default;
+
+    void reset(); ///< Sets all times and counters to zero.
+
+    /**
+     * @name Timing
+     * @details `enter()` pauses the current phase (if any) and starts
+     * `phase`; `leave()` stops it and resumes the previous one. `Scope`
+     * does both (RAII).
+     */
+    ///@{
+    void enter(Phase phase);
+    void leave();
+
+    class Scope {
+    private:
+        Profiler & profiler;
+    public:
+        Scope(Profiler & p, Phase phase) : profiler(p) { profiler.enter(phase); };
+        ~Scope() { profiler.leave(); };
+    };
+    ///@}
+
+    /**
+     * @brief Adds to a counter
+     * @details Thread-safe (atomic), since variates can be drawn within
+     * the parallel update.
+     */
+    void add(Counter counter, uint64_t n = 1u);
+    void add_event(EventAction action);
+
+    Profiler & operator+=(const Profiler & other); ///< Aggregates (e.g., replicates).
+
+    epiworld_double get_time(Phase phase) const; ///< Microseconds.
+    uint64_t get_count(Counter counter) const;
+    uint64_t get_events(EventAction action) const;
+
+    static const char * phase_name(Phase phase);
+    static const char * counter_name(Counter counter);
+    static const char * event_name(EventAction action);
+
+    void print() const;
+
+};
+
+#ifdef EPI_PROFILE
+    #define EPI_PROFILE_SCOPE(profiler, phase) \
+        Profiler::Scope epi_profile_scope_((profiler), Profiler::phase);
+    #define EPI_PROFILE_ADD(profiler, counter, n) \
+        (profiler).add(Profiler::counter, (n));
+    #define EPI_PROFILE_EVENT(profiler, action) \
+        (profiler).add_event(action);
+#else
+    #define EPI_PROFILE_SCOPE(profiler, phase)
+    #define EPI_PROFILE_ADD(profiler, counter, n)
+    #define EPI_PROFILE_EVENT(profiler, action)
+#endif
+
+inline void Profiler::reset()
+{
+    times.fill(0.0);
+    counters.fill(0u);
+    events.fill(0u);
+    depth = 0u;
+}
+
+inline void Profiler::stop_current(
+    std::chrono::time_point< std::chrono::steady_clock > now
+)
+{
+
+    // Phases nested deeper than the stack are not timed
+    if ((depth == 0u) || (depth > stack.size()))
+        return;
+
+    times[stack[depth - 1u]] +=
+        std::chrono::duration< epiworld_double, std::micro >(now - tic).count();
+
+}
+
+inline void Profiler::enter(Phase phase)
+{
+
+    auto now = std::chrono::steady_clock::now();
+    stop_current(now);
+
+    if (depth < stack.size())
+        stack[depth] = phase;
+
+    ++depth;
+    tic = now;
+
+}
+
+inline void Profiler::leave()
+{
+
+    auto now = std::chrono::steady_clock::now();
+
+    stop_current(now);
+
+    if (depth > 0u)
+        --depth;
+
+    tic = now;
+
+}
+
+inline void Profiler::add(Counter counter, uint64_t n)
+{
+    #pragma omp atomic
+    counters[counter] += n;
+}
+
+inline void Profiler::add_event(EventAction action)
+{
+    events[static_cast< size_t >(action)]++;
+}
+
+inline Profiler & Profiler::operator+=(const Profiler & other)
+{
+
+    for (size_t i = 0u; i < NPhases; ++i)
+        times[i] += other.times[i];
+
+    for (size_t i = 0u; i < NCounters; ++i)
+        counters[i] += other.counters[i];
+
+    for (size_t i = 0u; i < NEventActions; ++i)
+        events[i] += other.events[i];
+
+    return *this;
+
+}
+
+inline epiworld_double Profiler::get_time(Phase phase) const
+{
+    return times.at(phase);
+}
+
+inline uint64_t Profiler::get_count(Counter counter) const
+{
+    return counters.at(counter);
+}
+
+inline uint64_t Profiler::get_events(EventAction action) const
+{
+    return events.at(static_cast< size_t >(action));
+}
+
+inline const char * Profiler::phase_name(Phase phase)
+{
+
+    static const char * names[NPhases] = {
+        "update_state", "events_run", "run_globalevents", "rewire",
+        "record", "mutate_virus"
+    };
+
+    return names[phase];
+
+}
+
+inline const char * Profiler::counter_name(Counter counter)
+{
+
+    static const char * names[NCounters] = {
+        "agents visited", "state_fun calls", "random draws"
+    };
+
+    return names[counter];
+
+}
+
+inline const char * Profiler::event_name(EventAction action)
+{
+
+    static const char * names[NEventActions] = {
+        "add virus", "add tool", "add entity", "remove virus",
+        "remove tool", "remove entity", "change state"
+    };
+
+    return names[static_cast< size_t >(action)];
+
+}
+
+inline void Profiler::print() const
+{
+
+    printf_epiworld("Time per phase (ms):\n");
+    for (size_t i = 0u; i < NPhases; ++i)
+    {
+        printf_epiworld(
+            "  %-20s: %.3f\n",
+            phase_name(static_cast< Phase >(i)), times[i] / 1000.0
+        );
+    }
+
+    printf_epiworld("Counters:\n");
+    for (size_t i = 0u; i < NCounters; ++i)
+    {
+        printf_epiworld(
+            "  %-20s: %llu\n",
+            counter_name(static_cast< Counter >(i)),
+            static_cast< unsigned long long >(counters[i])
+        );
+    }
+
+    printf_epiworld("Events:\n");
+    for (size_t i = 0u; i < NEventActions; ++i)
+    {
+        printf_epiworld(
+            "  %-20s: %llu\n",
+            event_name(static_cast< EventAction >(i)),
+            static_cast< unsigned long long >(events[i])
+        );
+    }
+
+}
+
+#endif
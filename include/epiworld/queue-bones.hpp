@@ -28,6 +28,20 @@ private:
     Model<TSeq> * model = nullptr;
     int n_in_queue = 0;
 
+    /**
+     * @brief Worklist of agents that may be in the queue
+     * @details Agents are added (once, as tracked by `in_list`) when their
+     * counter is increased or accessed through `operator[]`, and are
+     * removed lazily by `get_active_agents()` once their counter is back
+     * to zero. This way, iterating over the queue costs as much as the
+     * number of active agents, not the size of the population.
+     */
+    ///@{
+    std::vector< size_t > active_list;
+    std::vector< bool > in_list;
+    void touch(size_t i);
+    ///@}
+
     // Auxiliary variable that checks how many steps
     // left are there
     // int n_steps_left;
@@ -39,6 +53,26 @@ public:
     void operator-=(Agent<TSeq> * p);
     epiworld_fast_int & operator[](epiworld_fast_uint i);
 
+    /**
+     * @brief Reads the counter of agent `i` without adding it to the
+     * worklist.
+     */
+    epiworld_fast_int operator[](epiworld_fast_uint i) const;
+
+    /**
+     * @brief Number of agents in the worklist, including those that left
+     * the queue since the last call to `get_active_agents()`.
+     */
+    size_t get_worklist_size() const {return active_list.size();};
+
+    /**
+     * @brief Ids of the agents in the queue, in ascending order
+     * @details Compacts the worklist before returning it. Iterating in
+     * ascending order keeps the draws from the random number generator
+     * in the same order as looping over the entire population.
+     */
+    const std::vector< size_t > & get_active_agents();
+
     // void initialize(Model<TSeq> * m, Agent<TSeq> * p);
     void reset();
 
@@ -51,6 +85,18 @@ public:
 
 };
 
+template<typename TSeq>
+inline void Queue<TSeq>::touch(size_t i)
+{
+
+    if (!in_list[i])
+    {
+        in_list[i] = true;
+        active_list.push_back(i);
+    }
+
+}
+
 template<typename TSeq>
 inline void Queue<TSeq>::operator+=(Agent<TSeq> * p)
 {
@@ -58,15 +104,22 @@ inline void Queue<TSeq>::operator+=(Agent<TSeq> * p)
     if (++active[p->id] == 1)
         n_in_queue++;
 
+    touch(p->id);
+
     if (p->get_n_neighbors() == 0u)
         return; // No neighbors, no need to add them
 
-    for (auto n : (*p->neighbors))
+    const epiworld_agent_index * neighbors = model->network->neighbors(p->id);
+    for (size_t i = 0u; i < p->n_neighbors; ++i)
     {
 
+        size_t n = neighbors[i];
+
         if (++active[n] == 1)
             n_in_queue++;
 
+        touch(n);
+
     }
 
 }
@@ -81,8 +134,12 @@ inline void Queue<TSeq>::operator-=(Agent<TSeq> * p)
     if (p->get_n_neighbors() == 0u)
         return; // No neighbors, no need to add them
 
-    for (auto n : (*p->neighbors))
+    const epiworld_agent_index * neighbors = model->network->neighbors(p->id);
+    for (size_t i = 0u; i < p->n_neighbors; ++i)
     {
+
+        size_t n = neighbors[i];
+
         if (--active[n] == 0)
             n_in_queue--;
     }
@@ -91,10 +148,58 @@ inline void Queue<TSeq>::operator-=(Agent<TSeq> * p)
 
 template<typename TSeq>
 inline epiworld_fast_int & Queue<TSeq>::operator[](epiworld_fast_uint i)
+{
+    // The counter may be modified through the reference
+    touch(i);
+    return active[i];
+}
+
+template<typename TSeq>
+inline epiworld_fast_int Queue<TSeq>::operator[](epiworld_fast_uint i) const
 {
     return active[i];
 }
 
+template<typename TSeq>
+inline const std::vector< size_t > & Queue<TSeq>::get_active_agents()
+{
+
+    if ((active_list.size() * 4u) > active.size())
+    {
+
+        // Dense queue: a single pass over the counters returns
+        // the agents already sorted
+        active_list.clear();
+        for (size_t i = 0u; i < active.size(); ++i)
+        {
+            in_list[i] = active[i] > 0;
+            if (in_list[i])
+                active_list.push_back(i);
+        }
+
+    }
+    else
+    {
+
+        // Sparse queue: dropping the agents that left the queue
+        size_t n = 0u;
+        for (auto i : active_list)
+        {
+            if (active[i] > 0)
+                active_list[n++] = i;
+            else
+                in_list[i] = false;
+        }
+
+        active_list.resize(n);
+        std::sort(active_list.begin(), active_list.end());
+
+    }
+
+    return active_list;
+
+}
+
 template<typename TSeq>
 inline void Queue<TSeq>::reset()
 {
@@ -111,6 +216,13 @@ inline void Queue<TSeq>::reset()
 
     active.resize(model->size(), 0);
 
+    // Rebuilding the worklist from the counters that were kept
+    active_list.clear();
+    in_list.assign(active.size(), false);
+    for (size_t i = 0u; i < active.size(); ++i)
+        if (active[i] > 0)
+            touch(i);
+
 }
 
 template<typename TSeq>
@@ -50,6 +50,21 @@ public:
         s[3] = splitmix64(seed_val);
     }
 
+    /**
+     * @brief Copies the 256-bit state from/to `x` (e.g., for checkpoints)
+     */
+    ///@{
+    void get_state(uint64_t x[4]) const noexcept {
+        for (int i = 0; i < 4; ++i)
+            x[i] = s[i];
+    }
+
+    void set_state(const uint64_t x[4]) noexcept {
+        for (int i = 0; i < 4; ++i)
+            s[i] = x[i];
+    }
+    ///@}
+
     result_type operator()() noexcept {
         const uint64_t result = rotl(s[1] * 5, 7) * 9;
         const uint64_t t = s[1] << 17;
@@ -61,32 +76,317 @@ public:
         s[3] = rotl(s[3], 45);
         return result;
     }
+
+    /**
+     * @brief Advances the state by 2^128 draws
+     * @details Used to split the sequence into non-overlapping streams
+     * (see `epi_xoshiro256ss_lanes`).
+     */
+    void jump() noexcept {
+
+        static constexpr uint64_t JUMP[4] = {
+            0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+            0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+        };
+
+        uint64_t j[4] = {0u, 0u, 0u, 0u};
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int b = 0; b < 64; ++b)
+            {
+                if (JUMP[i] & (uint64_t(1) << b))
+                    for (int k = 0; k < 4; ++k)
+                        j[k] ^= s[k];
+
+                (*this)();
+            }
+        }
+
+        set_state(j);
+
+    }
 };
 
 /**
- * @brief Draw a uniform [0, 1) random number from an epi_xoshiro256ss engine.
- *
- * Uses the top N bits of the 64-bit output (where N =
- * std::numeric_limits<epiworld_double>::digits) to produce a value in [0, 1)
- * without any long-double arithmetic.
+ * @brief Draw a uniform [0, 1) number from 64 random bits.
  *
- * @param engine An epi_xoshiro256ss engine.
- * @return epiworld_double in [0, 1).
+ * Uses the top N bits (where N = std::numeric_limits<epiworld_double>::digits)
+ * to produce a value in [0, 1) without any long-double arithmetic.
  */
-inline epiworld_double runif_epi(epi_xoshiro256ss & engine) {
+inline epiworld_double runif_from_bits(uint64_t x) noexcept {
     static_assert(
         std::numeric_limits<epiworld_double>::digits < 64,
         "epiworld_double must have fewer than 64 mantissa bits; "
-        "the bit-extraction in runif_epi requires digits < 64 to avoid "
+        "the bit-extraction in runif_from_bits requires digits < 64 to avoid "
         "undefined behaviour in the shift and scale computation"
     );
-    
+
     constexpr int bits  = std::numeric_limits<epiworld_double>::digits;
     constexpr int shift = 64 - bits;
     // scale = 2^{-bits}: the result is in [0, 1) by construction (no clamp needed)
     constexpr epiworld_double scale =
         epiworld_double(1) / epiworld_double(uint64_t(1) << bits);
-    return static_cast<epiworld_double>(engine() >> shift) * scale;
+    // Going through a 32-bit integer when possible, which converts to
+    // floating point with a single (vector) instruction
+    if constexpr (bits < 32)
+        return static_cast<epiworld_double>(
+            static_cast<int32_t>(x >> shift)
+        ) * scale;
+    else
+        return static_cast<epiworld_double>(
+            static_cast<int64_t>(x >> shift)
+        ) * scale;
+}
+
+/**
+ * @brief `L` interleaved xoshiro256** generators that fill blocks of numbers.
+ *
+ * Lane `l` starts `l` jumps (2^128 draws) ahead of an `epi_xoshiro256ss`
+ * seeded with the same value, so lanes never overlap. The state is stored
+ * by word (`s[word][lane]`), so each step updates the `L` lanes with the
+ * same operations and compilers vectorize the loop (e.g., AVX2 with
+ * `L = 4`, AVX-512 with `L = 8`).
+ *
+ * Block `k` holds the `k`-th output of every lane, so the sequence is
+ * reproducible for a fixed `L` but differs across values of `L`.
+ *
+ * @tparam L Number of lanes.
+ */
+template<size_t L = 4u>
+class epi_xoshiro256ss_lanes {
+    alignas(64) uint64_t s[4][L];
+
+public:
+    static constexpr size_t lanes = L;
+
+    explicit epi_xoshiro256ss_lanes(uint64_t seed_val = 0) noexcept {
+        seed(seed_val);
+    }
+
+    void seed(uint64_t seed_val) noexcept {
+
+        epi_xoshiro256ss eng(seed_val);
+        uint64_t x[4];
+        for (size_t l = 0u; l < L; ++l)
+        {
+            eng.get_state(x);
+            for (int w = 0; w < 4; ++w)
+                s[w][l] = x[w];
+
+            eng.jump();
+        }
+
+    }
+
+    /**
+     * @brief Copies the `4 * L` words of state from/to `x` (lane-major within
+     * each word, as stored).
+     */
+    ///@{
+    void get_state(uint64_t * x) const noexcept {
+        for (int w = 0; w < 4; ++w)
+            for (size_t l = 0u; l < L; ++l)
+                x[w * L + l] = s[w][l];
+    }
+
+    void set_state(const uint64_t * x) noexcept {
+        for (int w = 0; w < 4; ++w)
+            for (size_t l = 0u; l < L; ++l)
+                s[w][l] = x[w * L + l];
+    }
+    ///@}
+
+    /**
+     * @brief Writes `nblocks` blocks of `L` numbers to `out`
+     * @param out Array of at least `nblocks * L` elements.
+     * @param nblocks Number of blocks.
+     * @param conv Conversion applied to each 64-bit output.
+     */
+    template<typename T, typename TConv>
+    void fill(T * out, size_t nblocks, TConv conv) noexcept {
+
+        // Working on local copies lets the compiler keep the state in
+        // (vector) registers across blocks
+        alignas(64) uint64_t s0[L], s1[L], s2[L], s3[L], res[L];
+        for (size_t l = 0u; l < L; ++l)
+        {
+            s0[l] = s[0][l];
+            s1[l] = s[1][l];
+            s2[l] = s[2][l];
+            s3[l] = s[3][l];
+        }
+
+        for (size_t k = 0u; k < nblocks; ++k, out += L)
+        {
+
+            // Same as epi_xoshiro256ss::operator(); the multiplications by
+            // 5 and 9 are written as shifts so they vectorize without a
+            // 64-bit vector multiply.
+            for (size_t l = 0u; l < L; ++l)
+            {
+                const uint64_t r = (s1[l] << 2) + s1[l];
+                const uint64_t x = (r << 7) | (r >> 57);
+                res[l] = (x << 3) + x;
+
+                const uint64_t t = s1[l] << 17;
+                s2[l] ^= s0[l];
+                s3[l] ^= s1[l];
+                s1[l] ^= s2[l];
+                s0[l] ^= s3[l];
+                s2[l] ^= t;
+                s3[l] = (s3[l] << 45) | (s3[l] >> 19);
+            }
+
+            for (size_t l = 0u; l < L; ++l)
+                out[l] = conv(res[l]);
+
+        }
+
+        for (size_t l = 0u; l < L; ++l)
+        {
+            s[0][l] = s0[l];
+            s[1][l] = s1[l];
+            s[2][l] = s2[l];
+            s[3][l] = s3[l];
+        }
+
+    }
+
+    void fill(uint64_t * out, size_t nblocks) noexcept {
+        fill(out, nblocks, [](uint64_t x) noexcept { return x; });
+    }
+
+    /**
+     * @brief Writes `nblocks` blocks of `L` uniform [0, 1) numbers to `out`
+     * (see `runif_from_bits()`).
+     */
+    void fill_unif(epiworld_double * out, size_t nblocks) noexcept {
+        fill(out, nblocks, [](uint64_t x) noexcept { return runif_from_bits(x); });
+    }
+
+};
+
+/**
+ * @brief Counter-based 64-bit PRNG based on the Philox4x32-10 algorithm.
+ *
+ * The output is a pure function of a 64-bit key and a 128-bit counter, so
+ * any stream can be generated independently of every other (e.g., in a
+ * different thread) without carrying state around. The counter is split in
+ * three parts: a 64-bit stream id (e.g., the agent), a 32-bit sub-stream id
+ * (e.g., the day), and a 32-bit block index that advances as numbers are
+ * drawn. Each block yields two 64-bit numbers.
+ *
+ * Reference: Salmon, Moraes, Dror & Shaw, "Parallel Random Numbers: As
+ * Easy as 1, 2, 3", SC'11. https://www.deshawresearch.com/resources_random123.html
+ */
+class epi_philox4x32 {
+    uint32_t key[2]   = {0u, 0u};
+    uint32_t ctr[4]   = {0u, 0u, 0u, 0u};
+    uint32_t block[4] = {0u, 0u, 0u, 0u};
+    int used = 2; ///< Number of 64-bit words of `block` already returned.
+
+    static constexpr uint32_t M0 = 0xD2511F53u;
+    static constexpr uint32_t M1 = 0xCD9E8D57u;
+    static constexpr uint32_t W0 = 0x9E3779B9u;
+    static constexpr uint32_t W1 = 0xBB67AE85u;
+
+    void generate() noexcept {
+
+        uint32_t c[4] = {ctr[0], ctr[1], ctr[2], ctr[3]};
+        uint32_t k0 = key[0];
+        uint32_t k1 = key[1];
+
+        for (int r = 0; r < 10; ++r)
+        {
+            const uint64_t p0 = static_cast<uint64_t>(M0) * c[0];
+            const uint64_t p1 = static_cast<uint64_t>(M1) * c[2];
+
+            c[0] = static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k0;
+            c[1] = static_cast<uint32_t>(p1);
+            c[2] = static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k1;
+            c[3] = static_cast<uint32_t>(p0);
+
+            k0 += W0;
+            k1 += W1;
+        }
+
+        for (int i = 0; i < 4; ++i)
+            block[i] = c[i];
+
+        ++ctr[0];
+        used = 0;
+
+    }
+
+public:
+    using result_type = uint64_t;
+
+    explicit epi_philox4x32(uint64_t key_val = 0) noexcept {
+        seed(key_val);
+    }
+
+    static constexpr result_type min() noexcept { return 0; }
+    static constexpr result_type max() noexcept {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    /**
+     * @brief Sets the key and moves to the beginning of stream 0.
+     */
+    void seed(uint64_t key_val) noexcept {
+        key[0] = static_cast<uint32_t>(key_val);
+        key[1] = static_cast<uint32_t>(key_val >> 32);
+        set_stream(0u);
+    }
+
+    /**
+     * @brief Moves to the beginning of a stream (the key is kept).
+     * @param stream Stream id (e.g., agent id).
+     * @param substream Sub-stream id (e.g., day).
+     */
+    void set_stream(uint64_t stream, uint32_t substream = 0u) noexcept {
+        ctr[0] = 0u;
+        ctr[1] = substream;
+        ctr[2] = static_cast<uint32_t>(stream);
+        ctr[3] = static_cast<uint32_t>(stream >> 32);
+        used = 2;
+    }
+
+    /**
+     * @brief Raw 128-bit block for the current counter (used for testing).
+     */
+    const uint32_t * next_block() noexcept {
+        generate();
+        used = 2;
+        return block;
+    }
+
+    result_type operator()() noexcept {
+
+        if (used == 2)
+            generate();
+
+        const int i = 2 * (used++);
+        return (static_cast<uint64_t>(block[i]) << 32) | block[i + 1];
+
+    }
+};
+
+/**
+ * @brief Draw a uniform [0, 1) random number from a 64-bit engine
+ * (`epi_xoshiro256ss` or `epi_philox4x32`). See `runif_from_bits()`.
+ *
+ * @param engine An epi_xoshiro256ss or epi_philox4x32 engine.
+ * @return epiworld_double in [0, 1).
+ */
+template<typename TEngine>
+inline epiworld_double runif_epi(TEngine & engine) {
+    static_assert(
+        TEngine::max() == std::numeric_limits<uint64_t>::max(),
+        "runif_epi requires an engine with 64-bit output"
+    );
+
+    return runif_from_bits(engine());
 }
 
 /**
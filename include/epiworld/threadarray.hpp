@@ -0,0 +1,59 @@
+#ifndef EPIWORLD_THREADARRAY_HPP
+#define EPIWORLD_THREADARRAY_HPP
+
+/**
+ * @brief Fixed-size scratch array with one copy per thread
+ *
+ * @details Behaves like `std::array<T,N>` (only `operator[]` and `size()`
+ * are provided). By default there is a single copy. Once `split()` is on,
+ * every OpenMP thread indexes its own copy, so update functions running
+ * in parallel (see `Model<TSeq>::parallel_update_on()`) can use the
+ * model's temporary arrays without stepping on each other.
+ *
+ * @tparam T Type of the elements.
+ * @tparam N Number of elements.
+ */
+template<typename T, size_t N>
+class ThreadArray {
+private:
+    std::vector< std::array< T, N > > data = std::vector< std::array< T, N > >(1u);
+    bool splitted = false;
+
+public:
+
+    T & operator[](size_t i)
+    {
+        #ifdef _OPENMP
+        if (splitted)
+            return data[omp_get_thread_num()][i];
+        #endif
+        return data[0u][i];
+    }
+
+    const T & operator[](size_t i) const
+    {
+        #ifdef _OPENMP
+        if (splitted)
+            return data[omp_get_thread_num()][i];
+        #endif
+        return data[0u][i];
+    }
+
+    constexpr size_t size() const noexcept { return N; }
+
+    /**
+     * @brief Turns the per-thread copies on or off
+     * @param nthreads Number of copies to keep (ignored when `value` is
+     * false).
+     */
+    void split(bool value, size_t nthreads = 1u)
+    {
+        if (value && (data.size() < nthreads))
+            data.resize(nthreads);
+
+        splitted = value;
+    }
+
+};
+
+#endif
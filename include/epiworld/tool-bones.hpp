@@ -24,28 +24,62 @@ class Tool {
     friend class Model<TSeq>;
 protected:
 
+    /**
+     * @brief Fields shared by the copies of a tool
+     * @details Every agent holding the tool gets its own copy, but the name,
+     * functions, states, and queues are the same across them, so copies
+     * share a single `Definition`. Setters detach it first (copy-on-write).
+     */
+    struct Definition {
+
+        std::string tool_name;
+
+        ToolFun<TSeq> susceptibility_reduction = nullptr;
+        ToolFun<TSeq> transmission_reduction   = nullptr;
+        ToolFun<TSeq> recovery_enhancer        = nullptr;
+        ToolFun<TSeq> death_reduction          = nullptr;
+
+        ToolToAgentFun<TSeq> dist = nullptr;
+
+        epiworld_fast_int state_init = -99;
+        epiworld_fast_int state_post = -99;
+
+        epiworld_fast_int queue_init = Queue<TSeq>::NoOne; ///< Change of state when added to agent.
+        epiworld_fast_int queue_post = Queue<TSeq>::NoOne; ///< Change of state when removed from agent.
+
+        /**
+         * @brief Effects known to be constant
+         * @details Bit `k` of `fixed_mask` is on when the k-th effect
+         * (susceptibility, transmission, recovery, death) does not depend on
+         * the virus or the day, in which case its value is `fixed_value[k]`.
+         * Agents use these to cache the product of their tools' effects (see
+         * `Agent<TSeq>::tools_effects_update()`).
+         */
+        ///@{
+        unsigned char fixed_mask = 0x0Fu;
+        epiworld_double fixed_value[4u] = {
+            DEFAULT_TOOL_CONTAGION_REDUCTION,
+            DEFAULT_TOOL_TRANSMISSION_REDUCTION,
+            DEFAULT_TOOL_RECOVERY_ENHANCER,
+            DEFAULT_TOOL_DEATH_REDUCTION
+        };
+        ///@}
+
+    };
+
+    // Per-agent data
     Agent<TSeq> * agent = nullptr;
     int pos_in_agent        = -99; ///< Location in the agent
 
     int date = -99;
     int id   = -99;
-    std::string tool_name;
     
     EPI_TYPENAME_TRAITS(TSeq, int) sequence = 
         EPI_TYPENAME_TRAITS(TSeq, int)(); ///< Sequence of the tool
 
-    ToolFun<TSeq> susceptibility_reduction = nullptr;
-    ToolFun<TSeq> transmission_reduction   = nullptr;
-    ToolFun<TSeq> recovery_enhancer        = nullptr;
-    ToolFun<TSeq> death_reduction          = nullptr;
-
-    ToolToAgentFun<TSeq> dist = nullptr;
-
-    epiworld_fast_int state_init = -99;
-    epiworld_fast_int state_post = -99;
-
-    epiworld_fast_int queue_init = Queue<TSeq>::NoOne; ///< Change of state when added to agent.
-    epiworld_fast_int queue_post = Queue<TSeq>::NoOne; ///< Change of state when removed from agent.
+    std::shared_ptr< Definition > def = std::make_shared< Definition >();
+    Definition & def_mut(); ///< Definition to modify (detached if shared).
+    void set_fixed_effect(size_t k, bool fixed, epiworld_double value);
 
     void set_agent(Agent<TSeq> * p, size_t idx);
 
@@ -176,7 +176,7 @@ inline ToolToAgentFun<TSeq> distribute_tool_to_entities(
             if (n_to_distribute > n)
                 n_to_distribute = n;
 
-            std::vector< size_t > idx = agent_ids;
+            std::vector< epiworld_agent_index > idx = agent_ids;
             for (size_t i = 0u; i < n_to_distribute; ++i)
             {
                 size_t loc = model->runif_index(n--);
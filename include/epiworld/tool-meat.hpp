@@ -161,8 +161,8 @@ inline epiworld_double Tool<TSeq>::get_susceptibility_reduction(
 )
 {
 
-    if (susceptibility_reduction)
-        return susceptibility_reduction(
+    if (def->susceptibility_reduction)
+        return def->susceptibility_reduction(
             *this, this->agent, v, model
         );
 
@@ -177,8 +177,8 @@ inline epiworld_double Tool<TSeq>::get_transmission_reduction(
 )
 {
 
-    if (transmission_reduction)
-        return transmission_reduction(
+    if (def->transmission_reduction)
+        return def->transmission_reduction(
             *this, this->agent, v, model
         );
 
@@ -193,8 +193,8 @@ inline epiworld_double Tool<TSeq>::get_recovery_enhancer(
 )
 {
 
-    if (recovery_enhancer)
-        return recovery_enhancer(*this, this->agent, v, model);
+    if (def->recovery_enhancer)
+        return def->recovery_enhancer(*this, this->agent, v, model);
 
     return DEFAULT_TOOL_RECOVERY_ENHANCER;
 
@@ -207,8 +207,8 @@ inline epiworld_double Tool<TSeq>::get_death_reduction(
 )
 {
 
-    if (death_reduction)
-        return death_reduction(*this, this->agent, v, model);
+    if (def->death_reduction)
+        return def->death_reduction(*this, this->agent, v, model);
 
     return DEFAULT_TOOL_DEATH_REDUCTION;
 
@@ -219,7 +219,8 @@ inline void Tool<TSeq>::set_susceptibility_reduction_fun(
     ToolFun<TSeq> fun
 )
 {
-    susceptibility_reduction = fun;
+    def_mut().susceptibility_reduction = fun;
+    set_fixed_effect(0u, fun == nullptr, DEFAULT_TOOL_CONTAGION_REDUCTION);
 }
 
 template<typename TSeq>
@@ -227,7 +228,8 @@ inline void Tool<TSeq>::set_transmission_reduction_fun(
     ToolFun<TSeq> fun
 )
 {
-    transmission_reduction = fun;
+    def_mut().transmission_reduction = fun;
+    set_fixed_effect(1u, fun == nullptr, DEFAULT_TOOL_TRANSMISSION_REDUCTION);
 }
 
 template<typename TSeq>
@@ -235,7 +237,8 @@ inline void Tool<TSeq>::set_recovery_enhancer_fun(
     ToolFun<TSeq> fun
 )
 {
-    recovery_enhancer = fun;
+    def_mut().recovery_enhancer = fun;
+    set_fixed_effect(2u, fun == nullptr, DEFAULT_TOOL_RECOVERY_ENHANCER);
 }
 
 template<typename TSeq>
@@ -243,22 +246,24 @@ inline void Tool<TSeq>::set_death_reduction_fun(
     ToolFun<TSeq> fun
 )
 {
-    death_reduction = fun;
+    def_mut().death_reduction = fun;
+    set_fixed_effect(3u, fun == nullptr, DEFAULT_TOOL_DEATH_REDUCTION);
 }
 
 template<typename TSeq>
 inline void Tool<TSeq>::set_susceptibility_reduction(std::string param)
 {
 
-    auto parname_ptr = std::make_shared<const std::string>(param);
+    const size_t param_id = Model<TSeq>::param_id(param);
 
     ToolFun<TSeq> tmpfun =
-        [parname_ptr](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
+        [param_id](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
         {
-            return model->get_param(*parname_ptr);
+            return model->par(param_id);
         };
 
-    susceptibility_reduction = tmpfun;
+    def_mut().susceptibility_reduction = tmpfun;
+    set_fixed_effect(0u, false, 0.0);
 
 }
 
@@ -267,15 +272,16 @@ template<typename TSeq>
 inline void Tool<TSeq>::set_transmission_reduction(std::string param)
 {
 
-    auto parname_ptr = std::make_shared<const std::string>(param);
+    const size_t param_id = Model<TSeq>::param_id(param);
     
     ToolFun<TSeq> tmpfun =
-        [parname_ptr](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
+        [param_id](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
         {
-            return model->get_param(*parname_ptr);
+            return model->par(param_id);
         };
 
-    transmission_reduction = tmpfun;
+    def_mut().transmission_reduction = tmpfun;
+    set_fixed_effect(1u, false, 0.0);
 
 }
 
@@ -284,15 +290,16 @@ template<typename TSeq>
 inline void Tool<TSeq>::set_recovery_enhancer(std::string param)
 {
 
-    auto parname_ptr = std::make_shared<const std::string>(param);
+    const size_t param_id = Model<TSeq>::param_id(param);
 
     ToolFun<TSeq> tmpfun =
-        [parname_ptr](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
+        [param_id](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
         {
-            return model->get_param(*parname_ptr);
+            return model->par(param_id);
         };
 
-    recovery_enhancer = tmpfun;
+    def_mut().recovery_enhancer = tmpfun;
+    set_fixed_effect(2u, false, 0.0);
 
 }
 
@@ -301,15 +308,16 @@ template<typename TSeq>
 inline void Tool<TSeq>::set_death_reduction(std::string param)
 {
 
-    auto parname_ptr = std::make_shared<const std::string>(param);
+    const size_t param_id = Model<TSeq>::param_id(param);
 
     ToolFun<TSeq> tmpfun =
-        [parname_ptr](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
+        [param_id](Tool<TSeq> &, Agent<TSeq> *, VirusPtr<TSeq>&, Model<TSeq>* model)
         {
-            return model->get_param(*parname_ptr);
+            return model->par(param_id);
         };
 
-    death_reduction = tmpfun;
+    def_mut().death_reduction = tmpfun;
+    set_fixed_effect(3u, false, 0.0);
 
 }
 
@@ -328,7 +336,8 @@ inline void Tool<TSeq>::set_susceptibility_reduction(
             return prob;
         };
 
-    susceptibility_reduction = tmpfun;
+    def_mut().susceptibility_reduction = tmpfun;
+    set_fixed_effect(0u, true, prob);
 
 }
 
@@ -344,7 +353,8 @@ inline void Tool<TSeq>::set_transmission_reduction(
             return prob;
         };
 
-    transmission_reduction = tmpfun;
+    def_mut().transmission_reduction = tmpfun;
+    set_fixed_effect(1u, true, prob);
 
 }
 
@@ -360,7 +370,8 @@ inline void Tool<TSeq>::set_recovery_enhancer(
             return prob;
         };
 
-    recovery_enhancer = tmpfun;
+    def_mut().recovery_enhancer = tmpfun;
+    set_fixed_effect(2u, true, prob);
 
 }
 
@@ -376,20 +387,56 @@ inline void Tool<TSeq>::set_death_reduction(
             return prob;
         };
 
-    death_reduction = tmpfun;
+    def_mut().death_reduction = tmpfun;
+    set_fixed_effect(3u, true, prob);
+
+}
+
+template<typename TSeq>
+inline typename Tool<TSeq>::Definition & Tool<TSeq>::def_mut()
+{
+
+    // Copy-on-write: other copies of the tool keep the current definition
+    if (def.use_count() > 1)
+        def = std::make_shared<Definition>(*def);
+
+    return *def;
+
+}
+
+template<typename TSeq>
+inline void Tool<TSeq>::set_fixed_effect(
+    size_t k,
+    bool fixed,
+    epiworld_double value
+)
+{
+
+    Definition & d = def_mut();
+    if (fixed)
+    {
+        d.fixed_mask |= static_cast<unsigned char>(1u << k);
+        d.fixed_value[k] = value;
+    }
+    else
+        d.fixed_mask &= static_cast<unsigned char>(~(1u << k));
+
+    // Already in an agent, so its cache is stale
+    if (agent != nullptr)
+        agent->tools_effects_update();
 
 }
 
 template<typename TSeq>
 inline void Tool<TSeq>::set_name(std::string name)
 {
-    tool_name = name;
+    def_mut().tool_name = name;
 }
 
 template<typename TSeq>
 inline std::string Tool<TSeq>::get_name() const {
 
-    return tool_name;
+    return def->tool_name;
 
 }
 
@@ -436,8 +483,8 @@ inline void Tool<TSeq>::set_state(
     epiworld_fast_int end
 )
 {
-    state_init = init;
-    state_post = end;
+    def_mut().state_init = init;
+    def_mut().state_post = end;
 }
 
 template<typename TSeq>
@@ -446,8 +493,8 @@ inline void Tool<TSeq>::set_queue(
     epiworld_fast_int end
 )
 {
-    queue_init = init;
-    queue_post = end;
+    def_mut().queue_init = init;
+    def_mut().queue_post = end;
 }
 
 template<typename TSeq>
@@ -457,10 +504,10 @@ inline void Tool<TSeq>::get_state(
 )
 {
     if (init != nullptr)
-        *init = state_init;
+        *init = def->state_init;
 
     if (post != nullptr)
-        *post = state_post;
+        *post = def->state_post;
 
 }
 
@@ -471,10 +518,10 @@ inline void Tool<TSeq>::get_queue(
 )
 {
     if (init != nullptr)
-        *init = queue_init;
+        *init = def->queue_init;
 
     if (post != nullptr)
-        *post = queue_post;
+        *post = def->queue_post;
 
 }
 
@@ -493,19 +540,19 @@ inline bool Tool<std::vector<int>>::operator==(
             return false;
     }
 
-    if (tool_name != other.tool_name)
+    if (def->tool_name != other.def->tool_name)
         return false;
     
-    if (state_init != other.state_init)
+    if (def->state_init != other.def->state_init)
         return false;
 
-    if (state_post != other.state_post)
+    if (def->state_post != other.def->state_post)
         return false;
 
-    if (queue_init != other.queue_init)
+    if (def->queue_init != other.def->queue_init)
         return false;
 
-    if (queue_post != other.queue_post)
+    if (def->queue_post != other.def->queue_post)
         return false;
 
 
@@ -528,19 +575,19 @@ inline bool Tool<TSeq>::operator==(const Tool<TSeq> & other) const
     }
 
 
-    if (tool_name != other.tool_name)
+    if (def->tool_name != other.def->tool_name)
         return false;
     
-    if (state_init != other.state_init)
+    if (def->state_init != other.def->state_init)
         return false;
 
-    if (state_post != other.state_post)
+    if (def->state_post != other.def->state_post)
         return false;
 
-    if (queue_init != other.queue_init)
+    if (def->queue_init != other.def->queue_init)
         return false;
 
-    if (queue_post != other.queue_post)
+    if (def->queue_post != other.def->queue_post)
         return false;
 
     return true;
@@ -554,10 +601,10 @@ inline void Tool<TSeq>::print() const
 
     printf_epiworld("Tool       : %s\n", this->get_name().c_str());
     printf_epiworld("Id         : %s\n", (id < 0)? std::string("(empty)").c_str() : std::to_string(id).c_str());
-    printf_epiworld("state_init : %i\n", static_cast<int>(state_init));
-    printf_epiworld("state_post : %i\n", static_cast<int>(state_post));
-    printf_epiworld("queue_init : %i\n", static_cast<int>(queue_init));
-    printf_epiworld("queue_post : %i\n", static_cast<int>(queue_post));
+    printf_epiworld("state_init : %i\n", static_cast<int>(def->state_init));
+    printf_epiworld("state_post : %i\n", static_cast<int>(def->state_post));
+    printf_epiworld("queue_init : %i\n", static_cast<int>(def->queue_init));
+    printf_epiworld("queue_post : %i\n", static_cast<int>(def->queue_post));
 
 }
 
@@ -565,10 +612,10 @@ template<typename TSeq>
 inline void Tool<TSeq>::distribute(Model<TSeq> * model)
 {
 
-    if (dist)
+    if (def->dist)
     {
 
-        dist(*this, model);
+        def->dist(*this, model);
 
     }
 
@@ -577,7 +624,7 @@ inline void Tool<TSeq>::distribute(Model<TSeq> * model)
 template<typename TSeq>
 inline void Tool<TSeq>::set_distribution(ToolToAgentFun<TSeq> fun)
 {
-    dist = fun;
+    def_mut().dist = fun;
 }
 
 template<typename TSeq>
@@ -27,31 +27,48 @@ class Virus {
     friend class DataBase<TSeq>;
 private:
     
+    /**
+     * @brief Fields shared by the copies of a virus
+     * @details Agents carry their own copy of the virus, but the name,
+     * states, queues, and functions are the same for every carrier, so
+     * copies share a single `Strain`. Setters detach it first
+     * (copy-on-write), so copying a virus is cheap and only viruses that are
+     * modified after the copy (e.g., by a mutation) own a new strain.
+     */
+    struct Strain {
+
+        std::string virus_name = "unknown virus";
+        epiworld_fast_int state_init    = -99; ///< Change of state when added to agent.
+        epiworld_fast_int state_post    = -99; ///< Change of state when removed from agent.
+        epiworld_fast_int state_removed = -99; ///< Change of state when agent is removed
+
+        epiworld_fast_int queue_init    = Queue<TSeq>::Everyone; ///< Change of state when added to agent.
+        epiworld_fast_int queue_post    = -Queue<TSeq>::Everyone; ///< Change of state when removed from agent.
+        epiworld_fast_int queue_removed = -Queue<TSeq>::Everyone; ///< Change of state when agent is removed
+
+        MutFun<TSeq>          mutation                 = nullptr;
+        PostRecoveryFun<TSeq> post_recovery_fun        = nullptr;
+        VirusFun<TSeq>        probability_of_infecting = nullptr;
+        VirusFun<TSeq>        probability_of_recovery  = nullptr;
+        VirusFun<TSeq>        probability_of_death     = nullptr;
+        VirusFun<TSeq>        incubation               = nullptr;
+
+        // Information about how distribution works
+        VirusToAgentFun<TSeq> dist = nullptr;
+
+    };
+
+    // Per-carrier data
     Agent<TSeq> * agent = nullptr;
 
     EPI_TYPENAME_TRAITS(TSeq, int) baseline_sequence = 
         EPI_TYPENAME_TRAITS(TSeq, int)(); 
 
-    std::string virus_name = "unknown virus";
     int date = -99;
-    int id   = -99;    
-    epiworld_fast_int state_init    = -99; ///< Change of state when added to agent.
-    epiworld_fast_int state_post    = -99; ///< Change of state when removed from agent.
-    epiworld_fast_int state_removed = -99; ///< Change of state when agent is removed
-
-    epiworld_fast_int queue_init    = Queue<TSeq>::Everyone; ///< Change of state when added to agent.
-    epiworld_fast_int queue_post    = -Queue<TSeq>::Everyone; ///< Change of state when removed from agent.
-    epiworld_fast_int queue_removed = -Queue<TSeq>::Everyone; ///< Change of state when agent is removed
-
-    MutFun<TSeq>          mutation                 = nullptr;
-    PostRecoveryFun<TSeq> post_recovery_fun        = nullptr;
-    VirusFun<TSeq>        probability_of_infecting = nullptr;
-    VirusFun<TSeq>        probability_of_recovery  = nullptr;
-    VirusFun<TSeq>        probability_of_death     = nullptr;
-    VirusFun<TSeq>        incubation               = nullptr;
-
-    // Information about how distribution works
-    VirusToAgentFun<TSeq> dist = nullptr;
+    int id   = -99;
+
+    std::shared_ptr< Strain > strain = std::make_shared< Strain >();
+    Strain & strain_mut(); ///< Strain to modify (detached if shared).
         
 public:
 
@@ -198,7 +198,7 @@ inline VirusToAgentFun<TSeq> distribute_virus_to_entities(
             if (n_to_distribute > n)
                 n_to_distribute = n;
 
-            std::vector< size_t > idx = agents_ids;
+            std::vector< epiworld_agent_index > idx = agents_ids;
             for (size_t i = 0u; i < n_to_distribute; ++i)
             {
                 size_t loc = model->runif_index(n--);
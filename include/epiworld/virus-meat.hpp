@@ -179,15 +179,9 @@ template<typename TSeq>
 inline Virus<TSeq>::Virus(const Virus<TSeq>& other)
     : agent(other.agent),
       baseline_sequence(other.baseline_sequence),
-      virus_name(other.virus_name),
       date(other.date),
       id(other.id),
-      state_init(other.state_init),
-      state_post(other.state_post),
-      state_removed(other.state_removed),
-      queue_init(other.queue_init),
-      queue_post(other.queue_post),
-      queue_removed(other.queue_removed)
+      strain(other.strain)
 {
     counter_copy_construct++;
 }
@@ -197,15 +191,9 @@ template<typename TSeq>
 inline Virus<TSeq>::Virus(Virus<TSeq>&& other) noexcept
     : agent(other.agent),
       baseline_sequence(std::move(other.baseline_sequence)),
-      virus_name(std::move(other.virus_name)),
       date(other.date),
       id(other.id),
-      state_init(other.state_init),
-      state_post(other.state_post),
-      state_removed(other.state_removed),
-      queue_init(other.queue_init),
-      queue_post(other.queue_post),
-      queue_removed(other.queue_removed)
+      strain(std::move(other.strain))
 {
     counter_move_construct++;
     // other.agent = nullptr;
@@ -218,15 +206,9 @@ inline Virus<TSeq>& Virus<TSeq>::operator=(const Virus<TSeq>& other)
     if (this != &other) {
         agent = other.agent;
         baseline_sequence = other.baseline_sequence;
-        virus_name = other.virus_name;
         date = other.date;
         id = other.id;
-        state_init = other.state_init;
-        state_post = other.state_post;
-        state_removed = other.state_removed;
-        queue_init = other.queue_init;
-        queue_post = other.queue_post;
-        queue_removed = other.queue_removed;
+        strain = other.strain;
         counter_copy_assign++;
     }
     return *this;
@@ -239,15 +221,9 @@ inline Virus<TSeq>& Virus<TSeq>::operator=(Virus<TSeq>&& other) noexcept
     if (this != &other) {
         agent = other.agent;
         baseline_sequence = std::move(other.baseline_sequence);
-        virus_name = std::move(other.virus_name);
         date = other.date;
         id = other.id;
-        state_init = other.state_init;
-        state_post = other.state_post;
-        state_removed = other.state_removed;
-        queue_init = other.queue_init;
-        queue_post = other.queue_post;
-        queue_removed = other.queue_removed;
+        strain = std::move(other.strain);
         other.agent = nullptr;
         counter_move_assign++;
     }
@@ -255,13 +231,25 @@ inline Virus<TSeq>& Virus<TSeq>::operator=(Virus<TSeq>&& other) noexcept
 }
 #endif
 
+template<typename TSeq>
+inline typename Virus<TSeq>::Strain & Virus<TSeq>::strain_mut()
+{
+
+    // Copy-on-write: other copies of the virus keep the current strain
+    if (strain.use_count() > 1)
+        strain = std::make_shared<Strain>(*strain);
+
+    return *strain;
+
+}
+
 template<typename TSeq>
 inline void Virus<TSeq>::mutate(
     Model<TSeq> * model
 ) {
 
-    if (mutation)
-        if (mutation(agent, *this, model))
+    if (strain->mutation)
+        if (strain->mutation(agent, *this, model))
             model->get_db().record_virus(*this);
 
     return;
@@ -272,7 +260,7 @@ template<typename TSeq>
 inline void Virus<TSeq>::set_mutation(
     MutFun<TSeq> fun
 ) {
-    mutation = MutFun<TSeq>(fun);
+    strain_mut().mutation = MutFun<TSeq>(fun);
 }
 
 template<typename TSeq>
@@ -356,8 +344,8 @@ inline epiworld_double Virus<TSeq>::get_prob_infecting(
 )
 {
 
-    if (probability_of_infecting)
-        return probability_of_infecting(agent, *this, model);
+    if (strain->probability_of_infecting)
+        return strain->probability_of_infecting(agent, *this, model);
         
     return EPI_DEFAULT_VIRUS_PROB_INFECTION;
 
@@ -371,8 +359,8 @@ inline epiworld_double Virus<TSeq>::get_prob_recovery(
 )
 {
 
-    if (probability_of_recovery)
-        return probability_of_recovery(agent, *this, model);
+    if (strain->probability_of_recovery)
+        return strain->probability_of_recovery(agent, *this, model);
         
     return EPI_DEFAULT_VIRUS_PROB_RECOVERY;
 
@@ -386,8 +374,8 @@ inline epiworld_double Virus<TSeq>::get_prob_death(
 )
 {
 
-    if (probability_of_death)
-        return probability_of_death(agent, *this, model);
+    if (strain->probability_of_death)
+        return strain->probability_of_death(agent, *this, model);
         
     return EPI_DEFAULT_VIRUS_PROB_DEATH;
 
@@ -399,8 +387,8 @@ inline epiworld_double Virus<TSeq>::get_incubation(
 )
 {
 
-    if (incubation)
-        return incubation(agent, *this, model);
+    if (strain->incubation)
+        return strain->incubation(agent, *this, model);
         
     return EPI_DEFAULT_INCUBATION_DAYS;
 
@@ -409,77 +397,77 @@ inline epiworld_double Virus<TSeq>::get_incubation(
 template<typename TSeq>
 inline void Virus<TSeq>::set_prob_infecting_fun(VirusFun<TSeq> fun)
 {
-    probability_of_infecting = fun;
+    strain_mut().probability_of_infecting = fun;
 }
 
 template<typename TSeq>
 inline void Virus<TSeq>::set_prob_recovery_fun(VirusFun<TSeq> fun)
 {
-    probability_of_recovery = fun;
+    strain_mut().probability_of_recovery = fun;
 }
 
 template<typename TSeq>
 inline void Virus<TSeq>::set_prob_death_fun(VirusFun<TSeq> fun)
 {
-    probability_of_death = fun;
+    strain_mut().probability_of_death = fun;
 }
 
 template<typename TSeq>
 inline void Virus<TSeq>::set_incubation_fun(VirusFun<TSeq> fun)
 {
-    incubation = fun;
+    strain_mut().incubation = fun;
 }
 
 template<typename TSeq>
 inline void Virus<TSeq>::set_prob_infecting(std::string param)
 {
-    auto parname_ptr = std::make_shared< const std::string >(param);
+    const size_t param_id = Model<TSeq>::param_id(param);
     VirusFun<TSeq> tmpfun = 
-        [parname_ptr](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
+        [param_id](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
         {
-            return model->get_param(*parname_ptr);
+            return model->par(param_id);
         };
     
-    probability_of_infecting = tmpfun;
+    strain_mut().probability_of_infecting = tmpfun;
 }
 
 template<typename TSeq>
 inline void Virus<TSeq>::set_prob_recovery(std::string param)
 {
-    auto parname_ptr = std::make_shared< const std::string >(param);
+    const size_t param_id = Model<TSeq>::param_id(param);
     VirusFun<TSeq> tmpfun = 
-        [parname_ptr](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
+        [param_id](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
         {
-            return model->get_param(*parname_ptr);
+            return model->par(param_id);
         };
     
-    probability_of_recovery = tmpfun;
+    strain_mut().probability_of_recovery = tmpfun;
 }
 
 template<typename TSeq>
 inline void Virus<TSeq>::set_prob_death(std::string param)
 {
-    auto parname_ptr = std::make_shared< const std::string >(param);
+    const size_t param_id = Model<TSeq>::param_id(param);
     VirusFun<TSeq> tmpfun = 
-        [parname_ptr](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
+        [param_id](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
         {
-            return model->get_param(*parname_ptr);
+            return model->par(param_id);
         };
     
-    probability_of_death = tmpfun;
+    strain_mut().probability_of_death = tmpfun;
 }
 
 template<typename TSeq>
 inline void Virus<TSeq>::set_incubation(std::string param)
 {
-    auto parname_ptr = std::make_shared< const std::string >(param);
+    const size_t param_id = Model<TSeq>::param_id(param);
     VirusFun<TSeq> tmpfun = 
-        [parname_ptr](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
+        [param_id](Agent<TSeq> *, Virus<TSeq> &, Model<TSeq> * model)
         {
-            return model->get_param(*parname_ptr);
+            return model->par(param_id);
         };
     
-    incubation = tmpfun;
+    strain_mut().incubation = tmpfun;
 }
 
 template<typename TSeq>
@@ -491,7 +479,7 @@ inline void Virus<TSeq>::set_prob_infecting(epiworld_double prob)
             return prob;
         };
     
-    probability_of_infecting = tmpfun;
+    strain_mut().probability_of_infecting = tmpfun;
 }
 
 template<typename TSeq>
@@ -503,7 +491,7 @@ inline void Virus<TSeq>::set_prob_recovery(epiworld_double prob)
             return prob;
         };
     
-    probability_of_recovery = tmpfun;
+    strain_mut().probability_of_recovery = tmpfun;
 }
 
 template<typename TSeq>
@@ -515,7 +503,7 @@ inline void Virus<TSeq>::set_prob_death(epiworld_double prob)
             return prob;
         };
     
-    probability_of_death = tmpfun;
+    strain_mut().probability_of_death = tmpfun;
 }
 
 template<typename TSeq>
@@ -527,20 +515,20 @@ inline void Virus<TSeq>::set_incubation(epiworld_double prob)
             return prob;
         };
     
-    incubation = tmpfun;
+    strain_mut().incubation = tmpfun;
 }
 
 template<typename TSeq>
 inline void Virus<TSeq>::set_post_recovery(PostRecoveryFun<TSeq> fun)
 {
-    if (post_recovery_fun)
+    if (strain->post_recovery_fun)
     {
         printf_epiworld(
             "Warning: a PostRecoveryFun is alreay in place (overwriting)."
             );
     }
 
-    post_recovery_fun = fun;
+    strain_mut().post_recovery_fun = fun;
 }
 
 template<typename TSeq>
@@ -549,8 +537,8 @@ inline void Virus<TSeq>::post_recovery(
 )
 {
 
-    if (post_recovery_fun)
-        post_recovery_fun(agent, *this, model);    
+    if (strain->post_recovery_fun)
+        strain->post_recovery_fun(agent, *this, model);    
 
     return;
         
@@ -562,7 +550,7 @@ inline void Virus<TSeq>::set_post_immunity(
 )
 {
 
-    if (post_recovery_fun)
+    if (strain->post_recovery_fun)
     {
 
         std::string msg =
@@ -579,7 +567,7 @@ inline void Virus<TSeq>::set_post_immunity(
 
     // To make sure that we keep registering the virus
     ToolPtr<TSeq> __no_reinfect = std::make_shared<Tool<TSeq>>(
-        "Immunity (" + virus_name + ")"
+        "Immunity (" + strain->virus_name + ")"
     );
 
     __no_reinfect->set_susceptibility_reduction(prob);
@@ -603,7 +591,7 @@ inline void Virus<TSeq>::set_post_immunity(
 
         };
 
-    post_recovery_fun = tmpfun;
+    strain_mut().post_recovery_fun = tmpfun;
 
 }
 
@@ -613,7 +601,7 @@ inline void Virus<TSeq>::set_post_immunity(
 )
 {
 
-    if (post_recovery_fun)
+    if (strain->post_recovery_fun)
     {
 
         std::string msg =
@@ -630,7 +618,7 @@ inline void Virus<TSeq>::set_post_immunity(
 
     // To make sure that we keep registering the virus
     ToolPtr<TSeq> __no_reinfect = std::make_shared<Tool<TSeq>>(
-        "Immunity (" + virus_name + ")"
+        "Immunity (" + strain->virus_name + ")"
     );
 
     __no_reinfect->set_susceptibility_reduction(param);
@@ -652,7 +640,7 @@ inline void Virus<TSeq>::set_post_immunity(
 
         };
 
-    post_recovery_fun = tmpfun;
+    strain_mut().post_recovery_fun = tmpfun;
 
 }
 
@@ -660,7 +648,7 @@ template<typename TSeq>
 inline void Virus<TSeq>::set_name(std::string name)
 {
 
-    virus_name = name;
+    strain_mut().virus_name = name;
 
 }
 
@@ -668,7 +656,7 @@ template<typename TSeq>
 inline std::string Virus<TSeq>::get_name() const
 {
 
-    return virus_name;
+    return strain->virus_name;
 
 }
 
@@ -679,9 +667,9 @@ inline void Virus<TSeq>::set_state(
     epiworld_fast_int removed
 )
 {
-    state_init    = init;
-    state_post    = end;
-    state_removed = removed;
+    strain_mut().state_init    = init;
+    strain_mut().state_post    = end;
+    strain_mut().state_removed = removed;
 }
 
 template<typename TSeq>
@@ -692,9 +680,9 @@ inline void Virus<TSeq>::set_queue(
 )
 {
 
-    queue_init    = init;
-    queue_post     = end;
-    queue_removed = removed;
+    strain_mut().queue_init    = init;
+    strain_mut().queue_post     = end;
+    strain_mut().queue_removed = removed;
 
 }
 
@@ -707,13 +695,13 @@ inline void Virus<TSeq>::get_state(
 {
 
     if (init != nullptr)
-        *init = state_init;
+        *init = strain->state_init;
 
     if (end != nullptr)
-        *end = state_post;
+        *end = strain->state_post;
 
     if (removed != nullptr)
-        *removed = state_removed;
+        *removed = strain->state_removed;
 
 }
 
@@ -726,13 +714,13 @@ inline void Virus<TSeq>::get_queue(
 {
 
     if (init != nullptr)
-        *init = queue_init;
+        *init = strain->queue_init;
 
     if (end != nullptr)
-        *end = queue_post;
+        *end = strain->queue_post;
 
     if (removed != nullptr)
-        *removed = queue_removed;
+        *removed = strain->queue_removed;
         
 }
 
@@ -758,37 +746,37 @@ inline bool Virus<std::vector<int>>::operator==(
     }
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        virus_name != other.virus_name,
+        strain->virus_name != other.strain->virus_name,
         "Virus:: virus_name don't match"
         )
     
     EPI_DEBUG_FAIL_AT_TRUE(
-        state_init != other.state_init,
+        strain->state_init != other.strain->state_init,
         "Virus:: state_init don't match"
         )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        state_post != other.state_post,
+        strain->state_post != other.strain->state_post,
         "Virus:: state_post don't match"
         )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        state_removed != other.state_removed,
+        strain->state_removed != other.strain->state_removed,
         "Virus:: state_removed don't match"
         )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        queue_init != other.queue_init,
+        strain->queue_init != other.strain->queue_init,
         "Virus:: queue_init don't match"
         )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        queue_post != other.queue_post,
+        strain->queue_post != other.strain->queue_post,
         "Virus:: queue_post don't match"
         )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        queue_removed != other.queue_removed,
+        strain->queue_removed != other.strain->queue_removed,
         "Virus:: queue_removed don't match"
         )
 
@@ -816,37 +804,37 @@ inline bool Virus<TSeq>::operator==(const Virus<TSeq> & other) const
     }
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        virus_name != other.virus_name,
+        strain->virus_name != other.strain->virus_name,
         "Virus:: virus_name don't match"
     )
     
     EPI_DEBUG_FAIL_AT_TRUE(
-        state_init != other.state_init,
+        strain->state_init != other.strain->state_init,
         "Virus:: state_init don't match"
     )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        state_post != other.state_post,
+        strain->state_post != other.strain->state_post,
         "Virus:: state_post don't match"
     )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        state_removed != other.state_removed,
+        strain->state_removed != other.strain->state_removed,
         "Virus:: state_removed don't match"
     )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        queue_init != other.queue_init,
+        strain->queue_init != other.strain->queue_init,
         "Virus:: queue_init don't match"
     )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        queue_post != other.queue_post,
+        strain->queue_post != other.strain->queue_post,
         "Virus:: queue_post don't match"
     )
 
     EPI_DEBUG_FAIL_AT_TRUE(
-        queue_removed != other.queue_removed,
+        strain->queue_removed != other.strain->queue_removed,
         "Virus:: queue_removed don't match"
     )
 
@@ -858,14 +846,14 @@ template<typename TSeq>
 inline void Virus<TSeq>::print() const
 {
 
-    printf_epiworld("Virus         : %s\n", virus_name.c_str());
+    printf_epiworld("Virus         : %s\n", strain->virus_name.c_str());
     printf_epiworld("Id            : %s\n", (id < 0)? std::string("(empty)").c_str() : std::to_string(id).c_str());
-    printf_epiworld("state_init    : %i\n", static_cast<int>(state_init));
-    printf_epiworld("state_post    : %i\n", static_cast<int>(state_post));
-    printf_epiworld("state_removed : %i\n", static_cast<int>(state_removed));
-    printf_epiworld("queue_init    : %i\n", static_cast<int>(queue_init));
-    printf_epiworld("queue_post    : %i\n", static_cast<int>(queue_post));
-    printf_epiworld("queue_removed : %i\n", static_cast<int>(queue_removed));
+    printf_epiworld("state_init    : %i\n", static_cast<int>(strain->state_init));
+    printf_epiworld("state_post    : %i\n", static_cast<int>(strain->state_post));
+    printf_epiworld("state_removed : %i\n", static_cast<int>(strain->state_removed));
+    printf_epiworld("queue_init    : %i\n", static_cast<int>(strain->queue_init));
+    printf_epiworld("queue_post    : %i\n", static_cast<int>(strain->queue_post));
+    printf_epiworld("queue_removed : %i\n", static_cast<int>(strain->queue_removed));
 
 }
 
@@ -873,10 +861,10 @@ template<typename TSeq>
 inline void Virus<TSeq>::distribute(Model<TSeq> * model)
 {
 
-    if (dist)
+    if (strain->dist)
     {
 
-        dist(*this, model);
+        strain->dist(*this, model);
 
     }
 
@@ -885,7 +873,7 @@ inline void Virus<TSeq>::distribute(Model<TSeq> * model)
 template<typename TSeq>
 inline void Virus<TSeq>::set_distribution(VirusToAgentFun<TSeq> fun)
 {
-    dist = fun;
+    strain_mut().dist = fun;
 }
 
 template<typename TSeq>
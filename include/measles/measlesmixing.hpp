@@ -61,7 +61,7 @@ class ModelMeaslesMixing final :
 private:
 
     // Vector of vectors of infected agents (prodromal agents are infectious)
-    std::vector< size_t > infectious;
+    std::vector< epiworld_agent_index > infectious;
 
     // Number of infectious agents in each group
     std::vector< size_t > n_infectious_per_group;
@@ -70,10 +70,13 @@ private:
     std::vector< size_t > entity_indices;
 
     void _update_infectious_list();
-    std::vector< size_t > sampled_agents;
+    void _setup_groups(); ///< Sizes and fills the lists by group.
+    void write_checkpoint_derived(std::ostream & out) const override;
+    void read_checkpoint_derived(std::istream & in) override;
+    std::vector< epiworld_agent_index > sampled_agents;
     size_t sample_agents(
         Agent<TSeq> * agent,
-        std::vector< size_t > & sampled_agents
+        std::vector< epiworld_agent_index > & sampled_agents
         );
     std::vector< double > adjusted_contact_rate;
 
@@ -198,6 +201,12 @@ public:
      */
     std::unique_ptr< Model<TSeq> > clone_ptr() override;
 
+    /**
+     * @brief Runs the built-in states without `std::function` calls
+     * @return false if any state function was replaced by the user.
+     */
+    bool update_state_static() override;
+
     /**
      * @brief Set the initial states of the model
      * @param proportions_ Double vector with two elements:
@@ -305,7 +314,7 @@ inline void ModelMeaslesMixing<TSeq>::_update_infectious_list()
 template<typename TSeq>
 inline size_t ModelMeaslesMixing<TSeq>::sample_agents(
     Agent<TSeq> * agent,
-    std::vector< size_t > & sampled_agents
+    std::vector< epiworld_agent_index > & sampled_agents
     )
 {
 
@@ -365,35 +374,9 @@ inline size_t ModelMeaslesMixing<TSeq>::sample_agents(
 }
 
 template<typename TSeq>
-inline void ModelMeaslesMixing<TSeq>::reset()
+inline void ModelMeaslesMixing<TSeq>::_setup_groups()
 {
 
-    Model<TSeq>::reset();
-
-    // Checking if the model is using the queuing
-    // system
-    auto & virusptr = Model<TSeq>::viruses[0u];
-    if (this->is_queuing_on())
-    {
-        for (auto & a: this->get_agents())
-        {
-
-            // Some agents are already in the queue
-            if (a.get_virus() != nullptr)
-                continue;
-
-            // Removing the agent from the queue
-            if (a.get_susceptibility_reduction(virusptr, *this) >= 1.0)
-            {
-                this->queue -= &a;
-            }
-            else
-            {
-                this->queue += &a;
-            }
-        }
-    }
-
     // Checking contact matrix dimensions
     size_t nentities = this->entities.size();
     validate_contact_matrix(nentities);
@@ -422,6 +405,74 @@ inline void ModelMeaslesMixing<TSeq>::reset()
 
     this->_update_infectious_list();
 
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelMeaslesMixing<TSeq>::write_checkpoint_derived(std::ostream & out) const
+{
+
+    checkpoint_write(out, quarantine_willingness);
+    checkpoint_write(out, isolation_willingness);
+    checkpoint_write(out, agent_quarantine_triggered);
+    checkpoint_write(out, day_flagged);
+    checkpoint_write(out, day_rash_onset);
+    checkpoint_write(out, day_latent);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelMeaslesMixing<TSeq>::read_checkpoint_derived(std::istream & in)
+{
+
+    this->_setup_groups();
+
+    checkpoint_read(in, quarantine_willingness);
+    checkpoint_read(in, isolation_willingness);
+    checkpoint_read(in, agent_quarantine_triggered);
+    checkpoint_read(in, day_flagged);
+    checkpoint_read(in, day_rash_onset);
+    checkpoint_read(in, day_latent);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelMeaslesMixing<TSeq>::reset()
+{
+
+    Model<TSeq>::reset();
+
+    // Checking if the model is using the queuing
+    // system
+    auto & virusptr = Model<TSeq>::viruses[0u];
+    if (this->is_queuing_on())
+    {
+        for (auto & a: this->get_agents())
+        {
+
+            // Some agents are already in the queue
+            if (a.get_virus() != nullptr)
+                continue;
+
+            // Removing the agent from the queue
+            if (a.get_susceptibility_reduction(virusptr, *this) >= 1.0)
+            {
+                this->queue -= &a;
+            }
+            else
+            {
+                this->queue += &a;
+            }
+        }
+    }
+
+    this->_setup_groups();
+
     // Setting up the quarantine parameters
     quarantine_willingness.assign(this->size(), false);
     isolation_willingness.assign(this->size(), false);
@@ -450,6 +501,25 @@ inline std::unique_ptr<Model<TSeq>> ModelMeaslesMixing<TSeq>::clone_ptr()
 
 }
 
+template<typename TSeq>
+inline bool ModelMeaslesMixing<TSeq>::update_state_static()
+{
+    return this->template update_state_table<
+        _update_susceptible,
+        _update_latent,
+        _update_prodromal,
+        _update_rash,
+        _update_isolated,
+        _update_isolated_recovered,
+        _update_quarantine_latent,
+        _update_quarantine_suscep,
+        _update_quarantine_prodromal,
+        _update_quarantine_recovered,
+        _update_hospitalized,
+        nullptr
+        >();
+}
+
 template<typename TSeq>
 inline void ModelMeaslesMixing<TSeq>::_update_susceptible(
     Agent<TSeq> * p, Model<TSeq> * m
@@ -541,10 +611,13 @@ inline void ModelMeaslesMixing<TSeq>::_update_prodromal(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_prodromal_period =
+        Model<TSeq>::param_id("Prodromal period");
+
     auto* model = model_cast<ModelMeaslesMixing<TSeq>, TSeq>(m);
 
     // Does the agent transition to rash?
-    if (m->runif() < 1.0/m->par("Prodromal period"))
+    if (m->runif() < 1.0/m->par(par_prodromal_period))
     {
         model->day_rash_onset[p->get_id()] = m->today();
         p->change_state(*m, RASH);
@@ -559,13 +632,22 @@ inline void ModelMeaslesMixing<TSeq>::_update_rash(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_days_undetected =
+        Model<TSeq>::param_id("Days undetected");
+    static const size_t par_rash_period =
+        Model<TSeq>::param_id("Rash period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
     auto* model = model_cast<ModelMeaslesMixing<TSeq>,TSeq>(m);
 
     // Checking if the agent will be detected or not
     bool detected = false;
     if (
-        (m->par("Isolation period") >= 0) &&
-        (m->runif() < 1.0/m->par("Days undetected"))
+        (m->par(par_isolation_period) >= 0) &&
+        (m->runif() < 1.0/m->par(par_days_undetected))
     )
     {
         model->agent_quarantine_triggered[p->get_id()] =
@@ -574,8 +656,8 @@ inline void ModelMeaslesMixing<TSeq>::_update_rash(
     }
 
     // Computing probabilities for state change
-    m->array_double_tmp[0] = 1.0/m->par("Rash period"); // Recovery
-    m->array_double_tmp[1] = m->par("Hospitalization rate"); // Hospitalization
+    m->array_double_tmp[0] = 1.0/m->par(par_rash_period); // Recovery
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate); // Hospitalization
 
     auto which = m->sample_from_probs(2);
 
@@ -609,6 +691,13 @@ inline void ModelMeaslesMixing<TSeq>::_update_isolated(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_rash_period =
+        Model<TSeq>::param_id("Rash period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
     auto* model = model_cast<ModelMeaslesMixing<TSeq>,TSeq>(m);
 
     // Figuring out if the agent can be released from isolation
@@ -616,14 +705,14 @@ inline void ModelMeaslesMixing<TSeq>::_update_isolated(
     int days_since = m->today() - model->day_rash_onset[p->get_id()];
 
     bool unisolate =
-        (m->par("Isolation period") <= days_since) ?
+        (m->par(par_isolation_period) <= days_since) ?
         true: false;
 
     // Sampling from the probabilities of recovery
-    m->array_double_tmp[0] = 1.0/m->par("Rash period");
+    m->array_double_tmp[0] = 1.0/m->par(par_rash_period);
 
     // And hospitalization
-    m->array_double_tmp[1] = m->par("Hospitalization rate");
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
 
     auto which = m->sample_from_probs(2);
 
@@ -652,6 +741,9 @@ inline void ModelMeaslesMixing<TSeq>::_update_quarantine_suscep(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
     auto* model = model_cast<ModelMeaslesMixing<TSeq>,TSeq>(m);
 
     // Figuring out if the agent can be released from quarantine
@@ -659,7 +751,7 @@ inline void ModelMeaslesMixing<TSeq>::_update_quarantine_suscep(
     int days_since = m->today() - model->day_flagged[p->get_id()];
 
     bool unquarantine =
-        (m->par("Quarantine period") <= days_since) ?
+        (m->par(par_quarantine_period) <= days_since) ?
         true: false;
 
     if (unquarantine)
@@ -674,6 +766,9 @@ inline void ModelMeaslesMixing<TSeq>::_update_quarantine_latent(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
     auto* model = model_cast<ModelMeaslesMixing<TSeq>,TSeq>(m);
 
     // Figuring out if the agent can be released from quarantine
@@ -681,7 +776,7 @@ inline void ModelMeaslesMixing<TSeq>::_update_quarantine_latent(
     int days_since = m->today() - model->day_flagged[p->get_id()];
 
     bool unquarantine =
-        (m->par("Quarantine period") <= days_since) ?
+        (m->par(par_quarantine_period) <= days_since) ?
         true: false;
 
     if (m->runif() < 1.0/(p->get_virus()->get_incubation(m)))
@@ -700,6 +795,11 @@ inline void ModelMeaslesMixing<TSeq>::_update_quarantine_prodromal(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+    static const size_t par_prodromal_period =
+        Model<TSeq>::param_id("Prodromal period");
+
     auto* model = model_cast<ModelMeaslesMixing<TSeq>,TSeq>(m);
 
     // Otherwise, these are moved to the prodromal period, if
@@ -707,11 +807,11 @@ inline void ModelMeaslesMixing<TSeq>::_update_quarantine_prodromal(
     int days_since = m->today() - model->day_flagged[p->get_id()];
 
     bool unquarantine =
-        (m->par("Quarantine period") <= days_since) ?
+        (m->par(par_quarantine_period) <= days_since) ?
         true: false;
 
     // Develops rash?
-    if (m->runif() < (1.0/m->par("Prodromal period")))
+    if (m->runif() < (1.0/m->par(par_prodromal_period)))
     {
         model->day_rash_onset[p->get_id()] = m->today();
         p->change_state(*m, ISOLATED);
@@ -731,10 +831,13 @@ inline void ModelMeaslesMixing<TSeq>::_update_quarantine_recovered(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
     auto* model = model_cast<ModelMeaslesMixing<TSeq>,TSeq>(m);
     int days_since = m->today() - model->day_flagged[p->get_id()];
 
-    if (days_since >= m->par("Quarantine period"))
+    if (days_since >= m->par(par_quarantine_period))
         p->change_state(*m, RECOVERED);
 
 };
@@ -744,6 +847,9 @@ inline void ModelMeaslesMixing<TSeq>::_update_isolated_recovered(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+
     auto* model = model_cast<ModelMeaslesMixing<TSeq>,TSeq>(m);
 
     // Figuring out if the agent can be released from isolation
@@ -751,7 +857,7 @@ inline void ModelMeaslesMixing<TSeq>::_update_isolated_recovered(
     int days_since = m->today() - model->day_rash_onset[p->get_id()];
 
     bool unisolate =
-        (m->par("Isolation period") <= days_since) ?
+        (m->par(par_isolation_period) <= days_since) ?
         true: false;
 
     if (unisolate)
@@ -766,8 +872,11 @@ inline void ModelMeaslesMixing<TSeq>::_update_hospitalized(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_hospitalization_period =
+        Model<TSeq>::param_id("Hospitalization period");
+
     // The agent is removed from the system
-    if (m->runif() < 1.0/m->par("Hospitalization period"))
+    if (m->runif() < 1.0/m->par(par_hospitalization_period))
         p->rm_virus(*m, RECOVERED);
 
 };
@@ -775,6 +884,13 @@ inline void ModelMeaslesMixing<TSeq>::_update_hospitalized(
 template<typename TSeq>
 inline void ModelMeaslesMixing<TSeq>::_quarantine_process(Model<TSeq> * m) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+    static const size_t par_contact_tracing_days_window =
+        Model<TSeq>::param_id("Contact tracing days window");
+    static const size_t par_contact_tracing_success_rate =
+        Model<TSeq>::param_id("Contact tracing success rate");
+
     auto * model = model_cast<ModelMeaslesMixing<TSeq>,TSeq>(m);
 
     // Process entity-level quarantine
@@ -787,7 +903,7 @@ inline void ModelMeaslesMixing<TSeq>::_quarantine_process(Model<TSeq> * m) {
         if (model->agent_quarantine_triggered[agent_i] != QUARANTINE_PROCESS_ACTIVE)
             continue;
 
-        if (m->par("Quarantine period") < 0)
+        if (m->par(par_quarantine_period) < 0)
             continue;
 
         // Getting the number of contacts, if it is greater
@@ -808,13 +924,13 @@ inline void ModelMeaslesMixing<TSeq>::_quarantine_process(Model<TSeq> * m) {
             
             bool within_days =
                 std::abs(day_rash_onset_agent_i - contact_date) <=
-                m->par("Contact tracing days window");
+                m->par(par_contact_tracing_days_window);
 
             if (!within_days)
                 continue;
 
             // Checking if we will detect the contact
-            if (m->runif() > m->par("Contact tracing success rate"))
+            if (m->runif() > m->par(par_contact_tracing_success_rate))
                 continue;
 
             auto & agent = m->get_agent(contact_id);
@@ -828,7 +944,7 @@ inline void ModelMeaslesMixing<TSeq>::_quarantine_process(Model<TSeq> * m) {
 
             if (
                 model->quarantine_willingness[contact_id] &&
-                (m->par("Quarantine period") >= 0)
+                (m->par(par_quarantine_period) >= 0)
             )
             {
 
@@ -38,7 +38,7 @@ class ModelMeaslesMixingRiskQuarantine final :
 {
 private:
     // Vector of vectors of infected agents (prodromal agents are infectious)
-    std::vector< size_t > infectious;
+    std::vector< epiworld_agent_index > infectious;
 
     // Number of infectious agents in each group
     std::vector< size_t > n_infectious_per_group;
@@ -50,9 +50,12 @@ private:
 
     // Update the list of infectious agents
     void _update_infectious_list();
+    void _setup_groups(); ///< Sizes and fills the lists by group.
+    void write_checkpoint_derived(std::ostream & out) const override;
+    void read_checkpoint_derived(std::istream & in) override;
 
     // Vector to hold sampled agents temporarily
-    std::vector< size_t > sampled_agents;
+    std::vector< epiworld_agent_index > sampled_agents;
 
     /**
      * @brief Sample infected agents based on contact matrix
@@ -62,7 +65,7 @@ private:
      */
     size_t sample_infectious_agents(
         Agent<TSeq> * agent,
-        std::vector< size_t > & sampled_agents
+        std::vector< epiworld_agent_index > & sampled_agents
         );
 
     std::vector< double > adjusted_contact_rate;
@@ -194,6 +197,12 @@ public:
      */
     std::unique_ptr< Model<TSeq> > clone_ptr() override;
 
+    /**
+     * @brief Runs the built-in states without `std::function` calls
+     * @return false if any state function was replaced by the user.
+     */
+    bool update_state_static() override;
+
     /**
      * @brief Set the initial states of the model
      * @param proportions_ Double vector with two elements:
@@ -253,17 +262,24 @@ template<typename TSeq>
 inline double ModelMeaslesMixingRiskQuarantine<TSeq>::m_get_risk_period(size_t agent_id)
 {
 
+    static const size_t par_quarantine_period_high =
+        Model<TSeq>::param_id("Quarantine period high");
+    static const size_t par_quarantine_period_medium =
+        Model<TSeq>::param_id("Quarantine period medium");
+    static const size_t par_quarantine_period_low =
+        Model<TSeq>::param_id("Quarantine period low");
+
     double risk_period = 0.0;
 
     // Getting the risk level
     int risk_level = quarantine_risk_level[agent_id];
 
     if (risk_level == RISK_HIGH)
-        risk_period = this->par("Quarantine period high");
+        risk_period = this->par(par_quarantine_period_high);
     else if (risk_level == RISK_MEDIUM)
-        risk_period = this->par("Quarantine period medium");
+        risk_period = this->par(par_quarantine_period_medium);
     else
-        risk_period = this->par("Quarantine period low");
+        risk_period = this->par(par_quarantine_period_low);
 
     return risk_period;
 
@@ -333,7 +349,7 @@ inline void ModelMeaslesMixingRiskQuarantine<TSeq>::_update_infectious_list()
 template<typename TSeq>
 inline size_t ModelMeaslesMixingRiskQuarantine<TSeq>::sample_infectious_agents(
     Agent<TSeq> * agent,
-    std::vector< size_t > & sampled_agents
+    std::vector< epiworld_agent_index > & sampled_agents
     )
 {
 
@@ -493,15 +509,20 @@ template<typename TSeq>
 inline void ModelMeaslesMixingRiskQuarantine<TSeq>::_update_prodromal(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
+
+    static const size_t par_prodromal_period =
+        Model<TSeq>::param_id("Prodromal period");
+    static const size_t par_detection_rate_quarantine =
+        Model<TSeq>::param_id("Detection rate quarantine");
     
     auto* model = model_cast<ModelMeaslesMixingRiskQuarantine<TSeq>,TSeq>(m);
 
     // Does the agent transition to rash?
-    if (m->runif() < 1.0/m->par("Prodromal period"))
+    if (m->runif() < 1.0/m->par(par_prodromal_period))
     {
         // Check for detection during active quarantine
         bool detect_it = (model->get_days_quarantine_triggered().size() > 0u) &&
-            (m->runif() < m->par("Detection rate quarantine"));
+            (m->runif() < m->par(par_detection_rate_quarantine));
 
         model->day_rash_onset[p->get_id()] = m->today();
         p->change_state(*m, detect_it ? ISOLATED : RASH);
@@ -520,13 +541,22 @@ inline void ModelMeaslesMixingRiskQuarantine<TSeq>::_update_rash(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_days_undetected =
+        Model<TSeq>::param_id("Days undetected");
+    static const size_t par_rash_period =
+        Model<TSeq>::param_id("Rash period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
     auto* model = model_cast<ModelMeaslesMixingRiskQuarantine<TSeq>,TSeq>(m);
 
     // Checking if the agent will be detected or not
     bool detected = false;
     if (
-        (m->par("Isolation period") >= 0) &&
-        (m->runif() < 1.0/m->par("Days undetected"))
+        (m->par(par_isolation_period) >= 0) &&
+        (m->runif() < 1.0/m->par(par_days_undetected))
     )
     {
         model->m_add_contact_tracing(p->get_id());
@@ -535,8 +565,8 @@ inline void ModelMeaslesMixingRiskQuarantine<TSeq>::_update_rash(
     }
 
     // Computing probabilities for state change
-    m->array_double_tmp[0] = 1.0/m->par("Rash period"); // Recovery
-    m->array_double_tmp[1] = m->par("Hospitalization rate"); // Hospitalization
+    m->array_double_tmp[0] = 1.0/m->par(par_rash_period); // Recovery
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate); // Hospitalization
         
     auto which = m->sample_from_probs(2);
     
@@ -567,6 +597,13 @@ inline void ModelMeaslesMixingRiskQuarantine<TSeq>::_update_isolated(
     Agent<TSeq> * p, Model<TSeq> * m
 ) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_rash_period =
+        Model<TSeq>::param_id("Rash period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
     auto* model = model_cast<ModelMeaslesMixingRiskQuarantine<TSeq>,TSeq>(m);
 
     // Figuring out if the agent can be released from isolation
@@ -574,13 +611,13 @@ inline void ModelMeaslesMixingRiskQuarantine<TSeq>::_update_isolated(
     int days_since = m->today() - model->day_rash_onset[p->get_id()];
 
     bool unisolate =
-        (m->par("Isolation period") <= days_since) ?
+        (m->par(par_isolation_period) <= days_since) ?
         true: false;
 
     // Probability of staying in the rash period vs becoming
     // hospitalized
-    m->array_double_tmp[0] = 1.0/m->par("Rash period");
-    m->array_double_tmp[1] = m->par("Hospitalization rate");
+    m->array_double_tmp[0] = 1.0/m->par(par_rash_period);
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
 
     // Sampling from the probabilities
     auto which = m->sample_from_probs(2);
@@ -611,13 +648,16 @@ inline void ModelMeaslesMixingRiskQuarantine<TSeq>::_update_isolated_recovered(
     Model<TSeq> * m
 ) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+
     auto* model = model_cast<ModelMeaslesMixingRiskQuarantine<TSeq>,TSeq>(m);
 
     // Figuring out if the agent can be released from isolation
     // if the isolation period is over.
     int days_since = m->today() - model->day_rash_onset[p->get_id()];
 
-    if (m->par("Isolation period") <= days_since)
+    if (m->par(par_isolation_period) <= days_since)
         p->change_state(*m, RECOVERED);
 
 }
@@ -680,6 +720,9 @@ inline void ModelMeaslesMixingRiskQuarantine<TSeq>::_update_quarantine_prodromal
     Model<TSeq> * m
 ) {
 
+    static const size_t par_prodromal_period =
+        Model<TSeq>::param_id("Prodromal period");
+
     auto* model = model_cast<ModelMeaslesMixingRiskQuarantine<TSeq>,TSeq>(m);
 
     // Get the appropriate quarantine period based on risk level
@@ -689,7 +732,7 @@ inline void ModelMeaslesMixingRiskQuarantine<TSeq>::_update_quarantine_prodromal
     int days_since = m->today() - model->day_flagged[p->get_id()];
 
     // Develops rash?
-    if (m->runif() < (1.0/m->par("Prodromal period")))
+    if (m->runif() < (1.0/m->par(par_prodromal_period)))
     {
         
         // Developing Rash automatically triggers contact tracing
@@ -732,8 +775,11 @@ inline void ModelMeaslesMixingRiskQuarantine<TSeq>::_update_hospitalized(
     Model<TSeq> * m
 ) {
 
+    static const size_t par_hospitalization_period =
+        Model<TSeq>::param_id("Hospitalization period");
+
     // The agent is removed from the system
-    if (m->runif() < 1.0/m->par("Hospitalization period"))
+    if (m->runif() < 1.0/m->par(par_hospitalization_period))
         p->rm_virus(*m, RECOVERED);
 
 };
@@ -752,6 +798,11 @@ inline void ModelMeaslesMixingRiskQuarantine<TSeq>::m_add_contact_tracing(size_t
 template<typename TSeq>
 inline void ModelMeaslesMixingRiskQuarantine<TSeq>::_quarantine_process(Model<TSeq> * m) {
 
+    static const size_t par_contact_tracing_days_window =
+        Model<TSeq>::param_id("Contact tracing days window");
+    static const size_t par_contact_tracing_success_rate =
+        Model<TSeq>::param_id("Contact tracing success rate");
+
     auto* model = model_cast<ModelMeaslesMixingRiskQuarantine<TSeq>,TSeq>(m);
 
     // If no agents triggered contact tracing, then we skip
@@ -792,7 +843,7 @@ inline void ModelMeaslesMixingRiskQuarantine<TSeq>::_quarantine_process(Model<TS
     #endif
 
     // Checking the risk levels
-    double param_days_prior = m->par("Contact tracing days window");
+    double param_days_prior = m->par(par_contact_tracing_days_window);
     for (size_t i = 0u; i < model->agents_triggered_contact_tracing_size; ++i)
     {
 
@@ -846,7 +897,7 @@ inline void ModelMeaslesMixingRiskQuarantine<TSeq>::_quarantine_process(Model<TS
                 continue;
 
             // Will we detect the contact?
-            if (m->runif() > m->par("Contact tracing success rate"))
+            if (m->runif() > m->par(par_contact_tracing_success_rate))
                 continue;
 
             // How many days since they contacted relative to the rash onset?
@@ -1133,11 +1184,9 @@ inline ModelMeaslesMixingRiskQuarantine<TSeq>::ModelMeaslesMixingRiskQuarantine(
 }
 
 template<typename TSeq>
-inline void ModelMeaslesMixingRiskQuarantine<TSeq>::reset()
+inline void ModelMeaslesMixingRiskQuarantine<TSeq>::_setup_groups()
 {
 
-    Model<TSeq>::reset();
-
     // Checking contact matrix dimensions
     size_t nentities = this->entities.size();
     this->validate_contact_matrix(nentities);
@@ -1165,6 +1214,56 @@ inline void ModelMeaslesMixingRiskQuarantine<TSeq>::reset()
 
     this->_update_infectious_list();
 
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelMeaslesMixingRiskQuarantine<TSeq>::write_checkpoint_derived(std::ostream & out) const
+{
+
+    checkpoint_write(out, quarantine_willingness);
+    checkpoint_write(out, isolation_willingness);
+    checkpoint_write(out, day_flagged);
+    checkpoint_write(out, day_rash_onset);
+    checkpoint_write(out, agents_triggered_contact_tracing);
+    checkpoint_write(out, agents_triggered_contact_tracing_size);
+    checkpoint_write(out, agents_checked_contact_tracing);
+    checkpoint_write(out, quarantine_risk_level);
+    checkpoint_write(out, days_quarantine_triggered);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelMeaslesMixingRiskQuarantine<TSeq>::read_checkpoint_derived(std::istream & in)
+{
+
+    this->_setup_groups();
+
+    checkpoint_read(in, quarantine_willingness);
+    checkpoint_read(in, isolation_willingness);
+    checkpoint_read(in, day_flagged);
+    checkpoint_read(in, day_rash_onset);
+    checkpoint_read(in, agents_triggered_contact_tracing);
+    checkpoint_read(in, agents_triggered_contact_tracing_size);
+    checkpoint_read(in, agents_checked_contact_tracing);
+    checkpoint_read(in, quarantine_risk_level);
+    checkpoint_read(in, days_quarantine_triggered);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelMeaslesMixingRiskQuarantine<TSeq>::reset()
+{
+
+    Model<TSeq>::reset();
+
+    this->_setup_groups();
+
     // Setting up the quarantine parameters
     quarantine_willingness.resize(this->size(), false);
     isolation_willingness.resize(this->size(), false);
@@ -1201,6 +1300,25 @@ inline std::unique_ptr<Model<TSeq>> ModelMeaslesMixingRiskQuarantine<TSeq>::clon
 
 }
 
+template<typename TSeq>
+inline bool ModelMeaslesMixingRiskQuarantine<TSeq>::update_state_static()
+{
+    return this->template update_state_table<
+        _update_susceptible,
+        _update_latent,
+        _update_prodromal,
+        _update_rash,
+        _update_isolated,
+        _update_isolated_recovered,
+        _update_quarantine_latent,
+        _update_quarantine_suscep,
+        _update_quarantine_prodromal,
+        _update_quarantine_recovered,
+        _update_hospitalized,
+        nullptr
+        >();
+}
+
 template<typename TSeq>
 inline ModelMeaslesMixingRiskQuarantine<TSeq> & ModelMeaslesMixingRiskQuarantine<TSeq>::initial_states(
     std::vector< double > proportions_,
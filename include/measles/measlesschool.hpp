@@ -78,6 +78,8 @@ private:
     
     // Update which agents are infectious for contact
     void _update_infectious();
+    void write_checkpoint_derived(std::ostream & out) const override;
+    void read_checkpoint_derived(std::istream & in) override;
 
 public:
 
@@ -134,6 +136,13 @@ public:
     void reset() override;
 
     std::unique_ptr< Model<TSeq> > clone_ptr() override;
+
+    /**
+     * @brief Runs the built-in states without `std::function` calls
+     * @return false if any state function was replaced by the user.
+     */
+    bool update_state_static() override;
+
     void next() override;
 
 };
@@ -141,19 +150,30 @@ public:
 template<typename TSeq>
 inline void ModelMeaslesSchool<TSeq>::_quarantine_agents(Model<TSeq> * m) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_quarantine_willingness =
+        Model<TSeq>::param_id("Quarantine willingness");
+    static const size_t par_days_undetected =
+        Model<TSeq>::param_id("Days undetected");
+    static const size_t par_prodromal_period =
+        Model<TSeq>::param_id("Prodromal period");
+
     auto * model = model_cast<ModelMeaslesSchool<TSeq>,TSeq>(m);
 
     // Quarantine and isolation can be shut off if negative
     if (
-        (model->par("Quarantine period") < 0) &&
-        (model->par("Isolation period") < 0)
+        (model->par(par_quarantine_period) < 0) &&
+        (model->par(par_isolation_period) < 0)
     )
         return;
 
     // Capturing the days that matter and the probability of success
-    epiworld_double willingness = model->par("Quarantine willingness");
-    epiworld_double p_detection = 1.0/(model->par("Days undetected"));
-    int prodromal_period = static_cast<int>(model->par("Prodromal period"));
+    epiworld_double willingness = model->par(par_quarantine_willingness);
+    epiworld_double p_detection = 1.0/(model->par(par_days_undetected));
+    int prodromal_period = static_cast<int>(model->par(par_prodromal_period));
 
     bool triggered_today = false;
 
@@ -211,7 +231,7 @@ inline void ModelMeaslesSchool<TSeq>::_quarantine_agents(Model<TSeq> * m) {
         // Quarantine will depend on the willingness of the agent
         // to be quarantined. If negative, then quarantine never happens.
         if (
-            (model->par("Quarantine period") >= 0) &&
+            (model->par(par_quarantine_period) >= 0) &&
             (model->runif() < willingness)
         )
         {
@@ -234,6 +254,32 @@ inline void ModelMeaslesSchool<TSeq>::_quarantine_agents(Model<TSeq> * m) {
 
 }
 
+template<typename TSeq>
+inline void ModelMeaslesSchool<TSeq>::write_checkpoint_derived(std::ostream & out) const
+{
+
+    checkpoint_write(out, day_flagged);
+    checkpoint_write(out, day_rash_onset);
+    checkpoint_write(out, has_pep);
+
+    return;
+
+}
+
+template<typename TSeq>
+inline void ModelMeaslesSchool<TSeq>::read_checkpoint_derived(std::istream & in)
+{
+
+    checkpoint_read(in, day_flagged);
+    checkpoint_read(in, day_rash_onset);
+    checkpoint_read(in, has_pep);
+
+    this->_update_infectious();
+
+    return;
+
+}
+
 template<typename TSeq>
 inline void ModelMeaslesSchool<TSeq>::reset() {
 
@@ -251,6 +297,9 @@ inline void ModelMeaslesSchool<TSeq>::reset() {
 template<typename TSeq>
 inline void ModelMeaslesSchool<TSeq>::_update_infectious() {
 
+    static const size_t par_contact_rate =
+        Model<TSeq>::param_id("Contact rate");
+
     #ifdef EPI_DEBUG
     // All agents with state >= LATENT should have a virus
     for (auto & agent: this->get_agents())
@@ -287,7 +336,7 @@ inline void ModelMeaslesSchool<TSeq>::_update_infectious() {
     double p_contact = 0.0;
     if (n_available > 0)
     {
-        p_contact = this->par("Contact rate")/
+        p_contact = this->par(par_contact_rate)/
             static_cast< epiworld_double >(n_available);
     }
 
@@ -311,6 +360,25 @@ inline std::unique_ptr<Model<TSeq>> ModelMeaslesSchool<TSeq>::clone_ptr()
 
 }
 
+template<typename TSeq>
+inline bool ModelMeaslesSchool<TSeq>::update_state_static()
+{
+    return this->template update_state_table<
+        _update_susceptible,
+        _update_latent,
+        _update_prodromal,
+        _update_rash,
+        _update_isolated,
+        _update_isolated_recovered,
+        _update_q_latent,
+        _update_q_susceptible,
+        _update_q_prodromal,
+        _update_q_recovered,
+        _update_hospitalized,
+        nullptr
+        >();
+}
+
 LOCAL_UPDATE_FUN(_update_susceptible) {
 
     // How many contacts to draw
@@ -406,7 +474,10 @@ LOCAL_UPDATE_FUN(_update_latent) {
 
 LOCAL_UPDATE_FUN(_update_prodromal) {
 
-    if (m->runif() < (1.0/m->par("Prodromal period")))
+    static const size_t par_prodromal_period =
+        Model<TSeq>::param_id("Prodromal period");
+
+    if (m->runif() < (1.0/m->par(par_prodromal_period)))
     {
 
         auto* model = model_cast<ModelMeaslesSchool<TSeq>,TSeq>(m);
@@ -421,6 +492,10 @@ LOCAL_UPDATE_FUN(_update_prodromal) {
 
 LOCAL_UPDATE_FUN(_update_rash) {
 
+    static const size_t par_rash_period =
+        Model<TSeq>::param_id("Rash period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
 
     auto* model = model_cast<ModelMeaslesSchool<TSeq>,TSeq>(m);
 
@@ -437,8 +512,8 @@ LOCAL_UPDATE_FUN(_update_rash) {
 
     // Probability of Staying in the rash period vs becoming
     // hospitalized
-    m->array_double_tmp[0] = 1.0/m->par("Rash period");
-    m->array_double_tmp[1] = m->par("Hospitalization rate");
+    m->array_double_tmp[0] = 1.0/m->par(par_rash_period);
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
 
     // Sampling from the probabilities
     auto which = m->sample_from_probs(2);
@@ -464,6 +539,13 @@ LOCAL_UPDATE_FUN(_update_rash) {
 
 LOCAL_UPDATE_FUN(_update_isolated) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+    static const size_t par_rash_period =
+        Model<TSeq>::param_id("Rash period");
+    static const size_t par_hospitalization_rate =
+        Model<TSeq>::param_id("Hospitalization rate");
+
     auto* model = model_cast<ModelMeaslesSchool<TSeq>,TSeq>(m);
 
     // Figuring out if the agent can be released from isolation
@@ -471,13 +553,13 @@ LOCAL_UPDATE_FUN(_update_isolated) {
     int days_since = m->today() - model->day_rash_onset[p->get_id()];
 
     bool unisolate =
-        (m->par("Isolation period") <= days_since) ?
+        (m->par(par_isolation_period) <= days_since) ?
         true: false;
 
     // Probability of staying in the rash period vs becoming
     // hospitalized
-    m->array_double_tmp[0] = 1.0/m->par("Rash period");
-    m->array_double_tmp[1] = m->par("Hospitalization rate");
+    m->array_double_tmp[0] = 1.0/m->par(par_rash_period);
+    m->array_double_tmp[1] = m->par(par_hospitalization_rate);
 
     // Sampling from the probabilities
     auto which = m->sample_from_probs(2);
@@ -505,6 +587,9 @@ LOCAL_UPDATE_FUN(_update_isolated) {
 
 LOCAL_UPDATE_FUN(_update_isolated_recovered) {
 
+    static const size_t par_isolation_period =
+        Model<TSeq>::param_id("Isolation period");
+
     auto* model = model_cast<ModelMeaslesSchool<TSeq>,TSeq>(m);
 
     // Figuring out if the agent can be released from isolation
@@ -512,7 +597,7 @@ LOCAL_UPDATE_FUN(_update_isolated_recovered) {
     int days_since = m->today() - model->day_rash_onset[p->get_id()];
 
     bool unisolate =
-        (m->par("Isolation period") <= days_since) ?
+        (m->par(par_isolation_period) <= days_since) ?
         true: false;
 
     if (unisolate)
@@ -522,13 +607,16 @@ LOCAL_UPDATE_FUN(_update_isolated_recovered) {
 
 LOCAL_UPDATE_FUN(_update_q_latent) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
     // How many days since quarantine started
     auto* model = model_cast<ModelMeaslesSchool<TSeq>,TSeq>(m);
     int days_since =
         m->today() - model->day_flagged[p->get_id()];
 
     bool unquarantine =
-        (m->par("Quarantine period") <= days_since) ?
+        (m->par(par_quarantine_period) <= days_since) ?
         true: false;
 
     // Will develop prodromal symptoms?
@@ -551,17 +639,25 @@ LOCAL_UPDATE_FUN(_update_q_latent) {
 
 LOCAL_UPDATE_FUN(_update_q_susceptible) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
     auto* model = model_cast<ModelMeaslesSchool<TSeq>,TSeq>(m);
     int days_since =
         m->today() - model->day_flagged[p->get_id()];
 
-    if (days_since >= m->par("Quarantine period"))
+    if (days_since >= m->par(par_quarantine_period))
         p->change_state(*m, SUSCEPTIBLE);
 
 }
 
 LOCAL_UPDATE_FUN(_update_q_prodromal) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+    static const size_t par_prodromal_period =
+        Model<TSeq>::param_id("Prodromal period");
+
     auto* model = model_cast<ModelMeaslesSchool<TSeq>,TSeq>(m);
 
     // Otherwise, these are moved to the prodromal period, if
@@ -569,11 +665,11 @@ LOCAL_UPDATE_FUN(_update_q_prodromal) {
     int days_since = m->today() - model->day_flagged[p->get_id()];
 
     bool unquarantine =
-        (m->par("Quarantine period") <= days_since) ?
+        (m->par(par_quarantine_period) <= days_since) ?
         true: false;
 
     // Develops rash?
-    if (m->runif() < (1.0/m->par("Prodromal period")))
+    if (m->runif() < (1.0/m->par(par_prodromal_period)))
     {
         model->day_rash_onset[p->get_id()] = m->today();
         p->change_state(*m, ISOLATED);
@@ -590,18 +686,24 @@ LOCAL_UPDATE_FUN(_update_q_prodromal) {
 
 LOCAL_UPDATE_FUN(_update_q_recovered) {
 
+    static const size_t par_quarantine_period =
+        Model<TSeq>::param_id("Quarantine period");
+
     auto* model = model_cast<ModelMeaslesSchool<TSeq>,TSeq>(m);
     int days_since = m->today() - model->day_flagged[p->get_id()];
 
-    if (days_since >= m->par("Quarantine period"))
+    if (days_since >= m->par(par_quarantine_period))
         p->change_state(*m, RECOVERED);
 
 }
 
 LOCAL_UPDATE_FUN(_update_hospitalized) {
 
+    static const size_t par_hospitalization_period =
+        Model<TSeq>::param_id("Hospitalization period");
+
     // The agent is removed from the system
-    if (m->runif() < 1.0/m->par("Hospitalization period"))
+    if (m->runif() < 1.0/m->par(par_hospitalization_period))
         p->rm_virus(*m, RECOVERED);
 
     return;
@@ -0,0 +1,19 @@
+include share/mk/epw.prog.mk
+
+$(NAME)_BENCH_DIR := $($(NAME)_BUILD_DIR)/.bench
+BENCH_TARGETS += $(NAME)-bench
+
+# Runs the benchmark binary and writes the JSON report to the bench
+# directory. With BENCH_BASELINE, the results are compared against a
+# previous report and the target fails if there are regressions.
+.PHONY: $(NAME)-bench
+$(NAME)-bench: override NAME := $(NAME)
+$(NAME)-bench: $($(NAME)_BUILD_DIR)/$(NAME)
+	$(SAY) "BENCH" $@
+	$(V)mkdir -p $($(NAME)_BENCH_DIR)
+	$(V)$($(NAME)_BUILD_DIR)/$(NAME) \
+		--sizes '$(BENCH_SIZES)' \
+		--days '$(BENCH_DAYS)' \
+		--out '$($(NAME)_BENCH_DIR)/bench.json' \
+		$(if $(BENCH_FILTER),--filter '$(BENCH_FILTER)') \
+		$(if $(BENCH_BASELINE),--baseline '$(BENCH_BASELINE)' --threshold '$(BENCH_THRESHOLD)')
@@ -162,3 +162,57 @@ EPIWORLD_TEST_CASE("Random numbers", "[rand-nums]")
 
 
 }
+
+EPIWORLD_TEST_CASE("Counter-based random numbers", "[rand-nums]")
+{
+
+    // Known-answer tests from Random123 (philox4x32_10)
+    epi_philox4x32 eng(0u);
+    const uint32_t * block = eng.next_block();
+    REQUIRE(block[0] == 0x6627e8d5u);
+    REQUIRE(block[1] == 0xe169c58du);
+    REQUIRE(block[2] == 0xbc57ac4cu);
+    REQUIRE(block[3] == 0x9b00dbd8u);
+
+    // Same key and stream, same numbers
+    eng.seed(0x299f31d0a4093822ULL);
+    eng.set_stream(0x0370734413198a2eULL, 0x85a308d3u);
+
+    epi_philox4x32 eng2(0x299f31d0a4093822ULL);
+    eng2.set_stream(0x0370734413198a2eULL, 0x85a308d3u);
+    for (size_t i = 0u; i < 10u; ++i)
+        REQUIRE(eng() == eng2());
+
+    // Streams can be generated in any order
+    std::vector< uint64_t > a, b;
+    epi_philox4x32 e(1231u);
+    for (uint64_t s = 0u; s < 100u; ++s)
+    {
+        e.set_stream(s, 7u);
+        a.push_back(e());
+    }
+
+    for (uint64_t s = 100u; s > 0u; --s)
+    {
+        e.set_stream(s - 1u, 7u);
+        b.push_back(e());
+    }
+
+    std::reverse(b.begin(), b.end());
+    REQUIRE(a == b);
+
+    // Different days give different numbers
+    e.set_stream(0u, 8u);
+    REQUIRE(e() != a[0u]);
+
+    // Uniform numbers
+    size_t n = 100000u;
+    std::vector< epiworld_double > u(n);
+    e.set_stream(3u, 0u);
+    for (size_t i = 0u; i < n; ++i)
+        u[i] = runif_epi(e);
+
+    REQUIRE_FALSE(moreless(calc_mean(u), 0.5, 0.01));
+    REQUIRE_FALSE(moreless(calc_variance(u), 1.0/12.0, 0.01));
+
+}
@@ -0,0 +1,148 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("CSR network matches incremental construction", "[network]") {
+
+    // A small undirected graph with a repeated tie (0-1 and 1-0)
+    std::vector< int > source = {0, 1, 0, 2, 3, 4, 1};
+    std::vector< int > target = {1, 0, 2, 3, 4, 0, 3};
+
+    epimodels::ModelSIR<> model_0("a virus", 0.1, .5, .3);
+    model_0.agents_from_edgelist(source, target, 6, false);
+
+    // Same graph, adding one tie at a time
+    epimodels::ModelSIR<> model_1("a virus", 0.1, .5, .3);
+    model_1.agents_empty_graph(6);
+
+    AdjList al(source, target, 6, false);
+    auto & dat = al.get_dat();
+    for (size_t i = 0u; i < dat.size(); ++i)
+        for (const auto & link : dat[i])
+            model_1.get_agent(i).add_neighbor(
+                model_1.get_agent(link.first), model_1
+            );
+
+    const auto & net_0 = model_0.get_network();
+    const auto & net_1 = model_1.get_network();
+
+    REQUIRE(net_0.vcount() == 6u);
+    REQUIRE(net_0.ecount() == 12u);
+    REQUIRE(net_0 == net_1);
+
+    // Degrees are cached in the agents, and the isolated vertex has none
+    for (auto & a : model_0.get_agents())
+        REQUIRE(a.get_n_neighbors() == net_0.degree(a.get_id()));
+
+    REQUIRE(model_0.get_agent(5).get_n_neighbors() == 0u);
+
+    // Reverse ties are found through the locations
+    for (size_t i = 0u; i < net_0.vcount(); ++i)
+    {
+        for (size_t k = 0u; k < net_0.degree(i); ++k)
+        {
+            size_t j   = net_0.neighbors(i)[k];
+            size_t loc = net_0.neighbors_locations(i)[k];
+            REQUIRE(net_0.neighbors(j)[loc] == i);
+        }
+    }
+
+    // Neighbors through the agent
+    auto neighbors = model_0.get_agent(1).get_neighbors(model_0);
+    REQUIRE(neighbors.size() == 2u);
+    REQUIRE(neighbors[0u]->get_id() == 0);
+    REQUIRE(neighbors[1u]->get_id() == 3);
+
+    // The non-allocating view yields the same agents
+    auto view = model_0.get_agent(1).neighbors(model_0);
+    REQUIRE(view.size() == 2u);
+    REQUIRE(view.id(1u) == 3u);
+
+    size_t k = 0u;
+    for (auto & n : view)
+        REQUIRE(&n == neighbors[k++]);
+
+    REQUIRE(k == 2u);
+    REQUIRE(model_0.get_agent(5).neighbors(model_0).empty());
+
+}
+
+EPIWORLD_TEST_CASE("CSR network is restored after rewiring", "[network]") {
+
+    epimodels::ModelSIR<> model("a virus", 0.01, .5, .3);
+
+    model.seed(1231);
+    model.agents_smallworld(200, 4, false, 0.0);
+    model.verbose_off();
+
+    std::vector< int > source_0, target_0;
+    model.write_edgelist(source_0, target_0);
+
+    model.set_rewire_fun(rewire_degseq<>);
+    model.set_rewire_prop(0.5);
+
+    // The backup is taken before the first run, so every replicate starts
+    // from the original network
+    model.run_multiple(10, 4, 1231, nullptr, true, false, 1);
+
+    std::vector< int > source_1, target_1;
+    model.write_edgelist(source_1, target_1);
+
+    REQUIRE(source_0.size() == source_1.size());
+    REQUIRE(((source_0 != source_1) || (target_0 != target_1)));
+
+    model.reset();
+
+    std::vector< int > source_2, target_2;
+    model.write_edgelist(source_2, target_2);
+
+    REQUIRE(source_0 == source_2);
+    REQUIRE(target_0 == target_2);
+
+}
+
+EPIWORLD_TEST_CASE("CSR network is shared between clones", "[network]") {
+
+    epimodels::ModelSIR<> model("a virus", 0.01, .5, .3);
+
+    model.seed(1231);
+    model.agents_smallworld(200, 4, false, 0.0);
+    model.verbose_off();
+
+    // Clones share the topology
+    epimodels::ModelSIR<> clone(model);
+    REQUIRE(&clone.get_network() == &model.get_network());
+
+    // Adding a tie in the clone makes a copy (copy-on-write)
+    clone.get_agent(0).add_neighbor(clone.get_agent(100), clone);
+    REQUIRE(&clone.get_network() != &model.get_network());
+    REQUIRE(clone.get_network().ecount() == model.get_network().ecount() + 2);
+    REQUIRE(clone.get_agent(0).get_n_neighbors() == 5u);
+    REQUIRE(model.get_agent(0).get_n_neighbors() == 4u);
+
+    // Rewiring in one of the threads doesn't affect the others
+    std::vector< int > source_0, target_0;
+    model.write_edgelist(source_0, target_0);
+
+    model.set_rewire_fun(rewire_degseq<>);
+    model.set_rewire_prop(0.5);
+
+    std::vector< std::vector< int > > sources(4);
+    auto fun = [&sources](size_t n, Model<> * m) -> void {
+        std::vector< int > target;
+        m->write_edgelist(sources[n], target);
+    };
+
+    model.run_multiple(10, 4, 1231, fun, true, false, 2);
+
+    for (auto & s : sources)
+        REQUIRE(s.size() == source_0.size());
+
+    model.reset();
+
+    std::vector< int > source_1, target_1;
+    model.write_edgelist(source_1, target_1);
+    REQUIRE(source_0 == source_1);
+    REQUIRE(target_0 == target_1);
+
+}
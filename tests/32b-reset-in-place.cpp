@@ -0,0 +1,67 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Reset restores agents in place", "[reset]") {
+
+    epimodels::ModelSIR<> model("a virus", 0.05, .5, .3);
+
+    model.seed(2231);
+    model.agents_smallworld(1000, 5, false, 0.01);
+    model.verbose_off();
+
+    Tool<> tool("vax", .5, true);
+    tool.set_susceptibility_reduction(.3);
+    model.add_tool(tool);
+
+    model.set_rewire_fun(rewire_degseq<>);
+    model.set_rewire_prop(0.1);
+
+    std::vector< int > source_0, target_0;
+    model.write_edgelist(source_0, target_0);
+
+    // First run
+    std::vector< int > date_0, counts_0;
+    std::vector< std::string > state_0;
+    model.run_multiple(50, 1, 1231, nullptr, true, false, 1);
+    model.get_db().get_hist_total(&date_0, &state_0, &counts_0);
+
+    std::vector< size_t > ntools_0;
+    for (auto & a : model.get_agents())
+        ntools_0.push_back(a.get_n_tools());
+
+    // Second run: same seed, the reset is done in place
+    std::vector< int > date_1, counts_1;
+    std::vector< std::string > state_1;
+    model.run_multiple(50, 1, 1231, nullptr, true, false, 1);
+    model.get_db().get_hist_total(&date_1, &state_1, &counts_1);
+
+    std::vector< size_t > ntools_1;
+    for (auto & a : model.get_agents())
+        ntools_1.push_back(a.get_n_tools());
+
+    REQUIRE(date_0 == date_1);
+    REQUIRE(state_0 == state_1);
+    REQUIRE(counts_0 == counts_1);
+    REQUIRE(ntools_0 == ntools_1);
+
+    // Agents are back to the baseline state and the network is restored
+    model.reset();
+
+    size_t n_infected = 0u;
+    for (auto & a : model.get_agents())
+    {
+        REQUIRE(a.get_state() <= 1u);
+        if (a.get_virus() != nullptr)
+            n_infected++;
+    }
+
+    REQUIRE(n_infected == 50u);
+
+    std::vector< int > source_1, target_1;
+    model.write_edgelist(source_1, target_1);
+
+    REQUIRE(source_0 == source_1);
+    REQUIRE(target_0 == target_1);
+
+}
@@ -0,0 +1,74 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Queue worklist matches the counters", "[queue]") {
+
+    epimodels::ModelSIR<> model("a virus", 0.01, .5, .3);
+
+    model.seed(1231);
+    model.agents_smallworld(2000, 4, false, 0.01);
+    model.verbose_off();
+
+    // Checking the worklist at the end of every day
+    bool all_match = true;
+    size_t max_active = 0u;
+    size_t n_sparse = 0u;
+    GlobalFun<> check = [&all_match, &max_active, &n_sparse](
+        Model<> * m
+    ) -> void {
+
+        // Read only, so the counters are not added to the worklist
+        auto & q = m->get_queue();
+        const auto & q_const = q;
+
+        // Same condition as in get_active_agents()
+        if ((q_const.get_worklist_size() * 4u) <= m->size())
+            n_sparse++;
+
+        std::vector< size_t > active = q.get_active_agents();
+
+        // Sorted and unique
+        for (size_t i = 1u; i < active.size(); ++i)
+            if (active[i - 1u] >= active[i])
+                all_match = false;
+
+        // Same as scanning all the counters
+        std::vector< size_t > expected;
+        for (size_t i = 0u; i < m->size(); ++i)
+            if (q_const[i] > 0)
+                expected.push_back(i);
+
+        if (expected != active)
+            all_match = false;
+
+        max_active = std::max(max_active, active.size());
+
+    };
+
+    model.add_globalevent(check, "Check queue");
+    model.run(60, 223);
+
+    REQUIRE(all_match);
+    REQUIRE(max_active > 0u);
+    REQUIRE(max_active < model.size());
+
+    // The compact-and-sort path is the one being compared
+    REQUIRE(n_sparse > 0u);
+
+    // Results are the same with and without the queue
+    std::vector< int > date_0, counts_0, date_1, counts_1;
+    std::vector< std::string > state_0, state_1;
+    model.get_db().get_hist_total(&date_0, &state_0, &counts_0);
+
+    epimodels::ModelSIR<> model_1("a virus", 0.01, .5, .3);
+    model_1.seed(1231);
+    model_1.agents_smallworld(2000, 4, false, 0.01);
+    model_1.verbose_off();
+    model_1.queuing_off();
+    model_1.run(60, 223);
+    model_1.get_db().get_hist_total(&date_1, &state_1, &counts_1);
+
+    REQUIRE(counts_0 == counts_1);
+
+}
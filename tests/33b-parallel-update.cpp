@@ -0,0 +1,66 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Parallel update is reproducible across threads", "[parallel]") {
+
+    auto run = [](int nthreads, bool queuing) -> std::vector< int > {
+
+        epimodels::ModelSEIR<> model("a virus", 0.01, .5, 4.0, .3);
+
+        model.seed(1231);
+        model.agents_smallworld(5000, 6, false, 0.01);
+        model.verbose_off();
+
+        Tool<> tool("vax", .5, true);
+        tool.set_susceptibility_reduction(.3);
+        model.add_tool(tool);
+
+        if (!queuing)
+            model.queuing_off();
+
+        model.parallel_update_on(nthreads);
+        model.run(60, 223);
+
+        std::vector< int > date, counts;
+        std::vector< std::string > state;
+        model.get_db().get_hist_total(&date, &state, &counts);
+
+        // Appending the transmissions
+        std::vector< int > t_date, t_source, t_target, t_virus, t_exp;
+        model.get_db().get_transmissions(
+            t_date, t_source, t_target, t_virus, t_exp
+        );
+
+        counts.insert(counts.end(), t_source.begin(), t_source.end());
+        counts.insert(counts.end(), t_target.begin(), t_target.end());
+
+        return counts;
+
+    };
+
+    auto res_1 = run(1, true);
+    auto res_2 = run(2, true);
+    auto res_4 = run(4, true);
+
+    // 61 days x 4 states, plus some transmissions
+    REQUIRE(res_1.size() > 61u * 4u);
+
+    REQUIRE(res_1 == res_2);
+    REQUIRE(res_1 == res_4);
+
+    // Agents' streams are keyed by id, so skipping the agents out of the
+    // queue gives the same result
+    auto res_noqueue = run(3, false);
+    REQUIRE(res_1 == res_noqueue);
+
+    // The option is carried over to copies, and can be turned off
+    epimodels::ModelSEIR<> model("a virus", 0.01, .5, 4.0, .3);
+    model.parallel_update_on(2);
+    epimodels::ModelSEIR<> model_copy(model);
+    REQUIRE(model_copy.is_parallel_update_on());
+    model_copy.parallel_update_off();
+    REQUIRE_FALSE(model_copy.is_parallel_update_on());
+    REQUIRE_THROWS(model.parallel_update_on(0));
+
+}
@@ -0,0 +1,113 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Dynamic replicates match the serial run", "[run-multiple]") {
+
+    auto run = [](int nthreads, std::vector< int > & last) -> std::vector< std::vector< int > > {
+
+        // Low prevalence so that some replicates die out early while others
+        // take the whole period
+        epimodels::ModelSIR<> model("a virus", 0.001, .9, .1);
+        model.seed(1231);
+        model.agents_smallworld(2000, 4, false, 0.01);
+        model.verbose_off();
+
+        std::vector< std::vector< int > > res(20);
+        auto fun = [&res](size_t n, Model<> * m) -> void {
+            std::vector< int > date;
+            std::vector< std::string > state;
+            m->get_db().get_hist_total(&date, &state, &res[n]);
+        };
+
+        model.run_multiple(100, 20, 223, fun, true, false, nthreads);
+
+        // The calling model ends with the last replicate
+        std::vector< int > date;
+        std::vector< std::string > state;
+        model.get_db().get_hist_total(&date, &state, &last);
+        REQUIRE(model.get_sim_id() == 20u);
+        REQUIRE(model.get_n_replicates() == 20u);
+
+        return res;
+
+    };
+
+    std::vector< int > last_1, last_3;
+    auto res_1 = run(1, last_1);
+    auto res_3 = run(3, last_3);
+
+    for (size_t i = 0u; i < res_1.size(); ++i)
+        REQUIRE(res_1[i] == res_3[i]);
+
+    REQUIRE(last_1 == res_1.back());
+    REQUIRE(last_3 == res_1.back());
+
+}
+
+EPIWORLD_TEST_CASE("The last replicate can run on any thread", "[run-multiple]") {
+
+    auto run = [](int nthreads) -> std::vector< int > {
+
+        epimodels::ModelSIRCONN<> model("a virus", 2000, 0.01, 4, .3, .2);
+        model.verbose_off();
+
+        // Whichever thread runs the last replicate, the calling model ends
+        // with its state
+        model.run_multiple(50, 6, 223, nullptr, true, false, nthreads);
+        REQUIRE(model.get_sim_id() == 6u);
+
+        // The state (including ModelSIRCONN's list of infected agents and
+        // the RNG) continues as the last replicate would
+        model.resume(20);
+
+        std::vector< int > date, counts;
+        std::vector< std::string > state;
+        model.get_db().get_hist_total(&date, &state, &counts);
+
+        return counts;
+
+    };
+
+    REQUIRE(run(3) == run(1));
+
+}
+
+EPIWORLD_TEST_CASE("Replicates dont depend on cached draws", "[run-multiple]") {
+
+    // Sum of the draws of each replicate
+    auto run = [](int nthreads) -> std::vector< double > {
+
+        epimodels::ModelSIR<> model("a virus", 0.01, .5, .3);
+        model.agents_smallworld(1000, 4, false, 0.01);
+        model.verbose_off();
+
+        // One draw a day (an odd number per replicate) from distributions
+        // that keep a second draw for the next call
+        std::vector< double > draws(30u, 0.0);
+        model.add_globalevent(
+            [&draws](Model<> * m) -> void {
+                draws[m->get_sim_id()] +=
+                    m->rnorm() +
+                    m->rgamma(2.0, 1.0) +
+                    m->rlognormal(0.0, 1.0) +
+                    static_cast< double >(m->rbinom(1000000, .3));
+            },
+            "Draws"
+        );
+
+        model.run_multiple(11, 30, 223, nullptr, true, false, nthreads);
+
+        return draws;
+
+    };
+
+    auto draws_1 = run(1);
+    REQUIRE(draws_1 == run(1));
+
+    #ifdef _OPENMP
+    for (size_t i = 0u; i < 3u; ++i)
+        REQUIRE(run(3) == draws_1);
+    #endif
+
+}
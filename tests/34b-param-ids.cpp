@@ -0,0 +1,47 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Parameter ids", "[params]") {
+
+    epimodels::ModelSIR<> model("a virus", 0.01, .5, .3);
+
+    // Ids are the same for every model
+    size_t id_trans = Model<>::param_id("Transmission rate");
+    REQUIRE(id_trans == Model<>::param_id("Transmission rate"));
+    REQUIRE(Model<>::param_name(id_trans) == "Transmission rate");
+    REQUIRE(model.par(id_trans) == model.par("Transmission rate"));
+
+    // Changes through the string API are visible through the id
+    model.set_param("Transmission rate", .9);
+    REQUIRE(model.par(id_trans) == .9);
+
+    model.params()["Transmission rate"] = .8;
+    REQUIRE(model.par(id_trans) == .8);
+
+    // Parameters added directly to the map are found too
+    model.params()["Some new param"] = 2.0;
+    size_t id_new = Model<>::param_id("Some new param");
+    REQUIRE(model.par(id_new) == 2.0);
+
+    // ... and are bound by the next call to params()
+    model.params()["Some new param"] = 3.0;
+    REQUIRE(model.par(id_new) == 3.0);
+    REQUIRE(model.par(id_trans) == .8);
+
+    size_t id_missing = Model<>::param_id("Not in the model");
+    REQUIRE_THROWS(model.par(id_missing));
+
+    // Copies point to their own values
+    epimodels::ModelSIR<> model_copy(model);
+    model_copy.set_param("Transmission rate", .1);
+    REQUIRE(model_copy.par(id_trans) == .1);
+    REQUIRE(model.par(id_trans) == .8);
+
+    // Viruses using a parameter name resolve it in the model that calls them
+    Virus<> v("another virus");
+    v.set_prob_infecting("Transmission rate");
+    REQUIRE(v.get_prob_infecting(&model) == .8);
+    REQUIRE(v.get_prob_infecting(&model_copy) == .1);
+
+}
@@ -0,0 +1,115 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Cached tool effects", "[tools]") {
+
+    // With constant effects, agents cache them; with functions, they don't
+    auto run = [](bool as_fun) -> std::vector< int > {
+
+        epimodels::ModelSEIR<> model("a virus", 0.01, .5, 4.0, .3);
+
+        model.seed(1231);
+        model.agents_smallworld(2000, 6, false, 0.01);
+        model.verbose_off();
+
+        Tool<> mask("mask", .5, true);
+        Tool<> vax("vax", .3, true);
+
+        if (as_fun)
+        {
+            mask.set_transmission_reduction_fun(
+                [](Tool<> &, Agent<> *, VirusPtr<> &, Model<> *) { return .4; }
+            );
+            vax.set_susceptibility_reduction_fun(
+                [](Tool<> &, Agent<> *, VirusPtr<> &, Model<> *) { return .6; }
+            );
+            vax.set_recovery_enhancer_fun(
+                [](Tool<> &, Agent<> *, VirusPtr<> &, Model<> *) { return .2; }
+            );
+        } else {
+            mask.set_transmission_reduction(.4);
+            vax.set_susceptibility_reduction(.6);
+            vax.set_recovery_enhancer(.2);
+        }
+
+        model.add_tool(mask);
+        model.add_tool(vax);
+
+        model.run(60, 223);
+
+        std::vector< int > date, counts;
+        std::vector< std::string > state;
+        model.get_db().get_hist_total(&date, &state, &counts);
+
+        return counts;
+
+    };
+
+    REQUIRE(run(false) == run(true));
+
+    // Checking the cache against the tools
+    epimodels::ModelSEIR<> model("a virus", 0.01, .5, 4.0, .3);
+    model.seed(1);
+    model.agents_smallworld(500, 4, false, 0.01);
+    model.verbose_off();
+
+    Tool<> mask("mask", 1.0, true);
+    mask.set_transmission_reduction(.4);
+    mask.set_susceptibility_reduction(.1);
+    Tool<> vax("vax", 1.0, true);
+    vax.set_susceptibility_reduction(.6);
+    model.add_tool(mask);
+    model.add_tool(vax);
+
+    model.run(2, 22);
+
+    auto & agent = model.get_agent(0);
+    REQUIRE(agent.get_n_tools() == 2u);
+
+    VirusPtr<> v = nullptr;
+    REQUIRE_THAT(
+        agent.get_susceptibility_reduction(v, model),
+        Catch::WithinAbs(1.0 - (1.0 - .1) * (1.0 - .6), 1e-12)
+    );
+    REQUIRE_THAT(
+        agent.get_transmission_reduction(v, model),
+        Catch::WithinAbs(.4, 1e-12)
+    );
+    REQUIRE(agent.get_recovery_enhancer(v, model) == 0.0);
+
+    // Changing a tool already in an agent refreshes the cache
+    agent.get_tool(1)->set_susceptibility_reduction(.5);
+    REQUIRE_THAT(
+        agent.get_susceptibility_reduction(v, model),
+        Catch::WithinAbs(1.0 - (1.0 - .1) * (1.0 - .5), 1e-12)
+    );
+
+    agent.get_tool(1)->set_susceptibility_reduction_fun(
+        [](Tool<> &, Agent<> *, VirusPtr<> &, Model<> *) { return .9; }
+    );
+    REQUIRE_THAT(
+        agent.get_susceptibility_reduction(v, model),
+        Catch::WithinAbs(1.0 - (1.0 - .1) * (1.0 - .9), 1e-12)
+    );
+
+    // Agents share the tools' definitions, but changes stay local
+    auto & agent_1 = model.get_agent(1);
+    REQUIRE(agent_1.get_tool(1)->get_name() == "vax");
+    REQUIRE_THAT(
+        agent_1.get_susceptibility_reduction(v, model),
+        Catch::WithinAbs(1.0 - (1.0 - .1) * (1.0 - .6), 1e-12)
+    );
+
+    agent.get_tool(1)->set_name("vax 2");
+    REQUIRE(agent_1.get_tool(1)->get_name() == "vax");
+    REQUIRE(model.get_tool(1).get_name() == "vax");
+
+    // Copies of the model carry the cache over
+    epimodels::ModelSEIR<> model_copy(model);
+    REQUIRE_THAT(
+        model_copy.get_agent(0).get_susceptibility_reduction(v, model_copy),
+        Catch::WithinAbs(1.0 - (1.0 - .1) * (1.0 - .9), 1e-12)
+    );
+
+}
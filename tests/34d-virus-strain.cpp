@@ -0,0 +1,69 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Viruses share their strain until modified", "[virus]") {
+
+    epimodels::ModelSIR<> model("a virus", 0.01, .5, .3);
+
+    Virus<> v("flu");
+    v.set_prob_infecting(.3);
+    v.set_state(1, 2, 3);
+
+    // Modifying a copy leaves the original untouched (and vice versa)
+    Virus<> v2(v);
+    REQUIRE(v2 == v);
+    v2.set_prob_infecting(.9);
+    v2.set_name("flu 2");
+    REQUIRE(v.get_prob_infecting(&model) == .3);
+    REQUIRE(v.get_name() == "flu");
+    REQUIRE(v2.get_prob_infecting(&model) == .9);
+    REQUIRE(v2.get_name() == "flu 2");
+
+    v.set_state(4, 5, 6);
+    epiworld_fast_int init, post, removed;
+    v2.get_state(&init, &post, &removed);
+    REQUIRE(init == 1);
+    REQUIRE(post == 2);
+    REQUIRE(removed == 3);
+
+    // Mutated viruses get their own strain
+    epimodels::ModelSIR<> model_mut("a virus", 0.05, .9, .1);
+    model_mut.seed(10);
+    model_mut.agents_smallworld(1000, 6, false, .01);
+    model_mut.verbose_off();
+
+    auto mutfun = [](Agent<> * p, Virus<> & v, Model<> * m) -> bool {
+
+        if (m->runif() > .05)
+            return false;
+
+        v.set_sequence(1000 + p->get_id());
+        v.set_name("variant " + std::to_string(p->get_id()));
+        v.set_prob_infecting(.1);
+        return true;
+
+    };
+
+    model_mut.get_virus(0).set_mutation(mutfun);
+    model_mut.run(50, 22);
+
+    REQUIRE(model_mut.get_db().get_n_viruses() > 1u);
+    REQUIRE(model_mut.get_virus(0).get_name() == "a virus");
+    REQUIRE(model_mut.get_virus(0).get_prob_infecting(&model_mut) == .9);
+
+    // Carriers of the original virus keep its id
+    for (const auto & agent : model_mut.get_agents())
+    {
+        const auto & av = agent.get_virus();
+        if (av == nullptr)
+            continue;
+
+        if (av->get_name() == "a virus")
+            REQUIRE(av->get_id() == 0);
+        else
+            REQUIRE(av->get_id() > 0);
+
+    }
+
+}
@@ -0,0 +1,56 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Events applied in agent order", "[events]") {
+
+    auto run = [](bool by_agent, std::vector< int > & transitions) -> std::vector< int > {
+
+        epimodels::ModelSEIR<> model("a virus", 0.01, .5, 4.0, .3);
+
+        model.seed(1231);
+        model.agents_smallworld(2000, 6, false, 0.01);
+        model.verbose_off();
+
+        // Post-recovery tools are added while the events are running
+        model.get_virus(0).set_post_immunity(.9);
+
+        Tool<> tool("vax", .3, true);
+        tool.set_susceptibility_reduction(.5);
+        model.add_tool(tool);
+
+        if (by_agent)
+            model.events_by_agent_on();
+
+        model.run(60, 223);
+
+        std::vector< int > date, counts;
+        std::vector< std::string > state;
+        model.get_db().get_hist_total(&date, &state, &counts);
+
+        std::vector< std::string > t_from, t_to;
+        std::vector< int > t_date;
+        model.get_db().get_hist_transition_matrix(
+            t_from, t_to, t_date, transitions, false
+        );
+
+        return counts;
+
+    };
+
+    std::vector< int > trans_0, trans_1;
+    auto counts_0 = run(false, trans_0);
+    auto counts_1 = run(true, trans_1);
+
+    REQUIRE(counts_0.size() > 0u);
+    REQUIRE(counts_0 == counts_1);
+    REQUIRE(trans_0 == trans_1);
+
+    // The option is carried over to copies
+    epimodels::ModelSEIR<> model("a virus", 0.01, .5, 4.0, .3);
+    REQUIRE_FALSE(model.is_events_by_agent_on());
+    model.events_by_agent_on();
+    epimodels::ModelSEIR<> model_copy(model);
+    REQUIRE(model_copy.is_events_by_agent_on());
+
+}
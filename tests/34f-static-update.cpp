@@ -0,0 +1,173 @@
+#include "tests.hpp"
+#include "../include/measles/measles.hpp"
+
+using namespace epiworld;
+
+template<typename TModel>
+static std::vector< int > run_hist(TModel & model)
+{
+
+    model.verbose_off();
+    model.run(50, 1231);
+
+    std::vector< int > date, counts;
+    std::vector< std::string > state;
+    model.get_db().get_hist_total(&date, &state, &counts);
+
+    return counts;
+
+}
+
+/**
+ * Wraps the update functions of the model in lambdas, so the model can't
+ * recognize them and has to go through `std::function`.
+ */
+template<typename TSeq>
+static void wrap_state_funs(Model<TSeq> & model)
+{
+
+    auto funs = model.get_state_fun();
+    for (size_t s = 0u; s < funs.size(); ++s)
+    {
+        if (!funs[s])
+            continue;
+
+        UpdateFun<TSeq> f = funs[s];
+        model.set_state_function(
+            s, [f](Agent<TSeq> * p, Model<TSeq> * m) -> void { f(p, m); }
+        );
+    }
+
+}
+
+/**
+ * Counts the days in which the model took the static path.
+ */
+template<typename TModel>
+class StaticCount : public TModel
+{
+public:
+
+    using TModel::TModel;
+
+    size_t n_static = 0u;
+
+    bool update_state_static() override
+    {
+        bool ran = TModel::update_state_static();
+        n_static += ran ? 1u : 0u;
+        return ran;
+    }
+
+};
+
+/**
+ * The model runs every day through the static path, its copy with wrapped
+ * functions never does, and both give the same results.
+ */
+template<typename TModel>
+static bool static_matches(StaticCount< TModel > & model_0)
+{
+
+    StaticCount< TModel > model_1(model_0);
+    wrap_state_funs(model_1);
+
+    bool same = run_hist(model_0) == run_hist(model_1);
+
+    return same &&
+        (model_0.n_static == model_0.get_ndays()) &&
+        (model_1.n_static == 0u);
+
+}
+
+/**
+ * For final models: after the runs, only the model with its own functions
+ * goes through the table.
+ */
+template<typename TModel>
+static bool static_matches_final(TModel & model_0)
+{
+
+    TModel model_1(model_0);
+    wrap_state_funs(model_1);
+
+    bool same = run_hist(model_0) == run_hist(model_1);
+
+    return same &&
+        model_0.update_state_static() &&
+        !model_1.update_state_static();
+
+}
+
+EPIWORLD_TEST_CASE("Static update matches std::function", "[static-update]") {
+
+    // SIR
+    StaticCount< epimodels::ModelSIR<> > sir0("a virus", 0.01, .5, .3);
+    sir0.agents_smallworld(2000, 6, false, 0.01);
+
+    REQUIRE(static_matches(sir0));
+
+    // SEIR
+    StaticCount< epimodels::ModelSEIR<> > seir0("a virus", 0.01, .5, 4.0, .3);
+    seir0.agents_smallworld(2000, 6, false, 0.01);
+
+    REQUIRE(static_matches(seir0));
+
+    // SIR connected (no queuing)
+    StaticCount< epimodels::ModelSIRCONN<> > conn0(
+        "a virus", 5000, 0.01, 4.0, .3, .2
+    );
+
+    REQUIRE(static_matches(conn0));
+
+    // Mixing models
+    std::vector< double > contact_matrix = {
+        8.0, 1.0, 1.0,
+        1.0, 8.0, 1.0,
+        1.0, 1.0, 8.0
+    };
+
+    auto add_groups = [](Model<> & m) -> void {
+        m.add_entity(Entity<>("A", distribute_entity_to_range<>(0, 1000)));
+        m.add_entity(Entity<>("B", distribute_entity_to_range<>(1000, 2000)));
+        m.add_entity(Entity<>("C", distribute_entity_to_range<>(2000, 3000)));
+    };
+
+    StaticCount< epimodels::ModelSEIRMixing<> > mixing0(
+        "a virus", 3000, 0.01, 0.1, 4.0, 1.0/7.0, contact_matrix
+    );
+    add_groups(mixing0);
+
+    REQUIRE(static_matches(mixing0));
+
+    measles::ModelMeaslesMixing<> measles0(
+        3000, 0.005, 0.2, 0.9, 0.3, 7.0, 4.0, 5.0, contact_matrix,
+        0.2, 7.0, 2.0, 21, .8, .8, 4, 0.0, 1.0, 4u
+    );
+    add_groups(measles0);
+
+    REQUIRE(static_matches_final(measles0));
+
+    // Replacing a function must take effect: nobody recovers
+    epimodels::ModelSIR<> sir2("a virus", 0.01, .5, .3);
+    sir2.agents_smallworld(2000, 6, false, 0.01);
+    sir2.set_state_function(1u, nullptr);
+    run_hist(sir2);
+
+    REQUIRE(sir2.get_db().get_today_total("Recovered") == 0);
+    REQUIRE(sir2.get_db().get_today_total("Infected") > 20);
+
+    // States added by the user still run
+    epimodels::ModelSIR<> sir3("a virus", 0.01, .5, .3);
+    sir3.agents_smallworld(2000, 6, false, 0.01);
+    sir3.add_state("Lost", [](Agent<> * p, Model<> * m) -> void {
+        p->change_state(*m, 2u);
+    });
+
+    // Recovered agents go to "Lost", the only way into "Recovered"
+    sir3.get_virus(0).set_state(1, 3, 3);
+    run_hist(sir3);
+
+    REQUIRE(sir3.get_db().get_today_total("Recovered") > 0);
+
+}
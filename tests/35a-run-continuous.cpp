@@ -0,0 +1,62 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Continuous-time engine", "[run-continuous]") {
+
+    auto hist = [](Model<> & model) -> std::vector< int > {
+
+        std::vector< int > date, counts;
+        std::vector< std::string > state;
+        model.get_db().get_hist_total(&date, &state, &counts);
+
+        return counts;
+
+    };
+
+    // No transmission: infected agents recover with the same daily
+    // probability as in the discrete-time model (0.7^10 remain infected)
+    epimodels::ModelSIR<> model_0("a virus", 0.1, 0.0, .3);
+    model_0.agents_smallworld(10000, 4, false, 0.01);
+    model_0.verbose_off();
+    model_0.run_continuous(10, 1231);
+
+    REQUIRE(model_0.get_db().get_today_total("Susceptible") == 9000);
+    REQUIRE(model_0.get_db().get_today_total("Infected") > 10);
+    REQUIRE(model_0.get_db().get_today_total("Infected") < 50);
+    REQUIRE(model_0.get_db().get_today_total("Recovered") > 950);
+    REQUIRE(hist(model_0).size() == 11u * 3u);
+
+    // An outbreak, reproducible with the same seed
+    epimodels::ModelSIR<> model_1("a virus", 0.01, .5, .3);
+    model_1.agents_smallworld(2000, 6, false, 0.01);
+    model_1.verbose_off();
+    model_1.run_continuous(60, 223);
+    auto counts_1 = hist(model_1);
+
+    REQUIRE(model_1.get_db().get_today_total("Recovered") > 200);
+    REQUIRE(
+        model_1.get_db().get_today_total("Susceptible") +
+        model_1.get_db().get_today_total("Infected") +
+        model_1.get_db().get_today_total("Recovered") == 2000
+    );
+
+    model_1.run_continuous(60, 223);
+    REQUIRE(hist(model_1) == counts_1);
+
+    // Deaths go to the removed state
+    epimodels::ModelSIRD<> model_2("a virus", 0.1, .5, .2, .2);
+    model_2.agents_smallworld(2000, 6, false, 0.01);
+    model_2.verbose_off();
+    model_2.run_continuous(60, 11);
+
+    REQUIRE(model_2.get_db().get_today_total("Deceased") > 0);
+    REQUIRE(model_2.get_db().get_today_total("Recovered") > 0);
+
+    // States with other update functions are not supported
+    epimodels::ModelSEIR<> model_3("a virus", 0.01, .5, 4.0, .3);
+    model_3.agents_smallworld(2000, 6, false, 0.01);
+    model_3.verbose_off();
+    REQUIRE_THROWS_AS(model_3.run_continuous(10, 1), std::logic_error);
+
+}
@@ -0,0 +1,105 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Aggregated mixing models", "[mixing-aggregated]") {
+
+    std::vector< double > contact_matrix = {
+        10.0, 2.0, 1.0,
+        2.0, 10.0, 2.0,
+        1.0, 2.0, 10.0
+    };
+
+    auto final_total = [](Model<> & model, std::string state) -> int {
+        return model.get_db().get_today_total(state);
+    };
+
+    // Agent-based model
+    epimodels::ModelSEIRMixing<> model_agents(
+        "Flu", 30000, 0.01, .1, 3.0, .25, contact_matrix
+    );
+
+    model_agents.add_entity(Entity<>("A", dist_factory<>(0, 10000)));
+    model_agents.add_entity(Entity<>("B", dist_factory<>(10000, 20000)));
+    model_agents.add_entity(Entity<>("C", dist_factory<>(20000, 30000)));
+    model_agents.verbose_off();
+    model_agents.run(100, 123);
+
+    // Aggregated model (no agents)
+    epimodels::ModelSEIRMixing<> model_counts(
+        "Flu", 0, 0.01, .1, 3.0, .25, contact_matrix
+    );
+
+    model_counts.aggregated_on({10000, 10000, 10000});
+    model_counts.verbose_off();
+    model_counts.run(100, 123);
+
+    REQUIRE(model_counts.is_aggregated());
+    REQUIRE(model_counts.size() == 0u);
+    REQUIRE(
+        std::abs(
+            final_total(model_agents, "Recovered") -
+            final_total(model_counts, "Recovered")
+        ) < 1000
+    );
+
+    // Daily totals add up to the population
+    std::vector< int > date, counts;
+    std::vector< std::string > state;
+    model_counts.get_db().get_hist_total(&date, &state, &counts);
+
+    REQUIRE(counts.size() == 101u * 4u);
+    for (size_t d = 0u; d < 101u; ++d)
+        REQUIRE(
+            counts[d * 4] + counts[d * 4 + 1] +
+            counts[d * 4 + 2] + counts[d * 4 + 3] == 30000
+        );
+
+    // Reproducible
+    model_counts.run(100, 123);
+    std::vector< int > counts_2;
+    model_counts.get_db().get_hist_total(&date, &state, &counts_2);
+    REQUIRE(counts == counts_2);
+
+    // SIR with initial recovered, and many replicates at national scale
+    epimodels::ModelSIRMixing<> model_sir(
+        "Flu", 0, 0.01, .1, .25, contact_matrix
+    );
+
+    model_sir.initial_states({.1});
+    model_sir.aggregated_on({20000000, 20000000, 20000000});
+    model_sir.verbose_off();
+
+    std::vector< int > n_recovered;
+    model_sir.run_multiple(
+        100, 4, 1,
+        [&n_recovered](size_t, Model<> * m) -> void {
+            n_recovered.push_back(m->get_db().get_today_total("Recovered"));
+        },
+        true, false, 1
+    );
+
+    REQUIRE(n_recovered.size() == 4u);
+    for (auto n : n_recovered)
+        REQUIRE(n > 6000000);
+
+    // Counts are int, so the population cannot be above 2^31 - 1
+    REQUIRE_THROWS_AS(
+        model_sir.aggregated_on({1000000000, 1000000000, 1000000000}),
+        std::range_error
+    );
+    REQUIRE_THROWS_AS(
+        model_sir.aggregated_on({3000000000u, 1u, 1u}),
+        std::range_error
+    );
+    REQUIRE_THROWS_AS(
+        model_sir.aggregated_on({100u, 0u, 100u}),
+        std::invalid_argument
+    );
+
+    // Back to agents
+    model_counts.aggregated_off();
+    REQUIRE_FALSE(model_counts.is_aggregated());
+    REQUIRE(model_counts.size() == 30000u);
+
+}
@@ -0,0 +1,169 @@
+#include "tests.hpp"
+#include "../include/measles/measles.hpp"
+
+using namespace epiworld;
+
+template<typename TMake>
+static bool resumes_as_run(TMake make, const std::string & fn)
+{
+
+    auto hist = [](Model<> & model) -> std::vector< int > {
+
+        std::vector< int > date, counts;
+        std::vector< std::string > state;
+        model.get_db().get_hist_total(&date, &state, &counts);
+
+        return counts;
+
+    };
+
+    auto model_a = make();
+    model_a->run(10, 1231);
+    model_a->write_checkpoint(fn);
+
+    // A fresh model (never run) restores it
+    auto model_b = make();
+    model_b->read_checkpoint(fn);
+    std::remove(fn.c_str());
+
+    model_a->resume(10);
+    model_b->resume(10);
+
+    auto model_c = make();
+    model_c->run(20, 1231);
+
+    return (hist(*model_b) == hist(*model_a)) &&
+        (hist(*model_b) == hist(*model_c));
+
+}
+
+EPIWORLD_TEST_CASE("Checkpoints", "[checkpoint]") {
+
+    auto build = [](epimodels::ModelSEIR<> & model, size_t n) -> void {
+
+        model.agents_smallworld(n, 6, false, 0.01);
+        model.verbose_off();
+
+        Tool<> mask("mask", .3, true);
+        mask.set_transmission_reduction(.4);
+        model.add_tool(mask);
+
+        model.get_virus(0).set_mutation(
+            [](Agent<> *, Virus<> & v, Model<> * m) -> bool {
+                if (m->runif() < .01)
+                {
+                    v.set_sequence(v.get_sequence() + 1);
+                    return true;
+                }
+                return false;
+            }
+        );
+
+    };
+
+    auto hist = [](Model<> & model) -> std::vector< int > {
+
+        std::vector< int > date, counts;
+        std::vector< std::string > state;
+        model.get_db().get_hist_total(&date, &state, &counts);
+
+        return counts;
+
+    };
+
+    std::string fn = "35c-checkpoint.bin";
+
+    // Model A runs 20 days and saves its state
+    epimodels::ModelSEIR<> model_a("a virus", 0.01, .5, 4.0, .3);
+    build(model_a, 2000);
+    model_a.run(20, 1231);
+    model_a.write_checkpoint(fn);
+
+    // Model B is built by the same code and restores it
+    epimodels::ModelSEIR<> model_b("a virus", 0.01, .5, 4.0, .3);
+    build(model_b, 2000);
+    model_b.read_checkpoint(fn);
+
+    REQUIRE(model_a == model_b);
+    REQUIRE(model_b.today() == 20);
+    REQUIRE(hist(model_b) == hist(model_a));
+
+    // Both continue the same way, which is the same as running 40 days
+    model_a.resume(20);
+    model_b.resume(20);
+
+    epimodels::ModelSEIR<> model_c("a virus", 0.01, .5, 4.0, .3);
+    build(model_c, 2000);
+    model_c.run(40, 1231);
+
+    REQUIRE(model_b.today() == 40);
+    REQUIRE(model_b.get_ndays() == 40u);
+    REQUIRE(model_a == model_b);
+    REQUIRE(hist(model_b) == hist(model_a));
+    REQUIRE(hist(model_b) == hist(model_c));
+    REQUIRE(
+        model_b.get_db().get_n_viruses() == model_c.get_db().get_n_viruses()
+    );
+
+    // A model that doesn't match
+    epimodels::ModelSEIR<> model_d("a virus", 0.01, .5, 4.0, .3);
+    build(model_d, 1000);
+    REQUIRE_THROWS_AS(model_d.read_checkpoint(fn), std::logic_error);
+
+    std::remove(fn.c_str());
+
+}
+
+EPIWORLD_TEST_CASE("Checkpoints of derived models", "[checkpoint]") {
+
+    std::string fn = "35c-checkpoint-derived.bin";
+
+    // Lists of infected agents are rebuilt
+    REQUIRE(resumes_as_run([]() {
+        auto m = std::make_unique< epimodels::ModelSIRCONN<> >(
+            "a virus", 5000, 0.01, 4, .3, .2
+        );
+        m->verbose_off();
+        return m;
+    }, fn));
+
+    std::vector< double > contact_matrix = {
+        8.0, 1.0, 1.0,
+        1.0, 8.0, 1.0,
+        1.0, 1.0, 8.0
+    };
+
+    auto add_groups = [](Model<> & m) -> void {
+        m.add_entity(Entity<>("A", distribute_entity_to_range<>(0, 1000)));
+        m.add_entity(Entity<>("B", distribute_entity_to_range<>(1000, 2000)));
+        m.add_entity(Entity<>("C", distribute_entity_to_range<>(2000, 3000)));
+        m.verbose_off();
+    };
+
+    REQUIRE(resumes_as_run([&]() {
+        auto m = std::make_unique< epimodels::ModelSIRMixing<> >(
+            "a virus", 3000, 0.01, 0.1, 1.0/7.0, contact_matrix
+        );
+        add_groups(*m);
+        return m;
+    }, fn));
+
+    REQUIRE(resumes_as_run([&]() {
+        auto m = std::make_unique< epimodels::ModelSEIRMixing<> >(
+            "a virus", 3000, 0.01, 0.1, 4.0, 1.0/7.0, contact_matrix
+        );
+        add_groups(*m);
+        return m;
+    }, fn));
+
+    // Quarantine data is included
+    REQUIRE(resumes_as_run([&]() {
+        auto m = std::make_unique< measles::ModelMeaslesMixing<> >(
+            3000, 0.005, 0.2, 0.9, 0.3, 7.0, 4.0, 5.0, contact_matrix,
+            0.2, 7.0, 2.0, 21, .8, .8, 4, 0.0, 1.0, 4u
+        );
+        add_groups(*m);
+        return m;
+    }, fn));
+
+}
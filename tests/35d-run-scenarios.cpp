@@ -0,0 +1,106 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Scenarios from a shared burn-in", "[run-scenarios]") {
+
+    // Susceptible counts by fork and day
+    auto run = [](int nthreads) -> std::vector< std::vector< int > > {
+
+        epimodels::ModelSIR<> model("a virus", 0.01, .5, .3);
+        model.agents_smallworld(2000, 6, false, 0.01);
+        model.verbose_off();
+
+        std::vector< std::vector< int > > susceptible(6u);
+        auto fun = [&susceptible](size_t fork, Model<> * m) -> void {
+
+            std::vector< int > date, counts;
+            std::vector< std::string > state;
+            m->get_db().get_hist_total(&date, &state, &counts);
+
+            for (size_t i = 0u; i < state.size(); ++i)
+                if (state[i] == "Susceptible")
+                    susceptible[fork].push_back(counts[i]);
+
+        };
+
+        model.run_scenarios(
+            30, 10,
+            {{}, {{"Transmission rate", 0.0}}},
+            3, 123, fun, false, nthreads
+        );
+
+        return susceptible;
+
+    };
+
+    auto susceptible = run(1);
+
+    // All the forks go through the same burn-in
+    for (size_t fork = 0u; fork < susceptible.size(); ++fork)
+    {
+        REQUIRE(susceptible[fork].size() == 31u);
+        for (size_t day = 0u; day <= 10u; ++day)
+            REQUIRE(susceptible[fork][day] == susceptible[0u][day]);
+    }
+
+    // Replicates differ, and there are no infections without transmission
+    REQUIRE(susceptible[0u] != susceptible[1u]);
+    REQUIRE(susceptible[0u][30u] < susceptible[0u][10u]);
+    for (size_t fork = 3u; fork < 6u; ++fork)
+        REQUIRE(susceptible[fork][30u] == susceptible[fork][10u]);
+
+    // Results don't depend on the number of threads
+    #ifdef _OPENMP
+    REQUIRE(run(2) == susceptible);
+    #endif
+
+    // Unknown parameters
+    epimodels::ModelSIR<> model("a virus", 0.01, .5, .3);
+    model.agents_smallworld(200, 6, false, 0.01);
+    model.verbose_off();
+    REQUIRE_THROWS_AS(
+        model.run_scenarios(10, 5, {{{"Not a parameter", 0.0}}}, 1),
+        std::logic_error
+    );
+
+}
+
+EPIWORLD_TEST_CASE("Scenarios of derived models", "[run-scenarios]") {
+
+    // Totals by fork of a model that keeps its own list of infected agents
+    auto run = [](
+        std::vector< std::map< std::string, epiworld_double > > scenarios,
+        int nthreads
+    ) -> std::vector< std::vector< int > > {
+
+        epimodels::ModelSIRCONN<> model("a virus", 5000, 0.01, 4, .3, .2);
+        model.verbose_off();
+
+        std::vector< std::vector< int > > totals(scenarios.size());
+        auto fun = [&totals](size_t fork, Model<> * m) -> void {
+            std::vector< int > date, counts;
+            std::vector< std::string > state;
+            m->get_db().get_hist_total(&date, &state, &counts);
+            totals[fork] = counts;
+        };
+
+        model.run_scenarios(30, 10, scenarios, 1, 123, fun, false, nthreads);
+
+        return totals;
+
+    };
+
+    // The second fork has the same seed and parameters in both runs, so it
+    // can't depend on what the first fork left in the model
+    auto totals_a = run({{}, {}}, 1);
+    auto totals_b = run({{{"Transmission rate", 0.9}}, {}}, 1);
+
+    REQUIRE(totals_a[0u] != totals_b[0u]);
+    REQUIRE(totals_a[1u] == totals_b[1u]);
+
+    #ifdef _OPENMP
+    REQUIRE(run({{{"Transmission rate", 0.9}}, {}}, 2) == totals_b);
+    #endif
+
+}
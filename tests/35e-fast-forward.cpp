@@ -0,0 +1,91 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Fast-forward after extinction", "[fast-forward]") {
+
+    auto hist = [](Model<> & model) -> std::vector< int > {
+
+        std::vector< int > date, counts, res;
+        std::vector< std::string > state;
+        model.get_db().get_hist_total(&date, &state, &counts);
+        res.insert(res.end(), counts.begin(), counts.end());
+
+        std::vector< int > id;
+        model.get_db().get_hist_virus(date, id, state, counts);
+        res.insert(res.end(), counts.begin(), counts.end());
+
+        std::vector< std::string > state_to;
+        model.get_db().get_hist_transition_matrix(
+            state, state_to, date, counts, false
+        );
+        res.insert(res.end(), counts.begin(), counts.end());
+
+        return res;
+
+    };
+
+    // Outbreaks that die out early
+    epimodels::ModelSIR<> model_0("a virus", 0.001, .1, .5);
+    model_0.agents_smallworld(5000, 4, false, 0.01);
+    model_0.verbose_off();
+
+    epimodels::ModelSIR<> model_1(model_0);
+    model_1.fast_forward_on();
+
+    REQUIRE_FALSE(model_0.is_fast_forward_on());
+    REQUIRE(model_1.is_fast_forward_on());
+
+    for (int seed = 1; seed < 6; ++seed)
+    {
+
+        model_0.run(100, seed);
+        model_1.run(100, seed);
+
+        REQUIRE(hist(model_1) == hist(model_0));
+        REQUIRE(model_1.is_absorbing());
+
+    }
+
+    // With a custom detector
+    int day_extinct = -1;
+    model_1.fast_forward_on(
+        [&day_extinct](Model<> * m) -> bool {
+            bool res = m->get_db().get_today_total("Infected") == 0;
+            if (res && (day_extinct < 0))
+                day_extinct = m->today();
+            return res;
+        }
+    );
+    model_1.run(100, 1);
+    model_0.run(100, 1);
+
+    REQUIRE(day_extinct > 0);
+    REQUIRE(day_extinct < 100);
+    REQUIRE(hist(model_1) == hist(model_0));
+
+    // Global events left to run block the fast-forward
+    model_0.add_globalevent(
+        [](Model<> * m) -> void {
+            for (auto & a : m->get_agents())
+                if (a.get_state() == 0u)
+                {
+                    a.set_virus(*m, m->get_virus(0));
+                    break;
+                }
+        },
+        "import", 90
+    );
+
+    epimodels::ModelSIR<> model_2(model_0);
+    model_2.fast_forward_on();
+    model_0.run(100, 1);
+    model_2.run(100, 1);
+
+    REQUIRE(hist(model_2) == hist(model_0));
+    REQUIRE(
+        model_2.get_db().get_today_total("Susceptible") <
+        model_1.get_db().get_today_total("Susceptible")
+    );
+
+}
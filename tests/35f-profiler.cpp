@@ -0,0 +1,80 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Profiler", "[profiler]") {
+
+    // Exclusive timing of nested phases
+    Profiler p;
+    p.enter(Profiler::GlobalEvents);
+    p.enter(Profiler::EventsRun);
+    p.leave();
+    p.leave();
+    p.add(Profiler::RngDraws, 10u);
+    p.add_event(EventAction::AddVirus);
+
+    REQUIRE(p.get_time(Profiler::GlobalEvents) >= 0.0);
+    REQUIRE(p.get_time(Profiler::EventsRun) >= 0.0);
+    REQUIRE(p.get_time(Profiler::Rewire) == 0.0);
+    REQUIRE(p.get_count(Profiler::RngDraws) == 10u);
+    REQUIRE(p.get_events(EventAction::AddVirus) == 1u);
+
+    Profiler p_total;
+    p_total += p;
+    p_total += p;
+    REQUIRE(p_total.get_count(Profiler::RngDraws) == 20u);
+    REQUIRE(p_total.get_events(EventAction::AddVirus) == 2u);
+
+    p.reset();
+    REQUIRE(p.get_count(Profiler::RngDraws) == 0u);
+
+    // Per run and across the threads of run_multiple
+    epimodels::ModelSIR<> model("a virus", 0.01, .5, .3);
+    model.agents_smallworld(2000, 4, false, 0.01);
+    model.verbose_off();
+    model.run(30, 123);
+
+    const auto & prof = model.get_profile();
+
+    #ifdef EPI_PROFILE
+    REQUIRE(prof.get_count(Profiler::AgentsVisited) > 0u);
+    REQUIRE(prof.get_count(Profiler::StateFunCalls) > 0u);
+    REQUIRE(prof.get_count(Profiler::RngDraws) > 0u);
+    REQUIRE(
+        prof.get_events(EventAction::AddVirus) ==
+        static_cast< uint64_t >(2000 - model.get_db().get_today_total("Susceptible") - 20)
+    );
+    #else
+    REQUIRE(prof.get_count(Profiler::AgentsVisited) == 0u);
+    #endif
+
+    // The total adds up the runs of all the threads
+    uint64_t visited = model.get_profile_total().get_count(
+        Profiler::AgentsVisited
+    );
+
+    std::vector< uint64_t > visited_by_run(4u, 0u);
+    model.run_multiple(
+        30, 4, 123,
+        [&visited_by_run](size_t i, Model<> * m) -> void {
+            visited_by_run[i] = m->get_profile().get_count(
+                Profiler::AgentsVisited
+            );
+        },
+        true, false, 2
+    );
+
+    for (auto v : visited_by_run)
+    {
+        #ifdef EPI_PROFILE
+        REQUIRE(v > 0u);
+        #endif
+        visited += v;
+    }
+
+    REQUIRE(
+        model.get_profile_total().get_count(Profiler::AgentsVisited) ==
+        visited
+    );
+
+}
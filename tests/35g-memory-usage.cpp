@@ -0,0 +1,58 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Memory usage", "[memory-usage]") {
+
+    size_t n = 2000u;
+    epimodels::ModelSIR<> model("a virus", 0.01, .5, .3);
+    model.agents_smallworld(n, 4, false, 0.01);
+    model.verbose_off();
+    model.run(50, 123);
+
+    double mean_degree = 0.0;
+    for (const auto & a : model.get_agents())
+        mean_degree += static_cast< double >(a.get_n_neighbors());
+    mean_degree /= static_cast< double >(n);
+
+    auto usage = model.memory_usage();
+
+    size_t nrow = sizeof(int) * 3u + sizeof(epiworld_fast_uint);
+
+    REQUIRE(usage.agents >= n * sizeof(Agent<>));
+    REQUIRE(usage.network >= 2u * n * static_cast< size_t >(mean_degree) * sizeof(epiworld_agent_index));
+    REQUIRE(usage.network_backup == 0u);
+    REQUIRE(usage.queue > 0u);
+    REQUIRE(usage.db_hist_total >= 51u * 3u * nrow);
+    REQUIRE(usage.db_hist_transition >= 51u * 9u * sizeof(int));
+    REQUIRE(usage.db_transmission > 0u);
+    REQUIRE(usage.thread_clones == 0u);
+    REQUIRE(usage.total() > usage.database());
+
+    // Thread clones share the network
+    auto usage_4 = model.memory_usage(4);
+    REQUIRE(
+        usage_4.thread_clones == 3u * (usage.total() - usage.network)
+    );
+
+    // The estimate is close to what the model holds
+    auto estimate = Model<>::estimate_memory_usage(n, mean_degree, 3u, 50u);
+
+    REQUIRE(estimate.agents == n * (sizeof(Agent<>) + sizeof(unsigned int)));
+    REQUIRE(estimate.network <= usage.network);
+    REQUIRE(usage.network <= 2u * estimate.network);
+    REQUIRE(estimate.db_hist_total <= usage.db_hist_total);
+    REQUIRE(usage.db_hist_total <= 2u * estimate.db_hist_total);
+    REQUIRE(estimate.db_hist_transition <= usage.db_hist_transition);
+    REQUIRE(usage.db_hist_transition <= 2u * estimate.db_hist_transition);
+    REQUIRE(usage.db_transmission <= 2u * estimate.db_transmission);
+    REQUIRE(usage.total() <= 2u * estimate.total());
+
+    auto estimate_4 = Model<>::estimate_memory_usage(
+        n, mean_degree, 3u, 50u, 1u, 0u, 4
+    );
+    REQUIRE(
+        estimate_4.thread_clones == 3u * (estimate.total() - estimate.network)
+    );
+
+}
@@ -0,0 +1,64 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Contiguous agent states", "[agents-state]") {
+
+    // The states returned by the model must match those of the agents
+    auto same_states = [](Model<> & model) -> bool {
+
+        auto states = model.get_agents_states();
+        if (states.size() != model.size())
+            return false;
+
+        for (const auto & a : model.get_agents())
+        {
+            if (states[a.get_id()] != a.get_state())
+                return false;
+        }
+
+        return true;
+
+    };
+
+    epimodels::ModelSEIR<> model("a virus", 0.01, .5, 4.0, .3);
+    model.agents_smallworld(2000, 4, false, 0.01);
+    model.verbose_off();
+
+    REQUIRE(same_states(model));
+
+    model.run(30, 1231);
+    REQUIRE(same_states(model));
+
+    // Resetting re-distributes the viruses
+    model.reset();
+    REQUIRE(same_states(model));
+
+    // Restoring a checkpoint
+    model.run(20, 1231);
+
+    std::string fn = "35h-agents-state.bin";
+    model.write_checkpoint(fn);
+
+    epimodels::ModelSEIR<> model_b("a virus", 0.01, .5, 4.0, .3);
+    model_b.agents_smallworld(2000, 4, false, 0.01);
+    model_b.verbose_off();
+    model_b.read_checkpoint(fn);
+    std::remove(fn.c_str());
+
+    REQUIRE(same_states(model_b));
+    REQUIRE(model_b.get_agents_states() == model.get_agents_states());
+
+    // Sampling by state only picks agents in those states
+    AgentsSample<> sample(model, 50, {1u, 2u}, true);
+    for (auto & a : sample)
+        REQUIRE(((a->get_state() == 1u) || (a->get_state() == 2u)));
+
+    size_t n_in_states = 0u;
+    for (const auto & a : model.get_agents())
+        if ((a.get_state() == 1u) || (a.get_state() == 2u))
+            ++n_in_states;
+
+    REQUIRE(sample.size() == std::min< size_t >(50u, n_in_states));
+
+}
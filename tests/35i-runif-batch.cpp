@@ -0,0 +1,118 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+template<size_t L>
+static bool lanes_match_scalar(uint64_t seed)
+{
+
+    // Lane l is the scalar engine after l jumps
+    epi_xoshiro256ss_lanes< L > eng(seed);
+    std::vector< uint64_t > block(10u * L);
+    eng.fill(block.data(), 10u);
+
+    epi_xoshiro256ss scalar(seed);
+    for (size_t l = 0u; l < L; ++l)
+    {
+
+        epi_xoshiro256ss lane = scalar;
+        for (size_t k = 0u; k < 10u; ++k)
+            if (block[k * L + l] != lane())
+                return false;
+
+        scalar.jump();
+
+    }
+
+    return true;
+
+}
+
+EPIWORLD_TEST_CASE("Batched uniforms", "[runif-batch]") {
+
+    REQUIRE(lanes_match_scalar< 1u >(123u));
+    REQUIRE(lanes_match_scalar< 4u >(123u));
+    REQUIRE(lanes_match_scalar< 8u >(5u));
+
+    // Uniforms are the same conversion as runif_epi()
+    epi_xoshiro256ss_lanes< 4u > eng_a(33u), eng_b(33u);
+    std::vector< uint64_t > bits(4u * 100u);
+    std::vector< epiworld_double > unif(4u * 100u);
+    eng_a.fill(bits.data(), 100u);
+    eng_b.fill_unif(unif.data(), 100u);
+
+    bool all_equal = true;
+    double mean = 0.0;
+    for (size_t i = 0u; i < unif.size(); ++i)
+    {
+        all_equal &= (unif[i] == runif_from_bits(bits[i]));
+        all_equal &= (unif[i] >= 0.0) && (unif[i] < 1.0);
+        mean += unif[i] / static_cast< double >(unif.size());
+    }
+
+    REQUIRE(all_equal);
+    REQUIRE(std::fabs(mean - 0.5) < 0.05);
+
+    // Models give the same results for the same seed, also when copied
+    auto counts = [](Model<> & model) -> std::vector< int > {
+        std::vector< int > date, counts;
+        std::vector< std::string > state;
+        model.get_db().get_hist_total(&date, &state, &counts);
+        return counts;
+    };
+
+    std::vector< double > contact_matrix = {
+        8.0, 1.0, 1.0,
+        1.0, 8.0, 1.0,
+        1.0, 1.0, 8.0
+    };
+
+    epimodels::ModelSIRMixing<> model_0(
+        "a virus", 3000, 0.01, 0.1, 1.0/7.0, contact_matrix
+    );
+
+    model_0.add_entity(Entity<>("A", distribute_entity_to_range<>(0, 1000)));
+    model_0.add_entity(Entity<>("B", distribute_entity_to_range<>(1000, 2000)));
+    model_0.add_entity(Entity<>("C", distribute_entity_to_range<>(2000, 3000)));
+    model_0.verbose_off();
+
+    REQUIRE_FALSE(model_0.is_runif_batch_on());
+    model_0.runif_batch_on();
+    REQUIRE(model_0.is_runif_batch_on());
+
+    model_0.run(60, 1231);
+    auto counts_0 = counts(model_0);
+
+    model_0.run(60, 1231);
+    REQUIRE(counts(model_0) == counts_0);
+
+    epimodels::ModelSIRMixing<> model_1(model_0);
+    REQUIRE(model_1.is_runif_batch_on());
+    model_1.run(60, 1231);
+    REQUIRE(counts(model_1) == counts_0);
+
+    // The batched stream differs from the engine's
+    model_1.runif_batch_off();
+    model_1.run(60, 1231);
+    REQUIRE(counts(model_1) != counts_0);
+
+    // Checkpoints keep the position in the batched stream
+    epimodels::ModelSEIR<> model_a("a virus", 0.01, .5, 4.0, .3);
+    model_a.agents_smallworld(2000, 4, false, 0.01);
+    model_a.verbose_off();
+    model_a.runif_batch_on();
+
+    epimodels::ModelSEIR<> model_b(model_a);
+
+    std::string fn = "35i-runif-batch.bin";
+    model_a.run(20, 1231);
+    model_a.write_checkpoint(fn);
+
+    model_b.read_checkpoint(fn);
+    std::remove(fn.c_str());
+
+    model_a.resume(20);
+    model_b.resume(20);
+    REQUIRE(counts(model_b) == counts(model_a));
+
+}
@@ -0,0 +1,69 @@
+#include "tests.hpp"
+
+using namespace epiworld;
+
+EPIWORLD_TEST_CASE("Agent index type", "[agent-index]") {
+
+    const size_t max_n = static_cast< size_t >(
+        std::numeric_limits< epiworld_agent_index >::max()
+    );
+
+    // Ties are stored both ways, so every neighbor points back
+    epimodels::ModelSIR<> model("a virus", 0.01, .5, .3);
+    model.agents_smallworld(2000, 4, false, 0.01);
+    model.verbose_off();
+    model.run(30, 1231);
+
+    bool ties_ok = true;
+    for (auto & a : model.get_agents())
+    {
+        for (auto * n : a.get_neighbors(model))
+        {
+            bool found = false;
+            for (auto * m : n->get_neighbors(model))
+                found |= (m->get_id() == a.get_id());
+
+            ties_ok &= found;
+        }
+    }
+
+    REQUIRE(ties_ok);
+    REQUIRE(model.get_db().get_today_total("Recovered") > 0);
+
+    // Entities keep the ids of their agents
+    std::vector< double > contact_matrix = {
+        8.0, 1.0,
+        1.0, 8.0
+    };
+
+    epimodels::ModelSIRMixing<> model_mixing(
+        "a virus", 2000, 0.01, 0.1, 1.0/7.0, contact_matrix
+    );
+
+    model_mixing.add_entity(Entity<>("A", distribute_entity_to_range<>(0, 1000)));
+    model_mixing.add_entity(Entity<>("B", distribute_entity_to_range<>(1000, 2000)));
+    model_mixing.verbose_off();
+    model_mixing.run(30, 1231);
+
+    const auto & agents_b = model_mixing.get_entity(1u).get_agents();
+    REQUIRE(agents_b.size() == 1000u);
+    REQUIRE(static_cast< size_t >(agents_b.front()) == 1000u);
+    REQUIRE(static_cast< size_t >(agents_b.back()) == 1999u);
+    REQUIRE(model_mixing.get_db().get_today_total("Recovered") > 0);
+
+    // With a small index type (e.g., -Depiworld_agent_index=uint16_t),
+    // larger populations are rejected
+    if (max_n < 100000000u)
+    {
+
+        REQUIRE_NOTHROW(Network(max_n));
+        REQUIRE_THROWS_AS(Network(max_n + 1u), std::range_error);
+
+        epimodels::ModelSIR<> model_big("a virus", 0.01, .5, .3);
+        REQUIRE_THROWS_AS(
+            model_big.agents_empty_graph(max_n + 1u), std::range_error
+        );
+
+    }
+
+}
@@ -0,0 +1 @@
+#include "../35j-agent-index.cpp"
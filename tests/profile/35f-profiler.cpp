@@ -0,0 +1 @@
+#include "../35f-profiler.cpp"